@@ -0,0 +1,332 @@
+/**
+ * @file benchmark.cpp
+ *
+ * Implementation of the benchmark framework of mlpack_benchmarks.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "benchmark.hpp"
+
+#include <mlpack/core/util/version.hpp>
+
+#include <ctime>
+#include <iomanip>
+#include <regex>
+#include <thread>
+
+namespace mlpack {
+namespace benchmark {
+
+State::State(const std::vector<size_t>& args,
+             const size_t iterations,
+             const std::string& timerName) :
+    args(args),
+    iterations(iterations),
+    started(0),
+    timerName(timerName),
+    running(false),
+    itemsProcessed(0)
+{
+  // Nothing to do.
+}
+
+bool State::KeepRunning()
+{
+  if (started == 0)
+    ResumeTiming();
+
+  if (started == iterations)
+  {
+    PauseTiming();
+    return false;
+  }
+
+  ++started;
+  return true;
+}
+
+void State::PauseTiming()
+{
+  if (running)
+  {
+    Timer::Stop(timerName);
+    running = false;
+  }
+}
+
+void State::ResumeTiming()
+{
+  if (!running)
+  {
+    Timer::Start(timerName);
+    running = true;
+  }
+}
+
+size_t State::Range(const size_t i) const
+{
+  if (i >= args.size())
+  {
+    std::ostringstream oss;
+    oss << "State::Range(): argument " << i << " requested, but the run only "
+        << "has " << args.size() << " arguments!";
+    throw std::out_of_range(oss.str());
+  }
+
+  return args[i];
+}
+
+Benchmark::Benchmark(const std::string& name, FunctionType function) :
+    name(name),
+    function(std::move(function)),
+    iterations(1)
+{
+  // Nothing to do.
+}
+
+Benchmark* Benchmark::Args(const std::vector<size_t>& args)
+{
+  argSets.push_back(args);
+  return this;
+}
+
+Benchmark* Benchmark::DenseRange(const size_t begin,
+                                 const size_t end,
+                                 const std::vector<size_t>& otherArgs)
+{
+  for (size_t i = begin; i < end; ++i)
+  {
+    std::vector<size_t> args(1, i);
+    args.insert(args.end(), otherArgs.begin(), otherArgs.end());
+    argSets.push_back(args);
+  }
+
+  return this;
+}
+
+Benchmark* Benchmark::Iterations(const size_t iterations)
+{
+  this->iterations = iterations;
+  return this;
+}
+
+Benchmark* Benchmark::Register(const std::string& name, FunctionType function)
+{
+  Registry().push_back(new Benchmark(name, std::move(function)));
+  return Registry().back();
+}
+
+std::vector<Benchmark*>& Benchmark::Registry()
+{
+  static std::vector<Benchmark*> registry;
+  return registry;
+}
+
+std::string RunName(const Benchmark& benchmark,
+                    const std::vector<size_t>& args)
+{
+  std::ostringstream oss;
+  oss << benchmark.Name();
+  for (size_t i = 0; i < args.size(); ++i)
+    oss << "/" << args[i];
+  return oss.str();
+}
+
+namespace {
+
+//! Escape the given string for JSON.
+std::string Escape(const std::string& str)
+{
+  std::ostringstream oss;
+  for (size_t i = 0; i < str.size(); ++i)
+  {
+    if (str[i] == '"' || str[i] == '\\')
+      oss << '\\' << str[i];
+    else if ((unsigned char) str[i] < 0x20)
+      oss << "\\u" << std::hex << std::setw(4) << std::setfill('0')
+          << (int) str[i] << std::dec << std::setfill(' ');
+    else
+      oss << str[i];
+  }
+  return oss.str();
+}
+
+//! Write one result as a JSON object.
+void WriteResult(std::ostream& stream,
+                 const RunResult& result,
+                 const std::string& runType,
+                 const std::string& aggregate)
+{
+  stream << "    {\n"
+         << "      \"name\": \"" << Escape(result.name)
+         << (aggregate.empty() ? "" : "_" + aggregate) << "\",\n"
+         << "      \"run_name\": \"" << Escape(result.name) << "\",\n"
+         << "      \"run_type\": \"" << runType << "\",\n";
+  if (aggregate.empty())
+    stream << "      \"repetition_index\": " << result.repetition << ",\n";
+  else
+    stream << "      \"aggregate_name\": \"" << aggregate << "\",\n";
+  stream << "      \"iterations\": " << result.iterations << ",\n"
+         << "      \"real_time\": " << result.realTime << ",\n"
+         << "      \"cpu_time\": " << result.cpuTime << ",\n"
+         << "      \"time_unit\": \"ms\",\n"
+         << "      \"allocations\": " << result.allocations << ",\n"
+         << "      \"items_per_second\": " << result.itemsPerSecond << ",\n"
+         << "      \"label\": \"" << Escape(result.label) << "\"\n"
+         << "    }";
+}
+
+} // namespace
+
+std::vector<RunResult> RunBenchmarks(const std::string& filter,
+                                     const size_t repetitions,
+                                     const size_t seed)
+{
+  const std::regex filterRegex(filter);
+  std::vector<RunResult> results;
+
+  // The benchmarks are timed with mlpack timers, so timing must be on.
+  Timer::EnableTiming();
+
+  std::cout << std::left << std::setw(48) << "Benchmark" << std::right
+      << std::setw(14) << "Time (ms)" << std::setw(14) << "CPU (ms)"
+      << std::setw(12) << "Iterations" << "  Label" << std::endl;
+  std::cout << std::string(100, '-') << std::endl;
+
+  const std::vector<Benchmark*>& registry = Benchmark::Registry();
+  for (size_t b = 0; b < registry.size(); ++b)
+  {
+    const Benchmark& benchmark = *registry[b];
+
+    // A benchmark without arguments has a single run.
+    std::vector<std::vector<size_t>> argSets = benchmark.ArgSets();
+    if (argSets.empty())
+      argSets.push_back(std::vector<size_t>());
+
+    for (size_t a = 0; a < argSets.size(); ++a)
+    {
+      const std::string name = RunName(benchmark, argSets[a]);
+      if (!std::regex_search(name, filterRegex))
+        continue;
+
+      for (size_t r = 0; r < repetitions; ++r)
+      {
+        std::ostringstream timerName;
+        timerName << "benchmark/" << name << "/" << r;
+
+        math::RandomSeed(seed);
+        State state(argSets[a], benchmark.Iterations(), timerName.str());
+        benchmark.Function()(state);
+        // In case the benchmark returned early.
+        state.PauseTiming();
+
+        const TimerUsage usage = Timer::GetUsage(timerName.str());
+        const double iterations = std::max(state.Iterations(), (size_t) 1);
+        const double realTime = Timer::Get(timerName.str()).count() / 1000.0;
+
+        RunResult result;
+        result.name = name;
+        result.label = state.Label();
+        result.repetition = r;
+        result.iterations = state.Iterations();
+        result.realTime = realTime / iterations;
+        result.cpuTime = usage.cpuTime.count() / 1000.0 / iterations;
+        result.allocations = usage.allocations / iterations;
+        result.itemsPerSecond = (realTime > 0.0) ?
+            state.ItemsProcessed() / (realTime / 1000.0) : 0.0;
+        results.push_back(result);
+
+        std::cout << std::left << std::setw(48) << name << std::right
+            << std::fixed << std::setprecision(3)
+            << std::setw(14) << result.realTime
+            << std::setw(14) << result.cpuTime
+            << std::setw(12) << result.iterations
+            << "  " << result.label << std::endl;
+        std::cout.unsetf(std::ios::floatfield);
+      }
+    }
+  }
+
+  return results;
+}
+
+void WriteJSON(std::ostream& stream,
+               const std::vector<RunResult>& results,
+               const size_t seed)
+{
+  char date[64];
+  const std::time_t now = std::time(NULL);
+  std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", std::localtime(&now));
+
+  stream << std::setprecision(10);
+  stream << "{\n"
+         << "  \"context\": {\n"
+         << "    \"date\": \"" << date << "\",\n"
+         << "    \"mlpack_version\": \"" << Escape(util::GetVersion())
+         << "\",\n"
+         << "    \"num_cpus\": " << std::thread::hardware_concurrency()
+         << ",\n"
+         << "    \"seed\": " << seed << ",\n"
+#ifdef DEBUG
+         << "    \"library_build_type\": \"debug\"\n"
+#else
+         << "    \"library_build_type\": \"release\"\n"
+#endif
+         << "  },\n"
+         << "  \"benchmarks\": [\n";
+
+  bool first = true;
+  for (size_t i = 0; i < results.size(); ++i)
+  {
+    if (!first)
+      stream << ",\n";
+    first = false;
+    WriteResult(stream, results[i], "iteration", "");
+
+    // After the last repetition of a run, add the aggregates.
+    if (results[i].repetition == 0 || (i + 1 < results.size() &&
+        results[i + 1].name == results[i].name))
+      continue;
+
+    const size_t count = results[i].repetition + 1;
+    arma::vec real(count), cpu(count), allocations(count), items(count);
+    for (size_t j = 0; j < count; ++j)
+    {
+      const RunResult& r = results[i + 1 - count + j];
+      real[j] = r.realTime;
+      cpu[j] = r.cpuTime;
+      allocations[j] = r.allocations;
+      items[j] = r.itemsPerSecond;
+    }
+
+    RunResult aggregate = results[i];
+    aggregate.realTime = arma::mean(real);
+    aggregate.cpuTime = arma::mean(cpu);
+    aggregate.allocations = arma::mean(allocations);
+    aggregate.itemsPerSecond = arma::mean(items);
+    stream << ",\n";
+    WriteResult(stream, aggregate, "aggregate", "mean");
+
+    aggregate.realTime = arma::median(real);
+    aggregate.cpuTime = arma::median(cpu);
+    aggregate.allocations = arma::median(allocations);
+    aggregate.itemsPerSecond = arma::median(items);
+    stream << ",\n";
+    WriteResult(stream, aggregate, "aggregate", "median");
+
+    aggregate.realTime = arma::stddev(real);
+    aggregate.cpuTime = arma::stddev(cpu);
+    aggregate.allocations = arma::stddev(allocations);
+    aggregate.itemsPerSecond = arma::stddev(items);
+    stream << ",\n";
+    WriteResult(stream, aggregate, "aggregate", "stddev");
+  }
+
+  stream << "\n  ]\n}\n";
+}
+
+} // namespace benchmark
+} // namespace mlpack
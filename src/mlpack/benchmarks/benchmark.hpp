@@ -0,0 +1,230 @@
+/**
+ * @file benchmark.hpp
+ *
+ * A small framework for the benchmarks of mlpack_benchmarks, in the style of
+ * Google Benchmark: benchmarks are functions that take a State, run their
+ * timed code while State::KeepRunning() returns true, and are registered with
+ * MLPACK_BENCHMARK().
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_BENCHMARKS_BENCHMARK_HPP
+#define MLPACK_BENCHMARKS_BENCHMARK_HPP
+
+#include <mlpack/core.hpp>
+
+#include <functional>
+
+namespace mlpack {
+namespace benchmark /** Benchmarks of mlpack algorithms. */ {
+
+/**
+ * The State of a benchmark run holds the arguments of the run, and times the
+ * iterations of the benchmark.  Everything done before the first call to
+ * KeepRunning() (such as generating the dataset) is not timed, and neither is
+ * anything done between PauseTiming() and ResumeTiming().
+ *
+ * @code
+ * void BM_Example(State& state)
+ * {
+ *   arma::mat data = arma::randu<arma::mat>(3, state.Range(0));
+ *   while (state.KeepRunning())
+ *     Work(data);
+ * }
+ * @endcode
+ */
+class State
+{
+ public:
+  /**
+   * Create the state for a run with the given arguments and number of
+   * iterations.  The run is timed with the mlpack Timer of the given name.
+   */
+  State(const std::vector<size_t>& args,
+        const size_t iterations,
+        const std::string& timerName);
+
+  /**
+   * Return true while there are iterations left to run.  The first call starts
+   * the timer, and the call after the last iteration stops it.
+   */
+  bool KeepRunning();
+
+  //! Stop timing, for instance to reset some state between iterations.
+  void PauseTiming();
+  //! Restart timing after PauseTiming().
+  void ResumeTiming();
+
+  //! Get the i'th argument of the run.
+  size_t Range(const size_t i) const;
+
+  //! Set a label to print next to the results (for instance, a tree name).
+  void SetLabel(const std::string& label) { this->label = label; }
+  //! Get the label of the run.
+  const std::string& Label() const { return label; }
+
+  //! Set the number of items (for instance, points) processed by the run.
+  void SetItemsProcessed(const size_t items) { itemsProcessed = items; }
+  //! Get the number of items processed by the run.
+  size_t ItemsProcessed() const { return itemsProcessed; }
+
+  //! Get the number of iterations of the run.
+  size_t Iterations() const { return iterations; }
+
+ private:
+  //! The arguments of the run.
+  std::vector<size_t> args;
+  //! The number of iterations to run.
+  size_t iterations;
+  //! The number of iterations started so far.
+  size_t started;
+  //! The name of the timer of the run.
+  std::string timerName;
+  //! Whether the timer is running.
+  bool running;
+  //! The label of the run.
+  std::string label;
+  //! The number of items processed.
+  size_t itemsProcessed;
+};
+
+/**
+ * A registered benchmark: a function and the sets of arguments it is run with.
+ * Each set of arguments is a separate run, named after the benchmark and its
+ * arguments (for instance, "BM_KNN/0/10000").  Since the random seed is reset
+ * before each run, the runs are reproducible.
+ */
+class Benchmark
+{
+ public:
+  //! The type of a benchmark function.
+  typedef std::function<void(State&)> FunctionType;
+
+  /**
+   * Create a benchmark with the given name and function.  Use
+   * MLPACK_BENCHMARK() instead, which registers the benchmark too.
+   */
+  Benchmark(const std::string& name, FunctionType function);
+
+  //! Add a run with the given arguments.
+  Benchmark* Args(const std::vector<size_t>& args);
+
+  //! Add runs for each value in [begin, end) with the given other arguments
+  //! after it (this is useful to run each value of an enum).
+  Benchmark* DenseRange(const size_t begin,
+                        const size_t end,
+                        const std::vector<size_t>& otherArgs =
+                            std::vector<size_t>());
+
+  //! Set the number of iterations of each run (the default is 1).
+  Benchmark* Iterations(const size_t iterations);
+
+  //! Get the name of the benchmark.
+  const std::string& Name() const { return name; }
+  //! Get the function of the benchmark.
+  const FunctionType& Function() const { return function; }
+  //! Get the arguments of each run.
+  const std::vector<std::vector<size_t>>& ArgSets() const { return argSets; }
+  //! Get the number of iterations of each run.
+  size_t Iterations() const { return iterations; }
+
+  /**
+   * Register a new benchmark, which is kept until the end of the program.
+   */
+  static Benchmark* Register(const std::string& name, FunctionType function);
+
+  //! Get all the registered benchmarks.
+  static std::vector<Benchmark*>& Registry();
+
+ private:
+  //! The name of the benchmark.
+  std::string name;
+  //! The benchmark function.
+  FunctionType function;
+  //! The arguments of each run.
+  std::vector<std::vector<size_t>> argSets;
+  //! The number of iterations of each run.
+  size_t iterations;
+};
+
+/**
+ * Get the name of the run of the given benchmark with the given arguments: the
+ * name of the benchmark followed by each argument, separated by slashes.
+ */
+std::string RunName(const Benchmark& benchmark,
+                    const std::vector<size_t>& args);
+
+/**
+ * The result of one repetition of a run.
+ */
+struct RunResult
+{
+  //! Name of the run.
+  std::string name;
+  //! Label set by the run.
+  std::string label;
+  //! Repetition index.
+  size_t repetition;
+  //! Number of iterations.
+  size_t iterations;
+  //! Wall-clock time of each iteration (in milliseconds).
+  double realTime;
+  //! CPU time of each iteration (in milliseconds).
+  double cpuTime;
+  //! Allocations of each iteration (0 if they aren't counted).
+  double allocations;
+  //! Items processed per second, or 0 if the run didn't set them.
+  double itemsPerSecond;
+};
+
+/**
+ * Run all the registered benchmarks whose run names match the given regular
+ * expression, each the given number of times, and print the results to
+ * stdout.  mlpack::math::RandomSeed(seed) is called before each repetition.
+ *
+ * @param filter Regular expression (ECMAScript) that run names must match.
+ * @param repetitions Number of times to run each run.
+ * @param seed Random seed.
+ * @return The results of all repetitions.
+ */
+std::vector<RunResult> RunBenchmarks(const std::string& filter,
+                                     const size_t repetitions,
+                                     const size_t seed);
+
+/**
+ * Write the given results as JSON to the given stream.  The layout follows the
+ * one of Google Benchmark: a "context" object describing the machine and the
+ * build, and a "benchmarks" array with one object for each repetition (plus
+ * mean, median, and standard deviation aggregates when there is more than one
+ * repetition).  Times are in milliseconds.
+ *
+ * @param stream Stream to write to.
+ * @param results Results of RunBenchmarks().
+ * @param seed The random seed that was used.
+ */
+void WriteJSON(std::ostream& stream,
+               const std::vector<RunResult>& results,
+               const size_t seed);
+
+} // namespace benchmark
+} // namespace mlpack
+
+//! Register the given benchmark function.  The registration returns a
+//! Benchmark*, so Args() and the like can be appended.
+#define MLPACK_BENCHMARK(function) \
+    MLPACK_BENCHMARK_NAMED(#function, function)
+
+//! Register the given benchmark function with the given name; this is useful
+//! for template instantiations, whose names contain commas or brackets.
+#define MLPACK_BENCHMARK_NAMED(name, function) \
+    static ::mlpack::benchmark::Benchmark* \
+        MLPACK_BENCHMARK_CONCAT(mlpackBenchmark, __LINE__) = \
+        ::mlpack::benchmark::Benchmark::Register(name, function)
+
+#define MLPACK_BENCHMARK_CONCAT(a, b) MLPACK_BENCHMARK_CONCAT_IMPL(a, b)
+#define MLPACK_BENCHMARK_CONCAT_IMPL(a, b) a ## b
+
+#endif
@@ -0,0 +1,128 @@
+/**
+ * @file ffn_benchmarks.cpp
+ *
+ * Benchmarks of the forward and backward passes of a feedforward network with
+ * one hidden layer, on 100-dimensional inputs with 10 classes, built either as
+ * an FFN or as a StaticFFN.  The first argument of each run is the batch size,
+ * and the second is the size of the hidden layer.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "benchmark.hpp"
+
+#include <mlpack/methods/ann/layer/layer.hpp>
+#include <mlpack/methods/ann/ffn.hpp>
+#include <mlpack/methods/ann/static_ffn.hpp>
+
+using namespace mlpack;
+using namespace mlpack::ann;
+using namespace mlpack::benchmark;
+
+//! Build the network and a batch of random inputs and targets.
+static void BuildNetwork(State& state,
+                         FFN<NegativeLogLikelihood<>>& model,
+                         arma::mat& inputs,
+                         arma::mat& targets)
+{
+  const size_t batchSize = state.Range(0);
+  const size_t hiddenSize = state.Range(1);
+
+  model.Add<Linear<>>(100, hiddenSize);
+  model.Add<SigmoidLayer<>>();
+  model.Add<Linear<>>(hiddenSize, 10);
+  model.Add<LogSoftMax<>>();
+  model.ResetParameters();
+
+  inputs = arma::randu<arma::mat>(100, batchSize);
+  // NegativeLogLikelihood takes the labels as numbers in [1, 10].
+  targets = arma::floor(10 * arma::randu<arma::mat>(1, batchSize)) + 1;
+}
+
+//! Time the forward pass alone.
+static void BM_FFNForward(State& state)
+{
+  FFN<NegativeLogLikelihood<>> model;
+  arma::mat inputs, targets, results;
+  BuildNetwork(state, model, inputs, targets);
+
+  while (state.KeepRunning())
+    model.Forward(inputs, results);
+  state.SetItemsProcessed(state.Iterations() * inputs.n_cols);
+}
+MLPACK_BENCHMARK(BM_FFNForward)
+    ->Args({ 1, 10 })->Args({ 32, 100 })->Args({ 256, 100 })
+    ->Args({ 256, 1000 })->Iterations(100);
+
+//! Time a forward pass followed by a backward pass.
+static void BM_FFNForwardBackward(State& state)
+{
+  FFN<NegativeLogLikelihood<>> model;
+  arma::mat inputs, targets, results, gradients;
+  BuildNetwork(state, model, inputs, targets);
+
+  while (state.KeepRunning())
+  {
+    model.Forward(inputs, results);
+    model.Backward(targets, gradients);
+  }
+  state.SetItemsProcessed(state.Iterations() * inputs.n_cols);
+}
+MLPACK_BENCHMARK(BM_FFNForwardBackward)
+    ->Args({ 1, 10 })->Args({ 32, 100 })->Args({ 256, 100 })
+    ->Args({ 256, 1000 })->Iterations(100);
+
+//! The same network as a StaticFFN.
+typedef StaticFFN<LayerSequence<Linear<>, SigmoidLayer<>, Linear<>,
+    LogSoftMax<> > > StaticNetwork;
+
+//! Build the static network and a batch of random inputs and targets.
+static StaticNetwork BuildStaticNetwork(State& state,
+                                        arma::mat& inputs,
+                                        arma::mat& targets)
+{
+  const size_t batchSize = state.Range(0);
+  const size_t hiddenSize = state.Range(1);
+
+  StaticNetwork model(Linear<>(100, hiddenSize), SigmoidLayer<>(),
+      Linear<>(hiddenSize, 10), LogSoftMax<>());
+  model.ResetParameters();
+
+  inputs = arma::randu<arma::mat>(100, batchSize);
+  targets = arma::floor(10 * arma::randu<arma::mat>(1, batchSize)) + 1;
+
+  return model;
+}
+
+//! Time the forward pass of the static network alone.
+static void BM_StaticFFNForward(State& state)
+{
+  arma::mat inputs, targets, results;
+  StaticNetwork model = BuildStaticNetwork(state, inputs, targets);
+
+  while (state.KeepRunning())
+    model.Forward(inputs, results);
+  state.SetItemsProcessed(state.Iterations() * inputs.n_cols);
+}
+MLPACK_BENCHMARK(BM_StaticFFNForward)
+    ->Args({ 1, 10 })->Args({ 32, 100 })->Args({ 256, 100 })
+    ->Args({ 256, 1000 })->Iterations(100);
+
+//! Time a forward pass followed by a backward pass of the static network.
+static void BM_StaticFFNForwardBackward(State& state)
+{
+  arma::mat inputs, targets, results, gradients;
+  StaticNetwork model = BuildStaticNetwork(state, inputs, targets);
+
+  while (state.KeepRunning())
+  {
+    model.Forward(inputs, results);
+    model.Backward(targets, gradients);
+  }
+  state.SetItemsProcessed(state.Iterations() * inputs.n_cols);
+}
+MLPACK_BENCHMARK(BM_StaticFFNForwardBackward)
+    ->Args({ 1, 10 })->Args({ 32, 100 })->Args({ 256, 100 })
+    ->Args({ 256, 1000 })->Iterations(100);
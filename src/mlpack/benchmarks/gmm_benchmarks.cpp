@@ -0,0 +1,41 @@
+/**
+ * @file gmm_benchmarks.cpp
+ *
+ * Benchmarks of GMM training with EM.  The first argument of each run is the
+ * number of points, and the second is the number of Gaussians.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "benchmark.hpp"
+
+#include <mlpack/methods/gmm/gmm.hpp>
+
+using namespace mlpack;
+using namespace mlpack::benchmark;
+using namespace mlpack::gmm;
+
+/**
+ * Train a GMM on 5-dimensional Gaussian clusters with at most 50 iterations of
+ * EM (the initial k-means clustering is included in the time).
+ */
+static void BM_GMMTrain(State& state)
+{
+  const size_t points = state.Range(0);
+  const size_t gaussians = state.Range(1);
+
+  const arma::mat centers = 10 * arma::randu<arma::mat>(5, gaussians);
+  arma::mat dataset = arma::randn<arma::mat>(5, points);
+  for (size_t i = 0; i < points; ++i)
+    dataset.col(i) += centers.col(i % gaussians);
+
+  while (state.KeepRunning())
+  {
+    GMM gmm(gaussians, dataset.n_rows);
+    gmm.Train(dataset, 1, false, EMFit<>(50, 1e-10));
+  }
+  state.SetItemsProcessed(state.Iterations() * points);
+}
+MLPACK_BENCHMARK(BM_GMMTrain)->Args({ 10000, 5 })->Args({ 50000, 10 });
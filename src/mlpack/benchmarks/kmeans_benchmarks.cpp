@@ -0,0 +1,66 @@
+/**
+ * @file kmeans_benchmarks.cpp
+ *
+ * Benchmarks of each k-means Lloyd step type.  The first argument of each run
+ * is the number of points, and the second is the number of clusters.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "benchmark.hpp"
+
+#include <mlpack/methods/kmeans/kmeans.hpp>
+#include <mlpack/methods/kmeans/elkan_kmeans.hpp>
+#include <mlpack/methods/kmeans/hamerly_kmeans.hpp>
+#include <mlpack/methods/kmeans/pelleg_moore_kmeans.hpp>
+#include <mlpack/methods/kmeans/dual_tree_kmeans.hpp>
+
+using namespace mlpack;
+using namespace mlpack::benchmark;
+using namespace mlpack::kmeans;
+
+/**
+ * Run 20 iterations of k-means on 5-dimensional Gaussian clusters, starting
+ * from the same centroids every time.
+ */
+template<template<class, class> class LloydStepType>
+static void BM_KMeans(State& state)
+{
+  const size_t points = state.Range(0);
+  const size_t clusters = state.Range(1);
+
+  // Each point is drawn from a Gaussian around a random center.
+  const arma::mat centers = 10 * arma::randu<arma::mat>(5, clusters);
+  arma::mat dataset = arma::randn<arma::mat>(5, points);
+  for (size_t i = 0; i < points; ++i)
+    dataset.col(i) += centers.col(i % clusters);
+
+  const arma::mat initialCentroids = dataset.cols(0, clusters - 1);
+
+  KMeans<metric::EuclideanDistance, SampleInitialization, MaxVarianceNewCluster,
+      LloydStepType> kmeans(20);
+  arma::mat centroids;
+  while (state.KeepRunning())
+  {
+    state.PauseTiming();
+    centroids = initialCentroids;
+    state.ResumeTiming();
+
+    kmeans.Cluster(dataset, clusters, centroids, true);
+  }
+  state.SetItemsProcessed(state.Iterations() * points);
+}
+MLPACK_BENCHMARK_NAMED("BM_KMeans<NaiveKMeans>", BM_KMeans<NaiveKMeans>)
+    ->Args({ 10000, 10 })->Args({ 100000, 50 });
+MLPACK_BENCHMARK_NAMED("BM_KMeans<ElkanKMeans>", BM_KMeans<ElkanKMeans>)
+    ->Args({ 10000, 10 })->Args({ 100000, 50 });
+MLPACK_BENCHMARK_NAMED("BM_KMeans<HamerlyKMeans>", BM_KMeans<HamerlyKMeans>)
+    ->Args({ 10000, 10 })->Args({ 100000, 50 });
+MLPACK_BENCHMARK_NAMED("BM_KMeans<DualTreeKMeans>",
+    BM_KMeans<DefaultDualTreeKMeans>)
+    ->Args({ 10000, 10 })->Args({ 100000, 50 });
+MLPACK_BENCHMARK_NAMED("BM_KMeans<PellegMooreKMeans>",
+    BM_KMeans<PellegMooreKMeans>)
+    ->Args({ 10000, 10 })->Args({ 100000, 50 });
@@ -0,0 +1,38 @@
+/**
+ * @file load_benchmarks.cpp
+ *
+ * Benchmarks of data::Load() on CSV files.  The first argument of each run is
+ * the number of points, and the second is the number of dimensions.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "benchmark.hpp"
+
+#include <cstdio>
+
+using namespace mlpack;
+using namespace mlpack::benchmark;
+
+/**
+ * Load a CSV file of uniform random numbers.  The file is written to the
+ * working directory before timing starts, and removed at the end.
+ */
+static void BM_LoadCSV(State& state)
+{
+  const std::string filename = "mlpack_benchmark_load.csv";
+  const arma::mat dataset = arma::randu<arma::mat>(state.Range(1),
+      state.Range(0));
+  data::Save(filename, dataset, true);
+
+  arma::mat loaded;
+  while (state.KeepRunning())
+    data::Load(filename, loaded, true);
+  state.SetItemsProcessed(state.Iterations() * dataset.n_cols);
+
+  std::remove(filename.c_str());
+}
+MLPACK_BENCHMARK(BM_LoadCSV)->Args({ 10000, 10 })->Args({ 100000, 50 })
+    ->Args({ 1000000, 10 });
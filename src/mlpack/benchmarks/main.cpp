@@ -0,0 +1,102 @@
+/**
+ * @file main.cpp
+ *
+ * Entry point of mlpack_benchmarks.  The options follow the ones of Google
+ * Benchmark:
+ *
+ *   --benchmark_filter=<regex>      only run the runs whose name matches
+ *   --benchmark_repetitions=<n>     run each run n times (default 3)
+ *   --benchmark_out=<file>          write the results as JSON to the file
+ *   --benchmark_seed=<n>            random seed (default 42)
+ *   --benchmark_list_tests          print the run names and exit
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "benchmark.hpp"
+
+// Count the allocations of each run; this must be in exactly one file.
+#include <mlpack/core/util/count_allocations.hpp>
+
+#include <fstream>
+
+using namespace mlpack;
+using namespace mlpack::benchmark;
+
+//! If the argument starts with the given flag, store its value.
+static bool ParseFlag(const std::string& arg,
+                      const std::string& flag,
+                      std::string& value)
+{
+  const std::string prefix = "--" + flag + "=";
+  if (arg.compare(0, prefix.size(), prefix) != 0)
+    return false;
+
+  value = arg.substr(prefix.size());
+  return true;
+}
+
+int main(int argc, char** argv)
+{
+  std::string filter = ".";
+  std::string out;
+  size_t repetitions = 3;
+  size_t seed = 42;
+  bool list = false;
+
+  for (int i = 1; i < argc; ++i)
+  {
+    const std::string arg(argv[i]);
+    std::string value;
+    if (ParseFlag(arg, "benchmark_filter", value))
+      filter = value;
+    else if (ParseFlag(arg, "benchmark_out", value))
+      out = value;
+    else if (ParseFlag(arg, "benchmark_repetitions", value))
+      repetitions = std::stoul(value);
+    else if (ParseFlag(arg, "benchmark_seed", value))
+      seed = std::stoul(value);
+    else if (arg == "--benchmark_list_tests")
+      list = true;
+    else
+    {
+      std::cerr << "Unknown option '" << arg << "'." << std::endl;
+      return 1;
+    }
+  }
+
+  if (list)
+  {
+    const std::vector<Benchmark*>& registry = Benchmark::Registry();
+    for (size_t b = 0; b < registry.size(); ++b)
+    {
+      if (registry[b]->ArgSets().empty())
+        std::cout << registry[b]->Name() << std::endl;
+
+      for (size_t a = 0; a < registry[b]->ArgSets().size(); ++a)
+        std::cout << RunName(*registry[b], registry[b]->ArgSets()[a])
+            << std::endl;
+    }
+
+    return 0;
+  }
+
+  const std::vector<RunResult> results = RunBenchmarks(filter,
+      std::max(repetitions, (size_t) 1), seed);
+
+  if (!out.empty())
+  {
+    std::ofstream stream(out.c_str());
+    if (!stream.is_open())
+    {
+      std::cerr << "Cannot open '" << out << "' for writing." << std::endl;
+      return 1;
+    }
+
+    WriteJSON(stream, results, seed);
+  }
+
+  return 0;
+}
@@ -0,0 +1,87 @@
+/**
+ * @file tree_benchmarks.cpp
+ *
+ * Benchmarks of tree building, k-nearest-neighbor search, and range search,
+ * for each tree type of NSModel and RSModel.  The first argument of each run is
+ * the tree type, and the second is the number of points.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "benchmark.hpp"
+
+#include <mlpack/methods/neighbor_search/ns_model.hpp>
+#include <mlpack/methods/range_search/rs_model.hpp>
+
+using namespace mlpack;
+using namespace mlpack::benchmark;
+using namespace mlpack::neighbor;
+using namespace mlpack::range;
+
+typedef NSModel<NearestNeighborSort> KNNModel;
+
+//! Build the tree of the given type on uniform random points.
+static void BM_TreeBuild(State& state)
+{
+  const KNNModel::TreeTypes treeType = (KNNModel::TreeTypes) state.Range(0);
+  const arma::mat dataset = arma::randu<arma::mat>(3, state.Range(1));
+
+  KNNModel model(treeType);
+  state.SetLabel(model.TreeName());
+  while (state.KeepRunning())
+  {
+    state.PauseTiming();
+    arma::mat referenceSet(dataset);
+    state.ResumeTiming();
+
+    model.BuildModel(std::move(referenceSet), 20, DUAL_TREE_MODE);
+  }
+  state.SetItemsProcessed(state.Iterations() * dataset.n_cols);
+}
+MLPACK_BENCHMARK(BM_TreeBuild)
+    ->DenseRange(KNNModel::KD_TREE, KNNModel::OCTREE + 1, { 10000 })
+    ->DenseRange(KNNModel::KD_TREE, KNNModel::OCTREE + 1, { 100000 });
+
+//! Search for the 5 nearest neighbors of every point, with a dual-tree search.
+static void BM_KNN(State& state)
+{
+  const KNNModel::TreeTypes treeType = (KNNModel::TreeTypes) state.Range(0);
+  arma::mat dataset = arma::randu<arma::mat>(3, state.Range(1));
+
+  KNNModel model(treeType);
+  state.SetLabel(model.TreeName());
+  model.BuildModel(std::move(dataset), 20, DUAL_TREE_MODE);
+
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  while (state.KeepRunning())
+    model.Search(5, neighbors, distances);
+  state.SetItemsProcessed(state.Iterations() * state.Range(1));
+}
+MLPACK_BENCHMARK(BM_KNN)
+    ->DenseRange(KNNModel::KD_TREE, KNNModel::OCTREE + 1, { 10000 })
+    ->DenseRange(KNNModel::KD_TREE, KNNModel::OCTREE + 1, { 100000 });
+
+//! Find all the neighbors of every point within a distance of 0.05, with a
+//! dual-tree search.  On average, each point has about 5 neighbors.
+static void BM_RangeSearch(State& state)
+{
+  const RSModel::TreeTypes treeType = (RSModel::TreeTypes) state.Range(0);
+  arma::mat dataset = arma::randu<arma::mat>(3, state.Range(1));
+
+  RSModel model(treeType);
+  state.SetLabel(model.TreeName());
+  model.BuildModel(std::move(dataset), 20, false, false);
+
+  const math::Range range(0.0, 0.05);
+  std::vector<std::vector<size_t>> neighbors;
+  std::vector<std::vector<double>> distances;
+  while (state.KeepRunning())
+    model.Search(range, neighbors, distances);
+  state.SetItemsProcessed(state.Iterations() * state.Range(1));
+}
+MLPACK_BENCHMARK(BM_RangeSearch)
+    ->DenseRange(RSModel::KD_TREE, RSModel::OCTREE + 1, { 10000 })
+    ->DenseRange(RSModel::KD_TREE, RSModel::OCTREE + 1, { 100000 });
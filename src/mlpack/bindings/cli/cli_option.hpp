@@ -24,6 +24,7 @@
 #include "string_type_param.hpp"
 #include "get_param.hpp"
 #include "get_raw_param.hpp"
+#include "is_model_param.hpp"
 #include "map_parameter_name.hpp"
 #include "set_param.hpp"
 #include "get_printable_param_name.hpp"
@@ -150,6 +151,8 @@ class CLIOption
         &GetPrintableParamName<N>;
     CLI::GetSingleton().functionMap[tname]["GetPrintableParamValue"] =
         &GetPrintableParamValue<N>;
+    CLI::GetSingleton().functionMap[tname]["IsModelParam"] =
+        &IsModelParam<N>;
   }
 };
 
@@ -10,20 +10,18 @@
 
 #include <mlpack/core/util/cli.hpp>
 
+#include <fstream>
+
 namespace mlpack {
 namespace bindings {
 namespace cli {
 
 /**
- * Handle command-line program termination.  If --help or --info was passed, we
- * won't make it here, so we don't have to write any contingencies for that.
+ * Print the values of the output parameters of simple types, and save the
+ * output matrices and models to their files.
  */
-inline void EndProgram()
+inline void OutputParams()
 {
-  // Stop the CLI timers.
-  CLI::GetSingleton().timer.StopAllTimers();
-
-  // Print any output.
   const std::map<std::string, util::ParamData>& parameters = CLI::Parameters();
   std::map<std::string, util::ParamData>::const_iterator it =
       parameters.begin();
@@ -35,13 +33,43 @@ inline void EndProgram()
 
     ++it;
   }
+}
+
+/**
+ * Handle command-line program termination.  If --help or --info was passed, we
+ * won't make it here, so we don't have to write any contingencies for that.
+ */
+inline void EndProgram()
+{
+  // Stop the CLI timers.
+  CLI::GetSingleton().timer.StopAllTimers();
+
+  // Write the timing report, if requested.
+  if (CLI::HasParam("timing"))
+  {
+    const std::string& filename = CLI::GetParam<std::string>("timing");
+    std::ofstream stream(filename);
+    if (stream.is_open())
+      CLI::GetSingleton().timer.WriteJSON(stream);
+    if (!stream.is_open() || stream.fail())
+    {
+      Log::Warn << "Could not write timing report to '" << filename << "'."
+          << std::endl;
+    }
+  }
+
+  // Print any output.
+  OutputParams();
 
   if (CLI::HasParam("verbose"))
   {
     Log::Info << std::endl << "Execution parameters:" << std::endl;
 
     // Print out all the values.
-    it = parameters.begin();
+    const std::map<std::string, util::ParamData>& parameters =
+        CLI::Parameters();
+    std::map<std::string, util::ParamData>::const_iterator it =
+        parameters.begin();
     while (it != parameters.end())
     {
       // Now, figure out what type it is, and print it.
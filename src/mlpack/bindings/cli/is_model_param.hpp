@@ -0,0 +1,42 @@
+/**
+ * @file is_model_param.hpp
+ *
+ * Determine whether a parameter holds a serializable model.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_BINDINGS_CLI_IS_MODEL_PARAM_HPP
+#define MLPACK_BINDINGS_CLI_IS_MODEL_PARAM_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace bindings {
+namespace cli {
+
+/**
+ * Store whether the parameter holds a model (that is, a serializable object
+ * that is not a matrix) in the given bool.  This is used by the server mode to
+ * keep loaded models between requests.
+ *
+ * @param d Parameter information (unused).
+ * @param input Unused parameter.
+ * @param output Pointer to a bool to store the result in.
+ */
+template<typename T>
+void IsModelParam(const util::ParamData& /* d */,
+                  const void* /* input */,
+                  void* output)
+{
+  *((bool*) output) = data::HasSerialize<T>::value &&
+      !arma::is_arma_type<T>::value;
+}
+
+} // namespace cli
+} // namespace bindings
+} // namespace mlpack
+
+#endif
@@ -22,12 +22,23 @@ PARAM_STRING_IN("info", "Get help on a specific module or option.", "", "");
 PARAM_FLAG("verbose", "Display informational messages and the full list of "
     "parameters and timers at the end of execution.", "v");
 PARAM_FLAG("version", "Display the version of mlpack.", "V");
+PARAM_STRING_IN("timing", "If specified, a JSON report of the program timers "
+    "(wall-clock and CPU time, peak memory, and allocation counts) is written "
+    "to this file at the end of execution.", "", "");
+PARAM_INT_IN("threads", "Maximum number of threads to use (0 uses one thread "
+    "per core, or the value of OMP_NUM_THREADS if it is set).", "", 0);
 
 /**
- * Parse the command line, setting all of the options inside of the CLI object
- * to their appropriate given values.
+ * Parse the given options, setting the corresponding parameters inside of the
+ * CLI object to their given values and marking them as passed.  The default
+ * options (--help, --version, and so forth) are not handled here, and required
+ * parameters are not checked.
+ *
+ * @param argc Number of options.
+ * @param argv Options; the first one is the program name.
+ * @return The names of the parameters that were passed.
  */
-void ParseCommandLine(int argc, char** argv)
+inline std::vector<std::string> ParseOptions(int argc, char** argv)
 {
   // First, we need to build the boost::program_options variables for parsing.
   using namespace boost::program_options;
@@ -103,6 +114,8 @@ void ParseCommandLine(int argc, char** argv)
         << std::endl;
   }
 
+  std::vector<std::string> passed;
+
   // Now iterate through the filled vmap, and overwrite default values with
   // anything that's found on the command line.
   for (variables_map::iterator i = vmap.begin(); i != vmap.end(); ++i)
@@ -114,6 +127,7 @@ void ParseCommandLine(int argc, char** argv)
     const std::string identifier = boostNameMap[i->first];
     util::ParamData& param = parameters[identifier];
     param.wasPassed = true;
+    passed.push_back(identifier);
     CLI::GetSingleton().functionMap[param.tname]["SetParam"](param,
         (void*) &vmap[i->first].value(), NULL);
   }
@@ -121,6 +135,40 @@ void ParseCommandLine(int argc, char** argv)
   // Flush the buffer, make sure changes are propagated to vmap.
   notify(vmap);
 
+  return passed;
+}
+
+/**
+ * Issue an error if any required parameter was not passed.
+ */
+inline void CheckRequiredParams()
+{
+  const std::map<std::string, util::ParamData>& parameters =
+      CLI::Parameters();
+  for (std::map<std::string, util::ParamData>::const_iterator iter =
+       parameters.begin(); iter != parameters.end(); ++iter)
+  {
+    const util::ParamData& d = iter->second;
+    if (d.required && !d.wasPassed)
+    {
+      std::string boostName;
+      CLI::GetSingleton().functionMap[d.tname]["MapParameterName"](d, NULL,
+          (void*) &boostName);
+
+      Log::Fatal << "Required option --" << boostName << " is undefined."
+          << std::endl;
+    }
+  }
+}
+
+/**
+ * Parse the command line, setting all of the options inside of the CLI object
+ * to their appropriate given values.
+ */
+void ParseCommandLine(int argc, char** argv)
+{
+  ParseOptions(argc, argv);
+
   // If the user specified any of the default options (--help, --version, or
   // --info), handle those.
 
@@ -169,24 +217,17 @@ void ParseCommandLine(int argc, char** argv)
     Log::Info.ignoreInput = false;
   }
 
-  // Now, issue an error if we forgot any required options.
-  for (std::map<std::string, util::ParamData>::const_iterator iter =
-       parameters.begin(); iter != parameters.end(); ++iter)
+  // Set the thread budget of the program.
+  const int threads = CLI::GetParam<int>("threads");
+  if (threads < 0)
   {
-    const util::ParamData d = iter->second;
-    if (d.required)
-    {
-      const std::string boostName;
-      CLI::GetSingleton().functionMap[d.tname]["MapParameterName"](d, NULL,
-          (void*) &boostName);
-
-      if (!vmap.count(boostName))
-      {
-        Log::Fatal << "Required option --" << boostName << " is undefined."
-            << std::endl;
-      }
-    }
+    Log::Fatal << "Invalid value for --threads (" << threads << "); it must "
+        << "be 0 or greater." << std::endl;
   }
+  Parallel::SetMaxThreads((size_t) threads);
+
+  // Now, issue an error if we forgot any required options.
+  CheckRequiredParams();
 }
 
 } // namespace cli
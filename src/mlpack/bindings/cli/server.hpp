@@ -0,0 +1,202 @@
+/**
+ * @file server.hpp
+ *
+ * Run a command-line program as a server that answers many requests, so that
+ * input models are loaded only once.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_BINDINGS_CLI_SERVER_HPP
+#define MLPACK_BINDINGS_CLI_SERVER_HPP
+
+#include <mlpack/core.hpp>
+#include "parse_command_line.hpp"
+#include "end_program.hpp"
+
+namespace mlpack {
+namespace bindings {
+namespace cli {
+
+/**
+ * Split a request line into options, the way a shell would: options are
+ * separated by whitespace, and single quotes, double quotes, and backslashes
+ * can be used to include whitespace in an option.
+ *
+ * @param line Request line.
+ * @return The options in the line.
+ */
+inline std::vector<std::string> SplitRequest(const std::string& line)
+{
+  std::vector<std::string> options;
+  std::string option;
+  bool inOption = false;
+  char quote = '\0';
+  for (size_t i = 0; i < line.size(); ++i)
+  {
+    const char c = line[i];
+    if (quote != '\0')
+    {
+      if (c == quote)
+        quote = '\0';
+      else if (c == '\\' && quote == '"' && i + 1 < line.size())
+        option += line[++i];
+      else
+        option += c;
+    }
+    else if (c == '\'' || c == '"')
+    {
+      quote = c;
+      inOption = true;
+    }
+    else if (c == '\\' && i + 1 < line.size())
+    {
+      option += line[++i];
+      inOption = true;
+    }
+    else if (std::isspace((unsigned char) c))
+    {
+      if (inOption)
+        options.push_back(option);
+      option.clear();
+      inOption = false;
+    }
+    else
+    {
+      option += c;
+      inOption = true;
+    }
+  }
+
+  if (quote != '\0')
+    throw std::invalid_argument("unterminated quote in request");
+  if (inOption)
+    options.push_back(option);
+
+  return options;
+}
+
+/**
+ * Run the given program as a server.  Each line read from the given stream is
+ * a request, holding options given the same way as on the command line.  The
+ * options of a request are added to the options the server was started with,
+ * then the program is run and its outputs are written as usual, and a line
+ * "mlpack: ok" (or "mlpack: error: <message>" if the request failed) is
+ * printed to stdout to mark the end of the response.  The server stops on end
+ * of input or when it reads a line "quit".
+ *
+ * Input models that were loaded by a request are kept for the next requests,
+ * unless a request passes another model file.  So, the program must use its
+ * input models in place: it must not move them out or modify them.  Input
+ * matrices are loaded again for each request, so a batch of points can be
+ * passed in each request.
+ *
+ * This should be called after ParseCommandLine().
+ *
+ * @param mainFunction The main function of the program.
+ * @param stream Stream to read the requests from.
+ */
+template<typename MainFunctionType>
+void RunServer(MainFunctionType mainFunction, std::istream& stream = std::cin)
+{
+  std::map<std::string, util::ParamData>& parameters = CLI::Parameters();
+
+  // The parameters as given on the command line.  Input models haven't been
+  // loaded yet, so this copy is cheap.
+  const std::map<std::string, util::ParamData> baseParameters = parameters;
+  const std::string programName = CLI::ProgramName();
+
+  // The input models loaded by earlier requests.  These are only put back
+  // into the parameters once we know that the request does not pass another
+  // file for them.
+  std::map<std::string, util::ParamData> loadedModels;
+
+  std::string line;
+  while (std::getline(stream, line))
+  {
+    std::vector<std::string> passed;
+    try
+    {
+      std::vector<std::string> options = SplitRequest(line);
+      if (options.empty())
+        continue;
+      if (options.size() == 1 && (options[0] == "quit" ||
+          options[0] == "exit"))
+        break;
+
+      std::vector<char*> argv(1, const_cast<char*>(programName.c_str()));
+      for (size_t i = 0; i < options.size(); ++i)
+        argv.push_back(const_cast<char*>(options[i].c_str()));
+
+      passed = ParseOptions(argv.size(), argv.data());
+
+      // A model file given in the request replaces the model loaded earlier;
+      // the parameter as parsed is not loaded yet, so GetParam() will load the
+      // new file.
+      std::map<std::string, util::ParamData>::iterator m =
+          loadedModels.begin();
+      while (m != loadedModels.end())
+      {
+        if (std::find(passed.begin(), passed.end(), m->first) != passed.end())
+        {
+          m = loadedModels.erase(m);
+        }
+        else
+        {
+          std::swap(parameters[m->first], m->second);
+          ++m;
+        }
+      }
+
+      for (size_t i = 0; i < passed.size(); ++i)
+      {
+        if (passed[i] == "help" || passed[i] == "info" ||
+            passed[i] == "version" || passed[i] == "server" ||
+            passed[i] == "timing" || passed[i] == "threads")
+        {
+          Log::Fatal << "Option --" << passed[i] << " cannot be given in a "
+              << "request." << std::endl;
+        }
+      }
+      CheckRequiredParams();
+
+      mainFunction();
+      OutputParams();
+
+      std::cout << "mlpack: ok" << std::endl;
+    }
+    catch (std::exception& e)
+    {
+      // Timers may have been left running by the failed request.
+      CLI::GetSingleton().timer.StopAllTimers();
+      Timer::Start("total_time");
+
+      std::cout << "mlpack: error: " << e.what() << std::endl;
+    }
+
+    // Go back to the options the server was started with, but set aside the
+    // input models that are loaded, so that the next request can reuse them.
+    std::map<std::string, util::ParamData>::const_iterator it =
+        baseParameters.begin();
+    for ( ; it != baseParameters.end(); ++it)
+    {
+      util::ParamData& d = parameters[it->first];
+      bool isModel = false;
+      CLI::GetSingleton().functionMap[d.tname]["IsModelParam"](d, NULL,
+          (void*) &isModel);
+
+      if (isModel && d.input && d.loaded)
+        std::swap(loadedModels[it->first], d);
+
+      d = it->second;
+    }
+  }
+}
+
+} // namespace cli
+} // namespace bindings
+} // namespace mlpack
+
+#endif
@@ -18,15 +18,19 @@ import numpy
 
 numpy.import_array()
 
+from libcpp cimport bool
+
 cimport arma
 
 """
-Convert a numpy ndarray to a matrix.
+Convert a numpy ndarray to a matrix.  If takeOwnership is true and the ndarray
+owns its memory, the matrix takes ownership of it; otherwise, the matrix uses
+the memory of the ndarray without copying it.
 """
-cdef arma.Mat[double]* numpy_to_mat_d(numpy.ndarray[numpy.double_t, ndim=2] X) \
-    except +
-cdef arma.Mat[size_t]* numpy_to_mat_s(numpy.ndarray[numpy.npy_intp, ndim=2] X) \
-    except +
+cdef arma.Mat[double]* numpy_to_mat_d(numpy.ndarray[numpy.double_t, ndim=2] X,
+    bool takeOwnership) except +
+cdef arma.Mat[size_t]* numpy_to_mat_s(numpy.ndarray[numpy.npy_intp, ndim=2] X,
+    bool takeOwnership) except +
 
 """
 Convert an Armadillo object to a numpy ndarray of the given type.
@@ -39,10 +43,10 @@ cdef numpy.ndarray[numpy.npy_intp, ndim=2] mat_to_numpy_s(arma.Mat[size_t]& X) \
 """
 Convert a numpy one-dimensional ndarray to a row of the given type.
 """
-cdef arma.Row[double]* numpy_to_row_d(numpy.ndarray[numpy.double_t, ndim=1] X) \
-    except +
-cdef arma.Row[size_t]* numpy_to_row_s(numpy.ndarray[numpy.npy_intp, ndim=1] X) \
-    except +
+cdef arma.Row[double]* numpy_to_row_d(numpy.ndarray[numpy.double_t, ndim=1] X,
+    bool takeOwnership) except +
+cdef arma.Row[size_t]* numpy_to_row_s(numpy.ndarray[numpy.npy_intp, ndim=1] X,
+    bool takeOwnership) except +
 
 """
 Convert an Armadillo row vector to a one-dimensional numpy ndarray of the
@@ -56,10 +60,10 @@ cdef numpy.ndarray[numpy.npy_intp, ndim=1] row_to_numpy_s(arma.Row[size_t]& X) \
 """
 Convert a numpy one-dimensional ndarray to a column vector of the given type.
 """
-cdef arma.Col[double]* numpy_to_col_d(numpy.ndarray[numpy.double_t, ndim=1] X) \
-    except +
-cdef arma.Col[size_t]* numpy_to_col_s(numpy.ndarray[numpy.npy_intp, ndim=1] X) \
-    except +
+cdef arma.Col[double]* numpy_to_col_d(numpy.ndarray[numpy.double_t, ndim=1] X,
+    bool takeOwnership) except +
+cdef arma.Col[size_t]* numpy_to_col_s(numpy.ndarray[numpy.npy_intp, ndim=1] X,
+    bool takeOwnership) except +
 
 """
 Convert an Armadillo column vector to a one-dimensional numpy ndarray of the
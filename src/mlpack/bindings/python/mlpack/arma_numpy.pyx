@@ -4,10 +4,12 @@ arma_numpy.pyx: Armadillo/numpy interface functionality.
 
 This file defines a number of functions useful for converting between Armadillo
 and numpy objects without actually copying memory.  Note that if a numpy matrix
-is converted to an Armadillo object, then the Armadillo object will "own" the
-matrix and free the memory upon destruction (and the numpy object will no longer
-"own" the matrix).  Similarly, if an Armadillo object is converted to a numpy
-object, then the numpy object will "own" the matrix.
+is converted to an Armadillo object with takeOwnership set, then the Armadillo
+object will "own" the matrix and free the memory upon destruction (and the numpy
+object will no longer "own" the matrix); otherwise, the Armadillo object only
+borrows the memory of the numpy matrix.  Similarly, if an Armadillo object that
+owns its memory is converted to a numpy object, then the numpy object will "own"
+the matrix.
 
 Thus, know that if you convert a matrix type, remember that the resulting type
 is what "owns" the allocated memory.
@@ -23,6 +25,8 @@ import numpy
 
 numpy.import_array()
 
+from libcpp cimport bool
+
 cimport arma
 
 cdef extern from "numpy/arrayobject.h":
@@ -38,38 +42,47 @@ cdef extern from "<mlpack/bindings/python/mlpack/arma_util.hpp>":
   size_t* GetMemory(arma.Col[size_t]& m)
   size_t* GetMemory(arma.Row[size_t]& m)
 
-cdef arma.Mat[double]* numpy_to_mat_d(numpy.ndarray[numpy.double_t, ndim=2] X) \
-    except +:
+cdef arma.Mat[double]* numpy_to_mat_d(numpy.ndarray[numpy.double_t, ndim=2] X,
+    bool takeOwnership) except +:
   """
-  Convert a numpy ndarray to a matrix.
+  Convert a numpy ndarray to a matrix.  If takeOwnership is true and X owns
+  its memory, the result takes ownership of it; otherwise, the result uses
+  the memory of X without copying it, so X must outlive the result.
   """
-  if not (X.flags.c_contiguous or X.flags.owndata):
+  if not X.flags.c_contiguous:
     # If needed, make a copy where we own the memory.
     X = X.copy(order="C")
+    takeOwnership = True
 
-  cdef arma.Mat[double]* m = new arma.Mat[double](<double*> X.data, X.shape[1], X.shape[0], False, True)
+  cdef arma.Mat[double]* m = new arma.Mat[double](<double*> X.data, X.shape[1],
+      X.shape[0], False, False)
 
-  # Transfer ownership to the Armadillo matrix.
-  PyArray_CLEARFLAGS(X, numpy.NPY_OWNDATA)
-  SetMemState[arma.Mat[double]](m[0], 0)
+  if takeOwnership and X.flags.owndata:
+    # Transfer ownership to the Armadillo matrix.
+    PyArray_CLEARFLAGS(X, numpy.NPY_OWNDATA)
+    SetMemState[arma.Mat[double]](m[0], 0)
 
   return m
 
-cdef arma.Mat[size_t]* numpy_to_mat_s(numpy.ndarray[numpy.npy_intp, ndim=2] X) \
-    except +:
+cdef arma.Mat[size_t]* numpy_to_mat_s(numpy.ndarray[numpy.npy_intp, ndim=2] X,
+    bool takeOwnership) except +:
   """
-  Convert a numpy ndarray to a matrix.
+  Convert a numpy ndarray to a matrix.  If takeOwnership is true and X owns
+  its memory, the result takes ownership of it; otherwise, the result uses
+  the memory of X without copying it, so X must outlive the result.
   """
-  if not (X.flags.c_contiguous or X.flags.owndata):
+  if not X.flags.c_contiguous:
     # If needed, make a copy where we own the memory.
     X = X.copy(order="C")
+    takeOwnership = True
 
   cdef arma.Mat[size_t]* m = new arma.Mat[size_t](<size_t*> X.data, X.shape[1],
-      X.shape[0], False, True)
+      X.shape[0], False, False)
 
-  # Transfer ownership to the Armadillo matrix.
-  PyArray_CLEARFLAGS(X, numpy.NPY_OWNDATA)
-  SetMemState[arma.Mat[size_t]](m[0], 0)
+  if takeOwnership and X.flags.owndata:
+    # Transfer ownership to the Armadillo matrix.
+    PyArray_CLEARFLAGS(X, numpy.NPY_OWNDATA)
+    SetMemState[arma.Mat[size_t]](m[0], 0)
 
   return m
 
@@ -109,39 +122,47 @@ cdef numpy.ndarray[numpy.npy_intp, ndim=2] mat_to_numpy_s(arma.Mat[size_t]& X) \
 
   return output
 
-cdef arma.Row[double]* numpy_to_row_d(numpy.ndarray[numpy.double_t, ndim=1] X) \
-    except +:
+cdef arma.Row[double]* numpy_to_row_d(numpy.ndarray[numpy.double_t, ndim=1] X,
+    bool takeOwnership) except +:
   """
-  Convert a numpy one-dimensional ndarray to a row.
+  Convert a numpy one-dimensional ndarray to a row.  If takeOwnership is true
+  and X owns its memory, the result takes ownership of it; otherwise, the
+  result uses the memory of X without copying it, so X must outlive the result.
   """
-  if not (X.flags.c_contiguous or X.flags.owndata):
+  if not X.flags.c_contiguous:
     # If needed, make a copy where we own the memory.
     X = X.copy(order="C")
+    takeOwnership = True
 
   cdef arma.Row[double]* m = new arma.Row[double](<double*> X.data, X.shape[0],
-      False, True)
+      False, False)
 
-  # Transfer ownership to the Armadillo matrix.
-  PyArray_CLEARFLAGS(X, numpy.NPY_OWNDATA)
-  SetMemState[arma.Row[double]](m[0], 0)
+  if takeOwnership and X.flags.owndata:
+    # Transfer ownership to the Armadillo matrix.
+    PyArray_CLEARFLAGS(X, numpy.NPY_OWNDATA)
+    SetMemState[arma.Row[double]](m[0], 0)
 
   return m
 
-cdef arma.Row[size_t]* numpy_to_row_s(numpy.ndarray[numpy.npy_intp, ndim=1] X) \
-    except +:
+cdef arma.Row[size_t]* numpy_to_row_s(numpy.ndarray[numpy.npy_intp, ndim=1] X,
+    bool takeOwnership) except +:
   """
-  Convert a numpy one-dimensional ndarray to a row.
+  Convert a numpy one-dimensional ndarray to a row.  If takeOwnership is true
+  and X owns its memory, the result takes ownership of it; otherwise, the
+  result uses the memory of X without copying it, so X must outlive the result.
   """
-  if not (X.flags.c_contiguous or X.flags.owndata):
+  if not X.flags.c_contiguous:
     # If needed, make a copy where we own the memory.
     X = X.copy(order="C")
+    takeOwnership = True
 
   cdef arma.Row[size_t]* m = new arma.Row[size_t](<size_t*> X.data, X.shape[0],
-      False, True)
+      False, False)
 
-  # Transfer ownership to the Armadillo matrix.
-  PyArray_CLEARFLAGS(X, numpy.NPY_OWNDATA)
-  SetMemState[arma.Row[size_t]](m[0], 0)
+  if takeOwnership and X.flags.owndata:
+    # Transfer ownership to the Armadillo matrix.
+    PyArray_CLEARFLAGS(X, numpy.NPY_OWNDATA)
+    SetMemState[arma.Row[size_t]](m[0], 0)
 
   return m
 
@@ -177,39 +198,49 @@ cdef numpy.ndarray[numpy.npy_intp, ndim=1] row_to_numpy_s(arma.Row[size_t]& X) \
 
   return output
 
-cdef arma.Col[double]* numpy_to_col_d(numpy.ndarray[numpy.double_t, ndim=1] X) \
-    except +:
+cdef arma.Col[double]* numpy_to_col_d(numpy.ndarray[numpy.double_t, ndim=1] X,
+    bool takeOwnership) except +:
   """
-  Convert a numpy one-dimensional ndarray to a column vector.
+  Convert a numpy one-dimensional ndarray to a column vector.  If takeOwnership
+  is true and X owns its memory, the result takes ownership of it; otherwise,
+  the result uses the memory of X without copying it, so X must outlive the
+  result.
   """
-  if not (X.flags.c_contiguous or X.flags.owndata):
+  if not X.flags.c_contiguous:
     # If needed, make a copy where we own the memory.
     X = X.copy(order="C")
+    takeOwnership = True
 
   cdef arma.Col[double]* m = new arma.Col[double](<double*> X.data, X.shape[0],
-      False, True)
+      False, False)
 
-  # Transfer ownership to the Armadillo matrix.
-  PyArray_CLEARFLAGS(X, numpy.NPY_OWNDATA)
-  SetMemState[arma.Col[double]](m[0], 0)
+  if takeOwnership and X.flags.owndata:
+    # Transfer ownership to the Armadillo matrix.
+    PyArray_CLEARFLAGS(X, numpy.NPY_OWNDATA)
+    SetMemState[arma.Col[double]](m[0], 0)
 
   return m
 
-cdef arma.Col[size_t]* numpy_to_col_s(numpy.ndarray[numpy.npy_intp, ndim=1] X) \
-    except +:
+cdef arma.Col[size_t]* numpy_to_col_s(numpy.ndarray[numpy.npy_intp, ndim=1] X,
+    bool takeOwnership) except +:
   """
-  Convert a numpy one-dimensional ndarray to a column vector.
+  Convert a numpy one-dimensional ndarray to a column vector.  If takeOwnership
+  is true and X owns its memory, the result takes ownership of it; otherwise,
+  the result uses the memory of X without copying it, so X must outlive the
+  result.
   """
-  if not (X.flags.c_contiguous or X.flags.owndata):
+  if not X.flags.c_contiguous:
     # If needed, make a copy where we own the memory.
     X = X.copy(order="C")
+    takeOwnership = True
 
   cdef arma.Col[size_t]* m = new arma.Col[size_t](<size_t*> X.data, X.shape[0],
-      False, True)
+      False, False)
 
-  # Transfer ownership to the Armadillo matrix.
-  PyArray_CLEARFLAGS(X, numpy.NPY_OWNDATA)
-  SetMemState[arma.Col[size_t]](m[0], 0)
+  if takeOwnership and X.flags.owndata:
+    # Transfer ownership to the Armadillo matrix.
+    PyArray_CLEARFLAGS(X, numpy.NPY_OWNDATA)
+    SetMemState[arma.Col[size_t]](m[0], 0)
 
   return m
 
@@ -26,13 +26,15 @@ void SetMemState(T& t, int state)
 
 /**
  * Return the matrix's allocated memory pointer, unless the matrix is using its
- * internal preallocated memory, in which case we copy that and return a
- * pointer to the memory we just made.
+ * internal preallocated memory or memory it does not own (for instance, the
+ * memory of a numpy array it was given as input), in which case we copy that
+ * and return a pointer to the memory we just made.
  */
 template<typename T>
 inline typename T::elem_type* GetMemory(T& m)
 {
-  if (m.mem && m.n_elem <= arma::arma_config::mat_prealloc)
+  if (m.mem && (m.n_elem <= arma::arma_config::mat_prealloc ||
+      m.mem_state != 0))
   {
     // We need to allocate new memory.
     typename T::elem_type* mem =
@@ -35,18 +35,37 @@ inline void SetParam(const std::string& identifier, const T& value)
 }
 
 /**
- * Set the parameter (which is a matrix/DatasetInfo tuple) to the given value.
+ * Set the parameter to the object pointed to by the given pointer, moving it
+ * so that no copy is made (a matrix that uses the memory of a numpy array
+ * will keep using it), and delete the pointer.
+ *
+ * @param identifier Name of parameter.
+ * @param value Pointer to the object to set the parameter to; it is deleted.
+ */
+template<typename T>
+inline void SetParamPtr(const std::string& identifier, T* value)
+{
+  CLI::GetParam<T>(identifier) = std::move(*value);
+  delete value;
+}
+
+/**
+ * Set the parameter (which is a matrix/DatasetInfo tuple) to the matrix
+ * pointed to by the given pointer.  As with SetParamPtr(), the matrix is moved
+ * and the pointer is deleted.
  */
 template<typename T>
 inline void SetParamWithInfo(const std::string& identifier,
-                             const T& matrix,
+                             T* matrixPtr,
                              const bool* dims)
 {
   typedef typename std::tuple<data::DatasetInfo, T> TupleType;
   typedef typename T::elem_type eT;
 
   // The true type of the parameter is std::tuple<T, DatasetInfo>.
-  std::get<1>(CLI::GetParam<TupleType>(identifier)) = matrix;
+  T& matrix = std::get<1>(CLI::GetParam<TupleType>(identifier));
+  matrix = std::move(*matrixPtr);
+  delete matrixPtr;
   data::DatasetInfo& di = std::get<0>(CLI::GetParam<TupleType>(identifier));
   di = data::DatasetInfo(matrix.n_rows);
 
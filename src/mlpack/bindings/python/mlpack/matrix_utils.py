@@ -25,9 +25,12 @@ elif int(pd.__version__.split('.')[1]) == 17:
 elif int(pd.__version__.split('.')[1]) >= 15:
   from pandas.core.common import CategoricalDtype
 
-def to_matrix(x, dtype=np.double):
+def to_matrix(x, dtype=np.double, copy=False):
   """
-  Given some array-like X, return a numpy ndarray of the same type.
+  Given some array-like X, return a numpy ndarray of the same type.  If X is
+  already a C-contiguous ndarray of the right type (or of uint64 type, when
+  dtype is np.intp, since those have the same representation), X itself (or a
+  view of it) is returned and no copy is made, unless copy is True.
   """
   # Make sure it's array-like at all.
   if not hasattr(x, '__len__') and \
@@ -35,15 +38,20 @@ def to_matrix(x, dtype=np.double):
       not hasattr(x, '__array__'):
     raise TypeError("given argument is not array-like")
 
-  if (isinstance(x, np.ndarray) and x.dtype == dtype and x.flags.c_contiguous):
-    return x
-  else:
-    return np.array(x, copy=True, dtype=dtype, order='C')
+  if (isinstance(x, np.ndarray) and x.flags.c_contiguous and not copy):
+    if x.dtype == dtype:
+      return x
+    elif dtype == np.intp and x.dtype == np.uint64 and \
+        x.dtype.itemsize == np.dtype(np.intp).itemsize:
+      return x.view(np.intp)
 
-def to_matrix_with_info(x, dtype):
+  return np.array(x, copy=True, dtype=dtype, order='C')
+
+def to_matrix_with_info(x, dtype, copy=False):
   """
   Given some array-like X (which should be either a numpy ndarray or a pandas
-  DataFrame, convert into a numpy matrix of the given dtype.
+  DataFrame, convert into a numpy matrix of the given dtype.  As with
+  to_matrix(), a numpy ndarray is not copied unless copy is True.
   """
   # Make sure it's array-like at all.
   if not hasattr(x, '__len__') and \
@@ -54,7 +62,7 @@ def to_matrix_with_info(x, dtype):
   if isinstance(x, np.ndarray):
     # It is already an ndarray, so the vector of info is all 0s (all numeric).
     d = np.zeros([x.shape[1]], dtype=np.bool)
-    return (x, d)
+    return (to_matrix(x, dtype=dtype, copy=copy), d)
 
   if isinstance(x, pd.DataFrame) or isinstance(x, pd.Series):
     # It's a pandas dataframe.  So we need to see if any of the dtypes are
@@ -90,38 +90,37 @@ void PrintInputProcessing(
    *
    * # Detect if the parameter was passed; set if so.
    * if param_name is not None:
-   *   param_name_mat = arma_numpy.numpy_to_mat_d(param_name)
-   *   SetParam[mat](<const string> 'param_name', dereference(param_name_mat))
+   *   param_name_arr = to_matrix(param_name, dtype=np.double,
+   *       copy=copy_all_inputs)
+   *   param_name_mat = arma_numpy.numpy_to_mat_d(param_name_arr,
+   *       param_name_arr is not param_name)
+   *   SetParamPtr[mat](<const string> 'param_name', param_name_mat)
    *   CLI.SetPassed(<const string> 'param_name')
+   *
+   * If copy_all_inputs is False and param_name is a contiguous numpy array of
+   * the right type, the matrix uses its memory, and no copy is made;
+   * otherwise, the matrix takes ownership of the copy made by to_matrix().
    */
   std::cout << prefix << "# Detect if the parameter was passed; set if so."
       << std::endl;
+  std::string innerPrefix = prefix;
   if (!d.required)
   {
     std::cout << prefix << "if " << d.name << " is not None:" << std::endl;
-
-    std::cout << prefix << "  " << d.name << "_mat = arma_numpy.numpy_to_"
-        << GetArmaType<T>() << "_" << GetNumpyTypeChar<T>() << "(to_matrix("
-        << d.name << ", " << "dtype=" << GetNumpyType<typename T::elem_type>()
-        << "))" << std::endl;
-    std::cout << prefix << "  SetParam[" << GetCythonType<T>(d) << "](<const "
-        << "string> '" << d.name << "', dereference(" << d.name << "_mat))"
-        << std::endl;
-    std::cout << prefix << "  CLI.SetPassed(<const string> '" << d.name << "')"
-        << std::endl;
-  }
-  else
-  {
-    std::cout << prefix << d.name << "_mat = arma_numpy.numpy_to_"
-        << GetArmaType<T>() << "_" << GetNumpyTypeChar<T>() << "(to_matrix("
-        << d.name << ", " << "dtype=" << GetNumpyType<typename T::elem_type>()
-        << "))" << std::endl;
-    std::cout << prefix << "SetParam[" << GetCythonType<T>(d) << "](<const "
-        << "string> '" << d.name << "', dereference(" << d.name << "_mat))"
-        << std::endl;
-    std::cout << prefix << "CLI.SetPassed(<const string> '" << d.name << "')"
-        << std::endl;
+    innerPrefix += "  ";
   }
+
+  std::cout << innerPrefix << d.name << "_arr = to_matrix(" << d.name
+      << ", dtype=" << GetNumpyType<typename T::elem_type>()
+      << ", copy=copy_all_inputs)" << std::endl;
+  std::cout << innerPrefix << d.name << "_mat = arma_numpy.numpy_to_"
+      << GetArmaType<T>() << "_" << GetNumpyTypeChar<T>() << "(" << d.name
+      << "_arr, " << d.name << "_arr is not " << d.name << ")" << std::endl;
+  std::cout << innerPrefix << "SetParamPtr[" << GetCythonType<T>(d)
+      << "](<const string> '" << d.name << "', " << d.name << "_mat)"
+      << std::endl;
+  std::cout << innerPrefix << "CLI.SetPassed(<const string> '" << d.name
+      << "')" << std::endl;
   std::cout << std::endl;
 }
 
@@ -213,44 +212,37 @@ void PrintInputProcessing(
   /** We want to generate code like the following:
    *
    * if param_name is not None:
-   *   param_name_tuple = to_matrix_with_info(param_name)
-   *   param_name_mat = arma_numpy.numpy_to_matrix_d(param_name_tuple[0])
-   *   SetParamWithInfo[mat](<const string> 'param_name',
-   *       dereference(param_name_mat), &param_name_tuple[1][0])
+   *   param_name_tuple = to_matrix_with_info(param_name, dtype=np.double,
+   *       copy=copy_all_inputs)
+   *   param_name_mat = arma_numpy.numpy_to_mat_d(param_name_tuple[0],
+   *       param_name_tuple[0] is not param_name)
+   *   param_name_dims = param_name_tuple[1]
+   *   SetParamWithInfo[mat](<const string> 'param_name', param_name_mat,
+   *       <const bool*> param_name_dims.data)
    *   CLI.SetPassed(<const string> 'param_name')
    */
   std::cout << prefix << "cdef np.ndarray " << d.name << "_dims" << std::endl;
   std::cout << prefix << "# Detect if the parameter was passed; set if so."
       << std::endl;
+  std::string innerPrefix = prefix;
   if (!d.required)
   {
     std::cout << prefix << "if " << d.name << " is not None:" << std::endl;
-    std::cout << prefix << "  " << d.name << "_tuple = to_matrix_with_info("
-        << d.name << ", dtype=np.double)" << std::endl;
-    std::cout << prefix << "  " << d.name << "_mat = arma_numpy.numpy_to_mat_d("
-        << d.name << "_tuple[0])" << std::endl;
-    std::cout << prefix << "  " << d.name << "_dims = " << d.name << "_tuple[1]"
-        << std::endl;
-    std::cout << prefix << "  SetParamWithInfo[arma.Mat[double]](<const string>"
-        << " '" << d.name << "', dereference(" << d.name << "_mat), <const "
-        << "bool*> " << d.name << "_dims.data)" << std::endl;
-    std::cout << prefix << "  CLI.SetPassed(<const string> '" << d.name << "')"
-        << std::endl;
-  }
-  else
-  {
-    std::cout << prefix << d.name << "_tuple = to_matrix_with_info(" << d.name
-        << ", dtype=np.double)" << std::endl;
-    std::cout << prefix << d.name << "_mat = arma_numpy.numpy_to_mat_d("
-        << d.name << "_tuple[0])" << std::endl;
-    std::cout << prefix << d.name << "_dims = " << d.name << "_tuple[1]"
-        << std::endl;
-    std::cout << prefix << "SetParamWithInfo[arma.Mat[double]](<const string>"
-        << " '" << d.name << "', dereference(" << d.name << "_mat), <const "
-        << "bool*> " << d.name << "_dims.data)" << std::endl;
-    std::cout << prefix << "CLI.SetPassed(<const string> '" << d.name << "')"
-        << std::endl;
+    innerPrefix += "  ";
   }
+
+  std::cout << innerPrefix << d.name << "_tuple = to_matrix_with_info("
+      << d.name << ", dtype=np.double, copy=copy_all_inputs)" << std::endl;
+  std::cout << innerPrefix << d.name << "_mat = arma_numpy.numpy_to_mat_d("
+      << d.name << "_tuple[0], " << d.name << "_tuple[0] is not " << d.name
+      << ")" << std::endl;
+  std::cout << innerPrefix << d.name << "_dims = " << d.name << "_tuple[1]"
+      << std::endl;
+  std::cout << innerPrefix << "SetParamWithInfo[arma.Mat[double]](<const "
+      << "string> '" << d.name << "', " << d.name << "_mat, <const bool*> "
+      << d.name << "_dims.data)" << std::endl;
+  std::cout << innerPrefix << "CLI.SetPassed(<const string> '" << d.name
+      << "')" << std::endl;
   std::cout << std::endl;
 }
 
@@ -0,0 +1,101 @@
+/**
+ * @file print_input_restore.hpp
+ *
+ * Print the code that gives an input model back to its Python object after the
+ * program has run, for generating a .pyx binding.
+ */
+#ifndef MLPACK_BINDINGS_PYTHON_PRINT_INPUT_RESTORE_HPP
+#define MLPACK_BINDINGS_PYTHON_PRINT_INPUT_RESTORE_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "strip_type.hpp"
+
+namespace mlpack {
+namespace bindings {
+namespace python {
+
+/**
+ * Only serializable models are moved into the parameters, so this prints
+ * nothing.
+ */
+template<typename T>
+void PrintInputRestore(
+    const util::ParamData& /* d */,
+    const size_t /* indent */,
+    const typename boost::disable_if<arma::is_arma_type<T>>::type* = 0,
+    const typename boost::disable_if<data::HasSerialize<T>>::type* = 0)
+{
+  // Do nothing.
+}
+
+/**
+ * Matrices are not moved into the parameters, so this prints nothing.
+ */
+template<typename T>
+void PrintInputRestore(
+    const util::ParamData& /* d */,
+    const size_t /* indent */,
+    const typename boost::enable_if<arma::is_arma_type<T>>::type* = 0)
+{
+  // Do nothing.
+}
+
+/**
+ * Print the code that moves a serializable input model back to its Python
+ * object, so that the object can be passed to the next call without being
+ * copied or serialized.
+ */
+template<typename T>
+void PrintInputRestore(
+    const util::ParamData& d,
+    const size_t indent,
+    const typename boost::disable_if<arma::is_arma_type<T>>::type* = 0,
+    const typename boost::enable_if<data::HasSerialize<T>>::type* = 0)
+{
+  std::string strippedType, printedType, defaultsType;
+  StripType(d.cppType, strippedType, printedType, defaultsType);
+
+  const std::string prefix(indent, ' ');
+
+  /**
+   * This gives us code like:
+   *
+   * if param_name is not None:
+   *   MoveToPtr[Model]((<ModelType> param_name).modelptr,
+   *       CLI.GetParam[Model]('param_name'))
+   *
+   * The type of param_name was already checked by the input processing.
+   */
+  std::string innerPrefix = prefix;
+  if (!d.required)
+  {
+    std::cout << prefix << "if " << d.name << " is not None:" << std::endl;
+    innerPrefix += "  ";
+  }
+
+  std::cout << innerPrefix << "MoveToPtr[" << strippedType << "]((<"
+      << strippedType << "Type> " << d.name << ").modelptr, CLI.GetParam["
+      << strippedType << "]('" << d.name << "'))" << std::endl;
+}
+
+/**
+ * Print the code that gives an input parameter back to its Python object after
+ * the program has run, if it was moved into the parameters.
+ *
+ * @param d Parameter data.
+ * @param input Pointer to size_t holding the indentation.
+ * @param output Unused parameter.
+ */
+template<typename T>
+void PrintInputRestore(const util::ParamData& d,
+                       const void* input,
+                       void* /* output */)
+{
+  PrintInputRestore<T>(d, *((size_t*) input));
+}
+
+} // namespace python
+} // namespace bindings
+} // namespace mlpack
+
+#endif
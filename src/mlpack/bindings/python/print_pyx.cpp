@@ -70,8 +70,8 @@ void PrintPYX(const ProgramDoc& programInfo,
   // Now import all the necessary packages.
   cout << "cimport arma" << endl;
   cout << "cimport arma_numpy" << endl;
-  cout << "from cli cimport CLI" << endl;
-  cout << "from cli cimport SetParam, SetParamWithInfo" << endl;
+  cout << "from cli cimport CLI, CLIContext" << endl;
+  cout << "from cli cimport SetParam, SetParamPtr, SetParamWithInfo" << endl;
   cout << "from cli cimport EnableVerbose, DisableVerbose, DisableBacktrace, "
       << "ResetTimers, EnableTimers" << endl;
   cout << "from cli cimport MoveFromPtr, MoveToPtr" << endl;
@@ -131,6 +131,11 @@ void PrintPYX(const ProgramDoc& programInfo,
     CLI::GetSingleton().functionMap[d.tname]["PrintDefn"](d, NULL, NULL);
   }
 
+  // Every function can use its input matrices in place.
+  if (!inputOptions.empty())
+    cout << "," << endl << std::string(indent, ' ');
+  cout << "copy_all_inputs=True";
+
   // Print closing brace for function definition.
   cout << "):" << endl;
 
@@ -152,6 +157,12 @@ void PrintPYX(const ProgramDoc& programInfo,
         NULL);
     cout << endl;
   }
+  cout << "  " << HyphenateString(" - copy_all_inputs (bool): If True (the "
+      "default), input matrices are copied before the program is run.  If "
+      "False, C-contiguous numpy arrays of the right type are used in place "
+      "without being copied; then the program may modify them, and output "
+      "models may keep using their memory, so they must be kept alive.", 8)
+      << endl;
   cout << endl;
   cout << "  Output parameters:" << endl;
   cout << endl;
@@ -170,57 +181,76 @@ void PrintPYX(const ProgramDoc& programInfo,
       << "returned." << endl;
   cout << "  \"\"\"" << endl;
 
-  // Reset any timers and disable backtraces.
-  cout << "  ResetTimers()" << endl;
-  cout << "  EnableTimers()" << endl;
-  cout << "  DisableBacktrace()" << endl;
-  cout << "  DisableVerbose()" << endl;
+  // Give this call its own parameters and timers, so that other threads can
+  // call mlpack at the same time.
+  cout << "  cdef CLIContext* context = new CLIContext(<const string> \""
+      << programInfo.programName << "\")" << endl;
 
-  // Restore the parameters.
-  cout << "  CLI.RestoreSettings(\"" << programInfo.programName << "\")";
+  // Everything else runs in a try block, so that the context is destroyed
+  // (and the previous context of the thread restored) even if the input
+  // processing or the program raises.
+  cout << "  try:" << endl;
+
+  // Reset any timers and disable backtraces.
+  cout << "    ResetTimers()" << endl;
+  cout << "    EnableTimers()" << endl;
+  cout << "    DisableBacktrace()" << endl;
+  cout << "    DisableVerbose()" << endl;
 
   // Do any input processing.
   for (size_t i = 0; i < inputOptions.size(); ++i)
   {
     const util::ParamData& d = parameters.at(inputOptions[i]);
 
-    size_t indent = 2;
+    size_t indent = 4;
     CLI::GetSingleton().functionMap[d.tname]["PrintInputProcessing"](d,
         (void*) &indent, NULL);
   }
 
   // Set all output options as passed.
-  cout << "  # Mark all output options as passed." << endl;
+  cout << "    # Mark all output options as passed." << endl;
   for (size_t i = 0; i < outputOptions.size(); ++i)
   {
     const util::ParamData& d = parameters.at(outputOptions[i]);
-    cout << "  CLI.SetPassed(<const string> '" << d.name << "')" << endl;
+    cout << "    CLI.SetPassed(<const string> '" << d.name << "')" << endl;
   }
 
   // Call the method.
-  cout << "  # Call the mlpack program." << endl;
-  cout << "  mlpackMain()" << endl;
+  cout << "    # Call the mlpack program." << endl;
+  cout << "    with nogil:" << endl;
+  cout << "      mlpackMain()" << endl;
+
+  // Give the input models back to their Python objects, so that they can be
+  // used again.
+  for (size_t i = 0; i < inputOptions.size(); ++i)
+  {
+    const util::ParamData& d = parameters.at(inputOptions[i]);
+
+    size_t indent = 4;
+    CLI::GetSingleton().functionMap[d.tname]["PrintInputRestore"](d,
+        (void*) &indent, NULL);
+  }
 
   // Do any output processing and return.
-  cout << "  # Initialize result dictionary." << endl;
-  cout << "  result = {}" << endl;
+  cout << "    # Initialize result dictionary." << endl;
+  cout << "    result = {}" << endl;
   cout << endl;
 
   for (size_t i = 0; i < outputOptions.size(); ++i)
   {
     const util::ParamData& d = parameters.at(outputOptions[i]);
 
-    std::tuple<size_t, bool> t = std::make_tuple(2, false);
+    std::tuple<size_t, bool> t = std::make_tuple(4, false);
     CLI::GetSingleton().functionMap[d.tname]["PrintOutputProcessing"](d,
         (void*) &t, NULL);
   }
 
-  // Clear the parameters.
-  cout << endl;
-  cout << "  CLI.ClearSettings()" << endl;
   cout << endl;
+  cout << "    return result" << endl;
 
-  cout << "  return result" << endl;
+  // Destroy the parameters, whether or not the call succeeded.
+  cout << "  finally:" << endl;
+  cout << "    del context" << endl;
 }
 
 } // namespace python
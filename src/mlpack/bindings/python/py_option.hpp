@@ -14,6 +14,7 @@
 #include "print_defn.hpp"
 #include "print_doc.hpp"
 #include "print_input_processing.hpp"
+#include "print_input_restore.hpp"
 #include "print_output_processing.hpp"
 #include "import_decl.hpp"
 
@@ -86,6 +87,8 @@ class PyOption
         &PrintOutputProcessing<T>;
     CLI::GetSingleton().functionMap[data.tname]["PrintInputProcessing"] =
         &PrintInputProcessing<T>;
+    CLI::GetSingleton().functionMap[data.tname]["PrintInputRestore"] =
+        &PrintInputRestore<T>;
     CLI::GetSingleton().functionMap[data.tname]["ImportDecl"] = &ImportDecl<T>;
 
     // Add the ParamData object, then store.  This is necessary because we may
@@ -126,6 +126,33 @@ class TestToMatrix(unittest.TestCase):
 
     self.assertEqual(p1['data'], p2['data'])
 
+  def testNumpyToMatrixCopy(self):
+    """
+    Make sure a numpy matrix is copied when a copy is asked for.
+    """
+    m1 = np.random.randn(100, 5)
+    m2 = to_matrix(m1, copy=True)
+
+    self.assertTrue(isinstance(m2, np.ndarray))
+    self.assertEqual(m2.dtype, np.dtype(np.double))
+    self.assertTrue(m2.flags.owndata)
+    self.assertNotEqual(m1.__array_interface__['data'],
+                        m2.__array_interface__['data'])
+    self.assertTrue((m1 == m2).all())
+
+  def testUint64NumpyToMatrix(self):
+    """
+    Make sure a uint64 numpy matrix is converted to an intp matrix without
+    copying anything.
+    """
+    m1 = np.arange(20, dtype=np.uint64).reshape(4, 5)
+    m2 = to_matrix(m1, dtype=np.intp)
+
+    self.assertEqual(m2.dtype, np.dtype(np.intp))
+    self.assertEqual(m1.__array_interface__['data'],
+                     m2.__array_interface__['data'])
+    self.assertTrue((m1 == m2).all())
+
   def testPandasToMatrixNoCategorical(self):
     """
     Make sure that if we pass a Pandas dataframe with no categorical features,
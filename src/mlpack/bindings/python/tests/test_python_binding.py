@@ -4,6 +4,8 @@ test_python_binding.py
 
 Test that passing types to Python bindings works successfully.
 """
+import pickle
+import threading
 import unittest
 import pandas as pd
 import numpy as np
@@ -206,6 +208,82 @@ class TestPythonBinding(unittest.TestCase):
     for i in range(100):
       self.assertEqual(output['col_out'][i], x[i] * 2)
 
+  def testColNoCopy(self):
+    """
+    Test that a column vector input parameter is used in place when
+    copy_all_inputs is False.
+    """
+    x = np.random.rand(100)
+    z = x.copy()
+
+    output = test_python_binding(string_in='hello',
+                                 int_in=12,
+                                 double_in=4.0,
+                                 col_in=x,
+                                 copy_all_inputs=False)
+
+    self.assertEqual(output['col_out'].shape[0], 100)
+    self.assertEqual(output['col_out'].dtype, np.double)
+
+    # The binding doubled the memory of x itself, and the output is a copy.
+    for i in range(100):
+      self.assertEqual(x[i], z[i] * 2)
+      self.assertEqual(output['col_out'][i], z[i] * 2)
+
+    self.assertNotEqual(x.__array_interface__['data'][0],
+                        output['col_out'].__array_interface__['data'][0])
+
+  def testCopyAllInputs(self):
+    """
+    Test that every matrix and vector type gives the same output whether the
+    inputs are copied or used in place, and that copied inputs are unchanged.
+    """
+    inputs = { 'matrix': np.random.rand(100, 5),
+               'umatrix': np.random.randint(0, high=500, size=[100, 5]),
+               'col': np.random.rand(100),
+               'ucol': np.random.randint(0, high=500, size=100),
+               'row': np.random.rand(100),
+               'urow': np.random.randint(0, high=500, size=100) }
+
+    for name in inputs:
+      x = inputs[name]
+      z = x.copy()
+      y = x.copy()
+
+      copied = test_python_binding(string_in='hello',
+                                   int_in=12,
+                                   double_in=4.0,
+                                   **{ name + '_in': x })
+      shared = test_python_binding(string_in='hello',
+                                   int_in=12,
+                                   double_in=4.0,
+                                   copy_all_inputs=False,
+                                   **{ name + '_in': y })
+
+      self.assertTrue((x == z).all())
+      self.assertEqual(copied[name + '_out'].dtype,
+                       shared[name + '_out'].dtype)
+      self.assertEqual(copied[name + '_out'].shape,
+                       shared[name + '_out'].shape)
+      self.assertTrue((copied[name + '_out'] == shared[name + '_out']).all())
+
+    # A Fortran-order matrix is not C-contiguous, so it is copied either way.
+    x = np.asfortranarray(np.random.rand(100, 5))
+    z = x.copy()
+
+    copied = test_python_binding(string_in='hello',
+                                 int_in=12,
+                                 double_in=4.0,
+                                 matrix_in=x)
+    shared = test_python_binding(string_in='hello',
+                                 int_in=12,
+                                 double_in=4.0,
+                                 matrix_in=x,
+                                 copy_all_inputs=False)
+
+    self.assertTrue((x == z).all())
+    self.assertTrue((copied['matrix_out'] == shared['matrix_out']).all())
+
   def testUcol(self):
     """
     Test an unsigned column vector input parameter.
@@ -345,5 +423,77 @@ class TestPythonBinding(unittest.TestCase):
 
     self.assertEqual(output2['model_bw_out'], 20.0)
 
+  def testModelReuse(self):
+    """
+    Make sure that a model passed to a binding can be passed again, and still
+    holds the same model.
+    """
+    output = test_python_binding(string_in='hello',
+                                 int_in=12,
+                                 double_in=4.0,
+                                 build_model=True)
+    model = output['model_out']
+
+    for i in range(3):
+      output2 = test_python_binding(string_in='hello',
+                                    int_in=12,
+                                    double_in=4.0,
+                                    model_in=model)
+      self.assertEqual(output2['model_bw_out'], 20.0)
+
+  def testModelReuseMatchesCopy(self):
+    """
+    Make sure that passing a model again gives the same results as passing a
+    new copy of it each time, and that the calls leave the model unchanged.
+    """
+    output = test_python_binding(string_in='hello',
+                                 int_in=12,
+                                 double_in=4.0,
+                                 build_model=True)
+    model = output['model_out']
+    state = model.__getstate__()
+
+    for i in range(3):
+      reused = test_python_binding(string_in='hello',
+                                   int_in=12,
+                                   double_in=4.0,
+                                   model_in=model)
+      copied = test_python_binding(string_in='hello',
+                                   int_in=12,
+                                   double_in=4.0,
+                                   model_in=pickle.loads(pickle.dumps(model)))
+
+      self.assertEqual(reused['model_bw_out'], copied['model_bw_out'])
+      self.assertEqual(model.__getstate__(), state)
+
+  def testThreads(self):
+    """
+    Run the binding from several threads at once, each with its own inputs, and
+    make sure each thread gets its own results.
+    """
+    results = [None] * 8
+    def run(t):
+      # Only the threads that pass the right int get 13 back.
+      x = np.random.rand(100, 5)
+      correct = True
+      for i in range(20):
+        output = test_python_binding(string_in='hello',
+                                     int_in=12 + (t % 2),
+                                     double_in=4.0,
+                                     flag1=True,
+                                     matrix_in=x)
+        correct = correct and (output['int_out'] == (11 if t % 2 else 13))
+        correct = correct and np.array_equal(output['matrix_out'][:, 2],
+                                             2 * x[:, 2])
+      results[t] = correct
+
+    threads = [threading.Thread(target=run, args=(t,)) for t in range(8)]
+    for thread in threads:
+      thread.start()
+    for thread in threads:
+      thread.join()
+
+    self.assertEqual(results, [True] * 8)
+
 if __name__ == '__main__':
   unittest.main()
@@ -248,6 +248,7 @@
 #include <mlpack/core/math/shuffle_data.hpp>
 #include <mlpack/core/math/make_alias.hpp>
 #include <mlpack/core/dists/discrete_distribution.hpp>
+#include <mlpack/core/dists/sparse_discrete_distribution.hpp>
 #include <mlpack/core/dists/gaussian_distribution.hpp>
 #include <mlpack/core/dists/laplace_distribution.hpp>
 #include <mlpack/core/dists/gamma_distribution.hpp>
@@ -269,6 +270,8 @@
 #include <mlpack/core/kernels/pspectrum_string_kernel.hpp>
 #include <mlpack/core/kernels/spherical_kernel.hpp>
 #include <mlpack/core/kernels/triangular_kernel.hpp>
+#include <mlpack/core/kernels/precomputed_kernel.hpp>
+#include <mlpack/core/kernels/cached_kernel.hpp>
 
 // Use OpenMP if compiled with -DHAS_OPENMP.
 #ifdef HAS_OPENMP
@@ -25,6 +25,38 @@ void Mat<eT>::serialize(Archive& ar, const unsigned int /* version */)
   ar & make_nvp("n_elem", access::rw(n_elem));
   ar & make_nvp("vec_state", access::rw(vec_state));
 
+  // When a flat model file is saved or loaded (see mlpack::data::FlatPayload),
+  // the elements of large matrices are stored after the archive, and loaded
+  // matrices point straight into the mapped file (so mem_state is 1).
+  mlpack::data::FlatPayload* payload = mlpack::data::FlatPayload::Active();
+  if (payload != NULL)
+  {
+    bool flat = (n_elem * sizeof(eT) >= mlpack::data::FlatPayload::MinBytes);
+    ar & make_nvp("flat", flat);
+
+    if (flat)
+    {
+      uint64_t offset = 0;
+      if (!Archive::is_loading::value)
+        offset = payload->Add(mem, n_elem * sizeof(eT));
+      ar & make_nvp("offset", offset);
+
+      if (Archive::is_loading::value)
+      {
+        if (mem_state == 0 && mem != NULL &&
+            old_n_elem > arma_config::mat_prealloc)
+        {
+          memory::release(access::rw(mem));
+        }
+
+        access::rw(mem) = (eT*) payload->Get(offset, n_elem * sizeof(eT));
+        access::rw(mem_state) = 1;
+      }
+
+      return;
+    }
+  }
+
   // mem_state will always be 0 on load, so we don't need to save it.
   if (Archive::is_loading::value)
   {
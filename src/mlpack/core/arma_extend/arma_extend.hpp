@@ -49,6 +49,9 @@
 #include <boost/serialization/nvp.hpp>
 #include <boost/serialization/array.hpp>
 
+// Large matrices are stored outside of the archive in flat model files.
+#include <mlpack/core/data/flat_payload.hpp>
+
 #include <armadillo>
 
 namespace arma {
@@ -14,6 +14,11 @@
 
 #include <mlpack/core/cv/meta_info_extractor.hpp>
 #include <mlpack/core/cv/cv_base.hpp>
+#include <mlpack/core/cv/metrics/multi_metric.hpp>
+
+#ifdef HAS_OPENMP
+  #include <omp.h>
+#endif
 
 namespace mlpack {
 namespace cv {
@@ -40,6 +45,29 @@ namespace cv {
  * double softmaxAccuracy = cv.Evaluate(lambda);
  * @endcode
  *
+ * If Parallel() is set (and mlpack was compiled with OpenMP), the folds are
+ * trained and evaluated in parallel, so training MLAlgorithm has to be
+ * thread-safe.  NumThreads() bounds the number of folds trained at once (and
+ * so the number of models in memory), leaving threads to algorithms that are
+ * parallel themselves.  The training subsets are aliases of one layout of the
+ * data built at construction, so no fold copies the data.  If EarlyStopThreshold() is set, the evaluation stops as soon
+ * as the mean of the folds evaluated so far is worse than the threshold (with
+ * Parallel(), after each round of as many folds as there are threads), and
+ * that mean is returned; this is used by HyperParameterTuner to skip bad sets
+ * of hyper-parameters.
+ *
+ * Metric can be a MultiMetric, to evaluate several classification metrics with
+ * one run of classification per fold.  Evaluate() then returns the mean of the
+ * first metric, and FoldEvaluations() gives the value of every metric for each
+ * fold of the last run:
+ *
+ * @code
+ * KFoldCV<SoftmaxRegression<>, MultiMetric<Accuracy, F1<Macro>>> cv(10, data,
+ *     labels, numClasses);
+ * cv.Evaluate(lambda);
+ * arma::vec means = arma::mean(cv.FoldEvaluations(), 1);
+ * @endcode
+ *
  * @tparam MLAlgorithm A machine learning algorithm.
  * @tparam Metric A metric to assess the quality of a trained model.
  * @tparam MatType The type of data.
@@ -164,6 +192,27 @@ class KFoldCV
   //! Access and modify a model from the last run of k-fold cross-validation.
   MLAlgorithm& Model();
 
+  //! Get the values of the metric for each fold of the last run: one column
+  //! per evaluated fold, and one row per metric (several for a MultiMetric).
+  const arma::mat& FoldEvaluations() const { return foldEvaluations; }
+
+  //! Get whether the folds are trained and evaluated in parallel.
+  bool Parallel() const { return parallel; }
+  //! Modify whether the folds are trained and evaluated in parallel.
+  bool& Parallel() { return parallel; }
+
+  //! Get the largest number of folds trained at once with Parallel() (0 means
+  //! one per available thread).
+  size_t NumThreads() const { return numThreads; }
+  //! Modify the largest number of folds trained at once with Parallel().
+  size_t& NumThreads() { return numThreads; }
+
+  //! Get the threshold beyond which the evaluation stops early (the largest or
+  //! the lowest value, depending on Metric::NeedsMinimization, by default).
+  double EarlyStopThreshold() const { return earlyStopThreshold; }
+  //! Modify the threshold beyond which the evaluation stops early.
+  double& EarlyStopThreshold() { return earlyStopThreshold; }
+
  private:
   //! A short alias for CVBase.
   using Base = CVBase<MLAlgorithm, MatType, PredictionsType, WeightsType>;
@@ -190,6 +239,18 @@ class KFoldCV
   //! A pointer to a model from the last run of k-fold cross-validation.
   std::unique_ptr<MLAlgorithm> modelPtr;
 
+  //! Whether the folds are trained and evaluated in parallel.
+  bool parallel;
+
+  //! The largest number of folds trained at once (0 for no limit).
+  size_t numThreads;
+
+  //! The threshold beyond which the evaluation stops early.
+  double earlyStopThreshold;
+
+  //! The values of the metric for each fold of the last run.
+  arma::mat foldEvaluations;
+
   /**
    * Assert the k parameter and data consistency and initialize fields required
    * for running k-fold cross-validation.
@@ -217,21 +278,29 @@ class KFoldCV
   void InitKFoldCVMat(const DataType& source, DataType& destination);
 
   /**
-   * Train and run evaluation in the case of non-weighted learning.
+   * Train and run evaluation on each fold.
+   */
+  template<typename...MLAlgorithmArgs>
+  double TrainAndEvaluate(const MLAlgorithmArgs& ...mlAlgorithmArgs);
+
+  /**
+   * Train a model on the ith training subset in the case of non-weighted
+   * learning.
    */
   template<typename...MLAlgorithmArgs,
            bool Enabled = !Base::MIE::SupportsWeights,
            typename = typename std::enable_if<Enabled>::type>
-  double TrainAndEvaluate(const MLAlgorithmArgs& ...mlAlgorithmArgs);
+  MLAlgorithm Train(const size_t i, const MLAlgorithmArgs& ...mlAlgorithmArgs);
 
   /**
-   * Train and run evaluation in the case of supporting weighted learning.
+   * Train a model on the ith training subset in the case of supporting
+   * weighted learning.
    */
   template<typename...MLAlgorithmArgs,
            bool Enabled = Base::MIE::SupportsWeights,
            typename = typename std::enable_if<Enabled>::type,
            typename = void>
-  double TrainAndEvaluate(const MLAlgorithmArgs& ...mlAlgorithmArgs);
+  MLAlgorithm Train(const size_t i, const MLAlgorithmArgs& ...mlAlgorithmArgs);
 
   /**
    * Calculate the index of the first column of the ith validation subset.
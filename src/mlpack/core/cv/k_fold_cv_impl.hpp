@@ -127,7 +127,13 @@ KFoldCV<MLAlgorithm,
                               const size_t k,
                               const MatType& xs,
                               const PredictionsType& ys) :
-  base(std::move(base)), k(k)
+  base(std::move(base)),
+  k(k),
+  parallel(false),
+  numThreads(0),
+  earlyStopThreshold(Metric::NeedsMinimization ?
+      std::numeric_limits<double>::max() :
+      std::numeric_limits<double>::lowest())
 {
   if (k < 2)
     throw std::invalid_argument("KFoldCV: k should not be less than 2");
@@ -217,26 +223,60 @@ template<typename MLAlgorithm,
          typename MatType,
          typename PredictionsType,
          typename WeightsType>
-template<typename... MLAlgorithmArgs, bool Enabled, typename>
+template<typename... MLAlgorithmArgs>
 double KFoldCV<MLAlgorithm,
-                Metric,
-                MatType,
-                PredictionsType,
-                WeightsType>::TrainAndEvaluate(const MLAlgorithmArgs&... args)
+               Metric,
+               MatType,
+               PredictionsType,
+               WeightsType>::TrainAndEvaluate(const MLAlgorithmArgs&... args)
 {
-  arma::vec evaluations(k);
+  // One row for each metric; the first one is the one averaged and checked
+  // against the threshold.
+  arma::mat evaluations(MetricValues<Metric>::NumMetrics, k);
 
-  for (size_t i = 0; i < k; ++i)
+  // The folds are evaluated in rounds of foldThreads folds, so that the
+  // evaluation can stop early after each round.
+  size_t foldThreads = 1;
+  if (parallel)
   {
-    MLAlgorithm&& model  = base.Train(GetTrainingSubset(xs, i),
-        GetTrainingSubset(ys, i), args...);
-    evaluations(i) = Metric::Evaluate(model, GetValidationSubset(xs, i),
-        GetValidationSubset(ys, i));
-    if (i == k - 1)
-      modelPtr.reset(new MLAlgorithm(std::move(model)));
+    foldThreads = std::min(Parallel::Threads(), k);
+    if (numThreads > 0)
+      foldThreads = std::min(foldThreads, numThreads);
   }
 
-  return arma::mean(evaluations);
+  // The threads of the budget are shared between the folds, so that a model
+  // which is itself parallel does not oversubscribe the cores when OpenMP is
+  // allowed to nest parallel regions.
+  const size_t foldBudget = std::max(Parallel::MaxThreads() / foldThreads,
+      (size_t) 1);
+
+  size_t numEvaluations = 0;
+  while (numEvaluations < k)
+  {
+    const size_t roundEnd = std::min(numEvaluations + foldThreads, k);
+
+    #pragma omp parallel for num_threads(foldThreads) if (foldThreads > 1)
+    for (omp_size_t i = (omp_size_t) numEvaluations; i < (omp_size_t) roundEnd;
+        ++i)
+    {
+      Parallel::Scope scope(foldBudget);
+      MLAlgorithm model = Train(i, args...);
+      evaluations.col(i) = MetricValues<Metric>::Evaluate(model,
+          GetValidationSubset(xs, i), GetValidationSubset(ys, i));
+      if ((size_t) i == roundEnd - 1)
+        modelPtr.reset(new MLAlgorithm(std::move(model)));
+    }
+
+    numEvaluations = roundEnd;
+
+    const double mean = arma::mean(evaluations.row(0).head(numEvaluations));
+    if (Metric::NeedsMinimization ? (mean > earlyStopThreshold) :
+        (mean < earlyStopThreshold))
+      break;
+  }
+
+  foldEvaluations = evaluations.head_cols(numEvaluations);
+  return arma::mean(evaluations.row(0).head(numEvaluations));
 }
 
 template<typename MLAlgorithm,
@@ -244,29 +284,36 @@ template<typename MLAlgorithm,
          typename MatType,
          typename PredictionsType,
          typename WeightsType>
-template<typename... MLAlgorithmArgs, bool Enabled, typename, typename>
-double KFoldCV<MLAlgorithm,
-                Metric,
-                MatType,
-                PredictionsType,
-                WeightsType>::TrainAndEvaluate(const MLAlgorithmArgs&... args)
+template<typename... MLAlgorithmArgs, bool Enabled, typename>
+MLAlgorithm KFoldCV<MLAlgorithm,
+                    Metric,
+                    MatType,
+                    PredictionsType,
+                    WeightsType>::Train(const size_t i,
+                                        const MLAlgorithmArgs&... args)
 {
-  arma::vec evaluations(k);
-
-  for (size_t i = 0; i < k; ++i)
-  {
-    MLAlgorithm&& model = (weights.n_elem > 0) ?
-        base.Train(GetTrainingSubset(xs, i), GetTrainingSubset(ys, i),
-            GetTrainingSubset(weights, i), args...) :
-        base.Train(GetTrainingSubset(xs, i), GetTrainingSubset(ys, i),
-            args...);
-    evaluations(i) = Metric::Evaluate(model, GetValidationSubset(xs, i),
-        GetValidationSubset(ys, i));
-    if (i == k - 1)
-      modelPtr.reset(new MLAlgorithm(std::move(model)));
-  }
+  return base.Train(GetTrainingSubset(xs, i), GetTrainingSubset(ys, i),
+      args...);
+}
 
-  return arma::mean(evaluations);
+template<typename MLAlgorithm,
+         typename Metric,
+         typename MatType,
+         typename PredictionsType,
+         typename WeightsType>
+template<typename... MLAlgorithmArgs, bool Enabled, typename, typename>
+MLAlgorithm KFoldCV<MLAlgorithm,
+                    Metric,
+                    MatType,
+                    PredictionsType,
+                    WeightsType>::Train(const size_t i,
+                                        const MLAlgorithmArgs&... args)
+{
+  return (weights.n_elem > 0) ?
+      base.Train(GetTrainingSubset(xs, i), GetTrainingSubset(ys, i),
+          GetTrainingSubset(weights, i), args...) :
+      base.Train(GetTrainingSubset(xs, i), GetTrainingSubset(ys, i),
+          args...);
 }
 
 template<typename MLAlgorithm,
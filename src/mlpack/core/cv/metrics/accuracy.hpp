@@ -37,6 +37,15 @@ class Accuracy
                          const DataType& data,
                          const arma::Row<size_t>& labels);
 
+  /**
+   * Calculate accuracy from the given confusion matrix, as given by
+   * ConfusionMatrix().
+   */
+  static double FromConfusionMatrix(const arma::Mat<size_t>& confusion)
+  {
+    return (double) arma::accu(confusion.diag()) / arma::accu(confusion);
+  }
+
   /**
    * Information for hyper-parameter tuning code. It indicates that we want
    * to maximize the metric.
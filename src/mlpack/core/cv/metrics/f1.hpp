@@ -63,6 +63,15 @@ class F1
    */
   static const bool NeedsMinimization = false;
 
+  /**
+   * Calculate F1 from the given confusion matrix, as given by
+   * ConfusionMatrix().  This lets several metrics share one run of
+   * classification (see MultiMetric).
+   *
+   * @param confusion Confusion matrix of the test items.
+   */
+  static double FromConfusionMatrix(const arma::Mat<size_t>& confusion);
+
  private:
   /**
    * Run classification and calculate F1 for binary classification.
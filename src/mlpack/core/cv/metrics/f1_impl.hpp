@@ -93,6 +93,43 @@ double F1<AS, PC>::Evaluate(MLAlgorithm& model,
   return arma::mean(f1s);
 }
 
+template<AverageStrategy AS, size_t PC /* PositiveClass */>
+double F1<AS, PC>::FromConfusionMatrix(const arma::Mat<size_t>& confusion)
+{
+  if (AS == Binary)
+  {
+    // Without a positive label or prediction there are no positives.
+    const size_t tp = (PC < confusion.n_rows) ? confusion(PC, PC) : 0;
+    const size_t numberOfPositivePredictions = (PC < confusion.n_cols) ?
+        arma::accu(confusion.col(PC)) : 0;
+    const size_t numberOfPositiveClassInstances = (PC < confusion.n_rows) ?
+        arma::accu(confusion.row(PC)) : 0;
+
+    double precision = double(tp) / numberOfPositivePredictions;
+    double recall = double(tp) / numberOfPositiveClassInstances;
+
+    return (precision + recall == 0.0) ? 0.0 :
+        2.0 * precision * recall / (precision + recall);
+  }
+  else if (AS == Micro)
+  {
+    // Microaveraged F1 is the same as accuracy.
+    return Accuracy::FromConfusionMatrix(confusion);
+  }
+
+  const size_t numClasses = NumLabelClasses(confusion);
+  arma::vec f1s = arma::vec(numClasses);
+  for (size_t c = 0; c < numClasses; ++c)
+  {
+    double precision = double(confusion(c, c)) / arma::accu(confusion.col(c));
+    double recall = double(confusion(c, c)) / arma::accu(confusion.row(c));
+    f1s(c) = (precision + recall == 0.0) ? 0.0 :
+        2.0 * precision * recall / (precision + recall);
+  }
+
+  return arma::mean(f1s);
+}
+
 } // namespace cv
 } // namespace mlpack
 
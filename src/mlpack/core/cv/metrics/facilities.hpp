@@ -40,6 +40,45 @@ void AssertSizes(const DataType& data,
   }
 }
 
+/**
+ * Count the predictions of each class for the points of each class: element
+ * (i, j) of the confusion matrix is the number of points with label i that were
+ * predicted as j.  The matrix is square, with one row and one column for each
+ * class up to the largest label or prediction.
+ *
+ * @param labels Ground truth (correct) labels.
+ * @param predictedLabels Predicted labels.
+ * @param confusion Matrix to store the counts in.
+ */
+inline void ConfusionMatrix(const arma::Row<size_t>& labels,
+                            const arma::Row<size_t>& predictedLabels,
+                            arma::Mat<size_t>& confusion)
+{
+  const size_t numClasses = (labels.n_elem == 0) ? 0 :
+      std::max(arma::max(labels), arma::max(predictedLabels)) + 1;
+  confusion.zeros(numClasses, numClasses);
+  for (size_t i = 0; i < labels.n_elem; ++i)
+    ++confusion(labels[i], predictedLabels[i]);
+}
+
+/**
+ * Get the number of classes that a metric averages over, given a confusion
+ * matrix: one more than the largest label, as when the labels are used
+ * directly.
+ *
+ * @param confusion Confusion matrix, as given by ConfusionMatrix().
+ */
+inline size_t NumLabelClasses(const arma::Mat<size_t>& confusion)
+{
+  for (size_t c = confusion.n_rows; c > 0; --c)
+  {
+    if (arma::accu(confusion.row(c - 1)) > 0)
+      return c;
+  }
+
+  return 0;
+}
+
 } // namespace cv
 } // namespace mlpack
 
@@ -0,0 +1,144 @@
+/**
+ * @file multi_metric.hpp
+ *
+ * A metric that reports several classification metrics from one run of
+ * classification.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_CV_METRICS_MULTI_METRIC_HPP
+#define MLPACK_CORE_CV_METRICS_MULTI_METRIC_HPP
+
+#include <mlpack/core.hpp>
+
+#include <tuple>
+
+namespace mlpack {
+namespace cv {
+
+/**
+ * MultiMetric evaluates several classification metrics (Accuracy, Precision,
+ * Recall and F1, with any AverageStrategy) at once.  The model classifies the
+ * test items once, and each metric is calculated from the resulting confusion
+ * matrix with its FromConfusionMatrix() function, instead of each metric
+ * running classification on its own.
+ *
+ * EvaluateAll() returns the value of each metric, in the order they are given.
+ * Evaluate() returns the value of the first metric, so that MultiMetric can be
+ * used wherever a single metric can; KFoldCV also keeps the values of all the
+ * metrics for each fold (see KFoldCV::FoldEvaluations()).
+ *
+ * @code
+ * typedef MultiMetric<Accuracy, Precision<Macro>, Recall<Macro>, F1<Macro>>
+ *     Metrics;
+ * arma::vec values = Metrics::EvaluateAll(model, data, labels);
+ * @endcode
+ *
+ * @tparam Metrics The metrics to evaluate; the first one is the one that
+ *     Evaluate() returns and that hyper-parameter tuning optimizes.
+ */
+template<typename... Metrics>
+class MultiMetric
+{
+  static_assert(sizeof...(Metrics) > 0,
+      "MultiMetric needs at least one metric");
+
+  //! The first metric.
+  typedef typename std::tuple_element<0, std::tuple<Metrics...>>::type
+      FirstMetric;
+
+ public:
+  //! The number of metrics.
+  static const size_t NumMetrics = sizeof...(Metrics);
+
+  /**
+   * Run classification once and calculate all the metrics.
+   *
+   * @param model A classification model.
+   * @param data Column-major data containing test items.
+   * @param labels Ground truth (correct) labels for the test items.
+   * @return The value of each metric.
+   */
+  template<typename MLAlgorithm, typename DataType>
+  static arma::vec EvaluateAll(MLAlgorithm& model,
+                               const DataType& data,
+                               const arma::Row<size_t>& labels);
+
+  /**
+   * Calculate all the metrics from the given confusion matrix, as given by
+   * ConfusionMatrix().
+   *
+   * @param confusion Confusion matrix of the test items.
+   * @return The value of each metric.
+   */
+  static arma::vec EvaluateAll(const arma::Mat<size_t>& confusion);
+
+  /**
+   * Run classification and calculate the first metric.
+   *
+   * @param model A classification model.
+   * @param data Column-major data containing test items.
+   * @param labels Ground truth (correct) labels for the test items.
+   */
+  template<typename MLAlgorithm, typename DataType>
+  static double Evaluate(MLAlgorithm& model,
+                         const DataType& data,
+                         const arma::Row<size_t>& labels);
+
+  /**
+   * Information for hyper-parameter tuning code: the direction of the first
+   * metric.
+   */
+  static const bool NeedsMinimization = FirstMetric::NeedsMinimization;
+};
+
+/**
+ * Evaluate a metric as a vector of values: one value for a single metric, and
+ * one value for each metric of a MultiMetric (which then runs classification
+ * only once).  This is used by KFoldCV to record every metric of every fold.
+ *
+ * @tparam Metric A metric, or a MultiMetric.
+ */
+template<typename Metric>
+struct MetricValues
+{
+  //! The number of values.
+  static const size_t NumMetrics = 1;
+
+  //! Evaluate the metric.
+  template<typename MLAlgorithm, typename DataType, typename PredictionsType>
+  static arma::vec Evaluate(MLAlgorithm& model,
+                            const DataType& data,
+                            const PredictionsType& ys)
+  {
+    return arma::vec(1).fill(Metric::Evaluate(model, data, ys));
+  }
+};
+
+//! Evaluate all the metrics of a MultiMetric at once.
+template<typename... Metrics>
+struct MetricValues<MultiMetric<Metrics...>>
+{
+  //! The number of values.
+  static const size_t NumMetrics = sizeof...(Metrics);
+
+  //! Evaluate the metrics.
+  template<typename MLAlgorithm, typename DataType>
+  static arma::vec Evaluate(MLAlgorithm& model,
+                            const DataType& data,
+                            const arma::Row<size_t>& labels)
+  {
+    return MultiMetric<Metrics...>::EvaluateAll(model, data, labels);
+  }
+};
+
+} // namespace cv
+} // namespace mlpack
+
+// Include implementation.
+#include "multi_metric_impl.hpp"
+
+#endif
@@ -0,0 +1,55 @@
+/**
+ * @file multi_metric_impl.hpp
+ *
+ * The implementation of the class MultiMetric.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_CV_METRICS_MULTI_METRIC_IMPL_HPP
+#define MLPACK_CORE_CV_METRICS_MULTI_METRIC_IMPL_HPP
+
+#include <mlpack/core/cv/metrics/facilities.hpp>
+
+namespace mlpack {
+namespace cv {
+
+template<typename... Metrics>
+template<typename MLAlgorithm, typename DataType>
+arma::vec MultiMetric<Metrics...>::EvaluateAll(MLAlgorithm& model,
+                                               const DataType& data,
+                                               const arma::Row<size_t>& labels)
+{
+  AssertSizes(data, labels, "MultiMetric::EvaluateAll()");
+
+  arma::Row<size_t> predictedLabels;
+  model.Classify(data, predictedLabels);
+
+  arma::Mat<size_t> confusion;
+  ConfusionMatrix(labels, predictedLabels, confusion);
+
+  return EvaluateAll(confusion);
+}
+
+template<typename... Metrics>
+arma::vec MultiMetric<Metrics...>::EvaluateAll(
+    const arma::Mat<size_t>& confusion)
+{
+  return arma::vec({ Metrics::FromConfusionMatrix(confusion)... });
+}
+
+template<typename... Metrics>
+template<typename MLAlgorithm, typename DataType>
+double MultiMetric<Metrics...>::Evaluate(MLAlgorithm& model,
+                                         const DataType& data,
+                                         const arma::Row<size_t>& labels)
+{
+  return EvaluateAll(model, data, labels)[0];
+}
+
+} // namespace cv
+} // namespace mlpack
+
+#endif
@@ -66,6 +66,15 @@ class Precision
    */
   static const bool NeedsMinimization = false;
 
+  /**
+   * Calculate precision from the given confusion matrix, as given by
+   * ConfusionMatrix().  This lets several metrics share one run of
+   * classification (see MultiMetric).
+   *
+   * @param confusion Confusion matrix of the test items.
+   */
+  static double FromConfusionMatrix(const arma::Mat<size_t>& confusion);
+
  private:
   /**
    * Run classification and calculate precision for binary classification.
@@ -82,6 +82,35 @@ double Precision<AS, PC>::Evaluate(MLAlgorithm& model,
   return arma::mean(precisions);
 }
 
+template<AverageStrategy AS, size_t PC /* PositiveClass */>
+double Precision<AS, PC>::FromConfusionMatrix(
+    const arma::Mat<size_t>& confusion)
+{
+  if (AS == Binary)
+  {
+    // Without a positive label or prediction there are no positives.
+    const size_t tp = (PC < confusion.n_rows) ? confusion(PC, PC) : 0;
+    const size_t numberOfPositivePredictions = (PC < confusion.n_cols) ?
+        arma::accu(confusion.col(PC)) : 0;
+    return double(tp) / numberOfPositivePredictions;
+  }
+  else if (AS == Micro)
+  {
+    // Microaveraged precision turns out to be just accuracy.
+    return Accuracy::FromConfusionMatrix(confusion);
+  }
+
+  const size_t numClasses = NumLabelClasses(confusion);
+  arma::vec precisions = arma::vec(numClasses);
+  for (size_t c = 0; c < numClasses; ++c)
+  {
+    precisions(c) = double(confusion(c, c)) /
+        arma::accu(confusion.col(c));
+  }
+
+  return arma::mean(precisions);
+}
+
 } // namespace cv
 } // namespace mlpack
 
@@ -82,6 +82,31 @@ double Recall<AS, PC>::Evaluate(MLAlgorithm& model,
   return arma::mean(recalls);
 }
 
+template<AverageStrategy AS, size_t PC /* PositiveClass */>
+double Recall<AS, PC>::FromConfusionMatrix(const arma::Mat<size_t>& confusion)
+{
+  if (AS == Binary)
+  {
+    // Without a positive label or prediction there are no positives.
+    const size_t tp = (PC < confusion.n_rows) ? confusion(PC, PC) : 0;
+    const size_t numberOfPositiveClassInstances = (PC < confusion.n_rows) ?
+        arma::accu(confusion.row(PC)) : 0;
+    return double(tp) / numberOfPositiveClassInstances;
+  }
+  else if (AS == Micro)
+  {
+    // Microaveraged recall is really the same as accuracy.
+    return Accuracy::FromConfusionMatrix(confusion);
+  }
+
+  const size_t numClasses = NumLabelClasses(confusion);
+  arma::vec recalls = arma::vec(numClasses);
+  for (size_t c = 0; c < numClasses; ++c)
+    recalls(c) = double(confusion(c, c)) / arma::accu(confusion.row(c));
+
+  return arma::mean(recalls);
+}
+
 } // namespace cv
 } // namespace mlpack
 
@@ -86,6 +86,59 @@ void Binarize(const arma::Mat<T>& input,
     output(dimension, i) = input(dimension, i) > threshold;
 }
 
+/**
+ * Given an input dataset and threshold, set values greater than threshold to
+ * 1 and values less than or equal to the threshold to 0, in place, so that no
+ * copy of the dataset is made.  This overload applies the changes to all
+ * dimensions.
+ *
+ * @code
+ * arma::Mat<double> input = loadData();
+ *
+ * // Binarize the whole matrix in place.
+ * Binarize<double>(input, 0.5);
+ * @endcode
+ *
+ * @param input Matrix to binarize in place.
+ * @param threshold Threshold can by any number.
+ */
+template<typename T>
+void Binarize(arma::Mat<T>& input, const double threshold)
+{
+  T *ptr = input.memptr();
+
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) input.n_elem; ++i)
+    ptr[i] = ptr[i] > threshold;
+}
+
+/**
+ * Given an input dataset and threshold, set values greater than threshold to
+ * 1 and values less than or equal to the threshold to 0, in place.  This
+ * overload only changes the given dimension, so the other dimensions are not
+ * touched at all.
+ *
+ * @code
+ * arma::Mat<double> input = loadData();
+ *
+ * // Binarize the first dimension in place.
+ * Binarize<double>(input, 0.5, 0);
+ * @endcode
+ *
+ * @param input Matrix to binarize in place.
+ * @param threshold Threshold can by any number.
+ * @param dimension Feature to apply the Binarize function.
+ */
+template<typename T>
+void Binarize(arma::Mat<T>& input,
+              const double threshold,
+              const size_t dimension)
+{
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) input.n_cols; ++i)
+    input(dimension, i) = input(dimension, i) > threshold;
+}
+
 } // namespace data
 } // namespace mlpack
 
@@ -131,6 +131,21 @@ class DatasetMapper
    */
   size_t NumMappings(const size_t dimension) const;
 
+  /**
+   * Replace the types and mappings of the dimensions in the range [begin, end)
+   * with the ones held by the given DatasetMapper, which must have at least
+   * end dimensions.  The mappings are moved out of the other object.  This is
+   * useful to combine DatasetMappers that were filled at the same time (i.e.
+   * in different threads), each for a different range of dimensions.
+   *
+   * @param other DatasetMapper to take the dimensions from.
+   * @param begin First dimension to take.
+   * @param end One past the last dimension to take.
+   */
+  void MergeDimensions(DatasetMapper& other,
+                       const size_t begin,
+                       const size_t end);
+
   /**
    * Get the dimensionality of the DatasetMapper object (that is, how many
    * dimensions it has information for).  If this object was created by a call
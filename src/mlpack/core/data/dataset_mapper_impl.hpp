@@ -126,7 +126,9 @@ inline const InputType& DatasetMapper<PolicyType, InputType>::UnmapString(
       value;
 
   // Throw an exception if the value doesn't exist.
-  if (maps.at(dimension).second.count(usedValue) == 0)
+  const ReverseMapType& reverseMap = maps.at(dimension).second;
+  const typename ReverseMapType::const_iterator it = reverseMap.find(usedValue);
+  if (it == reverseMap.end())
   {
     std::ostringstream oss;
     oss << "DatasetMapper<PolicyType, InputType>::UnmapString(): value '"
@@ -134,17 +136,16 @@ inline const InputType& DatasetMapper<PolicyType, InputType>::UnmapString(
     throw std::invalid_argument(oss.str());
   }
 
-  if (unmappingIndex >= maps.at(dimension).second.at(usedValue).size())
+  if (unmappingIndex >= it->second.size())
   {
     std::ostringstream oss;
     oss << "DatasetMapper<PolicyType, InputType>::UnmapString(): value '"
-        << value << "' only has "
-        << maps.at(dimension).second.at(usedValue).size()
+        << value << "' only has " << it->second.size()
         << " unmappings, but unmappingIndex is " << unmappingIndex << "!";
     throw std::invalid_argument(oss.str());
   }
 
-  return maps.at(dimension).second.at(usedValue)[unmappingIndex];
+  return it->second[unmappingIndex];
 }
 
 template<typename PolicyType, typename InputType>
@@ -172,7 +173,11 @@ DatasetMapper<PolicyType, InputType>::UnmapValue(
     const size_t dimension)
 {
   // Throw an exception if the value doesn't exist.
-  if (maps[dimension].first.count(input) == 0)
+  const typename MapType::const_iterator dimensionMaps = maps.find(dimension);
+  typename ForwardMapType::const_iterator it;
+  if (dimensionMaps == maps.end() ||
+      (it = dimensionMaps->second.first.find(input)) ==
+      dimensionMaps->second.first.end())
   {
     std::ostringstream oss;
     oss << "DatasetMapper<PolicyType, InputType>::UnmapValue(): input '"
@@ -180,7 +185,7 @@ DatasetMapper<PolicyType, InputType>::UnmapValue(
     throw std::invalid_argument(oss.str());
   }
 
-  return maps[dimension].first.at(input);
+  return it->second;
 }
 
 // Get the type of a particular dimension.
@@ -213,7 +218,41 @@ template<typename PolicyType, typename InputType>
 inline size_t
 DatasetMapper<PolicyType, InputType>::NumMappings(const size_t dimension) const
 {
-  return (maps.count(dimension) == 0) ? 0 : maps.at(dimension).first.size();
+  const typename MapType::const_iterator it = maps.find(dimension);
+  return (it == maps.end()) ? 0 : it->second.first.size();
+}
+
+template<typename PolicyType, typename InputType>
+inline void DatasetMapper<PolicyType, InputType>::MergeDimensions(
+    DatasetMapper& other,
+    const size_t begin,
+    const size_t end)
+{
+  if (end > types.size() || end > other.types.size())
+  {
+    std::ostringstream oss;
+    oss << "DatasetMapper<PolicyType, InputType>::MergeDimensions(): cannot "
+        << "merge dimensions up to " << end << ", but the mappers have "
+        << types.size() << " and " << other.types.size() << " dimensions";
+    throw std::invalid_argument(oss.str());
+  }
+
+  for (size_t d = begin; d < end; ++d)
+  {
+    types[d] = other.types[d];
+
+    // Only categorical dimensions have an entry in the maps.
+    typename MapType::iterator it = other.maps.find(d);
+    if (it == other.maps.end())
+    {
+      maps.erase(d);
+    }
+    else
+    {
+      maps[d] = std::move(it->second);
+      other.maps.erase(it);
+    }
+  }
 }
 
 template<typename PolicyType, typename InputType>
@@ -0,0 +1,172 @@
+/**
+ * @file describe_statistics.cpp
+ *
+ * Implementation of the DescribeStatistics class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "describe_statistics.hpp"
+
+#ifdef HAS_OPENMP
+  #include <omp.h>
+#endif
+
+using namespace mlpack;
+using namespace mlpack::data;
+
+DescribeStatistics::DescribeStatistics(const size_t dimensionality)
+{
+  Reset(dimensionality);
+}
+
+void DescribeStatistics::Reset(const size_t dimensionality)
+{
+  count = 0;
+  mean.zeros(dimensionality);
+  m2.zeros(dimensionality);
+  m3.zeros(dimensionality);
+  m4.zeros(dimensionality);
+  min.set_size(dimensionality);
+  min.fill(arma::datum::inf);
+  max.set_size(dimensionality);
+  max.fill(-arma::datum::inf);
+}
+
+void DescribeStatistics::Update(const arma::mat& data)
+{
+  if (count == 0 && mean.n_elem == 0)
+    Reset(data.n_rows);
+
+  if (data.n_rows != mean.n_elem)
+  {
+    std::ostringstream oss;
+    oss << "DescribeStatistics::Update(): the points have " << data.n_rows
+        << " dimensions, but " << mean.n_elem << " were expected";
+    throw std::invalid_argument(oss.str());
+  }
+
+  // Each thread summarizes a contiguous block of the points, and the blocks
+  // are merged in order.
+  size_t numBlocks = 1;
+  #ifdef HAS_OPENMP
+  numBlocks = std::max(std::min((size_t) omp_get_max_threads(),
+      (size_t) data.n_cols), (size_t) 1);
+  #endif
+
+  std::vector<DescribeStatistics> blocks(numBlocks,
+      DescribeStatistics(data.n_rows));
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+  {
+    const size_t begin = b * data.n_cols / numBlocks;
+    const size_t end = (b + 1) * data.n_cols / numBlocks;
+    for (size_t i = begin; i < end; ++i)
+      blocks[b].Add(data.colptr(i));
+  }
+
+  for (size_t b = 0; b < numBlocks; ++b)
+    Merge(blocks[b]);
+}
+
+void DescribeStatistics::Add(const double* point)
+{
+  const double previousCount = count;
+  const double n = ++count;
+  for (size_t d = 0; d < mean.n_elem; ++d)
+  {
+    const double delta = point[d] - mean[d];
+    const double deltaN = delta / n;
+    const double deltaN2 = deltaN * deltaN;
+    const double term = delta * deltaN * previousCount;
+
+    // The higher moments are updated first, since they use the lower ones.
+    m4[d] += term * deltaN2 * (n * n - 3 * n + 3) + 6 * deltaN2 * m2[d] -
+        4 * deltaN * m3[d];
+    m3[d] += term * deltaN * (n - 2) - 3 * deltaN * m2[d];
+    m2[d] += term;
+    mean[d] += deltaN;
+
+    min[d] = std::min(min[d], point[d]);
+    max[d] = std::max(max[d], point[d]);
+  }
+}
+
+void DescribeStatistics::Merge(const DescribeStatistics& other)
+{
+  if (other.count == 0)
+    return;
+
+  if (count == 0)
+  {
+    *this = other;
+    return;
+  }
+
+  if (other.mean.n_elem != mean.n_elem)
+  {
+    std::ostringstream oss;
+    oss << "DescribeStatistics::Merge(): the statistics have "
+        << other.mean.n_elem << " dimensions, but " << mean.n_elem
+        << " were expected";
+    throw std::invalid_argument(oss.str());
+  }
+
+  const double na = count;
+  const double nb = other.count;
+  const double n = na + nb;
+  for (size_t d = 0; d < mean.n_elem; ++d)
+  {
+    const double delta = other.mean[d] - mean[d];
+    const double delta2 = delta * delta;
+
+    // The higher moments are merged first, since they use the lower ones.
+    m4[d] += other.m4[d] + delta2 * delta2 * na * nb *
+        (na * na - na * nb + nb * nb) / (n * n * n) +
+        6 * delta2 * (na * na * other.m2[d] + nb * nb * m2[d]) / (n * n) +
+        4 * delta * (na * other.m3[d] - nb * m3[d]) / n;
+    m3[d] += other.m3[d] + delta2 * delta * na * nb * (na - nb) / (n * n) +
+        3 * delta * (na * other.m2[d] - nb * m2[d]) / n;
+    m2[d] += other.m2[d] + delta2 * na * nb / n;
+    mean[d] += delta * nb / n;
+
+    min[d] = std::min(min[d], other.min[d]);
+    max[d] = std::max(max[d], other.max[d]);
+  }
+
+  count += other.count;
+}
+
+arma::vec DescribeStatistics::Variance(const bool population) const
+{
+  return m2 / (population ? count : count - 1.0);
+}
+
+arma::vec DescribeStatistics::StandardDeviation(const bool population) const
+{
+  return arma::sqrt(Variance(population));
+}
+
+arma::vec DescribeStatistics::Skewness(const bool population) const
+{
+  const double n = count;
+  const arma::vec std3 = arma::pow(StandardDeviation(population), 3);
+  if (population)
+    return m3 / (n * std3);
+  else
+    return n * m3 / ((n - 1) * (n - 2) * std3);
+}
+
+arma::vec DescribeStatistics::Kurtosis(const bool population) const
+{
+  const double n = count;
+  if (population)
+    return n * m4 / arma::square(m2) - 3;
+
+  const arma::vec std4 = arma::pow(StandardDeviation(population), 4);
+  const double norm3 = (3 * (n - 1) * (n - 1)) / ((n - 2) * (n - 3));
+  const double normC = (n * (n + 1)) / ((n - 1) * (n - 2) * (n - 3));
+  return normC * m4 / std4 - norm3;
+}
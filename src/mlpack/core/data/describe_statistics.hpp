@@ -0,0 +1,166 @@
+/**
+ * @file describe_statistics.hpp
+ *
+ * Definition of the DescribeStatistics class, which computes the descriptive
+ * statistics of each dimension of a dataset in one pass.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_DESCRIBE_STATISTICS_HPP
+#define MLPACK_CORE_DATA_DESCRIBE_STATISTICS_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace data {
+
+/**
+ * The DescribeStatistics class accumulates the count, the mean, the minimum,
+ * the maximum and the second to fourth central moments of each dimension of
+ * the points it is given, from which it computes the variance, the standard
+ * deviation, the skewness and the excess kurtosis.  The points can be given a
+ * chunk at a time, so that a dataset that does not fit in memory (see
+ * StreamingDataset) is described with one read:
+ *
+ * @code
+ * data::StreamingDataset<> dataset("clicks.bin", 50000);
+ * data::DescribeStatistics statistics;
+ * arma::mat points;
+ * while (dataset.Next(points))
+ *   statistics.Update(points);
+ *
+ * arma::vec skewness = statistics.Skewness();
+ * @endcode
+ *
+ * The moments are updated with numerically stable formulas: each point is
+ * added with the online update of Welford and Terriberry, and Update() splits
+ * the points into one block per OpenMP thread, whose statistics are merged in
+ * order with the pairwise formulas of Pebay.  Statistics computed separately
+ * (for instance on different machines) can be merged the same way with
+ * Merge().
+ *
+ * The median needs all the values of a dimension, so it is not computed here.
+ *
+ * For more information, see the following.
+ *
+ * @code
+ * @techreport{pebay2008formulas,
+ *   title       = {Formulas for Robust, One-Pass Parallel Computation of
+ *                  Covariances and Arbitrary-Order Statistical Moments},
+ *   author      = {Pebay, Philippe},
+ *   institution = {Sandia National Laboratories},
+ *   number      = {SAND2008-6212},
+ *   year        = {2008}
+ * }
+ * @endcode
+ */
+class DescribeStatistics
+{
+ public:
+  /**
+   * Create the statistics of an empty dataset with the given number of
+   * dimensions.  If it is 0, the number of dimensions of the first points
+   * given to Update() is used.
+   *
+   * @param dimensionality Number of dimensions of the points.
+   */
+  DescribeStatistics(const size_t dimensionality = 0);
+
+  /**
+   * Add the given points (one per column) to the statistics.
+   *
+   * @param data Points to add.
+   */
+  void Update(const arma::mat& data);
+
+  /**
+   * Merge the given statistics into these ones, so that they are the
+   * statistics of both sets of points.
+   *
+   * @param other Statistics to merge.
+   */
+  void Merge(const DescribeStatistics& other);
+
+  //! Get the number of dimensions of the points.
+  size_t Dimensionality() const { return mean.n_elem; }
+
+  //! Get the number of points.
+  size_t Count() const { return count; }
+
+  //! Get the mean of each dimension.
+  const arma::vec& Mean() const { return mean; }
+
+  //! Get the minimum of each dimension.
+  const arma::vec& Min() const { return min; }
+
+  //! Get the maximum of each dimension.
+  const arma::vec& Max() const { return max; }
+
+  /**
+   * Get the variance of each dimension.
+   *
+   * @param population If true, the points are the whole population; otherwise
+   *     they are a sample, and the unbiased estimator is used.
+   */
+  arma::vec Variance(const bool population = false) const;
+
+  /**
+   * Get the standard deviation of each dimension.
+   *
+   * @param population If true, the points are the whole population; otherwise
+   *     they are a sample.
+   */
+  arma::vec StandardDeviation(const bool population = false) const;
+
+  /**
+   * Get the skewness of each dimension.
+   *
+   * @param population If true, the points are the whole population; otherwise
+   *     they are a sample, and the adjusted estimator is used.
+   */
+  arma::vec Skewness(const bool population = false) const;
+
+  /**
+   * Get the excess kurtosis of each dimension.
+   *
+   * @param population If true, the points are the whole population; otherwise
+   *     they are a sample, and the adjusted estimator is used.
+   */
+  arma::vec Kurtosis(const bool population = false) const;
+
+ private:
+  //! Set the number of dimensions, with no points.
+  void Reset(const size_t dimensionality);
+
+  //! Add the point with the given values to the statistics.
+  void Add(const double* point);
+
+  //! The number of points.
+  size_t count;
+
+  //! The mean of each dimension.
+  arma::vec mean;
+
+  //! The sum of the squared deviations from the mean of each dimension.
+  arma::vec m2;
+
+  //! The sum of the cubed deviations from the mean of each dimension.
+  arma::vec m3;
+
+  //! The sum of the fourth powers of the deviations of each dimension.
+  arma::vec m4;
+
+  //! The minimum of each dimension.
+  arma::vec min;
+
+  //! The maximum of each dimension.
+  arma::vec max;
+};
+
+} // namespace data
+} // namespace mlpack
+
+#endif
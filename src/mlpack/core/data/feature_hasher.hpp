@@ -0,0 +1,128 @@
+/**
+ * @file feature_hasher.hpp
+ *
+ * Definition of the FeatureHasher class, which encodes a dataset with
+ * categorical dimensions into a sparse matrix of fixed dimensionality with the
+ * hashing trick.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_FEATURE_HASHER_HPP
+#define MLPACK_CORE_DATA_FEATURE_HASHER_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "dataset_mapper.hpp"
+
+namespace mlpack {
+namespace data {
+
+/**
+ * The FeatureHasher class encodes a dataset into a sparse matrix with a fixed
+ * number of dimensions, with the hashing trick: each category of each
+ * categorical dimension, and each numeric dimension, is hashed to an output
+ * dimension and a sign, and the output value of a point in an output dimension
+ * is the signed sum of the values hashed to it (1 for a category, the value
+ * itself for a numeric dimension).  Unlike OneHotEncoding(), the
+ * dimensionality does not grow with the number of categories, and since the
+ * strings of the categories are hashed (not their mapped values), datasets
+ * loaded separately, with different categories, are encoded consistently.  The
+ * signs make the inner products of the encoded points unbiased despite the
+ * collisions.
+ *
+ * The output is built directly in compressed sparse column form, with the
+ * points encoded in parallel.
+ *
+ * @code
+ * arma::mat input;
+ * data::DatasetInfo info;
+ * data::Load("clicks.csv", input, info);
+ *
+ * arma::sp_mat output;
+ * data::FeatureHasher hasher(1 << 20);
+ * hasher.Transform(input, info, output);
+ * @endcode
+ *
+ * For more information, see the following.
+ *
+ * @code
+ * @inproceedings{weinberger2009feature,
+ *   title     = {Feature Hashing for Large Scale Multitask Learning},
+ *   author    = {Weinberger, Kilian and Dasgupta, Anirban and Langford, John
+ *                and Smola, Alex and Attenberg, Josh},
+ *   booktitle = {Proceedings of the 26th International Conference on Machine
+ *                Learning (ICML '09)},
+ *   pages     = {1113--1120},
+ *   year      = {2009}
+ * }
+ * @endcode
+ */
+class FeatureHasher
+{
+ public:
+  /**
+   * Create the FeatureHasher.
+   *
+   * @param numFeatures Number of output dimensions.
+   * @param alternateSign If true, the values are added with the sign given by
+   *     the hash; otherwise they are all added.
+   */
+  FeatureHasher(const size_t numFeatures = 1048576,
+                const bool alternateSign = true) :
+      numFeatures(numFeatures),
+      alternateSign(alternateSign)
+  { /* Nothing to do. */ }
+
+  /**
+   * Encode the given dataset, whose categorical dimensions were mapped by the
+   * given DatasetMapper, into a sparse matrix with NumFeatures() dimensions.
+   *
+   * @param input Dataset to encode, with categorical values mapped by info.
+   * @param info Types and mappings of the dimensions of the dataset.
+   * @param output Sparse matrix to store the encoded dataset into.
+   */
+  template<typename eT, typename PolicyType>
+  void Transform(const arma::Mat<eT>& input,
+                 const DatasetMapper<PolicyType>& info,
+                 arma::SpMat<eT>& output) const;
+
+  /**
+   * Hash the given category of the given dimension (or, if it is empty, the
+   * numeric dimension) to an output dimension and a sign.
+   *
+   * @param dimension Dimension of the input.
+   * @param category String of the category.
+   * @param sign Variable to store the sign (1 or -1) into.
+   * @return The output dimension.
+   */
+  size_t Hash(const size_t dimension,
+              const std::string& category,
+              double& sign) const;
+
+  //! Get the number of output dimensions.
+  size_t NumFeatures() const { return numFeatures; }
+  //! Modify the number of output dimensions.
+  size_t& NumFeatures() { return numFeatures; }
+
+  //! Get whether the values are added with the sign given by the hash.
+  bool AlternateSign() const { return alternateSign; }
+  //! Modify whether the values are added with the sign given by the hash.
+  bool& AlternateSign() { return alternateSign; }
+
+ private:
+  //! The number of output dimensions.
+  size_t numFeatures;
+
+  //! Whether the values are added with the sign given by the hash.
+  bool alternateSign;
+};
+
+} // namespace data
+} // namespace mlpack
+
+// Include implementation.
+#include "feature_hasher_impl.hpp"
+
+#endif
@@ -0,0 +1,171 @@
+/**
+ * @file feature_hasher_impl.hpp
+ *
+ * Implementation of the FeatureHasher class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_FEATURE_HASHER_IMPL_HPP
+#define MLPACK_CORE_DATA_FEATURE_HASHER_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "feature_hasher.hpp"
+
+namespace mlpack {
+namespace data {
+
+inline size_t FeatureHasher::Hash(const size_t dimension,
+                                  const std::string& category,
+                                  double& sign) const
+{
+  // 64-bit FNV-1a over the bytes of the dimension and of the category, so the
+  // hash is the same on every platform and in every run.
+  uint64_t hash = 14695981039346656037ULL;
+  for (size_t i = 0; i < 8; ++i)
+  {
+    hash ^= ((uint64_t) dimension >> (8 * i)) & 0xFF;
+    hash *= 1099511628211ULL;
+  }
+  for (size_t i = 0; i < category.size(); ++i)
+  {
+    hash ^= (uint64_t) (unsigned char) category[i];
+    hash *= 1099511628211ULL;
+  }
+
+  // The highest bit gives the sign, and the others the output dimension.
+  sign = (alternateSign && (hash >> 63)) ? -1.0 : 1.0;
+  return (size_t) ((hash & 0x7FFFFFFFFFFFFFFFULL) % numFeatures);
+}
+
+template<typename eT, typename PolicyType>
+void FeatureHasher::Transform(const arma::Mat<eT>& input,
+                              const DatasetMapper<PolicyType>& info,
+                              arma::SpMat<eT>& output) const
+{
+  if (info.Dimensionality() != input.n_rows)
+  {
+    std::ostringstream oss;
+    oss << "FeatureHasher::Transform(): the dataset has " << input.n_rows
+        << " dimensions, but the DatasetMapper has " << info.Dimensionality();
+    throw std::invalid_argument(oss.str());
+  }
+
+  if (numFeatures == 0)
+  {
+    throw std::invalid_argument("FeatureHasher::Transform(): the number of "
+        "features must be positive");
+  }
+
+  // Each category is hashed once: firstHash[d] is the index in the tables of
+  // the first category of dimension d (or of the numeric dimension d).
+  std::vector<bool> categorical(input.n_rows);
+  std::vector<size_t> firstHash(input.n_rows + 1, 0);
+  std::vector<arma::uword> hashRows;
+  std::vector<eT> hashSigns;
+  for (size_t d = 0; d < input.n_rows; ++d)
+  {
+    categorical[d] = (info.Type(d) == Datatype::categorical);
+    double sign;
+    if (categorical[d])
+    {
+      for (size_t c = 0; c < info.NumMappings(d); ++c)
+      {
+        hashRows.push_back(Hash(d, info.UnmapString(c, d), sign));
+        hashSigns.push_back((eT) sign);
+      }
+    }
+    else
+    {
+      hashRows.push_back(Hash(d, "", sign));
+      hashSigns.push_back((eT) sign);
+    }
+
+    firstHash[d + 1] = hashRows.size();
+  }
+
+  // Each point is encoded separately, since its number of nonzero values
+  // depends on the collisions.
+  std::vector<std::vector<std::pair<arma::uword, eT>>> columns(input.n_cols);
+  arma::uvec colPtrs(input.n_cols + 1);
+  colPtrs[0] = 0;
+  bool valid = true;
+  #pragma omp parallel for reduction(&&: valid)
+  for (omp_size_t i = 0; i < (omp_size_t) input.n_cols; ++i)
+  {
+    std::vector<std::pair<arma::uword, eT>>& column = columns[i];
+    column.reserve(input.n_rows);
+    for (size_t d = 0; d < input.n_rows; ++d)
+    {
+      const eT value = input(d, i);
+      if (categorical[d])
+      {
+        const size_t numCategories = firstHash[d + 1] - firstHash[d];
+        if (!(value >= 0 && value < numCategories &&
+            value == std::floor(value)))
+        {
+          valid = false;
+          continue;
+        }
+
+        const size_t h = firstHash[d] + (size_t) value;
+        column.push_back(std::make_pair(hashRows[h], hashSigns[h]));
+      }
+      else if (value != 0)
+      {
+        const size_t h = firstHash[d];
+        column.push_back(std::make_pair(hashRows[h], hashSigns[h] * value));
+      }
+    }
+
+    // Values hashed to the same output dimension are summed, and the ones that
+    // cancel out are dropped.
+    std::sort(column.begin(), column.end(),
+        [](const std::pair<arma::uword, eT>& a,
+           const std::pair<arma::uword, eT>& b) { return a.first < b.first; });
+    size_t count = 0;
+    for (size_t j = 0; j < column.size(); ++j)
+    {
+      if (count > 0 && column[count - 1].first == column[j].first)
+        column[count - 1].second += column[j].second;
+      else
+        column[count++] = column[j];
+
+      if (column[count - 1].second == 0)
+        --count;
+    }
+    column.resize(count);
+
+    colPtrs[i + 1] = count;
+  }
+
+  if (!valid)
+  {
+    throw std::invalid_argument("FeatureHasher::Transform(): the dataset has "
+        "a categorical value that is not mapped by the DatasetMapper");
+  }
+
+  colPtrs = arma::cumsum(colPtrs);
+
+  arma::uvec rowIndices(colPtrs[input.n_cols]);
+  arma::Col<eT> values(colPtrs[input.n_cols]);
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) input.n_cols; ++i)
+  {
+    for (size_t j = 0; j < columns[i].size(); ++j)
+    {
+      rowIndices[colPtrs[i] + j] = columns[i][j].first;
+      values[colPtrs[i] + j] = columns[i][j].second;
+    }
+  }
+
+  output = arma::SpMat<eT>(rowIndices, colPtrs, values, numFeatures,
+      input.n_cols);
+}
+
+} // namespace data
+} // namespace mlpack
+
+#endif
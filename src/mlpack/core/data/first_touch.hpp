@@ -0,0 +1,90 @@
+/**
+ * @file first_touch.hpp
+ *
+ * Place the columns of a matrix in the memory of the threads that will
+ * process them, on machines with non-uniform memory access (NUMA).
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_FIRST_TOUCH_HPP
+#define MLPACK_CORE_DATA_FIRST_TOUCH_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace data {
+
+/**
+ * Copy a matrix into new memory, so that each block of columns is placed on
+ * the NUMA node of the thread that will process it.  Operating systems place a
+ * page of memory on the node of the thread that writes it first; a matrix
+ * loaded by one thread (like the ones given by data::Load()) is then all on
+ * one node, and on a machine with several sockets most threads of a parallel
+ * loop read remote memory.
+ *
+ * The columns are split into blocks of blockSize columns, and the blocks are
+ * copied by a `#pragma omp for schedule(static)` loop.  A later loop over the
+ * same blocks with schedule(static), in a parallel region with the same number
+ * of threads, gives each thread the blocks it copied; this is how NaiveKMeans
+ * and the naive mode of NeighborSearch process their points.  A loop over
+ * blocks of another size gets almost the same split, and only the columns at
+ * the boundaries are remote.
+ *
+ * The placement only helps if the threads do not move between sockets: set
+ * OMP_PROC_BIND (for instance to "spread" or "close") before the program
+ * starts, so that the OpenMP runtime pins them.  Without OpenMP this is a
+ * plain copy.
+ *
+ * @param source Matrix to copy.
+ * @param matrix Matrix to store the copy in.
+ * @param blockSize Number of columns in each block of the loops that will
+ *     process the matrix.
+ */
+template<typename eT>
+void FirstTouch(const arma::Mat<eT>& source,
+                arma::Mat<eT>& matrix,
+                const size_t blockSize = 1)
+{
+  if (blockSize == 0)
+    throw std::invalid_argument("FirstTouch(): blockSize must be positive");
+
+  // The new memory must not be written here, so that the first write to each
+  // page is made by the loop below.
+  arma::Mat<eT> placed(source.n_rows, source.n_cols, arma::fill::none);
+
+  const size_t numBlocks = (source.n_cols + blockSize - 1) / blockSize;
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+  {
+    const size_t begin = b * blockSize;
+    const size_t count = std::min(blockSize, (size_t) source.n_cols - begin);
+    std::copy(source.colptr(begin), source.colptr(begin) + count *
+        source.n_rows, placed.colptr(begin));
+  }
+
+  matrix.steal_mem(placed);
+}
+
+/**
+ * Move the columns of the given matrix to new memory, so that each block of
+ * columns is placed on the NUMA node of the thread that will process it.  See
+ * FirstTouch(const arma::Mat<eT>&, arma::Mat<eT>&, const size_t).
+ *
+ * @param matrix Matrix to place.
+ * @param blockSize Number of columns in each block of the loops that will
+ *     process the matrix.
+ */
+template<typename eT>
+void FirstTouch(arma::Mat<eT>& matrix, const size_t blockSize = 1)
+{
+  const arma::Mat<eT> source(std::move(matrix));
+  FirstTouch(source, matrix, blockSize);
+}
+
+} // namespace data
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,191 @@
+/**
+ * @file flat_payload.cpp
+ *
+ * Implementation of the FlatPayload class and of the functions that write and
+ * map flat model files.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "flat_payload.hpp"
+
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+#ifndef _WIN32
+  #include <fcntl.h>
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+  #include <unistd.h>
+#endif
+
+namespace mlpack {
+namespace data {
+
+const uint32_t FlatPayload::Version;
+const size_t FlatPayload::MinBytes;
+const size_t FlatPayload::Alignment;
+
+namespace {
+
+//! Round the given size up to a multiple of the payload alignment.
+uint64_t Align(const uint64_t size)
+{
+  return ((size + FlatPayload::Alignment - 1) / FlatPayload::Alignment) *
+      FlatPayload::Alignment;
+}
+
+//! Write zeros to the stream until its size is the given one.
+void Pad(std::ostream& stream, const uint64_t written, const uint64_t size)
+{
+  const char zeros[FlatPayload::Alignment] = { 0 };
+  stream.write(zeros, size - written);
+}
+
+const char flatMagic[8] = { 'M', 'L', 'P', 'K', 'F', 'L', 'A', 'T' };
+
+} // namespace
+
+uint64_t FlatPayload::Add(const void* data, const size_t bytes)
+{
+  const uint64_t offset = Align(size);
+  arrays.push_back(std::make_pair(data, bytes));
+  size = offset + bytes;
+  return offset;
+}
+
+void* FlatPayload::Get(const uint64_t offset, const size_t bytes) const
+{
+  if (base == NULL || offset > size || bytes > size - offset)
+  {
+    std::ostringstream oss;
+    oss << "FlatPayload::Get(): array of " << bytes << " bytes at offset "
+        << offset << " is not inside the payload (" << size << " bytes); the "
+        << "file may be corrupt.";
+    throw std::runtime_error(oss.str());
+  }
+
+  return base + offset;
+}
+
+void FlatPayload::Write(std::ostream& stream) const
+{
+  uint64_t written = 0;
+  for (size_t i = 0; i < arrays.size(); ++i)
+  {
+    const uint64_t offset = Align(written);
+    Pad(stream, written, offset);
+    stream.write((const char*) arrays[i].first, arrays[i].second);
+    written = offset + arrays[i].second;
+  }
+}
+
+void SaveFlatFile(std::ostream& stream,
+                  const std::string& metadata,
+                  const FlatPayload& payload)
+{
+  FlatPayload::Header header;
+  std::memcpy(header.magic, flatMagic, sizeof(flatMagic));
+  header.version = FlatPayload::Version;
+  header.reserved = 0;
+  header.metadataSize = metadata.size();
+  header.payloadOffset = Align(sizeof(FlatPayload::Header) + metadata.size());
+  header.payloadSize = payload.Size();
+
+  stream.write((const char*) &header, sizeof(FlatPayload::Header));
+  stream.write(metadata.data(), metadata.size());
+  Pad(stream, sizeof(FlatPayload::Header) + metadata.size(),
+      header.payloadOffset);
+  payload.Write(stream);
+
+  if (!stream)
+    throw std::runtime_error("SaveFlatFile(): error writing the file.");
+}
+
+void MapFlatFile(const std::string& filename,
+                 const char*& metadata,
+                 size_t& metadataSize,
+                 char*& payload,
+                 size_t& payloadSize)
+{
+  char* data = NULL;
+  size_t size = 0;
+
+#ifdef _WIN32
+  // There is no mmap(), so just read the file into memory, which is kept just
+  // like the mapping would be.
+  std::ifstream stream(filename.c_str(), std::ios::in | std::ios::binary);
+  if (stream.is_open())
+  {
+    stream.seekg(0, std::ios::end);
+    size = (size_t) stream.tellg();
+    stream.seekg(0, std::ios::beg);
+    data = new char[size];
+    if (!stream.read(data, size))
+    {
+      delete[] data;
+      data = NULL;
+    }
+  }
+#else
+  const int fd = open(filename.c_str(), O_RDONLY);
+  struct stat fileStat;
+  if (fd != -1 && fstat(fd, &fileStat) == 0 && fileStat.st_size > 0)
+  {
+    size = (size_t) fileStat.st_size;
+    void* mapping = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd,
+        0);
+    if (mapping != MAP_FAILED)
+      data = (char*) mapping;
+  }
+  if (fd != -1)
+    close(fd);
+#endif
+
+  if (data == NULL)
+  {
+    std::ostringstream oss;
+    oss << "MapFlatFile(): cannot map file '" << filename << "'.";
+    throw std::runtime_error(oss.str());
+  }
+
+  FlatPayload::Header header;
+  bool valid = (size >= sizeof(FlatPayload::Header));
+  if (valid)
+  {
+    std::memcpy(&header, data, sizeof(FlatPayload::Header));
+    valid = (std::memcmp(header.magic, flatMagic, sizeof(flatMagic)) == 0) &&
+        (header.version == FlatPayload::Version) &&
+        (header.metadataSize <= size - sizeof(FlatPayload::Header)) &&
+        (header.payloadOffset >= sizeof(FlatPayload::Header) +
+            header.metadataSize) &&
+        (header.payloadOffset <= size) &&
+        (header.payloadSize <= size - header.payloadOffset);
+  }
+
+  if (!valid)
+  {
+#ifdef _WIN32
+    delete[] data;
+#else
+    munmap(data, size);
+#endif
+
+    std::ostringstream oss;
+    oss << "MapFlatFile(): '" << filename << "' is not a flat model file of "
+        << "version " << FlatPayload::Version << ".";
+    throw std::runtime_error(oss.str());
+  }
+
+  metadata = data + sizeof(FlatPayload::Header);
+  metadataSize = header.metadataSize;
+  payload = data + header.payloadOffset;
+  payloadSize = header.payloadSize;
+}
+
+} // namespace data
+} // namespace mlpack
@@ -0,0 +1,200 @@
+/**
+ * @file flat_payload.hpp
+ *
+ * Definition of the FlatPayload class, which holds the large arrays of a model
+ * that is saved in (or loaded from) the flat model format (format::flat).
+ *
+ * This file is included by arma_extend.hpp, before Armadillo and the rest of
+ * mlpack, so it may only use the standard library.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_FLAT_PAYLOAD_HPP
+#define MLPACK_CORE_DATA_FLAT_PAYLOAD_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <streambuf>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace mlpack {
+namespace data /** Functions to load and save matrices and models. */ {
+
+/**
+ * A flat model file holds the object in two parts: a boost::serialization
+ * binary archive with everything except the large arrays (the metadata), and
+ * the large arrays themselves, stored one after another as raw memory (the
+ * payload).  This lets the file be mapped into memory when it is loaded, and
+ * the loaded matrices then point into the mapping instead of being copied.
+ *
+ * The layout of the file is:
+ *
+ *  - a header (see FlatPayload::Header), which holds the version of the format
+ *    and the size and position of the two parts;
+ *  - the metadata archive;
+ *  - the payload.  Each array is aligned to FlatPayload::Alignment bytes.
+ *
+ * While an object is serialized for a flat model file, the FlatPayload in use
+ * is returned by FlatPayload::Active().  Serialization functions (for now, the
+ * one of arma::Mat) check it, and when it is set, they store large arrays with
+ * Add() and Get() instead of in the archive.  Nothing changes for the other
+ * formats.
+ */
+class FlatPayload
+{
+ public:
+  //! Version of the file format.
+  static const uint32_t Version = 1;
+  //! Arrays smaller than this (in bytes) are stored in the archive.
+  static const size_t MinBytes = 4096;
+  //! Alignment of the arrays in the payload.
+  static const size_t Alignment = 64;
+
+  //! Header of a flat model file.
+  struct Header
+  {
+    //! Always "MLPKFLAT".
+    char magic[8];
+    //! Version of the file format.
+    uint32_t version;
+    //! Unused; always 0.
+    uint32_t reserved;
+    //! Size of the metadata archive, which comes right after the header.
+    uint64_t metadataSize;
+    //! Position of the payload in the file.
+    uint64_t payloadOffset;
+    //! Size of the payload.
+    uint64_t payloadSize;
+  };
+
+  /**
+   * Create an empty payload, to save an object.
+   */
+  FlatPayload() : base(NULL), size(0) { }
+
+  /**
+   * Create a payload on memory that holds the payload of a file, to load an
+   * object.  The memory must stay valid while the loaded object is used.
+   */
+  FlatPayload(char* base, const size_t size) : base(base), size(size) { }
+
+  /**
+   * Add an array to the payload, and return its offset.  The memory is not
+   * copied, so it must stay valid until Write() is called.
+   *
+   * @param data Array to add.
+   * @param bytes Size of the array (in bytes).
+   */
+  uint64_t Add(const void* data, const size_t bytes);
+
+  /**
+   * Get the array at the given offset, which was returned by Add() when the
+   * file was saved.  If the array is not inside the payload,
+   * std::runtime_error is thrown.
+   *
+   * @param offset Offset of the array.
+   * @param bytes Size of the array (in bytes).
+   */
+  void* Get(const uint64_t offset, const size_t bytes) const;
+
+  //! Get the size of the payload (in bytes).
+  size_t Size() const { return size; }
+
+  /**
+   * Write the arrays added with Add() to the given stream.
+   */
+  void Write(std::ostream& stream) const;
+
+  /**
+   * Get the payload that the serialization in the current thread should use,
+   * or NULL if no flat model file is being saved or loaded.
+   */
+  static FlatPayload*& Active()
+  {
+    static thread_local FlatPayload* active = NULL;
+    return active;
+  }
+
+ private:
+  //! The arrays added with Add(), and their sizes.
+  std::vector<std::pair<const void*, size_t>> arrays;
+  //! The memory that holds the payload, when loading.
+  char* base;
+  //! Size of the payload.
+  size_t size;
+};
+
+/**
+ * Make the given FlatPayload active in the current thread, until the
+ * FlatPayloadScope is destroyed.
+ */
+class FlatPayloadScope
+{
+ public:
+  FlatPayloadScope(FlatPayload& payload) :
+      previous(FlatPayload::Active())
+  {
+    FlatPayload::Active() = &payload;
+  }
+
+  ~FlatPayloadScope() { FlatPayload::Active() = previous; }
+
+ private:
+  //! The payload that was active before.
+  FlatPayload* previous;
+};
+
+/**
+ * Write a flat model file with the given metadata archive and payload.
+ *
+ * @param stream Stream (opened in binary mode) to write to.
+ * @param metadata The binary archive holding the metadata.
+ * @param payload The payload.
+ */
+void SaveFlatFile(std::ostream& stream,
+                  const std::string& metadata,
+                  const FlatPayload& payload);
+
+/**
+ * Map the given flat model file into memory, check its header, and find the
+ * metadata and payload.  The mapping is private, so the loaded objects may be
+ * modified without changing the file.  It is kept until the end of the program,
+ * because the loaded matrices point into it.  If the file can't be mapped or
+ * isn't a flat model file, std::runtime_error is thrown.
+ *
+ * @param filename Name of the file.
+ * @param metadata Will be set to the metadata archive.
+ * @param metadataSize Will be set to the size of the metadata archive.
+ * @param payload Will be set to the payload.
+ * @param payloadSize Will be set to the size of the payload.
+ */
+void MapFlatFile(const std::string& filename,
+                 const char*& metadata,
+                 size_t& metadataSize,
+                 char*& payload,
+                 size_t& payloadSize);
+
+/**
+ * A read-only stream buffer over existing memory, used to read the metadata
+ * archive out of the mapping without copying it.
+ */
+class MemoryStreamBuffer : public std::streambuf
+{
+ public:
+  MemoryStreamBuffer(const char* data, const size_t size)
+  {
+    char* begin = const_cast<char*>(data);
+    setg(begin, begin, begin + size);
+  }
+};
+
+} // namespace data
+} // namespace mlpack
+
+#endif
@@ -22,7 +22,8 @@ enum format
   autodetect,
   text,
   xml,
-  binary
+  binary,
+  flat
 };
 
 } // namespace data
@@ -71,6 +71,45 @@ class CustomImputation
     }
   }
 
+  /**
+   * Impute function that replaces the mappedValues of all the given dimensions
+   * with the user-defined custom value, in one parallel pass over the data.
+   *
+   * @param input Matrix that contains mappedValues.
+   * @param mappedValues Value that the user wants to get rid of, for each
+   *     dimension.
+   * @param dimensions Indices of the dimensions to impute.
+   * @param columnMajor State of whether the input matrix is columnMajor or not.
+   */
+  void Impute(arma::Mat<T>& input,
+              const std::vector<T>& mappedValues,
+              const std::vector<size_t>& dimensions,
+              const bool columnMajor = true)
+  {
+    if (columnMajor)
+    {
+      // Each point is checked for all the dimensions while it is in cache.
+      #pragma omp parallel for
+      for (omp_size_t i = 0; i < (omp_size_t) input.n_cols; ++i)
+      {
+        T* point = input.colptr(i);
+        for (size_t j = 0; j < dimensions.size(); ++j)
+        {
+          T& value = point[dimensions[j]];
+          if (value == mappedValues[j] || std::isnan(value))
+            value = customValue;
+        }
+      }
+    }
+    else
+    {
+      // Each dimension is a contiguous column.
+      #pragma omp parallel for
+      for (omp_size_t j = 0; j < (omp_size_t) dimensions.size(); ++j)
+        Impute(input, mappedValues[j], dimensions[j], false);
+    }
+  }
+
  private:
   //! A user-defined value that the user wants to replace missing values with.
   T customValue;
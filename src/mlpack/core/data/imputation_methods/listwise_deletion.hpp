@@ -66,6 +66,48 @@ class ListwiseDeletion
       input = input.rows(arma::uvec(colsToKeep));
     }
   }
+
+  /**
+   * Impute function that removes every point with a mappedValue in any of the
+   * given dimensions.  The points to keep are marked in one parallel pass over
+   * the data, and the matrix is then built once.  The result is overwritten to
+   * the input.
+   *
+   * @param input Matrix that contains mappedValues.
+   * @param mappedValues Value that the user wants to get rid of, for each
+   *     dimension.
+   * @param dimensions Indices of the dimensions to check.
+   * @param columnMajor State of whether the input matrix is columnMajor or not.
+   */
+  void Impute(arma::Mat<T>& input,
+              const std::vector<T>& mappedValues,
+              const std::vector<size_t>& dimensions,
+              const bool columnMajor = true)
+  {
+    const size_t numPoints = columnMajor ? input.n_cols : input.n_rows;
+    arma::uvec keep(numPoints);
+
+    #pragma omp parallel for
+    for (omp_size_t i = 0; i < (omp_size_t) numPoints; ++i)
+    {
+      keep[i] = 1;
+      for (size_t j = 0; j < dimensions.size(); ++j)
+      {
+        const T value = columnMajor ? input(dimensions[j], i) :
+            input(i, dimensions[j]);
+        if (value == mappedValues[j] || std::isnan(value))
+        {
+          keep[i] = 0;
+          break;
+        }
+      }
+    }
+
+    if (columnMajor)
+      input = input.cols(arma::find(keep));
+    else
+      input = input.rows(arma::find(keep));
+  }
 }; // class ListwiseDeletion
 
 } // namespace data
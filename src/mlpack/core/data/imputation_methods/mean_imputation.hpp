@@ -96,6 +96,83 @@ class MeanImputation
       input(target.first, target.second) = mean;
     }
   }
+
+  /**
+   * Impute function that replaces the mappedValues of all the given dimensions
+   * with the mean of their dimension.  For a columnMajor matrix, the sums of
+   * all the dimensions are computed in one parallel pass over the points, and
+   * the missing values are replaced in a second one; otherwise the dimensions
+   * (which are contiguous columns) are imputed in parallel.
+   *
+   * @param input Matrix that contains mappedValues.
+   * @param mappedValues Value that the user wants to get rid of, for each
+   *     dimension.
+   * @param dimensions Indices of the dimensions to impute.
+   * @param columnMajor State of whether the input matrix is columnMajor or not.
+   */
+  void Impute(arma::Mat<T>& input,
+              const std::vector<T>& mappedValues,
+              const std::vector<size_t>& dimensions,
+              const bool columnMajor = true)
+  {
+    if (!columnMajor)
+    {
+      #pragma omp parallel for
+      for (omp_size_t j = 0; j < (omp_size_t) dimensions.size(); ++j)
+        Impute(input, mappedValues[j], dimensions[j], false);
+      return;
+    }
+
+    // sum and number of elements of each dimension, excluding mapped value or
+    // nan.
+    arma::vec sums(dimensions.size(), arma::fill::zeros);
+    arma::Col<size_t> elems(dimensions.size(), arma::fill::zeros);
+    #pragma omp parallel
+    {
+      arma::vec threadSums(dimensions.size(), arma::fill::zeros);
+      arma::Col<size_t> threadElems(dimensions.size(), arma::fill::zeros);
+
+      #pragma omp for
+      for (omp_size_t i = 0; i < (omp_size_t) input.n_cols; ++i)
+      {
+        const T* point = input.colptr(i);
+        for (size_t j = 0; j < dimensions.size(); ++j)
+        {
+          const T value = point[dimensions[j]];
+          if (!(value == mappedValues[j] || std::isnan(value)))
+          {
+            threadSums[j] += value;
+            threadElems[j]++;
+          }
+        }
+      }
+
+      #pragma omp critical(MeanImputationSums)
+      {
+        sums += threadSums;
+        elems += threadElems;
+      }
+    }
+
+    if (arma::any(elems == 0))
+      Log::Fatal << "it is impossible to calculate mean; no valid elements in "
+          << "the dimension" << std::endl;
+
+    const arma::vec means = sums / arma::conv_to<arma::vec>::from(elems);
+
+    // Now replace the calculated means to the missing variables.
+    #pragma omp parallel for
+    for (omp_size_t i = 0; i < (omp_size_t) input.n_cols; ++i)
+    {
+      T* point = input.colptr(i);
+      for (size_t j = 0; j < dimensions.size(); ++j)
+      {
+        T& value = point[dimensions[j]];
+        if (value == mappedValues[j] || std::isnan(value))
+          value = means[j];
+      }
+    }
+  }
 }; // class MeanImputation
 
 } // namespace data
@@ -85,6 +85,27 @@ class MedianImputation
        input(target.first, target.second) = median;
     }
   }
+
+  /**
+   * Impute function that replaces the mappedValues of all the given dimensions
+   * with the median of their dimension.  The median needs all the values of a
+   * dimension, so the dimensions are imputed in parallel.
+   *
+   * @param input Matrix that contains mappedValues.
+   * @param mappedValues Value that the user wants to get rid of, for each
+   *     dimension.
+   * @param dimensions Indices of the dimensions to impute.
+   * @param columnMajor State of whether the input matrix is columnMajor or not.
+   */
+  void Impute(arma::Mat<T>& input,
+              const std::vector<T>& mappedValues,
+              const std::vector<size_t>& dimensions,
+              const bool columnMajor = true)
+  {
+    #pragma omp parallel for schedule(dynamic)
+    for (omp_size_t j = 0; j < (omp_size_t) dimensions.size(); ++j)
+      Impute(input, mappedValues[j], dimensions[j], columnMajor);
+  }
 }; // class MedianImputation
 
 } // namespace data
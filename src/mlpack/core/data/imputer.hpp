@@ -14,6 +14,7 @@
 #define MLPACK_CORE_DATA_IMPUTER_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/core/util/sfinae_utility.hpp>
 #include "dataset_mapper.hpp"
 #include "map_policies/missing_policy.hpp"
 #include "map_policies/increment_policy.hpp"
@@ -21,6 +22,11 @@
 namespace mlpack {
 namespace data {
 
+// This gives us a HasImputeCheck<T, U> type (where U is a function pointer) we
+// can use with SFINAE to catch when a strategy can impute several dimensions
+// at once.
+HAS_MEM_FUNC(Impute, HasImputeCheck);
+
 /**
  * Given a dataset of a particular datatype, replace user-specified missing
  * value with a variable dependent on the StrategyType and MapperType.
@@ -65,6 +71,32 @@ class Imputer
     strategy.Impute(input, mappedValue, dimension, columnMajor);
   }
 
+  /**
+  * Given an input dataset, replace missing values of all the given dimensions
+  * with given imputation strategy. If the strategy supports it (like the
+  * strategies of mlpack), all the dimensions are imputed in one parallel pass
+  * over the data; otherwise they are imputed one after the other. This
+  * function does not produce output matrix, but overwrites the result into the
+  * input matrix.
+  *
+  * @param input Input dataset to apply imputation.
+  * @param missingValue User defined missing value; it can be anything.
+  * @param dimensions Dimensions to apply the imputation (each one only once).
+  */
+  void Impute(arma::Mat<T>& input,
+              const std::string& missingValue,
+              const std::vector<size_t>& dimensions)
+  {
+    std::vector<T> mappedValues(dimensions.size());
+    for (size_t i = 0; i < dimensions.size(); ++i)
+    {
+      mappedValues[i] = static_cast<T>(mapper.UnmapValue(missingValue,
+          dimensions[i]));
+    }
+
+    ImputeDimensions(input, mappedValues, dimensions);
+  }
+
   //! Get the strategy
   const StrategyType& Strategy() const { return strategy; }
 
@@ -86,6 +118,31 @@ class Imputer
 
   // save columnMajor as a member variable since it is rarely changed.
   bool columnMajor;
+
+  //! Impute all the given dimensions at once with the strategy.
+  template<typename Strategy = StrategyType>
+  typename std::enable_if<HasImputeCheck<Strategy,
+      void(Strategy::*)(arma::Mat<T>&, const std::vector<T>&,
+      const std::vector<size_t>&, const bool)>::value, void>::type
+  ImputeDimensions(arma::Mat<T>& input,
+                   const std::vector<T>& mappedValues,
+                   const std::vector<size_t>& dimensions)
+  {
+    strategy.Impute(input, mappedValues, dimensions, columnMajor);
+  }
+
+  //! Impute the given dimensions one after the other with the strategy.
+  template<typename Strategy = StrategyType>
+  typename std::enable_if<!HasImputeCheck<Strategy,
+      void(Strategy::*)(arma::Mat<T>&, const std::vector<T>&,
+      const std::vector<size_t>&, const bool)>::value, void>::type
+  ImputeDimensions(arma::Mat<T>& input,
+                   const std::vector<T>& mappedValues,
+                   const std::vector<size_t>& dimensions)
+  {
+    for (size_t i = 0; i < dimensions.size(); ++i)
+      strategy.Impute(input, mappedValues[i], dimensions[i], columnMajor);
+  }
 }; // class Imputer
 
 } // namespace data
@@ -44,6 +44,12 @@ void LoadARFF(const std::string& filename, arma::Mat<eT>& matrix);
  * loading the training set is not used, then the test set may be loaded with
  * different mappings---which can cause horrible problems!
  *
+ * The rows of the @data section may be dense (a comma-separated value for each
+ * attribute) or sparse ({index value, index value, ...}, with zero-based
+ * indices; the attributes that aren't given are zero).  The @data section is
+ * read at once and its lines are parsed in parallel when OpenMP is available;
+ * the categorical mappings are the same as if the file were parsed serially.
+ *
  * @param filename Name of ARFF file to load.
  * @param matrix Matrix to load data into.
  * @param info DatasetInfo object; can be default-constructed or pre-existing
@@ -54,6 +60,31 @@ void LoadARFF(const std::string& filename,
               arma::Mat<eT>& matrix,
               DatasetMapper<PolicyType>& info);
 
+/**
+ * Load an ARFF dataset as numeric features into a sparse matrix.  An exception
+ * will be thrown if any features are non-numeric.
+ */
+template<typename eT>
+void LoadARFF(const std::string& filename, arma::SpMat<eT>& matrix);
+
+/**
+ * Load an ARFF dataset as numeric and categorical features into a sparse
+ * matrix, using the DatasetInfo structure for mapping.  This works just like
+ * the dense overload above, but only the nonzero values are ever stored, so
+ * datasets with sparse rows can be loaded without building a dense matrix
+ * first.  Dense rows may be mixed with sparse rows.  Note that a categorical
+ * value that maps to 0 is not stored either.
+ *
+ * @param filename Name of ARFF file to load.
+ * @param matrix Sparse matrix to load data into.
+ * @param info DatasetInfo object; can be default-constructed or pre-existing
+ *     from another call to LoadARFF().
+ */
+template<typename eT, typename PolicyType>
+void LoadARFF(const std::string& filename,
+              arma::SpMat<eT>& matrix,
+              DatasetMapper<PolicyType>& info);
+
 } // namespace data
 } // namespace mlpack
 
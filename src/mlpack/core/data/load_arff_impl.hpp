@@ -17,17 +17,97 @@
 
 #include <boost/algorithm/string/trim.hpp>
 
+#include <exception>
+
+
 namespace mlpack {
 namespace data {
+namespace details {
 
-template<typename eT, typename PolicyType>
-void LoadARFF(const std::string& filename,
-              arma::Mat<eT>& matrix,
-              DatasetMapper<PolicyType>& info)
+/**
+ * A line of the @data section of an ARFF file: the range of the line in the
+ * buffer (without surrounding whitespace) and its line number in the file.
+ */
+struct ARFFLine
+{
+  size_t begin;
+  size_t end;
+  size_t number;
+};
+
+/**
+ * A categorical value found while the @data section is parsed.  These are
+ * mapped after all the lines have been parsed, in file order, so the mappings
+ * are the same no matter how many threads parsed the file.
+ */
+struct ARFFCategoricalValue
+{
+  size_t point;
+  size_t dimension;
+  std::string value;
+};
+
+/**
+ * Stores the values of the points into a dense matrix.  All the chunks write
+ * into the same matrix, but each point is in only one chunk.
+ */
+template<typename eT>
+struct DenseARFFSink
+{
+  DenseARFFSink(arma::Mat<eT>& matrix) : matrix(&matrix) { }
+
+  void operator()(const size_t dimension, const size_t point, const eT value)
+  {
+    (*matrix)(dimension, point) = value;
+  }
+
+  arma::Mat<eT>* matrix;
+};
+
+/**
+ * Collects the nonzero values of the points of one chunk, to build a sparse
+ * matrix from once all the chunks are parsed.
+ */
+template<typename eT>
+struct SparseARFFSink
+{
+  void operator()(const size_t dimension, const size_t point, const eT value)
+  {
+    if (value == eT(0))
+      return;
+
+    locations.push_back(dimension);
+    locations.push_back(point);
+    values.push_back(value);
+  }
+
+  //! Pairs of (row, column) locations, one after the other.
+  std::vector<arma::uword> locations;
+  //! The value at each location.
+  std::vector<eT> values;
+};
+
+/**
+ * Open the given ARFF file, read its header into info (which is reset if it is
+ * empty; otherwise its dimensionality must match the file), then read the
+ * @data section into the given buffer and split it into lines.  Empty lines
+ * and comment lines in the @data section are skipped.
+ */
+template<typename PolicyType>
+void ReadARFF(const std::string& filename,
+              DatasetMapper<PolicyType>& info,
+              std::string& buffer,
+              std::vector<ARFFLine>& lines)
 {
   // First, open the file.
   std::ifstream ifs;
-  ifs.open(filename);
+  ifs.open(filename, std::ios::in | std::ios::binary);
+  if (!ifs.is_open())
+  {
+    std::ostringstream oss;
+    oss << "Cannot open file '" << filename << "'.";
+    throw std::runtime_error(oss.str());
+  }
 
   std::string line;
   size_t dimensionality = 0;
@@ -124,106 +204,413 @@ void LoadARFF(const std::string& filename,
       info.Type(i) = Datatype::numeric;
   }
 
-  // We need to find out how many lines of data are in the file.
-  std::streampos pos = ifs.tellg();
-  size_t row = 0;
-  while (!ifs.eof())
+  // Now read the whole @data section at once.
+  const std::streampos dataBegin = ifs.tellg();
+  ifs.seekg(0, std::ios::end);
+  const std::streamoff size = ifs.tellg() - dataBegin;
+  ifs.seekg(dataBegin);
+
+  buffer.resize(size);
+  if (size > 0 && !ifs.read(&buffer[0], size))
   {
-    std::getline(ifs, line, '\n');
-    ++row;
+    std::ostringstream oss;
+    oss << "Cannot read file '" << filename << "'.";
+    throw std::runtime_error(oss.str());
   }
-  // Uncount the EOF row.
-  --row;
 
-  // Since we've hit the EOF, we have to call clear() so we can seek again.
-  ifs.clear();
-  ifs.seekg(pos);
+  // Find the lines, and strip whitespace from either side of each of them.
+  lines.clear();
+  size_t lineBegin = 0;
+  size_t number = headerLines;
+  while (lineBegin < buffer.size())
+  {
+    size_t lineEnd = buffer.find('\n', lineBegin);
+    if (lineEnd == std::string::npos)
+      lineEnd = buffer.size();
+    ++number;
 
-  // Now, set the size of the matrix.
-  matrix.set_size(dimensionality, row);
+    ARFFLine dataLine = { lineBegin, lineEnd, number };
+    while (dataLine.begin < dataLine.end &&
+        std::isspace((unsigned char) buffer[dataLine.begin]))
+      ++dataLine.begin;
+    while (dataLine.end > dataLine.begin &&
+        std::isspace((unsigned char) buffer[dataLine.end - 1]))
+      --dataLine.end;
 
-  // Now we are looking at the @data section.
-  row = 0;
-  while (!ifs.eof())
+    if (dataLine.begin < dataLine.end && buffer[dataLine.begin] != '%')
+      lines.push_back(dataLine);
+
+    lineBegin = lineEnd + 1;
+  }
+}
+
+/**
+ * Parse a numeric value of the @data section.  The '?' representing a missing
+ * value is not allowed, so if that occurs we throw an exception.
+ */
+template<typename eT>
+eT ParseARFFNumeric(const std::string& str,
+                    std::stringstream& token,
+                    const size_t lineNumber,
+                    const size_t dimension)
+{
+  token.clear();
+  token.str(str);
+
+  eT val = eT(0);
+  token >> val;
+
+  if (token.fail())
   {
-    std::getline(ifs, line, '\n');
-    boost::trim(line);
-    // Each line of the @data section must be a CSV (except sparse data, which
-    // we will handle later).  So now we can tokenize the
-    // CSV and parse it.  The '?' representing a missing value is not allowed,
-    // so if that occurs we throw an exception.  We also throw an exception if
-    // any piece of data does not match its type (categorical or numeric).
-
-    // If the first character is {, it is sparse data, and we can just say this
-    // is not handled for now...
-    if (line[0] == '{')
-      throw std::runtime_error("cannot yet parse sparse ARFF data");
-
-    // Tokenize the line.
-    typedef boost::tokenizer<boost::escaped_list_separator<char>> Tokenizer;
-    boost::escaped_list_separator<char> sep("\\", ",", "\"");
-    Tokenizer tok(line, sep);
-
-    size_t col = 0;
-    std::stringstream token;
+    // Check for NaN or inf.
+    if (!arma::diskio::convert_naninf(val, token.str()))
+    {
+      // Okay, it's not NaN or inf.  If it's '?', we issue a specific error,
+      // otherwise we issue a general error.
+      std::stringstream error;
+      std::string tokenStr = token.str();
+      boost::trim(tokenStr);
+      if (tokenStr == "?")
+        error << "Missing values ('?') not supported, ";
+      else
+        error << "Parse error ";
+      error << "at line " << lineNumber << " token " << dimension << ": \""
+          << tokenStr << "\".";
+      throw std::runtime_error(error.str());
+    }
+  }
+
+  return val;
+}
+
+/**
+ * Parse one line of the @data section.  Numeric values are passed to the sink
+ * right away; categorical values are added to the given vector, so that they
+ * can be mapped later.  The line may be a dense row (a comma-separated value
+ * for each dimension) or a sparse row ({index value, index value, ...}, where
+ * the dimensions that aren't given are zero).
+ *
+ * @param buffer Buffer holding the @data section.
+ * @param line Line to parse.
+ * @param point Index of the point on the line.
+ * @param info Types of the dimensions.
+ * @param token Stream used to parse numeric values.
+ * @param dimensions Scratch space, used to find duplicate sparse indices.
+ * @param sink Function object that stores numeric values.
+ * @param categorical Vector to add the categorical values to.
+ */
+template<typename eT, typename PolicyType, typename SinkType>
+void ParseARFFLine(const std::string& buffer,
+                   const ARFFLine& line,
+                   const size_t point,
+                   const DatasetMapper<PolicyType>& info,
+                   std::stringstream& token,
+                   std::vector<size_t>& dimensions,
+                   SinkType& sink,
+                   std::vector<ARFFCategoricalValue>& categorical)
+{
+  typedef boost::tokenizer<boost::escaped_list_separator<char>> Tokenizer;
+  boost::escaped_list_separator<char> sep("\\", ",", "\"");
+  const size_t dimensionality = info.Dimensionality();
+
+  if (buffer[line.begin] != '{')
+  {
+    // Each dense line of the @data section must be a CSV.  We throw an
+    // exception if any piece of data does not match its type (categorical or
+    // numeric), or if the line doesn't have a value for each dimension.
+    Tokenizer tok(buffer.begin() + line.begin, buffer.begin() + line.end, sep);
+
+    size_t dimension = 0;
     for (Tokenizer::iterator it = tok.begin(); it != tok.end(); ++it)
     {
       // Check that we are not too many columns in.
-      if (col >= matrix.n_rows)
+      if (dimension >= dimensionality)
       {
         std::stringstream error;
-        error << "Too many columns in line " << (headerLines + row) << ".";
+        error << "Too many columns in line " << line.number << ".";
         throw std::runtime_error(error.str());
       }
 
-      // What should this token be?
-      if (info.Type(col) == Datatype::categorical)
+      if (info.Type(dimension) == Datatype::categorical)
       {
         // Strip spaces before mapping.
-        std::string token = *it;
-        boost::trim(token);
-        // We load transposed.
-        matrix(col, row) = info.template MapString<eT>(token, col);
+        ARFFCategoricalValue value = { point, dimension, *it };
+        boost::trim(value.value);
+        categorical.push_back(std::move(value));
       }
-      else if (info.Type(col) == Datatype::numeric)
+      else
       {
-        // Attempt to read as numeric.
-        token.clear();
-        token.str(*it);
+        sink(dimension, point, ParseARFFNumeric<eT>(*it, token, line.number,
+            dimension));
+      }
 
-        eT val = eT(0);
-        token >> val;
+      ++dimension;
+    }
 
-        if (token.fail())
-        {
-          // Check for NaN or inf.
-          if (!arma::diskio::convert_naninf(val, token.str()))
-          {
-            // Okay, it's not NaN or inf.  If it's '?', we issue a specific
-            // error, otherwise we issue a general error.
-            std::stringstream error;
-            std::string tokenStr = token.str();
-            boost::trim(tokenStr);
-            if (tokenStr == "?")
-              error << "Missing values ('?') not supported, ";
-            else
-              error << "Parse error ";
-            error << "at line " << (headerLines + row) << " token " << col
-                << ": \"" << tokenStr << "\".";
-            throw std::runtime_error(error.str());
-          }
-        }
+    if (dimension < dimensionality)
+    {
+      std::stringstream error;
+      error << "Too few columns in line " << line.number << ".";
+      throw std::runtime_error(error.str());
+    }
+
+    return;
+  }
+
+  // This is a sparse line.  Everything after the closing brace must be a
+  // comment.
+  const size_t close = buffer.rfind('}', line.end - 1);
+  size_t rest = close + 1;
+  while (close != std::string::npos && rest < line.end &&
+      std::isspace((unsigned char) buffer[rest]))
+    ++rest;
+  if (close == std::string::npos || close <= line.begin ||
+      (rest < line.end && buffer[rest] != '%'))
+  {
+    std::stringstream error;
+    error << "Parse error at line " << line.number << ": sparse row is not "
+        << "closed with '}'.";
+    throw std::runtime_error(error.str());
+  }
+
+  // An empty row has no nonzero values.
+  size_t first = line.begin + 1;
+  while (first < close && std::isspace((unsigned char) buffer[first]))
+    ++first;
+  if (first == close)
+    return;
+
+  dimensions.clear();
+  Tokenizer tok(buffer.begin() + first, buffer.begin() + close, sep);
+  for (Tokenizer::iterator it = tok.begin(); it != tok.end(); ++it)
+  {
+    // Each value is given as the index of the dimension and the value,
+    // separated by whitespace.
+    std::string entry = *it;
+    boost::trim(entry);
+    const size_t split = entry.find_first_of(" \t");
 
-        // If we made it to here, we have a value.
-        matrix(col, row) = val; // We load transposed.
+    char* indexEnd = NULL;
+    const unsigned long long index = (split == std::string::npos) ? 0 :
+        std::strtoull(entry.c_str(), &indexEnd, 10);
+    if (split == std::string::npos || entry[0] == '-' ||
+        indexEnd != entry.c_str() + split)
+    {
+      std::stringstream error;
+      error << "Parse error at line " << line.number << ": \"" << entry
+          << "\" is not an index and a value.";
+      throw std::runtime_error(error.str());
+    }
+
+    if (index >= dimensionality)
+    {
+      std::stringstream error;
+      error << "Index " << index << " in line " << line.number << " is out of "
+          << "range; the data has dimensionality " << dimensionality << ".";
+      throw std::runtime_error(error.str());
+    }
+    dimensions.push_back(index);
+
+    std::string value = entry.substr(split + 1);
+    boost::trim(value);
+    if (info.Type(index) == Datatype::categorical)
+    {
+      ARFFCategoricalValue categoricalValue = { point, (size_t) index,
+          std::move(value) };
+      categorical.push_back(std::move(categoricalValue));
+    }
+    else
+    {
+      sink(index, point, ParseARFFNumeric<eT>(value, token, line.number,
+          index));
+    }
+  }
+
+  // Each dimension may only be given once.
+  std::sort(dimensions.begin(), dimensions.end());
+  std::vector<size_t>::const_iterator duplicate = std::adjacent_find(
+      dimensions.begin(), dimensions.end());
+  if (duplicate != dimensions.end())
+  {
+    std::stringstream error;
+    error << "Index " << *duplicate << " is given more than once in line "
+        << line.number << ".";
+    throw std::runtime_error(error.str());
+  }
+}
+
+/**
+ * Return the number of chunks that the given number of lines of the @data
+ * section should be parsed in.
+ */
+inline size_t NumARFFChunks(const size_t numLines)
+{
+  // Use a few chunks per thread, so that the threads stay balanced when some
+  // lines are much longer than others.
+  size_t numChunks = 1;
+#ifdef HAS_OPENMP
+  numChunks = 4 * omp_get_max_threads();
+#endif
+  return std::max((size_t) 1, std::min(numChunks, numLines));
+}
+
+/**
+ * Parse all the lines of the @data section, giving all the values to the
+ * sinks: the lines are split into sinks.size() contiguous chunks, which are
+ * parsed in parallel, each with its own sink.  Then the categorical values are
+ * mapped in file order.
+ */
+template<typename eT, typename PolicyType, typename SinkType>
+void ParseARFFData(const std::string& buffer,
+                   const std::vector<ARFFLine>& lines,
+                   DatasetMapper<PolicyType>& info,
+                   std::vector<SinkType>& sinks)
+{
+  const size_t numChunks = sinks.size();
+  std::vector<std::vector<ARFFCategoricalValue>> categorical(numChunks);
+  std::vector<std::exception_ptr> errors(numChunks);
+
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t c = 0; c < (omp_size_t) numChunks; ++c)
+  {
+    const size_t begin = (lines.size() * (size_t) c) / numChunks;
+    const size_t end = (lines.size() * (size_t) (c + 1)) / numChunks;
+
+    std::stringstream token;
+    std::vector<size_t> dimensions;
+    try
+    {
+      for (size_t i = begin; i < end; ++i)
+      {
+        ParseARFFLine<eT>(buffer, lines[i], i, info, token, dimensions,
+            sinks[c], categorical[c]);
       }
+    }
+    catch (...)
+    {
+      errors[c] = std::current_exception();
+    }
+  }
+
+  // Report the error that comes first in the file, just as if the file had
+  // been parsed by one thread.
+  for (size_t c = 0; c < numChunks; ++c)
+    if (errors[c])
+      std::rethrow_exception(errors[c]);
+
+  // DatasetMapper isn't thread-safe, so the mappings are made here.
+  for (size_t c = 0; c < numChunks; ++c)
+  {
+    for (size_t i = 0; i < categorical[c].size(); ++i)
+    {
+      const ARFFCategoricalValue& value = categorical[c][i];
+      sinks[c](value.dimension, value.point,
+          info.template MapString<eT>(value.value, value.dimension));
+    }
 
-      ++col;
+    std::vector<ARFFCategoricalValue>().swap(categorical[c]);
+  }
+}
+
+/**
+ * Throw an exception if any dimension of the given DatasetInfo is not numeric.
+ */
+inline void CheckARFFNumeric(const DatasetInfo& info)
+{
+  for (size_t i = 0; i < info.Dimensionality(); ++i)
+  {
+    if (info.Type(i) != Datatype::numeric)
+    {
+      std::ostringstream oss;
+      oss << "data::LoadARFF(): dimension " << i << " is not numeric; pass a "
+          << "DatasetInfo to load categorical features.";
+      throw std::runtime_error(oss.str());
     }
-    ++row;
   }
 }
 
+} // namespace details
+
+template<typename eT>
+void LoadARFF(const std::string& filename, arma::Mat<eT>& matrix)
+{
+  DatasetInfo info;
+  LoadARFF(filename, matrix, info);
+  details::CheckARFFNumeric(info);
+}
+
+template<typename eT, typename PolicyType>
+void LoadARFF(const std::string& filename,
+              arma::Mat<eT>& matrix,
+              DatasetMapper<PolicyType>& info)
+{
+  std::string buffer;
+  std::vector<details::ARFFLine> lines;
+  details::ReadARFF(filename, info, buffer, lines);
+
+  // Sparse rows only set their nonzero values.  We load transposed.
+  matrix.zeros(info.Dimensionality(), lines.size());
+
+  std::vector<details::DenseARFFSink<eT>> sinks(
+      details::NumARFFChunks(lines.size()),
+      details::DenseARFFSink<eT>(matrix));
+  details::ParseARFFData<eT>(buffer, lines, info, sinks);
+}
+
+template<typename eT>
+void LoadARFF(const std::string& filename, arma::SpMat<eT>& matrix)
+{
+  DatasetInfo info;
+  LoadARFF(filename, matrix, info);
+  details::CheckARFFNumeric(info);
+}
+
+template<typename eT, typename PolicyType>
+void LoadARFF(const std::string& filename,
+              arma::SpMat<eT>& matrix,
+              DatasetMapper<PolicyType>& info)
+{
+  std::string buffer;
+  std::vector<details::ARFFLine> lines;
+  details::ReadARFF(filename, info, buffer, lines);
+
+  std::vector<details::SparseARFFSink<eT>> sinks(
+      details::NumARFFChunks(lines.size()));
+  details::ParseARFFData<eT>(buffer, lines, info, sinks);
+
+  // The buffer isn't needed anymore, so free it before the matrix is built.
+  std::string().swap(buffer);
+
+  size_t nonzeros = 0;
+  for (size_t c = 0; c < sinks.size(); ++c)
+    nonzeros += sinks[c].values.size();
+
+  if (nonzeros == 0)
+  {
+    matrix.zeros(info.Dimensionality(), lines.size());
+    return;
+  }
+
+  // Build the matrix with one batch insertion.  We load transposed.
+  arma::umat locations(2, nonzeros);
+  arma::Col<eT> values(nonzeros);
+  size_t offset = 0;
+  for (size_t c = 0; c < sinks.size(); ++c)
+  {
+    std::copy(sinks[c].locations.begin(), sinks[c].locations.end(),
+        locations.memptr() + 2 * offset);
+    std::copy(sinks[c].values.begin(), sinks[c].values.end(),
+        values.memptr() + offset);
+    offset += sinks[c].values.size();
+
+    std::vector<arma::uword>().swap(sinks[c].locations);
+    std::vector<eT>().swap(sinks[c].values);
+  }
+
+  matrix = arma::SpMat<eT>(locations, values, info.Dimensionality(),
+      lines.size(), true, false);
+}
+
 } // namespace data
 } // namespace mlpack
 
@@ -1,7 +1,5 @@
 #include "load_csv.hpp"
 
-using namespace boost::spirit;
-
 namespace mlpack {
 namespace data {
 
@@ -13,49 +11,146 @@ LoadCSV::LoadCSV(const std::string& file) :
   // Attempt to open stream.
   CheckOpen();
 
-  // Set rules.
-  if (extension == "csv" || extension == "txt")
-  {
-    // Match all characters that are not ',', '\r', or '\n'.
-    stringRule = qi::raw[*~qi::char_(" ,\r\n")];
-  }
+  // Set the delimiter.  CSVs use a single comma, possibly with whitespace on
+  // either side; text files use any number of spaces; TSVs use a single tab,
+  // possibly with whitespace on either side.
+  if (extension == "csv")
+    delimiter = ',';
+  else if (extension == "txt")
+    delimiter = ' ';
   else
+    delimiter = '\t';
+
+  ReadFile();
+}
+
+void LoadCSV::CheckOpen()
+{
+  if (!inFile.is_open())
   {
-    // Match all characters that are not '\t', '\r', or '\n'.
-    stringRule = qi::raw[*~qi::char_(" \t\r\n")];
+    std::ostringstream oss;
+    oss << "Cannot open file '" << filename << "'. " << std::endl;
+    throw std::runtime_error(oss.str());
   }
 
-  if (extension == "csv")
+  inFile.unsetf(std::ios::skipws);
+}
+
+void LoadCSV::ReadFile()
+{
+  inFile.seekg(0, std::ios::end);
+  const std::streamoff size = inFile.tellg();
+  inFile.seekg(0, std::ios::beg);
+
+  buffer.resize(size);
+  if (size > 0 && !inFile.read(&buffer[0], size))
   {
-    // Extract a single comma as the delimiter, catching whitespace on either
-    // side.
-    delimiterRule = qi::raw[(*qi::char_(" ") >> qi::char_(",") >>
-        *qi::char_(" "))];
+    std::ostringstream oss;
+    oss << "Cannot read file '" << filename << "'. " << std::endl;
+    throw std::runtime_error(oss.str());
   }
-  else if (extension == "txt")
+
+  // Find the newlines in one chunk of the buffer per thread.  The chunks don't
+  // need to start on a newline boundary: the beginning of a line is just the
+  // character after a newline.
+  size_t numChunks = 1;
+#ifdef HAS_OPENMP
+  numChunks = omp_get_max_threads();
+#endif
+  std::vector<std::vector<size_t>> chunkLines(numChunks);
+
+  #pragma omp parallel for
+  for (omp_size_t c = 0; c < (omp_size_t) numChunks; ++c)
   {
-    // This one is a little more difficult, we need to catch any number of
-    // spaces more than one.
-    delimiterRule = qi::raw[+qi::char_(" ")];
+    const size_t begin = (buffer.size() * (size_t) c) / numChunks;
+    const size_t end = (buffer.size() * (size_t) (c + 1)) / numChunks;
+    for (size_t i = begin; i < end; ++i)
+    {
+      // A newline at the very end of the file doesn't start a new line (like
+      // std::getline()).
+      if (buffer[i] == '\n' && i + 1 < buffer.size())
+        chunkLines[c].push_back(i + 1);
+    }
   }
-  else // TSV.
+
+  lineBegins.clear();
+  if (!buffer.empty())
+    lineBegins.push_back(0);
+  for (size_t c = 0; c < numChunks; ++c)
   {
-    // Catch a tab character, possibly with whitespace on either side.
-    delimiterRule = qi::raw[(*qi::char_(" ") >> qi::char_("\t") >>
-        *qi::char_(" "))];
+    lineBegins.insert(lineBegins.end(), chunkLines[c].begin(),
+        chunkLines[c].end());
   }
+  lineBegins.push_back(buffer.size());
 }
 
-void LoadCSV::CheckOpen()
+size_t LoadCSV::TokenizeLine(const size_t line,
+                             size_t* fields,
+                             const size_t maxFields) const
 {
-  if (!inFile.is_open())
+  // Remove whitespace from either side (this also removes the newline).
+  size_t begin = lineBegins[line];
+  size_t end = lineBegins[line + 1];
+  while (begin < end && std::isspace((unsigned char) buffer[begin]))
+    ++begin;
+  while (end > begin && std::isspace((unsigned char) buffer[end - 1]))
+    --end;
+
+  // Fields can't contain spaces, newlines, or the separator.  (For text files,
+  // a comma also ends a field.)
+  const char separator = (delimiter == '\t') ? '\t' : ',';
+  auto isFieldChar = [separator](const char c)
   {
-    std::ostringstream oss;
-    oss << "Cannot open file '" << filename << "'. " << std::endl;
-    throw std::runtime_error(oss.str());
+    return (c != ' ' && c != '\r' && c != '\n' && c != separator);
+  };
+
+  size_t numFields = 0;
+  size_t pos = begin;
+  while (true)
+  {
+    // Extract the field, and trim any other whitespace from it.
+    size_t fieldEnd = pos;
+    while (fieldEnd < end && isFieldChar(buffer[fieldEnd]))
+      ++fieldEnd;
+
+    if (numFields < maxFields)
+    {
+      size_t fieldBegin = pos;
+      size_t trimmedEnd = fieldEnd;
+      while (fieldBegin < trimmedEnd &&
+             std::isspace((unsigned char) buffer[fieldBegin]))
+        ++fieldBegin;
+      while (trimmedEnd > fieldBegin &&
+             std::isspace((unsigned char) buffer[trimmedEnd - 1]))
+        --trimmedEnd;
+
+      fields[2 * numFields] = fieldBegin;
+      fields[2 * numFields + 1] = trimmedEnd;
+    }
+    ++numFields;
+
+    // Now extract the delimiter; if there isn't one, the line is done.
+    pos = fieldEnd;
+    if (delimiter == ' ')
+    {
+      if (pos == end || buffer[pos] != ' ')
+        break;
+      while (pos < end && buffer[pos] == ' ')
+        ++pos;
+    }
+    else
+    {
+      while (pos < end && buffer[pos] == ' ')
+        ++pos;
+      if (pos == end || buffer[pos] != delimiter)
+        break;
+      ++pos;
+      while (pos < end && buffer[pos] == ' ')
+        ++pos;
+    }
   }
 
-  inFile.unsetf(std::ios::skipws);
+  return numFields;
 }
 
 } // namespace data
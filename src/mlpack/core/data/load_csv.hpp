@@ -12,12 +12,10 @@
 #ifndef MLPACK_CORE_DATA_LOAD_CSV_HPP
 #define MLPACK_CORE_DATA_LOAD_CSV_HPP
 
-#include <boost/spirit/include/qi.hpp>
-#include <boost/algorithm/string/trim.hpp>
-
 #include <mlpack/core.hpp>
 #include <mlpack/core/util/log.hpp>
 
+#include <exception>
 #include <set>
 #include <string>
 
@@ -29,16 +27,25 @@ namespace mlpack {
 namespace data {
 
 /**
- *Load the csv file.This class use boost::spirit
- *to implement the parser, please refer to following link
- *http://theboostcpplibraries.com/boost.spirit for quick review.
+ * Load the csv file.  The whole file is read into memory once, and then the
+ * lines are tokenized and mapped in parallel (if OpenMP is available).  The
+ * file is split on newline boundaries, and each line is tokenized in place, so
+ * no string is allocated for each field.
+ *
+ * Mapping with the DatasetMapper is split by dimension: every dimension is
+ * handled by a single thread (with its own copy of the DatasetMapper), which
+ * sees the values of that dimension in file order.  The copies are merged at
+ * the end.  So the mappings are the same as if the file was read serially, no
+ * matter how many threads are used.  This requires that the MapPolicy only
+ * changes the information about the dimension it is called with, which is
+ * true for IncrementPolicy and MissingPolicy.
  */
 class LoadCSV
 {
  public:
   /**
-   * Construct the LoadCSV object on the given file.  This will construct the
-   * rules necessary for loading and attempt to open the file.
+   * Construct the LoadCSV object on the given file.  This will attempt to open
+   * the file and read it into memory.
    */
   LoadCSV(const std::string& file);
 
@@ -56,8 +63,6 @@ class LoadCSV
             DatasetMapper<PolicyType> &infoSet,
             const bool transpose = true)
   {
-    CheckOpen();
-
     if (transpose)
       TransposeParse(inout, infoSet);
     else
@@ -68,7 +73,9 @@ class LoadCSV
    * Peek at the file to determine the number of rows and columns in the matrix,
    * assuming a non-transposed matrix.  This will also take a first pass over
    * the data for DatasetMapper, if MapPolicy::NeedsFirstPass is true.  The info
-   * object will be re-initialized with the correct dimensionality.
+   * object will be re-initialized with the correct dimensionality.  If a first
+   * pass is taken and a line has the wrong number of columns,
+   * std::runtime_error is thrown.
    *
    * @param rows Variable to be filled with the number of rows.
    * @param cols Variable to be filled with the number of columns.
@@ -77,71 +84,25 @@ class LoadCSV
   template<typename T, typename MapPolicy>
   void GetMatrixSize(size_t& rows, size_t& cols, DatasetMapper<MapPolicy>& info)
   {
-    using namespace boost::spirit;
-
-    // Take a pass through the file.  If the DatasetMapper policy requires it,
-    // we will pass everything string through MapString().  This might be useful
-    // if, e.g., the MapPolicy needs to find which dimensions are numeric or
-    // categorical.
-
-    // Reset to the start of the file.
-    inFile.clear();
-    inFile.seekg(0, std::ios::beg);
-    rows = 0;
-    cols = 0;
-
-    // First, count the number of rows in the file (this is the dimensionality).
-    std::string line;
-    while (std::getline(inFile, line))
-    {
-      ++rows;
-    }
+    // Each line is a dimension.
+    rows = NumLines();
+    cols = (rows == 0) ? 0 : TokenizeLine(0, NULL, 0);
     info = DatasetMapper<MapPolicy>(rows);
 
-    // Now, jump back to the beginning of the file.
-    inFile.clear();
-    inFile.seekg(0, std::ios::beg);
-    rows = 0;
-
-    while (std::getline(inFile, line))
-    {
-      ++rows;
-      // Remove whitespace from either side.
-      boost::trim(line);
-
-      if (rows == 1)
-      {
-        // Extract the number of columns.
-        auto findColSize = [&cols](iter_type) { ++cols; };
-        qi::parse(line.begin(), line.end(),
-            stringRule[findColSize] % delimiterRule);
-      }
-
-      // I guess this is technically a second pass, but that's ok... still the
-      // same idea...
-      if (MapPolicy::NeedsFirstPass)
-      {
-        // In this case we must pass everything we parse to the MapPolicy.
-        auto firstPassMap = [&](const iter_type& iter)
-        {
-          std::string str(iter.begin(), iter.end());
-          boost::trim(str);
-
-          info.template MapFirstPass<T>(std::move(str), rows - 1);
-        };
-
-        // Now parse the line.
-        qi::parse(line.begin(), line.end(),
-            stringRule[firstPassMap] % delimiterRule);
-      }
-    }
+    // If the DatasetMapper policy requires it, we will pass every string
+    // through MapFirstPass().  This might be useful if, e.g., the MapPolicy
+    // needs to find which dimensions are numeric or categorical.
+    if (MapPolicy::NeedsFirstPass)
+      ParseLines<T>(NULL, info, false, cols, true);
   }
 
   /**
    * Peek at the file to determine the number of rows and columns in the matrix,
    * assuming a transposed matrix.  This will also take a first pass over the
    * data for DatasetMapper, if MapPolicy::NeedsFirstPass is true.  The info
-   * object will be re-initialized with the correct dimensionality.
+   * object will be re-initialized with the correct dimensionality.  If a first
+   * pass is taken and a line has the wrong number of dimensions,
+   * std::runtime_error is thrown.
    *
    * @param rows Variable to be filled with the number of rows.
    * @param cols Variable to be filled with the number of columns.
@@ -152,67 +113,52 @@ class LoadCSV
                               size_t& cols,
                               DatasetMapper<MapPolicy>& info)
   {
-    using namespace boost::spirit;
-
-    // Take a pass through the file.  If the DatasetMapper policy requires it,
-    // we will pass everything string through MapString().  This might be useful
-    // if, e.g., the MapPolicy needs to find which dimensions are numeric or
-    // categorical.
-
-    // Reset to the start of the file.
-    inFile.clear();
-    inFile.seekg(0, std::ios::beg);
+    // Each line is a point.
+    cols = NumLines();
     rows = 0;
-    cols = 0;
+    if (cols == 0)
+      return;
 
-    std::string line;
-    while (std::getline(inFile, line))
-    {
-      ++cols;
-      // Remove whitespace from either side.
-      boost::trim(line);
-
-      if (cols == 1)
-      {
-        // Extract the number of dimensions.
-        auto findRowSize = [&rows](iter_type) { ++rows; };
-        qi::parse(line.begin(), line.end(),
-            stringRule[findRowSize] % delimiterRule);
-
-        // Now that we know the dimensionality, initialize the DatasetMapper.
-        info = DatasetMapper<MapPolicy>(rows);
-      }
-
-      // If we need to do a first pass for the DatasetMapper, do it.
-      if (MapPolicy::NeedsFirstPass)
-      {
-        size_t dim = 0;
-
-        // In this case we must pass everything we parse to the MapPolicy.
-        auto firstPassMap = [&](const iter_type& iter)
-        {
-          std::string str(iter.begin(), iter.end());
-          boost::trim(str);
-
-          info.template MapFirstPass<T>(std::move(str), dim++);
-        };
+    // Now that we know the dimensionality, initialize the DatasetMapper.
+    rows = TokenizeLine(0, NULL, 0);
+    info = DatasetMapper<MapPolicy>(rows);
 
-        // Now parse the line.
-        qi::parse(line.begin(), line.end(),
-            stringRule[firstPassMap] % delimiterRule);
-      }
-    }
+    // If we need to do a first pass for the DatasetMapper, do it.
+    if (MapPolicy::NeedsFirstPass)
+      ParseLines<T>(NULL, info, true, rows, true);
   }
 
  private:
-  using iter_type = boost::iterator_range<std::string::iterator>;
-
   /**
    * Check whether or not the file has successfully opened; throw an exception
    * if not.
    */
   void CheckOpen();
 
+  /**
+   * Read the whole file into the buffer, and find the beginning of each line.
+   */
+  void ReadFile();
+
+  //! Get the number of lines in the file.
+  size_t NumLines() const { return lineBegins.size() - 1; }
+
+  /**
+   * Split the given line into fields, and store the first maxFields of them
+   * (as pairs of beginning and end positions in the buffer, with whitespace
+   * trimmed) in the given array, which must have space for 2 * maxFields
+   * elements.  The total number of fields on the line is returned.  This
+   * never allocates memory, so it is safe to call from many threads.
+   *
+   * @param line Index of the line to tokenize.
+   * @param fields Array to store the positions of the fields in (may be NULL
+   *     if maxFields is 0).
+   * @param maxFields Maximum number of fields to store.
+   */
+  size_t TokenizeLine(const size_t line,
+                      size_t* fields,
+                      const size_t maxFields) const;
+
   /**
    * Parse a non-transposed matrix.
    *
@@ -223,64 +169,13 @@ class LoadCSV
   void NonTransposeParse(arma::Mat<T>& inout,
                          DatasetMapper<PolicyType>& infoSet)
   {
-    using namespace boost::spirit;
-
     // Get the size of the matrix.
     size_t rows, cols;
     GetMatrixSize<T>(rows, cols, infoSet);
 
-    // Set up output matrix.
+    // Set up output matrix, and fill it.
     inout.set_size(rows, cols);
-    size_t row = 0;
-    size_t col = 0;
-
-    // Reset file position.
-    std::string line;
-    inFile.clear();
-    inFile.seekg(0, std::ios::beg);
-
-    auto setCharClass = [&](iter_type const &iter)
-    {
-      std::string str(iter.begin(), iter.end());
-      if (str == "\t")
-      {
-        str.clear();
-      }
-      boost::trim(str);
-
-      inout(row, col++) = infoSet.template MapString<T>(std::move(str), row);
-    };
-
-    while (std::getline(inFile, line))
-    {
-      // Remove whitespace from either side.
-      boost::trim(line);
-
-      // Parse the numbers from a line (ex: 1,2,3,4); if the parser finds a
-      // number it will execute the setNum function.
-      const bool canParse = qi::parse(line.begin(), line.end(),
-          stringRule[setCharClass] % delimiterRule);
-
-      // Make sure we got the right number of rows.
-      if (col != cols)
-      {
-        std::ostringstream oss;
-        oss << "LoadCSV::NonTransposeParse(): wrong number of dimensions ("
-            << col << ") on line " << row << "; should be " << cols
-            << " dimensions.";
-        throw std::runtime_error(oss.str());
-      }
-
-      if (!canParse)
-      {
-        std::ostringstream oss;
-        oss << "LoadCSV::NonTransposeParse(): parsing error on line " << col
-            << "!";
-        throw std::runtime_error(oss.str());
-      }
-
-      ++row; col = 0;
-    }
+    ParseLines<T>(&inout, infoSet, false, cols, false);
   }
 
   /**
@@ -292,82 +187,168 @@ class LoadCSV
   template<typename T, typename PolicyType>
   void TransposeParse(arma::Mat<T>& inout, DatasetMapper<PolicyType>& infoSet)
   {
-    using namespace boost::spirit;
-
     // Get matrix size.  This also initializes infoSet correctly.
     size_t rows, cols;
     GetTransposeMatrixSize<T>(rows, cols, infoSet);
 
-    // Set the matrix size.
+    // Set the matrix size, and fill it.
     inout.set_size(rows, cols);
+    ParseLines<T>(&inout, infoSet, true, rows, false);
+  }
 
-    // Initialize auxiliary variables.
-    size_t row = 0;
-    size_t col = 0;
-    std::string line;
-    inFile.clear();
-    inFile.seekg(0, std::ios::beg);
-
-    /**
-     * This is the parse rule for strings.  When we get a string we have to pass
-     * it to the DatasetMapper.
-     */
-    auto parseString = [&](iter_type const &iter)
-    {
-      // All parsed values must be mapped.
-      std::string str(iter.begin(), iter.end());
-      boost::trim(str);
+  /**
+   * Tokenize every line of the file and pass each field to the DatasetMapper,
+   * either with MapFirstPass() (if firstPass is true) or with MapString(), in
+   * which case the result is stored in the matrix.  The lines are processed in
+   * blocks; the lines of a block are tokenized in parallel, and then each
+   * thread maps a range of dimensions.  If a line does not have
+   * fieldsPerLine fields, std::runtime_error is thrown.
+   *
+   * @param inout Matrix to store the mapped values in (ignored if firstPass is
+   *     true).
+   * @param infoSet DatasetMapper to map with, initialized with the right
+   *     dimensionality.
+   * @param transpose If true, each line is a point; otherwise each line is a
+   *     dimension.
+   * @param fieldsPerLine Number of fields each line must have.
+   * @param firstPass Whether to call MapFirstPass() instead of MapString().
+   */
+  template<typename T, typename PolicyType>
+  void ParseLines(arma::Mat<T>* inout,
+                  DatasetMapper<PolicyType>& infoSet,
+                  const bool transpose,
+                  const size_t fieldsPerLine,
+                  const bool firstPass)
+  {
+    const size_t numLines = NumLines();
+    const size_t dimensionality = infoSet.Dimensionality();
+
+    // Split the dimensions into one stripe per thread.  Each stripe gets its
+    // own copy of the DatasetMapper, so the stripes can be mapped at the same
+    // time.  The result doesn't depend on the number of stripes.
+    size_t numStripes = 1;
+#ifdef HAS_OPENMP
+    numStripes = omp_get_max_threads();
+#endif
+    numStripes = std::max((size_t) 1, std::min(numStripes, dimensionality));
+    std::vector<DatasetMapper<PolicyType>> stripeInfo(numStripes, infoSet);
 
-      inout(row, col) = infoSet.template MapString<T>(std::move(str), row);
-      ++row;
-    };
+    // Don't hold the positions of more than about a million fields at once.
+    const size_t blockLines = std::max((size_t) 1,
+        (size_t) (1 << 20) / std::max((size_t) 1, fieldsPerLine));
+    std::vector<size_t> fields;
+    std::vector<size_t> counts;
 
-    while (std::getline(inFile, line))
-    {
-      // Remove whitespace from either side.
-      boost::trim(line);
+    // Exceptions can't leave a parallel region, so they are stored here.
+    std::vector<std::exception_ptr> errors(numStripes);
 
-      // Reset the row we are looking at.  (Remember this is transposed.)
-      row = 0;
+    for (size_t blockBegin = 0; blockBegin < numLines; blockBegin += blockLines)
+    {
+      const size_t blockEnd = std::min(blockBegin + blockLines, numLines);
+      fields.resize(2 * (blockEnd - blockBegin) * fieldsPerLine);
+      counts.resize(blockEnd - blockBegin);
 
-      // Now use boost::spirit to parse the characters of the line;
-      // parseString() will be called when a token is detected.
-      const bool canParse = qi::parse(line.begin(), line.end(),
-          stringRule[parseString] % delimiterRule);
+      #pragma omp parallel for
+      for (omp_size_t i = 0; i < (omp_size_t) (blockEnd - blockBegin); ++i)
+      {
+        counts[i] = TokenizeLine(blockBegin + i,
+            fields.data() + 2 * i * fieldsPerLine, fieldsPerLine);
+      }
 
-      // Make sure we got the right number of rows.
-      if (row != rows)
+      // Make sure every line has the right number of fields.
+      for (size_t i = 0; i < counts.size(); ++i)
       {
+        if (counts[i] == fieldsPerLine)
+          continue;
+
         std::ostringstream oss;
-        oss << "LoadCSV::TransposeParse(): wrong number of dimensions (" << row
-            << ") on line " << col << "; should be " << rows << " dimensions.";
+        if (transpose)
+        {
+          oss << "LoadCSV::TransposeParse(): wrong number of dimensions ("
+              << counts[i] << ") on line " << blockBegin + i << "; should be "
+              << fieldsPerLine << " dimensions.";
+        }
+        else
+        {
+          oss << "LoadCSV::NonTransposeParse(): wrong number of dimensions ("
+              << counts[i] << ") on line " << blockBegin + i << "; should be "
+              << fieldsPerLine << " dimensions.";
+        }
         throw std::runtime_error(oss.str());
       }
 
-      if (!canParse)
+      #pragma omp parallel for schedule(static, 1)
+      for (omp_size_t s = 0; s < (omp_size_t) numStripes; ++s)
       {
-        std::ostringstream oss;
-        oss << "LoadCSV::TransposeParse(): parsing error on line " << col
-            << "!";
-        throw std::runtime_error(oss.str());
+        DatasetMapper<PolicyType>& info = stripeInfo[s];
+        const size_t dimBegin = (dimensionality * (size_t) s) / numStripes;
+        const size_t dimEnd = (dimensionality * (size_t) (s + 1)) / numStripes;
+
+        // The token is reused, so its memory is only allocated a few times.
+        std::string token;
+        auto mapField = [&](const size_t line, const size_t field,
+                            const size_t dim)
+        {
+          const size_t* f = fields.data() +
+              2 * ((line - blockBegin) * fieldsPerLine + field);
+          token.assign(buffer, f[0], f[1] - f[0]);
+
+          if (firstPass)
+            info.template MapFirstPass<T>(token, dim);
+          else if (transpose)
+            (*inout)(dim, line) = info.template MapString<T>(token, dim);
+          else
+            (*inout)(dim, field) = info.template MapString<T>(token, dim);
+        };
+
+        try
+        {
+          if (transpose)
+          {
+            for (size_t line = blockBegin; line < blockEnd; ++line)
+              for (size_t dim = dimBegin; dim < dimEnd; ++dim)
+                mapField(line, dim, dim);
+          }
+          else
+          {
+            const size_t lineBegin = std::max(blockBegin, dimBegin);
+            const size_t lineEnd = std::min(blockEnd, dimEnd);
+            for (size_t line = lineBegin; line < lineEnd; ++line)
+              for (size_t field = 0; field < fieldsPerLine; ++field)
+                mapField(line, field, line);
+          }
+        }
+        catch (...)
+        {
+          errors[s] = std::current_exception();
+        }
       }
 
-      // Increment the column index.
-      ++col;
+      for (size_t s = 0; s < numStripes; ++s)
+        if (errors[s])
+          std::rethrow_exception(errors[s]);
     }
-  }
 
-  //! Spirit rule for parsing.
-  boost::spirit::qi::rule<std::string::iterator, iter_type()> stringRule;
-  //! Spirit rule for delimiters (i.e. ',' for CSVs).
-  boost::spirit::qi::rule<std::string::iterator, iter_type()> delimiterRule;
+    // Collect the results of each stripe.
+    for (size_t s = 0; s < numStripes; ++s)
+    {
+      infoSet.MergeDimensions(stripeInfo[s], (dimensionality * s) / numStripes,
+          (dimensionality * (s + 1)) / numStripes);
+    }
+  }
 
+  //! Character that separates fields (',', ' ', or '\t').
+  char delimiter;
   //! Extension (type) of file.
   std::string extension;
   //! Name of file.
   std::string filename;
   //! Opened stream for reading.
   std::ifstream inFile;
+  //! Contents of the file.
+  std::string buffer;
+  //! Position of the first character of each line, followed by the file size.
+  std::vector<size_t> lineBegins;
 };
 
 } // namespace data
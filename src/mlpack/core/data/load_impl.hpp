@@ -27,6 +27,7 @@
 #include <boost/algorithm/string.hpp>
 
 #include "load_arff.hpp"
+#include "load_libsvm.hpp"
 
 namespace mlpack {
 namespace data {
@@ -0,0 +1,71 @@
+/**
+ * @file load_libsvm.hpp
+ *
+ * Load a dataset in the libsvm (or svmlight) sparse format.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_LOAD_LIBSVM_HPP
+#define MLPACK_CORE_DATA_LOAD_LIBSVM_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace data {
+
+/**
+ * Load a dataset in the libsvm format (which is also used by svmlight) into a
+ * sparse matrix and a vector of labels.  Each line of the file holds one point:
+ *
+ * @code
+ * <label> <index>:<value> <index>:<value> ... # optional comment
+ * @endcode
+ *
+ * The indices start at 1 and must be increasing on each line; the dimensions
+ * that aren't given are zero.  svmlight's "qid:<n>" tokens are ignored, as are
+ * empty lines and lines that only hold a comment.  As usual for mlpack, each
+ * point is a column of the loaded matrix.  Multi-label files (with labels like
+ * "1,3") are not supported.
+ *
+ * The file is read at once, and its lines are parsed in parallel when OpenMP
+ * is available.  The lines are parsed twice: once to count the nonzero values
+ * of each point, and once to write them straight into the CSC storage of the
+ * matrix, so no other copy of the data is ever held in memory.
+ *
+ * If the file can't be read or is malformed, or a label can't be represented
+ * by LabelType (for instance, a label of -1 with arma::Row<size_t>), a
+ * std::runtime_error is thrown.
+ *
+ * @code
+ * arma::sp_mat dataset;
+ * arma::Row<double> labels;
+ * data::LoadLibSVM("train.svm", dataset, labels);
+ * // Use the same dimensionality for the test set.
+ * arma::sp_mat testDataset;
+ * arma::Row<double> testLabels;
+ * data::LoadLibSVM("test.svm", testDataset, testLabels, dataset.n_rows);
+ * @endcode
+ *
+ * @param filename Name of the file to load.
+ * @param matrix Sparse matrix to load the points into.
+ * @param labels Row vector to load the labels into.
+ * @param dimensionality Number of dimensions of the loaded matrix.  If 0, the
+ *     largest index in the file is used; otherwise, larger indices are an
+ *     error.
+ */
+template<typename eT, typename LabelType>
+void LoadLibSVM(const std::string& filename,
+                arma::SpMat<eT>& matrix,
+                arma::Row<LabelType>& labels,
+                const size_t dimensionality = 0);
+
+} // namespace data
+} // namespace mlpack
+
+// Include implementation.
+#include "load_libsvm_impl.hpp"
+
+#endif
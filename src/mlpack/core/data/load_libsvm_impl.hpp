@@ -0,0 +1,342 @@
+/**
+ * @file load_libsvm_impl.hpp
+ *
+ * Implementation of LoadLibSVM().
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_LOAD_LIBSVM_IMPL_HPP
+#define MLPACK_CORE_DATA_LOAD_LIBSVM_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "load_libsvm.hpp"
+
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <limits>
+
+namespace mlpack {
+namespace data {
+namespace details {
+
+//! The range of a line of a libsvm file in the buffer.
+typedef std::pair<size_t, size_t> LibSVMLine;
+
+/**
+ * Throw a std::runtime_error for an error on the given line.  The line number
+ * is only found here, so that the lines don't have to be counted otherwise.
+ */
+[[noreturn]] inline void LibSVMError(const std::string& buffer,
+                                     const LibSVMLine& line,
+                                     const std::string& message)
+{
+  const size_t number = std::count(buffer.begin(),
+      buffer.begin() + line.first, '\n') + 1;
+
+  std::ostringstream oss;
+  oss << "Parse error at line " << number << ": " << message << ".";
+  throw std::runtime_error(oss.str());
+}
+
+/**
+ * Read the given file into the buffer, and find the lines that hold points
+ * (that is, the lines that aren't empty or comments).  Whitespace is stripped
+ * from either side of each line.
+ */
+inline void ReadLibSVM(const std::string& filename,
+                       std::string& buffer,
+                       std::vector<LibSVMLine>& lines)
+{
+  std::ifstream stream(filename, std::ios::in | std::ios::binary);
+  if (!stream.is_open())
+  {
+    std::ostringstream oss;
+    oss << "Cannot open file '" << filename << "'.";
+    throw std::runtime_error(oss.str());
+  }
+
+  stream.seekg(0, std::ios::end);
+  const std::streamoff size = stream.tellg();
+  stream.seekg(0, std::ios::beg);
+
+  buffer.resize(size);
+  if (size > 0 && !stream.read(&buffer[0], size))
+  {
+    std::ostringstream oss;
+    oss << "Cannot read file '" << filename << "'.";
+    throw std::runtime_error(oss.str());
+  }
+
+  // Find the lines in one chunk of the buffer per thread; each chunk finds the
+  // lines that begin inside of it.
+  size_t numChunks = 1;
+#ifdef HAS_OPENMP
+  numChunks = omp_get_max_threads();
+#endif
+  std::vector<std::vector<LibSVMLine>> chunkLines(numChunks);
+
+  #pragma omp parallel for
+  for (omp_size_t c = 0; c < (omp_size_t) numChunks; ++c)
+  {
+    const size_t begin = (buffer.size() * (size_t) c) / numChunks;
+    const size_t end = (buffer.size() * (size_t) (c + 1)) / numChunks;
+
+    // A line begins at the start of the buffer, or right after a newline.
+    size_t lineBegin = begin;
+    if (lineBegin > 0)
+    {
+      lineBegin = buffer.find('\n', lineBegin - 1);
+      lineBegin = (lineBegin == std::string::npos) ? end : lineBegin + 1;
+    }
+
+    while (lineBegin < end)
+    {
+      size_t lineEnd = buffer.find('\n', lineBegin);
+      if (lineEnd == std::string::npos)
+        lineEnd = buffer.size();
+
+      LibSVMLine line(lineBegin, lineEnd);
+      while (line.first < line.second &&
+          std::isspace((unsigned char) buffer[line.first]))
+        ++line.first;
+      while (line.second > line.first &&
+          std::isspace((unsigned char) buffer[line.second - 1]))
+        --line.second;
+
+      if (line.first < line.second && buffer[line.first] != '#')
+        chunkLines[c].push_back(line);
+
+      lineBegin = lineEnd + 1;
+    }
+  }
+
+  lines.clear();
+  for (size_t c = 0; c < numChunks; ++c)
+    lines.insert(lines.end(), chunkLines[c].begin(), chunkLines[c].end());
+}
+
+/**
+ * Convert a label to the given type, throwing an exception if it can't be
+ * represented.
+ */
+template<typename LabelType>
+LabelType ConvertLibSVMLabel(const double label,
+                             const std::string& buffer,
+                             const LibSVMLine& line)
+{
+  if (std::is_integral<LabelType>::value && (std::floor(label) != label ||
+      label < (double) std::numeric_limits<LabelType>::min() ||
+      label > (double) std::numeric_limits<LabelType>::max()))
+  {
+    std::ostringstream oss;
+    oss << "label " << label << " can't be represented by the label type";
+    LibSVMError(buffer, line, oss.str());
+  }
+
+  return (LabelType) label;
+}
+
+/**
+ * Parse one line of a libsvm file.  The label is given to label(), then each
+ * value is given to entry(index, value) in increasing order of index (which
+ * starts at 0 here).  Errors cause a std::runtime_error to be thrown.
+ */
+template<typename LabelFunction, typename EntryFunction>
+void ParseLibSVMLine(const std::string& buffer,
+                     const LibSVMLine& line,
+                     LabelFunction label,
+                     EntryFunction entry)
+{
+  // The buffer is followed by a terminating null character, and each line is
+  // followed by whitespace or the end of the buffer, so strtod() and strtoull()
+  // never read past the end of the line.  But they skip leading whitespace,
+  // so they must not be called on whitespace.
+  const char* pos = buffer.c_str() + line.first;
+  const char* end = buffer.c_str() + line.second;
+  auto isSeparator = [end](const char* p)
+  {
+    return (p == end || *p == ' ' || *p == '\t' || *p == '#');
+  };
+
+  char* next;
+  const double labelValue = std::strtod(pos, &next);
+  if (next == pos || !isSeparator(next))
+  {
+    if (next != pos && *next == ',')
+      LibSVMError(buffer, line, "multi-label files are not supported");
+    LibSVMError(buffer, line, "invalid label");
+  }
+  label(labelValue);
+  pos = next;
+
+  unsigned long long lastIndex = 0;
+  while (true)
+  {
+    while (pos < end && (*pos == ' ' || *pos == '\t'))
+      ++pos;
+    if (pos == end || *pos == '#')
+      break;
+
+    // svmlight query ids are ignored.
+    if (end - pos >= 4 && std::strncmp(pos, "qid:", 4) == 0)
+    {
+      while (!isSeparator(pos))
+        ++pos;
+      continue;
+    }
+
+    if (*pos < '0' || *pos > '9')
+      LibSVMError(buffer, line, "expected <index>:<value>");
+    const unsigned long long index = std::strtoull(pos, &next, 10);
+    if (next == end || *next != ':')
+      LibSVMError(buffer, line, "expected <index>:<value>");
+    if (index <= lastIndex)
+    {
+      LibSVMError(buffer, line, "indices must start at 1 and be in increasing "
+          "order");
+    }
+
+    pos = next + 1;
+    if (pos == end || std::isspace((unsigned char) *pos))
+      LibSVMError(buffer, line, "missing value");
+    const double value = std::strtod(pos, &next);
+    if (next == pos || !isSeparator(next))
+      LibSVMError(buffer, line, "invalid value");
+
+    entry((size_t) index - 1, value);
+    lastIndex = index;
+    pos = next;
+  }
+}
+
+} // namespace details
+
+template<typename eT, typename LabelType>
+void LoadLibSVM(const std::string& filename,
+                arma::SpMat<eT>& matrix,
+                arma::Row<LabelType>& labels,
+                const size_t dimensionality)
+{
+  std::string buffer;
+  std::vector<details::LibSVMLine> lines;
+  details::ReadLibSVM(filename, buffer, lines);
+
+  const size_t numPoints = lines.size();
+  labels.set_size(numPoints);
+
+  // Use a few chunks of lines per thread, so that the threads stay balanced
+  // when some lines are much longer than others.
+  size_t numChunks = 1;
+#ifdef HAS_OPENMP
+  numChunks = 4 * omp_get_max_threads();
+#endif
+  numChunks = std::max((size_t) 1, std::min(numChunks, numPoints));
+
+  // The first pass parses the labels and counts the nonzero values of each
+  // point.  Values that are zero in eT are not stored.
+  std::vector<arma::uword> colPtrs(numPoints + 1, 0);
+  std::vector<size_t> maxIndices(numChunks, 0);
+  std::vector<std::exception_ptr> errors(numChunks);
+
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t c = 0; c < (omp_size_t) numChunks; ++c)
+  {
+    const size_t begin = (numPoints * (size_t) c) / numChunks;
+    const size_t end = (numPoints * (size_t) (c + 1)) / numChunks;
+
+    size_t maxIndex = 0;
+    try
+    {
+      for (size_t i = begin; i < end; ++i)
+      {
+        arma::uword count = 0;
+        details::ParseLibSVMLine(buffer, lines[i],
+            [&](const double label)
+            {
+              labels[i] = details::ConvertLibSVMLabel<LabelType>(label,
+                  buffer, lines[i]);
+            },
+            [&](const size_t index, const double value)
+            {
+              if (eT(value) != eT(0))
+                ++count;
+              maxIndex = std::max(maxIndex, index + 1);
+            });
+
+        colPtrs[i + 1] = count;
+      }
+    }
+    catch (...)
+    {
+      errors[c] = std::current_exception();
+    }
+
+    maxIndices[c] = maxIndex;
+  }
+
+  // Report the error that comes first in the file.
+  for (size_t c = 0; c < numChunks; ++c)
+    if (errors[c])
+      std::rethrow_exception(errors[c]);
+
+  const size_t maxIndex = *std::max_element(maxIndices.begin(),
+      maxIndices.end());
+  if (dimensionality != 0 && maxIndex > dimensionality)
+  {
+    std::ostringstream oss;
+    oss << "data::LoadLibSVM(): index " << maxIndex << " found in '"
+        << filename << "', but the given dimensionality is " << dimensionality
+        << ".";
+    throw std::runtime_error(oss.str());
+  }
+
+  for (size_t i = 0; i < numPoints; ++i)
+    colPtrs[i + 1] += colPtrs[i];
+  const size_t nonzeros = colPtrs[numPoints];
+
+  // Allocate the CSC storage of the matrix, and fill in the column pointers.
+  matrix.zeros((dimensionality == 0) ? maxIndex : dimensionality, numPoints);
+  if (nonzeros == 0)
+    return;
+
+  matrix.mem_resize(nonzeros);
+  arma::uword* matrixColPtrs = arma::access::rwp(matrix.col_ptrs);
+  std::copy(colPtrs.begin(), colPtrs.end(), matrixColPtrs);
+  std::vector<arma::uword>().swap(colPtrs);
+
+  // The second pass writes the values of each point into its column.  The
+  // lines were all parsed once already, so no errors can happen here.
+  arma::uword* rowIndices = arma::access::rwp(matrix.row_indices);
+  eT* values = arma::access::rwp(matrix.values);
+
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t c = 0; c < (omp_size_t) numChunks; ++c)
+  {
+    const size_t begin = (numPoints * (size_t) c) / numChunks;
+    const size_t end = (numPoints * (size_t) (c + 1)) / numChunks;
+
+    for (size_t i = begin; i < end; ++i)
+    {
+      arma::uword position = matrixColPtrs[i];
+      details::ParseLibSVMLine(buffer, lines[i], [](const double) { },
+          [&](const size_t index, const double value)
+          {
+            if (eT(value) != eT(0))
+            {
+              rowIndices[position] = index;
+              values[position] = eT(value);
+              ++position;
+            }
+          });
+    }
+  }
+}
+
+} // namespace data
+} // namespace mlpack
+
+#endif
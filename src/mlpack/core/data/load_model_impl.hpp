@@ -19,6 +19,7 @@
 #include <mlpack/core/util/timers.hpp>
 
 #include "extension.hpp"
+#include "flat_payload.hpp"
 
 #include <boost/serialization/serialization.hpp>
 #include <boost/algorithm/string/trim.hpp>
@@ -49,6 +50,8 @@ bool Load(const std::string& filename,
       f = format::binary;
     else if (extension == "txt")
       f = format::text;
+    else if (extension == "flat")
+      f = format::flat;
     else
     {
       if (fatal)
@@ -65,7 +68,7 @@ bool Load(const std::string& filename,
   // Now load the given format.
   std::ifstream ifs;
 #ifdef _WIN32 // Open non-text in binary mode on Windows.
-  if (f == format::binary)
+  if (f == format::binary || f == format::flat)
     ifs.open(filename, std::ifstream::in | std::ifstream::binary);
   else
     ifs.open(filename, std::ifstream::in);
@@ -102,6 +105,23 @@ bool Load(const std::string& filename,
       boost::archive::binary_iarchive ar(ifs);
       ar >> boost::serialization::make_nvp(name.c_str(), t);
     }
+    else if (f == format::flat)
+    {
+      // The large matrices of the object will point into the mapping.
+      const char* metadata;
+      size_t metadataSize;
+      char* payloadData;
+      size_t payloadSize;
+      MapFlatFile(filename, metadata, metadataSize, payloadData, payloadSize);
+
+      FlatPayload payload(payloadData, payloadSize);
+      MemoryStreamBuffer buffer(metadata, metadataSize);
+      std::istream metadataStream(&buffer);
+
+      FlatPayloadScope scope(payload);
+      boost::archive::binary_iarchive ar(metadataStream);
+      ar >> boost::serialization::make_nvp(name.c_str(), t);
+    }
 
     return true;
   }
@@ -114,6 +134,15 @@ bool Load(const std::string& filename,
 
     return false;
   }
+  catch (std::runtime_error& e)
+  {
+    if (fatal)
+      Log::Fatal << e.what() << std::endl;
+    else
+      Log::Warn << e.what() << std::endl;
+
+    return false;
+  }
 }
 
 } // namespace data
@@ -106,21 +106,12 @@ class MissingPolicy
     {
       // Everything is mapped to NaN.  However we must still keep track of
       // everything that we have mapped, so we add it to the maps if needed.
-      if (maps.count(dimension) == 0 ||
-          maps[dimension].first.count(string) == 0)
+      auto& dimensionMaps = maps[dimension];
+      if (dimensionMaps.first.find(string) == dimensionMaps.first.end())
       {
-        // This string does not exist yet.
-        typedef std::pair<std::string, MappedType> PairType;
-        maps[dimension].first.insert(PairType(string, value));
-
-        // Insert right mapping too.
-        if (maps[dimension].second.count(mapValue) == 0)
-        {
-          // Create new element in reverse map.
-          maps[dimension].second.insert(std::make_pair(mapValue,
-              std::vector<std::string>()));
-        }
-        maps[dimension].second[mapValue].push_back(string);
+        // This string does not exist yet; insert right mapping too.
+        dimensionMaps.first.emplace(string, value);
+        dimensionMaps.second[mapValue].push_back(string);
       }
 
       return value;
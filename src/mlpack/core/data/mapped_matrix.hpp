@@ -0,0 +1,156 @@
+/**
+ * @file mapped_matrix.hpp
+ *
+ * A simple binary matrix format that can be memory-mapped, so that large
+ * datasets can be used as an Armadillo matrix without reading (and copying)
+ * the whole file into memory.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_MAPPED_MATRIX_HPP
+#define MLPACK_CORE_DATA_MAPPED_MATRIX_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <cstdint>
+
+namespace mlpack {
+namespace data {
+
+/**
+ * The header of a mapped matrix file.  It is followed directly by the elements
+ * of the matrix, in column-major order.  The header is 64 bytes long, so the
+ * elements are suitably aligned for any element type (and for vectorized
+ * access) when the file is mapped.
+ */
+struct MappedMatrixHeader
+{
+  //! Magic string identifying the format ("MLPKMMAT").
+  char magic[8];
+  //! Version of the format.
+  uint32_t version;
+  //! Size of each element, in bytes.
+  uint32_t elemSize;
+  //! Nonzero if the elements are floating-point numbers.
+  uint32_t isFloat;
+  //! Nonzero if the elements are signed.
+  uint32_t isSigned;
+  //! Number of rows of the matrix.
+  uint64_t nRows;
+  //! Number of columns of the matrix.
+  uint64_t nCols;
+  //! Padding to 64 bytes.
+  char padding[24];
+};
+
+/**
+ * MappedMatrix gives access to a matrix stored with SaveMapped() through
+ * memory mapping: the file is mapped into memory and an Armadillo matrix is
+ * constructed on top of the mapping (using auxiliary memory), so no copy of the
+ * data is made and only the pages that are actually used are read from disk.
+ *
+ * The mapping can be read-only (the default), in which case the matrix must not
+ * be modified, or copy-on-write, in which case the matrix may be modified; any
+ * modified pages are then private to this process, and the file itself is
+ * never changed.
+ *
+ * The matrix is only valid as long as the MappedMatrix object exists.  It can
+ * be passed (by const reference) to tree types that do not rearrange the
+ * dataset, like cover trees, without any copy being made.  If a copy-on-write
+ * mapping is used, the matrix can also be moved into trees that rearrange the
+ * dataset, like kd-trees; then, the rearrangement happens in place, and only
+ * one copy of the data (the modified private pages) will ever be held in
+ * memory.  In that case the MappedMatrix must outlive the tree.
+ *
+ * On systems without mmap() (i.e. Windows), the file is simply read into
+ * memory.
+ *
+ * @code
+ * data::SaveMapped("dataset.mbin", dataset);
+ * ...
+ * data::MappedMatrix<double> mapped("dataset.mbin");
+ * NeighborSearch<NearestNeighborSort, EuclideanDistance, arma::mat,
+ *     StandardCoverTree> knn(mapped.Matrix());
+ * @endcode
+ *
+ * @tparam eT Element type of the matrix.
+ */
+template<typename eT>
+class MappedMatrix
+{
+ public:
+  /**
+   * Map the given file, which must have been written with SaveMapped() for the
+   * same element type.  A std::runtime_error is thrown if the file cannot be
+   * opened or mapped, or if it is not a valid mapped matrix file of the right
+   * element type.
+   *
+   * @param filename Name of file to map.
+   * @param copyOnWrite If true, the matrix may be modified without modifying
+   *     the file.
+   */
+  MappedMatrix(const std::string& filename, const bool copyOnWrite = false);
+
+  //! Unmap the file.
+  ~MappedMatrix();
+
+  //! A MappedMatrix can't be copied.
+  MappedMatrix(const MappedMatrix& other) = delete;
+  //! A MappedMatrix can't be copied.
+  MappedMatrix& operator=(const MappedMatrix& other) = delete;
+
+  //! Get the mapped matrix.
+  const arma::Mat<eT>& Matrix() const { return matrix; }
+  //! Modify the mapped matrix (only allowed for copy-on-write mappings).
+  arma::Mat<eT>& Matrix() { return matrix; }
+
+  //! Return whether or not the mapping is copy-on-write.
+  bool CopyOnWrite() const { return copyOnWrite; }
+
+ private:
+  /**
+   * Map the given file and read its header.  This is a helper for the
+   * constructor, because the matrix has to be constructed on top of the
+   * mapping.
+   */
+  static char* Map(const std::string& filename,
+                   const bool copyOnWrite,
+                   MappedMatrixHeader& header,
+                   size_t& mappingSize);
+
+  //! Whether or not the mapping is copy-on-write.
+  bool copyOnWrite;
+  //! The header of the file.
+  MappedMatrixHeader header;
+  //! The size of the mapping, in bytes.
+  size_t mappingSize;
+  //! The start of the mapping (the header).
+  char* mapping;
+  //! The matrix, which uses the mapped memory.
+  arma::Mat<eT> matrix;
+};
+
+/**
+ * Save the given matrix in the mapped matrix format, so that it can later be
+ * used with MappedMatrix.  The matrix is not transposed.  If 'fatal' is true, a
+ * std::runtime_error is thrown on failure.
+ *
+ * @param filename Name of file to save to.
+ * @param matrix Matrix to save.
+ * @param fatal If an error should be reported as fatal (default false).
+ * @return Boolean value indicating success or failure of save.
+ */
+template<typename eT>
+bool SaveMapped(const std::string& filename,
+                const arma::Mat<eT>& matrix,
+                const bool fatal = false);
+
+} // namespace data
+} // namespace mlpack
+
+// Include implementation.
+#include "mapped_matrix_impl.hpp"
+
+#endif
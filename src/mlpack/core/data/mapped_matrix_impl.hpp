@@ -0,0 +1,198 @@
+/**
+ * @file mapped_matrix_impl.hpp
+ *
+ * Implementation of MappedMatrix and SaveMapped().
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_MAPPED_MATRIX_IMPL_HPP
+#define MLPACK_CORE_DATA_MAPPED_MATRIX_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "mapped_matrix.hpp"
+
+#include <mlpack/core/util/timers.hpp>
+#include <cstring>
+#include <fstream>
+
+#ifndef _WIN32
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+  #include <fcntl.h>
+  #include <unistd.h>
+#endif
+
+namespace mlpack {
+namespace data {
+
+static_assert(sizeof(MappedMatrixHeader) == 64,
+    "the mapped matrix header must be 64 bytes");
+
+template<typename eT>
+MappedMatrix<eT>::MappedMatrix(const std::string& filename,
+                               const bool copyOnWrite) :
+    copyOnWrite(copyOnWrite),
+    mapping(Map(filename, copyOnWrite, header, mappingSize)),
+    matrix((eT*) (mapping + sizeof(MappedMatrixHeader)), header.nRows,
+        header.nCols, false /* Don't copy the memory. */, true /* Strict. */)
+{
+  // Nothing to do.
+}
+
+template<typename eT>
+MappedMatrix<eT>::~MappedMatrix()
+{
+#ifndef _WIN32
+  munmap(mapping, mappingSize);
+#else
+  delete[] mapping;
+#endif
+}
+
+template<typename eT>
+char* MappedMatrix<eT>::Map(const std::string& filename,
+                            const bool copyOnWrite,
+                            MappedMatrixHeader& header,
+                            size_t& mappingSize)
+{
+  Timer::Start("loading_data");
+
+  // Read and check the header first.
+  std::ifstream stream(filename.c_str(), std::ios::in | std::ios::binary);
+  if (!stream.is_open())
+  {
+    Timer::Stop("loading_data");
+    Log::Fatal << "Cannot open file '" << filename << "'." << std::endl;
+  }
+
+  stream.read((char*) &header, sizeof(MappedMatrixHeader));
+  if (!stream.good() || std::memcmp(header.magic, "MLPKMMAT", 8) != 0 ||
+      header.version != 1)
+  {
+    Timer::Stop("loading_data");
+    Log::Fatal << "'" << filename << "' is not a mapped matrix file."
+        << std::endl;
+  }
+
+  if (header.elemSize != sizeof(eT) ||
+      (header.isFloat != 0) != std::is_floating_point<eT>::value ||
+      (header.isSigned != 0) != std::is_signed<eT>::value)
+  {
+    Timer::Stop("loading_data");
+    Log::Fatal << "The element type of the matrix in '" << filename << "' does "
+        << "not match the requested element type." << std::endl;
+  }
+
+  mappingSize = sizeof(MappedMatrixHeader) +
+      header.nRows * header.nCols * sizeof(eT);
+
+#ifndef _WIN32
+  stream.close();
+
+  const int fd = open(filename.c_str(), O_RDONLY);
+  struct stat fileInfo;
+  if (fd < 0 || fstat(fd, &fileInfo) != 0 ||
+      size_t(fileInfo.st_size) < mappingSize)
+  {
+    if (fd >= 0)
+      close(fd);
+    Timer::Stop("loading_data");
+    Log::Fatal << "'" << filename << "' is truncated or cannot be read."
+        << std::endl;
+  }
+
+  // A private mapping with write permission is copy-on-write; the file is
+  // never modified.
+  void* address = mmap(NULL, mappingSize,
+      copyOnWrite ? (PROT_READ | PROT_WRITE) : PROT_READ,
+      copyOnWrite ? MAP_PRIVATE : MAP_SHARED, fd, 0);
+  close(fd); // The mapping stays valid after the descriptor is closed.
+
+  if (address == MAP_FAILED)
+  {
+    Timer::Stop("loading_data");
+    Log::Fatal << "Cannot map file '" << filename << "' into memory."
+        << std::endl;
+  }
+
+  char* mapping = (char*) address;
+#else
+  // Without mmap(), just read the whole file.
+  (void) copyOnWrite;
+  char* mapping = new char[mappingSize];
+  std::memcpy(mapping, &header, sizeof(MappedMatrixHeader));
+  stream.read(mapping + sizeof(MappedMatrixHeader),
+      mappingSize - sizeof(MappedMatrixHeader));
+  if (!stream.good())
+  {
+    delete[] mapping;
+    Timer::Stop("loading_data");
+    Log::Fatal << "'" << filename << "' is truncated or cannot be read."
+        << std::endl;
+  }
+#endif
+
+  Timer::Stop("loading_data");
+
+  Log::Info << "Mapped " << header.nRows << " x " << header.nCols
+      << " matrix from '" << filename << "'." << std::endl;
+
+  return mapping;
+}
+
+template<typename eT>
+bool SaveMapped(const std::string& filename,
+                const arma::Mat<eT>& matrix,
+                const bool fatal)
+{
+  Timer::Start("saving_data");
+
+  std::ofstream stream(filename.c_str(), std::ios::out | std::ios::binary);
+  if (!stream.is_open())
+  {
+    Timer::Stop("saving_data");
+    if (fatal)
+      Log::Fatal << "Cannot open file '" << filename << "' for writing; save "
+          << "failed." << std::endl;
+    else
+      Log::Warn << "Cannot open file '" << filename << "' for writing; save "
+          << "failed." << std::endl;
+
+    return false;
+  }
+
+  MappedMatrixHeader header;
+  std::memset(&header, 0, sizeof(MappedMatrixHeader));
+  std::memcpy(header.magic, "MLPKMMAT", 8);
+  header.version = 1;
+  header.elemSize = sizeof(eT);
+  header.isFloat = std::is_floating_point<eT>::value ? 1 : 0;
+  header.isSigned = std::is_signed<eT>::value ? 1 : 0;
+  header.nRows = matrix.n_rows;
+  header.nCols = matrix.n_cols;
+
+  stream.write((const char*) &header, sizeof(MappedMatrixHeader));
+  stream.write((const char*) matrix.memptr(), matrix.n_elem * sizeof(eT));
+
+  if (!stream.good())
+  {
+    Timer::Stop("saving_data");
+    if (fatal)
+      Log::Fatal << "Save to '" << filename << "' failed." << std::endl;
+    else
+      Log::Warn << "Save to '" << filename << "' failed." << std::endl;
+
+    return false;
+  }
+
+  Timer::Stop("saving_data");
+  return true;
+}
+
+} // namespace data
+} // namespace mlpack
+
+#endif
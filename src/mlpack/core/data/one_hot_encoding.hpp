@@ -0,0 +1,140 @@
+/**
+ * @file one_hot_encoding.hpp
+ *
+ * Defines OneHotEncoding(), which encodes the categorical dimensions of a
+ * dataset into a sparse matrix with one dimension per category.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_ONE_HOT_ENCODING_HPP
+#define MLPACK_CORE_DATA_ONE_HOT_ENCODING_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "dataset_mapper.hpp"
+
+namespace mlpack {
+namespace data {
+
+/**
+ * Given a dataset whose categorical dimensions were mapped to 0, 1, 2, ... by
+ * the given DatasetMapper (as by data::Load() with IncrementPolicy), encode it
+ * into a sparse matrix where each categorical dimension is replaced by one
+ * dimension per category, which is 1 for the points of that category and 0
+ * otherwise.  Numeric dimensions are kept as they are.  The dimensions of the
+ * output are in the order of the input: a numeric dimension gives one output
+ * dimension, and a categorical dimension d gives info.NumMappings(d) output
+ * dimensions, in the order of the mapped values.
+ *
+ * The output is built directly in compressed sparse column form, with the
+ * points encoded in parallel, so the dense one-hot matrix is never formed.
+ *
+ * @code
+ * arma::mat input;
+ * data::DatasetInfo info;
+ * data::Load("categorical.csv", input, info);
+ *
+ * arma::sp_mat output;
+ * data::OneHotEncoding(input, info, output);
+ * @endcode
+ *
+ * @param input Dataset to encode, with categorical values mapped by info.
+ * @param info Types and mappings of the dimensions of the dataset.
+ * @param output Sparse matrix to store the encoded dataset into.
+ */
+template<typename eT, typename PolicyType, typename InputType>
+void OneHotEncoding(const arma::Mat<eT>& input,
+                    const DatasetMapper<PolicyType, InputType>& info,
+                    arma::SpMat<eT>& output)
+{
+  if (info.Dimensionality() != input.n_rows)
+  {
+    std::ostringstream oss;
+    oss << "OneHotEncoding(): the dataset has " << input.n_rows
+        << " dimensions, but the DatasetMapper has " << info.Dimensionality();
+    throw std::invalid_argument(oss.str());
+  }
+
+  // The types and mappings are looked up once, and then the first output
+  // dimension of each input dimension is known.
+  std::vector<bool> categorical(input.n_rows);
+  arma::uvec numCategories(input.n_rows);
+  arma::uvec offsets(input.n_rows);
+  size_t numRows = 0;
+  for (size_t d = 0; d < input.n_rows; ++d)
+  {
+    categorical[d] = (info.Type(d) == Datatype::categorical);
+    numCategories[d] = categorical[d] ? info.NumMappings(d) : 0;
+    offsets[d] = numRows;
+    numRows += categorical[d] ? numCategories[d] : 1;
+  }
+
+  // Make sure that each categorical value is a mapped value, and count the
+  // nonzero values of each point (numeric values may be zero).
+  arma::uvec colPtrs(input.n_cols + 1);
+  colPtrs[0] = 0;
+  bool valid = true;
+  #pragma omp parallel for reduction(&&: valid)
+  for (omp_size_t i = 0; i < (omp_size_t) input.n_cols; ++i)
+  {
+    size_t count = 0;
+    for (size_t d = 0; d < input.n_rows; ++d)
+    {
+      const eT value = input(d, i);
+      if (categorical[d])
+      {
+        valid = valid && (value >= 0 && value < numCategories[d] &&
+            value == std::floor(value));
+        ++count;
+      }
+      else if (value != 0)
+      {
+        ++count;
+      }
+    }
+
+    colPtrs[i + 1] = count;
+  }
+
+  if (!valid)
+  {
+    throw std::invalid_argument("OneHotEncoding(): the dataset has a "
+        "categorical value that is not mapped by the DatasetMapper");
+  }
+
+  colPtrs = arma::cumsum(colPtrs);
+
+  // The output dimensions of each point are increasing, as the sparse matrix
+  // needs.
+  arma::uvec rowIndices(colPtrs[input.n_cols]);
+  arma::Col<eT> values(colPtrs[input.n_cols]);
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) input.n_cols; ++i)
+  {
+    size_t position = colPtrs[i];
+    for (size_t d = 0; d < input.n_rows; ++d)
+    {
+      const eT value = input(d, i);
+      if (categorical[d])
+      {
+        rowIndices[position] = offsets[d] + (size_t) value;
+        values[position++] = 1;
+      }
+      else if (value != 0)
+      {
+        rowIndices[position] = offsets[d];
+        values[position++] = value;
+      }
+    }
+  }
+
+  output = arma::SpMat<eT>(rowIndices, colPtrs, values, numRows,
+      input.n_cols);
+}
+
+} // namespace data
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,132 @@
+/**
+ * @file reorder.hpp
+ *
+ * Reorder the points of a dataset along a space-filling curve, so that points
+ * that are close in space are close in memory.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_REORDER_HPP
+#define MLPACK_CORE_DATA_REORDER_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/tree/address.hpp>
+#include <mlpack/core/tree/rectangle_tree/discrete_hilbert_value.hpp>
+
+namespace mlpack {
+namespace data {
+
+//! The space-filling curves that Reorder() can sort the points along.
+enum ReorderCurve
+{
+  //! The Z-order curve, given by the addresses of the UB tree.
+  MORTON_CURVE,
+  //! The Hilbert curve, given by the values of the Hilbert R tree.
+  HILBERT_CURVE
+};
+
+/**
+ * Permute the columns (points) of a dataset so that they are sorted along a
+ * space-filling curve.  Trees rearrange their points as they split, but the
+ * algorithms that do not build trees (like the naive k-means step) visit the
+ * points in the order they are given; after the reordering, the points that
+ * such an algorithm compares with the same centroid or neighbor are likely to
+ * be near each other in memory.
+ *
+ * The keys are the ones the trees use: the addresses of UBTreeSplit for the
+ * Morton (Z-order) curve and the values of DiscreteHilbertValue for the
+ * Hilbert curve.  The Hilbert curve keeps neighboring points closer, but its
+ * keys are slower to compute.
+ *
+ * The permutation is returned in oldFromNew: the point now in column i was in
+ * column oldFromNew[i].  Results that hold one column per point can be put back
+ * in the original order with RestoreOrder().
+ *
+ * @code
+ * std::vector<size_t> oldFromNew;
+ * data::Reorder(dataset, oldFromNew);
+ * kmeans.Cluster(dataset, clusters, assignments);
+ * data::RestoreOrder(assignments, oldFromNew);
+ * @endcode
+ *
+ * @param dataset Dataset to reorder.
+ * @param oldFromNew Vector to store the permutation in.
+ * @param curve Space-filling curve to sort the points along.
+ */
+template<typename eT>
+void Reorder(arma::Mat<eT>& dataset,
+             std::vector<size_t>& oldFromNew,
+             const ReorderCurve curve = HILBERT_CURVE)
+{
+  typedef typename tree::DiscreteHilbertValue<eT>::HilbertElemType KeyElemType;
+
+  // Compute the keys.  Each point is independent of the others.
+  std::vector<arma::Col<KeyElemType>> keys(dataset.n_cols);
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) dataset.n_cols; ++i)
+  {
+    if (curve == HILBERT_CURVE)
+    {
+      keys[i] = tree::DiscreteHilbertValue<eT>::CalculateValue(
+          dataset.unsafe_col(i));
+    }
+    else
+    {
+      keys[i].zeros(dataset.n_rows);
+      bound::addr::PointToAddress(keys[i], dataset.unsafe_col(i));
+    }
+  }
+
+  oldFromNew.resize(dataset.n_cols);
+  for (size_t i = 0; i < oldFromNew.size(); ++i)
+    oldFromNew[i] = i;
+
+  // Both keys are compared lexicographically.  The sort is stable, so points
+  // with equal keys keep their order.
+  std::stable_sort(oldFromNew.begin(), oldFromNew.end(),
+      [&keys](const size_t a, const size_t b)
+      {
+        return bound::addr::CompareAddresses(keys[a], keys[b]) < 0;
+      });
+
+  arma::Mat<eT> reordered(dataset.n_rows, dataset.n_cols);
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) dataset.n_cols; ++i)
+    reordered.col(i) = dataset.col(oldFromNew[i]);
+
+  dataset = std::move(reordered);
+}
+
+/**
+ * Put the columns of a matrix that was computed on a reordered dataset (or the
+ * reordered dataset itself) back in the original order of the points.
+ *
+ * @param matrix Matrix with one column per point, in the order given by
+ *     Reorder().
+ * @param oldFromNew The permutation given by Reorder().
+ */
+template<typename MatType>
+void RestoreOrder(MatType& matrix, const std::vector<size_t>& oldFromNew)
+{
+  if (matrix.n_cols != oldFromNew.size())
+  {
+    std::ostringstream oss;
+    oss << "RestoreOrder(): matrix has " << matrix.n_cols << " columns, but "
+        << "the permutation has " << oldFromNew.size() << " points";
+    throw std::invalid_argument(oss.str());
+  }
+
+  MatType restored(matrix.n_rows, matrix.n_cols);
+  for (size_t i = 0; i < oldFromNew.size(); ++i)
+    restored.col(oldFromNew[i]) = matrix.col(i);
+
+  matrix = std::move(restored);
+}
+
+} // namespace data
+} // namespace mlpack
+
+#endif
@@ -69,9 +69,13 @@ bool Save(const std::string& filename,
  *  - text, denoted by .txt
  *  - xml, denoted by .xml
  *  - binary, denoted by .bin
+ *  - flat, denoted by .flat: a binary archive followed by the raw elements of
+ *    the large matrices, so that loading maps the file into memory instead of
+ *    copying the matrices (see FlatPayload)
  *
  * The format parameter can take any of the values in the 'format' enum:
- * 'format::autodetect', 'format::text', 'format::xml', and 'format::binary'.
+ * 'format::autodetect', 'format::text', 'format::xml', 'format::binary', and
+ * 'format::flat'.
  * The autodetect functionality operates on the file extension (so, "file.txt"
  * would be autodetected as text).
  *
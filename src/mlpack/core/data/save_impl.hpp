@@ -15,6 +15,8 @@
 // In case it hasn't already been included.
 #include "save.hpp"
 #include "extension.hpp"
+#include "flat_payload.hpp"
+#include "save_text.hpp"
 
 #include <boost/serialization/serialization.hpp>
 #include <boost/archive/xml_oarchive.hpp>
@@ -153,8 +155,23 @@ bool Save(const std::string& filename,
   Log::Info << "Saving " << stringType << " to '" << filename << "'."
       << std::endl;
 
-  // Transpose the matrix.
-  if (transpose)
+  // Text is formatted in parallel, and written transposed without building the
+  // transpose.
+  if (saveType == arma::csv_ascii || saveType == arma::raw_ascii)
+  {
+    if (!SaveText(stream, matrix, transpose,
+        (saveType == arma::csv_ascii) ? ',' : ' '))
+    {
+      Timer::Stop("saving_data");
+      if (fatal)
+        Log::Fatal << "Save to '" << filename << "' failed." << std::endl;
+      else
+        Log::Warn << "Save to '" << filename << "' failed." << std::endl;
+
+      return false;
+    }
+  }
+  else if (transpose)
   {
     arma::Mat<eT> tmp = trans(matrix);
 
@@ -215,14 +232,16 @@ bool Save(const std::string& filename,
       f = format::binary;
     else if (extension == "txt")
       f = format::text;
+    else if (extension == "flat")
+      f = format::flat;
     else
     {
       if (fatal)
         Log::Fatal << "Unable to detect type of '" << filename << "'; incorrect"
-            << " extension? (allowed: xml/bin/txt)" << std::endl;
+            << " extension? (allowed: xml/bin/txt/flat)" << std::endl;
       else
         Log::Warn << "Unable to detect type of '" << filename << "'; save "
-            << "failed.  Incorrect extension? (allowed: xml/bin/txt)"
+            << "failed.  Incorrect extension? (allowed: xml/bin/txt/flat)"
             << std::endl;
 
       return false;
@@ -232,7 +251,8 @@ bool Save(const std::string& filename,
   // Open the file to save to.
   std::ofstream ofs;
 #ifdef _WIN32
-  if (f == format::binary) // Open non-text types in binary mode on Windows.
+  // Open non-text types in binary mode on Windows.
+  if (f == format::binary || f == format::flat)
     ofs.open(filename, std::ofstream::out | std::ofstream::binary);
   else
     ofs.open(filename, std::ofstream::out);
@@ -269,6 +289,20 @@ bool Save(const std::string& filename,
       boost::archive::binary_oarchive ar(ofs);
       ar << boost::serialization::make_nvp(name.c_str(), t);
     }
+    else if (f == format::flat)
+    {
+      // Serialize everything but the large arrays first, and then write the
+      // arrays after it.
+      FlatPayload payload;
+      std::ostringstream metadata;
+      {
+        FlatPayloadScope scope(payload);
+        boost::archive::binary_oarchive ar(metadata);
+        ar << boost::serialization::make_nvp(name.c_str(), t);
+      }
+
+      SaveFlatFile(ofs, metadata.str(), payload);
+    }
 
     return true;
   }
@@ -281,6 +315,15 @@ bool Save(const std::string& filename,
 
     return false;
   }
+  catch (std::runtime_error& e)
+  {
+    if (fatal)
+      Log::Fatal << e.what() << std::endl;
+    else
+      Log::Warn << e.what() << std::endl;
+
+    return false;
+  }
 }
 
 } // namespace data
@@ -0,0 +1,153 @@
+/**
+ * @file save_text.hpp
+ *
+ * Write a matrix as delimited text, formatting it in parallel.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_SAVE_TEXT_HPP
+#define MLPACK_CORE_DATA_SAVE_TEXT_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+namespace mlpack {
+namespace data {
+
+/**
+ * Format a double at the given position, with the fewest significant digits
+ * (15 or 17) that read back to the same value, and return the position after
+ * it.  There must be room for 32 characters.
+ */
+inline char* FormatValue(char* out, const double value)
+{
+  int length = std::snprintf(out, 32, "%.15g", value);
+  if (std::strtod(out, NULL) != value)
+    length = std::snprintf(out, 32, "%.17g", value);
+  return out + length;
+}
+
+/**
+ * Format a float at the given position, with the fewest significant digits (7
+ * or 9) that read back to the same value, and return the position after it.
+ * There must be room for 32 characters.
+ */
+inline char* FormatValue(char* out, const float value)
+{
+  int length = std::snprintf(out, 32, "%.7g", (double) value);
+  if (std::strtof(out, NULL) != value)
+    length = std::snprintf(out, 32, "%.9g", (double) value);
+  return out + length;
+}
+
+/**
+ * Format an integer at the given position, and return the position after it.
+ * There must be room for 32 characters.
+ */
+template<typename eT>
+inline typename std::enable_if<std::is_integral<eT>::value, char*>::type
+FormatValue(char* out, const eT value)
+{
+  // Write the digits backwards, then reverse them.
+  char* begin = out;
+  typedef typename std::make_unsigned<eT>::type UnsignedType;
+  UnsignedType magnitude = (UnsignedType) value;
+  if (std::is_signed<eT>::value && value < 0)
+  {
+    *out++ = '-';
+    ++begin;
+    magnitude = (UnsignedType) 0 - magnitude;
+  }
+
+  do
+  {
+    *out++ = (char) ('0' + (magnitude % 10));
+    magnitude /= 10;
+  } while (magnitude != 0);
+
+  std::reverse(begin, out);
+  return out;
+}
+
+/**
+ * Write a matrix to the given stream as delimited text: one line for each row
+ * of the matrix (or each column, if transpose is true), with the values
+ * separated by the given character.  This is the layout of the csv_ascii and
+ * raw_ascii formats of Armadillo, but the values are written with the fewest
+ * digits that read back exactly.
+ *
+ * The lines are split into chunks, which are formatted into separate buffers
+ * by the OpenMP threads and then written in order, a few chunks per thread at
+ * a time; the transpose is written without being built.
+ *
+ * @param stream Stream to write to.
+ * @param matrix Matrix to write.
+ * @param transpose Whether to write the columns as lines.
+ * @param separator Character between the values of a line.
+ * @return Whether the stream is still good after the write.
+ */
+template<typename eT>
+bool SaveText(std::ostream& stream,
+              const arma::Mat<eT>& matrix,
+              const bool transpose,
+              const char separator)
+{
+  const size_t numLines = transpose ? matrix.n_cols : matrix.n_rows;
+  const size_t lineLength = transpose ? matrix.n_rows : matrix.n_cols;
+
+  // Chunks of about 64k values keep the buffers in cache, and a round of
+  // chunks keeps the memory used bounded.
+  const size_t linesPerChunk = std::max((size_t) 65536 /
+      std::max(lineLength, (size_t) 1), (size_t) 1);
+  const size_t numChunks = (numLines + linesPerChunk - 1) / linesPerChunk;
+  const size_t chunksPerRound = 4 * Parallel::Threads();
+  std::vector<std::string> buffers(chunksPerRound);
+
+  for (size_t round = 0; round < numChunks; round += chunksPerRound)
+  {
+    const size_t roundEnd = std::min(round + chunksPerRound, numChunks);
+
+    #pragma omp parallel for schedule(dynamic)
+    for (omp_size_t c = (omp_size_t) round; c < (omp_size_t) roundEnd; ++c)
+    {
+      const size_t chunk = (size_t) c;
+      std::string& buffer = buffers[chunk - round];
+      buffer.clear();
+
+      char value[32];
+      const size_t lineEnd = std::min((chunk + 1) * linesPerChunk, numLines);
+      for (size_t line = chunk * linesPerChunk; line < lineEnd; ++line)
+      {
+        for (size_t j = 0; j < lineLength; ++j)
+        {
+          if (j > 0)
+            buffer += separator;
+          const char* end = FormatValue(value, transpose ? matrix(j, line) :
+              matrix(line, j));
+          buffer.append(value, end);
+        }
+        buffer += '\n';
+      }
+    }
+
+    for (size_t c = round; c < roundEnd; ++c)
+      stream.write(buffers[c - round].data(), buffers[c - round].size());
+
+    if (!stream.good())
+      return false;
+  }
+
+  stream.flush();
+  return stream.good();
+}
+
+} // namespace data
+} // namespace mlpack
+
+#endif
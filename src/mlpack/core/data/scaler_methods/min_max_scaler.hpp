@@ -0,0 +1,251 @@
+/**
+ * @file min_max_scaler.hpp
+ *
+ * Definition and implementation of the MinMaxScaler class, which scales each
+ * dimension of a dataset to a given range.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_SCALER_METHODS_MIN_MAX_SCALER_HPP
+#define MLPACK_CORE_DATA_SCALER_METHODS_MIN_MAX_SCALER_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "scale_rows.hpp"
+
+namespace mlpack {
+namespace data {
+
+/**
+ * The MinMaxScaler class maps each dimension of the points linearly so that
+ * the minimum and the maximum of the dimension become the given lower and
+ * upper bounds.  Like StandardScaler, it is fitted once (a chunk of points at
+ * a time with Update(), if needed), can be saved with serialize(), and then
+ * transforms points in place, in parallel.
+ *
+ * @code
+ * arma::mat train = loadTrain(), test = loadTest();
+ * data::MinMaxScaler scaler(-1.0, 1.0);
+ * scaler.Fit(train);
+ * scaler.Transform(train);
+ * scaler.Transform(test);
+ * @endcode
+ *
+ * A sparse matrix stays sparse only if its zeros are mapped to zero in each
+ * dimension (typically, nonnegative data like counts, whose minimum is 0, with
+ * a lower bound of 0); otherwise Transform() throws a std::invalid_argument.
+ * Dimensions whose values are all equal are only shifted.
+ */
+class MinMaxScaler
+{
+ public:
+  /**
+   * Create the MinMaxScaler, with no statistics.
+   *
+   * @param lower Value the minimum of each dimension is mapped to.
+   * @param upper Value the maximum of each dimension is mapped to.
+   */
+  MinMaxScaler(const double lower = 0.0, const double upper = 1.0) :
+      lower(lower),
+      upper(upper)
+  {
+    if (lower >= upper)
+    {
+      throw std::invalid_argument("MinMaxScaler::MinMaxScaler(): the lower "
+          "bound must be less than the upper bound");
+    }
+  }
+
+  /**
+   * Fit the statistics to the given points, forgetting any previous ones.
+   *
+   * @param input Points to fit (one per column).
+   */
+  template<typename MatType>
+  void Fit(const MatType& input)
+  {
+    minValues.reset();
+    maxValues.reset();
+    Update(input);
+  }
+
+  /**
+   * Add the given points (dense or sparse) to the statistics.
+   *
+   * @param input Points to add (one per column).
+   */
+  template<typename MatType>
+  void Update(const MatType& input)
+  {
+    if (input.n_cols == 0)
+      return;
+
+    // For sparse matrices, the minimum and maximum include the zeros.
+    const arma::vec chunkMin = arma::conv_to<arma::vec>::from(
+        arma::Mat<typename MatType::elem_type>(arma::min(input, 1)));
+    const arma::vec chunkMax = arma::conv_to<arma::vec>::from(
+        arma::Mat<typename MatType::elem_type>(arma::max(input, 1)));
+
+    if (minValues.n_elem == 0)
+    {
+      minValues = chunkMin;
+      maxValues = chunkMax;
+      return;
+    }
+
+    CheckDimensionality(input.n_rows, "Update");
+    for (size_t d = 0; d < minValues.n_elem; ++d)
+    {
+      minValues[d] = std::min(minValues[d], chunkMin[d]);
+      maxValues[d] = std::max(maxValues[d], chunkMax[d]);
+    }
+  }
+
+  /**
+   * Transform the given points in place with the fitted statistics.
+   *
+   * @param input Points to transform (one per column).
+   */
+  template<typename eT>
+  void Transform(arma::Mat<eT>& input) const
+  {
+    CheckDimensionality(input.n_rows, "Transform");
+    const arma::vec factors = Factors();
+
+    #pragma omp parallel for
+    for (omp_size_t i = 0; i < (omp_size_t) input.n_cols; ++i)
+    {
+      for (size_t d = 0; d < input.n_rows; ++d)
+      {
+        input(d, i) = eT((input(d, i) - minValues[d]) * factors[d] + lower);
+      }
+    }
+  }
+
+  /**
+   * Transform the given sparse points in place with the fitted statistics.
+   * Zero must be mapped to zero in each dimension.
+   *
+   * @param input Points to transform (one per column).
+   */
+  template<typename eT>
+  void Transform(arma::SpMat<eT>& input) const
+  {
+    CheckDimensionality(input.n_rows, "Transform");
+    CheckSparse("Transform");
+    ScaleRows(input, Factors());
+  }
+
+  /**
+   * Undo the transformation of the given points in place.
+   *
+   * @param input Transformed points (one per column).
+   */
+  template<typename eT>
+  void InverseTransform(arma::Mat<eT>& input) const
+  {
+    CheckDimensionality(input.n_rows, "InverseTransform");
+    const arma::vec factors = Factors();
+
+    #pragma omp parallel for
+    for (omp_size_t i = 0; i < (omp_size_t) input.n_cols; ++i)
+    {
+      for (size_t d = 0; d < input.n_rows; ++d)
+      {
+        input(d, i) = eT((input(d, i) - lower) / factors[d] + minValues[d]);
+      }
+    }
+  }
+
+  /**
+   * Undo the transformation of the given sparse points in place.  Zero must be
+   * mapped to zero in each dimension.
+   *
+   * @param input Transformed points (one per column).
+   */
+  template<typename eT>
+  void InverseTransform(arma::SpMat<eT>& input) const
+  {
+    CheckDimensionality(input.n_rows, "InverseTransform");
+    CheckSparse("InverseTransform");
+    ScaleRows(input, 1.0 / Factors());
+  }
+
+  //! Get the minimum of each dimension.
+  const arma::vec& Min() const { return minValues; }
+
+  //! Get the maximum of each dimension.
+  const arma::vec& Max() const { return maxValues; }
+
+  //! Get the value the minimum of each dimension is mapped to.
+  double Lower() const { return lower; }
+  //! Modify the value the minimum of each dimension is mapped to.
+  double& Lower() { return lower; }
+
+  //! Get the value the maximum of each dimension is mapped to.
+  double Upper() const { return upper; }
+  //! Modify the value the maximum of each dimension is mapped to.
+  double& Upper() { return upper; }
+
+  //! Serialize the MinMaxScaler.
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */)
+  {
+    ar & BOOST_SERIALIZATION_NVP(lower);
+    ar & BOOST_SERIALIZATION_NVP(upper);
+    ar & BOOST_SERIALIZATION_NVP(minValues);
+    ar & BOOST_SERIALIZATION_NVP(maxValues);
+  }
+
+ private:
+  //! Get the factor of each dimension (one if all its values are equal).
+  arma::vec Factors() const
+  {
+    arma::vec ranges = maxValues - minValues;
+    ranges.elem(arma::find(ranges == 0.0)).fill(upper - lower);
+    return (upper - lower) / ranges;
+  }
+
+  //! Make sure the points have the dimensionality of the statistics.
+  void CheckDimensionality(const size_t dimensionality,
+                           const std::string& method) const
+  {
+    if (dimensionality != minValues.n_elem)
+    {
+      std::ostringstream oss;
+      oss << "MinMaxScaler::" << method << "(): the points have "
+          << dimensionality << " dimensions, but " << minValues.n_elem
+          << " were fitted";
+      throw std::invalid_argument(oss.str());
+    }
+  }
+
+  //! Make sure that sparse points can be transformed.
+  void CheckSparse(const std::string& method) const
+  {
+    if (arma::any(lower - minValues % Factors() != 0.0))
+    {
+      throw std::invalid_argument("MinMaxScaler::" + method + "(): zero is "
+          "not mapped to zero, so a sparse matrix would become dense");
+    }
+  }
+
+  //! The value the minimum of each dimension is mapped to.
+  double lower;
+
+  //! The value the maximum of each dimension is mapped to.
+  double upper;
+
+  //! The minimum of each dimension.
+  arma::vec minValues;
+
+  //! The maximum of each dimension.
+  arma::vec maxValues;
+};
+
+} // namespace data
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,50 @@
+/**
+ * @file scale_rows.hpp
+ *
+ * Definition of ScaleRows(), which multiplies each dimension of a sparse
+ * matrix by a factor, used by the scalers.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_SCALER_METHODS_SCALE_ROWS_HPP
+#define MLPACK_CORE_DATA_SCALER_METHODS_SCALE_ROWS_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace data {
+
+/**
+ * Multiply each dimension (row) of the given sparse matrix by the
+ * corresponding factor, which must be nonzero so that the nonzero values stay
+ * nonzero.  The values are scaled in parallel over the points, and the
+ * structure of the matrix is kept.
+ *
+ * @param input Sparse matrix to scale.
+ * @param factors Factor of each dimension.
+ */
+template<typename eT>
+void ScaleRows(arma::SpMat<eT>& input, const arma::vec& factors)
+{
+  const arma::uvec rowIndices(input.row_indices, input.n_nonzero);
+  const arma::uvec colPtrs(input.col_ptrs, input.n_cols + 1);
+  arma::Col<eT> values(input.values, input.n_nonzero);
+
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) input.n_cols; ++i)
+  {
+    for (size_t j = colPtrs[i]; j < colPtrs[i + 1]; ++j)
+      values[j] = eT(values[j] * factors[rowIndices[j]]);
+  }
+
+  input = arma::SpMat<eT>(rowIndices, colPtrs, values, input.n_rows,
+      input.n_cols);
+}
+
+} // namespace data
+} // namespace mlpack
+
+#endif
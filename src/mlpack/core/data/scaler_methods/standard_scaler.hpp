@@ -0,0 +1,316 @@
+/**
+ * @file standard_scaler.hpp
+ *
+ * Definition and implementation of the StandardScaler class, which scales each
+ * dimension of a dataset to zero mean and unit variance.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_SCALER_METHODS_STANDARD_SCALER_HPP
+#define MLPACK_CORE_DATA_SCALER_METHODS_STANDARD_SCALER_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "scale_rows.hpp"
+
+namespace mlpack {
+namespace data {
+
+/**
+ * The StandardScaler class subtracts the mean of each dimension from the
+ * points and divides them by the standard deviation of the dimension, so that
+ * each dimension has zero mean and unit variance.  The statistics are fitted
+ * once, and can then be applied to other datasets (for instance test points,
+ * at inference time); they can be saved with the model through serialize().
+ *
+ * The statistics can be fitted a chunk of points at a time with Update(), so a
+ * dataset that does not fit in memory (see StreamingDataset) is fitted with one
+ * read:
+ *
+ * @code
+ * data::StreamingDataset<> dataset("clicks.csv");
+ * data::StandardScaler scaler;
+ * arma::mat points;
+ * while (dataset.Next(points))
+ *   scaler.Update(points);
+ *
+ * arma::mat test = loadTest();
+ * scaler.Transform(test);
+ * @endcode
+ *
+ * Both dense and sparse matrices can be fitted and transformed; the points are
+ * transformed in place, in parallel.  Subtracting the mean would make a sparse
+ * matrix dense, so sparse matrices can only be transformed by a StandardScaler
+ * created with center = false, which only divides by the standard deviations.
+ * Dimensions whose standard deviation is zero are not scaled.
+ */
+class StandardScaler
+{
+ public:
+  /**
+   * Create the StandardScaler, with no statistics.
+   *
+   * @param center Whether to subtract the means.
+   * @param scale Whether to divide by the standard deviations.
+   */
+  StandardScaler(const bool center = true, const bool scale = true) :
+      center(center),
+      scale(scale),
+      count(0)
+  { /* Nothing to do. */ }
+
+  /**
+   * Fit the statistics to the given points, forgetting any previous ones.
+   *
+   * @param input Points to fit (one per column).
+   */
+  template<typename MatType>
+  void Fit(const MatType& input)
+  {
+    count = 0;
+    mean.reset();
+    m2.reset();
+    Update(input);
+  }
+
+  /**
+   * Add the given points to the statistics.
+   *
+   * @param input Points to add (one per column).
+   */
+  template<typename eT>
+  void Update(const arma::Mat<eT>& input)
+  {
+    if (input.n_cols == 0)
+      return;
+
+    const arma::vec chunkMean = arma::conv_to<arma::vec>::from(
+        arma::mean(input, 1));
+
+    // The squared deviations are accumulated by each thread over its points.
+    arma::vec chunkM2(input.n_rows, arma::fill::zeros);
+    #pragma omp parallel
+    {
+      arma::vec threadM2(input.n_rows, arma::fill::zeros);
+
+      #pragma omp for schedule(static)
+      for (omp_size_t i = 0; i < (omp_size_t) input.n_cols; ++i)
+      {
+        for (size_t d = 0; d < input.n_rows; ++d)
+        {
+          const double deviation = input(d, i) - chunkMean[d];
+          threadM2[d] += deviation * deviation;
+        }
+      }
+
+      #pragma omp critical(StandardScalerUpdate)
+      chunkM2 += threadM2;
+    }
+
+    Merge(input.n_cols, chunkMean, chunkM2);
+  }
+
+  /**
+   * Add the given sparse points to the statistics.
+   *
+   * @param input Points to add (one per column).
+   */
+  template<typename eT>
+  void Update(const arma::SpMat<eT>& input)
+  {
+    if (input.n_cols == 0)
+      return;
+
+    const double n = input.n_cols;
+    const arma::vec chunkMean = arma::conv_to<arma::vec>::from(
+        arma::Mat<eT>(arma::sum(input, 1))) / n;
+    const arma::vec squares = arma::conv_to<arma::vec>::from(
+        arma::Mat<eT>(arma::sum(arma::square(input), 1)));
+    arma::vec chunkM2 = squares - n * arma::square(chunkMean);
+    chunkM2.elem(arma::find(chunkM2 < 0.0)).zeros();
+
+    Merge(input.n_cols, chunkMean, chunkM2);
+  }
+
+  /**
+   * Transform the given points in place with the fitted statistics.
+   *
+   * @param input Points to transform (one per column).
+   */
+  template<typename eT>
+  void Transform(arma::Mat<eT>& input) const
+  {
+    CheckDimensionality(input.n_rows, "Transform");
+    const arma::vec offsets = center ? mean : arma::vec(mean.n_elem,
+        arma::fill::zeros);
+    const arma::vec factors = 1.0 / Scales();
+
+    #pragma omp parallel for
+    for (omp_size_t i = 0; i < (omp_size_t) input.n_cols; ++i)
+    {
+      for (size_t d = 0; d < input.n_rows; ++d)
+        input(d, i) = eT((input(d, i) - offsets[d]) * factors[d]);
+    }
+  }
+
+  /**
+   * Transform the given sparse points in place with the fitted statistics.
+   * The StandardScaler must not center the points.
+   *
+   * @param input Points to transform (one per column).
+   */
+  template<typename eT>
+  void Transform(arma::SpMat<eT>& input) const
+  {
+    CheckDimensionality(input.n_rows, "Transform");
+    CheckSparse("Transform");
+    ScaleRows(input, 1.0 / Scales());
+  }
+
+  /**
+   * Undo the transformation of the given points in place.
+   *
+   * @param input Transformed points (one per column).
+   */
+  template<typename eT>
+  void InverseTransform(arma::Mat<eT>& input) const
+  {
+    CheckDimensionality(input.n_rows, "InverseTransform");
+    const arma::vec offsets = center ? mean : arma::vec(mean.n_elem,
+        arma::fill::zeros);
+    const arma::vec factors = Scales();
+
+    #pragma omp parallel for
+    for (omp_size_t i = 0; i < (omp_size_t) input.n_cols; ++i)
+    {
+      for (size_t d = 0; d < input.n_rows; ++d)
+        input(d, i) = eT(input(d, i) * factors[d] + offsets[d]);
+    }
+  }
+
+  /**
+   * Undo the transformation of the given sparse points in place.  The
+   * StandardScaler must not center the points.
+   *
+   * @param input Transformed points (one per column).
+   */
+  template<typename eT>
+  void InverseTransform(arma::SpMat<eT>& input) const
+  {
+    CheckDimensionality(input.n_rows, "InverseTransform");
+    CheckSparse("InverseTransform");
+    ScaleRows(input, Scales());
+  }
+
+  //! Get the number of points the statistics were fitted to.
+  size_t Count() const { return count; }
+
+  //! Get the mean of each dimension.
+  const arma::vec& Mean() const { return mean; }
+
+  //! Get the (population) standard deviation of each dimension.
+  arma::vec StandardDeviation() const
+  {
+    return (count == 0) ? arma::vec(mean.n_elem, arma::fill::zeros) :
+        arma::vec(arma::sqrt(m2 / count));
+  }
+
+  //! Get whether the means are subtracted.
+  bool Center() const { return center; }
+  //! Modify whether the means are subtracted.
+  bool& Center() { return center; }
+
+  //! Get whether the points are divided by the standard deviations.
+  bool Scale() const { return scale; }
+  //! Modify whether the points are divided by the standard deviations.
+  bool& Scale() { return scale; }
+
+  //! Serialize the StandardScaler.
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */)
+  {
+    ar & BOOST_SERIALIZATION_NVP(center);
+    ar & BOOST_SERIALIZATION_NVP(scale);
+    ar & BOOST_SERIALIZATION_NVP(count);
+    ar & BOOST_SERIALIZATION_NVP(mean);
+    ar & BOOST_SERIALIZATION_NVP(m2);
+  }
+
+ private:
+  //! Merge the statistics of a chunk of points into the statistics.
+  void Merge(const size_t chunkCount,
+             const arma::vec& chunkMean,
+             const arma::vec& chunkM2)
+  {
+    if (count == 0)
+    {
+      count = chunkCount;
+      mean = chunkMean;
+      m2 = chunkM2;
+      return;
+    }
+
+    CheckDimensionality(chunkMean.n_elem, "Update");
+    const double na = count;
+    const double nb = chunkCount;
+    const arma::vec delta = chunkMean - mean;
+    mean += delta * (nb / (na + nb));
+    m2 += chunkM2 + arma::square(delta) * (na * nb / (na + nb));
+    count += chunkCount;
+  }
+
+  //! Get the factor of each dimension (with zeros replaced by one).
+  arma::vec Scales() const
+  {
+    arma::vec scales = scale ? StandardDeviation() :
+        arma::vec(mean.n_elem, arma::fill::ones);
+    scales.elem(arma::find(scales == 0.0)).ones();
+    return scales;
+  }
+
+  //! Make sure the points have the dimensionality of the statistics.
+  void CheckDimensionality(const size_t dimensionality,
+                           const std::string& method) const
+  {
+    if (dimensionality != mean.n_elem)
+    {
+      std::ostringstream oss;
+      oss << "StandardScaler::" << method << "(): the points have "
+          << dimensionality << " dimensions, but " << mean.n_elem
+          << " were fitted";
+      throw std::invalid_argument(oss.str());
+    }
+  }
+
+  //! Make sure that sparse points can be transformed.
+  void CheckSparse(const std::string& method) const
+  {
+    if (center)
+    {
+      throw std::invalid_argument("StandardScaler::" + method + "(): "
+          "centering would make a sparse matrix dense; use center = false");
+    }
+  }
+
+  //! Whether the means are subtracted.
+  bool center;
+
+  //! Whether the points are divided by the standard deviations.
+  bool scale;
+
+  //! The number of points the statistics were fitted to.
+  size_t count;
+
+  //! The mean of each dimension.
+  arma::vec mean;
+
+  //! The sum of the squared deviations from the mean of each dimension.
+  arma::vec m2;
+};
+
+} // namespace data
+} // namespace mlpack
+
+#endif
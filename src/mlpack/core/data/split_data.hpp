@@ -14,9 +14,89 @@
 #define MLPACK_CORE_DATA_SPLIT_DATA_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/core/math/random.hpp>
+#include "extension.hpp"
+#include "streaming_dataset.hpp"
 
 namespace mlpack {
 namespace data {
+
+/**
+ * Given the number of points of a dataset, split their indices into training
+ * and test indices, without touching the data.  The points are randomly
+ * ordered just as by the other overloads of Split() (for the same random seed,
+ * they give the points with these indices), and can be used without copies
+ * through views like input.cols(trainIndices).
+ *
+ * @code
+ * arma::mat input = loadData();
+ * arma::uvec trainIndices, testIndices;
+ * SplitIndices(input.n_cols, trainIndices, testIndices, 0.3);
+ * model.Train(input.cols(trainIndices));
+ * @endcode
+ *
+ * @param numPoints Number of points in the dataset.
+ * @param trainIndices Vector to store the indices of the training points into.
+ * @param testIndices Vector to store the indices of the test points into.
+ * @param testRatio Percentage of dataset to use for test set (between 0 and 1).
+ */
+inline void SplitIndices(const size_t numPoints,
+                         arma::uvec& trainIndices,
+                         arma::uvec& testIndices,
+                         const double testRatio)
+{
+  const size_t testSize = static_cast<size_t>(numPoints * testRatio);
+  const size_t trainSize = numPoints - testSize;
+
+  const arma::uvec order =
+      arma::shuffle(arma::linspace<arma::uvec>(0, numPoints - 1, numPoints));
+
+  trainIndices = order.head(trainSize);
+  testIndices = order.tail(testSize);
+}
+
+/**
+ * Given the labels of a dataset, split the indices of its points into training
+ * and test indices so that each label has the same proportion of its points in
+ * the test set: of the points with each label, testRatio of them (rounded
+ * down) are test points.  The points of all the labels are then randomly
+ * ordered.
+ *
+ * @param inputLabel Labels of the points.
+ * @param trainIndices Vector to store the indices of the training points into.
+ * @param testIndices Vector to store the indices of the test points into.
+ * @param testRatio Percentage of each label to use for test set (between 0 and
+ *     1).
+ */
+template<typename U>
+void StratifiedSplitIndices(const arma::Row<U>& inputLabel,
+                            arma::uvec& trainIndices,
+                            arma::uvec& testIndices,
+                            const double testRatio)
+{
+  // The points of each label are contiguous in this order.
+  const arma::uvec byLabel = arma::stable_sort_index(inputLabel);
+
+  std::vector<arma::uword> train, test;
+  for (size_t begin = 0; begin < byLabel.n_elem; )
+  {
+    size_t end = begin + 1;
+    while (end < byLabel.n_elem &&
+        inputLabel[byLabel[end]] == inputLabel[byLabel[begin]])
+      ++end;
+
+    const arma::uvec group = arma::shuffle(byLabel.subvec(begin, end - 1));
+    const size_t testSize = static_cast<size_t>(group.n_elem * testRatio);
+    test.insert(test.end(), group.begin(), group.begin() + testSize);
+    train.insert(train.end(), group.begin() + testSize, group.end());
+
+    begin = end;
+  }
+
+  trainIndices = arma::shuffle(arma::uvec(train));
+  testIndices = arma::shuffle(arma::uvec(test));
+}
+
 /**
  * Given an input dataset and labels, split into a training set and test set.
  * Example usage below.  This overload places the split dataset into the four
@@ -54,28 +134,45 @@ void Split(const arma::Mat<T>& input,
            arma::Row<U>& testLabel,
            const double testRatio)
 {
-  const size_t testSize = static_cast<size_t>(input.n_cols * testRatio);
-  const size_t trainSize = input.n_cols - testSize;
-  trainData.set_size(input.n_rows, trainSize);
-  testData.set_size(input.n_rows, testSize);
-  trainLabel.set_size(trainSize);
-  testLabel.set_size(testSize);
-
-  const arma::Col<size_t> order =
-      arma::shuffle(arma::linspace<arma::Col<size_t>>(0, input.n_cols - 1,
-                                                      input.n_cols));
-
-  for (size_t i = 0; i != trainSize; ++i)
-  {
-    trainData.col(i) = input.col(order[i]);
-    trainLabel(i) = inputLabel(order[i]);
-  }
+  arma::uvec trainIndices, testIndices;
+  SplitIndices(input.n_cols, trainIndices, testIndices, testRatio);
 
-  for (size_t i = 0; i != testSize; ++i)
-  {
-    testData.col(i) = input.col(order[i + trainSize]);
-    testLabel(i) = inputLabel(order[i + trainSize]);
-  }
+  trainData = input.cols(trainIndices);
+  testData = input.cols(testIndices);
+  trainLabel = inputLabel.cols(trainIndices);
+  testLabel = inputLabel.cols(testIndices);
+}
+
+/**
+ * Given an input dataset and labels, split into a training set and test set so
+ * that each label has the same proportion of its points in the test set (see
+ * StratifiedSplitIndices()).  This is useful when some labels are rare.
+ *
+ * @param input Input dataset to split.
+ * @param label Input labels to split.
+ * @param trainData Matrix to store training data into.
+ * @param testData Matrix to store test data into.
+ * @param trainLabel Vector to store training labels into.
+ * @param testLabel Vector to store test labels into.
+ * @param testRatio Percentage of each label to use for test set (between 0 and
+ *     1).
+ */
+template<typename T, typename U>
+void StratifiedSplit(const arma::Mat<T>& input,
+                     const arma::Row<U>& inputLabel,
+                     arma::Mat<T>& trainData,
+                     arma::Mat<T>& testData,
+                     arma::Row<U>& trainLabel,
+                     arma::Row<U>& testLabel,
+                     const double testRatio)
+{
+  arma::uvec trainIndices, testIndices;
+  StratifiedSplitIndices(inputLabel, trainIndices, testIndices, testRatio);
+
+  trainData = input.cols(trainIndices);
+  testData = input.cols(testIndices);
+  trainLabel = inputLabel.cols(trainIndices);
+  testLabel = inputLabel.cols(testIndices);
 }
 
 /**
@@ -105,22 +202,104 @@ void Split(const arma::Mat<T>& input,
            arma::Mat<T>& testData,
            const double testRatio)
 {
-  const size_t testSize = static_cast<size_t>(input.n_cols * testRatio);
-  const size_t trainSize = input.n_cols - testSize;
-  trainData.set_size(input.n_rows, trainSize);
-  testData.set_size(input.n_rows, testSize);
+  arma::uvec trainIndices, testIndices;
+  SplitIndices(input.n_cols, trainIndices, testIndices, testRatio);
 
-  const arma::Col<size_t> order =
-      arma::shuffle(arma::linspace<arma::Col<size_t>>(0, input.n_cols -1,
-                                                      input.n_cols));
+  trainData = input.cols(trainIndices);
+  testData = input.cols(testIndices);
+}
 
-  for (size_t i = 0; i != trainSize; ++i)
+/**
+ * Split a dataset that is read a chunk of points at a time from a file (see
+ * StreamingDataset) into a training set and a test set, which are written to
+ * the given text files (csv, tsv or txt, with one point per line, like
+ * data::Save() with transpose = true), so the dataset never has to fit in
+ * memory.  The test set has as many points as with the other overloads, chosen
+ * uniformly at random by selection sampling, but the points are not reordered:
+ * they are written in the order of the input file.  If the last dimension of
+ * the points holds their labels, it is written with them.
+ *
+ * @code
+ * data::StreamingDataset<> input("huge.csv");
+ * Split(input, "huge_train.csv", "huge_test.csv", 0.2);
+ * @endcode
+ *
+ * @param input Dataset to split; it is read from its first point.
+ * @param trainFile Name of the file to write the training points to.
+ * @param testFile Name of the file to write the test points to.
+ * @param testRatio Percentage of dataset to use for test set (between 0 and 1).
+ */
+template<typename T>
+void Split(StreamingDataset<T>& input,
+           const std::string& trainFile,
+           const std::string& testFile,
+           const double testRatio)
+{
+  const size_t numPoints = input.NumPoints();
+  const size_t testSize = static_cast<size_t>(numPoints * testRatio);
+
+  // Open the output files, with the separator their type calls for.
+  std::ofstream streams[2];
+  char separators[2];
+  const std::string filenames[2] = { trainFile, testFile };
+  for (size_t i = 0; i < 2; ++i)
+  {
+    const std::string extension = Extension(filenames[i]);
+    if (extension != "csv" && extension != "tsv" && extension != "txt")
+    {
+      std::ostringstream oss;
+      oss << "Split(): unknown type of file '" << filenames[i] << "'; only "
+          << "csv, tsv and txt files can be written a chunk at a time.";
+      throw std::runtime_error(oss.str());
+    }
+
+    streams[i].open(filenames[i].c_str());
+    if (!streams[i].is_open())
+    {
+      std::ostringstream oss;
+      oss << "Split(): cannot open file '" << filenames[i] << "'.";
+      throw std::runtime_error(oss.str());
+    }
+
+    streams[i].precision(std::numeric_limits<T>::max_digits10);
+    separators[i] = (extension == "csv") ? ',' :
+        (extension == "tsv") ? '\t' : ' ';
+  }
+
+  input.Reset();
+  size_t pointsSeen = 0;
+  size_t testPoints = 0;
+  arma::Mat<T> chunk;
+  while (input.Next(chunk))
   {
-    trainData.col(i) = input.col(order[i]);
+    for (size_t i = 0; i < chunk.n_cols; ++i, ++pointsSeen)
+    {
+      // Selection sampling: each remaining point is a test point with the
+      // probability that makes all the test sets of testSize points equally
+      // likely.
+      const size_t out = (math::Random() * (numPoints - pointsSeen) <
+          testSize - testPoints) ? 1 : 0;
+      testPoints += out;
+
+      for (size_t d = 0; d < chunk.n_rows; ++d)
+      {
+        if (d > 0)
+          streams[out] << separators[out];
+        streams[out] << chunk(d, i);
+      }
+      streams[out] << '\n';
+    }
   }
-  for (size_t i = 0; i != testSize; ++i)
+
+  for (size_t i = 0; i < 2; ++i)
   {
-    testData.col(i) = input.col(order[i + trainSize]);
+    streams[i].close();
+    if (streams[i].fail())
+    {
+      std::ostringstream oss;
+      oss << "Split(): error writing to file '" << filenames[i] << "'.";
+      throw std::runtime_error(oss.str());
+    }
   }
 }
 
@@ -163,6 +342,39 @@ Split(const arma::Mat<T>& input,
                          std::move(testLabel));
 }
 
+/**
+ * Given an input dataset and labels, split into a training set and test set so
+ * that each label has the same proportion of its points in the test set (see
+ * StratifiedSplitIndices()).  This overload returns the split dataset as a
+ * std::tuple, like the corresponding overload of Split().
+ *
+ * @param input Input dataset to split.
+ * @param label Input labels to split.
+ * @param testRatio Percentage of each label to use for test set (between 0 and
+ *     1).
+ * @return std::tuple containing trainData (arma::Mat<T>), testData
+ *      (arma::Mat<T>), trainLabel (arma::Row<U>), and testLabel (arma::Row<U>).
+ */
+template<typename T, typename U>
+std::tuple<arma::Mat<T>, arma::Mat<T>, arma::Row<U>, arma::Row<U>>
+StratifiedSplit(const arma::Mat<T>& input,
+                const arma::Row<U>& inputLabel,
+                const double testRatio)
+{
+  arma::Mat<T> trainData;
+  arma::Mat<T> testData;
+  arma::Row<U> trainLabel;
+  arma::Row<U> testLabel;
+
+  StratifiedSplit(input, inputLabel, trainData, testData, trainLabel,
+      testLabel, testRatio);
+
+  return std::make_tuple(std::move(trainData),
+                         std::move(testData),
+                         std::move(trainLabel),
+                         std::move(testLabel));
+}
+
 /**
  * Given an input dataset, split into a training set and test set.
  * Example usage below.  This overload returns the split dataset as a std::tuple
@@ -0,0 +1,171 @@
+/**
+ * @file streaming_dataset.hpp
+ *
+ * Definition of the StreamingDataset class, which reads a dataset from disk in
+ * chunks of points, so that datasets that don't fit in memory can be used for
+ * training.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_STREAMING_DATASET_HPP
+#define MLPACK_CORE_DATA_STREAMING_DATASET_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include <fstream>
+#include <future>
+#include <iomanip>
+
+namespace mlpack {
+namespace data /** Functions to load and save matrices and models. */ {
+
+/**
+ * The StreamingDataset class reads a dataset from disk a chunk of points at a
+ * time, instead of loading the whole dataset into memory.  The chunks are
+ * returned in file order by Next(); after the last chunk, Next() returns false,
+ * and Reset() may be called to start another pass over the data.
+ *
+ * If prefetching is enabled (the default), the next chunk is read by a
+ * background thread while the current chunk is used, so reading from disk
+ * overlaps with computation.
+ *
+ * The following file types are supported (the type is detected from the
+ * extension):
+ *
+ *  - csv, tsv, txt: numeric text, with one point on each line (just like
+ *    data::Load() with transpose = true).  Categorical values are not
+ *    supported.
+ *  - bin: Armadillo binary files (arma_binary), with one point in each column
+ *    (as saved by data::Save() with transpose = false).  The element type of
+ *    the file must be eT.  The columns are read straight into the chunk.
+ *
+ * For labeled datasets, the labels can be stored as the last dimension of each
+ * point and split off with Next(points, labels).  To use a StreamingDataset
+ * for training with SGD, see optimization::StreamingFunction.
+ *
+ * @code
+ * data::StreamingDataset<> dataset("clicks.bin", 50000);
+ * arma::mat points;
+ * arma::Row<size_t> labels;
+ * while (dataset.Next(points, labels))
+ * {
+ *   // Use the chunk...
+ * }
+ * @endcode
+ *
+ * @tparam eT Element type of the points.
+ */
+template<typename eT = double>
+class StreamingDataset
+{
+ public:
+  /**
+   * Open the given file for streaming.  The dimensionality and number of
+   * points are found right away (for text files, this means the lines are
+   * counted).  If the file can't be opened or has an unknown type,
+   * std::runtime_error is thrown.
+   *
+   * @param filename Name of the file to read.
+   * @param chunkSize Maximum number of points in each chunk.
+   * @param prefetch Whether to read the next chunk in a background thread.
+   */
+  StreamingDataset(const std::string& filename,
+                   const size_t chunkSize = 10000,
+                   const bool prefetch = true);
+
+  /**
+   * Wait for the background read (if any) to finish.
+   */
+  ~StreamingDataset();
+
+  /**
+   * Read the next chunk of points into the given matrix, which will have
+   * Dimensionality() rows and at most ChunkSize() columns.  If all the points
+   * have already been read, false is returned and the matrix is left empty.
+   * Errors in the file cause std::runtime_error to be thrown.
+   *
+   * @param points Matrix to store the chunk in.
+   */
+  bool Next(arma::Mat<eT>& points);
+
+  /**
+   * Read the next chunk of points, splitting the last dimension off as labels.
+   * The points matrix will have Dimensionality() - 1 rows.
+   *
+   * @param points Matrix to store the chunk in.
+   * @param labels Row vector to store the labels of the chunk in.
+   */
+  bool Next(arma::Mat<eT>& points, arma::Row<size_t>& labels);
+
+  /**
+   * Restart from the first point of the dataset.
+   */
+  void Reset();
+
+  //! Get the number of dimensions of each point (including any labels).
+  size_t Dimensionality() const { return dimensionality; }
+  //! Get the number of points in the dataset.
+  size_t NumPoints() const { return numPoints; }
+  //! Get the maximum number of points in each chunk.
+  size_t ChunkSize() const { return chunkSize; }
+
+ private:
+  //! Read the header of an Armadillo binary file.
+  void ReadBinaryHeader();
+
+  //! Find the dimensionality and number of points of a text file.
+  void ReadTextHeader();
+
+  /**
+   * Read the chunk that starts at the current position.  This is called from
+   * the prefetching thread, so it may only use the stream and the current
+   * position.
+   */
+  arma::Mat<eT> ReadChunk();
+
+  /**
+   * Parse one line of a text file into the given array, and return the number
+   * of values on the line.  At most maxValues values are stored.
+   */
+  static size_t ParseLine(const std::string& line,
+                          eT* values,
+                          const size_t maxValues);
+
+  //! Start reading the next chunk in the background.
+  void StartPrefetch();
+
+  //! Name of the file.
+  std::string filename;
+  //! Maximum number of points in a chunk.
+  size_t chunkSize;
+  //! Whether to read chunks in the background.
+  bool prefetch;
+  //! Whether the file is an Armadillo binary file (otherwise, it is text).
+  bool binary;
+
+  //! The open file.
+  std::ifstream stream;
+  //! Position of the first point in the file.
+  std::streampos dataBegin;
+  //! Number of points that have been read from the stream.
+  size_t pointsRead;
+
+  //! Dimensionality of the points.
+  size_t dimensionality;
+  //! Number of points in the file.
+  size_t numPoints;
+
+  //! The chunk being read in the background.
+  std::future<arma::Mat<eT>> nextChunk;
+};
+
+} // namespace data
+} // namespace mlpack
+
+// Include implementation.
+#include "streaming_dataset_impl.hpp"
+
+#endif
@@ -0,0 +1,277 @@
+/**
+ * @file streaming_dataset_impl.hpp
+ *
+ * Implementation of the StreamingDataset class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_STREAMING_DATASET_IMPL_HPP
+#define MLPACK_CORE_DATA_STREAMING_DATASET_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "streaming_dataset.hpp"
+#include "extension.hpp"
+
+namespace mlpack {
+namespace data {
+
+template<typename eT>
+StreamingDataset<eT>::StreamingDataset(const std::string& filename,
+                                       const size_t chunkSize,
+                                       const bool prefetch) :
+    filename(filename),
+    chunkSize(chunkSize),
+    prefetch(prefetch),
+    binary(false),
+    pointsRead(0),
+    dimensionality(0),
+    numPoints(0)
+{
+  if (chunkSize == 0)
+  {
+    throw std::invalid_argument("StreamingDataset::StreamingDataset(): "
+        "chunkSize must be positive!");
+  }
+
+  const std::string extension = Extension(filename);
+  if (extension == "bin")
+  {
+    binary = true;
+  }
+  else if (extension != "csv" && extension != "tsv" && extension != "txt")
+  {
+    std::ostringstream oss;
+    oss << "StreamingDataset::StreamingDataset(): unknown type of file '"
+        << filename << "'; only csv, tsv, txt and bin (Armadillo binary) "
+        << "files can be streamed.";
+    throw std::runtime_error(oss.str());
+  }
+
+  stream.open(filename.c_str(), binary ? std::ios::in | std::ios::binary :
+      std::ios::in);
+  if (!stream.is_open())
+  {
+    std::ostringstream oss;
+    oss << "StreamingDataset::StreamingDataset(): cannot open file '"
+        << filename << "'.";
+    throw std::runtime_error(oss.str());
+  }
+
+  if (binary)
+    ReadBinaryHeader();
+  else
+    ReadTextHeader();
+
+  dataBegin = stream.tellg();
+}
+
+template<typename eT>
+StreamingDataset<eT>::~StreamingDataset()
+{
+  if (nextChunk.valid())
+    nextChunk.wait();
+}
+
+template<typename eT>
+bool StreamingDataset<eT>::Next(arma::Mat<eT>& points)
+{
+  if (prefetch)
+  {
+    if (!nextChunk.valid())
+      StartPrefetch();
+    points = nextChunk.get();
+  }
+  else
+  {
+    points = ReadChunk();
+  }
+
+  if (points.n_cols == 0)
+    return false;
+
+  // Read the following chunk while this one is used.
+  if (prefetch)
+    StartPrefetch();
+
+  return true;
+}
+
+template<typename eT>
+bool StreamingDataset<eT>::Next(arma::Mat<eT>& points,
+                                arma::Row<size_t>& labels)
+{
+  if (dimensionality == 0)
+  {
+    throw std::invalid_argument("StreamingDataset::Next(): cannot split "
+        "labels off of a dataset with no dimensions!");
+  }
+
+  arma::Mat<eT> chunk;
+  if (!Next(chunk))
+  {
+    points.reset();
+    labels.reset();
+    return false;
+  }
+
+  labels = arma::conv_to<arma::Row<size_t>>::from(chunk.row(dimensionality -
+      1));
+  chunk.shed_row(dimensionality - 1);
+  points = std::move(chunk);
+  return true;
+}
+
+template<typename eT>
+void StreamingDataset<eT>::Reset()
+{
+  // Throw away the chunk being read, if there is one.
+  if (nextChunk.valid())
+  {
+    nextChunk.wait();
+    nextChunk = std::future<arma::Mat<eT>>();
+  }
+
+  stream.clear();
+  stream.seekg(dataBegin);
+  pointsRead = 0;
+}
+
+template<typename eT>
+void StreamingDataset<eT>::ReadBinaryHeader()
+{
+  // Armadillo binary files start with a line describing the element type,
+  // followed by a line with the number of rows and columns.
+  std::ostringstream expected;
+  expected << "ARMA_MAT_BIN_";
+  if (std::is_floating_point<eT>::value)
+    expected << "FN";
+  else
+    expected << "I" << (std::is_signed<eT>::value ? "S" : "U");
+  expected << std::setw(3) << std::setfill('0') << sizeof(eT);
+
+  std::string header;
+  size_t cols = 0;
+  stream >> header >> dimensionality >> cols;
+  if (stream.fail() || header != expected.str())
+  {
+    std::ostringstream oss;
+    oss << "StreamingDataset::StreamingDataset(): '" << filename << "' is "
+        << "not an Armadillo binary file with the right element type (expected"
+        << " header " << expected.str() << ", got '" << header << "').";
+    throw std::runtime_error(oss.str());
+  }
+
+  numPoints = cols;
+
+  // Skip the newline after the header.
+  stream.get();
+}
+
+template<typename eT>
+void StreamingDataset<eT>::ReadTextHeader()
+{
+  // Every line is a point.
+  std::string line;
+  while (std::getline(stream, line))
+  {
+    if (numPoints == 0)
+      dimensionality = ParseLine(line, NULL, 0);
+    ++numPoints;
+  }
+
+  stream.clear();
+  stream.seekg(0, std::ios::beg);
+}
+
+template<typename eT>
+arma::Mat<eT> StreamingDataset<eT>::ReadChunk()
+{
+  const size_t count = std::min(chunkSize, numPoints - pointsRead);
+  arma::Mat<eT> chunk(dimensionality, count);
+
+  if (binary)
+  {
+    stream.read((char*) chunk.memptr(), chunk.n_elem * sizeof(eT));
+    if (!stream)
+    {
+      std::ostringstream oss;
+      oss << "StreamingDataset::Next(): error reading points " << pointsRead
+          << " to " << (pointsRead + count - 1) << " of '" << filename << "'.";
+      throw std::runtime_error(oss.str());
+    }
+  }
+  else
+  {
+    std::string line;
+    for (size_t i = 0; i < count; ++i)
+    {
+      std::getline(stream, line);
+      const size_t lineDims = ParseLine(line, chunk.colptr(i),
+          dimensionality);
+      if (!stream || lineDims != dimensionality)
+      {
+        std::ostringstream oss;
+        oss << "StreamingDataset::Next(): wrong number of dimensions ("
+            << lineDims << ") on line " << (pointsRead + i) << " of '"
+            << filename << "'; should be " << dimensionality << " dimensions.";
+        throw std::runtime_error(oss.str());
+      }
+    }
+  }
+
+  pointsRead += count;
+  return chunk;
+}
+
+template<typename eT>
+size_t StreamingDataset<eT>::ParseLine(const std::string& line,
+                                       eT* values,
+                                       const size_t maxValues)
+{
+  // Values are separated by commas, tabs, or spaces.
+  size_t numValues = 0;
+  const char* pos = line.c_str();
+  while (true)
+  {
+    while (*pos == ' ' || *pos == '\t' || *pos == '\r')
+      ++pos;
+    if (*pos == '\0')
+      break;
+
+    char* end;
+    const double value = std::strtod(pos, &end);
+    if (end == pos)
+    {
+      std::ostringstream oss;
+      oss << "StreamingDataset::Next(): cannot parse '" << line << "'; only "
+          << "numeric values can be streamed.";
+      throw std::runtime_error(oss.str());
+    }
+
+    if (numValues < maxValues)
+      values[numValues] = eT(value);
+    ++numValues;
+
+    pos = end;
+    while (*pos == ' ' || *pos == '\t' || *pos == '\r')
+      ++pos;
+    if (*pos == ',')
+      ++pos;
+  }
+
+  return numValues;
+}
+
+template<typename eT>
+void StreamingDataset<eT>::StartPrefetch()
+{
+  nextChunk = std::async(std::launch::async, [this]() { return ReadChunk(); });
+}
+
+} // namespace data
+} // namespace mlpack
+
+#endif
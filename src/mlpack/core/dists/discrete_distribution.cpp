@@ -157,3 +157,24 @@ void DiscreteDistribution::Train(const arma::mat& observations,
       probabilities[i].fill(1.0 / probabilities[i].n_elem);
   }
 }
+
+/**
+ * Take one step of stepwise EM towards the given weighted observations.
+ */
+void DiscreteDistribution::Update(const arma::mat& observations,
+                                  const arma::vec& probObs,
+                                  const double stepSize)
+{
+  if (stepSize <= 0.0 || arma::accu(probObs) == 0.0)
+    return;
+
+  // Estimate the probabilities of the batch (this checks the observations).
+  DiscreteDistribution batch(*this);
+  batch.Train(observations, probObs);
+
+  for (size_t i = 0; i < probabilities.size(); ++i)
+  {
+    probabilities[i] = (1.0 - stepSize) * probabilities[i] +
+        stepSize * batch.probabilities[i];
+  }
+}
@@ -198,6 +198,21 @@ class DiscreteDistribution
   void Train(const arma::mat& observations,
              const arma::vec& probabilities);
 
+  /**
+   * Take one step of stepwise (online) EM towards the given weighted
+   * observations: the probabilities of the distribution are replaced by
+   * (1 - stepSize) times their current value plus stepSize times their
+   * estimate from the observations.  A stepSize of 1 is the same as Train().
+   *
+   * @param observations Batch of observations.
+   * @param probabilities List of probabilities that each observation is
+   *    actually from this distribution.
+   * @param stepSize Weight of the batch, in (0, 1].
+   */
+  void Update(const arma::mat& observations,
+              const arma::vec& probabilities,
+              const double stepSize);
+
   //! Return the vector of probabilities for the given dimension.
   arma::vec& Probabilities(const size_t dim = 0) { return probabilities[dim]; }
   //! Modify the vector of probabilities for the given dimension.
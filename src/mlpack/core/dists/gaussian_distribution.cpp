@@ -11,6 +11,7 @@
  * http://www.opensource.org/licenses/BSD-3-Clause for more information.
  */
 #include "gaussian_distribution.hpp"
+#include <mlpack/core/math/lin_alg.hpp>
 #include <mlpack/methods/gmm/positive_definite_constraint.hpp>
 
 using namespace mlpack;
@@ -78,6 +79,12 @@ arma::vec GaussianDistribution::Random() const
   return covLower * arma::randn<arma::vec>(mean.n_elem) + mean;
 }
 
+void GaussianDistribution::Random(const size_t n, arma::mat& samples) const
+{
+  samples = covLower * arma::randn<arma::mat>(mean.n_elem, n);
+  samples.each_col() += mean;
+}
+
 /**
  * Estimate the Gaussian distribution directly from the given observations.
  *
@@ -98,23 +105,14 @@ void GaussianDistribution::Train(const arma::mat& observations)
     return;
   }
 
-  // Calculate the mean.
-  for (size_t i = 0; i < observations.n_cols; i++)
-    mean += observations.col(i);
-
-  // Normalize the mean.
-  mean /= observations.n_cols;
-
-  // Now calculate the covariance.
-  for (size_t i = 0; i < observations.n_cols; i++)
-  {
-    arma::vec obsNoMean = observations.col(i) - mean;
-    covariance += obsNoMean * trans(obsNoMean);
-  }
+  // Calculate the mean and the covariance in parallel, a block of points at a
+  // time.
+  math::WeightedCovariance(observations, arma::ones<arma::vec>(
+      observations.n_cols), mean, covariance);
 
-  // Finish estimating the covariance by normalizing, with the (1 / (n - 1)) so
+  // Finish estimating the covariance with the (1 / (n - 1)) normalization, so
   // that it is the unbiased estimator.
-  covariance /= (observations.n_cols - 1);
+  covariance *= double(observations.n_cols) / (observations.n_cols - 1);
 
   // Ensure that the covariance is positive definite.
   gmm::PositiveDefiniteConstraint::ApplyConstraint(covariance);
@@ -143,15 +141,12 @@ void GaussianDistribution::Train(const arma::mat& observations,
     return;
   }
 
-  double sumProb = 0;
-
-  // First calculate the mean, and save the sum of all the probabilities for
-  // later normalization.
-  for (size_t i = 0; i < observations.n_cols; i++)
-  {
-    mean += probabilities[i] * observations.col(i);
-    sumProb += probabilities[i];
-  }
+  // Find the weighted mean and covariance in parallel, a block of points at a
+  // time, and the sum of all the probabilities.  The covariance is normalized
+  // by the sum of the probabilities; this is probably biased, but I don't know
+  // how to unbias it.
+  const double sumProb = math::WeightedCovariance(observations, probabilities,
+      mean, covariance);
 
   if (sumProb == 0)
   {
@@ -162,23 +157,34 @@ void GaussianDistribution::Train(const arma::mat& observations,
     return;
   }
 
-  // Normalize.
-  if (sumProb > 0)
-    mean /= sumProb;
-
-  // Now find the covariance.
-  for (size_t i = 0; i < observations.n_cols; i++)
-  {
-    arma::vec obsNoMean = observations.col(i) - mean;
-    covariance += probabilities[i] * (obsNoMean * trans(obsNoMean));
-  }
-
-  // This is probably biased, but I don't know how to unbias it.
-  if (sumProb > 0)
-    covariance /= sumProb;
-
   // Ensure that the covariance is positive definite.
   gmm::PositiveDefiniteConstraint::ApplyConstraint(covariance);
 
   FactorCovariance();
 }
+
+/**
+ * Take one step of stepwise EM towards the given weighted observations.
+ */
+void GaussianDistribution::Update(const arma::mat& observations,
+                                  const arma::vec& probabilities,
+                                  const double stepSize)
+{
+  if (stepSize <= 0.0 || arma::accu(probabilities) == 0.0)
+    return;
+
+  // Find the mean and the covariance of the batch.
+  GaussianDistribution batch;
+  batch.Train(observations, probabilities);
+
+  // Interpolate the means, and the second moments around the new mean.
+  const arma::vec newMean = (1.0 - stepSize) * mean + stepSize * batch.mean;
+  const arma::vec oldShift = mean - newMean;
+  const arma::vec batchShift = batch.mean - newMean;
+  arma::mat newCovariance = (1.0 - stepSize) * (covariance + oldShift *
+      oldShift.t()) + stepSize * (batch.covariance + batchShift *
+      batchShift.t());
+
+  mean = newMean;
+  Covariance(std::move(newCovariance));
+}
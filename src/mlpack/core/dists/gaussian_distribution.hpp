@@ -105,6 +105,16 @@ class GaussianDistribution
    */
   arma::vec Random() const;
 
+  /**
+   * Generate the given number of random observations at once, as the columns of
+   * the given matrix.  All the standard normal draws are made together and
+   * transformed with one matrix multiplication.
+   *
+   * @param n Number of observations to generate.
+   * @param samples Matrix to store the observations in.
+   */
+  void Random(const size_t n, arma::mat& samples) const;
+
   /**
    * Estimate the Gaussian distribution directly from the given observations.
    *
@@ -120,6 +130,21 @@ class GaussianDistribution
   void Train(const arma::mat& observations,
              const arma::vec& probabilities);
 
+  /**
+   * Take one step of stepwise (online) EM towards the given weighted
+   * observations: the mean and the second moment of the distribution are
+   * replaced by (1 - stepSize) times their current value plus stepSize times
+   * their value for the observations.  A stepSize of 1 is the same as Train().
+   *
+   * @param observations Batch of observations.
+   * @param probabilities Probability that each observation is actually from
+   *     this distribution.
+   * @param stepSize Weight of the batch, in (0, 1].
+   */
+  void Update(const arma::mat& observations,
+              const arma::vec& probabilities,
+              const double stepSize);
+
   /**
    * Return the mean.
    */
@@ -177,20 +202,40 @@ inline void GaussianDistribution::LogProbability(
     arma::vec& logProbabilities) const
 {
   // Column i of 'diffs' is the difference between x.col(i) and the mean.
-  arma::mat diffs = x - (mean * arma::ones<arma::rowvec>(x.n_cols));
-
-  // Now, we only want to calculate the diagonal elements of (diffs' * cov^-1 *
-  // diffs).  We just don't need any of the other elements.  We can calculate
-  // the right hand part of the equation (instead of the left side) so that
-  // later we are referencing columns, not rows -- that is faster.
-  const arma::mat rhs = -0.5 * invCov * diffs;
-  arma::vec logExponents(diffs.n_cols); // We will now fill this.
-  for (size_t i = 0; i < diffs.n_cols; i++)
-    logExponents(i) = accu(diffs.unsafe_col(i) % rhs.unsafe_col(i));
+  arma::mat diffs = x;
+  diffs.each_col() -= mean;
+
+  // We only want the diagonal elements of (diffs' * cov^-1 * diffs).  If the
+  // covariance is diagonal (as with the DiagonalConstraint), these are a
+  // weighted sum of the squared differences, which is one matrix-vector
+  // product.
+  bool diagonal = true;
+  for (size_t j = 0; j < covLower.n_cols && diagonal; ++j)
+    for (size_t i = j + 1; i < covLower.n_rows; ++i)
+      if (covLower(i, j) != 0.0)
+      {
+        diagonal = false;
+        break;
+      }
+
+  arma::rowvec mahalanobis;
+  if (diagonal)
+  {
+    mahalanobis = trans(invCov.diag()) * arma::square(diffs);
+  }
+  else
+  {
+    // Otherwise, cov^-1 = L^-T L^-1, so one triangular solve for all the
+    // observations gives L^-1 diffs, whose squared column norms are the
+    // elements we need.
+    mahalanobis = arma::sum(arma::square(
+        arma::solve(arma::trimatl(covLower), diffs)), 0);
+  }
 
   const size_t k = x.n_rows;
 
-  logProbabilities = -0.5 * k * log2pi - 0.5 * logDetCov + logExponents;
+  logProbabilities = (-0.5 * k * log2pi - 0.5 * logDetCov) -
+      0.5 * trans(mahalanobis);
 }
 
 
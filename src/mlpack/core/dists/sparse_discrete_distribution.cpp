@@ -0,0 +1,175 @@
+/**
+ * @file sparse_discrete_distribution.cpp
+ *
+ * Implementation of SparseDiscreteDistribution.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "sparse_discrete_distribution.hpp"
+
+#include <mlpack/core/math/random.hpp>
+#include <unordered_map>
+
+using namespace mlpack;
+using namespace mlpack::distribution;
+
+/**
+ * Compute the log probabilities of all the given observations at once.
+ */
+void SparseDiscreteDistribution::LogProbability(
+    const arma::mat& observations,
+    arma::vec& logProbabilities) const
+{
+  logProbabilities.set_size(observations.n_cols);
+  for (size_t i = 0; i < observations.n_cols; ++i)
+  {
+    logProbabilities[i] = std::log(IndexProbability(
+        Index(observations(0, i))));
+  }
+}
+
+/**
+ * Return a randomly generated observation according to the distribution.
+ */
+arma::vec SparseDiscreteDistribution::Random() const
+{
+  arma::vec result(1);
+
+  // The smoothing is a uniform distribution mixed in.
+  if (probabilities.n_nonzero == 0 || math::Random() < smoothing)
+  {
+    result[0] = math::RandInt(numObservations);
+    return result;
+  }
+
+  const double randObs = math::Random();
+  double sumProb = 0;
+  for (arma::sp_vec::const_iterator it = probabilities.begin();
+       it != probabilities.end(); ++it)
+  {
+    result[0] = it.row();
+    if ((sumProb += (*it)) >= randObs)
+      break;
+  }
+
+  return result;
+}
+
+/**
+ * Estimate the distribution directly from the given observations.
+ */
+void SparseDiscreteDistribution::Train(const arma::mat& observations)
+{
+  Train(observations, arma::ones<arma::vec>(observations.n_cols));
+}
+
+/**
+ * Estimate the distribution from the given observations when also given
+ * probabilities that each observation is from this distribution.
+ */
+void SparseDiscreteDistribution::Train(const arma::mat& observations,
+                                       const arma::vec& probObs)
+{
+  if (observations.n_rows != 1)
+  {
+    throw std::invalid_argument("observations must be one-dimensional for the "
+        "SparseDiscreteDistribution object");
+  }
+
+  // Sum the weight of each distinct observation.
+  std::unordered_map<size_t, double> totals;
+  for (size_t r = 0; r < observations.n_cols; ++r)
+  {
+    // The addition of 0.5 to the observation is to turn the default flooring
+    // operation of the size_t cast into a rounding observation.
+    const size_t obs = size_t(observations(0, r) + 0.5);
+    if (obs >= numObservations)
+    {
+      std::ostringstream oss;
+      oss << "observation " << r << " (" << observations(0, r) << ") is "
+          << "invalid; must be in [0, " << numObservations << ") for this "
+          << "distribution";
+      throw std::invalid_argument(oss.str());
+    }
+
+    totals[obs] += probObs[r];
+  }
+
+  std::vector<std::pair<size_t, double>> weights(totals.begin(),
+      totals.end());
+  SetProbabilities(weights);
+}
+
+/**
+ * Take one step of stepwise EM towards the given weighted observations.
+ */
+void SparseDiscreteDistribution::Update(const arma::mat& observations,
+                                        const arma::vec& probObs,
+                                        const double stepSize)
+{
+  if (stepSize <= 0.0 || arma::accu(probObs) == 0.0)
+    return;
+
+  // Estimate the probabilities of the batch (this checks the observations).
+  SparseDiscreteDistribution batch(*this);
+  batch.Train(observations, probObs);
+
+  std::unordered_map<size_t, double> totals;
+  for (arma::sp_vec::const_iterator it = probabilities.begin();
+       it != probabilities.end(); ++it)
+    totals[it.row()] += (1.0 - stepSize) * (*it);
+  for (arma::sp_vec::const_iterator it = batch.probabilities.begin();
+       it != batch.probabilities.end(); ++it)
+    totals[it.row()] += stepSize * (*it);
+
+  std::vector<std::pair<size_t, double>> weights(totals.begin(),
+      totals.end());
+  SetProbabilities(weights);
+}
+
+/**
+ * Set the estimated probabilities from the given weight of each observation,
+ * keeping only the maxEntries largest.
+ */
+void SparseDiscreteDistribution::SetProbabilities(
+    std::vector<std::pair<size_t, double>>& weights)
+{
+  typedef std::pair<size_t, double> Entry;
+
+  // Keep only the most likely observations, if asked to.
+  if (maxEntries > 0 && weights.size() > maxEntries)
+  {
+    std::nth_element(weights.begin(), weights.begin() + maxEntries,
+        weights.end(), [](const Entry& a, const Entry& b)
+        { return a.second > b.second; });
+    weights.resize(maxEntries);
+  }
+
+  // The sparse vector is built from its entries in order.
+  std::sort(weights.begin(), weights.end());
+  double sum = 0.0;
+  size_t nonzero = 0;
+  for (size_t i = 0; i < weights.size(); ++i)
+  {
+    if (weights[i].second > 0.0)
+    {
+      sum += weights[i].second;
+      weights[nonzero++] = weights[i];
+    }
+  }
+
+  arma::umat locations(2, nonzero);
+  arma::vec values(nonzero);
+  for (size_t i = 0; i < nonzero; ++i)
+  {
+    locations(0, i) = weights[i].first;
+    locations(1, i) = 0;
+    values[i] = weights[i].second / sum;
+  }
+
+  // With no weight at all, all the observations become equally likely.
+  probabilities = arma::sp_mat(locations, values, numObservations, 1);
+}
@@ -0,0 +1,215 @@
+/**
+ * @file sparse_discrete_distribution.hpp
+ *
+ * Implementation of a discrete distribution over a large number of possible
+ * observations, which only stores the probabilities of the observations that
+ * were seen.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DISTRIBUTIONS_SPARSE_DISCRETE_DISTRIBUTION_HPP
+#define MLPACK_CORE_DISTRIBUTIONS_SPARSE_DISCRETE_DISTRIBUTION_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace distribution {
+
+/**
+ * A one-dimensional discrete distribution for a large number of possible
+ * observations (such as the words of a vocabulary), of which only a few have a
+ * noticeable probability.  Only the estimated probabilities of the
+ * observations seen in training are stored, in a sparse vector, and a small
+ * share of the probability (the smoothing) is spread evenly over all the
+ * possible observations:
+ *
+ *   P(o) = (1 - smoothing) * estimate(o) + smoothing / numObservations.
+ *
+ * The memory used is proportional to the number of distinct observations seen,
+ * not to the number of possible observations, and it can be bounded further
+ * by keeping only the maxEntries most likely observations.  This can be used
+ * as the emission distribution of a discrete HMM; HMM uses the batch
+ * LogProbability() to compute the emission probabilities of a whole sequence
+ * at once.
+ *
+ * As with DiscreteDistribution, observations are stored in an arma::vec (or
+ * the rows of an arma::mat) and rounded to the nearest size_t.
+ */
+class SparseDiscreteDistribution
+{
+ public:
+  /**
+   * Create the distribution with the given number of possible observations,
+   * with all of them equally likely.
+   *
+   * @param numObservations Number of possible observations.
+   * @param smoothing Share of the probability spread evenly over all the
+   *     possible observations, in [0, 1].
+   * @param maxEntries Number of most likely observations whose estimated
+   *     probabilities are kept after training (0 means all of them).
+   */
+  SparseDiscreteDistribution(const size_t numObservations = 0,
+                             const double smoothing = 1e-3,
+                             const size_t maxEntries = 0) :
+      numObservations(numObservations),
+      smoothing(smoothing),
+      maxEntries(maxEntries),
+      probabilities(numObservations)
+  { /* Nothing to do. */ }
+
+  //! Get the dimensionality of the distribution (it is always 1).
+  size_t Dimensionality() const { return 1; }
+
+  /**
+   * Return the probability of the given observation.
+   *
+   * @param observation Observation to return the probability of.
+   * @return Probability of the given observation.
+   */
+  double Probability(const arma::vec& observation) const
+  {
+    return IndexProbability(Index(observation[0]));
+  }
+
+  /**
+   * Return the log probability of the given observation.
+   *
+   * @param observation Observation to return the log probability of.
+   * @return Log probability of the given observation.
+   */
+  double LogProbability(const arma::vec& observation) const
+  {
+    return std::log(Probability(observation));
+  }
+
+  /**
+   * Compute the log probabilities of all the given observations at once.  Each
+   * observation costs one lookup in the sparse vector of probabilities.
+   *
+   * @param observations Observations (one per column).
+   * @param logProbabilities Vector to store the log probabilities in.
+   */
+  void LogProbability(const arma::mat& observations,
+                      arma::vec& logProbabilities) const;
+
+  /**
+   * Return a randomly generated observation (a one-dimensional vector)
+   * according to the distribution.
+   *
+   * @return Random observation.
+   */
+  arma::vec Random() const;
+
+  /**
+   * Estimate the distribution from the given observations.
+   *
+   * @param observations List of observations.
+   */
+  void Train(const arma::mat& observations);
+
+  /**
+   * Estimate the distribution from the given observations, taking into account
+   * the probability of each observation actually being from this distribution.
+   *
+   * @param observations List of observations.
+   * @param probabilities List of probabilities that each observation is
+   *    actually from this distribution.
+   */
+  void Train(const arma::mat& observations,
+             const arma::vec& probabilities);
+
+  /**
+   * Take one step of stepwise (online) EM towards the given weighted
+   * observations: the estimated probabilities are replaced by (1 - stepSize)
+   * times their current value plus stepSize times their estimate from the
+   * observations.
+   *
+   * @param observations Batch of observations.
+   * @param probabilities List of probabilities that each observation is
+   *    actually from this distribution.
+   * @param stepSize Weight of the batch, in (0, 1].
+   */
+  void Update(const arma::mat& observations,
+              const arma::vec& probabilities,
+              const double stepSize);
+
+  //! Get the number of possible observations.
+  size_t NumObservations() const { return numObservations; }
+
+  //! Get the share of the probability spread over all the observations.
+  double Smoothing() const { return smoothing; }
+  //! Modify the share of the probability spread over all the observations.
+  double& Smoothing() { return smoothing; }
+
+  //! Get the number of estimated probabilities kept after training.
+  size_t MaxEntries() const { return maxEntries; }
+  //! Modify the number of estimated probabilities kept after training.
+  size_t& MaxEntries() { return maxEntries; }
+
+  //! Get the estimated probabilities (before smoothing).
+  const arma::sp_vec& Probabilities() const { return probabilities; }
+
+  /**
+   * Serialize the distribution.
+   */
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */)
+  {
+    ar & BOOST_SERIALIZATION_NVP(numObservations);
+    ar & BOOST_SERIALIZATION_NVP(smoothing);
+    ar & BOOST_SERIALIZATION_NVP(maxEntries);
+    ar & BOOST_SERIALIZATION_NVP(probabilities);
+  }
+
+ private:
+  //! Round the given observation to its index, and check it.
+  size_t Index(const double observation) const
+  {
+    // Adding 0.5 helps ensure that we cast the floating point to a size_t
+    // correctly.
+    const size_t obs = size_t(observation + 0.5);
+    if (obs >= numObservations)
+    {
+      Log::Fatal << "SparseDiscreteDistribution: received observation " << obs
+          << "; observation must be in [0, " << numObservations << ") for "
+          << "this distribution." << std::endl;
+    }
+
+    return obs;
+  }
+
+  //! Return the probability of the observation with the given index.
+  double IndexProbability(const size_t obs) const
+  {
+    // Without any estimate, all the observations are equally likely.
+    if (probabilities.n_nonzero == 0)
+      return 1.0 / numObservations;
+
+    return (1.0 - smoothing) * probabilities[obs] +
+        smoothing / numObservations;
+  }
+
+  //! Set the estimated probabilities from the given weight of each
+  //! observation, keeping only the maxEntries largest.
+  void SetProbabilities(std::vector<std::pair<size_t, double>>& weights);
+
+  //! The number of possible observations.
+  size_t numObservations;
+
+  //! The share of the probability spread over all the observations.
+  double smoothing;
+
+  //! The number of estimated probabilities kept after training (0 for all).
+  size_t maxEntries;
+
+  //! The estimated probabilities of the observations seen in training.
+  arma::sp_vec probabilities;
+};
+
+} // namespace distribution
+} // namespace mlpack
+
+#endif
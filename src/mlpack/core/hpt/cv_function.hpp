@@ -13,10 +13,16 @@
 #define MLPACK_CORE_HPT_CV_FUNCTION_HPP
 
 #include <mlpack/core.hpp>
+#include <map>
 
 namespace mlpack {
 namespace hpt {
 
+// This gives us a HasEarlyStopThresholdCheck<T, U> type (where U is a function
+// pointer) we can use with SFINAE to catch when a cross-validation type can
+// stop its evaluation early.
+HAS_MEM_FUNC(EarlyStopThreshold, HasEarlyStopThresholdCheck);
+
 /**
  * This wrapper serves for adapting the interface of the cross-validation
  * classes to the one that can be utilized by the mlpack optimizers.
@@ -62,7 +68,9 @@ class CVFunction
              const BoundArgs&... args);
 
   /**
-   * Run cross-validation with the bound and passed parameters.
+   * Run cross-validation with the bound and passed parameters.  The objective
+   * of each set of parameters is kept, so cross-validation is not run again
+   * when the same parameters are evaluated again.
    *
    * @param parameters Arguments (rather than the bound arguments) that should
    *     be passed into the Evaluate method of the CVType object.
@@ -71,7 +79,8 @@ class CVFunction
 
   /**
    * Evaluate numerically the gradient of the CVFunction with the given
-   * parameters.
+   * parameters.  This costs one run of cross-validation per parameter, plus
+   * one for the given parameters if they have not been evaluated yet.
    *
    * @param parameters Arguments (rather than the bound arguments) that should
    *     be passed into the Evaluate method of the CVType object.
@@ -82,6 +91,20 @@ class CVFunction
   //! Access and modify the best model so far.
   MLAlgorithm& BestModel() { return bestModel; }
 
+  //! Get the number of distinct sets of parameters evaluated so far.
+  size_t NumEvaluations() const { return evaluations.size(); }
+
+  /**
+   * Get the relative tolerance of early stopping: if the cross-validation
+   * strategy supports it (like KFoldCV), the evaluation of a set of arguments
+   * stops as soon as it is worse than the best objective so far by more than
+   * this fraction of its absolute value.  A negative value (the default)
+   * disables early stopping.
+   */
+  double EarlyStopTolerance() const { return earlyStopTolerance; }
+  //! Modify the relative tolerance of early stopping.
+  double& EarlyStopTolerance() { return earlyStopTolerance; }
+
  private:
   //! The type of tuples of BoundArgs.
   using BoundArgsTupleType = std::tuple<BoundArgs...>;
@@ -118,6 +141,33 @@ class CVFunction
   //! Minimum absolute increase of arguments for calculation of gradient.
   double minDelta;
 
+  //! Relative tolerance of early stopping.
+  double earlyStopTolerance;
+
+  //! The objectives of the sets of parameters evaluated so far.
+  std::map<std::vector<double>, double> evaluations;
+
+  /**
+   * Set the threshold of early stopping of a cross-validation strategy that
+   * supports it.
+   */
+  template<typename CV = CVType>
+  typename std::enable_if<HasEarlyStopThresholdCheck<CV,
+      double&(CV::*)()>::value, void>::type
+  SetEarlyStopThreshold(const double threshold)
+  {
+    cv.EarlyStopThreshold() = threshold;
+  }
+
+  /**
+   * Do nothing for a cross-validation strategy that does not support early
+   * stopping.
+   */
+  template<typename CV = CVType>
+  typename std::enable_if<!HasEarlyStopThresholdCheck<CV,
+      double&(CV::*)()>::value, void>::type
+  SetEarlyStopThreshold(const double /* threshold */) { }
+
   /**
    * Collect all arguments and run cross-validation.
    */
@@ -53,7 +53,8 @@ CVFunction<CVType, MLAlgorithm, TotalArgs, BoundArgs...>::CVFunction(
     boundArgs(args...),
     bestObjective(std::numeric_limits<double>::max()),
     relativeDelta(relativeDelta),
-    minDelta(minDelta)
+    minDelta(minDelta),
+    earlyStopTolerance(-1)
 { /* Nothing left to do. */ }
 
 template<typename CVType,
@@ -63,7 +64,17 @@ template<typename CVType,
 double CVFunction<CVType, MLAlgorithm, TotalArgs, BoundArgs...>::Evaluate(
     const arma::mat& parameters)
 {
-  return Evaluate<0, 0>(parameters);
+  // Optimizers can come back to the same parameters (GradientDescent evaluates
+  // the objective and then the gradient at each point), and cross-validation
+  // is too expensive to run again.
+  const std::vector<double> key(parameters.begin(), parameters.end());
+  const auto it = evaluations.find(key);
+  if (it != evaluations.end())
+    return it->second;
+
+  const double objective = Evaluate<0, 0>(parameters);
+  evaluations[key] = objective;
+  return objective;
 }
 
 template<typename CVType,
@@ -115,6 +126,15 @@ double CVFunction<CVType, MLAlgorithm, TotalArgs, BoundArgs...>::Evaluate(
     const arma::mat& /* parameters */,
     const Args&... args)
 {
+  // Sets of arguments that are clearly worse than the best one so far don't
+  // need to be evaluated on all the data.
+  if (earlyStopTolerance >= 0 &&
+      bestObjective != std::numeric_limits<double>::max())
+  {
+    SetEarlyStopThreshold(bestObjective + earlyStopTolerance *
+        std::abs(bestObjective));
+  }
+
   double objective = cv.Evaluate(args...);
 
   // Change the best model if we have got a better score, or if we probably
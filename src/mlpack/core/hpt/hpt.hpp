@@ -71,8 +71,8 @@ namespace hpt {
  * @tparam Metric A metric to assess the quality of a trained model.
  * @tparam CV A cross-validation strategy used to assess a set of
  *     hyper-parameters.
- * @tparam OptimizerType An optimization strategy (GridSearch and
- *     GradientDescent are supported).
+ * @tparam OptimizerType An optimization strategy (GridSearch, RandomSearch,
+ *     BayesianOptimization and GradientDescent are supported).
  * @tparam MatType The type of data.
  * @tparam PredictionsType The type of predictions (should be passed when the
  *     predictions type is a template parameter in Train methods of the given
@@ -151,13 +151,31 @@ class HyperParameterTuner
    */
   double& MinDelta() { return minDelta; }
 
+  /**
+   * Get the relative tolerance of early stopping.  If the cross-validation
+   * strategy supports it (like KFoldCV), the evaluation of a set of
+   * hyper-parameters stops as soon as the folds evaluated so far are worse
+   * than the best set so far by more than this fraction; this is meant to be
+   * used with GridSearch.
+   *
+   * The default value is -1 (no early stopping).
+   */
+  double EarlyStopTolerance() const { return earlyStopTolerance; }
+
+  /**
+   * Modify the relative tolerance of early stopping (see
+   * EarlyStopTolerance()).  A negative value disables early stopping.
+   */
+  double& EarlyStopTolerance() { return earlyStopTolerance; }
+
   /**
    * Find the best hyper-parameters by using the given Optimizer. For each
    * hyper-parameter one of the following should be passed as an argument.
-   * 1. A set of values to choose from (when using GridSearch as an optimizer).
-   *   The set of values should be an STL-compatible container (it should
-   *   provide begin() and end() methods returning iterators).
-   * 2. A starting value (when using any other optimizer than GridSearch).
+   * 1. A set of values to choose from (when using GridSearch, RandomSearch or
+   *   BayesianOptimization as an optimizer). The set of values should be an
+   *   STL-compatible container (it should provide begin() and end() methods
+   *   returning iterators).
+   * 2. A starting value (when using any other optimizer).
    * 3. A value fixed by using the function mlpack::hpt::Fixed. In this case the
    *   hyper-parameter will not be optimized.
    *
@@ -197,6 +215,9 @@ class HyperParameterTuner
                            const MatType& xs,
                            const PredictionsType& ys)
     { return -OriginalMetric::Evaluate(model, xs, ys); }
+
+    //! The negated values of a metric to maximize have to be minimized.
+    static const bool NeedsMinimization = true;
   };
 
   //! A short alias for the full type of the cross-validation.
@@ -205,7 +226,14 @@ class HyperParameterTuner
       CV<MLAlgorithm, Negated<Metric>, MatType, PredictionsType,
           WeightsType>>::type;
 
+ public:
+  /**
+   * Access and modify the cross-validation object (e.g., to evaluate the folds
+   * of KFoldCV in parallel with Parallel()).
+   */
+  CVType& CrossValidation() { return cv; }
 
+ private:
   //! The cross-validation object for assessing sets of hyper-parameters.
   CVType cv;
 
@@ -230,6 +258,9 @@ class HyperParameterTuner
    */
   double minDelta;
 
+  //! The relative tolerance of early stopping in CVFunction.
+  double earlyStopTolerance;
+
   /**
    * A type function to check whether the element I of the tuple type is a
    * PreFixedArg.
@@ -32,7 +32,8 @@ HyperParameterTuner<MLAlgorithm,
                     MatType,
                     PredictionsType,
                     WeightsType>::HyperParameterTuner(const CVArgs&... args) :
-    cv(args...), relativeDelta(0.01), minDelta(1e-10) {}
+    cv(args...), relativeDelta(0.01), minDelta(1e-10), earlyStopTolerance(-1)
+{}
 
 template<typename MLAlgorithm,
          typename Metric,
@@ -89,6 +90,7 @@ void HyperParameterTuner<MLAlgorithm,
 
   CVFunction<CVType, MLAlgorithm, totalArgs, FixedArgs...>
       cvFunction(cv, relativeDelta, minDelta, fixedArgs...);
+  cvFunction.EarlyStopTolerance() = earlyStopTolerance;
   bestObjective = Metric::NeedsMinimization?
       optimizer.Optimize(cvFunction, bestParams, datasetInfo) :
       -optimizer.Optimize(cvFunction, bestParams, datasetInfo);
@@ -0,0 +1,147 @@
+/**
+ * @file cached_kernel.hpp
+ *
+ * A wrapper around another kernel that keeps the most recently used rows of
+ * the kernel matrix of a dataset, so that kernel values are not computed again
+ * when a method needs them many times.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_KERNELS_CACHED_KERNEL_HPP
+#define MLPACK_CORE_KERNELS_CACHED_KERNEL_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/kernels/kernel_traits.hpp>
+
+namespace mlpack {
+namespace kernel {
+
+/**
+ * A kernel that caches the rows of the kernel matrix of a dataset, computed
+ * with another kernel.  When a kernel value is needed and neither of the two
+ * points has its row in the cache, the whole row of the kernel matrix for the
+ * first point is computed and kept in the cache; when the cache is full, the
+ * least recently used row is replaced.  The cached rows are stored as the
+ * columns of a single matrix.  (KernelMatrix() does not use the cache: it
+ * computes whole kernel matrices directly with the wrapped kernel.)
+ *
+ * Like the PSpectrumStringKernel, the data given to the machine learning
+ * method is a "fake" data matrix with one row, which holds the index of each
+ * point in the dataset given to the CachedKernel:
+ *
+ * [[0 1 2 3 4 5 6 7 8]]
+ *
+ * Evaluate(a, b) then returns K(dataset.col(a[0]), dataset.col(b[0])).  Only
+ * methods that never use the explicit representation of the points (such as
+ * FastMKS, KernelPCA and the NystroemMethod) can use this kernel.  The dataset
+ * is held by reference, so it must outlive the kernel.
+ *
+ * The wrapped kernel must be symmetric.  Evaluate() may be called from several
+ * OpenMP threads; accesses to the cache are serialized.
+ *
+ * @tparam KernelType Kernel to compute the values with.
+ */
+template<typename KernelType>
+class CachedKernel
+{
+ public:
+  /**
+   * Create the cached kernel for the given dataset.
+   *
+   * @param dataset Points to compute the kernel values between.
+   * @param cacheSize Maximum number of rows of the kernel matrix to keep (the
+   *     cache takes cacheSize times the number of points doubles).
+   * @param kernel Kernel to compute the values with.
+   */
+  CachedKernel(const arma::mat& dataset,
+               const size_t cacheSize = 100,
+               const KernelType& kernel = KernelType());
+
+  /**
+   * Return the kernel value between the two points whose indices are given,
+   * computing and caching the row of one of them if neither is cached.
+   *
+   * @param a One-element vector holding the index of the first point.
+   * @param b One-element vector holding the index of the second point.
+   */
+  template<typename VecTypeA, typename VecTypeB>
+  double Evaluate(const VecTypeA& a, const VecTypeB& b) const;
+
+  //! Forget all cached rows.
+  void Clear();
+
+  //! Get the dataset.
+  const arma::mat& Dataset() const { return dataset; }
+
+  //! Get the wrapped kernel.
+  const KernelType& Kernel() const { return kernel; }
+  //! Modify the wrapped kernel.  Call Clear() if its parameters change.
+  KernelType& Kernel() { return kernel; }
+
+  //! Get the maximum number of cached rows.
+  size_t CacheSize() const { return cacheSize; }
+
+  //! Get the number of kernel values that were found in the cache.
+  size_t Hits() const { return hits; }
+  //! Get the number of rows of the kernel matrix that were computed.
+  size_t Misses() const { return misses; }
+
+ private:
+  //! Compute the row of the given point, replacing the least recently used
+  //! row, and return its slot.
+  size_t Insert(const size_t point) const;
+
+  //! The points (held by reference).
+  const arma::mat& dataset;
+
+  //! Maximum number of cached rows.
+  size_t cacheSize;
+
+  //! The wrapped kernel (mutable, since not every kernel has a const
+  //! Evaluate()).
+  mutable KernelType kernel;
+
+  //! The cached rows; column s holds the row of the point in slot s.
+  mutable arma::mat rows;
+
+  //! The slot of each point, or cacheSize if the point's row is not cached.
+  mutable std::vector<size_t> slots;
+
+  //! The point held by each slot, or the number of points if it is empty.
+  mutable std::vector<size_t> points;
+
+  //! The time at which each slot was last used.
+  mutable std::vector<size_t> lastUsed;
+
+  //! The current time (the number of cache accesses).
+  mutable size_t time;
+
+  //! The number of kernel values that were found in the cache.
+  mutable size_t hits;
+
+  //! The number of rows that were computed.
+  mutable size_t misses;
+};
+
+//! Kernel traits for the cached kernel.
+template<typename KernelType>
+class KernelTraits<CachedKernel<KernelType>>
+{
+ public:
+  //! The cached kernel is normalized if the wrapped kernel is.
+  static const bool IsNormalized = KernelTraits<KernelType>::IsNormalized;
+
+  //! The points are indices, so the distance between them means nothing.
+  static const bool UsesSquaredDistance = false;
+};
+
+} // namespace kernel
+} // namespace mlpack
+
+// Include implementation.
+#include "cached_kernel_impl.hpp"
+
+#endif
@@ -0,0 +1,106 @@
+/**
+ * @file cached_kernel_impl.hpp
+ *
+ * Implementation of the CachedKernel class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_KERNELS_CACHED_KERNEL_IMPL_HPP
+#define MLPACK_CORE_KERNELS_CACHED_KERNEL_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "cached_kernel.hpp"
+
+namespace mlpack {
+namespace kernel {
+
+template<typename KernelType>
+CachedKernel<KernelType>::CachedKernel(const arma::mat& dataset,
+                                       const size_t cacheSize,
+                                       const KernelType& kernel) :
+    dataset(dataset),
+    cacheSize(std::max(std::min(cacheSize, (size_t) dataset.n_cols),
+        (size_t) 1)),
+    kernel(kernel)
+{
+  Clear();
+}
+
+template<typename KernelType>
+void CachedKernel<KernelType>::Clear()
+{
+  rows.set_size(dataset.n_cols, cacheSize);
+  slots.assign(dataset.n_cols, cacheSize);
+  points.assign(cacheSize, dataset.n_cols);
+  lastUsed.assign(cacheSize, 0);
+  time = 0;
+  hits = 0;
+  misses = 0;
+}
+
+template<typename KernelType>
+template<typename VecTypeA, typename VecTypeB>
+double CachedKernel<KernelType>::Evaluate(const VecTypeA& a,
+                                          const VecTypeB& b) const
+{
+  const size_t i = (size_t) a[0];
+  const size_t j = (size_t) b[0];
+
+  double value;
+  #pragma omp critical(CachedKernelAccess)
+  {
+    // The kernel is symmetric, so the row of either point will do.
+    size_t slot = slots[i];
+    size_t other = j;
+    if (slot == cacheSize)
+    {
+      slot = slots[j];
+      other = i;
+    }
+
+    if (slot == cacheSize)
+    {
+      slot = Insert(i);
+      other = j;
+    }
+    else
+    {
+      ++hits;
+    }
+
+    lastUsed[slot] = ++time;
+    value = rows(other, slot);
+  }
+
+  return value;
+}
+
+template<typename KernelType>
+size_t CachedKernel<KernelType>::Insert(const size_t point) const
+{
+  // Replace the least recently used slot; empty slots have never been used.
+  size_t slot = 0;
+  for (size_t s = 1; s < cacheSize; ++s)
+    if (lastUsed[s] < lastUsed[slot])
+      slot = s;
+
+  if (points[slot] != dataset.n_cols)
+    slots[points[slot]] = cacheSize;
+
+  for (size_t k = 0; k < dataset.n_cols; ++k)
+    rows(k, slot) = kernel.Evaluate(dataset.col(point), dataset.col(k));
+
+  points[slot] = point;
+  slots[point] = slot;
+  ++misses;
+
+  return slot;
+}
+
+} // namespace kernel
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,426 @@
+/**
+ * @file kernel_matrix.hpp
+ *
+ * Construction of kernel matrices.  Kernels that are functions of the inner
+ * product or of the squared distance are evaluated between all pairs of points
+ * with one matrix multiplication; other kernels are evaluated pair by pair, in
+ * tiles split between OpenMP threads.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_KERNELS_KERNEL_MATRIX_HPP
+#define MLPACK_CORE_KERNELS_KERNEL_MATRIX_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "kernel_traits.hpp"
+#include "linear_kernel.hpp"
+#include "polynomial_kernel.hpp"
+#include "cosine_distance.hpp"
+#include "gaussian_kernel.hpp"
+#include "precomputed_kernel.hpp"
+#include "pspectrum_string_kernel.hpp"
+#include "cached_kernel.hpp"
+
+namespace mlpack {
+namespace kernel {
+
+/**
+ * Compute the squared Euclidean distance between every point of a and every
+ * point of b from the inner products, with one matrix multiplication; entry
+ * (i, j) of distances is ||a.col(i) - b.col(j)||^2.  Small negative values
+ * caused by rounding are set to 0.
+ *
+ * @param a First set of points.
+ * @param b Second set of points.
+ * @param distances Matrix to store the squared distances in.
+ */
+template<typename MatType>
+void SquaredDistanceMatrix(const MatType& a,
+                           const MatType& b,
+                           arma::mat& distances)
+{
+  distances = -2.0 * (a.t() * b);
+  distances.each_col() += arma::sum(arma::square(a), 0).t();
+  distances.each_row() += arma::sum(arma::square(b), 0);
+  distances.elem(arma::find(distances < 0.0)).zeros();
+}
+
+/**
+ * Compute the squared Euclidean distance between every pair of points of the
+ * given set.  The diagonal is exactly 0.
+ *
+ * @param data Set of points.
+ * @param distances Matrix to store the squared distances in.
+ */
+template<typename MatType>
+void SquaredDistanceMatrix(const MatType& data, arma::mat& distances)
+{
+  // Armadillo computes X^T X with a symmetric rank-k update.
+  distances = -2.0 * (data.t() * data);
+  const arma::rowvec norms = arma::sum(arma::square(data), 0);
+  distances.each_col() += norms.t();
+  distances.each_row() += norms;
+  distances.elem(arma::find(distances < 0.0)).zeros();
+  distances.diag().zeros();
+}
+
+/**
+ * Evaluate the kernel between every pair of points of a and b pair by pair,
+ * with tiles of the matrix split between OpenMP threads.
+ */
+template<typename KernelType, typename MatType>
+void PairwiseKernelMatrix(KernelType& kernel,
+                          const MatType& a,
+                          const MatType& b,
+                          arma::mat& kernelMatrix)
+{
+  kernelMatrix.set_size(a.n_cols, b.n_cols);
+
+  const size_t tileSize = 64;
+  const size_t rowTiles = (a.n_cols + tileSize - 1) / tileSize;
+  const size_t colTiles = (b.n_cols + tileSize - 1) / tileSize;
+
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t t = 0; t < (omp_size_t) (rowTiles * colTiles); ++t)
+  {
+    const size_t rowBegin = (t % rowTiles) * tileSize;
+    const size_t rowEnd = std::min(rowBegin + tileSize, (size_t) a.n_cols);
+    const size_t colBegin = (t / rowTiles) * tileSize;
+    const size_t colEnd = std::min(colBegin + tileSize, (size_t) b.n_cols);
+
+    for (size_t j = colBegin; j < colEnd; ++j)
+      for (size_t i = rowBegin; i < rowEnd; ++i)
+        kernelMatrix(i, j) = kernel.Evaluate(a.col(i), b.col(j));
+  }
+}
+
+/**
+ * Evaluate the kernel between every pair of points of the given set pair by
+ * pair.  Only the tiles on or above the diagonal are evaluated, split between
+ * OpenMP threads, and each is mirrored into the lower triangle.
+ */
+template<typename KernelType, typename MatType>
+void PairwiseKernelMatrix(KernelType& kernel,
+                          const MatType& data,
+                          arma::mat& kernelMatrix)
+{
+  kernelMatrix.set_size(data.n_cols, data.n_cols);
+
+  const size_t tileSize = 64;
+  const size_t numTiles = (data.n_cols + tileSize - 1) / tileSize;
+
+  // Each pair of tiles (ti, tj) with ti <= tj writes only to its own tile and
+  // the mirrored one, so no two iterations write to the same entry.
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t t = 0; t < (omp_size_t) (numTiles * numTiles); ++t)
+  {
+    const size_t ti = t % numTiles;
+    const size_t tj = t / numTiles;
+    if (ti > tj)
+      continue;
+
+    const size_t rowBegin = ti * tileSize;
+    const size_t rowEnd = std::min(rowBegin + tileSize, (size_t) data.n_cols);
+    const size_t colBegin = tj * tileSize;
+    const size_t colEnd = std::min(colBegin + tileSize, (size_t) data.n_cols);
+
+    for (size_t j = colBegin; j < colEnd; ++j)
+    {
+      for (size_t i = rowBegin; i < std::min(rowEnd, j + 1); ++i)
+      {
+        const double value = kernel.Evaluate(data.col(i), data.col(j));
+        kernelMatrix(i, j) = value;
+        kernelMatrix(j, i) = value;
+      }
+    }
+  }
+}
+
+/**
+ * Replace each squared distance of the given matrix with the kernel value of
+ * the distance, in parallel.  This is used for kernels with
+ * KernelTraits<KernelType>::UsesSquaredDistance, which must provide
+ * Evaluate(distance).
+ */
+template<typename KernelType>
+void KernelMatrixFromDistances(KernelType& kernel, arma::mat& kernelMatrix)
+{
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t i = 0; i < (omp_size_t) kernelMatrix.n_elem; ++i)
+    kernelMatrix[i] = kernel.Evaluate(std::sqrt(kernelMatrix[i]));
+}
+
+//! Select the computation from the squared distances for kernels that use
+//! them.
+template<typename KernelType, typename MatType>
+void KernelMatrixImpl(KernelType& kernel,
+                      const MatType& a,
+                      const MatType& b,
+                      arma::mat& kernelMatrix,
+                      const std::true_type& /* usesSquaredDistance */)
+{
+  SquaredDistanceMatrix(a, b, kernelMatrix);
+  KernelMatrixFromDistances(kernel, kernelMatrix);
+}
+
+//! Select the pairwise computation for other kernels.
+template<typename KernelType, typename MatType>
+void KernelMatrixImpl(KernelType& kernel,
+                      const MatType& a,
+                      const MatType& b,
+                      arma::mat& kernelMatrix,
+                      const std::false_type& /* usesSquaredDistance */)
+{
+  PairwiseKernelMatrix(kernel, a, b, kernelMatrix);
+}
+
+//! Select the computation from the squared distances for kernels that use
+//! them.
+template<typename KernelType, typename MatType>
+void KernelMatrixImpl(KernelType& kernel,
+                      const MatType& data,
+                      arma::mat& kernelMatrix,
+                      const std::true_type& /* usesSquaredDistance */)
+{
+  SquaredDistanceMatrix(data, kernelMatrix);
+  KernelMatrixFromDistances(kernel, kernelMatrix);
+}
+
+//! Select the pairwise computation for other kernels.
+template<typename KernelType, typename MatType>
+void KernelMatrixImpl(KernelType& kernel,
+                      const MatType& data,
+                      arma::mat& kernelMatrix,
+                      const std::false_type& /* usesSquaredDistance */)
+{
+  PairwiseKernelMatrix(kernel, data, kernelMatrix);
+}
+
+/**
+ * Evaluate the kernel between every point of a and every point of b; entry
+ * (i, j) of kernelMatrix is K(a.col(i), b.col(j)).  Kernels with
+ * KernelTraits<KernelType>::UsesSquaredDistance are evaluated from the squared
+ * distances, which take one matrix multiplication; other kernels without a
+ * specialized overload are evaluated pair by pair, in parallel.
+ *
+ * @param kernel Kernel to evaluate.
+ * @param a First set of points.
+ * @param b Second set of points.
+ * @param kernelMatrix Matrix to store the kernel values in.
+ */
+template<typename KernelType, typename MatType>
+void KernelMatrix(KernelType& kernel,
+                  const MatType& a,
+                  const MatType& b,
+                  arma::mat& kernelMatrix)
+{
+  KernelMatrixImpl(kernel, a, b, kernelMatrix, std::integral_constant<bool,
+      KernelTraits<KernelType>::UsesSquaredDistance>());
+}
+
+/**
+ * Evaluate the kernel between every pair of points of the given set; the
+ * result is symmetric.  Kernels with KernelTraits<KernelType>::
+ * UsesSquaredDistance are evaluated from the squared distances; other kernels
+ * without a specialized overload are evaluated pair by pair, in parallel, for
+ * the upper triangle only.
+ *
+ * @param kernel Kernel to evaluate.
+ * @param data Set of points.
+ * @param kernelMatrix Matrix to store the kernel values in.
+ */
+template<typename KernelType, typename MatType>
+void KernelMatrix(KernelType& kernel,
+                  const MatType& data,
+                  arma::mat& kernelMatrix)
+{
+  KernelMatrixImpl(kernel, data, kernelMatrix, std::integral_constant<bool,
+      KernelTraits<KernelType>::UsesSquaredDistance>());
+}
+
+//! Evaluate the linear kernel between two sets with one matrix
+//! multiplication.
+template<typename MatType>
+void KernelMatrix(LinearKernel& /* kernel */,
+                  const MatType& a,
+                  const MatType& b,
+                  arma::mat& kernelMatrix)
+{
+  kernelMatrix = a.t() * b;
+}
+
+//! Evaluate the linear kernel between all pairs of a set with one matrix
+//! multiplication.
+template<typename MatType>
+void KernelMatrix(LinearKernel& /* kernel */,
+                  const MatType& data,
+                  arma::mat& kernelMatrix)
+{
+  kernelMatrix = data.t() * data;
+}
+
+//! Evaluate the polynomial kernel between two sets with one matrix
+//! multiplication.
+template<typename MatType>
+void KernelMatrix(PolynomialKernel& kernel,
+                  const MatType& a,
+                  const MatType& b,
+                  arma::mat& kernelMatrix)
+{
+  kernelMatrix = arma::pow(a.t() * b + kernel.Offset(), kernel.Degree());
+}
+
+//! Evaluate the polynomial kernel between all pairs of a set with one matrix
+//! multiplication.
+template<typename MatType>
+void KernelMatrix(PolynomialKernel& kernel,
+                  const MatType& data,
+                  arma::mat& kernelMatrix)
+{
+  kernelMatrix = arma::pow(data.t() * data + kernel.Offset(),
+      kernel.Degree());
+}
+
+//! Evaluate the cosine distance between two sets with one matrix
+//! multiplication; as in CosineDistance::Evaluate(), pairs with a zero vector
+//! have a cosine similarity of 0.
+template<typename MatType>
+void KernelMatrix(CosineDistance& /* kernel */,
+                  const MatType& a,
+                  const MatType& b,
+                  arma::mat& kernelMatrix)
+{
+  kernelMatrix = a.t() * b;
+
+  // The inner product with a zero vector is zero, so dividing it by 1 instead
+  // of 0 gives the expected 0.
+  arma::rowvec aNorms = arma::sqrt(arma::sum(arma::square(a), 0));
+  arma::rowvec bNorms = arma::sqrt(arma::sum(arma::square(b), 0));
+  aNorms.elem(arma::find(aNorms == 0.0)).ones();
+  bNorms.elem(arma::find(bNorms == 0.0)).ones();
+
+  kernelMatrix.each_col() /= aNorms.t();
+  kernelMatrix.each_row() /= bNorms;
+}
+
+//! Evaluate the cosine distance between all pairs of a set with one matrix
+//! multiplication.
+template<typename MatType>
+void KernelMatrix(CosineDistance& kernel,
+                  const MatType& data,
+                  arma::mat& kernelMatrix)
+{
+  KernelMatrix(kernel, data, data, kernelMatrix);
+}
+
+//! Evaluate the Gaussian kernel between two sets from the squared distances,
+//! with one vectorized exponential.
+template<typename MatType>
+void KernelMatrix(GaussianKernel& kernel,
+                  const MatType& a,
+                  const MatType& b,
+                  arma::mat& kernelMatrix)
+{
+  SquaredDistanceMatrix(a, b, kernelMatrix);
+  kernelMatrix = arma::exp((-0.5 / std::pow(kernel.Bandwidth(), 2.0)) *
+      kernelMatrix);
+}
+
+//! Evaluate the Gaussian kernel between all pairs of a set from the squared
+//! distances, with one vectorized exponential.
+template<typename MatType>
+void KernelMatrix(GaussianKernel& kernel,
+                  const MatType& data,
+                  arma::mat& kernelMatrix)
+{
+  SquaredDistanceMatrix(data, kernelMatrix);
+  kernelMatrix = arma::exp((-0.5 / std::pow(kernel.Bandwidth(), 2.0)) *
+      kernelMatrix);
+}
+
+//! Evaluate the p-spectrum string kernel between two sets of strings with one
+//! sparse matrix multiplication of their encoded substring counts.
+template<typename MatType>
+void KernelMatrix(PSpectrumStringKernel& kernel,
+                  const MatType& a,
+                  const MatType& b,
+                  arma::mat& kernelMatrix)
+{
+  arma::sp_mat aKmers, bKmers;
+  kernel.KmerMatrix(a, aKmers);
+  kernel.KmerMatrix(b, bKmers);
+  kernelMatrix = arma::mat(aKmers.t() * bKmers);
+}
+
+//! Evaluate the p-spectrum string kernel between all pairs of a set of strings
+//! with one sparse matrix multiplication of their encoded substring counts.
+template<typename MatType>
+void KernelMatrix(PSpectrumStringKernel& kernel,
+                  const MatType& data,
+                  arma::mat& kernelMatrix)
+{
+  arma::sp_mat kmers;
+  kernel.KmerMatrix(data, kmers);
+  kernelMatrix = arma::mat(kmers.t() * kmers);
+}
+
+//! Look up the kernel matrix between two sets of point indices in the
+//! precomputed kernel matrix.
+template<typename MatType>
+void KernelMatrix(PrecomputedKernel& kernel,
+                  const MatType& a,
+                  const MatType& b,
+                  arma::mat& kernelMatrix)
+{
+  const arma::uvec aIndices = arma::conv_to<arma::uvec>::from(a.row(0));
+  const arma::uvec bIndices = arma::conv_to<arma::uvec>::from(b.row(0));
+  kernelMatrix = kernel.Matrix().submat(aIndices, bIndices);
+}
+
+//! Look up the kernel matrix between all pairs of a set of point indices in
+//! the precomputed kernel matrix.
+template<typename MatType>
+void KernelMatrix(PrecomputedKernel& kernel,
+                  const MatType& data,
+                  arma::mat& kernelMatrix)
+{
+  const arma::uvec indices = arma::conv_to<arma::uvec>::from(data.row(0));
+  kernelMatrix = kernel.Matrix().submat(indices, indices);
+}
+
+//! Compute the kernel matrix between two sets of point indices directly with
+//! the kernel wrapped by the CachedKernel, so that the wrapped kernel's own
+//! KernelMatrix() overload is used; the cache is not used or changed.
+template<typename KernelType, typename MatType>
+void KernelMatrix(CachedKernel<KernelType>& kernel,
+                  const MatType& a,
+                  const MatType& b,
+                  arma::mat& kernelMatrix)
+{
+  const arma::uvec aIndices = arma::conv_to<arma::uvec>::from(a.row(0));
+  const arma::uvec bIndices = arma::conv_to<arma::uvec>::from(b.row(0));
+  const arma::mat aPoints = kernel.Dataset().cols(aIndices);
+  const arma::mat bPoints = kernel.Dataset().cols(bIndices);
+  KernelMatrix(kernel.Kernel(), aPoints, bPoints, kernelMatrix);
+}
+
+//! Compute the kernel matrix between all pairs of a set of point indices
+//! directly with the kernel wrapped by the CachedKernel; the cache is not used
+//! or changed.
+template<typename KernelType, typename MatType>
+void KernelMatrix(CachedKernel<KernelType>& kernel,
+                  const MatType& data,
+                  arma::mat& kernelMatrix)
+{
+  const arma::uvec indices = arma::conv_to<arma::uvec>::from(data.row(0));
+  const arma::mat points = kernel.Dataset().cols(indices);
+  KernelMatrix(kernel.Kernel(), points, kernelMatrix);
+}
+
+} // namespace kernel
+} // namespace mlpack
+
+#endif
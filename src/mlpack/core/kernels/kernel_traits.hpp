@@ -33,7 +33,9 @@ class KernelTraits
   static const bool IsNormalized = false;
 
   /**
-   * If true, then the kernel include a squared distance, ||x - y||^2 .
+   * If true, then the kernel include a squared distance, ||x - y||^2 .  Such
+   * kernels must also provide Evaluate(distance), so that KernelMatrix() can
+   * compute them from squared distances obtained with a matrix multiplication.
    */
   static const bool UsesSquaredDistance = false;
 };
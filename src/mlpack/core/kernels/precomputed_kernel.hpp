@@ -0,0 +1,94 @@
+/**
+ * @file precomputed_kernel.hpp
+ *
+ * A kernel whose values are all given in a precomputed kernel matrix.  As with
+ * the PSpectrumStringKernel, the points given to the methods are indices into
+ * the kernel matrix.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_KERNELS_PRECOMPUTED_KERNEL_HPP
+#define MLPACK_CORE_KERNELS_PRECOMPUTED_KERNEL_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/kernels/kernel_traits.hpp>
+
+namespace mlpack {
+namespace kernel {
+
+/**
+ * A kernel that looks up its values in a precomputed kernel matrix K, where
+ * K(i, j) is the kernel value between point i and point j.  This can be used
+ * when the kernel matrix is already known, or when the kernel is expensive and
+ * the same values are needed many times.
+ *
+ * Like the PSpectrumStringKernel, the data given to the machine learning
+ * method is a "fake" data matrix with one row, which holds the index of each
+ * point in the kernel matrix:
+ *
+ * [[0 1 2 3 4 5 6 7 8]]
+ *
+ * Evaluate(a, b) then returns K(a[0], b[0]).  Only methods that never use the
+ * explicit representation of the points (such as FastMKS, KernelPCA and the
+ * NystroemMethod) can use this kernel.
+ */
+class PrecomputedKernel
+{
+ public:
+  /**
+   * Create the kernel with an empty kernel matrix.
+   */
+  PrecomputedKernel() { }
+
+  /**
+   * Create the kernel from the given kernel matrix, which is copied.
+   *
+   * @param kernelMatrix Matrix of kernel values between all points.
+   */
+  PrecomputedKernel(const arma::mat& kernelMatrix) :
+      kernelMatrix(kernelMatrix) { }
+
+  /**
+   * Create the kernel from the given kernel matrix, taking ownership of it.
+   *
+   * @param kernelMatrix Matrix of kernel values between all points.
+   */
+  PrecomputedKernel(arma::mat&& kernelMatrix) :
+      kernelMatrix(std::move(kernelMatrix)) { }
+
+  /**
+   * Return the kernel value between the two points whose indices are given.
+   *
+   * @param a One-element vector holding the index of the first point.
+   * @param b One-element vector holding the index of the second point.
+   */
+  template<typename VecTypeA, typename VecTypeB>
+  double Evaluate(const VecTypeA& a, const VecTypeB& b) const
+  {
+    return kernelMatrix((size_t) a[0], (size_t) b[0]);
+  }
+
+  //! Get the kernel matrix.
+  const arma::mat& Matrix() const { return kernelMatrix; }
+  //! Modify the kernel matrix.
+  arma::mat& Matrix() { return kernelMatrix; }
+
+  //! Serialize the kernel.
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */)
+  {
+    ar & BOOST_SERIALIZATION_NVP(kernelMatrix);
+  }
+
+ private:
+  //! The kernel values between all points.
+  arma::mat kernelMatrix;
+};
+
+} // namespace kernel
+} // namespace mlpack
+
+#endif
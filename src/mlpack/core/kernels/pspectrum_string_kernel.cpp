@@ -84,5 +84,41 @@ mlpack::kernel::PSpectrumStringKernel::PSpectrumStringKernel(
     }
   }
 
-  Log::Info << "Substring extraction complete." << std::endl;
+  // Give each distinct substring an index, in alphabetical order, so that the
+  // counts of each string can be stored as a sparse vector sorted by index.
+  std::map<std::string, size_t> indices;
+  for (size_t dataset = 0; dataset < counts.size(); ++dataset)
+    for (size_t index = 0; index < counts[dataset].size(); ++index)
+      for (const std::pair<const std::string, int>& c : counts[dataset][index])
+        indices[c.first] = 0;
+
+  size_t numKmers = 0;
+  for (std::pair<const std::string, size_t>& i : indices)
+    i.second = numKmers++;
+
+  kmers.resize(counts.size());
+  for (size_t dataset = 0; dataset < counts.size(); ++dataset)
+  {
+    kmers[dataset].resize(counts[dataset].size());
+    for (size_t index = 0; index < counts[dataset].size(); ++index)
+    {
+      const std::map<std::string, int>& mapping = counts[dataset][index];
+
+      // Both maps are in alphabetical order, so the indices are sorted.
+      arma::umat locations(2, mapping.size(), arma::fill::zeros);
+      arma::vec values(mapping.size());
+      size_t i = 0;
+      for (const std::pair<const std::string, int>& c : mapping)
+      {
+        locations(0, i) = indices[c.first];
+        values[i++] = c.second;
+      }
+
+      kmers[dataset][index] = arma::sp_vec(locations, values, numKmers, 1,
+          false);
+    }
+  }
+
+  Log::Info << "Substring extraction complete (" << numKmers << " distinct "
+      << "substrings)." << std::endl;
 }
@@ -81,7 +81,8 @@ class PSpectrumStringKernel
    * element contains the index of the dataset and the second element contains
    * the index of the string.  Therefore, if [2 3] is passed for a, the string
    * used will be datasets[2][3] (datasets is of type
-   * std::vector<std::vector<std::string> >&).
+   * std::vector<std::vector<std::string> >&).  The kernel value is a merge of
+   * the sorted encoded substring counts of the two strings.
    *
    * @param a Index of string and dataset for first string.
    * @param b Index of string and dataset for second string.
@@ -89,13 +90,37 @@ class PSpectrumStringKernel
   template<typename VecType>
   double Evaluate(const VecType& a, const VecType& b) const;
 
+  /**
+   * Gather the encoded substring counts of the strings with the given indices
+   * into the columns of a sparse matrix.  The kernel matrix between two sets
+   * of strings is then the product of the transpose of the first matrix with
+   * the second; this is what KernelMatrix() does.
+   *
+   * @param indices Indices of the strings (one column per string, holding the
+   *     index of the dataset and the index of the string).
+   * @param kmerMatrix Sparse matrix to store the counts in.
+   */
+  template<typename MatType>
+  void KmerMatrix(const MatType& indices, arma::sp_mat& kmerMatrix) const;
+
   //! Access the lists of substrings.
   const std::vector<std::vector<std::map<std::string, int> > >& Counts() const
   { return counts; }
-  //! Modify the lists of substrings.
+  /**
+   * Modify the lists of substrings.  Evaluate() uses the encoded counts given
+   * by Kmers(), so changes here have no effect on the kernel values.
+   */
   std::vector<std::vector<std::map<std::string, int> > >& Counts()
   { return counts; }
 
+  /**
+   * Access the encoded counts of substrings: each distinct substring of all
+   * the datasets has an index (in alphabetical order), and the counts of each
+   * string are a sparse vector over those indices.
+   */
+  const std::vector<std::vector<arma::sp_vec> >& Kmers() const
+  { return kmers; }
+
   //! Access the value of p.
   size_t P() const { return p; }
   //! Modify the value of p.
@@ -109,6 +134,10 @@ class PSpectrumStringKernel
   //! is not wonderful...
   std::vector<std::vector<std::map<std::string, int> > > counts;
 
+  //! The counts of substrings of each string of each dataset, as sparse
+  //! vectors over the indices of the distinct substrings.
+  std::vector<std::vector<arma::sp_vec> > kmers;
+
   //! The value of p to use in calculation.
   size_t p;
 };
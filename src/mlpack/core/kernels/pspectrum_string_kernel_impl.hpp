@@ -36,44 +36,73 @@ template<typename VecType>
 double PSpectrumStringKernel::Evaluate(const VecType& a,
                                        const VecType& b) const
 {
-  // Get the map of substrings for the two strings we are interested in.
-  const std::map<std::string, int>& aMap = counts[a[0]][a[1]];
-  const std::map<std::string, int>& bMap = counts[b[0]][b[1]];
+  // Get the encoded substring counts for the two strings we are interested in.
+  const arma::sp_vec& aKmers = kmers[(size_t) a[0]][(size_t) a[1]];
+  const arma::sp_vec& bKmers = kmers[(size_t) b[0]][(size_t) b[1]];
 
   double eval = 0;
 
-  // Loop through the two maps (which, when iterated through, are sorted
-  // alphabetically).
-  std::map<std::string, int>::const_iterator aIt = aMap.begin();
-  std::map<std::string, int>::const_iterator bIt = bMap.begin();
-
-  while ((aIt != aMap.end()) && (bIt != bMap.end()))
+  // Loop through the nonzero counts of the two strings, which are sorted by
+  // the index of the substring.
+  size_t i = 0;
+  size_t j = 0;
+  while ((i < aKmers.n_nonzero) && (j < bKmers.n_nonzero))
   {
-    // Compare alphabetically (this is how std::map is ordered).
-    int result = (*aIt).first.compare((*bIt).first);
-
-    if (result == 0) // The same substring.
+    if (aKmers.row_indices[i] == bKmers.row_indices[j]) // The same substring.
     {
-      eval += ((*aIt).second * (*bIt).second);
+      eval += aKmers.values[i] * bKmers.values[j];
 
       // Now increment both.
-      ++aIt;
-      ++bIt;
+      ++i;
+      ++j;
     }
-    else if (result > 0)
+    else if (aKmers.row_indices[i] > bKmers.row_indices[j])
     {
-      // aIt is "ahead" of bIt (alphabetically); so increment bIt to "catch up".
-      ++bIt;
+      // i is "ahead" of j; so increment j to "catch up".
+      ++j;
     }
     else
     {
-      // bIt is "ahead" of aIt (alphabetically); so increment aIt to "catch up".
-      ++aIt;
+      // j is "ahead" of i; so increment i to "catch up".
+      ++i;
     }
   }
 
   return eval;
 }
+
+template<typename MatType>
+void PSpectrumStringKernel::KmerMatrix(const MatType& indices,
+                                       arma::sp_mat& kmerMatrix) const
+{
+  const size_t numKmers = (kmers.empty() || kmers[0].empty()) ? 0 :
+      kmers[0][0].n_rows;
+
+  // Count the nonzero values, so the batch constructor can be used.
+  size_t nonzeros = 0;
+  for (size_t i = 0; i < indices.n_cols; ++i)
+    nonzeros += kmers[(size_t) indices(0, i)][(size_t) indices(1, i)].n_nonzero;
+
+  arma::umat locations(2, nonzeros);
+  arma::vec values(nonzeros);
+  size_t k = 0;
+  for (size_t i = 0; i < indices.n_cols; ++i)
+  {
+    const arma::sp_vec& stringKmers =
+        kmers[(size_t) indices(0, i)][(size_t) indices(1, i)];
+    for (size_t j = 0; j < stringKmers.n_nonzero; ++j, ++k)
+    {
+      locations(0, k) = stringKmers.row_indices[j];
+      locations(1, k) = i;
+      values[k] = stringKmers.values[j];
+    }
+  }
+
+  // The locations are already sorted in column-major order.
+  kmerMatrix = arma::sp_mat(locations, values, numKmers, indices.n_cols,
+      false);
+}
+
 } // namespace kernel
 } // namespace mlpack
 
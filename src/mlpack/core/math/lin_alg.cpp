@@ -42,10 +42,142 @@ void mlpack::math::VectorPower(arma::vec& vec, const double power)
  */
 void mlpack::math::Center(const arma::mat& x, arma::mat& xCentered)
 {
+  // Centering a matrix into itself needs no copy.
+  if (&x == &xCentered)
+  {
+    CenterInPlace(xCentered);
+    return;
+  }
+
   // Get the mean of the elements in each row.
-  arma::vec rowMean = arma::sum(x, 1) / x.n_cols;
+  const arma::vec rowMean = arma::mean(x, 1);
+
+  // Each point is written once, without the repeated matrix of means.
+  xCentered.set_size(x.n_rows, x.n_cols);
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) x.n_cols; ++i)
+    xCentered.col(i) = x.col(i) - rowMean;
+}
+
+/**
+ * Centers a matrix in place, by subtracting the mean of each row from the row.
+ * Only the vector of means is allocated.
+ *
+ * @param x Matrix to center.
+ */
+void mlpack::math::CenterInPlace(arma::mat& x)
+{
+  const arma::vec rowMean = arma::mean(x, 1);
+
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) x.n_cols; ++i)
+    x.col(i) -= rowMean;
+}
+
+/**
+ * Compute the weighted mean and covariance of the columns of a matrix, a block
+ * of columns at a time.
+ */
+double mlpack::math::WeightedCovariance(const arma::mat& x,
+                                        const arma::vec& weights,
+                                        arma::vec& mean,
+                                        arma::mat& covariance,
+                                        const bool onePass)
+{
+  if (weights.n_elem != x.n_cols)
+  {
+    std::ostringstream oss;
+    oss << "WeightedCovariance(): number of weights (" << weights.n_elem
+        << ") does not match number of points (" << x.n_cols << ")";
+    throw std::invalid_argument(oss.str());
+  }
+
+  // Large enough for an efficient rank-k update, small enough that the scaled
+  // block of each thread stays in cache.
+  const size_t blockSize = 256;
+  const size_t numBlocks = (x.n_cols + blockSize - 1) / blockSize;
+
+  mean.zeros(x.n_rows);
+  covariance.zeros(x.n_rows, x.n_rows);
+
+  // The first pass finds the weighted sum of the points, and in one-pass mode
+  // also their weighted second moment.
+  double sumWeights = 0.0;
+  #pragma omp parallel
+  {
+    arma::vec threadSum(x.n_rows, arma::fill::zeros);
+    arma::mat threadMoment;
+    if (onePass)
+      threadMoment.zeros(x.n_rows, x.n_rows);
+    arma::mat scaled;
+    double threadWeights = 0.0;
+
+    #pragma omp for schedule(dynamic)
+    for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+    {
+      const size_t begin = b * blockSize;
+      const size_t end = std::min(begin + blockSize, (size_t) x.n_cols);
+
+      threadSum += x.cols(begin, end - 1) * weights.subvec(begin, end - 1);
+      threadWeights += arma::accu(weights.subvec(begin, end - 1));
+
+      if (onePass)
+      {
+        scaled = x.cols(begin, end - 1);
+        scaled.each_row() %= arma::sqrt(weights.subvec(begin, end - 1)).t();
+        threadMoment += scaled * scaled.t();
+      }
+    }
+
+    #pragma omp critical(WeightedCovarianceSum)
+    {
+      mean += threadSum;
+      sumWeights += threadWeights;
+      if (onePass)
+        covariance += threadMoment;
+    }
+  }
+
+  if (sumWeights == 0.0)
+  {
+    covariance.zeros();
+    return sumWeights;
+  }
+
+  mean /= sumWeights;
+
+  if (onePass)
+  {
+    covariance /= sumWeights;
+    covariance -= mean * mean.t();
+    return sumWeights;
+  }
 
-  xCentered = x - arma::repmat(rowMean, 1, x.n_cols);
+  // The second pass accumulates the covariance of the centered points.
+  #pragma omp parallel
+  {
+    arma::mat threadCovariance(x.n_rows, x.n_rows, arma::fill::zeros);
+    arma::mat scaled;
+
+    #pragma omp for schedule(dynamic)
+    for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+    {
+      const size_t begin = b * blockSize;
+      const size_t end = std::min(begin + blockSize, (size_t) x.n_cols);
+
+      scaled = x.cols(begin, end - 1);
+      for (size_t i = 0; i < scaled.n_cols; ++i)
+        scaled.col(i) = std::sqrt(weights[begin + i]) * (scaled.col(i) - mean);
+
+      threadCovariance += scaled * scaled.t();
+    }
+
+    #pragma omp critical(WeightedCovarianceSum)
+    covariance += threadCovariance;
+  }
+
+  covariance /= sumWeights;
+  return sumWeights;
 }
 
 /**
@@ -57,18 +189,15 @@ void mlpack::math::WhitenUsingSVD(const arma::mat& x,
                                   arma::mat& xWhitened,
                                   arma::mat& whiteningMatrix)
 {
-  arma::mat covX, u, v, invSMatrix, temp1;
+  arma::mat u, v;
   arma::vec sVector;
 
-  covX = ccov(x);
-
-  svd(u, sVector, v, covX);
+  svd(u, sVector, v, ccov(x));
 
-  size_t d = sVector.n_elem;
-  invSMatrix.zeros(d, d);
-  invSMatrix.diag() = 1 / sqrt(sVector);
-
-  whiteningMatrix = v * invSMatrix * trans(u);
+  // Scaling the columns of v is the product with the diagonal matrix of the
+  // inverse square roots of the singular values, without forming it.
+  v.each_row() %= arma::trans(1 / sqrt(sVector));
+  whiteningMatrix = v * trans(u);
 
   xWhitened = whiteningMatrix * x;
 }
@@ -81,19 +210,17 @@ void mlpack::math::WhitenUsingEig(const arma::mat& x,
                                   arma::mat& xWhitened,
                                   arma::mat& whiteningMatrix)
 {
-  arma::mat diag, eigenvectors;
+  arma::mat eigenvectors;
   arma::vec eigenvalues;
 
   // Get eigenvectors of covariance of input matrix.
   eig_sym(eigenvalues, eigenvectors, ccov(x));
 
-  // Generate diagonal matrix using 1 / sqrt(eigenvalues) for each value.
+  // Our whitening matrix is diag(1 / sqrt(eigenvalues)) * eigenvectors^T; the
+  // rows are scaled directly instead of multiplying by the diagonal matrix.
   VectorPower(eigenvalues, -0.5);
-  diag.zeros(eigenvalues.n_elem, eigenvalues.n_elem);
-  diag.diag() = eigenvalues;
-
-  // Our whitening matrix is diag(1 / sqrt(eigenvectors)) * eigenvalues.
-  whiteningMatrix = diag * trans(eigenvectors);
+  whiteningMatrix = trans(eigenvectors);
+  whiteningMatrix.each_col() %= eigenvalues;
 
   // Now apply the whitening matrix.
   xWhitened = whiteningMatrix * x;
@@ -132,23 +259,22 @@ void mlpack::math::RandVector(arma::vec& v)
 void mlpack::math::Orthogonalize(const arma::mat& x, arma::mat& W)
 {
   // For a matrix A, A^N = V * D^N * V', where VDV' is the
-  // eigendecomposition of the matrix A.
-  arma::mat eigenvalues, eigenvectors;
+  // eigendecomposition of the matrix A.  V * D^N is computed by scaling the
+  // columns of V, so only one matrix product is needed.
+  arma::mat eigenvectors;
   arma::vec egval;
   eig_sym(egval, eigenvectors, ccov(x));
   VectorPower(egval, -0.5);
 
-  eigenvalues.zeros(egval.n_elem, egval.n_elem);
-  eigenvalues.diag() = egval;
-
-  arma::mat at = (eigenvectors * eigenvalues * trans(eigenvectors));
+  arma::mat scaled = eigenvectors;
+  scaled.each_row() %= trans(egval);
+  const arma::mat at = scaled * trans(eigenvectors);
 
   W = at * x;
 }
 
 /**
- * Orthogonalize x in-place.  This could be sped up by a custom
- * implementation.
+ * Orthogonalize x in-place.
  */
 void mlpack::math::Orthogonalize(arma::mat& x)
 {
@@ -220,18 +346,16 @@ void mlpack::math::Svec(const arma::mat& input, arma::vec& output)
   const size_t n = input.n_rows;
   const size_t n2bar = n * (n + 1) / 2;
 
-  output.zeros(n2bar);
+  output.set_size(n2bar);
 
-  size_t idx = 0;
-  for (size_t i = 0; i < n; i++)
+  // Row i starts at SvecIndex(i, i, n), so the rows can be filled in parallel.
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t i = 0; i < (omp_size_t) n; i++)
   {
-    for (size_t j = i; j < n; j++)
-    {
-      if (i == j)
-        output(idx++) = input(i, j);
-      else
-        output(idx++) = M_SQRT2 * input(i, j);
-    }
+    size_t idx = SvecIndex(i, i, n);
+    output(idx++) = input(i, i);
+    for (size_t j = i + 1; j < n; j++)
+      output(idx++) = M_SQRT2 * input(i, j);
   }
 }
 
@@ -261,18 +385,17 @@ void mlpack::math::Smat(const arma::vec& input, arma::mat& output)
       (ceil((-1. + sqrt(1. + 8. * input.n_elem))/2.));
 
 
-  output.zeros(n, n);
+  output.set_size(n, n);
 
-  size_t idx = 0;
-  for (size_t i = 0; i < n; i++)
+  // Each element is written by the thread of the smaller of its row and
+  // column, so the rows of the upper triangle can be filled in parallel.
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t i = 0; i < (omp_size_t) n; i++)
   {
-    for (size_t j = i; j < n; j++)
-    {
-      if (i == j)
-        output(i, j) = input(idx++);
-      else
-        output(i, j) = output(j, i) = M_SQRT1_2 * input(idx++);
-    }
+    size_t idx = SvecIndex(i, i, n);
+    output(i, i) = input(idx++);
+    for (size_t j = i + 1; j < n; j++)
+      output(i, j) = output(j, i) = M_SQRT1_2 * input(idx++);
   }
 }
 
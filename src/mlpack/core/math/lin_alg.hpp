@@ -36,6 +36,42 @@ void VectorPower(arma::vec& vec, const double power);
  */
 void Center(const arma::mat& x, arma::mat& xCentered);
 
+/**
+ * Centers a matrix in place, by subtracting the mean of each row from the row.
+ * Only the vector of means is allocated.
+ *
+ * @param x Matrix to center.
+ */
+void CenterInPlace(arma::mat& x);
+
+/**
+ * Compute the weighted mean and covariance of the columns of a matrix,
+ *
+ *   mean = sum_i w_i x_i / W,
+ *   covariance = sum_i w_i (x_i - mean) (x_i - mean)^T / W,
+ *
+ * where W is the sum of the weights.  The columns are processed in blocks in
+ * parallel; each block is centered and scaled by sqrt(w_i), so that its
+ * contribution to the covariance is a single symmetric rank-k product.  With
+ * onePass, the mean and the second moment are accumulated in the same pass over
+ * the data and the covariance is the second moment minus the outer product of
+ * the mean; that reads the data only once but is less accurate when the mean
+ * is large compared to the spread of the data.  If the weights sum to zero,
+ * the mean and the covariance are zero.
+ *
+ * @param x Input matrix (one point per column).
+ * @param weights Nonnegative weight of each point.
+ * @param mean Vector to store the weighted mean in.
+ * @param covariance Matrix to store the weighted covariance in.
+ * @param onePass Whether to compute the mean and covariance in one pass.
+ * @return The sum of the weights.
+ */
+double WeightedCovariance(const arma::mat& x,
+                          const arma::vec& weights,
+                          arma::vec& mean,
+                          arma::mat& covariance,
+                          const bool onePass = false);
+
 /**
  * Whitens a matrix using the singular value decomposition of the covariance
  * matrix. Whitening means the covariance matrix of the result is the identity
@@ -65,8 +101,7 @@ void RandVector(arma::vec& v);
 void Orthogonalize(const arma::mat& x, arma::mat& W);
 
 /**
- * Orthogonalize x in-place.  This could be sped up by a custom
- * implementation.
+ * Orthogonalize x in-place.
  */
 void Orthogonalize(arma::mat& x);
 
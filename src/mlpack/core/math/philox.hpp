@@ -0,0 +1,180 @@
+/**
+ * @file philox.hpp
+ *
+ * An implementation of the Philox4x32-10 counter-based random number
+ * generator.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_MATH_PHILOX_HPP
+#define MLPACK_CORE_MATH_PHILOX_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+namespace mlpack {
+namespace math {
+
+/**
+ * The Philox4x32-10 counter-based random number generator.  The n-th block of
+ * four outputs is a fixed bijection (ten rounds of multiplications and xors)
+ * of the counter n under a key, so a generator is fully described by its key
+ * and its position, and jumping ahead is free.  The key is made of the seed
+ * and a stream number: the streams of a seed are independent, so parallel code
+ * can give each thread, or better each independent piece of work, its own
+ * stream, and get the same numbers whatever the number of threads.
+ *
+ * This satisfies the requirements of a UniformRandomBitGenerator, so it can be
+ * used with the distributions of the standard library.
+ *
+ * For more information, see the following.
+ *
+ * @code
+ * @inproceedings{salmon2011parallel,
+ *   title     = {Parallel Random Numbers: As Easy as 1, 2, 3},
+ *   author    = {Salmon, John K. and Moraes, Mark A. and Dror, Ron O. and
+ *                Shaw, David E.},
+ *   booktitle = {Proceedings of the International Conference for High
+ *                Performance Computing, Networking, Storage and Analysis},
+ *   year      = {2011}
+ * }
+ * @endcode
+ */
+class Philox
+{
+ public:
+  //! The type of the generated numbers.
+  typedef uint32_t result_type;
+
+  /**
+   * Create the generator of the given stream of the given seed, at the start
+   * of the stream.
+   *
+   * @param seed Seed of the generator.
+   * @param stream Stream number.
+   */
+  Philox(const uint64_t seed = 0, const uint64_t stream = 0)
+  {
+    Seed(seed, stream);
+  }
+
+  /**
+   * Move to the start of the given stream of the given seed.
+   *
+   * @param seed Seed of the generator.
+   * @param stream Stream number.
+   */
+  void Seed(const uint64_t seed, const uint64_t stream = 0)
+  {
+    key[0] = (uint32_t) seed;
+    key[1] = (uint32_t) (seed >> 32);
+    counter[0] = 0;
+    counter[1] = 0;
+    counter[2] = (uint32_t) stream;
+    counter[3] = (uint32_t) (stream >> 32);
+    position = 4;
+  }
+
+  //! Generate the next number.
+  result_type operator()()
+  {
+    if (position == 4)
+    {
+      Generate();
+      position = 0;
+    }
+
+    return output[position++];
+  }
+
+  /**
+   * Skip the given number of outputs.  This takes constant time.
+   *
+   * @param n Number of outputs to skip.
+   */
+  void Discard(uint64_t n)
+  {
+    // Use up the current block first.
+    while (n > 0 && position < 4)
+    {
+      ++position;
+      --n;
+    }
+
+    // Skip whole blocks by moving the counter, then start the last one.
+    Increment(n / 4);
+    if (n % 4 != 0)
+    {
+      Generate();
+      position = n % 4;
+    }
+  }
+
+  //! Get the smallest number that can be generated.
+  static constexpr result_type min() { return 0; }
+  //! Get the largest number that can be generated.
+  static constexpr result_type max()
+  { return std::numeric_limits<result_type>::max(); }
+
+ private:
+  //! Compute the block of the current counter, and move the counter forward.
+  void Generate()
+  {
+    uint32_t c[4] = { counter[0], counter[1], counter[2], counter[3] };
+    uint32_t k[2] = { key[0], key[1] };
+    for (size_t round = 0; round < 10; ++round)
+    {
+      const uint64_t product0 = (uint64_t) 0xD2511F53 * c[0];
+      const uint64_t product1 = (uint64_t) 0xCD9E8D57 * c[2];
+      const uint32_t next[4] = {
+          (uint32_t) (product1 >> 32) ^ c[1] ^ k[0],
+          (uint32_t) product1,
+          (uint32_t) (product0 >> 32) ^ c[3] ^ k[1],
+          (uint32_t) product0 };
+      c[0] = next[0];
+      c[1] = next[1];
+      c[2] = next[2];
+      c[3] = next[3];
+
+      k[0] += 0x9E3779B9;
+      k[1] += 0xBB67AE85;
+    }
+
+    output[0] = c[0];
+    output[1] = c[1];
+    output[2] = c[2];
+    output[3] = c[3];
+    Increment(1);
+  }
+
+  //! Move the counter (the first two words) forward by the given amount.
+  void Increment(const uint64_t n)
+  {
+    const uint64_t low = ((uint64_t) counter[1] << 32 | counter[0]) + n;
+    counter[0] = (uint32_t) low;
+    counter[1] = (uint32_t) (low >> 32);
+  }
+
+  //! The key: the seed.
+  uint32_t key[2];
+
+  //! The counter: the block number in the first two words, and the stream
+  //! number in the last two.
+  uint32_t counter[4];
+
+  //! The current block of outputs.
+  uint32_t output[4];
+
+  //! The position of the next output in the current block (4 if it is used
+  //! up).
+  size_t position;
+};
+
+} // namespace math
+} // namespace mlpack
+
+#endif
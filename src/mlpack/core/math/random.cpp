@@ -8,6 +8,8 @@
  * 3-clause BSD license along with mlpack.  If not, see
  * http://www.opensource.org/licenses/BSD-3-Clause for more information.
  */
+#include <atomic>
+#include <cstdint>
 #include <random>
 #include <mlpack/mlpack_export.hpp>
 
@@ -20,6 +22,10 @@ MLPACK_EXPORT std::mt19937 randGen;
 MLPACK_EXPORT std::uniform_real_distribution<> randUniformDist(0.0, 1.0);
 // Global normal distribution.
 MLPACK_EXPORT std::normal_distribution<> randNormalDist(0.0, 1.0);
+// Seed of the random streams.
+MLPACK_EXPORT std::atomic<uint64_t> randSeed(0);
+// Number of calls to RandomSeed().
+MLPACK_EXPORT std::atomic<size_t> randSeedVersion(0);
 
 } // namespace math
 } // namespace mlpack
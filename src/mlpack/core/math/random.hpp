@@ -14,6 +14,15 @@
 #include <mlpack/prereqs.hpp>
 #include <mlpack/mlpack_export.hpp>
 #include <random>
+#include <algorithm>
+#include <atomic>
+#include <limits>
+
+#include "philox.hpp"
+
+#ifdef HAS_OPENMP
+  #include <omp.h>
+#endif
 
 namespace mlpack {
 namespace math /** Miscellaneous math routines. */ {
@@ -23,17 +32,23 @@ namespace math /** Miscellaneous math routines. */ {
  * correctly on Windows.
  */
 
-// Global random object.
+// Global random object (not thread-safe; the functions below don't use it).
 extern MLPACK_EXPORT std::mt19937 randGen;
 // Global uniform distribution.
 extern MLPACK_EXPORT std::uniform_real_distribution<> randUniformDist;
 // Global normal distribution.
 extern MLPACK_EXPORT std::normal_distribution<> randNormalDist;
 
+// Seed of the random streams.
+extern MLPACK_EXPORT std::atomic<uint64_t> randSeed;
+// Number of calls to RandomSeed(), so that the threads notice a new seed.
+extern MLPACK_EXPORT std::atomic<size_t> randSeedVersion;
+
 /**
- * Set the random seed used by the random functions (Random() and RandInt()).
- * The seed is casted to a 32-bit integer before being given to the random
- * number generator, but a size_t is taken as a parameter for API consistency.
+ * Set the random seed used by the random functions (Random(), RandInt(),
+ * RandNormal() and the random streams), by the global generator randGen, and
+ * by Armadillo.  The global generator is seeded with the seed casted to a
+ * 32-bit integer.
  *
  * @param seed Seed for the random number generator.
  */
@@ -42,6 +57,109 @@ inline void RandomSeed(const size_t seed)
   randGen.seed((uint32_t) seed);
   srand((unsigned int) seed);
   arma::arma_rng::set_seed(seed);
+  randSeed = seed;
+  ++randSeedVersion;
+}
+
+/**
+ * Get the generator of the given stream of the current seed.  Giving each
+ * independent piece of parallel work (each tree of a forest, each
+ * initialization, ...) its own stream makes the results the same whatever the
+ * number of threads and whatever the order in which the work is done.  Streams
+ * from 2^63 on are used by the threads (see ThreadRandom()).
+ *
+ * @param stream Stream number (less than 2^63).
+ */
+inline Philox RandomStream(const uint64_t stream)
+{
+  return Philox(randSeed, stream);
+}
+
+/**
+ * The random state of a thread: its generator, and a normal distribution
+ * (which keeps the second number of each pair it draws).
+ */
+struct ThreadRandomState
+{
+  ThreadRandomState() : version(std::numeric_limits<size_t>::max()) { }
+
+  //! The generator of the thread.
+  Philox generator;
+  //! The normal distribution of the thread.
+  std::normal_distribution<> normal;
+  //! The value of randSeedVersion the generator was seeded at.
+  size_t version;
+};
+
+/**
+ * Get the random state of the calling thread.  OpenMP thread i uses stream
+ * 2^63 + i of the current seed, so the threads never need a lock and the
+ * results of a given number of threads are reproducible.  Other threads use
+ * the stream of the main thread, so they should use RandomStream() instead.
+ */
+inline ThreadRandomState& ThreadRandom()
+{
+  static thread_local ThreadRandomState state;
+  if (state.version != randSeedVersion)
+  {
+    uint64_t thread = 0;
+    #ifdef HAS_OPENMP
+      thread = omp_get_thread_num();
+    #endif
+    state.version = randSeedVersion;
+    state.generator.Seed(randSeed, ((uint64_t) 1 << 63) | thread);
+    state.normal.reset();
+  }
+
+  return state;
+}
+
+/**
+ * While an object of this class exists, the random functions called by the
+ * thread that created it (Random(), RandInt(), RandNormal(), ...) draw from
+ * the given stream of the current seed instead of the stream of the thread.
+ * This lets a piece of parallel work that calls code using those functions
+ * (for instance one of several restarts of an algorithm) get the same random
+ * numbers whatever thread it runs on.  The previous state of the thread is
+ * restored on destruction.
+ */
+class RandomStreamScope
+{
+ public:
+  /**
+   * Make the calling thread draw from the given stream.
+   *
+   * @param stream Stream number (less than 2^63).
+   */
+  RandomStreamScope(const uint64_t stream) :
+      state(ThreadRandom()),
+      saved(state)
+  {
+    state.generator = RandomStream(stream);
+    state.normal.reset();
+  }
+
+  //! Restore the previous random state of the thread.
+  ~RandomStreamScope() { state = saved; }
+
+ private:
+  //! The random state of the thread.
+  ThreadRandomState& state;
+  //! The random state of the thread before this scope.
+  ThreadRandomState saved;
+};
+
+/**
+ * Generates a uniform random number in [0, 1) from the given generator, with
+ * 53 random bits.
+ *
+ * @param generator Generator to use.
+ */
+inline double Random(Philox& generator)
+{
+  const uint32_t high = generator() >> 5;
+  const uint32_t low = generator() >> 6;
+  return (high * 67108864.0 + low) * (1.0 / 9007199254740992.0);
 }
 
 /**
@@ -49,7 +167,7 @@ inline void RandomSeed(const size_t seed)
  */
 inline double Random()
 {
-  return randUniformDist(randGen);
+  return Random(ThreadRandom().generator);
 }
 
 /**
@@ -57,7 +175,7 @@ inline double Random()
  */
 inline double Random(const double lo, const double hi)
 {
-  return lo + (hi - lo) * randUniformDist(randGen);
+  return lo + (hi - lo) * Random();
 }
 
 /**
@@ -65,7 +183,7 @@ inline double Random(const double lo, const double hi)
  */
 inline int RandInt(const int hiExclusive)
 {
-  return (int) std::floor((double) hiExclusive * randUniformDist(randGen));
+  return (int) std::floor((double) hiExclusive * Random());
 }
 
 /**
@@ -73,8 +191,7 @@ inline int RandInt(const int hiExclusive)
  */
 inline int RandInt(const int lo, const int hiExclusive)
 {
-  return lo + (int) std::floor((double) (hiExclusive - lo)
-                               * randUniformDist(randGen));
+  return lo + (int) std::floor((double) (hiExclusive - lo) * Random());
 }
 
 /**
@@ -82,7 +199,8 @@ inline int RandInt(const int lo, const int hiExclusive)
  */
 inline double RandNormal()
 {
-  return randNormalDist(randGen);
+  ThreadRandomState& state = ThreadRandom();
+  return state.normal(state.generator);
 }
 
 /**
@@ -94,7 +212,7 @@ inline double RandNormal()
  */
 inline double RandNormal(const double mean, const double variance)
 {
-  return variance * randNormalDist(randGen) + mean;
+  return variance * RandNormal() + mean;
 }
 
 /**
@@ -135,6 +253,49 @@ inline void ObtainDistinctSamples(const size_t loInclusive,
   }
 }
 
+/**
+ * Obtains no more than maxNumSamples distinct samples, each in [loInclusive,
+ * hiExclusive), with the given random number generator.  The samples are drawn
+ * the same way as by the other overload (maxNumSamples draws with replacement,
+ * of which the distinct values are kept, in increasing order), but no memory
+ * proportional to the size of the range is used, and the given vector is
+ * reused as storage, so repeated calls with the same vector do not allocate
+ * once it is large enough.  Giving each thread its own generator and vector
+ * makes this safe to call from several threads at once.
+ *
+ * @param loInclusive The lower bound (inclusive).
+ * @param hiExclusive The high bound (exclusive).
+ * @param maxNumSamples The maximum number of samples to obtain.
+ * @param distinctSamples The samples that will be obtained.
+ * @param generator Random number generator to draw the samples with.
+ */
+template<typename RNGType>
+inline void ObtainDistinctSamples(const size_t loInclusive,
+                                  const size_t hiExclusive,
+                                  const size_t maxNumSamples,
+                                  std::vector<size_t>& distinctSamples,
+                                  RNGType& generator)
+{
+  const size_t samplesRangeSize = hiExclusive - loInclusive;
+
+  distinctSamples.clear();
+  if (samplesRangeSize > maxNumSamples)
+  {
+    std::uniform_int_distribution<size_t> dist(loInclusive, hiExclusive - 1);
+    for (size_t i = 0; i < maxNumSamples; i++)
+      distinctSamples.push_back(dist(generator));
+
+    std::sort(distinctSamples.begin(), distinctSamples.end());
+    distinctSamples.erase(std::unique(distinctSamples.begin(),
+        distinctSamples.end()), distinctSamples.end());
+  }
+  else
+  {
+    for (size_t i = 0; i < samplesRangeSize; i++)
+      distinctSamples.push_back(loInclusive + i);
+  }
+}
+
 } // namespace math
 } // namespace mlpack
 
@@ -0,0 +1,156 @@
+/**
+ * @file evaluate_block.hpp
+ *
+ * Compute the distances between one point and a contiguous block of points, or
+ * between two contiguous blocks of points, with any metric, using the fast
+ * evaluations of LMetric when possible.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_METRICS_EVALUATE_BLOCK_HPP
+#define MLPACK_CORE_METRICS_EVALUATE_BLOCK_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "lmetric.hpp"
+
+namespace mlpack {
+namespace metric {
+
+/**
+ * Compute the distances between the point a and the count points (columns) of
+ * b starting at index begin, and store them in distances.  The distances are
+ * computed one by one with metric.Evaluate(); this is the general case for
+ * metrics without a faster block evaluation.
+ *
+ * @param metric Metric to use.
+ * @param a Point to compute distances from.
+ * @param b Matrix holding the block of points.
+ * @param begin Index of the first point of the block.
+ * @param count Number of points in the block.
+ * @param distances Vector to store the distances in.
+ */
+template<typename MetricType, typename VecType, typename MatType>
+inline void EvaluateBlock(MetricType& metric,
+                          const VecType& a,
+                          const MatType& b,
+                          const size_t begin,
+                          const size_t count,
+                          arma::vec& distances)
+{
+  distances.set_size(count);
+  for (size_t i = 0; i < count; ++i)
+    distances[i] = metric.Evaluate(a, b.col(begin + i));
+}
+
+/**
+ * Compute the distances between the point a and the count points (columns) of
+ * the dense matrix b starting at index begin, using the block evaluation of
+ * LMetric.
+ */
+template<int Power, bool TakeRoot, typename VecType, typename eT>
+inline void EvaluateBlock(LMetric<Power, TakeRoot>& /* metric */,
+                          const VecType& a,
+                          const arma::Mat<eT>& b,
+                          const size_t begin,
+                          const size_t count,
+                          arma::vec& distances)
+{
+  LMetric<Power, TakeRoot>::Evaluate(a, b, begin, count, distances);
+}
+
+/**
+ * Compute the distances between the queryCount points (columns) of queries
+ * starting at index queryBegin and the referenceCount points of references
+ * starting at index referenceBegin.  Column i of distances holds the distances
+ * between query point queryBegin + i and each of the reference points.  This
+ * is the general case, which computes the exact distances one query point at
+ * a time with EvaluateBlock().  Other metrics (or other hardware) can overload
+ * this function to compute a whole tile at once.
+ *
+ * @param metric Metric to use.
+ * @param queries Matrix holding the block of query points.
+ * @param queryBegin Index of the first query point of the block.
+ * @param queryCount Number of query points in the block.
+ * @param references Matrix holding the block of reference points.
+ * @param referenceBegin Index of the first reference point of the block.
+ * @param referenceCount Number of reference points in the block.
+ * @param distances Matrix to store the distances in.
+ * @return Bound on the absolute error of the distances (0 here).
+ */
+template<typename MetricType, typename QueryMatType, typename ReferenceMatType>
+inline double EvaluateTile(MetricType& metric,
+                           const QueryMatType& queries,
+                           const size_t queryBegin,
+                           const size_t queryCount,
+                           const ReferenceMatType& references,
+                           const size_t referenceBegin,
+                           const size_t referenceCount,
+                           arma::mat& distances)
+{
+  distances.set_size(referenceCount, queryCount);
+  arma::vec queryDistances;
+  for (size_t i = 0; i < queryCount; ++i)
+  {
+    EvaluateBlock(metric, queries.col(queryBegin + i), references,
+        referenceBegin, referenceCount, queryDistances);
+    distances.col(i) = queryDistances;
+  }
+
+  return 0.0;
+}
+
+/**
+ * Compute the Euclidean (or squared Euclidean) distances between a block of
+ * query points and a block of reference points of dense matrices with one
+ * matrix multiplication, using ||q - r||^2 = ||q||^2 + ||r||^2 - 2 q^T r.
+ * Points that are close compared to their norms lose precision this way, so
+ * the returned bound on the absolute error of the distances is not zero, and
+ * the distances should only be used to decide which points need an exact
+ * evaluation.
+ */
+template<bool TakeRoot, typename eT>
+inline double EvaluateTile(LMetric<2, TakeRoot>& /* metric */,
+                           const arma::Mat<eT>& queries,
+                           const size_t queryBegin,
+                           const size_t queryCount,
+                           const arma::Mat<eT>& references,
+                           const size_t referenceBegin,
+                           const size_t referenceCount,
+                           arma::mat& distances)
+{
+  const arma::mat queryBlock = arma::conv_to<arma::mat>::from(
+      queries.cols(queryBegin, queryBegin + queryCount - 1));
+  const arma::mat referenceBlock = arma::conv_to<arma::mat>::from(
+      references.cols(referenceBegin, referenceBegin + referenceCount - 1));
+  const arma::rowvec queryNorms = arma::sum(arma::square(queryBlock), 0);
+  const arma::rowvec referenceNorms = arma::sum(arma::square(referenceBlock),
+      0);
+
+  distances = -2.0 * (referenceBlock.t() * queryBlock);
+  distances.each_col() += referenceNorms.t();
+  distances.each_row() += queryNorms;
+  distances.elem(arma::find(distances < 0.0)).zeros();
+
+  // Both this computation and the direct one round the squared distances by
+  // at most a small multiple of the dimensionality times the sum of the
+  // squared norms.
+  const double squaredTolerance = 8.0 * (queries.n_rows + 2) *
+      std::numeric_limits<eT>::epsilon() * (queryNorms.max() +
+      referenceNorms.max());
+
+  if (TakeRoot)
+  {
+    distances = arma::sqrt(distances);
+    return std::sqrt(squaredTolerance);
+  }
+
+  return squaredTolerance;
+}
+
+} // namespace metric
+} // namespace mlpack
+
+#endif
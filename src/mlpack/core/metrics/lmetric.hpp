@@ -83,6 +83,29 @@ class LMetric
   static typename VecTypeA::elem_type Evaluate(const VecTypeA& a,
                                                const VecTypeB& b);
 
+  /**
+   * Computes the distances between one point and a contiguous block of points
+   * (columns) of a dense matrix.  This is equivalent to calling Evaluate() for
+   * each of the points of the block, but it is considerably faster, since the
+   * distances to several points are computed at once, in a way that the
+   * compiler can vectorize.
+   *
+   * @tparam VecType Type of the point.
+   * @tparam eT Element type of the matrix.
+   * @param a Point to compute distances from.
+   * @param b Matrix holding the block of points.
+   * @param begin Index of the first point of the block.
+   * @param count Number of points in the block.
+   * @param distances Vector to store the distances in; it will be resized to
+   *     hold count elements.
+   */
+  template<typename VecType, typename eT>
+  static void Evaluate(const VecType& a,
+                       const arma::Mat<eT>& b,
+                       const size_t begin,
+                       const size_t count,
+                       arma::vec& distances);
+
   //! Serialize the metric (nothing to do).
   template<typename Archive>
   void serialize(Archive& /* ar */, const unsigned int /* version */) { }
@@ -91,6 +114,33 @@ class LMetric
   static const int Power = TPower;
   //! Whether or not the root is taken.
   static const bool TakeRoot = TTakeRoot;
+
+ private:
+  //! Add the contribution of a single dimension, where the points have values
+  //! x and y, to a running sum.
+  template<typename eT>
+  static eT Accumulate(const eT sum, const eT x, const eT y);
+
+  //! Turn a sum of the contributions of all dimensions into a distance.
+  template<typename eT>
+  static eT Finish(const eT sum);
+
+  //! Store the sums of the block in the given distances with the compiled
+  //! kernels, if there is one for this type; the sums of types other than
+  //! double go through a small buffer on the stack.
+  template<typename eT>
+  static bool BlockSums(const eT* point,
+                        const eT* block,
+                        const size_t dim,
+                        const size_t count,
+                        arma::vec& distances);
+
+  //! Store the sums of the block of double points directly in the distances.
+  static bool BlockSums(const double* point,
+                        const double* block,
+                        const size_t dim,
+                        const size_t count,
+                        arma::vec& distances);
 };
 
 // Convenience typedefs.
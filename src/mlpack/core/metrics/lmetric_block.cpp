@@ -0,0 +1,133 @@
+/**
+ * @file lmetric_block.cpp
+ *
+ * Implementation of the LMetricBlockSums() kernels for the L1 and L2 metrics.
+ * With GCC on x86-64 Linux, each kernel is compiled for AVX-512, AVX2 and the
+ * baseline instruction set, and the dynamic loader picks the best version the
+ * CPU supports when the program starts; so a binary compiled for baseline
+ * x86-64 still uses wide vector instructions where they are available.  Other
+ * platforms (including ARM, where NEON is always available) get one version.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "lmetric_block.hpp"
+
+#if defined(__GNUC__) && !defined(__clang__) && defined(__x86_64__) && \
+    defined(__linux__)
+  #define MLPACK_KERNEL_CLONES \
+      __attribute__((target_clones("avx512f", "avx2", "default")))
+#else
+  #define MLPACK_KERNEL_CLONES
+#endif
+
+namespace mlpack {
+namespace metric {
+
+/**
+ * Compute the sums for the given power.  This is inlined into each version of
+ * the kernels, so it is compiled for each instruction set.  Four points are
+ * handled at a time, so that the point only has to be loaded once for all of
+ * them, and the four independent sums can be vectorized.
+ */
+template<int Power, typename eT>
+inline force_inline void BlockSums(const eT* point,
+                                   const eT* block,
+                                   const size_t dim,
+                                   const size_t count,
+                                   eT* sums)
+{
+  size_t i = 0;
+  for (; i + 4 <= count; i += 4)
+  {
+    const eT* r0 = block + i * dim;
+    const eT* r1 = r0 + dim;
+    const eT* r2 = r1 + dim;
+    const eT* r3 = r2 + dim;
+
+    eT s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+    for (size_t d = 0; d < dim; ++d)
+    {
+      const eT d0 = point[d] - r0[d];
+      const eT d1 = point[d] - r1[d];
+      const eT d2 = point[d] - r2[d];
+      const eT d3 = point[d] - r3[d];
+      s0 += (Power == 1) ? std::abs(d0) : d0 * d0;
+      s1 += (Power == 1) ? std::abs(d1) : d1 * d1;
+      s2 += (Power == 1) ? std::abs(d2) : d2 * d2;
+      s3 += (Power == 1) ? std::abs(d3) : d3 * d3;
+    }
+
+    sums[i] = s0;
+    sums[i + 1] = s1;
+    sums[i + 2] = s2;
+    sums[i + 3] = s3;
+  }
+
+  for (; i < count; ++i)
+  {
+    const eT* r = block + i * dim;
+
+    eT s = 0;
+    for (size_t d = 0; d < dim; ++d)
+    {
+      const eT diff = point[d] - r[d];
+      s += (Power == 1) ? std::abs(diff) : diff * diff;
+    }
+
+    sums[i] = s;
+  }
+}
+
+MLPACK_KERNEL_CLONES
+bool LMetricBlockSums(std::integral_constant<int, 1>,
+                      const double* point,
+                      const double* block,
+                      const size_t dim,
+                      const size_t count,
+                      double* sums)
+{
+  BlockSums<1>(point, block, dim, count, sums);
+  return true;
+}
+
+MLPACK_KERNEL_CLONES
+bool LMetricBlockSums(std::integral_constant<int, 1>,
+                      const float* point,
+                      const float* block,
+                      const size_t dim,
+                      const size_t count,
+                      float* sums)
+{
+  BlockSums<1>(point, block, dim, count, sums);
+  return true;
+}
+
+MLPACK_KERNEL_CLONES
+bool LMetricBlockSums(std::integral_constant<int, 2>,
+                      const double* point,
+                      const double* block,
+                      const size_t dim,
+                      const size_t count,
+                      double* sums)
+{
+  BlockSums<2>(point, block, dim, count, sums);
+  return true;
+}
+
+MLPACK_KERNEL_CLONES
+bool LMetricBlockSums(std::integral_constant<int, 2>,
+                      const float* point,
+                      const float* block,
+                      const size_t dim,
+                      const size_t count,
+                      float* sums)
+{
+  BlockSums<2>(point, block, dim, count, sums);
+  return true;
+}
+
+} // namespace metric
+} // namespace mlpack
@@ -0,0 +1,91 @@
+/**
+ * @file lmetric_block.hpp
+ *
+ * Declaration of LMetricBlockSums(), which computes the sums of the
+ * contributions of each dimension to the distances between one point and a
+ * contiguous block of points.  The common cases (the L1 and L2 metrics on
+ * double and float points) are compiled in lmetric_block.cpp for several
+ * instruction sets, and the best one for the CPU is chosen at runtime.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_METRICS_LMETRIC_BLOCK_HPP
+#define MLPACK_CORE_METRICS_LMETRIC_BLOCK_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace metric {
+
+/**
+ * Compute, for each of the count points (stored contiguously, one after the
+ * other) starting at block, the sum over all dimensions of |point - block|^p,
+ * and store it in sums.  This is the general case, for which no kernel is
+ * compiled; it computes nothing and returns false, so the caller should
+ * compute the sums itself.
+ *
+ * @param power Power p of the metric.
+ * @param point Point to compute the sums for.
+ * @param block First of the points to compute the sums for.
+ * @param dim Dimensionality of the points.
+ * @param count Number of points in the block.
+ * @param sums Array of count elements to store the sums in.
+ * @return Whether the sums were computed.
+ */
+template<int Power, typename eT>
+inline bool LMetricBlockSums(std::integral_constant<int, Power> /* power */,
+                             const eT* /* point */,
+                             const eT* /* block */,
+                             const size_t /* dim */,
+                             const size_t /* count */,
+                             eT* /* sums */)
+{
+  return false;
+}
+
+/**
+ * Don't document these with doxygen; these declarations aren't helpful to
+ * users.
+ *
+ * @cond
+ */
+
+bool LMetricBlockSums(std::integral_constant<int, 1>,
+                      const double* point,
+                      const double* block,
+                      const size_t dim,
+                      const size_t count,
+                      double* sums);
+
+bool LMetricBlockSums(std::integral_constant<int, 1>,
+                      const float* point,
+                      const float* block,
+                      const size_t dim,
+                      const size_t count,
+                      float* sums);
+
+bool LMetricBlockSums(std::integral_constant<int, 2>,
+                      const double* point,
+                      const double* block,
+                      const size_t dim,
+                      const size_t count,
+                      double* sums);
+
+bool LMetricBlockSums(std::integral_constant<int, 2>,
+                      const float* point,
+                      const float* block,
+                      const size_t dim,
+                      const size_t count,
+                      float* sums);
+
+/**
+ * @endcond
+ */
+
+} // namespace metric
+} // namespace mlpack
+
+#endif
@@ -14,6 +14,7 @@
 
 // In case it hasn't been included.
 #include "lmetric.hpp"
+#include "lmetric_block.hpp"
 
 namespace mlpack {
 namespace metric {
@@ -106,6 +107,137 @@ typename VecTypeA::elem_type LMetric<INT_MAX, false>::Evaluate(
   return arma::as_scalar(arma::max(arma::abs(a - b)));
 }
 
+template<int TPower, bool TTakeRoot>
+template<typename eT>
+inline force_inline eT LMetric<TPower, TTakeRoot>::Accumulate(
+    const eT sum,
+    const eT x,
+    const eT y)
+{
+  // Computing the absolute difference like this also works for unsigned types.
+  const eT difference = (x > y) ? (x - y) : (y - x);
+
+  // All of these conditions are known at compile-time.
+  if (Power == 1)
+    return sum + difference;
+  else if (Power == 2)
+    return sum + difference * difference;
+  else if (Power == INT_MAX)
+    return std::max(sum, difference);
+  else
+    return sum + (eT) std::pow(difference, Power);
+}
+
+template<int TPower, bool TTakeRoot>
+template<typename eT>
+inline force_inline eT LMetric<TPower, TTakeRoot>::Finish(const eT sum)
+{
+  if (!TakeRoot || Power == 1 || Power == INT_MAX)
+    return sum;
+  else if (Power == 2)
+    return (eT) std::sqrt(sum);
+  else
+    return (eT) std::pow(sum, 1.0 / Power);
+}
+
+template<int TPower, bool TTakeRoot>
+template<typename eT>
+bool LMetric<TPower, TTakeRoot>::BlockSums(const eT* point,
+                                           const eT* block,
+                                           const size_t dim,
+                                           const size_t count,
+                                           arma::vec& distances)
+{
+  const size_t bufferSize = 64;
+  eT sums[bufferSize];
+  for (size_t i = 0; i < count; i += bufferSize)
+  {
+    const size_t n = std::min(bufferSize, count - i);
+    if (!LMetricBlockSums(std::integral_constant<int, Power>(), point,
+        block + i * dim, dim, n, sums))
+      return false;
+
+    for (size_t j = 0; j < n; ++j)
+      distances[i + j] = sums[j];
+  }
+
+  return true;
+}
+
+template<int TPower, bool TTakeRoot>
+inline bool LMetric<TPower, TTakeRoot>::BlockSums(const double* point,
+                                                  const double* block,
+                                                  const size_t dim,
+                                                  const size_t count,
+                                                  arma::vec& distances)
+{
+  return LMetricBlockSums(std::integral_constant<int, Power>(), point, block,
+      dim, count, distances.memptr());
+}
+
+template<int TPower, bool TTakeRoot>
+template<typename VecType, typename eT>
+void LMetric<TPower, TTakeRoot>::Evaluate(const VecType& a,
+                                          const arma::Mat<eT>& b,
+                                          const size_t begin,
+                                          const size_t count,
+                                          arma::vec& distances)
+{
+  distances.set_size(count);
+
+  // Make sure the point is contiguous in memory, whatever VecType is.
+  const arma::Col<eT> point(a);
+  const eT* p = point.memptr();
+  const size_t dim = b.n_rows;
+
+  // The common cases are computed by kernels compiled for several instruction
+  // sets, the best of which is chosen at runtime.
+  if (count > 0 && BlockSums(p, b.colptr(begin), dim, count, distances))
+  {
+    for (size_t i = 0; i < count; ++i)
+      distances[i] = Finish(distances[i]);
+    return;
+  }
+
+  // Handle four points at a time.  The four sums are independent, so they can
+  // be computed in the lanes of vector registers, and the point only has to be
+  // loaded once for all four of them.
+  size_t i = 0;
+  for (; i + 4 <= count; i += 4)
+  {
+    const eT* r0 = b.colptr(begin + i);
+    const eT* r1 = r0 + dim;
+    const eT* r2 = r1 + dim;
+    const eT* r3 = r2 + dim;
+
+    eT s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+    for (size_t d = 0; d < dim; ++d)
+    {
+      s0 = Accumulate(s0, p[d], r0[d]);
+      s1 = Accumulate(s1, p[d], r1[d]);
+      s2 = Accumulate(s2, p[d], r2[d]);
+      s3 = Accumulate(s3, p[d], r3[d]);
+    }
+
+    distances[i] = Finish(s0);
+    distances[i + 1] = Finish(s1);
+    distances[i + 2] = Finish(s2);
+    distances[i + 3] = Finish(s3);
+  }
+
+  // Handle the remaining points.
+  for (; i < count; ++i)
+  {
+    const eT* r = b.colptr(begin + i);
+
+    eT s = 0;
+    for (size_t d = 0; d < dim; ++d)
+      s = Accumulate(s, p[d], r[d]);
+
+    distances[i] = Finish(s);
+  }
+}
+
 } // namespace metric
 } // namespace mlpack
 
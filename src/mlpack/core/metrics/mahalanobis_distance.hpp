@@ -32,8 +32,9 @@ namespace metric {
  *
  * Because each evaluation multiplies (x_1 - x_2) by the covariance matrix, it
  * may be much quicker to use an LMetric and simply stretch the actual dataset
- * itself before performing any evaluations.  However, this class is provided
- * for convenience.
+ * itself before performing any evaluations; Transform() does that, and the
+ * MahalanobisSearch and MahalanobisRangeSearch classes use it to search with
+ * trees in Euclidean space.  However, this class is provided for convenience.
  *
  * Similar to the LMetric class, this offers a template parameter TakeRoot
  * which, when set to false, will instead evaluate the distance
@@ -88,6 +89,18 @@ class MahalanobisDistance
   template<typename VecTypeA, typename VecTypeB>
   double Evaluate(const VecTypeA& a, const VecTypeB& b);
 
+  /**
+   * Map the given points (one per column) into the space where this distance
+   * is the Euclidean distance: with Q = L^T L, the output is L times the
+   * input, so that d(x, y) = ||L x - L y||.  L is the Cholesky factor of Q, or,
+   * if Q is only positive semidefinite, is computed from the eigendecomposition
+   * of Q.  If the covariance matrix has not been set, the points are copied.
+   *
+   * @param input Points to transform.
+   * @param output Matrix to store the transformed points in.
+   */
+  void Transform(const arma::mat& input, arma::mat& output) const;
+
   /**
    * Access the covariance matrix.
    *
@@ -25,9 +25,8 @@ template<typename VecTypeA, typename VecTypeB>
 double MahalanobisDistance<false>::Evaluate(const VecTypeA& a,
                                             const VecTypeB& b)
 {
-  arma::vec m = (a - b);
-  arma::mat out = trans(m) * covariance * m; // 1x1
-  return out[0];
+  const arma::vec m = (a - b);
+  return arma::dot(m, covariance * m);
 }
 /**
  * Specialization for rooted case.  This requires one extra evaluation of
@@ -42,9 +41,34 @@ double MahalanobisDistance<true>::Evaluate(const VecTypeA& a,
   if (covariance.n_rows == 0)
     covariance = arma::eye<arma::mat>(a.n_elem, a.n_elem);
 
-  arma::vec m = (a - b);
-  arma::mat out = trans(m) * covariance * m; // 1x1;
-  return sqrt(out[0]);
+  const arma::vec m = (a - b);
+  return sqrt(arma::dot(m, covariance * m));
+}
+
+template<bool TakeRoot>
+void MahalanobisDistance<TakeRoot>::Transform(const arma::mat& input,
+                                              arma::mat& output) const
+{
+  if (covariance.n_rows == 0)
+  {
+    output = input;
+    return;
+  }
+
+  // Q = R^T R, so (x - y)^T Q (x - y) = ||R x - R y||^2.
+  arma::mat factor;
+  if (!arma::chol(factor, covariance))
+  {
+    // Q is only positive semidefinite; with Q = V diag(lambda) V^T, the factor
+    // is diag(sqrt(lambda)) V^T.
+    arma::vec eigenvalues;
+    arma::mat eigenvectors;
+    arma::eig_sym(eigenvalues, eigenvectors, covariance);
+    factor = arma::diagmat(arma::sqrt(arma::clamp(eigenvalues, 0.0,
+        arma::datum::inf))) * eigenvectors.t();
+  }
+
+  output = factor * input;
 }
 
 // Serialize the Mahalanobis distance.
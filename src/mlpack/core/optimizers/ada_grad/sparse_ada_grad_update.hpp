@@ -0,0 +1,118 @@
+/**
+ * @file sparse_ada_grad_update.hpp
+ *
+ * AdaGrad update for Stochastic Gradient Descent with sparse gradients.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_OPTIMIZERS_ADA_GRAD_SPARSE_ADA_GRAD_UPDATE_HPP
+#define MLPACK_CORE_OPTIMIZERS_ADA_GRAD_SPARSE_ADA_GRAD_UPDATE_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace optimization {
+
+/**
+ * The AdaGrad update policy (see AdaGradUpdate) for functions with a sparse
+ * gradient.  When the function gives the gradient of its batches as a sparse
+ * matrix (like LogisticRegressionFunction; see HasSparseGradient), SGD passes
+ * it to this policy as is, and only the coordinates with a nonzero gradient are
+ * updated.  Since AdaGrad does not change the coordinates with a zero
+ * gradient, the steps are the same as the ones of AdaGradUpdate.
+ */
+class SparseAdaGradUpdate
+{
+ public:
+  /**
+   * Construct the sparse AdaGrad update policy with given epsilon parameter.
+   *
+   * @param epsilon The epsilon value used to initialise the squared gradient
+   *        parameter.
+   */
+  SparseAdaGradUpdate(const double epsilon = 1e-8) : epsilon(epsilon)
+  {
+    // Nothing to do.
+  }
+
+  /**
+   * The Initialize method is called by SGD Optimizer method before the start of
+   * the iteration update process.  The squared gradient matrix is initialized
+   * to the zeros matrix with the same size as the gradient matrix.
+   *
+   * @param rows Number of rows in the gradient matrix.
+   * @param cols Number of columns in the gradient matrix.
+   */
+  void Initialize(const size_t rows, const size_t cols)
+  {
+    // Initialize an empty matrix for sum of squares of parameter gradient.
+    squaredGradient = arma::zeros<arma::mat>(rows, cols);
+  }
+
+  /**
+   * Update step for SGD with a dense gradient (see AdaGradUpdate).
+   *
+   * @param iterate Parameters that minimize the function.
+   * @param stepSize Step size to be used for the given iteration.
+   * @param gradient The gradient matrix.
+   */
+  void Update(arma::mat& iterate,
+              const double stepSize,
+              const arma::mat& gradient)
+  {
+    squaredGradient += (gradient % gradient);
+    iterate -= (stepSize * gradient) / (arma::sqrt(squaredGradient) + epsilon);
+  }
+
+  /**
+   * Update step for SGD with a sparse gradient: only the coordinates with a
+   * nonzero gradient are visited.
+   *
+   * @param iterate Parameters that minimize the function.
+   * @param stepSize Step size to be used for the given iteration.
+   * @param gradient The sparse gradient matrix.
+   */
+  void Update(arma::mat& iterate,
+              const double stepSize,
+              const arma::sp_mat& gradient)
+  {
+    for (arma::sp_mat::const_iterator it = gradient.begin();
+        it != gradient.end(); ++it)
+    {
+      const size_t i = it.row() + it.col() * iterate.n_rows;
+      squaredGradient[i] += (*it) * (*it);
+      iterate[i] -= (stepSize * (*it)) / (std::sqrt(squaredGradient[i]) +
+          epsilon);
+    }
+  }
+
+  //! Get the value used to initialise the squared gradient parameter.
+  double Epsilon() const { return epsilon; }
+  //! Modify the value used to initialise the squared gradient parameter.
+  double& Epsilon() { return epsilon; }
+
+  /**
+   * Serialize the update policy (for checkpoints of the optimization).
+   */
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */)
+  {
+    ar & BOOST_SERIALIZATION_NVP(epsilon);
+    ar & BOOST_SERIALIZATION_NVP(squaredGradient);
+  }
+
+ private:
+  // The epsilon value used to initialise the squared gradient parameter.
+  double epsilon;
+
+  // The squared gradient matrix.
+  arma::mat squaredGradient;
+};
+
+} // namespace optimization
+} // namespace mlpack
+
+#endif
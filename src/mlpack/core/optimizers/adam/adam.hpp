@@ -157,6 +157,16 @@ class AdamType
   //! Modify whether or not the individual functions are shuffled.
   bool& Shuffle() { return optimizer.Shuffle(); }
 
+  //! Get the checkpoint settings (a checkpoint is saved every Interval()
+  //! passes over the data).
+  const OptimizerCheckpoint& Checkpoint() const
+  {
+    return optimizer.Checkpoint();
+  }
+  //! Modify the checkpoint settings (a checkpoint is saved every Interval()
+  //! passes over the data).
+  OptimizerCheckpoint& Checkpoint() { return optimizer.Checkpoint(); }
+
  private:
   //! The Stochastic Gradient Descent object with Adam policy.
   SGD<UpdateRule> optimizer;
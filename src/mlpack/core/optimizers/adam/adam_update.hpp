@@ -122,6 +122,20 @@ class AdamUpdate
   //! Modify the second moment coefficient.
   double& Beta2() { return beta2; }
 
+  /**
+   * Serialize the update policy (for checkpoints of the optimization).
+   */
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */)
+  {
+    ar & BOOST_SERIALIZATION_NVP(epsilon);
+    ar & BOOST_SERIALIZATION_NVP(beta1);
+    ar & BOOST_SERIALIZATION_NVP(beta2);
+    ar & BOOST_SERIALIZATION_NVP(m);
+    ar & BOOST_SERIALIZATION_NVP(v);
+    ar & BOOST_SERIALIZATION_NVP(iteration);
+  }
+
  private:
   // The epsilon value used to initialise the squared gradient parameter.
   double epsilon;
@@ -0,0 +1,229 @@
+/**
+ * @file lazy_adam_update.hpp
+ *
+ * Lazy Adam update for Stochastic Gradient Descent with sparse gradients.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_OPTIMIZERS_ADAM_LAZY_ADAM_UPDATE_HPP
+#define MLPACK_CORE_OPTIMIZERS_ADAM_LAZY_ADAM_UPDATE_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace optimization {
+
+/**
+ * The Adam update policy (see AdamUpdate) for functions with a sparse gradient.
+ * When the function gives the gradient of its batches as a sparse matrix (like
+ * LogisticRegressionFunction; see HasSparseGradient), SGD passes it to this
+ * policy as is, and only the coordinates with a nonzero gradient are updated.
+ *
+ * The moment estimates of a coordinate are decayed in closed form for the steps
+ * where its gradient was zero when the coordinate is next updated, so they are
+ * the same as the ones of AdamUpdate.  Unlike AdamUpdate, though, the
+ * coordinate is not moved during those steps (Adam would move it by its decayed
+ * first moment); this is the "lazy" Adam commonly used for sparse problems such
+ * as embeddings, and its steps are the ones of AdamUpdate only when every
+ * coordinate has a nonzero gradient at every step.  Dense gradients are handled
+ * exactly like AdamUpdate.
+ */
+class LazyAdamUpdate
+{
+ public:
+  /**
+   * Construct the lazy Adam update policy with the given parameters.
+   *
+   * @param epsilon The epsilon value used to initialise the squared gradient
+   *        parameter.
+   * @param beta1 The smoothing parameter.
+   * @param beta2 The second moment coefficient.
+   */
+  LazyAdamUpdate(const double epsilon = 1e-8,
+                 const double beta1 = 0.9,
+                 const double beta2 = 0.999) :
+    epsilon(epsilon),
+    beta1(beta1),
+    beta2(beta2),
+    iteration(0),
+    denseIteration(0),
+    deferred(false)
+  {
+    // Nothing to do.
+  }
+
+  /**
+   * The Initialize method is called by SGD Optimizer method before the start of
+   * the iteration update process.
+   *
+   * @param rows Number of rows in the gradient matrix.
+   * @param cols Number of columns in the gradient matrix.
+   */
+  void Initialize(const size_t rows, const size_t cols)
+  {
+    m = arma::zeros<arma::mat>(rows, cols);
+    v = arma::zeros<arma::mat>(rows, cols);
+    lastIteration = arma::zeros<arma::Mat<size_t>>(rows, cols);
+    iteration = 0;
+    denseIteration = 0;
+    deferred = false;
+  }
+
+  /**
+   * Update step for Adam with a dense gradient (see AdamUpdate).
+   *
+   * @param iterate Parameters that minimize the function.
+   * @param stepSize Step size to be used for the given iteration.
+   * @param gradient The gradient matrix.
+   */
+  void Update(arma::mat& iterate,
+              const double stepSize,
+              const arma::mat& gradient)
+  {
+    // Increment the iteration counter variable.
+    ++iteration;
+
+    // The decay that was deferred by the sparse updates has to be applied
+    // first.
+    if (deferred)
+    {
+      for (size_t i = 0; i < m.n_elem; ++i)
+      {
+        const double skipped = Skipped(i);
+        m[i] *= std::pow(beta1, skipped);
+        v[i] *= std::pow(beta2, skipped);
+      }
+      deferred = false;
+    }
+
+    denseIteration = iteration;
+
+    // And update the iterate.
+    m *= beta1;
+    m += (1 - beta1) * gradient;
+
+    v *= beta2;
+    v += (1 - beta2) * (gradient % gradient);
+
+    iterate -= StepScale(stepSize) * m / (arma::sqrt(v) + epsilon);
+  }
+
+  /**
+   * Update step for Adam with a sparse gradient: only the coordinates with a
+   * nonzero gradient are visited.
+   *
+   * @param iterate Parameters that minimize the function.
+   * @param stepSize Step size to be used for the given iteration.
+   * @param gradient The sparse gradient matrix.
+   */
+  void Update(arma::mat& iterate,
+              const double stepSize,
+              const arma::sp_mat& gradient)
+  {
+    // Increment the iteration counter variable.
+    ++iteration;
+    deferred = true;
+
+    const double scale = StepScale(stepSize);
+    for (arma::sp_mat::const_iterator it = gradient.begin();
+        it != gradient.end(); ++it)
+    {
+      const size_t i = it.row() + it.col() * iterate.n_rows;
+
+      // The decay of the skipped steps and of this step.
+      const double skipped = Skipped(i);
+      m[i] = std::pow(beta1, skipped + 1) * m[i] + (1 - beta1) * (*it);
+      v[i] = std::pow(beta2, skipped + 1) * v[i] +
+          (1 - beta2) * (*it) * (*it);
+
+      iterate[i] -= scale * m[i] / (std::sqrt(v[i]) + epsilon);
+      lastIteration[i] = iteration;
+    }
+  }
+
+  //! Get the value used to initialise the squared gradient parameter.
+  double Epsilon() const { return epsilon; }
+  //! Modify the value used to initialise the squared gradient parameter.
+  double& Epsilon() { return epsilon; }
+
+  //! Get the smoothing parameter.
+  double Beta1() const { return beta1; }
+  //! Modify the smoothing parameter.
+  double& Beta1() { return beta1; }
+
+  //! Get the second moment coefficient.
+  double Beta2() const { return beta2; }
+  //! Modify the second moment coefficient.
+  double& Beta2() { return beta2; }
+
+  /**
+   * Serialize the update policy (for checkpoints of the optimization).
+   */
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */)
+  {
+    ar & BOOST_SERIALIZATION_NVP(epsilon);
+    ar & BOOST_SERIALIZATION_NVP(beta1);
+    ar & BOOST_SERIALIZATION_NVP(beta2);
+    ar & BOOST_SERIALIZATION_NVP(m);
+    ar & BOOST_SERIALIZATION_NVP(v);
+    ar & BOOST_SERIALIZATION_NVP(lastIteration);
+    ar & BOOST_SERIALIZATION_NVP(iteration);
+    ar & BOOST_SERIALIZATION_NVP(denseIteration);
+    ar & BOOST_SERIALIZATION_NVP(deferred);
+  }
+
+ private:
+  /**
+   * Get the number of steps before the current one since the given coordinate
+   * was last updated.
+   */
+  double Skipped(const size_t i) const
+  {
+    const size_t last = std::max(lastIteration[i], denseIteration);
+    return (double) (iteration - 1 - last);
+  }
+
+  //! Get the bias-corrected step size of the current step (see AdamUpdate).
+  double StepScale(const double stepSize) const
+  {
+    const double biasCorrection1 = 1.0 - std::pow(beta1, (double) iteration);
+    const double biasCorrection2 = 1.0 - std::pow(beta2, (double) iteration);
+    return stepSize * std::sqrt(biasCorrection2) / biasCorrection1;
+  }
+
+  // The epsilon value used to initialise the squared gradient parameter.
+  double epsilon;
+
+  // The smoothing parameter.
+  double beta1;
+
+  // The second moment coefficient.
+  double beta2;
+
+  // The exponential moving average of gradient values.
+  arma::mat m;
+
+  // The exponential moving average of squared gradient values.
+  arma::mat v;
+
+  // The last sparse step where each coordinate was updated.
+  arma::Mat<size_t> lastIteration;
+
+  // The number of iterations.
+  size_t iteration;
+
+  // The last dense step, where all the coordinates were updated.
+  size_t denseIteration;
+
+  // Whether the sparse updates deferred the decay of some coordinates.
+  bool deferred;
+};
+
+} // namespace optimization
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,240 @@
+/**
+ * @file bayesian_optimization.hpp
+ *
+ * Bayesian optimization over a grid, with a Gaussian process model and the
+ * expected improvement.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_OPTIMIZERS_BAYESIAN_OPTIMIZATION_HPP
+#define MLPACK_CORE_OPTIMIZERS_BAYESIAN_OPTIMIZATION_HPP
+
+#include <mlpack/core.hpp>
+#include <mlpack/core/optimizers/population_evaluator.hpp>
+#include <set>
+
+namespace mlpack {
+namespace optimization {
+
+/**
+ * An optimizer that finds the minimum of an expensive function over the points
+ * of a multidimensional grid (like GridSearch) with Bayesian optimization.
+ * After a few random points, the objective is modeled with a Gaussian process
+ * fitted on the points evaluated so far, and the next points to evaluate are
+ * the ones with the largest expected improvement over the best objective, out
+ * of a random sample of candidates.  This needs far fewer evaluations than
+ * GridSearch or RandomSearch to find a good point when the objective is
+ * smooth, as is often the case for the performance of a model as a function of
+ * its hyper-parameters.
+ *
+ * Each parameter is represented for the Gaussian process by the position of
+ * its value among its possible values, scaled to [0, 1], so the possible
+ * values should be given in order (and, for parameters like regularization
+ * constants, on a logarithmic scale).  The kernel is a Gaussian kernel with
+ * the given length scale, and the objectives are standardized before fitting.
+ *
+ * Several points can be evaluated at once: a batch of points is chosen by
+ * assuming that each chosen point has the objective predicted by the model
+ * (the "kriging believer" strategy), so that the next points of the batch are
+ * chosen elsewhere.  If Evaluate() is const (see HasConstEvaluate), the
+ * function is assumed to be thread-safe, and the points of a batch are
+ * evaluated in parallel with OpenMP; otherwise they are evaluated one after
+ * the other.
+ *
+ * For BayesianOptimization to work, a FunctionType template parameter is
+ * required.  This class must implement the following function:
+ *
+ *   double Evaluate(const arma::mat& coordinates);
+ *
+ * For more information, see the following.
+ *
+ * @code
+ * @inproceedings{snoek2012practical,
+ *   title     = {Practical Bayesian Optimization of Machine Learning
+ *                Algorithms},
+ *   author    = {Snoek, Jasper and Larochelle, Hugo and Adams, Ryan P.},
+ *   booktitle = {Advances in Neural Information Processing Systems 25},
+ *   pages     = {2951--2959},
+ *   year      = {2012}
+ * }
+ *
+ * @incollection{ginsbourger2010kriging,
+ *   title     = {Kriging is Well-Suited to Parallelize Optimization},
+ *   author    = {Ginsbourger, David and Le Riche, Rodolphe and Carraro,
+ *                Laurent},
+ *   booktitle = {Computational Intelligence in Expensive Optimization
+ *                Problems},
+ *   pages     = {131--162},
+ *   year      = {2010}
+ * }
+ * @endcode
+ */
+class BayesianOptimization
+{
+ public:
+  /**
+   * Create the BayesianOptimization optimizer.
+   *
+   * @param maxEvaluations Number of points to evaluate in total.  If the grid
+   *     has fewer points, all of them are evaluated.
+   * @param initialPoints Number of random points evaluated before the model
+   *     is used (at least one is).
+   * @param batchSize Number of points chosen and evaluated at once.
+   * @param numCandidates Number of random points among which each point is
+   *     chosen.
+   * @param lengthScale Length scale of the Gaussian kernel.
+   * @param noise Variance of the noise of the objectives (relative to their
+   *     variance).
+   */
+  BayesianOptimization(const size_t maxEvaluations = 50,
+                       const size_t initialPoints = 10,
+                       const size_t batchSize = 1,
+                       const size_t numCandidates = 1000,
+                       const double lengthScale = 0.2,
+                       const double noise = 1e-6) :
+      maxEvaluations(maxEvaluations),
+      initialPoints(initialPoints),
+      batchSize(batchSize),
+      numCandidates(numCandidates),
+      lengthScale(lengthScale),
+      noise(noise)
+  { /* Nothing to do. */ }
+
+  /**
+   * Optimize (minimize) the given function over the combinations of values for
+   * the parameters specified in datasetInfo.
+   *
+   * @param function Function to optimize.
+   * @param bestParameters Variable for storing results.
+   * @param datasetInfo Type information for each dimension of the dataset. It
+   *     should store possible values for each parameter.
+   * @return Objective value of the final point.
+   */
+  template<typename FunctionType>
+  double Optimize(
+      FunctionType& function,
+      arma::mat& bestParameters,
+      data::DatasetMapper<data::IncrementPolicy, double>& datasetInfo);
+
+  //! Get the number of points to evaluate.
+  size_t MaxEvaluations() const { return maxEvaluations; }
+  //! Modify the number of points to evaluate.
+  size_t& MaxEvaluations() { return maxEvaluations; }
+
+  //! Get the number of random points evaluated before the model is used.
+  size_t InitialPoints() const { return initialPoints; }
+  //! Modify the number of random points evaluated before the model is used.
+  size_t& InitialPoints() { return initialPoints; }
+
+  //! Get the number of points evaluated at once.
+  size_t BatchSize() const { return batchSize; }
+  //! Modify the number of points evaluated at once.
+  size_t& BatchSize() { return batchSize; }
+
+  //! Get the number of candidates for each point.
+  size_t NumCandidates() const { return numCandidates; }
+  //! Modify the number of candidates for each point.
+  size_t& NumCandidates() { return numCandidates; }
+
+  //! Get the length scale of the kernel.
+  double LengthScale() const { return lengthScale; }
+  //! Modify the length scale of the kernel.
+  double& LengthScale() { return lengthScale; }
+
+  //! Get the variance of the noise.
+  double Noise() const { return noise; }
+  //! Modify the variance of the noise.
+  double& Noise() { return noise; }
+
+ private:
+  //! The indices of the values of a point of the grid.
+  typedef std::vector<size_t> GridPoint;
+
+  /**
+   * Draw the given number of distinct random points of the grid that are not
+   * in the given set.  There must be enough such points.
+   *
+   * @param count Number of points to draw.
+   * @param datasetInfo Possible values for each parameter.
+   * @param excluded Points that must not be drawn.
+   * @param points Vector to store the points in.
+   */
+  static void DrawPoints(
+      const size_t count,
+      const data::DatasetMapper<data::IncrementPolicy, double>& datasetInfo,
+      const std::set<GridPoint>& excluded,
+      std::vector<GridPoint>& points);
+
+  /**
+   * Get the location of the given point for the Gaussian process: the
+   * position of each value among the possible values, scaled to [0, 1].
+   */
+  static arma::vec Location(
+      const GridPoint& point,
+      const data::DatasetMapper<data::IncrementPolicy, double>& datasetInfo);
+
+  //! Compute the kernel between each column of a and each column of b.
+  arma::mat Kernel(const arma::mat& a, const arma::mat& b) const;
+
+  /**
+   * Fit the Gaussian process to the given responses at the given locations.
+   *
+   * @param locations Locations of the points (one per column).
+   * @param responses Standardized objectives of the points.
+   * @param lower Lower Cholesky factor of the covariance of the points.
+   * @param alpha Weights of the points in the predicted mean.
+   */
+  void Fit(const arma::mat& locations,
+           const arma::vec& responses,
+           arma::mat& lower,
+           arma::vec& alpha) const;
+
+  /**
+   * Compute the expected improvement of each candidate over the given best
+   * response.
+   *
+   * @param locations Locations of the points the model was fitted on.
+   * @param lower Lower Cholesky factor returned by Fit().
+   * @param alpha Weights returned by Fit().
+   * @param candidates Locations of the candidates (one per column).
+   * @param bestResponse Best response so far.
+   * @param mean Vector to store the predicted mean of each candidate in.
+   * @param improvement Vector to store the expected improvements in.
+   */
+  void ExpectedImprovement(const arma::mat& locations,
+                           const arma::mat& lower,
+                           const arma::vec& alpha,
+                           const arma::mat& candidates,
+                           const double bestResponse,
+                           arma::vec& mean,
+                           arma::vec& improvement) const;
+
+  //! The number of points to evaluate.
+  size_t maxEvaluations;
+
+  //! The number of random points evaluated before the model is used.
+  size_t initialPoints;
+
+  //! The number of points evaluated at once.
+  size_t batchSize;
+
+  //! The number of candidates for each point.
+  size_t numCandidates;
+
+  //! The length scale of the kernel.
+  double lengthScale;
+
+  //! The variance of the noise.
+  double noise;
+};
+
+} // namespace optimization
+} // namespace mlpack
+
+// Include implementation
+#include "bayesian_optimization_impl.hpp"
+
+#endif
@@ -0,0 +1,237 @@
+/**
+ * @file bayesian_optimization_impl.hpp
+ *
+ * Implementation of the Bayesian optimization.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_OPTIMIZERS_BAYESIAN_OPTIMIZATION_IMPL_HPP
+#define MLPACK_CORE_OPTIMIZERS_BAYESIAN_OPTIMIZATION_IMPL_HPP
+
+#include <limits>
+
+namespace mlpack {
+namespace optimization {
+
+template<typename FunctionType>
+double BayesianOptimization::Optimize(
+    FunctionType& function,
+    arma::mat& bestParameters,
+    data::DatasetMapper<data::IncrementPolicy, double>& datasetInfo)
+{
+  const size_t dimensionality = datasetInfo.Dimensionality();
+  for (size_t i = 0; i < dimensionality; ++i)
+  {
+    if (datasetInfo.Type(i) != data::Datatype::categorical)
+    {
+      std::ostringstream oss;
+      oss << "BayesianOptimization::Optimize(): the dimension " << i
+          << " is not categorical" << std::endl;
+      throw std::invalid_argument(oss.str());
+    }
+  }
+
+  // The number of points on the grid may not fit in a size_t.
+  double gridSize = 1.0;
+  for (size_t i = 0; i < dimensionality; ++i)
+    gridSize *= datasetInfo.NumMappings(i);
+
+  const size_t numEvaluations = (maxEvaluations < gridSize) ? maxEvaluations :
+      (size_t) gridSize;
+  if (numEvaluations == 0)
+    return std::numeric_limits<double>::max();
+
+  // The points evaluated so far, with their parameters, their locations for
+  // the model and their objectives.
+  std::set<GridPoint> evaluated;
+  arma::mat parameters(dimensionality, numEvaluations);
+  arma::mat locations(dimensionality, numEvaluations);
+  arma::vec objectives(numEvaluations);
+  size_t numEvaluated = 0;
+
+  // The first batch is random.
+  std::vector<GridPoint> batch;
+  DrawPoints(std::min(std::max(initialPoints, (size_t) 1), numEvaluations),
+      datasetInfo, evaluated, batch);
+  while (!batch.empty())
+  {
+    for (size_t b = 0; b < batch.size(); ++b)
+    {
+      evaluated.insert(batch[b]);
+      locations.col(numEvaluated + b) = Location(batch[b], datasetInfo);
+      for (size_t i = 0; i < dimensionality; ++i)
+      {
+        parameters(i, numEvaluated + b) =
+            datasetInfo.UnmapString(batch[b][i], i);
+      }
+    }
+
+    // A function whose Evaluate() is not const may not be thread-safe, so it
+    // is evaluated by a single thread.
+    #pragma omp parallel for schedule(dynamic) \
+        if (HasConstEvaluate<FunctionType>::value)
+    for (omp_size_t b = 0; b < (omp_size_t) batch.size(); ++b)
+    {
+      const arma::vec currentParameters = parameters.col(numEvaluated + b);
+      objectives[numEvaluated + b] = function.Evaluate(currentParameters);
+    }
+
+    numEvaluated += batch.size();
+    batch.clear();
+
+    const size_t remaining = numEvaluations - numEvaluated;
+    if (remaining == 0)
+      break;
+
+    // The model is fitted to the standardized objectives.
+    const arma::vec seen = objectives.subvec(0, numEvaluated - 1);
+    double scale = (numEvaluated > 1) ? arma::stddev(seen) : 0.0;
+    if (!(scale > 0.0))
+      scale = 1.0;
+    arma::vec responses = (seen - arma::mean(seen)) / scale;
+    const double bestResponse = responses.min();
+
+    std::vector<GridPoint> candidates;
+    DrawPoints((size_t) std::min((double) numCandidates,
+        gridSize - numEvaluated), datasetInfo, evaluated, candidates);
+    arma::mat candidateLocations(dimensionality, candidates.size());
+    for (size_t c = 0; c < candidates.size(); ++c)
+      candidateLocations.col(c) = Location(candidates[c], datasetInfo);
+
+    // Each point of the batch is assumed to have the objective predicted for
+    // it, and the model is fitted again to choose the next one.
+    arma::mat modelLocations = locations.cols(0, numEvaluated - 1);
+    std::vector<bool> chosen(candidates.size(), false);
+    const size_t batchPoints = std::min(std::min(std::max(batchSize,
+        (size_t) 1), remaining), candidates.size());
+    arma::mat lower;
+    arma::vec alpha, mean, improvement;
+    for (size_t b = 0; b < batchPoints; ++b)
+    {
+      Fit(modelLocations, responses, lower, alpha);
+      ExpectedImprovement(modelLocations, lower, alpha, candidateLocations,
+          bestResponse, mean, improvement);
+
+      size_t next = candidates.size();
+      for (size_t c = 0; c < candidates.size(); ++c)
+      {
+        if (!chosen[c] && (next == candidates.size() ||
+            improvement[c] > improvement[next]))
+          next = c;
+      }
+
+      chosen[next] = true;
+      batch.push_back(candidates[next]);
+      modelLocations.insert_cols(modelLocations.n_cols,
+          candidateLocations.col(next));
+      responses.resize(responses.n_elem + 1);
+      responses[responses.n_elem - 1] = mean[next];
+    }
+  }
+
+  // The first of the best points is kept, as if the points had been evaluated
+  // in order.
+  arma::uword bestPoint = 0;
+  const double bestObjective = objectives.min(bestPoint);
+  bestParameters = parameters.col(bestPoint);
+
+  return bestObjective;
+}
+
+inline void BayesianOptimization::DrawPoints(
+    const size_t count,
+    const data::DatasetMapper<data::IncrementPolicy, double>& datasetInfo,
+    const std::set<GridPoint>& excluded,
+    std::vector<GridPoint>& points)
+{
+  std::set<GridPoint> drawn;
+  GridPoint point(datasetInfo.Dimensionality());
+  while (drawn.size() < count)
+  {
+    for (size_t i = 0; i < point.size(); ++i)
+      point[i] = math::RandInt((int) datasetInfo.NumMappings(i));
+
+    if (excluded.count(point) == 0 && drawn.insert(point).second)
+      points.push_back(point);
+  }
+}
+
+inline arma::vec BayesianOptimization::Location(
+    const GridPoint& point,
+    const data::DatasetMapper<data::IncrementPolicy, double>& datasetInfo)
+{
+  arma::vec location(point.size());
+  for (size_t i = 0; i < point.size(); ++i)
+  {
+    const size_t numMappings = datasetInfo.NumMappings(i);
+    location[i] = (numMappings > 1) ?
+        (double) point[i] / (numMappings - 1) : 0.0;
+  }
+
+  return location;
+}
+
+inline arma::mat BayesianOptimization::Kernel(const arma::mat& a,
+                                              const arma::mat& b) const
+{
+  // Squared distances, with the rounding errors below zero removed.
+  arma::mat distances = -2.0 * a.t() * b;
+  distances.each_col() += arma::sum(arma::square(a), 0).t();
+  distances.each_row() += arma::sum(arma::square(b), 0);
+  distances.elem(arma::find(distances < 0.0)).zeros();
+
+  return arma::exp(-distances / (2.0 * lengthScale * lengthScale));
+}
+
+inline void BayesianOptimization::Fit(const arma::mat& locations,
+                                      const arma::vec& responses,
+                                      arma::mat& lower,
+                                      arma::vec& alpha) const
+{
+  const arma::mat covariance = Kernel(locations, locations);
+  const arma::mat identity = arma::eye<arma::mat>(locations.n_cols,
+      locations.n_cols);
+
+  // The factorization can fail when points are very close; more noise is then
+  // added until it succeeds.
+  double jitter = noise;
+  while (!arma::chol(lower, covariance + jitter * identity, "lower"))
+    jitter = (jitter > 0.0) ? 10.0 * jitter : 1e-10;
+
+  alpha = arma::solve(arma::trimatu(lower.t()),
+      arma::solve(arma::trimatl(lower), responses));
+}
+
+inline void BayesianOptimization::ExpectedImprovement(
+    const arma::mat& locations,
+    const arma::mat& lower,
+    const arma::vec& alpha,
+    const arma::mat& candidates,
+    const double bestResponse,
+    arma::vec& mean,
+    arma::vec& improvement) const
+{
+  const arma::mat cross = Kernel(locations, candidates);
+  mean = cross.t() * alpha;
+  const arma::mat v = arma::solve(arma::trimatl(lower), cross);
+
+  improvement.set_size(candidates.n_cols);
+  for (size_t c = 0; c < candidates.n_cols; ++c)
+  {
+    // The prior variance of the Gaussian kernel is 1.
+    const double variance = 1.0 - arma::dot(v.col(c), v.col(c));
+    const double sd = std::sqrt(std::max(variance, 1e-12));
+    const double gain = bestResponse - mean[c];
+    const double z = gain / sd;
+    improvement[c] = gain * 0.5 * std::erfc(-z / std::sqrt(2.0)) +
+        sd * std::exp(-0.5 * z * z) / std::sqrt(2.0 * arma::datum::pi);
+  }
+}
+
+} // namespace optimization
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,96 @@
+/**
+ * @file checkpoint.cpp
+ *
+ * Implementation of the non-templated functions of OptimizerCheckpoint.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "checkpoint.hpp"
+
+#include <cstdio>
+
+namespace mlpack {
+namespace optimization {
+
+OptimizerCheckpoint::OptimizerCheckpoint(const std::string& filename,
+                                         const size_t interval) :
+    filename(filename),
+    interval(interval)
+{
+  // Nothing to do.
+}
+
+OptimizerCheckpoint::OptimizerCheckpoint(const OptimizerCheckpoint& other) :
+    filename(other.filename),
+    interval(other.interval)
+{
+  // Nothing to do.
+}
+
+OptimizerCheckpoint& OptimizerCheckpoint::operator=(
+    const OptimizerCheckpoint& other)
+{
+  if (this != &other)
+  {
+    Wait();
+    filename = other.filename;
+    interval = other.interval;
+  }
+
+  return *this;
+}
+
+OptimizerCheckpoint::~OptimizerCheckpoint()
+{
+  Wait();
+}
+
+void OptimizerCheckpoint::Wait()
+{
+  if (pending.valid())
+    pending.get();
+}
+
+void OptimizerCheckpoint::Finish()
+{
+  Wait();
+  if (Enabled())
+    std::remove(filename.c_str());
+}
+
+void OptimizerCheckpoint::Write() const
+{
+  // Write under a temporary name, so that the last checkpoint stays intact
+  // until the new one is complete.
+  const std::string tmpFilename = filename + ".tmp";
+  std::ofstream ofs(tmpFilename, std::ios::out | std::ios::binary |
+      std::ios::trunc);
+  if (!ofs.is_open())
+  {
+    Log::Warn << "OptimizerCheckpoint: can't open '" << tmpFilename << "' for "
+        << "writing; checkpoint not saved." << std::endl;
+    return;
+  }
+
+  ofs.write(buffer.data(), buffer.size());
+  ofs.close();
+  if (!ofs)
+  {
+    Log::Warn << "OptimizerCheckpoint: error writing '" << tmpFilename << "'; "
+        << "checkpoint not saved." << std::endl;
+    std::remove(tmpFilename.c_str());
+    return;
+  }
+
+  if (std::rename(tmpFilename.c_str(), filename.c_str()) != 0)
+  {
+    Log::Warn << "OptimizerCheckpoint: can't rename '" << tmpFilename << "' to "
+        << "'" << filename << "'; checkpoint not saved." << std::endl;
+  }
+}
+
+} // namespace optimization
+} // namespace mlpack
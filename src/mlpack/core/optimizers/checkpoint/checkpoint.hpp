@@ -0,0 +1,167 @@
+/**
+ * @file checkpoint.hpp
+ *
+ * Definition of the OptimizerCheckpoint class, which saves the state of an
+ * optimization periodically so that it can be resumed after an interruption.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_OPTIMIZERS_CHECKPOINT_CHECKPOINT_HPP
+#define MLPACK_CORE_OPTIMIZERS_CHECKPOINT_CHECKPOINT_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <future>
+
+namespace mlpack {
+namespace optimization {
+
+/**
+ * An OptimizerCheckpoint saves the state of an optimization (the iterate, the
+ * counters of the optimizer, and the state of its policies, like the moment
+ * estimates of Adam or the learning rate schedule of SGDR) to a file every
+ * given number of iterations, so that a run that is interrupted can be resumed
+ * where it left off.  When an optimizer that supports checkpoints (SGD and the
+ * optimizers built on it, and L_BFGS) is given an OptimizerCheckpoint with a
+ * filename, it resumes from the file if it exists, and it removes the file when
+ * the optimization finishes.
+ *
+ * Saving is cheap for the optimizer: the state is written to a binary archive
+ * in memory, which holds the matrices as raw memory, and the archive is written
+ * to the file by a background thread while the optimization goes on.  The file
+ * is written under a temporary name first and then renamed, so an interruption
+ * while a checkpoint is written leaves the previous checkpoint intact.
+ *
+ * The policies of the optimizer are saved with their serialize() method;
+ * policies without one are assumed to have no state.  The random number
+ * generators are not part of the checkpoint, so when the functions are
+ * shuffled, a resumed run visits them in a different (but still random) order
+ * than the interrupted run would have.
+ *
+ * @code
+ * SGD<MomentumUpdate> sgd(0.01, 32, 100000000);
+ * sgd.Checkpoint() = OptimizerCheckpoint("sgd.checkpoint", 10);
+ * sgd.Optimize(function, iterate); // Resumes from sgd.checkpoint if it exists.
+ * @endcode
+ */
+class OptimizerCheckpoint
+{
+ public:
+  /**
+   * Create the checkpoint with the given file and interval.  An empty filename
+   * disables checkpoints.
+   *
+   * @param filename Name of the checkpoint file.
+   * @param interval Number of iterations between checkpoints (the meaning of
+   *     an iteration depends on the optimizer; for SGD, it is a pass over the
+   *     data).
+   */
+  OptimizerCheckpoint(const std::string& filename = "",
+                      const size_t interval = 1);
+
+  //! Copy the settings of the given checkpoint (but not its pending write).
+  OptimizerCheckpoint(const OptimizerCheckpoint& other);
+
+  //! Copy the settings of the given checkpoint (but not its pending write).
+  OptimizerCheckpoint& operator=(const OptimizerCheckpoint& other);
+
+  //! Wait for the pending write, if any.
+  ~OptimizerCheckpoint();
+
+  //! Whether checkpoints are enabled (the filename isn't empty).
+  bool Enabled() const { return !filename.empty(); }
+
+  //! Whether a checkpoint must be saved at the given iteration.
+  bool Due(const size_t iteration) const
+  {
+    return Enabled() && interval > 0 && (iteration % interval == 0);
+  }
+
+  /**
+   * Load the state from the checkpoint file, if it exists.  If the file holds
+   * the checkpoint of another kind of optimization, or can't be read,
+   * std::runtime_error is thrown.
+   *
+   * @tparam StateType Type of the state (it must have a serialize() method).
+   * @param name Name of the kind of optimization (for instance, "SGD").
+   * @param state State to load into.
+   * @return true if the state was loaded, false if there is no checkpoint.
+   */
+  template<typename StateType>
+  bool Load(const std::string& name, StateType& state);
+
+  /**
+   * Save the given state to the checkpoint file.  The state is serialized
+   * before this returns, so it may be modified right away; the file is written
+   * in the background.  If the previous checkpoint is still being written,
+   * this waits for it first.
+   *
+   * @tparam StateType Type of the state (it must have a serialize() method).
+   * @param name Name of the kind of optimization (for instance, "SGD").
+   * @param state State to save.
+   */
+  template<typename StateType>
+  void Save(const std::string& name, const StateType& state);
+
+  //! Wait until the pending checkpoint, if any, is written.
+  void Wait();
+
+  //! Wait for the pending write, and remove the checkpoint file.
+  void Finish();
+
+  //! Get the name of the checkpoint file.
+  const std::string& Filename() const { return filename; }
+  //! Modify the name of the checkpoint file.
+  std::string& Filename() { return filename; }
+
+  //! Get the number of iterations between checkpoints.
+  size_t Interval() const { return interval; }
+  //! Modify the number of iterations between checkpoints.
+  size_t& Interval() { return interval; }
+
+ private:
+  //! Write the buffer to the checkpoint file (run in the background).
+  void Write() const;
+
+  //! The name of the checkpoint file.
+  std::string filename;
+
+  //! The number of iterations between checkpoints.
+  size_t interval;
+
+  //! The serialized state that is being written.
+  std::string buffer;
+
+  //! The pending write.
+  std::future<void> pending;
+};
+
+/**
+ * Serialize the given policy of an optimizer, if it has a serialize() method;
+ * otherwise, it is assumed to have no state, and nothing is done.
+ */
+template<typename Archive, typename PolicyType>
+typename std::enable_if<data::HasSerialize<PolicyType>::value, void>::type
+SerializePolicy(Archive& ar, const char* name, PolicyType& policy)
+{
+  ar & boost::serialization::make_nvp(name, policy);
+}
+
+template<typename Archive, typename PolicyType>
+typename std::enable_if<!data::HasSerialize<PolicyType>::value, void>::type
+SerializePolicy(Archive& /* ar */,
+                const char* /* name */,
+                PolicyType& /* policy */)
+{
+  // Nothing to do.
+}
+
+} // namespace optimization
+} // namespace mlpack
+
+// Include implementation.
+#include "checkpoint_impl.hpp"
+
+#endif
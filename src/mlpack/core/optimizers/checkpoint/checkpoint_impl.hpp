@@ -0,0 +1,85 @@
+/**
+ * @file checkpoint_impl.hpp
+ *
+ * Implementation of the templated functions of OptimizerCheckpoint.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_OPTIMIZERS_CHECKPOINT_CHECKPOINT_IMPL_HPP
+#define MLPACK_CORE_OPTIMIZERS_CHECKPOINT_CHECKPOINT_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "checkpoint.hpp"
+
+#include <boost/archive/binary_iarchive.hpp>
+#include <boost/archive/binary_oarchive.hpp>
+#include <boost/serialization/string.hpp>
+#include <fstream>
+#include <sstream>
+
+namespace mlpack {
+namespace optimization {
+
+template<typename StateType>
+bool OptimizerCheckpoint::Load(const std::string& name, StateType& state)
+{
+  Wait();
+
+  std::ifstream ifs(filename, std::ios::in | std::ios::binary);
+  if (!ifs.is_open())
+    return false;
+
+  try
+  {
+    boost::archive::binary_iarchive ar(ifs);
+
+    std::string savedName;
+    ar >> BOOST_SERIALIZATION_NVP(savedName);
+    if (savedName != name)
+    {
+      std::ostringstream oss;
+      oss << "OptimizerCheckpoint::Load(): '" << filename << "' is a "
+          << "checkpoint of " << savedName << ", not of " << name << "!";
+      throw std::runtime_error(oss.str());
+    }
+
+    ar >> boost::serialization::make_nvp("state", state);
+  }
+  catch (boost::archive::archive_exception& e)
+  {
+    std::ostringstream oss;
+    oss << "OptimizerCheckpoint::Load(): can't read '" << filename << "': "
+        << e.what();
+    throw std::runtime_error(oss.str());
+  }
+
+  Log::Info << "Resuming " << name << " from checkpoint '" << filename << "'."
+      << std::endl;
+  return true;
+}
+
+template<typename StateType>
+void OptimizerCheckpoint::Save(const std::string& name, const StateType& state)
+{
+  // The buffer belongs to the pending write until it is done.
+  Wait();
+
+  std::ostringstream oss(std::ios::out | std::ios::binary);
+  {
+    boost::archive::binary_oarchive ar(oss);
+    const std::string savedName = name;
+    ar << BOOST_SERIALIZATION_NVP(savedName);
+    ar << boost::serialization::make_nvp("state", state);
+  }
+  buffer = oss.str();
+
+  pending = std::async(std::launch::async, [this]() { Write(); });
+}
+
+} // namespace optimization
+} // namespace mlpack
+
+#endif
@@ -16,6 +16,7 @@
 #define MLPACK_CORE_OPTIMIZERS_CMAES_CMAES_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/core/optimizers/population_evaluator.hpp>
 
 #include "full_selection.hpp"
 #include "random_selection.hpp"
@@ -60,6 +61,12 @@ namespace optimization {
  * objective function on the first point in the dataset (presumably, the dataset
  * is held internally in the DecomposableFunctionType).
  *
+ * The offspring of each iteration are evaluated in parallel with OpenMP (see
+ * PopulationEvaluator): if Evaluate() is not const, each thread gets its own
+ * copy of the function, so the function must then be copyable and must
+ * evaluate the given coordinates.  The selection policy is shared by the
+ * threads.
+ *
  * @tparam SelectionPolicy The selection strategy used for the evaluation step.
  */
 template<typename SelectionPolicyType = FullSelection>
@@ -116,6 +116,12 @@ double CMAES<SelectionPolicyType>::Optimize(
   // The current visitation order (sorted by population objectives).
   arma::uvec idx = arma::linspace<arma::uvec>(0, lambda - 1, lambda);
 
+  // The offspring are evaluated by all the threads.  The best point is kept
+  // apart, since the function may hold its own parameters in the iterate
+  // (like FFN) and evaluate the other points there.
+  PopulationEvaluator<DecomposableFunctionType> evaluator(function);
+  arma::mat bestIterate = iterate;
+
   // Now iterate!
   for (size_t i = 1; i < maxIterations; ++i)
   {
@@ -140,12 +146,19 @@ double CMAES<SelectionPolicyType>::Optimize(
 
       pPosition.slice(idx(j)) = mPosition.slice(idx0) + sigma(idx0) *
           pStep.slice(idx(j));
-
-      // Calculate the objective function.
-      pObjective(idx(j)) = selectionPolicy.Select(function, batchSize,
-          pPosition.slice(idx(j)));
     }
 
+    // Calculate the objective function of each offspring.
+    evaluator.Evaluate(lambda, pObjective,
+        [&](DecomposableFunctionType& threadFunction, const size_t j)
+        {
+          // Alias the offspring, so that the threads don't access the slices
+          // of the cube.
+          const arma::mat position(pPosition.slice_memptr(j),
+              pPosition.n_rows, pPosition.n_cols, false, true);
+          return selectionPolicy.Select(threadFunction, batchSize, position);
+        });
+
     // Sort population.
     idx = sort_index(pObjective);
 
@@ -163,7 +176,7 @@ double CMAES<SelectionPolicyType>::Optimize(
     if (currentObjective < overallObjective)
     {
       overallObjective = currentObjective;
-      iterate = mPosition.slice(idx1);
+      bestIterate = mPosition.slice(idx1);
     }
 
     // Update Step Size.
@@ -258,19 +271,20 @@ double CMAES<SelectionPolicyType>::Optimize(
     {
       Log::Warn << "CMA-ES: converged to " << overallObjective << "; "
           << "terminating with failure.  Try a smaller step size?" << std::endl;
-      return overallObjective;
+      break;
     }
 
     if (std::abs(lastObjective - overallObjective) < tolerance)
     {
       Log::Info << "CMA-ES: minimized within tolerance " << tolerance << "; "
           << "terminating optimization." << std::endl;
-      return overallObjective;
+      break;
     }
 
     lastObjective = overallObjective;
   }
 
+  iterate = bestIterate;
   return overallObjective;
 }
 
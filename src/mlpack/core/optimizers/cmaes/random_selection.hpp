@@ -57,7 +57,12 @@ class RandomSelection
     double objective = 0;
     for (size_t f = 0; f < std::floor(numFunctions * fraction); f += batchSize)
     {
-      const size_t selection = math::RandInt(0, numFunctions);
+      // The offspring may be evaluated by several threads at once, and the
+      // random number generator is not thread-safe.
+      size_t selection;
+      #pragma omp critical(RandomSelection)
+      selection = math::RandInt(0, numFunctions);
+
       const size_t effectiveBatchSize = std::min(batchSize,
           numFunctions - selection);
 
@@ -17,6 +17,7 @@
 #define MLPACK_CORE_OPTIMIZERS_CNE_CNE_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/core/optimizers/population_evaluator.hpp>
 
 namespace mlpack {
 namespace optimization {
@@ -70,6 +71,11 @@ namespace optimization {
  * This class must implement the following function:
  *
  *   double Evaluate(const arma::mat& iterate);
+ *
+ * The candidates of each generation are evaluated in parallel with OpenMP (see
+ * PopulationEvaluator): if Evaluate() is not const, each thread gets its own
+ * copy of the function, so the function must then be copyable and must
+ * evaluate the given parameters.
  */
 class CNE
 {
@@ -86,18 +86,22 @@ double CNE::Optimize(DecomposableFunctionType& function, arma::mat& iterate)
   // Find the fitness before optimization using given iterate parameters.
   size_t lastBestFitness = function.Evaluate(iterate);
 
+  // The candidates are evaluated by all the threads.
+  PopulationEvaluator<DecomposableFunctionType> evaluator(function);
+
   // Iterate until maximum number of generations is obtained.
   for (size_t gen = 1; gen <= maxGenerations; gen++)
   {
     // Calculating fitness values of all candidates.
-    for (size_t i = 0; i < populationSize; i++)
-    {
-       // Select a candidate and insert the parameters in the function.
-       iterate = population.slice(i);
-
-       // Find fitness of candidate.
-       fitnessValues[i] = function.Evaluate(iterate);
-    }
+    evaluator.Evaluate(populationSize, fitnessValues,
+        [this](DecomposableFunctionType& threadFunction, const size_t i)
+        {
+          // Alias the candidate, so that the threads don't access the slices
+          // of the cube.
+          const arma::mat candidate(population.slice_memptr(i),
+              population.n_rows, population.n_cols, false, true);
+          return threadFunction.Evaluate(candidate);
+        });
 
     Log::Info << "Generation number: " << gen << " best fitness = "
         << fitnessValues.min() << std::endl;
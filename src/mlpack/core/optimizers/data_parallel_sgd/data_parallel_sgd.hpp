@@ -0,0 +1,217 @@
+/**
+ * @file data_parallel_sgd.hpp
+ *
+ * Synchronous data-parallel stochastic gradient descent.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_OPTIMIZERS_DATA_PARALLEL_SGD_DATA_PARALLEL_SGD_HPP
+#define MLPACK_CORE_OPTIMIZERS_DATA_PARALLEL_SGD_DATA_PARALLEL_SGD_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/optimizers/sgd/update_policies/vanilla_update.hpp>
+#include <mlpack/core/optimizers/sgd/decay_policies/no_decay.hpp>
+#include <mlpack/core/optimizers/evaluate_with_gradient.hpp>
+#include <mlpack/core/optimizers/population_evaluator.hpp>
+
+namespace mlpack {
+namespace optimization {
+
+/**
+ * Synchronous data-parallel stochastic gradient descent.  This takes the same
+ * steps as SGD with the same batch size, but each mini-batch is split into one
+ * shard per OpenMP thread: every thread takes the gradient of its shard at the
+ * current point, the gradients of the shards are summed (in a fixed order, so
+ * that the result does not depend on the scheduling of the threads), and the
+ * update policy takes a single step with the sum.  Unlike ParallelSGD, the
+ * updates are therefore not asynchronous, and any update policy of SGD (like
+ * MomentumUpdate) can be used.
+ *
+ * For DataParallelSGD to work, a DecomposableFunctionType template parameter is
+ * required, with the same interface as for SGD:
+ *
+ *   size_t NumFunctions();
+ *   double Evaluate(const arma::mat& coordinates,
+ *                   const size_t i,
+ *                   const size_t batchSize);
+ *   void Gradient(const arma::mat& coordinates,
+ *                 const size_t i,
+ *                 arma::mat& gradient,
+ *                 const size_t batchSize);
+ *
+ * and optionally EvaluateWithGradient() and Shuffle().  If Evaluate() is const
+ * (like for LogisticRegressionFunction), the function is assumed to be
+ * thread-safe and all the threads share it.  Otherwise (like for FFN, which
+ * runs the points through its own layers, or SoftmaxRegressionFunction), each
+ * thread gets a copy of the function, which must then evaluate the given
+ * coordinates rather than its own parameters; the copies are made again each
+ * time the function is shuffled, so that they visit the points in the same
+ * order.  The network of an FFN optimized this way should not use Parallel().
+ *
+ * @tparam UpdatePolicyType Update policy used to take the steps (see SGD).
+ * @tparam DecayPolicyType Decay policy used to adjust the step size (see SGD).
+ */
+template<typename UpdatePolicyType = VanillaUpdate,
+         typename DecayPolicyType = NoDecay>
+class DataParallelSGD
+{
+ public:
+  /**
+   * Construct the data-parallel SGD optimizer with the given parameters.  The
+   * defaults here are not necessarily good for the given problem, so it is
+   * suggested that the values used be tailored to the task at hand.  As for
+   * SGD, one iteration equals one point.
+   *
+   * @param stepSize Step size for each iteration.
+   * @param batchSize Batch size to use for each step; it is split between the
+   *     threads.
+   * @param maxIterations Maximum number of iterations allowed (0 means no
+   *     limit).
+   * @param tolerance Maximum absolute tolerance to terminate algorithm.
+   * @param shuffle If true, the function order is shuffled; otherwise, each
+   *     function is visited in linear order.
+   * @param updatePolicy Instantiated update policy used to adjust the given
+   *     parameters.
+   * @param decayPolicy Instantiated decay policy used to adjust the step size.
+   * @param resetPolicy Flag that determines whether update policy parameters
+   *     are reset before every Optimize call.
+   */
+  DataParallelSGD(const double stepSize = 0.01,
+                  const size_t batchSize = 32,
+                  const size_t maxIterations = 100000,
+                  const double tolerance = 1e-5,
+                  const bool shuffle = true,
+                  const UpdatePolicyType& updatePolicy = UpdatePolicyType(),
+                  const DecayPolicyType& decayPolicy = DecayPolicyType(),
+                  const bool resetPolicy = true);
+
+  /**
+   * Optimize the given function using data-parallel stochastic gradient
+   * descent.  The given starting point will be modified to store the finishing
+   * point of the algorithm, and the final objective value is returned.
+   *
+   * @tparam DecomposableFunctionType Type of the function to be optimized.
+   * @param function Function to optimize.
+   * @param iterate Starting point (will be modified).
+   * @return Objective value of the final point.
+   */
+  template<typename DecomposableFunctionType>
+  double Optimize(DecomposableFunctionType& function, arma::mat& iterate);
+
+  //! Get the step size.
+  double StepSize() const { return stepSize; }
+  //! Modify the step size.
+  double& StepSize() { return stepSize; }
+
+  //! Get the batch size.
+  size_t BatchSize() const { return batchSize; }
+  //! Modify the batch size.
+  size_t& BatchSize() { return batchSize; }
+
+  //! Get the maximum number of iterations (0 indicates no limit).
+  size_t MaxIterations() const { return maxIterations; }
+  //! Modify the maximum number of iterations (0 indicates no limit).
+  size_t& MaxIterations() { return maxIterations; }
+
+  //! Get the tolerance for termination.
+  double Tolerance() const { return tolerance; }
+  //! Modify the tolerance for termination.
+  double& Tolerance() { return tolerance; }
+
+  //! Get whether or not the individual functions are shuffled.
+  bool Shuffle() const { return shuffle; }
+  //! Modify whether or not the individual functions are shuffled.
+  bool& Shuffle() { return shuffle; }
+
+  //! Get whether or not the update policy parameters
+  //! are reset before Optimize call.
+  bool ResetPolicy() const { return resetPolicy; }
+  //! Modify whether or not the update policy parameters
+  //! are reset before Optimize call.
+  bool& ResetPolicy() { return resetPolicy; }
+
+  //! Get the update policy.
+  const UpdatePolicyType& UpdatePolicy() const { return updatePolicy; }
+  //! Modify the update policy.
+  UpdatePolicyType& UpdatePolicy() { return updatePolicy; }
+
+  //! Get the step size decay policy.
+  const DecayPolicyType& DecayPolicy() const { return decayPolicy; }
+  //! Modify the step size decay policy.
+  DecayPolicyType& DecayPolicy() { return decayPolicy; }
+
+ private:
+  //! The copies of a function used by the threads.
+  template<typename FunctionType>
+  using CopyVector = std::vector<std::unique_ptr<FunctionType>>;
+
+  //! Functions with a const Evaluate() are shared, so nothing is copied.
+  template<typename FunctionType>
+  typename std::enable_if<HasConstEvaluate<FunctionType>::value, void>::type
+  ResetCopies(FunctionType& /* function */,
+              CopyVector<FunctionType>& /* copies */,
+              const size_t /* numThreads */) const { }
+
+  //! Make a fresh copy of the function for each thread.
+  template<typename FunctionType>
+  typename std::enable_if<!HasConstEvaluate<FunctionType>::value, void>::type
+  ResetCopies(FunctionType& function,
+              CopyVector<FunctionType>& copies,
+              const size_t numThreads) const;
+
+  /**
+   * Evaluate the function on all the points with all the threads, one batch at
+   * a time.
+   */
+  template<typename FunctionType>
+  double Objective(FunctionType& function,
+                   CopyVector<FunctionType>& copies,
+                   const arma::mat& iterate,
+                   const size_t numThreads) const;
+
+  //! Get the function to be used by the given thread.
+  template<typename FunctionType>
+  static FunctionType& ThreadFunction(FunctionType& function,
+                                      CopyVector<FunctionType>& copies,
+                                      const size_t threadId)
+  {
+    return copies.empty() ? function : *copies[threadId];
+  }
+
+  //! The step size for each example.
+  double stepSize;
+
+  //! The batch size for processing.
+  size_t batchSize;
+
+  //! The maximum number of allowed iterations.
+  size_t maxIterations;
+
+  //! The tolerance for termination.
+  double tolerance;
+
+  //! Controls whether or not the individual functions are shuffled when
+  //! iterating.
+  bool shuffle;
+
+  //! The update policy used to update the parameters in each iteration.
+  UpdatePolicyType updatePolicy;
+
+  //! The decay policy used to update the step size.
+  DecayPolicyType decayPolicy;
+
+  //! Flag indicating whether update policy
+  //! should be reset before running optimization.
+  bool resetPolicy;
+};
+
+} // namespace optimization
+} // namespace mlpack
+
+// Include implementation.
+#include "data_parallel_sgd_impl.hpp"
+
+#endif
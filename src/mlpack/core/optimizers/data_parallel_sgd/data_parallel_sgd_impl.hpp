@@ -0,0 +1,219 @@
+/**
+ * @file data_parallel_sgd_impl.hpp
+ *
+ * Implementation of synchronous data-parallel stochastic gradient descent.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_OPTIMIZERS_DATA_PARALLEL_SGD_DATA_PARALLEL_SGD_IMPL_HPP
+#define MLPACK_CORE_OPTIMIZERS_DATA_PARALLEL_SGD_DATA_PARALLEL_SGD_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "data_parallel_sgd.hpp"
+
+#ifdef HAS_OPENMP
+  #include <omp.h>
+#endif
+
+namespace mlpack {
+namespace optimization {
+
+template<typename UpdatePolicyType, typename DecayPolicyType>
+DataParallelSGD<UpdatePolicyType, DecayPolicyType>::DataParallelSGD(
+    const double stepSize,
+    const size_t batchSize,
+    const size_t maxIterations,
+    const double tolerance,
+    const bool shuffle,
+    const UpdatePolicyType& updatePolicy,
+    const DecayPolicyType& decayPolicy,
+    const bool resetPolicy) :
+    stepSize(stepSize),
+    batchSize(batchSize),
+    maxIterations(maxIterations),
+    tolerance(tolerance),
+    shuffle(shuffle),
+    updatePolicy(updatePolicy),
+    decayPolicy(decayPolicy),
+    resetPolicy(resetPolicy)
+{ /* Nothing to do. */ }
+
+//! Optimize the function (minimize).
+template<typename UpdatePolicyType, typename DecayPolicyType>
+template<typename DecomposableFunctionType>
+double DataParallelSGD<UpdatePolicyType, DecayPolicyType>::Optimize(
+    DecomposableFunctionType& function,
+    arma::mat& iterate)
+{
+  // Find the number of functions to use.
+  const size_t numFunctions = function.NumFunctions();
+
+  // A batch can't be split into more shards than it has points.
+  size_t numThreads = 1;
+  #ifdef HAS_OPENMP
+    numThreads = std::min((size_t) omp_get_max_threads(),
+        std::min(batchSize, numFunctions));
+  #endif
+
+  CopyVector<DecomposableFunctionType> copies;
+  if (numThreads > 1)
+    ResetCopies(function, copies, numThreads);
+
+  // To keep track of where we are and how things are going.
+  size_t currentFunction = 0;
+  double overallObjective = Objective(function, copies, iterate, numThreads);
+  double lastObjective = DBL_MAX;
+
+  // Initialize the update policy.
+  if (resetPolicy)
+    updatePolicy.Initialize(iterate.n_rows, iterate.n_cols);
+
+  // Each thread takes the gradient of its shard in a column of its own.
+  arma::mat gradient(iterate.n_rows, iterate.n_cols);
+  arma::mat shardGradients(iterate.n_elem, numThreads);
+  arma::vec shardObjectives(numThreads);
+
+  const size_t actualMaxIterations = (maxIterations == 0) ?
+      std::numeric_limits<size_t>::max() : maxIterations;
+  for (size_t i = 0; i < actualMaxIterations; /* incrementing done manually */)
+  {
+    // Is this iteration the start of a sequence?
+    if ((currentFunction % numFunctions) == 0)
+    {
+      // Output current objective function.
+      Log::Info << "DataParallelSGD: iteration " << i << ", objective "
+          << overallObjective << "." << std::endl;
+
+      if (std::isnan(overallObjective) || std::isinf(overallObjective))
+      {
+        Log::Warn << "DataParallelSGD: converged to " << overallObjective
+            << "; terminating with failure.  Try a smaller step size?"
+            << std::endl;
+        return overallObjective;
+      }
+
+      if (std::abs(lastObjective - overallObjective) < tolerance)
+      {
+        Log::Info << "DataParallelSGD: minimized within tolerance "
+            << tolerance << "; terminating optimization." << std::endl;
+        return overallObjective;
+      }
+
+      // Reset the counter variables.
+      lastObjective = overallObjective;
+      overallObjective = 0;
+      currentFunction = 0;
+
+      if (shuffle) // Determine order of visitation.
+      {
+        function.Shuffle();
+
+        // The copies have to visit the points in the new order too.
+        if (!copies.empty())
+          ResetCopies(function, copies, numThreads);
+      }
+    }
+
+    // Find the effective batch size (the last batch may be smaller).
+    const size_t effectiveBatchSize = std::min(batchSize,
+        numFunctions - currentFunction);
+    const size_t numShards = std::min(numThreads, effectiveBatchSize);
+
+    #pragma omp parallel for schedule(static) num_threads(numShards) \
+        if (numShards > 1)
+    for (omp_size_t t = 0; t < (omp_size_t) numShards; ++t)
+    {
+      const size_t first = currentFunction + t * effectiveBatchSize / numShards;
+      const size_t last = currentFunction +
+          (t + 1) * effectiveBatchSize / numShards;
+
+      arma::mat shardGradient(shardGradients.colptr(t), iterate.n_rows,
+          iterate.n_cols, false, true);
+      shardObjectives[t] = EvaluateWithGradient(ThreadFunction(function,
+          copies, t), iterate, first, shardGradient, last - first);
+    }
+
+    // Sum the gradients of the shards in order.
+    if (numShards > 1)
+    {
+      gradient = arma::sum(shardGradients.head_cols(numShards), 1);
+      gradient.reshape(iterate.n_rows, iterate.n_cols);
+    }
+    else
+    {
+      gradient = arma::reshape(shardGradients.col(0), iterate.n_rows,
+          iterate.n_cols);
+    }
+    overallObjective += arma::accu(shardObjectives.head(numShards));
+
+    // Use the update policy to take a step.
+    updatePolicy.Update(iterate, stepSize, gradient);
+
+    // Now update the learning rate if requested by the user.
+    decayPolicy.Update(iterate, stepSize, gradient);
+
+    i += effectiveBatchSize;
+    currentFunction += effectiveBatchSize;
+  }
+
+  Log::Info << "DataParallelSGD: maximum iterations (" << maxIterations
+      << ") reached; terminating optimization." << std::endl;
+
+  // Calculate final objective.
+  return Objective(function, copies, iterate, numThreads);
+}
+
+template<typename UpdatePolicyType, typename DecayPolicyType>
+template<typename FunctionType>
+typename std::enable_if<!HasConstEvaluate<FunctionType>::value, void>::type
+DataParallelSGD<UpdatePolicyType, DecayPolicyType>::ResetCopies(
+    FunctionType& function,
+    CopyVector<FunctionType>& copies,
+    const size_t numThreads) const
+{
+  copies.clear();
+  for (size_t t = 0; t < numThreads; ++t)
+    copies.emplace_back(new FunctionType(function));
+}
+
+template<typename UpdatePolicyType, typename DecayPolicyType>
+template<typename FunctionType>
+double DataParallelSGD<UpdatePolicyType, DecayPolicyType>::Objective(
+    FunctionType& function,
+    CopyVector<FunctionType>& copies,
+    const arma::mat& iterate,
+    const size_t numThreads) const
+{
+  const size_t numFunctions = function.NumFunctions();
+  const size_t numBatches = (numFunctions + batchSize - 1) / batchSize;
+
+  double objective = 0;
+  #pragma omp parallel num_threads(numThreads) if (numThreads > 1) \
+      reduction(+:objective)
+  {
+    size_t threadId = 0;
+    #ifdef HAS_OPENMP
+      threadId = omp_get_thread_num();
+    #endif
+    FunctionType& threadFunction = ThreadFunction(function, copies, threadId);
+
+    #pragma omp for schedule(static)
+    for (omp_size_t b = 0; b < (omp_size_t) numBatches; ++b)
+    {
+      const size_t begin = b * batchSize;
+      const size_t effectiveBatchSize = std::min(batchSize,
+          numFunctions - begin);
+      objective += threadFunction.Evaluate(iterate, begin, effectiveBatchSize);
+    }
+  }
+
+  return objective;
+}
+
+} // namespace optimization
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,229 @@
+/**
+ * @file evaluate_with_gradient.hpp
+ *
+ * Utilities for the optimizers to evaluate a function and its gradient at the
+ * same point with a single call to the function's EvaluateWithGradient(), when
+ * the function provides it, and with Evaluate() and Gradient() otherwise.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_OPTIMIZERS_EVALUATE_WITH_GRADIENT_HPP
+#define MLPACK_CORE_OPTIMIZERS_EVALUATE_WITH_GRADIENT_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/util/sfinae_utility.hpp>
+
+namespace mlpack {
+namespace optimization {
+
+// This gives us a HasEvaluateWithGradientCheck<T, U> type (where U is a
+// function pointer) we can use with SFINAE to catch when a type has an
+// EvaluateWithGradient(...) function.
+HAS_MEM_FUNC(EvaluateWithGradient, HasEvaluateWithGradientCheck);
+
+/**
+ * Whether the given function type has a (const or non-const) method
+ * double EvaluateWithGradient(const arma::mat& coordinates,
+ *                             arma::mat& gradient).
+ */
+template<typename FunctionType>
+struct HasEvaluateWithGradient
+{
+  static const bool value =
+      HasEvaluateWithGradientCheck<FunctionType,
+          double(FunctionType::*)(const arma::mat&, arma::mat&)>::value ||
+      HasEvaluateWithGradientCheck<FunctionType,
+          double(FunctionType::*)(const arma::mat&, arma::mat&) const>::value;
+};
+
+/**
+ * Whether the given separable function type has a (const or non-const) method
+ * double EvaluateWithGradient(const arma::mat& coordinates,
+ *                             const size_t begin,
+ *                             arma::mat& gradient,
+ *                             const size_t batchSize).
+ */
+template<typename FunctionType>
+struct HasSeparableEvaluateWithGradient
+{
+  static const bool value =
+      HasEvaluateWithGradientCheck<FunctionType,
+          double(FunctionType::*)(const arma::mat&, const size_t, arma::mat&,
+          const size_t)>::value ||
+      HasEvaluateWithGradientCheck<FunctionType,
+          double(FunctionType::*)(const arma::mat&, const size_t, arma::mat&,
+          const size_t) const>::value;
+};
+
+// This gives us a HasSparseGradientCheck<T, U> type (where U is a function
+// pointer) we can use with SFINAE to catch when a type has a Gradient(...)
+// function.
+HAS_MEM_FUNC(Gradient, HasSparseGradientCheck);
+
+/**
+ * Whether the given separable function type has a (const or non-const) method
+ * void Gradient(const arma::mat& coordinates,
+ *               const size_t begin,
+ *               arma::sp_mat& gradient,
+ *               const size_t batchSize),
+ * which gives the gradient of a batch of functions as a sparse matrix.
+ */
+template<typename FunctionType>
+struct HasSparseGradient
+{
+  static const bool value =
+      HasSparseGradientCheck<FunctionType,
+          void(FunctionType::*)(const arma::mat&, const size_t, arma::sp_mat&,
+          const size_t)>::value ||
+      HasSparseGradientCheck<FunctionType,
+          void(FunctionType::*)(const arma::mat&, const size_t, arma::sp_mat&,
+          const size_t) const>::value;
+};
+
+/**
+ * Evaluate the given function and its gradient at the given coordinates, with
+ * the function's EvaluateWithGradient().
+ *
+ * @param function Function to evaluate.
+ * @param coordinates Point to evaluate the function at.
+ * @param gradient Matrix to store the gradient in.
+ * @return The value of the function at the given coordinates.
+ */
+template<typename FunctionType>
+typename std::enable_if<HasEvaluateWithGradient<FunctionType>::value,
+    double>::type
+EvaluateWithGradient(FunctionType& function,
+                     const arma::mat& coordinates,
+                     arma::mat& gradient)
+{
+  return function.EvaluateWithGradient(coordinates, gradient);
+}
+
+/**
+ * Evaluate the given function and its gradient at the given coordinates, with
+ * Evaluate() and Gradient(), for functions that don't provide
+ * EvaluateWithGradient().
+ *
+ * @param function Function to evaluate.
+ * @param coordinates Point to evaluate the function at.
+ * @param gradient Matrix to store the gradient in.
+ * @return The value of the function at the given coordinates.
+ */
+template<typename FunctionType>
+typename std::enable_if<!HasEvaluateWithGradient<FunctionType>::value,
+    double>::type
+EvaluateWithGradient(FunctionType& function,
+                     const arma::mat& coordinates,
+                     arma::mat& gradient)
+{
+  const double objective = function.Evaluate(coordinates);
+  function.Gradient(coordinates, gradient);
+  return objective;
+}
+
+/**
+ * Evaluate the given separable function and its gradient at the given
+ * coordinates, for the given batch of functions, with the function's
+ * EvaluateWithGradient().
+ *
+ * @param function Function to evaluate.
+ * @param coordinates Point to evaluate the function at.
+ * @param begin Index of the first function of the batch.
+ * @param gradient Matrix to store the gradient in.
+ * @param batchSize Number of functions in the batch.
+ * @return The value of the batch of functions at the given coordinates.
+ */
+template<typename FunctionType>
+typename std::enable_if<HasSeparableEvaluateWithGradient<FunctionType>::value,
+    double>::type
+EvaluateWithGradient(FunctionType& function,
+                     const arma::mat& coordinates,
+                     const size_t begin,
+                     arma::mat& gradient,
+                     const size_t batchSize)
+{
+  return function.EvaluateWithGradient(coordinates, begin, gradient,
+      batchSize);
+}
+
+/**
+ * Evaluate the given separable function and its gradient at the given
+ * coordinates, for the given batch of functions, with Evaluate() and
+ * Gradient(), for functions that don't provide EvaluateWithGradient().
+ *
+ * @param function Function to evaluate.
+ * @param coordinates Point to evaluate the function at.
+ * @param begin Index of the first function of the batch.
+ * @param gradient Matrix to store the gradient in.
+ * @param batchSize Number of functions in the batch.
+ * @return The value of the batch of functions at the given coordinates.
+ */
+template<typename FunctionType>
+typename std::enable_if<!HasSeparableEvaluateWithGradient<FunctionType>::value,
+    double>::type
+EvaluateWithGradient(FunctionType& function,
+                     const arma::mat& coordinates,
+                     const size_t begin,
+                     arma::mat& gradient,
+                     const size_t batchSize)
+{
+  const double objective = function.Evaluate(coordinates, begin, batchSize);
+  function.Gradient(coordinates, begin, gradient, batchSize);
+  return objective;
+}
+
+/**
+ * Evaluate the given separable function and its sparse gradient at the given
+ * coordinates, for the given batch of functions, with Evaluate() and the
+ * sparse Gradient() (see HasSparseGradient).
+ *
+ * @param function Function to evaluate.
+ * @param coordinates Point to evaluate the function at.
+ * @param begin Index of the first function of the batch.
+ * @param gradient Sparse matrix to store the gradient in.
+ * @param batchSize Number of functions in the batch.
+ * @return The value of the batch of functions at the given coordinates.
+ */
+template<typename FunctionType>
+double EvaluateWithGradient(FunctionType& function,
+                            const arma::mat& coordinates,
+                            const size_t begin,
+                            arma::sp_mat& gradient,
+                            const size_t batchSize)
+{
+  const double objective = function.Evaluate(coordinates, begin, batchSize);
+  function.Gradient(coordinates, begin, gradient, batchSize);
+  return objective;
+}
+
+// This gives us a HasEvaluateCheck<T, U> type (where U is a function pointer)
+// we can use with SFINAE to catch when a type has an Evaluate(...) function.
+HAS_MEM_FUNC(Evaluate, HasEvaluateCheck);
+
+/**
+ * Whether the given function type has a const method
+ * double Evaluate(const arma::mat& coordinates) const or
+ * double Evaluate(const arma::mat& coordinates,
+ *                 const size_t begin,
+ *                 const size_t batchSize) const.
+ * The optimizers that call a function from several threads at once assume
+ * that such a function is thread-safe.
+ */
+template<typename FunctionType>
+struct HasConstEvaluate
+{
+  static const bool value =
+      HasEvaluateCheck<FunctionType,
+          double(FunctionType::*)(const arma::mat&) const>::value ||
+      HasEvaluateCheck<FunctionType,
+          double(FunctionType::*)(const arma::mat&, const size_t,
+          const size_t) const>::value;
+};
+
+} // namespace optimization
+} // namespace mlpack
+
+#endif
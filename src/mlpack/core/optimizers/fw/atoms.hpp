@@ -21,6 +21,22 @@ namespace optimization {
 /**
  * Class to hold the information and operations of current atoms in the
  * soluton space.
+ *
+ * Along with the atoms, the class keeps a thin QR factorization
+ * \f$ A D = Q R \f$ of the matrix \f$ A \f$ of the function times the matrix
+ * \f$ D \f$ of the atoms, and \f$ Q^T b \f$.  The factorization is updated
+ * when an atom is added (with two passes of Gram-Schmidt orthogonalization)
+ * or removed (with Givens rotations), in \f$ O(mk) \f$ time for k atoms and m
+ * rows of \f$ A \f$.  The least-squares problems and the gradients over the
+ * atoms then only need products with \f$ R \f$, instead of forming and
+ * factorizing \f$ A D \f$ again at each iteration.  An atom that is (nearly)
+ * in the span of the previous ones gets a zero column of \f$ Q \f$ and a zero
+ * diagonal entry of \f$ R \f$, and a zero coefficient in the least-squares
+ * solution.
+ *
+ * All the atoms must be added with the same function, and the atoms must not
+ * be modified through CurrentAtoms(), or the factorization no longer matches
+ * them.
  */
 class Atoms
 {
@@ -35,25 +51,68 @@ class Atoms
    */
   void AddAtom(const arma::vec& v, FuncSq& function, const double c = 0)
   {
-    if (currentAtoms.is_empty())
+    const arma::vec av = function.MatrixA() * v;
+    const size_t k = currentAtoms.n_cols;
+
+    if (k == 0)
     {
-      CurrentAtoms() = v;
-      CurrentCoeffs().set_size(1);
-      CurrentCoeffs().fill(c);
+      currentAtoms = v;
+      currentCoeffs.set_size(1);
+      currentCoeffs(0) = c;
       atomSqTerm.set_size(1);
-      atomSqTerm(0) = std::pow(norm(function.MatrixA() * v, 2), 2);
+      atomSqTerm(0) = arma::dot(av, av);
+
+      q.set_size(av.n_elem, 0);
+      r.set_size(0, 0);
+      qb.set_size(0);
+    }
+    else
+    {
+      currentAtoms.insert_cols(k, v);
+      currentCoeffs.resize(k + 1);
+      currentCoeffs(k) = c;
+      atomSqTerm.resize(k + 1);
+      atomSqTerm(k) = arma::dot(av, av);
+    }
+
+    // Orthogonalize A * v against the previous columns of Q.  The second pass
+    // recovers the orthogonality lost to rounding in the first one.
+    arma::vec residual = av;
+    arma::vec h = arma::zeros<arma::vec>(k);
+    if (k > 0)
+    {
+      for (size_t pass = 0; pass < 2; ++pass)
+      {
+        const arma::vec projection = q.t() * residual;
+        residual -= q * projection;
+        h += projection;
+      }
+    }
+
+    double diagonal = arma::norm(residual, 2);
+    if (diagonal <= 1e-10 * arma::norm(av, 2))
+    {
+      // The atom is in the span of the previous ones.
+      diagonal = 0.0;
+      residual.zeros();
     }
     else
     {
-      currentAtoms.insert_cols(0, v);
-      arma::vec cVec(1);
-      cVec(0) = c;
-      currentCoeffs.insert_rows(0, cVec);
-      double tmp = std::pow(norm(function.MatrixA() * v, 2), 2);
-      arma::vec tmpVec(1);
-      tmpVec(0) = tmp;
-      atomSqTerm.insert_rows(0, tmpVec);
+      residual /= diagonal;
+    }
+
+    arma::mat newR(k + 1, k + 1, arma::fill::zeros);
+    if (k > 0)
+    {
+      newR.submat(0, 0, k - 1, k - 1) = r;
+      newR.submat(0, k, k - 1, k) = h;
     }
+    newR(k, k) = diagonal;
+    r = std::move(newR);
+
+    q.insert_cols(k, residual);
+    qb.resize(k + 1);
+    qb(k) = arma::dot(residual, function.Vectorb());
   }
 
 
@@ -63,6 +122,16 @@ class Atoms
     x = currentAtoms * currentCoeffs;
   }
 
+  /**
+   * Set the coefficients of the current atoms to the least-squares solution
+   * of \f$ \min_c ||A D c - b||_2 \f$, in \f$ O(k^2) \f$ time from the
+   * factorization.  Used in UpdateSpan class for update step.
+   */
+  void SolveInSpan()
+  {
+    SolveTriangular(r, qb, currentCoeffs);
+  }
+
   /**
    * Prune the support, delete previous atoms if they don't contribute much.
    * See Algorithm 2 of paper:
@@ -88,37 +157,37 @@ class Atoms
 
     while (currentAtoms.n_cols > 1)
     {
-      // Solve for current gradient.
-      arma::mat x;
-      RecoverVector(x);
-      arma::mat gradient(size(x));
-      function.Gradient(x, gradient);
+      // The gradient of the function with respect to the coefficients of the
+      // atoms, D^T A^T (A D c - b), is R^T (R c - Q^T b).
+      arma::vec atomGradient = r.t() * (r * currentCoeffs - qb);
 
       // Find possible atom to be deleted.
-      arma::vec gap = sqTerm -
-          currentCoeffs % trans(gradient.t() * currentAtoms);
+      arma::vec gap = sqTerm - currentCoeffs % atomGradient;
       arma::uword ind;
       gap.min(ind);
 
-      // Try deleting the atom.
-      arma::mat newAtoms(currentAtoms.n_rows, currentAtoms.n_cols - 1);
-      if (ind > 0)
-        newAtoms.cols(0, ind - 1) = currentAtoms.cols(0, ind - 1);
-      if (ind < (currentAtoms.n_cols - 1))
-      {
-        newAtoms.cols(ind, newAtoms.n_cols - 1) =
-            currentAtoms.cols(ind + 1, currentAtoms.n_cols - 1);
-      }
+      // Try deleting the atom: downdate a copy of the factorization, and
+      // reoptimize the coefficients in the span of the other atoms, which
+      // would be used in UpdateSpan class.  Alternatively, if you want to add
+      // an atom norm constraint, you could use projected gradient method, see
+      // the implementaton of ProjectedGradientEnhancement().
+      arma::mat newQ = q;
+      arma::mat newR = r;
+      arma::vec newQb = qb;
+      RemoveFromFactorization(ind, newQ, newR, newQb);
 
-      // Reoptimize the coefficients, we brute-forcely reoptimize in the span,
-      // which would be used in UpdateSpan class. Alternatively, if you want to
-      // add an atom norm constraint, you could use projected gradient method,
-      // see the implementaton of ProjectedGradientEnhancement().
-      arma::vec newCoeffs =
-          solve(function.MatrixA() * newAtoms, function.Vectorb());
+      arma::vec newCoeffs;
+      SolveTriangular(newR, newQb, newCoeffs);
 
       // Evaluate the function again.
-      double Fnew = function.Evaluate(newAtoms * newCoeffs);
+      arma::vec fullCoeffs(currentAtoms.n_cols);
+      if (ind > 0)
+        fullCoeffs.head(ind) = newCoeffs.head(ind);
+      fullCoeffs(ind) = 0.0;
+      if (ind < (currentAtoms.n_cols - 1))
+        fullCoeffs.tail(newCoeffs.n_elem - ind) = newCoeffs.tail(
+            newCoeffs.n_elem - ind);
+      double Fnew = function.Evaluate(currentAtoms * fullCoeffs);
 
       if (Fnew > F)
         // Should not delete the atom.
@@ -126,8 +195,11 @@ class Atoms
       else
       {
         // Delete the atom from current atoms.
-        currentAtoms = newAtoms;
-        currentCoeffs = newCoeffs;
+        currentAtoms.shed_col(ind);
+        currentCoeffs = std::move(newCoeffs);
+        q = std::move(newQ);
+        r = std::move(newR);
+        qb = std::move(newQb);
         atomSqTerm.shed_row(ind);
         sqTerm.shed_row(ind);
       } // else
@@ -156,35 +228,36 @@ class Atoms
    * }
    * @endcode
    *
-   * @param function function to be minimized.
+   * The gradient and the value of the function are computed from the
+   * factorization, in \f$ O(k^2) \f$ time for each step: the function is
+   * \f$ 0.5 ||R c - Q^T b||^2 \f$ plus a constant.
+   *
+   * @param function function to be minimized (the atoms were added with it).
    * @param tau atom norm constraint.
    * @param stepSize step size for projected gradient method.
    * @param maxIteration maximum iteration number.
    * @param tolerance tolerance for projected gradient method.
    */
-  void ProjectedGradientEnhancement(FuncSq& function,
+  void ProjectedGradientEnhancement(FuncSq& /* function */,
                                     double tau,
                                     double stepSize,
                                     size_t maxIteration = 100,
                                     double tolerance = 1e-3)
   {
-    arma::mat x;
-    RecoverVector(x);
-    double value = function.Evaluate(x);
+    arma::vec residual = r * currentCoeffs - qb;
+    double value = 0.5 * arma::dot(residual, residual);
 
     for (size_t iter = 1; iter<maxIteration; iter++)
     {
       // Update currentCoeffs with gradient descent method.
-      arma::mat g;
-      function.Gradient(x, g);
-      g = currentAtoms.t() * g;
+      arma::vec g = r.t() * residual;
       currentCoeffs = currentCoeffs - stepSize * g;
 
       // Projection of currentCoeffs to satisfy the atom norm constraint.
       Proximal::ProjectToL1Ball(currentCoeffs, tau);
 
-      RecoverVector(x);
-      double valueNew = function.Evaluate(x);
+      residual = r * currentCoeffs - qb;
+      double valueNew = 0.5 * arma::dot(residual, residual);
 
       if ((value - valueNew) < tolerance)
         break;
@@ -205,6 +278,72 @@ class Atoms
   arma::mat& CurrentAtoms() { return currentAtoms; }
 
  private:
+  /**
+   * Remove the given column from the factorization: the column is removed from
+   * R, which makes it upper Hessenberg from that column on, and Givens
+   * rotations of the following rows restore its triangular form.  The same
+   * rotations are applied to the columns of Q and to Q^T b.
+   */
+  static void RemoveFromFactorization(const size_t ind,
+                                      arma::mat& q,
+                                      arma::mat& r,
+                                      arma::vec& qb)
+  {
+    r.shed_col(ind);
+    for (size_t i = ind; i < r.n_cols; ++i)
+    {
+      const double a = r(i, i);
+      const double b = r(i + 1, i);
+      const double rho = std::hypot(a, b);
+      if (rho == 0.0)
+        continue;
+
+      const double c = a / rho;
+      const double s = b / rho;
+      for (size_t j = i; j < r.n_cols; ++j)
+      {
+        const double upper = r(i, j);
+        const double lower = r(i + 1, j);
+        r(i, j) = c * upper + s * lower;
+        r(i + 1, j) = -s * upper + c * lower;
+      }
+
+      const arma::vec left = q.col(i);
+      q.col(i) = c * left + s * q.col(i + 1);
+      q.col(i + 1) = -s * left + c * q.col(i + 1);
+
+      const double upper = qb(i);
+      qb(i) = c * upper + s * qb(i + 1);
+      qb(i + 1) = -s * upper + c * qb(i + 1);
+    }
+
+    r.shed_row(r.n_rows - 1);
+    q.shed_col(q.n_cols - 1);
+    qb.shed_row(qb.n_elem - 1);
+  }
+
+  /**
+   * Solve R c = Q^T b by back substitution.  The coefficient of an atom with a
+   * zero diagonal entry (an atom in the span of the previous ones) is zero.
+   */
+  static void SolveTriangular(const arma::mat& r,
+                              const arma::vec& qb,
+                              arma::vec& coeffs)
+  {
+    coeffs.zeros(r.n_cols);
+    for (size_t i = r.n_cols; i > 0; --i)
+    {
+      const size_t row = i - 1;
+      if (r(row, row) == 0.0)
+        continue;
+
+      double sum = qb(row);
+      for (size_t j = i; j < r.n_cols; ++j)
+        sum -= r(row, j) * coeffs(j);
+      coeffs(row) = sum / r(row, row);
+    }
+  }
+
   //! Coefficients of current atoms.
   arma::vec currentCoeffs;
 
@@ -214,6 +353,16 @@ class Atoms
   //! Atom square term: ||A * atom||^2, used in PruneSupport(). It is computed
   //! when an atom is added.
   arma::vec atomSqTerm;
+
+  //! The orthonormal factor of A times the atoms (with a zero column for each
+  //! atom in the span of the previous ones).
+  arma::mat q;
+
+  //! The upper triangular factor of A times the atoms.
+  arma::mat r;
+
+  //! Q^T b.
+  arma::vec qb;
 }; // class Atoms
 }  // namespace optimization
 }  // namespace mlpack
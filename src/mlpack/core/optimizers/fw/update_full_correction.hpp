@@ -31,6 +31,10 @@ namespace optimization {
  * smaller than or equal to tau. This constraint optimization problem is solved
  * by projected gradient method. See Atoms.ProjectedEnhancement().
  *
+ * Both classes use the QR factorization of the matrix of the function times
+ * the atoms, which Atoms updates as atoms are added and pruned, so that the
+ * matrix of the function is not multiplied by all the atoms at each iteration.
+ *
  * Currently only works for function in FuncSq class.
  *
  */
@@ -57,9 +57,9 @@ class UpdateSpan
     // Add new atom into soluton space.
     atoms.AddAtom(s, function);
 
-    // Reoptimize the solution in the current space.
-    arma::vec b = function.Vectorb();
-    atoms.CurrentCoeffs() = solve(function.MatrixA() * atoms.CurrentAtoms(), b);
+    // Reoptimize the solution in the current space, with the QR factorization
+    // that the atoms keep up to date.
+    atoms.SolveInSpan();
 
     // x has coords of only the current atoms, recover the solution
     // to the original size.
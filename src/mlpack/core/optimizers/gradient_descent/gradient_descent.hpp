@@ -13,6 +13,7 @@
 #define MLPACK_CORE_OPTIMIZERS_GRADIENT_DESCENT_GRADIENT_DESCENT_HPP
 
 #include <mlpack/core.hpp>
+#include <mlpack/core/optimizers/evaluate_with_gradient.hpp>
 
 namespace mlpack {
 namespace optimization {
@@ -45,6 +46,13 @@ namespace optimization {
  *   double Evaluate(const arma::mat& coordinates);
  *   void Gradient(const arma::mat& coordinates,
  *                 arma::mat& gradient);
+ *
+ * If the class also implements
+ *
+ *   double EvaluateWithGradient(const arma::mat& coordinates,
+ *                               arma::mat& gradient);
+ *
+ * then it is used to compute the objective and the gradient in one pass.
  */
 class GradientDescent
 {
@@ -23,12 +23,13 @@ template<typename FunctionType>
 double GradientDescent::Optimize(
     FunctionType& function, arma::mat& iterate)
 {
-  // To keep track of where we are and how things are going.
-  double overallObjective = function.Evaluate(iterate);
+  // To keep track of where we are and how things are going.  The gradient is
+  // always the one of the current iterate.
+  arma::mat gradient(iterate.n_rows, iterate.n_cols);
+  double overallObjective = EvaluateWithGradient(function, iterate, gradient);
   double lastObjective = DBL_MAX;
 
   // Now iterate!
-  arma::mat gradient(iterate.n_rows, iterate.n_cols);
   for (size_t i = 1; i != maxIterations; ++i)
   {
     // Output current objective function.
@@ -53,13 +54,11 @@ double GradientDescent::Optimize(
     // Reset the counter variables.
     lastObjective = overallObjective;
 
-    function.Gradient(iterate, gradient);
-
     // And update the iterate.
     iterate -= stepSize * gradient;
 
     // Now add that to the overall objective function.
-    overallObjective = function.Evaluate(iterate);
+    overallObjective = EvaluateWithGradient(function, iterate, gradient);
   }
 
   Log::Info << "Gradient Descent: maximum iterations (" << maxIterations
@@ -13,6 +13,7 @@
 #define MLPACK_CORE_OPTIMIZERS_GRID_SEARCH_GRID_SEARCH_HPP
 
 #include <mlpack/core.hpp>
+#include <mlpack/core/optimizers/population_evaluator.hpp>
 
 namespace mlpack {
 namespace optimization {
@@ -25,6 +26,11 @@ namespace optimization {
  * class must implement the following function:
  *
  *   double Evaluate(const arma::mat& coordinates);
+ *
+ * If Evaluate() is const (see HasConstEvaluate), the function is assumed to be
+ * thread-safe, and the points of the grid are evaluated in parallel with
+ * OpenMP; otherwise they are evaluated one after the other.  In both cases,
+ * when several points have the best objective, the first one is returned.
  */
 class GridSearch
 {
@@ -48,20 +54,17 @@ class GridSearch
 
  private:
   /**
-   * Iterate through the last (parameterValueCollections.size() - i) dimensions
-   * of the grid and change the arguments bestObjective and bestParameters if
-   * there is something better. The values for the first i dimensions
-   * (parameters) are specified in the first i rows of the currentParameters
-   * argument.
+   * Get the point of the grid with the given index.  The points are numbered
+   * with the values of the last dimension changing fastest.
+   *
+   * @param index Index of the point.
+   * @param datasetInfo Possible values for each parameter.
+   * @param parameters Vector to store the point in.
    */
-  template<typename FunctionType>
-  void Optimize(
-      FunctionType& function,
-      double& bestObjective,
-      arma::mat& bestParameters,
-      arma::vec& currentParameters,
-      data::DatasetMapper<data::IncrementPolicy, double>& datasetInfo,
-      size_t i);
+  static void GridPoint(
+      size_t index,
+      const data::DatasetMapper<data::IncrementPolicy, double>& datasetInfo,
+      arma::vec& parameters);
 };
 
 } // namespace optimization
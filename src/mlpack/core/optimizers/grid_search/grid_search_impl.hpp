@@ -34,49 +34,62 @@ double GridSearch::Optimize(
     }
   }
 
-  double bestObjective = std::numeric_limits<double>::max();
-  bestParameters = arma::mat(datasetInfo.Dimensionality(), 1);
-  arma::vec currentParameters = arma::vec(datasetInfo.Dimensionality());
-
-  /* Initialize best parameters for the case (very unlikely though) when no set
-   * of parameters gives an objective value better than
-   * std::numeric_limits<double>::max() */
+  // Find the number of points on the grid.
+  size_t numPoints = 1;
   for (size_t i = 0; i < datasetInfo.Dimensionality(); ++i)
-    bestParameters(i, 0) = datasetInfo.UnmapString(0, i);
-
-  Optimize(function, bestObjective, bestParameters, currentParameters,
-      datasetInfo, 0);
+    numPoints *= datasetInfo.NumMappings(i);
 
-  return bestObjective;
-}
+  arma::vec objectives(numPoints);
 
-template<typename FunctionType>
-void GridSearch::Optimize(
-    FunctionType& function,
-    double& bestObjective,
-    arma::mat& bestParameters,
-    arma::vec& currentParameters,
-    data::DatasetMapper<data::IncrementPolicy, double>& datasetInfo,
-    size_t i)
-{
-  if (i < datasetInfo.Dimensionality())
+  // Each thread needs its own vector for the current point.  A function whose
+  // Evaluate() is not const may not be thread-safe, so it is evaluated by a
+  // single thread.
+  #pragma omp parallel if (HasConstEvaluate<FunctionType>::value)
   {
-    for (size_t j = 0; j < datasetInfo.NumMappings(i); ++j)
+    arma::vec currentParameters(datasetInfo.Dimensionality());
+
+    #pragma omp for schedule(dynamic)
+    for (omp_size_t i = 0; i < (omp_size_t) numPoints; ++i)
     {
-      currentParameters(i) = datasetInfo.UnmapString(j, i);
-      Optimize(function, bestObjective, bestParameters, currentParameters,
-          datasetInfo, i + 1);
+      GridPoint(i, datasetInfo, currentParameters);
+      objectives[i] = function.Evaluate(currentParameters);
     }
   }
-  else
+
+  // The first of the best points is kept, as if the grid had been visited in
+  // order.
+  double bestObjective = std::numeric_limits<double>::max();
+  size_t bestPoint = 0;
+  for (size_t i = 0; i < numPoints; ++i)
   {
-    double objective = function.Evaluate(currentParameters);
-    if (objective < bestObjective)
+    if (objectives[i] < bestObjective)
     {
-      bestObjective = objective;
-      bestParameters = currentParameters;
+      bestObjective = objectives[i];
+      bestPoint = i;
     }
   }
+
+  /* If no set of parameters gives an objective value better than
+   * std::numeric_limits<double>::max() (very unlikely though), the first point
+   * of the grid is returned. */
+  arma::vec point(datasetInfo.Dimensionality());
+  GridPoint(bestPoint, datasetInfo, point);
+  bestParameters = point;
+
+  return bestObjective;
+}
+
+inline void GridSearch::GridPoint(
+    size_t index,
+    const data::DatasetMapper<data::IncrementPolicy, double>& datasetInfo,
+    arma::vec& parameters)
+{
+  for (size_t i = datasetInfo.Dimensionality(); i > 0; --i)
+  {
+    const size_t numMappings = datasetInfo.NumMappings(i - 1);
+    parameters(i - 1) = datasetInfo.UnmapString(index % numMappings, i - 1);
+    index /= numMappings;
+  }
 }
 
 } // namespace optimization
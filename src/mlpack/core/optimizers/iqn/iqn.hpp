@@ -15,6 +15,7 @@
 #define MLPACK_CORE_OPTIMIZERS_IQN_IQN_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/core/optimizers/evaluate_with_gradient.hpp>
 
 namespace mlpack {
 namespace optimization {
@@ -61,6 +62,16 @@ namespace optimization {
  * of points in the dataset, and Evaluate(coordinates, 0) will evaluate the
  * objective function on the first point in the dataset (presumably, the dataset
  * is held internally in the DecomposableFunctionType).
+ *
+ * If the class also implements
+ *
+ *   double EvaluateWithGradient(const arma::mat& coordinates,
+ *                               const size_t i,
+ *                               arma::mat& gradient,
+ *                               const size_t batchSize);
+ *
+ * then it is used to compute the objective and the gradient of each batch in
+ * one pass.
  */
 class IQN
 {
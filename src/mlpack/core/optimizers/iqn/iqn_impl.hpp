@@ -77,6 +77,9 @@ double IQN::Optimize(DecomposableFunctionType& function, arma::mat& iterate)
 
   for (size_t i = 1; i != maxIterations; ++i)
   {
+    // The objective of each batch is taken at the point its gradient is taken
+    // at, so that both can be computed together.
+    overallObjective = 0;
     for (size_t j = 0, f = 0; f < numFunctions; j++)
     {
       // Cyclicly iterating through the number of functions.
@@ -88,8 +91,8 @@ double IQN::Optimize(DecomposableFunctionType& function, arma::mat& iterate)
 
       if (arma::norm(iterateVec - t.slice(it)) > 0)
       {
-        function.Gradient(iterate, it * batchSize, gradient,
-            effectiveBatchSize);
+        overallObjective += EvaluateWithGradient(function, iterate,
+            it * batchSize, gradient, effectiveBatchSize);
         gradient /= effectiveBatchSize;
 
         const arma::mat s = iterateVec - t.slice(it);
@@ -117,16 +120,14 @@ double IQN::Optimize(DecomposableFunctionType& function, arma::mat& iterate)
         iterateVec = stepSize * B.i() * (u - gVec) + (1 - stepSize) *
             iterateVec;
       }
+      else
+      {
+        overallObjective += function.Evaluate(iterate, it * batchSize,
+            effectiveBatchSize);
+      }
 
       f+= effectiveBatchSize;
     }
-
-    overallObjective = 0;
-    for (size_t f = 0; f < numFunctions; f += batchSize)
-    {
-      const size_t effectiveBatchSize = std::min(batchSize, numFunctions - f);
-      overallObjective += function.Evaluate(iterate, f, effectiveBatchSize);
-    }
     overallObjective /= numFunctions;
 
     // Output current objective function.
@@ -28,6 +28,8 @@ namespace optimization {
  *     (before giving up).
  * @param minStep The minimum step of the line search.
  * @param maxStep The maximum step of the line search.
+ * @param parallelLineSearch Whether to evaluate several trial step sizes of
+ *     the line search at once with the OpenMP threads.
  */
 L_BFGS::L_BFGS(const size_t numBasis,
                const size_t maxIterations,
@@ -37,7 +39,8 @@ L_BFGS::L_BFGS(const size_t numBasis,
                const double factr,
                const size_t maxLineSearchTrials,
                const double minStep,
-               const double maxStep) :
+               const double maxStep,
+               const bool parallelLineSearch) :
     numBasis(numBasis),
     maxIterations(maxIterations),
     armijoConstant(armijoConstant),
@@ -46,7 +49,8 @@ L_BFGS::L_BFGS(const size_t numBasis,
     factr(factr),
     maxLineSearchTrials(maxLineSearchTrials),
     minStep(minStep),
-    maxStep(maxStep)
+    maxStep(maxStep),
+    parallelLineSearch(parallelLineSearch)
 {
   // Nothing to do.
 }
@@ -59,17 +63,15 @@ L_BFGS::L_BFGS(const size_t numBasis,
  */
 double L_BFGS::ChooseScalingFactor(const size_t iterationNum,
                                    const arma::mat& gradient,
-                                   const arma::cube& s,
-                                   const arma::cube& y)
+                                   const arma::mat& sy,
+                                   const arma::mat& yy)
 {
   double scalingFactor = 1.0;
   if (iterationNum > 0)
   {
-    int previousPos = (iterationNum - 1) % numBasis;
-    // Get s and y matrices once instead of multiple times.
-    const arma::mat& sMat = s.slice(previousPos);
-    const arma::mat& yMat = y.slice(previousPos);
-    scalingFactor = dot(sMat, yMat) / dot(yMat, yMat);
+    // The inner products of the last basis vectors are already known.
+    const size_t previousPos = (iterationNum - 1) % numBasis;
+    scalingFactor = sy(previousPos, previousPos) / yy(previousPos, previousPos);
   }
   else
   {
@@ -90,50 +92,82 @@ double L_BFGS::ChooseScalingFactor(const size_t iterationNum,
 void L_BFGS::SearchDirection(const arma::mat& gradient,
                              const size_t iterationNum,
                              const double scalingFactor,
-                             const arma::cube& s,
-                             const arma::cube& y,
+                             const arma::mat& s,
+                             const arma::mat& y,
+                             const arma::mat& sy,
+                             const arma::mat& yy,
                              arma::mat& searchDirection)
 {
-  // Start from this point.
-  searchDirection = gradient;
+  // See "Representations of quasi-Newton matrices and their use in limited
+  // memory methods" (Byrd, Nocedal and Schnabel, 1994).  With the compact
+  // representation of the inverse Hessian approximation
+  //
+  //   H = gamma * I + [S  gamma * Y] [ R^-T (D + gamma * Y^T Y) R^-1  -R^-T ]
+  //                                  [ -R^-1                           0    ]
+  //                                  [S  gamma * Y]^T,
+  //
+  // where S and Y hold the basis vectors in order, R is the upper triangle of
+  // S^T Y and D is its diagonal, H * g takes two products of the basis with
+  // the gradient and two products back instead of going through the basis
+  // vectors one at a time, and everything else is of the size of the basis.
+  const size_t k = std::min(iterationNum, numBasis);
+  searchDirection = -scalingFactor * gradient;
+  if (k == 0)
+    return;
 
-  // See "A Recursive Formula to Compute H * g" in "Updating quasi-Newton
-  // matrices with limited storage" (Nocedal, 1980).
+  // The first k columns hold the basis vectors, and the oldest one is at
+  // position pos[0].
+  arma::uvec pos(k);
+  for (size_t j = 0; j < k; ++j)
+    pos[j] = (iterationNum - k + j) % numBasis;
 
-  // Temporary variables.
-  arma::vec rho(numBasis);
-  arma::vec alpha(numBasis);
+  const arma::vec g(const_cast<double*>(gradient.memptr()), gradient.n_elem,
+      false, true);
+  const arma::vec sg = s.head_cols(k).t() * g;
+  const arma::vec yg = y.head_cols(k).t() * g;
 
-  size_t limit = (numBasis > iterationNum) ? 0 : (iterationNum - numBasis);
-  for (size_t i = iterationNum; i != limit; i--)
+  // Solve R w = S^T g.
+  arma::vec w(k);
+  for (size_t j = k; j-- > 0; )
   {
-    int translatedPosition = (i + (numBasis - 1)) % numBasis;
-    rho[iterationNum - i] = 1.0 / arma::dot(y.slice(translatedPosition),
-                                            s.slice(translatedPosition));
-    alpha[iterationNum - i] = rho[iterationNum - i] *
-        arma::dot(s.slice(translatedPosition), searchDirection);
-    searchDirection -= alpha[iterationNum - i] * y.slice(translatedPosition);
+    double sum = sg[pos[j]];
+    for (size_t l = j + 1; l < k; ++l)
+      sum -= sy(pos[j], pos[l]) * w[l];
+    w[j] = sum / sy(pos[j], pos[j]);
   }
 
-  searchDirection *= scalingFactor;
+  // Solve R^T u = D w + gamma * (Y^T Y w - Y^T g).
+  arma::vec u(k);
+  for (size_t j = 0; j < k; ++j)
+  {
+    double sum = sy(pos[j], pos[j]) * w[j] - scalingFactor * yg[pos[j]];
+    for (size_t l = 0; l < k; ++l)
+      sum += scalingFactor * yy(pos[j], pos[l]) * w[l];
+    for (size_t l = 0; l < j; ++l)
+      sum -= sy(pos[l], pos[j]) * u[l];
+    u[j] = sum / sy(pos[j], pos[j]);
+  }
 
-  for (size_t i = limit; i < iterationNum; i++)
+  // Put the coefficients back in the order of the columns.
+  arma::vec sCoefficients(k), yCoefficients(k);
+  for (size_t j = 0; j < k; ++j)
   {
-    int translatedPosition = i % numBasis;
-    double beta = rho[iterationNum - i - 1] *
-        arma::dot(y.slice(translatedPosition), searchDirection);
-    searchDirection += (alpha[iterationNum - i - 1] - beta) *
-        s.slice(translatedPosition);
+    sCoefficients[pos[j]] = u[j];
+    yCoefficients[pos[j]] = scalingFactor * w[j];
   }
 
-  // Negate the search direction so that it is a descent direction.
-  searchDirection *= -1;
+  // The search direction is -H * g = -gamma * g - S u + gamma * Y w, which is
+  // a descent direction.
+  arma::vec direction(searchDirection.memptr(), searchDirection.n_elem, false,
+      true);
+  direction -= s.head_cols(k) * sCoefficients;
+  direction += y.head_cols(k) * yCoefficients;
 }
 
 /**
  * Update the y and s matrices, which store the differences between
  * the iterate and old iterate and the differences between the gradient and the
- * old gradient, respectively.
+ * old gradient, respectively, and the inner products of the basis vectors.
  *
  * @param iterationNum Iteration number
  * @param iterate Current point
@@ -146,14 +180,27 @@ void L_BFGS::UpdateBasisSet(const size_t iterationNum,
                             const arma::mat& oldIterate,
                             const arma::mat& gradient,
                             const arma::mat& oldGradient,
-                            arma::cube& s,
-                            arma::cube& y)
+                            arma::mat& s,
+                            arma::mat& y,
+                            arma::mat& sy,
+                            arma::mat& yy)
 {
   // Overwrite a certain position instead of pushing everything in the vector
   // back one position.
-  int overwritePos = iterationNum % numBasis;
-  s.slice(overwritePos) = iterate - oldIterate;
-  y.slice(overwritePos) = gradient - oldGradient;
+  const size_t overwritePos = iterationNum % numBasis;
+  s.col(overwritePos) = arma::vectorise(iterate - oldIterate);
+  y.col(overwritePos) = arma::vectorise(gradient - oldGradient);
+
+  // Only the inner products with the new basis vectors change.
+  const size_t numFilled = std::min(iterationNum + 1, numBasis);
+  sy.submat(overwritePos, 0, overwritePos, numFilled - 1) =
+      s.col(overwritePos).t() * y.head_cols(numFilled);
+  sy.submat(0, overwritePos, numFilled - 1, overwritePos) =
+      s.head_cols(numFilled).t() * y.col(overwritePos);
+
+  const arma::vec yty = y.head_cols(numFilled).t() * y.col(overwritePos);
+  yy.submat(0, overwritePos, numFilled - 1, overwritePos) = yty;
+  yy.submat(overwritePos, 0, overwritePos, numFilled - 1) = yty.t();
 }
 
 } // namespace optimization
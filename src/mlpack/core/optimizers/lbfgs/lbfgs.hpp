@@ -14,6 +14,8 @@
 #define MLPACK_CORE_OPTIMIZERS_LBFGS_LBFGS_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/core/optimizers/evaluate_with_gradient.hpp>
+#include <mlpack/core/optimizers/checkpoint/checkpoint.hpp>
 
 namespace mlpack {
 namespace optimization {
@@ -30,6 +32,28 @@ namespace optimization {
  *  - double Evaluate(const arma::mat& coordinates);
  *  - void Gradient(const arma::mat& coordinates, arma::mat& gradient);
  *  - arma::mat& GetInitialPoint();
+ *
+ * If the function also implements
+ *
+ *  - double EvaluateWithGradient(const arma::mat& coordinates,
+ *                                arma::mat& gradient);
+ *
+ * then it is used to compute the objective and the gradient of each point of
+ * the line search in one pass.
+ *
+ * The search direction is computed with the compact representation of the
+ * inverse Hessian approximation (Byrd, Nocedal and Schnabel, 1994), so that
+ * each iteration only takes a few matrix-vector products with the basis.  When
+ * ParallelLineSearch() is set, the line search evaluates the next trial step
+ * sizes at once with the OpenMP threads (assuming that the step size keeps
+ * decreasing, which is the common case), and uses them in order, so the steps
+ * are the same as with the serial line search; the Evaluate() and Gradient()
+ * (or EvaluateWithGradient()) methods of the function must then be
+ * thread-safe, and each thread holds a point and a gradient of its own.
+ *
+ * The state of the optimization (the iterate and the basis) can be saved every
+ * few iterations, so that an interrupted run can be resumed; see Checkpoint()
+ * and OptimizerCheckpoint.
  */
 class L_BFGS
 {
@@ -50,6 +74,8 @@ class L_BFGS
    *     (before giving up).
    * @param minStep The minimum step of the line search.
    * @param maxStep The maximum step of the line search.
+   * @param parallelLineSearch Whether to evaluate several trial step sizes of
+   *     the line search at once with the OpenMP threads.
    */
   L_BFGS(const size_t numBasis = 10, /* same default as scipy */
          const size_t maxIterations = 10000, /* many but not infinite */
@@ -59,7 +85,8 @@ class L_BFGS
          const double factr = 1e-15,
          const size_t maxLineSearchTrials = 50,
          const double minStep = 1e-20,
-         const double maxStep = 1e20);
+         const double maxStep = 1e20,
+         const bool parallelLineSearch = false);
 
   /**
    * Return the point where the lowest function value has been found.
@@ -130,7 +157,53 @@ class L_BFGS
   //! Modify the maximum line search step size.
   double& MaxStep() { return maxStep; }
 
+  //! Get whether the trial step sizes of the line search are evaluated in
+  //! parallel.
+  bool ParallelLineSearch() const { return parallelLineSearch; }
+  //! Modify whether the trial step sizes of the line search are evaluated in
+  //! parallel.
+  bool& ParallelLineSearch() { return parallelLineSearch; }
+
+  //! Get the checkpoint settings (a checkpoint is saved every Interval()
+  //! iterations).
+  const OptimizerCheckpoint& Checkpoint() const { return checkpoint; }
+  //! Modify the checkpoint settings (a checkpoint is saved every Interval()
+  //! iterations).
+  OptimizerCheckpoint& Checkpoint() { return checkpoint; }
+
  private:
+  /**
+   * The state of an optimization that is saved in a checkpoint, at the start
+   * of an iteration.
+   */
+  struct CheckpointState
+  {
+    size_t& iteration;
+    arma::mat& iterate;
+    arma::mat& gradient;
+    double& functionValue;
+    arma::mat& s;
+    arma::mat& y;
+    arma::mat& sy;
+    arma::mat& yy;
+    std::pair<arma::mat, double>& minPointIterate;
+
+    template<typename Archive>
+    void serialize(Archive& ar, const unsigned int /* version */)
+    {
+      ar & BOOST_SERIALIZATION_NVP(iteration);
+      ar & BOOST_SERIALIZATION_NVP(iterate);
+      ar & BOOST_SERIALIZATION_NVP(gradient);
+      ar & BOOST_SERIALIZATION_NVP(functionValue);
+      ar & BOOST_SERIALIZATION_NVP(s);
+      ar & BOOST_SERIALIZATION_NVP(y);
+      ar & BOOST_SERIALIZATION_NVP(sy);
+      ar & BOOST_SERIALIZATION_NVP(yy);
+      ar & boost::serialization::make_nvp("minPoint", minPointIterate.first);
+      ar & boost::serialization::make_nvp("minValue", minPointIterate.second);
+    }
+  };
+
   //! Size of memory for this L-BFGS optimizer.
   size_t numBasis;
   //! Maximum number of iterations.
@@ -149,16 +222,22 @@ class L_BFGS
   double minStep;
   //! Maximum step of the line search.
   double maxStep;
+  //! Whether the trial step sizes of the line search are evaluated in
+  //! parallel.
+  bool parallelLineSearch;
+  //! The checkpoint settings.
+  OptimizerCheckpoint checkpoint;
 
   /**
-   * Evaluate the function at the given iterate point and store the result if it
-   * is a new minimum.
+   * Evaluate the function and its gradient at the given iterate point and
+   * store the result if it is a new minimum.
    *
    * @return The value of the function.
    */
   template<typename FunctionType>
   double Evaluate(FunctionType& function,
                   const arma::mat& iterate,
+                  arma::mat& gradient,
                   std::pair<arma::mat, double>& minPointIterate);
 
   /**
@@ -170,8 +249,8 @@ class L_BFGS
    */
   double ChooseScalingFactor(const size_t iterationNum,
                              const arma::mat& gradient,
-                             const arma::cube& s,
-                             const arma::cube& y);
+                             const arma::mat& sy,
+                             const arma::mat& yy);
 
   /**
    * Check to make sure that the norm of the gradient is not smaller than 1e-5.
@@ -209,19 +288,26 @@ class L_BFGS
    * @param gradient The gradient at the current point
    * @param iteration_num The iteration number
    * @param scaling_factor Scaling factor to use (see ChooseScalingFactor_())
+   * @param s The differences between the iterates, one in each column
+   * @param y The differences between the gradients, one in each column
+   * @param sy The inner products of the columns of s and y
+   * @param yy The inner products of the columns of y
    * @param search_direction Vector to store search direction in
    */
   void SearchDirection(const arma::mat& gradient,
                        const size_t iterationNum,
                        const double scalingFactor,
-                       const arma::cube& s,
-                       const arma::cube& y,
+                       const arma::mat& s,
+                       const arma::mat& y,
+                       const arma::mat& sy,
+                       const arma::mat& yy,
                        arma::mat& searchDirection);
 
   /**
    * Update the y and s matrices, which store the differences
    * between the iterate and old iterate and the differences between the
-   * gradient and the old gradient, respectively.
+   * gradient and the old gradient, respectively, and the sy and yy matrices,
+   * which store their inner products.
    *
    * @param iterationNum Iteration number
    * @param iterate Current point
@@ -234,8 +320,10 @@ class L_BFGS
                       const arma::mat& oldIterate,
                       const arma::mat& gradient,
                       const arma::mat& oldGradient,
-                      arma::cube& s,
-                      arma::cube& y);
+                      arma::mat& s,
+                      arma::mat& y,
+                      arma::mat& sy,
+                      arma::mat& yy);
 };
 
 } // namespace optimization
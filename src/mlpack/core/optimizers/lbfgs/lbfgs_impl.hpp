@@ -13,23 +13,29 @@
 #ifndef MLPACK_CORE_OPTIMIZERS_LBFGS_LBFGS_IMPL_HPP
 #define MLPACK_CORE_OPTIMIZERS_LBFGS_LBFGS_IMPL_HPP
 
+#ifdef HAS_OPENMP
+  #include <omp.h>
+#endif
+
 namespace mlpack {
 namespace optimization {
 
 /**
- * Evaluate the function at the given iterate point and store the result if
- * it is a new minimum.
+ * Evaluate the function and its gradient at the given iterate point and store
+ * the result if it is a new minimum.
  *
  * @return The value of the function
  */
 template<typename FunctionType>
 double L_BFGS::Evaluate(FunctionType& function,
                         const arma::mat& iterate,
+                        arma::mat& gradient,
                         std::pair<arma::mat, double>& minPointIterate)
 {
   // Evaluate the function and keep track of the minimum function
   // value encountered during the optimization.
-  const double functionValue = function.Evaluate(iterate);
+  const double functionValue = EvaluateWithGradient(function, iterate,
+      gradient);
 
   if (functionValue < minPointIterate.second)
   {
@@ -105,55 +111,116 @@ bool L_BFGS::LineSearch(FunctionType& function,
   const double dec = 0.5;
   double width = 0;
 
-  while (true)
+  // With a parallel line search, the next trial step sizes are evaluated at
+  // once, as if the step size were decreased after each of them; the results
+  // are then used in order, until the step size is not decreased.
+  size_t numThreads = 1;
+  #ifdef HAS_OPENMP
+    if (parallelLineSearch)
+      numThreads = omp_get_max_threads();
+  #endif
+  std::vector<arma::mat> trialIterates;
+  std::vector<arma::mat> trialGradients;
+  arma::vec trialValues;
+
+  bool finished = false;
+  while (!finished)
   {
-    // Perform a step and evaluate the gradient and the function values at that
-    // point.
-    newIterateTmp = iterate;
-    newIterateTmp += stepSize * searchDirection;
-    functionValue = Evaluate(function, newIterateTmp, minPointIterate);
-    function.Gradient(newIterateTmp, gradient);
-    numIterations++;
-
-    if (functionValue > initialFunctionValue + stepSize *
-        linearApproxFunctionValueDecrease)
+    const size_t numTrials = (numIterations + 1 < maxLineSearchTrials) ?
+        std::min(numThreads, maxLineSearchTrials - numIterations) : 1;
+    if (numTrials > 1)
     {
-      width = dec;
+      trialIterates.resize(numTrials);
+      trialGradients.resize(numTrials);
+      trialValues.set_size(numTrials);
+
+      #pragma omp parallel for num_threads(numTrials)
+      for (omp_size_t t = 0; t < (omp_size_t) numTrials; ++t)
+      {
+        double trialStepSize = stepSize;
+        for (size_t j = 0; j < (size_t) t; ++j)
+          trialStepSize *= dec;
+
+        trialIterates[t] = iterate;
+        trialIterates[t] += trialStepSize * searchDirection;
+        trialValues[t] = EvaluateWithGradient(function, trialIterates[t],
+            trialGradients[t]);
+      }
     }
-    else
+
+    for (size_t t = 0; t < numTrials; ++t)
     {
-      // Check Wolfe's condition.
-      double searchDirectionDotGradient = arma::dot(gradient, searchDirection);
+      // Perform a step and evaluate the gradient and the function values at
+      // that point.
+      if (numTrials > 1)
+      {
+        newIterateTmp.swap(trialIterates[t]);
+        gradient.swap(trialGradients[t]);
+        functionValue = trialValues[t];
+        if (functionValue < minPointIterate.second)
+        {
+          minPointIterate.first = newIterateTmp;
+          minPointIterate.second = functionValue;
+        }
+      }
+      else
+      {
+        newIterateTmp = iterate;
+        newIterateTmp += stepSize * searchDirection;
+        functionValue = Evaluate(function, newIterateTmp, gradient,
+            minPointIterate);
+      }
+      numIterations++;
 
-      if (searchDirectionDotGradient < wolfe *
-          initialSearchDirectionDotGradient)
+      if (functionValue > initialFunctionValue + stepSize *
+          linearApproxFunctionValueDecrease)
       {
-        width = inc;
+        width = dec;
       }
       else
       {
-        if (searchDirectionDotGradient > -wolfe *
+        // Check Wolfe's condition.
+        double searchDirectionDotGradient = arma::dot(gradient,
+            searchDirection);
+
+        if (searchDirectionDotGradient < wolfe *
             initialSearchDirectionDotGradient)
         {
-          width = dec;
+          width = inc;
         }
         else
         {
-          break;
+          if (searchDirectionDotGradient > -wolfe *
+              initialSearchDirectionDotGradient)
+          {
+            width = dec;
+          }
+          else
+          {
+            finished = true;
+            break;
+          }
         }
       }
-    }
 
-    // Terminate when the step size gets too small or too big or it
-    // exceeds the max number of iterations.
-    const bool cond1 = (stepSize < minStep);
-    const bool cond2 = (stepSize > maxStep);
-    const bool cond3 = (numIterations >= maxLineSearchTrials);
-    if (cond1 || cond2 || cond3)
-      break;
+      // Terminate when the step size gets too small or too big or it
+      // exceeds the max number of iterations.
+      const bool cond1 = (stepSize < minStep);
+      const bool cond2 = (stepSize > maxStep);
+      const bool cond3 = (numIterations >= maxLineSearchTrials);
+      if (cond1 || cond2 || cond3)
+      {
+        finished = true;
+        break;
+      }
+
+      // Scale the step size.
+      stepSize *= width;
 
-    // Scale the step size.
-    stepSize *= width;
+      // The other trials were evaluated for a decreased step size.
+      if (width != dec)
+        break;
+    }
   }
 
   // Move to the new iterate.
@@ -173,14 +240,16 @@ bool L_BFGS::LineSearch(FunctionType& function,
 template<typename FunctionType>
 double L_BFGS::Optimize(FunctionType& function, arma::mat& iterate)
 {
-  // Ensure that the cubes holding past iterations' information are the right
-  // size.  Also set the current best point value to the maximum.
+  // Ensure that the matrices holding past iterations' information are the
+  // right size.  Also set the current best point value to the maximum.
   const size_t rows = iterate.n_rows;
   const size_t cols = iterate.n_cols;
 
   arma::mat newIterateTmp(rows, cols);
-  arma::cube s(rows, cols, numBasis);
-  arma::cube y(rows, cols, numBasis);
+  arma::mat s(rows * cols, numBasis);
+  arma::mat y(rows * cols, numBasis);
+  arma::mat sy(numBasis, numBasis);
+  arma::mat yy(numBasis, numBasis);
   std::pair<arma::mat, double> minPointIterate;
   minPointIterate.second = std::numeric_limits<double>::max();
 
@@ -191,10 +260,6 @@ double L_BFGS::Optimize(FunctionType& function, arma::mat& iterate)
   // Whether to optimize until convergence.
   bool optimizeUntilConvergence = (maxIterations == 0);
 
-  // The initial function value.
-  double functionValue = Evaluate(function, iterate, minPointIterate);
-  double prevFunctionValue = functionValue;
-
   // The gradient: the current and the old.
   arma::mat gradient;
   arma::mat oldGradient;
@@ -205,15 +270,41 @@ double L_BFGS::Optimize(FunctionType& function, arma::mat& iterate)
   arma::mat searchDirection;
   searchDirection.zeros(iterate.n_rows, iterate.n_cols);
 
-  // The initial gradient value.
-  function.Gradient(iterate, gradient);
+  // The initial function and gradient value.
+  double functionValue = Evaluate(function, iterate, gradient,
+      minPointIterate);
+  double prevFunctionValue = functionValue;
+
+  // Resume from the last checkpoint, if there is one.
+  size_t itNum = 0;
+  CheckpointState state = { itNum, iterate, gradient, functionValue, s, y, sy,
+      yy, minPointIterate };
+  if (checkpoint.Enabled() && checkpoint.Load("L_BFGS", state))
+  {
+    if (s.n_rows != rows * cols || s.n_cols != numBasis)
+    {
+      std::ostringstream oss;
+      oss << "L_BFGS::Optimize(): the checkpoint '" << checkpoint.Filename()
+          << "' was saved with a different number of basis points or "
+          << "coordinates!";
+      throw std::invalid_argument(oss.str());
+    }
+
+    prevFunctionValue = functionValue;
+  }
 
   // The main optimization loop.
-  for (size_t itNum = 0; optimizeUntilConvergence || (itNum != maxIterations);
-       ++itNum)
+  for (/* itNum is set above */;
+       optimizeUntilConvergence || (itNum != maxIterations); ++itNum)
   {
-    Log::Debug << "L-BFGS iteration " << itNum << "; objective " <<
-        function.Evaluate(iterate) << ", gradient norm "
+    // Save the state (in the background), if it is time.
+    if (itNum > 0 && checkpoint.Due(itNum))
+      checkpoint.Save("L_BFGS", state);
+
+    // The line search leaves the objective of the new iterate in
+    // functionValue.
+    MLPACK_LOG_DEBUG << "L-BFGS iteration " << itNum << "; objective " <<
+        functionValue << ", gradient norm "
         << arma::norm(gradient, 2) << ", "
         << ((prevFunctionValue - functionValue) /
             std::max(std::max(fabs(prevFunctionValue),
@@ -243,11 +334,12 @@ double L_BFGS::Optimize(FunctionType& function, arma::mat& iterate)
     }
 
     // Choose the scaling factor.
-    double scalingFactor = ChooseScalingFactor(itNum, gradient, s, y);
+    double scalingFactor = ChooseScalingFactor(itNum, gradient, sy, yy);
 
     // Build an approximation to the Hessian and choose the search
     // direction for the current iteration.
-    SearchDirection(gradient, itNum, scalingFactor, s, y, searchDirection);
+    SearchDirection(gradient, itNum, scalingFactor, s, y, sy, yy,
+        searchDirection);
 
     // Save the old iterate and the gradient before stepping.
     oldIterate = iterate;
@@ -282,9 +374,11 @@ double L_BFGS::Optimize(FunctionType& function, arma::mat& iterate)
     }
 
     // Overwrite an old basis set.
-    UpdateBasisSet(itNum, iterate, oldIterate, gradient, oldGradient, s, y);
+    UpdateBasisSet(itNum, iterate, oldIterate, gradient, oldGradient, s, y, sy,
+        yy);
   } // End of the optimization loop.
 
+  checkpoint.Finish();
   return function.Evaluate(iterate);
 }
 
@@ -14,6 +14,7 @@
 
 #include <mlpack/prereqs.hpp>
 #include <mlpack/core/math/random.hpp>
+#include <mlpack/core/optimizers/evaluate_with_gradient.hpp>
 #include "decay_policies/constant_step.hpp"
 
 namespace mlpack {
@@ -50,8 +51,42 @@ namespace optimization {
  *
  * The Gradient function interface is slightly changed from the
  * DecomposableFunctionType interface, it takes in a sparse matrix as the
- * out-param for the gradient, as ParallelSGD is only expected to be relevant in
- * situations where the computed gradient is sparse.
+ * out-param for the gradient, as ParallelSGD is mostly relevant in situations
+ * where the computed gradient is sparse.
+ *
+ * Dense objectives, whose class implements the separable
+ * EvaluateWithGradient() used by SGD (like LogisticRegressionFunction), are
+ * optimized with mini-batches instead: each thread takes the dense gradient
+ * of batchSize points with
+ *
+ *   double Evaluate(const arma::mat& coordinates,
+ *                   const size_t i,
+ *                   const size_t batchSize);
+ *   void Gradient(const arma::mat& coordinates,
+ *                 const size_t i,
+ *                 arma::mat& gradient,
+ *                 const size_t batchSize);
+ *
+ * and applies it to the whole decision variable.
+ *
+ * In both cases the functions are called by several threads at once.  A
+ * sparse objective must not modify the state of its class.  A dense objective
+ * whose Evaluate() is const (like LogisticRegressionFunction) is assumed to be
+ * thread-safe, and all the threads share it.  Otherwise (like FFN, which runs
+ * the points through its own layers), each thread gets a copy of the dense
+ * objective, which must then evaluate the given coordinates rather than its
+ * own parameters.
+ *
+ * The points (or mini-batches) are split into slices of threadShareSize
+ * points, and at each iteration each thread takes the next slice in turn, so
+ * that all of them are visited even when there are more slices than threads.
+ * When shuffling is enabled, the points are shuffled once, and then each
+ * thread visits its slice in an order drawn from a generator of its own, so
+ * that there is no serial shuffle at each iteration.  The updates of the
+ * threads are atomic by default; without atomic updates (AtomicUpdates() set
+ * to false), this is the original HOGWILD! scheme, where the threads may
+ * overwrite each other's updates of the same element, which is harmless when
+ * the updates are sparse.
  *
  * @tparam DecayPolicyType Step size update policy used by parallel SGD
  *     to update the stepsize after each iteration.
@@ -76,12 +111,22 @@ class ParallelSGD
    * @param shuffle If true, the function order is shuffled; otherwise, each
    *     function is visited in linear order.
    * @param decayPolicy The step size update policy to use.
+   * @param batchSize Number of points in each mini-batch of a dense objective.
+   * @param evaluationInterval The objective is evaluated (and the tolerance is
+   *     checked) every evaluationInterval iterations; 0 means that it is only
+   *     evaluated at the end.
+   * @param atomicUpdates If true, each element of the decision variable is
+   *     updated atomically; otherwise, the threads update it without any
+   *     synchronization.
   */
   ParallelSGD(const size_t maxIterations,
               const size_t threadShareSize,
               const double tolerance = 1e-5,
               const bool shuffle = true,
-              const DecayPolicyType& decayPolicy = DecayPolicyType());
+              const DecayPolicyType& decayPolicy = DecayPolicyType(),
+              const size_t batchSize = 32,
+              const size_t evaluationInterval = 1,
+              const bool atomicUpdates = true);
 
   /**
    * Optimize the given function using the parallel SGD algorithm. The given
@@ -124,7 +169,135 @@ class ParallelSGD
   //! Modify the step size decay policy.
   DecayPolicyType& DecayPolicy() { return decayPolicy; }
 
+  //! Get the number of points in each mini-batch of a dense objective.
+  size_t BatchSize() const { return batchSize; }
+  //! Modify the number of points in each mini-batch of a dense objective.
+  size_t& BatchSize() { return batchSize; }
+
+  //! Get the number of iterations between evaluations of the objective.
+  size_t EvaluationInterval() const { return evaluationInterval; }
+  //! Modify the number of iterations between evaluations of the objective.
+  size_t& EvaluationInterval() { return evaluationInterval; }
+
+  //! Get whether the elements of the decision variable are updated atomically.
+  bool AtomicUpdates() const { return atomicUpdates; }
+  //! Modify whether the elements of the decision variable are updated
+  //! atomically.
+  bool& AtomicUpdates() { return atomicUpdates; }
+
  private:
+  /**
+   * Get the number of points in each block of a sparse objective: the points
+   * are visited one at a time.
+   */
+  template<typename SparseFunctionType>
+  typename std::enable_if<
+      !HasSeparableEvaluateWithGradient<SparseFunctionType>::value,
+      size_t>::type
+  BlockSize(SparseFunctionType& /* function */) const { return 1; }
+
+  /**
+   * Get the number of points in each block of a dense objective: the points
+   * are visited one mini-batch at a time.
+   */
+  template<typename DenseFunctionType>
+  typename std::enable_if<
+      HasSeparableEvaluateWithGradient<DenseFunctionType>::value, size_t>::type
+  BlockSize(DenseFunctionType& /* function */) const { return batchSize; }
+
+  //! The copies of a function used by the threads.
+  template<typename FunctionType>
+  using CopyVector = std::vector<std::unique_ptr<FunctionType>>;
+
+  //! Sparse objectives and dense objectives with a const Evaluate() are
+  //! shared, so nothing is copied.
+  template<typename FunctionType>
+  typename std::enable_if<
+      !HasSeparableEvaluateWithGradient<FunctionType>::value ||
+      HasConstEvaluate<FunctionType>::value, void>::type
+  MakeCopies(FunctionType& /* function */,
+             CopyVector<FunctionType>& /* copies */,
+             const size_t /* numThreads */) const { }
+
+  //! Make a copy of the dense objective for each thread.
+  template<typename FunctionType>
+  typename std::enable_if<
+      HasSeparableEvaluateWithGradient<FunctionType>::value &&
+      !HasConstEvaluate<FunctionType>::value, void>::type
+  MakeCopies(FunctionType& function,
+             CopyVector<FunctionType>& copies,
+             const size_t numThreads) const
+  {
+    for (size_t t = 0; t < numThreads; ++t)
+      copies.emplace_back(new FunctionType(function));
+  }
+
+  //! Get the function to be used by the given thread.
+  template<typename FunctionType>
+  static FunctionType& ThreadFunction(FunctionType& function,
+                                      CopyVector<FunctionType>& copies,
+                                      const size_t threadId)
+  {
+    return copies.empty() ? function : *copies[threadId];
+  }
+
+  /**
+   * Take a step with the sparse gradient of the given point, and apply its
+   * non-zero components to the decision variable.
+   *
+   * @param function Function to be optimized.
+   * @param iterate Decision variable to update.
+   * @param stepSize Step size of this iteration.
+   * @param block Index of the point.
+   */
+  template<typename SparseFunctionType>
+  typename std::enable_if<
+      !HasSeparableEvaluateWithGradient<SparseFunctionType>::value, void>::type
+  Step(SparseFunctionType& function,
+       arma::mat& iterate,
+       const double stepSize,
+       const size_t block);
+
+  /**
+   * Take a step with the dense gradient of the given mini-batch, and apply it
+   * to the decision variable.
+   *
+   * @param function Function to be optimized.
+   * @param iterate Decision variable to update.
+   * @param stepSize Step size of this iteration.
+   * @param block Index of the mini-batch.
+   */
+  template<typename DenseFunctionType>
+  typename std::enable_if<
+      HasSeparableEvaluateWithGradient<DenseFunctionType>::value, void>::type
+  Step(DenseFunctionType& function,
+       arma::mat& iterate,
+       const double stepSize,
+       const size_t block);
+
+  /**
+   * Evaluate a sparse objective with all the threads, one point at a time.
+   */
+  template<typename SparseFunctionType>
+  typename std::enable_if<
+      !HasSeparableEvaluateWithGradient<SparseFunctionType>::value,
+      double>::type
+  Objective(SparseFunctionType& function,
+            CopyVector<SparseFunctionType>& copies,
+            const arma::mat& iterate,
+            const size_t numThreads) const;
+
+  /**
+   * Evaluate a dense objective with all the threads, one mini-batch at a time.
+   */
+  template<typename DenseFunctionType>
+  typename std::enable_if<
+      HasSeparableEvaluateWithGradient<DenseFunctionType>::value, double>::type
+  Objective(DenseFunctionType& function,
+            CopyVector<DenseFunctionType>& copies,
+            const arma::mat& iterate,
+            const size_t numThreads) const;
+
   //! The maximum number of allowed iterations.
   size_t maxIterations;
 
@@ -140,6 +313,15 @@ class ParallelSGD
 
   //! The step size decay policy.
   DecayPolicyType decayPolicy;
+
+  //! The number of points in each mini-batch of a dense objective.
+  size_t batchSize;
+
+  //! The number of iterations between evaluations of the objective.
+  size_t evaluationInterval;
+
+  //! Whether the elements of the decision variable are updated atomically.
+  bool atomicUpdates;
 };
 
 } // namespace optimization
@@ -24,12 +24,18 @@ ParallelSGD<DecayPolicyType>::ParallelSGD(
     const size_t threadShareSize,
     const double tolerance,
     const bool shuffle,
-    const DecayPolicyType& decayPolicy) :
+    const DecayPolicyType& decayPolicy,
+    const size_t batchSize,
+    const size_t evaluationInterval,
+    const bool atomicUpdates) :
     maxIterations(maxIterations),
     threadShareSize(threadShareSize),
     tolerance(tolerance),
     shuffle(shuffle),
-    decayPolicy(decayPolicy)
+    decayPolicy(decayPolicy),
+    batchSize(batchSize),
+    evaluationInterval(evaluationInterval),
+    atomicUpdates(atomicUpdates)
 { /* Nothing to do. */ }
 
 template <typename DecayPolicyType>
@@ -38,94 +44,258 @@ double ParallelSGD<DecayPolicyType>::Optimize(
     SparseFunctionType& function,
     arma::mat& iterate)
 {
+  // Without any evaluation of the objective, the optimization would never
+  // terminate.
+  if (maxIterations == 0 && evaluationInterval == 0)
+  {
+    throw std::invalid_argument("ParallelSGD::Optimize(): the evaluation "
+        "interval must be positive when there is no limit on the number of "
+        "iterations!");
+  }
+
+  // The points are visited one block at a time: a point of a sparse
+  // objective, or a mini-batch of a dense objective.  Each thread visits one
+  // slice of blocks at each iteration.
+  const size_t blockSize = BlockSize(function);
+  if (blockSize == 0)
+  {
+    throw std::invalid_argument("ParallelSGD::Optimize(): the batch size must "
+        "be positive!");
+  }
+
+  const size_t numBlocks = (function.NumFunctions() + blockSize - 1) /
+      blockSize;
+  const size_t sliceSize = std::max((size_t) 1, threadShareSize / blockSize);
+  const size_t numSlices = (numBlocks + sliceSize - 1) / sliceSize;
+
+  // The order in which the blocks will be visited.  After this one serial
+  // shuffle, each thread only shuffles its own slice.
+  arma::Col<size_t> visitationOrder = arma::linspace<arma::Col<size_t>>(0,
+      (numBlocks - 1), numBlocks);
+  if (shuffle)
+  {
+    std::shuffle(visitationOrder.begin(), visitationOrder.end(),
+        mlpack::math::randGen);
+  }
+
+  // Dense objectives that are not thread-safe are copied for each thread.
+  size_t maxThreads = 1;
+  #ifdef HAS_OPENMP
+    maxThreads = omp_get_max_threads();
+  #endif
+
+  CopyVector<SparseFunctionType> copies;
+  if (maxThreads > 1)
+    MakeCopies(function, copies, maxThreads);
+
   double overallObjective = DBL_MAX;
   double lastObjective;
 
-  // The order in which the functions will be visited.
-  arma::Col<size_t> visitationOrder = arma::linspace<arma::Col<size_t>>(0,
-      (function.NumFunctions() - 1), function.NumFunctions());
+  // The slice taken by the first thread at the current iteration.
+  size_t firstSlice = 0;
 
   // Iterate till the objective is within tolerance or the maximum number of
   // allowed iterations is reached. If maxIterations is 0, this will iterate
   // till convergence.
   for (size_t i = 1; i != maxIterations; ++i)
   {
-    // Calculate the overall objective.
-    lastObjective = overallObjective;
-
-    overallObjective = function.Evaluate(iterate);
+    if (evaluationInterval > 0 && (i - 1) % evaluationInterval == 0)
+    {
+      // Calculate the overall objective.
+      lastObjective = overallObjective;
+      overallObjective = Objective(function, copies, iterate, maxThreads);
 
-    // Output current objective function.
-    Log::Info << "Parallel SGD: iteration " << i << ", objective "
-      << overallObjective << "." << std::endl;
+      // Output current objective function.
+      Log::Info << "Parallel SGD: iteration " << i << ", objective "
+        << overallObjective << "." << std::endl;
 
-    if (std::isnan(overallObjective) || std::isinf(overallObjective))
-    {
-      Log::Warn << "Parallel SGD: converged to " << overallObjective
-        << "; terminating with failure. Try a smaller step size?"
-        << std::endl;
-      return overallObjective;
-    }
+      if (std::isnan(overallObjective) || std::isinf(overallObjective))
+      {
+        Log::Warn << "Parallel SGD: converged to " << overallObjective
+          << "; terminating with failure. Try a smaller step size?"
+          << std::endl;
+        return overallObjective;
+      }
 
-    if (std::abs(lastObjective - overallObjective) < tolerance)
-    {
-      Log::Info << "SGD: minimized within tolerance " << tolerance << "; "
-        << "terminating optimization." << std::endl;
-      return overallObjective;
+      if (std::abs(lastObjective - overallObjective) < tolerance)
+      {
+        Log::Info << "SGD: minimized within tolerance " << tolerance << "; "
+          << "terminating optimization." << std::endl;
+        return overallObjective;
+      }
     }
 
     // Get the stepsize for this iteration
     double stepSize = decayPolicy.StepSize(i);
 
-    // Shuffle for uniform sampling of functions by each thread.
-    if (shuffle)
-    {
-      // Determine order of visitation.
-      std::shuffle(visitationOrder.begin(), visitationOrder.end(),
-          mlpack::math::randGen);
-    }
+    // The generator of each thread is seeded from this, so that the threads
+    // don't share the (not thread-safe) global generator.
+    const size_t seed = mlpack::math::randGen();
+    size_t numThreads = 1;
 
-    #pragma omp parallel
+    #pragma omp parallel num_threads(maxThreads)
     {
-      // Each processor gets a subset of the instances.
-      // Each subset is of size threadShareSize
       size_t threadId = 0;
       #ifdef HAS_OPENMP
         threadId = omp_get_thread_num();
+        #pragma omp master
+        numThreads = omp_get_num_threads();
       #endif
+      SparseFunctionType& threadFunction = ThreadFunction(function, copies,
+          threadId);
 
-      for (size_t j = threadId * threadShareSize;
-          j < (threadId + 1) * threadShareSize && j < visitationOrder.n_elem;
-          ++j)
+      // The threads take distinct slices, so they can shuffle them without
+      // synchronization.
+      if (threadId < numSlices)
       {
-        // Each instance affects only some components of the decision variable.
-        // So the gradient is sparse.
-        arma::sp_mat gradient;
-
-        // Evaluate the sparse gradient.
-        function.Gradient(iterate, visitationOrder[j], gradient);
+        const size_t slice = (firstSlice + threadId) % numSlices;
+        const size_t sliceBegin = slice * sliceSize;
+        const size_t sliceEnd = std::min(sliceBegin + sliceSize, numBlocks);
 
-        // Update the decision variable with non-zero components of the
-        // gradient.
-        for (size_t i = 0; i < gradient.n_cols; ++i)
+        if (shuffle)
         {
-          // Iterate over the non-zero elements.
-          for (arma::sp_mat::iterator cur = gradient.begin_col(i);
-              cur != gradient.end_col(i); ++cur)
-          {
-            #pragma omp atomic
-            iterate(cur.row(), i) -= stepSize * (*cur);
-          }
+          std::mt19937 generator(seed + threadId);
+          std::shuffle(visitationOrder.begin() + sliceBegin,
+              visitationOrder.begin() + sliceEnd, generator);
         }
+
+        for (size_t j = sliceBegin; j < sliceEnd; ++j)
+          Step(threadFunction, iterate, stepSize, visitationOrder[j]);
       }
     }
+
+    firstSlice = (firstSlice + numThreads) % numSlices;
   }
 
+  // The last objective was computed before the last updates (if at all).
+  overallObjective = Objective(function, copies, iterate, maxThreads);
+
   Log::Info << "\n Parallel SGD terminated with objective : "
     << overallObjective << std::endl;
   return overallObjective;
 }
 
+template <typename DecayPolicyType>
+template <typename SparseFunctionType>
+typename std::enable_if<
+    !HasSeparableEvaluateWithGradient<SparseFunctionType>::value, void>::type
+ParallelSGD<DecayPolicyType>::Step(SparseFunctionType& function,
+                                   arma::mat& iterate,
+                                   const double stepSize,
+                                   const size_t block)
+{
+  // Each instance affects only some components of the decision variable.
+  // So the gradient is sparse.
+  arma::sp_mat gradient;
+
+  // Evaluate the sparse gradient.
+  function.Gradient(iterate, block, gradient);
+
+  // Update the decision variable with non-zero components of the gradient.
+  for (size_t i = 0; i < gradient.n_cols; ++i)
+  {
+    // Iterate over the non-zero elements.
+    for (arma::sp_mat::iterator cur = gradient.begin_col(i);
+        cur != gradient.end_col(i); ++cur)
+    {
+      if (atomicUpdates)
+      {
+        #pragma omp atomic
+        iterate(cur.row(), i) -= stepSize * (*cur);
+      }
+      else
+      {
+        iterate(cur.row(), i) -= stepSize * (*cur);
+      }
+    }
+  }
+}
+
+template <typename DecayPolicyType>
+template <typename DenseFunctionType>
+typename std::enable_if<
+    HasSeparableEvaluateWithGradient<DenseFunctionType>::value, void>::type
+ParallelSGD<DecayPolicyType>::Step(DenseFunctionType& function,
+                                   arma::mat& iterate,
+                                   const double stepSize,
+                                   const size_t block)
+{
+  // The last mini-batch may be smaller.
+  const size_t begin = block * batchSize;
+  const size_t effectiveBatchSize = std::min(batchSize,
+      function.NumFunctions() - begin);
+
+  arma::mat gradient;
+  function.Gradient(iterate, begin, gradient, effectiveBatchSize);
+
+  if (atomicUpdates)
+  {
+    for (size_t i = 0; i < iterate.n_elem; ++i)
+    {
+      #pragma omp atomic
+      iterate[i] -= stepSize * gradient[i];
+    }
+  }
+  else
+  {
+    iterate -= stepSize * gradient;
+  }
+}
+
+template <typename DecayPolicyType>
+template <typename SparseFunctionType>
+typename std::enable_if<
+    !HasSeparableEvaluateWithGradient<SparseFunctionType>::value, double>::type
+ParallelSGD<DecayPolicyType>::Objective(
+    SparseFunctionType& function,
+    CopyVector<SparseFunctionType>& /* copies */,
+    const arma::mat& iterate,
+    const size_t numThreads) const
+{
+  double objective = 0;
+
+  #pragma omp parallel for num_threads(numThreads) reduction(+:objective)
+  for (omp_size_t j = 0; j < (omp_size_t) function.NumFunctions(); ++j)
+    objective += function.Evaluate(iterate, j);
+
+  return objective;
+}
+
+template <typename DecayPolicyType>
+template <typename DenseFunctionType>
+typename std::enable_if<
+    HasSeparableEvaluateWithGradient<DenseFunctionType>::value, double>::type
+ParallelSGD<DecayPolicyType>::Objective(
+    DenseFunctionType& function,
+    CopyVector<DenseFunctionType>& copies,
+    const arma::mat& iterate,
+    const size_t numThreads) const
+{
+  const size_t numFunctions = function.NumFunctions();
+  const size_t numBlocks = (numFunctions + batchSize - 1) / batchSize;
+  double objective = 0;
+
+  #pragma omp parallel num_threads(numThreads) reduction(+:objective)
+  {
+    size_t threadId = 0;
+    #ifdef HAS_OPENMP
+      threadId = omp_get_thread_num();
+    #endif
+    DenseFunctionType& threadFunction = ThreadFunction(function, copies,
+        threadId);
+
+    #pragma omp for
+    for (omp_size_t j = 0; j < (omp_size_t) numBlocks; ++j)
+    {
+      const size_t begin = j * batchSize;
+      objective += threadFunction.Evaluate(iterate, begin,
+          std::min(batchSize, numFunctions - begin));
+    }
+  }
+
+  return objective;
+}
+
 } // namespace optimization
 } // namespace mlpack
 
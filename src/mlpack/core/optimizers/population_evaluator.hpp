@@ -0,0 +1,131 @@
+/**
+ * @file population_evaluator.hpp
+ *
+ * A utility for the population-based optimizers (like CNE and CMAES) to
+ * evaluate all the candidates of a generation in parallel.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_OPTIMIZERS_POPULATION_EVALUATOR_HPP
+#define MLPACK_CORE_OPTIMIZERS_POPULATION_EVALUATOR_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/optimizers/evaluate_with_gradient.hpp>
+
+#ifdef HAS_OPENMP
+  #include <omp.h>
+#endif
+
+namespace mlpack {
+namespace optimization {
+
+/**
+ * Evaluate all the candidates of a population with the OpenMP threads.
+ *
+ * A function whose Evaluate() is const (see HasConstEvaluate) is assumed to
+ * be thread-safe, and all the threads share it.  Otherwise (like FFN, which
+ * runs the candidates through its own layers), the function must be copyable
+ * and must evaluate the parameters it is given; each thread then gets a copy
+ * of its own, which is made at the first evaluation and kept for the following
+ * generations, and the function itself is left untouched (unless there is only
+ * one thread).
+ *
+ * @tparam FunctionType Type of the function to evaluate.
+ */
+template<typename FunctionType>
+class PopulationEvaluator
+{
+ public:
+  /**
+   * Create the evaluator for the given function.
+   *
+   * @param function Function to evaluate.
+   */
+  PopulationEvaluator(FunctionType& function) : function(function)
+  { /* Nothing to do here. */ }
+
+  //! Delete the copies of the function.
+  ~PopulationEvaluator()
+  {
+    for (size_t i = 0; i < copies.size(); ++i)
+      delete copies[i];
+  }
+
+  /**
+   * Evaluate the candidates of the population in parallel.  The evaluation of
+   * each candidate is given by evaluate(function, i), where function is the
+   * function (or copy) to use for candidate i; it is called by several threads
+   * at once.
+   *
+   * @param populationSize Number of candidates.
+   * @param objectives Vector to store the objective of each candidate in.
+   * @param evaluate Evaluation of a candidate.
+   */
+  template<typename EvaluateType>
+  void Evaluate(const size_t populationSize,
+                arma::vec& objectives,
+                EvaluateType evaluate)
+  {
+    objectives.set_size(populationSize);
+
+    #ifdef HAS_OPENMP
+      const size_t numThreads = std::min((size_t) omp_get_max_threads(),
+          populationSize);
+      if (numThreads > 1)
+      {
+        Copy(numThreads);
+
+        #pragma omp parallel num_threads(numThreads)
+        {
+          FunctionType& threadFunction = ThreadFunction(omp_get_thread_num());
+
+          // The candidates may take very different times to evaluate.
+          #pragma omp for schedule(dynamic)
+          for (omp_size_t i = 0; i < (omp_size_t) populationSize; ++i)
+            objectives[i] = evaluate(threadFunction, i);
+        }
+
+        return;
+      }
+    #endif
+
+    // With a single thread, the function itself is used.
+    for (size_t i = 0; i < populationSize; ++i)
+      objectives[i] = evaluate(function, i);
+  }
+
+ private:
+  //! Functions with a const Evaluate() are shared, so nothing is copied.
+  template<typename F = FunctionType>
+  typename std::enable_if<HasConstEvaluate<F>::value, void>::type
+  Copy(const size_t /* numThreads */) { }
+
+  //! Make sure that there is a copy of the function for each thread.
+  template<typename F = FunctionType>
+  typename std::enable_if<!HasConstEvaluate<F>::value, void>::type
+  Copy(const size_t numThreads)
+  {
+    while (copies.size() < numThreads)
+      copies.push_back(new FunctionType(function));
+  }
+
+  //! Get the function to be used by the given thread.
+  FunctionType& ThreadFunction(const size_t threadId)
+  {
+    return copies.empty() ? function : *copies[threadId];
+  }
+
+  //! The function to evaluate.
+  FunctionType& function;
+
+  //! The copies of the function used by each thread.
+  std::vector<FunctionType*> copies;
+};
+
+} // namespace optimization
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,95 @@
+/**
+ * @file random_search.hpp
+ *
+ * Random-search optimization.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_OPTIMIZERS_RANDOM_SEARCH_RANDOM_SEARCH_HPP
+#define MLPACK_CORE_OPTIMIZERS_RANDOM_SEARCH_RANDOM_SEARCH_HPP
+
+#include <mlpack/core.hpp>
+#include <mlpack/core/optimizers/population_evaluator.hpp>
+
+namespace mlpack {
+namespace optimization {
+
+/**
+ * An optimizer that finds the minimum of a given function by evaluating it at
+ * randomly chosen points of a multidimensional grid.  This is used like
+ * GridSearch, but only a given number of distinct points of the grid are
+ * evaluated, which can be much less than the whole grid when there are many
+ * parameters.
+ *
+ * For RandomSearch to work, a FunctionType template parameter is required.
+ * This class must implement the following function:
+ *
+ *   double Evaluate(const arma::mat& coordinates);
+ *
+ * The points are drawn with math::RandInt() before any of them is evaluated.
+ * If Evaluate() is const (see HasConstEvaluate), the function is assumed to be
+ * thread-safe, and the points are evaluated in parallel with OpenMP; otherwise
+ * they are evaluated one after the other.  In both cases, when several points
+ * have the best objective, the first one drawn is returned.
+ *
+ * For more information, see the following.
+ *
+ * @code
+ * @article{bergstra2012random,
+ *   title   = {Random Search for Hyper-Parameter Optimization},
+ *   author  = {Bergstra, James and Bengio, Yoshua},
+ *   journal = {Journal of Machine Learning Research},
+ *   volume  = {13},
+ *   pages   = {281--305},
+ *   year    = {2012}
+ * }
+ * @endcode
+ */
+class RandomSearch
+{
+ public:
+  /**
+   * Create the RandomSearch optimizer.
+   *
+   * @param numPoints Number of distinct points of the grid to evaluate.  If
+   *     the grid has fewer points, all of them are evaluated.
+   */
+  RandomSearch(const size_t numPoints = 100) : numPoints(numPoints)
+  { /* Nothing to do. */ }
+
+  /**
+   * Optimize (minimize) the given function by evaluating it at random
+   * combinations of values for the parameters specified in datasetInfo.
+   *
+   * @param function Function to optimize.
+   * @param bestParameters Variable for storing results.
+   * @param datasetInfo Type information for each dimension of the dataset. It
+   *     should store possible values for each parameter.
+   * @return Objective value of the final point.
+   */
+  template<typename FunctionType>
+  double Optimize(
+      FunctionType& function,
+      arma::mat& bestParameters,
+      data::DatasetMapper<data::IncrementPolicy, double>& datasetInfo);
+
+  //! Get the number of points to evaluate.
+  size_t NumPoints() const { return numPoints; }
+  //! Modify the number of points to evaluate.
+  size_t& NumPoints() { return numPoints; }
+
+ private:
+  //! The number of points to evaluate.
+  size_t numPoints;
+};
+
+} // namespace optimization
+} // namespace mlpack
+
+// Include implementation
+#include "random_search_impl.hpp"
+
+#endif
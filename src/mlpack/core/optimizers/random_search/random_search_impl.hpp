@@ -0,0 +1,97 @@
+/**
+ * @file random_search_impl.hpp
+ *
+ * Implementation of the random-search optimization.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_OPTIMIZERS_RANDOM_SEARCH_RANDOM_SEARCH_IMPL_HPP
+#define MLPACK_CORE_OPTIMIZERS_RANDOM_SEARCH_RANDOM_SEARCH_IMPL_HPP
+
+#include <limits>
+#include <set>
+
+namespace mlpack {
+namespace optimization {
+
+template<typename FunctionType>
+double RandomSearch::Optimize(
+    FunctionType& function,
+    arma::mat& bestParameters,
+    data::DatasetMapper<data::IncrementPolicy, double>& datasetInfo)
+{
+  const size_t dimensionality = datasetInfo.Dimensionality();
+  for (size_t i = 0; i < dimensionality; ++i)
+  {
+    if (datasetInfo.Type(i) != data::Datatype::categorical)
+    {
+      std::ostringstream oss;
+      oss << "RandomSearch::Optimize(): the dimension " << i
+          << " is not categorical" << std::endl;
+      throw std::invalid_argument(oss.str());
+    }
+  }
+
+  // The number of points on the grid may not fit in a size_t.
+  double gridSize = 1.0;
+  for (size_t i = 0; i < dimensionality; ++i)
+    gridSize *= datasetInfo.NumMappings(i);
+
+  // Draw all the points first, so that they do not depend on the order in
+  // which they are evaluated.  A point that was already drawn is replaced by
+  // another one.
+  const size_t numDrawn = (numPoints < gridSize) ? numPoints :
+      (size_t) gridSize;
+  arma::mat points(dimensionality, numDrawn);
+  std::set<std::vector<size_t>> drawn;
+  std::vector<size_t> indices(dimensionality);
+  for (size_t p = 0; p < numDrawn; )
+  {
+    for (size_t i = 0; i < dimensionality; ++i)
+      indices[i] = math::RandInt((int) datasetInfo.NumMappings(i));
+
+    if (!drawn.insert(indices).second)
+      continue;
+
+    for (size_t i = 0; i < dimensionality; ++i)
+      points(i, p) = datasetInfo.UnmapString(indices[i], i);
+    ++p;
+  }
+
+  // A function whose Evaluate() is not const may not be thread-safe, so it is
+  // evaluated by a single thread.
+  arma::vec objectives(numDrawn);
+  #pragma omp parallel for schedule(dynamic) \
+      if (HasConstEvaluate<FunctionType>::value)
+  for (omp_size_t p = 0; p < (omp_size_t) numDrawn; ++p)
+  {
+    const arma::vec currentParameters = points.col(p);
+    objectives[p] = function.Evaluate(currentParameters);
+  }
+
+  // The first of the best points is kept, as if the points had been evaluated
+  // in order.
+  double bestObjective = std::numeric_limits<double>::max();
+  size_t bestPoint = 0;
+  for (size_t p = 0; p < numDrawn; ++p)
+  {
+    if (objectives[p] < bestObjective)
+    {
+      bestObjective = objectives[p];
+      bestPoint = p;
+    }
+  }
+
+  if (numDrawn > 0)
+    bestParameters = points.col(bestPoint);
+
+  return bestObjective;
+}
+
+} // namespace optimization
+} // namespace mlpack
+
+#endif
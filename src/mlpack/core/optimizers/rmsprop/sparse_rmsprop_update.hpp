@@ -0,0 +1,187 @@
+/**
+ * @file sparse_rmsprop_update.hpp
+ *
+ * RMSProp update for Stochastic Gradient Descent with sparse gradients.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_OPTIMIZERS_RMSPROP_SPARSE_RMSPROP_UPDATE_HPP
+#define MLPACK_CORE_OPTIMIZERS_RMSPROP_SPARSE_RMSPROP_UPDATE_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace optimization {
+
+/**
+ * The RMSProp update policy (see RMSPropUpdate) for functions with a sparse
+ * gradient.  When the function gives the gradient of its batches as a sparse
+ * matrix (like LogisticRegressionFunction; see HasSparseGradient), SGD passes
+ * it to this policy as is, and only the coordinates with a nonzero gradient are
+ * updated.  The decay of the mean squared gradient of a coordinate during the
+ * steps where its gradient was zero is applied in closed form when the
+ * coordinate is next updated; since RMSProp does not move the coordinates with
+ * a zero gradient, the steps are the same as the ones of RMSPropUpdate.
+ */
+class SparseRMSPropUpdate
+{
+ public:
+  /**
+   * Construct the sparse RMSProp update policy with the given parameters.
+   *
+   * @param epsilon The epsilon value used to initialise the squared gradient
+   *        parameter.
+   * @param alpha The smoothing parameter.
+   */
+  SparseRMSPropUpdate(const double epsilon = 1e-8,
+                      const double alpha = 0.99) :
+    epsilon(epsilon),
+    alpha(alpha),
+    iteration(0),
+    denseIteration(0),
+    deferred(false)
+  {
+    // Nothing to do.
+  }
+
+  /**
+   * The Initialize method is called by SGD Optimizer method before the start of
+   * the iteration update process.
+   *
+   * @param rows Number of rows in the gradient matrix.
+   * @param cols Number of columns in the gradient matrix.
+   */
+  void Initialize(const size_t rows, const size_t cols)
+  {
+    // Leaky sum of squares of parameter gradient.
+    meanSquaredGradient = arma::zeros<arma::mat>(rows, cols);
+    lastIteration = arma::zeros<arma::Mat<size_t>>(rows, cols);
+    iteration = 0;
+    denseIteration = 0;
+    deferred = false;
+  }
+
+  /**
+   * Update step for RMSProp with a dense gradient (see RMSPropUpdate).
+   *
+   * @param iterate Parameters that minimize the function.
+   * @param stepSize Step size to be used for the given iteration.
+   * @param gradient The gradient matrix.
+   */
+  void Update(arma::mat& iterate,
+              const double stepSize,
+              const arma::mat& gradient)
+  {
+    ++iteration;
+
+    // The decay that was deferred by the sparse updates has to be applied
+    // first.
+    if (deferred)
+    {
+      for (size_t i = 0; i < meanSquaredGradient.n_elem; ++i)
+        meanSquaredGradient[i] *= Decay(i);
+      deferred = false;
+    }
+
+    denseIteration = iteration;
+
+    meanSquaredGradient *= alpha;
+    meanSquaredGradient += (1 - alpha) * (gradient % gradient);
+    iterate -= stepSize * gradient / (arma::sqrt(meanSquaredGradient) +
+        epsilon);
+  }
+
+  /**
+   * Update step for RMSProp with a sparse gradient: only the coordinates with a
+   * nonzero gradient are visited.
+   *
+   * @param iterate Parameters that minimize the function.
+   * @param stepSize Step size to be used for the given iteration.
+   * @param gradient The sparse gradient matrix.
+   */
+  void Update(arma::mat& iterate,
+              const double stepSize,
+              const arma::sp_mat& gradient)
+  {
+    ++iteration;
+    deferred = true;
+
+    for (arma::sp_mat::const_iterator it = gradient.begin();
+        it != gradient.end(); ++it)
+    {
+      const size_t i = it.row() + it.col() * iterate.n_rows;
+
+      // The decay of the skipped steps and of this step.
+      meanSquaredGradient[i] *= alpha * Decay(i);
+      meanSquaredGradient[i] += (1 - alpha) * (*it) * (*it);
+      iterate[i] -= stepSize * (*it) / (std::sqrt(meanSquaredGradient[i]) +
+          epsilon);
+      lastIteration[i] = iteration;
+    }
+  }
+
+  //! Get the value used to initialise the squared gradient parameter.
+  double Epsilon() const { return epsilon; }
+  //! Modify the value used to initialise the squared gradient parameter.
+  double& Epsilon() { return epsilon; }
+
+  //! Get the smoothing parameter.
+  double Alpha() const { return alpha; }
+  //! Modify the smoothing parameter.
+  double& Alpha() { return alpha; }
+
+  /**
+   * Serialize the update policy (for checkpoints of the optimization).
+   */
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */)
+  {
+    ar & BOOST_SERIALIZATION_NVP(epsilon);
+    ar & BOOST_SERIALIZATION_NVP(alpha);
+    ar & BOOST_SERIALIZATION_NVP(meanSquaredGradient);
+    ar & BOOST_SERIALIZATION_NVP(lastIteration);
+    ar & BOOST_SERIALIZATION_NVP(iteration);
+    ar & BOOST_SERIALIZATION_NVP(denseIteration);
+    ar & BOOST_SERIALIZATION_NVP(deferred);
+  }
+
+ private:
+  /**
+   * Get the decay of the mean squared gradient of the given coordinate for the
+   * steps before the current one since it was last updated.
+   */
+  double Decay(const size_t i) const
+  {
+    const size_t last = std::max(lastIteration[i], denseIteration);
+    return std::pow(alpha, (double) (iteration - 1 - last));
+  }
+
+  // The epsilon value used to initialise the squared gradient parameter.
+  double epsilon;
+
+  // The smoothing parameter.
+  double alpha;
+
+  // Leaky sum of squares of parameter gradient.
+  arma::mat meanSquaredGradient;
+
+  // The last sparse step where each coordinate was updated.
+  arma::Mat<size_t> lastIteration;
+
+  // The number of steps.
+  size_t iteration;
+
+  // The last dense step, where all the coordinates were updated.
+  size_t denseIteration;
+
+  // Whether the sparse updates deferred the decay of some coordinates.
+  bool deferred;
+};
+
+} // namespace optimization
+} // namespace mlpack
+
+#endif
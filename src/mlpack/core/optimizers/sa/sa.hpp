@@ -13,6 +13,7 @@
 #define MLPACK_CORE_OPTIMIZERS_SA_SA_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/core/math/random.hpp>
 
 #include "exponential_schedule.hpp"
 
@@ -41,6 +42,18 @@ namespace optimization {
  * The system is considered "frozen" when its score fails to change more then
  * tolerance for maxToleranceSweep consecutive sweeps.
  *
+ * With numChains > 1, SA runs parallel tempering: numChains chains start from
+ * the same point at the temperatures initT, initT * temperatureRatio,
+ * initT * temperatureRatio^2, ..., each with its own copy of the cooling
+ * schedule, its own move sizes and its own random stream.  The chains run in
+ * parallel (with OpenMP) for exchangeInterval moves at a time; then the states
+ * of neighboring chains are exchanged with the replica-exchange Metropolis
+ * probability min{1, exp((E_i - E_j) (1 / T_i - 1 / T_j))}, so that the cold
+ * chain can leave local minima found by the hot ones.  The search stops when
+ * the coldest chain is frozen or has made maxIterations cooling moves, and the
+ * best point seen by any chain is returned.  The function's Evaluate() is then
+ * called concurrently on different points, so it must be thread-safe.
+ *
  * For SA to work, the FunctionType template class, used by the Optimize()
  * method, must implement the following two methods:
  *
@@ -76,6 +89,12 @@ class SA
    * @param maxMoveCoef Maximum move size.
    * @param initMoveCoef Initial move size.
    * @param gain Proportional control in feedback move control.
+   * @param numChains Number of chains of parallel tempering (1 runs a single
+   *    chain).
+   * @param exchangeInterval Moves of each chain between two exchanges of
+   *    states.
+   * @param temperatureRatio Ratio between the temperatures of neighboring
+   *    chains.
    */
   SA(CoolingScheduleType& coolingSchedule,
      const size_t maxIterations = 1000000,
@@ -86,7 +105,10 @@ class SA
      const size_t maxToleranceSweep = 3,
      const double maxMoveCoef = 20,
      const double initMoveCoef = 0.3,
-     const double gain = 0.3);
+     const double gain = 0.3,
+     const size_t numChains = 1,
+     const size_t exchangeInterval = 1000,
+     const double temperatureRatio = 2.0);
 
   /**
    * Optimize the given function using simulated annealing. The given starting
@@ -136,6 +158,21 @@ class SA
   //! Modify the maximum number of iterations.
   size_t& MaxIterations() { return maxIterations; }
 
+  //! Get the number of chains of parallel tempering.
+  size_t NumChains() const { return numChains; }
+  //! Modify the number of chains of parallel tempering.
+  size_t& NumChains() { return numChains; }
+
+  //! Get the number of moves of each chain between exchanges.
+  size_t ExchangeInterval() const { return exchangeInterval; }
+  //! Modify the number of moves of each chain between exchanges.
+  size_t& ExchangeInterval() { return exchangeInterval; }
+
+  //! Get the ratio between the temperatures of neighboring chains.
+  double TemperatureRatio() const { return temperatureRatio; }
+  //! Modify the ratio between the temperatures of neighboring chains.
+  double& TemperatureRatio() { return temperatureRatio; }
+
  private:
   //! The cooling schedule being used.
   CoolingScheduleType& coolingSchedule;
@@ -157,6 +194,49 @@ class SA
   double initMoveCoef;
   //! Proportional control in feedback move control.
   double gain;
+  //! The number of chains of parallel tempering.
+  size_t numChains;
+  //! The number of moves of each chain between exchanges.
+  size_t exchangeInterval;
+  //! The ratio between the temperatures of neighboring chains.
+  double temperatureRatio;
+
+  //! The state of one chain of parallel tempering.
+  struct Chain
+  {
+    Chain(const CoolingScheduleType& coolingSchedule) :
+        coolingSchedule(coolingSchedule) { }
+
+    //! The current point of the chain.
+    arma::mat iterate;
+    //! The objective value of the current point.
+    double energy;
+    //! The temperature of the chain.
+    double temperature;
+    //! The cooling schedule of the chain.
+    CoolingScheduleType coolingSchedule;
+    //! The accepted moves of each parameter since the last move control.
+    arma::mat accept;
+    //! The move size of each parameter.
+    arma::mat moveSize;
+    //! The parameter to move next.
+    size_t idx;
+    //! The sweeps since the last move control.
+    size_t sweepCounter;
+    //! The moves made so far, including the initial moves.
+    size_t moves;
+    //! The consecutive moves that changed the energy less than the tolerance.
+    size_t frozenCount;
+    //! The random stream of the chain.
+    math::Philox generator;
+  };
+
+  /**
+   * Run parallel tempering with numChains chains (see the class
+   * documentation).
+   */
+  template<typename FunctionType>
+  double OptimizeChains(FunctionType& function, arma::mat& iterate);
 
   /**
    * GenerateMove proposes a move on element iterate(idx), and determines if
@@ -166,6 +246,9 @@ class SA
    * resets idx and increments sweepCounter. When sweepCounter reaches
    * moveCtrlSweep, it performs MoveControl() and resets sweepCounter.
    *
+   * @param function Function to optimize.
+   * @param currentTemperature Temperature of the Metropolis criterion.
+   * @param generator Random generator to draw the move from.
    * @param iterate Current optimization position.
    * @param accept Matrix representing which parameters have had accepted moves.
    * @param moveSize Strides for a move.
@@ -176,6 +259,8 @@ class SA
    */
   template<typename FunctionType>
   void GenerateMove(FunctionType& function,
+                    const double currentTemperature,
+                    math::Philox& generator,
                     arma::mat& iterate,
                     arma::mat& accept,
                     arma::mat& moveSize,
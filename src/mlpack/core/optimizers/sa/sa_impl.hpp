@@ -28,7 +28,10 @@ SA<CoolingScheduleType>::SA(
     const size_t maxToleranceSweep,
     const double maxMoveCoef,
     const double initMoveCoef,
-    const double gain) :
+    const double gain,
+    const size_t numChains,
+    const size_t exchangeInterval,
+    const double temperatureRatio) :
     coolingSchedule(coolingSchedule),
     maxIterations(maxIterations),
     temperature(initT),
@@ -38,7 +41,10 @@ SA<CoolingScheduleType>::SA(
     maxToleranceSweep(maxToleranceSweep),
     maxMoveCoef(maxMoveCoef),
     initMoveCoef(initMoveCoef),
-    gain(gain)
+    gain(gain),
+    numChains(numChains),
+    exchangeInterval(exchangeInterval),
+    temperatureRatio(temperatureRatio)
 {
   // Nothing to do.
 }
@@ -49,6 +55,9 @@ template<typename FunctionType>
 double SA<CoolingScheduleType>::Optimize(FunctionType& function,
                                          arma::mat& iterate)
 {
+  if (numChains > 1)
+    return OptimizeChains(function, iterate);
+
   const size_t rows = iterate.n_rows;
   const size_t cols = iterate.n_cols;
 
@@ -65,15 +74,15 @@ double SA<CoolingScheduleType>::Optimize(FunctionType& function,
 
   // Initial moves to get rid of dependency of initial states.
   for (size_t i = 0; i < initMoves; ++i)
-    GenerateMove(function, iterate, accept, moveSize, energy, idx,
-        sweepCounter);
+    GenerateMove(function, temperature, math::ThreadRandom().generator,
+        iterate, accept, moveSize, energy, idx, sweepCounter);
 
   // Iterating and cooling.
   for (size_t i = 0; i != maxIterations; ++i)
   {
     oldEnergy = energy;
-    GenerateMove(function, iterate, accept, moveSize, energy, idx,
-        sweepCounter);
+    GenerateMove(function, temperature, math::ThreadRandom().generator,
+        iterate, accept, moveSize, energy, idx, sweepCounter);
     temperature = coolingSchedule.NextTemperature(temperature, energy);
 
     // Determine if the optimization has entered (or continues to be in) a
@@ -98,6 +107,127 @@ double SA<CoolingScheduleType>::Optimize(FunctionType& function,
   return energy;
 }
 
+//! Optimize the function (minimize) with parallel tempering.
+template<typename CoolingScheduleType>
+template<typename FunctionType>
+double SA<CoolingScheduleType>::OptimizeChains(FunctionType& function,
+                                               arma::mat& iterate)
+{
+  if (exchangeInterval == 0)
+  {
+    throw std::invalid_argument("SA::Optimize(): exchangeInterval must be "
+        "positive");
+  }
+
+  // Each call draws new streams for the chains, so the chains do not depend on
+  // the threads they run on.
+  const uint64_t firstStream =
+      (uint64_t) math::ThreadRandom().generator() << 16;
+
+  const double initialEnergy = function.Evaluate(iterate);
+  std::vector<Chain> chains(numChains, Chain(coolingSchedule));
+  for (size_t c = 0; c < numChains; ++c)
+  {
+    Chain& chain = chains[c];
+    chain.iterate = iterate;
+    chain.energy = initialEnergy;
+    chain.temperature = temperature * std::pow(temperatureRatio, (double) c);
+    chain.accept.zeros(iterate.n_rows, iterate.n_cols);
+    chain.moveSize.set_size(iterate.n_rows, iterate.n_cols);
+    chain.moveSize.fill(initMoveCoef);
+    chain.idx = 0;
+    chain.sweepCounter = 0;
+    chain.moves = 0;
+    chain.frozenCount = 0;
+    chain.generator = math::RandomStream(firstStream + c);
+  }
+
+  arma::mat bestIterate = iterate;
+  double bestEnergy = initialEnergy;
+
+  const size_t frozenMoves = maxToleranceSweep * moveCtrlSweep *
+      iterate.n_elem;
+  const size_t totalMoves = (maxIterations == 0) ? size_t(-1) :
+      initMoves + maxIterations;
+
+  size_t round = 0;
+  while (chains[0].moves < totalMoves && chains[0].frozenCount < frozenMoves)
+  {
+    // The chains are independent until the exchange.
+    #pragma omp parallel for schedule(dynamic)
+    for (omp_size_t c = 0; c < (omp_size_t) numChains; ++c)
+    {
+      Chain& chain = chains[c];
+      for (size_t m = 0; m < exchangeInterval && chain.moves < totalMoves &&
+          chain.frozenCount < frozenMoves; ++m)
+      {
+        const double oldEnergy = chain.energy;
+        GenerateMove(function, chain.temperature, chain.generator,
+            chain.iterate, chain.accept, chain.moveSize, chain.energy,
+            chain.idx, chain.sweepCounter);
+
+        // The temperature is kept for the initial moves.
+        if (chain.moves++ < initMoves)
+          continue;
+
+        chain.temperature = chain.coolingSchedule.NextTemperature(
+            chain.temperature, chain.energy);
+        if (std::abs(chain.energy - oldEnergy) < tolerance)
+          ++chain.frozenCount;
+        else
+          chain.frozenCount = 0;
+      }
+    }
+
+    for (size_t c = 0; c < numChains; ++c)
+    {
+      if (chains[c].energy < bestEnergy)
+      {
+        bestEnergy = chains[c].energy;
+        bestIterate = chains[c].iterate;
+      }
+    }
+
+    // Propose exchanges between the pairs (0, 1), (2, 3), ... and
+    // (1, 2), (3, 4), ... in alternate rounds.  The move sizes stay with the
+    // chains, since they are tuned to the temperatures.
+    for (size_t c = round % 2; c + 1 < numChains; c += 2)
+    {
+      Chain& cold = chains[c];
+      Chain& hot = chains[c + 1];
+      const double exponent = (cold.energy - hot.energy) *
+          (1.0 / cold.temperature - 1.0 / hot.temperature);
+      if (exponent >= 0.0 || math::Random() < std::exp(exponent))
+      {
+        cold.iterate.swap(hot.iterate);
+        std::swap(cold.energy, hot.energy);
+        cold.frozenCount = 0;
+        hot.frozenCount = 0;
+      }
+    }
+
+    ++round;
+  }
+
+  temperature = chains[0].temperature;
+  if (chains[0].frozenCount >= frozenMoves)
+  {
+    Log::Debug << "SA: coldest of " << numChains << " chains minimized within "
+        << "tolerance " << tolerance << " for " << maxToleranceSweep
+        << " sweeps after " << round << " exchange rounds; terminating "
+        << "optimization." << std::endl;
+  }
+  else
+  {
+    Log::Debug << "SA: maximum iterations (" << maxIterations << ") reached "
+        << "by the coldest of " << numChains << " chains; terminating "
+        << "optimization." << std::endl;
+  }
+
+  iterate = std::move(bestIterate);
+  return bestEnergy;
+}
+
 /**
  * GenerateMove proposes a move on element iterate(idx), and determines
  * it that move is acceptable or not according to the Metropolis criterion.
@@ -110,6 +240,8 @@ template<typename CoolingScheduleType>
 template<typename FunctionType>
 void SA<CoolingScheduleType>::GenerateMove(
     FunctionType& function,
+    const double currentTemperature,
+    math::Philox& generator,
     arma::mat& iterate,
     arma::mat& accept,
     arma::mat& moveSize,
@@ -125,7 +257,7 @@ void SA<CoolingScheduleType>::GenerateMove(
   // MoveControl() is derived for the Laplace distribution.
 
   // Sample from a Laplace distribution with scale parameter moveSize(idx).
-  const double unif = 2.0 * math::Random() - 1.0;
+  const double unif = 2.0 * math::Random(generator) - 1.0;
   const double move = (unif < 0) ? (moveSize(idx) * std::log(1 + unif)) :
       (-moveSize(idx) * std::log(1 - unif));
 
@@ -133,9 +265,9 @@ void SA<CoolingScheduleType>::GenerateMove(
   energy = function.Evaluate(iterate);
   // According to the Metropolis criterion, accept the move with probability
   // min{1, exp(-(E_new - E_old) / T)}.
-  const double xi = math::Random();
+  const double xi = math::Random(generator);
   const double delta = energy - prevEnergy;
-  const double criterion = std::exp(-delta / temperature);
+  const double criterion = std::exp(-delta / currentTemperature);
   if (delta <= 0. || criterion > xi)
   {
     accept(idx) += 1.;
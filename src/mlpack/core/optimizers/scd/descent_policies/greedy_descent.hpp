@@ -21,7 +21,10 @@ namespace optimization {
  * Greedy descent policy for Stochastic Co-ordinate Descent(SCD). This
  * descent scheme picks a the co-ordinate for the descent with the maximum
  * guaranteed descent, according to the Gauss-Southwell rule. This is a
- * deterministic approach and is generally more expensive to calculate.
+ * deterministic approach and is generally more expensive to calculate; the
+ * partial gradients of the features are calculated in parallel with OpenMP,
+ * so the function's PartialGradient() must be safe to call from several
+ * threads at once (as it is for all const functions in mlpack).
  *
  * For more information, refer to the following.
  * @code
@@ -56,17 +59,37 @@ class GreedyDescent
   {
     size_t bestFeature = 0;
     double bestDescent = 0;
-    for (size_t i = 0; i < function.NumFeatures(); ++i)
+
+    // Each thread finds the best feature of its share, and the first of the
+    // best features wins, as in a serial search.
+    #pragma omp parallel
     {
+      size_t threadBestFeature = 0;
+      double threadBestDescent = 0;
       arma::sp_mat fGrad;
 
-      function.PartialGradient(iterate, i, fGrad);
+      #pragma omp for schedule(static) nowait
+      for (omp_size_t i = 0; i < (omp_size_t) function.NumFeatures(); ++i)
+      {
+        function.PartialGradient(iterate, i, fGrad);
+
+        double descent = arma::accu(fGrad);
+        if (descent > threadBestDescent)
+        {
+          threadBestFeature = i;
+          threadBestDescent = descent;
+        }
+      }
 
-      double descent = arma::accu(fGrad);
-      if (descent > bestDescent)
+      #pragma omp critical
       {
-        bestFeature = i;
-        bestDescent = descent;
+        if (threadBestDescent > bestDescent ||
+            (threadBestDescent == bestDescent &&
+            threadBestFeature < bestFeature))
+        {
+          bestFeature = threadBestFeature;
+          bestDescent = threadBestDescent;
+        }
       }
     }
 
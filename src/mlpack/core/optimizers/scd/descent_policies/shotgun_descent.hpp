@@ -0,0 +1,165 @@
+/**
+ * @file shotgun_descent.hpp
+ *
+ * Shotgun descent policy for Stochastic Coordinate Descent (SCD).
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_OPTIMIZERS_SCD_DESCENT_POLICIES_SHOTGUN_HPP
+#define MLPACK_CORE_OPTIMIZERS_SCD_DESCENT_POLICIES_SHOTGUN_HPP
+
+#include <mlpack/core.hpp>
+
+#ifdef HAS_OPENMP
+  #include <omp.h>
+#endif
+
+namespace mlpack {
+namespace optimization {
+
+/**
+ * Shotgun descent policy for Stochastic Co-ordinate Descent(SCD).  Instead of
+ * a single co-ordinate, this descent scheme picks several distinct
+ * co-ordinates uniformly at random for each descent; SCD calculates their
+ * partial gradients at the same point in parallel with OpenMP, and then
+ * updates all of them.  So, the function's PartialGradient() must be safe to
+ * call from several threads at once (as it is for all const functions in
+ * mlpack).
+ *
+ * Updating too many co-ordinates at once can make the descent diverge when the
+ * features are correlated.  For the squared and logistic losses, Bradley et
+ * al. show that up to P = d / rho co-ordinates can be updated at once without
+ * slowing down the convergence, where d is the number of features and rho is
+ * the spectral radius of the Gram matrix of the (normalized) features; this
+ * number can be estimated from the data with MaxParallelUpdates().
+ *
+ * For more information, see the following.
+ * @code
+ * @inproceedings{Bradley2011,
+ *   author    = {Bradley, Joseph K. and Kyrola, Aapo and Bickson, Danny and
+ *                Guestrin, Carlos},
+ *   title     = {Parallel Coordinate Descent for L1-Regularized Loss
+ *                Minimization},
+ *   booktitle = {Proceedings of the 28th International Conference on Machine
+ *                Learning},
+ *   series    = {ICML '11},
+ *   year      = {2011}
+ * }
+ * @endcode
+ */
+class ShotgunDescent
+{
+ public:
+  /**
+   * Construct the shotgun descent policy.
+   *
+   * @param numParallelUpdates The number of co-ordinates to update at once (0
+   *     means one for each OpenMP thread).
+   */
+  ShotgunDescent(const size_t numParallelUpdates = 0) :
+      numParallelUpdates(numParallelUpdates)
+  {
+    // Nothing to do.
+  }
+
+  /**
+   * The DescentFeatures method is used to get the descent coordinates for the
+   * current iteration.
+   *
+   * @tparam ResolvableFunctionType The type of the function to be optimized.
+   * @param iteration The iteration number for which the features are to be
+   *    obtained.
+   * @param iterate The current value of the decision variable.
+   * @param function The function to be optimized.
+   * @param features Vector to store the indices of the coordinates to be
+   *    descended in.
+   */
+  template <typename ResolvableFunctionType>
+  void DescentFeatures(const size_t /* iteration */,
+                       const arma::mat& /* iterate */,
+                       const ResolvableFunctionType& function,
+                       arma::uvec& features)
+  {
+    const size_t numFeatures = function.NumFeatures();
+    if (permutation.n_elem != numFeatures)
+      permutation = arma::linspace<arma::uvec>(0, numFeatures - 1, numFeatures);
+
+    size_t numUpdates = numParallelUpdates;
+    #ifdef HAS_OPENMP
+      if (numUpdates == 0)
+        numUpdates = omp_get_max_threads();
+    #endif
+    numUpdates = std::min(std::max(numUpdates, (size_t) 1), numFeatures);
+
+    // Draw distinct features with a partial Fisher-Yates shuffle.
+    for (size_t i = 0; i < numUpdates; ++i)
+    {
+      const size_t j = math::RandInt(i, numFeatures);
+      std::swap(permutation[i], permutation[j]);
+    }
+
+    features = permutation.head(numUpdates);
+  }
+
+  /**
+   * Estimate the number of co-ordinates that can be updated at once for the
+   * given data, d / rho (see Bradley et al.).  The spectral radius rho of the
+   * Gram matrix of the normalized features is found with the power method.
+   *
+   * @tparam MatType Type of the data matrix.
+   * @param data Data matrix, with one point in each column (so that each
+   *     feature is a row).
+   * @param maxIterations Maximum number of iterations of the power method.
+   * @return The number of co-ordinates to update at once (at least 1).
+   */
+  template<typename MatType>
+  static size_t MaxParallelUpdates(const MatType& data,
+                                   const size_t maxIterations = 100)
+  {
+    // Normalize the features, without changing their zeros.
+    arma::vec norms = arma::sqrt(arma::vec(arma::sum(arma::square(data), 1)));
+    norms.elem(arma::find(norms == 0)).ones();
+    const arma::vec scales = 1.0 / norms;
+
+    arma::vec v = arma::ones<arma::vec>(data.n_rows) / std::sqrt(
+        (double) data.n_rows);
+    double rho = 0.0;
+    for (size_t i = 0; i < maxIterations; ++i)
+    {
+      // Multiply with the Gram matrix without forming it.
+      const arma::rowvec projection = (v % scales).t() * data;
+      arma::vec w = (data * projection.t()) % scales;
+
+      const double lastRho = rho;
+      rho = arma::norm(w);
+      if (rho == 0.0)
+        return data.n_rows;
+
+      v = w / rho;
+      if (std::abs(rho - lastRho) < 1e-6 * rho)
+        break;
+    }
+
+    return std::max((size_t) (data.n_rows / rho), (size_t) 1);
+  }
+
+  //! Get the number of co-ordinates to update at once.
+  size_t NumParallelUpdates() const { return numParallelUpdates; }
+  //! Modify the number of co-ordinates to update at once.
+  size_t& NumParallelUpdates() { return numParallelUpdates; }
+
+ private:
+  //! The number of co-ordinates to update at once.
+  size_t numParallelUpdates;
+
+  //! The permutation of the features the co-ordinates are drawn from.
+  arma::uvec permutation;
+};
+
+} // namespace optimization
+} // namespace mlpack
+
+#endif
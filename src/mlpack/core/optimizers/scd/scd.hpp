@@ -18,6 +18,28 @@
 namespace mlpack {
 namespace optimization {
 
+// This gives us a HasDescentFeaturesCheck<T, U> type (where U is a function
+// pointer) we can use with SFINAE to catch when a descent policy has a
+// DescentFeatures(...) function.
+HAS_MEM_FUNC(DescentFeatures, HasDescentFeaturesCheck);
+
+/**
+ * Whether the given descent policy picks several coordinates for each descent
+ * of the given function type, with a method
+ * void DescentFeatures(const size_t iteration,
+ *                      const arma::mat& iterate,
+ *                      const FunctionType& function,
+ *                      arma::uvec& features)
+ * (like ShotgunDescent).
+ */
+template<typename DescentPolicyType, typename FunctionType>
+struct HasDescentFeatures
+{
+  static const bool value = HasDescentFeaturesCheck<DescentPolicyType,
+      void(DescentPolicyType::*)(const size_t, const arma::mat&,
+      const FunctionType&, arma::uvec&)>::value;
+};
+
 /**
  * Stochastic Coordinate descent is a technique for minimizing a function by
  * doing a line search along a single direction at the current point in the
@@ -55,6 +77,10 @@ namespace optimization {
  *  variable and PartialGradient is used to evaluate the partial gradient with
  *  respect to the jth feature.
  *
+ *  If the descent policy picks several coordinates for each descent (see
+ *  HasDescentFeatures and ShotgunDescent), their partial gradients are
+ *  calculated in parallel at the same point, and then all of them are updated.
+ *
  *  @tparam DescentPolicy Descent policy to decide the order in which the
  *      coordinate for descent is selected.
  */
@@ -124,6 +150,28 @@ class SCD
   DescentPolicyType& DescentPolicy() { return descentPolicy; }
 
  private:
+  /**
+   * Descend on the coordinate picked by the descent policy.
+   */
+  template <typename ResolvableFunctionType>
+  typename std::enable_if<!HasDescentFeatures<DescentPolicyType,
+      ResolvableFunctionType>::value, void>::type
+  Descend(ResolvableFunctionType& function,
+          arma::mat& iterate,
+          const size_t iteration,
+          arma::sp_mat& gradient);
+
+  /**
+   * Descend on all the coordinates picked by the descent policy at once.
+   */
+  template <typename ResolvableFunctionType>
+  typename std::enable_if<HasDescentFeatures<DescentPolicyType,
+      ResolvableFunctionType>::value, void>::type
+  Descend(ResolvableFunctionType& function,
+          arma::mat& iterate,
+          const size_t iteration,
+          arma::sp_mat& gradient);
+
   //! The step size for each example.
   double stepSize;
 
@@ -46,14 +46,8 @@ double SCD<DescentPolicyType>::Optimize(ResolvableFunctionType& function,
   // Start iterating.
   for (size_t i = 1; i != maxIterations; ++i)
   {
-    // Get the coordinate to descend on.
-    size_t featureIdx = descentPolicy.DescentFeature(i, iterate, function);
-
-    // Get the partial gradient with respect to this feature.
-    function.PartialGradient(iterate, featureIdx, gradient);
-
-    // Update the decision variable with the partial gradient.
-    iterate.col(featureIdx) -= stepSize * gradient.col(featureIdx);
+    // Descend on the coordinate(s) given by the descent policy.
+    Descend(function, iterate, i, gradient);
 
     // Check for convergence.
     if (i % updateInterval == 0)
@@ -89,6 +83,55 @@ double SCD<DescentPolicyType>::Optimize(ResolvableFunctionType& function,
   return function.Evaluate(iterate);
 }
 
+template <typename DescentPolicyType>
+template <typename ResolvableFunctionType>
+typename std::enable_if<!HasDescentFeatures<DescentPolicyType,
+    ResolvableFunctionType>::value, void>::type
+SCD<DescentPolicyType>::Descend(ResolvableFunctionType& function,
+                                arma::mat& iterate,
+                                const size_t iteration,
+                                arma::sp_mat& gradient)
+{
+  // Get the coordinate to descend on.
+  size_t featureIdx = descentPolicy.DescentFeature(iteration, iterate,
+      function);
+
+  // Get the partial gradient with respect to this feature.
+  function.PartialGradient(iterate, featureIdx, gradient);
+
+  // Update the decision variable with the partial gradient.
+  iterate.col(featureIdx) -= stepSize * gradient.col(featureIdx);
+}
+
+template <typename DescentPolicyType>
+template <typename ResolvableFunctionType>
+typename std::enable_if<HasDescentFeatures<DescentPolicyType,
+    ResolvableFunctionType>::value, void>::type
+SCD<DescentPolicyType>::Descend(ResolvableFunctionType& function,
+                                arma::mat& iterate,
+                                const size_t iteration,
+                                arma::sp_mat& /* gradient */)
+{
+  // Get the coordinates to descend on.
+  arma::uvec features;
+  descentPolicy.DescentFeatures(iteration, iterate, function, features);
+
+  // All the partial gradients are taken at the same point, so they can be
+  // calculated in parallel.
+  arma::mat updates(iterate.n_rows, features.n_elem);
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t k = 0; k < (omp_size_t) features.n_elem; ++k)
+  {
+    arma::sp_mat featureGradient;
+    function.PartialGradient(iterate, features[k], featureGradient);
+    updates.col(k) = arma::mat(featureGradient.col(features[k]));
+  }
+
+  // Update the decision variable with the partial gradients.
+  for (size_t k = 0; k < features.n_elem; ++k)
+    iterate.col(features[k]) -= stepSize * updates.col(k);
+}
+
 } // namespace optimization
 } // namespace mlpack
 
@@ -76,6 +76,33 @@ class LRSDPFunction
                           const arma::mat& coordinates,
                           arma::mat& gradient) const;
 
+  /**
+   * Evaluate all the constraints of the LRSDP at the given coordinates, that
+   * is, Tr(A_i * (R R^T)) - b_i for each constraint i (the sparse constraints
+   * first, then the dense constraints).  The constraints are evaluated in
+   * parallel with OpenMP, and R R^T is only formed if there are dense
+   * constraints.
+   *
+   * @param coordinates The coordinates R.
+   * @param constraints Vector to store the values of the constraints in.
+   */
+  void EvaluateConstraints(const arma::mat& coordinates,
+                           arma::vec& constraints) const;
+
+  /**
+   * Compute (sum_i y_i A_i) R for the given weights y_i of the constraints
+   * (the sparse constraints first, then the dense constraints), in parallel
+   * with OpenMP.  This is the part of the gradient of the augmented Lagrangian
+   * that comes from the constraints.
+   *
+   * @param weights The weight y_i of each constraint.
+   * @param coordinates The coordinates R.
+   * @param product Matrix to store (sum_i y_i A_i) R in.
+   */
+  void WeightedConstraintsProduct(const arma::vec& weights,
+                                  const arma::mat& coordinates,
+                                  arma::mat& product) const;
+
   //! Get the total number of constraints in the LRSDP.
   size_t NumConstraints() const { return sdp.NumConstraints(); }
 
@@ -85,15 +112,37 @@ class LRSDPFunction
   //! Return the SDP object representing the problem.
   const SDPType& SDP() const { return sdp; }
 
-  //! Modify the SDP object representing the problem.
-  SDPType& SDP() { return sdp; }
+  /**
+   * Modify the SDP object representing the problem.  The sparse constraints
+   * are evaluated from a compact copy of their nonzeros, which is rebuilt the
+   * next time they are evaluated; so, if the SDP is modified through a
+   * reference kept from an earlier call, call this again before optimizing.
+   */
+  SDPType& SDP() { sparseLayoutStale = true; return sdp; }
 
  private:
+  //! Rebuild the compact layout of the sparse constraints, if it is stale.
+  void UpdateSparseLayout() const;
+
   //! SDP object representing the problem
   SDPType sdp;
 
   //! Initial point.
   arma::mat initialPoint;
+
+  //! The nonzeros of all the sparse constraint matrices, stored contiguously
+  //! constraint by constraint (like the rows of a CSR matrix): the nonzeros
+  //! of constraint i are at the positions sparseOffsets[i] to
+  //! sparseOffsets[i + 1] - 1 of sparseRows, sparseCols, and sparseValues.
+  mutable arma::uvec sparseOffsets;
+  //! The row of each nonzero of the sparse constraint matrices.
+  mutable arma::uvec sparseRows;
+  //! The column of each nonzero of the sparse constraint matrices.
+  mutable arma::uvec sparseCols;
+  //! The value of each nonzero of the sparse constraint matrices.
+  mutable arma::vec sparseValues;
+  //! Whether the SDP may have been modified since the layout was built.
+  mutable bool sparseLayoutStale;
 };
 
 // Declare specializations in lrsdp_function.cpp.
@@ -23,7 +23,8 @@ template <typename SDPType>
 LRSDPFunction<SDPType>::LRSDPFunction(const SDPType& sdp,
                                       const arma::mat& initialPoint):
     sdp(sdp),
-    initialPoint(initialPoint)
+    initialPoint(initialPoint),
+    sparseLayoutStale(true)
 {
   if (initialPoint.n_rows < initialPoint.n_cols)
     Log::Warn << "LRSDPFunction::LRSDPFunction(): solution matrix will have "
@@ -36,7 +37,8 @@ LRSDPFunction<SDPType>::LRSDPFunction(const size_t numSparseConstraints,
                                       const size_t numDenseConstraints,
                                       const arma::mat& initialPoint):
     sdp(initialPoint.n_rows, numSparseConstraints, numDenseConstraints),
-    initialPoint(initialPoint)
+    initialPoint(initialPoint),
+    sparseLayoutStale(true)
 {
   if (initialPoint.n_rows < initialPoint.n_cols)
     Log::Warn << "LRSDPFunction::LRSDPFunction(): solution matrix will have "
@@ -47,8 +49,8 @@ LRSDPFunction<SDPType>::LRSDPFunction(const size_t numSparseConstraints,
 template <typename SDPType>
 double LRSDPFunction<SDPType>::Evaluate(const arma::mat& coordinates) const
 {
-  const arma::mat rrt = coordinates * trans(coordinates);
-  return accu(SDP().C() % rrt);
+  // Tr(C * (R R^T)) = Tr((C R)^T R), which doesn't need R R^T.
+  return accu((SDP().C() * coordinates) % coordinates);
 }
 
 template <typename SDPType>
@@ -64,11 +66,23 @@ double LRSDPFunction<SDPType>::EvaluateConstraint(
     const size_t index,
     const arma::mat& coordinates) const
 {
-  const arma::mat rrt = coordinates * trans(coordinates);
   if (index < SDP().NumSparseConstraints())
-    return accu(SDP().SparseA()[index] % rrt) - SDP().SparseB()[index];
+  {
+    UpdateSparseLayout();
+
+    double trace = 0.0;
+    for (size_t p = sparseOffsets[index]; p < sparseOffsets[index + 1]; ++p)
+    {
+      trace += sparseValues[p] * arma::dot(coordinates.row(sparseRows[p]),
+          coordinates.row(sparseCols[p]));
+    }
+
+    return trace - SDP().SparseB()[index];
+  }
+
   const size_t index1 = index - SDP().NumSparseConstraints();
-  return accu(SDP().DenseA()[index1] % rrt) - SDP().DenseB()[index1];
+  return accu((SDP().DenseA()[index1] * coordinates) % coordinates) -
+      SDP().DenseB()[index1];
 }
 
 template <typename SDPType>
@@ -81,45 +95,130 @@ void LRSDPFunction<SDPType>::GradientConstraint(
       << "for arbitrary optimizers!" << std::endl;
 }
 
-//! Utility function for calculating part of the objective when AugLagrangian is
-//! used with an LRSDPFunction.
-template <typename MatrixType>
-static inline void
-UpdateObjective(double& objective,
-                const arma::mat& rrt,
-                const std::vector<MatrixType>& ais,
-                const arma::vec& bis,
-                const arma::vec& lambda,
-                const size_t lambdaOffset,
-                const double sigma)
+template <typename SDPType>
+void LRSDPFunction<SDPType>::EvaluateConstraints(
+    const arma::mat& coordinates,
+    arma::vec& constraints) const
 {
-  for (size_t i = 0; i < ais.size(); ++i)
+  UpdateSparseLayout();
+
+  const size_t numSparse = SDP().NumSparseConstraints();
+  const size_t numDense = SDP().NumDenseConstraints();
+  constraints.set_size(numSparse + numDense);
+
+  // The rows of R are the columns of R^T, which are contiguous in memory.
+  const arma::mat rt = trans(coordinates);
+
+  // Each sparse trace is taken over the nonzeros of A_i only:
+  //   Tr(A_i * (R R^T)) = sum_{(j, k)} A_i(j, k) * dot(R.row(j), R.row(k)).
+  #pragma omp parallel for schedule(dynamic, 64)
+  for (omp_size_t i = 0; i < (omp_size_t) numSparse; ++i)
   {
-    // Take the trace subtracted by the b_i.
-    const double constraint = accu(ais[i] % rrt) - bis[i];
-    objective -= (lambda[lambdaOffset + i] * constraint);
-    objective += (sigma / 2.) * constraint * constraint;
+    double trace = 0.0;
+    for (size_t p = sparseOffsets[i]; p < sparseOffsets[i + 1]; ++p)
+    {
+      trace += sparseValues[p] * arma::dot(rt.unsafe_col(sparseRows[p]),
+          rt.unsafe_col(sparseCols[p]));
+    }
+
+    constraints[i] = trace - SDP().SparseB()[i];
+  }
+
+  if (numDense == 0)
+    return;
+
+  const arma::mat rrt = coordinates * rt;
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) numDense; ++i)
+  {
+    constraints[numSparse + i] = accu(SDP().DenseA()[i] % rrt) -
+        SDP().DenseB()[i];
   }
 }
 
-//! Utility function for calculating part of the gradient when AugLagrangian is
-//! used with an LRSDPFunction.
-template <typename MatrixType>
-static inline void
-UpdateGradient(arma::mat& s,
-               const arma::mat& rrt,
-               const std::vector<MatrixType>& ais,
-               const arma::vec& bis,
-               const arma::vec& lambda,
-               const size_t lambdaOffset,
-               const double sigma)
+template <typename SDPType>
+void LRSDPFunction<SDPType>::WeightedConstraintsProduct(
+    const arma::vec& weights,
+    const arma::mat& coordinates,
+    arma::mat& product) const
 {
-  for (size_t i = 0; i < ais.size(); ++i)
+  UpdateSparseLayout();
+
+  const size_t numSparse = SDP().NumSparseConstraints();
+  const size_t numDense = SDP().NumDenseConstraints();
+
+  // (A_i R).row(j) = sum_{(j, k)} A_i(j, k) * R.row(k); we work with R^T, so
+  // that the rows are contiguous.  Each thread accumulates its own sum.
+  const arma::mat rt = trans(coordinates);
+  arma::mat productT(rt.n_rows, rt.n_cols, arma::fill::zeros);
+
+  #pragma omp parallel
   {
-    const double constraint = accu(ais[i] % rrt) - bis[i];
-    const double y = lambda[lambdaOffset + i] - sigma * constraint;
-    s -= y * ais[i];
+    arma::mat localProductT(rt.n_rows, rt.n_cols, arma::fill::zeros);
+
+    #pragma omp for schedule(dynamic, 64)
+    for (omp_size_t i = 0; i < (omp_size_t) numSparse; ++i)
+    {
+      for (size_t p = sparseOffsets[i]; p < sparseOffsets[i + 1]; ++p)
+      {
+        localProductT.unsafe_col(sparseRows[p]) += (weights[i] *
+            sparseValues[p]) * rt.unsafe_col(sparseCols[p]);
+      }
+    }
+
+    #pragma omp critical
+    productT += localProductT;
   }
+
+  product = trans(productT);
+
+  if (numDense == 0)
+    return;
+
+  // Sum the dense constraints column by column, so that each thread writes
+  // to its own columns.
+  arma::mat s(coordinates.n_rows, coordinates.n_rows);
+  #pragma omp parallel for
+  for (omp_size_t j = 0; j < (omp_size_t) s.n_cols; ++j)
+  {
+    s.unsafe_col(j).zeros();
+    for (size_t i = 0; i < numDense; ++i)
+      s.unsafe_col(j) += weights[numSparse + i] * SDP().DenseA()[i].col(j);
+  }
+
+  product += s * coordinates;
+}
+
+template <typename SDPType>
+void LRSDPFunction<SDPType>::UpdateSparseLayout() const
+{
+  if (!sparseLayoutStale)
+    return;
+
+  const std::vector<arma::sp_mat>& sparseA = sdp.SparseA();
+  sparseOffsets.set_size(sparseA.size() + 1);
+  sparseOffsets[0] = 0;
+  for (size_t i = 0; i < sparseA.size(); ++i)
+    sparseOffsets[i + 1] = sparseOffsets[i] + sparseA[i].n_nonzero;
+
+  const size_t numNonzero = sparseOffsets[sparseA.size()];
+  sparseRows.set_size(numNonzero);
+  sparseCols.set_size(numNonzero);
+  sparseValues.set_size(numNonzero);
+
+  for (size_t i = 0; i < sparseA.size(); ++i)
+  {
+    size_t p = sparseOffsets[i];
+    for (arma::sp_mat::const_iterator it = sparseA[i].begin();
+        it != sparseA[i].end(); ++it, ++p)
+    {
+      sparseRows[p] = it.row();
+      sparseCols[p] = it.col();
+      sparseValues[p] = (*it);
+    }
+  }
+
+  sparseLayoutStale = false;
 }
 
 template <typename SDPType>
@@ -133,26 +232,15 @@ EvaluateImpl(const LRSDPFunction<SDPType>& function,
   // L(R, y, s) = Tr(C * (R R^T)) -
   //     sum_{i = 1}^{m} (y_i (Tr(A_i * (R R^T)) - b_i)) +
   //     (sigma / 2) * sum_{i = 1}^{m} (Tr(A_i * (R R^T)) - b_i)^2
-
-  // Let's start with the objective: Tr(C * (R R^T)).
-  // Simple, possibly slow solution-- see below for optimization opportunity
   //
-  // TODO: Note that Tr(C^T * (R R^T)) = Tr( (CR)^T * R ), so
-  // multiplying C*R first, and then taking the trace dot should be more memory
-  // efficient
-  //
-  // Similarly for the constraints, taking A*R first should be more efficient
-  const arma::mat rrt = coordinates * trans(coordinates);
-  double objective = accu(function.SDP().C() % rrt);
-
-  // Now each constraint.
-  UpdateObjective(objective, rrt, function.SDP().SparseA(),
-      function.SDP().SparseB(), lambda, 0, sigma);
-  UpdateObjective(objective, rrt, function.SDP().DenseA(),
-      function.SDP().DenseB(), lambda, function.SDP().NumSparseConstraints(),
-      sigma);
-
-  return objective;
+  // Tr(C * (R R^T)) = Tr((C R)^T R), so R R^T isn't needed for the objective;
+  // the constraints are evaluated all at once.
+  arma::vec constraints;
+  function.EvaluateConstraints(coordinates, constraints);
+
+  return accu((function.SDP().C() * coordinates) % coordinates) -
+      arma::dot(lambda, constraints) +
+      (sigma / 2.) * arma::dot(constraints, constraints);
 }
 
 template <typename SDPType>
@@ -168,17 +256,14 @@ GradientImpl(const LRSDPFunction<SDPType>& function,
   //   with
   // S' = C - sum_{i = 1}^{m} y'_i A_i
   // y'_i = y_i - sigma * (Trace(A_i * (R R^T)) - b_i)
-  const arma::mat rrt = coordinates * trans(coordinates);
-  arma::mat s(function.SDP().C());
+  arma::vec constraints;
+  function.EvaluateConstraints(coordinates, constraints);
+  const arma::vec y = lambda - sigma * constraints;
 
-  UpdateGradient(
-      s, rrt, function.SDP().SparseA(), function.SDP().SparseB(),
-      lambda, 0, sigma);
-  UpdateGradient(
-      s, rrt, function.SDP().DenseA(), function.SDP().DenseB(),
-      lambda, function.SDP().NumSparseConstraints(), sigma);
+  arma::mat constraintsProduct;
+  function.WeightedConstraintsProduct(y, coordinates, constraintsProduct);
 
-  gradient = 2 * s * coordinates;
+  gradient = 2 * (function.SDP().C() * coordinates - constraintsProduct);
 }
 
 // Template specializations for function and gradient evaluation.
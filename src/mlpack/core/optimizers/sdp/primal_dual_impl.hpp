@@ -129,17 +129,65 @@ Alpha(const arma::mat& A, const arma::mat& dA, double tau)
  *
  *   AX + XA = H
  *
- * where A, H are symmetric matrices.
+ * where A is symmetric positive definite and H is symmetric, given the
+ * eigenvalue decomposition A = Q diag(evals) Q^T.  In the eigenbasis of A the
+ * equation is diagonal (see Lemma 7.2 of [AHO98]), so
  *
- * TODO(stephentu): Note this method current uses arma's builtin arma::syl
- * method, which is overkill for this situation. See Lemma 7.2 of [AHO98] for
- * how to solve this Lyapunov equation using an eigenvalue decomposition of A.
+ *   X = Q ((Q^T H Q) ./ (evals_i + evals_j)) Q^T.
  *
+ * The decomposition is computed once per iteration and shared by all the
+ * equations, so each solve is only a few matrix products.
  */
 static inline void
-SolveLyapunov(arma::mat& X, const arma::mat& A, const arma::mat& H)
+SolveLyapunov(arma::mat& X,
+              const arma::mat& Q,
+              const arma::vec& evals,
+              const arma::mat& H)
 {
-  arma::syl(X, A, A, -H);
+  arma::mat Ht = Q.t() * H * Q;
+  for (size_t j = 0; j < Ht.n_cols; ++j)
+    for (size_t i = 0; i < Ht.n_rows; ++i)
+      Ht(i, j) /= (evals(i) + evals(j));
+
+  X = Q * Ht * Q.t();
+}
+
+/**
+ * Compute F v, where F = X sym I and v = svec(V), without forming the
+ * n2bar x n2bar matrix F: F v = svec((X V + V X) / 2).
+ */
+static inline void
+SymKronIdProduct(const arma::mat& X, const arma::vec& v, arma::vec& Fv)
+{
+  arma::mat V;
+  math::Smat(v, V);
+  math::Svec(0.5 * (X * V + V * X), Fv);
+}
+
+/**
+ * Compute A B, where the sparse matrix A is given by its transpose AT.  The
+ * columns of AT are the rows of A, and they are stored contiguously (so AT is
+ * A in compressed sparse row format); each entry of A B is a sparse dot
+ * product with a column of B, and the columns are computed in parallel.
+ */
+static inline void
+SparseRowProduct(const arma::sp_mat& AT, const arma::mat& B, arma::mat& AB)
+{
+  AB.set_size(AT.n_cols, B.n_cols);
+
+  #pragma omp parallel for
+  for (omp_size_t j = 0; j < (omp_size_t) B.n_cols; ++j)
+  {
+    for (size_t i = 0; i < AT.n_cols; ++i)
+    {
+      double sum = 0.0;
+      for (arma::sp_mat::const_col_iterator it = AT.begin_col(i);
+          it != AT.end_col(i); ++it)
+        sum += (*it) * B(it.row(), j);
+
+      AB(i, j) = sum;
+    }
+  }
 }
 
 /**
@@ -158,13 +206,16 @@ SolveLyapunov(arma::mat& X, const arma::mat& A, const arma::mat& H)
  *     E  = Z sym I
  *     F  = X sym I
  *
+ * The eigenvalue decomposition of Z is given, to solve the Lyapunov equations
+ * for E^(-1), and F is applied through X.
  */
 static inline void
 SolveKKTSystem(const arma::sp_mat& Asparse,
                const arma::mat& Adense,
-               const arma::mat& Z,
+               const arma::mat& zEigvec,
+               const arma::vec& zEigval,
                const arma::mat& M,
-               const arma::mat& F,
+               const arma::mat& X,
                const arma::vec& rp,
                const arma::vec& rd,
                const arma::vec& rc,
@@ -175,14 +226,15 @@ SolveKKTSystem(const arma::sp_mat& Asparse,
 {
   arma::mat Frd_rc_Mat, Einv_Frd_rc_Mat,
             Einv_Frd_ATdy_rc_Mat, Frd_ATdy_rc_Mat;
-  arma::vec Einv_Frd_rc, Einv_Frd_ATdy_rc, dy;
+  arma::vec Frd, Frd_ATdy, Einv_Frd_rc, Einv_Frd_ATdy_rc, dy;
 
   // Note: Whenever a formula calls for E^(-1) v for some v, we solve Lyapunov
   // equations instead of forming an explicit inverse.
 
   // Compute the RHS of (2.12)
-  math::Smat(F * rd - rc, Frd_rc_Mat);
-  SolveLyapunov(Einv_Frd_rc_Mat, Z, 2. * Frd_rc_Mat);
+  SymKronIdProduct(X, rd, Frd);
+  math::Smat(Frd - rc, Frd_rc_Mat);
+  SolveLyapunov(Einv_Frd_rc_Mat, zEigvec, zEigval, 2. * Frd_rc_Mat);
   math::Svec(Einv_Frd_rc_Mat, Einv_Frd_rc);
 
   arma::vec rhs = rp;
@@ -203,9 +255,11 @@ SolveKKTSystem(const arma::sp_mat& Asparse,
     dydense = dy(arma::span(Asparse.n_rows, numConstraints - 1));
 
   // Compute dx from (2.13)
-  math::Smat(F * (rd - Asparse.t() * dysparse - Adense.t() * dydense) - rc,
-      Frd_ATdy_rc_Mat);
-  SolveLyapunov(Einv_Frd_ATdy_rc_Mat, Z, 2. * Frd_ATdy_rc_Mat);
+  SymKronIdProduct(X, rd - Asparse.t() * dysparse - Adense.t() * dydense,
+      Frd_ATdy);
+  math::Smat(Frd_ATdy - rc, Frd_ATdy_rc_Mat);
+  SolveLyapunov(Einv_Frd_ATdy_rc_Mat, zEigvec, zEigval,
+      2. * Frd_ATdy_rc_Mat);
   math::Svec(Einv_Frd_ATdy_rc_Mat, Einv_Frd_ATdy_rc);
   dsx = -Einv_Frd_ATdy_rc;
 
@@ -249,6 +303,9 @@ PrimalDualSolver<SDPType>::Optimize(arma::mat& X,
     Asparse.row(i) = Aisparse.t();
   }
 
+  // The rows of Asparse, for the products in (2.15).
+  const arma::sp_mat AsparseT = Asparse.t();
+
   arma::mat Adense(sdp.NumDenseConstraints(), n2bar);
   arma::vec Aidense;
   for (size_t i = 0; i < sdp.NumDenseConstraints(); i++)
@@ -271,10 +328,9 @@ PrimalDualSolver<SDPType>::Optimize(arma::mat& X,
   math::Svec(X, sx);
   math::Svec(Z, sz);
 
-  arma::vec rp, rd, rc, gk;
+  arma::vec rp, rd, rc, zEigval;
 
-  arma::mat Rc, F, Einv_F_AsparseT, Einv_F_AdenseT, Gk,
-            M, DualCheck;
+  arma::mat Rc, Einv_F_AsparseT, Einv_F_AdenseT, M, Mblock, zEigvec;
 
   rp.set_size(sdp.NumConstraints());
 
@@ -300,22 +356,33 @@ PrimalDualSolver<SDPType>::Optimize(arma::mat& X,
           sdp.DenseB() - Adense * sx;
 
     // Rd = C - Z - smat A^T y
-    rd = sc - sz - Asparse.t() * ysparse - Adense.t() * ydense;
+    rd = sc - sz - AsparseT * ysparse - Adense.t() * ydense;
 
-    math::SymKronId(X, F);
+    if (!arma::eig_sym(zEigval, zEigvec, Z))
+      Log::Fatal << "PrimalDualSolver::Optimize(): Could not decompose Z."
+          << std::endl;
 
     // We compute E^(-1) F A^T by solving Lyapunov equations.
-    // See (2.16).
-    for (size_t i = 0; i < sdp.NumSparseConstraints(); i++)
+    // See (2.16).  The equations are independent, so they are solved in
+    // parallel.
+    #pragma omp parallel for schedule(dynamic)
+    for (omp_size_t i = 0; i < (omp_size_t) sdp.NumSparseConstraints(); i++)
     {
-      SolveLyapunov(Gk, Z, X * sdp.SparseA()[i] + sdp.SparseA()[i] * X);
+      arma::mat Gk;
+      arma::vec gk;
+      SolveLyapunov(Gk, zEigvec, zEigval,
+          X * sdp.SparseA()[i] + sdp.SparseA()[i] * X);
       math::Svec(Gk, gk);
       Einv_F_AsparseT.col(i) = gk;
     }
 
-    for (size_t i = 0; i < sdp.NumDenseConstraints(); i++)
+    #pragma omp parallel for schedule(dynamic)
+    for (omp_size_t i = 0; i < (omp_size_t) sdp.NumDenseConstraints(); i++)
     {
-      SolveLyapunov(Gk, Z, X * sdp.DenseA()[i] + sdp.DenseA()[i] * X);
+      arma::mat Gk;
+      arma::vec gk;
+      SolveLyapunov(Gk, zEigvec, zEigval,
+          X * sdp.DenseA()[i] + sdp.DenseA()[i] * X);
       math::Svec(Gk, gk);
       Einv_F_AdenseT.col(i) = gk;
     }
@@ -323,18 +390,19 @@ PrimalDualSolver<SDPType>::Optimize(arma::mat& X,
     // Form the M = A E^(-1) F A^T matrix (2.15)
     //
     // Since we split A up into its sparse and dense components,
-    // we have to handle each block separately.
+    // we have to handle each block separately.  The blocks with the sparse
+    // rows are computed in parallel from the rows of Asparse.
     if (sdp.NumSparseConstraints())
     {
+      SparseRowProduct(AsparseT, Einv_F_AsparseT, Mblock);
       M.submat(arma::span(0, sdp.NumSparseConstraints() - 1),
-               arma::span(0, sdp.NumSparseConstraints() - 1)) =
-          Asparse * Einv_F_AsparseT;
+               arma::span(0, sdp.NumSparseConstraints() - 1)) = Mblock;
       if (sdp.NumDenseConstraints())
       {
+        SparseRowProduct(AsparseT, Einv_F_AdenseT, Mblock);
         M.submat(arma::span(0, sdp.NumSparseConstraints() - 1),
                  arma::span(sdp.NumSparseConstraints(),
-                            sdp.NumConstraints() - 1)) =
-            Asparse * Einv_F_AdenseT;
+                            sdp.NumConstraints() - 1)) = Mblock;
       }
     }
     if (sdp.NumDenseConstraints())
@@ -363,8 +431,8 @@ PrimalDualSolver<SDPType>::Optimize(arma::mat& X,
     // This solves step (1) of Section 7, the "predictor" step.
     Rc = -0.5*(X*Z + Z*X);
     math::Svec(Rc, rc);
-    SolveKKTSystem(Asparse, Adense, Z, M, F, rp, rd, rc, dsx, dysparse, dydense,
-        dsz);
+    SolveKKTSystem(Asparse, Adense, zEigvec, zEigval, M, X, rp, rd, rc, dsx,
+        dysparse, dydense, dsz);
     math::Smat(dsx, dX);
     math::Smat(dsz, dZ);
 
@@ -380,8 +448,8 @@ PrimalDualSolver<SDPType>::Optimize(arma::mat& X,
     // Step (3), the "corrector" step.
     Rc = mu*arma::eye<arma::mat>(n, n) - 0.5*(X*Z + Z*X + dX*dZ + dZ*dX);
     math::Svec(Rc, rc);
-    SolveKKTSystem(Asparse, Adense, Z, M, F, rp, rd, rc, dsx, dysparse, dydense,
-        dsz);
+    SolveKKTSystem(Asparse, Adense, zEigvec, zEigval, M, X, rp, rd, rc, dsx,
+        dysparse, dydense, dsz);
     math::Smat(dsx, dX);
     math::Smat(dsz, dZ);
     alpha = Alpha(X, dX, tau);
@@ -419,14 +487,11 @@ PrimalDualSolver<SDPType>::Optimize(arma::mat& X,
         arma::dot(sdp.DenseB(), ydense);
     const double dualityGap = primalObj - dualObj;
 
-    // TODO(stephentu): this dual check is quite expensive,
-    // maybe make it optional?
-    DualCheck = Z - sdp.C();
-    for (size_t i = 0; i < sdp.NumSparseConstraints(); i++)
-      DualCheck += ysparse(i) * sdp.SparseA()[i];
-    for (size_t i = 0; i < sdp.NumDenseConstraints(); i++)
-      DualCheck += ydense(i) * sdp.DenseA()[i];
-    const double dualInfeas = arma::norm(DualCheck, "fro");
+    // The dual infeasibility is ||Z - C + sum_i y_i A_i||_F.  Since svec()
+    // preserves the norm of symmetric matrices, this is the norm of the svec()
+    // of that matrix, which is computed from A without summing the A_i.
+    const double dualInfeas = arma::norm(arma::vec(sz - sc +
+        AsparseT * ysparse + Adense.t() * ydense), 2);
 
     Log::Debug
         << "iter=" << iteration << ", "
@@ -36,12 +36,22 @@ class NoDecay
   * @param stepSize Step size to be used for the given iteration.
   * @param gradient The gradient matrix.
   */
+  template<typename GradType>
   void Update(arma::mat& /* iterate */,
               double& /* stepSize */,
-              const arma::mat& /* gradient */)
+              const GradType& /* gradient */)
   {
     // Nothing to do here.
   }
+
+  /**
+   * Serialize the decay policy (for checkpoints of the optimization).
+   */
+  template<typename Archive>
+  void serialize(Archive& /* ar */, const unsigned int /* version */)
+  {
+    // Nothing to do; the policy has no state.
+  }
 };
 
 } // namespace optimization
@@ -18,10 +18,32 @@
 #include "update_policies/vanilla_update.hpp"
 #include "update_policies/momentum_update.hpp"
 #include "decay_policies/no_decay.hpp"
+#include <mlpack/core/optimizers/evaluate_with_gradient.hpp>
+#include <mlpack/core/optimizers/checkpoint/checkpoint.hpp>
 
 namespace mlpack {
 namespace optimization {
 
+// This gives us a HasSparseUpdateCheck<T, U> type (where U is a function
+// pointer) we can use with SFINAE to catch when an update policy has an
+// Update(...) function.
+HAS_MEM_FUNC(Update, HasSparseUpdateCheck);
+
+/**
+ * Whether the given update policy type has a method
+ * void Update(arma::mat& iterate,
+ *             const double stepSize,
+ *             const arma::sp_mat& gradient),
+ * which takes a step with a sparse gradient.
+ */
+template<typename UpdatePolicyType>
+struct HasSparseUpdate
+{
+  static const bool value = HasSparseUpdateCheck<UpdatePolicyType,
+      void(UpdatePolicyType::*)(arma::mat&, const double,
+      const arma::sp_mat&)>::value;
+};
+
 /**
  * Stochastic Gradient Descent is a technique for minimizing a function which
  * can be expressed as a sum of other functions.  That is, suppose we have
@@ -72,6 +94,31 @@ namespace optimization {
  * objective function on the first point in the dataset (presumably, the dataset
  * is held internally in the DecomposableFunctionType).
  *
+ * If the class also implements
+ *
+ *   double EvaluateWithGradient(const arma::mat& coordinates,
+ *                               const size_t i,
+ *                               arma::mat& gradient,
+ *                               const size_t batchSize);
+ *
+ * then it is used to compute the objective and the gradient of each batch in
+ * one pass, instead of calling Evaluate() and Gradient().
+ *
+ * If the class also implements
+ *
+ *   void Gradient(const arma::mat& coordinates,
+ *                 const size_t i,
+ *                 arma::sp_mat& gradient,
+ *                 const size_t batchSize);
+ *
+ * and the update policy can take a step with a sparse gradient (see
+ * HasSparseUpdate; for instance SparseAdaGradUpdate, SparseRMSPropUpdate or
+ * LazyAdamUpdate), then the gradient of each batch is kept sparse, so that the
+ * cost of each step depends only on the number of nonzero gradient entries.
+ *
+ * The state of the optimization can be saved periodically, so that an
+ * interrupted run can be resumed; see Checkpoint() and OptimizerCheckpoint.
+ *
  * @tparam UpdatePolicyType update policy used by SGD during the iterative update
  *     process. By default vanilla update policy (see
  *     mlpack::optimization::VanillaUpdate) is used.
@@ -170,7 +217,39 @@ class SGD
   //! Modify the step size decay policy.
   DecayPolicyType& DecayPolicy() { return decayPolicy; }
 
+  //! Get the checkpoint settings (a checkpoint is saved every Interval()
+  //! passes over the data).
+  const OptimizerCheckpoint& Checkpoint() const { return checkpoint; }
+  //! Modify the checkpoint settings (a checkpoint is saved every Interval()
+  //! passes over the data).
+  OptimizerCheckpoint& Checkpoint() { return checkpoint; }
+
  private:
+  /**
+   * The state of an optimization that is saved in a checkpoint, at the start
+   * of a pass over the data.
+   */
+  struct CheckpointState
+  {
+    arma::mat& iterate;
+    size_t& iteration;
+    double& lastObjective;
+    double& stepSize;
+    UpdatePolicyType& updatePolicy;
+    DecayPolicyType& decayPolicy;
+
+    template<typename Archive>
+    void serialize(Archive& ar, const unsigned int /* version */)
+    {
+      ar & BOOST_SERIALIZATION_NVP(iterate);
+      ar & BOOST_SERIALIZATION_NVP(iteration);
+      ar & BOOST_SERIALIZATION_NVP(lastObjective);
+      ar & BOOST_SERIALIZATION_NVP(stepSize);
+      SerializePolicy(ar, "updatePolicy", updatePolicy);
+      SerializePolicy(ar, "decayPolicy", decayPolicy);
+    }
+  };
+
   //! The step size for each example.
   double stepSize;
 
@@ -196,6 +275,9 @@ class SGD
   //! Flag indicating whether update policy
   //! should be reset before running optimization.
   bool resetPolicy;
+
+  //! The checkpoint settings.
+  OptimizerCheckpoint checkpoint;
 };
 
 using StandardSGD = SGD<VanillaUpdate>;
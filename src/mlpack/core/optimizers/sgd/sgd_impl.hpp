@@ -54,49 +54,76 @@ double SGD<UpdatePolicyType, DecayPolicyType>::Optimize(
   size_t currentFunction = 0;
   double overallObjective = 0;
   double lastObjective = DBL_MAX;
+  size_t i = 0;
+
+  // Initialize the update policy.
+  if (resetPolicy)
+    updatePolicy.Initialize(iterate.n_rows, iterate.n_cols);
+
+  // Resume from the last checkpoint, if there is one; it was saved at the
+  // start of a pass, after the checks for convergence.
+  CheckpointState state = { iterate, i, lastObjective, stepSize, updatePolicy,
+      decayPolicy };
+  bool resuming = checkpoint.Enabled() && checkpoint.Load("SGD", state);
 
   // Calculate the first objective function.
-  for (size_t i = 0; i < numFunctions; i += batchSize)
+  for (size_t j = 0; j < numFunctions && !resuming; j += batchSize)
   {
-    const size_t effectiveBatchSize = std::min(batchSize, numFunctions - i);
-    overallObjective += function.Evaluate(iterate, i, effectiveBatchSize);
+    const size_t effectiveBatchSize = std::min(batchSize, numFunctions - j);
+    overallObjective += function.Evaluate(iterate, j, effectiveBatchSize);
   }
 
-  // Initialize the update policy.
-  if (resetPolicy)
-    updatePolicy.Initialize(iterate.n_rows, iterate.n_cols);
+  // The gradient is kept sparse if both the function and the update policy
+  // support it.
+  typedef typename std::conditional<
+      HasSparseUpdate<UpdatePolicyType>::value &&
+      HasSparseGradient<DecomposableFunctionType>::value,
+      arma::sp_mat, arma::mat>::type GradType;
 
   // Now iterate!
-  arma::mat gradient(iterate.n_rows, iterate.n_cols);
+  GradType gradient(iterate.n_rows, iterate.n_cols);
   const size_t actualMaxIterations = (maxIterations == 0) ?
       std::numeric_limits<size_t>::max() : maxIterations;
-  for (size_t i = 0; i < actualMaxIterations; /* incrementing done manually */)
+  for (/* i is set above */; i < actualMaxIterations;
+      /* incrementing done manually */)
   {
     // Is this iteration the start of a sequence?
     if ((currentFunction % numFunctions) == 0)
     {
-      // Output current objective function.
-      Log::Info << "SGD: iteration " << i << ", objective " << overallObjective
-          << "." << std::endl;
-
-      if (std::isnan(overallObjective) || std::isinf(overallObjective))
+      // When resuming, the checks were already done before the checkpoint.
+      if (!resuming)
       {
-        Log::Warn << "SGD: converged to " << overallObjective << "; terminating"
-            << " with failure.  Try a smaller step size?" << std::endl;
-        return overallObjective;
+        // Output current objective function.
+        Log::Info << "SGD: iteration " << i << ", objective "
+            << overallObjective << "." << std::endl;
+
+        if (std::isnan(overallObjective) || std::isinf(overallObjective))
+        {
+          Log::Warn << "SGD: converged to " << overallObjective << "; "
+              << "terminating with failure.  Try a smaller step size?"
+              << std::endl;
+          checkpoint.Finish();
+          return overallObjective;
+        }
+
+        if (std::abs(lastObjective - overallObjective) < tolerance)
+        {
+          Log::Info << "SGD: minimized within tolerance " << tolerance << "; "
+              << "terminating optimization." << std::endl;
+          checkpoint.Finish();
+          return overallObjective;
+        }
+
+        // Reset the counter variables.
+        lastObjective = overallObjective;
+        overallObjective = 0;
+        currentFunction = 0;
+
+        // Save the state (in the background), if it is time.
+        if (checkpoint.Due(i / numFunctions))
+          checkpoint.Save("SGD", state);
       }
-
-      if (std::abs(lastObjective - overallObjective) < tolerance)
-      {
-        Log::Info << "SGD: minimized within tolerance " << tolerance << "; "
-            << "terminating optimization." << std::endl;
-        return overallObjective;
-      }
-
-      // Reset the counter variables.
-      lastObjective = overallObjective;
-      overallObjective = 0;
-      currentFunction = 0;
+      resuming = false;
 
       if (shuffle) // Determine order of visitation.
         function.Shuffle();
@@ -106,14 +133,14 @@ double SGD<UpdatePolicyType, DecayPolicyType>::Optimize(
     const size_t effectiveBatchSize = std::min(batchSize,
         numFunctions - currentFunction);
 
-    function.Gradient(iterate, currentFunction, gradient, effectiveBatchSize);
+    // The objective of the batch is taken at the point its gradient is taken
+    // at, so that both can be computed together.
+    overallObjective += EvaluateWithGradient(function, iterate,
+        currentFunction, gradient, effectiveBatchSize);
 
     // Use the update policy to take a step.
     updatePolicy.Update(iterate, stepSize, gradient);
 
-    overallObjective += function.Evaluate(iterate, currentFunction,
-        effectiveBatchSize);
-
     // Now update the learning rate if requested by the user.
     decayPolicy.Update(iterate, stepSize, gradient);
 
@@ -123,13 +150,14 @@ double SGD<UpdatePolicyType, DecayPolicyType>::Optimize(
 
   Log::Info << "SGD: maximum iterations (" << maxIterations << ") reached; "
       << "terminating optimization." << std::endl;
+  checkpoint.Finish();
 
   // Calculate final objective.
   overallObjective = 0;
-  for (size_t i = 0; i < numFunctions; i += batchSize)
+  for (size_t j = 0; j < numFunctions; j += batchSize)
   {
-    const size_t effectiveBatchSize = std::min(batchSize, numFunctions - i);
-    overallObjective += function.Evaluate(iterate, i, effectiveBatchSize);
+    const size_t effectiveBatchSize = std::min(batchSize, numFunctions - j);
+    overallObjective += function.Evaluate(iterate, j, effectiveBatchSize);
   }
   return overallObjective;
 }
@@ -0,0 +1,142 @@
+/**
+ * @file streaming_function.hpp
+ *
+ * Definition of the StreamingFunction class, which lets SGD-type optimizers
+ * train on a dataset that is read from disk a chunk at a time.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_OPTIMIZERS_SGD_STREAMING_FUNCTION_HPP
+#define MLPACK_CORE_OPTIMIZERS_SGD_STREAMING_FUNCTION_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/data/streaming_dataset.hpp>
+
+#include <functional>
+#include <memory>
+
+namespace mlpack {
+namespace optimization {
+
+/**
+ * StreamingFunction is a decomposable function (see SGD) over a
+ * data::StreamingDataset.  Only one chunk of the dataset is held in memory at a
+ * time: for each chunk, a FunctionType object is built on it with the given
+ * builder, and the calls to Evaluate() and Gradient() for the points of the
+ * chunk are passed to that object.  Batches that span two chunks are split,
+ * and the objectives and gradients of the two parts are summed.
+ *
+ * The points must be visited in order, as SGD (and all the optimizers built on
+ * it, such as Adam and RMSProp) does; asking for an earlier point starts a new
+ * pass over the file.  Shuffle() makes each chunk shuffle its own points when
+ * it is loaded, so points are only reordered inside of a chunk.
+ *
+ * When the builder is called, the labels are taken from the last dimension of
+ * the dataset, unless the function was constructed with labeled = false (in
+ * which case the labels are empty).  The objects passed to the builder live
+ * until the next chunk is loaded, so FunctionType may keep aliases to them.
+ *
+ * @code
+ * data::StreamingDataset<> dataset("clicks.bin", 100000);
+ * StreamingFunction<LogisticRegressionFunction<>> f(dataset,
+ *     [](const arma::mat& points, const arma::Row<size_t>& labels)
+ *     {
+ *       return LogisticRegressionFunction<>(points, labels);
+ *     });
+ *
+ * StandardSGD sgd(0.01, 32, 10 * dataset.NumPoints());
+ * arma::mat parameters(1, dataset.Dimensionality(), arma::fill::zeros);
+ * sgd.Optimize(f, parameters);
+ * @endcode
+ *
+ * @tparam FunctionType Decomposable function to build on each chunk.
+ * @tparam eT Element type of the dataset.
+ */
+template<typename FunctionType, typename eT = double>
+class StreamingFunction
+{
+ public:
+  //! Type of the builder, which creates the function for a chunk.
+  typedef std::function<FunctionType(const arma::Mat<eT>& points,
+                                     const arma::Row<size_t>& labels)>
+      BuilderType;
+
+  /**
+   * Create the StreamingFunction on the given dataset.  The dataset must stay
+   * valid while the StreamingFunction is used.
+   *
+   * @param dataset Dataset to read chunks from.
+   * @param builder Function that creates a FunctionType for a chunk.
+   * @param labeled Whether the last dimension of the dataset holds labels.
+   */
+  StreamingFunction(data::StreamingDataset<eT>& dataset,
+                    BuilderType builder,
+                    const bool labeled = true);
+
+  //! Return the number of functions (the number of points in the dataset).
+  size_t NumFunctions() const { return dataset.NumPoints(); }
+
+  //! Shuffle the points of each chunk, from the next chunk that is loaded.
+  void Shuffle() { shuffle = true; }
+
+  /**
+   * Evaluate the objective function on the points [begin, begin + batchSize).
+   *
+   * @param coordinates The coordinates to evaluate at.
+   * @param begin Index of the first point of the batch.
+   * @param batchSize Number of points in the batch.
+   */
+  double Evaluate(const arma::mat& coordinates,
+                  const size_t begin,
+                  const size_t batchSize);
+
+  /**
+   * Evaluate the gradient of the objective function on the points
+   * [begin, begin + batchSize).
+   *
+   * @param coordinates The coordinates to evaluate at.
+   * @param begin Index of the first point of the batch.
+   * @param gradient Matrix to store the gradient in.
+   * @param batchSize Number of points in the batch.
+   */
+  void Gradient(const arma::mat& coordinates,
+                const size_t begin,
+                arma::mat& gradient,
+                const size_t batchSize);
+
+ private:
+  /**
+   * Make sure that the chunk holding the given point is loaded, and return the
+   * number of points of the chunk from the given point onwards.
+   */
+  size_t Seek(const size_t point);
+
+  //! The dataset to read from.
+  data::StreamingDataset<eT>& dataset;
+  //! The function used to build a FunctionType for each chunk.
+  BuilderType builder;
+  //! Whether the last dimension holds labels.
+  bool labeled;
+  //! Whether the chunks should be shuffled.
+  bool shuffle;
+
+  //! The points of the current chunk.
+  arma::Mat<eT> points;
+  //! The labels of the current chunk.
+  arma::Row<size_t> labels;
+  //! Index of the first point of the current chunk.
+  size_t chunkBegin;
+  //! The function for the current chunk (NULL if no chunk is loaded).
+  std::unique_ptr<FunctionType> function;
+};
+
+} // namespace optimization
+} // namespace mlpack
+
+// Include implementation.
+#include "streaming_function_impl.hpp"
+
+#endif
@@ -0,0 +1,117 @@
+/**
+ * @file streaming_function_impl.hpp
+ *
+ * Implementation of the StreamingFunction class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_OPTIMIZERS_SGD_STREAMING_FUNCTION_IMPL_HPP
+#define MLPACK_CORE_OPTIMIZERS_SGD_STREAMING_FUNCTION_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "streaming_function.hpp"
+
+namespace mlpack {
+namespace optimization {
+
+template<typename FunctionType, typename eT>
+StreamingFunction<FunctionType, eT>::StreamingFunction(
+    data::StreamingDataset<eT>& dataset,
+    BuilderType builder,
+    const bool labeled) :
+    dataset(dataset),
+    builder(std::move(builder)),
+    labeled(labeled),
+    shuffle(false),
+    chunkBegin(0)
+{
+  // Nothing to do; the first chunk is loaded when it is needed.
+}
+
+template<typename FunctionType, typename eT>
+double StreamingFunction<FunctionType, eT>::Evaluate(
+    const arma::mat& coordinates,
+    const size_t begin,
+    const size_t batchSize)
+{
+  double objective = 0.0;
+  size_t point = begin;
+  while (point < begin + batchSize)
+  {
+    const size_t count = std::min(Seek(point), begin + batchSize - point);
+    objective += function->Evaluate(coordinates, point - chunkBegin, count);
+    point += count;
+  }
+
+  return objective;
+}
+
+template<typename FunctionType, typename eT>
+void StreamingFunction<FunctionType, eT>::Gradient(
+    const arma::mat& coordinates,
+    const size_t begin,
+    arma::mat& gradient,
+    const size_t batchSize)
+{
+  size_t count = std::min(Seek(begin), batchSize);
+  function->Gradient(coordinates, begin - chunkBegin, gradient, count);
+
+  // If the batch continues into the next chunk, add the gradient of the rest.
+  size_t point = begin + count;
+  arma::mat partialGradient;
+  while (point < begin + batchSize)
+  {
+    count = std::min(Seek(point), begin + batchSize - point);
+    function->Gradient(coordinates, point - chunkBegin, partialGradient,
+        count);
+    gradient += partialGradient;
+    point += count;
+  }
+}
+
+template<typename FunctionType, typename eT>
+size_t StreamingFunction<FunctionType, eT>::Seek(const size_t point)
+{
+  if (function && point >= chunkBegin && point < chunkBegin + points.n_cols)
+    return chunkBegin + points.n_cols - point;
+
+  // Going backwards means starting a new pass over the data.
+  size_t nextBegin = chunkBegin + points.n_cols;
+  if (!function || point < chunkBegin)
+  {
+    dataset.Reset();
+    nextBegin = 0;
+  }
+
+  // The old function may hold aliases to the chunk, so it goes first.
+  function.reset();
+  do
+  {
+    const bool read = labeled ? dataset.Next(points, labels) :
+        dataset.Next(points);
+    if (!read)
+    {
+      std::ostringstream oss;
+      oss << "StreamingFunction::Seek(): point " << point << " requested, "
+          << "but the dataset only has " << dataset.NumPoints() << " points!";
+      throw std::out_of_range(oss.str());
+    }
+
+    chunkBegin = nextBegin;
+    nextBegin += points.n_cols;
+  } while (point >= nextBegin);
+
+  function.reset(new FunctionType(builder(points, labels)));
+  if (shuffle)
+    function->Shuffle();
+
+  return nextBegin - point;
+}
+
+} // namespace optimization
+} // namespace mlpack
+
+#endif
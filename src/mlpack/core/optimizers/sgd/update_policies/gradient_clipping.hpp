@@ -93,6 +93,17 @@ class GradientClipping
   //! Modify the maximum gradient value.
   double& MaxGradient() { return maxGradient; }
 
+  /**
+   * Serialize the update policy (for checkpoints of the optimization).
+   */
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */)
+  {
+    ar & BOOST_SERIALIZATION_NVP(minGradient);
+    ar & BOOST_SERIALIZATION_NVP(maxGradient);
+    ar & BOOST_SERIALIZATION_NVP(updatePolicy);
+  }
+
  private:
   //! Minimum possible value of gradient element.
   double minGradient;
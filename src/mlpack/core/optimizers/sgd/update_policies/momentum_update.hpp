@@ -104,6 +104,16 @@ class MomentumUpdate
     iterate += velocity;
   }
 
+  /**
+   * Serialize the update policy (for checkpoints of the optimization).
+   */
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */)
+  {
+    ar & BOOST_SERIALIZATION_NVP(momentum);
+    ar & BOOST_SERIALIZATION_NVP(velocity);
+  }
+
  private:
   // The momentum hyperparamter
   double momentum;
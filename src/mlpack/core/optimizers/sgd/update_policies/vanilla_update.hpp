@@ -57,6 +57,15 @@ class VanillaUpdate
     // Perform the vanilla SGD update.
     iterate -= stepSize * gradient;
   }
+
+  /**
+   * Serialize the update policy (for checkpoints of the optimization).
+   */
+  template<typename Archive>
+  void serialize(Archive& /* ar */, const unsigned int /* version */)
+  {
+    // Nothing to do; the policy has no state.
+  }
 };
 
 } // namespace optimization
@@ -71,9 +71,10 @@ class CyclicalDecay
    * @param stepSize Step size to be used for the given iteration.
    * @param gradient The gradient matrix.
    */
+  template<typename GradType>
   void Update(arma::mat& /* iterate */,
               double& stepSize,
-              const arma::mat& /* gradient */)
+              const GradType& /* gradient */)
   {
     // Time to adjust the step size.
     if (epoch >= epochRestart)
@@ -111,6 +112,21 @@ class CyclicalDecay
   //! Modify the restart fraction.
   double& EpochBatches() { return epochBatches; }
 
+  /**
+   * Serialize the decay policy (for checkpoints of the optimization).
+   */
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */)
+  {
+    ar & BOOST_SERIALIZATION_NVP(epochRestart);
+    ar & BOOST_SERIALIZATION_NVP(multFactor);
+    ar & BOOST_SERIALIZATION_NVP(constStepSize);
+    ar & BOOST_SERIALIZATION_NVP(nextRestart);
+    ar & BOOST_SERIALIZATION_NVP(batchRestart);
+    ar & BOOST_SERIALIZATION_NVP(epochBatches);
+    ar & BOOST_SERIALIZATION_NVP(epoch);
+  }
+
  private:
   //! Epoch where decay is applied.
   size_t epochRestart;
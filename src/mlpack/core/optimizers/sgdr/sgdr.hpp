@@ -127,6 +127,16 @@ class SGDR
     return optimizer.UpdatePolicy();
   }
 
+  //! Get the checkpoint settings (a checkpoint is saved every Interval()
+  //! passes over the data).
+  const OptimizerCheckpoint& Checkpoint() const
+  {
+    return optimizer.Checkpoint();
+  }
+  //! Modify the checkpoint settings (a checkpoint is saved every Interval()
+  //! passes over the data).
+  OptimizerCheckpoint& Checkpoint() { return optimizer.Checkpoint(); }
+
  private:
   //! The size of each mini-batch.
   size_t batchSize;
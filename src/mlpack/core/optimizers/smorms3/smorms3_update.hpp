@@ -96,6 +96,18 @@ class SMORMS3Update
   //! Modify the value used to initialise the mean squared gradient parameter.
   double& Epsilon() { return epsilon; }
 
+  /**
+   * Serialize the update policy (for checkpoints of the optimization).
+   */
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */)
+  {
+    ar & BOOST_SERIALIZATION_NVP(epsilon);
+    ar & BOOST_SERIALIZATION_NVP(mem);
+    ar & BOOST_SERIALIZATION_NVP(g);
+    ar & BOOST_SERIALIZATION_NVP(g2);
+  }
+
  private:
   //! The value used to initialise the mean squared gradient parameter.
   double epsilon;
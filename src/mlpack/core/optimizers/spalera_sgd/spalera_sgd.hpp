@@ -15,6 +15,7 @@
 #include <mlpack/prereqs.hpp>
 #include <mlpack/core/optimizers/spalera_sgd/spalera_stepsize.hpp>
 #include <mlpack/core/optimizers/sgd/decay_policies/no_decay.hpp>
+#include <mlpack/core/optimizers/evaluate_with_gradient.hpp>
 
 namespace mlpack {
 namespace optimization {
@@ -80,6 +81,16 @@ namespace optimization {
  * function on the first point in the dataset (presumably, the dataset is held
  * internally in the DecomposableFunctionType).
  *
+ * If the class also implements
+ *
+ *   double EvaluateWithGradient(const arma::mat& coordinates,
+ *                               const size_t i,
+ *                               arma::mat& gradient,
+ *                               const size_t batchSize);
+ *
+ * then it is used to compute the objective and the gradient of each batch in
+ * one pass.
+ *
  * @tparam DecayPolicyType Decay policy used during the iterative update
  *     process to adjust the step size. By default the step size isn't going to
  *     be adjusted.
@@ -112,7 +112,11 @@ double SPALeRASGD<DecayPolicyType>::Optimize(DecomposableFunctionType& function,
     const size_t effectiveBatchSize = std::min(batchSize,
         numFunctions - currentFunction);
 
-    function.Gradient(iterate, currentFunction, gradient, effectiveBatchSize);
+    // The objective of the batch is taken at the point its gradient is taken
+    // at, so that both can be computed together.
+    const double batchObjective = EvaluateWithGradient(function, iterate,
+        currentFunction, gradient, effectiveBatchSize);
+    currentObjective = batchObjective / effectiveBatchSize;
 
     // Use the update policy to take a step.
     if (!updatePolicy.Update(stepSize, currentObjective, effectiveBatchSize,
@@ -124,16 +128,12 @@ double SPALeRASGD<DecayPolicyType>::Optimize(DecomposableFunctionType& function,
         return overallObjective;
     }
 
-    currentObjective = function.Evaluate(iterate, currentFunction,
-        effectiveBatchSize);
-
     // Now update the learning rate if requested by the user.
     decayPolicy.Update(iterate, stepSize, gradient);
 
     i += effectiveBatchSize;
     currentFunction += effectiveBatchSize;
-    overallObjective += currentObjective;
-    currentObjective /= effectiveBatchSize;
+    overallObjective += batchObjective;
   }
 
   Log::Info << "SPALeRA SGD: maximum iterations (" << maxIterations
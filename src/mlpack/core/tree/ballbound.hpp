@@ -118,6 +118,18 @@ class BallBound
    */
   void Center(VecType& center) const { center = this->center; }
 
+  /**
+   * Place the center of BallBound into the given vector, which holds elements
+   * of a different type.
+   *
+   * @param center Vector which the centroid will be written to.
+   */
+  template<typename OtherVecType>
+  void Center(OtherVecType& center) const
+  {
+    center = arma::conv_to<OtherVecType>::from(this->center);
+  }
+
   /**
    * Calculates minimum bound-to-point squared distance.
    */
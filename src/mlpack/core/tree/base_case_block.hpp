@@ -0,0 +1,82 @@
+/**
+ * @file base_case_block.hpp
+ *
+ * A utility for tree traversers to evaluate the base cases between one query
+ * point and a contiguous block of reference points at once, if the RuleType
+ * supports it.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_BASE_CASE_BLOCK_HPP
+#define MLPACK_CORE_TREE_BASE_CASE_BLOCK_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/util/sfinae_utility.hpp>
+
+namespace mlpack {
+namespace tree {
+
+HAS_MEM_FUNC(BaseCaseBlock, HasBaseCaseBlockCheck);
+
+/**
+ * Whether or not the given RuleType has a method
+ *
+ * @code
+ * void BaseCaseBlock(const size_t queryIndex,
+ *                    const size_t referenceBegin,
+ *                    const size_t referenceCount);
+ * @endcode
+ *
+ * which is equivalent to calling BaseCase(queryIndex, referenceIndex) for each
+ * point of the block of referenceCount points starting at referenceBegin (and
+ * is presumably faster).
+ */
+template<typename RuleType>
+struct HasBaseCaseBlock
+{
+  static const bool value = HasBaseCaseBlockCheck<RuleType,
+      void(RuleType::*)(const size_t, const size_t, const size_t)>::value;
+};
+
+/**
+ * Evaluate the base cases between the given query point and each of the given
+ * block of reference points, using the RuleType's BaseCaseBlock() method.
+ */
+template<typename RuleType>
+inline force_inline void BaseCaseBlock(
+    RuleType& rule,
+    const size_t queryIndex,
+    const size_t referenceBegin,
+    const size_t referenceCount,
+    const typename std::enable_if<
+        HasBaseCaseBlock<RuleType>::value>::type* = 0)
+{
+  rule.BaseCaseBlock(queryIndex, referenceBegin, referenceCount);
+}
+
+/**
+ * Evaluate the base cases between the given query point and each of the given
+ * block of reference points one by one, for a RuleType that has no
+ * BaseCaseBlock() method.
+ */
+template<typename RuleType>
+inline force_inline void BaseCaseBlock(
+    RuleType& rule,
+    const size_t queryIndex,
+    const size_t referenceBegin,
+    const size_t referenceCount,
+    const typename std::enable_if<
+        !HasBaseCaseBlock<RuleType>::value>::type* = 0)
+{
+  const size_t referenceEnd = referenceBegin + referenceCount;
+  for (size_t i = referenceBegin; i < referenceEnd; ++i)
+    rule.BaseCase(queryIndex, i);
+}
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
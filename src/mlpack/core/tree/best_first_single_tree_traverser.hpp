@@ -0,0 +1,109 @@
+/**
+ * @file best_first_single_tree_traverser.hpp
+ *
+ * A single-tree traverser which always visits the node with the best score
+ * among all the nodes that have been scored so far (not only the children of
+ * the current node), and can stop after a maximum number of visited nodes.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_BEST_FIRST_SINGLE_TREE_TRAVERSER_HPP
+#define MLPACK_CORE_TREE_BEST_FIRST_SINGLE_TREE_TRAVERSER_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * The BestFirstSingleTreeTraverser keeps the nodes it has scored (starting with
+ * the root) in a min-heap ordered by score, and always visits the one with the
+ * lowest score next; the node is rescored before it is visited, since the rules
+ * may have found better results in the meantime.  For nearest neighbor search,
+ * where the score of a node is the distance between the query point and its
+ * bound, good candidates are found early, so more nodes are pruned than by a
+ * depth-first traversal.
+ *
+ * If a maximum number of visits is given, the traversal stops once that many
+ * nodes have been visited, and the remaining nodes are counted as pruned; the
+ * results are then approximate, but the time of each query is bounded.
+ *
+ * Any tree type with NumChildren(), Child(), NumPoints() and Point() can be
+ * traversed; the base cases are evaluated for the points held by each visited
+ * node.
+ */
+template<typename TreeType, typename RuleType>
+class BestFirstSingleTreeTraverser
+{
+ public:
+  /**
+   * Instantiate the best-first single tree traverser with the given rule set.
+   *
+   * @param rule Rules with which the tree will be traversed.
+   * @param maxVisits Maximum number of nodes to visit for each query point (0
+   *     means no limit).
+   */
+  BestFirstSingleTreeTraverser(RuleType& rule, const size_t maxVisits = 0);
+
+  /**
+   * Traverse the tree with the given point.
+   *
+   * @param queryIndex The index of the point in the query set which is being
+   *     used as the query point.
+   * @param referenceNode The tree node to be traversed.
+   */
+  void Traverse(const size_t queryIndex, TreeType& referenceNode);
+
+  //! Get the number of prunes.
+  size_t NumPrunes() const { return numPrunes; }
+  //! Modify the number of prunes.
+  size_t& NumPrunes() { return numPrunes; }
+
+  //! Get the maximum number of nodes to visit for each query point.
+  size_t MaxVisits() const { return maxVisits; }
+  //! Modify the maximum number of nodes to visit for each query point.
+  size_t& MaxVisits() { return maxVisits; }
+
+ private:
+  //! A node that has been scored but not visited yet.
+  struct HeapEntry
+  {
+    //! The node.
+    TreeType* node;
+    //! The score of the node.
+    double score;
+  };
+
+  //! Order the heap so that the entry with the lowest score is on top.
+  static bool HeapComparator(const HeapEntry& a, const HeapEntry& b)
+  {
+    return a.score > b.score;
+  }
+
+  //! Evaluate the base cases of the given node, and push its children.
+  void Visit(const size_t queryIndex, TreeType& node);
+
+  //! Reference to the rules with which the tree will be traversed.
+  RuleType& rule;
+
+  //! The maximum number of nodes to visit for each query point.
+  size_t maxVisits;
+
+  //! The number of nodes which have been pruned during traversal.
+  size_t numPrunes;
+
+  //! The heap of scored nodes, held in the class so that it isn't continually
+  //! being reallocated.
+  std::vector<HeapEntry> heap;
+};
+
+} // namespace tree
+} // namespace mlpack
+
+// Include implementation.
+#include "best_first_single_tree_traverser_impl.hpp"
+
+#endif
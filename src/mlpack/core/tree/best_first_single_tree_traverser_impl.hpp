@@ -0,0 +1,117 @@
+/**
+ * @file best_first_single_tree_traverser_impl.hpp
+ *
+ * Implementation of the BestFirstSingleTreeTraverser, which always visits the
+ * node with the best score among all the nodes that have been scored so far.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_BEST_FIRST_SINGLE_TREE_TRAVERSER_IMPL_HPP
+#define MLPACK_CORE_TREE_BEST_FIRST_SINGLE_TREE_TRAVERSER_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "best_first_single_tree_traverser.hpp"
+
+#include <algorithm>
+
+#include <mlpack/core/tree/tree_traits.hpp>
+
+namespace mlpack {
+namespace tree {
+
+template<typename TreeType, typename RuleType>
+BestFirstSingleTreeTraverser<TreeType, RuleType>::BestFirstSingleTreeTraverser(
+    RuleType& rule,
+    const size_t maxVisits) :
+    rule(rule),
+    maxVisits(maxVisits),
+    numPrunes(0)
+{ /* Nothing to do. */ }
+
+template<typename TreeType, typename RuleType>
+void BestFirstSingleTreeTraverser<TreeType, RuleType>::Traverse(
+    const size_t queryIndex,
+    TreeType& referenceNode)
+{
+  heap.clear();
+
+  // The root is scored like the other nodes, so that the rules can prepare
+  // their state for it.
+  HeapEntry root;
+  root.node = &referenceNode;
+  root.score = rule.Score(queryIndex, referenceNode);
+  if (root.score == DBL_MAX)
+  {
+    ++numPrunes;
+    return;
+  }
+  heap.push_back(root);
+
+  size_t numVisits = 0;
+  while (!heap.empty())
+  {
+    // Stop if the budget is spent; the nodes left are not visited.
+    if (maxVisits != 0 && numVisits >= maxVisits)
+    {
+      numPrunes += heap.size();
+      break;
+    }
+
+    std::pop_heap(heap.begin(), heap.end(), HeapComparator);
+    const HeapEntry entry = heap.back();
+    heap.pop_back();
+
+    // Is it still valid to visit this node?
+    if (rule.Rescore(queryIndex, *entry.node, entry.score) == DBL_MAX)
+    {
+      ++numPrunes;
+      continue;
+    }
+
+    Visit(queryIndex, *entry.node);
+    ++numVisits;
+  }
+}
+
+template<typename TreeType, typename RuleType>
+void BestFirstSingleTreeTraverser<TreeType, RuleType>::Visit(
+    const size_t queryIndex,
+    TreeType& node)
+{
+  // In trees with self-children whose first point is the centroid (like the
+  // cover tree), the rules evaluate the base case with the point of a node
+  // when they score it; evaluating it again later, once other base cases have
+  // been evaluated, could add the same neighbor twice.
+  if (!(TreeTraits<TreeType>::HasSelfChildren &&
+      TreeTraits<TreeType>::FirstPointIsCentroid))
+  {
+    // Run the base case as necessary for all the points in the node.
+    for (size_t i = 0; i < node.NumPoints(); ++i)
+      rule.BaseCase(queryIndex, node.Point(i));
+  }
+
+  // Score the children, and keep those that can't be pruned.
+  for (size_t i = 0; i < node.NumChildren(); ++i)
+  {
+    HeapEntry entry;
+    entry.node = &node.Child(i);
+    entry.score = rule.Score(queryIndex, *entry.node);
+
+    if (entry.score == DBL_MAX)
+    {
+      ++numPrunes;
+      continue;
+    }
+
+    heap.push_back(entry);
+    std::push_heap(heap.begin(), heap.end(), HeapComparator);
+  }
+}
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
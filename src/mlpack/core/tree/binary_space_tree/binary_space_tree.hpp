@@ -13,21 +13,47 @@
 
 #include <mlpack/prereqs.hpp>
 
+#include <unordered_map>
+
 #include "../statistic.hpp"
 #include "midpoint_split.hpp"
+#include "split_traits.hpp"
 
 namespace mlpack {
 namespace tree /** Trees and tree-building procedures. */ {
 
+/**
+ * The type of the bound of each node of a BinarySpaceTree with the given
+ * BoundType, MetricType and element type of the dataset.  The elements of the
+ * bound have the same type as the elements of the dataset, so that (for
+ * instance) the bounds of a tree built on an arma::fmat are also held in
+ * single precision.
+ */
+template<template<typename BoundMetricType, typename...> class BoundType,
+         typename MetricType,
+         typename ElemType>
+struct BinarySpaceTreeBound
+{
+  typedef BoundType<MetricType, ElemType> type;
+};
+
+//! BallBound is parameterized by the type of its center instead.
+template<typename MetricType, typename ElemType>
+struct BinarySpaceTreeBound<bound::BallBound, MetricType, ElemType>
+{
+  typedef bound::BallBound<MetricType, arma::Col<ElemType>> type;
+};
+
 /**
  * A binary space partitioning tree, such as a KD-tree or a ball tree.  Once the
  * bound and type of dataset is defined, the tree will construct itself.  Call
  * the constructor with the dataset to build the tree on, and the entire tree
  * will be built.
  *
- * This particular tree does not allow growth, so you cannot add or delete nodes
- * from it.  If you need to add or delete a node, the better procedure is to
- * rebuild the tree entirely.
+ * Points can be added to and removed from a built tree with InsertPoints() and
+ * DeletePoints(), which only modify the parts of the tree that contain the
+ * points; if many points change, it may still be better to rebuild the tree
+ * entirely.
  *
  * This tree does take one runtime parameter in the constructor, which is the
  * max leaf size to be used.
@@ -58,8 +84,11 @@ class BinarySpaceTree
   typedef MatType Mat;
   //! The type of element held in MatType.
   typedef typename MatType::elem_type ElemType;
+  //! The type of the bound of each node.
+  typedef typename BinarySpaceTreeBound<BoundType, MetricType, ElemType>::type
+      BoundObjectType;
 
-  typedef SplitType<BoundType<MetricType>, MatType> Split;
+  typedef SplitType<BoundObjectType, MatType> Split;
 
  private:
   //! The left child node.
@@ -75,7 +104,7 @@ class BinarySpaceTree
   //! children).
   size_t count;
   //! The bound object for this node.
-  BoundType<MetricType> bound;
+  BoundObjectType bound;
   //! Any extra data contained in the node.
   StatisticType stat;
   //! The distance from the centroid of this node to the centroid of the parent.
@@ -88,6 +117,11 @@ class BinarySpaceTree
   //! The dataset.  If we are the root of the tree, we own the dataset and must
   //! delete it.
   MatType* dataset;
+  //! If the nodes of the tree have been packed with PackNodes() and we are the
+  //! root, this is the block holding all the other nodes.
+  BinarySpaceTree* packedNodes;
+  //! The number of nodes held in packedNodes.
+  size_t numPackedNodes;
 
  public:
   //! A single-tree traverser for binary space trees; see
@@ -109,8 +143,13 @@ class BinarySpaceTree
    *
    * @param data Dataset to create tree from.  This will be copied!
    * @param maxLeafSize Size of each leaf in the tree.
+   * @param parallelCutoff Nodes holding at least this many points have their
+   *     children built in parallel (if OpenMP is available and SplitType allows
+   *     it; see SplitTraits).
    */
-  BinarySpaceTree(const MatType& data, const size_t maxLeafSize = 20);
+  BinarySpaceTree(const MatType& data,
+                  const size_t maxLeafSize = 20,
+                  const size_t parallelCutoff = 10000);
 
   /**
    * Construct this as the root node of a binary space tree using the given
@@ -123,10 +162,14 @@ class BinarySpaceTree
    * @param oldFromNew Vector which will be filled with the old positions for
    *     each new point.
    * @param maxLeafSize Size of each leaf in the tree.
+   * @param parallelCutoff Nodes holding at least this many points have their
+   *     children built in parallel (if OpenMP is available and SplitType allows
+   *     it; see SplitTraits).
    */
   BinarySpaceTree(const MatType& data,
                   std::vector<size_t>& oldFromNew,
-                  const size_t maxLeafSize = 20);
+                  const size_t maxLeafSize = 20,
+                  const size_t parallelCutoff = 10000);
 
   /**
    * Construct this as the root node of a binary space tree using the given
@@ -142,11 +185,15 @@ class BinarySpaceTree
    * @param newFromOld Vector which will be filled with the new positions for
    *     each old point.
    * @param maxLeafSize Size of each leaf in the tree.
+   * @param parallelCutoff Nodes holding at least this many points have their
+   *     children built in parallel (if OpenMP is available and SplitType allows
+   *     it; see SplitTraits).
    */
   BinarySpaceTree(const MatType& data,
                   std::vector<size_t>& oldFromNew,
                   std::vector<size_t>& newFromOld,
-                  const size_t maxLeafSize = 20);
+                  const size_t maxLeafSize = 20,
+                  const size_t parallelCutoff = 10000);
 
   /**
    * Construct this as the root node of a binary space tree using the given
@@ -156,9 +203,13 @@ class BinarySpaceTree
    *
    * @param data Dataset to create tree from.
    * @param maxLeafSize Size of each leaf in the tree.
+   * @param parallelCutoff Nodes holding at least this many points have their
+   *     children built in parallel (if OpenMP is available and SplitType allows
+   *     it; see SplitTraits).
    */
   BinarySpaceTree(MatType&& data,
-                  const size_t maxLeafSize = 20);
+                  const size_t maxLeafSize = 20,
+                  const size_t parallelCutoff = 10000);
 
   /**
    * Construct this as the root node of a binary space tree using the given
@@ -171,10 +222,14 @@ class BinarySpaceTree
    * @param oldFromNew Vector which will be filled with the old positions for
    *     each new point.
    * @param maxLeafSize Size of each leaf in the tree.
+   * @param parallelCutoff Nodes holding at least this many points have their
+   *     children built in parallel (if OpenMP is available and SplitType allows
+   *     it; see SplitTraits).
    */
   BinarySpaceTree(MatType&& data,
                   std::vector<size_t>& oldFromNew,
-                  const size_t maxLeafSize = 20);
+                  const size_t maxLeafSize = 20,
+                  const size_t parallelCutoff = 10000);
 
   /**
    * Construct this as the root node of a binary space tree using the given
@@ -190,11 +245,15 @@ class BinarySpaceTree
    * @param newFromOld Vector which will be filled with the new positions for
    *     each old point.
    * @param maxLeafSize Size of each leaf in the tree.
+   * @param parallelCutoff Nodes holding at least this many points have their
+   *     children built in parallel (if OpenMP is available and SplitType allows
+   *     it; see SplitTraits).
    */
   BinarySpaceTree(MatType&& data,
                   std::vector<size_t>& oldFromNew,
                   std::vector<size_t>& newFromOld,
-                  const size_t maxLeafSize = 20);
+                  const size_t maxLeafSize = 20,
+                  const size_t parallelCutoff = 10000);
 
   /**
    * Construct this node as a child of the given parent, starting at column
@@ -207,12 +266,15 @@ class BinarySpaceTree
    * @param count Number of points to use to construct tree.
    * @param splitter Instantiated node splitter object.
    * @param maxLeafSize Size of each leaf in the tree.
+   * @param parallelCutoff Nodes holding at least this many points have their
+   *     children built in parallel.
    */
   BinarySpaceTree(BinarySpaceTree* parent,
                   const size_t begin,
                   const size_t count,
-                  SplitType<BoundType<MetricType>, MatType>& splitter,
-                  const size_t maxLeafSize = 20);
+                  SplitType<BoundObjectType, MatType>& splitter,
+                  const size_t maxLeafSize = 20,
+                  const size_t parallelCutoff = 10000);
 
   /**
    * Construct this node as a child of the given parent, starting at column
@@ -232,13 +294,16 @@ class BinarySpaceTree
    *     each new point.
    * @param splitter Instantiated node splitter object.
    * @param maxLeafSize Size of each leaf in the tree.
+   * @param parallelCutoff Nodes holding at least this many points have their
+   *     children built in parallel.
    */
   BinarySpaceTree(BinarySpaceTree* parent,
                   const size_t begin,
                   const size_t count,
                   std::vector<size_t>& oldFromNew,
-                  SplitType<BoundType<MetricType>, MatType>& splitter,
-                  const size_t maxLeafSize = 20);
+                  SplitType<BoundObjectType, MatType>& splitter,
+                  const size_t maxLeafSize = 20,
+                  const size_t parallelCutoff = 10000);
 
   /**
    * Construct this node as a child of the given parent, starting at column
@@ -260,14 +325,17 @@ class BinarySpaceTree
    * @param newFromOld Vector which will be filled with the new positions for
    *     each old point.
    * @param maxLeafSize Size of each leaf in the tree.
+   * @param parallelCutoff Nodes holding at least this many points have their
+   *     children built in parallel.
    */
   BinarySpaceTree(BinarySpaceTree* parent,
                   const size_t begin,
                   const size_t count,
                   std::vector<size_t>& oldFromNew,
                   std::vector<size_t>& newFromOld,
-                  SplitType<BoundType<MetricType>, MatType>& splitter,
-                  const size_t maxLeafSize = 20);
+                  SplitType<BoundObjectType, MatType>& splitter,
+                  const size_t maxLeafSize = 20,
+                  const size_t parallelCutoff = 10000);
 
   /**
    * Create a binary space tree by copying the other tree.  Be careful!  This
@@ -300,10 +368,109 @@ class BinarySpaceTree
    */
   ~BinarySpaceTree();
 
+  /**
+   * Move all the descendants of this node (which must be the root of the tree)
+   * into a single contiguous block of memory, so that nodes which are visited
+   * together during traversals are close to each other in memory.  Usually a
+   * tree's nodes are allocated one by one and may be spread all over memory, so
+   * this can reduce cache misses considerably for large trees.  The nodes can
+   * either be ordered in van Emde Boas order (which is cache-oblivious: it is
+   * efficient for any cache size and for both single-tree and dual-tree
+   * traversals) or in breadth-first order.
+   *
+   * Pointers and references to any nodes other than the root are invalidated
+   * by this method.  The tree must not be modified structurally afterwards
+   * (i.e. children can't be deleted or replaced).  Copying the tree gives an
+   * unpacked tree; the nodes of a packed tree that is loaded from an archive
+   * are also not packed anymore.
+   *
+   * @param vanEmdeBoas If true, use van Emde Boas order; otherwise, use
+   *     breadth-first order.
+   */
+  void PackNodes(const bool vanEmdeBoas = true);
+
+  //! Return whether or not the nodes of this tree have been packed.
+  bool IsPacked() const { return packedNodes != NULL; }
+
+  /**
+   * Insert the given points into the tree, which must be the root and must not
+   * be packed.  Each point is passed down to the leaf whose bound is closest to
+   * it, expanding the bounds on the way, and the dataset is then reordered once
+   * so that every node still holds a contiguous range of points.  Leaves that
+   * hold more than maxLeafSize points afterwards are split, and any subtree
+   * that received more than rebuildFraction times its previous number of
+   * points is rebuilt from scratch, since its splits are likely not
+   * representative anymore.  The statistics of all modified nodes are
+   * recomputed.
+   *
+   * The mapping of the points is kept up to date: the i'th new point gets the
+   * index oldFromNew.size() + i (before insertion).  Pointers and references
+   * to nodes outside of the paths of the new points stay valid.
+   *
+   * @param points Points to insert.
+   * @param oldFromNew Mapping of the points in the dataset to their original
+   *     indices, as returned by the constructor.
+   * @param maxLeafSize Maximum number of points held in a leaf.
+   * @param rebuildFraction Relative growth above which a subtree is rebuilt.
+   */
+  void InsertPoints(const MatType& points,
+                    std::vector<size_t>& oldFromNew,
+                    const size_t maxLeafSize = 20,
+                    const double rebuildFraction = 0.5);
+
+  /**
+   * Insert the given points into the tree, which must be the root and must not
+   * be packed.  See the other overload for details.
+   *
+   * @param points Points to insert.
+   * @param maxLeafSize Maximum number of points held in a leaf.
+   * @param rebuildFraction Relative growth above which a subtree is rebuilt.
+   */
+  void InsertPoints(const MatType& points,
+                    const size_t maxLeafSize = 20,
+                    const double rebuildFraction = 0.5);
+
+  /**
+   * Remove the given points from the tree, which must be the root and must not
+   * be packed.  The points are given by their index in the dataset.  Deleted
+   * points are tombstoned: they are moved to the end of the dataset, after the
+   * points held by the root, so they are never visited again but the dataset
+   * keeps its size and the indices given by oldFromNew stay meaningful.  The
+   * bounds of the nodes that held the points are left as they are (they are
+   * still valid, just looser).  Nodes that end up holding no more than
+   * maxLeafSize points become leaves, empty children are removed, and any
+   * subtree that lost more than rebuildFraction of its points is rebuilt.  The
+   * statistics of all modified nodes are recomputed.
+   *
+   * @param points Indices of the points to remove, in the dataset.
+   * @param oldFromNew Mapping of the points in the dataset to their original
+   *     indices, as returned by the constructor.
+   * @param maxLeafSize Maximum number of points held in a leaf.
+   * @param rebuildFraction Fraction of removed points above which a subtree is
+   *     rebuilt.
+   */
+  void DeletePoints(const std::vector<size_t>& points,
+                    std::vector<size_t>& oldFromNew,
+                    const size_t maxLeafSize = 20,
+                    const double rebuildFraction = 0.5);
+
+  /**
+   * Remove the given points from the tree, which must be the root and must not
+   * be packed.  See the other overload for details.
+   *
+   * @param points Indices of the points to remove, in the dataset.
+   * @param maxLeafSize Maximum number of points held in a leaf.
+   * @param rebuildFraction Fraction of removed points above which a subtree is
+   *     rebuilt.
+   */
+  void DeletePoints(const std::vector<size_t>& points,
+                    const size_t maxLeafSize = 20,
+                    const double rebuildFraction = 0.5);
+
   //! Return the bound object for this node.
-  const BoundType<MetricType>& Bound() const { return bound; }
+  const BoundObjectType& Bound() const { return bound; }
   //! Return the bound object for this node.
-  BoundType<MetricType>& Bound() { return bound; }
+  BoundObjectType& Bound() { return bound; }
 
   //! Return the statistic object for this node.
   const StatisticType& Stat() const { return stat; }
@@ -498,9 +665,12 @@ class BinarySpaceTree
    *
    * @param maxLeafSize Maximum number of points held in a leaf.
    * @param splitter Instantiated SplitType object.
+   * @param parallelCutoff Minimum number of points in a node for its children
+   *     to be built in parallel.
    */
   void SplitNode(const size_t maxLeafSize,
-                 SplitType<BoundType<MetricType>, MatType>& splitter);
+                 SplitType<BoundObjectType, MatType>& splitter,
+                 const size_t parallelCutoff);
 
   /**
    * Splits the current node, assigning its left and right children recursively.
@@ -509,10 +679,32 @@ class BinarySpaceTree
    * @param oldFromNew Vector holding permuted indices.
    * @param maxLeafSize Maximum number of points held in a leaf.
    * @param splitter Instantiated SplitType object.
+   * @param parallelCutoff Minimum number of points in a node for its children
+   *     to be built in parallel.
    */
   void SplitNode(std::vector<size_t>& oldFromNew,
                  const size_t maxLeafSize,
-                 SplitType<BoundType<MetricType>, MatType>& splitter);
+                 SplitType<BoundObjectType, MatType>& splitter,
+                 const size_t parallelCutoff);
+
+  /**
+   * Build the children of this node, once its points have been split at
+   * splitCol.  If the node holds at least parallelCutoff points and SplitType
+   * allows it, the two children are built at the same time as OpenMP tasks.
+   *
+   * @param splitCol Index of the first point of the right child.
+   * @param oldFromNew Vector holding permuted indices (or NULL, if the indices
+   *     aren't tracked).
+   * @param maxLeafSize Maximum number of points held in a leaf.
+   * @param splitter Instantiated SplitType object.
+   * @param parallelCutoff Minimum number of points in a node for its children
+   *     to be built in parallel.
+   */
+  void BuildChildren(const size_t splitCol,
+                     std::vector<size_t>* oldFromNew,
+                     const size_t maxLeafSize,
+                     SplitType<BoundObjectType, MatType>& splitter,
+                     const size_t parallelCutoff);
 
   /**
    * Update the bound of the current node. This method does not take into
@@ -529,7 +721,105 @@ class BinarySpaceTree
    *
    * @param boundToUpdate The bound to update.
    */
-  void UpdateBound(bound::HollowBallBound<MetricType>& boundToUpdate);
+  void UpdateBound(bound::HollowBallBound<MetricType, ElemType>& boundToUpdate);
+
+  /**
+   * Append the nodes of the subtree rooted at the given node, limited to the
+   * given number of levels, to the given list in van Emde Boas order.
+   *
+   * @param node Root of the subtree.
+   * @param levels Number of levels of the subtree to consider.
+   * @param order List to append the nodes to.
+   */
+  static void VanEmdeBoasOrder(BinarySpaceTree* node,
+                               const size_t levels,
+                               std::vector<BinarySpaceTree*>& order);
+
+  //! Destroy the packed nodes of the tree, if there are any.
+  void FreePackedNodes();
+
+  //! Throw an exception if this tree can't be modified by InsertPoints() or
+  //! DeletePoints().
+  void CheckModifiable(const char* function) const;
+
+  //! The new points assigned to each leaf by InsertPoints().
+  typedef std::unordered_map<const BinarySpaceTree*, std::vector<size_t>>
+      InsertionMap;
+  //! The number of points added to or removed from each modified node.
+  typedef std::unordered_map<const BinarySpaceTree*, size_t> ChangeMap;
+
+  /**
+   * Add the given new points to the leaves they have been assigned to and
+   * remove the given deleted points, reordering the dataset so that each node
+   * still holds a contiguous range of points, and then update the modified
+   * nodes.  This is the shared implementation of InsertPoints() and
+   * DeletePoints(); only one of newPoints and deleted may be non-empty.
+   *
+   * @param points New points.
+   * @param newPoints Indices of the new points assigned to each leaf.
+   * @param deleted Whether each point of the dataset is deleted (may be empty).
+   * @param oldFromNew Mapping of the points in the dataset.
+   * @param maxLeafSize Maximum number of points held in a leaf.
+   * @param rebuildFraction Relative change above which a subtree is rebuilt.
+   */
+  void ModifyPoints(const MatType& points,
+                    const InsertionMap& newPoints,
+                    const std::vector<bool>& deleted,
+                    std::vector<size_t>& oldFromNew,
+                    const size_t maxLeafSize,
+                    const double rebuildFraction);
+
+  /**
+   * Copy the points of this subtree into the given matrix starting at the
+   * given offset, adding the given new points to the leaves they have been
+   * assigned to and skipping the given deleted points, and update begin and
+   * count accordingly.  The number of points added to (or removed from) each
+   * node is recorded in 'changes'.
+   *
+   * @param newDataset Matrix to copy the points into.
+   * @param newOldFromNew Mapping of the points in newDataset.
+   * @param oldFromNew Mapping of the points in the current dataset.
+   * @param points New points.
+   * @param newPoints Indices of the new points assigned to each leaf.
+   * @param deleted Whether each point of the current dataset is deleted.
+   * @param tombstones List to append the indices of deleted points to.
+   * @param offset Where to copy the points of this subtree to; on return, the
+   *     end of its points.
+   * @param changes Number of points added to or removed from each node.
+   */
+  void Relayout(MatType& newDataset,
+                std::vector<size_t>& newOldFromNew,
+                const std::vector<size_t>& oldFromNew,
+                const MatType& points,
+                const InsertionMap& newPoints,
+                const std::vector<bool>& deleted,
+                std::vector<size_t>& tombstones,
+                size_t& offset,
+                ChangeMap& changes);
+
+  /**
+   * After the points of the tree have been changed by InsertPoints() or
+   * DeletePoints(), split, collapse or rebuild the modified nodes of this
+   * subtree as needed, and recompute their bounds, distances and statistics.
+   *
+   * @param changes Number of points added to or removed from each node.
+   * @param inserted Whether points were inserted (or removed).
+   * @param oldFromNew Mapping of the points in the dataset.
+   * @param maxLeafSize Maximum number of points held in a leaf.
+   * @param rebuildFraction Relative change above which a subtree is rebuilt.
+   * @param splitter Instantiated SplitType object.
+   */
+  void UpdateModifiedNodes(
+      const ChangeMap& changes,
+      const bool inserted,
+      std::vector<size_t>& oldFromNew,
+      const size_t maxLeafSize,
+      const double rebuildFraction,
+      SplitType<BoundObjectType, MatType>& splitter);
+
+  //! Recompute the distances from the center of this node to the centers of
+  //! its children.
+  void UpdateParentDistances();
 
  protected:
   /**
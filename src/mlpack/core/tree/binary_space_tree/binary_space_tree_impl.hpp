@@ -17,6 +17,7 @@
 #include <mlpack/core/util/cli.hpp>
 #include <mlpack/core/util/log.hpp>
 #include <queue>
+#include <unordered_map>
 
 namespace mlpack {
 namespace tree {
@@ -32,7 +33,8 @@ template<typename MetricType,
 BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
 BinarySpaceTree(
     const MatType& data,
-    const size_t maxLeafSize) :
+    const size_t maxLeafSize,
+    const size_t parallelCutoff) :
     left(NULL),
     right(NULL),
     parent(NULL),
@@ -40,11 +42,13 @@ BinarySpaceTree(
     count(data.n_cols), /* and spans all of the dataset. */
     bound(data.n_rows),
     parentDistance(0), // Parent distance for the root is 0: it has no parent.
-    dataset(new MatType(data)) // Copies the dataset.
+    dataset(new MatType(data)), // Copies the dataset.
+    packedNodes(NULL),
+    numPackedNodes(0)
 {
   // Do the actual splitting of this node.
-  SplitType<BoundType<MetricType>, MatType> splitter;
-  SplitNode(maxLeafSize, splitter);
+  SplitType<BoundObjectType, MatType> splitter;
+  SplitNode(maxLeafSize, splitter, parallelCutoff);
 
   // Create the statistic depending on if we are a leaf or not.
   stat = StatisticType(*this);
@@ -60,7 +64,8 @@ BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
 BinarySpaceTree(
     const MatType& data,
     std::vector<size_t>& oldFromNew,
-    const size_t maxLeafSize) :
+    const size_t maxLeafSize,
+    const size_t parallelCutoff) :
     left(NULL),
     right(NULL),
     parent(NULL),
@@ -68,7 +73,9 @@ BinarySpaceTree(
     count(data.n_cols),
     bound(data.n_rows),
     parentDistance(0), // Parent distance for the root is 0: it has no parent.
-    dataset(new MatType(data)) // Copies the dataset.
+    dataset(new MatType(data)), // Copies the dataset.
+    packedNodes(NULL),
+    numPackedNodes(0)
 {
   // Initialize oldFromNew correctly.
   oldFromNew.resize(data.n_cols);
@@ -76,8 +83,8 @@ BinarySpaceTree(
     oldFromNew[i] = i; // Fill with unharmed indices.
 
   // Now do the actual splitting.
-  SplitType<BoundType<MetricType>, MatType> splitter;
-  SplitNode(oldFromNew, maxLeafSize, splitter);
+  SplitType<BoundObjectType, MatType> splitter;
+  SplitNode(oldFromNew, maxLeafSize, splitter, parallelCutoff);
 
   // Create the statistic depending on if we are a leaf or not.
   stat = StatisticType(*this);
@@ -94,7 +101,8 @@ BinarySpaceTree(
     const MatType& data,
     std::vector<size_t>& oldFromNew,
     std::vector<size_t>& newFromOld,
-    const size_t maxLeafSize) :
+    const size_t maxLeafSize,
+    const size_t parallelCutoff) :
     left(NULL),
     right(NULL),
     parent(NULL),
@@ -102,7 +110,9 @@ BinarySpaceTree(
     count(data.n_cols),
     bound(data.n_rows),
     parentDistance(0), // Parent distance for the root is 0: it has no parent.
-    dataset(new MatType(data)) // Copies the dataset.
+    dataset(new MatType(data)), // Copies the dataset.
+    packedNodes(NULL),
+    numPackedNodes(0)
 {
   // Initialize the oldFromNew vector correctly.
   oldFromNew.resize(data.n_cols);
@@ -110,8 +120,8 @@ BinarySpaceTree(
     oldFromNew[i] = i; // Fill with unharmed indices.
 
   // Now do the actual splitting.
-  SplitType<BoundType<MetricType>, MatType> splitter;
-  SplitNode(oldFromNew, maxLeafSize, splitter);
+  SplitType<BoundObjectType, MatType> splitter;
+  SplitNode(oldFromNew, maxLeafSize, splitter, parallelCutoff);
 
   // Create the statistic depending on if we are a leaf or not.
   stat = StatisticType(*this);
@@ -129,7 +139,9 @@ template<typename MetricType,
          template<typename SplitBoundType, typename SplitMatType>
              class SplitType>
 BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
-BinarySpaceTree(MatType&& data, const size_t maxLeafSize) :
+BinarySpaceTree(MatType&& data,
+                const size_t maxLeafSize,
+                const size_t parallelCutoff) :
     left(NULL),
     right(NULL),
     parent(NULL),
@@ -137,11 +149,13 @@ BinarySpaceTree(MatType&& data, const size_t maxLeafSize) :
     count(data.n_cols),
     bound(data.n_rows),
     parentDistance(0), // Parent distance for the root is 0: it has no parent.
-    dataset(new MatType(std::move(data)))
+    dataset(new MatType(std::move(data))),
+    packedNodes(NULL),
+    numPackedNodes(0)
 {
   // Do the actual splitting of this node.
-  SplitType<BoundType<MetricType>, MatType> splitter;
-  SplitNode(maxLeafSize, splitter);
+  SplitType<BoundObjectType, MatType> splitter;
+  SplitNode(maxLeafSize, splitter, parallelCutoff);
 
   // Create the statistic depending on if we are a leaf or not.
   stat = StatisticType(*this);
@@ -157,7 +171,8 @@ BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
 BinarySpaceTree(
     MatType&& data,
     std::vector<size_t>& oldFromNew,
-    const size_t maxLeafSize) :
+    const size_t maxLeafSize,
+    const size_t parallelCutoff) :
     left(NULL),
     right(NULL),
     parent(NULL),
@@ -165,7 +180,9 @@ BinarySpaceTree(
     count(data.n_cols),
     bound(data.n_rows),
     parentDistance(0), // Parent distance for the root is 0: it has no parent.
-    dataset(new MatType(std::move(data)))
+    dataset(new MatType(std::move(data))),
+    packedNodes(NULL),
+    numPackedNodes(0)
 {
   // Initialize oldFromNew correctly.
   oldFromNew.resize(dataset->n_cols);
@@ -173,8 +190,8 @@ BinarySpaceTree(
     oldFromNew[i] = i; // Fill with unharmed indices.
 
   // Now do the actual splitting.
-  SplitType<BoundType<MetricType>, MatType> splitter;
-  SplitNode(oldFromNew, maxLeafSize, splitter);
+  SplitType<BoundObjectType, MatType> splitter;
+  SplitNode(oldFromNew, maxLeafSize, splitter, parallelCutoff);
 
   // Create the statistic depending on if we are a leaf or not.
   stat = StatisticType(*this);
@@ -191,7 +208,8 @@ BinarySpaceTree(
     MatType&& data,
     std::vector<size_t>& oldFromNew,
     std::vector<size_t>& newFromOld,
-    const size_t maxLeafSize) :
+    const size_t maxLeafSize,
+    const size_t parallelCutoff) :
     left(NULL),
     right(NULL),
     parent(NULL),
@@ -199,7 +217,9 @@ BinarySpaceTree(
     count(data.n_cols),
     bound(data.n_rows),
     parentDistance(0), // Parent distance for the root is 0: it has no parent.
-    dataset(new MatType(std::move(data)))
+    dataset(new MatType(std::move(data))),
+    packedNodes(NULL),
+    numPackedNodes(0)
 {
   // Initialize the oldFromNew vector correctly.
   oldFromNew.resize(dataset->n_cols);
@@ -207,8 +227,8 @@ BinarySpaceTree(
     oldFromNew[i] = i; // Fill with unharmed indices.
 
   // Now do the actual splitting.
-  SplitType<BoundType<MetricType>, MatType> splitter;
-  SplitNode(oldFromNew, maxLeafSize, splitter);
+  SplitType<BoundObjectType, MatType> splitter;
+  SplitNode(oldFromNew, maxLeafSize, splitter, parallelCutoff);
 
   // Create the statistic depending on if we are a leaf or not.
   stat = StatisticType(*this);
@@ -230,18 +250,21 @@ BinarySpaceTree(
     BinarySpaceTree* parent,
     const size_t begin,
     const size_t count,
-    SplitType<BoundType<MetricType>, MatType>& splitter,
-    const size_t maxLeafSize) :
+    SplitType<BoundObjectType, MatType>& splitter,
+    const size_t maxLeafSize,
+    const size_t parallelCutoff) :
     left(NULL),
     right(NULL),
     parent(parent),
     begin(begin),
     count(count),
     bound(parent->Dataset().n_rows),
-    dataset(&parent->Dataset()) // Point to the parent's dataset.
+    dataset(&parent->Dataset()), // Point to the parent's dataset.
+    packedNodes(NULL),
+    numPackedNodes(0)
 {
   // Perform the actual splitting.
-  SplitNode(maxLeafSize, splitter);
+  SplitNode(maxLeafSize, splitter, parallelCutoff);
 
   // Create the statistic depending on if we are a leaf or not.
   stat = StatisticType(*this);
@@ -259,22 +282,25 @@ BinarySpaceTree(
     const size_t begin,
     const size_t count,
     std::vector<size_t>& oldFromNew,
-    SplitType<BoundType<MetricType>, MatType>& splitter,
-    const size_t maxLeafSize) :
+    SplitType<BoundObjectType, MatType>& splitter,
+    const size_t maxLeafSize,
+    const size_t parallelCutoff) :
     left(NULL),
     right(NULL),
     parent(parent),
     begin(begin),
     count(count),
     bound(parent->Dataset().n_rows),
-    dataset(&parent->Dataset())
+    dataset(&parent->Dataset()),
+    packedNodes(NULL),
+    numPackedNodes(0)
 {
   // Hopefully the vector is initialized correctly!  We can't check that
   // entirely but we can do a minor sanity check.
   assert(oldFromNew.size() == dataset->n_cols);
 
   // Perform the actual splitting.
-  SplitNode(oldFromNew, maxLeafSize, splitter);
+  SplitNode(oldFromNew, maxLeafSize, splitter, parallelCutoff);
 
   // Create the statistic depending on if we are a leaf or not.
   stat = StatisticType(*this);
@@ -293,22 +319,25 @@ BinarySpaceTree(
     const size_t count,
     std::vector<size_t>& oldFromNew,
     std::vector<size_t>& newFromOld,
-    SplitType<BoundType<MetricType>, MatType>& splitter,
-    const size_t maxLeafSize) :
+    SplitType<BoundObjectType, MatType>& splitter,
+    const size_t maxLeafSize,
+    const size_t parallelCutoff) :
     left(NULL),
     right(NULL),
     parent(parent),
     begin(begin),
     count(count),
     bound(parent->Dataset()->n_rows),
-    dataset(&parent->Dataset())
+    dataset(&parent->Dataset()),
+    packedNodes(NULL),
+    numPackedNodes(0)
 {
   // Hopefully the vector is initialized correctly!  We can't check that
   // entirely but we can do a minor sanity check.
   Log::Assert(oldFromNew.size() == dataset->n_cols);
 
   // Perform the actual splitting.
-  SplitNode(oldFromNew, maxLeafSize, splitter);
+  SplitNode(oldFromNew, maxLeafSize, splitter, parallelCutoff);
 
   // Create the statistic depending on if we are a leaf or not.
   stat = StatisticType(*this);
@@ -342,7 +371,9 @@ BinarySpaceTree(
     parentDistance(other.parentDistance),
     furthestDescendantDistance(other.furthestDescendantDistance),
     // Copy matrix, but only if we are the root.
-    dataset((other.parent == NULL) ? new MatType(*other.dataset) : NULL)
+    dataset((other.parent == NULL) ? new MatType(*other.dataset) : NULL),
+    packedNodes(NULL),
+    numPackedNodes(0)
 {
   // Create left and right children (if any).
   if (other.Left())
@@ -400,7 +431,9 @@ BinarySpaceTree(BinarySpaceTree&& other) :
     parentDistance(other.parentDistance),
     furthestDescendantDistance(other.furthestDescendantDistance),
     minimumBoundDistance(other.minimumBoundDistance),
-    dataset(other.dataset)
+    dataset(other.dataset),
+    packedNodes(other.packedNodes),
+    numPackedNodes(other.numPackedNodes)
 {
   // Now we are a clone of the other tree.  But we must also clear the other
   // tree's contents, so it doesn't delete anything when it is destructed.
@@ -412,6 +445,8 @@ BinarySpaceTree(BinarySpaceTree&& other) :
   other.furthestDescendantDistance = 0.0;
   other.minimumBoundDistance = 0.0;
   other.dataset = NULL;
+  other.packedNodes = NULL;
+  other.numPackedNodes = 0;
 
   // Set new parent.
   if (left)
@@ -455,6 +490,8 @@ template<typename MetricType,
 BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
     ~BinarySpaceTree()
 {
+  FreePackedNodes();
+
   delete left;
   delete right;
 
@@ -463,6 +500,522 @@ BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
     delete dataset;
 }
 
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+    PackNodes(const bool vanEmdeBoas)
+{
+  if (parent != NULL)
+    throw std::invalid_argument("BinarySpaceTree::PackNodes(): only the root "
+        "of a tree can be packed");
+
+  // If the tree was already packed, the nodes are repacked; they'll be moved
+  // out of the old block before it is destroyed.
+  BinarySpaceTree* oldPackedNodes = packedNodes;
+
+  // Compute the order of the nodes.  In both orders a node always comes before
+  // its children.
+  std::vector<BinarySpaceTree*> order;
+  if (vanEmdeBoas)
+  {
+    // Find the height of the tree.
+    size_t height = 0;
+    std::queue<std::pair<BinarySpaceTree*, size_t>> queue;
+    queue.push(std::make_pair(this, 1));
+    while (!queue.empty())
+    {
+      BinarySpaceTree* node = queue.front().first;
+      const size_t level = queue.front().second;
+      queue.pop();
+
+      height = std::max(height, level);
+      if (node->left)
+        queue.push(std::make_pair(node->left, level + 1));
+      if (node->right)
+        queue.push(std::make_pair(node->right, level + 1));
+    }
+
+    VanEmdeBoasOrder(this, height, order);
+  }
+  else
+  {
+    std::queue<BinarySpaceTree*> queue;
+    queue.push(this);
+    while (!queue.empty())
+    {
+      BinarySpaceTree* node = queue.front();
+      queue.pop();
+
+      order.push_back(node);
+      if (node->left)
+        queue.push(node->left);
+      if (node->right)
+        queue.push(node->right);
+    }
+  }
+
+  // The root stays where it is.
+  const size_t numNodes = order.size() - 1;
+  if (numNodes == 0)
+    return;
+
+  BinarySpaceTree* nodes = static_cast<BinarySpaceTree*>(
+      ::operator new(numNodes * sizeof(BinarySpaceTree)));
+
+  // Move each node into its place.  Because parents are moved before their
+  // children, the move constructor takes care of the parent pointers; only the
+  // child pointers have to be fixed afterwards.
+  std::unordered_map<BinarySpaceTree*, BinarySpaceTree*> newFromOld;
+  newFromOld[this] = this;
+  for (size_t i = 0; i < numNodes; ++i)
+  {
+    BinarySpaceTree* oldNode = order[i + 1];
+    new (nodes + i) BinarySpaceTree(std::move(*oldNode));
+    newFromOld[oldNode] = nodes + i;
+
+    // The old node is now empty, so it can be destroyed without affecting any
+    // other nodes.
+    if (oldPackedNodes)
+      oldNode->~BinarySpaceTree();
+    else
+      delete oldNode;
+  }
+
+  for (size_t i = 0; i < order.size(); ++i)
+  {
+    BinarySpaceTree* node = newFromOld[order[i]];
+    if (node->left)
+      node->left = newFromOld[node->left];
+    if (node->right)
+      node->right = newFromOld[node->right];
+  }
+
+  if (oldPackedNodes)
+    ::operator delete(oldPackedNodes);
+
+  packedNodes = nodes;
+  numPackedNodes = numNodes;
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+    VanEmdeBoasOrder(BinarySpaceTree* node,
+                     const size_t levels,
+                     std::vector<BinarySpaceTree*>& order)
+{
+  if (levels == 1)
+  {
+    order.push_back(node);
+    return;
+  }
+
+  // Lay out the top half of the levels first, then each of the subtrees
+  // hanging from it.
+  const size_t topLevels = levels / 2;
+  VanEmdeBoasOrder(node, topLevels, order);
+
+  std::vector<BinarySpaceTree*> current(1, node);
+  for (size_t level = 0; level < topLevels; ++level)
+  {
+    std::vector<BinarySpaceTree*> next;
+    for (size_t i = 0; i < current.size(); ++i)
+    {
+      if (current[i]->left)
+        next.push_back(current[i]->left);
+      if (current[i]->right)
+        next.push_back(current[i]->right);
+    }
+    current.swap(next);
+  }
+
+  for (size_t i = 0; i < current.size(); ++i)
+    VanEmdeBoasOrder(current[i], levels - topLevels, order);
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+    FreePackedNodes()
+{
+  if (!packedNodes)
+    return;
+
+  // The packed nodes must not delete their children, since those are part of
+  // the same block.
+  for (size_t i = 0; i < numPackedNodes; ++i)
+  {
+    packedNodes[i].left = NULL;
+    packedNodes[i].right = NULL;
+    packedNodes[i].~BinarySpaceTree();
+  }
+  ::operator delete(packedNodes);
+
+  packedNodes = NULL;
+  numPackedNodes = 0;
+  left = NULL;
+  right = NULL;
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+    InsertPoints(const MatType& points,
+                 std::vector<size_t>& oldFromNew,
+                 const size_t maxLeafSize,
+                 const double rebuildFraction)
+{
+  CheckModifiable("InsertPoints");
+  if (points.n_rows != dataset->n_rows)
+    throw std::invalid_argument("BinarySpaceTree::InsertPoints(): the points "
+        "must have the same dimensionality as the dataset");
+  if (oldFromNew.size() != dataset->n_cols)
+    throw std::invalid_argument("BinarySpaceTree::InsertPoints(): the size of "
+        "oldFromNew must be the number of points in the dataset");
+
+  if (points.n_cols == 0)
+    return;
+
+  // Pass each point down to the leaf whose bound is closest to it, expanding
+  // the bounds on the way.
+  InsertionMap newPoints;
+  for (size_t i = 0; i < points.n_cols; ++i)
+  {
+    BinarySpaceTree* node = this;
+    node->bound |= points.cols(i, i);
+    while (!node->IsLeaf())
+    {
+      const ElemType leftDistance = node->left->bound.MinDistance(
+          points.col(i));
+      const ElemType rightDistance = node->right->bound.MinDistance(
+          points.col(i));
+
+      // If both children are equally close, prefer the smaller one.
+      if (leftDistance < rightDistance || (leftDistance == rightDistance &&
+          node->left->count <= node->right->count))
+        node = node->left;
+      else
+        node = node->right;
+
+      node->bound |= points.cols(i, i);
+    }
+
+    newPoints[node].push_back(i);
+  }
+
+  ModifyPoints(points, newPoints, std::vector<bool>(), oldFromNew, maxLeafSize,
+      rebuildFraction);
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+    InsertPoints(const MatType& points,
+                 const size_t maxLeafSize,
+                 const double rebuildFraction)
+{
+  // The mapping isn't needed, but it is easiest to just keep track of it.
+  std::vector<size_t> oldFromNew(dataset->n_cols);
+  for (size_t i = 0; i < oldFromNew.size(); ++i)
+    oldFromNew[i] = i;
+
+  InsertPoints(points, oldFromNew, maxLeafSize, rebuildFraction);
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+    DeletePoints(const std::vector<size_t>& points,
+                 std::vector<size_t>& oldFromNew,
+                 const size_t maxLeafSize,
+                 const double rebuildFraction)
+{
+  CheckModifiable("DeletePoints");
+  if (oldFromNew.size() != dataset->n_cols)
+    throw std::invalid_argument("BinarySpaceTree::DeletePoints(): the size of "
+        "oldFromNew must be the number of points in the dataset");
+
+  if (points.empty())
+    return;
+
+  // Points at or after the end of the root have already been deleted.
+  std::vector<bool> deleted(dataset->n_cols, false);
+  for (size_t i = 0; i < points.size(); ++i)
+  {
+    if (points[i] >= count)
+      throw std::invalid_argument("BinarySpaceTree::DeletePoints(): invalid "
+          "point index (or the point has already been deleted)");
+    deleted[points[i]] = true;
+  }
+
+  ModifyPoints(MatType(), InsertionMap(), deleted, oldFromNew, maxLeafSize,
+      rebuildFraction);
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+    DeletePoints(const std::vector<size_t>& points,
+                 const size_t maxLeafSize,
+                 const double rebuildFraction)
+{
+  // The mapping isn't needed, but it is easiest to just keep track of it.
+  std::vector<size_t> oldFromNew(dataset->n_cols);
+  for (size_t i = 0; i < oldFromNew.size(); ++i)
+    oldFromNew[i] = i;
+
+  DeletePoints(points, oldFromNew, maxLeafSize, rebuildFraction);
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+    CheckModifiable(const char* function) const
+{
+  if (parent != NULL)
+    throw std::invalid_argument(std::string("BinarySpaceTree::") + function +
+        "(): only the root of a tree can be modified");
+  if (packedNodes != NULL)
+    throw std::invalid_argument(std::string("BinarySpaceTree::") + function +
+        "(): the tree can't be modified after PackNodes() has been called");
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+    ModifyPoints(const MatType& points,
+                 const InsertionMap& newPoints,
+                 const std::vector<bool>& deleted,
+                 std::vector<size_t>& oldFromNew,
+                 const size_t maxLeafSize,
+                 const double rebuildFraction)
+{
+  // Build the new dataset in a single pass over the tree.
+  const size_t oldCount = count;
+  MatType newDataset(dataset->n_rows, dataset->n_cols + points.n_cols);
+  std::vector<size_t> newOldFromNew(newDataset.n_cols);
+  std::vector<size_t> tombstones;
+  ChangeMap changes;
+  size_t offset = 0;
+  Relayout(newDataset, newOldFromNew, oldFromNew, points, newPoints, deleted,
+      tombstones, offset, changes);
+
+  // The deleted points go after the points of the root: first the ones that
+  // had already been deleted, then the new ones.
+  for (size_t i = oldCount; i < dataset->n_cols; ++i)
+  {
+    newDataset.col(offset) = dataset->col(i);
+    newOldFromNew[offset++] = oldFromNew[i];
+  }
+  for (size_t i = 0; i < tombstones.size(); ++i)
+  {
+    newDataset.col(offset) = dataset->col(tombstones[i]);
+    newOldFromNew[offset++] = oldFromNew[tombstones[i]];
+  }
+
+  // All the nodes point to the same matrix, so it is modified in place.
+  *dataset = std::move(newDataset);
+  oldFromNew.swap(newOldFromNew);
+
+  SplitType<BoundObjectType, MatType> splitter;
+  UpdateModifiedNodes(changes, points.n_cols > 0, oldFromNew, maxLeafSize,
+      rebuildFraction, splitter);
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+    Relayout(MatType& newDataset,
+             std::vector<size_t>& newOldFromNew,
+             const std::vector<size_t>& oldFromNew,
+             const MatType& points,
+             const InsertionMap& newPoints,
+             const std::vector<bool>& deleted,
+             std::vector<size_t>& tombstones,
+             size_t& offset,
+             ChangeMap& changes)
+{
+  const size_t oldBegin = begin;
+  const size_t oldCount = count;
+  begin = offset;
+
+  if (IsLeaf())
+  {
+    for (size_t i = oldBegin; i < oldBegin + oldCount; ++i)
+    {
+      if (!deleted.empty() && deleted[i])
+      {
+        tombstones.push_back(i);
+        continue;
+      }
+
+      newDataset.col(offset) = dataset->col(i);
+      newOldFromNew[offset++] = oldFromNew[i];
+    }
+
+    // The new points get the next indices.
+    const typename InsertionMap::const_iterator it = newPoints.find(this);
+    if (it != newPoints.end())
+    {
+      for (size_t j = 0; j < it->second.size(); ++j)
+      {
+        newDataset.col(offset) = points.col(it->second[j]);
+        newOldFromNew[offset++] = oldFromNew.size() + it->second[j];
+      }
+    }
+  }
+  else
+  {
+    left->Relayout(newDataset, newOldFromNew, oldFromNew, points, newPoints,
+        deleted, tombstones, offset, changes);
+    right->Relayout(newDataset, newOldFromNew, oldFromNew, points, newPoints,
+        deleted, tombstones, offset, changes);
+  }
+
+  count = offset - begin;
+  if (count != oldCount)
+    changes[this] = (count > oldCount) ? count - oldCount : oldCount - count;
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+    UpdateModifiedNodes(const ChangeMap& changes,
+                        const bool inserted,
+                        std::vector<size_t>& oldFromNew,
+                        const size_t maxLeafSize,
+                        const double rebuildFraction,
+                        SplitType<BoundObjectType, MatType>& splitter)
+{
+  const typename ChangeMap::const_iterator it = changes.find(this);
+  if (it == changes.end())
+    return; // Nothing in this subtree has changed.
+
+  const size_t change = it->second;
+  const size_t oldCount = inserted ? count - change : count + change;
+
+  if (!IsLeaf() && (count <= maxLeafSize ||
+      change > rebuildFraction * oldCount))
+  {
+    // Either this node should be a leaf now, or so much of the subtree has
+    // changed that its splits are not representative anymore, so rebuild it.
+    // This also gives a tight bound again.
+    delete left;
+    delete right;
+    left = NULL;
+    right = NULL;
+
+    bound = BoundObjectType(dataset->n_rows);
+    SplitNode(oldFromNew, maxLeafSize, splitter,
+        std::numeric_limits<size_t>::max());
+  }
+  else if (IsLeaf())
+  {
+    // The bound already holds the new points; split the leaf if it is too big.
+    if (count > maxLeafSize)
+      SplitNode(oldFromNew, maxLeafSize, splitter,
+          std::numeric_limits<size_t>::max());
+  }
+  else
+  {
+    left->UpdateModifiedNodes(changes, inserted, oldFromNew, maxLeafSize,
+        rebuildFraction, splitter);
+    right->UpdateModifiedNodes(changes, inserted, oldFromNew, maxLeafSize,
+        rebuildFraction, splitter);
+
+    // Deleting points may have emptied one child; then this node takes the
+    // place of the other child.
+    if (left->count == 0 || right->count == 0)
+    {
+      BinarySpaceTree* child = (left->count == 0) ? right : left;
+      BinarySpaceTree* emptyChild = (left->count == 0) ? left : right;
+      delete emptyChild;
+
+      left = child->left;
+      right = child->right;
+      child->left = NULL;
+      child->right = NULL;
+      delete child;
+
+      if (left)
+      {
+        left->parent = this;
+        right->parent = this;
+      }
+    }
+
+    UpdateParentDistances();
+  }
+
+  furthestDescendantDistance = 0.5 * bound.Diameter();
+  stat = StatisticType(*this);
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+    UpdateParentDistances()
+{
+  if (!left)
+    return;
+
+  arma::vec center, leftCenter, rightCenter;
+  Center(center);
+  left->Center(leftCenter);
+  right->Center(rightCenter);
+
+  left->ParentDistance() = MetricType::Evaluate(center, leftCenter);
+  right->ParentDistance() = MetricType::Evaluate(center, rightCenter);
+}
+
 template<typename MetricType,
          typename StatisticType,
          typename MatType,
@@ -745,7 +1298,8 @@ template<typename MetricType,
              class SplitType>
 void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
     SplitNode(const size_t maxLeafSize,
-              SplitType<BoundType<MetricType>, MatType>& splitter)
+              SplitType<BoundObjectType, MatType>& splitter,
+              const size_t parallelCutoff)
 {
   // We need to expand the bounds of this node properly.
   UpdateBound(bound);
@@ -783,10 +1337,7 @@ void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
 
   // Now that we know the split column, we will recursively split the children
   // by calling their constructors (which perform this splitting process).
-  left = new BinarySpaceTree(this, begin, splitCol - begin, splitter,
-      maxLeafSize);
-  right = new BinarySpaceTree(this, splitCol, begin + count - splitCol,
-      splitter, maxLeafSize);
+  BuildChildren(splitCol, NULL, maxLeafSize, splitter, parallelCutoff);
 
   // Calculate parent distances for those two nodes.
   arma::vec center, leftCenter, rightCenter;
@@ -811,7 +1362,8 @@ template<typename MetricType,
 void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
 SplitNode(std::vector<size_t>& oldFromNew,
           const size_t maxLeafSize,
-          SplitType<BoundType<MetricType>, MatType>& splitter)
+          SplitType<BoundObjectType, MatType>& splitter,
+          const size_t parallelCutoff)
 {
   // We need to expand the bounds of this node properly.
   UpdateBound(bound);
@@ -850,10 +1402,7 @@ SplitNode(std::vector<size_t>& oldFromNew,
 
   // Now that we know the split column, we will recursively split the children
   // by calling their constructors (which perform this splitting process).
-  left = new BinarySpaceTree(this, begin, splitCol - begin, oldFromNew,
-      splitter, maxLeafSize);
-  right = new BinarySpaceTree(this, splitCol, begin + count - splitCol,
-      oldFromNew, splitter, maxLeafSize);
+  BuildChildren(splitCol, &oldFromNew, maxLeafSize, splitter, parallelCutoff);
 
   // Calculate parent distances for those two nodes.
   arma::vec center, leftCenter, rightCenter;
@@ -869,6 +1418,80 @@ SplitNode(std::vector<size_t>& oldFromNew,
   right->ParentDistance() = rightParentDistance;
 }
 
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+BuildChildren(const size_t splitCol,
+              std::vector<size_t>* oldFromNew,
+              const size_t maxLeafSize,
+              SplitType<BoundObjectType, MatType>& splitter,
+              const size_t parallelCutoff)
+{
+  const size_t leftCount = splitCol - begin;
+  const size_t rightCount = begin + count - splitCol;
+
+#if defined(HAS_OPENMP) && (_OPENMP >= 200805)
+  // The two children hold disjoint sets of points (and disjoint parts of
+  // oldFromNew), so they can be built at the same time.  OpenMP tasks (from
+  // OpenMP 3.0) are used, so that the children of the children can also be
+  // built in parallel.
+  if (SplitTraits<Split>::ParallelSafe && count >= parallelCutoff)
+  {
+    if (!omp_in_parallel())
+    {
+      // This is the first node that is built in parallel, so start the threads.
+      #pragma omp parallel
+      {
+        #pragma omp single
+        BuildChildren(splitCol, oldFromNew, maxLeafSize, splitter,
+            parallelCutoff);
+      }
+      return;
+    }
+
+    // The tasks get copies of the local variables, so use a pointer to the
+    // splitter.
+    Split* splitterPtr = &splitter;
+
+    #pragma omp task
+    left = (oldFromNew == NULL) ?
+        new BinarySpaceTree(this, begin, leftCount, *splitterPtr, maxLeafSize,
+            parallelCutoff) :
+        new BinarySpaceTree(this, begin, leftCount, *oldFromNew, *splitterPtr,
+            maxLeafSize, parallelCutoff);
+
+    #pragma omp task
+    right = (oldFromNew == NULL) ?
+        new BinarySpaceTree(this, splitCol, rightCount, *splitterPtr,
+            maxLeafSize, parallelCutoff) :
+        new BinarySpaceTree(this, splitCol, rightCount, *oldFromNew,
+            *splitterPtr, maxLeafSize, parallelCutoff);
+
+    #pragma omp taskwait
+    return;
+  }
+#endif
+
+  if (oldFromNew == NULL)
+  {
+    left = new BinarySpaceTree(this, begin, leftCount, splitter, maxLeafSize,
+        parallelCutoff);
+    right = new BinarySpaceTree(this, splitCol, rightCount, splitter,
+        maxLeafSize, parallelCutoff);
+  }
+  else
+  {
+    left = new BinarySpaceTree(this, begin, leftCount, *oldFromNew, splitter,
+        maxLeafSize, parallelCutoff);
+    right = new BinarySpaceTree(this, splitCol, rightCount, *oldFromNew,
+        splitter, maxLeafSize, parallelCutoff);
+  }
+}
+
 template<typename MetricType,
          typename StatisticType,
          typename MatType,
@@ -890,7 +1513,7 @@ template<typename MetricType,
          template<typename SplitBoundType, typename SplitMatType>
              class SplitType>
 void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
-UpdateBound(bound::HollowBallBound<MetricType>& boundToUpdate)
+UpdateBound(bound::HollowBallBound<MetricType, ElemType>& boundToUpdate)
 {
   if (!parent)
   {
@@ -926,7 +1549,9 @@ BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
     stat(*this),
     parentDistance(0),
     furthestDescendantDistance(0),
-    dataset(NULL)
+    dataset(NULL),
+    packedNodes(NULL),
+    numPackedNodes(0)
 {
   // Nothing to do.
 }
@@ -947,6 +1572,8 @@ void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
   // If we're loading, and we have children, they need to be deleted.
   if (Archive::is_loading::value)
   {
+    FreePackedNodes();
+
     if (left)
       delete left;
     if (right)
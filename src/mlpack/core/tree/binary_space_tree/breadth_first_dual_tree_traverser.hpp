@@ -16,7 +16,6 @@
 #define MLPACK_CORE_TREE_BINARY_SPACE_TREE_BF_DUAL_TREE_TRAVERSER_HPP
 
 #include <mlpack/prereqs.hpp>
-#include <queue>
 
 #include "../binary_space_tree.hpp"
 
@@ -53,7 +52,12 @@ class BinarySpaceTree<MetricType, StatisticType, MatType, BoundType,
       QueueFrameType;
 
   /**
-   * Traverse the two trees.  This does not reset the number of prunes.
+   * Traverse the two trees.  This does not reset the number of prunes.  The
+   * combinations of each query node are held in a heap, and the query nodes are
+   * handled depth-first with an explicit stack.  The heaps are kept in buffers
+   * that are reused between query nodes (two for each query depth) and between
+   * traversals, so that the traversal does not allocate memory once the
+   * buffers have grown.
    *
    * @param queryNode The query node to be traversed.
    * @param referenceNode The reference node to be traversed.
@@ -61,8 +65,6 @@ class BinarySpaceTree<MetricType, StatisticType, MatType, BoundType,
    */
   void Traverse(BinarySpaceTree& queryNode,
                 BinarySpaceTree& referenceNode);
-  void Traverse(BinarySpaceTree& queryNode,
-                std::priority_queue<QueueFrameType>& referenceQueue);
 
   //! Get the number of prunes.
   size_t NumPrunes() const { return numPrunes; }
@@ -103,6 +105,33 @@ class BinarySpaceTree<MetricType, StatisticType, MatType, BoundType,
   //! Traversal information, held in the class so that it isn't continually
   //! being reallocated.
   typename RuleType::TraversalInfoType traversalInfo;
+  //! A query node waiting to be handled, with the buffer holding the heap of
+  //! its combinations.
+  struct QueryEntry
+  {
+    //! The query node.
+    BinarySpaceTree* node;
+    //! The depth of the query node.
+    size_t depth;
+    //! The index of the buffer holding its combinations.
+    size_t queue;
+  };
+
+  //! The buffers holding the heaps of combinations; the left and right
+  //! children of a query node at depth d use the buffers 2 (d + 1) and
+  //! 2 (d + 1) + 1.
+  std::vector<std::vector<QueueFrameType>> queues;
+
+  //! The stack of query nodes to handle.
+  std::vector<QueryEntry> queryStack;
+
+  //! Add the given combination to the given heap.
+  static void Push(std::vector<QueueFrameType>& queue,
+                   const QueueFrameType& frame)
+  {
+    queue.push_back(frame);
+    std::push_heap(queue.begin(), queue.end());
+  }
 };
 
 } // namespace tree
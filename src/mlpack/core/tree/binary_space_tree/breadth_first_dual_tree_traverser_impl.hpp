@@ -17,6 +17,8 @@
 // In case it hasn't been included yet.
 #include "breadth_first_dual_tree_traverser.hpp"
 
+#include <algorithm>
+
 namespace mlpack {
 namespace tree {
 
@@ -73,8 +75,6 @@ BreadthFirstDualTreeTraverser<RuleType>::Traverse(
   if (rootScore == DBL_MAX)
     return; // This probably means something is wrong.
 
-  std::priority_queue<QueueFrameType> queue;
-
   QueueFrameType rootFrame;
   rootFrame.queryNode = &queryRoot;
   rootFrame.referenceNode = &referenceRoot;
@@ -82,126 +82,134 @@ BreadthFirstDualTreeTraverser<RuleType>::Traverse(
   rootFrame.score = 0.0;
   rootFrame.traversalInfo = rule.TraversalInfo();
 
-  queue.push(rootFrame);
+  if (queues.empty())
+    queues.resize(1);
+  queues[0].clear();
+  queues[0].push_back(rootFrame);
 
   // Start the traversal.
-  Traverse(queryRoot, queue);
-}
+  QueryEntry rootEntry = { &queryRoot, 0, 0 };
+  queryStack.clear();
+  queryStack.push_back(rootEntry);
 
-template<typename MetricType,
-         typename StatisticType,
-         typename MatType,
-         template<typename BoundMetricType, typename...> class BoundType,
-         template<typename SplitBoundType, typename SplitMatType>
-             class SplitType>
-template<typename RuleType>
-void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
-BreadthFirstDualTreeTraverser<RuleType>::Traverse(
-    BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>&
-        queryNode,
-    std::priority_queue<QueueFrameType>& referenceQueue)
-{
-  // Store queues for the children.  We will recurse into the children once our
-  // queue is empty.
-  std::priority_queue<QueueFrameType> leftChildQueue;
-  std::priority_queue<QueueFrameType> rightChildQueue;
-
-  while (!referenceQueue.empty())
+  while (!queryStack.empty())
   {
-    QueueFrameType currentFrame = referenceQueue.top();
-    referenceQueue.pop();
-
-    BinarySpaceTree& queryNode = *currentFrame.queryNode;
-    BinarySpaceTree& referenceNode = *currentFrame.referenceNode;
-    typename RuleType::TraversalInfoType ti = currentFrame.traversalInfo;
-    rule.TraversalInfo() = ti;
-    const size_t queryDepth = currentFrame.queryDepth;
-
-    double score = rule.Score(queryNode, referenceNode);
-    ++numScores;
-
-    if (score == DBL_MAX)
+    const QueryEntry entry = queryStack.back();
+    queryStack.pop_back();
+
+    // Get the buffers of the combinations of the children; nothing is pending
+    // in them, since all the query nodes still on the stack are at most as
+    // deep as this one.
+    const size_t leftIndex = 2 * (entry.depth + 1);
+    const size_t rightIndex = leftIndex + 1;
+    if (queues.size() <= rightIndex)
+      queues.resize(rightIndex + 1);
+
+    std::vector<QueueFrameType>& referenceQueue = queues[entry.queue];
+    std::vector<QueueFrameType>& leftChildQueue = queues[leftIndex];
+    std::vector<QueueFrameType>& rightChildQueue = queues[rightIndex];
+    leftChildQueue.clear();
+    rightChildQueue.clear();
+
+    while (!referenceQueue.empty())
     {
-      ++numPrunes;
-      continue;
-    }
+      std::pop_heap(referenceQueue.begin(), referenceQueue.end());
+      const QueueFrameType currentFrame = referenceQueue.back();
+      referenceQueue.pop_back();
 
-    // If both are leaves, we must evaluate the base case.
-    if (queryNode.IsLeaf() && referenceNode.IsLeaf())
-    {
-      // Loop through each of the points in each node.
-      const size_t queryEnd = queryNode.Begin() + queryNode.Count();
-      const size_t refEnd = referenceNode.Begin() + referenceNode.Count();
-      for (size_t query = queryNode.Begin(); query < queryEnd; ++query)
-      {
-        // See if we need to investigate this point (this function should be
-        // implemented for the single-tree recursion too).  Restore the
-        // traversal information first.
-//        const double childScore = rule.Score(query, referenceNode);
+      BinarySpaceTree& queryNode = *currentFrame.queryNode;
+      BinarySpaceTree& referenceNode = *currentFrame.referenceNode;
+      const typename RuleType::TraversalInfoType& ti =
+          currentFrame.traversalInfo;
+      rule.TraversalInfo() = ti;
+      const size_t queryDepth = currentFrame.queryDepth;
 
-//        if (childScore == DBL_MAX)
-//          continue; // We can't improve this particular point.
+      double score = rule.Score(queryNode, referenceNode);
+      ++numScores;
 
-        for (size_t ref = referenceNode.Begin(); ref < refEnd; ++ref)
-          rule.BaseCase(query, ref);
+      if (score == DBL_MAX)
+      {
+        ++numPrunes;
+        continue;
+      }
 
-        numBaseCases += referenceNode.Count();
+      // If both are leaves, we must evaluate the base case.
+      if (queryNode.IsLeaf() && referenceNode.IsLeaf())
+      {
+        // Loop through each of the points in each node.
+        const size_t queryEnd = queryNode.Begin() + queryNode.Count();
+        const size_t refEnd = referenceNode.Begin() + referenceNode.Count();
+        for (size_t query = queryNode.Begin(); query < queryEnd; ++query)
+        {
+          for (size_t ref = referenceNode.Begin(); ref < refEnd; ++ref)
+            rule.BaseCase(query, ref);
+
+          numBaseCases += referenceNode.Count();
+        }
+      }
+      else if ((!queryNode.IsLeaf()) && referenceNode.IsLeaf())
+      {
+        // We have to descend the query node.
+        QueueFrameType fl = { queryNode.Left(), &referenceNode, queryDepth + 1,
+            score, rule.TraversalInfo() };
+        Push(leftChildQueue, fl);
+
+        QueueFrameType fr = { queryNode.Right(), &referenceNode,
+            queryDepth + 1, score, ti };
+        Push(rightChildQueue, fr);
+      }
+      else if (queryNode.IsLeaf() && (!referenceNode.IsLeaf()))
+      {
+        // We have to descend the reference node.  In this case the order does
+        // matter.  Before descending, though, we have to set the traversal
+        // information correctly.
+        QueueFrameType fl = { &queryNode, referenceNode.Left(), queryDepth,
+            score, rule.TraversalInfo() };
+        Push(referenceQueue, fl);
+
+        QueueFrameType fr = { &queryNode, referenceNode.Right(), queryDepth,
+            score, ti };
+        Push(referenceQueue, fr);
+      }
+      else
+      {
+        // We have to descend both query and reference nodes.  Because the
+        // query descent order does not matter, we will go to the left query
+        // child first.  Before descending, we have to set the traversal
+        // information correctly.
+        QueueFrameType fll = { queryNode.Left(), referenceNode.Left(),
+            queryDepth + 1, score, rule.TraversalInfo() };
+        Push(leftChildQueue, fll);
+
+        QueueFrameType flr = { queryNode.Left(), referenceNode.Right(),
+            queryDepth + 1, score, rule.TraversalInfo() };
+        Push(leftChildQueue, flr);
+
+        QueueFrameType frl = { queryNode.Right(), referenceNode.Left(),
+            queryDepth + 1, score, rule.TraversalInfo() };
+        Push(rightChildQueue, frl);
+
+        QueueFrameType frr = { queryNode.Right(), referenceNode.Right(),
+            queryDepth + 1, score, rule.TraversalInfo() };
+        Push(rightChildQueue, frr);
       }
     }
-    else if ((!queryNode.IsLeaf()) && referenceNode.IsLeaf())
-    {
-      // We have to recurse down the query node.
-      QueueFrameType fl = { queryNode.Left(), &referenceNode, queryDepth + 1,
-          score, rule.TraversalInfo() };
-      leftChildQueue.push(fl);
-
-      QueueFrameType fr = { queryNode.Right(), &referenceNode, queryDepth + 1,
-          score, ti };
-      rightChildQueue.push(fr);
-    }
-    else if (queryNode.IsLeaf() && (!referenceNode.IsLeaf()))
+
+    // Now, handle the left and right children.  The order doesn't matter, but
+    // the left child is handled first, so it is pushed last.
+    if (rightChildQueue.size() > 0)
     {
-      // We have to recurse down the reference node.  In this case the recursion
-      // order does matter.  Before recursing, though, we have to set the
-      // traversal information correctly.
-      QueueFrameType fl = { &queryNode, referenceNode.Left(), queryDepth,
-          score, rule.TraversalInfo() };
-      referenceQueue.push(fl);
-
-      QueueFrameType fr = { &queryNode, referenceNode.Right(), queryDepth,
-          score, ti };
-      referenceQueue.push(fr);
+      QueryEntry rightEntry = { entry.node->Right(), entry.depth + 1,
+          rightIndex };
+      queryStack.push_back(rightEntry);
     }
-    else
+    if (leftChildQueue.size() > 0)
     {
-      // We have to recurse down both query and reference nodes.  Because the
-      // query descent order does not matter, we will go to the left query child
-      // first.  Before recursing, we have to set the traversal information
-      // correctly.
-      QueueFrameType fll = { queryNode.Left(), referenceNode.Left(),
-          queryDepth + 1, score, rule.TraversalInfo() };
-      leftChildQueue.push(fll);
-
-      QueueFrameType flr = { queryNode.Left(), referenceNode.Right(),
-          queryDepth + 1, score, rule.TraversalInfo() };
-      leftChildQueue.push(flr);
-
-      QueueFrameType frl = { queryNode.Right(), referenceNode.Left(),
-          queryDepth + 1, score, rule.TraversalInfo() };
-      rightChildQueue.push(frl);
-
-      QueueFrameType frr = { queryNode.Right(), referenceNode.Right(),
-          queryDepth + 1, score, rule.TraversalInfo() };
-      rightChildQueue.push(frr);
+      QueryEntry leftEntry = { entry.node->Left(), entry.depth + 1,
+          leftIndex };
+      queryStack.push_back(leftEntry);
     }
   }
-
-  // Now, recurse into the left and right children queues.  The order doesn't
-  // matter.
-  if (leftChildQueue.size() > 0)
-    Traverse(*queryNode.Left(), leftChildQueue);
-  if (rightChildQueue.size() > 0)
-    Traverse(*queryNode.Right(), rightChildQueue);
 }
 
 } // namespace tree
@@ -39,7 +39,9 @@ class BinarySpaceTree<MetricType, StatisticType, MatType, BoundType,
   DualTreeTraverser(RuleType& rule);
 
   /**
-   * Traverse the two trees.  This does not reset the number of prunes.
+   * Traverse the two trees.  This does not reset the number of prunes.  The
+   * traversal is depth-first, but it uses an explicit stack instead of
+   * recursion, so deep trees can't overflow the call stack.
    *
    * @param queryNode The query node to be traversed.
    * @param referenceNode The reference node to be traversed.
@@ -87,6 +89,57 @@ class BinarySpaceTree<MetricType, StatisticType, MatType, BoundType,
   //! Traversal information, held in the class so that it isn't continually
   //! being reallocated.
   typename RuleType::TraversalInfoType traversalInfo;
+
+  //! The step a combination of nodes on the stack is at.
+  enum Stage
+  {
+    //! The combination has not been visited yet.
+    Enter,
+    //! The left query child has been traversed (or pruned).
+    QueryLeftTraversed,
+    //! The pair query node must be scored against the reference children.
+    PairScore,
+    //! The left reference child has been traversed first.
+    PairLeftTraversed,
+    //! The right reference child has been traversed first.
+    PairRightTraversed,
+    //! Both reference children have been traversed (or pruned).
+    PairDone
+  };
+
+  //! A combination of nodes on the stack, with the state that a recursive
+  //! traversal would keep in its local variables.
+  struct Frame
+  {
+    //! The query node.
+    BinarySpaceTree* queryNode;
+    //! The reference node.
+    BinarySpaceTree* referenceNode;
+    //! The step the combination is at.
+    Stage stage;
+    //! The query node scored against the children of the reference node.
+    BinarySpaceTree* pairQuery;
+    //! Whether the pair query node is the last one to score.
+    bool lastPair;
+    //! Whether the traversal information of the right reference child is
+    //! stored in traversalInfo instead of rightInfo.
+    bool rightInfoInClass;
+    //! The score of the left reference child.
+    double leftScore;
+    //! The score of the right reference child.
+    double rightScore;
+    //! The traversal information of the left reference child.
+    typename RuleType::TraversalInfoType leftInfo;
+    //! The traversal information of the right reference child.
+    typename RuleType::TraversalInfoType rightInfo;
+  };
+
+  //! Push the given combination of nodes on the stack.
+  void Push(BinarySpaceTree& queryNode, BinarySpaceTree& referenceNode);
+
+  //! The stack of combinations to traverse, held in the class so that it isn't
+  //! continually being reallocated.
+  std::vector<Frame> stack;
 };
 
 } // namespace tree
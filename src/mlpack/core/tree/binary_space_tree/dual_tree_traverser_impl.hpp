@@ -17,6 +17,9 @@
 // In case it hasn't been included yet.
 #include "dual_tree_traverser.hpp"
 
+#include <mlpack/core/tree/base_case_block.hpp>
+#include <mlpack/core/tree/prefetch.hpp>
+
 namespace mlpack {
 namespace tree {
 
@@ -50,296 +53,235 @@ DualTreeTraverser<RuleType>::Traverse(
     BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>&
         referenceNode)
 {
-  // Increment the visit counter.
-  ++numVisited;
-
-  // Store the current traversal info.
-  traversalInfo = rule.TraversalInfo();
-
-  // If both are leaves, we must evaluate the base case.
-  if (queryNode.IsLeaf() && referenceNode.IsLeaf())
+  // The combinations are kept on an explicit stack; each one goes through the
+  // steps a recursive traversal would take, so the rules see the same calls in
+  // the same order.  Only the entries above the current top belong to this
+  // traversal, so a rule may start another traversal.
+  const size_t stackBase = stack.size();
+  Push(queryNode, referenceNode);
+
+  while (stack.size() > stackBase)
   {
-    // Loop through each of the points in each node.
-    const size_t queryEnd = queryNode.Begin() + queryNode.Count();
-    const size_t refEnd = referenceNode.Begin() + referenceNode.Count();
-    for (size_t query = queryNode.Begin(); query < queryEnd; ++query)
-    {
-      // See if we need to investigate this point (this function should be
-      // implemented for the single-tree recursion too).  Restore the traversal
-      // information first.
-      rule.TraversalInfo() = traversalInfo;
-      const double childScore = rule.Score(query, referenceNode);
+    // The frame must not be used after another one is pushed.
+    Frame& frame = stack.back();
+    BinarySpaceTree& query = *frame.queryNode;
+    BinarySpaceTree& reference = *frame.referenceNode;
 
-      if (childScore == DBL_MAX)
-        continue; // We can't improve this particular point.
-
-      for (size_t ref = referenceNode.Begin(); ref < refEnd; ++ref)
-        rule.BaseCase(query, ref);
+    switch (frame.stage)
+    {
+      case Enter:
+      {
+        // Increment the visit counter.
+        ++numVisited;
 
-      numBaseCases += referenceNode.Count();
-    }
-  }
-  else if (((!queryNode.IsLeaf()) && referenceNode.IsLeaf()) ||
-           (queryNode.NumDescendants() > 3 * referenceNode.NumDescendants() &&
-            !queryNode.IsLeaf() && !referenceNode.IsLeaf()))
-  {
-    // We have to recurse down the query node.  In this case the recursion order
-    // does not matter.
-    const double leftScore = rule.Score(*queryNode.Left(), referenceNode);
-    ++numScores;
+        // Store the current traversal info.
+        traversalInfo = rule.TraversalInfo();
 
-    if (leftScore != DBL_MAX)
-      Traverse(*queryNode.Left(), referenceNode);
-    else
-      ++numPrunes;
+        // If both are leaves, we must evaluate the base case.
+        if (query.IsLeaf() && reference.IsLeaf())
+        {
+          // Loop through each of the points in each node.
+          const size_t queryEnd = query.Begin() + query.Count();
+          for (size_t q = query.Begin(); q < queryEnd; ++q)
+          {
+            // See if we need to investigate this point (this function should
+            // be implemented for the single-tree traversal too).  Restore the
+            // traversal information first.
+            rule.TraversalInfo() = traversalInfo;
+            const double childScore = rule.Score(q, reference);
 
-    // Before recursing, we have to set the traversal information correctly.
-    rule.TraversalInfo() = traversalInfo;
-    const double rightScore = rule.Score(*queryNode.Right(), referenceNode);
-    ++numScores;
+            if (childScore == DBL_MAX)
+              continue; // We can't improve this particular point.
 
-    if (rightScore != DBL_MAX)
-      Traverse(*queryNode.Right(), referenceNode);
-    else
-      ++numPrunes;
-  }
-  else if (queryNode.IsLeaf() && (!referenceNode.IsLeaf()))
-  {
-    // We have to recurse down the reference node.  In this case the recursion
-    // order does matter.  Before recursing, though, we have to set the
-    // traversal information correctly.
-    double leftScore = rule.Score(queryNode, *referenceNode.Left());
-    typename RuleType::TraversalInfoType leftInfo = rule.TraversalInfo();
-    rule.TraversalInfo() = traversalInfo;
-    double rightScore = rule.Score(queryNode, *referenceNode.Right());
-    numScores += 2;
+            BaseCaseBlock(rule, q, reference.Begin(), reference.Count());
 
-    if (leftScore < rightScore)
-    {
-      // Recurse to the left.  Restore the left traversal info.  Store the right
-      // traversal info.
-      traversalInfo = rule.TraversalInfo();
-      rule.TraversalInfo() = leftInfo;
-      Traverse(queryNode, *referenceNode.Left());
+            numBaseCases += reference.Count();
+          }
 
-      // Is it still valid to recurse to the right?
-      rightScore = rule.Rescore(queryNode, *referenceNode.Right(), rightScore);
+          stack.pop_back();
+        }
+        else if (((!query.IsLeaf()) && reference.IsLeaf()) ||
+                 (query.NumDescendants() > 3 * reference.NumDescendants() &&
+                  !query.IsLeaf() && !reference.IsLeaf()))
+        {
+          // We have to descend the query node.  In this case the order does
+          // not matter.
+          const double leftScore = rule.Score(*query.Left(), reference);
+          ++numScores;
+
+          frame.stage = QueryLeftTraversed;
+          if (leftScore != DBL_MAX)
+            Push(*query.Left(), reference);
+          else
+            ++numPrunes;
+        }
+        else if (query.IsLeaf() && (!reference.IsLeaf()))
+        {
+          // We have to descend the reference node.  In this case the order
+          // does matter; the traversal information of the right child is
+          // stored in traversalInfo.
+          frame.pairQuery = &query;
+          frame.lastPair = true;
+          frame.rightInfoInClass = true;
+          frame.stage = PairScore;
+        }
+        else
+        {
+          // We have to descend both query and reference nodes.  Because the
+          // query descent order does not matter, we will go to the left query
+          // child first.
+          frame.pairQuery = query.Left();
+          frame.lastPair = false;
+          frame.rightInfoInClass = false;
+          frame.stage = PairScore;
+        }
+        break;
+      }
 
-      if (rightScore != DBL_MAX)
+      case QueryLeftTraversed:
       {
-        // Restore the right traversal info.
+        // Before descending, we have to set the traversal information
+        // correctly.  Nothing is left to do for this combination afterwards.
         rule.TraversalInfo() = traversalInfo;
-        Traverse(queryNode, *referenceNode.Right());
-      }
-      else
-        ++numPrunes;
-    }
-    else if (rightScore < leftScore)
-    {
-      // Recurse to the right.
-      Traverse(queryNode, *referenceNode.Right());
+        const double rightScore = rule.Score(*query.Right(), reference);
+        ++numScores;
 
-      // Is it still valid to recurse to the left?
-      leftScore = rule.Rescore(queryNode, *referenceNode.Left(), leftScore);
-
-      if (leftScore != DBL_MAX)
-      {
-        // Restore the left traversal info.
-        rule.TraversalInfo() = leftInfo;
-        Traverse(queryNode, *referenceNode.Left());
+        stack.pop_back();
+        if (rightScore != DBL_MAX)
+          Push(*query.Right(), reference);
+        else
+          ++numPrunes;
+        break;
       }
-      else
-        ++numPrunes;
-    }
-    else // leftScore is equal to rightScore.
-    {
-      if (leftScore == DBL_MAX)
+
+      case PairScore:
       {
-        numPrunes += 2;
+        BinarySpaceTree& pairQuery = *frame.pairQuery;
+        frame.leftScore = rule.Score(pairQuery, *reference.Left());
+        frame.leftInfo = rule.TraversalInfo();
+        rule.TraversalInfo() = traversalInfo;
+        frame.rightScore = rule.Score(pairQuery, *reference.Right());
+        numScores += 2;
+
+        if (frame.rightScore < frame.leftScore)
+        {
+          // Descend to the right first.
+          frame.stage = PairRightTraversed;
+          Push(pairQuery, *reference.Right());
+        }
+        else if (frame.leftScore == DBL_MAX && frame.rightScore == DBL_MAX)
+        {
+          numPrunes += 2;
+          frame.stage = PairDone;
+        }
+        else
+        {
+          // Descend to the left first (also on a tie).  Store the right
+          // traversal info and restore the left traversal info.
+          if (frame.rightInfoInClass)
+            traversalInfo = rule.TraversalInfo();
+          else
+            frame.rightInfo = rule.TraversalInfo();
+          rule.TraversalInfo() = frame.leftInfo;
+
+          frame.stage = PairLeftTraversed;
+          Push(pairQuery, *reference.Left());
+        }
+        break;
       }
-      else
-      {
-        // Choose the left first.  Restore the left traversal info.  Store the
-        // right traversal info.
-        traversalInfo = rule.TraversalInfo();
-        rule.TraversalInfo() = leftInfo;
-        Traverse(queryNode, *referenceNode.Left());
 
-        rightScore = rule.Rescore(queryNode, *referenceNode.Right(),
-            rightScore);
+      case PairLeftTraversed:
+      {
+        // Is it still valid to descend to the right?
+        BinarySpaceTree& pairQuery = *frame.pairQuery;
+        frame.rightScore = rule.Rescore(pairQuery, *reference.Right(),
+            frame.rightScore);
 
-        if (rightScore != DBL_MAX)
+        frame.stage = PairDone;
+        if (frame.rightScore != DBL_MAX)
         {
           // Restore the right traversal info.
-          rule.TraversalInfo() = traversalInfo;
-          Traverse(queryNode, *referenceNode.Right());
+          rule.TraversalInfo() = frame.rightInfoInClass ? traversalInfo :
+              frame.rightInfo;
+          Push(pairQuery, *reference.Right());
         }
         else
+        {
           ++numPrunes;
+        }
+        break;
       }
-    }
-  }
-  else
-  {
-    // We have to recurse down both query and reference nodes.  Because the
-    // query descent order does not matter, we will go to the left query child
-    // first.  Before recursing, we have to set the traversal information
-    // correctly.
-    double leftScore = rule.Score(*queryNode.Left(), *referenceNode.Left());
-    typename RuleType::TraversalInfoType leftInfo = rule.TraversalInfo();
-    rule.TraversalInfo() = traversalInfo;
-    double rightScore = rule.Score(*queryNode.Left(), *referenceNode.Right());
-    typename RuleType::TraversalInfoType rightInfo;
-    numScores += 2;
-
-    if (leftScore < rightScore)
-    {
-      // Recurse to the left.  Restore the left traversal info.  Store the right
-      // traversal info.
-      rightInfo = rule.TraversalInfo();
-      rule.TraversalInfo() = leftInfo;
-      Traverse(*queryNode.Left(), *referenceNode.Left());
-
-      // Is it still valid to recurse to the right?
-      rightScore = rule.Rescore(*queryNode.Left(), *referenceNode.Right(),
-          rightScore);
-
-      if (rightScore != DBL_MAX)
-      {
-        // Restore the right traversal info.
-        rule.TraversalInfo() = rightInfo;
-        Traverse(*queryNode.Left(), *referenceNode.Right());
-      }
-      else
-        ++numPrunes;
-    }
-    else if (rightScore < leftScore)
-    {
-      // Recurse to the right.
-      Traverse(*queryNode.Left(), *referenceNode.Right());
-
-      // Is it still valid to recurse to the left?
-      leftScore = rule.Rescore(*queryNode.Left(), *referenceNode.Left(),
-          leftScore);
 
-      if (leftScore != DBL_MAX)
-      {
-        // Restore the left traversal info.
-        rule.TraversalInfo() = leftInfo;
-        Traverse(*queryNode.Left(), *referenceNode.Left());
-      }
-      else
-        ++numPrunes;
-    }
-    else
-    {
-      if (leftScore == DBL_MAX)
+      case PairRightTraversed:
       {
-        numPrunes += 2;
-      }
-      else
-      {
-        // Choose the left first.  Restore the left traversal info and store the
-        // right traversal info.
-        rightInfo = rule.TraversalInfo();
-        rule.TraversalInfo() = leftInfo;
-        Traverse(*queryNode.Left(), *referenceNode.Left());
+        // Is it still valid to descend to the left?
+        BinarySpaceTree& pairQuery = *frame.pairQuery;
+        frame.leftScore = rule.Rescore(pairQuery, *reference.Left(),
+            frame.leftScore);
 
-        // Is it still valid to recurse to the right?
-        rightScore = rule.Rescore(*queryNode.Left(), *referenceNode.Right(),
-            rightScore);
-
-        if (rightScore != DBL_MAX)
+        frame.stage = PairDone;
+        if (frame.leftScore != DBL_MAX)
         {
-          // Restore the right traversal information.
-          rule.TraversalInfo() = rightInfo;
-          Traverse(*queryNode.Left(), *referenceNode.Right());
+          // Restore the left traversal info.
+          rule.TraversalInfo() = frame.leftInfo;
+          Push(pairQuery, *reference.Left());
         }
         else
+        {
           ++numPrunes;
+        }
+        break;
       }
-    }
-
-    // Restore the main traversal information.
-    rule.TraversalInfo() = traversalInfo;
-
-    // Now recurse down the right query node.
-    leftScore = rule.Score(*queryNode.Right(), *referenceNode.Left());
-    leftInfo = rule.TraversalInfo();
-    rule.TraversalInfo() = traversalInfo;
-    rightScore = rule.Score(*queryNode.Right(), *referenceNode.Right());
-    numScores += 2;
-
-    if (leftScore < rightScore)
-    {
-      // Recurse to the left.  Restore the left traversal info.  Store the right
-      // traversal info.
-      rightInfo = rule.TraversalInfo();
-      rule.TraversalInfo() = leftInfo;
-      Traverse(*queryNode.Right(), *referenceNode.Left());
-
-      // Is it still valid to recurse to the right?
-      rightScore = rule.Rescore(*queryNode.Right(), *referenceNode.Right(),
-          rightScore);
-
-      if (rightScore != DBL_MAX)
-      {
-        // Restore the right traversal info.
-        rule.TraversalInfo() = rightInfo;
-        Traverse(*queryNode.Right(), *referenceNode.Right());
-      }
-      else
-        ++numPrunes;
-    }
-    else if (rightScore < leftScore)
-    {
-      // Recurse to the right.
-      Traverse(*queryNode.Right(), *referenceNode.Right());
-
-      // Is it still valid to recurse to the left?
-      leftScore = rule.Rescore(*queryNode.Right(), *referenceNode.Left(),
-          leftScore);
 
-      if (leftScore != DBL_MAX)
-      {
-        // Restore the left traversal info.
-        rule.TraversalInfo() = leftInfo;
-        Traverse(*queryNode.Right(), *referenceNode.Left());
-      }
-      else
-        ++numPrunes;
-    }
-    else
-    {
-      if (leftScore == DBL_MAX)
-      {
-        numPrunes += 2;
-      }
-      else
+      case PairDone:
       {
-        // Choose the left first.  Restore the left traversal info.  Store the
-        // right traversal info.
-        rightInfo = rule.TraversalInfo();
-        rule.TraversalInfo() = leftInfo;
-        Traverse(*queryNode.Right(), *referenceNode.Left());
-
-        // Is it still valid to recurse to the right?
-        rightScore = rule.Rescore(*queryNode.Right(), *referenceNode.Right(),
-            rightScore);
-
-        if (rightScore != DBL_MAX)
+        if (frame.lastPair)
         {
-          // Restore the right traversal info.
-          rule.TraversalInfo() = rightInfo;
-          Traverse(*queryNode.Right(), *referenceNode.Right());
+          stack.pop_back();
         }
         else
-          ++numPrunes;
+        {
+          // Restore the main traversal information, and score the right query
+          // child.
+          rule.TraversalInfo() = traversalInfo;
+          frame.pairQuery = query.Right();
+          frame.lastPair = true;
+          frame.stage = PairScore;
+        }
+        break;
       }
     }
   }
 }
 
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+template<typename RuleType>
+void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+DualTreeTraverser<RuleType>::Push(
+    BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>&
+        queryNode,
+    BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>&
+        referenceNode)
+{
+  // The children of the reference node will be scored soon.
+  if (!referenceNode.IsLeaf())
+  {
+    PrefetchNode(referenceNode.Left());
+    PrefetchNode(referenceNode.Right());
+  }
+
+  stack.push_back(Frame());
+  Frame& frame = stack.back();
+  frame.queryNode = &queryNode;
+  frame.referenceNode = &referenceNode;
+  frame.stage = Enter;
+}
+
 } // namespace tree
 } // namespace mlpack
 
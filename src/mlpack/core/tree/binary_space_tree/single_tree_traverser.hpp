@@ -38,7 +38,9 @@ class BinarySpaceTree<MetricType, StatisticType, MatType, BoundType,
   SingleTreeTraverser(RuleType& rule);
 
   /**
-   * Traverse the tree with the given point.
+   * Traverse the tree with the given point.  The traversal is depth-first, but
+   * it uses an explicit stack instead of recursion, so deep trees can't
+   * overflow the call stack.
    *
    * @param queryIndex The index of the point in the query set which is being
    *     used as the query point.
@@ -57,6 +59,21 @@ class BinarySpaceTree<MetricType, StatisticType, MatType, BoundType,
 
   //! The number of nodes which have been pruned during traversal.
   size_t numPrunes;
+
+  //! A node waiting to be traversed.
+  struct StackEntry
+  {
+    //! The node.
+    BinarySpaceTree* node;
+    //! The score of the node.
+    double score;
+    //! Whether the node must be rescored before it is traversed.
+    bool rescore;
+  };
+
+  //! The stack of nodes to traverse, held in the class so that it isn't
+  //! continually being reallocated.
+  std::vector<StackEntry> stack;
 };
 
 } // namespace tree
@@ -17,7 +17,8 @@
 // In case it hasn't been included yet.
 #include "single_tree_traverser.hpp"
 
-#include <stack>
+#include <mlpack/core/tree/base_case_block.hpp>
+#include <mlpack/core/tree/prefetch.hpp>
 
 namespace mlpack {
 namespace tree {
@@ -48,66 +49,67 @@ SingleTreeTraverser<RuleType>::Traverse(
     BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>&
         referenceNode)
 {
-  // If we are a leaf, run the base case as necessary.
-  if (referenceNode.IsLeaf())
-  {
-    const size_t refEnd = referenceNode.Begin() + referenceNode.Count();
-    for (size_t i = referenceNode.Begin(); i < refEnd; ++i)
-      rule.BaseCase(queryIndex, i);
-  }
-  else
+  // The nodes are kept on an explicit stack, so that the order in which they
+  // are scored and traversed is the order of a depth-first recursion.  Only the
+  // entries above the current top belong to this traversal, so a rule may
+  // start another traversal from a base case.
+  const size_t stackBase = stack.size();
+  StackEntry rootEntry = { &referenceNode, 0.0, false };
+  stack.push_back(rootEntry);
+
+  while (stack.size() > stackBase)
   {
-    // If either score is DBL_MAX, we do not recurse into that node.
-    double leftScore = rule.Score(queryIndex, *referenceNode.Left());
-    double rightScore = rule.Score(queryIndex, *referenceNode.Right());
+    StackEntry entry = stack.back();
+    stack.pop_back();
 
-    if (leftScore < rightScore)
+    // A node that was scored before its sibling was traversed must be
+    // rescored.
+    if (entry.rescore)
     {
-      // Recurse to the left.
-      Traverse(queryIndex, *referenceNode.Left());
-
-      // Is it still valid to recurse to the right?
-      rightScore = rule.Rescore(queryIndex, *referenceNode.Right(), rightScore);
-
-      if (rightScore != DBL_MAX)
-        Traverse(queryIndex, *referenceNode.Right()); // Recurse to the right.
-      else
+      if (rule.Rescore(queryIndex, *entry.node, entry.score) == DBL_MAX)
+      {
         ++numPrunes;
+        continue;
+      }
     }
-    else if (rightScore < leftScore)
+
+    BinarySpaceTree& node = *entry.node;
+
+    // If we are a leaf, run the base case as necessary.
+    if (node.IsLeaf())
     {
-      // Recurse to the right.
-      Traverse(queryIndex, *referenceNode.Right());
+      BaseCaseBlock(rule, queryIndex, node.Begin(), node.Count());
+      continue;
+    }
 
-      // Is it still valid to recurse to the left?
-      leftScore = rule.Rescore(queryIndex, *referenceNode.Left(), leftScore);
+    // If either score is DBL_MAX, we do not traverse that node.
+    const double leftScore = rule.Score(queryIndex, *node.Left());
+    const double rightScore = rule.Score(queryIndex, *node.Right());
 
-      if (leftScore != DBL_MAX)
-        Traverse(queryIndex, *referenceNode.Left()); // Recurse to the left.
-      else
-        ++numPrunes;
+    // Traverse the node with the best score first; on a tie, choose the left.
+    // The other node is pushed first, so it is traversed afterwards.
+    StackEntry first = { node.Left(), leftScore, false };
+    StackEntry second = { node.Right(), rightScore, true };
+    if (rightScore < leftScore)
+    {
+      std::swap(first.node, second.node);
+      std::swap(first.score, second.score);
     }
-    else // leftScore is equal to rightScore.
+    else if (leftScore == DBL_MAX && rightScore == DBL_MAX)
     {
-      if (leftScore == DBL_MAX)
-      {
-        numPrunes += 2; // Pruned both left and right.
-      }
-      else
-      {
-        // Choose the left first.
-        Traverse(queryIndex, *referenceNode.Left());
-
-        // Is it still valid to recurse to the right?
-        rightScore = rule.Rescore(queryIndex, *referenceNode.Right(),
-            rightScore);
+      numPrunes += 2; // Pruned both left and right.
+      continue;
+    }
 
-        if (rightScore != DBL_MAX)
-          Traverse(queryIndex, *referenceNode.Right());
-        else
-          ++numPrunes;
-      }
+    // The children of the next node will be scored soon.
+    if (!first.node->IsLeaf())
+    {
+      PrefetchNode(first.node->Left());
+      PrefetchNode(first.node->Right());
     }
+
+    stack.push_back(second);
+    stack.push_back(first);
   }
 }
 
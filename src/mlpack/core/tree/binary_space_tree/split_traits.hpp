@@ -0,0 +1,68 @@
+/**
+ * @file split_traits.hpp
+ *
+ * This file defines the SplitTraits class, which describes properties of the
+ * split types used by BinarySpaceTree.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_BINARY_SPACE_TREE_SPLIT_TRAITS_HPP
+#define MLPACK_CORE_TREE_BINARY_SPACE_TREE_SPLIT_TRAITS_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include "midpoint_split.hpp"
+#include "mean_split.hpp"
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * The SplitTraits class describes properties of a split type that
+ * BinarySpaceTree uses during construction.  The default values are the safe
+ * ones, so a new split type only needs a specialization if it wants to change
+ * them.
+ *
+ * @tparam SplitType The split type, instantiated with its bound and matrix
+ *     types (i.e. MidpointSplit<BoundType, MatType>).
+ */
+template<typename SplitType>
+class SplitTraits
+{
+ public:
+  /**
+   * This is true if the children of a node may be split at the same time, in
+   * different threads.  That requires the split to not keep any state that is
+   * shared between nodes, and to not draw random numbers (which would make the
+   * tree depend on the scheduling of the threads).
+   */
+  static const bool ParallelSafe = false;
+};
+
+/**
+ * MidpointSplit only looks at the points of the node it is splitting.
+ */
+template<typename BoundType, typename MatType>
+class SplitTraits<MidpointSplit<BoundType, MatType>>
+{
+ public:
+  static const bool ParallelSafe = true;
+};
+
+/**
+ * MeanSplit only looks at the points of the node it is splitting.
+ */
+template<typename BoundType, typename MatType>
+class SplitTraits<MeanSplit<BoundType, MatType>>
+{
+ public:
+  static const bool ParallelSafe = true;
+};
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
@@ -147,7 +147,8 @@ class CellBound
    *
    * @param center Vector which the center will be written to.
    */
-  void Center(arma::Col<ElemType>& center) const;
+  template<typename VecType>
+  void Center(VecType& center) const;
 
   /**
    * Calculates minimum bound-to-point distance.
@@ -164,8 +164,8 @@ inline void CellBound<MetricType, ElemType>::Clear()
  * @param centroid Vector which the centroid will be written to.
  */
 template<typename MetricType, typename ElemType>
-inline void CellBound<MetricType, ElemType>::Center(
-    arma::Col<ElemType>& center) const
+template<typename VecType>
+inline void CellBound<MetricType, ElemType>::Center(VecType& center) const
 {
   // Set size correctly if necessary.
   if (!(center.n_elem == dim))
@@ -14,6 +14,10 @@
 
 #include <boost/math/distributions/normal.hpp>
 
+#ifdef HAS_OPENMP
+  #include <omp.h>
+#endif
+
 namespace mlpack {
 namespace tree {
 
@@ -29,11 +33,11 @@ CosineTree::CosineTree(const arma::mat& dataset) :
   l2NormsSquared.zeros(numColumns);
 
   // Set indices and calculate squared norms of the columns.
-  for (size_t i = 0; i < numColumns; i++)
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) numColumns; i++)
   {
     indices[i] = i;
-    double l2Norm = arma::norm(dataset.col(i), 2);
-    l2NormsSquared(i) = l2Norm * l2Norm;
+    l2NormsSquared(i) = arma::dot(dataset.col(i), dataset.col(i));
   }
 
   // Frobenius norm of columns in the node.
@@ -123,27 +127,35 @@ CosineTree::CosineTree(const arma::mat& dataset,
     currentLeft = currentNode->Left();
     currentRight = currentNode->Right();
 
-    // Calculate basis vectors of left and right children.
+    // Gather the basis vectors of the nodes left in the queue into a matrix,
+    // so that the orthonormalization and the error estimates below are
+    // matrix products instead of one dot product per basis vector.
+    ConstructBasis(treeQueue);
+
+    // Calculate basis vectors of left and right children, and add them to the
+    // basis.
     arma::vec lBasisVector, rBasisVector;
 
-    ModifiedGramSchmidt(treeQueue, currentLeft->Centroid(), lBasisVector);
-    ModifiedGramSchmidt(treeQueue, currentRight->Centroid(), rBasisVector,
-                        &lBasisVector);
+    ModifiedGramSchmidt(basis, currentLeft->Centroid(), lBasisVector);
+    basis.insert_cols(basis.n_cols, lBasisVector);
+    ModifiedGramSchmidt(basis, currentRight->Centroid(), rBasisVector);
+    basis.insert_cols(basis.n_cols, rBasisVector);
 
     // Add basis vectors to their respective nodes.
     currentLeft->BasisVector(lBasisVector);
     currentRight->BasisVector(rBasisVector);
 
     // Calculate Monte Carlo error estimates for child nodes.
-    MonteCarloError(currentLeft, treeQueue, &lBasisVector, &rBasisVector);
-    MonteCarloError(currentRight, treeQueue, &lBasisVector, &rBasisVector);
+    MonteCarloError(currentLeft, basis);
+    MonteCarloError(currentRight, basis);
 
     // Push child nodes into the priority queue.
     treeQueue.push(currentLeft);
     treeQueue.push(currentRight);
 
-    // Calculate Monte Carlo error estimate for the root node.
-    monteCarloError = MonteCarloError(&root, treeQueue);
+    // Calculate Monte Carlo error estimate for the root node.  The basis
+    // already holds the basis vectors of every node in the queue.
+    monteCarloError = MonteCarloError(&root, basis);
   }
 
   // Construct the subspace basis from the current priority queue.
@@ -163,39 +175,56 @@ void CosineTree::ModifiedGramSchmidt(CosineNodeQueue& treeQueue,
                                      arma::vec& newBasisVector,
                                      arma::vec* addBasisVector)
 {
-  // Set new basis vector to centroid.
-  newBasisVector = centroid;
-
-  // Variables for iterating throught the priority queue.
-  CosineTree *currentNode;
-  CosineNodeQueue::const_iterator i = treeQueue.begin();
+  // Collect the current basis, and the additional basis vector if given.
+  arma::mat currentBasis;
+  QueueBasis(treeQueue, currentBasis);
+  if (addBasisVector)
+    currentBasis.insert_cols(currentBasis.n_cols, *addBasisVector);
 
-  // For every vector in the current basis, remove its projection from the
-  // centroid.
-  for ( ; i != treeQueue.end(); i++)
-  {
-    currentNode = *i;
+  ModifiedGramSchmidt(currentBasis, centroid, newBasisVector);
+}
 
-    double projection = arma::dot(currentNode->BasisVector(), centroid);
-    newBasisVector -= projection * currentNode->BasisVector();
-  }
+void CosineTree::ModifiedGramSchmidt(const arma::mat& currentBasis,
+                                     const arma::vec& centroid,
+                                     arma::vec& newBasisVector)
+{
+  // Set new basis vector to centroid.
+  newBasisVector = centroid;
 
-  // If additional basis vector is passed, take it into account.
-  if (addBasisVector)
+  // Remove the projection onto every vector of the current basis at once.  A
+  // second pass removes what is left because of cancellation, so the result
+  // stays orthogonal to the basis even when the centroid is nearly in its span.
+  if (currentBasis.n_cols > 0)
   {
-    double projection = arma::dot(*addBasisVector, centroid);
-    newBasisVector -= *addBasisVector * projection;
+    for (size_t pass = 0; pass < 2; ++pass)
+      newBasisVector -= currentBasis * (currentBasis.t() * newBasisVector);
   }
 
   // Normalize the modified centroid vector.
-  if (arma::norm(newBasisVector, 2))
-    newBasisVector /= arma::norm(newBasisVector, 2);
+  const double norm = arma::norm(newBasisVector, 2);
+  if (norm)
+    newBasisVector /= norm;
 }
 
 double CosineTree::MonteCarloError(CosineTree* node,
                                    CosineNodeQueue& treeQueue,
                                    arma::vec* addBasisVector1,
                                    arma::vec* addBasisVector2)
+{
+  // Collect the current basis, and the additional basis vectors if given.
+  arma::mat currentBasis;
+  QueueBasis(treeQueue, currentBasis);
+  if (addBasisVector1 && addBasisVector2)
+  {
+    currentBasis.insert_cols(currentBasis.n_cols, *addBasisVector1);
+    currentBasis.insert_cols(currentBasis.n_cols, *addBasisVector2);
+  }
+
+  return MonteCarloError(node, currentBasis);
+}
+
+double CosineTree::MonteCarloError(CosineTree* node,
+                                   const arma::mat& currentBasis)
 {
   std::vector<size_t> sampledIndices;
   arma::vec probabilities;
@@ -205,55 +234,21 @@ double CosineTree::MonteCarloError(CosineTree* node,
   size_t numSamples = log(node->NumColumns()) + 1;
   node->ColumnSamplesLS(sampledIndices, probabilities, numSamples);
 
-  // Get pointer to the original dataset.
-  arma::mat dataset = node->GetDataset();
-
-  // Initialize weighted projection magnitudes as zeros.
+  // Calculate the weighted squared norm of the projection of each sample onto
+  // the current basis, projecting all the samples at once.
   arma::vec weightedMagnitudes;
-  weightedMagnitudes.zeros(numSamples);
-
-  // Set size of projection vector, depending on whether additional basis
-  // vectors are passed.
-  size_t projectionSize;
-  if (addBasisVector1 && addBasisVector2)
-    projectionSize = treeQueue.size() + 2;
+  if (currentBasis.n_cols == 0)
+  {
+    weightedMagnitudes.zeros(numSamples);
+  }
   else
-    projectionSize = treeQueue.size();
-
-  // For each sample, calculate the weighted projection onto the current basis.
-  for (size_t i = 0; i < numSamples; i++)
   {
-    // Initialize projection as a vector of zeros.
-    arma::vec projection;
-    projection.zeros(projectionSize);
-
-    CosineTree *currentNode;
-    CosineNodeQueue::const_iterator j = treeQueue.begin();
-
-    size_t k = 0;
-    // Compute the projection of the sampled vector onto the existing subspace.
-    for ( ; j != treeQueue.end(); j++, k++)
-    {
-      currentNode = *j;
-
-      projection(k) = arma::dot(dataset.col(sampledIndices[i]),
-                                currentNode->BasisVector());
-    }
-    // If two additional vectors are passed, take their projections.
-    if (addBasisVector1 && addBasisVector2)
-    {
-      projection(k++) = arma::dot(dataset.col(sampledIndices[i]),
-                                  *addBasisVector1);
-      projection(k) = arma::dot(dataset.col(sampledIndices[i]),
-                                *addBasisVector2);
-    }
-
-    // Calculate the Frobenius norm squared of the projected vector.
-    double frobProjection = arma::norm(projection, "frob");
-    double frobProjectionSquared = frobProjection * frobProjection;
-
-    // Calculate the weighted projection magnitude.
-    weightedMagnitudes(i) = frobProjectionSquared / probabilities(i);
+    const arma::uvec sampledColumns =
+        arma::conv_to<arma::uvec>::from(sampledIndices);
+    const arma::mat projections = currentBasis.t() *
+        node->GetDataset().cols(sampledColumns);
+    weightedMagnitudes = arma::trans(arma::sum(arma::square(projections), 0)) /
+        probabilities;
   }
 
   // Compute mean and standard deviation of the weighted samples.
@@ -278,9 +273,15 @@ double CosineTree::MonteCarloError(CosineTree* node,
 }
 
 void CosineTree::ConstructBasis(CosineNodeQueue& treeQueue)
+{
+  QueueBasis(treeQueue, basis);
+}
+
+void CosineTree::QueueBasis(const CosineNodeQueue& treeQueue,
+                            arma::mat& queueBasis) const
 {
   // Initialize basis as matrix of zeros.
-  basis.zeros(dataset.n_rows, treeQueue.size());
+  queueBasis.zeros(dataset.n_rows, treeQueue.size());
 
   // Variables for iterating through the priority queue.
   CosineTree *currentNode;
@@ -291,7 +292,7 @@ void CosineTree::ConstructBasis(CosineNodeQueue& treeQueue)
   for ( ; i != treeQueue.end(); i++, j++)
   {
     currentNode = *i;
-    basis.col(j) = currentNode->BasisVector();
+    queueBasis.col(j) = currentNode->BasisVector();
   }
 }
 
@@ -341,11 +342,8 @@ void CosineTree::ColumnSamplesLS(std::vector<size_t>& sampledIndices,
   cDistribution.zeros(numColumns + 1);
 
   // Calculate cumulative length-squared distribution for the node.
-  for (size_t i = 0; i < numColumns; i++)
-  {
-    cDistribution(i + 1) = cDistribution(i) +
-        (l2NormsSquared(i) / frobNormSquared);
-  }
+  cDistribution.subvec(1, numColumns) =
+      arma::cumsum(l2NormsSquared / frobNormSquared);
 
   // Initialize sizes of the 'sampledIndices' and 'probabilities' vectors.
   sampledIndices.resize(numSamples);
@@ -377,11 +375,8 @@ size_t CosineTree::ColumnSampleLS()
   cDistribution.zeros(numColumns + 1);
 
   // Calculate cumulative length-squared distribution for the node.
-  for (size_t i = 0; i < numColumns; i++)
-  {
-    cDistribution(i + 1) = cDistribution(i) +
-        (l2NormsSquared(i) / frobNormSquared);
-  }
+  cDistribution.subvec(1, numColumns) =
+      arma::cumsum(l2NormsSquared / frobNormSquared);
 
   // Generate a random value for sampling.
   double randValue = arma::randu();
@@ -424,19 +419,20 @@ void CosineTree::CalculateCosines(arma::vec& cosines)
   // Initialize cosine vector as a vector of zeros.
   cosines.zeros(numColumns);
 
-  for (size_t i = 0; i < numColumns; i++)
+  // The norms of the columns are already known, so each cosine only needs one
+  // dot product.  Small nodes are not worth starting threads for.
+  const arma::vec splitPoint = dataset.col(indices[splitPointIndex]);
+  const double splitNorm = std::sqrt(l2NormsSquared(splitPointIndex));
+
+  #pragma omp parallel for if (numColumns >= 1024)
+  for (omp_size_t i = 0; i < (omp_size_t) numColumns; i++)
   {
     // If norm is zero, store cosine value as zero. Else, calculate cosine value
     // between two vectors.
-    if (l2NormsSquared(i) == 0)
+    if (l2NormsSquared(i) != 0 && splitNorm != 0)
     {
-      cosines(i) = 0;
-    }
-    else
-    {
-      cosines(i) =
-          std::abs(arma::norm_dot(dataset.col(indices[splitPointIndex]),
-                                  dataset.col(indices[i])));
+      cosines(i) = std::abs(arma::dot(splitPoint, dataset.col(indices[i]))) /
+          (splitNorm * std::sqrt(l2NormsSquared(i)));
     }
   }
 }
@@ -446,10 +442,18 @@ void CosineTree::CalculateCentroid()
   // Initialize centroid as vector of zeros.
   centroid.zeros(dataset.n_rows);
 
-  // Calculate centroid of columns in the node.
-  for (size_t i = 0; i < numColumns; i++)
+  // Calculate centroid of columns in the node; each thread sums its share of
+  // the columns.
+  #pragma omp parallel if (numColumns >= 1024)
   {
-    centroid += dataset.col(indices[i]);
+    arma::vec threadSum(dataset.n_rows, arma::fill::zeros);
+
+    #pragma omp for
+    for (omp_size_t i = 0; i < (omp_size_t) numColumns; i++)
+      threadSum += dataset.col(indices[i]);
+
+    #pragma omp critical
+    centroid += threadSum;
   }
   centroid /= numColumns;
 }
@@ -87,6 +87,18 @@ class CosineTree
                            arma::vec& newBasisVector,
                            arma::vec* addBasisVector = NULL);
 
+  /**
+   * Calculates the orthonormalization of the passed centroid, with respect to
+   * the subspace spanned by the columns of the given orthonormal basis.
+   *
+   * @param currentBasis Orthonormal basis of the current vector subspace.
+   * @param centroid Centroid of the node being added to the basis.
+   * @param newBasisVector Orthonormalized centroid of the node.
+   */
+  void ModifiedGramSchmidt(const arma::mat& currentBasis,
+                           const arma::vec& centroid,
+                           arma::vec& newBasisVector);
+
   /**
    * Estimates the squared error of the projection of the input node's matrix
    * onto the current vector subspace. A normal distribution is fit using
@@ -104,6 +116,16 @@ class CosineTree
                          arma::vec* addBasisVector1 = NULL,
                          arma::vec* addBasisVector2 = NULL);
 
+  /**
+   * Estimates the squared error of the projection of the input node's matrix
+   * onto the subspace spanned by the columns of the given orthonormal basis,
+   * as above.  All the samples are projected with one matrix product.
+   *
+   * @param node Node for which Monte Carlo estimate is calculated.
+   * @param currentBasis Orthonormal basis of the current vector subspace.
+   */
+  double MonteCarloError(CosineTree* node, const arma::mat& currentBasis);
+
   /**
    * Constructs the final basis matrix, after the cosine tree construction.
    *
@@ -213,6 +235,16 @@ class CosineTree
   size_t SplitPointIndex() const { return indices[splitPointIndex]; }
 
  private:
+  /**
+   * Gather the basis vectors of the nodes in the priority queue into the
+   * columns of a matrix.
+   *
+   * @param treeQueue Priority queue of cosine nodes.
+   * @param queueBasis Matrix to store the basis vectors in.
+   */
+  void QueueBasis(const CosineNodeQueue& treeQueue,
+                  arma::mat& queueBasis) const;
+
   //! Matrix for which cosine tree is constructed.
   const arma::mat& dataset;
   //! Cumulative probability for Monte Carlo error lower bound.
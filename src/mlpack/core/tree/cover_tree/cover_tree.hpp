@@ -458,7 +458,8 @@ class CoverTree
    * Fill the vector of distances with the distances between the point specified
    * by pointIndex and each point in the indices array.  The distances of the
    * first pointSetSize points in indices are calculated (so, this does not
-   * necessarily need to use all of the points in the arrays).
+   * necessarily need to use all of the points in the arrays).  If OpenMP is
+   * available, large point sets are handled in parallel.
    *
    * @param pointIndex Point to build the distances for.
    * @param indices List of indices to compute distances for.
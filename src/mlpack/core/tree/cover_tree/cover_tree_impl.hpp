@@ -1241,9 +1241,13 @@ void CoverTree<MetricType, StatisticType, MatType, RootPointPolicy>::
                      const size_t pointSetSize)
 {
   // For each point, rebuild the distances.  The indices do not need to be
-  // modified.
+  // modified.  This is where most of the construction time is spent, so large
+  // point sets are split between threads.  (The children themselves have to be
+  // built one after another, since each child takes points away from the near
+  // and far sets of its later siblings.)
   distanceComps += pointSetSize;
-  for (size_t i = 0; i < pointSetSize; ++i)
+  #pragma omp parallel for if (pointSetSize >= 1000)
+  for (omp_size_t i = 0; i < (omp_size_t) pointSetSize; ++i)
   {
     distances[i] = metric->Evaluate(dataset->col(pointIndex),
         dataset->col(indices[i]));
@@ -162,6 +162,11 @@ DualTreeTraverser<RuleType>::PruneMap(
   if (referenceMap.empty())
     return; // Nothing to do.
 
+  // The frames of the map were built for the parent of the query node, so if
+  // the query node is its self-child, their base cases are already known.
+  const bool selfChild = (queryNode.Parent() != NULL) &&
+      (queryNode.Point() == queryNode.Parent()->Point());
+
   // Copy the zero set first.
   if ((*referenceMap.begin()).first == INT_MIN)
   {
@@ -195,9 +200,10 @@ DualTreeTraverser<RuleType>::PruneMap(
         continue;
       }
 
-      // If it isn't pruned, we must evaluate the base case.
-      const double baseCase = rule.BaseCase(queryNode.Point(),
-          refNode->Point());
+      // If it isn't pruned, we must evaluate the base case, unless this is the
+      // self-child of the query node the frame was built for.
+      const double baseCase = selfChild ? frame.baseCase :
+          rule.BaseCase(queryNode.Point(), refNode->Point());
 
       // Add to child map.
       newScaleVector.push_back(frame);
@@ -248,9 +254,10 @@ DualTreeTraverser<RuleType>::PruneMap(
         continue;
       }
 
-      // If it isn't pruned, we must evaluate the base case.
-      const double baseCase = rule.BaseCase(queryNode.Point(),
-          refNode->Point());
+      // If it isn't pruned, we must evaluate the base case, unless this is the
+      // self-child of the query node the frame was built for.
+      const double baseCase = selfChild ? frame.baseCase :
+          rule.BaseCase(queryNode.Point(), refNode->Point());
 
       // Add to child map.
       newScaleVector.push_back(frame);
@@ -335,9 +342,12 @@ DualTreeTraverser<RuleType>::ReferenceRecursion(
           continue;
         }
 
-        // It wasn't pruned; evaluate the base case.
-        const double baseCase = rule.BaseCase(queryNode.Point(),
-            refNode->Child(j).Point());
+        // It wasn't pruned; evaluate the base case.  The self-child of the
+        // reference node holds the same point, so its base case is the one of
+        // the frame.
+        const double baseCase = (refNode->Child(j).Point() ==
+            refNode->Point()) ? frame.baseCase :
+            rule.BaseCase(queryNode.Point(), refNode->Child(j).Point());
 
         DualCoverTreeMapEntry newFrame;
         newFrame.referenceNode = &refNode->Child(j);
@@ -138,7 +138,10 @@ class HollowBallBound
    * @param center Vector which the centroid will be written to.
    */
   template<typename VecType>
-  void Center(VecType& center) const { center = this->center; }
+  void Center(VecType& center) const
+  {
+    center = arma::conv_to<VecType>::from(this->center);
+  }
 
   /**
    * Calculates minimum bound-to-point squared distance.
@@ -106,7 +106,8 @@ class HRectBound
    *
    * @param center Vector which the center will be written to.
    */
-  void Center(arma::Col<ElemType>& center) const;
+  template<typename VecType>
+  void Center(VecType& center) const;
 
   /**
    * Calculate the volume of the hyperrectangle.
@@ -221,6 +222,11 @@ class HRectBound
   void serialize(Archive& ar, const unsigned int version);
 
  private:
+  //! Raise the distance along one dimension to the power of the metric.
+  static ElemType DimensionPower(const ElemType v);
+  //! Take the root of a sum of powers, if the metric takes the root.
+  static ElemType Root(const ElemType sum);
+
   //! The dimensionality of the bound.
   size_t dim;
   //! The bounds for each dimension.
@@ -127,8 +127,8 @@ inline void HRectBound<MetricType, ElemType>::Clear()
  * @param centroid Vector which the centroid will be written to.
  */
 template<typename MetricType, typename ElemType>
-inline void HRectBound<MetricType, ElemType>::Center(
-    arma::Col<ElemType>& center) const
+template<typename VecType>
+inline void HRectBound<MetricType, ElemType>::Center(VecType& center) const
 {
   // Set size correctly if necessary.
   if (!(center.n_elem == dim))
@@ -158,6 +158,38 @@ inline ElemType HRectBound<MetricType, ElemType>::Volume() const
   return volume;
 }
 
+/**
+ * Raise the distance along one dimension to the power of the metric.  The
+ * compiler resolves the branches, so that the common cases Power == 1 and
+ * Power == 2 need no call to pow().
+ */
+template<typename MetricType, typename ElemType>
+inline force_inline ElemType HRectBound<MetricType, ElemType>::DimensionPower(
+    const ElemType v)
+{
+  if (MetricType::Power == 1)
+    return v;
+  else if (MetricType::Power == 2)
+    return v * v;
+  else
+    return std::pow(v, (ElemType) MetricType::Power);
+}
+
+/**
+ * Take the Power'th root of a sum of powers, if the metric takes the root.
+ */
+template<typename MetricType, typename ElemType>
+inline force_inline ElemType HRectBound<MetricType, ElemType>::Root(
+    const ElemType sum)
+{
+  if (!MetricType::TakeRoot || MetricType::Power == 1)
+    return sum;
+  else if (MetricType::Power == 2)
+    return (ElemType) std::sqrt(sum);
+  else
+    return (ElemType) pow((double) sum, 1.0 / (double) MetricType::Power);
+}
+
 /**
  * Calculates minimum bound-to-point squared distance.
  */
@@ -169,52 +201,18 @@ inline ElemType HRectBound<MetricType, ElemType>::MinDistance(
 {
   Log::Assert(point.n_elem == dim);
 
+  // At most one of 'lower' and 'higher' is positive, so the distance along
+  // each dimension is the larger of the two, or zero.  std::max() compiles to
+  // a branch-free instruction, so the loop vectorizes.
   ElemType sum = 0;
-
-  ElemType lower, higher;
   for (size_t d = 0; d < dim; d++)
   {
-    lower = bounds[d].Lo() - point[d];
-    higher = point[d] - bounds[d].Hi();
-
-    // Since only one of 'lower' or 'higher' is negative, if we add each's
-    // absolute value to itself and then sum those two, our result is the
-    // nonnegative half of the equation times two; then we raise to power Power.
-    if (MetricType::Power == 1)
-      sum += (lower + std::fabs(lower)) + (higher + std::fabs(higher));
-    else if (MetricType::Power == 2)
-    {
-      ElemType dist = (lower + std::fabs(lower)) + (higher + std::fabs(higher));
-      sum += dist * dist;
-    }
-    else
-    {
-      sum += pow((lower + fabs(lower)) + (higher + fabs(higher)),
-          (ElemType) MetricType::Power);
-    }
+    const ElemType lower = bounds[d].Lo() - point[d];
+    const ElemType higher = point[d] - bounds[d].Hi();
+    sum += DimensionPower(std::max(std::max(lower, higher), (ElemType) 0));
   }
 
-  // Now take the Power'th root (but make sure our result is squared if it needs
-  // to be); then cancel out the constant of 2 (which may have been squared now)
-  // that was introduced earlier.  The compiler should optimize out the if
-  // statement entirely.
-  if (MetricType::Power == 1)
-    return sum * 0.5;
-  else if (MetricType::Power == 2)
-  {
-    if (MetricType::TakeRoot)
-      return (ElemType) std::sqrt(sum) * 0.5;
-    else
-      return sum * 0.25;
-  }
-  else
-  {
-    if (MetricType::TakeRoot)
-      return (ElemType) pow((double) sum,
-          1.0 / (double) MetricType::Power) / 2.0;
-    else
-      return sum / pow(2.0, MetricType::Power);
-  }
+  return Root(sum);
 }
 
 /**
@@ -226,56 +224,17 @@ ElemType HRectBound<MetricType, ElemType>::MinDistance(const HRectBound& other)
 {
   Log::Assert(dim == other.dim);
 
+  // As above, the gap along each dimension is the larger of 'lower' and
+  // 'higher', or zero if the ranges overlap.
   ElemType sum = 0;
-  const math::RangeType<ElemType>* mbound = bounds;
-  const math::RangeType<ElemType>* obound = other.bounds;
-
-  ElemType lower, higher;
   for (size_t d = 0; d < dim; d++)
   {
-    lower = obound->Lo() - mbound->Hi();
-    higher = mbound->Lo() - obound->Hi();
-    // We invoke the following:
-    //   x + fabs(x) = max(x * 2, 0)
-    //   (x * 2)^2 / 4 = x^2
-
-    // The compiler should optimize out this if statement entirely.
-    if (MetricType::Power == 1)
-      sum += (lower + std::fabs(lower)) + (higher + std::fabs(higher));
-    else if (MetricType::Power == 2)
-    {
-      ElemType dist = (lower + std::fabs(lower)) + (higher + std::fabs(higher));
-      sum += dist * dist;
-    }
-    else
-    {
-      sum += pow((lower + fabs(lower)) + (higher + fabs(higher)),
-          (ElemType) MetricType::Power);
-    }
-
-    // Move bound pointers.
-    mbound++;
-    obound++;
+    const ElemType lower = other.bounds[d].Lo() - bounds[d].Hi();
+    const ElemType higher = bounds[d].Lo() - other.bounds[d].Hi();
+    sum += DimensionPower(std::max(std::max(lower, higher), (ElemType) 0));
   }
 
-  // The compiler should optimize out this if statement entirely.
-  if (MetricType::Power == 1)
-    return sum * 0.5;
-  else if (MetricType::Power == 2)
-  {
-    if (MetricType::TakeRoot)
-      return (ElemType) std::sqrt(sum) * 0.5;
-    else
-      return sum * 0.25;
-  }
-  else
-  {
-    if (MetricType::TakeRoot)
-      return (ElemType) pow((double) sum,
-          1.0 / (double) MetricType::Power) / 2.0;
-    else
-      return sum / pow(2.0, MetricType::Power);
-  }
+  return Root(sum);
 }
 
 /**
@@ -287,36 +246,16 @@ inline ElemType HRectBound<MetricType, ElemType>::MaxDistance(
     const VecType& point,
     typename std::enable_if_t<IsVector<VecType>::value>* /* junk */) const
 {
-  ElemType sum = 0;
-
   Log::Assert(point.n_elem == dim);
 
+  ElemType sum = 0;
   for (size_t d = 0; d < dim; d++)
   {
-    ElemType v = std::max(fabs(point[d] - bounds[d].Lo()),
-        fabs(bounds[d].Hi() - point[d]));
-
-    // The compiler should optimize out this if statement entirely.
-    if (MetricType::Power == 1)
-      sum += v; // v is non-negative.
-    else if (MetricType::Power == 2)
-      sum += v * v;
-    else
-      sum += std::pow(v, (ElemType) MetricType::Power);
+    sum += DimensionPower(std::max(point[d] - bounds[d].Lo(),
+        bounds[d].Hi() - point[d]));
   }
 
-  // The compiler should optimize out this if statement entirely.
-  if (MetricType::TakeRoot)
-  {
-    if (MetricType::Power == 1)
-      return sum;
-    else if (MetricType::Power == 2)
-      return (ElemType) std::sqrt(sum);
-    else
-      return (ElemType) pow((double) sum, 1.0 / (double) MetricType::Power);
-  }
-  else
-    return sum;
+  return Root(sum);
 }
 
 /**
@@ -327,37 +266,16 @@ inline ElemType HRectBound<MetricType, ElemType>::MaxDistance(
     const HRectBound& other)
     const
 {
-  ElemType sum = 0;
-
   Log::Assert(dim == other.dim);
 
-  ElemType v;
+  ElemType sum = 0;
   for (size_t d = 0; d < dim; d++)
   {
-    v = std::max(fabs(other.bounds[d].Hi() - bounds[d].Lo()),
-        fabs(bounds[d].Hi() - other.bounds[d].Lo()));
-
-    // The compiler should optimize out this if statement entirely.
-    if (MetricType::Power == 1)
-      sum += v; // v is non-negative.
-    else if (MetricType::Power == 2)
-      sum += v * v;
-    else
-      sum += std::pow(v, (ElemType) MetricType::Power);
+    sum += DimensionPower(std::max(other.bounds[d].Hi() - bounds[d].Lo(),
+        bounds[d].Hi() - other.bounds[d].Lo()));
   }
 
-  // The compiler should optimize out this if statement entirely.
-  if (MetricType::TakeRoot)
-  {
-    if (MetricType::Power == 1)
-      return sum;
-    else if (MetricType::Power == 2)
-      return (ElemType) std::sqrt(sum);
-    else
-      return (ElemType) pow((double) sum, 1.0 / (double) MetricType::Power);
-  }
-  else
-    return sum;
+  return Root(sum);
 }
 
 /**
@@ -368,62 +286,22 @@ inline math::RangeType<ElemType>
 HRectBound<MetricType, ElemType>::RangeDistance(
     const HRectBound& other) const
 {
-  ElemType loSum = 0;
-  ElemType hiSum = 0;
-
   Log::Assert(dim == other.dim);
 
-  ElemType v1, v2, vLo, vHi;
+  // With v1 = other.lo - hi and v2 = lo - other.hi, the gap along a dimension
+  // is max(v1, v2, 0) and the largest extent is max(-v1, -v2); computing both
+  // with std::max() avoids the branches on the signs of v1 and v2.
+  ElemType loSum = 0;
+  ElemType hiSum = 0;
   for (size_t d = 0; d < dim; d++)
   {
-    v1 = other.bounds[d].Lo() - bounds[d].Hi();
-    v2 = bounds[d].Lo() - other.bounds[d].Hi();
-    // One of v1 or v2 is negative.
-    if (v1 >= v2)
-    {
-      vHi = -v2; // Make it nonnegative.
-      vLo = (v1 > 0) ? v1 : 0; // Force to be 0 if negative.
-    }
-    else
-    {
-      vHi = -v1; // Make it nonnegative.
-      vLo = (v2 > 0) ? v2 : 0; // Force to be 0 if negative.
-    }
-
-    // The compiler should optimize out this if statement entirely.
-    if (MetricType::Power == 1)
-    {
-      loSum += vLo; // vLo is non-negative.
-      hiSum += vHi; // vHi is non-negative.
-    }
-    else if (MetricType::Power == 2)
-    {
-      loSum += vLo * vLo;
-      hiSum += vHi * vHi;
-    }
-    else
-    {
-      loSum += std::pow(vLo, (ElemType) MetricType::Power);
-      hiSum += std::pow(vHi, (ElemType) MetricType::Power);
-    }
+    const ElemType v1 = other.bounds[d].Lo() - bounds[d].Hi();
+    const ElemType v2 = bounds[d].Lo() - other.bounds[d].Hi();
+    loSum += DimensionPower(std::max(std::max(v1, v2), (ElemType) 0));
+    hiSum += DimensionPower(std::max(-v1, -v2));
   }
 
-  if (MetricType::TakeRoot)
-  {
-    if (MetricType::Power == 1)
-      return math::RangeType<ElemType>(loSum, hiSum);
-    else if (MetricType::Power == 2)
-      return math::RangeType<ElemType>((ElemType) std::sqrt(loSum),
-                                       (ElemType) std::sqrt(hiSum));
-    else
-    {
-      return math::RangeType<ElemType>(
-          (ElemType) pow((double) loSum, 1.0 / (double) MetricType::Power),
-          (ElemType) pow((double) hiSum, 1.0 / (double) MetricType::Power));
-    }
-  }
-  else
-    return math::RangeType<ElemType>(loSum, hiSum);
+  return math::RangeType<ElemType>(Root(loSum), Root(hiSum));
 }
 
 /**
@@ -436,70 +314,20 @@ HRectBound<MetricType, ElemType>::RangeDistance(
     const VecType& point,
     typename std::enable_if_t<IsVector<VecType>::value>* /* junk */) const
 {
-  ElemType loSum = 0;
-  ElemType hiSum = 0;
-
   Log::Assert(point.n_elem == dim);
 
-  ElemType v1, v2, vLo, vHi;
+  // As above, with v1 = lo - point and v2 = point - hi.
+  ElemType loSum = 0;
+  ElemType hiSum = 0;
   for (size_t d = 0; d < dim; d++)
   {
-    v1 = bounds[d].Lo() - point[d]; // Negative if point[d] > lo.
-    v2 = point[d] - bounds[d].Hi(); // Negative if point[d] < hi.
-    // One of v1 or v2 (or both) is negative.
-    if (v1 >= 0) // point[d] <= bounds_[d].Lo().
-    {
-      vHi = -v2; // v2 will be larger but must be negated.
-      vLo = v1;
-    }
-    else // point[d] is between lo and hi, or greater than hi.
-    {
-      if (v2 >= 0)
-      {
-        vHi = -v1; // v1 will be larger, but must be negated.
-        vLo = v2;
-      }
-      else
-      {
-        vHi = -std::min(v1, v2); // Both are negative, but we need the larger.
-        vLo = 0;
-      }
-    }
-
-    // The compiler should optimize out this if statement entirely.
-    if (MetricType::Power == 1)
-    {
-      loSum += vLo; // vLo is non-negative.
-      hiSum += vHi; // vHi is non-negative.
-    }
-    else if (MetricType::Power == 2)
-    {
-      loSum += vLo * vLo;
-      hiSum += vHi * vHi;
-    }
-    else
-    {
-      loSum += std::pow(vLo, (ElemType) MetricType::Power);
-      hiSum += std::pow(vHi, (ElemType) MetricType::Power);
-    }
+    const ElemType v1 = bounds[d].Lo() - point[d];
+    const ElemType v2 = point[d] - bounds[d].Hi();
+    loSum += DimensionPower(std::max(std::max(v1, v2), (ElemType) 0));
+    hiSum += DimensionPower(std::max(-v1, -v2));
   }
 
-  if (MetricType::TakeRoot)
-  {
-    if (MetricType::Power == 1)
-      return math::RangeType<ElemType>(loSum, hiSum);
-    else if (MetricType::Power == 2)
-      return math::RangeType<ElemType>((ElemType) std::sqrt(loSum),
-                                       (ElemType) std::sqrt(hiSum));
-    else
-    {
-      return math::RangeType<ElemType>(
-          (ElemType) pow((double) loSum, 1.0 / (double) MetricType::Power),
-          (ElemType) pow((double) hiSum, 1.0 / (double) MetricType::Power));
-    }
-  }
-  else
-    return math::RangeType<ElemType>(loSum, hiSum);
+  return math::RangeType<ElemType>(Root(loSum), Root(hiSum));
 }
 
 /**
@@ -512,8 +340,10 @@ HRectBound<MetricType, ElemType>::operator|=(const MatType& data)
 {
   Log::Assert(data.n_rows == dim);
 
-  arma::Col<ElemType> mins(min(data, 1));
-  arma::Col<ElemType> maxs(max(data, 1));
+  // The data may have a different element type than the bound.
+  typedef typename MatType::elem_type DataElemType;
+  arma::Col<DataElemType> mins(min(data, 1));
+  arma::Col<DataElemType> maxs(max(data, 1));
 
   minWidth = std::numeric_limits<ElemType>::max();
   for (size_t i = 0; i < dim; i++)
@@ -15,6 +15,8 @@
 // In case it hasn't been included yet.
 #include "dual_tree_traverser.hpp"
 
+#include <mlpack/core/tree/base_case_block.hpp>
+
 namespace mlpack {
 namespace tree {
 
@@ -57,10 +59,8 @@ void Octree<MetricType, StatisticType, MatType>::DualTreeTraverser<RuleType>::
         continue;
       }
 
-      const size_t rBegin = referenceNode.Point(0);
-      const size_t rEnd = rBegin + referenceNode.NumPoints();
-      for (size_t r = rBegin; r < rEnd; ++r)
-        rule.BaseCase(q, r);
+      BaseCaseBlock(rule, q, referenceNode.Point(0),
+          referenceNode.NumPoints());
 
       numBaseCases += referenceNode.NumPoints();
     }
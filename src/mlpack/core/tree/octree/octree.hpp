@@ -50,7 +50,7 @@ class Octree
   size_t count;
   //! The minimum bounding rectangle of the points held in the node (and its
   //! children).
-  bound::HRectBound<MetricType> bound;
+  bound::HRectBound<MetricType, ElemType> bound;
   //! The dataset.
   MatType* dataset;
   //! The parent (NULL if this node is the root).
@@ -244,9 +244,9 @@ class Octree
   Octree*& Parent() { return parent; }
 
   //! Return the bound object for this node.
-  const bound::HRectBound<MetricType>& Bound() const { return bound; }
+  const bound::HRectBound<MetricType, ElemType>& Bound() const { return bound; }
   //! Modify the bound object for this node.
-  bound::HRectBound<MetricType>& Bound() { return bound; }
+  bound::HRectBound<MetricType, ElemType>& Bound() { return bound; }
 
   //! Return the statistic object for this node.
   const StatisticType& Stat() const { return stat; }
@@ -425,6 +425,39 @@ class Octree
                  std::vector<size_t>& oldFromNew,
                  const size_t maxLeafSize);
 
+  /**
+   * Create the children of the node that have points, once the points of the
+   * node are sorted.  The children are built in parallel if the node holds at
+   * least ParallelCutoff points (and OpenMP is available).
+   *
+   * @param childBegins Index of the first point of each child, followed by the
+   *     index after the last point of the node.
+   * @param center Center of the node.
+   * @param width Width of the current node.
+   * @param oldFromNew Mappings from old to new (NULL if not needed).
+   * @param maxLeafSize Maximum number of points allowed in a leaf.
+   */
+  void BuildChildren(const arma::Col<size_t>& childBegins,
+                     const arma::vec& center,
+                     const double width,
+                     std::vector<size_t>* oldFromNew,
+                     const size_t maxLeafSize);
+
+  /**
+   * Create one child of the node, filling the mappings if oldFromNew is not
+   * NULL.
+   */
+  Octree* NewChild(const size_t childBegin,
+                   const size_t childCount,
+                   std::vector<size_t>* oldFromNew,
+                   const arma::vec& childCenter,
+                   const double childWidth,
+                   const size_t maxLeafSize);
+
+  //! Nodes holding at least this many points have their children built in
+  //! parallel.
+  static const size_t ParallelCutoff = 10000;
+
   /**
    * This is used for sorting points while splitting.
    */
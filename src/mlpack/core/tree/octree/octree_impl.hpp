@@ -735,28 +735,7 @@ void Octree<MetricType, StatisticType, MatType>::SplitNode(
   }
 
   // Now that the dataset is reordered, we can create the children.
-  arma::vec childCenter(center.n_elem);
-  const double childWidth = width / 2.0;
-  for (size_t i = 0; i < childBegins.n_elem - 1; ++i)
-  {
-    // If the child has no points, don't create it.
-    if (childBegins[i + 1] - childBegins[i] == 0)
-      continue;
-
-    // Create the correct center.
-    for (size_t d = 0; d < center.n_elem; ++d)
-    {
-      // Is the dimension "right" (1) or "left" (0)?
-      if (((i >> d) & 1) == 0)
-        childCenter[d] = center[d] - childWidth;
-      else
-        childCenter[d] = center[d] + childWidth;
-    }
-
-    children.push_back(new Octree(this, childBegins[i],
-        childBegins[i + 1] - childBegins[i], childCenter, childWidth,
-        maxLeafSize));
-  }
+  BuildChildren(childBegins, center, width, NULL, maxLeafSize);
 }
 
 //! Split the node, and store mappings.
@@ -837,15 +816,29 @@ void Octree<MetricType, StatisticType, MatType>::SplitNode(
   }
 
   // Now that the dataset is reordered, we can create the children.
-  arma::vec childCenter(center.n_elem);
+  BuildChildren(childBegins, center, width, &oldFromNew, maxLeafSize);
+}
+
+//! Create the children of the node.
+template<typename MetricType, typename StatisticType, typename MatType>
+void Octree<MetricType, StatisticType, MatType>::BuildChildren(
+    const arma::Col<size_t>& childBegins,
+    const arma::vec& center,
+    const double width,
+    std::vector<size_t>* oldFromNew,
+    const size_t maxLeafSize)
+{
+  // Find the children that have points (the others aren't created), and their
+  // centers.
+  std::vector<size_t> indices;
+  std::vector<arma::vec> childCenters;
   const double childWidth = width / 2.0;
   for (size_t i = 0; i < childBegins.n_elem - 1; ++i)
   {
-    // If the child has no points, don't create it.
     if (childBegins[i + 1] - childBegins[i] == 0)
       continue;
 
-    // Create the correct center.
+    arma::vec childCenter(center.n_elem);
     for (size_t d = 0; d < center.n_elem; ++d)
     {
       // Is the dimension "right" (1) or "left" (0)?
@@ -855,10 +848,71 @@ void Octree<MetricType, StatisticType, MatType>::SplitNode(
         childCenter[d] = center[d] + childWidth;
     }
 
-    children.push_back(new Octree(this, childBegins[i],
-        childBegins[i + 1] - childBegins[i], oldFromNew, childCenter,
-        childWidth, maxLeafSize));
+    indices.push_back(i);
+    childCenters.push_back(std::move(childCenter));
   }
+
+  children.assign(indices.size(), NULL);
+
+#if defined(HAS_OPENMP) && (_OPENMP >= 200805)
+  // The children hold disjoint sets of points (and disjoint parts of
+  // oldFromNew), so they can be built at the same time.  OpenMP tasks (from
+  // OpenMP 3.0) are used, so that the children of the children can also be
+  // built in parallel.
+  if (count >= ParallelCutoff)
+  {
+    if (!omp_in_parallel())
+    {
+      // This is the first node that is built in parallel, so start the threads.
+      #pragma omp parallel
+      {
+        #pragma omp single
+        BuildChildren(childBegins, center, width, oldFromNew, maxLeafSize);
+      }
+
+      return;
+    }
+
+    for (size_t c = 0; c < indices.size(); ++c)
+    {
+      #pragma omp task shared(childBegins, indices, childCenters)
+      children[c] = NewChild(childBegins[indices[c]],
+          childBegins[indices[c] + 1] - childBegins[indices[c]], oldFromNew,
+          childCenters[c], childWidth, maxLeafSize);
+    }
+
+    #pragma omp taskwait
+    return;
+  }
+#endif
+
+  for (size_t c = 0; c < indices.size(); ++c)
+  {
+    children[c] = NewChild(childBegins[indices[c]],
+        childBegins[indices[c] + 1] - childBegins[indices[c]], oldFromNew,
+        childCenters[c], childWidth, maxLeafSize);
+  }
+}
+
+//! Create a child of the node.
+template<typename MetricType, typename StatisticType, typename MatType>
+Octree<MetricType, StatisticType, MatType>*
+Octree<MetricType, StatisticType, MatType>::NewChild(
+    const size_t childBegin,
+    const size_t childCount,
+    std::vector<size_t>* oldFromNew,
+    const arma::vec& childCenter,
+    const double childWidth,
+    const size_t maxLeafSize)
+{
+  if (oldFromNew == NULL)
+  {
+    return new Octree(this, childBegin, childCount, childCenter, childWidth,
+        maxLeafSize);
+  }
+
+  return new Octree(this, childBegin, childCount, *oldFromNew, childCenter,
+      childWidth, maxLeafSize);
 }
 
 } // namespace tree
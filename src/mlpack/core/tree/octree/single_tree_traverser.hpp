@@ -30,7 +30,8 @@ class Octree<MetricType, StatisticType, MatType>::SingleTreeTraverser
 
   /**
    * Traverse the reference tree with the given query point.  This does not
-   * reset the number of pruned nodes.
+   * reset the number of pruned nodes.  The traversal is depth-first, but it
+   * uses an explicit stack instead of recursion.
    *
    * @param queryIndex Index of query point.
    * @param referenceNode Node in reference tree.
@@ -47,6 +48,9 @@ class Octree<MetricType, StatisticType, MatType>::SingleTreeTraverser
   RuleType& rule;
   //! The number of reference nodes that have been pruned.
   size_t numPrunes;
+  //! The stack of nodes to traverse, held in the class so that it isn't
+  //! continually being reallocated.
+  std::vector<Octree*> stack;
 };
 
 } // namespace tree
@@ -15,6 +15,9 @@
 // In case it hasn't been included yet.
 #include "single_tree_traverser.hpp"
 
+#include <mlpack/core/tree/base_case_block.hpp>
+#include <mlpack/core/tree/prefetch.hpp>
+
 namespace mlpack {
 namespace tree {
 
@@ -22,7 +25,8 @@ template<typename MetricType, typename StatisticType, typename MatType>
 template<typename RuleType>
 Octree<MetricType, StatisticType, MatType>::SingleTreeTraverser<RuleType>::
     SingleTreeTraverser(RuleType& rule) :
-    rule(rule)
+    rule(rule),
+    numPrunes(0)
 {
   // Nothing to do.
 }
@@ -32,37 +36,49 @@ template<typename RuleType>
 void Octree<MetricType, StatisticType, MatType>::SingleTreeTraverser<RuleType>::
     Traverse(const size_t queryIndex, Octree& referenceNode)
 {
-  // If we are a leaf, run the base cases.
-  if (referenceNode.NumChildren() == 0)
-  {
-    const size_t refBegin = referenceNode.Point(0);
-    const size_t refEnd = refBegin + referenceNode.NumPoints();
-    for (size_t r = refBegin; r < refEnd; ++r)
-      rule.BaseCase(queryIndex, r);
-  }
-  else
+  // The nodes are kept on an explicit stack, so that they are visited in the
+  // order of a depth-first recursion.  Only the entries above the current top
+  // belong to this traversal.
+  const size_t stackBase = stack.size();
+  stack.push_back(&referenceNode);
+
+  while (stack.size() > stackBase)
   {
-    // Do a prioritized recursion, by scoring all candidates and then sorting
+    Octree& node = *stack.back();
+    stack.pop_back();
+
+    // If we are a leaf, run the base cases.
+    if (node.NumChildren() == 0)
+    {
+      BaseCaseBlock(rule, queryIndex, node.Point(0), node.NumPoints());
+      continue;
+    }
+
+    // Do a prioritized traversal, by scoring all candidates and then sorting
     // them.
-    arma::vec scores(referenceNode.NumChildren());
+    arma::vec scores(node.NumChildren());
     for (size_t i = 0; i < scores.n_elem; ++i)
-      scores[i] = rule.Score(queryIndex, referenceNode.Child(i));
+      scores[i] = rule.Score(queryIndex, node.Child(i));
 
     // Sort the scores.
     arma::uvec sortedIndices = arma::sort_index(scores);
 
-    for (size_t i = 0; i < sortedIndices.n_elem; ++i)
-    {
-      // If the node is pruned, all subsequent nodes in sorted order will also
-      // be pruned.
-      if (scores[sortedIndices[i]] == DBL_MAX)
-      {
-        numPrunes += (sortedIndices.n_elem - i);
-        break;
-      }
+    // If a node is pruned, all subsequent nodes in sorted order will also be
+    // pruned.
+    size_t numKept = 0;
+    while (numKept < sortedIndices.n_elem &&
+           scores[sortedIndices[numKept]] != DBL_MAX)
+      ++numKept;
+    numPrunes += (sortedIndices.n_elem - numKept);
 
-      Traverse(queryIndex, referenceNode.Child(sortedIndices[i]));
-    }
+    // Push the kept children in reverse order, so the best one is traversed
+    // first.
+    for (size_t i = numKept; i > 0; --i)
+      stack.push_back(&node.Child(sortedIndices[i - 1]));
+
+    // The best child is visited next.
+    if (numKept > 0)
+      PrefetchNode(stack.back());
   }
 }
 
@@ -0,0 +1,40 @@
+/**
+ * @file prefetch.hpp
+ *
+ * A utility for tree traversers to ask the processor to load a tree node (and
+ * so the bound it holds) into the cache before it is scored.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_PREFETCH_HPP
+#define MLPACK_CORE_TREE_PREFETCH_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * Issue a software prefetch (for reading) of the given node, if the compiler
+ * supports it; otherwise, do nothing.  This is only a hint, so it is always
+ * safe to call.
+ *
+ * @param node Node that will be scored soon.
+ */
+template<typename TreeType>
+inline force_inline void PrefetchNode(const TreeType* node)
+{
+#if defined(__GNUC__)
+  __builtin_prefetch(node, 0, 3);
+#else
+  (void) node;
+#endif
+}
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,126 @@
+/**
+ * @file bulk_load_partition.hpp
+ *
+ * Definition of the BulkLoadPartition class, which orders and groups points (or
+ * nodes) when a RectangleTree is bulk-loaded, using either Sort-Tile-Recursive
+ * or Hilbert curve packing.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_RECTANGLE_TREE_BULK_LOAD_PARTITION_HPP
+#define MLPACK_CORE_TREE_RECTANGLE_TREE_BULK_LOAD_PARTITION_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace tree /** Trees and tree-building procedures. */ {
+
+/**
+ * The BulkLoadPartition class orders a set of points and splits them into
+ * groups of (nearly) equal size, so that the groups are spatially compact.
+ * This is used to build each level of a bulk-loaded RectangleTree: the points
+ * are grouped into leaves, then the centers of the leaves are grouped into
+ * their parents, and so on.  The sizes of any two groups differ by at most one.
+ *
+ * Two strategies are available:
+ *
+ *  - Sort-Tile-Recursive (STR) packing sorts the points along the first
+ *    dimension and cuts them into slabs, and then recursively does the same in
+ *    each slab along the next dimension.
+ *  - Hilbert packing sorts the points by their Hilbert value (see
+ *    DiscreteHilbertValue) and cuts the sorted list into groups.
+ *
+ * The sorts (and the computation of the Hilbert values) are parallelized with
+ * OpenMP, if it is available.
+ *
+ * @code
+ * @article{leutenegger1997str,
+ *   title={STR: A simple and efficient algorithm for R-tree packing},
+ *   author={Leutenegger, Scott T. and Lopez, Mario A. and Edgington, Jeffrey},
+ *   journal={Proceedings of the 13th International Conference on Data
+ *       Engineering},
+ *   pages={497--506},
+ *   year={1997}
+ * }
+ * @endcode
+ */
+class BulkLoadPartition
+{
+ public:
+  /**
+   * Order the columns of the given matrix with Sort-Tile-Recursive packing and
+   * split them into the given number of groups.  Group i holds the columns
+   * order[groupBegins[i]] to order[groupBegins[i + 1] - 1]; groupBegins has
+   * numGroups + 1 elements.
+   *
+   * @param data Points to order (one per column).
+   * @param numGroups Number of groups to split the points into.
+   * @param order Will be filled with the indices of the ordered points.
+   * @param groupBegins Will be filled with the beginnings of the groups.
+   */
+  template<typename MatType>
+  static void STR(const MatType& data,
+                  const size_t numGroups,
+                  std::vector<size_t>& order,
+                  std::vector<size_t>& groupBegins);
+
+  /**
+   * Order the columns of the given matrix by their Hilbert values and split
+   * them into the given number of groups, like STR().
+   *
+   * @param data Points to order (one per column).
+   * @param numGroups Number of groups to split the points into.
+   * @param order Will be filled with the indices of the ordered points.
+   * @param groupBegins Will be filled with the beginnings of the groups.
+   */
+  template<typename MatType>
+  static void Hilbert(const MatType& data,
+                      const size_t numGroups,
+                      std::vector<size_t>& order,
+                      std::vector<size_t>& groupBegins);
+
+  /**
+   * Split n consecutive elements into numGroups groups whose sizes differ by at
+   * most one, and store the beginnings of the groups (and n) in groupBegins.
+   */
+  static void SplitEvenly(const size_t n,
+                          const size_t numGroups,
+                          std::vector<size_t>& groupBegins);
+
+ private:
+  /**
+   * Recursively order the groups [firstGroup, lastGroup) along the given
+   * dimension and the following ones.  The boundaries of all groups are
+   * already known (they are given by groupBegins), so only the points have to
+   * be moved.
+   */
+  template<typename MatType>
+  static void STRSlabs(const MatType& data,
+                       const std::vector<size_t>& groupBegins,
+                       const size_t firstGroup,
+                       const size_t lastGroup,
+                       const size_t dim,
+                       std::vector<size_t>& order);
+
+  /**
+   * Sort order[begin, end) with the given comparator.  If the range is large
+   * and this is not called from inside a parallel region, each thread sorts a
+   * chunk, and the chunks are then merged.
+   */
+  template<typename CompareType>
+  static void ParallelSort(std::vector<size_t>& order,
+                           const size_t begin,
+                           const size_t end,
+                           CompareType comp);
+};
+
+} // namespace tree
+} // namespace mlpack
+
+// Include implementation.
+#include "bulk_load_partition_impl.hpp"
+
+#endif
@@ -0,0 +1,165 @@
+/**
+ * @file bulk_load_partition_impl.hpp
+ *
+ * Implementation of the BulkLoadPartition class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_RECTANGLE_TREE_BULK_LOAD_PARTITION_IMPL_HPP
+#define MLPACK_CORE_TREE_RECTANGLE_TREE_BULK_LOAD_PARTITION_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "bulk_load_partition.hpp"
+#include "discrete_hilbert_value.hpp"
+
+#include <algorithm>
+
+namespace mlpack {
+namespace tree {
+
+template<typename MatType>
+void BulkLoadPartition::STR(const MatType& data,
+                            const size_t numGroups,
+                            std::vector<size_t>& order,
+                            std::vector<size_t>& groupBegins)
+{
+  order.resize(data.n_cols);
+  for (size_t i = 0; i < order.size(); ++i)
+    order[i] = i;
+
+  SplitEvenly(data.n_cols, numGroups, groupBegins);
+  STRSlabs(data, groupBegins, 0, numGroups, 0, order);
+}
+
+template<typename MatType>
+void BulkLoadPartition::Hilbert(const MatType& data,
+                                const size_t numGroups,
+                                std::vector<size_t>& order,
+                                std::vector<size_t>& groupBegins)
+{
+  typedef DiscreteHilbertValue<typename MatType::elem_type> HilbertValueType;
+  typedef typename HilbertValueType::HilbertElemType HilbertElemType;
+
+  // Each Hilbert value is stored as a column; they are compared
+  // lexicographically (as in DiscreteHilbertValue::CompareValues()).
+  arma::Mat<HilbertElemType> values(data.n_rows, data.n_cols);
+
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) data.n_cols; ++i)
+    values.col(i) = HilbertValueType::CalculateValue(data.col(i));
+
+  order.resize(data.n_cols);
+  for (size_t i = 0; i < order.size(); ++i)
+    order[i] = i;
+
+  ParallelSort(order, 0, order.size(),
+      [&values](const size_t a, const size_t b)
+      {
+        for (size_t d = 0; d < values.n_rows; ++d)
+        {
+          if (values(d, a) != values(d, b))
+            return values(d, a) < values(d, b);
+        }
+        return false;
+      });
+
+  SplitEvenly(data.n_cols, numGroups, groupBegins);
+}
+
+inline void BulkLoadPartition::SplitEvenly(const size_t n,
+                                           const size_t numGroups,
+                                           std::vector<size_t>& groupBegins)
+{
+  groupBegins.resize(numGroups + 1);
+  for (size_t i = 0; i <= numGroups; ++i)
+    groupBegins[i] = (n * i) / numGroups;
+}
+
+template<typename MatType>
+void BulkLoadPartition::STRSlabs(const MatType& data,
+                                 const std::vector<size_t>& groupBegins,
+                                 const size_t firstGroup,
+                                 const size_t lastGroup,
+                                 const size_t dim,
+                                 std::vector<size_t>& order)
+{
+  const size_t numGroups = lastGroup - firstGroup;
+  if (numGroups <= 1 || dim == data.n_rows)
+    return;
+
+  const size_t begin = groupBegins[firstGroup];
+  const size_t end = groupBegins[lastGroup];
+  ParallelSort(order, begin, end, [&data, dim](const size_t a, const size_t b)
+      { return data(dim, a) < data(dim, b); });
+
+  // In the last dimension, the sorted points are just cut into groups.
+  if (dim + 1 == data.n_rows)
+    return;
+
+  // Otherwise, cut the points into slabs of whole groups, so that each of the
+  // remaining dimensions is cut the same number of times.
+  const size_t numSlabs = std::min(numGroups, (size_t) std::ceil(
+      std::pow((double) numGroups, 1.0 / (data.n_rows - dim)) - 1e-9));
+
+  // The slabs are independent of each other.
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t s = 0; s < (omp_size_t) numSlabs; ++s)
+  {
+    STRSlabs(data, groupBegins, firstGroup + (numGroups * s) / numSlabs,
+        firstGroup + (numGroups * (s + 1)) / numSlabs, dim + 1, order);
+  }
+}
+
+template<typename CompareType>
+void BulkLoadPartition::ParallelSort(std::vector<size_t>& order,
+                                     const size_t begin,
+                                     const size_t end,
+                                     CompareType comp)
+{
+  size_t numChunks = 1;
+#ifdef HAS_OPENMP
+  // Sorting small ranges in parallel isn't worth it.
+  if (!omp_in_parallel() && end - begin > 10000)
+    numChunks = omp_get_max_threads();
+#endif
+
+  if (numChunks <= 1)
+  {
+    std::sort(order.begin() + begin, order.begin() + end, comp);
+    return;
+  }
+
+  std::vector<size_t> chunkBegins;
+  SplitEvenly(end - begin, numChunks, chunkBegins);
+
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) numChunks; ++i)
+  {
+    std::sort(order.begin() + begin + chunkBegins[i],
+        order.begin() + begin + chunkBegins[i + 1], comp);
+  }
+
+  // Merge neighboring chunks until only one is left.
+  for (size_t width = 1; width < numChunks; width *= 2)
+  {
+    #pragma omp parallel for
+    for (omp_size_t i = 0; i < (omp_size_t) numChunks; i += 2 * width)
+    {
+      if ((size_t) i + width >= numChunks)
+        continue;
+
+      const size_t last = std::min((size_t) i + 2 * width, numChunks);
+      std::inplace_merge(order.begin() + begin + chunkBegins[i],
+          order.begin() + begin + chunkBegins[i + width],
+          order.begin() + begin + chunkBegins[last], comp);
+    }
+  }
+}
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
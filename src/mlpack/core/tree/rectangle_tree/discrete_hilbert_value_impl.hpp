@@ -50,10 +50,11 @@ DiscreteHilbertValue<TreeElemType>::DiscreteHilbertValue(const TreeType* tree) :
   // Calculate the Hilbert value for all points.
   if (!tree->Parent()) // This is the root node.
     ownsLocalHilbertValues = true;
-  else if (tree->Parent()->Child(0).IsLeaf())
+  else if (tree->Parent()->NumChildren() > 0 &&
+           tree->Parent()->Child(0).IsLeaf())
   {
-    // This is a leaf node.
-    assert(tree->Parent()->NumChildren() > 0);
+    // This is a leaf node.  (If the parent doesn't have any children yet, as
+    // when a tree is bulk-loaded, the values are allocated by InsertPoint().)
     ownsLocalHilbertValues = true;
   }
 
@@ -354,6 +355,14 @@ InsertPoint(TreeType *node,
     *valueToInsert = CalculateValue(pt);
   if (node->IsLeaf())
   {
+    if (!localHilbertValues)
+    {
+      localHilbertValues = new arma::Mat<HilbertElemType>(pt.n_rows,
+          node->MaxLeafSize() + 1);
+      ownsLocalHilbertValues = true;
+      numValues = 0;
+    }
+
     // Find an appropriate place.
     for (i = 0; i < numValues; i++)
       if (CompareValues(localHilbertValues->col(i), *valueToInsert) > 0)
@@ -456,6 +465,13 @@ void DiscreteHilbertValue<TreeElemType>::UpdateLargestValue(TreeType* node)
 {
   if (!node->IsLeaf())
   {
+    // Intermediate nodes only point to the values of their last child.
+    if (ownsLocalHilbertValues)
+    {
+      delete localHilbertValues;
+      ownsLocalHilbertValues = false;
+    }
+
     // Update the largest Hilbert value
     localHilbertValues = node->Child(node->NumChildren() -
         1).AuxiliaryInfo().HilbertValue().LocalHilbertValues();
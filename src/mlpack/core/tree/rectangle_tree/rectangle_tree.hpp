@@ -20,10 +20,23 @@
 #include "r_tree_split.hpp"
 #include "r_tree_descent_heuristic.hpp"
 #include "no_auxiliary_information.hpp"
+#include "bulk_load_partition.hpp"
 
 namespace mlpack {
 namespace tree /** Trees and tree-building procedures. */ {
 
+/**
+ * The strategy used to order the points when a RectangleTree is bulk-loaded.
+ * Sort-Tile-Recursive packing works for any rectangle tree whose nodes may
+ * overlap; Hilbert packing keeps the Hilbert order of the points, so it is the
+ * one to use for Hilbert R trees.
+ */
+enum BulkLoadType
+{
+  STR_BULK_LOAD,
+  HILBERT_BULK_LOAD
+};
+
 /**
  * A rectangle type tree tree, such as an R-tree or X-tree.  Once the
  * bound and type of dataset is defined, the tree will construct itself.  Call
@@ -90,7 +103,7 @@ class RectangleTree
   //! The minimum leaf size.
   size_t minLeafSize;
   //! The bound object for this node.
-  bound::HRectBound<metric::EuclideanDistance, ElemType> bound;
+  bound::HRectBound<MetricType, ElemType> bound;
   //! Any extra data contained in the node.
   StatisticType stat;
   //! The distance from the centroid of this node to the centroid of the parent.
@@ -156,6 +169,55 @@ class RectangleTree
                 const size_t minNumChildren = 2,
                 const size_t firstDataIndex = 0);
 
+  /**
+   * Construct this as the root node of a rectangle type tree using the given
+   * dataset, by bulk-loading the points instead of inserting them one at a
+   * time.  The points are packed into full leaves with the given strategy, and
+   * the leaves are then packed into their parents level by level, which is much
+   * faster than repeated insertion and gives nodes with less overlap.  The
+   * ordering and grouping are parallelized with OpenMP, if it is available.
+   *
+   * This is not available for trees whose nodes may not overlap (R+ and R++
+   * trees).
+   *
+   * @param data Dataset from which to create the tree.
+   * @param bulkLoad Strategy used to pack the points (STR_BULK_LOAD or
+   *      HILBERT_BULK_LOAD).
+   * @param maxLeafSize Maximum size of each leaf in the tree.
+   * @param minLeafSize Minimum size of each leaf in the tree.
+   * @param maxNumChildren The maximum number of child nodes a non-leaf node may
+   *      have.
+   * @param minNumChildren The minimum number of child nodes a non-leaf node may
+   *      have.
+   */
+  RectangleTree(const MatType& data,
+                const BulkLoadType bulkLoad,
+                const size_t maxLeafSize = 20,
+                const size_t minLeafSize = 8,
+                const size_t maxNumChildren = 5,
+                const size_t minNumChildren = 2);
+
+  /**
+   * Construct this as the root node of a rectangle type tree by bulk-loading
+   * the given dataset (see above), and taking ownership of the dataset.
+   *
+   * @param data Dataset from which to create the tree.
+   * @param bulkLoad Strategy used to pack the points (STR_BULK_LOAD or
+   *      HILBERT_BULK_LOAD).
+   * @param maxLeafSize Maximum size of each leaf in the tree.
+   * @param minLeafSize Minimum size of each leaf in the tree.
+   * @param maxNumChildren The maximum number of child nodes a non-leaf node may
+   *      have.
+   * @param minNumChildren The minimum number of child nodes a non-leaf node may
+   *      have.
+   */
+  RectangleTree(MatType&& data,
+                const BulkLoadType bulkLoad,
+                const size_t maxLeafSize = 20,
+                const size_t minLeafSize = 8,
+                const size_t maxNumChildren = 5,
+                const size_t minNumChildren = 2);
+
   /**
    * Construct this as an empty node with the specified parent.  Copying the
    * parameters (maxLeafSize, minLeafSize, maxNumChildren, minNumChildren,
@@ -297,9 +359,9 @@ class RectangleTree
   RectangleTree* FindByBeginCount(size_t begin, size_t count);
 
   //! Return the bound object for this node.
-  const bound::HRectBound<MetricType>& Bound() const { return bound; }
+  const bound::HRectBound<MetricType, ElemType>& Bound() const { return bound; }
   //! Modify the bound object for this node.
-  bound::HRectBound<MetricType>& Bound() { return bound; }
+  bound::HRectBound<MetricType, ElemType>& Bound() { return bound; }
 
   //! Return the statistic object for this node.
   const StatisticType& Stat() const { return stat; }
@@ -542,6 +604,29 @@ class RectangleTree
    */
   void SplitNode(std::vector<bool>& relevels);
 
+  /**
+   * Build the whole tree under this (empty) root node by bulk-loading the
+   * dataset with the given strategy.
+   */
+  void BulkLoad(const BulkLoadType bulkLoad);
+
+  /**
+   * Build the subtree of a bulk-loaded tree rooted at this (empty) node.  Node
+   * i of level l groups the nodes levels[l - 1][levels[l][i].first] to
+   * levels[l - 1][levels[l][i].second - 1] (or, for a leaf, the points
+   * pointOrder[levels[0][i].first] to pointOrder[levels[0][i].second - 1]).
+   *
+   * @param levels Ranges of the nodes of each level of the tree.
+   * @param level Level of this node (0 for a leaf).
+   * @param index Index of this node in its level.
+   * @param pointOrder Ordering of the points.
+   */
+  void BuildBulkLoadedNode(
+      const std::vector<std::vector<std::pair<size_t, size_t>>>& levels,
+      const size_t level,
+      const size_t index,
+      const std::vector<size_t>& pointOrder);
+
  protected:
   /**
    * A default constructor.  This is meant to only be used with
@@ -595,7 +680,8 @@ class RectangleTree
    *      shrinking.
    * @return true if the bound needed to be changed, false if it did not.
    */
-  bool ShrinkBoundForBound(const bound::HRectBound<MetricType>& changedBound);
+  bool ShrinkBoundForBound(
+      const bound::HRectBound<MetricType, ElemType>& changedBound);
 
   /**
    * Make an exact copy of this node, pointers and everything.
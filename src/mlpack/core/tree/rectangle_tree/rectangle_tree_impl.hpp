@@ -17,6 +17,7 @@
 
 #include <mlpack/core/util/cli.hpp>
 #include <mlpack/core/util/log.hpp>
+#include <mlpack/core/tree/tree_traits.hpp>
 
 namespace mlpack {
 namespace tree {
@@ -101,6 +102,74 @@ RectangleTree(MatType&& data,
     root->InsertPoint(i);
 }
 
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         typename SplitType,
+         typename DescentType,
+         template<typename> class AuxiliaryInformationType>
+RectangleTree<MetricType, StatisticType, MatType, SplitType, DescentType,
+              AuxiliaryInformationType>::
+RectangleTree(const MatType& data,
+              const BulkLoadType bulkLoad,
+              const size_t maxLeafSize,
+              const size_t minLeafSize,
+              const size_t maxNumChildren,
+              const size_t minNumChildren) :
+    maxNumChildren(maxNumChildren),
+    minNumChildren(minNumChildren),
+    numChildren(0),
+    children(maxNumChildren + 1), // Add one to make splitting the node simpler.
+    parent(NULL),
+    begin(0),
+    count(0),
+    numDescendants(0),
+    maxLeafSize(maxLeafSize),
+    minLeafSize(minLeafSize),
+    bound(data.n_rows),
+    parentDistance(0),
+    dataset(new MatType(data)),
+    ownsDataset(true),
+    points(maxLeafSize + 1), // Add one to make splitting the node simpler.
+    auxiliaryInfo(this)
+{
+  BulkLoad(bulkLoad);
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         typename SplitType,
+         typename DescentType,
+         template<typename> class AuxiliaryInformationType>
+RectangleTree<MetricType, StatisticType, MatType, SplitType, DescentType,
+              AuxiliaryInformationType>::
+RectangleTree(MatType&& data,
+              const BulkLoadType bulkLoad,
+              const size_t maxLeafSize,
+              const size_t minLeafSize,
+              const size_t maxNumChildren,
+              const size_t minNumChildren) :
+    maxNumChildren(maxNumChildren),
+    minNumChildren(minNumChildren),
+    numChildren(0),
+    children(maxNumChildren + 1), // Add one to make splitting the node simpler.
+    parent(NULL),
+    begin(0),
+    count(0),
+    numDescendants(0),
+    maxLeafSize(maxLeafSize),
+    minLeafSize(minLeafSize),
+    bound(data.n_rows),
+    parentDistance(0),
+    dataset(new MatType(std::move(data))),
+    ownsDataset(true),
+    points(maxLeafSize + 1), // Add one to make splitting the node simpler.
+    auxiliaryInfo(this)
+{
+  BulkLoad(bulkLoad);
+}
+
 template<typename MetricType,
          typename StatisticType,
          typename MatType,
@@ -893,6 +962,183 @@ void RectangleTree<MetricType, StatisticType, MatType, SplitType, DescentType,
   }
 }
 
+/**
+ * Bulk-load the dataset: the points are packed into leaves, and then each level
+ * of nodes is packed into the next one, until only the children of the root are
+ * left.  The nodes are only created once the whole structure is known.
+ */
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         typename SplitType,
+         typename DescentType,
+         template<typename> class AuxiliaryInformationType>
+void RectangleTree<MetricType, StatisticType, MatType, SplitType, DescentType,
+                   AuxiliaryInformationType>::
+    BulkLoad(const BulkLoadType bulkLoad)
+{
+  // Packing the nodes would give overlapping children.
+  static_assert(TreeTraits<RectangleTree>::HasOverlappingChildren,
+      "RectangleTree: bulk-loading is not available for trees whose children "
+      "may not overlap.");
+
+  const size_t numPoints = dataset->n_cols;
+  if (numPoints <= maxLeafSize)
+  {
+    // A single leaf is enough.
+    stat = StatisticType(*this);
+    for (size_t i = 0; i < numPoints; i++)
+      InsertPoint(i);
+    return;
+  }
+
+  // Pack the points into leaves.
+  std::vector<size_t> pointOrder, groupBegins;
+  size_t numGroups = (numPoints + maxLeafSize - 1) / maxLeafSize;
+  if (bulkLoad == HILBERT_BULK_LOAD)
+    BulkLoadPartition::Hilbert(*dataset, numGroups, pointOrder, groupBegins);
+  else
+    BulkLoadPartition::STR(*dataset, numGroups, pointOrder, groupBegins);
+
+  std::vector<std::vector<std::pair<size_t, size_t>>> levels(1);
+  levels[0].resize(numGroups);
+  for (size_t i = 0; i < numGroups; i++)
+    levels[0][i] = std::make_pair(groupBegins[i], groupBegins[i + 1]);
+
+  // The bounds of the nodes of the current level.
+  arma::Mat<ElemType> lo(dataset->n_rows, numGroups);
+  arma::Mat<ElemType> hi(dataset->n_rows, numGroups);
+
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) numGroups; i++)
+  {
+    lo.col(i) = dataset->col(pointOrder[levels[0][i].first]);
+    hi.col(i) = lo.col(i);
+    for (size_t j = levels[0][i].first + 1; j < levels[0][i].second; j++)
+    {
+      lo.col(i) = arma::min(lo.col(i), dataset->col(pointOrder[j]));
+      hi.col(i) = arma::max(hi.col(i), dataset->col(pointOrder[j]));
+    }
+  }
+
+  // Pack the nodes of each level into their parents, until the remaining nodes
+  // fit into the root.
+  while (levels.back().size() > maxNumChildren)
+  {
+    const size_t numNodes = levels.back().size();
+    numGroups = (numNodes + maxNumChildren - 1) / maxNumChildren;
+
+    // Hilbert R trees need the Hilbert order of the leaves to be kept, so the
+    // nodes are only reordered with STR packing (by their centers).
+    if (bulkLoad == STR_BULK_LOAD)
+    {
+      std::vector<size_t> nodeOrder;
+      const arma::Mat<ElemType> centers = (lo + hi) / 2;
+      BulkLoadPartition::STR(centers, numGroups, nodeOrder, groupBegins);
+
+      std::vector<std::pair<size_t, size_t>> ranges(numNodes);
+      for (size_t i = 0; i < numNodes; i++)
+        ranges[i] = levels.back()[nodeOrder[i]];
+      levels.back().swap(ranges);
+
+      const arma::uvec indices = arma::conv_to<arma::uvec>::from(nodeOrder);
+      lo = arma::Mat<ElemType>(lo.cols(indices));
+      hi = arma::Mat<ElemType>(hi.cols(indices));
+    }
+    else
+    {
+      BulkLoadPartition::SplitEvenly(numNodes, numGroups, groupBegins);
+    }
+
+    levels.push_back(std::vector<std::pair<size_t, size_t>>(numGroups));
+    arma::Mat<ElemType> newLo(dataset->n_rows, numGroups);
+    arma::Mat<ElemType> newHi(dataset->n_rows, numGroups);
+    for (size_t i = 0; i < numGroups; i++)
+    {
+      levels.back()[i] = std::make_pair(groupBegins[i], groupBegins[i + 1]);
+      newLo.col(i) = arma::min(lo.cols(groupBegins[i], groupBegins[i + 1] - 1),
+          1);
+      newHi.col(i) = arma::max(hi.cols(groupBegins[i], groupBegins[i + 1] - 1),
+          1);
+    }
+
+    lo.swap(newLo);
+    hi.swap(newHi);
+  }
+
+  // Now create the nodes, from the root down to the leaves.
+  const size_t level = levels.size() - 1;
+  for (size_t i = 0; i < levels[level].size(); i++)
+  {
+    RectangleTree* child = new RectangleTree(this);
+    children[numChildren++] = child;
+    child->BuildBulkLoadedNode(levels, level, i, pointOrder);
+
+    bound |= child->Bound();
+    numDescendants += child->NumDescendants();
+  }
+
+  stat = StatisticType(*this);
+}
+
+/**
+ * Build one node of a bulk-loaded tree and all of its descendants.
+ */
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         typename SplitType,
+         typename DescentType,
+         template<typename> class AuxiliaryInformationType>
+void RectangleTree<MetricType, StatisticType, MatType, SplitType, DescentType,
+                   AuxiliaryInformationType>::
+    BuildBulkLoadedNode(
+        const std::vector<std::vector<std::pair<size_t, size_t>>>& levels,
+        const size_t level,
+        const size_t index,
+        const std::vector<size_t>& pointOrder)
+{
+  const std::pair<size_t, size_t>& range = levels[level][index];
+
+  if (level == 0)
+  {
+    // The auxiliary information of the ancestors has to see each point first,
+    // from the root down, like in InsertPoint().
+    std::vector<RectangleTree*> ancestors;
+    for (RectangleTree* node = parent; node != NULL; node = node->Parent())
+      ancestors.push_back(node);
+
+    for (size_t i = range.first; i < range.second; i++)
+    {
+      const size_t point = pointOrder[i];
+      for (size_t j = ancestors.size(); j > 0; j--)
+      {
+        ancestors[j - 1]->auxiliaryInfo.HandlePointInsertion(ancestors[j - 1],
+            point);
+      }
+
+      bound |= dataset->col(point);
+      numDescendants++;
+      if (!auxiliaryInfo.HandlePointInsertion(this, point))
+        points[count++] = point;
+    }
+  }
+  else
+  {
+    for (size_t i = range.first; i < range.second; i++)
+    {
+      RectangleTree* child = new RectangleTree(this);
+      children[numChildren++] = child;
+      child->BuildBulkLoadedNode(levels, level - 1, i, pointOrder);
+
+      bound |= child->Bound();
+      numDescendants += child->NumDescendants();
+    }
+  }
+
+  stat = StatisticType(*this);
+}
+
 //! Default constructor for boost::serialization.
 template<typename MetricType,
          typename StatisticType,
@@ -1212,7 +1458,7 @@ template<typename MetricType,
          template<typename> class AuxiliaryInformationType>
 bool RectangleTree<MetricType, StatisticType, MatType, SplitType, DescentType,
                    AuxiliaryInformationType>::
-    ShrinkBoundForBound(const bound::HRectBound<MetricType>& /* b */)
+    ShrinkBoundForBound(const bound::HRectBound<MetricType, ElemType>& /* b */)
 {
   // Using the sum is safe since none of the dimensions can increase.
   ElemType sum = 0;
@@ -38,7 +38,8 @@ class RectangleTree<MetricType, StatisticType, MatType, SplitType,
   SingleTreeTraverser(RuleType& rule);
 
   /**
-   * Traverse the tree with the given point.
+   * Traverse the tree with the given point.  The traversal is depth-first, but
+   * it uses an explicit stack instead of recursion.
    *
    * @param queryIndex The index of the point in the query set which is being
    *     used as the query point.
@@ -70,6 +71,22 @@ class RectangleTree<MetricType, StatisticType, MatType, SplitType,
 
   //! The number of nodes which have been prenud during traversal.
   size_t numPrunes;
+
+  //! A node waiting to be traversed, after its better-scored siblings.
+  struct StackEntry
+  {
+    //! The node.
+    RectangleTree* node;
+    //! The score of the node.
+    double score;
+    //! The number of siblings left to traverse, including this node; they are
+    //! the entries below this one on the stack.
+    size_t numRemaining;
+  };
+
+  //! The stack of nodes to traverse, held in the class so that it isn't
+  //! continually being reallocated.
+  std::vector<StackEntry> stack;
 };
 
 } // namespace tree
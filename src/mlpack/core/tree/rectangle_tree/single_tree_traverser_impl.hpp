@@ -17,7 +17,8 @@
 #include "single_tree_traverser.hpp"
 
 #include <algorithm>
-#include <stack>
+
+#include <mlpack/core/tree/prefetch.hpp>
 
 namespace mlpack {
 namespace tree {
@@ -49,39 +50,62 @@ SingleTreeTraverser<RuleType>::Traverse(
     const size_t queryIndex,
     const RectangleTree& referenceNode)
 {
-  // If we reach a leaf node, we need to run the base case.
-  if (referenceNode.IsLeaf())
-  {
-    for (size_t i = 0; i < referenceNode.Count(); i++)
-      rule.BaseCase(queryIndex, referenceNode.Point(i));
-
-    return;
-  }
-
-  // This is not a leaf node so we sort the children of this node by their
-  // scores.
-  std::vector<NodeAndScore> nodesAndScores(referenceNode.NumChildren());
-  for (size_t i = 0; i < referenceNode.NumChildren(); i++)
-  {
-    nodesAndScores[i].node = &(referenceNode.Child(i));
-    nodesAndScores[i].score = rule.Score(queryIndex, *nodesAndScores[i].node);
-  }
-
-  std::sort(nodesAndScores.begin(), nodesAndScores.end(), NodeComparator);
+  // The children of each node are pushed on an explicit stack, so that they
+  // are rescored and visited in the order of a depth-first recursion.  Only the
+  // entries above the current top belong to this traversal.
+  const size_t stackBase = stack.size();
+  const RectangleTree* node = &referenceNode;
 
-  // Now iterate through them starting with the best and stopping when we reach
-  // one that isn't good enough.
-  for (size_t i = 0; i < referenceNode.NumChildren(); i++)
+  while (node != NULL)
   {
-    if (rule.Rescore(queryIndex, *nodesAndScores[i].node,
-        nodesAndScores[i].score) != DBL_MAX)
+    // If we reach a leaf node, we need to run the base case.
+    if (node->IsLeaf())
     {
-      Traverse(queryIndex, *nodesAndScores[i].node);
+      for (size_t i = 0; i < node->Count(); i++)
+        rule.BaseCase(queryIndex, node->Point(i));
     }
     else
     {
-      numPrunes += referenceNode.NumChildren() - i;
-      return;
+      // This is not a leaf node so we sort the children of this node by their
+      // scores.
+      std::vector<NodeAndScore> nodesAndScores(node->NumChildren());
+      for (size_t i = 0; i < node->NumChildren(); i++)
+      {
+        nodesAndScores[i].node = &(node->Child(i));
+        nodesAndScores[i].score = rule.Score(queryIndex,
+            *nodesAndScores[i].node);
+      }
+
+      std::sort(nodesAndScores.begin(), nodesAndScores.end(), NodeComparator);
+
+      // Push them starting with the worst, so that the best is traversed
+      // first.
+      for (size_t i = nodesAndScores.size(); i > 0; i--)
+      {
+        StackEntry entry = { nodesAndScores[i - 1].node,
+            nodesAndScores[i - 1].score, nodesAndScores.size() - i + 1 };
+        stack.push_back(entry);
+      }
+
+      PrefetchNode(stack.back().node);
+    }
+
+    // Find the next node that is still good enough.  When a node isn't, none
+    // of its remaining siblings are traversed.
+    node = NULL;
+    while (stack.size() > stackBase)
+    {
+      const StackEntry entry = stack.back();
+      stack.pop_back();
+
+      if (rule.Rescore(queryIndex, *entry.node, entry.score) != DBL_MAX)
+      {
+        node = entry.node;
+        break;
+      }
+
+      numPrunes += entry.numRemaining;
+      stack.resize(stack.size() - (entry.numRemaining - 1));
     }
   }
 }
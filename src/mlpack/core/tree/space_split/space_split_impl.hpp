@@ -93,9 +93,11 @@ bool SpaceSplit<MetricType, MatType>::GetProjVector(
     return false;
 
   // Calculate the normalized projection vector.
-  projVector = ProjVector(data.col(snd) - data.col(fst));
+  projVector = ProjVector(arma::conv_to<arma::vec>::from(data.col(snd) -
+      data.col(fst)));
 
-  arma::vec midPoint = (data.col(snd) + data.col(fst)) / 2;
+  arma::vec midPoint = arma::conv_to<arma::vec>::from((data.col(snd) +
+      data.col(fst)) / 2);
 
   midValue = projVector.Project(midPoint);
 
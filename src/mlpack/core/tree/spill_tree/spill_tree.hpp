@@ -91,8 +91,12 @@ class SpillTree
   //! children).
   size_t count;
   //! The list of indexes of points contained in this node (non-null for
-  //! leaf nodes).
+  //! leaf nodes).  After construction, it is an alias of a part of the
+  //! root's pointsArena.
   arma::Col<size_t>* pointsIndex;
+  //! The indexes of the points of all the leaves, stored contiguously in
+  //! depth-first order (non-null only for the root of a built tree).
+  arma::Col<size_t>* pointsArena;
   //! Flag to distinguish overlapping nodes from non-overlapping nodes.
   bool overlappingNode;
   //! Splitting hyperplane represented by this node.
@@ -154,11 +158,14 @@ class SpillTree
    * @param tau Overlapping size.
    * @param maxLeafSize Size of each leaf in the tree.
    * @param rho Balance threshold.
+   * @param parallelCutoff Nodes holding at least this many points have their
+   *     children built in parallel (if OpenMP is available).
    */
   SpillTree(const MatType& data,
             const double tau = 0,
             const size_t maxLeafSize = 20,
-            const double rho = 0.7);
+            const double rho = 0.7,
+            const size_t parallelCutoff = 10000);
 
   /**
    * Construct this as the root node of a hybrid spill tree using the given
@@ -170,11 +177,14 @@ class SpillTree
    * @param tau Overlapping size.
    * @param maxLeafSize Size of each leaf in the tree.
    * @param rho Balance threshold.
+   * @param parallelCutoff Nodes holding at least this many points have their
+   *     children built in parallel (if OpenMP is available).
    */
   SpillTree(MatType&& data,
             const double tau = 0,
             const size_t maxLeafSize = 20,
-            const double rho = 0.7);
+            const double rho = 0.7,
+            const size_t parallelCutoff = 10000);
 
   /**
    * Construct this node as a child of the given parent, including the given
@@ -186,12 +196,15 @@ class SpillTree
    * @param tau Overlapping size.
    * @param maxLeafSize Size of each leaf in the tree.
    * @param rho Balance threshold.
+   * @param parallelCutoff Nodes holding at least this many points have their
+   *     children built in parallel (if OpenMP is available).
    */
   SpillTree(SpillTree* parent,
             arma::Col<size_t>& points,
             const double tau = 0,
             const size_t maxLeafSize = 20,
-            const double rho = 0.7);
+            const double rho = 0.7,
+            const size_t parallelCutoff = 10000);
 
   /**
    * Create a hybrid spill tree by copying the other tree.  Be careful!  This
@@ -431,11 +444,40 @@ class SpillTree
    * @param maxLeafSize Maximum number of points held in a leaf.
    * @param tau Overlapping size.
    * @param rho Balance threshold.
+   * @param parallelCutoff Nodes holding at least this many points have their
+   *     children built in parallel.
    */
   void SplitNode(arma::Col<size_t>& points,
                  const size_t maxLeafSize,
                  const double tau,
-                 const double rho);
+                 const double rho,
+                 const size_t parallelCutoff);
+
+  /**
+   * Build the children of this node, in parallel if the node holds at least
+   * parallelCutoff points.
+   *
+   * @param leftPoints Indexes of points to be included in left child.
+   * @param rightPoints Indexes of points to be included in right child.
+   * @param maxLeafSize Maximum number of points held in a leaf.
+   * @param tau Overlapping size.
+   * @param rho Balance threshold.
+   * @param parallelCutoff Nodes holding at least this many points have their
+   *     children built in parallel.
+   */
+  void BuildChildren(arma::Col<size_t>& leftPoints,
+                     arma::Col<size_t>& rightPoints,
+                     const size_t maxLeafSize,
+                     const double tau,
+                     const double rho,
+                     const size_t parallelCutoff);
+
+  /**
+   * Move the point indexes of all the leaves into one contiguous arena owned
+   * by this node (the root), in depth-first order, so that the leaves are not
+   * scattered over the heap.  This is called once the tree is built.
+   */
+  void CompactPoints();
 
   /**
    * Split the list of points.
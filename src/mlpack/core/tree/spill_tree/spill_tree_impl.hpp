@@ -30,12 +30,14 @@ SpillTree(
     const MatType& data,
     const double tau,
     const size_t maxLeafSize,
-    const double rho) :
+    const double rho,
+    const size_t parallelCutoff) :
     left(NULL),
     right(NULL),
     parent(NULL),
     count(0),
     pointsIndex(NULL),
+    pointsArena(NULL),
     overlappingNode(false),
     hyperplane(),
     bound(data.n_rows),
@@ -50,7 +52,8 @@ SpillTree(
         dataset->n_cols);
 
   // Do the actual splitting of this node.
-  SplitNode(points, maxLeafSize, tau, rho);
+  SplitNode(points, maxLeafSize, tau, rho, parallelCutoff);
+  CompactPoints();
 
   // Create the statistic depending on if we are a leaf or not.
   stat = StatisticType(*this);
@@ -67,12 +70,14 @@ SpillTree(
     MatType&& data,
     const double tau,
     const size_t maxLeafSize,
-    const double rho) :
+    const double rho,
+    const size_t parallelCutoff) :
     left(NULL),
     right(NULL),
     parent(NULL),
     count(0),
     pointsIndex(NULL),
+    pointsArena(NULL),
     overlappingNode(false),
     hyperplane(),
     bound(data.n_rows),
@@ -87,7 +92,8 @@ SpillTree(
         dataset->n_cols);
 
   // Do the actual splitting of this node.
-  SplitNode(points, maxLeafSize, tau, rho);
+  SplitNode(points, maxLeafSize, tau, rho, parallelCutoff);
+  CompactPoints();
 
   // Create the statistic depending on if we are a leaf or not.
   stat = StatisticType(*this);
@@ -105,12 +111,14 @@ SpillTree(
     arma::Col<size_t>& points,
     const double tau,
     const size_t maxLeafSize,
-    const double rho) :
+    const double rho,
+    const size_t parallelCutoff) :
     left(NULL),
     right(NULL),
     parent(parent),
     count(0),
     pointsIndex(NULL),
+    pointsArena(NULL),
     overlappingNode(false),
     hyperplane(),
     bound(parent->Dataset().n_rows),
@@ -118,7 +126,7 @@ SpillTree(
     localDataset(false)
 {
   // Perform the actual splitting.
-  SplitNode(points, maxLeafSize, tau, rho);
+  SplitNode(points, maxLeafSize, tau, rho, parallelCutoff);
 
   // Create the statistic depending on if we are a leaf or not.
   stat = StatisticType(*this);
@@ -141,6 +149,7 @@ SpillTree(const SpillTree& other) :
     parent(other.parent),
     count(other.count),
     pointsIndex(NULL),
+    pointsArena(NULL),
     overlappingNode(other.overlappingNode),
     hyperplane(other.hyperplane),
     bound(other.bound),
@@ -208,6 +217,7 @@ SpillTree(SpillTree&& other) :
     parent(other.parent),
     count(other.count),
     pointsIndex(other.pointsIndex),
+    pointsArena(other.pointsArena),
     overlappingNode(other.overlappingNode),
     hyperplane(other.hyperplane),
     bound(std::move(other.bound)),
@@ -224,6 +234,7 @@ SpillTree(SpillTree&& other) :
   other.right = NULL;
   other.count = 0;
   other.pointsIndex = NULL;
+  other.pointsArena = NULL;
   other.parentDistance = 0.0;
   other.furthestDescendantDistance = 0.0;
   other.minimumBoundDistance = 0.0;
@@ -275,6 +286,8 @@ SpillTree<MetricType, StatisticType, MatType, HyperplaneType, SplitType>::
   delete left;
   delete right;
   delete pointsIndex;
+  // The leaves only alias the arena, so it is deleted after them.
+  delete pointsArena;
 
   // If we're the root and we own the dataset, delete it.
   if (!parent && localDataset)
@@ -577,7 +590,8 @@ void SpillTree<MetricType, StatisticType, MatType, HyperplaneType, SplitType>::
     SplitNode(arma::Col<size_t>& points,
               const size_t maxLeafSize,
               const double tau,
-              const double rho)
+              const double rho,
+              const size_t parallelCutoff)
 {
   // We need to expand the bounds of this node properly.
   for (size_t i = 0; i < points.n_elem; i++)
@@ -616,8 +630,7 @@ void SpillTree<MetricType, StatisticType, MatType, HyperplaneType, SplitType>::
 
   // Now we will recursively split the children by calling their constructors
   // (which perform this splitting process).
-  left = new SpillTree(this, leftPoints, tau, maxLeafSize, rho);
-  right = new SpillTree(this, rightPoints, tau, maxLeafSize, rho);
+  BuildChildren(leftPoints, rightPoints, maxLeafSize, tau, rho, parallelCutoff);
 
   // Update count number, to represent the number of descendant points.
   count = left->NumDescendants() + right->NumDescendants();
@@ -636,6 +649,113 @@ void SpillTree<MetricType, StatisticType, MatType, HyperplaneType, SplitType>::
   right->ParentDistance() = rightParentDistance;
 }
 
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename HyperplaneMetricType> class HyperplaneType,
+         template<typename SplitMetricType, typename SplitMatType>
+             class SplitType>
+void SpillTree<MetricType, StatisticType, MatType, HyperplaneType, SplitType>::
+    BuildChildren(arma::Col<size_t>& leftPoints,
+                  arma::Col<size_t>& rightPoints,
+                  const size_t maxLeafSize,
+                  const double tau,
+                  const double rho,
+                  const size_t parallelCutoff)
+{
+#if defined(HAS_OPENMP) && (_OPENMP >= 200805)
+  // The children only read the dataset and their own lists of points, so they
+  // can be built at the same time, even if they overlap.  OpenMP tasks (from
+  // OpenMP 3.0) are used, so that the children of the children can also be
+  // built in parallel.
+  if (leftPoints.n_elem + rightPoints.n_elem >= parallelCutoff)
+  {
+    if (!omp_in_parallel())
+    {
+      // This is the first node that is built in parallel, so start the threads.
+      #pragma omp parallel
+      {
+        #pragma omp single
+        BuildChildren(leftPoints, rightPoints, maxLeafSize, tau, rho,
+            parallelCutoff);
+      }
+      return;
+    }
+
+    // The lists of points are swapped into the children, so they must not be
+    // copied into the tasks.
+    #pragma omp task shared(leftPoints)
+    left = new SpillTree(this, leftPoints, tau, maxLeafSize, rho,
+        parallelCutoff);
+
+    #pragma omp task shared(rightPoints)
+    right = new SpillTree(this, rightPoints, tau, maxLeafSize, rho,
+        parallelCutoff);
+
+    #pragma omp taskwait
+    return;
+  }
+#endif
+
+  left = new SpillTree(this, leftPoints, tau, maxLeafSize, rho,
+      parallelCutoff);
+  right = new SpillTree(this, rightPoints, tau, maxLeafSize, rho,
+      parallelCutoff);
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename HyperplaneMetricType> class HyperplaneType,
+         template<typename SplitMetricType, typename SplitMatType>
+             class SplitType>
+void SpillTree<MetricType, StatisticType, MatType, HyperplaneType, SplitType>::
+    CompactPoints()
+{
+  if (IsLeaf())
+    return;
+
+  // Collect the leaves in depth-first order, and the offset of each one in
+  // the arena.
+  std::vector<SpillTree*> leaves;
+  std::vector<size_t> offsets;
+  std::vector<SpillTree*> stack(1, this);
+  size_t total = 0;
+  while (!stack.empty())
+  {
+    SpillTree* node = stack.back();
+    stack.pop_back();
+
+    if (node->IsLeaf())
+    {
+      leaves.push_back(node);
+      offsets.push_back(total);
+      total += node->pointsIndex->n_elem;
+    }
+    else
+    {
+      stack.push_back(node->right);
+      stack.push_back(node->left);
+    }
+  }
+
+  pointsArena = new arma::Col<size_t>(total);
+
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) leaves.size(); ++i)
+  {
+    SpillTree* leaf = leaves[i];
+    const size_t numPoints = leaf->pointsIndex->n_elem;
+    size_t* points = pointsArena->memptr() + offsets[i];
+    std::copy(leaf->pointsIndex->begin(), leaf->pointsIndex->end(), points);
+
+    // The leaf now only holds an alias of its part of the arena.
+    delete leaf->pointsIndex;
+    leaf->pointsIndex = (numPoints == 0) ? new arma::Col<size_t>() :
+        new arma::Col<size_t>(points, numPoints, false, true);
+  }
+}
+
 template<typename MetricType,
          typename StatisticType,
          typename MatType,
@@ -724,6 +844,7 @@ SpillTree<MetricType, StatisticType, MatType, HyperplaneType, SplitType>::
     parent(NULL),
     count(0),
     pointsIndex(NULL),
+    pointsArena(NULL),
     overlappingNode(false),
     stat(*this),
     parentDistance(0),
@@ -756,6 +877,10 @@ void SpillTree<MetricType, StatisticType, MatType, HyperplaneType, SplitType>::
       delete right;
     if (!parent && localDataset)
       delete dataset;
+
+    // The loaded leaves own their point indexes.
+    delete pointsArena;
+    pointsArena = NULL;
   }
 
   ar & BOOST_SERIALIZATION_NVP(parent);
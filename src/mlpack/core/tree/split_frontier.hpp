@@ -0,0 +1,120 @@
+/**
+ * @file split_frontier.hpp
+ *
+ * Functions that split a tree near its root into a frontier of disjoint
+ * subtrees, and traverse those subtrees in parallel; they are used by the
+ * parallel dual-tree traversals of the tree-based methods.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_SPLIT_FRONTIER_HPP
+#define MLPACK_CORE_TREE_SPLIT_FRONTIER_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace tree {
+
+//! A SplitFrontier() callback that does nothing.
+struct NoSplitAction
+{
+  template<typename TreeType>
+  void operator()(TreeType& /* node */) const { }
+};
+
+/**
+ * Split the given tree near its root until the frontier holds at least
+ * minNodes subtrees, or only leaves.  Each split replaces every non-leaf node
+ * of the current frontier with its children, so the frontier always covers
+ * every point of the tree, and (unless the tree's nodes overlap, as in spill
+ * trees) no two of its subtrees hold the same point.
+ *
+ * The given callback is called with each node that is split, before it is
+ * replaced by its children; it can be used to reset statistics of the nodes
+ * above the frontier, which a traversal of the frontier never visits.
+ *
+ * @param root Root of the tree to split.
+ * @param minNodes Number of subtrees to split the tree into, if it can be.
+ * @param onSplit Callback called with each node that is split.
+ * @return The subtrees of the frontier.
+ */
+template<typename TreeType, typename SplitAction = NoSplitAction>
+std::vector<TreeType*> SplitFrontier(TreeType& root,
+                                     const size_t minNodes,
+                                     SplitAction onSplit = SplitAction())
+{
+  std::vector<TreeType*> frontier(1, &root);
+  std::vector<TreeType*> nextFrontier;
+  bool split = true;
+  while (split && frontier.size() < minNodes)
+  {
+    split = false;
+    nextFrontier.clear();
+    for (size_t i = 0; i < frontier.size(); ++i)
+    {
+      if (frontier[i]->NumChildren() == 0)
+      {
+        nextFrontier.push_back(frontier[i]);
+        continue;
+      }
+
+      onSplit(*frontier[i]);
+      for (size_t j = 0; j < frontier[i]->NumChildren(); ++j)
+        nextFrontier.push_back(&frontier[i]->Child(j));
+      split = true;
+    }
+
+    frontier.swap(nextFrontier);
+  }
+
+  return frontier;
+}
+
+/**
+ * Traverse each subtree of the given frontier (from SplitFrontier()) against
+ * the given reference node, in parallel.  Each thread has its own copy of the
+ * rules, which shares the results of the given rules; since no two subtrees of
+ * the frontier hold the same query point, each thread only touches the results
+ * of its own query points.  The traversal info of the copies is reset before
+ * each subtree, since nothing is known about the combination of that subtree
+ * and the reference node, and the counters of the copies are added to the
+ * counters of the given rules at the end.
+ *
+ * The RuleType must be copy-constructible, with the copy starting with empty
+ * counters, and must provide TraversalInfo() and Counters().
+ *
+ * @param frontier Subtrees of the query tree to traverse.
+ * @param referenceNode Root of the reference tree.
+ * @param rules Rules to traverse with.
+ */
+template<typename TraverserType, typename TreeType, typename RuleType>
+void TraverseFrontier(const std::vector<TreeType*>& frontier,
+                      TreeType& referenceNode,
+                      RuleType& rules)
+{
+  #pragma omp parallel
+  {
+    RuleType threadRules(rules);
+    const typename RuleType::TraversalInfoType initialInfo =
+        threadRules.TraversalInfo();
+    TraverserType traverser(threadRules);
+
+    #pragma omp for schedule(dynamic)
+    for (omp_size_t i = 0; i < (omp_size_t) frontier.size(); ++i)
+    {
+      threadRules.TraversalInfo() = initialInfo;
+      traverser.Traverse(*frontier[i], referenceNode);
+    }
+
+    #pragma omp critical
+    rules.Counters() += threadRules.Counters();
+  }
+}
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
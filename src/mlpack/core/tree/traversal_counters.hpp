@@ -0,0 +1,134 @@
+/**
+ * @file traversal_counters.hpp
+ *
+ * Definition of the TraversalCounters class, which counts the work done by the
+ * rules of a tree traversal.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_TRAVERSAL_COUNTERS_HPP
+#define MLPACK_CORE_TREE_TRAVERSAL_COUNTERS_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * The TraversalCounters class counts the work done by the rules of a tree
+ * traversal: base cases, scores, prunes (calls to Score() or Rescore() that
+ * return DBL_MAX), and node visits (calls to Score() that don't prune, so the
+ * traversal recurses into the combination).  It should be held as a member of
+ * the RuleType class, and the interface to it should be through a Counters()
+ * method.
+ *
+ * What a base case or a score is depends on the rules; most rules count calls
+ * to BaseCase() and Score(), but some count distance calculations instead.
+ *
+ * The counters are plain integers, because each rules object is only used by
+ * one thread: parallel traversals give each thread its own copy of the rules,
+ * and add the counters of the copies together at the end with operator+=().
+ *
+ * Base cases and scores are always counted.  Prunes and visits are only counted
+ * when mlpack is compiled with MLPACK_TRAVERSAL_COUNTERS defined (the CMake
+ * option TRAVERSAL_COUNTERS); otherwise ScoreResult() and RescoreResult() just
+ * return the score, and compile to nothing.
+ */
+class TraversalCounters
+{
+ public:
+  //! Initialize all counters to 0.
+  TraversalCounters() : baseCases(0), scores(0), prunes(0), visits(0) { }
+
+  //! Count a base case.
+  void BaseCase() { ++baseCases; }
+  //! Count a score.
+  void Score() { ++scores; }
+
+  /**
+   * Count the result of a call to Score(): a prune if the score is DBL_MAX,
+   * and a visit otherwise.  The score is returned, so that this can wrap the
+   * return value of Score().
+   */
+  double ScoreResult(const double score)
+  {
+#ifdef MLPACK_TRAVERSAL_COUNTERS
+    if (score == DBL_MAX)
+      ++prunes;
+    else
+      ++visits;
+#endif
+    return score;
+  }
+
+  /**
+   * Count the result of a call to Rescore(): a prune if the new score is
+   * DBL_MAX and the old one wasn't (the combination was already counted as
+   * visited when it was scored).  The new score is returned.  This is const,
+   * because Rescore() usually is.
+   */
+  double RescoreResult(const double oldScore, const double score) const
+  {
+#ifdef MLPACK_TRAVERSAL_COUNTERS
+    if (score == DBL_MAX && oldScore != DBL_MAX)
+      ++prunes;
+#endif
+    return score;
+  }
+
+  //! Add the counters of another object (for instance, another thread's).
+  TraversalCounters& operator+=(const TraversalCounters& other)
+  {
+    baseCases += other.baseCases;
+    scores += other.scores;
+    prunes += other.prunes;
+    visits += other.visits;
+    return *this;
+  }
+
+  /**
+   * Print the prunes and node visits to Log::Info, if they are counted.  (Base
+   * cases and scores are printed by the algorithms themselves.)
+   */
+  void Report() const
+  {
+#ifdef MLPACK_TRAVERSAL_COUNTERS
+    Log::Info << prunes << " node combinations were pruned, and " << visits
+        << " were visited." << std::endl;
+#endif
+  }
+
+  //! Get the number of base cases.
+  size_t BaseCases() const { return baseCases; }
+  //! Modify the number of base cases.
+  size_t& BaseCases() { return baseCases; }
+
+  //! Get the number of scores.
+  size_t Scores() const { return scores; }
+  //! Modify the number of scores.
+  size_t& Scores() { return scores; }
+
+  //! Get the number of prunes (0 unless MLPACK_TRAVERSAL_COUNTERS is defined).
+  size_t Prunes() const { return prunes; }
+  //! Get the number of node visits (0 unless MLPACK_TRAVERSAL_COUNTERS is
+  //! defined).
+  size_t Visits() const { return visits; }
+
+ private:
+  //! The number of base cases.
+  size_t baseCases;
+  //! The number of scores.
+  size_t scores;
+  //! The number of prunes (mutable, so that RescoreResult() can be const).
+  mutable size_t prunes;
+  //! The number of node visits.
+  size_t visits;
+};
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
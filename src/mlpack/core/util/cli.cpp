@@ -13,6 +13,7 @@
 #include <boost/program_options.hpp>
 #include <boost/scoped_ptr.hpp>
 #include <iostream>
+#include <mutex>
 
 #include "cli.hpp"
 #include "log.hpp"
@@ -30,6 +31,12 @@ using namespace mlpack::util;
 // Fake ProgramDoc in case none is supplied.
 static ProgramDoc emptyProgramDoc = ProgramDoc("", []() { return ""; });
 
+// The CLI object of the Context active on this thread, if any.
+static thread_local CLI* activeContext = NULL;
+
+// Protects the stored settings, which Contexts copy from.
+static std::mutex settingsMutex;
+
 /* Constructors, Destructors, Copy */
 /* Make the constructor private, to preclude unauthorized instances */
 CLI::CLI() : didParse(false), doc(&emptyProgramDoc)
@@ -133,9 +140,12 @@ bool CLI::HasParam(const std::string& key)
   return (parameters.at(checkKey).wasPassed > 0);
 }
 
-// Returns the sole instance of this class.
+// Returns the sole instance of this class, or the active Context.
 CLI& CLI::GetSingleton()
 {
+  if (activeContext != NULL)
+    return *activeContext;
+
   if (singleton == NULL)
     singleton = new CLI();
 
@@ -192,6 +202,7 @@ void CLI::StoreSettings(const std::string& name)
 {
   // Take all of the parameters and put them in the map.  Clear anything old
   // first.
+  std::lock_guard<std::mutex> lock(settingsMutex);
   std::get<0>(GetSingleton().storageMap[name]) = GetSingleton().parameters;
   std::get<1>(GetSingleton().storageMap[name]) = GetSingleton().aliases;
   std::get<2>(GetSingleton().storageMap[name]) = GetSingleton().functionMap;
@@ -273,3 +284,37 @@ void CLI::ClearSettings()
   GetSingleton().aliases = persistentAliases;
   GetSingleton().functionMap = persistentFunctions;
 }
+
+CLI::Context::Context(const std::string& name) :
+    cli(NULL),
+    previous(activeContext)
+{
+  // The settings are stored in the singleton, even if another Context is
+  // active.
+  activeContext = NULL;
+  CLI& global = GetSingleton();
+  activeContext = previous;
+
+  std::lock_guard<std::mutex> lock(settingsMutex);
+  if (global.storageMap.count(name) == 0)
+  {
+    throw std::invalid_argument("CLI::Context::Context(): no settings stored "
+        "under the name '" + name + "'");
+  }
+
+  cli = new CLI();
+  cli->parameters = std::get<0>(global.storageMap[name]);
+  cli->aliases = std::get<1>(global.storageMap[name]);
+  cli->functionMap = std::get<2>(global.storageMap[name]);
+  cli->programName = global.programName;
+  cli->doc = global.doc;
+  cli->timer.Enabled() = global.timer.Enabled().load();
+
+  activeContext = cli;
+}
+
+CLI::Context::~Context()
+{
+  activeContext = previous;
+  delete cli;
+}
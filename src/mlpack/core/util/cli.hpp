@@ -230,6 +230,9 @@ class CLI
    * as there is no point in defining static methods only to have users call
    * private instance methods.
    *
+   * If a Context is active on the calling thread, its CLI object is returned
+   * instead of the singleton.
+   *
    * @return The singleton instance for use in the static methods.
    */
   static CLI& GetSingleton();
@@ -284,6 +287,57 @@ class CLI
    */
   static void ClearSettings();
 
+  /**
+   * A Context holds its own parameters, aliases, function mappings and timers,
+   * copied from the settings stored under a given name with StoreSettings().
+   * As long as a Context exists, the static methods of CLI called from the
+   * thread that created it use the Context instead of the singleton.  So a
+   * program (its mlpackMain()) can be run by several threads of a process at
+   * once, each with its own Context:
+   *
+   * @code
+   * CLI::Context context("K-Nearest-Neighbors Search");
+   * CLI::GetParam<arma::mat>("reference") = std::move(referenceSet);
+   * CLI::SetPassed("reference");
+   * CLI::GetParam<int>("k") = 5;
+   * CLI::SetPassed("k");
+   * mlpackMain();
+   * arma::Mat<size_t> neighbors = std::move(
+   *     CLI::GetParam<arma::Mat<size_t>>("neighbors"));
+   * @endcode
+   *
+   * Contexts on one thread must be destroyed in the reverse order of their
+   * creation; destroying a Context makes the previous one (or the singleton)
+   * active again.  The settings must all be stored before any Context is
+   * created.
+   */
+  class Context
+  {
+   public:
+    /**
+     * Create a Context holding the settings stored under the given name, and
+     * make it active on this thread.  A std::invalid_argument exception is
+     * thrown if no settings were stored under the name.
+     *
+     * @param name Name of the settings to use.
+     */
+    Context(const std::string& name);
+
+    //! Destroy the Context, and make the previous one active again.
+    ~Context();
+
+   private:
+    //! The CLI object holding the parameters of this Context.
+    CLI* cli;
+    //! The Context that was active when this one was created, if any.
+    CLI* previous;
+
+    //! A Context can't be copied.
+    Context(const Context& other);
+    //! A Context can't be copied.
+    Context& operator=(const Context& other);
+  };
+
  private:
   //! Convenience map from alias values to names.
   std::map<char, std::string> aliases;
@@ -0,0 +1,88 @@
+/**
+ * @file count_allocations.hpp
+ *
+ * Replace the global operator new and operator delete, so that the allocations
+ * of the program are counted by the mlpack timers (see TimerUsage).
+ *
+ * This file is not included by mlpack/core.hpp.  To count allocations, include
+ * it in exactly one source file of the program; it defines the replacement
+ * functions, so including it twice gives multiple definitions.  The counting
+ * itself is two relaxed atomic increments per allocation.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_UTIL_COUNT_ALLOCATIONS_HPP
+#define MLPACK_CORE_UTIL_COUNT_ALLOCATIONS_HPP
+
+#include "timers.hpp"
+
+#include <cstdlib>
+#include <new>
+
+void* operator new(std::size_t size)
+{
+  mlpack::Timer::RecordAllocation(size);
+
+  // operator new must return a unique pointer even for size 0.
+  if (size == 0)
+    size = 1;
+
+  while (true)
+  {
+    void* pointer = std::malloc(size);
+    if (pointer)
+      return pointer;
+
+    std::new_handler handler = std::get_new_handler();
+    if (!handler)
+      throw std::bad_alloc();
+    handler();
+  }
+}
+
+void* operator new[](std::size_t size)
+{
+  return ::operator new(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+  try
+  {
+    return ::operator new(size);
+  }
+  catch (std::bad_alloc&)
+  {
+    return NULL;
+  }
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+  return ::operator new(size, std::nothrow);
+}
+
+void operator delete(void* pointer) noexcept
+{
+  std::free(pointer);
+}
+
+void operator delete[](void* pointer) noexcept
+{
+  std::free(pointer);
+}
+
+void operator delete(void* pointer, const std::nothrow_t&) noexcept
+{
+  std::free(pointer);
+}
+
+void operator delete[](void* pointer, const std::nothrow_t&) noexcept
+{
+  std::free(pointer);
+}
+
+#endif
@@ -95,4 +95,27 @@ class Log
 
 }; // namespace mlpack
 
+/**
+ * Log statements whose arguments are only evaluated when the stream would
+ * print them.  A statement to Log::Debug or Log::Info evaluates (and, for
+ * Log::Info, formats) all of its arguments even when nothing is printed, so in
+ * loops, or when an argument is expensive to compute (an objective value, a
+ * norm), use these instead:
+ *
+ * @code
+ * MLPACK_LOG_INFO << "Objective: " << Objective(data) << "." << std::endl;
+ * @endcode
+ *
+ * MLPACK_LOG_DEBUG compiles to nothing when DEBUG is not defined, and
+ * MLPACK_LOG_INFO skips the statement when verbose output is disabled.
+ */
+#ifdef DEBUG
+  #define MLPACK_LOG_DEBUG mlpack::Log::Debug
+#else
+  #define MLPACK_LOG_DEBUG if (true) { } else mlpack::Log::Debug
+#endif
+
+#define MLPACK_LOG_INFO \
+    if (mlpack::Log::Info.ignoreInput) { } else mlpack::Log::Info
+
 #endif
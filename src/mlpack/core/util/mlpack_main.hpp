@@ -49,6 +49,20 @@ using Option = mlpack::bindings::cli::CLIOption<T>;
 #include <mlpack/core/util/param.hpp>
 #include <mlpack/bindings/cli/parse_command_line.hpp>
 #include <mlpack/bindings/cli/end_program.hpp>
+#include <mlpack/bindings/cli/server.hpp>
+
+/**
+ * Add the --server option to the program.  With --server, the program reads
+ * requests (options given as on the command line) from stdin, one per line,
+ * and answers each of them, so input models are loaded only once; see
+ * mlpack::bindings::cli::RunServer().  Only programs that use their input
+ * models in place (without moving them out or modifying them) should use this.
+ */
+#define BINDING_SERVER_MODE() PARAM_FLAG("server", "If set, run as a server: " \
+    "read requests (options given as on the command line) from stdin, one " \
+    "per line, and answer each of them, keeping input models loaded.  Each " \
+    "response ends with a line 'mlpack: ok' or 'mlpack: error: <message>'.", \
+    "")
 
 void mlpackMain(); // This is typically defined after this include.
 
@@ -62,7 +76,12 @@ int main(int argc, char** argv)
   // A "total_time" timer is run by default for each mlpack program.
   mlpack::Timer::Start("total_time");
 
-  mlpackMain();
+  // In server mode, answer requests until the end of the input.
+  if (mlpack::CLI::Parameters().count("server") &&
+      mlpack::CLI::HasParam("server"))
+    mlpack::bindings::cli::RunServer(mlpackMain);
+  else
+    mlpackMain();
 
   // Print output options, print verbose information, save model parameters,
   // clean up, and so forth.
@@ -93,6 +112,9 @@ using Option = mlpack::bindings::tests::TestOption<T>;
 
 #include <mlpack/core/util/param.hpp>
 
+// Server mode is only available to command-line programs.
+#define BINDING_SERVER_MODE()
+
 #undef PROGRAM_INFO
 #define PROGRAM_INFO(NAME, DESC) static mlpack::util::ProgramDoc \
     cli_programdoc_dummy_object = mlpack::util::ProgramDoc(NAME, \
@@ -128,6 +150,9 @@ using Option = mlpack::bindings::python::PyOption<T>;
 
 #include <mlpack/core/util/param.hpp>
 
+// Server mode is only available to command-line programs.
+#define BINDING_SERVER_MODE()
+
 #undef PROGRAM_INFO
 #define PROGRAM_INFO(NAME, DESC) static mlpack::util::ProgramDoc \
     cli_programdoc_dummy_object = mlpack::util::ProgramDoc(NAME, \
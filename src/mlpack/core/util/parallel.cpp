@@ -0,0 +1,91 @@
+/**
+ * @file parallel.cpp
+ *
+ * Implementation of the Parallel class, which holds the thread budget of
+ * mlpack.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "parallel.hpp"
+
+#include <algorithm>
+
+#ifdef HAS_OPENMP
+  #include <omp.h>
+#endif
+
+using namespace mlpack;
+
+#ifdef HAS_OPENMP
+
+namespace {
+
+// The budget of OpenMP before the first call to SetMaxThreads().
+int DefaultThreads()
+{
+  static const int defaultThreads = omp_get_max_threads();
+  return defaultThreads;
+}
+
+} // anonymous namespace
+
+#endif
+
+Parallel::Scope::Scope(const size_t maxThreads) :
+    previous(Parallel::MaxThreads())
+{
+#ifdef HAS_OPENMP
+  if (maxThreads > 0)
+    omp_set_num_threads((int) std::min(maxThreads, previous));
+#else
+  (void) maxThreads;
+#endif
+}
+
+Parallel::Scope::~Scope()
+{
+#ifdef HAS_OPENMP
+  omp_set_num_threads((int) previous);
+#endif
+}
+
+void Parallel::SetMaxThreads(const size_t maxThreads)
+{
+#ifdef HAS_OPENMP
+  const int defaultThreads = DefaultThreads();
+  omp_set_num_threads((maxThreads == 0) ? defaultThreads : (int) maxThreads);
+#else
+  (void) maxThreads;
+#endif
+}
+
+size_t Parallel::MaxThreads()
+{
+#ifdef HAS_OPENMP
+  return (size_t) omp_get_max_threads();
+#else
+  return 1;
+#endif
+}
+
+size_t Parallel::Threads()
+{
+#if defined(HAS_OPENMP) && (_OPENMP >= 200805)
+  if (omp_get_active_level() >= omp_get_max_active_levels())
+    return 1;
+
+  return (size_t) omp_get_max_threads();
+#elif defined(HAS_OPENMP)
+  // The nesting levels are only known from OpenMP 3.0; before that, a region
+  // opened inside a parallel region is assumed to get a single thread.
+  if (omp_in_parallel())
+    return 1;
+
+  return (size_t) omp_get_max_threads();
+#else
+  return 1;
+#endif
+}
@@ -0,0 +1,101 @@
+/**
+ * @file parallel.hpp
+ *
+ * Definition of the Parallel class, which holds the thread budget of mlpack.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_UTIL_PARALLEL_HPP
+#define MLPACK_CORE_UTIL_PARALLEL_HPP
+
+#include <cstddef>
+
+namespace mlpack {
+
+/**
+ * The thread budget of mlpack.  The parallel code of mlpack is written with
+ * OpenMP, and its parallel regions (and the work split between threads, like
+ * the chunks of a parallel load) are sized with the number of threads OpenMP
+ * gives to the calling thread.  Parallel sets that number, so that a single
+ * setting limits all the parallel code:
+ *
+ *  - SetMaxThreads() sets the budget of the program (the --threads option of
+ *    the command-line programs calls it);
+ *  - a Parallel::Scope object limits the threads of the calls made by the
+ *    calling thread while it lives, for instance to run one algorithm with
+ *    fewer threads than the rest of the program;
+ *  - Threads() gives the number of threads that a parallel region started by
+ *    the calling thread will get.  Inside a parallel region this is 1, unless
+ *    OpenMP is allowed to nest regions, so nested calls (like models trained
+ *    in the parallel folds of KFoldCV) do not oversubscribe the cores.
+ *
+ * The OpenMP runtime schedules the threads of the regions; Parallel only
+ * decides how many there are.  Without OpenMP, mlpack runs on one thread, and
+ * Threads() is always 1.
+ *
+ * @code
+ * Parallel::SetMaxThreads(8);
+ * {
+ *   // The random forest is trained with (at most) 2 threads.
+ *   Parallel::Scope scope(2);
+ *   rf.Train(data, labels, numClasses);
+ * }
+ * @endcode
+ */
+class Parallel
+{
+ public:
+  /**
+   * Limit the threads of the calling thread while the object lives.  The
+   * limit can only lower the budget; the previous budget is restored by the
+   * destructor.
+   */
+  class Scope
+  {
+   public:
+    /**
+     * Limit the threads of the calling thread to the given number.
+     *
+     * @param maxThreads Maximum number of threads (0 leaves the budget as it
+     *     is).
+     */
+    explicit Scope(const size_t maxThreads);
+
+    //! Restore the previous budget.
+    ~Scope();
+
+    Scope(const Scope& other) = delete;
+    Scope& operator=(const Scope& other) = delete;
+
+   private:
+    //! The budget before the object was created.
+    size_t previous;
+  };
+
+  /**
+   * Set the maximum number of threads of the program; this is the budget of
+   * the threads that do not set their own with Parallel::Scope.  It should be
+   * called from the main thread, before the parallel work starts.
+   *
+   * @param maxThreads Maximum number of threads (0 restores the default of
+   *     OpenMP, which is one thread per core unless OMP_NUM_THREADS is set).
+   */
+  static void SetMaxThreads(const size_t maxThreads);
+
+  //! Get the thread budget of the calling thread.
+  static size_t MaxThreads();
+
+  /**
+   * Get the number of threads that a parallel region started by the calling
+   * thread gets: the budget, or 1 if the calling thread is already in a
+   * parallel region that can't be nested.
+   */
+  static size_t Threads();
+};
+
+} // namespace mlpack
+
+#endif
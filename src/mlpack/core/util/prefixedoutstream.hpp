@@ -14,6 +14,7 @@
 #define MLPACK_CORE_UTIL_PREFIXEDOUTSTREAM_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mutex>
 
 namespace mlpack {
 namespace util {
@@ -42,6 +43,11 @@ namespace util {
  *
  * These objects are used for the mlpack::Log levels (DEBUG, INFO, WARN, and
  * FATAL).
+ *
+ * Several threads may write to the same stream: each single insertion (each
+ * call to operator<<) is serialized with a mutex.  A statement made of several
+ * insertions is not written atomically, though, so the pieces of statements
+ * from different threads may interleave, even within a line.
  */
 class PrefixedOutStream
 {
@@ -165,6 +171,9 @@ class PrefixedOutStream
   //! If true, a std::runtime_error exception will be thrown when a CR is
   //! encountered.
   bool fatal;
+
+  //! Serializes the single insertions of different threads to the stream.
+  std::recursive_mutex mutex;
 };
 
 } // namespace util
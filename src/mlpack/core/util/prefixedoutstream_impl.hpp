@@ -38,6 +38,16 @@ template<typename T>
 typename std::enable_if<!arma::is_arma_type<T>::value>::type
 PrefixedOutStream::BaseLogic(const T& val)
 {
+  // Nothing is printed, so there is nothing to format.  A fatal stream still
+  // has to throw at the end of the line.
+  if (ignoreInput && !fatal)
+    return;
+
+  // Several threads (for instance, several programs run at once) may write to
+  // the same stream.  Only this insertion is serialized; the other insertions
+  // of the same statement may be interleaved with those of other threads.
+  std::lock_guard<std::recursive_mutex> lock(mutex);
+
   // We will use this to track whether or not we need to terminate at the end of
   // this call (only for streams which terminate after a newline).
   bool newlined = false;
@@ -146,6 +156,11 @@ template<typename T>
 typename std::enable_if<arma::is_arma_type<T>::value>::type
 PrefixedOutStream::BaseLogic(const T& val)
 {
+  if (ignoreInput && !fatal)
+    return;
+
+  std::lock_guard<std::recursive_mutex> lock(mutex);
+
   // Extract printable object from the input.
   const arma::Mat<typename T::elem_type>& printVal(val);
 
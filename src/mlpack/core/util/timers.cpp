@@ -18,6 +18,15 @@
 #include <map>
 #include <string>
 
+#ifdef _WIN32
+  #ifndef NOMINMAX
+    #define NOMINMAX
+  #endif
+  #include <windows.h>
+#else
+  #include <sys/resource.h>
+#endif
+
 using namespace mlpack;
 using namespace std;
 using namespace chrono;
@@ -46,6 +55,18 @@ microseconds Timer::Get(const string& name)
   return CLI::GetSingleton().timer.GetTimer(name);
 }
 
+/**
+ * Get the resources used while the given timer ran.
+ */
+TimerUsage Timer::GetUsage(const string& name)
+{
+  return CLI::GetSingleton().timer.GetUsage(name);
+}
+
+// The allocation counts.
+atomic<size_t> Timer::allocations(0);
+atomic<size_t> Timer::allocatedBytes(0);
+
 // Enable timing.
 void Timer::EnableTiming()
 {
@@ -69,6 +90,7 @@ void Timers::Reset()
 {
   lock_guard<mutex> lock(timersMutex);
   timers.clear();
+  usage.clear();
   timerStartTime.clear();
 }
 
@@ -88,6 +110,147 @@ microseconds Timers::GetTimer(const string& timerName)
   return timers[timerName];
 }
 
+TimerUsage Timers::GetUsage(const string& timerName)
+{
+  if (!enabled)
+    return TimerUsage();
+
+  lock_guard<mutex> lock(timersMutex);
+  return usage[timerName];
+}
+
+namespace {
+
+//! Write the given string as a JSON string.
+void WriteJSONString(ostream& stream, const string& str)
+{
+  stream << '"';
+  for (size_t i = 0; i < str.size(); ++i)
+  {
+    const unsigned char c = (unsigned char) str[i];
+    if (c == '"' || c == '\\')
+      stream << '\\' << str[i];
+    else if (c < 0x20)
+      stream << "\\u" << hex << setw(4) << setfill('0') << (int) c << dec;
+    else
+      stream << str[i];
+  }
+  stream << '"';
+}
+
+//! Write the given duration as a number of seconds.
+void WriteSeconds(ostream& stream, const microseconds time)
+{
+  stream << (time.count() / 1000000) << "." << setw(6) << setfill('0')
+      << (time.count() % 1000000);
+}
+
+} // namespace
+
+void Timers::WriteJSON(ostream& stream)
+{
+  lock_guard<mutex> lock(timersMutex);
+
+  // Include the time that running timers have run so far.
+  map<string, microseconds> currentTimers = timers;
+  map<string, TimerUsage> currentUsage = usage;
+  const StartState now = CurrentState();
+  for (auto it : timerStartTime)
+  {
+    for (auto it2 : it.second)
+    {
+      currentTimers[it2.first] += duration_cast<microseconds>(now.time -
+          it2.second.time);
+      TimerUsage& u = currentUsage[it2.first];
+      u.cpuTime += now.cpuTime - it2.second.cpuTime;
+      u.allocations += now.allocations - it2.second.allocations;
+      u.allocatedBytes += now.allocatedBytes - it2.second.allocatedBytes;
+    }
+  }
+
+  stream << "{" << endl << "  \"timers\": {";
+  bool first = true;
+  for (auto it : currentTimers)
+  {
+    const TimerUsage& u = currentUsage[it.first];
+    stream << (first ? "" : ",") << endl << "    ";
+    WriteJSONString(stream, it.first);
+    stream << ": {" << endl;
+    stream << "      \"wall_time\": ";
+    WriteSeconds(stream, it.second);
+    stream << "," << endl << "      \"cpu_time\": ";
+    WriteSeconds(stream, u.cpuTime);
+    stream << "," << endl;
+    stream << "      \"peak_memory\": " << u.peakMemory << "," << endl;
+    stream << "      \"allocations\": " << u.allocations << "," << endl;
+    stream << "      \"allocated_bytes\": " << u.allocatedBytes << "," << endl;
+    stream << "      \"runs\": " << u.runs << endl;
+    stream << "    }";
+    first = false;
+  }
+  stream << endl << "  }" << endl << "}" << endl;
+}
+
+Timers::StartState Timers::CurrentState()
+{
+  StartState state;
+  state.time = high_resolution_clock::now();
+  state.allocations = Timer::allocations.load(memory_order_relaxed);
+  state.allocatedBytes = Timer::allocatedBytes.load(memory_order_relaxed);
+
+#ifdef _WIN32
+  FILETIME creationTime, exitTime, kernelTime, userTime;
+  if (GetProcessTimes(GetCurrentProcess(), &creationTime, &exitTime,
+      &kernelTime, &userTime))
+  {
+    // FILETIMEs are in units of 100 nanoseconds.
+    const uint64_t kernel = ((uint64_t) kernelTime.dwHighDateTime << 32) |
+        kernelTime.dwLowDateTime;
+    const uint64_t user = ((uint64_t) userTime.dwHighDateTime << 32) |
+        userTime.dwLowDateTime;
+    state.cpuTime = microseconds((kernel + user) / 10);
+  }
+  else
+  {
+    state.cpuTime = microseconds(0);
+  }
+#else
+  struct rusage resources;
+  getrusage(RUSAGE_SELF, &resources);
+  state.cpuTime = seconds(resources.ru_utime.tv_sec +
+      resources.ru_stime.tv_sec) + microseconds(resources.ru_utime.tv_usec +
+      resources.ru_stime.tv_usec);
+#endif
+
+  return state;
+}
+
+void Timers::AddRun(const string& timerName,
+                    const StartState& start,
+                    const StartState& end)
+{
+  timers[timerName] += duration_cast<microseconds>(end.time - start.time);
+
+  TimerUsage& u = usage[timerName];
+  u.cpuTime += end.cpuTime - start.cpuTime;
+  u.allocations += end.allocations - start.allocations;
+  u.allocatedBytes += end.allocatedBytes - start.allocatedBytes;
+  ++u.runs;
+
+  // The peak resident set size of the process so far.
+#if !defined(_WIN32)
+  struct rusage resources;
+  getrusage(RUSAGE_SELF, &resources);
+  #ifdef __APPLE__
+    // macOS gives the size in bytes...
+    u.peakMemory = (size_t) resources.ru_maxrss;
+  #else
+    // ...but Linux and the BSDs give it in kilobytes.
+    u.peakMemory = (size_t) resources.ru_maxrss * 1024;
+  #endif
+#endif
+}
+
 bool Timers::GetState(const string& timerName,
                       const thread::id& threadId)
 {
@@ -163,10 +326,10 @@ void Timers::StopAllTimers()
   // the map and would invalidate our iterators.
   lock_guard<mutex> lock(timersMutex);
 
-  high_resolution_clock::time_point currTime = high_resolution_clock::now();
+  const StartState currState = CurrentState();
   for (auto it : timerStartTime)
     for (auto it2 : it.second)
-      timers[it2.first] += duration_cast<microseconds>(currTime - it2.second);
+      AddRun(it2.first, it2.second, currState);
 
   // If all timers are stopped, we can clear the maps.
   timerStartTime.clear();
@@ -190,15 +353,16 @@ void Timers::StartTimer(const string& timerName,
     throw runtime_error(error.str());
   }
 
-  high_resolution_clock::time_point currTime = high_resolution_clock::now();
+  const StartState currState = CurrentState();
 
   // If the timer is added for the first time.
   if (timers.count(timerName) == 0)
   {
     timers[timerName] = (microseconds) 0;
+    usage[timerName] = TimerUsage();
   }
 
-  timerStartTime[threadId][timerName] = currTime;
+  timerStartTime[threadId][timerName] = currState;
 }
 
 void Timers::StopTimer(const string& timerName,
@@ -219,11 +383,10 @@ void Timers::StopTimer(const string& timerName,
     throw runtime_error(error.str());
   }
 
-  high_resolution_clock::time_point currTime = high_resolution_clock::now();
+  const StartState currState = CurrentState();
 
-  // Calculate the delta time.
-  timers[timerName] += duration_cast<microseconds>(currTime -
-      timerStartTime[threadId][timerName]);
+  // Calculate the delta time and resource usage.
+  AddRun(timerName, timerStartTime[threadId][timerName], currState);
 
   // Remove the entries.
   timerStartTime[threadId].erase(timerName);
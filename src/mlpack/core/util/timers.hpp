@@ -14,6 +14,7 @@
 #ifndef MLPACK_CORE_UTILITIES_TIMERS_HPP
 #define MLPACK_CORE_UTILITIES_TIMERS_HPP
 
+#include <cstddef>
 #include <map>
 #include <string>
 #include <chrono> // chrono library for cross platform timer calculation.
@@ -21,6 +22,7 @@
 #include <mutex>
 #include <list>
 #include <atomic>
+#include <ostream>
 
 #if defined(_WIN32)
   // uint64_t isn't defined on every windows.
@@ -35,6 +37,39 @@
 
 namespace mlpack {
 
+/**
+ * The resources used while a timer ran, besides its wall-clock time (which is
+ * returned by Timer::Get()).  The values are summed over all the runs of the
+ * timer, except for peakMemory.
+ *
+ * CPU time and allocations are counted for the whole process, so while other
+ * threads are busy they are included too.  Allocations are only counted if the
+ * program includes mlpack/core/util/count_allocations.hpp (which replaces the
+ * global operator new); otherwise they are zero.
+ */
+struct TimerUsage
+{
+  TimerUsage() :
+      cpuTime(0),
+      peakMemory(0),
+      allocations(0),
+      allocatedBytes(0),
+      runs(0)
+  { }
+
+  //! CPU time (user and system) used by the process while the timer ran.
+  std::chrono::microseconds cpuTime;
+  //! Peak resident set size of the process (in bytes) when the timer was last
+  //! stopped, or 0 if it can't be found on this platform.
+  size_t peakMemory;
+  //! Number of calls to operator new while the timer ran.
+  size_t allocations;
+  //! Number of bytes allocated with operator new while the timer ran.
+  size_t allocatedBytes;
+  //! Number of times the timer has been stopped.
+  size_t runs;
+};
+
 /**
  * The timer class provides a way for mlpack methods to be timed.  The three
  * methods contained in this class allow a named timer to be started and
@@ -75,6 +110,27 @@ class Timer
    */
   static std::chrono::microseconds Get(const std::string& name);
 
+  /**
+   * Get the resources used while the given timer ran.
+   *
+   * @param name Name of timer to return the usage of.
+   */
+  static TimerUsage GetUsage(const std::string& name);
+
+  /**
+   * Count an allocation of the given size, for the allocation counts of the
+   * timers.  This is called by the operator new defined in
+   * mlpack/core/util/count_allocations.hpp, but custom allocators may call it
+   * too.  It is thread-safe and does not allocate.
+   *
+   * @param bytes Size of the allocation.
+   */
+  static void RecordAllocation(const size_t bytes)
+  {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    allocatedBytes.fetch_add(bytes, std::memory_order_relaxed);
+  }
+
   /**
    * Enable timing of mlpack programs.  Do not run this while timers are
    * running!
@@ -92,6 +148,15 @@ class Timer
    * existing timers.
    */
   static void ResetAll();
+
+ private:
+  // So that the allocation counts can be read.
+  friend class Timers;
+
+  //! Number of allocations recorded with RecordAllocation().
+  static std::atomic<size_t> allocations;
+  //! Number of bytes allocated, recorded with RecordAllocation().
+  static std::atomic<size_t> allocatedBytes;
 };
 
 class Timers
@@ -119,6 +184,23 @@ class Timers
    */
   std::chrono::microseconds GetTimer(const std::string& timerName);
 
+  /**
+   * Returns a copy of the resource usage of the timer specified.
+   *
+   * @param timerName The name of the timer in question.
+   */
+  TimerUsage GetUsage(const std::string& timerName);
+
+  /**
+   * Write a JSON report of all the timers to the given stream: for each timer,
+   * its wall-clock and CPU time (in seconds), its peak memory, and its
+   * allocation counts.  Running timers are included with the time they have
+   * run so far.
+   *
+   * @param stream Stream to write the report to.
+   */
+  void WriteJSON(std::ostream& stream);
+
   /**
    * Prints the specified timer.  If it took longer than a minute to complete
    * the timer will be displayed in days, hours, and minutes as well.
@@ -172,9 +254,31 @@ class Timers
   std::map<std::string, std::chrono::microseconds> timers;
   //! A mutex for modifying the timers.
   std::mutex timersMutex;
+  //! A map of the resource usage of the timers.
+  std::map<std::string, TimerUsage> usage;
+
+  //! The state of the process when a timer was started.
+  struct StartState
+  {
+    //! Wall-clock time.
+    std::chrono::high_resolution_clock::time_point time;
+    //! CPU time used by the process.
+    std::chrono::microseconds cpuTime;
+    //! Allocations made by the process.
+    size_t allocations;
+    //! Bytes allocated by the process.
+    size_t allocatedBytes;
+  };
+
+  //! Get the current state of the process.
+  static StartState CurrentState();
+
+  //! Add the run of a timer that started in the given state to its totals.
+  void AddRun(const std::string& timerName, const StartState& start,
+              const StartState& end);
+
   //! A map for the starting values of the timers.
-  std::map<std::thread::id, std::map<std::string,
-      std::chrono::high_resolution_clock::time_point>> timerStartTime;
+  std::map<std::thread::id, std::map<std::string, StartState>> timerStartTime;
 
   //! Whether or not timing is enabled.
   std::atomic<bool> enabled;
@@ -70,6 +70,10 @@ namespace adaboost {
  * void Classify(const MatType& data, arma::Row<size_t>& predictedLabels);
  * @endcode
  *
+ * AdaBoost::Classify() calls the Classify() method of each weak learner from
+ * several threads at once (on different batches of points), so it must not
+ * modify the weak learner.
+ *
  * For more information on and examples of weak learners, see
  * perceptron::Perceptron<> and decision_stump::DecisionStump<>.
  *
@@ -86,13 +86,6 @@ void AdaBoost<WeakLearnerType, MatType>::Train(
   // To be used for prediction by the weak learner.
   arma::Row<size_t> predictedLabels(labels.n_cols);
 
-  // Use tempData to modify input data for incorporating weights.
-  MatType tempData(data);
-
-  // This matrix is a helper matrix used to calculate the final hypothesis.
-  arma::mat sumFinalH = arma::zeros<arma::mat>(numClasses,
-      predictedLabels.n_cols);
-
   // Load the initial weights into a 2-D matrix.
   const double initWeight = 1.0 / double(data.n_cols * numClasses);
   arma::mat D(numClasses, data.n_cols);
@@ -101,38 +94,23 @@ void AdaBoost<WeakLearnerType, MatType>::Train(
   // Weights are stored in this row vector.
   arma::rowvec weights(predictedLabels.n_cols);
 
-  // This is the final hypothesis.
-  arma::Row<size_t> finalH(predictedLabels.n_cols);
-
   // Now, start the boosting rounds.
   for (size_t i = 0; i < iterations; i++)
   {
-    // Initialized to zero in every round.  rt is used for calculation of
-    // alphat; it is the weighted error.
-    // rt = (sum) D(i) y(i) ht(xi)
-    rt = 0.0;
-
-    // zt is used for weight normalization.
-    zt = 0.0;
-
     // Build the weight vectors.
     weights = arma::sum(D);
 
-    // Use the existing weak learner to train a new one with new weights.
-    WeakLearnerType w(other, tempData, labels, numClasses, weights);
-    w.Classify(tempData, predictedLabels);
+    // Use the existing weak learner to train a new one with new weights.  The
+    // weak learner takes the weights directly, so the data is not copied.
+    WeakLearnerType w(other, data, labels, numClasses, weights);
+    w.Classify(data, predictedLabels);
 
-    // Now from predictedLabels, build ht, the weak hypothesis
-    // buildClassificationMatrix(ht, predictedLabels);
-
-    // Now, calculate alpha(t) using ht.
-    for (size_t j = 0; j < D.n_cols; j++) // instead of D, ht
-    {
-      if (predictedLabels(j) == labels(j))
-        rt += arma::accu(D.col(j));
-      else
-        rt -= arma::accu(D.col(j));
-    }
+    // Now, calculate alpha(t).  rt is used for calculation of alphat; it is
+    // the weighted error, rt = (sum) D(i) y(i) ht(xi), and the weight of a
+    // point is the sum of its column of D.
+    const arma::rowvec correct =
+        arma::conv_to<arma::rowvec>::from(predictedLabels == labels);
+    rt = 2.0 * arma::dot(correct, weights) - arma::accu(weights);
 
     if ((i > 0) && (std::abs(rt - crt) < tolerance))
       break;
@@ -155,42 +133,11 @@ void AdaBoost<WeakLearnerType, MatType>::Train(
     alpha.push_back(alphat);
     wl.push_back(w);
 
-    // Now start modifying the weights.
-    for (size_t j = 0; j < D.n_cols; j++)
-    {
-      const double expo = exp(alphat);
-      if (predictedLabels(j) == labels(j))
-      {
-        for (size_t k = 0; k < D.n_rows; k++)
-        {
-          // We calculate zt, the normalization constant.
-          D(k, j) /= expo;
-          zt += D(k, j); // * exp(-1 * alphat * yt(j,k) * ht(j,k));
-
-          // Add to the final hypothesis matrix.
-          // sumFinalH(k, j) += (alphat * ht(k, j));
-          if (k == labels(j))
-            sumFinalH(k, j) += (alphat); // * ht(k, j));
-          else
-            sumFinalH(k, j) -= (alphat);
-        }
-      }
-      else
-      {
-        for (size_t k = 0; k < D.n_rows; k++)
-        {
-          // We calculate zt, the normalization constant.
-          D(k, j) *= expo;
-          zt += D(k, j);
-
-          // Add to the final hypothesis matrix.
-          if (k == labels(j))
-            sumFinalH(k, j) += alphat; // * ht(k, j));
-          else
-            sumFinalH(k, j) -= alphat;
-        }
-      }
-    }
+    // Now modify the weights: the weights of the correctly classified points
+    // shrink, and the others grow.  zt is the normalization constant.
+    const double expo = exp(alphat);
+    D.each_row() %= (correct / expo + (1.0 - correct) * expo);
+    zt = arma::accu(D);
 
     // Normalize D.
     D /= zt;
@@ -208,28 +155,37 @@ void AdaBoost<WeakLearnerType, MatType>::Classify(
     const MatType& test,
     arma::Row<size_t>& predictedLabels)
 {
-  arma::Row<size_t> tempPredictedLabels(test.n_cols);
-  arma::mat cMatrix(numClasses, test.n_cols);
-
-  cMatrix.zeros();
   predictedLabels.set_size(test.n_cols);
 
-  for (size_t i = 0; i < wl.size(); i++)
+  // The points are split into batches, which are classified in parallel; each
+  // batch is extracted once and then passed to every weak learner, whose votes
+  // are accumulated in the batch's own part of the vote matrix.
+  const size_t batchSize = 1024;
+  const size_t numBatches = (test.n_cols + batchSize - 1) / batchSize;
+
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t b = 0; b < (omp_size_t) numBatches; ++b)
   {
-    wl[i].Classify(test, tempPredictedLabels);
+    const size_t begin = b * batchSize;
+    const size_t end = std::min(begin + batchSize, (size_t) test.n_cols);
+    const MatType batch(test.cols(begin, end - 1));
 
-    for (size_t j = 0; j < tempPredictedLabels.n_cols; j++)
-      cMatrix(tempPredictedLabels(j), j) += alpha[i];
-  }
+    arma::mat cMatrix(numClasses, end - begin, arma::fill::zeros);
+    arma::Row<size_t> tempPredictedLabels(end - begin);
+    for (size_t i = 0; i < wl.size(); i++)
+    {
+      wl[i].Classify(batch, tempPredictedLabels);
 
-  arma::colvec cMRow;
-  arma::uword maxIndex = 0;
+      for (size_t j = 0; j < tempPredictedLabels.n_cols; j++)
+        cMatrix(tempPredictedLabels(j), j) += alpha[i];
+    }
 
-  for (size_t i = 0; i < predictedLabels.n_cols; i++)
-  {
-    cMRow = cMatrix.unsafe_col(i);
-    cMRow.max(maxIndex);
-    predictedLabels(i) = maxIndex;
+    arma::uword maxIndex = 0;
+    for (size_t j = 0; j < cMatrix.n_cols; j++)
+    {
+      cMatrix.col(j).max(maxIndex);
+      predictedLabels(begin + j) = maxIndex;
+    }
   }
 }
 
@@ -25,6 +25,8 @@
 #include <mlpack/methods/amf/update_rules/svd_batch_learning.hpp>
 #include <mlpack/methods/amf/update_rules/svd_incomplete_incremental_learning.hpp>
 #include <mlpack/methods/amf/update_rules/svd_complete_incremental_learning.hpp>
+#include <mlpack/methods/amf/update_rules/svd_parallel_incremental_learning.hpp>
+#include <mlpack/methods/amf/update_rules/parallel_als.hpp>
 
 #include <mlpack/methods/amf/init_rules/random_init.hpp>
 #include <mlpack/methods/amf/init_rules/random_acol_init.hpp>
@@ -142,6 +144,28 @@ typedef amf::AMF<amf::SimpleResidueTermination,
                  amf::RandomAcolInitialization<>,
                  amf::NMFALSUpdate> NMFALSFactorizer;
 
+/**
+ * ParallelALSFactorizer factorizes given matrix V into two matrices W and H by
+ * regularized alternating least squares on the nonzero entries of V, solving
+ * each row of W and each column of H in parallel.
+ *
+ * @see ParallelALSUpdate
+ */
+typedef amf::AMF<amf::SimpleResidueTermination,
+                 amf::RandomAcolInitialization<>,
+                 amf::ParallelALSUpdate> ParallelALSFactorizer;
+
+/**
+ * SVDParallelIncrementalFactorizer factorizes given matrix V into two matrices
+ * W and H by lock-free parallel complete incremental gradient descent.
+ *
+ * @see SVDParallelIncrementalLearning
+ */
+typedef amf::AMF<amf::SimpleResidueTermination,
+                 amf::RandomAcolInitialization<>,
+                 amf::SVDParallelIncrementalLearning>
+        SVDParallelIncrementalFactorizer;
+
 //! Add simple typedefs
 #ifdef MLPACK_USE_CXX11
 
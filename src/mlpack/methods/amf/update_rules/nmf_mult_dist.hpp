@@ -35,6 +35,12 @@ namespace amf {
  * This is a multiplicative rule that ensures that the Frobenius norm
  * \f$ \sqrt{\sum_i \sum_j(V-WH)^2} \f$ is non-increasing between subsequent
  * iterations. Both of the update rules for W and H are defined in this file.
+ *
+ * The products are ordered so that no temporary is as large as V (W H H^T is
+ * computed as W (H H^T)), and the rank-sized buffers are kept between
+ * iterations.  For sparse V, V H^T and W^T V are accumulated from the nonzero
+ * entries only, in parallel over the rows and columns of V; to walk the rows,
+ * Initialize() stores a transposed copy of a sparse V.
  */
 class NMFMultiplicativeDistanceUpdate
 {
@@ -43,8 +49,8 @@ class NMFMultiplicativeDistanceUpdate
   NMFMultiplicativeDistanceUpdate() { }
 
   /**
-   * Initialize the factorization.  These update rules hold no information, so
-   * the input parameters are ignored.
+   * Initialize the factorization.  These update rules hold no information for
+   * dense matrices, so the input parameters are ignored.
    */
   template<typename MatType>
   void Initialize(const MatType& /* dataset */, const size_t /* rank */)
@@ -52,6 +58,16 @@ class NMFMultiplicativeDistanceUpdate
     // Nothing to do.
   }
 
+  /**
+   * Initialize the factorization of a sparse matrix.  This stores the
+   * transpose of the dataset, so that the nonzero entries of each row can be
+   * walked.
+   */
+  void Initialize(const arma::sp_mat& dataset, const size_t /* rank */)
+  {
+    transposedData = dataset.t();
+  }
+
   /**
    * The update rule for the basis matrix W. The formula used isa
    *
@@ -67,11 +83,36 @@ class NMFMultiplicativeDistanceUpdate
    * @param H Encoding matrix.
    */
   template<typename MatType>
-  inline static void WUpdate(const MatType& V,
-                             arma::mat& W,
-                             const arma::mat& H)
+  inline void WUpdate(const MatType& V,
+                      arma::mat& W,
+                      const arma::mat& H)
   {
-    W = (W % (V * H.t())) / (W * H * H.t());
+    denominator = W * (H * H.t());
+    W %= V * H.t();
+    W /= denominator;
+  }
+
+  /**
+   * The update rule for the basis matrix W, for sparse V.  The formula is the
+   * same; row i of V H^T is accumulated from the nonzero entries of row i of
+   * V.
+   *
+   * @param V Input matrix to be factorized.
+   * @param W Basis matrix to be updated.
+   * @param H Encoding matrix.
+   */
+  inline void WUpdate(const arma::sp_mat& V,
+                      arma::mat& W,
+                      const arma::mat& H)
+  {
+    denominator = W * (H * H.t());
+
+    // The transposed numerator has one column per row of V.
+    numerator.zeros(H.n_rows, V.n_rows);
+    AccumulateColumns(transposedData, H, numerator);
+
+    W %= numerator.t();
+    W /= denominator;
   }
 
   /**
@@ -89,16 +130,68 @@ class NMFMultiplicativeDistanceUpdate
    * @param H Encoding matrix to be updated.
    */
   template<typename MatType>
-  inline static void HUpdate(const MatType& V,
-                             const arma::mat& W,
-                             arma::mat& H)
+  inline void HUpdate(const MatType& V,
+                      const arma::mat& W,
+                      arma::mat& H)
   {
-    H = (H % (W.t() * V)) / (W.t() * W * H);
+    denominator = (W.t() * W) * H;
+    H %= W.t() * V;
+    H /= denominator;
+  }
+
+  /**
+   * The update rule for the encoding matrix H, for sparse V.  The formula is
+   * the same; column j of W^T V is accumulated from the nonzero entries of
+   * column j of V.
+   *
+   * @param V Input matrix to be factorized.
+   * @param W Basis matrix.
+   * @param H Encoding matrix to be updated.
+   */
+  inline void HUpdate(const arma::sp_mat& V,
+                      const arma::mat& W,
+                      arma::mat& H)
+  {
+    denominator = (W.t() * W) * H;
+
+    wt = W.t();
+    numerator.zeros(H.n_rows, V.n_cols);
+    AccumulateColumns(V, wt, numerator);
+
+    H %= numerator;
+    H /= denominator;
   }
 
   //! Serialize the object (in this case, there is nothing to serialize).
   template<typename Archive>
   void serialize(Archive& /* ar */, const unsigned int /* version */) { }
+
+ private:
+  /**
+   * Set column j of the output to the sum of factors.col(i) * data(i, j) over
+   * the nonzero entries of column j of data (that is, output = factors *
+   * data), in parallel over the columns.  The output must be zeroed.
+   */
+  static void AccumulateColumns(const arma::sp_mat& data,
+                                const arma::mat& factors,
+                                arma::mat& output)
+  {
+    #pragma omp parallel for schedule(dynamic, 256)
+    for (omp_size_t j = 0; j < (omp_size_t) data.n_cols; ++j)
+    {
+      for (size_t k = data.col_ptrs[j]; k < data.col_ptrs[j + 1]; ++k)
+        output.col(j) += data.values[k] * factors.col(data.row_indices[k]);
+    }
+  }
+
+  //! Transpose of a sparse dataset, so the nonzeros of each row are a column.
+  arma::sp_mat transposedData;
+  //! Transpose of W, so its rows are contiguous.
+  arma::mat wt;
+  //! Numerator of the multiplicative update.
+  arma::mat numerator;
+  //! Denominator of the multiplicative update.
+  arma::mat denominator;
 };
 
 } // namespace amf
@@ -41,9 +41,13 @@ namespace amf {
  * is non-increasing between subsequent iterations. Both of the update rules
  * for W and H are defined in this file.
  *
- * This set of update rules is not meant to work with sparse matrices.  Using
- * sparse matrices often causes NaNs in the output, so other choices of update
- * rules are better in that situation.
+ * For sparse V, the ratio V / (W H) is only needed at the nonzero entries of
+ * V, so W H is never formed: each nonzero entry costs one dot product of a
+ * row of W and a column of H, and the numerators of the updates are
+ * accumulated from the nonzero entries in parallel over the rows (for W) and
+ * the columns (for H) of V.  To walk the rows, Initialize() stores a
+ * transposed copy of a sparse V.  For dense V, the updates are written as
+ * matrix products, and W H is kept in a buffer between iterations.
  */
 class NMFMultiplicativeDivergenceUpdate
 {
@@ -52,8 +56,8 @@ class NMFMultiplicativeDivergenceUpdate
   NMFMultiplicativeDivergenceUpdate() { }
 
   /**
-   * Initialize the factorization.  These rules don't store any state, so the
-   * input values are ignore.
+   * Initialize the factorization.  These rules don't store any state for dense
+   * matrices, so the input values are ignored.
    */
   template<typename MatType>
   void Initialize(const MatType& /* dataset */, const size_t /* rank */)
@@ -61,6 +65,16 @@ class NMFMultiplicativeDivergenceUpdate
     // Nothing to do.
   }
 
+  /**
+   * Initialize the factorization of a sparse matrix.  This stores the
+   * transpose of the dataset, so that the nonzero entries of each row can be
+   * walked.
+   */
+  void Initialize(const arma::sp_mat& dataset, const size_t /* rank */)
+  {
+    transposedData = dataset.t();
+  }
+
   /**
    * The update rule for the basis matrix W. The formula used is
    *
@@ -77,32 +91,37 @@ class NMFMultiplicativeDivergenceUpdate
    * @param H Encoding matrix.
    */
   template<typename MatType>
-  inline static void WUpdate(const MatType& V,
-                             arma::mat& W,
-                             const arma::mat& H)
+  inline void WUpdate(const MatType& V,
+                      arma::mat& W,
+                      const arma::mat& H)
   {
-    // Simple implementation left in the header file.
-    arma::mat t1;
-    arma::rowvec t2;
+    // The ratio V / (W H) is formed in place.
+    ratio = W * H;
+    ratio = V / ratio;
 
-    t1 = W * H;
-    for (size_t i = 0; i < W.n_rows; ++i)
-    {
-      for (size_t j = 0; j < W.n_cols; ++j)
-      {
-        // Writing this as a single expression does not work as of Armadillo
-        // 3.920.  This should be fixed in a future release, and then the code
-        // below can be fixed.
-        // t2 = H.row(j) % V.row(i) / t1.row(i);
-        t2.set_size(H.n_cols);
-        for (size_t k = 0; k < t2.n_elem; ++k)
-        {
-          t2(k) = H(j, k) * V(i, k) / t1(i, k);
-        }
-
-        W(i, j) = W(i, j) * sum(t2) / sum(H.row(j));
-      }
-    }
+    W %= ratio * H.t();
+    W.each_row() /= arma::trans(arma::sum(H, 1));
+  }
+
+  /**
+   * The update rule for the basis matrix W, for sparse V.  The formula is the
+   * same, but the sum is only over the nonzero entries of row i of V.
+   *
+   * @param V Input matrix to be factorized.
+   * @param W Basis matrix to be updated.
+   * @param H Encoding matrix.
+   */
+  inline void WUpdate(const arma::sp_mat& /* V */,
+                      arma::mat& W,
+                      const arma::mat& H)
+  {
+    // Column i of the transposed data holds row i of V.
+    wt = W.t();
+    numerator.zeros(H.n_rows, W.n_rows);
+    AccumulateRatios(transposedData, H, wt, numerator);
+
+    W %= numerator.t();
+    W.each_row() /= arma::trans(arma::sum(H, 1));
   }
 
   /**
@@ -121,37 +140,80 @@ class NMFMultiplicativeDivergenceUpdate
    * @param H Encoding matrix to updated.
    */
   template<typename MatType>
-  inline static void HUpdate(const MatType& V,
-                            const arma::mat& W,
-                            arma::mat& H)
+  inline void HUpdate(const MatType& V,
+                      const arma::mat& W,
+                      arma::mat& H)
+  {
+    // The ratio V / (W H) is formed in place.
+    ratio = W * H;
+    ratio = V / ratio;
+
+    H %= W.t() * ratio;
+    H.each_col() /= arma::trans(arma::sum(W, 0));
+  }
+
+  /**
+   * The update rule for the encoding matrix H, for sparse V.  The formula is
+   * the same, but the sum is only over the nonzero entries of column mu of V.
+   *
+   * @param V Input matrix to be factorized.
+   * @param W Basis matrix.
+   * @param H Encoding matrix to updated.
+   */
+  inline void HUpdate(const arma::sp_mat& V,
+                      const arma::mat& W,
+                      arma::mat& H)
   {
-    // Simple implementation left in the header file.
-    arma::mat t1;
-    arma::colvec t2;
+    wt = W.t();
+    numerator.zeros(H.n_rows, H.n_cols);
+    AccumulateRatios(V, wt, H, numerator);
 
-    t1 = W * H;
-    for (size_t i = 0; i < H.n_rows; i++)
+    H %= numerator;
+    H.each_col() /= arma::trans(arma::sum(W, 0));
+  }
+
+  //! Serialize the object (in this case, there is nothing to serialize).
+  template<typename Archive>
+  void serialize(Archive& /* ar */, const unsigned int /* version */) { }
+
+ private:
+  /**
+   * For each column j of data, set column j of the output to the sum of
+   * rowFactors.col(i) * data(i, j) / dot(rowFactors.col(i), colFactors.col(j))
+   * over the nonzero entries of column j, in parallel over the columns.  The
+   * output must be zeroed.
+   *
+   * @param data Sparse data; one column per column of the output.
+   * @param rowFactors Factors of the rows of data (one column per row).
+   * @param colFactors Factors of the columns of data (one column per column).
+   * @param output Accumulated numerators.
+   */
+  static void AccumulateRatios(const arma::sp_mat& data,
+                               const arma::mat& rowFactors,
+                               const arma::mat& colFactors,
+                               arma::mat& output)
+  {
+    #pragma omp parallel for schedule(dynamic, 256)
+    for (omp_size_t j = 0; j < (omp_size_t) data.n_cols; ++j)
     {
-      for (size_t j = 0; j < H.n_cols; j++)
+      for (size_t k = data.col_ptrs[j]; k < data.col_ptrs[j + 1]; ++k)
       {
-        // Writing this as a single expression does not work as of Armadillo
-        // 3.920.  This should be fixed in a future release, and then the code
-        // below can be fixed.
-        // t2 = W.col(i) % V.col(j) / t1.col(j);
-        t2.set_size(W.n_rows);
-        for (size_t k = 0; k < t2.n_elem; ++k)
-        {
-          t2(k) = W(k, i) * V(k, j) / t1(k, j);
-        }
-
-        H(i, j) = H(i, j) * sum(t2) / sum(W.col(i));
+        const size_t i = data.row_indices[k];
+        const double product = arma::dot(rowFactors.col(i),
+            colFactors.col(j));
+        output.col(j) += (data.values[k] / product) * rowFactors.col(i);
       }
     }
   }
 
-  //! Serialize the object (in this case, there is nothing to serialize).
-  template<typename Archive>
-  void serialize(Archive& /* ar */, const unsigned int /* version */) { }
+  //! Transpose of a sparse dataset, so the nonzeros of each row are a column.
+  arma::sp_mat transposedData;
+  //! Transpose of W, so its rows are contiguous.
+  arma::mat wt;
+  //! Buffer for W H and the ratio V / (W H), for dense V.
+  arma::mat ratio;
+  //! Numerator of the multiplicative update, for sparse V.
+  arma::mat numerator;
 };
 
 } // namespace amf
@@ -0,0 +1,188 @@
+/**
+ * @file parallel_als.hpp
+ *
+ * Regularized alternating least squares update rules for AMF, where every row
+ * of W and every column of H is solved independently and in parallel.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_AMF_UPDATE_RULES_PARALLEL_ALS_HPP
+#define MLPACK_METHODS_AMF_UPDATE_RULES_PARALLEL_ALS_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace amf {
+
+/**
+ * This class implements regularized alternating least squares for
+ * collaborative filtering, as described in the following paper:
+ *
+ * @code
+ * @inproceedings{zhou2008large,
+ *   title={Large-scale parallel collaborative filtering for the Netflix
+ *       prize},
+ *   author={Zhou, Y. and Wilkinson, D. and Schreiber, R. and Pan, R.},
+ *   booktitle={Algorithmic Aspects in Information and Management},
+ *   pages={337--348},
+ *   year={2008}
+ * }
+ * @endcode
+ *
+ * Only the nonzero (observed) entries of V are fit.  With H held fixed, each
+ * row of W is the solution of a small (rank x rank) regularized least squares
+ * problem over the users that rated that item, and with W held fixed, each
+ * column of H is solved in the same way over the items that user rated.  These
+ * problems are independent, so they are solved in parallel with OpenMP.
+ *
+ * To walk the ratings of each item, Initialize() stores a sparse transposed
+ * copy of V.
+ *
+ * @see NMFALSUpdate
+ */
+class ParallelALSUpdate
+{
+ public:
+  /**
+   * Initialize the parameters of ParallelALSUpdate.
+   *
+   * @param lambda Regularization constant for both W and H.
+   */
+  ParallelALSUpdate(const double lambda = 0.01) : lambda(lambda)
+  {
+    // Nothing to do.
+  }
+
+  /**
+   * Initialize parameters before factorization.  This stores the transpose of
+   * the dataset, so the rows of W can be solved from its columns.
+   *
+   * @param dataset Input matrix to be factorized.
+   * @param rank Rank of factorization.
+   */
+  template<typename MatType>
+  void Initialize(const MatType& dataset, const size_t /* rank */)
+  {
+    transposedData = arma::sp_mat(dataset.t());
+  }
+
+  /**
+   * The update rule for the basis matrix W.  Each row of W is solved from the
+   * ratings of that item, holding H constant.
+   *
+   * @param V Input matrix to be factorized.
+   * @param W Basis matrix to be updated.
+   * @param H Encoding matrix.
+   */
+  template<typename MatType>
+  inline void WUpdate(const MatType& /* V */,
+                      arma::mat& W,
+                      const arma::mat& H)
+  {
+    #pragma omp parallel for schedule(dynamic, 64)
+    for (omp_size_t i = 0; i < (omp_size_t) W.n_rows; ++i)
+    {
+      arma::vec row;
+      if (Solve(transposedData, i, H, row))
+        W.row(i) = row.t();
+    }
+  }
+
+  /**
+   * The update rule for the encoding matrix H.  Each column of H is solved
+   * from the ratings of that user, holding W constant.
+   *
+   * @param V Input matrix to be factorized.
+   * @param W Basis matrix.
+   * @param H Encoding matrix to be updated.
+   */
+  template<typename MatType>
+  inline void HUpdate(const MatType& V,
+                      const arma::mat& W,
+                      arma::mat& H)
+  {
+    const arma::mat wt = W.t();
+
+    #pragma omp parallel for schedule(dynamic, 64)
+    for (omp_size_t j = 0; j < (omp_size_t) H.n_cols; ++j)
+    {
+      arma::vec col;
+      if (Solve(V, j, wt, col))
+        H.col(j) = col;
+    }
+  }
+
+  //! Get the regularization constant.
+  double Lambda() const { return lambda; }
+  //! Modify the regularization constant.
+  double& Lambda() { return lambda; }
+
+ private:
+  /**
+   * Solve (F_j F_j^T + lambda I) x = F_j v_j, where v_j holds the observed
+   * entries of the given column of the data and F_j holds the columns of the
+   * factors that correspond to them.  Returns false (and leaves x untouched)
+   * if the system can't be solved, e.g. for an empty column without
+   * regularization.
+   */
+  template<typename MatType>
+  bool Solve(const MatType& data,
+             const size_t col,
+             const arma::mat& factors,
+             arma::vec& x) const
+  {
+    arma::uvec indices;
+    arma::vec values;
+    ObservedEntries(data, col, indices, values);
+    if (indices.n_elem == 0 && lambda == 0.0)
+      return false;
+
+    const arma::mat observedFactors = factors.cols(indices);
+    arma::mat a = observedFactors * observedFactors.t();
+    a.diag() += lambda;
+    const arma::vec b = observedFactors * values;
+
+    arma::vec result;
+    if (!arma::solve(result, a, b))
+      return false;
+
+    x = std::move(result);
+    return true;
+  }
+
+  //! Collect the nonzero entries of a column of a sparse matrix.
+  static void ObservedEntries(const arma::sp_mat& data,
+                              const size_t col,
+                              arma::uvec& indices,
+                              arma::vec& values)
+  {
+    const size_t begin = data.col_ptrs[col];
+    const size_t count = data.col_ptrs[col + 1] - begin;
+    indices = arma::uvec(data.row_indices + begin, count);
+    values = arma::vec(data.values + begin, count);
+  }
+
+  //! Collect the nonzero entries of a column of a dense matrix.
+  template<typename MatType>
+  static void ObservedEntries(const MatType& data,
+                              const size_t col,
+                              arma::uvec& indices,
+                              arma::vec& values)
+  {
+    indices = arma::find(data.col(col));
+    values = arma::vec(data.col(col)).elem(indices);
+  }
+
+  //! Regularization constant.
+  double lambda;
+  //! Transpose of the dataset, so the ratings of each item are a column.
+  arma::sp_mat transposedData;
+}; // class ParallelALSUpdate
+
+} // namespace amf
+} // namespace mlpack
+
+#endif
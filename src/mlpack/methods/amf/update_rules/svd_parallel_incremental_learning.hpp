@@ -0,0 +1,165 @@
+/**
+ * @file svd_parallel_incremental_learning.hpp
+ *
+ * SVD factorizer used in AMF (Alternating Matrix Factorization), trained with
+ * lock-free parallel incremental learning.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_AMF_SVD_PARALLEL_INCREMENTAL_LEARNING_HPP
+#define MLPACK_METHODS_AMF_SVD_PARALLEL_INCREMENTAL_LEARNING_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace amf {
+
+/**
+ * This class computes SVD with complete incremental learning (see
+ * SVDCompleteIncrementalLearning), where the users are split between threads
+ * that update W and H without any locking, as described in the following
+ * paper:
+ *
+ * @code
+ * @inproceedings{recht2011hogwild,
+ *   title={Hogwild: A lock-free approach to parallelizing stochastic gradient
+ *       descent},
+ *   author={Recht, B. and Re, C. and Wright, S. and Niu, F.},
+ *   booktitle={Advances in Neural Information Processing Systems},
+ *   pages={693--701},
+ *   year={2011}
+ * }
+ * @endcode
+ *
+ * Each call to WUpdate() makes one full pass over the nonzero entries of V and
+ * updates both W and H; HUpdate() does nothing.  Every column of H is only
+ * touched by the thread that owns that user, but rows of W are shared between
+ * threads, so concurrent updates of the same item may overwrite each other.
+ * For sparse rating matrices such collisions are rare and do not prevent
+ * convergence, but the result is not deterministic when more than one thread
+ * is used.
+ *
+ * @see SVDCompleteIncrementalLearning
+ */
+class SVDParallelIncrementalLearning
+{
+ public:
+  /**
+   * Initialize the parameters of SVDParallelIncrementalLearning.
+   *
+   * @param u Step value used in batch learning.
+   * @param kw Regularization constant for W matrix.
+   * @param kh Regularization constant for H matrix.
+   */
+  SVDParallelIncrementalLearning(double u = 0.001,
+                                 double kw = 0,
+                                 double kh = 0)
+      : u(u), kw(kw), kh(kh)
+  {
+    // Nothing to do.
+  }
+
+  /**
+   * Initialize parameters before factorization.  There is nothing to
+   * initialize for this update rule.
+   *
+   * @param dataset Input matrix to be factorized.
+   * @param rank rank of factorization
+   */
+  template<typename MatType>
+  void Initialize(const MatType& /* dataset */, const size_t /* rank */)
+  {
+    // Nothing to do.
+  }
+
+  /**
+   * Make one pass over all the nonzero entries of V, updating both W and H.
+   *
+   * @param V Input matrix to be factorized.
+   * @param W Basis matrix to be updated.
+   * @param H Encoding matrix to be updated.
+   */
+  template<typename MatType>
+  inline void WUpdate(const MatType& V,
+                      arma::mat& W,
+                      arma::mat& H)
+  {
+    #pragma omp parallel for schedule(dynamic, 64)
+    for (omp_size_t j = 0; j < (omp_size_t) V.n_cols; ++j)
+      UserUpdate(V, j, W, H);
+  }
+
+  /**
+   * H has already been updated by WUpdate(), so this does nothing.
+   *
+   * @param V Input matrix to be factorized.
+   * @param W Basis matrix.
+   * @param H Encoding matrix.
+   */
+  template<typename MatType>
+  inline void HUpdate(const MatType& /* V */,
+                      const arma::mat& /* W */,
+                      arma::mat& /* H */)
+  {
+    // Nothing to do.
+  }
+
+ private:
+  //! Update W and H with the given rating.
+  void Update(const double val,
+              const size_t item,
+              const size_t user,
+              arma::mat& W,
+              arma::mat& H) const
+  {
+    const arma::rowvec w = W.row(item);
+    const double error = val - arma::dot(w, H.col(user));
+
+    W.row(item) += u * (error * H.col(user).t() - kw * w);
+    H.col(user) += u * (error * w.t() - kh * H.col(user));
+  }
+
+  //! Update W and H with all the ratings of the given user in a sparse matrix.
+  void UserUpdate(const arma::sp_mat& V,
+                  const size_t user,
+                  arma::mat& W,
+                  arma::mat& H) const
+  {
+    for (arma::sp_mat::const_iterator it = V.begin_col(user);
+        it != V.end_col(user); ++it)
+    {
+      Update(*it, it.row(), user, W, H);
+    }
+  }
+
+  //! Update W and H with all the ratings of the given user in a dense matrix.
+  template<typename MatType>
+  void UserUpdate(const MatType& V,
+                  const size_t user,
+                  arma::mat& W,
+                  arma::mat& H) const
+  {
+    for (size_t i = 0; i < V.n_rows; ++i)
+    {
+      const double val = V(i, user);
+      // Update only if the rating is non-zero.
+      if (val != 0)
+        Update(val, i, user, W, H);
+    }
+  }
+
+  //! Step size of the updates.
+  double u;
+  //! Regularization parameter for W matrix.
+  double kw;
+  //! Regularization parameter for H matrix.
+  double kh;
+}; // class SVDParallelIncrementalLearning
+
+} // namespace amf
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,336 @@
+/**
+ * @file im2col_convolution.hpp
+ *
+ * Implementation of the convolution through matrix multiplication: the input
+ * is lowered to a matrix of patches (im2col), which is multiplied with the
+ * filters.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_CONVOLUTION_RULES_IM2COL_CONVOLUTION_HPP
+#define MLPACK_METHODS_ANN_CONVOLUTION_RULES_IM2COL_CONVOLUTION_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "border_modes.hpp"
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+/**
+ * Computes the two-dimensional convolution by lowering the input to a matrix
+ * whose rows are the patches the filter is applied to (im2col), so that the
+ * convolution becomes a single matrix multiplication.  The results are the
+ * same as NaiveConvolution, so this class can be used in place of it.
+ *
+ * When it is used as the convolution rules of the Convolution layer, the layer
+ * lowers all the maps of a whole batch at once with Im2Col(), and the forward,
+ * backward and gradient passes each take a single matrix multiplication (GEMM)
+ * that covers every (outMap, inMap) pair and every point of the batch.
+ *
+ * FullConvolution: returns the full two-dimensional convolution.
+ * ValidConvolution: returns only those parts of the convolution that are
+ * computed without the zero-padded edges.
+ *
+ * @tparam BorderMode Type of the border mode (FullConvolution or
+ * ValidConvolution).
+ */
+template<typename BorderMode = FullConvolution>
+class Im2ColConvolution
+{
+ public:
+  /*
+   * Perform a convolution (valid mode).
+   *
+   * @param input Input used to perform the convolution.
+   * @param filter Filter used to perform the conolution.
+   * @param output Output data that contains the results of the convolution.
+   * @param dW Stride of filter application in the x direction.
+   * @param dH Stride of filter application in the y direction.
+   */
+  template<typename eT, typename Border = BorderMode>
+  static typename std::enable_if<
+      std::is_same<Border, ValidConvolution>::value, void>::type
+  Convolution(const arma::Mat<eT>& input,
+              const arma::Mat<eT>& filter,
+              arma::Mat<eT>& output,
+              const size_t dW = 1,
+              const size_t dH = 1)
+  {
+    // Use the same output size and strides as NaiveConvolution.
+    const size_t outputRows = (input.n_rows - filter.n_rows + 1) / dW;
+    const size_t outputCols = (input.n_cols - filter.n_cols + 1) / dH;
+
+    const arma::Cube<eT> inputCube(const_cast<eT*>(input.memptr()),
+        input.n_rows, input.n_cols, 1, false, true);
+
+    arma::Mat<eT> patches;
+    Im2Col(inputCube, 1, filter.n_rows, filter.n_cols, dH, dW, outputRows,
+        outputCols, patches);
+
+    // The output may be a slice of a cube, so it can't be resized in place.
+    arma::Mat<eT> convOutput = patches * arma::vectorise(filter);
+    output = arma::Mat<eT>(convOutput.memptr(), outputRows, outputCols, false,
+        true);
+  }
+
+  /*
+   * Perform a convolution (full mode).
+   *
+   * @param input Input used to perform the convolution.
+   * @param filter Filter used to perform the conolution.
+   * @param output Output data that contains the results of the convolution.
+   * @param dW Stride of filter application in the x direction.
+   * @param dH Stride of filter application in the y direction.
+   */
+  template<typename eT, typename Border = BorderMode>
+  static typename std::enable_if<
+      std::is_same<Border, FullConvolution>::value, void>::type
+  Convolution(const arma::Mat<eT>& input,
+              const arma::Mat<eT>& filter,
+              arma::Mat<eT>& output,
+              const size_t dW = 1,
+              const size_t dH = 1)
+  {
+    const size_t outputRows = (input.n_rows + 2 * (filter.n_rows - 1)) * dW;
+    const size_t outputCols = (input.n_cols + 2 * (filter.n_cols - 1)) * dH;
+
+    // Pad filter and input to the working output shape.
+    arma::Mat<eT> inputPadded = arma::zeros<arma::Mat<eT> >(outputRows,
+        outputCols);
+    inputPadded.submat(filter.n_rows - 1, filter.n_cols - 1,
+        filter.n_rows - 1 + input.n_rows - 1,
+        filter.n_cols - 1 + input.n_cols - 1) = input;
+
+    Im2ColConvolution<ValidConvolution>::Convolution(inputPadded, filter,
+        output, 1, 1);
+  }
+
+  /*
+   * Perform a convolution using 3rd order tensors.
+   *
+   * @param input Input used to perform the convolution.
+   * @param filter Filter used to perform the conolution.
+   * @param output Output data that contains the results of the convolution.
+   * @param dW Stride of filter application in the x direction.
+   * @param dH Stride of filter application in the y direction.
+   */
+  template<typename eT>
+  static void Convolution(const arma::Cube<eT>& input,
+                          const arma::Cube<eT>& filter,
+                          arma::Cube<eT>& output,
+                          const size_t dW = 1,
+                          const size_t dH = 1)
+  {
+    arma::Mat<eT> convOutput;
+    Im2ColConvolution<BorderMode>::Convolution(input.slice(0),
+        filter.slice(0), convOutput, dW, dH);
+
+    output = arma::Cube<eT>(convOutput.n_rows, convOutput.n_cols,
+        input.n_slices);
+    output.slice(0) = convOutput;
+
+    for (size_t i = 1; i < input.n_slices; i++)
+    {
+      Im2ColConvolution<BorderMode>::Convolution(input.slice(i),
+          filter.slice(i), output.slice(i), dW, dH);
+    }
+  }
+
+  /*
+   * Perform a convolution using dense matrix as input and a 3rd order tensors
+   * as filter and output.
+   *
+   * @param input Input used to perform the convolution.
+   * @param filter Filter used to perform the conolution.
+   * @param output Output data that contains the results of the convolution.
+   * @param dW Stride of filter application in the x direction.
+   * @param dH Stride of filter application in the y direction.
+   */
+  template<typename eT>
+  static void Convolution(const arma::Mat<eT>& input,
+                          const arma::Cube<eT>& filter,
+                          arma::Cube<eT>& output,
+                          const size_t dW = 1,
+                          const size_t dH = 1)
+  {
+    arma::Mat<eT> convOutput;
+    Im2ColConvolution<BorderMode>::Convolution(input, filter.slice(0),
+        convOutput, dW, dH);
+
+    output = arma::Cube<eT>(convOutput.n_rows, convOutput.n_cols,
+        filter.n_slices);
+    output.slice(0) = convOutput;
+
+    for (size_t i = 1; i < filter.n_slices; i++)
+    {
+      Im2ColConvolution<BorderMode>::Convolution(input, filter.slice(i),
+          output.slice(i), dW, dH);
+    }
+  }
+
+  /*
+   * Perform a convolution using a 3rd order tensors as input and output and a
+   * dense matrix as filter.
+   *
+   * @param input Input used to perform the convolution.
+   * @param filter Filter used to perform the conolution.
+   * @param output Output data that contains the results of the convolution.
+   * @param dW Stride of filter application in the x direction.
+   * @param dH Stride of filter application in the y direction.
+   */
+  template<typename eT>
+  static void Convolution(const arma::Cube<eT>& input,
+                          const arma::Mat<eT>& filter,
+                          arma::Cube<eT>& output,
+                          const size_t dW = 1,
+                          const size_t dH = 1)
+  {
+    arma::Mat<eT> convOutput;
+    Im2ColConvolution<BorderMode>::Convolution(input.slice(0), filter,
+        convOutput, dW, dH);
+
+    output = arma::Cube<eT>(convOutput.n_rows, convOutput.n_cols,
+        input.n_slices);
+    output.slice(0) = convOutput;
+
+    for (size_t i = 1; i < input.n_slices; i++)
+    {
+      Im2ColConvolution<BorderMode>::Convolution(input.slice(i), filter,
+          output.slice(i), dW, dH);
+    }
+  }
+
+  /**
+   * Lower the given points to a matrix of patches.  The input holds the maps
+   * of each point one after the other (so slice point * maps + map is the given
+   * map of the given point).  Row point * outputRows * outputCols + j *
+   * outputRows + i of the patches holds the input the filter is applied to
+   * for output element (i, j) of the point, for all the maps: column map *
+   * kRows * kCols + kj * kRows + ki holds element (i * rowStride + ki,
+   * j * colStride + kj) of the given map.  So, the patches can be multiplied
+   * with a matrix that holds one vectorised filter (of all the maps) in each
+   * column.
+   *
+   * @param input Input maps of all the points.
+   * @param maps Number of maps of each point.
+   * @param kRows Number of rows of the filter.
+   * @param kCols Number of columns of the filter.
+   * @param rowStride Stride of filter application along the rows.
+   * @param colStride Stride of filter application along the columns.
+   * @param outputRows Number of rows of the convolution output.
+   * @param outputCols Number of columns of the convolution output.
+   * @param patches Matrix to store the patches in.
+   */
+  template<typename eT>
+  static void Im2Col(const arma::Cube<eT>& input,
+                     const size_t maps,
+                     const size_t kRows,
+                     const size_t kCols,
+                     const size_t rowStride,
+                     const size_t colStride,
+                     const size_t outputRows,
+                     const size_t outputCols,
+                     arma::Mat<eT>& patches)
+  {
+    const size_t points = input.n_slices / maps;
+    patches.set_size(points * outputRows * outputCols, maps * kRows * kCols);
+
+    // Fill the patches column by column, so that the writes are contiguous.
+    eT* patchesPtr = patches.memptr();
+    for (size_t map = 0; map < maps; ++map)
+    {
+      for (size_t kj = 0; kj < kCols; ++kj)
+      {
+        for (size_t ki = 0; ki < kRows; ++ki)
+        {
+          for (size_t point = 0; point < points; ++point)
+          {
+            const arma::Mat<eT>& slice = input.slice(point * maps + map);
+            for (size_t j = 0; j < outputCols; ++j)
+            {
+              const eT* inputPtr = slice.colptr(j * colStride + kj) + ki;
+              for (size_t i = 0; i < outputRows; ++i, ++patchesPtr)
+                *patchesPtr = inputPtr[i * rowStride];
+            }
+          }
+        }
+      }
+    }
+  }
+
+  /**
+   * Add the given patches back to the maps they were taken from; this is the
+   * transpose of Im2Col(), and the layout of the patches is the same.  The
+   * output must already have the size of the input given to Im2Col(), and the
+   * patches are added to it.
+   *
+   * @param patches Matrix of the patches.
+   * @param maps Number of maps of each point.
+   * @param kRows Number of rows of the filter.
+   * @param kCols Number of columns of the filter.
+   * @param rowStride Stride of filter application along the rows.
+   * @param colStride Stride of filter application along the columns.
+   * @param outputRows Number of rows of the convolution output.
+   * @param outputCols Number of columns of the convolution output.
+   * @param output Maps of all the points to add the patches to.
+   */
+  template<typename eT>
+  static void Col2Im(const arma::Mat<eT>& patches,
+                     const size_t maps,
+                     const size_t kRows,
+                     const size_t kCols,
+                     const size_t rowStride,
+                     const size_t colStride,
+                     const size_t outputRows,
+                     const size_t outputCols,
+                     arma::Cube<eT>& output)
+  {
+    const size_t points = output.n_slices / maps;
+
+    const eT* patchesPtr = patches.memptr();
+    for (size_t map = 0; map < maps; ++map)
+    {
+      for (size_t kj = 0; kj < kCols; ++kj)
+      {
+        for (size_t ki = 0; ki < kRows; ++ki)
+        {
+          for (size_t point = 0; point < points; ++point)
+          {
+            arma::Mat<eT>& slice = output.slice(point * maps + map);
+            for (size_t j = 0; j < outputCols; ++j)
+            {
+              eT* outputPtr = slice.colptr(j * colStride + kj) + ki;
+              for (size_t i = 0; i < outputRows; ++i, ++patchesPtr)
+                outputPtr[i * rowStride] += *patchesPtr;
+            }
+          }
+        }
+      }
+    }
+  }
+};  // class Im2ColConvolution
+
+/**
+ * Whether the given convolution rule is an Im2ColConvolution, in which case
+ * the Convolution layer runs each pass on the whole batch with one matrix
+ * multiplication.
+ */
+template<typename ConvolutionRule>
+struct IsIm2ColConvolution
+{
+  static const bool value = false;
+};
+
+template<typename BorderMode>
+struct IsIm2ColConvolution<Im2ColConvolution<BorderMode> >
+{
+  static const bool value = true;
+};
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
@@ -30,6 +30,8 @@
 #include <mlpack/methods/ann/init_rules/random_init.hpp>
 #include <mlpack/core/optimizers/rmsprop/rmsprop.hpp>
 
+#include <future>
+
 namespace mlpack {
 namespace ann /** Artificial Neural Network. */ {
 
@@ -49,6 +51,35 @@ class FFN
   //! Convenience typedef for the internal model construction.
   using NetworkType = FFN<OutputLayerType, InitializationRuleType>;
 
+  /**
+   * The state of the const Predict(): a copy of the layers of a network, which
+   * holds the activations, with the weights of the network.  A trained network
+   * can then be shared between threads that predict at the same time, each
+   * with its own workspace, without a copy of the weights for each thread.  The
+   * workspace is built by the first call that uses it, and built again when
+   * the layers or the memory of the parameters of the network change.
+   */
+  class Workspace
+  {
+   public:
+    //! Create an empty workspace.
+    Workspace() : replica(NULL), parameter(NULL) { }
+
+    //! Delete the copy of the layers.
+    ~Workspace() { delete replica; }
+
+    Workspace(const Workspace& other) = delete;
+    Workspace& operator=(const Workspace& other) = delete;
+
+   private:
+    //! The copy of the network that holds the activations.
+    NetworkType* replica;
+    //! The memory of the parameters the copy was built with.
+    const double* parameter;
+
+    friend class FFN;
+  };
+
   /**
    * Create the FFN object with the given predictors and responses set (this is
    * the set that is used to train the network).
@@ -137,22 +168,96 @@ class FFN
   template<typename OptimizerType = mlpack::optimization::RMSProp>
   void Train(arma::mat predictors, arma::mat responses);
 
+  /**
+   * Train the feedforward network on the given sparse input data using the
+   * given optimizer.  The first layer of the network must be a Linear layer,
+   * which multiplies its weights with the sparse predictors directly, so the
+   * predictors are never densified, and whose weight gradient only holds the
+   * columns of the input units that appear in each batch (see the sparse
+   * Gradient()).  Prefetch() is ignored.
+   *
+   * This will use the existing model parameters as a starting point for the
+   * optimization.
+   *
+   * @tparam OptimizerType Type of optimizer to use to train the model.
+   * @param predictors Sparse input training variables.
+   * @param responses Outputs results from input training variables.
+   * @param optimizer Instantiated optimizer used to train the model.
+   */
+  template<typename OptimizerType>
+  void Train(arma::sp_mat predictors,
+             arma::mat responses,
+             OptimizerType& optimizer);
+
+  /**
+   * Train the feedforward network on the given sparse input data, as the
+   * other sparse Train(), with a default-constructed optimizer (RMSProp by
+   * default).
+   *
+   * @tparam OptimizerType Type of optimizer to use to train the model.
+   * @param predictors Sparse input training variables.
+   * @param responses Outputs results from input training variables.
+   */
+  template<typename OptimizerType = mlpack::optimization::RMSProp>
+  void Train(arma::sp_mat predictors, arma::mat responses);
+
   /**
    * Predict the responses to a given set of predictors. The responses will
    * reflect the output of the given output layer as returned by the
    * output layer function.
    *
+   * The predictors are passed through the network in batches of batchSize
+   * points, so that each layer works on a whole batch at once (for instance,
+   * a Linear layer does one matrix-matrix product for each batch).  If the
+   * network does not keep one column for each point (for instance, because it
+   * holds a Join or Concat layer), the points are passed one at a time.
+   *
    * If you want to pass in a parameter and discard the original parameter
    * object, be sure to use std::move to avoid unnecessary copy.
    *
    * @param predictors Input predictors.
    * @param results Matrix to put output predictions of responses into.
+   * @param batchSize Number of points to pass through the network at a time.
    */
-  void Predict(arma::mat predictors, arma::mat& results);
+  void Predict(arma::mat predictors,
+               arma::mat& results,
+               const size_t batchSize = 256);
+
+  /**
+   * Predict the responses to a given set of sparse predictors, as the dense
+   * Predict().  The first layer of the network must be a Linear layer.
+   *
+   * @param predictors Sparse input predictors.
+   * @param results Matrix to put output predictions of responses into.
+   * @param batchSize Number of points to pass through the network at a time.
+   */
+  void Predict(arma::sp_mat predictors,
+               arma::mat& results,
+               const size_t batchSize = 256);
+
+  /**
+   * Predict the responses to a given set of predictors, as the other Predict(),
+   * but without modifying the network: the activations are held by the given
+   * workspace.  So several threads may predict with the same network at the
+   * same time, as long as each thread has its own workspace and the network is
+   * not modified meanwhile.  The layers always work in deterministic (testing)
+   * mode.  The network must already have parameters.
+   *
+   * @param predictors Input predictors.
+   * @param results Matrix to put output predictions of responses into.
+   * @param workspace Workspace of the calling thread.
+   * @param batchSize Number of points to pass through the network at a time.
+   */
+  void Predict(arma::mat predictors,
+               arma::mat& results,
+               Workspace& workspace,
+               const size_t batchSize = 256) const;
 
   /**
    * Evaluate the feedforward network with the given parameters. This function
-   * is usually called by the optimizer to train the model.
+   * is usually called by the optimizer to train the model.  If the given
+   * parameters are not the parameters of the network (see Parameters()), they
+   * are copied into them first.
    *
    * @param parameters Matrix model parameters.
    * @param deterministic Whether or not to train or test the model. Note some
@@ -183,6 +288,14 @@ class FFN
    * and with respect to only one point in the dataset. This is useful for
    * optimizers such as SGD, which require a separable objective function.
    *
+   * If Parallel() is set (and mlpack was compiled with OpenMP), the batch is
+   * split between the OpenMP threads.  Each thread runs the forward and
+   * backward passes of its part of the batch on its own replica of the
+   * network, whose layers share the parameters of this network, and the
+   * gradients of the threads are then summed.  So, the gradient is the same
+   * as the one of a single thread, and this works with any optimizer.  The
+   * first call is always done by a single thread.
+   *
    * @param parameters Matrix of the model parameters to be optimized.
    * @param begin Index of the starting point to use for objective function
    *        gradient evaluation.
@@ -195,9 +308,55 @@ class FFN
                 arma::mat& gradient,
                 const size_t batchSize);
 
+  /**
+   * Evaluate the gradient of the feedforward network with the given
+   * parameters, for the given batch of points, as a sparse matrix.  The
+   * gradient of each Lookup layer of the network only holds the columns of the
+   * looked up inputs of the batch, so with the sparse update policies of SGD
+   * (like LazyAdamUpdate) only these rows of the embedding tables are updated,
+   * and the whole tables are neither cleared nor visited at each step.  The
+   * gradient of the other layers is held as it is (Lookup layers nested in
+   * other layers are handled as the other layers).  In the same way, if the
+   * network is trained on sparse predictors, the weight gradient of the first
+   * layer only holds the columns of the input units that appear in the batch.
+   * Parallel() is ignored.
+   *
+   * @param parameters Matrix of the model parameters to be optimized.
+   * @param begin Index of the starting point to use for objective function
+   *        gradient evaluation.
+   * @param gradient Sparse matrix to output gradient into.
+   * @param batchSize Number of points to be processed as a batch for objective
+   *        function gradient evaluation.
+   */
+  void Gradient(const arma::mat& parameters,
+                const size_t begin,
+                arma::sp_mat& gradient,
+                const size_t batchSize);
+
+  /**
+   * Evaluate the feedforward network and its gradient with the given
+   * parameters, for the given batch of points.  This takes a single forward
+   * pass, while calling Evaluate() and Gradient() one after the other takes
+   * two; it is used by the optimizers when it is available.  Parallel() is
+   * handled as by Gradient().
+   *
+   * @param parameters Matrix of the model parameters to be optimized.
+   * @param begin Index of the starting point to use for objective function
+   *        evaluation.
+   * @param gradient Matrix to output gradient into.
+   * @param batchSize Number of points to be processed as a batch for objective
+   *        function evaluation.
+   * @return The objective function of the batch with the given parameters.
+   */
+  double EvaluateWithGradient(const arma::mat& parameters,
+                              const size_t begin,
+                              arma::mat& gradient,
+                              const size_t batchSize);
+
   /**
    * Shuffle the order of function visitation. This may be called by the
-   * optimizer.
+   * optimizer.  Only the order is shuffled; the points of each batch are then
+   * gathered from the (unshuffled) data when the batch is visited.
    */
   void Shuffle();
 
@@ -219,6 +378,21 @@ class FFN
   //! Return the number of separable functions (the number of predictor points).
   size_t NumFunctions() const { return numFunctions; }
 
+  //! Get whether the gradient of each batch is computed by several OpenMP
+  //! threads.
+  bool Parallel() const { return parallel; }
+  //! Modify whether the gradient of each batch is computed by several OpenMP
+  //! threads.
+  bool& Parallel() { return parallel; }
+
+  //! Get whether the next batch is gathered by a background thread while the
+  //! current batch is trained.
+  bool Prefetch() const { return prefetch; }
+  //! Modify whether the next batch is gathered by a background thread while
+  //! the current batch is trained.  This pays off for large batches of
+  //! high-dimensional points, where the copy of the batch takes a while.
+  bool& Prefetch() { return prefetch; }
+
   //! Return the initial point for the optimization.
   const arma::mat& Parameters() const { return parameter; }
   //! Modify the initial point for the optimization.
@@ -229,6 +403,30 @@ class FFN
    */
   void ResetParameters();
 
+  /**
+   * Prepare the trained network for fast prediction: each Linear and
+   * LinearNoBias layer of the network is replaced by a QuantizedLinear layer,
+   * which holds its weights as 8-bit integers.  The parameters of the network
+   * then only hold the weights of the other layers, so the quantized layers
+   * are not changed by further training.  Layers inside other layers (like
+   * Sequential) are not quantized.
+   */
+  void Quantize();
+
+  /**
+   * Fuse each Linear layer of the network that is followed by a SigmoidLayer
+   * or a ReLULayer into a single FusedLinear layer, which adds the bias and
+   * applies the activation function in the same pass over the output, and
+   * multiplies by the derivative of the activation function in the same pass
+   * over the error.  The fused layers have the same parameters as the Linear
+   * layers, so the parameters of the network are not changed, and the network
+   * can be trained or used for prediction as before.  The layers of Sequential
+   * layers that expose their modules are fused too.  A network that takes
+   * sparse predictors should not be fused, since its first layer has to stay
+   * a Linear layer.
+   */
+  void Fuse();
+
   //! Serialize the model.
   template<typename Archive>
   void serialize(Archive& ar, const unsigned int /* version */);
@@ -268,6 +466,20 @@ class FFN
    */
   void Forward(arma::mat&& input);
 
+  /**
+   * The Forward algorithm for sparse input, which is handled by the first
+   * layer of the network (a Linear layer).
+   *
+   * @param input Sparse data sequence to compute probabilities for.
+   */
+  void Forward(const arma::sp_mat& input);
+
+  /**
+   * Pass the output of the first layer through the other layers of the
+   * network.
+   */
+  void ForwardLayers();
+
   /**
    * Prepare the network for the given data.
    * This function won't actually trigger training process.
@@ -277,6 +489,14 @@ class FFN
    */
   void ResetData(arma::mat predictors, arma::mat responses);
 
+  /**
+   * Prepare the network for the given sparse data.
+   *
+   * @param predictors Sparse input data variables.
+   * @param responses Outputs results from input data variables.
+   */
+  void ResetData(arma::sp_mat predictors, arma::mat responses);
+
   /**
    * The Backward algorithm (part of the Forward-Backward algorithm). Computes
    * backward pass for module.
@@ -289,6 +509,23 @@ class FFN
    */
   void Gradient(arma::mat&& input);
 
+  /**
+   * Update the gradient of all the layer modules for sparse input, which is
+   * handled by the first layer of the network (a Linear layer).
+   */
+  void Gradient(const arma::sp_mat& input);
+
+  /**
+   * Update the gradient of all the layer modules but the first one.
+   */
+  void GradientLayers();
+
+  /**
+   * Get the first layer of the network, which has to be a Linear layer for
+   * sparse input; otherwise, an exception is thrown.
+   */
+  Linear<arma::mat, arma::mat>& SparseInputLayer();
+
   /**
    * Reset the module status by setting the current deterministic parameter
    * for all modules that implement the Deterministic function.
@@ -300,6 +537,88 @@ class FFN
    */
   void ResetGradients(arma::mat& gradient);
 
+  /**
+   * Compute the objective function and the gradient of the given batch by
+   * splitting it between the given number of threads, each with its own
+   * replica of the network.
+   *
+   * @param begin Index of the first point of the batch.
+   * @param gradient Matrix to output gradient into.
+   * @param batchSize Number of points in the batch.
+   * @param numThreads Number of threads to split the batch between.
+   * @return The objective function of the batch.
+   */
+  double ParallelGradient(const size_t begin,
+                          arma::mat& gradient,
+                          const size_t batchSize,
+                          const size_t numThreads);
+
+  /**
+   * Build the given number of replicas of the network; the layers of each
+   * replica are copies of the layers of this network, and their weights are
+   * held by the parameter matrix of this network.
+   *
+   * @param numThreads Number of replicas to build.
+   */
+  void ResetReplicas(const size_t numThreads);
+
+  /**
+   * Build a replica of the network: its layers are copies of the layers of
+   * this network, and its parameters and weights are held by the parameters of
+   * this network.  The replica only reads the parameters in the forward pass.
+   */
+  NetworkType* NewReplica() const;
+
+  //! Delete the replicas of the network.
+  void ClearReplicas();
+
+  /**
+   * Replace each Linear layer of the given list that is followed by a
+   * SigmoidLayer or a ReLULayer by a FusedLinear layer, and do the same for
+   * the modules of the Sequential layers in the list.
+   *
+   * @param layers The list of layers to fuse.
+   */
+  void FuseLayers(std::vector<LayerTypes>& layers);
+
+  /**
+   * Make the given batch (in the order of visitation) the current batch, held
+   * by batchPredictors and batchResponses.  If prefetching is enabled, the
+   * batch that follows it is then gathered by a background thread.
+   *
+   * @param begin Index of the first point of the batch.
+   * @param batchSize Number of points in the batch.
+   */
+  void LoadBatch(const size_t begin, const size_t batchSize);
+
+  /**
+   * Gather the points of the given sparse batch (in the order of visitation)
+   * into batchSparsePredictors and batchResponses.
+   *
+   * @param begin Index of the first point of the batch.
+   * @param batchSize Number of points in the batch.
+   */
+  void GatherSparseBatch(const size_t begin, const size_t batchSize);
+
+  /**
+   * Copy the points of the given batch (in the order of visitation) into the
+   * given matrices, whose memory is reused if they already have the right
+   * size.
+   *
+   * @param begin Index of the first point of the batch.
+   * @param batchSize Number of points in the batch.
+   * @param batchPredictors Matrix to store the predictors of the batch in.
+   * @param batchResponses Matrix to store the responses of the batch in.
+   */
+  void GatherBatch(const size_t begin,
+                   const size_t batchSize,
+                   arma::mat& batchPredictors,
+                   arma::mat& batchResponses) const;
+
+  //! Wait for the batch being prefetched, if there is one, and throw it away,
+  //! along with the current batch.
+  void StopPrefetch();
+
   /**
    * Swap the content of this network with given network.
    *
@@ -332,6 +651,12 @@ class FFN
   //! The matrix of responses to the input data points.
   arma::mat responses;
 
+  //! Whether the network is trained on sparse predictors.
+  bool sparseInput;
+
+  //! The sparse matrix of data points (predictors), if sparseInput is set.
+  arma::sp_mat sparsePredictors;
+
   //! Matrix of (trained) parameters.
   arma::mat parameter;
 
@@ -382,6 +707,66 @@ class FFN
 
   //! Locally-stored copy visitor
   CopyVisitor copyVisitor;
+
+  //! Whether the gradient is computed by several threads.
+  bool parallel;
+
+  //! The replicas of the network used by each thread.
+  std::vector<NetworkType*> replicas;
+
+  //! The memory of the parameters the replicas were built with.
+  const double* replicaParameter;
+
+  //! The gradient computed by each thread (one column for each thread).
+  arma::mat threadGradients;
+
+  //! The dense gradient behind the sparse Gradient(); only the parts that were
+  //! set by the last call are cleared.
+  arma::mat sparseGradient;
+
+  //! The objective function computed by each thread.
+  arma::vec threadObjectives;
+
+  //! The order of visitation of the points (empty if they are visited in
+  //! order).
+  arma::uvec visitationOrder;
+
+  //! The predictors of the current batch.
+  arma::mat batchPredictors;
+
+  //! The sparse predictors of the current batch, if sparseInput is set.
+  arma::sp_mat batchSparsePredictors;
+
+  //! The weight columns of the first layer that are set by the sparse
+  //! Gradient() for the current batch of sparse predictors.
+  arma::uvec sparseInputColumns;
+
+  //! The responses of the current batch.
+  arma::mat batchResponses;
+
+  //! The index of the first point of the current batch.
+  size_t batchBegin;
+
+  //! The number of points of the current batch (0 if there is none).
+  size_t currentBatchSize;
+
+  //! Whether the next batch is gathered by a background thread.
+  bool prefetch;
+
+  //! The predictors of the batch being prefetched.
+  arma::mat nextPredictors;
+
+  //! The responses of the batch being prefetched.
+  arma::mat nextResponses;
+
+  //! The index of the first point of the batch being prefetched.
+  size_t nextBegin;
+
+  //! The number of points of the batch being prefetched.
+  size_t nextBatchSize;
+
+  //! The result of the background thread that prefetches the next batch.
+  std::future<void> nextBatch;
 }; // class FFN
 
 } // namespace ann
@@ -23,8 +23,16 @@
 #include "visitor/set_input_height_visitor.hpp"
 #include "visitor/set_input_width_visitor.hpp"
 
+#include "layer/fused_linear.hpp"
+#include "layer/quantized_linear.hpp"
+#include "layer/sequential.hpp"
+
 #include <boost/serialization/variant.hpp>
 
+#ifdef HAS_OPENMP
+  #include <omp.h>
+#endif
+
 namespace mlpack {
 namespace ann /** Artificial Neural Network. */ {
 
@@ -37,8 +45,16 @@ FFN<OutputLayerType, InitializationRuleType>::FFN(
     width(0),
     height(0),
     reset(false),
+    sparseInput(false),
     numFunctions(0),
-    deterministic(true)
+    deterministic(true),
+    parallel(false),
+    replicaParameter(NULL),
+    batchBegin(0),
+    currentBatchSize(0),
+    prefetch(false),
+    nextBegin(0),
+    nextBatchSize(0)
 {
   /* Nothing to do here */
 }
@@ -56,7 +72,15 @@ FFN<OutputLayerType, InitializationRuleType>::FFN(
     reset(false),
     predictors(std::move(predictors)),
     responses(std::move(responses)),
-    deterministic(true)
+    sparseInput(false),
+    deterministic(true),
+    parallel(false),
+    replicaParameter(NULL),
+    batchBegin(0),
+    currentBatchSize(0),
+    prefetch(false),
+    nextBegin(0),
+    nextBatchSize(0)
 {
   numFunctions = this->responses.n_cols;
 }
@@ -64,6 +88,8 @@ FFN<OutputLayerType, InitializationRuleType>::FFN(
 template<typename OutputLayerType, typename InitializationRuleType>
 FFN<OutputLayerType, InitializationRuleType>::~FFN()
 {
+  StopPrefetch();
+  ClearReplicas();
   std::for_each(network.begin(), network.end(),
       boost::apply_visitor(deleteVisitor));
 }
@@ -72,12 +98,39 @@ template<typename OutputLayerType, typename InitializationRuleType>
 void FFN<OutputLayerType, InitializationRuleType>::ResetData(
     arma::mat predictors, arma::mat responses)
 {
+  StopPrefetch();
+  visitationOrder.reset();
+
   numFunctions = responses.n_cols;
   this->predictors = std::move(predictors);
   this->responses = std::move(responses);
+  sparseInput = false;
+  sparsePredictors.reset();
+  this->deterministic = true;
+  ResetDeterministic();
+
+  if (!reset)
+    ResetParameters();
+}
+
+template<typename OutputLayerType, typename InitializationRuleType>
+void FFN<OutputLayerType, InitializationRuleType>::ResetData(
+    arma::sp_mat predictors, arma::mat responses)
+{
+  StopPrefetch();
+  visitationOrder.reset();
+
+  numFunctions = responses.n_cols;
+  sparsePredictors = std::move(predictors);
+  this->responses = std::move(responses);
+  sparseInput = true;
+  this->predictors.reset();
   this->deterministic = true;
   ResetDeterministic();
 
+  // Fail before the optimization starts.
+  SparseInputLayer();
+
   if (!reset)
     ResetParameters();
 }
@@ -95,6 +148,7 @@ void FFN<OutputLayerType, InitializationRuleType>::Train(
   Timer::Start("ffn_optimization");
   const double out = optimizer.Optimize(*this, parameter);
   Timer::Stop("ffn_optimization");
+  StopPrefetch();
 
   Log::Info << "FFN::FFN(): final objective of trained model is " << out
       << "." << std::endl;
@@ -105,28 +159,48 @@ template<typename OptimizerType>
 void FFN<OutputLayerType, InitializationRuleType>::Train(
     arma::mat predictors, arma::mat responses)
 {
-  numFunctions = responses.n_cols;
+  ResetData(std::move(predictors), std::move(responses));
 
-  this->predictors = std::move(predictors);
-  this->responses = std::move(responses);
+  OptimizerType optimizer;
 
-  this->deterministic = true;
-  ResetDeterministic();
+  // Train the model.
+  Timer::Start("ffn_optimization");
+  const double out = optimizer.Optimize(*this, parameter);
+  Timer::Stop("ffn_optimization");
+  StopPrefetch();
 
-  if (!reset)
-    ResetParameters();
+  Log::Info << "FFN::FFN(): final objective of trained model is " << out
+      << "." << std::endl;
+}
 
-  OptimizerType optimizer;
+template<typename OutputLayerType, typename InitializationRuleType>
+template<typename OptimizerType>
+void FFN<OutputLayerType, InitializationRuleType>::Train(
+      arma::sp_mat predictors,
+      arma::mat responses,
+      OptimizerType& optimizer)
+{
+  ResetData(std::move(predictors), std::move(responses));
 
   // Train the model.
   Timer::Start("ffn_optimization");
   const double out = optimizer.Optimize(*this, parameter);
   Timer::Stop("ffn_optimization");
+  StopPrefetch();
 
   Log::Info << "FFN::FFN(): final objective of trained model is " << out
       << "." << std::endl;
 }
 
+template<typename OutputLayerType, typename InitializationRuleType>
+template<typename OptimizerType>
+void FFN<OutputLayerType, InitializationRuleType>::Train(
+    arma::sp_mat predictors, arma::mat responses)
+{
+  OptimizerType optimizer;
+  Train(std::move(predictors), std::move(responses), optimizer);
+}
+
 template<typename OutputLayerType, typename InitializationRuleType>
 void FFN<OutputLayerType, InitializationRuleType>::Forward(
     arma::mat inputs, arma::mat& results)
@@ -166,7 +240,7 @@ double FFN<OutputLayerType, InitializationRuleType>::Backward(
 
 template<typename OutputLayerType, typename InitializationRuleType>
 void FFN<OutputLayerType, InitializationRuleType>::Predict(
-    arma::mat predictors, arma::mat& results)
+    arma::mat predictors, arma::mat& results, const size_t batchSize)
 {
   if (parameter.is_empty())
     ResetParameters();
@@ -177,40 +251,122 @@ void FFN<OutputLayerType, InitializationRuleType>::Predict(
     ResetDeterministic();
   }
 
-  arma::mat resultsTemp;
-  Forward(std::move(arma::mat(predictors.colptr(0),
-      predictors.n_rows, 1, false, true)));
-  resultsTemp = boost::apply_visitor(outputParameterVisitor,
-      network.back()).col(0);
+  if (predictors.n_cols == 0)
+  {
+    results.reset();
+    return;
+  }
+
+  size_t effectiveBatchSize = std::min(std::max(batchSize, (size_t) 1),
+      (size_t) predictors.n_cols);
+  for (size_t begin = 0; begin < predictors.n_cols; )
+  {
+    const size_t end = std::min(begin + effectiveBatchSize,
+        (size_t) predictors.n_cols) - 1;
+    Forward(std::move(arma::mat(predictors.colptr(begin), predictors.n_rows,
+        end - begin + 1, false, true)));
+    const arma::mat& output = boost::apply_visitor(outputParameterVisitor,
+        network.back());
+
+    // Some layers (like Join or Concat) don't keep one column for each point;
+    // in that case, the points have to be passed one at a time.
+    if (output.n_cols != end - begin + 1 && end != begin)
+    {
+      effectiveBatchSize = 1;
+      continue;
+    }
+
+    if (begin == 0)
+      results.set_size(output.n_rows, predictors.n_cols);
+
+    if (end == begin)
+      results.col(begin) = output.col(0);
+    else
+      results.cols(begin, end) = output;
+
+    begin = end + 1;
+  }
+}
+
+template<typename OutputLayerType, typename InitializationRuleType>
+void FFN<OutputLayerType, InitializationRuleType>::Predict(
+    arma::sp_mat predictors, arma::mat& results, const size_t batchSize)
+{
+  if (parameter.is_empty())
+    ResetParameters();
 
-  results = arma::mat(resultsTemp.n_elem, predictors.n_cols);
-  results.col(0) = resultsTemp.col(0);
+  if (!deterministic)
+  {
+    deterministic = true;
+    ResetDeterministic();
+  }
 
-  for (size_t i = 1; i < predictors.n_cols; i++)
+  if (predictors.n_cols == 0)
   {
-    Forward(std::move(arma::mat(predictors.colptr(i),
-        predictors.n_rows, 1, false, true)));
+    results.reset();
+    return;
+  }
 
-    resultsTemp = boost::apply_visitor(outputParameterVisitor,
+  const size_t effectiveBatchSize = std::min(std::max(batchSize, (size_t) 1),
+      (size_t) predictors.n_cols);
+  for (size_t begin = 0; begin < predictors.n_cols;
+      begin += effectiveBatchSize)
+  {
+    const size_t end = std::min(begin + effectiveBatchSize,
+        (size_t) predictors.n_cols) - 1;
+    Forward(arma::sp_mat(predictors.cols(begin, end)));
+    const arma::mat& output = boost::apply_visitor(outputParameterVisitor,
         network.back());
-    results.col(i) = resultsTemp.col(0);
+
+    if (begin == 0)
+      results.set_size(output.n_rows, predictors.n_cols);
+
+    results.cols(begin, end) = output;
+  }
+}
+
+template<typename OutputLayerType, typename InitializationRuleType>
+void FFN<OutputLayerType, InitializationRuleType>::Predict(
+    arma::mat predictors,
+    arma::mat& results,
+    Workspace& workspace,
+    const size_t batchSize) const
+{
+  if (parameter.is_empty())
+  {
+    throw std::invalid_argument("FFN::Predict(): the network has no "
+        "parameters; train it or call ResetParameters() first");
+  }
+
+  if (!workspace.replica || workspace.parameter != parameter.memptr() ||
+      workspace.replica->network.size() != network.size())
+  {
+    delete workspace.replica;
+    workspace.replica = NewReplica();
+    workspace.parameter = parameter.memptr();
+
+    workspace.replica->deterministic = true;
+    workspace.replica->ResetDeterministic();
   }
+
+  workspace.replica->Predict(std::move(predictors), results, batchSize);
 }
 
 template<typename OutputLayerType, typename InitializationRuleType>
 double FFN<OutputLayerType, InitializationRuleType>::Evaluate(
     const arma::mat& parameters)
 {
+  // The given parameters are only copied into the network by the first call.
   double res = 0;
-  for (size_t i = 0; i < predictors.n_cols; ++i)
-    res += Evaluate(parameters, i, true);
+  for (size_t i = 0; i < numFunctions; ++i)
+    res += Evaluate((i == 0) ? parameters : parameter, i, true);
 
   return res;
 }
 
 template<typename OutputLayerType, typename InitializationRuleType>
 double FFN<OutputLayerType, InitializationRuleType>::Evaluate(
-    const arma::mat& /* parameters */,
+    const arma::mat& parameters,
     const size_t begin,
     const size_t batchSize,
     const bool deterministic)
@@ -218,16 +374,37 @@ double FFN<OutputLayerType, InitializationRuleType>::Evaluate(
   if (parameter.is_empty())
     ResetParameters();
 
+  // The optimizer may evaluate other points than the parameters of the network
+  // (like the candidates of CNE and CMAES); since the layers use the memory of
+  // the parameters, the point is copied there.
+  if (parameters.memptr() != parameter.memptr())
+  {
+    if (parameters.n_elem != parameter.n_elem)
+    {
+      std::ostringstream oss;
+      oss << "FFN::Evaluate(): the given parameters have " << parameters.n_elem
+          << " elements, but the network has " << parameter.n_elem << "!";
+      throw std::invalid_argument(oss.str());
+    }
+
+    parameter = parameters;
+  }
+
   if (deterministic != this->deterministic)
   {
     this->deterministic = deterministic;
     ResetDeterministic();
   }
 
-  Forward(std::move(predictors.cols(begin, begin + batchSize - 1)));
+  LoadBatch(begin, batchSize);
+  if (sparseInput)
+    Forward(batchSparsePredictors);
+  else
+    Forward(std::move(batchPredictors));
+
   double res = outputLayer.Forward(
       std::move(boost::apply_visitor(outputParameterVisitor, network.back())),
-      std::move(responses.cols(begin, begin + batchSize - 1)));
+      std::move(batchResponses));
 
   return res;
 }
@@ -238,6 +415,119 @@ void FFN<OutputLayerType, InitializationRuleType>::Gradient(
     const size_t begin,
     arma::mat& gradient,
     const size_t batchSize)
+{
+  EvaluateWithGradient(parameters, begin, gradient, batchSize);
+}
+
+template<typename OutputLayerType, typename InitializationRuleType>
+void FFN<OutputLayerType, InitializationRuleType>::Gradient(
+    const arma::mat& parameters,
+    const size_t begin,
+    arma::sp_mat& gradient,
+    const size_t batchSize)
+{
+  Evaluate(parameters, begin, batchSize, false);
+
+  outputLayer.Backward(
+      std::move(boost::apply_visitor(outputParameterVisitor, network.back())),
+      std::move(batchResponses), std::move(error));
+
+  Backward();
+
+  // The gradient is computed into sparseGradient, which is kept between the
+  // calls.  The Lookup layers clear the columns they set in the last call, the
+  // first layer clears the columns it sets for sparse predictors (the others
+  // are not gathered), and the parts of the other layers are cleared here.
+  if (sparseGradient.n_elem != parameter.n_elem)
+    sparseGradient.zeros(parameter.n_rows, parameter.n_cols);
+
+  ResetGradients(sparseGradient);
+
+  // For each layer, the columns of its weights that are set (NULL if all the
+  // weights are set), the number of rows of these columns, and the number of
+  // elements that are in the columns (the others follow them and are set).
+  std::vector<size_t> offsets(network.size() + 1, 0);
+  std::vector<const arma::uvec*> columns(network.size(), NULL);
+  std::vector<size_t> rows(network.size(), 0);
+  std::vector<size_t> columnElements(network.size(), 0);
+  for (size_t i = 0; i < network.size(); ++i)
+  {
+    offsets[i + 1] = offsets[i] + boost::apply_visitor(weightSizeVisitor,
+        network[i]);
+
+    Lookup<>* const* lookup = boost::get<Lookup<>*>(&network[i]);
+    if (lookup)
+    {
+      columns[i] = &(*lookup)->GradientColumns();
+      rows[i] = (*lookup)->Parameters().n_rows;
+      columnElements[i] = offsets[i + 1] - offsets[i];
+    }
+    else if (i == 0 && sparseInput)
+    {
+      const Linear<>& layer = SparseInputLayer();
+      arma::uvec inputs(batchSparsePredictors.n_nonzero);
+      arma::sp_mat::const_iterator it = batchSparsePredictors.begin();
+      for (size_t k = 0; it != batchSparsePredictors.end(); ++it, ++k)
+        inputs[k] = it.row();
+      sparseInputColumns = arma::unique(inputs);
+
+      columns[i] = &sparseInputColumns;
+      rows[i] = layer.OutputSize();
+      columnElements[i] = layer.OutputSize() * layer.InputSize();
+    }
+    else if (offsets[i + 1] > offsets[i])
+    {
+      sparseGradient.rows(offsets[i], offsets[i + 1] - 1).zeros();
+    }
+  }
+
+  if (sparseInput)
+    Gradient(batchSparsePredictors);
+  else
+    Gradient(std::move(batchPredictors));
+
+  // Gather the locations of the parts that were set, in increasing order.
+  size_t numElements = 0;
+  for (size_t i = 0; i < network.size(); ++i)
+  {
+    numElements += offsets[i + 1] - offsets[i] - columnElements[i];
+    if (columns[i])
+      numElements += columns[i]->n_elem * rows[i];
+  }
+
+  arma::umat locations(2, numElements, arma::fill::zeros);
+  arma::vec values(numElements);
+  size_t n = 0;
+  for (size_t i = 0; i < network.size(); ++i)
+  {
+    for (size_t c = 0; columns[i] && c < columns[i]->n_elem; ++c)
+    {
+      const size_t first = offsets[i] + (*columns[i])[c] * rows[i];
+      for (size_t j = first; j < first + rows[i]; ++j, ++n)
+      {
+        locations(0, n) = j;
+        values[n] = sparseGradient[j];
+      }
+    }
+
+    for (size_t j = offsets[i] + columnElements[i]; j < offsets[i + 1];
+        ++j, ++n)
+    {
+      locations(0, n) = j;
+      values[n] = sparseGradient[j];
+    }
+  }
+
+  gradient = arma::sp_mat(locations, values, parameter.n_rows,
+      parameter.n_cols, false);
+}
+
+template<typename OutputLayerType, typename InitializationRuleType>
+double FFN<OutputLayerType, InitializationRuleType>::EvaluateWithGradient(
+    const arma::mat& parameters,
+    const size_t begin,
+    arma::mat& gradient,
+    const size_t batchSize)
 {
   if (gradient.is_empty())
   {
@@ -251,22 +541,297 @@ void FFN<OutputLayerType, InitializationRuleType>::Gradient(
     gradient.zeros();
   }
 
-  Evaluate(parameters, begin, batchSize, false);
+#ifdef HAS_OPENMP
+  // The first pass is done by this network, so that the layers know the size
+  // of their inputs before they are copied to the replicas.
+  const size_t numThreads = std::min((size_t) omp_get_max_threads(),
+      batchSize);
+  if (parallel && reset && numThreads > 1)
+    return ParallelGradient(begin, gradient, batchSize, numThreads);
+#endif
+
+  const double res = Evaluate(parameters, begin, batchSize, false);
 
   outputLayer.Backward(
       std::move(boost::apply_visitor(outputParameterVisitor, network.back())),
-      std::move(responses.cols(begin, begin + batchSize - 1)),
-      std::move(error));
+      std::move(batchResponses), std::move(error));
 
   Backward();
   ResetGradients(gradient);
-  Gradient(std::move(predictors.cols(begin, begin + batchSize - 1)));
+  if (sparseInput)
+    Gradient(batchSparsePredictors);
+  else
+    Gradient(std::move(batchPredictors));
+
+  return res;
+}
+
+template<typename OutputLayerType, typename InitializationRuleType>
+double FFN<OutputLayerType, InitializationRuleType>::ParallelGradient(
+    const size_t begin,
+    arma::mat& gradient,
+    const size_t batchSize,
+    const size_t numThreads)
+{
+  // The replicas have to be built again if the layers or the memory of the
+  // parameters changed.
+  if (replicas.size() != numThreads || replicaParameter != parameter.memptr() ||
+      replicas[0]->network.size() != network.size())
+  {
+    ResetReplicas(numThreads);
+  }
+
+  threadGradients.set_size(parameter.n_elem, numThreads);
+  threadObjectives.set_size(numThreads);
+  LoadBatch(begin, batchSize);
+
+  #pragma omp parallel for schedule(static) num_threads(numThreads)
+  for (omp_size_t t = 0; t < (omp_size_t) numThreads; ++t)
+  {
+    NetworkType& replica = *replicas[t];
+    const size_t first = t * batchSize / numThreads;
+    const size_t last = (t + 1) * batchSize / numThreads - 1;
+
+    arma::mat threadGradient(threadGradients.colptr(t), parameter.n_rows,
+        parameter.n_cols, false, true);
+    threadGradient.zeros();
+
+    arma::sp_mat threadSparsePredictors;
+    if (sparseInput)
+    {
+      threadSparsePredictors = batchSparsePredictors.cols(first, last);
+      replica.Forward(threadSparsePredictors);
+    }
+    else
+    {
+      replica.Forward(std::move(batchPredictors.cols(first, last)));
+    }
+
+    threadObjectives[t] = replica.outputLayer.Forward(std::move(
+        boost::apply_visitor(outputParameterVisitor, replica.network.back())),
+        std::move(batchResponses.cols(first, last)));
+    replica.outputLayer.Backward(std::move(boost::apply_visitor(
+        outputParameterVisitor, replica.network.back())),
+        std::move(batchResponses.cols(first, last)),
+        std::move(replica.error));
+
+    replica.Backward();
+    replica.ResetGradients(threadGradient);
+    if (sparseInput)
+      replica.Gradient(threadSparsePredictors);
+    else
+      replica.Gradient(std::move(batchPredictors.cols(first, last)));
+  }
+
+  // Sum the gradients of the threads.  Each thread sums a separate range of
+  // the parameters, so no locks are needed.
+  #pragma omp parallel for schedule(static) num_threads(numThreads)
+  for (omp_size_t t = 0; t < (omp_size_t) numThreads; ++t)
+  {
+    const size_t first = t * parameter.n_elem / numThreads;
+    const size_t last = (t + 1) * parameter.n_elem / numThreads;
+    if (first < last)
+    {
+      gradient.rows(first, last - 1) = arma::sum(threadGradients.rows(first,
+          last - 1), 1);
+    }
+  }
+
+  return arma::accu(threadObjectives);
+}
+
+template<typename OutputLayerType, typename InitializationRuleType>
+void FFN<OutputLayerType, InitializationRuleType>::ResetReplicas(
+    const size_t numThreads)
+{
+  ClearReplicas();
+
+  // The weights of the replicas are held by the parameters of this network, so
+  // each update of the optimizer is seen by all the replicas.
+  for (size_t t = 0; t < numThreads; ++t)
+  {
+    NetworkType* replica = NewReplica();
+    replica->deterministic = false;
+    replica->ResetDeterministic();
+    replicas.push_back(replica);
+  }
+
+  replicaParameter = parameter.memptr();
+}
+
+template<typename OutputLayerType, typename InitializationRuleType>
+typename FFN<OutputLayerType, InitializationRuleType>::NetworkType*
+FFN<OutputLayerType, InitializationRuleType>::NewReplica() const
+{
+  NetworkType* replica = new NetworkType(outputLayer, initializeRule);
+  for (size_t i = 0; i < network.size(); ++i)
+    replica->network.push_back(boost::apply_visitor(copyVisitor, network[i]));
+
+  // The replica doesn't write to the parameters, so they can be shared by a
+  // const network.
+  arma::mat weights(const_cast<double*>(parameter.memptr()), parameter.n_rows,
+      parameter.n_cols, false, false);
+
+  size_t offset = 0;
+  for (size_t i = 0; i < network.size(); ++i)
+  {
+    offset += boost::apply_visitor(WeightSetVisitor(std::move(weights),
+        offset), replica->network[i]);
+
+    boost::apply_visitor(resetVisitor, replica->network[i]);
+  }
+
+  replica->parameter = std::move(weights);
+  return replica;
+}
+
+template<typename OutputLayerType, typename InitializationRuleType>
+void FFN<OutputLayerType, InitializationRuleType>::ClearReplicas()
+{
+  for (size_t i = 0; i < replicas.size(); ++i)
+    delete replicas[i];
+
+  replicas.clear();
+  replicaParameter = NULL;
 }
 
 template<typename OutputLayerType, typename InitializationRuleType>
 void FFN<OutputLayerType, InitializationRuleType>::Shuffle()
 {
-  math::ShuffleData(predictors, responses, predictors, responses);
+  // The batch being prefetched follows the old order.
+  StopPrefetch();
+
+  // Only the order of visitation is shuffled, which avoids a copy of the whole
+  // dataset; the points are gathered when each batch is loaded.
+  visitationOrder = arma::shuffle(arma::linspace<arma::uvec>(0,
+      numFunctions - 1, numFunctions));
+}
+
+template<typename OutputLayerType, typename InitializationRuleType>
+void FFN<OutputLayerType, InitializationRuleType>::LoadBatch(
+    const size_t begin, const size_t batchSize)
+{
+  // The optimizer usually evaluates the batch whose gradient it just took.
+  if (currentBatchSize == batchSize && batchBegin == begin)
+    return;
+
+  // Sparse batches are not prefetched.
+  if (sparseInput)
+  {
+    GatherSparseBatch(begin, batchSize);
+    batchBegin = begin;
+    currentBatchSize = batchSize;
+    return;
+  }
+
+  if (nextBatch.valid())
+  {
+    // This rethrows the exception of the background thread, if there is one.
+    nextBatch.get();
+  }
+
+  if (nextBatchSize == batchSize && nextBegin == begin)
+  {
+    // The old buffers are reused for the batch that is prefetched next.
+    batchPredictors.swap(nextPredictors);
+    batchResponses.swap(nextResponses);
+  }
+  else
+  {
+    GatherBatch(begin, batchSize, batchPredictors, batchResponses);
+  }
+
+  batchBegin = begin;
+  currentBatchSize = batchSize;
+  nextBatchSize = 0;
+
+  // Gather the next batch while this one is trained.  The background thread
+  // only reads the data and the order of visitation, and only writes to the
+  // prefetch buffers, which aren't touched until the batch is loaded.
+  if (prefetch && begin + batchSize < numFunctions)
+  {
+    nextBegin = begin + batchSize;
+    nextBatchSize = std::min(batchSize, numFunctions - nextBegin);
+    nextBatch = std::async(std::launch::async, [this]()
+    {
+      GatherBatch(nextBegin, nextBatchSize, nextPredictors, nextResponses);
+    });
+  }
+}
+
+template<typename OutputLayerType, typename InitializationRuleType>
+void FFN<OutputLayerType, InitializationRuleType>::GatherSparseBatch(
+    const size_t begin, const size_t batchSize)
+{
+  if (visitationOrder.is_empty())
+  {
+    batchSparsePredictors = sparsePredictors.cols(begin, begin + batchSize - 1);
+    batchResponses = responses.cols(begin, begin + batchSize - 1);
+    return;
+  }
+
+  size_t nonzeros = 0;
+  for (size_t i = 0; i < batchSize; ++i)
+  {
+    const size_t point = visitationOrder[begin + i];
+    nonzeros += sparsePredictors.col_ptrs[point + 1] -
+        sparsePredictors.col_ptrs[point];
+  }
+
+  // The elements are gathered column by column, so they are already sorted.
+  arma::umat locations(2, nonzeros);
+  arma::vec values(nonzeros);
+  batchResponses.set_size(responses.n_rows, batchSize);
+  size_t n = 0;
+  for (size_t i = 0; i < batchSize; ++i)
+  {
+    const size_t point = visitationOrder[begin + i];
+    for (size_t k = sparsePredictors.col_ptrs[point];
+         k < sparsePredictors.col_ptrs[point + 1]; ++k, ++n)
+    {
+      locations(0, n) = sparsePredictors.row_indices[k];
+      locations(1, n) = i;
+      values[n] = sparsePredictors.values[k];
+    }
+
+    batchResponses.col(i) = responses.col(point);
+  }
+
+  batchSparsePredictors = arma::sp_mat(locations, values,
+      sparsePredictors.n_rows, batchSize, false);
+}
+
+template<typename OutputLayerType, typename InitializationRuleType>
+void FFN<OutputLayerType, InitializationRuleType>::GatherBatch(
+    const size_t begin,
+    const size_t batchSize,
+    arma::mat& batchPredictors,
+    arma::mat& batchResponses) const
+{
+  batchPredictors.set_size(predictors.n_rows, batchSize);
+  batchResponses.set_size(responses.n_rows, batchSize);
+  for (size_t i = 0; i < batchSize; ++i)
+  {
+    const size_t point = visitationOrder.is_empty() ? begin + i :
+        visitationOrder[begin + i];
+    std::copy(predictors.colptr(point), predictors.colptr(point) +
+        predictors.n_rows, batchPredictors.colptr(i));
+    std::copy(responses.colptr(point), responses.colptr(point) +
+        responses.n_rows, batchResponses.colptr(i));
+  }
+}
+
+template<typename OutputLayerType, typename InitializationRuleType>
+void FFN<OutputLayerType, InitializationRuleType>::StopPrefetch()
+{
+  if (nextBatch.valid())
+  {
+    nextBatch.wait();
+    nextBatch = std::future<void>();
+  }
+
+  nextBatchSize = 0;
+  currentBatchSize = 0;
 }
 
 template<typename OutputLayerType, typename InitializationRuleType>
@@ -279,6 +844,116 @@ void FFN<OutputLayerType, InitializationRuleType>::ResetParameters()
   networkInit.Initialize(network, parameter);
 }
 
+template<typename OutputLayerType, typename InitializationRuleType>
+void FFN<OutputLayerType, InitializationRuleType>::Quantize()
+{
+  if (parameter.is_empty())
+    ResetParameters();
+
+  // The replicas share the layers that are replaced.
+  ClearReplicas();
+
+  // Collect the weights of the layers that are kept, in order, before the
+  // others are replaced.
+  arma::mat keptParameter(parameter.n_elem, 1);
+  size_t keptWeights = 0, offset = 0;
+  for (size_t i = 0; i < network.size(); ++i)
+  {
+    const size_t weights = boost::apply_visitor(weightSizeVisitor, network[i]);
+
+    if (Linear<>** linear = boost::get<Linear<>*>(&network[i]))
+    {
+      LayerTypes layer = new QuantizedLinear<>(**linear);
+      boost::apply_visitor(deleteVisitor, network[i]);
+      network[i] = layer;
+    }
+    else if (LinearNoBias<>** linear = boost::get<LinearNoBias<>*>(
+        &network[i]))
+    {
+      LayerTypes layer = new QuantizedLinear<>(**linear);
+      boost::apply_visitor(deleteVisitor, network[i]);
+      network[i] = layer;
+    }
+    else if (weights > 0)
+    {
+      keptParameter.rows(keptWeights, keptWeights + weights - 1) =
+          parameter.rows(offset, offset + weights - 1);
+      keptWeights += weights;
+    }
+
+    offset += weights;
+  }
+
+  keptParameter.resize(keptWeights, 1);
+  parameter = std::move(keptParameter);
+
+  // Point the weights of the kept layers into the new parameters.
+  offset = 0;
+  for (size_t i = 0; i < network.size(); ++i)
+  {
+    offset += boost::apply_visitor(WeightSetVisitor(std::move(parameter),
+        offset), network[i]);
+
+    boost::apply_visitor(resetVisitor, network[i]);
+  }
+}
+
+template<typename OutputLayerType, typename InitializationRuleType>
+void FFN<OutputLayerType, InitializationRuleType>::Fuse()
+{
+  if (parameter.is_empty())
+    ResetParameters();
+
+  // The replicas share the layers that are replaced.
+  ClearReplicas();
+
+  FuseLayers(network);
+
+  // The fused layers hold the weights of the Linear layers they replace in the
+  // same order, so only the weights have to be pointed into the parameters.
+  size_t offset = 0;
+  for (size_t i = 0; i < network.size(); ++i)
+  {
+    offset += boost::apply_visitor(WeightSetVisitor(std::move(parameter),
+        offset), network[i]);
+
+    boost::apply_visitor(resetVisitor, network[i]);
+  }
+}
+
+template<typename OutputLayerType, typename InitializationRuleType>
+void FFN<OutputLayerType, InitializationRuleType>::FuseLayers(
+    std::vector<LayerTypes>& layers)
+{
+  std::vector<LayerTypes> fused;
+  for (size_t i = 0; i < layers.size(); ++i)
+  {
+    if (Sequential<>** sequential = boost::get<Sequential<>*>(&layers[i]))
+      FuseLayers((*sequential)->Model());
+
+    Linear<>** linear = boost::get<Linear<>*>(&layers[i]);
+    const bool sigmoid = linear && i + 1 < layers.size() &&
+        boost::get<SigmoidLayer<>*>(&layers[i + 1]);
+    const bool relu = linear && i + 1 < layers.size() &&
+        boost::get<ReLULayer<>*>(&layers[i + 1]);
+    if (!sigmoid && !relu)
+    {
+      fused.push_back(layers[i]);
+      continue;
+    }
+
+    if (sigmoid)
+      fused.push_back(new FusedLinear<LogisticFunction>(**linear));
+    else
+      fused.push_back(new FusedLinear<RectifierFunction>(**linear));
+
+    boost::apply_visitor(deleteVisitor, layers[i]);
+    boost::apply_visitor(deleteVisitor, layers[++i]);
+  }
+
+  layers = std::move(fused);
+}
+
 template<typename OutputLayerType, typename InitializationRuleType>
 void FFN<OutputLayerType, InitializationRuleType>::ResetDeterministic()
 {
@@ -306,6 +981,22 @@ void FFN<OutputLayerType, InitializationRuleType>::Forward(arma::mat&& input)
       boost::apply_visitor(outputParameterVisitor, network.front()))),
       network.front());
 
+  ForwardLayers();
+}
+
+template<typename OutputLayerType, typename InitializationRuleType>
+void FFN<OutputLayerType, InitializationRuleType>::Forward(
+    const arma::sp_mat& input)
+{
+  Linear<>& layer = SparseInputLayer();
+  layer.Forward(input, layer.OutputParameter());
+
+  ForwardLayers();
+}
+
+template<typename OutputLayerType, typename InitializationRuleType>
+void FFN<OutputLayerType, InitializationRuleType>::ForwardLayers()
+{
   if (!reset)
   {
     if (boost::apply_visitor(outputWidthVisitor, network.front()) != 0)
@@ -377,6 +1068,23 @@ void FFN<OutputLayerType, InitializationRuleType>::Gradient(arma::mat&& input)
   boost::apply_visitor(GradientVisitor(std::move(input), std::move(
       boost::apply_visitor(deltaVisitor, network[1]))), network.front());
 
+  GradientLayers();
+}
+
+template<typename OutputLayerType, typename InitializationRuleType>
+void FFN<OutputLayerType, InitializationRuleType>::Gradient(
+    const arma::sp_mat& input)
+{
+  Linear<>& layer = SparseInputLayer();
+  layer.Gradient(input, boost::apply_visitor(deltaVisitor, network[1]),
+      layer.Gradient());
+
+  GradientLayers();
+}
+
+template<typename OutputLayerType, typename InitializationRuleType>
+void FFN<OutputLayerType, InitializationRuleType>::GradientLayers()
+{
   for (size_t i = 1; i < network.size() - 1; ++i)
   {
     boost::apply_visitor(GradientVisitor(std::move(boost::apply_visitor(
@@ -389,6 +1097,20 @@ void FFN<OutputLayerType, InitializationRuleType>::Gradient(arma::mat&& input)
       network[network.size() - 1]);
 }
 
+template<typename OutputLayerType, typename InitializationRuleType>
+Linear<>& FFN<OutputLayerType, InitializationRuleType>::SparseInputLayer()
+{
+  Linear<>** layer = network.empty() ? NULL :
+      boost::get<Linear<>*>(&network.front());
+  if (!layer)
+  {
+    throw std::invalid_argument("FFN: sparse predictors can only be used if "
+        "the first layer of the network is a Linear layer");
+  }
+
+  return **layer;
+}
+
 template<typename OutputLayerType, typename InitializationRuleType>
 template<typename Archive>
 void FFN<OutputLayerType, InitializationRuleType>::serialize(
@@ -402,6 +1124,7 @@ void FFN<OutputLayerType, InitializationRuleType>::serialize(
   // Be sure to clear other layers before loading.
   if (Archive::is_loading::value)
   {
+    ClearReplicas();
     std::for_each(network.begin(), network.end(),
         boost::apply_visitor(deleteVisitor));
     network.clear();
@@ -431,6 +1154,9 @@ void FFN<OutputLayerType, InitializationRuleType>::serialize(
 template<typename OutputLayerType, typename InitializationRuleType>
 void FFN<OutputLayerType, InitializationRuleType>::Swap(FFN& network)
 {
+  StopPrefetch();
+  network.StopPrefetch();
+
   std::swap(outputLayer, network.outputLayer);
   std::swap(initializeRule, network.initializeRule);
   std::swap(width, network.width);
@@ -439,6 +1165,8 @@ void FFN<OutputLayerType, InitializationRuleType>::Swap(FFN& network)
   std::swap(this->network, network.network);
   std::swap(predictors, network.predictors);
   std::swap(responses, network.responses);
+  std::swap(sparseInput, network.sparseInput);
+  std::swap(sparsePredictors, network.sparsePredictors);
   std::swap(parameter, network.parameter);
   std::swap(numFunctions, network.numFunctions);
   std::swap(error, network.error);
@@ -448,6 +1176,13 @@ void FFN<OutputLayerType, InitializationRuleType>::Swap(FFN& network)
   std::swap(inputParameter, network.inputParameter);
   std::swap(outputParameter, network.outputParameter);
   std::swap(gradient, network.gradient);
+  std::swap(parallel, network.parallel);
+  std::swap(replicas, network.replicas);
+  std::swap(replicaParameter, network.replicaParameter);
+  std::swap(threadGradients, network.threadGradients);
+  std::swap(threadObjectives, network.threadObjectives);
+  std::swap(visitationOrder, network.visitationOrder);
+  std::swap(prefetch, network.prefetch);
 };
 
 template<typename OutputLayerType, typename InitializationRuleType>
@@ -460,6 +1195,8 @@ FFN<OutputLayerType, InitializationRuleType>::FFN(
     reset(network.reset),
     predictors(network.predictors),
     responses(network.responses),
+    sparseInput(network.sparseInput),
+    sparsePredictors(network.sparsePredictors),
     parameter(network.parameter),
     numFunctions(network.numFunctions),
     error(network.error),
@@ -468,7 +1205,15 @@ FFN<OutputLayerType, InitializationRuleType>::FFN(
     delta(network.delta),
     inputParameter(network.inputParameter),
     outputParameter(network.outputParameter),
-    gradient(network.gradient)
+    gradient(network.gradient),
+    parallel(network.parallel),
+    replicaParameter(NULL),
+    visitationOrder(network.visitationOrder),
+    batchBegin(0),
+    currentBatchSize(0),
+    prefetch(network.prefetch),
+    nextBegin(0),
+    nextBatchSize(0)
 {
   // Build new layers according to source network
   for (size_t i = 0; i < network.network.size(); ++i)
@@ -476,6 +1221,20 @@ FFN<OutputLayerType, InitializationRuleType>::FFN(
     this->network.push_back(boost::apply_visitor(copyVisitor,
         network.network[i]));
   }
+
+  // The weights of the new layers have to be held by the parameters of this
+  // network, so that they can be changed independently of the source network.
+  if (!parameter.is_empty())
+  {
+    size_t offset = 0;
+    for (size_t i = 0; i < this->network.size(); ++i)
+    {
+      offset += boost::apply_visitor(WeightSetVisitor(std::move(parameter),
+          offset), this->network[i]);
+
+      boost::apply_visitor(resetVisitor, this->network[i]);
+    }
+  }
 };
 
 template<typename OutputLayerType, typename InitializationRuleType>
@@ -486,8 +1245,7 @@ FFN<OutputLayerType, InitializationRuleType>::FFN(
     width(network.width),
     height(network.height),
     reset(network.reset),
-    predictors(std::move(network.predictors)),
-    responses(std::move(network.responses)),
+    sparseInput(network.sparseInput),
     parameter(std::move(network.parameter)),
     numFunctions(network.numFunctions),
     error(std::move(network.error)),
@@ -496,9 +1254,23 @@ FFN<OutputLayerType, InitializationRuleType>::FFN(
     delta(std::move(network.delta)),
     inputParameter(std::move(network.inputParameter)),
     outputParameter(std::move(network.outputParameter)),
-    gradient(std::move(network.gradient))
+    gradient(std::move(network.gradient)),
+    parallel(network.parallel),
+    replicaParameter(NULL),
+    batchBegin(0),
+    currentBatchSize(0),
+    prefetch(network.prefetch),
+    nextBegin(0),
+    nextBatchSize(0)
 {
   this->network = std::move(network.network);
+
+  // The data can only be moved once the other network doesn't read it anymore.
+  network.StopPrefetch();
+  predictors = std::move(network.predictors);
+  responses = std::move(network.responses);
+  sparsePredictors = std::move(network.sparsePredictors);
+  visitationOrder = std::move(network.visitationOrder);
 };
 
 template<typename OutputLayerType, typename InitializationRuleType>
@@ -18,6 +18,7 @@
 #include <mlpack/methods/ann/convolution_rules/naive_convolution.hpp>
 #include <mlpack/methods/ann/convolution_rules/fft_convolution.hpp>
 #include <mlpack/methods/ann/convolution_rules/svd_convolution.hpp>
+#include <mlpack/methods/ann/convolution_rules/im2col_convolution.hpp>
 
 #include "layer_types.hpp"
 
@@ -28,6 +29,17 @@ namespace ann /** Artificial Neural Network. */ {
  * Implementation of the Convolution class. The Convolution class represents a
  * single layer of a neural network.
  *
+ * With the default rules, each pass convolves every (outMap, inMap) pair of
+ * every point separately.  When Im2ColConvolution is used for a pass, the pass
+ * lowers the whole batch to a matrix of patches instead, and takes a single
+ * matrix multiplication; this is much faster for layers with many maps.
+ *
+ * @code
+ * Convolution<Im2ColConvolution<ValidConvolution>,
+ *             Im2ColConvolution<FullConvolution>,
+ *             Im2ColConvolution<ValidConvolution> > layer(3, 16, 5, 5);
+ * @endcode
+ *
  * @tparam ForwardConvolutionRule Convolution to perform forward process.
  * @tparam BackwardConvolutionRule Convolution to perform backward process.
  * @tparam GradientConvolutionRule Convolution to calculate gradient.
@@ -185,6 +197,46 @@ class Convolution
     return std::floor(size + p * 2 - k) / s + 1;
   }
 
+  /**
+   * Run the forward pass on the whole batch with a single matrix
+   * multiplication of the input patches and the filters.
+   *
+   * @param input Input data used for evaluating the specified function.
+   * @param output Resulting output activation.
+   */
+  template<typename eT>
+  void ForwardIm2Col(const arma::Mat<eT>& input, arma::Mat<eT>& output);
+
+  /**
+   * Run the backward pass on the whole batch with a single matrix
+   * multiplication of the error and the filters.
+   *
+   * @param gy The backpropagated error.
+   * @param g The calculated gradient.
+   */
+  template<typename eT>
+  void BackwardIm2Col(const arma::Mat<eT>& gy, arma::Mat<eT>& g);
+
+  /**
+   * Calculate the gradient of the whole batch with a single matrix
+   * multiplication of the input patches and the error.
+   *
+   * @param error The calculated error.
+   * @param gradient The calculated gradient.
+   */
+  template<typename eT>
+  void GradientIm2Col(const arma::Mat<eT>& error, arma::Mat<eT>& gradient);
+
+  /**
+   * Arrange the given error the way the input patches are: one row for each
+   * output element of each point, and one column for each output map.
+   *
+   * @param error The error, with the output maps of each point in a column.
+   * @param mappedError The arranged error.
+   */
+  template<typename eT>
+  void MapError(const arma::Mat<eT>& error, arma::Mat<eT>& mappedError);
+
   /*
    * Rotates a 3rd-order tensor counterclockwise by 180 degrees.
    *
@@ -321,6 +373,18 @@ class Convolution
   //! Locally-stored transformed gradient parameter.
   arma::cube gradientTemp;
 
+  //! Locally-stored padded error parameter (used by Im2ColConvolution).
+  arma::cube gPaddedTemp;
+
+  //! Locally-stored input patches (used by Im2ColConvolution).
+  arma::mat inputPatches;
+
+  //! Locally-stored output or error patches (used by Im2ColConvolution).
+  arma::mat outputPatches;
+
+  //! Locally-stored arranged error (used by Im2ColConvolution).
+  arma::mat mappedErrorTemp;
+
   //! Locally-stored delta object.
   OutputDataType delta;
 
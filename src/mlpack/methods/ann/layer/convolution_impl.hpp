@@ -113,7 +113,18 @@ void Convolution<
     OutputDataType
 >::Forward(const arma::Mat<eT>&& input, arma::Mat<eT>&& output)
 {
-  inputTemp = arma::cube(input.memptr(), inputWidth, inputHeight, inSize);
+  if (IsIm2ColConvolution<ForwardConvolutionRule>::value)
+  {
+    ForwardIm2Col(input, output);
+    return;
+  }
+
+  // The input may hold several points, each made of inSize maps (usually one
+  // point per column).  It is copied into the memory of the last pass (if it
+  // has the same size), instead of allocating a new cube for each pass.
+  const size_t batchSize = input.n_elem / (inputWidth * inputHeight * inSize);
+  inputTemp = arma::cube(const_cast<eT*>(input.memptr()), inputWidth,
+      inputHeight, inSize * batchSize, false, true);
 
   if (padW != 0 || padH != 0)
   {
@@ -123,32 +134,40 @@ void Convolution<
   size_t wConv = ConvOutSize(inputWidth, kW, dW, padW);
   size_t hConv = ConvOutSize(inputHeight, kH, dH, padH);
 
-  outputTemp = arma::zeros<arma::Cube<eT> >(wConv, hConv, outSize);
+  outputTemp = arma::zeros<arma::Cube<eT> >(wConv, hConv,
+      outSize * batchSize);
 
-  for (size_t outMap = 0, outMapIdx = 0; outMap < outSize; outMap++)
+  arma::Mat<eT> convOutput;
+  for (size_t point = 0; point < batchSize; ++point)
   {
-    for (size_t inMap = 0; inMap < inSize; inMap++, outMapIdx++)
+    const size_t inOffset = point * inSize;
+    const size_t outOffset = point * outSize;
+    for (size_t outMap = 0, outMapIdx = 0; outMap < outSize; outMap++)
     {
-      arma::Mat<eT> convOutput;
-
-      if (padW != 0 || padH != 0)
-      {
-        ForwardConvolutionRule::Convolution(inputPaddedTemp.slice(inMap),
-            weight.slice(outMapIdx), convOutput, dW, dH);
-      }
-      else
+      for (size_t inMap = 0; inMap < inSize; inMap++, outMapIdx++)
       {
-        ForwardConvolutionRule::Convolution(inputTemp.slice(inMap),
-            weight.slice(outMapIdx), convOutput, dW, dH);
+        if (padW != 0 || padH != 0)
+        {
+          ForwardConvolutionRule::Convolution(
+              inputPaddedTemp.slice(inOffset + inMap), weight.slice(outMapIdx),
+              convOutput, dW, dH);
+        }
+        else
+        {
+          ForwardConvolutionRule::Convolution(
+              inputTemp.slice(inOffset + inMap), weight.slice(outMapIdx),
+              convOutput, dW, dH);
+        }
+
+        outputTemp.slice(outOffset + outMap) += convOutput;
       }
 
-      outputTemp.slice(outMap) += convOutput;
+      outputTemp.slice(outOffset + outMap) += bias(outMap);
     }
-
-    outputTemp.slice(outMap) += bias(outMap);
   }
 
-  output = arma::Mat<eT>(outputTemp.memptr(), outputTemp.n_elem, 1);
+  output = arma::Mat<eT>(outputTemp.memptr(), outputTemp.n_elem / batchSize,
+      batchSize, false, true);
 
   outputWidth = outputTemp.n_rows;
   outputHeight = outputTemp.n_cols;
@@ -171,19 +190,23 @@ void Convolution<
 >::Backward(
     const arma::Mat<eT>&& /* input */, arma::Mat<eT>&& gy, arma::Mat<eT>&& g)
 {
-  arma::cube mappedError = arma::cube(gy.memptr(),
-        outputWidth, outputHeight, outSize);
-  gTemp = arma::zeros<arma::Cube<eT> >(inputTemp.n_rows,
-      inputTemp.n_cols, inputTemp.n_slices);
+  if (IsIm2ColConvolution<BackwardConvolutionRule>::value)
+  {
+    BackwardIm2Col(gy, g);
+    return;
+  }
 
+  const arma::cube mappedError(gy.memptr(), outputWidth, outputHeight,
+      outSize, false, true);
+  gTemp.zeros(inputTemp.n_rows, inputTemp.n_cols, inputTemp.n_slices);
+
+  arma::Mat<eT> rotatedFilter, output;
   for (size_t outMap = 0, outMapIdx = 0; outMap < outSize; outMap++)
   {
     for (size_t inMap = 0; inMap < inSize; inMap++, outMapIdx++)
     {
-      arma::Mat<eT> rotatedFilter;
       Rotate180(weight.slice(outMapIdx), rotatedFilter);
 
-      arma::Mat<eT> output;
       BackwardConvolutionRule::Convolution(mappedError.slice(outMap),
           rotatedFilter, output, dW, dH);
 
@@ -201,7 +224,7 @@ void Convolution<
     }
   }
 
-  g = arma::mat(gTemp.memptr(), gTemp.n_elem, 1);
+  g = arma::mat(gTemp.memptr(), gTemp.n_elem, 1, false, true);
 }
 
 template<
@@ -223,39 +246,37 @@ void Convolution<
     arma::Mat<eT>&& error,
     arma::Mat<eT>&& gradient)
 {
-  arma::cube mappedError;
-  if (padW != 0 && padH != 0)
-  {
-    mappedError = arma::cube(error.memptr(), outputWidth / padW,
-        outputHeight / padH, outSize);
-  }
-  else
+  if (IsIm2ColConvolution<GradientConvolutionRule>::value)
   {
-    mappedError = arma::cube(error.memptr(), outputWidth,
-        outputHeight, outSize);
+    GradientIm2Col(error, gradient);
+    return;
   }
 
-  gradientTemp = arma::zeros<arma::Cube<eT> >(weight.n_rows, weight.n_cols,
-      weight.n_slices);
+  const size_t errorWidth = (padW != 0 && padH != 0) ? outputWidth / padW :
+      outputWidth;
+  const size_t errorHeight = (padW != 0 && padH != 0) ? outputHeight / padH :
+      outputHeight;
+  const arma::cube mappedError(error.memptr(), errorWidth, errorHeight,
+      outSize, false, true);
 
+  gradientTemp.zeros(weight.n_rows, weight.n_cols, weight.n_slices);
+
+  arma::Cube<eT> output;
   for (size_t outMap = 0, outMapIdx = 0; outMap < outSize; outMap++)
   {
     for (size_t inMap = 0, s = outMap; inMap < inSize; inMap++, outMapIdx++,
         s += outSize)
     {
-      arma::Cube<eT> inputSlices;
-      if (padW != 0 || padH != 0)
-      {
-        inputSlices = inputPaddedTemp.slices(inMap, inMap);
-      }
-      else
-      {
-        inputSlices = inputTemp.slices(inMap, inMap);
-      }
+      // Use the slices in place instead of copying them.
+      arma::cube& inputCube = (padW != 0 || padH != 0) ? inputPaddedTemp :
+          inputTemp;
+      const arma::Cube<eT> inputSlices(inputCube.slice_memptr(inMap),
+          inputCube.n_rows, inputCube.n_cols, 1, false, true);
 
-      arma::Cube<eT> deltaSlices = mappedError.slices(outMap, outMap);
+      const arma::Cube<eT> deltaSlices(const_cast<eT*>(
+          mappedError.slice_memptr(outMap)), mappedError.n_rows,
+          mappedError.n_cols, 1, false, true);
 
-      arma::Cube<eT> output;
       GradientConvolutionRule::Convolution(inputSlices, deltaSlices,
           output, dW, dH);
 
@@ -291,6 +312,163 @@ void Convolution<
       gradientTemp.memptr(), gradientTemp.n_elem, 1, false, false);
 }
 
+template<
+    typename ForwardConvolutionRule,
+    typename BackwardConvolutionRule,
+    typename GradientConvolutionRule,
+    typename InputDataType,
+    typename OutputDataType
+>
+template<typename eT>
+void Convolution<
+    ForwardConvolutionRule,
+    BackwardConvolutionRule,
+    GradientConvolutionRule,
+    InputDataType,
+    OutputDataType
+>::ForwardIm2Col(const arma::Mat<eT>& input, arma::Mat<eT>& output)
+{
+  // Copy the input into the memory of the last pass (if it has the same
+  // size), instead of allocating a new cube for each pass.
+  const size_t batchSize = input.n_elem / (inputWidth * inputHeight * inSize);
+  inputTemp = arma::cube(const_cast<eT*>(input.memptr()), inputWidth,
+      inputHeight, inSize * batchSize, false, true);
+
+  if (padW != 0 || padH != 0)
+  {
+    Pad(inputTemp, padW, padH, inputPaddedTemp);
+  }
+
+  outputWidth = ConvOutSize(inputWidth, kW, dW, padW);
+  outputHeight = ConvOutSize(inputHeight, kH, dH, padH);
+
+  Im2ColConvolution<>::Im2Col((padW != 0 || padH != 0) ? inputPaddedTemp :
+      inputTemp, inSize, kW, kH, dW, dH, outputWidth, outputHeight,
+      inputPatches);
+
+  // Each column holds the filters of one output map, for all the input maps.
+  const arma::Mat<eT> filters(weight.memptr(), kW * kH * inSize, outSize,
+      false, true);
+
+  outputPatches = inputPatches * filters;
+  outputPatches.each_row() += arma::trans(bias);
+
+  // Put the output maps of each point in a column.
+  const size_t outputSize = outputWidth * outputHeight;
+  output.set_size(outputSize * outSize, batchSize);
+  for (size_t point = 0; point < batchSize; ++point)
+  {
+    output.col(point) = arma::vectorise(outputPatches.rows(point * outputSize,
+        (point + 1) * outputSize - 1));
+  }
+}
+
+template<
+    typename ForwardConvolutionRule,
+    typename BackwardConvolutionRule,
+    typename GradientConvolutionRule,
+    typename InputDataType,
+    typename OutputDataType
+>
+template<typename eT>
+void Convolution<
+    ForwardConvolutionRule,
+    BackwardConvolutionRule,
+    GradientConvolutionRule,
+    InputDataType,
+    OutputDataType
+>::BackwardIm2Col(const arma::Mat<eT>& gy, arma::Mat<eT>& g)
+{
+  MapError(gy, mappedErrorTemp);
+  const size_t batchSize = mappedErrorTemp.n_rows /
+      (outputWidth * outputHeight);
+
+  const arma::Mat<eT> filters(weight.memptr(), kW * kH * inSize, outSize,
+      false, true);
+  outputPatches = mappedErrorTemp * arma::trans(filters);
+
+  if (padW != 0 || padH != 0)
+  {
+    gPaddedTemp.zeros(inputWidth + padW * 2, inputHeight + padH * 2,
+        inSize * batchSize);
+    Im2ColConvolution<>::Col2Im(outputPatches, inSize, kW, kH, dW, dH,
+        outputWidth, outputHeight, gPaddedTemp);
+
+    gTemp = gPaddedTemp.tube(padW, padH, padW + inputWidth - 1,
+        padH + inputHeight - 1);
+  }
+  else
+  {
+    gTemp.zeros(inputWidth, inputHeight, inSize * batchSize);
+    Im2ColConvolution<>::Col2Im(outputPatches, inSize, kW, kH, dW, dH,
+        outputWidth, outputHeight, gTemp);
+  }
+
+  g = arma::mat(gTemp.memptr(), gTemp.n_elem / batchSize, batchSize, false,
+      true);
+}
+
+template<
+    typename ForwardConvolutionRule,
+    typename BackwardConvolutionRule,
+    typename GradientConvolutionRule,
+    typename InputDataType,
+    typename OutputDataType
+>
+template<typename eT>
+void Convolution<
+    ForwardConvolutionRule,
+    BackwardConvolutionRule,
+    GradientConvolutionRule,
+    InputDataType,
+    OutputDataType
+>::GradientIm2Col(const arma::Mat<eT>& error, arma::Mat<eT>& gradient)
+{
+  MapError(error, mappedErrorTemp);
+
+  // The input patches are only there if the forward pass used them too.
+  if (!IsIm2ColConvolution<ForwardConvolutionRule>::value)
+  {
+    Im2ColConvolution<>::Im2Col((padW != 0 || padH != 0) ? inputPaddedTemp :
+        inputTemp, inSize, kW, kH, dW, dH, outputWidth, outputHeight,
+        inputPatches);
+  }
+
+  // The gradient of the filters has the same layout as the filters.
+  gradient.submat(0, 0, weight.n_elem - 1, 0) = arma::vectorise(
+      arma::trans(inputPatches) * mappedErrorTemp);
+  gradient.submat(weight.n_elem, 0, weight.n_elem + outSize - 1, 0) =
+      arma::trans(arma::sum(mappedErrorTemp));
+}
+
+template<
+    typename ForwardConvolutionRule,
+    typename BackwardConvolutionRule,
+    typename GradientConvolutionRule,
+    typename InputDataType,
+    typename OutputDataType
+>
+template<typename eT>
+void Convolution<
+    ForwardConvolutionRule,
+    BackwardConvolutionRule,
+    GradientConvolutionRule,
+    InputDataType,
+    OutputDataType
+>::MapError(const arma::Mat<eT>& error, arma::Mat<eT>& mappedError)
+{
+  const size_t outputSize = outputWidth * outputHeight;
+  const size_t batchSize = error.n_elem / (outputSize * outSize);
+
+  mappedError.set_size(outputSize * batchSize, outSize);
+  for (size_t point = 0; point < batchSize; ++point)
+  {
+    mappedError.rows(point * outputSize, (point + 1) * outputSize - 1) =
+        arma::Mat<eT>(const_cast<eT*>(error.memptr()) + point * outputSize *
+        outSize, outputSize, outSize, false, true);
+  }
+}
+
 template<
     typename ForwardConvolutionRule,
     typename BackwardConvolutionRule,
@@ -103,6 +103,45 @@ class FastLSTM
                 ErrorType&& gy,
                 GradientType&& g);
 
+  /**
+   * Run the forward pass over a whole sequence at once, starting from a zero
+   * state (like a call to ResetCell() followed by one call to Forward() for
+   * each time step).  The input projections of all the time steps are
+   * computed with a single matrix multiplication, and the gate nonlinearities
+   * and the cell update of each time step are computed in a single pass.
+   *
+   * The whole sequence is kept, so BackwardSequence() backpropagates through
+   * all the time steps, regardless of rho.
+   *
+   * @param input Input sequence: the points of each time step (batchSize
+   *     columns) one time step after the other.
+   * @param output The output of each time step, with the same layout.
+   * @param batchSize Number of points in each time step.
+   */
+  template<typename eT>
+  void ForwardSequence(const arma::Mat<eT>& input,
+                       arma::Mat<eT>& output,
+                       const size_t batchSize = 1);
+
+  /**
+   * Run the backward pass over the sequence given to the last call of
+   * ForwardSequence(), and calculate the gradient of the parameters.  The
+   * errors of the gates are kept for all the time steps, so the error of the
+   * inputs and each part of the gradient take a single matrix multiplication.
+   *
+   * @param input The input sequence given to ForwardSequence().
+   * @param gy The backpropagated error of each time step, with the same layout
+   *     as the output of ForwardSequence().
+   * @param g The calculated error of each point of the input sequence.
+   * @param gradient The calculated gradient of the parameters, summed over the
+   *     sequence.
+   */
+  template<typename eT>
+  void BackwardSequence(const arma::Mat<eT>& input,
+                        const arma::Mat<eT>& gy,
+                        arma::Mat<eT>& g,
+                        arma::Mat<eT>& gradient);
+
   /*
    * Reset the layer parameter.
    */
@@ -112,10 +151,36 @@ class FastLSTM
    * Resets the cell to accept a new input. This breaks the BPTT chain starts a
    * new one.
    *
+   * Otherwise, after each window of rho steps, the next call to Forward()
+   * continues from the last output and cell of the window (truncated BPTT),
+   * like LSTM.
+   *
    * @param size The current maximum number of steps through time.
    */
   void ResetCell(const size_t size);
 
+  /**
+   * Get the current state of the layer: the last output, followed by the last
+   * cell, with one column for each point of the batch.  The next call to
+   * Forward() continues from this state.
+   *
+   * @param state Matrix to store the state in.
+   */
+  void State(OutputDataType& state) const;
+
+  /**
+   * Set the state of the layer (in the layout of State()), so that the next
+   * call to Forward() continues from it.  The number of columns of the state
+   * is the batch size of the next calls to Forward().  ResetCell() must have
+   * been called before (RNN does it).
+   *
+   * @param state The state to continue from.
+   */
+  void SetState(const OutputDataType& state);
+
+  //! Get the number of rows of the state of the layer.
+  size_t StateSize() const { return 2 * outSize; }
+
   /*
    * Calculate the gradient using the output delta and the input activation.
    *
@@ -290,6 +355,9 @@ class FastLSTM
   //! Locally-stored previous error.
   OutputDataType prevError;
 
+  //! Locally-stored gate errors of a whole sequence (see BackwardSequence()).
+  OutputDataType gateError;
+
   //! Locally-stored output parameters.
   OutputDataType outParameter;
 
@@ -298,6 +366,12 @@ class FastLSTM
 
   //! Current backpropagate through time steps.
   size_t bpttSteps;
+
+  //! Locally-stored cell the current window of steps started from.
+  OutputDataType initialCell;
+
+  //! Whether the next forward pass continues the sequence of the last window.
+  bool carryState;
 }; // class FastLSTM
 
 } // namespace ann
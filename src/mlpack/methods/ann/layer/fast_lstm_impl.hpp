@@ -20,7 +20,8 @@ namespace mlpack {
 namespace ann /** Artificial Neural Network. */ {
 
 template<typename InputDataType, typename OutputDataType>
-FastLSTM<InputDataType, OutputDataType>::FastLSTM()
+FastLSTM<InputDataType, OutputDataType>::FastLSTM() :
+    carryState(false)
 {
   // Nothing to do here.
 }
@@ -38,7 +39,8 @@ FastLSTM<InputDataType, OutputDataType>::FastLSTM(
     batchStep(0),
     gradientStepIdx(0),
     rhoSize(rho),
-    bpttSteps(0)
+    bpttSteps(0),
+    carryState(false)
 {
   // Weights for: input to gate layer (4 * outsize * inSize + 4 * outsize)
   // and output to gate (4 * outSize).
@@ -107,6 +109,54 @@ void FastLSTM<InputDataType, OutputDataType>::ResetCell(const size_t size)
       outParameter.resize(outSize, (size + 1) * batchSize);
     }
   }
+
+  // The new sequence starts from a zero state.
+  carryState = false;
+  initialCell.zeros(outSize, batchSize);
+  outParameter.cols(0, batchStep).zeros();
+}
+
+template<typename InputDataType, typename OutputDataType>
+void FastLSTM<InputDataType, OutputDataType>::State(OutputDataType& state) const
+{
+  state.zeros(2 * outSize, batchSize);
+  if (outParameter.is_empty())
+    return;
+
+  // The state is where the next call to Forward() takes it from.
+  if (carryState)
+  {
+    const size_t lastStep = (bpttSteps - 1) * batchSize;
+    state.rows(0, outSize - 1) = outParameter.cols(lastStep + batchSize,
+        lastStep + batchSize + batchStep);
+    state.rows(outSize, 2 * outSize - 1) = cell.cols(lastStep,
+        lastStep + batchStep);
+  }
+  else if (forwardStep == 0)
+  {
+    state.rows(0, outSize - 1) = outParameter.cols(0, batchStep);
+    state.rows(outSize, 2 * outSize - 1) = initialCell;
+  }
+  else
+  {
+    state.rows(0, outSize - 1) = outParameter.cols(forwardStep,
+        forwardStep + batchStep);
+    state.rows(outSize, 2 * outSize - 1) = cell.cols(forwardStep - batchSize,
+        forwardStep - batchSize + batchStep);
+  }
+}
+
+template<typename InputDataType, typename OutputDataType>
+void FastLSTM<InputDataType, OutputDataType>::SetState(
+    const OutputDataType& state)
+{
+  batchSize = state.n_cols;
+  batchStep = batchSize - 1;
+  ResetCell(rhoSize);
+
+  // ResetCell() starts a window of steps from a zero state.
+  outParameter.cols(0, batchStep) = state.rows(0, outSize - 1);
+  initialCell = state.rows(outSize, 2 * outSize - 1);
 }
 
 template<typename InputDataType, typename OutputDataType>
@@ -123,6 +173,17 @@ void FastLSTM<InputDataType, OutputDataType>::Forward(
     ResetCell(rhoSize);
   }
 
+  // If the last window of steps ended the sequence, the next window continues
+  // from its last output and cell.
+  if (carryState)
+  {
+    const size_t lastStep = (bpttSteps - 1) * batchSize;
+    outParameter.cols(0, batchStep) = outParameter.cols(lastStep + batchSize,
+        lastStep + batchSize + batchStep);
+    initialCell = cell.cols(lastStep, lastStep + batchStep);
+    carryState = false;
+  }
+
   gate.cols(forwardStep, forwardStep + batchStep) = input2GateWeight * input +
       output2GateWeight * outParameter.cols(
       forwardStep, forwardStep + batchStep);
@@ -144,7 +205,9 @@ void FastLSTM<InputDataType, OutputDataType>::Forward(
     cell.cols(forwardStep, forwardStep + batchStep) =
         gateActivation.submat(0, forwardStep, outSize - 1,
         forwardStep + batchStep) %
-        stateActivation.cols(forwardStep, forwardStep + batchStep);
+        stateActivation.cols(forwardStep, forwardStep + batchStep) +
+        gateActivation.submat(2 * outSize, forwardStep, 3 * outSize - 1,
+        forwardStep + batchStep) % initialCell;
   }
   else
   {
@@ -172,6 +235,7 @@ void FastLSTM<InputDataType, OutputDataType>::Forward(
   if ((forwardStep / batchSize) == bpttSteps)
   {
     forwardStep = 0;
+    carryState = true;
   }
 }
 
@@ -197,7 +261,8 @@ void FastLSTM<InputDataType, OutputDataType>::Backward(
       backwardStep - batchStep, 3 * outSize - 1, backwardStep) %
       cellActivationError;
 
-  if (backwardStep != 0)
+  // The first step of the window uses the cell the window started from.
+  if (backwardStep != batchStep)
   {
     prevError.submat(2 * outSize, 0, 3 * outSize - 1, batchStep) =
         cell.cols((backwardStep - batchSize) - batchStep,
@@ -208,7 +273,11 @@ void FastLSTM<InputDataType, OutputDataType>::Backward(
   }
   else
   {
-    prevError.submat(2 * outSize, 0, 3 * outSize - 1, batchStep).zeros();
+    prevError.submat(2 * outSize, 0, 3 * outSize - 1, batchStep) =
+        initialCell % cellActivationError % gateActivation.submat(2 * outSize,
+        backwardStep - batchStep, 3 * outSize - 1, backwardStep) % (1.0 -
+        gateActivation.submat(2 * outSize, backwardStep - batchStep,
+        3 * outSize - 1, backwardStep));
   }
 
   prevError.submat(0, 0, outSize - 1, batchStep) =
@@ -236,7 +305,7 @@ void FastLSTM<InputDataType, OutputDataType>::Backward(
   gradientStepIdx++;
   if (gradientStepIdx == bpttSteps)
   {
-    backwardStep = bpttSteps - 1;
+    backwardStep = batchSize * bpttSteps - 1;
     gradientStepIdx = 0;
   }
 }
@@ -258,7 +327,7 @@ void FastLSTM<InputDataType, OutputDataType>::Gradient(
       gradient.n_elem - 1, 0) = arma::vectorise(prevError *
       outParameter.cols(gradientStep - batchStep, gradientStep).t());
 
-  if (gradientStep == 0)
+  if (gradientStep == batchStep)
   {
     gradientStep = batchSize * bpttSteps - 1;
   }
@@ -268,6 +337,156 @@ void FastLSTM<InputDataType, OutputDataType>::Gradient(
   }
 }
 
+template<typename InputDataType, typename OutputDataType>
+template<typename eT>
+void FastLSTM<InputDataType, OutputDataType>::ForwardSequence(
+    const arma::Mat<eT>& input, arma::Mat<eT>& output, const size_t batchSize)
+{
+  const size_t steps = input.n_cols / batchSize;
+  const size_t n = steps * batchSize;
+
+  this->batchSize = batchSize;
+  batchStep = batchSize - 1;
+  ResetCell(steps);
+  if (outParameter.n_cols < n + batchSize)
+    outParameter.resize(outSize, n + batchSize);
+
+  // The state before the first time step is zero.
+  outParameter.cols(0, batchStep).zeros();
+
+  // Project the inputs of all the time steps at once.
+  gate.cols(0, n - 1) = input2GateWeight * input;
+  gate.cols(0, n - 1).each_col() += input2GateBias;
+
+  for (size_t step = 0; step < n; step += batchSize)
+  {
+    gate.cols(step, step + batchStep) += output2GateWeight *
+        outParameter.cols(step, step + batchStep);
+
+    // Compute the gates, the cell and the output of each unit in one pass.
+    // The layout is the same as Forward(): input gate, output gate, forget
+    // gate, then the hidden state.
+    for (size_t col = step; col <= step + batchStep; ++col)
+    {
+      const ElemType* gatePtr = gate.colptr(col);
+      ElemType* gateActivationPtr = gateActivation.colptr(col);
+      ElemType* stateActivationPtr = stateActivation.colptr(col);
+      ElemType* cellPtr = cell.colptr(col);
+      ElemType* cellActivationPtr = cellActivation.colptr(col);
+      ElemType* outputPtr = outParameter.colptr(col + batchSize);
+      const ElemType* prevCellPtr = (step == 0) ? NULL :
+          cell.colptr(col - batchSize);
+
+      for (size_t i = 0; i < outSize; ++i)
+      {
+        const ElemType inputGate = FastSigmoid(gatePtr[i]);
+        const ElemType outputGate = FastSigmoid(gatePtr[outSize + i]);
+        const ElemType forgetGate = FastSigmoid(gatePtr[2 * outSize + i]);
+        const ElemType state = std::tanh(gatePtr[3 * outSize + i]);
+
+        gateActivationPtr[i] = inputGate;
+        gateActivationPtr[outSize + i] = outputGate;
+        gateActivationPtr[2 * outSize + i] = forgetGate;
+        stateActivationPtr[i] = state;
+
+        cellPtr[i] = inputGate * state;
+        if (prevCellPtr)
+          cellPtr[i] += forgetGate * prevCellPtr[i];
+
+        cellActivationPtr[i] = std::tanh(cellPtr[i]);
+        outputPtr[i] = outputGate * cellActivationPtr[i];
+      }
+    }
+  }
+
+  output = outParameter.cols(batchSize, n + batchStep);
+}
+
+template<typename InputDataType, typename OutputDataType>
+template<typename eT>
+void FastLSTM<InputDataType, OutputDataType>::BackwardSequence(
+    const arma::Mat<eT>& input,
+    const arma::Mat<eT>& gy,
+    arma::Mat<eT>& g,
+    arma::Mat<eT>& gradient)
+{
+  const size_t n = input.n_cols;
+  gateError.set_size(4 * outSize, n);
+
+  // Walk back through the time steps; only the recurrent part of the error
+  // has to be computed one time step at a time.
+  arma::Mat<eT> stepError;
+  for (size_t step = n - batchSize; ; step -= batchSize)
+  {
+    const size_t last = step + batchStep;
+    stepError = gy.cols(step, last);
+    if (last + 1 < n)
+    {
+      stepError += output2GateWeight.t() * gateError.cols(last + 1,
+          last + batchSize);
+    }
+
+    cellActivationError = stepError % gateActivation.submat(outSize, step,
+        2 * outSize - 1, last) % (1 - arma::pow(cellActivation.cols(step,
+        last), 2));
+    if (last + 1 < n)
+      cellActivationError += forgetGateError;
+
+    forgetGateError = gateActivation.submat(2 * outSize, step,
+        3 * outSize - 1, last) % cellActivationError;
+
+    // Input gate.
+    gateError.submat(0, step, outSize - 1, last) = stateActivation.cols(
+        step, last) % cellActivationError % gateActivation.submat(0, step,
+        outSize - 1, last) % (1.0 - gateActivation.submat(0, step,
+        outSize - 1, last));
+
+    // Output gate.
+    gateError.submat(outSize, step, 2 * outSize - 1, last) =
+        cellActivation.cols(step, last) % stepError % gateActivation.submat(
+        outSize, step, 2 * outSize - 1, last) % (1.0 - gateActivation.submat(
+        outSize, step, 2 * outSize - 1, last));
+
+    // Forget gate.
+    if (step != 0)
+    {
+      gateError.submat(2 * outSize, step, 3 * outSize - 1, last) =
+          cell.cols(step - batchSize, last - batchSize) %
+          cellActivationError % gateActivation.submat(2 * outSize, step,
+          3 * outSize - 1, last) % (1.0 - gateActivation.submat(2 * outSize,
+          step, 3 * outSize - 1, last));
+    }
+    else
+    {
+      gateError.submat(2 * outSize, step, 3 * outSize - 1, last).zeros();
+    }
+
+    // Hidden state.
+    gateError.submat(3 * outSize, step, 4 * outSize - 1, last) =
+        gateActivation.submat(0, step, outSize - 1, last) %
+        cellActivationError % (1 - arma::pow(stateActivation.cols(step, last),
+        2));
+
+    if (step == 0)
+      break;
+  }
+
+  g = input2GateWeight.t() * gateError;
+
+  // The gradients of all the time steps at once; column step of outParameter
+  // holds the state before the given time step.
+  gradient.set_size(weights.n_rows, weights.n_cols);
+  gradient.submat(0, 0, input2GateWeight.n_elem - 1, 0) =
+      arma::vectorise(gateError * input.t());
+
+  gradient.submat(input2GateWeight.n_elem, 0, input2GateWeight.n_elem +
+      input2GateBias.n_elem - 1, 0) = arma::sum(gateError, 1);
+
+  gradient.submat(input2GateWeight.n_elem + input2GateBias.n_elem, 0,
+      gradient.n_elem - 1, 0) = arma::vectorise(gateError *
+      outParameter.cols(0, n - 1).t());
+}
+
 template<typename InputDataType, typename OutputDataType>
 template<typename Archive>
 void FastLSTM<InputDataType, OutputDataType>::serialize(
@@ -292,6 +511,8 @@ void FastLSTM<InputDataType, OutputDataType>::serialize(
   ar & BOOST_SERIALIZATION_NVP(forgetGateError);
   ar & BOOST_SERIALIZATION_NVP(prevError);
   ar & BOOST_SERIALIZATION_NVP(outParameter);
+  ar & BOOST_SERIALIZATION_NVP(initialCell);
+  ar & BOOST_SERIALIZATION_NVP(carryState);
 }
 
 } // namespace ann
@@ -0,0 +1,200 @@
+/**
+ * @file fused_linear.hpp
+ *
+ * Definition of the FusedLinear layer class, a Linear layer followed by an
+ * element-wise activation function, computed in one pass.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_LAYER_FUSED_LINEAR_HPP
+#define MLPACK_METHODS_ANN_LAYER_FUSED_LINEAR_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include "layer_types.hpp"
+#include "linear.hpp"
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+/**
+ * Implementation of the FusedLinear layer class.  The layer computes
+ * f(W x + b), the same as a Linear layer followed by a BaseLayer with the same
+ * activation function, and has the same parameters as the Linear layer (in the
+ * same order).
+ *
+ * The bias and the activation function are applied to the result of the
+ * matrix product in a single pass, instead of writing the affine output and
+ * then reading it again in a second layer.  In the backward pass, the error is
+ * multiplied by the derivative of the activation function in the same way, and
+ * the result is kept for the computation of the gradient.
+ *
+ * The layer is usually created with FFN::Fuse(), but it can also be added to a
+ * network directly.
+ *
+ * @tparam ActivationFunction Activation function applied to the affine output.
+ * @tparam InputDataType Type of the input data (arma::colvec, arma::mat,
+ *         arma::sp_mat or arma::cube).
+ * @tparam OutputDataType Type of the output data (arma::colvec, arma::mat,
+ *         arma::sp_mat or arma::cube).
+ */
+template <
+    class ActivationFunction = RectifierFunction,
+    typename InputDataType = arma::mat,
+    typename OutputDataType = arma::mat
+>
+class FusedLinear
+{
+ public:
+  //! Create the FusedLinear object.
+  FusedLinear();
+
+  /**
+   * Create the FusedLinear layer object using the specified number of units.
+   *
+   * @param inSize The number of input units.
+   * @param outSize The number of output units.
+   */
+  FusedLinear(const size_t inSize, const size_t outSize);
+
+  /**
+   * Create the FusedLinear layer object with a copy of the weights of the given
+   * Linear layer.
+   *
+   * @param layer The Linear layer to take the weights of.
+   */
+  FusedLinear(const Linear<InputDataType, OutputDataType>& layer);
+
+  /*
+   * Reset the layer parameter.
+   */
+  void Reset();
+
+  /**
+   * Ordinary feed forward pass of a neural network, evaluating the function
+   * f(x) by propagating the activity forward through f.
+   *
+   * @param input Input data used for evaluating the specified function.
+   * @param output Resulting output activation.
+   */
+  template<typename eT>
+  void Forward(const arma::Mat<eT>&& input, arma::Mat<eT>&& output);
+
+  /**
+   * Ordinary feed backward pass of a neural network, calculating the function
+   * f(x) by propagating x backwards trough f. Using the results from the feed
+   * forward pass.
+   *
+   * @param input The output of the forward pass.
+   * @param gy The backpropagated error.
+   * @param g The calculated gradient.
+   */
+  template<typename eT>
+  void Backward(const arma::Mat<eT>&& input,
+                arma::Mat<eT>&& gy,
+                arma::Mat<eT>&& g);
+
+  /*
+   * Calculate the gradient using the output delta and the input activation.
+   *
+   * @param input The input parameter used for calculating the gradient.
+   * @param error The calculated error.
+   * @param gradient The calculated gradient.
+   */
+  template<typename eT>
+  void Gradient(const arma::Mat<eT>&& input,
+                arma::Mat<eT>&& error,
+                arma::Mat<eT>&& gradient);
+
+  //! Get the number of input units.
+  size_t InputSize() const { return inSize; }
+  //! Get the number of output units.
+  size_t OutputSize() const { return outSize; }
+
+  //! Get the parameters.
+  OutputDataType const& Parameters() const { return weights; }
+  //! Modify the parameters.
+  OutputDataType& Parameters() { return weights; }
+
+  //! Get the input parameter.
+  InputDataType const& InputParameter() const { return inputParameter; }
+  //! Modify the input parameter.
+  InputDataType& InputParameter() { return inputParameter; }
+
+  //! Get the output parameter.
+  OutputDataType const& OutputParameter() const { return outputParameter; }
+  //! Modify the output parameter.
+  OutputDataType& OutputParameter() { return outputParameter; }
+
+  //! Get the delta.
+  OutputDataType const& Delta() const { return delta; }
+  //! Modify the delta.
+  OutputDataType& Delta() { return delta; }
+
+  //! Get the gradient.
+  OutputDataType const& Gradient() const { return gradient; }
+  //! Modify the gradient.
+  OutputDataType& Gradient() { return gradient; }
+
+  /**
+   * Serialize the layer
+   */
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */);
+
+ private:
+  /**
+   * Compute the error before the activation function, gy % f'(output), into
+   * activationError.
+   *
+   * @param output The output of the forward pass.
+   * @param gy The backpropagated error.
+   */
+  template<typename eT>
+  void ActivationError(const arma::Mat<eT>& output, const arma::Mat<eT>& gy);
+
+  //! Locally-stored number of input units.
+  size_t inSize;
+
+  //! Locally-stored number of output units.
+  size_t outSize;
+
+  //! Locally-stored weight object.
+  OutputDataType weights;
+
+  //! Locally-stored weight paramters.
+  OutputDataType weight;
+
+  //! Locally-stored bias term parameters.
+  OutputDataType bias;
+
+  //! Locally-stored error before the activation function, from the last
+  //! backward pass.
+  OutputDataType activationError;
+
+  //! Whether activationError belongs to the last forward pass.
+  bool activationErrorValid;
+
+  //! Locally-stored delta object.
+  OutputDataType delta;
+
+  //! Locally-stored gradient object.
+  OutputDataType gradient;
+
+  //! Locally-stored input parameter object.
+  InputDataType inputParameter;
+
+  //! Locally-stored output parameter object.
+  OutputDataType outputParameter;
+}; // class FusedLinear
+
+} // namespace ann
+} // namespace mlpack
+
+// Include implementation.
+#include "fused_linear_impl.hpp"
+
+#endif
@@ -0,0 +1,151 @@
+/**
+ * @file fused_linear_impl.hpp
+ *
+ * Implementation of the FusedLinear layer class, a Linear layer followed by an
+ * element-wise activation function, computed in one pass.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_LAYER_FUSED_LINEAR_IMPL_HPP
+#define MLPACK_METHODS_ANN_LAYER_FUSED_LINEAR_IMPL_HPP
+
+// In case it hasn't yet been included.
+#include "fused_linear.hpp"
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+template<typename ActivationFunction, typename InputDataType,
+         typename OutputDataType>
+FusedLinear<ActivationFunction, InputDataType, OutputDataType>::FusedLinear() :
+    inSize(0),
+    outSize(0),
+    activationErrorValid(false)
+{
+  // Nothing to do here.
+}
+
+template<typename ActivationFunction, typename InputDataType,
+         typename OutputDataType>
+FusedLinear<ActivationFunction, InputDataType, OutputDataType>::FusedLinear(
+    const size_t inSize,
+    const size_t outSize) :
+    inSize(inSize),
+    outSize(outSize),
+    activationErrorValid(false)
+{
+  weights.set_size(outSize * inSize + outSize, 1);
+}
+
+template<typename ActivationFunction, typename InputDataType,
+         typename OutputDataType>
+FusedLinear<ActivationFunction, InputDataType, OutputDataType>::FusedLinear(
+    const Linear<InputDataType, OutputDataType>& layer) :
+    inSize(layer.InputSize()),
+    outSize(layer.OutputSize()),
+    weights(layer.Parameters()),
+    activationErrorValid(false)
+{
+  Reset();
+}
+
+template<typename ActivationFunction, typename InputDataType,
+         typename OutputDataType>
+void FusedLinear<ActivationFunction, InputDataType, OutputDataType>::Reset()
+{
+  weight = OutputDataType(weights.memptr(), outSize, inSize, false, false);
+  bias = OutputDataType(weights.memptr() + weight.n_elem,
+      outSize, 1, false, false);
+}
+
+template<typename ActivationFunction, typename InputDataType,
+         typename OutputDataType>
+template<typename eT>
+void FusedLinear<ActivationFunction, InputDataType, OutputDataType>::Forward(
+    const arma::Mat<eT>&& input, arma::Mat<eT>&& output)
+{
+  output = weight * input;
+
+  // Add the bias and apply the activation function while the product is
+  // still in the cache.
+  for (size_t j = 0; j < output.n_cols; ++j)
+  {
+    eT* column = output.colptr(j);
+    for (size_t i = 0; i < outSize; ++i)
+      column[i] = ActivationFunction::Fn(column[i] + bias[i]);
+  }
+
+  activationErrorValid = false;
+}
+
+template<typename ActivationFunction, typename InputDataType,
+         typename OutputDataType>
+template<typename eT>
+void FusedLinear<ActivationFunction, InputDataType, OutputDataType>::Backward(
+    const arma::Mat<eT>&& input, arma::Mat<eT>&& gy, arma::Mat<eT>&& g)
+{
+  ActivationError(input, gy);
+  g = weight.t() * activationError;
+}
+
+template<typename ActivationFunction, typename InputDataType,
+         typename OutputDataType>
+template<typename eT>
+void FusedLinear<ActivationFunction, InputDataType, OutputDataType>::Gradient(
+    const arma::Mat<eT>&& input,
+    arma::Mat<eT>&& error,
+    arma::Mat<eT>&& gradient)
+{
+  // The networks do not call Backward() for their first layer, so the error
+  // before the activation function may not be there yet.
+  if (!activationErrorValid)
+    ActivationError(outputParameter, error);
+
+  arma::Mat<eT> weightGradient(gradient.memptr(), outSize, inSize, false,
+      true);
+  weightGradient = activationError * input.t();
+  gradient.rows(weight.n_elem, gradient.n_elem - 1) =
+      arma::sum(activationError, 1);
+
+  activationErrorValid = false;
+}
+
+template<typename ActivationFunction, typename InputDataType,
+         typename OutputDataType>
+template<typename eT>
+void FusedLinear<ActivationFunction, InputDataType, OutputDataType>::
+ActivationError(const arma::Mat<eT>& output, const arma::Mat<eT>& gy)
+{
+  activationError.set_size(gy.n_rows, gy.n_cols);
+
+  const eT* y = output.memptr();
+  const eT* e = gy.memptr();
+  eT* result = activationError.memptr();
+  for (size_t i = 0; i < gy.n_elem; ++i)
+    result[i] = e[i] * ActivationFunction::Deriv(y[i]);
+
+  activationErrorValid = true;
+}
+
+template<typename ActivationFunction, typename InputDataType,
+         typename OutputDataType>
+template<typename Archive>
+void FusedLinear<ActivationFunction, InputDataType, OutputDataType>::serialize(
+    Archive& ar, const unsigned int /* version */)
+{
+  ar & BOOST_SERIALIZATION_NVP(inSize);
+  ar & BOOST_SERIALIZATION_NVP(outSize);
+
+  // This is inefficient, but we have to allocate this memory so that
+  // WeightSetVisitor gets the right size.
+  if (Archive::is_loading::value)
+    weights.set_size(outSize * inSize + outSize, 1);
+}
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
@@ -120,6 +120,27 @@ class GRU
    */
   void ResetCell(const size_t size);
 
+  /**
+   * Get the current state of the layer (the last output), with one column for
+   * each point of the batch.  The next call to Forward() continues from this
+   * state.
+   *
+   * @param state Matrix to store the state in.
+   */
+  void State(OutputDataType& state) const;
+
+  /**
+   * Set the state of the layer (in the layout of State()), so that the next
+   * call to Forward() continues from it.  The number of columns of the state
+   * is the batch size of the next calls to Forward().
+   *
+   * @param state The state to continue from.
+   */
+  void SetState(const OutputDataType& state);
+
+  //! Get the number of rows of the state of the layer.
+  size_t StateSize() const { return outSize; }
+
   //! The value of the deterministic parameter.
   bool Deterministic() const { return deterministic; }
   //! Modify the value of the deterministic parameter.
@@ -237,6 +258,21 @@ class GRU
   //! Locally-stored previous error.
   arma::mat prevError;
 
+  //! Locally-stored input of the outputHidden2GateModule.
+  arma::mat modInput;
+
+  //! Locally-stored input of the hidden state module.
+  arma::mat outputH;
+
+  //! Locally-stored error of the input gate (delta zt).
+  arma::mat dZt;
+
+  //! Locally-stored error of the hidden state module (delta ot).
+  arma::mat dOt;
+
+  //! Locally-stored error of the forget gate (delta rt).
+  arma::mat dRt;
+
   //! If true dropout and scaling is disabled, see notes above.
   bool deterministic;
 
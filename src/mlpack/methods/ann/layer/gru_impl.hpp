@@ -92,10 +92,14 @@ template<typename eT>
 void GRU<InputDataType, OutputDataType>::Forward(
     arma::Mat<eT>&& input, arma::Mat<eT>&& output)
 {
+  // The state of another batch size can't be continued, so the sequence starts
+  // again from a zero state.
   if (input.n_cols != batchSize)
   {
     batchSize = input.n_cols;
     prevError.resize(3 * outSize, batchSize);
+    allZeros.zeros(outSize, batchSize);
+    ResetCell(rho);
   }
 
   // Process the input linearly(zt, rt, ot).
@@ -124,7 +128,7 @@ void GRU<InputDataType, OutputDataType>::Forward(
       boost::apply_visitor(outputParameterVisitor, forgetGateModule))),
       forgetGateModule);
 
-  arma::mat modInput = (boost::apply_visitor(outputParameterVisitor,
+  modInput = (boost::apply_visitor(outputParameterVisitor,
       forgetGateModule) % *prevOutput);
 
   // Pass that through the outputHidden2GateModule.
@@ -133,7 +137,7 @@ void GRU<InputDataType, OutputDataType>::Forward(
       outputHidden2GateModule);
 
   // Merge for ot.
-  arma::mat outputH = boost::apply_visitor(outputParameterVisitor,
+  outputH = boost::apply_visitor(outputParameterVisitor,
       input2GateModule).submat(2 * outSize, 0, 3 * outSize - 1, batchSize - 1) +
       boost::apply_visitor(outputParameterVisitor, outputHidden2GateModule);
 
@@ -192,10 +196,14 @@ template<typename eT>
 void GRU<InputDataType, OutputDataType>::Backward(
   const arma::Mat<eT>&& input, arma::Mat<eT>&& gy, arma::Mat<eT>&& g)
 {
+  // The state of another batch size can't be continued, so the sequence starts
+  // again from a zero state.
   if (input.n_cols != batchSize)
   {
     batchSize = input.n_cols;
     prevError.resize(3 * outSize, batchSize);
+    allZeros.zeros(outSize, batchSize);
+    ResetCell(rho);
   }
 
   if ((outParameter.size() - backwardStep  - 1) % rho != 0 && backwardStep != 0)
@@ -209,12 +217,12 @@ void GRU<InputDataType, OutputDataType>::Backward(
   }
 
   // Delta zt.
-  arma::mat dZt = gy % (*backIterator -
+  dZt = gy % (*backIterator -
       boost::apply_visitor(outputParameterVisitor,
       hiddenStateModule));
 
   // Delta ot.
-  arma::mat dOt = gy % (arma::ones<arma::vec>(outSize) -
+  dOt = gy % (arma::ones<arma::vec>(outSize) -
       boost::apply_visitor(outputParameterVisitor, inputGateModule));
 
   // Delta of input gate.
@@ -237,7 +245,7 @@ void GRU<InputDataType, OutputDataType>::Backward(
       outputHidden2GateModule);
 
   // Delta rt.
-  arma::mat dRt = boost::apply_visitor(deltaVisitor, outputHidden2GateModule) %
+  dRt = boost::apply_visitor(deltaVisitor, outputHidden2GateModule) %
       *backIterator;
 
   // Delta of forget gate.
@@ -293,10 +301,14 @@ void GRU<InputDataType, OutputDataType>::Gradient(
     arma::Mat<eT>&& /* error */,
     arma::Mat<eT>&& /* gradient */)
 {
+  // The state of another batch size can't be continued, so the sequence starts
+  // again from a zero state.
   if (input.n_cols != batchSize)
   {
     batchSize = input.n_cols;
     prevError.resize(3 * outSize, batchSize);
+    allZeros.zeros(outSize, batchSize);
+    ResetCell(rho);
   }
 
   if (gradIterator == outParameter.end())
@@ -336,6 +348,28 @@ void GRU<InputDataType, OutputDataType>::ResetCell(const size_t /* size */)
   backwardStep = 0;
 }
 
+template<typename InputDataType, typename OutputDataType>
+void GRU<InputDataType, OutputDataType>::State(OutputDataType& state) const
+{
+  state = *prevOutput;
+}
+
+template<typename InputDataType, typename OutputDataType>
+void GRU<InputDataType, OutputDataType>::SetState(const OutputDataType& state)
+{
+  if (state.n_cols != batchSize)
+  {
+    batchSize = state.n_cols;
+    prevError.resize(3 * outSize, batchSize);
+    allZeros.zeros(outSize, batchSize);
+  }
+
+  ResetCell(rho);
+  outParameter.clear();
+  outParameter.push_back(state);
+  prevOutput = outParameter.begin();
+}
+
 template<typename InputDataType, typename OutputDataType>
 template<typename Archive>
 void GRU<InputDataType, OutputDataType>::serialize(
@@ -16,11 +16,13 @@
 #include "concat_performance.hpp"
 #include "convolution.hpp"
 #include "dropconnect.hpp"
+#include "fused_linear.hpp"
 #include "glimpse.hpp"
 #include "layer_types.hpp"
 #include "linear.hpp"
 #include "linear_no_bias.hpp"
 #include "lstm.hpp"
+#include "quantized_linear.hpp"
 #include "gru.hpp"
 #include "fast_lstm.hpp"
 #include "recurrent.hpp"
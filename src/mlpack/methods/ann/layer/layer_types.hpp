@@ -39,6 +39,7 @@
 #include <mlpack/methods/ann/convolution_rules/border_modes.hpp>
 #include <mlpack/methods/ann/convolution_rules/naive_convolution.hpp>
 #include <mlpack/methods/ann/convolution_rules/fft_convolution.hpp>
+#include <mlpack/methods/ann/convolution_rules/im2col_convolution.hpp>
 
 namespace mlpack {
 namespace ann {
@@ -50,6 +51,7 @@ template<typename InputDataType, typename OutputDataType> class Glimpse;
 template<typename InputDataType, typename OutputDataType> class Linear;
 template<typename InputDataType, typename OutputDataType> class LinearNoBias;
 template<typename InputDataType, typename OutputDataType> class LSTM;
+template<typename InputDataType, typename OutputDataType> class QuantizedLinear;
 template<typename InputDataType, typename OutputDataType> class GRU;
 template<typename InputDataType, typename OutputDataType> class FastLSTM;
 template<typename InputDataType, typename OutputDataType> class Recurrent;
@@ -63,6 +65,13 @@ template<
 >
 class ConcatPerformance;
 
+template<
+    class ActivationFunction,
+    typename InputDataType,
+    typename OutputDataType
+>
+class FusedLinear;
+
 template<
     typename ForwardConvolutionRule,
     typename BackwardConvolutionRule,
@@ -92,10 +101,15 @@ using LayerTypes = boost::variant<
     Convolution<NaiveConvolution<ValidConvolution>,
                 NaiveConvolution<FullConvolution>,
                 NaiveConvolution<ValidConvolution>, arma::mat, arma::mat>*,
+    Convolution<Im2ColConvolution<ValidConvolution>,
+                Im2ColConvolution<FullConvolution>,
+                Im2ColConvolution<ValidConvolution>, arma::mat, arma::mat>*,
     CrossEntropyError<arma::mat, arma::mat>*,
     DropConnect<arma::mat, arma::mat>*,
     Dropout<arma::mat, arma::mat>*,
     ELU<arma::mat, arma::mat>*,
+    FusedLinear<LogisticFunction, arma::mat, arma::mat>*,
+    FusedLinear<RectifierFunction, arma::mat, arma::mat>*,
     Glimpse<arma::mat, arma::mat>*,
     HardTanH<arma::mat, arma::mat>*,
     Join<arma::mat, arma::mat>*,
@@ -113,6 +127,7 @@ using LayerTypes = boost::variant<
     MultiplyConstant<arma::mat, arma::mat>*,
     NegativeLogLikelihood<arma::mat, arma::mat>*,
     PReLU<arma::mat, arma::mat>*,
+    QuantizedLinear<arma::mat, arma::mat>*,
     Recurrent<arma::mat, arma::mat>*,
     RecurrentAttention<arma::mat, arma::mat>*,
     ReinforceNormal<arma::mat, arma::mat>*,
@@ -88,6 +88,36 @@ class Linear
                 arma::Mat<eT>&& error,
                 arma::Mat<eT>&& gradient);
 
+  /**
+   * Feed forward pass for sparse input.  The product of the weights with the
+   * input only visits the nonzero elements of the input, so the input does not
+   * have to be densified.
+   *
+   * @param input Sparse input data used for evaluating the specified function.
+   * @param output Resulting output activation.
+   */
+  template<typename eT>
+  void Forward(const arma::SpMat<eT>& input, arma::Mat<eT>& output);
+
+  /*
+   * Calculate the gradient for sparse input.  Only the columns of the weight
+   * gradient of the input units that are nonzero in the input are set; the
+   * other columns are not touched, so they have to be zero already.
+   *
+   * @param input The sparse input used for calculating the gradient.
+   * @param error The calculated error.
+   * @param gradient The calculated gradient.
+   */
+  template<typename eT>
+  void Gradient(const arma::SpMat<eT>& input,
+                const arma::Mat<eT>& error,
+                arma::Mat<eT>& gradient);
+
+  //! Get the number of input units.
+  size_t InputSize() const { return inSize; }
+  //! Get the number of output units.
+  size_t OutputSize() const { return outSize; }
+
   //! Get the parameters.
   OutputDataType const& Parameters() const { return weights; }
   //! Modify the parameters.
@@ -38,8 +38,8 @@ Linear<InputDataType, OutputDataType>::Linear(
 template<typename InputDataType, typename OutputDataType>
 void Linear<InputDataType, OutputDataType>::Reset()
 {
-  weight = arma::mat(weights.memptr(), outSize, inSize, false, false);
-  bias = arma::mat(weights.memptr() + weight.n_elem,
+  weight = OutputDataType(weights.memptr(), outSize, inSize, false, false);
+  bias = OutputDataType(weights.memptr() + weight.n_elem,
       outSize, 1, false, false);
 }
 
@@ -73,6 +73,37 @@ void Linear<InputDataType, OutputDataType>::Gradient(
       arma::sum(error, 1);
 }
 
+template<typename InputDataType, typename OutputDataType>
+template<typename eT>
+void Linear<InputDataType, OutputDataType>::Forward(
+    const arma::SpMat<eT>& input, arma::Mat<eT>& output)
+{
+  output = weight * input;
+  output.each_col() += bias;
+}
+
+template<typename InputDataType, typename OutputDataType>
+template<typename eT>
+void Linear<InputDataType, OutputDataType>::Gradient(
+    const arma::SpMat<eT>& input,
+    const arma::Mat<eT>& error,
+    arma::Mat<eT>& gradient)
+{
+  arma::Mat<eT> weightGradient(gradient.memptr(), outSize, inSize, false,
+      true);
+
+  // Column k of the weight gradient is the sum of the errors of the points,
+  // weighted by their input k.
+  typename arma::SpMat<eT>::const_iterator it;
+  for (it = input.begin(); it != input.end(); ++it)
+    weightGradient.col(it.row()).zeros();
+  for (it = input.begin(); it != input.end(); ++it)
+    weightGradient.col(it.row()) += (*it) * error.col(it.col());
+
+  gradient.submat(weight.n_elem, 0, gradient.n_elem - 1, 0) =
+      arma::sum(error, 1);
+}
+
 template<typename InputDataType, typename OutputDataType>
 template<typename Archive>
 void Linear<InputDataType, OutputDataType>::serialize(
@@ -70,6 +70,11 @@ class Lookup
 
   /*
    * Calculate the gradient using the output delta and the input activation.
+   * Only the columns of the looked up inputs are set (the errors of repeated
+   * inputs are summed).  If the gradient is the same memory as in the last
+   * call, only the columns set by that call are cleared, instead of the whole
+   * gradient, which is as large as the embedding table; so the gradient must
+   * not be modified between the calls.
    *
    * @param input The input parameter used for calculating the gradient.
    * @param error The calculated error.
@@ -105,6 +110,10 @@ class Lookup
   //! Modify the gradient.
   OutputDataType& Gradient() { return gradient; }
 
+  //! Get the (sorted) columns of the gradient set by the last call to
+  //! Gradient(); the other columns are zero.
+  const arma::uvec& GradientColumns() const { return gradientColumns; }
+
   /**
    * Serialize the layer
    */
@@ -127,6 +136,12 @@ class Lookup
   //! Locally-stored gradient object.
   OutputDataType gradient;
 
+  //! The columns of the gradient set by the last call to Gradient().
+  arma::uvec gradientColumns;
+
+  //! The memory of the gradient in the last call to Gradient().
+  const void* gradientMemory;
+
   //! Locally-stored input parameter object.
   InputDataType inputParameter;
 
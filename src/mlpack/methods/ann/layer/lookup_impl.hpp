@@ -24,7 +24,8 @@ Lookup<InputDataType, OutputDataType>::Lookup(
     const size_t inSize,
     const size_t outSize) :
     inSize(inSize),
-    outSize(outSize)
+    outSize(outSize),
+    gradientMemory(NULL)
 {
   weights.set_size(outSize, inSize);
 }
@@ -54,8 +55,26 @@ void Lookup<InputDataType, OutputDataType>::Gradient(
     arma::Mat<eT>&& error,
     arma::Mat<eT>&& gradient)
 {
-  gradient = arma::zeros<arma::Mat<eT> >(weights.n_rows, weights.n_cols);
-  gradient.cols(arma::conv_to<arma::uvec>::from(input) - 1) = error;
+  const arma::uvec indices = arma::conv_to<arma::uvec>::from(input) - 1;
+
+  // A batch only touches a few columns of the table, so unless the gradient
+  // has moved, only the columns set by the last call are cleared.
+  if (gradient.memptr() != gradientMemory ||
+      gradient.n_rows != weights.n_rows || gradient.n_cols != weights.n_cols)
+  {
+    gradient.zeros(weights.n_rows, weights.n_cols);
+  }
+  else
+  {
+    for (size_t i = 0; i < gradientColumns.n_elem; ++i)
+      gradient.col(gradientColumns[i]).zeros();
+  }
+
+  for (size_t i = 0; i < indices.n_elem; ++i)
+    gradient.col(indices[i]) += error.col(i);
+
+  gradientColumns = arma::unique(indices);
+  gradientMemory = gradient.memptr();
 }
 
 template<typename InputDataType, typename OutputDataType>
@@ -110,10 +110,38 @@ class LSTM
    * Resets the cell to accept a new input. This breaks the BPTT chain starts a
    * new one.
    *
+   * Otherwise, after each window of rho steps, the next call to Forward()
+   * continues from the last output and cell of the window, so a sequence that
+   * is longer than rho is trained with truncated BPTT: the state is carried
+   * along the whole sequence, but the error is only backpropagated within each
+   * window.
+   *
    * @param size The current maximum number of steps through time.
    */
   void ResetCell(const size_t size);
 
+  /**
+   * Get the current state of the layer: the last output, followed by the last
+   * cell, with one column for each point of the batch.  The next call to
+   * Forward() continues from this state.
+   *
+   * @param state Matrix to store the state in.
+   */
+  void State(OutputDataType& state) const;
+
+  /**
+   * Set the state of the layer (in the layout of State()), so that the next
+   * call to Forward() continues from it.  The number of columns of the state
+   * is the batch size of the next calls to Forward().  ResetCell() must have
+   * been called before (RNN does it).
+   *
+   * @param state The state to continue from.
+   */
+  void SetState(const OutputDataType& state);
+
+  //! Get the number of rows of the state of the layer.
+  size_t StateSize() const { return 2 * outSize; }
+
   /*
    * Calculate the gradient using the output delta and the input activation.
    *
@@ -308,11 +336,20 @@ class LSTM
   //! Locally-stored hidden layer error.
   OutputDataType hiddenError;
 
+  //! Locally-stored cell error.
+  OutputDataType cellError;
+
   //! Locally-stored current rho size.
   size_t rhoSize;
 
   //! Current backpropagate through time steps.
   size_t bpttSteps;
+
+  //! Locally-stored cell the current window of steps started from.
+  OutputDataType initialCell;
+
+  //! Whether the next forward pass continues the sequence of the last window.
+  bool carryState;
 }; // class LSTM
 
 } // namespace ann
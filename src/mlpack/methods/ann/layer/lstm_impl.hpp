@@ -19,7 +19,8 @@ namespace mlpack {
 namespace ann /** Artificial Neural Network. */ {
 
 template<typename InputDataType, typename OutputDataType>
-LSTM<InputDataType, OutputDataType>::LSTM()
+LSTM<InputDataType, OutputDataType>::LSTM() :
+    carryState(false)
 {
   // Nothing to do here.
 }
@@ -37,7 +38,8 @@ LSTM<InputDataType, OutputDataType>::LSTM(
     batchStep(0),
     gradientStepIdx(0),
     rhoSize(rho),
-    bpttSteps(0)
+    bpttSteps(0),
+    carryState(false)
 {
   weights.set_size(4 * outSize * inSize + 7 * outSize +
       4 * outSize * outSize, 1);
@@ -91,6 +93,54 @@ void LSTM<InputDataType, OutputDataType>::ResetCell(const size_t size)
       outParameter.resize(outSize, (size + 1) * batchSize);
     }
   }
+
+  // The new sequence starts from a zero state.
+  carryState = false;
+  initialCell.zeros(outSize, batchSize);
+  outParameter.cols(0, batchStep).zeros();
+}
+
+template<typename InputDataType, typename OutputDataType>
+void LSTM<InputDataType, OutputDataType>::State(OutputDataType& state) const
+{
+  state.zeros(2 * outSize, batchSize);
+  if (outParameter.is_empty())
+    return;
+
+  // The state is where the next call to Forward() takes it from.
+  if (carryState)
+  {
+    const size_t lastStep = (bpttSteps - 1) * batchSize;
+    state.rows(0, outSize - 1) = outParameter.cols(lastStep + batchSize,
+        lastStep + batchSize + batchStep);
+    state.rows(outSize, 2 * outSize - 1) = cell.cols(lastStep,
+        lastStep + batchStep);
+  }
+  else if (forwardStep == 0)
+  {
+    state.rows(0, outSize - 1) = outParameter.cols(0, batchStep);
+    state.rows(outSize, 2 * outSize - 1) = initialCell;
+  }
+  else
+  {
+    state.rows(0, outSize - 1) = outParameter.cols(forwardStep,
+        forwardStep + batchStep);
+    state.rows(outSize, 2 * outSize - 1) = cell.cols(forwardStep - batchSize,
+        forwardStep - batchSize + batchStep);
+  }
+}
+
+template<typename InputDataType, typename OutputDataType>
+void LSTM<InputDataType, OutputDataType>::SetState(
+    const OutputDataType& state)
+{
+  batchSize = state.n_cols;
+  batchStep = batchSize - 1;
+  ResetCell(rhoSize);
+
+  // ResetCell() starts a window of steps from a zero state.
+  outParameter.cols(0, batchStep) = state.rows(0, outSize - 1);
+  initialCell = state.rows(outSize, 2 * outSize - 1);
 }
 
 template<typename InputDataType, typename OutputDataType>
@@ -173,6 +223,17 @@ void LSTM<InputDataType, OutputDataType>::Forward(
     ResetCell(rhoSize);
   }
 
+  // If the last window of steps ended the sequence, the next window continues
+  // from its last output and cell.
+  if (carryState)
+  {
+    const size_t lastStep = (bpttSteps - 1) * batchSize;
+    outParameter.cols(0, batchStep) = outParameter.cols(lastStep + batchSize,
+        lastStep + batchSize + batchStep);
+    initialCell = cell.cols(lastStep, lastStep + batchStep);
+    carryState = false;
+  }
+
   inputGate.cols(forwardStep, forwardStep + batchStep) = input2GateInputWeight *
       input + output2GateInputWeight * outParameter.cols(forwardStep,
       forwardStep + batchStep);
@@ -188,12 +249,20 @@ void LSTM<InputDataType, OutputDataType>::Forward(
   if (forwardStep > 0)
   {
     inputGate.cols(forwardStep, forwardStep + batchStep) +=
-        cell2GateInputWeight % cell.cols(forwardStep - batchSize,
-        forwardStep - batchSize + batchStep);
+        cell.cols(forwardStep - batchSize, forwardStep - batchSize +
+        batchStep).each_col() % cell2GateInputWeight;
 
     forgetGate.cols(forwardStep, forwardStep + batchStep) +=
-        cell2GateForgetWeight % cell.cols(forwardStep - batchSize,
-        forwardStep - batchSize + batchStep);
+        cell.cols(forwardStep - batchSize, forwardStep - batchSize +
+        batchStep).each_col() % cell2GateForgetWeight;
+  }
+  else
+  {
+    inputGate.cols(forwardStep, forwardStep + batchStep) +=
+        initialCell.each_col() % cell2GateInputWeight;
+
+    forgetGate.cols(forwardStep, forwardStep + batchStep) +=
+        initialCell.each_col() % cell2GateForgetWeight;
   }
 
   inputGateActivation.cols(forwardStep, forwardStep + batchStep) = 1.0 /
@@ -215,8 +284,10 @@ void LSTM<InputDataType, OutputDataType>::Forward(
   if (forwardStep == 0)
   {
     cell.cols(forwardStep, forwardStep + batchStep) =
-        inputGateActivation.cols(forwardStep, forwardStep + batchStep) %
-        hiddenLayerActivation.cols(forwardStep, forwardStep + batchStep);
+        forgetGateActivation.cols(forwardStep, forwardStep + batchStep) %
+        initialCell + inputGateActivation.cols(forwardStep,
+        forwardStep + batchStep) % hiddenLayerActivation.cols(forwardStep,
+        forwardStep + batchStep);
   }
   else
   {
@@ -253,6 +324,7 @@ void LSTM<InputDataType, OutputDataType>::Forward(
   if ((forwardStep / batchSize) == bpttSteps)
   {
     forwardStep = 0;
+    carryState = true;
   }
 }
 
@@ -272,7 +344,7 @@ void LSTM<InputDataType, OutputDataType>::Backward(
       (1.0 - outputGateActivation.cols(backwardStep - batchStep,
       backwardStep)));
 
-  OutputDataType cellError = gy %
+  cellError = gy %
       outputGateActivation.cols(backwardStep - batchStep, backwardStep) %
       (1 - arma::pow(cellActivation.cols(backwardStep -
       batchStep, backwardStep), 2)) + outputGateError.each_col() %
@@ -283,7 +355,8 @@ void LSTM<InputDataType, OutputDataType>::Backward(
     cellError += inputCellError;
   }
 
-  if (backwardStep != 0)
+  // The first step of the window uses the state the window started from.
+  if (backwardStep != batchStep)
   {
     forgetGateError = cell.cols((backwardStep - batchSize) - batchStep,
       (backwardStep - batchSize)) % cellError % (forgetGateActivation.cols(
@@ -292,7 +365,9 @@ void LSTM<InputDataType, OutputDataType>::Backward(
   }
   else
   {
-    forgetGateError.zeros();
+    forgetGateError = initialCell % cellError % (forgetGateActivation.cols(
+      backwardStep - batchStep, backwardStep) % (1.0 -
+      forgetGateActivation.cols(backwardStep - batchStep, backwardStep)));
   }
 
   inputGateError = hiddenLayerActivation.cols(backwardStep - batchStep,
@@ -322,7 +397,7 @@ void LSTM<InputDataType, OutputDataType>::Backward(
   gradientStepIdx++;
   if (gradientStepIdx == bpttSteps)
   {
-    backwardStep = bpttSteps - 1;
+    backwardStep = batchSize * bpttSteps - 1;
     gradientStepIdx = 0;
   }
 }
@@ -395,7 +470,7 @@ void LSTM<InputDataType, OutputDataType>::Gradient(
   offset += cell2GateOutputWeight.n_elem;
 
   // Cell2GateForgetWeight and cell2GateInputWeight gradients.
-  if (gradientStep != 0)
+  if (gradientStep != batchStep)
   {
     gradient.submat(offset, 0, offset + cell2GateForgetWeight.n_elem - 1, 0) =
         arma::sum(forgetGateError % cell.cols(gradientStep - batchStep -
@@ -407,14 +482,14 @@ void LSTM<InputDataType, OutputDataType>::Gradient(
   }
   else
   {
-    gradient.submat(offset, 0, offset +
-        cell2GateForgetWeight.n_elem - 1, 0).zeros();
+    gradient.submat(offset, 0, offset + cell2GateForgetWeight.n_elem - 1, 0) =
+        arma::sum(forgetGateError % initialCell, 1);
     gradient.submat(offset + cell2GateForgetWeight.n_elem, 0, offset +
-        cell2GateForgetWeight.n_elem +
-        cell2GateInputWeight.n_elem - 1, 0).zeros();
+        cell2GateForgetWeight.n_elem + cell2GateInputWeight.n_elem - 1, 0) =
+        arma::sum(inputGateError % initialCell, 1);
   }
 
-  if (gradientStep == 0)
+  if (gradientStep == batchStep)
   {
     gradientStep = batchSize * bpttSteps - 1;
   }
@@ -448,6 +523,8 @@ void LSTM<InputDataType, OutputDataType>::serialize(
   ar & BOOST_SERIALIZATION_NVP(cellActivation);
   ar & BOOST_SERIALIZATION_NVP(prevError);
   ar & BOOST_SERIALIZATION_NVP(outParameter);
+  ar & BOOST_SERIALIZATION_NVP(initialCell);
+  ar & BOOST_SERIALIZATION_NVP(carryState);
 }
 
 } // namespace ann
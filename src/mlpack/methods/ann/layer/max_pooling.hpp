@@ -141,58 +141,68 @@ class MaxPooling
   void serialize(Archive& ar, const unsigned int /* version */);
 
  private:
- /**
-   * Apply pooling to the input and store the results.
+  /**
+   * Apply max pooling to a slice of the input.  The windows of each column of
+   * the output are handled together: each element of the windows is compared
+   * with the maxima of all the windows of the column in turn, in a loop without
+   * branches over the rows of the output.  The elements of each window are
+   * visited in column-major order, so on ties the first one is kept.
    *
-   * @param input The input to be apply the pooling rule.
-   * @param output The pooled result.
-   * @param poolingIndices The pooled indices.
+   * @param input The slice of the input.
+   * @param output The slice of the output.
+   * @param indices The index in the input slice of the maximum of each output
+   *     element (only written if StoreIndices is true).
    */
-  template<typename eT>
-  void PoolingOperation(const arma::Mat<eT>& input,
-                        arma::Mat<eT>& output,
-                        arma::Mat<eT>& poolingIndices)
+  template<bool StoreIndices, typename eT>
+  void PoolingOperation(const eT* input, eT* output, arma::u32* indices) const
   {
-    for (size_t j = 0, colidx = 0; j < output.n_cols; ++j, colidx += dW)
+    const size_t windowRows = kW - offset;
+    const size_t windowCols = kH - offset;
+
+    for (size_t j = 0; j < outputHeight; ++j)
     {
-      for (size_t i = 0, rowidx = 0; i < output.n_rows; ++i, rowidx += dH)
+      const size_t colStart = j * dH;
+      const size_t colEnd = std::min(colStart + windowCols, inputHeight);
+      eT* out = output + j * outputWidth;
+      arma::u32* outIndices = StoreIndices ? indices + j * outputWidth : NULL;
+
+      // The first element of each window is the first maximum.
+      const eT* first = input + colStart * inputWidth;
+      for (size_t i = 0; i < outputWidth; ++i)
       {
-        arma::mat subInput = input(arma::span(rowidx, rowidx + kW - 1 - offset),
-            arma::span(colidx, colidx + kH - 1 - offset));
-
-        const size_t idx = pooling.Pooling(subInput);
-        output(i, j) = subInput(idx);
+        out[i] = first[i * dW];
+        if (StoreIndices)
+          outIndices[i] = colStart * inputWidth + i * dW;
+      }
 
-        if (!deterministic)
+      for (size_t c = colStart; c < colEnd; ++c)
+      {
+        const eT* col = input + c * inputWidth;
+        for (size_t r = (c == colStart) ? 1 : 0; r < windowRows; ++r)
         {
-          arma::Mat<size_t> subIndices = indices(arma::span(rowidx,
-              rowidx + kW - 1 - offset),
-              arma::span(colidx, colidx + kH - 1 - offset));
-
-          poolingIndices(i, j) = subIndices(idx);
+          // The windows of the last rows may be cut by the border (only with
+          // ceil rounding).
+          if (r >= inputWidth)
+            break;
+          const size_t rows = std::min(outputWidth,
+              (inputWidth - r + dW - 1) / dW);
+
+          for (size_t i = 0; i < rows; ++i)
+          {
+            const eT value = col[i * dW + r];
+            const bool better = value > out[i];
+            out[i] = better ? value : out[i];
+            if (StoreIndices)
+            {
+              outIndices[i] = better ? (arma::u32) (c * inputWidth + i * dW +
+                  r) : outIndices[i];
+            }
+          }
         }
       }
     }
   }
 
-  /**
-   * Apply unpooling to the input and store the results.
-   *
-   * @param error The backward error.
-   * @param output The pooled result.
-   * @param poolingIndices The pooled indices.
-   */
-  template<typename eT>
-  void Unpooling(const arma::Mat<eT>& error,
-                 arma::Mat<eT>& output,
-                 arma::Mat<eT>& poolingIndices)
-  {
-    for (size_t i = 0; i < poolingIndices.n_elem; ++i)
-    {
-      output(poolingIndices(i)) += error(i);
-    }
-  }
-
   //! Locally-stored number of input units.
   size_t inSize;
 
@@ -211,9 +221,6 @@ class MaxPooling
   //! Locally-stored height of the stride operation.
   size_t dH;
 
-  //! Locally-stored reset parameter used to initialize the module once.
-  bool reset;
-
   //! Rounding operation used.
   bool floor;
 
@@ -244,9 +251,6 @@ class MaxPooling
   //! Locally-stored transformed output parameter.
   arma::cube gTemp;
 
-  //! Locally-stored pooling strategy.
-  MaxPoolingRule pooling;
-
   //! Locally-stored delta object.
   OutputDataType delta;
 
@@ -259,14 +263,13 @@ class MaxPooling
   //! Locally-stored output parameter object.
   OutputDataType outputParameter;
 
-  //! Locally-stored indices matrix parameter.
-  arma::Mat<size_t> indices;
-
-  //! Locally-stored indices column parameter.
-  arma::Col<size_t> indicesCol;
+  //! The index in the input slice of the maximum of each output element, one
+  //! column for each slice, for each forward pass that wasn't followed by a
+  //! backward pass yet.  32 bits are enough for the index in a slice.
+  std::vector<arma::Mat<arma::u32> > poolingIndices;
 
-  //! Locally-stored pooling indicies.
-  std::vector<arma::cube> poolingIndices;
+  //! Locally-stored number of pooling indices in use.
+  size_t poolingIndicesCount;
 }; // class MaxPooling
 
 } // namespace ann
@@ -20,7 +20,8 @@ namespace mlpack {
 namespace ann /** Artificial Neural Network. */ {
 
 template<typename InputDataType, typename OutputDataType>
-MaxPooling<InputDataType, OutputDataType>::MaxPooling()
+MaxPooling<InputDataType, OutputDataType>::MaxPooling() :
+    poolingIndicesCount(0)
 {
   // Nothing to do here.
 }
@@ -36,14 +37,14 @@ MaxPooling<InputDataType, OutputDataType>::MaxPooling(
     kH(kH),
     dW(dW),
     dH(dH),
-    reset(false),
     floor(floor),
     offset(0),
     inputWidth(0),
     inputHeight(0),
     outputWidth(0),
     outputHeight(0),
-    deterministic(false)
+    deterministic(false),
+    poolingIndicesCount(0)
 {
   // Nothing to do here.
 }
@@ -54,7 +55,9 @@ void MaxPooling<InputDataType, OutputDataType>::Forward(
   const arma::Mat<eT>&& input, arma::Mat<eT>&& output)
 {
   const size_t slices = input.n_elem / (inputWidth * inputHeight);
-  inputTemp = arma::cube(input.memptr(), inputWidth, inputHeight, slices);
+  // Copy the input into the memory of the last pass, if it has the same size.
+  inputTemp = arma::cube(const_cast<eT*>(input.memptr()), inputWidth,
+      inputHeight, slices, false, true);
 
   if (floor)
   {
@@ -69,40 +72,42 @@ void MaxPooling<InputDataType, OutputDataType>::Forward(
     offset = 1;
   }
 
-  outputTemp = arma::zeros<arma::Cube<eT> >(outputWidth, outputHeight,
-      slices);
+  outputTemp.set_size(outputWidth, outputHeight, slices);
 
+  // The indices are kept after the backward pass, so that the next forward
+  // passes can reuse their memory.
+  arma::u32* indices = NULL;
   if (!deterministic)
   {
-    poolingIndices.push_back(outputTemp);
-  }
-
-  if (!reset)
-  {
-    size_t elements = inputWidth * inputHeight;
-    indicesCol = arma::linspace<arma::Col<size_t> >(0, (elements - 1),
-        elements);
-
-    indices = arma::Mat<size_t>(indicesCol.memptr(), inputWidth, inputHeight);
+    if (poolingIndicesCount == poolingIndices.size())
+      poolingIndices.push_back(arma::Mat<arma::u32>());
 
-    reset = true;
+    poolingIndices[poolingIndicesCount].set_size(outputWidth * outputHeight,
+        slices);
+    indices = poolingIndices[poolingIndicesCount].memptr();
+    ++poolingIndicesCount;
   }
 
-  for (size_t s = 0; s < inputTemp.n_slices; s++)
+  // Each slice (a map of a point) is pooled independently.
+  const size_t outputElements = outputWidth * outputHeight;
+  #pragma omp parallel for
+  for (omp_size_t s = 0; s < (omp_size_t) slices; ++s)
   {
-    if (!deterministic)
+    if (indices)
     {
-      PoolingOperation(inputTemp.slice(s), outputTemp.slice(s),
-        poolingIndices.back().slice(s));
+      PoolingOperation<true>(inputTemp.slice_memptr(s),
+          outputTemp.slice_memptr(s), indices + s * outputElements);
     }
     else
     {
-      PoolingOperation(inputTemp.slice(s), outputTemp.slice(s),
-          inputTemp.slice(s));
+      PoolingOperation<false>(inputTemp.slice_memptr(s),
+          outputTemp.slice_memptr(s), indices);
     }
   }
 
-  output = arma::Mat<eT>(outputTemp.memptr(), outputTemp.n_elem, 1);
+  // Each column of the input is a separate point.
+  output = arma::Mat<eT>(outputTemp.memptr(), outputTemp.n_elem / input.n_cols,
+      input.n_cols, false, true);
 
   outputWidth = outputTemp.n_rows;
   outputHeight = outputTemp.n_cols;
@@ -114,21 +119,26 @@ template<typename eT>
 void MaxPooling<InputDataType, OutputDataType>::Backward(
     const arma::Mat<eT>&& /* input */, arma::Mat<eT>&& gy, arma::Mat<eT>&& g)
 {
-  arma::cube mappedError = arma::cube(gy.memptr(), outputWidth,
-      outputHeight, outSize);
+  const arma::cube mappedError(gy.memptr(), outputWidth, outputHeight,
+      outSize, false, true);
 
-  gTemp = arma::zeros<arma::cube>(inputTemp.n_rows,
-      inputTemp.n_cols, inputTemp.n_slices);
+  gTemp.zeros(inputTemp.n_rows, inputTemp.n_cols, inputTemp.n_slices);
 
-  for (size_t s = 0; s < mappedError.n_slices; s++)
+  // The error of each output element goes to the maximum of its window.
+  const arma::Mat<arma::u32>& indices = poolingIndices[poolingIndicesCount - 1];
+  #pragma omp parallel for
+  for (omp_size_t s = 0; s < (omp_size_t) mappedError.n_slices; ++s)
   {
-    Unpooling(mappedError.slice(s), gTemp.slice(s),
-        poolingIndices.back().slice(s));
+    const double* error = mappedError.slice_memptr(s);
+    const arma::u32* sliceIndices = indices.colptr(s);
+    double* sliceG = gTemp.slice_memptr(s);
+    for (size_t i = 0; i < indices.n_rows; ++i)
+      sliceG[sliceIndices[i]] += error[i];
   }
 
-  poolingIndices.pop_back();
+  --poolingIndicesCount;
 
-  g = arma::mat(gTemp.memptr(), gTemp.n_elem, 1);
+  g = arma::mat(gTemp.memptr(), gTemp.n_elem, 1, false, true);
 }
 
 template<typename InputDataType, typename OutputDataType>
@@ -122,61 +122,94 @@ class MeanPooling
 
  private:
   /**
-   * Apply pooling to the input and store the results.
+   * Apply mean pooling to a slice of the input.  The windows of each column of
+   * the output are handled together: each element of the windows is added to
+   * the sums of all the windows of the column in turn, in a loop over the rows
+   * of the output.
    *
-   * @param input The input to be apply the pooling rule.
-   * @param output The pooled result.
+   * @param input The slice of the input.
+   * @param output The slice of the output.
    */
   template<typename eT>
-  void Pooling(const arma::Mat<eT>& input, arma::Mat<eT>& output)
+  void Pooling(const eT* input, eT* output) const
   {
-    const size_t rStep = kW;
-    const size_t cStep = kH;
-
-    for (size_t j = 0, colidx = 0; j < output.n_cols; ++j, colidx += dH)
+    for (size_t j = 0; j < outputHeight; ++j)
     {
-      for (size_t i = 0, rowidx = 0; i < output.n_rows; ++i, rowidx += dW)
+      eT* out = output + j * outputWidth;
+      std::fill(out, out + outputWidth, eT(0));
+
+      const size_t colStart = j * dH;
+      const size_t colEnd = WindowEnd(colStart, kH, inputHeight);
+      for (size_t c = colStart; c < colEnd; ++c)
       {
-        arma::mat subInput = input(
-            arma::span(rowidx, rowidx + rStep - 1 - offset),
-            arma::span(colidx, colidx + cStep - 1 - offset));
+        const eT* col = input + c * inputWidth;
+        for (size_t r = 0; r < kW - offset && r < inputWidth; ++r)
+        {
+          const size_t rows = WindowRows(r);
+          for (size_t i = 0; i < rows; ++i)
+            out[i] += col[i * dW + r];
+        }
+      }
 
-        output(i, j) = arma::mean(arma::mean(subInput));
+      for (size_t i = 0; i < outputWidth; ++i)
+      {
+        out[i] /= (colEnd - colStart) * (WindowEnd(i * dW, kW, inputWidth) -
+            i * dW);
       }
     }
   }
 
   /**
-   * Apply unpooling to the input and store the results.
+   * Apply unpooling to the error of a slice of the output: the error of each
+   * output element is spread evenly over its window.
    *
-   * @param input The input to be apply the unpooling rule.
-   * @param output The pooled result.
+   * @param error The error of the slice of the output.
+   * @param output The error of the slice of the input.
    */
   template<typename eT>
-  void Unpooling(const arma::Mat<eT>& input,
-                 const arma::Mat<eT>& error,
-                 arma::Mat<eT>& output)
+  void Unpooling(const eT* error, eT* output) const
   {
-    const size_t rStep = input.n_rows / error.n_rows - offset;
-    const size_t cStep = input.n_cols / error.n_cols - offset;
-
-    arma::Mat<eT> unpooledError;
-    for (size_t j = 0; j < input.n_cols - cStep; j += cStep)
+    std::vector<eT> spread(outputWidth);
+    for (size_t j = 0; j < outputHeight; ++j)
     {
-      for (size_t i = 0; i < input.n_rows - rStep; i += rStep)
+      const size_t colStart = j * dH;
+      const size_t colEnd = WindowEnd(colStart, kH, inputHeight);
+      for (size_t i = 0; i < outputWidth; ++i)
       {
-        const arma::Mat<eT>& inputArea = input(arma::span(i, i + rStep - 1),
-            arma::span(j, j + cStep - 1));
-
-        unpooledError = arma::Mat<eT>(inputArea.n_rows, inputArea.n_cols);
-        unpooledError.fill(error(i / rStep, j / cStep) / inputArea.n_elem);
+        spread[i] = error[j * outputWidth + i] / ((colEnd - colStart) *
+            (WindowEnd(i * dW, kW, inputWidth) - i * dW));
+      }
 
-        output(arma::span(i, i + rStep - 1 - offset),
-            arma::span(j, j + cStep - 1 - offset)) += unpooledError;
+      for (size_t c = colStart; c < colEnd; ++c)
+      {
+        eT* col = output + c * inputWidth;
+        for (size_t r = 0; r < kW - offset && r < inputWidth; ++r)
+        {
+          const size_t rows = WindowRows(r);
+          for (size_t i = 0; i < rows; ++i)
+            col[i * dW + r] += spread[i];
+        }
       }
     }
   }
 
+  //! Get the end of the window that starts at the given position, for the
+  //! given window size; the windows may be cut by the border (only with ceil
+  //! rounding).
+  size_t WindowEnd(const size_t start,
+                   const size_t size,
+                   const size_t inputSize) const
+  {
+    return std::min(start + size - offset, inputSize);
+  }
+
+  //! Get the number of rows of the output whose windows hold the given row of
+  //! the windows.
+  size_t WindowRows(const size_t r) const
+  {
+    return std::min(outputWidth, (inputWidth - r + dW - 1) / dW);
+  }
+
   //! Locally-stored number of input units.
   size_t inSize;
 
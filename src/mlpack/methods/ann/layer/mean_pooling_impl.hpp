@@ -54,7 +54,9 @@ void MeanPooling<InputDataType, OutputDataType>::Forward(
     const arma::Mat<eT>&& input, arma::Mat<eT>&& output)
 {
   size_t slices = input.n_elem / (inputWidth * inputHeight);
-  inputTemp = arma::cube(input.memptr(), inputWidth, inputHeight, slices);
+  // Copy the input into the memory of the last pass, if it has the same size.
+  inputTemp = arma::cube(const_cast<eT*>(input.memptr()), inputWidth,
+      inputHeight, slices, false, true);
 
   if (floor)
   {
@@ -71,13 +73,16 @@ void MeanPooling<InputDataType, OutputDataType>::Forward(
     offset = 1;
   }
 
-  outputTemp = arma::zeros<arma::Cube<eT> >(outputWidth, outputHeight,
-      slices);
+  outputTemp.set_size(outputWidth, outputHeight, slices);
 
-  for (size_t s = 0; s < inputTemp.n_slices; s++)
-    Pooling(inputTemp.slice(s), outputTemp.slice(s));
+  // Each slice (a map of a point) is pooled independently.
+  #pragma omp parallel for
+  for (omp_size_t s = 0; s < (omp_size_t) slices; ++s)
+    Pooling(inputTemp.slice_memptr(s), outputTemp.slice_memptr(s));
 
-  output = arma::Mat<eT>(outputTemp.memptr(), outputTemp.n_elem, 1);
+  // Each column of the input is a separate point.
+  output = arma::Mat<eT>(outputTemp.memptr(), outputTemp.n_elem / input.n_cols,
+      input.n_cols, false, true);
 
   outputWidth = outputTemp.n_rows;
   outputHeight = outputTemp.n_cols;
@@ -91,18 +96,16 @@ void MeanPooling<InputDataType, OutputDataType>::Backward(
   arma::Mat<eT>&& gy,
   arma::Mat<eT>&& g)
 {
-  arma::cube mappedError = arma::cube(gy.memptr(), outputWidth,
-      outputHeight, outSize);
+  const arma::cube mappedError(gy.memptr(), outputWidth, outputHeight,
+      outSize, false, true);
 
-  gTemp = arma::zeros<arma::cube>(inputTemp.n_rows,
-      inputTemp.n_cols, inputTemp.n_slices);
+  gTemp.zeros(inputTemp.n_rows, inputTemp.n_cols, inputTemp.n_slices);
 
-  for (size_t s = 0; s < mappedError.n_slices; s++)
-  {
-    Unpooling(inputTemp.slice(s), mappedError.slice(s), gTemp.slice(s));
-  }
+  #pragma omp parallel for
+  for (omp_size_t s = 0; s < (omp_size_t) mappedError.n_slices; ++s)
+    Unpooling(mappedError.slice_memptr(s), gTemp.slice_memptr(s));
 
-  g = arma::mat(gTemp.memptr(), gTemp.n_elem, 1);
+  g = arma::mat(gTemp.memptr(), gTemp.n_elem, 1, false, true);
 }
 
 template<typename InputDataType, typename OutputDataType>
@@ -0,0 +1,173 @@
+/**
+ * @file quantized_linear.hpp
+ *
+ * Definition of the QuantizedLinear layer class, an inference-only version of
+ * the Linear layer that holds its weights as 8-bit integers.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_LAYER_QUANTIZED_LINEAR_HPP
+#define MLPACK_METHODS_ANN_LAYER_QUANTIZED_LINEAR_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include "layer_types.hpp"
+#include "linear.hpp"
+#include "linear_no_bias.hpp"
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+/**
+ * Implementation of the QuantizedLinear layer class.  The layer computes the
+ * same affine transformation as a trained Linear (or LinearNoBias) layer, but
+ * the weights are stored as 8-bit integers, with one scale for each output
+ * unit, which takes a quarter of the memory of the original weights.
+ *
+ * In the forward pass, each input point is quantized to 8-bit integers with a
+ * scale of its own (so no calibration data is needed), the products are
+ * accumulated in 32-bit integers, and the result is scaled back and the bias is
+ * added.  The error of the results is usually about 1% of their magnitude.
+ *
+ * The layer has no trainable parameters; it is meant to speed up the
+ * prediction of a trained network, and it is usually created with
+ * FFN::Quantize().
+ *
+ * @tparam InputDataType Type of the input data (arma::colvec, arma::mat,
+ *         arma::sp_mat or arma::cube).
+ * @tparam OutputDataType Type of the output data (arma::colvec, arma::mat,
+ *         arma::sp_mat or arma::cube).
+ */
+template <
+    typename InputDataType = arma::mat,
+    typename OutputDataType = arma::mat
+>
+class QuantizedLinear
+{
+ public:
+  //! Create the QuantizedLinear object.
+  QuantizedLinear();
+
+  /**
+   * Create the QuantizedLinear layer object from the weights of the given
+   * Linear layer.
+   *
+   * @param layer The trained Linear layer.
+   */
+  QuantizedLinear(const Linear<InputDataType, OutputDataType>& layer);
+
+  /**
+   * Create the QuantizedLinear layer object from the weights of the given
+   * LinearNoBias layer.
+   *
+   * @param layer The trained LinearNoBias layer.
+   */
+  QuantizedLinear(const LinearNoBias<InputDataType, OutputDataType>& layer);
+
+  /**
+   * Ordinary feed forward pass of a neural network, evaluating the function
+   * f(x) by propagating the activity forward through f.
+   *
+   * @param input Input data used for evaluating the specified function.
+   * @param output Resulting output activation.
+   */
+  template<typename eT>
+  void Forward(const arma::Mat<eT>&& input, arma::Mat<eT>&& output);
+
+  /**
+   * Ordinary feed backward pass of a neural network, calculating the function
+   * f(x) by propagating x backwards trough f, with the dequantized weights.
+   *
+   * @param input The propagated input activation.
+   * @param gy The backpropagated error.
+   * @param g The calculated gradient.
+   */
+  template<typename eT>
+  void Backward(const arma::Mat<eT>&& /* input */,
+                arma::Mat<eT>&& gy,
+                arma::Mat<eT>&& g);
+
+  //! Get the number of input units.
+  size_t InputSize() const { return inSize; }
+  //! Get the number of output units.
+  size_t OutputSize() const { return outSize; }
+
+  //! Get the quantized weights (row i * InputSize() + j holds the weight of
+  //! input unit j for output unit i).
+  const std::vector<int8_t>& Weights() const { return weights; }
+  //! Get the scale of the weights of each output unit.
+  OutputDataType const& WeightScales() const { return weightScales; }
+  //! Get the bias.
+  OutputDataType const& Bias() const { return bias; }
+
+  //! Get the input parameter.
+  InputDataType const& InputParameter() const { return inputParameter; }
+  //! Modify the input parameter.
+  InputDataType& InputParameter() { return inputParameter; }
+
+  //! Get the output parameter.
+  OutputDataType const& OutputParameter() const { return outputParameter; }
+  //! Modify the output parameter.
+  OutputDataType& OutputParameter() { return outputParameter; }
+
+  //! Get the delta.
+  OutputDataType const& Delta() const { return delta; }
+  //! Modify the delta.
+  OutputDataType& Delta() { return delta; }
+
+  /**
+   * Serialize the layer.  Unlike Linear, the layer holds its own (quantized)
+   * weights, so they are saved with it.
+   */
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */);
+
+ private:
+  /**
+   * Quantize the given weights, one output unit (row) at a time.
+   *
+   * @param weight Weights of the layer (outSize x inSize).
+   */
+  void QuantizeWeights(const OutputDataType& weight);
+
+  //! Locally-stored number of input units.
+  size_t inSize;
+
+  //! Locally-stored number of output units.
+  size_t outSize;
+
+  //! Locally-stored quantized weights, one output unit after the other.
+  std::vector<int8_t> weights;
+
+  //! Locally-stored scale of the weights of each output unit.
+  OutputDataType weightScales;
+
+  //! Locally-stored bias term parameters.
+  OutputDataType bias;
+
+  //! Locally-stored quantized input of the forward pass.
+  std::vector<int8_t> quantizedInput;
+
+  //! Locally-stored scale of each quantized input point.
+  OutputDataType inputScales;
+
+  //! Locally-stored delta object.
+  OutputDataType delta;
+
+  //! Locally-stored input parameter object.
+  InputDataType inputParameter;
+
+  //! Locally-stored output parameter object.
+  OutputDataType outputParameter;
+}; // class QuantizedLinear
+
+} // namespace ann
+} // namespace mlpack
+
+// Include implementation.
+#include "quantized_linear_impl.hpp"
+
+#endif
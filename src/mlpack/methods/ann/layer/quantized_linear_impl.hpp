@@ -0,0 +1,144 @@
+/**
+ * @file quantized_linear_impl.hpp
+ *
+ * Implementation of the QuantizedLinear layer class, an inference-only version
+ * of the Linear layer that holds its weights as 8-bit integers.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_LAYER_QUANTIZED_LINEAR_IMPL_HPP
+#define MLPACK_METHODS_ANN_LAYER_QUANTIZED_LINEAR_IMPL_HPP
+
+// In case it hasn't yet been included.
+#include "quantized_linear.hpp"
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+template<typename InputDataType, typename OutputDataType>
+QuantizedLinear<InputDataType, OutputDataType>::QuantizedLinear() :
+    inSize(0),
+    outSize(0)
+{
+  // Nothing to do here.
+}
+
+template<typename InputDataType, typename OutputDataType>
+QuantizedLinear<InputDataType, OutputDataType>::QuantizedLinear(
+    const Linear<InputDataType, OutputDataType>& layer) :
+    inSize(layer.InputSize()),
+    outSize(layer.OutputSize())
+{
+  const OutputDataType& parameters = layer.Parameters();
+  QuantizeWeights(OutputDataType(parameters.memptr(), outSize, inSize));
+  bias = parameters.rows(outSize * inSize, parameters.n_elem - 1);
+}
+
+template<typename InputDataType, typename OutputDataType>
+QuantizedLinear<InputDataType, OutputDataType>::QuantizedLinear(
+    const LinearNoBias<InputDataType, OutputDataType>& layer) :
+    inSize(layer.InputSize()),
+    outSize(layer.OutputSize())
+{
+  QuantizeWeights(OutputDataType(layer.Parameters().memptr(), outSize,
+      inSize));
+  bias.zeros(outSize, 1);
+}
+
+template<typename InputDataType, typename OutputDataType>
+void QuantizedLinear<InputDataType, OutputDataType>::QuantizeWeights(
+    const OutputDataType& weight)
+{
+  // Each output unit gets a symmetric scale, so that its largest weight is
+  // mapped to 127.
+  weights.resize(outSize * inSize);
+  weightScales = arma::max(arma::abs(weight), 1) / 127.0;
+  for (size_t i = 0; i < outSize; ++i)
+  {
+    if (weightScales(i) == 0)
+      weightScales(i) = 1;
+
+    int8_t* row = weights.data() + i * inSize;
+    for (size_t j = 0; j < inSize; ++j)
+      row[j] = (int8_t) std::round(weight(i, j) / weightScales(i));
+  }
+}
+
+template<typename InputDataType, typename OutputDataType>
+template<typename eT>
+void QuantizedLinear<InputDataType, OutputDataType>::Forward(
+    const arma::Mat<eT>&& input, arma::Mat<eT>&& output)
+{
+  // Quantize all the points first, so that each row of the weights is then
+  // used for the whole batch while it is in the cache.
+  quantizedInput.resize(input.n_elem);
+  inputScales.set_size(input.n_cols, 1);
+  for (size_t j = 0; j < input.n_cols; ++j)
+  {
+    const eT* point = input.colptr(j);
+    eT maxInput = 0;
+    for (size_t k = 0; k < inSize; ++k)
+      maxInput = std::max(maxInput, (eT) std::abs(point[k]));
+
+    inputScales(j) = (maxInput == 0) ? 1 : maxInput / 127.0;
+
+    int8_t* quantizedPoint = quantizedInput.data() + j * inSize;
+    for (size_t k = 0; k < inSize; ++k)
+      quantizedPoint[k] = (int8_t) std::round(point[k] / inputScales(j));
+  }
+
+  output.set_size(outSize, input.n_cols);
+  for (size_t i = 0; i < outSize; ++i)
+  {
+    const int8_t* row = weights.data() + i * inSize;
+    for (size_t j = 0; j < input.n_cols; ++j)
+    {
+      const int8_t* quantizedPoint = quantizedInput.data() + j * inSize;
+
+      // The products of two 8-bit integers fit in 16 bits, so the compiler can
+      // vectorize this loop with integer multiply-add instructions.  The sum
+      // can't overflow for fewer than 2^31 / 127^2 (about 133000) inputs.
+      int32_t sum = 0;
+      for (size_t k = 0; k < inSize; ++k)
+        sum += int32_t(row[k]) * int32_t(quantizedPoint[k]);
+
+      output(i, j) = sum * weightScales(i) * inputScales(j) + bias(i);
+    }
+  }
+}
+
+template<typename InputDataType, typename OutputDataType>
+template<typename eT>
+void QuantizedLinear<InputDataType, OutputDataType>::Backward(
+    const arma::Mat<eT>&& /* input */, arma::Mat<eT>&& gy, arma::Mat<eT>&& g)
+{
+  arma::Mat<eT> weight(outSize, inSize);
+  for (size_t i = 0; i < outSize; ++i)
+  {
+    const int8_t* row = weights.data() + i * inSize;
+    for (size_t j = 0; j < inSize; ++j)
+      weight(i, j) = row[j] * weightScales(i);
+  }
+
+  g = weight.t() * gy;
+}
+
+template<typename InputDataType, typename OutputDataType>
+template<typename Archive>
+void QuantizedLinear<InputDataType, OutputDataType>::serialize(
+    Archive& ar, const unsigned int /* version */)
+{
+  ar & BOOST_SERIALIZATION_NVP(inSize);
+  ar & BOOST_SERIALIZATION_NVP(outSize);
+  ar & BOOST_SERIALIZATION_NVP(weights);
+  ar & BOOST_SERIALIZATION_NVP(weightScales);
+  ar & BOOST_SERIALIZATION_NVP(bias);
+}
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
@@ -135,8 +135,17 @@ void Sequential<InputDataType, OutputDataType>::Gradient(
     arma::Mat<eT>&& error,
     arma::Mat<eT>&& /* gradient */)
 {
-  boost::apply_visitor(GradientVisitor(std::move(input), std::move(error)),
-      network.front());
+  if (network.size() == 1)
+  {
+    boost::apply_visitor(GradientVisitor(std::move(input), std::move(error)),
+        network.front());
+    return;
+  }
+
+  // Each module gets the error of the module after it, and the last module
+  // gets the error of the whole block.
+  boost::apply_visitor(GradientVisitor(std::move(input), std::move(
+      boost::apply_visitor(deltaVisitor, network[1]))), network.front());
 
   for (size_t i = 1; i < network.size() - 1; ++i)
   {
@@ -144,6 +153,10 @@ void Sequential<InputDataType, OutputDataType>::Gradient(
         outputParameterVisitor, network[i - 1])), std::move(
         boost::apply_visitor(deltaVisitor, network[i + 1]))), network[i]);
   }
+
+  boost::apply_visitor(GradientVisitor(std::move(boost::apply_visitor(
+      outputParameterVisitor, network[network.size() - 2])), std::move(error)),
+      network.back());
 }
 
 template<typename InputDataType, typename OutputDataType>
@@ -31,6 +31,16 @@ namespace ann /** Artificial Neural Network. */ {
 /**
  * Implementation of a standard recurrent neural network container.
  *
+ * Each column of the predictors holds one sequence, with the time steps one
+ * after the other.  By default the sequences have rho steps, and the error is
+ * backpropagated through all of them.  Longer sequences can be given by
+ * setting SequenceLength() to a multiple of rho; the network is then trained
+ * with truncated BPTT: the forward and the backward pass are run on one
+ * window of rho steps at a time, and the LSTM and FastLSTM layers carry their
+ * state from one window to the next (the other recurrent layers start each
+ * window from a zero state).  Only the activations of one window are stored,
+ * so the memory does not grow with the length of the sequences.
+ *
  * @tparam OutputLayerType The output layer type used to evaluate the network.
  * @tparam InitializationRuleType Rule used to initialize the weight matrix.
  */
@@ -144,6 +154,47 @@ class RNN
    */
   void Predict(arma::mat predictors, arma::mat& results);
 
+  /**
+   * Start new sequences for Step(): the state of the recurrent layers is set to
+   * zero.
+   */
+  void ResetState();
+
+  /**
+   * Advance the network by a single time step, for online prediction: the
+   * recurrent layers (like LSTM, FastLSTM and GRU) continue from their state
+   * after the last call, so each call only costs one time step, instead of
+   * running the whole sequence again.  Each column is a separate sequence (for
+   * instance, one session), so several sequences can be advanced at once; the
+   * number of columns must be the same for all the calls after ResetState() or
+   * SetState().  The layers work in deterministic (testing) mode.
+   *
+   * @param input Input of the time step, one column for each sequence.
+   * @param output Matrix to store the output of the time step in.
+   */
+  void Step(const arma::mat& input, arma::mat& output);
+
+  /**
+   * Get the state of the recurrent layers of the network, to continue the
+   * sequences later with SetState(), possibly in another network with the same
+   * layers.  The state of each recurrent layer takes a block of rows, in the
+   * order of the layers, and each column is the state of one sequence, so the
+   * states of single sequences can be taken from it.  Recurrent layers inside
+   * other layers are not included.
+   *
+   * @param state Matrix to store the state in.
+   */
+  void State(arma::mat& state) const;
+
+  /**
+   * Set the state of the recurrent layers of the network (in the layout of
+   * State()), so that the next call to Step() continues from it.  The number of
+   * columns is the number of sequences of the next calls to Step().
+   *
+   * @param state The state to continue from.
+   */
+  void SetState(const arma::mat& state);
+
   /**
    * Evaluate the recurrent neural network with the given parameters. This
    * function is usually called by the optimizer to train the model.
@@ -221,6 +272,12 @@ class RNN
   //! Modify the maximum length of backpropagation through time.
   size_t& Rho() { return rho; }
 
+  //! Return the number of time steps of each sequence (0 means rho steps).
+  const size_t& SequenceLength() const { return sequenceLength; }
+  //! Modify the number of time steps of each sequence; this must be a multiple
+  //! of rho, and 0 means rho steps.
+  size_t& SequenceLength() { return sequenceLength; }
+
   /**
    * Reset the module infomration (weights/parameters).
    */
@@ -244,6 +301,49 @@ class RNN
    */
   void ResetCells();
 
+  //! The number of time steps of each sequence.
+  size_t Steps() const { return (sequenceLength == 0) ? rho : sequenceLength; }
+
+  /**
+   * Set the size of the input and of the target of each time step from the
+   * data, if that hasn't been done yet.
+   */
+  void ResetDataSizes();
+
+  /**
+   * Run the forward pass over some consecutive time steps of the given
+   * sequences, and return the error of the output layer over these steps.
+   *
+   * @param begin Index of the first sequence.
+   * @param batchSize Number of sequences.
+   * @param firstStep Index of the first time step.
+   * @param steps Number of time steps.
+   * @param save Whether to save the output parameters of each step for the
+   *        backward pass.
+   */
+  double ForwardSteps(const size_t begin,
+                      const size_t batchSize,
+                      const size_t firstStep,
+                      const size_t steps,
+                      const bool save);
+
+  /**
+   * Run the backward pass over the time steps of the last call to
+   * ForwardSteps() (with save = true), from the last step to the first, and
+   * add the gradient to the given gradient.
+   *
+   * @param begin Index of the first sequence.
+   * @param batchSize Number of sequences.
+   * @param firstStep Index of the first time step.
+   * @param steps Number of time steps.
+   * @param gradient Gradient to add the gradient of these steps to.
+   */
+  void BackwardSteps(const size_t begin,
+                     const size_t batchSize,
+                     const size_t firstStep,
+                     const size_t steps,
+                     arma::mat& gradient);
+
   /**
    * The Backward algorithm (part of the Forward-Backward algorithm). Computes
    * backward pass for module.
@@ -279,6 +379,9 @@ class RNN
   //! Number of steps to backpropagate through time (BPTT).
   size_t rho;
 
+  //! Number of time steps of each sequence (0 means rho).
+  size_t sequenceLength;
+
   //! Instantiated outputlayer used to evaluate the network.
   OutputLayerType outputLayer;
 
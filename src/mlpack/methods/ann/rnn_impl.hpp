@@ -20,6 +20,8 @@
 #include "visitor/forward_visitor.hpp"
 #include "visitor/backward_visitor.hpp"
 #include "visitor/reset_cell_visitor.hpp"
+#include "visitor/set_state_visitor.hpp"
+#include "visitor/state_visitor.hpp"
 #include "visitor/deterministic_set_visitor.hpp"
 #include "visitor/gradient_set_visitor.hpp"
 #include "visitor/gradient_visitor.hpp"
@@ -37,6 +39,7 @@ RNN<OutputLayerType, InitializationRuleType>::RNN(
     OutputLayerType outputLayer,
     InitializationRuleType initializeRule) :
     rho(rho),
+    sequenceLength(0),
     outputLayer(std::move(outputLayer)),
     initializeRule(std::move(initializeRule)),
     inputSize(0),
@@ -59,6 +62,7 @@ RNN<OutputLayerType, InitializationRuleType>::RNN(
     OutputLayerType outputLayer,
     InitializationRuleType initializeRule) :
     rho(rho),
+    sequenceLength(0),
     outputLayer(std::move(outputLayer)),
     initializeRule(std::move(initializeRule)),
     inputSize(0),
@@ -170,11 +174,15 @@ void RNN<OutputLayerType, InitializationRuleType>::Predict(
     ResetDeterministic();
   }
 
-  results = arma::zeros<arma::mat>(outputSize * rho, predictors.n_cols);
+  results = arma::zeros<arma::mat>(outputSize * Steps(), predictors.n_cols);
   arma::mat resultsTemp = results.col(0);
 
   for (size_t i = 0; i < predictors.n_cols; i++)
   {
+    // Each sequence starts from a zero state.
+    if (i > 0)
+      ResetCells();
+
     SinglePredict(
         arma::mat(predictors.colptr(i), predictors.n_rows, 1, false, true),
         resultsTemp);
@@ -183,11 +191,68 @@ void RNN<OutputLayerType, InitializationRuleType>::Predict(
   }
 }
 
+template<typename OutputLayerType, typename InitializationRuleType>
+void RNN<OutputLayerType, InitializationRuleType>::ResetState()
+{
+  if (parameter.is_empty())
+    ResetParameters();
+
+  ResetCells();
+}
+
+template<typename OutputLayerType, typename InitializationRuleType>
+void RNN<OutputLayerType, InitializationRuleType>::Step(
+    const arma::mat& input, arma::mat& output)
+{
+  if (parameter.is_empty())
+  {
+    ResetParameters();
+    ResetCells();
+  }
+
+  if (!deterministic)
+  {
+    deterministic = true;
+    ResetDeterministic();
+  }
+
+  Forward(arma::mat(input));
+  output = boost::apply_visitor(outputParameterVisitor, network.back());
+}
+
+template<typename OutputLayerType, typename InitializationRuleType>
+void RNN<OutputLayerType, InitializationRuleType>::State(
+    arma::mat& state) const
+{
+  state.reset();
+  for (size_t i = 0; i < network.size(); ++i)
+    boost::apply_visitor(StateVisitor(std::move(state)), network[i]);
+}
+
+template<typename OutputLayerType, typename InitializationRuleType>
+void RNN<OutputLayerType, InitializationRuleType>::SetState(
+    const arma::mat& state)
+{
+  ResetState();
+
+  size_t offset = 0;
+  for (size_t i = 0; i < network.size(); ++i)
+    offset += boost::apply_visitor(SetStateVisitor(state, offset), network[i]);
+
+  if (offset != state.n_rows)
+  {
+    std::ostringstream oss;
+    oss << "RNN::SetState(): the state has " << state.n_rows << " rows, but "
+        << "the recurrent layers of the network have " << offset << "!";
+    throw std::invalid_argument(oss.str());
+  }
+}
+
 template<typename OutputLayerType, typename InitializationRuleType>
 void RNN<OutputLayerType, InitializationRuleType>::SinglePredict(
     const arma::mat& predictors, arma::mat& results)
 {
-  for (size_t seqNum = 0; seqNum < rho; ++seqNum)
+  for (size_t seqNum = 0; seqNum < Steps(); ++seqNum)
   {
     Forward(std::move(predictors.rows(seqNum * inputSize,
         (seqNum + 1) * inputSize - 1)));
@@ -216,26 +281,97 @@ double RNN<OutputLayerType, InitializationRuleType>::Evaluate(
     ResetDeterministic();
   }
 
-  if (!inputSize)
+  ResetDataSizes();
+  ResetCells();
+
+  return ForwardSteps(begin, batchSize, 0, Steps(), false);
+}
+
+template<typename OutputLayerType, typename InitializationRuleType>
+void RNN<OutputLayerType, InitializationRuleType>::Gradient(
+    const arma::mat& /* parameters */,
+    const size_t begin,
+    arma::mat& gradient,
+    const size_t batchSize)
+{
+  if (parameter.is_empty())
   {
-    inputSize = predictors.n_rows / rho;
-    targetSize = responses.n_rows / rho;
+    ResetParameters();
+    reset = true;
   }
-  else if (targetSize == 0)
+
+  // Initialize passed gradient.
+  if (gradient.is_empty())
+    gradient = arma::zeros<arma::mat>(parameter.n_rows, parameter.n_cols);
+  else
+    gradient.zeros();
+
+  if (deterministic)
   {
-    targetSize = responses.n_rows / rho;
+    deterministic = false;
+    ResetDeterministic();
   }
 
+  ResetDataSizes();
+
+  // Initialize current/working gradient.
+  if (currentGradient.is_empty())
+  {
+    currentGradient = arma::zeros<arma::mat>(parameter.n_rows,
+        parameter.n_cols);
+  }
+
+  ResetGradients(currentGradient);
   ResetCells();
 
+  // Run each window of rho steps forward and then backward, so that only the
+  // output parameters of one window are stored.  The recurrent layers carry
+  // their state from one window to the next.
+  for (size_t firstStep = 0; firstStep < Steps(); firstStep += rho)
+  {
+    ForwardSteps(begin, batchSize, firstStep, rho, true);
+    BackwardSteps(begin, batchSize, firstStep, rho, gradient);
+  }
+}
+
+template<typename OutputLayerType, typename InitializationRuleType>
+void RNN<OutputLayerType, InitializationRuleType>::ResetDataSizes()
+{
+  if (Steps() % rho != 0)
+  {
+    std::ostringstream oss;
+    oss << "RNN::ResetDataSizes(): the sequence length (" << Steps()
+        << ") must be a multiple of rho (" << rho << ")";
+    throw std::invalid_argument(oss.str());
+  }
+
+  if (!inputSize)
+  {
+    inputSize = predictors.n_rows / Steps();
+    targetSize = responses.n_rows / Steps();
+  }
+  else if (targetSize == 0)
+  {
+    targetSize = responses.n_rows / Steps();
+  }
+}
+
+template<typename OutputLayerType, typename InitializationRuleType>
+double RNN<OutputLayerType, InitializationRuleType>::ForwardSteps(
+    const size_t begin,
+    const size_t batchSize,
+    const size_t firstStep,
+    const size_t steps,
+    const bool save)
+{
   double performance = 0;
 
-  for (size_t seqNum = 0; seqNum < rho; ++seqNum)
+  for (size_t seqNum = firstStep; seqNum < firstStep + steps; ++seqNum)
   {
     Forward(std::move(predictors.submat(seqNum * inputSize, begin,
         (seqNum + 1) * inputSize - 1, begin + batchSize - 1)));
 
-    if (!deterministic)
+    if (save)
     {
       for (size_t l = 0; l < network.size(); ++l)
       {
@@ -260,41 +396,16 @@ double RNN<OutputLayerType, InitializationRuleType>::Evaluate(
 }
 
 template<typename OutputLayerType, typename InitializationRuleType>
-void RNN<OutputLayerType, InitializationRuleType>::Gradient(
-    const arma::mat& parameters,
+void RNN<OutputLayerType, InitializationRuleType>::BackwardSteps(
     const size_t begin,
-    arma::mat& gradient,
-    const size_t batchSize)
+    const size_t batchSize,
+    const size_t firstStep,
+    const size_t steps,
+    arma::mat& gradient)
 {
-  // Initialize passed gradient.
-  if (gradient.is_empty())
-  {
-    if (parameter.is_empty())
-    {
-      ResetParameters();
-      reset = true;
-    }
-
-    gradient = arma::zeros<arma::mat>(parameter.n_rows, parameter.n_cols);
-  }
-  else
-  {
-    gradient.zeros();
-  }
-
-  Evaluate(parameters, begin, batchSize, false);
-
-  // Initialize current/working gradient.
-  if (currentGradient.is_empty())
-  {
-    currentGradient = arma::zeros<arma::mat>(parameter.n_rows,
-        parameter.n_cols);
-  }
-
-  ResetGradients(currentGradient);
-
-  for (size_t seqNum = 0; seqNum < rho; ++seqNum)
+  for (size_t i = 0; i < steps; ++i)
   {
+    const size_t seqNum = firstStep + steps - 1 - i;
     currentGradient.zeros();
 
     for (size_t l = 0; l < network.size(); ++l)
@@ -303,7 +414,7 @@ void RNN<OutputLayerType, InitializationRuleType>::Gradient(
           std::move(moduleOutputParameter)), network[network.size() - 1 - l]);
     }
 
-    if (single && seqNum > 0)
+    if (single && seqNum != Steps() - 1)
     {
       error.zeros();
     }
@@ -311,14 +422,14 @@ void RNN<OutputLayerType, InitializationRuleType>::Gradient(
     {
       outputLayer.Backward(std::move(boost::apply_visitor(
           outputParameterVisitor, network.back())),
-          std::move(responses.submat((rho - seqNum - 1) * targetSize, begin,
-          (rho - seqNum) * targetSize - 1, begin + batchSize - 1)),
+          std::move(responses.submat(seqNum * targetSize, begin,
+          (seqNum + 1) * targetSize - 1, begin + batchSize - 1)),
           std::move(error));
     }
 
     Backward();
-    Gradient(std::move(predictors.submat((rho - seqNum - 1) * inputSize, begin,
-        (rho - seqNum) * inputSize - 1, begin + batchSize - 1)));
+    Gradient(std::move(predictors.submat(seqNum * inputSize, begin,
+        (seqNum + 1) * inputSize - 1, begin + batchSize - 1)));
     gradient += currentGradient;
   }
 }
@@ -417,6 +528,7 @@ void RNN<OutputLayerType, InitializationRuleType>::serialize(
 {
   ar & BOOST_SERIALIZATION_NVP(parameter);
   ar & BOOST_SERIALIZATION_NVP(rho);
+  ar & BOOST_SERIALIZATION_NVP(sequenceLength);
   ar & BOOST_SERIALIZATION_NVP(single);
   ar & BOOST_SERIALIZATION_NVP(inputSize);
   ar & BOOST_SERIALIZATION_NVP(outputSize);
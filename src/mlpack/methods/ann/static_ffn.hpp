@@ -0,0 +1,594 @@
+/**
+ * @file static_ffn.hpp
+ *
+ * Definition of the StaticFFN class, which implements feed forward neural
+ * networks whose layers are known at compile time.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_STATIC_FFN_HPP
+#define MLPACK_METHODS_ANN_STATIC_FFN_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include "visitor/gradient_set_visitor.hpp"
+#include "visitor/output_height_visitor.hpp"
+#include "visitor/output_width_visitor.hpp"
+#include "visitor/reset_visitor.hpp"
+#include "visitor/weight_size_visitor.hpp"
+#include "visitor/weight_set_visitor.hpp"
+
+#include "init_rules/init_rules_traits.hpp"
+
+#include <mlpack/methods/ann/layer/layer_types.hpp>
+#include <mlpack/methods/ann/init_rules/random_init.hpp>
+#include <mlpack/core/optimizers/rmsprop/rmsprop.hpp>
+
+#include <tuple>
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+/**
+ * The list of the layer types of a StaticFFN, in the order the input goes
+ * through them.
+ */
+template<typename... Layers>
+struct LayerSequence { };
+
+template<
+  typename LayerSequenceType,
+  typename OutputLayerType = NegativeLogLikelihood<>,
+  typename InitializationRuleType = RandomInitialization,
+  typename MatType = arma::mat
+>
+class StaticFFN;
+
+/**
+ * Implementation of a feed forward network whose layers are given at compile
+ * time, for instance
+ *
+ * @code
+ * StaticFFN<LayerSequence<Linear<>, SigmoidLayer<>, Linear<>, LogSoftMax<> > >
+ *     model(Linear<>(10, 20), SigmoidLayer<>(), Linear<>(20, 2),
+ *     LogSoftMax<>());
+ * @endcode
+ *
+ * The layers are held by value, and each pass calls the layers directly
+ * instead of going through the LayerTypes variant, so the calls can be inlined.
+ * This lowers the overhead of each pass, which matters for small networks.
+ * Use FFN when the layers are only known at run time; other than Add(), the
+ * two classes have the same interface.
+ *
+ * The layers can also work in single precision, which halves the memory of
+ * the data and of the activations, and speeds up the matrix products:
+ *
+ * @code
+ * StaticFFN<LayerSequence<Linear<arma::fmat, arma::fmat>,
+ *     SigmoidLayer<arma::fmat, arma::fmat>, Linear<arma::fmat, arma::fmat>,
+ *     LogSoftMax<arma::fmat, arma::fmat> >,
+ *     NegativeLogLikelihood<arma::fmat, arma::fmat>, RandomInitialization,
+ *     arma::fmat> model(Linear<arma::fmat, arma::fmat>(10, 20), ...);
+ * @endcode
+ *
+ * In that case, the parameters seen by the optimizer (Parameters()) stay in
+ * double precision, so that small updates are not lost; the layers use a
+ * single-precision copy of them, which is refreshed before each pass, and the
+ * gradient computed by the layers is converted back for the optimizer.  Layers
+ * that hold other layers (like Sequential) only work in double precision.
+ *
+ * @tparam Layers The layer types of the network.
+ * @tparam OutputLayerType The output layer type used to evaluate the network.
+ * @tparam InitializationRuleType Rule used to initialize the weight matrix.
+ * @tparam MatType The matrix type of the data and of the layers (arma::mat or
+ *     arma::fmat).
+ */
+template<
+  typename... Layers,
+  typename OutputLayerType,
+  typename InitializationRuleType,
+  typename MatType
+>
+class StaticFFN<LayerSequence<Layers...>, OutputLayerType,
+    InitializationRuleType, MatType>
+{
+  static_assert(sizeof...(Layers) >= 2,
+      "a StaticFFN must have at least two layers");
+
+ public:
+  //! The type of the tuple that holds the layers.
+  typedef std::tuple<Layers...> NetworkType;
+
+  /**
+   * Create the StaticFFN object with the given layers.
+   *
+   * @param layers The layers of the network.
+   */
+  explicit StaticFFN(Layers... layers);
+
+  /**
+   * Create the StaticFFN object with the given layers, output layer and
+   * initialization rule.
+   *
+   * @param network The layers of the network.
+   * @param outputLayer Output layer used to evaluate the network.
+   * @param initializeRule Optional instantiated InitializationRule object
+   *        for initializing the network parameter.
+   */
+  StaticFFN(NetworkType network,
+            OutputLayerType outputLayer,
+            InitializationRuleType initializeRule = InitializationRuleType());
+
+  //! Copy constructor.
+  StaticFFN(const StaticFFN&);
+
+  //! Move constructor.
+  StaticFFN(StaticFFN&&);
+
+  //! Copy/move assignment operator.
+  StaticFFN& operator = (StaticFFN);
+
+  /**
+   * Train the feedforward network on the given input data using the given
+   * optimizer.
+   *
+   * This will use the existing model parameters as a starting point for the
+   * optimization. If this is not what you want, then you should access the
+   * parameters vector directly with Parameters() and modify it as desired.
+   *
+   * @tparam OptimizerType Type of optimizer to use to train the model.
+   * @param predictors Input training variables.
+   * @param responses Outputs results from input training variables.
+   * @param optimizer Instantiated optimizer used to train the model.
+   */
+  template<typename OptimizerType>
+  void Train(MatType predictors,
+             MatType responses,
+             OptimizerType& optimizer);
+
+  /**
+   * Train the feedforward network on the given input data. By default, the
+   * RMSProp optimization algorithm is used, but others can be specified
+   * (such as mlpack::optimization::SGD).
+   *
+   * @tparam OptimizerType Type of optimizer to use to train the model.
+   * @param predictors Input training variables.
+   * @param responses Outputs results from input training variables.
+   */
+  template<typename OptimizerType = mlpack::optimization::RMSProp>
+  void Train(MatType predictors, MatType responses);
+
+  /**
+   * Predict the responses to a given set of predictors, passing them through
+   * the network in batches of batchSize points.
+   *
+   * @param predictors Input predictors.
+   * @param results Matrix to put output predictions of responses into.
+   * @param batchSize Number of points to pass through the network at a time.
+   */
+  void Predict(MatType predictors,
+               MatType& results,
+               const size_t batchSize = 256);
+
+  /**
+   * Evaluate the feedforward network with the given parameters, on the whole
+   * dataset.
+   *
+   * @param parameters Matrix model parameters.
+   */
+  double Evaluate(const arma::mat& parameters);
+
+  /**
+   * Evaluate the feedforward network with the given parameters, but using only
+   * a batch of the data points. This is useful for optimizers such as SGD,
+   * which require a separable objective function.
+   *
+   * @param parameters Matrix model parameters.
+   * @param begin Index of the starting point to use for objective function
+   *        evaluation.
+   * @param batchSize Number of points to be passed at a time to use for
+   *        objective function evaluation.
+   * @param deterministic Whether or not to train or test the model. Note some
+   *        layer act differently in training or testing mode.
+   */
+  double Evaluate(const arma::mat& parameters,
+                  const size_t begin,
+                  const size_t batchSize,
+                  const bool deterministic = true);
+
+  /**
+   * Evaluate the gradient of the feedforward network with the given
+   * parameters, and with respect to only a batch of the data points. This is
+   * useful for optimizers such as SGD, which require a separable objective
+   * function.
+   *
+   * @param parameters Matrix of the model parameters to be optimized.
+   * @param begin Index of the starting point to use for objective function
+   *        gradient evaluation.
+   * @param gradient Matrix to output gradient into.
+   * @param batchSize Number of points to be processed as a batch for objective
+   *        function gradient evaluation.
+   */
+  void Gradient(const arma::mat& parameters,
+                const size_t begin,
+                arma::mat& gradient,
+                const size_t batchSize);
+
+  /**
+   * Shuffle the order of function visitation. This may be called by the
+   * optimizer.
+   */
+  void Shuffle();
+
+  //! Get the layers of the network.
+  const NetworkType& Network() const { return network; }
+  //! Modify the layers of the network.  If the weight sizes change, call
+  //! ResetParameters() afterwards.
+  NetworkType& Network() { return network; }
+
+  //! Return the number of separable functions (the number of predictor points).
+  size_t NumFunctions() const { return numFunctions; }
+
+  //! Return the initial point for the optimization.
+  const arma::mat& Parameters() const { return parameter; }
+  //! Modify the initial point for the optimization.
+  arma::mat& Parameters() { return parameter; }
+
+  /**
+   * Reset the module infomration (weights/parameters).
+   */
+  void ResetParameters();
+
+  //! Serialize the model.
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */);
+
+  /**
+   * Perform the forward pass of the data in real batch mode.
+   *
+   * @param inputs The input data.
+   * @param results The predicted results.
+   */
+  void Forward(MatType inputs, MatType& results);
+
+  /**
+   * Perform the backward pass of the data in real batch mode; Forward() must
+   * be called first.
+   *
+   * @param targets The training target.
+   * @param gradients Computed gradients.
+   * @return Training error of the current pass.
+   */
+  double Backward(MatType targets, arma::mat& gradients);
+
+ private:
+  //! The index of a layer, used to go through the layers at compile time.
+  template<size_t I>
+  using LayerIndex = std::integral_constant<size_t, I>;
+
+  //! The number of layers.
+  static const size_t NumLayers = sizeof...(Layers);
+
+  //! Get the I'th layer.
+  template<size_t I>
+  typename std::tuple_element<I, NetworkType>::type& Layer()
+  {
+    return std::get<I>(network);
+  }
+
+  //! Apply the given visitor to each layer, starting at the I'th.
+  template<typename VisitorType, size_t I>
+  void Apply(VisitorType& visitor, LayerIndex<I>)
+  {
+    visitor(&Layer<I>());
+    Apply(visitor, LayerIndex<I + 1>());
+  }
+
+  //! There are no layers left to apply the visitor to.
+  template<typename VisitorType>
+  void Apply(VisitorType& /* visitor */, LayerIndex<NumLayers>) { }
+
+  //! Add up the number of weights of the layers.
+  struct WeightCounter
+  {
+    size_t weights;
+
+    template<typename LayerType>
+    void operator()(LayerType* layer)
+    {
+      weights += WeightSizeVisitor()(layer);
+    }
+  };
+
+  //! Initialize the weights of each layer in turn with the given rule.
+  struct LayerInitializer
+  {
+    InitializationRuleType& initializeRule;
+    arma::mat& parameter;
+    size_t offset;
+
+    template<typename LayerType>
+    void operator()(LayerType* layer)
+    {
+      const size_t weight = WeightSizeVisitor()(layer);
+      arma::mat tmp = arma::mat(parameter.memptr() + offset, weight, 1, false,
+          false);
+      initializeRule.Initialize(tmp, tmp.n_elem, 1);
+      offset += weight;
+    }
+  };
+
+  //! Make the weights of each layer point into the parameters.
+  struct WeightSetter
+  {
+    MatType& parameter;
+    size_t offset;
+
+    template<typename LayerType>
+    void operator()(LayerType* layer)
+    {
+      offset += SetWeights(*layer, parameter, offset);
+      ResetVisitor()(layer);
+    }
+  };
+
+  //! Make the gradient of each layer point into the given gradient.
+  struct GradientSetter
+  {
+    MatType& gradient;
+    size_t offset;
+
+    template<typename LayerType>
+    void operator()(LayerType* layer)
+    {
+      offset += SetGradient(*layer, gradient, offset);
+    }
+  };
+
+  //! Whether a layer holds other layers (which are held by the LayerTypes
+  //! variant, so the visitors have to be used for them).
+  template<typename LayerType>
+  using HasModel = HasModelCheck<LayerType,
+      std::vector<LayerTypes>&(LayerType::*)()>;
+
+  //! Make the weights of the given layer point into the parameters.
+  template<typename LayerType>
+  static typename std::enable_if<HasModel<LayerType>::value, size_t>::type
+  SetWeights(LayerType& layer, MatType& parameter, const size_t offset)
+  {
+    return WeightSetVisitor(std::move(parameter), offset)(&layer);
+  }
+
+  template<typename LayerType>
+  static typename std::enable_if<!HasModel<LayerType>::value &&
+      HasParametersCheck<LayerType, MatType&(LayerType::*)()>::value,
+      size_t>::type
+  SetWeights(LayerType& layer, MatType& parameter, const size_t offset)
+  {
+    layer.Parameters() = MatType(parameter.memptr() + offset,
+        layer.Parameters().n_rows, layer.Parameters().n_cols, false, false);
+    return layer.Parameters().n_elem;
+  }
+
+  template<typename LayerType>
+  static typename std::enable_if<!HasModel<LayerType>::value &&
+      !HasParametersCheck<LayerType, MatType&(LayerType::*)()>::value,
+      size_t>::type
+  SetWeights(LayerType& /* layer */, MatType& /* parameter */,
+             const size_t /* offset */)
+  {
+    return 0;
+  }
+
+  //! Make the gradient of the given layer point into the given gradient.
+  template<typename LayerType>
+  static typename std::enable_if<HasModel<LayerType>::value, size_t>::type
+  SetGradient(LayerType& layer, MatType& gradient, const size_t offset)
+  {
+    return GradientSetVisitor(std::move(gradient), offset)(&layer);
+  }
+
+  template<typename LayerType>
+  static typename std::enable_if<!HasModel<LayerType>::value &&
+      HasGradientCheck<LayerType, MatType&(LayerType::*)()>::value,
+      size_t>::type
+  SetGradient(LayerType& layer, MatType& gradient, const size_t offset)
+  {
+    layer.Gradient() = MatType(gradient.memptr() + offset,
+        layer.Parameters().n_rows, layer.Parameters().n_cols, false, false);
+    return layer.Parameters().n_elem;
+  }
+
+  template<typename LayerType>
+  static typename std::enable_if<!HasModel<LayerType>::value &&
+      !HasGradientCheck<LayerType, MatType&(LayerType::*)()>::value,
+      size_t>::type
+  SetGradient(LayerType& /* layer */, MatType& /* gradient */,
+              const size_t /* offset */)
+  {
+    return 0;
+  }
+
+  //! Compute the gradient of the given layer, if it has weights.
+  template<typename LayerType, typename InputType, typename ErrorType>
+  static typename std::enable_if<
+      HasGradientCheck<LayerType, MatType&(LayerType::*)()>::value>::type
+  LayerGradient(LayerType& layer, InputType&& input, ErrorType&& error)
+  {
+    layer.Gradient(std::move(input), std::move(error),
+        std::move(layer.Gradient()));
+  }
+
+  template<typename LayerType, typename InputType, typename ErrorType>
+  static typename std::enable_if<
+      !HasGradientCheck<LayerType, MatType&(LayerType::*)()>::value>::type
+  LayerGradient(LayerType& /* layer */, InputType&& /* input */,
+                ErrorType&& /* error */)
+  {
+    /* Nothing to do here. */
+  }
+
+  //! Whether the layers work in the precision of the parameters.
+  typedef typename std::is_same<MatType, arma::mat>::type SamePrecision;
+
+  //! The weights used by the layers.
+  MatType& LayerParameters() { return LayerParameters(SamePrecision()); }
+  arma::mat& LayerParameters(std::true_type) { return parameter; }
+  MatType& LayerParameters(std::false_type) { return layerParameter; }
+
+  //! Copy the parameters into the weights used by the layers, if they are in
+  //! another precision.
+  void CopyParameters() { CopyParameters(SamePrecision()); }
+  void CopyParameters(std::true_type) { }
+  void CopyParameters(std::false_type)
+  {
+    layerParameter.set_size(parameter.n_rows, parameter.n_cols);
+    std::copy(parameter.begin(), parameter.end(), layerParameter.begin());
+  }
+
+  //! The gradient the layers write into, for the given gradient.
+  MatType& LayerGradients(arma::mat& gradient)
+  {
+    return LayerGradients(gradient, SamePrecision());
+  }
+  arma::mat& LayerGradients(arma::mat& gradient, std::true_type)
+  {
+    return gradient;
+  }
+  MatType& LayerGradients(arma::mat& gradient, std::false_type)
+  {
+    layerGradient.zeros(gradient.n_rows, gradient.n_cols);
+    return layerGradient;
+  }
+
+  //! Copy the gradient computed by the layers into the given gradient, if
+  //! they are in another precision.
+  void CopyGradients(arma::mat& gradient)
+  {
+    CopyGradients(gradient, SamePrecision());
+  }
+  void CopyGradients(arma::mat& /* gradient */, std::true_type) { }
+  void CopyGradients(arma::mat& gradient, std::false_type)
+  {
+    std::copy(layerGradient.begin(), layerGradient.end(), gradient.begin());
+  }
+
+  //! The output of the last layer.
+  MatType& NetworkOutput()
+  {
+    return Layer<NumLayers - 1>().OutputParameter();
+  }
+
+  // Helper functions.
+  void Forward(MatType&& input);
+
+  //! Pass the output of the previous layer through the I'th layer and the
+  //! layers after it.
+  template<size_t I>
+  void Forward(LayerIndex<I>);
+
+  //! There are no layers left for the forward pass.
+  void Forward(LayerIndex<NumLayers>) { }
+
+  void ResetData(MatType predictors, MatType responses);
+
+  void Backward();
+
+  //! Propagate the delta of the next layer back through the I'th layer and
+  //! the layers before it (down to the second one).
+  template<size_t I>
+  void Backward(LayerIndex<I>);
+
+  //! The first layer doesn't have to propagate its delta.
+  void Backward(LayerIndex<0>) { }
+
+  void Gradient(MatType&& input);
+
+  //! Compute the gradient of the I'th layer and the layers after it (except
+  //! the last one).
+  template<size_t I>
+  void Gradient(LayerIndex<I>);
+
+  //! The gradient of the last layer is handled by Gradient(MatType&&).
+  void Gradient(LayerIndex<NumLayers - 1>) { }
+
+  void ResetDeterministic();
+
+  void ResetGradients(MatType& gradient);
+
+  //! Set the weights of each layer to point into the parameters.
+  void ResetWeights();
+
+  void Swap(StaticFFN& network);
+
+  //! Serialize the I'th layer and the layers after it.
+  template<typename Archive, size_t I>
+  void SerializeLayers(Archive& ar, LayerIndex<I>);
+
+  //! There are no layers left to serialize.
+  template<typename Archive>
+  void SerializeLayers(Archive& /* ar */, LayerIndex<NumLayers>) { }
+
+  //! Instantiated outputlayer used to evaluate the network.
+  OutputLayerType outputLayer;
+
+  //! Instantiated InitializationRule object for initializing the network
+  //! parameter.
+  InitializationRuleType initializeRule;
+
+  //! The input width.
+  size_t width;
+
+  //! The input height.
+  size_t height;
+
+  //! Indicator if we already trained the model.
+  bool reset;
+
+  //! Locally-stored model modules.
+  NetworkType network;
+
+  //! The matrix of data points (predictors).
+  MatType predictors;
+
+  //! The matrix of responses to the input data points.
+  MatType responses;
+
+  //! Matrix of (trained) parameters.
+  arma::mat parameter;
+
+  //! The parameters in the precision of the layers, if it is not double.
+  MatType layerParameter;
+
+  //! The gradient in the precision of the layers, if it is not double.
+  MatType layerGradient;
+
+  //! The number of separable functions (the number of predictor points).
+  size_t numFunctions;
+
+  //! The current error for the backward pass.
+  MatType error;
+
+  //! THe current input of the forward/backward pass.
+  MatType currentInput;
+
+  //! Locally-stored output width visitor.
+  OutputWidthVisitor outputWidthVisitor;
+
+  //! Locally-stored output height visitor.
+  OutputHeightVisitor outputHeightVisitor;
+
+  //! The current evaluation mode (training or testing).
+  bool deterministic;
+}; // class StaticFFN
+
+} // namespace ann
+} // namespace mlpack
+
+// Include implementation.
+#include "static_ffn_impl.hpp"
+
+#endif
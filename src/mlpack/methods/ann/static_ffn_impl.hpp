@@ -0,0 +1,797 @@
+/**
+ * @file static_ffn_impl.hpp
+ *
+ * Implementation of the StaticFFN class, which implements feed forward neural
+ * networks whose layers are known at compile time.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_STATIC_FFN_IMPL_HPP
+#define MLPACK_METHODS_ANN_STATIC_FFN_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "static_ffn.hpp"
+
+#include "visitor/deterministic_set_visitor.hpp"
+#include "visitor/set_input_height_visitor.hpp"
+#include "visitor/set_input_width_visitor.hpp"
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+template<
+  typename... Layers,
+  typename OutputLayerType,
+  typename InitializationRuleType,
+  typename MatType
+>
+StaticFFN<
+    LayerSequence<Layers...>,
+    OutputLayerType,
+    InitializationRuleType,
+    MatType
+>::StaticFFN(Layers... layers) :
+    width(0),
+    height(0),
+    reset(false),
+    network(std::move(layers)...),
+    numFunctions(0),
+    deterministic(true)
+{
+  /* Nothing to do here */
+}
+
+template<
+  typename... Layers,
+  typename OutputLayerType,
+  typename InitializationRuleType,
+  typename MatType
+>
+StaticFFN<
+    LayerSequence<Layers...>,
+    OutputLayerType,
+    InitializationRuleType,
+    MatType
+>::StaticFFN(
+    NetworkType network,
+    OutputLayerType outputLayer,
+    InitializationRuleType initializeRule) :
+    outputLayer(std::move(outputLayer)),
+    initializeRule(std::move(initializeRule)),
+    width(0),
+    height(0),
+    reset(false),
+    network(std::move(network)),
+    numFunctions(0),
+    deterministic(true)
+{
+  /* Nothing to do here */
+}
+
+template<
+  typename... Layers,
+  typename OutputLayerType,
+  typename InitializationRuleType,
+  typename MatType
+>
+StaticFFN<
+    LayerSequence<Layers...>,
+    OutputLayerType,
+    InitializationRuleType,
+    MatType
+>::StaticFFN(
+    const StaticFFN& network) :
+    outputLayer(network.outputLayer),
+    initializeRule(network.initializeRule),
+    width(network.width),
+    height(network.height),
+    reset(network.reset),
+    network(network.network),
+    predictors(network.predictors),
+    responses(network.responses),
+    parameter(network.parameter),
+    layerParameter(network.layerParameter),
+    numFunctions(network.numFunctions),
+    error(network.error),
+    currentInput(network.currentInput),
+    deterministic(network.deterministic)
+{
+  // The copied layers still use the weights of the other network.
+  if (!parameter.is_empty())
+    ResetWeights();
+}
+
+template<
+  typename... Layers,
+  typename OutputLayerType,
+  typename InitializationRuleType,
+  typename MatType
+>
+StaticFFN<
+    LayerSequence<Layers...>,
+    OutputLayerType,
+    InitializationRuleType,
+    MatType
+>::StaticFFN(
+    StaticFFN&& network) :
+    outputLayer(std::move(network.outputLayer)),
+    initializeRule(std::move(network.initializeRule)),
+    width(network.width),
+    height(network.height),
+    reset(network.reset),
+    network(std::move(network.network)),
+    predictors(std::move(network.predictors)),
+    responses(std::move(network.responses)),
+    parameter(std::move(network.parameter)),
+    layerParameter(std::move(network.layerParameter)),
+    numFunctions(network.numFunctions),
+    error(std::move(network.error)),
+    currentInput(std::move(network.currentInput)),
+    deterministic(network.deterministic)
+{
+  // Small parameter matrices are copied instead of moved.
+  if (!parameter.is_empty())
+    ResetWeights();
+}
+
+template<
+  typename... Layers,
+  typename OutputLayerType,
+  typename InitializationRuleType,
+  typename MatType
+>
+StaticFFN<
+    LayerSequence<Layers...>,
+    OutputLayerType,
+    InitializationRuleType,
+    MatType
+>&
+StaticFFN<
+    LayerSequence<Layers...>,
+    OutputLayerType,
+    InitializationRuleType,
+    MatType
+>::operator = (
+    StaticFFN network)
+{
+  Swap(network);
+  if (!parameter.is_empty())
+    ResetWeights();
+
+  return *this;
+}
+
+template<
+  typename... Layers,
+  typename OutputLayerType,
+  typename InitializationRuleType,
+  typename MatType
+>
+void StaticFFN<
+    LayerSequence<Layers...>,
+    OutputLayerType,
+    InitializationRuleType,
+    MatType
+>::ResetData(
+    MatType predictors, MatType responses)
+{
+  numFunctions = responses.n_cols;
+  this->predictors = std::move(predictors);
+  this->responses = std::move(responses);
+  this->deterministic = true;
+  ResetDeterministic();
+
+  if (!reset)
+    ResetParameters();
+}
+
+template<
+  typename... Layers,
+  typename OutputLayerType,
+  typename InitializationRuleType,
+  typename MatType
+>
+template<typename OptimizerType>
+void StaticFFN<
+    LayerSequence<Layers...>,
+    OutputLayerType,
+    InitializationRuleType,
+    MatType
+>::Train(
+    MatType predictors,
+    MatType responses,
+    OptimizerType& optimizer)
+{
+  ResetData(std::move(predictors), std::move(responses));
+
+  // Train the model.
+  Timer::Start("ffn_optimization");
+  const double out = optimizer.Optimize(*this, parameter);
+  Timer::Stop("ffn_optimization");
+
+  Log::Info << "StaticFFN::Train(): final objective of trained model is "
+      << out << "." << std::endl;
+}
+
+template<
+  typename... Layers,
+  typename OutputLayerType,
+  typename InitializationRuleType,
+  typename MatType
+>
+template<typename OptimizerType>
+void StaticFFN<
+    LayerSequence<Layers...>,
+    OutputLayerType,
+    InitializationRuleType,
+    MatType
+>::Train(
+    MatType predictors, MatType responses)
+{
+  OptimizerType optimizer;
+  Train(std::move(predictors), std::move(responses), optimizer);
+}
+
+template<
+  typename... Layers,
+  typename OutputLayerType,
+  typename InitializationRuleType,
+  typename MatType
+>
+void StaticFFN<
+    LayerSequence<Layers...>,
+    OutputLayerType,
+    InitializationRuleType,
+    MatType
+>::Forward(
+    MatType inputs, MatType& results)
+{
+  if (parameter.is_empty())
+    ResetParameters();
+  else
+    CopyParameters();
+
+  if (!deterministic)
+  {
+    deterministic = true;
+    ResetDeterministic();
+  }
+
+  currentInput = std::move(inputs);
+  Forward(std::move(currentInput));
+  results = NetworkOutput();
+}
+
+template<
+  typename... Layers,
+  typename OutputLayerType,
+  typename InitializationRuleType,
+  typename MatType
+>
+double StaticFFN<
+    LayerSequence<Layers...>,
+    OutputLayerType,
+    InitializationRuleType,
+    MatType
+>::Backward(
+    MatType targets, arma::mat& gradients)
+{
+  double res = outputLayer.Forward(std::move(NetworkOutput()),
+      std::move(targets));
+
+  outputLayer.Backward(std::move(NetworkOutput()), std::move(targets),
+      std::move(error));
+
+  gradients = arma::zeros<arma::mat>(parameter.n_rows, parameter.n_cols);
+
+  Backward();
+  ResetGradients(LayerGradients(gradients));
+  Gradient(std::move(currentInput));
+  CopyGradients(gradients);
+
+  return res;
+}
+
+template<
+  typename... Layers,
+  typename OutputLayerType,
+  typename InitializationRuleType,
+  typename MatType
+>
+void StaticFFN<
+    LayerSequence<Layers...>,
+    OutputLayerType,
+    InitializationRuleType,
+    MatType
+>::Predict(
+    MatType predictors, MatType& results, const size_t batchSize)
+{
+  if (parameter.is_empty())
+    ResetParameters();
+  else
+    CopyParameters();
+
+  if (!deterministic)
+  {
+    deterministic = true;
+    ResetDeterministic();
+  }
+
+  if (predictors.n_cols == 0)
+  {
+    results.reset();
+    return;
+  }
+
+  size_t effectiveBatchSize = std::min(std::max(batchSize, (size_t) 1),
+      (size_t) predictors.n_cols);
+  for (size_t begin = 0; begin < predictors.n_cols; )
+  {
+    const size_t end = std::min(begin + effectiveBatchSize,
+        (size_t) predictors.n_cols) - 1;
+    Forward(std::move(MatType(predictors.colptr(begin), predictors.n_rows,
+        end - begin + 1, false, true)));
+    const MatType& output = NetworkOutput();
+
+    // Some layers (like Join or Concat) don't keep one column for each point;
+    // in that case, the points have to be passed one at a time.
+    if (output.n_cols != end - begin + 1 && end != begin)
+    {
+      effectiveBatchSize = 1;
+      continue;
+    }
+
+    if (begin == 0)
+      results.set_size(output.n_rows, predictors.n_cols);
+
+    if (end == begin)
+      results.col(begin) = output.col(0);
+    else
+      results.cols(begin, end) = output;
+
+    begin = end + 1;
+  }
+}
+
+template<
+  typename... Layers,
+  typename OutputLayerType,
+  typename InitializationRuleType,
+  typename MatType
+>
+double StaticFFN<
+    LayerSequence<Layers...>,
+    OutputLayerType,
+    InitializationRuleType,
+    MatType
+>::Evaluate(
+    const arma::mat& parameters)
+{
+  return Evaluate(parameters, 0, predictors.n_cols);
+}
+
+template<
+  typename... Layers,
+  typename OutputLayerType,
+  typename InitializationRuleType,
+  typename MatType
+>
+double StaticFFN<
+    LayerSequence<Layers...>,
+    OutputLayerType,
+    InitializationRuleType,
+    MatType
+>::Evaluate(
+    const arma::mat& /* parameters */,
+    const size_t begin,
+    const size_t batchSize,
+    const bool deterministic)
+{
+  if (parameter.is_empty())
+    ResetParameters();
+  else
+    CopyParameters();
+
+  if (deterministic != this->deterministic)
+  {
+    this->deterministic = deterministic;
+    ResetDeterministic();
+  }
+
+  Forward(std::move(predictors.cols(begin, begin + batchSize - 1)));
+  return outputLayer.Forward(std::move(NetworkOutput()),
+      std::move(responses.cols(begin, begin + batchSize - 1)));
+}
+
+template<
+  typename... Layers,
+  typename OutputLayerType,
+  typename InitializationRuleType,
+  typename MatType
+>
+void StaticFFN<
+    LayerSequence<Layers...>,
+    OutputLayerType,
+    InitializationRuleType,
+    MatType
+>::Gradient(
+    const arma::mat& parameters,
+    const size_t begin,
+    arma::mat& gradient,
+    const size_t batchSize)
+{
+  if (gradient.is_empty())
+  {
+    if (parameter.is_empty())
+      ResetParameters();
+
+    gradient = arma::zeros<arma::mat>(parameter.n_rows, parameter.n_cols);
+  }
+  else
+  {
+    gradient.zeros();
+  }
+
+  Evaluate(parameters, begin, batchSize, false);
+
+  outputLayer.Backward(std::move(NetworkOutput()),
+      std::move(responses.cols(begin, begin + batchSize - 1)),
+      std::move(error));
+
+  Backward();
+  ResetGradients(LayerGradients(gradient));
+  Gradient(std::move(predictors.cols(begin, begin + batchSize - 1)));
+  CopyGradients(gradient);
+}
+
+template<
+  typename... Layers,
+  typename OutputLayerType,
+  typename InitializationRuleType,
+  typename MatType
+>
+void StaticFFN<
+    LayerSequence<Layers...>,
+    OutputLayerType,
+    InitializationRuleType,
+    MatType
+>::Shuffle()
+{
+  math::ShuffleData(predictors, responses, predictors, responses);
+}
+
+template<
+  typename... Layers,
+  typename OutputLayerType,
+  typename InitializationRuleType,
+  typename MatType
+>
+void StaticFFN<
+    LayerSequence<Layers...>,
+    OutputLayerType,
+    InitializationRuleType,
+    MatType
+>::ResetParameters()
+{
+  ResetDeterministic();
+
+  // Determine the number of parameter/weights of the network.
+  WeightCounter counter = { 0 };
+  Apply(counter, LayerIndex<0>());
+  parameter.set_size(counter.weights, 1);
+
+  // Initialize the network layer by layer or the complete network.
+  if (InitTraits<InitializationRuleType>::UseLayer)
+  {
+    LayerInitializer initializer = { initializeRule, parameter, 0 };
+    Apply(initializer, LayerIndex<0>());
+  }
+  else
+  {
+    initializeRule.Initialize(parameter, parameter.n_elem, 1);
+  }
+
+  ResetWeights();
+}
+
+template<
+  typename... Layers,
+  typename OutputLayerType,
+  typename InitializationRuleType,
+  typename MatType
+>
+void StaticFFN<
+    LayerSequence<Layers...>,
+    OutputLayerType,
+    InitializationRuleType,
+    MatType
+>::ResetWeights()
+{
+  // Layers of another precision use a converted copy of the parameters.
+  CopyParameters();
+
+  WeightSetter setter = { LayerParameters(), 0 };
+  Apply(setter, LayerIndex<0>());
+}
+
+template<
+  typename... Layers,
+  typename OutputLayerType,
+  typename InitializationRuleType,
+  typename MatType
+>
+void StaticFFN<
+    LayerSequence<Layers...>,
+    OutputLayerType,
+    InitializationRuleType,
+    MatType
+>::ResetDeterministic()
+{
+  DeterministicSetVisitor deterministicSetVisitor(deterministic);
+  Apply(deterministicSetVisitor, LayerIndex<0>());
+}
+
+template<
+  typename... Layers,
+  typename OutputLayerType,
+  typename InitializationRuleType,
+  typename MatType
+>
+void StaticFFN<
+    LayerSequence<Layers...>,
+    OutputLayerType,
+    InitializationRuleType,
+    MatType
+>::ResetGradients(
+    MatType& gradient)
+{
+  GradientSetter setter = { gradient, 0 };
+  Apply(setter, LayerIndex<0>());
+}
+
+template<
+  typename... Layers,
+  typename OutputLayerType,
+  typename InitializationRuleType,
+  typename MatType
+>
+void StaticFFN<
+    LayerSequence<Layers...>,
+    OutputLayerType,
+    InitializationRuleType,
+    MatType
+>::Forward(
+    MatType&& input)
+{
+  Layer<0>().Forward(std::move(input),
+      std::move(Layer<0>().OutputParameter()));
+
+  if (!reset)
+  {
+    if (outputWidthVisitor(&Layer<0>()) != 0)
+      width = outputWidthVisitor(&Layer<0>());
+
+    if (outputHeightVisitor(&Layer<0>()) != 0)
+      height = outputHeightVisitor(&Layer<0>());
+  }
+
+  Forward(LayerIndex<1>());
+
+  if (!reset)
+    reset = true;
+}
+
+template<
+  typename... Layers,
+  typename OutputLayerType,
+  typename InitializationRuleType,
+  typename MatType
+>
+template<size_t I>
+void StaticFFN<
+    LayerSequence<Layers...>,
+    OutputLayerType,
+    InitializationRuleType,
+    MatType
+>::Forward(
+    LayerIndex<I>)
+{
+  if (!reset)
+  {
+    // Set the input width and height.
+    const SetInputWidthVisitor setInputWidthVisitor(width);
+    setInputWidthVisitor(&Layer<I>());
+    const SetInputHeightVisitor setInputHeightVisitor(height);
+    setInputHeightVisitor(&Layer<I>());
+  }
+
+  Layer<I>().Forward(std::move(Layer<I - 1>().OutputParameter()),
+      std::move(Layer<I>().OutputParameter()));
+
+  if (!reset)
+  {
+    // Get the output width and height.
+    if (outputWidthVisitor(&Layer<I>()) != 0)
+      width = outputWidthVisitor(&Layer<I>());
+
+    if (outputHeightVisitor(&Layer<I>()) != 0)
+      height = outputHeightVisitor(&Layer<I>());
+  }
+
+  Forward(LayerIndex<I + 1>());
+}
+
+template<
+  typename... Layers,
+  typename OutputLayerType,
+  typename InitializationRuleType,
+  typename MatType
+>
+void StaticFFN<
+    LayerSequence<Layers...>,
+    OutputLayerType,
+    InitializationRuleType,
+    MatType
+>::Backward()
+{
+  Layer<NumLayers - 1>().Backward(std::move(NetworkOutput()), std::move(error),
+      std::move(Layer<NumLayers - 1>().Delta()));
+
+  Backward(LayerIndex<NumLayers - 2>());
+}
+
+template<
+  typename... Layers,
+  typename OutputLayerType,
+  typename InitializationRuleType,
+  typename MatType
+>
+template<size_t I>
+void StaticFFN<
+    LayerSequence<Layers...>,
+    OutputLayerType,
+    InitializationRuleType,
+    MatType
+>::Backward(
+    LayerIndex<I>)
+{
+  Layer<I>().Backward(std::move(Layer<I>().OutputParameter()),
+      std::move(Layer<I + 1>().Delta()), std::move(Layer<I>().Delta()));
+
+  Backward(LayerIndex<I - 1>());
+}
+
+template<
+  typename... Layers,
+  typename OutputLayerType,
+  typename InitializationRuleType,
+  typename MatType
+>
+void StaticFFN<
+    LayerSequence<Layers...>,
+    OutputLayerType,
+    InitializationRuleType,
+    MatType
+>::Gradient(
+    MatType&& input)
+{
+  LayerGradient(Layer<0>(), std::move(input), std::move(Layer<1>().Delta()));
+
+  Gradient(LayerIndex<1>());
+
+  LayerGradient(Layer<NumLayers - 1>(), std::move(
+      Layer<NumLayers - 2>().OutputParameter()), std::move(error));
+}
+
+template<
+  typename... Layers,
+  typename OutputLayerType,
+  typename InitializationRuleType,
+  typename MatType
+>
+template<size_t I>
+void StaticFFN<
+    LayerSequence<Layers...>,
+    OutputLayerType,
+    InitializationRuleType,
+    MatType
+>::Gradient(
+    LayerIndex<I>)
+{
+  LayerGradient(Layer<I>(), std::move(Layer<I - 1>().OutputParameter()),
+      std::move(Layer<I + 1>().Delta()));
+
+  Gradient(LayerIndex<I + 1>());
+}
+
+template<
+  typename... Layers,
+  typename OutputLayerType,
+  typename InitializationRuleType,
+  typename MatType
+>
+template<typename Archive>
+void StaticFFN<
+    LayerSequence<Layers...>,
+    OutputLayerType,
+    InitializationRuleType,
+    MatType
+>::serialize(
+    Archive& ar, const unsigned int /* version */)
+{
+  ar & BOOST_SERIALIZATION_NVP(parameter);
+  ar & BOOST_SERIALIZATION_NVP(width);
+  ar & BOOST_SERIALIZATION_NVP(height);
+  ar & BOOST_SERIALIZATION_NVP(currentInput);
+
+  SerializeLayers(ar, LayerIndex<0>());
+
+  // If we are loading, we need to initialize the weights.
+  if (Archive::is_loading::value)
+  {
+    reset = false;
+    ResetWeights();
+
+    deterministic = true;
+    ResetDeterministic();
+  }
+}
+
+template<
+  typename... Layers,
+  typename OutputLayerType,
+  typename InitializationRuleType,
+  typename MatType
+>
+template<typename Archive, size_t I>
+void StaticFFN<
+    LayerSequence<Layers...>,
+    OutputLayerType,
+    InitializationRuleType,
+    MatType
+>::SerializeLayers(
+    Archive& ar, LayerIndex<I>)
+{
+  const std::string name = "layer" + std::to_string(I);
+  ar & boost::serialization::make_nvp(name.c_str(), Layer<I>());
+
+  SerializeLayers(ar, LayerIndex<I + 1>());
+}
+
+template<
+  typename... Layers,
+  typename OutputLayerType,
+  typename InitializationRuleType,
+  typename MatType
+>
+void StaticFFN<
+    LayerSequence<Layers...>,
+    OutputLayerType,
+    InitializationRuleType,
+    MatType
+>::Swap(
+    StaticFFN& network)
+{
+  std::swap(outputLayer, network.outputLayer);
+  std::swap(initializeRule, network.initializeRule);
+  std::swap(width, network.width);
+  std::swap(height, network.height);
+  std::swap(reset, network.reset);
+  std::swap(this->network, network.network);
+  std::swap(predictors, network.predictors);
+  std::swap(responses, network.responses);
+  std::swap(parameter, network.parameter);
+  std::swap(layerParameter, network.layerParameter);
+  std::swap(numFunctions, network.numFunctions);
+  std::swap(error, network.error);
+  std::swap(currentInput, network.currentInput);
+  std::swap(deterministic, network.deterministic);
+}
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,65 @@
+/**
+ * @file set_state_visitor.hpp
+ *
+ * This file provides an abstraction for the SetState() function of the
+ * recurrent layers.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_VISITOR_SET_STATE_VISITOR_HPP
+#define MLPACK_METHODS_ANN_VISITOR_SET_STATE_VISITOR_HPP
+
+#include <mlpack/methods/ann/layer/layer_traits.hpp>
+#include <mlpack/methods/ann/layer/layer_types.hpp>
+
+#include <boost/variant.hpp>
+
+namespace mlpack {
+namespace ann {
+
+/**
+ * SetStateVisitor sets the state of a recurrent module (see LSTM::SetState())
+ * from the rows of the given matrix that start at the given offset, in the
+ * layout of StateVisitor.  It returns the number of rows of the state of the
+ * module.
+ */
+class SetStateVisitor : public boost::static_visitor<size_t>
+{
+ public:
+  //! Set the states of the modules from the given matrix.
+  SetStateVisitor(const arma::mat& state, const size_t offset = 0);
+
+  //! Set the state of the module.
+  template<typename LayerType>
+  size_t operator()(LayerType* layer) const;
+
+ private:
+  //! The states of the modules.
+  const arma::mat& state;
+
+  //! The row of the state of the module.
+  size_t offset;
+
+  //! Set the state if the module implements the State() function.
+  template<typename T>
+  typename std::enable_if<
+      HasStateCheck<T, void(T::*)(arma::mat&) const>::value, size_t>::type
+  LayerState(T* layer) const;
+
+  //! Do nothing if the module doesn't implement the State() function.
+  template<typename T>
+  typename std::enable_if<
+      !HasStateCheck<T, void(T::*)(arma::mat&) const>::value, size_t>::type
+  LayerState(T* layer) const;
+};
+
+} // namespace ann
+} // namespace mlpack
+
+// Include implementation.
+#include "set_state_visitor_impl.hpp"
+
+#endif
@@ -0,0 +1,64 @@
+/**
+ * @file set_state_visitor_impl.hpp
+ *
+ * Implementation of the SetState() function of the recurrent layers.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_VISITOR_SET_STATE_VISITOR_IMPL_HPP
+#define MLPACK_METHODS_ANN_VISITOR_SET_STATE_VISITOR_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "set_state_visitor.hpp"
+
+namespace mlpack {
+namespace ann {
+
+//! SetStateVisitor visitor class.
+inline SetStateVisitor::SetStateVisitor(const arma::mat& state,
+                                        const size_t offset) :
+    state(state),
+    offset(offset)
+{
+  /* Nothing to do here. */
+}
+
+template<typename LayerType>
+inline size_t SetStateVisitor::operator()(LayerType* layer) const
+{
+  return LayerState(layer);
+}
+
+template<typename T>
+inline typename std::enable_if<
+    HasStateCheck<T, void(T::*)(arma::mat&) const>::value, size_t>::type
+SetStateVisitor::LayerState(T* layer) const
+{
+  const size_t rows = layer->StateSize();
+  if (offset + rows > state.n_rows)
+  {
+    std::ostringstream oss;
+    oss << "SetStateVisitor: the state has " << state.n_rows << " rows, but "
+        << "the modules need at least " << offset + rows << "!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  layer->SetState(state.rows(offset, offset + rows - 1));
+  return rows;
+}
+
+template<typename T>
+inline typename std::enable_if<
+    !HasStateCheck<T, void(T::*)(arma::mat&) const>::value, size_t>::type
+SetStateVisitor::LayerState(T* /* layer */) const
+{
+  return 0;
+}
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,60 @@
+/**
+ * @file state_visitor.hpp
+ *
+ * This file provides an abstraction for the State() function of the recurrent
+ * layers.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_VISITOR_STATE_VISITOR_HPP
+#define MLPACK_METHODS_ANN_VISITOR_STATE_VISITOR_HPP
+
+#include <mlpack/methods/ann/layer/layer_traits.hpp>
+#include <mlpack/methods/ann/layer/layer_types.hpp>
+
+#include <boost/variant.hpp>
+
+namespace mlpack {
+namespace ann {
+
+/**
+ * StateVisitor appends the state of a recurrent module (see LSTM::State()) to
+ * the given matrix, below the states of the modules visited before.
+ */
+class StateVisitor : public boost::static_visitor<void>
+{
+ public:
+  //! Append the states of the modules to the given matrix.
+  StateVisitor(arma::mat&& state);
+
+  //! Append the state of the module.
+  template<typename LayerType>
+  void operator()(LayerType* layer) const;
+
+ private:
+  //! The states of the modules.
+  arma::mat&& state;
+
+  //! Append the state if the module implements the State() function.
+  template<typename T>
+  typename std::enable_if<
+      HasStateCheck<T, void(T::*)(arma::mat&) const>::value, void>::type
+  LayerState(T* layer) const;
+
+  //! Do nothing if the module doesn't implement the State() function.
+  template<typename T>
+  typename std::enable_if<
+      !HasStateCheck<T, void(T::*)(arma::mat&) const>::value, void>::type
+  LayerState(T* layer) const;
+};
+
+} // namespace ann
+} // namespace mlpack
+
+// Include implementation.
+#include "state_visitor_impl.hpp"
+
+#endif
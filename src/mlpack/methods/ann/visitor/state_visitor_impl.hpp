@@ -0,0 +1,53 @@
+/**
+ * @file state_visitor_impl.hpp
+ *
+ * Implementation of the State() function of the recurrent layers.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_VISITOR_STATE_VISITOR_IMPL_HPP
+#define MLPACK_METHODS_ANN_VISITOR_STATE_VISITOR_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "state_visitor.hpp"
+
+namespace mlpack {
+namespace ann {
+
+//! StateVisitor visitor class.
+inline StateVisitor::StateVisitor(arma::mat&& state) : state(std::move(state))
+{
+  /* Nothing to do here. */
+}
+
+template<typename LayerType>
+inline void StateVisitor::operator()(LayerType* layer) const
+{
+  LayerState(layer);
+}
+
+template<typename T>
+inline typename std::enable_if<
+    HasStateCheck<T, void(T::*)(arma::mat&) const>::value, void>::type
+StateVisitor::LayerState(T* layer) const
+{
+  arma::mat layerState;
+  layer->State(layerState);
+  state = arma::join_cols(state, layerState);
+}
+
+template<typename T>
+inline typename std::enable_if<
+    !HasStateCheck<T, void(T::*)(arma::mat&) const>::value, void>::type
+StateVisitor::LayerState(T* /* layer */) const
+{
+  /* Nothing to do here. */
+}
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
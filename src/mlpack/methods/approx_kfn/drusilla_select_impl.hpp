@@ -84,8 +84,10 @@ void DrusillaSelect<MatType>::Train(
   arma::vec dataMean(arma::mean(referenceSet, 1));
   arma::vec norms(referenceSet.n_cols);
 
+  // Columns of a sparse matrix can't be assigned by several threads at once.
   MatType refCopy(referenceSet.n_rows, referenceSet.n_cols);
-  for (size_t i = 0; i < refCopy.n_cols; ++i)
+  #pragma omp parallel for if (!arma::is_SpMat<MatType>::value)
+  for (omp_size_t i = 0; i < (omp_size_t) refCopy.n_cols; ++i)
   {
     refCopy.col(i) = referenceSet.col(i) - dataMean;
     norms[i] = arma::norm(refCopy.col(i));
@@ -100,10 +102,13 @@ void DrusillaSelect<MatType>::Train(
 
     arma::vec line(refCopy.col(maxIndex) / arma::norm(refCopy.col(maxIndex)));
 
-    // Calculate distortion and offset and make scores.
-    std::vector<bool> closeAngle(referenceSet.n_cols, false);
+    // Calculate distortion and offset and make scores, in parallel over the
+    // points.  (std::vector<bool> can't be written by several threads at once,
+    // so closeAngle holds chars.)
+    std::vector<char> closeAngle(referenceSet.n_cols, false);
     arma::vec sums(referenceSet.n_cols);
-    for (size_t j = 0; j < referenceSet.n_cols; ++j)
+    #pragma omp parallel for
+    for (omp_size_t j = 0; j < (omp_size_t) referenceSet.n_cols; ++j)
     {
       if (norms[j] > 0.0)
       {
@@ -183,18 +188,29 @@ void DrusillaSelect<MatType>::Search(const MatType& querySet,
   // Note that we aren't using trees for our search, so we can use 'int' as a
   // TreeType.
   metric::EuclideanDistance metric;
-  NeighborSearchRules<FurthestNeighborSort, metric::EuclideanDistance,
+  typedef NeighborSearchRules<FurthestNeighborSort, metric::EuclideanDistance,
       tree::KDTree<metric::EuclideanDistance, tree::EmptyStatistic, MatType>>
-      rules(candidateSet, querySet, k, metric, 0, false);
+      RuleType;
+  RuleType rules(candidateSet, querySet, k, metric, 0, false);
 
-  for (size_t q = 0; q < querySet.n_cols; ++q)
-    for (size_t r = 0; r < candidateSet.n_cols; ++r)
-      rules.BaseCase(q, r);
+  #pragma omp parallel
+  {
+    // Each thread has its own rules (sharing the candidate lists), and works
+    // on its own query points.
+    RuleType threadRules(rules);
+
+    // The candidates are contiguous, so each query point is compared with all
+    // of them as one block.
+    #pragma omp for schedule(dynamic, 16)
+    for (omp_size_t q = 0; q < (omp_size_t) querySet.n_cols; ++q)
+      threadRules.BaseCaseBlock(q, 0, candidateSet.n_cols);
+  }
 
   rules.GetResults(neighbors, distances);
 
   // Map the neighbors back to their original indices in the reference set.
-  for (size_t i = 0; i < neighbors.n_elem; ++i)
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) neighbors.n_elem; ++i)
     neighbors[i] = candidateIndices[neighbors[i]];
 }
 
@@ -15,6 +15,8 @@
  */
 #include "cf.hpp"
 
+#include <mlpack/core/kernels/linear_kernel.hpp>
+#include <mlpack/methods/fastmks/fastmks.hpp>
 #include <queue>
 
 namespace mlpack {
@@ -54,85 +56,158 @@ void CF::GetRecommendations(const size_t numRecs,
                             arma::Mat<size_t>& recommendations,
                             const arma::Col<size_t>& users)
 {
-  // We want to avoid calculating the full rating matrix, so we will do nearest
-  // neighbor search only on the H matrix, using the observation that if the
-  // rating matrix X = W*H, then d(X.col(i), X.col(j)) = d(W H.col(i), W
-  // H.col(j)).  This can be seen as nearest neighbor search on the H matrix
-  // with the Mahalanobis distance where M^{-1} = W^T W.  So, we'll decompose
-  // M^{-1} = L L^T (the Cholesky decomposition), and then multiply H by L^T.
-  // Then we can perform nearest neighbor search.
-  arma::mat l = arma::chol(w.t() * w);
-  arma::mat stretchedH = l * h; // Due to the Armadillo API, l is L^T.
-
-  // Now, we will use the decomposed w and h matrices to estimate what the user
+  // We will use the decomposed w and h matrices to estimate what the user
   // would have rated items as, and then pick the best items.
 
-  // Temporarily store feature vector of queried users.
-  arma::mat query(stretchedH.n_rows, users.n_elem);
-
-  // Select feature vectors of queried users.
+  // Select the stretched feature vectors of the queried users.
+  arma::mat query(l.n_rows, users.n_elem);
   for (size_t i = 0; i < users.n_elem; i++)
-    query.col(i) = stretchedH.col(users(i));
+    query.col(i) = l * h.col(users(i));
 
-  // Temporary storage for neighborhood of the queried users.
+  // Calculate the neighborhood of the queried users with the cached index.
   arma::Mat<size_t> neighborhood;
-
-  // Calculate the neighborhood of the queried users.
-  // This should be a templatized option.
-  neighbor::KNN a(stretchedH);
   arma::mat resultingDistances; // Temporary storage.
-  a.Search(query, numUsersForSimilarity, neighborhood, resultingDistances);
+  similarityIndex.SearchMode() = neighbor::DUAL_TREE_MODE;
+  similarityIndex.Search(query, numUsersForSimilarity, neighborhood,
+      resultingDistances);
 
   // Generate recommendations for each query user by finding the maximum numRecs
-  // elements in the averages matrix.
+  // elements in the averages matrix.  The users are processed in blocks; the
+  // averages of a block are computed with one matrix multiplication, and
+  // blocks are handled in parallel.  The block size keeps the averages of a
+  // block at around 2^21 elements.
   recommendations.set_size(numRecs, users.n_elem);
-  arma::mat values(numRecs, users.n_elem);
+  const size_t blockSize = std::max((size_t) 1, std::min((size_t) 256,
+      (size_t) (1 << 21) / std::max((size_t) cleanedData.n_rows, (size_t) 1)));
+  const size_t numBlocks = (users.n_elem + blockSize - 1) / blockSize;
 
-  for (size_t i = 0; i < users.n_elem; i++)
+  // Default candidate: the smallest possible value and invalid item number.
+  const Candidate def = std::make_pair(-DBL_MAX, cleanedData.n_rows);
+
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
   {
-    // First, calculate average of neighborhood values.
-    arma::vec averages;
-    averages.zeros(cleanedData.n_rows);
+    const size_t begin = b * blockSize;
+    const size_t end = std::min(begin + blockSize, (size_t) users.n_elem);
+
+    // First, calculate average of neighborhood values.  Since the ratings are
+    // W * H, the average of the neighbors' ratings is W times the average of
+    // their columns of H.
+    arma::mat meanH(h.n_rows, end - begin, arma::fill::zeros);
+    for (size_t i = begin; i < end; ++i)
+    {
+      for (size_t j = 0; j < neighborhood.n_rows; ++j)
+        meanH.col(i - begin) += h.col(neighborhood(j, i));
+    }
+    meanH /= neighborhood.n_rows;
 
-    for (size_t j = 0; j < neighborhood.n_rows; ++j)
-      averages += w * h.col(neighborhood(j, i));
-    averages /= neighborhood.n_rows;
-
-    // Let's build the list of candidate recomendations for the given user.
-    // Default candidate: the smallest possible value and invalid item number.
-    const Candidate def = std::make_pair(-DBL_MAX, cleanedData.n_rows);
-    std::vector<Candidate> vect(numRecs, def);
-    typedef std::priority_queue<Candidate, std::vector<Candidate>, CandidateCmp>
-        CandidateList;
-    CandidateList pqueue(CandidateCmp(), std::move(vect));
-
-    // Look through the averages column corresponding to the current user.
-    for (size_t j = 0; j < averages.n_rows; ++j)
+    arma::mat averages = w * meanH;
+
+    for (size_t i = begin; i < end; ++i)
     {
-      // Ensure that the user hasn't already rated the item.
-      if (cleanedData(j, users(i)) != 0.0)
-        continue; // The user already rated the item.
+      // Exclude the items that the user has already rated, by walking the
+      // nonzero ratings of the user.  No candidate can beat the default
+      // candidate with a value of -DBL_MAX.
+      for (arma::sp_mat::const_col_iterator it =
+          cleanedData.begin_col(users(i)); it != cleanedData.end_col(users(i));
+          ++it)
+      {
+        averages(it.row(), i - begin) = -DBL_MAX;
+      }
 
+      // Let's build the list of candidate recomendations for the given user.
+      std::vector<Candidate> vect(numRecs, def);
+      typedef std::priority_queue<Candidate, std::vector<Candidate>,
+          CandidateCmp> CandidateList;
+      CandidateList pqueue(CandidateCmp(), std::move(vect));
 
-      // Is the estimated value better than the worst candidate?
-      if (averages[j] > pqueue.top().first)
+      // Look through the averages column corresponding to the current user.
+      const double* userAverages = averages.colptr(i - begin);
+      for (size_t j = 0; j < averages.n_rows; ++j)
       {
-        Candidate c = std::make_pair(averages[j], j);
+        // Is the estimated value better than the worst candidate?
+        if (userAverages[j] > pqueue.top().first)
+        {
+          Candidate c = std::make_pair(userAverages[j], j);
+          pqueue.pop();
+          pqueue.push(c);
+        }
+      }
+
+      for (size_t p = 1; p <= numRecs; p++)
+      {
+        recommendations(numRecs - p, i) = pqueue.top().second;
         pqueue.pop();
-        pqueue.push(c);
       }
     }
+  }
+
+  // If we were not able to come up with enough recommendations, issue a
+  // warning.  This is done outside the parallel loop so the output is in order.
+  for (size_t i = 0; i < users.n_elem; ++i)
+  {
+    if (recommendations(numRecs - 1, i) == def.second)
+      Log::Warn << "Could not provide " << numRecs << " recommendations "
+          << "for user " << users(i) << " (not enough un-rated items)!"
+          << std::endl;
+  }
+}
+
+void CF::GetMaxInnerProductRecommendations(
+    const size_t numRecs,
+    arma::Mat<size_t>& recommendations) const
+{
+  arma::Col<size_t> users = arma::linspace<arma::Col<size_t> >(0,
+      cleanedData.n_cols - 1, cleanedData.n_cols);
 
-    for (size_t p = 1; p <= numRecs; p++)
+  GetMaxInnerProductRecommendations(numRecs, recommendations, users);
+}
+
+void CF::GetMaxInnerProductRecommendations(
+    const size_t numRecs,
+    arma::Mat<size_t>& recommendations,
+    const arma::Col<size_t>& users) const
+{
+  // The search can't skip the items that a user has already rated, so we ask
+  // for enough extra results to cover the user who rated the most items.
+  size_t maxRated = 0;
+  for (size_t i = 0; i < users.n_elem; ++i)
+  {
+    maxRated = std::max(maxRated, (size_t) (cleanedData.col_ptrs[users(i) + 1] -
+        cleanedData.col_ptrs[users(i)]));
+  }
+  const size_t k = std::min(numRecs + maxRated, (size_t) w.n_rows);
+
+  // The predicted rating of an item is the inner product of its row of W with
+  // the user's column of H, so the best items are a max-kernel search with the
+  // linear kernel.
+  const arma::mat items = w.t();
+  arma::mat query(h.n_rows, users.n_elem);
+  for (size_t i = 0; i < users.n_elem; ++i)
+    query.col(i) = h.col(users(i));
+
+  fastmks::FastMKS<kernel::LinearKernel> mks(items);
+  arma::Mat<size_t> indices;
+  arma::mat products;
+  mks.Search(query, k, indices, products);
+
+  // Now keep the best items that each user hasn't already rated.  Anything we
+  // can't fill is left as an invalid item index.
+  recommendations.set_size(numRecs, users.n_elem);
+  recommendations.fill(cleanedData.n_rows);
+  for (size_t i = 0; i < users.n_elem; ++i)
+  {
+    size_t r = 0;
+    for (size_t j = 0; j < indices.n_rows && r < numRecs; ++j)
     {
-      recommendations(numRecs - p, i) = pqueue.top().second;
-      values(numRecs - p, i) = pqueue.top().first;
-      pqueue.pop();
+      const size_t item = indices(j, i);
+      if (item >= cleanedData.n_rows || cleanedData(item, users(i)) != 0.0)
+        continue; // Invalid result, or the user already rated the item.
+
+      recommendations(r++, i) = item;
     }
 
-    // If we were not able to come up with enough recommendations, issue a
-    // warning.
-    if (recommendations(numRecs - 1, i) == def.second)
+    if (r < numRecs)
       Log::Warn << "Could not provide " << numRecs << " recommendations "
           << "for user " << users(i) << " (not enough un-rated items)!"
           << std::endl;
@@ -142,34 +217,15 @@ void CF::GetRecommendations(const size_t numRecs,
 // Predict the rating for a single user/item combination.
 double CF::Predict(const size_t user, const size_t item) const
 {
-  // First, we need to find the nearest neighbors of the given user.
-  // We'll use the same technique as for GetRecommendations().
-
-  // We want to avoid calculating the full rating matrix, so we will do nearest
-  // neighbor search only on the H matrix, using the observation that if the
-  // rating matrix X = W*H, then d(X.col(i), X.col(j)) = d(W H.col(i), W
-  // H.col(j)).  This can be seen as nearest neighbor search on the H matrix
-  // with the Mahalanobis distance where M^{-1} = W^T W.  So, we'll decompose
-  // M^{-1} = L L^T (the Cholesky decomposition), and then multiply H by L^T.
-  // Then we can perform nearest neighbor search.
-  arma::mat l = arma::chol(w.t() * w);
-  arma::mat stretchedH = l * h; // Due to the Armadillo API, l is L^T.
+  // First, we need to find the nearest neighbors of the given user in the
+  // cached index; for a single query, single-tree search is fastest.
+  const arma::mat query = l * h.col(user);
 
-  // Now, we will use the decomposed w and h matrices to estimate what the user
-  // would have rated items as, and then pick the best items.
-
-  // Temporarily store feature vector of queried users.
-  arma::mat query = stretchedH.col(user);
-
-  // Temporary storage for neighborhood of the queried users.
   arma::Mat<size_t> neighborhood;
-
-  // Calculate the neighborhood of the queried users.
-  // This should be a templatized option.
-  neighbor::KNN a(stretchedH, neighbor::SINGLE_TREE_MODE);
   arma::mat resultingDistances; // Temporary storage.
-
-  a.Search(query, numUsersForSimilarity, neighborhood, resultingDistances);
+  similarityIndex.SearchMode() = neighbor::SINGLE_TREE_MODE;
+  similarityIndex.Search(query, numUsersForSimilarity, neighborhood,
+      resultingDistances);
 
   double rating = 0; // We'll take the average of neighborhood values.
 
@@ -184,11 +240,7 @@ double CF::Predict(const size_t user, const size_t item) const
 void CF::Predict(const arma::Mat<size_t>& combinations,
                  arma::vec& predictions) const
 {
-  // First, for nearest neighbor search, stretch the H matrix.
-  arma::mat l = arma::chol(w.t() * w);
-  arma::mat stretchedH = l * h; // Due to the Armadillo API, l is L^T.
-
-  // Now, we must determine those query indices we need to find the nearest
+  // First, we must determine those query indices we need to find the nearest
   // neighbors for.  This is easiest if we just sort the combinations matrix.
   arma::Mat<size_t> sortedCombinations(combinations.n_rows,
                                        combinations.n_cols);
@@ -199,17 +251,17 @@ void CF::Predict(const arma::Mat<size_t>& combinations,
   // Now, we have to get the list of unique users we will be searching for.
   arma::Col<size_t> users = arma::unique(combinations.row(0).t());
 
-  // Assemble our query matrix from the stretchedH matrix.
-  arma::mat queries(stretchedH.n_rows, users.n_elem);
+  // Assemble our query matrix from the stretched H matrix.
+  arma::mat queries(l.n_rows, users.n_elem);
   for (size_t i = 0; i < queries.n_cols; ++i)
-    queries.col(i) = stretchedH.col(users[i]);
+    queries.col(i) = l * h.col(users[i]);
 
-  // Now calculate the neighborhood of these users.
-  neighbor::KNN a(stretchedH);
+  // Now calculate the neighborhood of these users with the cached index.
   arma::mat distances;
   arma::Mat<size_t> neighborhood;
-
-  a.Search(queries, numUsersForSimilarity, neighborhood, distances);
+  similarityIndex.SearchMode() = neighbor::DUAL_TREE_MODE;
+  similarityIndex.Search(queries, numUsersForSimilarity, neighborhood,
+      distances);
 
   // Now that we have the neighborhoods we need, calculate the predictions.
   predictions.set_size(combinations.n_cols);
@@ -234,6 +286,20 @@ void CF::Predict(const arma::Mat<size_t>& combinations,
   }
 }
 
+void CF::BuildSimilarityIndex()
+{
+  // We want to avoid calculating the full rating matrix, so we will do nearest
+  // neighbor search only on the H matrix, using the observation that if the
+  // rating matrix X = W*H, then d(X.col(i), X.col(j)) = d(W H.col(i), W
+  // H.col(j)).  This can be seen as nearest neighbor search on the H matrix
+  // with the Mahalanobis distance where M^{-1} = W^T W.  So, we'll decompose
+  // M^{-1} = L L^T (the Cholesky decomposition), and then multiply H by L^T.
+  // Then we can perform nearest neighbor search.
+  // The tree on L^T H is built once here and reused by every query.
+  l = arma::chol(w.t() * w); // Due to the Armadillo API, l is L^T.
+  similarityIndex.Train(arma::mat(l * h));
+}
+
 void CF::CleanData(const arma::mat& data, arma::sp_mat& cleanedData)
 {
   // Generate list of locations for batch insert constructor for sparse
@@ -67,6 +67,12 @@ struct FactorizerTraits
  *
  * @endcode
  *
+ * After training, the neighbor search index of the users is built once, and it
+ * is reused (and serialized with the model) for every call to
+ * GetRecommendations() and Predict().  Searching the index modifies it, so
+ * those methods should not be called on the same CF object from several
+ * threads at once.
+ *
  * The data matrix is a (user, item, rating) table.  Each column in the matrix
  * should have three rows.  The first represents the user; the second represents
  * the item; and the third represents the rating.  The user and item, while they
@@ -218,6 +224,36 @@ class CF
                           arma::Mat<size_t>& recommendations,
                           const arma::Col<size_t>& users);
 
+  /**
+   * Generates the given number of recommendations for all users, by finding
+   * the items with the largest predicted rating (that is, the largest inner
+   * product W.row(item) * H.col(user)) for each user.  Instead of averaging the
+   * ratings of a neighborhood of similar users and scanning every item, this
+   * runs max-kernel search (FastMKS with the linear kernel) on cover trees
+   * built over the items, so the work per user grows sub-linearly with the
+   * number of items.
+   *
+   * @param numRecs Number of Recommendations
+   * @param recommendations Matrix to save recommendations into.
+   */
+  void GetMaxInnerProductRecommendations(
+      const size_t numRecs,
+      arma::Mat<size_t>& recommendations) const;
+
+  /**
+   * Generates the given number of recommendations for the specified users, by
+   * finding the items with the largest predicted rating for each user (see the
+   * other overload of GetMaxInnerProductRecommendations()).
+   *
+   * @param numRecs Number of Recommendations
+   * @param recommendations Matrix to save recommendations
+   * @param users Users for which recommendations are to be generated
+   */
+  void GetMaxInnerProductRecommendations(
+      const size_t numRecs,
+      arma::Mat<size_t>& recommendations,
+      const arma::Col<size_t>& users) const;
+
   //! Converts the User, Item, Value Matrix to User-Item Table
   static void CleanData(const arma::mat& data, arma::sp_mat& cleanedData);
 
@@ -248,7 +284,7 @@ class CF
    * Serialize the CF model to the given archive.
    */
   template<typename Archive>
-  void serialize(Archive& ar, const unsigned int /* version */);
+  void serialize(Archive& ar, const unsigned int version);
 
  private:
   //! Number of users for similarity.
@@ -262,6 +298,19 @@ class CF
   //! Cleaned data matrix.
   arma::sp_mat cleanedData;
 
+  /**
+   * The transposed Cholesky factor L^T of W^T W.  The neighbors of a user are
+   * found by nearest neighbor search on the columns of L^T H (see
+   * BuildSimilarityIndex()).
+   */
+  arma::mat l;
+  //! Nearest neighbor search index of the columns of L^T H.  Searching updates
+  //! the statistics of its tree, so it is mutable.
+  mutable neighbor::KNN similarityIndex;
+
+  //! Compute l and build the similarity index from the W and H matrices.
+  void BuildSimilarityIndex();
+
   //! Candidate represents a possible recommendation (value, item).
   typedef std::pair<double, size_t> Candidate;
 
@@ -277,6 +326,9 @@ class CF
 } // namespace cf
 } // namespace mlpack
 
+//! Set the serialization version of the CF class.
+BOOST_CLASS_VERSION(mlpack::cf::CF, 1);
+
 // Include implementation of templated functions.
 #include "cf_impl.hpp"
 
@@ -123,6 +123,8 @@ void CF::Train(const arma::mat& data, FactorizerType factorizer)
   Timer::Start("cf_factorization");
   ApplyFactorizer(factorizer, data, cleanedData, this->rank, w, h);
   Timer::Stop("cf_factorization");
+
+  BuildSimilarityIndex();
 }
 
 template<typename FactorizerType>
@@ -151,19 +153,30 @@ void CF::Train(const arma::sp_mat& data,
   Timer::Start("cf_factorization");
   factorizer.Apply(cleanedData, this->rank, w, h);
   Timer::Stop("cf_factorization");
+
+  BuildSimilarityIndex();
 }
 
 //! Serialize the model.
 template<typename Archive>
-void CF::serialize(Archive& ar, const unsigned int /* version */)
+void CF::serialize(Archive& ar, const unsigned int version)
 {
-  // This model is simple; just serialize all the members.  No special handling
-  // required.
   ar & BOOST_SERIALIZATION_NVP(numUsersForSimilarity);
   ar & BOOST_SERIALIZATION_NVP(rank);
   ar & BOOST_SERIALIZATION_NVP(w);
   ar & BOOST_SERIALIZATION_NVP(h);
   ar & BOOST_SERIALIZATION_NVP(cleanedData);
+
+  // Older models don't hold the similarity index, so we have to build it.
+  if (version > 0)
+  {
+    ar & BOOST_SERIALIZATION_NVP(l);
+    ar & BOOST_SERIALIZATION_NVP(similarityIndex);
+  }
+  else if (Archive::is_loading::value)
+  {
+    BuildSimilarityIndex();
+  }
 }
 
 } // namespace cf
@@ -17,6 +17,7 @@
 #include <mlpack/methods/regularized_svd/regularized_svd.hpp>
 #include <mlpack/methods/amf/termination_policies/max_iteration_termination.hpp>
 #include "cf.hpp"
+#include "implicit_als.hpp"
 
 using namespace mlpack;
 using namespace mlpack::cf;
@@ -50,7 +51,10 @@ PROGRAM_INFO("Collaborative Filtering", "This program performs collaborative "
     "specified with the " + PRINT_PARAM_STRING("recommendations") + " "
     "parameter, and the number of similar users (the size of the neighborhood) "
     " to be considered when generating recommendations can be specified with "
-    "the " + PRINT_PARAM_STRING("neighborhood") + " parameter."
+    "the " + PRINT_PARAM_STRING("neighborhood") + " parameter.  If " +
+    PRINT_PARAM_STRING("max_inner_product") + " is specified, the "
+    "neighborhood is not used; instead, each user is recommended the items "
+    "with the largest predicted ratings, found with fast max-kernel search."
     "\n\n"
     "For performing the matrix decomposition, the following optimization "
     "algorithms can be specified via the " + PRINT_PARAM_STRING("algorithm") +
@@ -62,6 +66,12 @@ PROGRAM_INFO("Collaborative Filtering", "This program performs collaborative "
     "'BatchSVD' -- SVD batch learning\n"
     "'SVDIncompleteIncremental' -- SVD incomplete incremental learning\n"
     "'SVDCompleteIncremental' -- SVD complete incremental learning\n"
+    "'SVDParallelIncremental' -- lock-free parallel SVD complete incremental "
+    "learning\n"
+    "'ParallelALS' -- regularized alternating least squares, solved in "
+    "parallel\n"
+    "'ImplicitALS' -- weighted alternating least squares for implicit feedback "
+    "(e.g. click counts) instead of ratings\n"
     "\n"
     "A trained model may be saved to with the " +
     PRINT_PARAM_STRING("output_model") + " output parameter."
@@ -112,6 +122,9 @@ PARAM_UMATRIX_OUT("output", "Matrix that will store output recommendations.",
     "o");
 PARAM_INT_IN("recommendations", "Number of recommendations to generate for each"
     " query user.", "c", 5);
+PARAM_FLAG("max_inner_product", "Recommend the items with the largest predicted"
+    " ratings (found with max-kernel search) instead of averaging the ratings "
+    "of similar users.", "");
 
 PARAM_INT_IN("seed", "Set the random seed (0 uses std::time(NULL)).", "s", 0);
 
@@ -132,12 +145,23 @@ void ComputeRecommendations(CF& cf,
 
     Log::Info << "Generating recommendations for " << users.n_elem << " users."
         << endl;
-    cf.GetRecommendations(numRecs, recommendations, users.row(0).t());
+    if (CLI::HasParam("max_inner_product"))
+    {
+      cf.GetMaxInnerProductRecommendations(numRecs, recommendations,
+          users.row(0).t());
+    }
+    else
+    {
+      cf.GetRecommendations(numRecs, recommendations, users.row(0).t());
+    }
   }
   else
   {
     Log::Info << "Generating recommendations for all users." << endl;
-    cf.GetRecommendations(numRecs, recommendations);
+    if (CLI::HasParam("max_inner_product"))
+      cf.GetMaxInnerProductRecommendations(numRecs, recommendations);
+    else
+      cf.GetRecommendations(numRecs, recommendations);
   }
 }
 
@@ -237,6 +261,22 @@ void AssembleFactorizerType(const std::string& algorithm,
           SVDCompleteIncrementalLearning<arma::sp_mat>> FactorizerType;
       PerformAction(FactorizerType(mit), dataset, rank);
     }
+    else if (algorithm == "SVDParallelIncremental")
+    {
+      typedef AMF<MaxIterationTermination, RandomInitialization,
+          SVDParallelIncrementalLearning> FactorizerType;
+      PerformAction(FactorizerType(mit), dataset, rank);
+    }
+    else if (algorithm == "ParallelALS")
+    {
+      typedef AMF<MaxIterationTermination, RandomInitialization,
+          ParallelALSUpdate> FactorizerType;
+      PerformAction(FactorizerType(mit), dataset, rank);
+    }
+    else if (algorithm == "ImplicitALS")
+    {
+      PerformAction(ImplicitALS(maxIterations), dataset, rank);
+    }
     else if (algorithm == "RegSVD")
     {
       Log::Fatal << PRINT_PARAM_STRING("iteration_only_termination") << " not "
@@ -258,6 +298,12 @@ void AssembleFactorizerType(const std::string& algorithm,
           rank);
     else if (algorithm == "SVDCompleteIncremental")
       PerformAction(SparseSVDCompleteIncrementalFactorizer(srt), dataset, rank);
+    else if (algorithm == "SVDParallelIncremental")
+      PerformAction(SVDParallelIncrementalFactorizer(srt), dataset, rank);
+    else if (algorithm == "ParallelALS")
+      PerformAction(ParallelALSFactorizer(srt), dataset, rank);
+    else if (algorithm == "ImplicitALS")
+      PerformAction(ImplicitALS(maxIterations), dataset, rank);
     else if (algorithm == "RegSVD")
       PerformAction(RegularizedSVD<>(maxIterations), dataset, rank);
   }
@@ -283,10 +329,13 @@ void mlpackMain()
     ReportIgnoredParam("output", "no recommendations requested");
 
   RequireParamInSet<string>("algorithm", { "NMF", "BatchSVD",
-      "SVDIncompleteIncremental", "SVDCompleteIncremental", "RegSVD" }, true,
+      "SVDIncompleteIncremental", "SVDCompleteIncremental",
+      "SVDParallelIncremental", "ParallelALS", "ImplicitALS", "RegSVD" }, true,
       "unknown algorithm");
 
   ReportIgnoredParam({{ "iteration_only_termination", true }}, "min_residue");
+  ReportIgnoredParam({{ "query", false }, { "all_user_recommendations", false }},
+      "max_inner_product");
 
   // Either load from a model, or train a model.
   if (CLI::HasParam("training"))
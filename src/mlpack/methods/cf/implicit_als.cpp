@@ -0,0 +1,101 @@
+/**
+ * @file implicit_als.cpp
+ *
+ * Implementation of weighted alternating least squares for implicit feedback.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "implicit_als.hpp"
+
+namespace mlpack {
+namespace cf {
+
+ImplicitALS::ImplicitALS(const size_t maxIterations,
+                         const double alpha,
+                         const double lambda) :
+    maxIterations(maxIterations),
+    alpha(alpha),
+    lambda(lambda)
+{
+  // Nothing to do.
+}
+
+double ImplicitALS::Apply(const arma::sp_mat& V,
+                          const size_t rank,
+                          arma::mat& W,
+                          arma::mat& H) const
+{
+  // The items are solved from the columns of the transposed matrix.
+  const arma::sp_mat vt = V.t();
+
+  // Small random initial factors.
+  W = 0.01 * arma::randu<arma::mat>(V.n_rows, rank);
+  H = 0.01 * arma::randu<arma::mat>(rank, V.n_cols);
+
+  arma::mat wt = W.t();
+  for (size_t i = 0; i < maxIterations; ++i)
+  {
+    Solve(V, wt, H);
+    Solve(vt, H, wt);
+  }
+  W = wt.t();
+
+  // The squared error over all entries is the error of the zero entries
+  // (sum of (w_i^T h_u)^2) plus the corrections of the nonzero entries; the
+  // first part is the sum over all entries minus the nonzero ones, and the
+  // sum over all entries is trace(W^T W H H^T).
+  double error = arma::accu((W.t() * W) % (H * H.t()));
+  for (arma::sp_mat::const_iterator it = V.begin(); it != V.end(); ++it)
+  {
+    const double score = arma::dot(W.row(it.row()), H.col(it.col()));
+    error += (1.0 + alpha * (*it)) * std::pow(1.0 - score, 2.0) -
+        std::pow(score, 2.0);
+  }
+
+  Log::Info << "ImplicitALS::Apply(): weighted squared error after "
+      << maxIterations << " iterations is " << error << "." << std::endl;
+
+  return error;
+}
+
+void ImplicitALS::Solve(const arma::sp_mat& data,
+                        const arma::mat& factors,
+                        arma::mat& output) const
+{
+  // Y^T Y is shared by every column; each column only adds the terms of its
+  // nonzero entries.
+  arma::mat gram = factors * factors.t();
+  gram.diag() += lambda;
+
+  output.set_size(factors.n_rows, data.n_cols);
+
+  #pragma omp parallel for schedule(dynamic, 64)
+  for (omp_size_t j = 0; j < (omp_size_t) data.n_cols; ++j)
+  {
+    const size_t begin = data.col_ptrs[j];
+    const size_t count = data.col_ptrs[j + 1] - begin;
+    const arma::uvec indices(data.row_indices + begin, count);
+    const arma::vec values(data.values + begin, count);
+
+    // A = Y^T Y + Y^T (C_j - I) Y + lambda I, and b = Y^T C_j p_j, where p_j
+    // is 1 exactly on the nonzero entries.
+    const arma::mat observedFactors = factors.cols(indices);
+    const arma::mat a = gram + observedFactors *
+        arma::diagmat(alpha * values) * observedFactors.t();
+    const arma::vec b = observedFactors * (1.0 + alpha * values);
+
+    arma::vec x;
+    if (count == 0)
+      output.col(j).zeros();
+    else if (arma::solve(x, a, b))
+      output.col(j) = x;
+    else
+      output.col(j).zeros();
+  }
+}
+
+} // namespace cf
+} // namespace mlpack
@@ -0,0 +1,132 @@
+/**
+ * @file implicit_als.hpp
+ *
+ * Weighted alternating least squares for implicit feedback, for use as a
+ * factorizer with the CF class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_CF_IMPLICIT_ALS_HPP
+#define MLPACK_METHODS_CF_IMPLICIT_ALS_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/methods/cf/cf.hpp>
+
+namespace mlpack {
+namespace cf {
+
+/**
+ * This class factorizes implicit feedback (such as click or play counts) with
+ * weighted alternating least squares, as described in the following paper:
+ *
+ * @code
+ * @inproceedings{hu2008collaborative,
+ *   title={Collaborative filtering for implicit feedback datasets},
+ *   author={Hu, Y. and Koren, Y. and Volinsky, C.},
+ *   booktitle={Proceedings of the Eighth IEEE International Conference on
+ *       Data Mining (ICDM '08)},
+ *   pages={263--272},
+ *   year={2008}
+ * }
+ * @endcode
+ *
+ * Every (item, user) pair is used: the preference is 1 when the feedback r is
+ * nonzero and 0 otherwise, with a confidence of 1 + alpha * r.  The zero
+ * entries are never stored, though.  To solve for a user with the item
+ * matrix Y held fixed, Y^T Y is computed once per step, and only the user's
+ * nonzero entries add the Y^T (C_u - I) Y correction, so each step costs
+ * O(nnz * rank^2) (plus one rank x rank solve per user and item).  Users (and
+ * items) are solved in parallel with OpenMP.
+ *
+ * The input is the sparse (item, user) matrix that CF builds, so this class can
+ * be used directly as the factorizer of CF:
+ *
+ * @code
+ * extern arma::mat data; // (user, item, count) table.
+ *
+ * CF c(data, ImplicitALS(15, 40.0, 0.1), 5, 20);
+ * @endcode
+ */
+class ImplicitALS
+{
+ public:
+  /**
+   * Create the ImplicitALS object with the given parameters.
+   *
+   * @param maxIterations Number of alternating steps (each of which solves
+   *     both W and H).
+   * @param alpha Confidence scaling of the nonzero feedback.
+   * @param lambda Regularization constant for W and H.
+   */
+  ImplicitALS(const size_t maxIterations = 15,
+              const double alpha = 40.0,
+              const double lambda = 0.1);
+
+  /**
+   * Factorize the given (item, user) feedback matrix V into W * H.  The
+   * returned value is the (unregularized) weighted squared error of the
+   * factorization over all entries of V.
+   *
+   * @param V Sparse feedback matrix; items are rows and users are columns.
+   * @param rank Rank of the factorization.
+   * @param W Item matrix to output (V.n_rows x rank).
+   * @param H User matrix to output (rank x V.n_cols).
+   */
+  double Apply(const arma::sp_mat& V,
+               const size_t rank,
+               arma::mat& W,
+               arma::mat& H) const;
+
+  //! Get the number of alternating steps.
+  size_t MaxIterations() const { return maxIterations; }
+  //! Modify the number of alternating steps.
+  size_t& MaxIterations() { return maxIterations; }
+
+  //! Get the confidence scaling.
+  double Alpha() const { return alpha; }
+  //! Modify the confidence scaling.
+  double& Alpha() { return alpha; }
+
+  //! Get the regularization constant.
+  double Lambda() const { return lambda; }
+  //! Modify the regularization constant.
+  double& Lambda() { return lambda; }
+
+ private:
+  /**
+   * Solve for every column of the output, given the fixed factors.  Column j
+   * of data holds the feedback of entity j, indexed by the columns of
+   * factors.
+   *
+   * @param data Sparse feedback; one column per entity to solve.
+   * @param factors Fixed factors; one column per row of data.
+   * @param output Solved factors; one column per column of data.
+   */
+  void Solve(const arma::sp_mat& data,
+             const arma::mat& factors,
+             arma::mat& output) const;
+
+  //! Number of alternating steps.
+  size_t maxIterations;
+  //! Confidence scaling.
+  double alpha;
+  //! Regularization constant.
+  double lambda;
+};
+
+//! Factorizer traits of ImplicitALS.
+template<>
+class FactorizerTraits<ImplicitALS>
+{
+ public:
+  //! ImplicitALS works on the cleaned sparse (item, user) matrix.
+  static const bool UsesCoordinateList = false;
+};
+
+} // namespace cf
+} // namespace mlpack
+
+#endif
@@ -15,7 +15,7 @@
 
 #include <mlpack/core.hpp>
 #include <mlpack/methods/range_search/range_search.hpp>
-#include <mlpack/methods/emst/union_find.hpp>
+#include <mlpack/methods/emst/concurrent_union_find.hpp>
 #include "random_point_selection.hpp"
 #include <boost/dynamic_bitset.hpp>
 
@@ -43,6 +43,13 @@ namespace dbscan {
  * range search technique used and the point selection strategy by means of
  * template parameters.
  *
+ * The neighbors of the points are merged into the clusters with a lock-free
+ * union-find structure (emst::ConcurrentUnionFind), in parallel with OpenMP.
+ * In batch mode, the range search can be done for blocks of BatchSize() query
+ * points at a time instead of for the whole dataset at once, so that only the
+ * neighborhoods of one block are held in memory; this is useful for very large
+ * datasets, where the neighborhoods of all the points may not fit in memory.
+ *
  * @tparam RangeSearchType Class to use for range searching.
  * @tparam PointSelectionPolicy Strategy for selecting next point to cluster
  *      with.
@@ -111,6 +118,13 @@ class DBSCAN
                  arma::Row<size_t>& assignments,
                  arma::mat& centroids);
 
+  //! Get the number of query points searched at once in batch mode (0 means
+  //! all of them).
+  size_t BatchSize() const { return batchSize; }
+  //! Modify the number of query points searched at once in batch mode (0
+  //! means all of them).
+  size_t& BatchSize() { return batchSize; }
+
  private:
   //! Maximum distance between two points to be part of same cluster.
   double epsilon;
@@ -122,6 +136,10 @@ class DBSCAN
   //! Whether or not to perform the search in batch mode.  If false, single
   bool batchMode;
 
+  //! The number of query points searched at once in batch mode (0 means all
+  //! of them).
+  size_t batchSize;
+
   //! Instantiated range search policy.
   RangeSearchType rangeSearch;
 
@@ -140,7 +158,7 @@ class DBSCAN
    */
   template<typename MatType>
   void PointwiseCluster(const MatType& data,
-                        emst::UnionFind& uf);
+                        emst::ConcurrentUnionFind& uf);
 
   /**
    * Performs DBSCAN clustering on the data, returning number of clusters
@@ -153,7 +171,18 @@ class DBSCAN
    */
   template<typename MatType>
   void BatchCluster(const MatType& data,
-                    emst::UnionFind& uf);
+                    emst::ConcurrentUnionFind& uf);
+
+  /**
+   * Union each of the given points with its neighbors, in parallel.
+   *
+   * @param begin Index of the first point.
+   * @param neighbors Neighbors of each point, starting with point begin.
+   * @param uf UnionFind structure that will be modified.
+   */
+  void UnionNeighbors(const size_t begin,
+                      const std::vector<std::vector<size_t>>& neighbors,
+                      emst::ConcurrentUnionFind& uf);
 };
 
 } // namespace dbscan
@@ -30,6 +30,7 @@ DBSCAN<RangeSearchType, PointSelectionPolicy>::DBSCAN(
     epsilon(epsilon),
     minPoints(minPoints),
     batchMode(batchMode),
+    batchSize(0),
     rangeSearch(rangeSearch),
     pointSelector(pointSelector)
 {
@@ -101,7 +102,7 @@ size_t DBSCAN<RangeSearchType, PointSelectionPolicy>::Cluster(
     arma::Row<size_t>& assignments)
 {
   // Initialize the UnionFind object.
-  emst::UnionFind uf(data.n_cols);
+  emst::ConcurrentUnionFind uf(data.n_cols);
   rangeSearch.Train(data);
 
   if (batchMode)
@@ -111,7 +112,8 @@ size_t DBSCAN<RangeSearchType, PointSelectionPolicy>::Cluster(
 
   // Now set assignments.
   assignments.set_size(data.n_cols);
-  for (size_t i = 0; i < data.n_cols; ++i)
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) data.n_cols; ++i)
     assignments[i] = uf.Find(i);
 
   // Get a count of all clusters.
@@ -150,7 +152,7 @@ template<typename RangeSearchType, typename PointSelectionPolicy>
 template<typename MatType>
 void DBSCAN<RangeSearchType, PointSelectionPolicy>::PointwiseCluster(
     const MatType& data,
-    emst::UnionFind& uf)
+    emst::ConcurrentUnionFind& uf)
 {
   std::vector<std::vector<size_t>> neighbors;
   std::vector<std::vector<double>> distances;
@@ -179,22 +181,50 @@ template<typename RangeSearchType, typename PointSelectionPolicy>
 template<typename MatType>
 void DBSCAN<RangeSearchType, PointSelectionPolicy>::BatchCluster(
     const MatType& data,
-    emst::UnionFind& uf)
+    emst::ConcurrentUnionFind& uf)
 {
   // For each point, find the points in epsilon-nighborhood and their distances.
+  // The reference tree was already built by Cluster().
   std::vector<std::vector<size_t>> neighbors;
   std::vector<std::vector<double>> distances;
   Log::Info << "Performing range search." << std::endl;
-  rangeSearch.Train(data);
-  rangeSearch.Search(data, math::Range(0.0, epsilon), neighbors, distances);
+  if (batchSize == 0 || batchSize >= data.n_cols)
+  {
+    rangeSearch.Search(math::Range(0.0, epsilon), neighbors, distances);
+    UnionNeighbors(0, neighbors, uf);
+  }
+  else
+  {
+    // Search one block of query points at a time, so that only the
+    // neighborhoods of that block are held in memory.
+    for (size_t begin = 0; begin < data.n_cols; begin += batchSize)
+    {
+      const size_t end = std::min(begin + batchSize, (size_t) data.n_cols) - 1;
+      const MatType block(data.cols(begin, end));
+      rangeSearch.Search(block, math::Range(0.0, epsilon), neighbors,
+          distances);
+      UnionNeighbors(begin, neighbors, uf);
+    }
+  }
   Log::Info << "Range search complete." << std::endl;
+}
 
-  // Now loop over all points.
-  for (size_t i = 0; i < data.n_cols; ++i)
+/**
+ * Union each of the given points with its neighbors, in parallel.
+ */
+template<typename RangeSearchType, typename PointSelectionPolicy>
+void DBSCAN<RangeSearchType, PointSelectionPolicy>::UnionNeighbors(
+    const size_t begin,
+    const std::vector<std::vector<size_t>>& neighbors,
+    emst::ConcurrentUnionFind& uf)
+{
+  // Neighborhoods can be very unbalanced, so the points are handed out
+  // dynamically.
+  #pragma omp parallel for schedule(dynamic, 256)
+  for (omp_size_t i = 0; i < (omp_size_t) neighbors.size(); ++i)
   {
-    // Union to all neighbors.
     for (size_t j = 0; j < neighbors[i].size(); ++j)
-      uf.Union(i, neighbors[i][j]);
+      uf.Union(begin + i, neighbors[i][j]);
   }
 }
 
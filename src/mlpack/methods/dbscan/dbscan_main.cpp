@@ -76,6 +76,9 @@ PARAM_FLAG("single_mode", "If set, single-tree range search (not dual-tree) "
     "will be used.", "S");
 PARAM_FLAG("naive", "If set, brute-force range search (not tree-based) "
     "will be used.", "N");
+PARAM_INT_IN("batch_size", "If nonzero, the range search is done for this "
+    "many points at a time, which bounds the memory used for the "
+    "neighborhoods.", "b", 0);
 
 // Actually run the clustering, and process the output.
 template<typename RangeSearchType>
@@ -92,6 +95,7 @@ void RunDBSCAN(RangeSearchType rs = RangeSearchType())
 
   DBSCAN<RangeSearchType> d(epsilon, minSize, !CLI::HasParam("single_mode"),
       rs);
+  d.BatchSize() = (size_t) CLI::GetParam<int>("batch_size");
 
   // If possible, avoid the overhead of calculating centroids.
   arma::Row<size_t> assignments;
@@ -114,6 +118,8 @@ void RunDBSCAN(RangeSearchType rs = RangeSearchType())
 
 void mlpackMain()
 {
+  RequireParamValue<int>("batch_size", [](int x) { return x >= 0; }, true,
+      "batch size must be nonnegative");
   RequireAtLeastOnePassed({ "assignments", "centroids" }, false,
       "no output will be saved");
 
@@ -14,6 +14,7 @@
 #define MLPACK_METHODS_DECISION_TREE_ALL_CATEGORICAL_SPLIT_HPP
 
 #include <mlpack/prereqs.hpp>
+#include "split_traits.hpp"
 
 namespace mlpack {
 namespace tree {
@@ -87,6 +88,19 @@ class AllCategoricalSplit
       const AuxiliarySplitInfo<ElemType>& /* aux */);
 };
 
+/**
+ * Specialization of SplitTraits for AllCategoricalSplit.
+ */
+template<typename FitnessFunction>
+class SplitTraits<AllCategoricalSplit<FitnessFunction>>
+{
+ public:
+  //! The categorical split is not a threshold.
+  static const bool IsThresholdSplit = false;
+  //! The categorical split has a child for each category.
+  static const bool IsValueSplit = true;
+};
+
 } // namespace tree
 } // namespace mlpack
 
@@ -13,6 +13,7 @@
 #define MLPACK_METHODS_DECISION_TREE_BEST_BINARY_NUMERIC_SPLIT_HPP
 
 #include <mlpack/prereqs.hpp>
+#include "split_traits.hpp"
 
 namespace mlpack {
 namespace tree {
@@ -85,6 +86,19 @@ class BestBinaryNumericSplit
       const AuxiliarySplitInfo<ElemType>& /* aux */);
 };
 
+/**
+ * Specialization of SplitTraits for BestBinaryNumericSplit.
+ */
+template<typename FitnessFunction>
+class SplitTraits<BestBinaryNumericSplit<FitnessFunction>>
+{
+ public:
+  //! The best binary numeric split is a threshold on the split dimension.
+  static const bool IsThresholdSplit = true;
+  //! The child of a point is not given by its value.
+  static const bool IsValueSplit = false;
+};
+
 } // namespace tree
 } // namespace mlpack
 
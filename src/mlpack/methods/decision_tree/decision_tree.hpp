@@ -322,6 +322,21 @@ class DecisionTree :
   //! Modify the child of the given index (be careful!).
   DecisionTree& Child(const size_t i) { return *children[i]; }
 
+  //! Get the dimension this node splits on (if it is not a leaf).
+  size_t SplitDimension() const { return splitDimension; }
+
+  //! Get the type of the dimension this node splits on (if it is not a leaf).
+  data::Datatype SplitDimensionType() const
+  {
+    return (data::Datatype) dimensionTypeOrMajorityClass;
+  }
+
+  /**
+   * Get the class probabilities of this node if it is a leaf; otherwise, this
+   * holds the split information that is used by CalculateDirection().
+   */
+  const arma::vec& ClassProbabilities() const { return classProbabilities; }
+
   /**
    * Given a point and that this node is not a leaf, calculate the index of the
    * child node this point would go towards.  This method is primarily used by
@@ -415,6 +430,69 @@ class DecisionTree :
              const size_t numClasses,
              arma::rowvec& weights,
              const size_t minimumLeafSize = 10);
+
+  /**
+   * Find the best split of the points of this node among the given dimensions,
+   * and store its information in this node.  When mlpack is compiled with
+   * OpenMP, the dimensions of large nodes are searched in parallel; the result
+   * is the same as the one of a serial search.
+   *
+   * @param data Dataset to train on.
+   * @param begin Index of the starting point in the dataset that belongs to
+   *      this node.
+   * @param count Number of points in this node.
+   * @param datasetInfo Type information for each dimension (NULL if all the
+   *      dimensions are numeric).
+   * @param dimensions Dimensions to search, in order.
+   * @param labels Labels for each training point.
+   * @param numClasses Number of classes in the dataset.
+   * @param weights Weights of the points (if UseWeights is true).
+   * @param minimumLeafSize Minimum number of points in each leaf node.
+   * @param bestGain Gain without a split; it is set to the gain of the best
+   *      split.
+   * @return Index (in dimensions) of the best dimension, or dimensions.size()
+   *      if no split improves the gain.
+   */
+  template<bool UseWeights, typename MatType>
+  size_t FindBestSplit(const MatType& data,
+                       const size_t begin,
+                       const size_t count,
+                       const data::DatasetInfo* datasetInfo,
+                       const std::vector<size_t>& dimensions,
+                       const arma::Row<size_t>& labels,
+                       const size_t numClasses,
+                       const arma::rowvec& weights,
+                       const size_t minimumLeafSize,
+                       double& bestGain);
+
+  /**
+   * Reorder the points of this node so that the points of each child are
+   * together, and store the index of the first point of each child (and the
+   * end of the points of the last child) in childBegins.
+   */
+  template<bool UseWeights, typename MatType>
+  void SplitPoints(MatType& data,
+                   const size_t begin,
+                   const size_t count,
+                   arma::Row<size_t>& labels,
+                   arma::rowvec& weights,
+                   const size_t numChildren,
+                   arma::Row<size_t>& childAssignments,
+                   std::vector<size_t>& childBegins);
+
+  /**
+   * Build the children of this node on the given ranges of points.  When
+   * mlpack is compiled with OpenMP, the children of large nodes are built as
+   * parallel tasks.
+   */
+  template<bool UseWeights, typename MatType>
+  void TrainChildren(MatType& data,
+                     const std::vector<size_t>& childBegins,
+                     const data::DatasetInfo* datasetInfo,
+                     arma::Row<size_t>& labels,
+                     const size_t numClasses,
+                     arma::rowvec& weights,
+                     const size_t minimumLeafSize);
 };
 
 /**
@@ -12,6 +12,10 @@
 #ifndef MLPACK_METHODS_DECISION_TREE_DECISION_TREE_IMPL_HPP
 #define MLPACK_METHODS_DECISION_TREE_DECISION_TREE_IMPL_HPP
 
+#ifdef HAS_OPENMP
+  #include <omp.h>
+#endif
+
 namespace mlpack {
 namespace tree {
 
@@ -540,48 +544,26 @@ void DecisionTree<FitnessFunction,
       labels.subvec(begin, begin + count - 1),
       numClasses,
       UseWeights ? weights.subvec(begin, begin + count - 1) : weights);
-  size_t bestDim = datasetInfo.Dimensionality(); // This means "no split".
-  DimensionSelectionType dimensions(datasetInfo.Dimensionality());
-  for (size_t i = dimensions.Begin(); i != dimensions.End();
-       i = dimensions.Next())
-  {
-    double dimGain = -DBL_MAX;
-    if (datasetInfo.Type(i) == data::Datatype::categorical)
-    {
-      dimGain = CategoricalSplit::template SplitIfBetter<UseWeights>(bestGain,
-          data.cols(begin, begin + count - 1).row(i),
-          datasetInfo.NumMappings(i),
-          labels.subvec(begin, begin + count - 1),
-          numClasses,
-          UseWeights ? weights.subvec(begin, begin + count - 1) : weights,
-          minimumLeafSize,
-          classProbabilities,
-          *this);
-    }
-    else if (datasetInfo.Type(i) == data::Datatype::numeric)
-    {
-      dimGain = NumericSplit::template SplitIfBetter<UseWeights>(bestGain,
-          data.cols(begin, begin + count - 1).row(i),
-          labels.subvec(begin, begin + count - 1),
-          numClasses,
-          UseWeights ? weights.subvec(begin, begin + count - 1) : weights,
-          minimumLeafSize,
-          classProbabilities,
-          *this);
-    }
-
-    // Was there an improvement?  If so mark that it's the new best dimension.
-    if (dimGain > bestGain)
-    {
-      bestDim = i;
-      bestGain = dimGain;
-    }
 
-    // If the gain is the best possible, no need to keep looking.
-    if (bestGain >= 0.0)
-      break;
+  // The dimension selection may be random, and the random number generator
+  // isn't thread-safe, so only one node (of any tree) selects its dimensions
+  // at a time.
+  std::vector<size_t> dimensions;
+  #pragma omp critical(DecisionTreeDimensionSelection)
+  {
+    DimensionSelectionType selection(datasetInfo.Dimensionality());
+    for (size_t i = selection.Begin(); i != selection.End();
+         i = selection.Next())
+      dimensions.push_back(i);
   }
 
+  const size_t bestIndex = FindBestSplit<UseWeights>(data, begin, count,
+      &datasetInfo, dimensions, labels, numClasses, weights, minimumLeafSize,
+      bestGain);
+  // datasetInfo.Dimensionality() means "no split".
+  const size_t bestDim = (bestIndex == dimensions.size()) ?
+      datasetInfo.Dimensionality() : dimensions[bestIndex];
+
   // Did we split or not?  If so, then split the data and create the children.
   if (bestDim != datasetInfo.Dimensionality())
   {
@@ -612,45 +594,12 @@ void DecisionTree<FitnessFunction,
       }
     }
 
-    // Figure out counts of children.
-    arma::Row<size_t> childCounts(numClasses, arma::fill::zeros);
-    for (size_t i = begin; i < begin + count; ++i)
-      childCounts[childAssignments[i - begin]]++;
-
-    // Split into children.
-    size_t currentCol = begin;
-    for (size_t i = 0; i < numChildren; ++i)
-    {
-      size_t currentChildBegin = currentCol;
-      for (size_t j = currentChildBegin; j < begin + count; ++j)
-      {
-        if (childAssignments[j - begin] == i)
-        {
-          childAssignments.swap_cols(currentCol - begin, j - begin);
-          data.swap_cols(currentCol, j);
-          labels.swap_cols(currentCol, j);
-          if (UseWeights)
-            weights.swap_cols(currentCol, j);
-          ++currentCol;
-        }
-      }
-
-      // Now build the child recursively.
-      DecisionTree* child = new DecisionTree();
-      if (NoRecursion)
-      {
-        child->Train<UseWeights>(data, currentChildBegin,
-            currentCol - currentChildBegin, datasetInfo, labels, numClasses,
-            weights, currentCol - currentChildBegin);
-      }
-      else
-      {
-        child->Train<UseWeights>(data, currentChildBegin,
-            currentCol - currentChildBegin, datasetInfo, labels, numClasses,
-            weights, minimumLeafSize);
-      }
-      children.push_back(child);
-    }
+    // Split into children, and build them.
+    std::vector<size_t> childBegins;
+    SplitPoints<UseWeights>(data, begin, count, labels, weights, numChildren,
+        childAssignments, childBegins);
+    TrainChildren<UseWeights>(data, childBegins, &datasetInfo, labels,
+        numClasses, weights, minimumLeafSize);
   }
   else
   {
@@ -704,31 +653,13 @@ void DecisionTree<FitnessFunction,
       labels.subvec(begin, begin + count - 1),
       numClasses,
       UseWeights ? weights.subvec(begin, begin + count - 1) : weights);
-  size_t bestDim = data.n_rows; // This means "no split".
+  std::vector<size_t> dimensions(data.n_rows);
   for (size_t i = 0; i < data.n_rows; ++i)
-  {
-    const double dimGain = NumericSplitType<FitnessFunction>::template
-        SplitIfBetter<UseWeights>(bestGain,
-                                  data.cols(begin, begin + count - 1).row(i),
-                                  labels.cols(begin, begin + count - 1),
-                                  numClasses,
-                                  UseWeights ?
-                                      weights.cols(begin, begin + count - 1) :
-                                      weights,
-                                  minimumLeafSize,
-                                  classProbabilities,
-                                  *this);
-
-    if (dimGain > bestGain)
-    {
-      bestDim = i;
-      bestGain = dimGain;
-    }
+    dimensions[i] = i;
 
-    // If the gain is the best possible, no need to keep looking.
-    if (bestGain >= 0.0)
-      break;
-  }
+  // data.n_rows means "no split".
+  const size_t bestDim = FindBestSplit<UseWeights>(data, begin, count, NULL,
+      dimensions, labels, numClasses, weights, minimumLeafSize, bestGain);
 
   // Did we split or not?  If so, then split the data and create the children.
   if (bestDim != data.n_rows)
@@ -747,56 +678,275 @@ void DecisionTree<FitnessFunction,
           data(bestDim, j), classProbabilities, *this);
     }
 
-    // Calculate counts of children in each node.
-    arma::Row<size_t> childCounts(numChildren);
-    childCounts.zeros();
-    for (size_t j = begin; j < begin + count; ++j)
-      childCounts[childAssignments[j - begin]]++;
+    // Split into children, and build them.
+    std::vector<size_t> childBegins;
+    SplitPoints<UseWeights>(data, begin, count, labels, weights, numChildren,
+        childAssignments, childBegins);
+    TrainChildren<UseWeights>(data, childBegins, NULL, labels, numClasses,
+        weights, minimumLeafSize);
+  }
+  else
+  {
+    // We won't be needing these members, so reset them.
+    NumericAuxiliarySplitInfo::operator=(NumericAuxiliarySplitInfo());
 
-    size_t currentCol = begin;
-    for (size_t i = 0; i < numChildren; ++i)
+    // Calculate class probabilities because we are a leaf.
+    CalculateClassProbabilities<UseWeights>(
+        labels.subvec(begin, begin + count - 1),
+        numClasses,
+        UseWeights ? weights.subvec(begin, begin + count - 1) : weights);
+  }
+}
+
+//! Find the best split among the given dimensions.
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         typename DimensionSelectionType,
+         typename ElemType,
+         bool NoRecursion>
+template<bool UseWeights, typename MatType>
+size_t DecisionTree<FitnessFunction,
+             NumericSplitType,
+             CategoricalSplitType,
+             DimensionSelectionType,
+             ElemType,
+             NoRecursion>::FindBestSplit(
+    const MatType& data,
+    const size_t begin,
+    const size_t count,
+    const data::DatasetInfo* datasetInfo,
+    const std::vector<size_t>& dimensions,
+    const arma::Row<size_t>& labels,
+    const size_t numClasses,
+    const arma::rowvec& weights,
+    const size_t minimumLeafSize,
+    double& bestGain)
+{
+  // All gains of at least 0 are perfect, and the first perfect dimension is
+  // taken (like the first dimension with the best gain), so that the result
+  // doesn't depend on the number of threads.
+  size_t bestIndex = dimensions.size();
+  const double nodeGain = bestGain;
+
+  // Searching the dimensions of small nodes in parallel isn't worth it.
+  #pragma omp parallel if (dimensions.size() > 1 && count >= 1000)
+  {
+    double threadGain = nodeGain;
+    size_t threadIndex = dimensions.size();
+    arma::vec threadProbabilities;
+    NumericAuxiliarySplitInfo threadNumericAux;
+    CategoricalAuxiliarySplitInfo threadCategoricalAux;
+
+    #pragma omp for schedule(dynamic)
+    for (omp_size_t j = 0; j < (omp_size_t) dimensions.size(); ++j)
     {
-      size_t currentChildBegin = currentCol;
-      for (size_t j = currentChildBegin; j < begin + count; ++j)
+      // If the gain is the best possible, no need to keep looking.
+      if (threadGain >= 0.0)
+        continue;
+
+      const size_t i = dimensions[j];
+      double dimGain = -DBL_MAX;
+      if (datasetInfo &&
+          datasetInfo->Type(i) == data::Datatype::categorical)
       {
-        if (childAssignments[j - begin] == i)
-        {
-          childAssignments.swap_cols(currentCol - begin, j - begin);
-          data.swap_cols(currentCol, j);
-          labels.swap_cols(currentCol, j);
-          if (UseWeights)
-            weights.swap_cols(currentCol, j);
-          ++currentCol;
-        }
+        dimGain = CategoricalSplit::template SplitIfBetter<UseWeights>(
+            threadGain,
+            data.cols(begin, begin + count - 1).row(i),
+            datasetInfo->NumMappings(i),
+            labels.subvec(begin, begin + count - 1),
+            numClasses,
+            UseWeights ? weights.subvec(begin, begin + count - 1) : weights,
+            minimumLeafSize,
+            threadProbabilities,
+            threadCategoricalAux);
+      }
+      else if (!datasetInfo ||
+          datasetInfo->Type(i) == data::Datatype::numeric)
+      {
+        dimGain = NumericSplit::template SplitIfBetter<UseWeights>(
+            threadGain,
+            data.cols(begin, begin + count - 1).row(i),
+            labels.subvec(begin, begin + count - 1),
+            numClasses,
+            UseWeights ? weights.subvec(begin, begin + count - 1) : weights,
+            minimumLeafSize,
+            threadProbabilities,
+            threadNumericAux);
       }
 
-      // Now build the child recursively.
-      DecisionTree* child = new DecisionTree();
-      if (NoRecursion)
+      // Was there an improvement?  If so mark that it's the new best
+      // dimension.
+      if (dimGain > threadGain)
       {
-        child->Train<UseWeights>(data, currentChildBegin,
-            currentCol - currentChildBegin, labels, numClasses, weights,
-            currentCol - currentChildBegin);
+        threadIndex = j;
+        threadGain = dimGain;
       }
-      else
+    }
+
+    #pragma omp critical(DecisionTreeBestSplit)
+    {
+      const double gain = std::min(threadGain, 0.0);
+      const double best = std::min(bestGain, 0.0);
+      if (threadIndex != dimensions.size() && (gain > best ||
+          (gain == best && threadIndex < bestIndex)))
       {
-        child->Train<UseWeights>(data, currentChildBegin,
-            currentCol - currentChildBegin, labels, numClasses, weights,
-            minimumLeafSize);
+        bestGain = threadGain;
+        bestIndex = threadIndex;
+        classProbabilities = std::move(threadProbabilities);
+        NumericAuxiliarySplitInfo::operator=(std::move(threadNumericAux));
+        CategoricalAuxiliarySplitInfo::operator=(
+            std::move(threadCategoricalAux));
       }
-      children.push_back(child);
     }
   }
-  else
+
+  return bestIndex;
+}
+
+//! Move the points of each child together.
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         typename DimensionSelectionType,
+         typename ElemType,
+         bool NoRecursion>
+template<bool UseWeights, typename MatType>
+void DecisionTree<FitnessFunction,
+             NumericSplitType,
+             CategoricalSplitType,
+             DimensionSelectionType,
+             ElemType,
+             NoRecursion>::SplitPoints(
+    MatType& data,
+    const size_t begin,
+    const size_t count,
+    arma::Row<size_t>& labels,
+    arma::rowvec& weights,
+    const size_t numChildren,
+    arma::Row<size_t>& childAssignments,
+    std::vector<size_t>& childBegins)
+{
+  childBegins.resize(numChildren + 1);
+  size_t currentCol = begin;
+  for (size_t i = 0; i < numChildren; ++i)
   {
-    // We won't be needing these members, so reset them.
-    NumericAuxiliarySplitInfo::operator=(NumericAuxiliarySplitInfo());
+    childBegins[i] = currentCol;
+    for (size_t j = currentCol; j < begin + count; ++j)
+    {
+      if (childAssignments[j - begin] == i)
+      {
+        childAssignments.swap_cols(currentCol - begin, j - begin);
+        data.swap_cols(currentCol, j);
+        labels.swap_cols(currentCol, j);
+        if (UseWeights)
+          weights.swap_cols(currentCol, j);
+        ++currentCol;
+      }
+    }
+  }
+  childBegins[numChildren] = currentCol;
+}
 
-    // Calculate class probabilities because we are a leaf.
-    CalculateClassProbabilities<UseWeights>(
-        labels.subvec(begin, begin + count - 1),
-        numClasses,
-        UseWeights ? weights.subvec(begin, begin + count - 1) : weights);
+//! Build the children of this node.
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         typename DimensionSelectionType,
+         typename ElemType,
+         bool NoRecursion>
+template<bool UseWeights, typename MatType>
+void DecisionTree<FitnessFunction,
+             NumericSplitType,
+             CategoricalSplitType,
+             DimensionSelectionType,
+             ElemType,
+             NoRecursion>::TrainChildren(
+    MatType& data,
+    const std::vector<size_t>& childBegins,
+    const data::DatasetInfo* datasetInfo,
+    arma::Row<size_t>& labels,
+    const size_t numClasses,
+    arma::rowvec& weights,
+    const size_t minimumLeafSize)
+{
+  // The children may be made already, if this is called again to start the
+  // threads.
+  const size_t numChildren = childBegins.size() - 1;
+  if (children.size() != numChildren)
+  {
+    for (size_t i = 0; i < numChildren; ++i)
+      children.push_back(new DecisionTree());
+  }
+
+#if defined(HAS_OPENMP) && (_OPENMP >= 200805)
+  // The children hold disjoint sets of points, so they can be built at the
+  // same time.  OpenMP tasks are used, so that the children of the children
+  // can also be built in parallel, and so that the threads of an enclosing
+  // parallel loop (like the one over the trees of a RandomForest) that are
+  // done with their own work can help.  Small nodes aren't worth a task.
+  if (!NoRecursion && childBegins[numChildren] - childBegins[0] >= 1000)
+  {
+    if (!omp_in_parallel())
+    {
+      // This is the first node that is built in parallel, so start the
+      // threads.
+      #pragma omp parallel
+      {
+        #pragma omp single
+        TrainChildren<UseWeights>(data, childBegins, datasetInfo, labels,
+            numClasses, weights, minimumLeafSize);
+      }
+      return;
+    }
+
+    // The tasks get copies of the local variables, so use pointers.
+    MatType* dataPtr = &data;
+    arma::Row<size_t>* labelsPtr = &labels;
+    arma::rowvec* weightsPtr = &weights;
+    for (size_t i = 0; i < numChildren; ++i)
+    {
+      DecisionTree* child = children[i];
+      const size_t childBegin = childBegins[i];
+      const size_t childCount = childBegins[i + 1] - childBegins[i];
+
+      #pragma omp task
+      {
+        if (datasetInfo)
+        {
+          child->Train<UseWeights>(*dataPtr, childBegin, childCount,
+              *datasetInfo, *labelsPtr, numClasses, *weightsPtr,
+              minimumLeafSize);
+        }
+        else
+        {
+          child->Train<UseWeights>(*dataPtr, childBegin, childCount,
+              *labelsPtr, numClasses, *weightsPtr, minimumLeafSize);
+        }
+      }
+    }
+
+    #pragma omp taskwait
+    return;
+  }
+#endif
+
+  for (size_t i = 0; i < numChildren; ++i)
+  {
+    const size_t childBegin = childBegins[i];
+    const size_t childCount = childBegins[i + 1] - childBegins[i];
+    // A decision stump doesn't split its children.
+    const size_t childLeafSize = NoRecursion ? childCount : minimumLeafSize;
+    if (datasetInfo)
+    {
+      children[i]->Train<UseWeights>(data, childBegin, childCount,
+          *datasetInfo, labels, numClasses, weights, childLeafSize);
+    }
+    else
+    {
+      children[i]->Train<UseWeights>(data, childBegin, childCount, labels,
+          numClasses, weights, childLeafSize);
+    }
   }
 }
 
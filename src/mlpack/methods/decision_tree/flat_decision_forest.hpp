@@ -0,0 +1,187 @@
+/**
+ * @file flat_decision_forest.hpp
+ *
+ * Definition of the FlatDecisionForest class, which packs trained decision
+ * trees into contiguous node tables for fast prediction.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_DECISION_TREE_FLAT_DECISION_FOREST_HPP
+#define MLPACK_METHODS_DECISION_TREE_FLAT_DECISION_FOREST_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "decision_tree.hpp"
+#include "split_traits.hpp"
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * A FlatDecisionForest is a read-only copy of one or more trained decision
+ * trees that is laid out for fast prediction.  The nodes of all trees are
+ * stored in one table, as separate arrays of split dimensions, thresholds,
+ * types, and child offsets; the children of a node are stored next to each
+ * other, in breadth-first order, and the class probabilities of the leaves are
+ * the columns of one matrix.  So a point walks down a tree by indexing into a
+ * few flat arrays, instead of following a pointer to a separately allocated
+ * node at each level.
+ *
+ * The predictions are the same as the ones of the trees: for one tree, they are
+ * the ones of DecisionTree::Classify(), and for several trees, the class
+ * probabilities are averaged like in RandomForest::Classify().  When a set of
+ * points is classified, the points are taken in batches, and each tree is
+ * applied to the whole batch before the next one, so that the nodes near the
+ * root stay in the cache; batches are classified in parallel with OpenMP.
+ *
+ * The splits of the numeric and categorical split types are evaluated directly
+ * when SplitTraits says how (this is the case for BestBinaryNumericSplit,
+ * HistogramNumericSplit, and AllCategoricalSplit).  For other split types, the
+ * node of the original tree is kept and its CalculateDirection() is called; in
+ * that case, the original trees must outlive the FlatDecisionForest.
+ *
+ * @code
+ * DecisionTree<> tree(data, labels, numClasses);
+ * FlatDecisionForest<> flatTree(tree);
+ * flatTree.Classify(points, predictions, probabilities);
+ *
+ * RandomForest<> forest(data, labels, numClasses);
+ * FlatDecisionForest<RandomForest<>::DecisionTreeType> flatForest =
+ *     forest.Flatten();
+ * @endcode
+ *
+ * @tparam TreeType Type of the decision trees.
+ */
+template<typename TreeType = DecisionTree<>>
+class FlatDecisionForest
+{
+ public:
+  /**
+   * Create an empty forest.  Trees can be added with Add().
+   */
+  FlatDecisionForest();
+
+  /**
+   * Create a forest holding the given tree.
+   *
+   * @param tree Trained decision tree.
+   */
+  FlatDecisionForest(const TreeType& tree);
+
+  /**
+   * Add the given tree to the forest.  It must have the same number of classes
+   * as the trees that are already in the forest; otherwise,
+   * std::invalid_argument is thrown.
+   *
+   * @param tree Trained decision tree.
+   */
+  void Add(const TreeType& tree);
+
+  /**
+   * Predict the class of the given point.  If the forest is empty, this will
+   * throw an exception.
+   *
+   * @param point Point to be classified.
+   */
+  template<typename VecType>
+  size_t Classify(const VecType& point) const;
+
+  /**
+   * Predict the class of the given point and return the predicted class
+   * probabilities for each class.  If the forest is empty, this will throw an
+   * exception.
+   *
+   * @param point Point to be classified.
+   * @param prediction size_t to store predicted class in.
+   * @param probabilities Output vector of class probabilities.
+   */
+  template<typename VecType>
+  void Classify(const VecType& point,
+                size_t& prediction,
+                arma::vec& probabilities) const;
+
+  /**
+   * Predict the classes of each point in the given dataset.  If the forest is
+   * empty, this will throw an exception.
+   *
+   * @param data Dataset to be classified.
+   * @param predictions Output predictions for each point in the dataset.
+   */
+  template<typename MatType>
+  void Classify(const MatType& data,
+                arma::Row<size_t>& predictions) const;
+
+  /**
+   * Predict the classes of each point in the given dataset, also returning the
+   * predicted class probabilities for each point.  If the forest is empty, this
+   * will throw an exception.
+   *
+   * @param data Dataset to be classified.
+   * @param predictions Output predictions for each point in the dataset.
+   * @param probabilities Output matrix of class probabilities for each point.
+   */
+  template<typename MatType>
+  void Classify(const MatType& data,
+                arma::Row<size_t>& predictions,
+                arma::mat& probabilities) const;
+
+  //! Get the number of trees in the forest.
+  size_t NumTrees() const { return roots.size(); }
+  //! Get the number of nodes of all trees in the forest.
+  size_t NumNodes() const { return types.size(); }
+  //! Get the number of leaves of all trees in the forest.
+  size_t NumLeaves() const { return leafProbabilities.n_cols; }
+  //! Get the number of classes.
+  size_t NumClasses() const { return leafProbabilities.n_rows; }
+
+ private:
+  //! The ways a node can send a point to its children.
+  enum NodeType
+  {
+    //! The node is a leaf.
+    LEAF,
+    //! Go to the first child if the value is at most the threshold.
+    THRESHOLD,
+    //! Go to the child given by the value.
+    VALUE,
+    //! Call CalculateDirection() on the original node.
+    OTHER
+  };
+
+  /**
+   * Find the leaf of the given tree that the given point falls into, and return
+   * its index (the column of leafProbabilities).
+   */
+  template<typename VecType>
+  size_t Leaf(const size_t tree, const VecType& point) const;
+
+  //! Add the class probabilities of the given leaf to the given vector.
+  void AddLeaf(const size_t leaf, double* probabilities) const;
+
+  //! The index of the root node of each tree.
+  std::vector<size_t> roots;
+  //! The type of each node (a NodeType).
+  std::vector<unsigned char> types;
+  //! The split dimension of each node.  For OTHER nodes, this is the index of
+  //! the original node in sourceNodes instead.
+  std::vector<size_t> dimensions;
+  //! The threshold of each THRESHOLD node.
+  std::vector<double> thresholds;
+  //! The index of the first child of each node, or the index of the leaf for
+  //! leaves.
+  std::vector<size_t> firstChildren;
+  //! The original nodes of the OTHER nodes.
+  std::vector<const TreeType*> sourceNodes;
+  //! The class probabilities of each leaf.
+  arma::mat leafProbabilities;
+};
+
+} // namespace tree
+} // namespace mlpack
+
+// Include implementation.
+#include "flat_decision_forest_impl.hpp"
+
+#endif
@@ -0,0 +1,238 @@
+/**
+ * @file flat_decision_forest_impl.hpp
+ *
+ * Implementation of the FlatDecisionForest class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_DECISION_TREE_FLAT_DECISION_FOREST_IMPL_HPP
+#define MLPACK_METHODS_DECISION_TREE_FLAT_DECISION_FOREST_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "flat_decision_forest.hpp"
+
+namespace mlpack {
+namespace tree {
+
+template<typename TreeType>
+FlatDecisionForest<TreeType>::FlatDecisionForest()
+{
+  // Nothing to do.
+}
+
+template<typename TreeType>
+FlatDecisionForest<TreeType>::FlatDecisionForest(const TreeType& tree)
+{
+  Add(tree);
+}
+
+template<typename TreeType>
+void FlatDecisionForest<TreeType>::Add(const TreeType& tree)
+{
+  typedef typename TreeType::NumericSplit NumericSplit;
+  typedef typename TreeType::CategoricalSplit CategoricalSplit;
+
+  const size_t numClasses = tree.NumClasses();
+  if (roots.size() > 0 && numClasses != NumClasses())
+  {
+    std::ostringstream oss;
+    oss << "FlatDecisionForest::Add(): the tree has " << numClasses
+        << " classes, but the forest has " << NumClasses() << "!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  // Lay out the nodes in breadth-first order, so that the children of each
+  // node are next to each other.  The nodes of the tree are collected in the
+  // order of their indices in the table.
+  const size_t root = types.size();
+  roots.push_back(root);
+
+  std::vector<const TreeType*> nodes(1, &tree);
+  std::vector<const TreeType*> leaves;
+  for (size_t i = 0; i < nodes.size(); ++i)
+  {
+    const TreeType& node = *nodes[i];
+    if (node.NumChildren() == 0)
+    {
+      types.push_back(LEAF);
+      dimensions.push_back(0);
+      thresholds.push_back(0.0);
+      firstChildren.push_back(leafProbabilities.n_cols + leaves.size());
+      leaves.push_back(&node);
+      continue;
+    }
+
+    NodeType type = OTHER;
+    if (node.SplitDimensionType() == data::Datatype::categorical)
+    {
+      if (SplitTraits<CategoricalSplit>::IsValueSplit)
+        type = VALUE;
+    }
+    else if (SplitTraits<NumericSplit>::IsThresholdSplit &&
+        node.NumChildren() == 2)
+    {
+      type = THRESHOLD;
+    }
+
+    types.push_back(type);
+    if (type == OTHER)
+    {
+      dimensions.push_back(sourceNodes.size());
+      sourceNodes.push_back(&node);
+    }
+    else
+    {
+      dimensions.push_back(node.SplitDimension());
+    }
+    thresholds.push_back(type == THRESHOLD ?
+        node.ClassProbabilities()[0] : 0.0);
+    firstChildren.push_back(root + nodes.size());
+
+    for (size_t j = 0; j < node.NumChildren(); ++j)
+      nodes.push_back(&node.Child(j));
+  }
+
+  // Now store the class probabilities of the leaves.
+  const size_t firstLeaf = leafProbabilities.n_cols;
+  leafProbabilities.resize(numClasses, firstLeaf + leaves.size());
+  for (size_t i = 0; i < leaves.size(); ++i)
+    leafProbabilities.col(firstLeaf + i) = leaves[i]->ClassProbabilities();
+}
+
+template<typename TreeType>
+template<typename VecType>
+size_t FlatDecisionForest<TreeType>::Classify(const VecType& point) const
+{
+  size_t prediction;
+  arma::vec probabilities;
+  Classify(point, prediction, probabilities);
+
+  return prediction;
+}
+
+template<typename TreeType>
+template<typename VecType>
+void FlatDecisionForest<TreeType>::Classify(const VecType& point,
+                                            size_t& prediction,
+                                            arma::vec& probabilities) const
+{
+  if (roots.size() == 0)
+  {
+    probabilities.clear();
+    prediction = 0;
+
+    throw std::invalid_argument("FlatDecisionForest::Classify(): the forest "
+        "has no trees!");
+  }
+
+  probabilities.zeros(NumClasses());
+  for (size_t t = 0; t < roots.size(); ++t)
+    AddLeaf(Leaf(t, point), probabilities.memptr());
+
+  probabilities /= roots.size();
+  arma::uword maxIndex = 0;
+  probabilities.max(maxIndex);
+  prediction = (size_t) maxIndex;
+}
+
+template<typename TreeType>
+template<typename MatType>
+void FlatDecisionForest<TreeType>::Classify(
+    const MatType& data,
+    arma::Row<size_t>& predictions) const
+{
+  arma::mat probabilities;
+  Classify(data, predictions, probabilities);
+}
+
+template<typename TreeType>
+template<typename MatType>
+void FlatDecisionForest<TreeType>::Classify(
+    const MatType& data,
+    arma::Row<size_t>& predictions,
+    arma::mat& probabilities) const
+{
+  if (roots.size() == 0)
+  {
+    predictions.clear();
+    probabilities.clear();
+
+    throw std::invalid_argument("FlatDecisionForest::Classify(): the forest "
+        "has no trees!");
+  }
+
+  predictions.set_size(data.n_cols);
+  probabilities.zeros(NumClasses(), data.n_cols);
+
+  // Each tree is applied to a whole batch of points before moving on to the
+  // next tree, so that the top of the tree stays in the cache.
+  const size_t batchSize = 64;
+  const size_t numBatches = (data.n_cols + batchSize - 1) / batchSize;
+
+  #pragma omp parallel for
+  for (omp_size_t b = 0; b < (omp_size_t) numBatches; ++b)
+  {
+    const size_t begin = b * batchSize;
+    const size_t end = std::min(begin + batchSize, (size_t) data.n_cols);
+
+    for (size_t t = 0; t < roots.size(); ++t)
+      for (size_t i = begin; i < end; ++i)
+        AddLeaf(Leaf(t, data.col(i)), probabilities.colptr(i));
+
+    for (size_t i = begin; i < end; ++i)
+    {
+      arma::vec probs = probabilities.unsafe_col(i); // Alias of column.
+      probs /= roots.size();
+      arma::uword maxIndex = 0;
+      probs.max(maxIndex);
+      predictions[i] = (size_t) maxIndex;
+    }
+  }
+}
+
+template<typename TreeType>
+template<typename VecType>
+size_t FlatDecisionForest<TreeType>::Leaf(const size_t tree,
+                                          const VecType& point) const
+{
+  size_t node = roots[tree];
+  while (true)
+  {
+    switch (types[node])
+    {
+      case LEAF:
+        return firstChildren[node];
+
+      case THRESHOLD:
+        node = firstChildren[node] +
+            ((point[dimensions[node]] <= thresholds[node]) ? 0 : 1);
+        break;
+
+      case VALUE:
+        node = firstChildren[node] + (size_t) point[dimensions[node]];
+        break;
+
+      default:
+        node = firstChildren[node] +
+            sourceNodes[dimensions[node]]->CalculateDirection(point);
+        break;
+    }
+  }
+}
+
+template<typename TreeType>
+void FlatDecisionForest<TreeType>::AddLeaf(const size_t leaf,
+                                           double* probabilities) const
+{
+  const double* leafProbs = leafProbabilities.colptr(leaf);
+  for (size_t c = 0; c < leafProbabilities.n_rows; ++c)
+    probabilities[c] += leafProbs[c];
+}
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
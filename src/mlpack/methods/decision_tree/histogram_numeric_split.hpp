@@ -0,0 +1,137 @@
+/**
+ * @file histogram_numeric_split.hpp
+ *
+ * A tree splitter that finds the best binary numeric split among the
+ * boundaries of a histogram of the points.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_DECISION_TREE_HISTOGRAM_NUMERIC_SPLIT_HPP
+#define MLPACK_METHODS_DECISION_TREE_HISTOGRAM_NUMERIC_SPLIT_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "split_traits.hpp"
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * The HistogramNumericSplit is a splitting function for decision trees that
+ * searches a numeric dimension for the best binary split, like
+ * BestBinaryNumericSplit, but only considers the boundaries of at most
+ * MaxBins() bins (as LightGBM and XGBoost's histogram method do).  The bin
+ * boundaries are quantiles of a sample of at most SampleSize() points of the
+ * node, and the class counts (or weights) of each bin are collected in one
+ * pass over the points; then all the boundaries are scored from the cumulative
+ * counts.  So, instead of sorting the points of the node in each dimension,
+ * finding the split takes O(n log(MaxBins()) + MaxBins() * numClasses) time.
+ * When a node has at most SampleSize() points and fewer than MaxBins()
+ * distinct values, every boundary between them is a candidate, and the split
+ * is the same as the one of BestBinaryNumericSplit.
+ *
+ * The fitness function only needs to support weights: the gain of each side of
+ * a split is evaluated on one (weighted) label for each class.
+ *
+ * @tparam FitnessFunction Fitness function to use to calculate gain.
+ */
+template<typename FitnessFunction>
+class HistogramNumericSplit
+{
+ public:
+  // No extra info needed for split.
+  template<typename ElemType>
+  class AuxiliarySplitInfo { };
+
+  //! The maximum number of bins of the histogram of a node.
+  static size_t MaxBins() { return 256; }
+
+  //! The maximum number of points used to find the bin boundaries.
+  static size_t SampleSize() { return 4096; }
+
+  /**
+   * Check if we can split a node.  If we can split a node in a way that
+   * improves on 'bestGain', then we return the improved gain.  Otherwise we
+   * return the value 'bestGain'.  If a split is made, then classProbabilities
+   * and aux may be modified.
+   *
+   * @param bestGain Best gain seen so far (we'll only split if we find gain
+   *      better than this).
+   * @param data The dimension of data points to check for a split in.
+   * @param labels Labels for each point.
+   * @param numClasses Number of classes in the dataset.
+   * @param weights Weights of the points (only used if UseWeights is true).
+   * @param minimumLeafSize Minimum number of points in a leaf node for
+   *      splitting.
+   * @param classProbabilities Class probabilities vector, which may be filled
+   *      with split information a successful split.
+   * @param aux Auxiliary split information, which may be modified on a
+   *      successful split.
+   */
+  template<bool UseWeights, typename VecType, typename WeightVecType>
+  static double SplitIfBetter(
+      const double bestGain,
+      const VecType& data,
+      const arma::Row<size_t>& labels,
+      const size_t numClasses,
+      const WeightVecType& weights,
+      const size_t minimumLeafSize,
+      arma::Col<typename VecType::elem_type>& classProbabilities,
+      AuxiliarySplitInfo<typename VecType::elem_type>& aux);
+
+  /**
+   * Returns 2, since the binary split always has two children.
+   */
+  template<typename ElemType>
+  static size_t NumChildren(const arma::Col<ElemType>& /* classProbabilities */,
+                            const AuxiliarySplitInfo<ElemType>& /* aux */)
+  {
+    return 2;
+  }
+
+  /**
+   * Given a point, calculate which child it should go to (left or right).
+   *
+   * @param point Point to calculate direction of.
+   * @param classProbabilities Auxiliary information for the split.
+   * @param aux (Unused) auxiliary information for the split.
+   */
+  template<typename ElemType>
+  static size_t CalculateDirection(
+      const ElemType& point,
+      const arma::Col<ElemType>& classProbabilities,
+      const AuxiliarySplitInfo<ElemType>& /* aux */);
+
+ private:
+  /**
+   * Find the bin boundaries for the given points: quantiles of a sample of the
+   * points, halfway between two distinct values.
+   */
+  template<typename VecType>
+  static void BinBoundaries(
+      const VecType& data,
+      std::vector<typename VecType::elem_type>& boundaries);
+};
+
+/**
+ * Specialization of SplitTraits for HistogramNumericSplit.
+ */
+template<typename FitnessFunction>
+class SplitTraits<HistogramNumericSplit<FitnessFunction>>
+{
+ public:
+  //! The histogram numeric split is a threshold on the split dimension.
+  static const bool IsThresholdSplit = true;
+  //! The child of a point is not given by its value.
+  static const bool IsValueSplit = false;
+};
+
+} // namespace tree
+} // namespace mlpack
+
+// Include implementation.
+#include "histogram_numeric_split_impl.hpp"
+
+#endif
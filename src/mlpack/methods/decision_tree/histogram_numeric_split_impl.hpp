@@ -0,0 +1,178 @@
+/**
+ * @file histogram_numeric_split_impl.hpp
+ *
+ * Implementation of the strategy that finds the best binary numeric split
+ * among the boundaries of a histogram.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_DECISION_TREE_HISTOGRAM_NUMERIC_SPLIT_IMPL_HPP
+#define MLPACK_METHODS_DECISION_TREE_HISTOGRAM_NUMERIC_SPLIT_IMPL_HPP
+
+namespace mlpack {
+namespace tree {
+
+template<typename FitnessFunction>
+template<bool UseWeights, typename VecType, typename WeightVecType>
+double HistogramNumericSplit<FitnessFunction>::SplitIfBetter(
+    const double bestGain,
+    const VecType& data,
+    const arma::Row<size_t>& labels,
+    const size_t numClasses,
+    const WeightVecType& weights,
+    const size_t minimumLeafSize,
+    arma::Col<typename VecType::elem_type>& classProbabilities,
+    AuxiliarySplitInfo<typename VecType::elem_type>& /* aux */)
+{
+  typedef typename VecType::elem_type ElemType;
+
+  // First sanity check: if we don't have enough points, we can't split.
+  if (data.n_elem < (minimumLeafSize * 2))
+    return bestGain;
+
+  std::vector<ElemType> boundaries;
+  BinBoundaries(data, boundaries);
+  if (boundaries.empty())
+    return bestGain; // All the values are the same.
+
+  // Collect the class counts (or weights) and the number of points of each
+  // bin.  The points of bin b are greater than boundary b - 1, and less than
+  // or equal to boundary b.
+  const size_t numBins = boundaries.size() + 1;
+  arma::mat classCounts(numClasses, numBins, arma::fill::zeros);
+  arma::Col<size_t> binCounts(numBins, arma::fill::zeros);
+  for (size_t i = 0; i < data.n_elem; ++i)
+  {
+    const size_t bin = std::lower_bound(boundaries.begin(), boundaries.end(),
+        data[i]) - boundaries.begin();
+    classCounts(labels[i], bin) += UseWeights ? (double) weights[i] : 1.0;
+    ++binCounts[bin];
+  }
+
+  // The gain of each side is evaluated on one label of each class, weighted by
+  // its count.
+  const arma::Row<size_t> classes = arma::linspace<arma::Row<size_t>>(0,
+      numClasses - 1, numClasses);
+  const arma::rowvec totalCounts = arma::sum(classCounts, 1).t();
+  arma::rowvec leftCounts(numClasses, arma::fill::zeros);
+
+  // Loop through all the bin boundaries, choosing the best one.  Also, force a
+  // minimum leaf size of 1 (empty children don't make sense).
+  double bestFoundGain = bestGain;
+  const size_t minimum = std::max(minimumLeafSize, (size_t) 1);
+  size_t leftPoints = 0;
+  for (size_t b = 0; b < boundaries.size(); ++b)
+  {
+    leftCounts += classCounts.col(b).t();
+    leftPoints += binCounts[b];
+    if (leftPoints < minimum)
+      continue;
+    if (data.n_elem - leftPoints < minimum)
+      break;
+
+    const arma::rowvec rightCounts = totalCounts - leftCounts;
+    const double leftWeight = arma::accu(leftCounts);
+    const double rightWeight = arma::accu(rightCounts);
+    const double fullWeight = leftWeight + rightWeight;
+    if (fullWeight == 0.0)
+      continue;
+
+    const double leftGain = FitnessFunction::template Evaluate<true>(classes,
+        numClasses, leftCounts);
+    const double rightGain = FitnessFunction::template Evaluate<true>(classes,
+        numClasses, rightCounts);
+    const double gain = (leftWeight / fullWeight) * leftGain +
+        (rightWeight / fullWeight) * rightGain;
+
+    // Corner case: is this the best possible split?
+    if (gain >= 0.0)
+    {
+      // We can take a shortcut: no split will be better than this, so just take
+      // this one.
+      classProbabilities.set_size(1);
+      classProbabilities[0] = boundaries[b];
+      return gain;
+    }
+    else if (gain > bestFoundGain)
+    {
+      // We still have a better split.
+      bestFoundGain = gain;
+      classProbabilities.set_size(1);
+      classProbabilities[0] = boundaries[b];
+    }
+  }
+
+  return bestFoundGain;
+}
+
+template<typename FitnessFunction>
+template<typename ElemType>
+size_t HistogramNumericSplit<FitnessFunction>::CalculateDirection(
+    const ElemType& point,
+    const arma::Col<ElemType>& classProbabilities,
+    const AuxiliarySplitInfo<ElemType>& /* aux */)
+{
+  if (point <= classProbabilities[0])
+    return 0; // Go left.
+  else
+    return 1; // Go right.
+}
+
+template<typename FitnessFunction>
+template<typename VecType>
+void HistogramNumericSplit<FitnessFunction>::BinBoundaries(
+    const VecType& data,
+    std::vector<typename VecType::elem_type>& boundaries)
+{
+  typedef typename VecType::elem_type ElemType;
+
+  // Take an evenly spaced sample of the points, and sort it.
+  const size_t stride = std::max(data.n_elem / SampleSize(), (size_t) 1);
+  std::vector<ElemType> sample;
+  sample.reserve(data.n_elem / stride + 1);
+  for (size_t i = 0; i < data.n_elem; i += stride)
+    sample.push_back(data[i]);
+  std::sort(sample.begin(), sample.end());
+
+  // If there are few distinct values, take all the boundaries between them.
+  std::vector<ElemType> allBoundaries;
+  for (size_t i = 1; i < sample.size(); ++i)
+  {
+    if (sample[i] != sample[i - 1])
+    {
+      allBoundaries.push_back((sample[i - 1] + sample[i]) / 2.0);
+      if (allBoundaries.size() >= MaxBins())
+        break;
+    }
+  }
+
+  boundaries.clear();
+  if (allBoundaries.size() < MaxBins())
+  {
+    boundaries.swap(allBoundaries);
+    return;
+  }
+
+  // Otherwise take the boundary after each quantile of the sample, skipping
+  // ties, so that each bin holds about the same number of points.
+  size_t last = 0;
+  for (size_t k = 1; k < MaxBins(); ++k)
+  {
+    size_t i = std::max((k * sample.size()) / MaxBins(), last + 1);
+    while (i < sample.size() && sample[i] == sample[i - 1])
+      ++i;
+    if (i >= sample.size())
+      break;
+
+    boundaries.push_back((sample[i - 1] + sample[i]) / 2.0);
+    last = i;
+  }
+}
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
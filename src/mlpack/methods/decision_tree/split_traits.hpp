@@ -0,0 +1,49 @@
+/**
+ * @file split_traits.hpp
+ *
+ * This provides the SplitTraits class, a template class to get information
+ * about the numeric and categorical split types of decision trees.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_DECISION_TREE_SPLIT_TRAITS_HPP
+#define MLPACK_METHODS_DECISION_TREE_SPLIT_TRAITS_HPP
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * This is a template class that can provide information about the split types
+ * of decision trees, so that code outside of the tree (like FlatDecisionForest)
+ * can compute the direction of a point without calling CalculateDirection().
+ * By default, this class will provide the weakest possible assumptions on
+ * split types, and each split type should override values as necessary.  If a
+ * split type doesn't need to override a value, then there's no need to write a
+ * SplitTraits specialization for that class.
+ */
+template<typename SplitType>
+class SplitTraits
+{
+ public:
+  /**
+   * If true, then a node that is split by this type has two children, and a
+   * point goes to the first one if and only if its value in the split dimension
+   * is less than or equal to the first element of the node's class
+   * probabilities vector.
+   */
+  static const bool IsThresholdSplit = false;
+
+  /**
+   * If true, then a point goes to the child whose index is its value in the
+   * split dimension.
+   */
+  static const bool IsValueSplit = false;
+};
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
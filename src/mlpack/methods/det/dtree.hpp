@@ -150,6 +150,13 @@ class DTree
    * Greedily expand the tree.  The points in the dataset will be reordered
    * during tree growth.
    *
+   * For dense matrices, the values of each dimension are sorted once before
+   * the tree is grown, and the splits keep them sorted, so the split search
+   * doesn't sort the points of each node again; this takes memory for a copy
+   * of the data and for an index of each value.  When mlpack is compiled with
+   * OpenMP, the split search of each node is parallelized over the dimensions,
+   * and the children of large nodes are grown as parallel tasks.
+   *
    * @param data Dataset to build tree on.
    * @param oldFromNew Mappings from old points to new points.
    * @param useVolReg If true, volume regularization is used.
@@ -335,14 +342,57 @@ class DTree
   // Utility methods.
 
   /**
-   * Find the dimension to split on.
+   * The values of each dimension, sorted, for the points of each node to be
+   * split.  The rows from Start() to End() of each column hold the sorted
+   * values of the points of the node in one dimension.
+   */
+  struct SortedDimensions
+  {
+    //! The sorted values (each column is a dimension).
+    arma::Mat<ElemType> values;
+    //! The points of the sorted values (as indices when the values were
+    //! sorted).
+    arma::Mat<size_t> points;
+    //! For each point, whether it goes to the left child of the last split.
+    std::vector<char> goesLeft;
+  };
+
+  /**
+   * Greedily expand the tree, with the sorted values of each dimension (or
+   * NULL, if the values are not sorted).
+   */
+  double Grow(MatType& data,
+              arma::Col<size_t>& oldFromNew,
+              const bool useVolReg,
+              const size_t maxLeafSize,
+              const size_t minLeafSize,
+              SortedDimensions* sorted);
+
+  /**
+   * Grow both children of this node, in parallel if possible, and store the
+   * value of g_k(t) of each.
+   */
+  void GrowChildren(MatType& data,
+                    arma::Col<size_t>& oldFromNew,
+                    const bool useVolReg,
+                    const size_t maxLeafSize,
+                    const size_t minLeafSize,
+                    SortedDimensions* sorted,
+                    double& leftG,
+                    double& rightG);
+
+  /**
+   * Find the dimension to split on.  If the sorted values of each dimension
+   * are given (see SortedDimensions), they are used instead of sorting the
+   * points of the node.
    */
   bool FindSplit(const MatType& data,
                  size_t& splitDim,
                  ElemType& splitValue,
                  double& leftError,
                  double& rightError,
-                 const size_t minLeafSize = 5) const;
+                 const size_t minLeafSize = 5,
+                 const arma::Mat<ElemType>* sortedValues = NULL) const;
 
   /**
    * Split the data, returning the number of points left of the split.
@@ -352,6 +402,14 @@ class DTree
                    const ElemType splitValue,
                    arma::Col<size_t>& oldFromNew) const;
 
+  /**
+   * Partition the sorted values of each dimension for the given split, so that
+   * they stay sorted for each child.
+   */
+  void SplitSorted(SortedDimensions& sorted,
+                   const size_t splitDim,
+                   const size_t splitIndex) const;
+
   void  FillMinMax(const StatType& mins,
                    const StatType& maxs);
 };
@@ -15,6 +15,10 @@
 #include <stack>
 #include <vector>
 
+#ifdef HAS_OPENMP
+  #include <omp.h>
+#endif
+
 using namespace mlpack;
 using namespace det;
 
@@ -57,6 +61,30 @@ void ExtractSplits(std::vector<std::pair<ElemType, size_t>>& splitVec,
   }
 }
 
+/**
+ * Put all the splits of the given sorted values in a vector.
+ */
+template<typename ElemType>
+void ExtractSortedSplits(std::vector<std::pair<ElemType, size_t>>& splitVec,
+                         const ElemType* sortedVals,
+                         const size_t n_elem,
+                         const size_t minLeafSize)
+{
+  typedef std::pair<ElemType, size_t> SplitItem;
+
+  for (size_t i = minLeafSize - 1; i < n_elem - minLeafSize; ++i)
+  {
+    // This makes sense for real continuous data. This kinda corrupts the data
+    // and estimation if the data is ordinal. Potentially we can fix that by
+    // taking into account ordinality later in the min/max update, but then we
+    // can end-up with a zero-volumed dimension. No good.
+    const ElemType split = (sortedVals[i] + sortedVals[i + 1]) / 2.0;
+
+    if (split != sortedVals[i])
+      splitVec.push_back(SplitItem(split, i + 1));
+  }
+}
+
 // Now the custom arma::Mat implementation.
 template<typename ElemType>
 void ExtractSplits(std::vector<std::pair<ElemType, size_t>>& splitVec,
@@ -66,23 +94,12 @@ void ExtractSplits(std::vector<std::pair<ElemType, size_t>>& splitVec,
                    const size_t end,
                    const size_t minLeafSize)
 {
-  typedef std::pair<ElemType, size_t> SplitItem;
-  arma::rowvec dimVec = data(dim, arma::span(start, end - 1));
+  arma::Row<ElemType> dimVec = data(dim, arma::span(start, end - 1));
 
   // We sort these, in-place (it's a copy of the data, anyways).
   std::sort(dimVec.begin(), dimVec.end());
 
-  for (size_t i = minLeafSize - 1; i < dimVec.n_elem - minLeafSize; ++i)
-  {
-    // This makes sense for real continuous data. This kinda corrupts the data
-    // and estimation if the data is ordinal. Potentially we can fix that by
-    // taking into account ordinality later in the min/max update, but then we
-    // can end-up with a zero-volumed dimension. No good.
-    const ElemType split = (dimVec[i] + dimVec[i + 1]) / 2.0;
-
-    if (split != dimVec[i])
-      splitVec.push_back(SplitItem(split, i + 1));
-  }
+  ExtractSortedSplits(splitVec, dimVec.memptr(), dimVec.n_elem, minLeafSize);
 }
 
 // This the custom, sparse optimized implementation of the same routine.
@@ -147,6 +164,46 @@ void ExtractSplits(std::vector<std::pair<ElemType, size_t>>& splitVec,
   }
 }
 
+/**
+ * Sort the values of the given points in each dimension, for dense matrices.
+ * For other matrices (sparse matrices, whose values would take too much memory
+ * this way), nothing is done and false is returned.
+ */
+template<typename MatType>
+bool SortDimensions(const MatType& /* data */,
+                    const size_t /* start */,
+                    const size_t /* end */,
+                    arma::Mat<typename MatType::elem_type>& /* values */,
+                    arma::Mat<size_t>& /* points */)
+{
+  return false;
+}
+
+template<typename ElemType>
+bool SortDimensions(const arma::Mat<ElemType>& data,
+                    const size_t start,
+                    const size_t end,
+                    arma::Mat<ElemType>& values,
+                    arma::Mat<size_t>& points)
+{
+  values.set_size(data.n_cols, data.n_rows);
+  points.set_size(data.n_cols, data.n_rows);
+
+  #pragma omp parallel for
+  for (omp_size_t dim = 0; dim < (omp_size_t) data.n_rows; ++dim)
+  {
+    const arma::uvec order = start + arma::stable_sort_index(
+        data(dim, arma::span(start, end - 1)));
+    for (size_t i = 0; i < order.n_elem; ++i)
+    {
+      values(start + i, dim) = data(dim, order[i]);
+      points(start + i, dim) = order[i];
+    }
+  }
+
+  return true;
+}
+
 } // namespace details
 
 template<typename MatType, typename TagType>
@@ -439,7 +496,9 @@ bool DTree<MatType, TagType>::FindSplit(const MatType& data,
                                         ElemType& splitValue,
                                         double& leftError,
                                         double& rightError,
-                                        const size_t minLeafSize) const
+                                        const size_t minLeafSize,
+                                        const arma::Mat<ElemType>* sortedValues)
+    const
 {
   typedef std::pair<ElemType, size_t> SplitItem;
 
@@ -485,11 +544,20 @@ bool DTree<MatType, TagType>::FindSplit(const MatType& data,
     //   dimVec = arma::sort(dimVec);
     // could be quite inefficient for sparse matrices, due to
     // copy operations (3). This one has custom implementation for dense and
-    // sparse matrices.
+    // sparse matrices.  If the values are sorted already, there's no need to do
+    // any of this.
 
     std::vector<SplitItem> splitVec;
-    details::ExtractSplits<ElemType>(splitVec, data, dim, start, end,
-        minLeafSize);
+    if (sortedValues)
+    {
+      details::ExtractSortedSplits<ElemType>(splitVec,
+          sortedValues->colptr(dim) + start, points, minLeafSize);
+    }
+    else
+    {
+      details::ExtractSplits<ElemType>(splitVec, data, dim, start, end,
+          minLeafSize);
+    }
 
     // Iterate on all the splits for this dimension
     for (typename std::vector<SplitItem>::iterator i = splitVec.begin();
@@ -585,6 +653,95 @@ size_t DTree<MatType, TagType>::SplitData(MatType& data,
   return left;
 }
 
+template<typename MatType, typename TagType>
+void DTree<MatType, TagType>::SplitSorted(SortedDimensions& sorted,
+                                          const size_t splitDim,
+                                          const size_t splitIndex) const
+{
+  // The points of the split dimension are already in order: the first ones go
+  // to the left child.
+  for (size_t i = start; i < end; ++i)
+    sorted.goesLeft[sorted.points(i, splitDim)] = (i < splitIndex);
+
+  // Now partition the other dimensions the same way, without changing the
+  // order of the points on each side.
+  #pragma omp parallel for if (end - start >= 10000)
+  for (omp_size_t dim = 0; dim < (omp_size_t) sorted.values.n_cols; ++dim)
+  {
+    if ((size_t) dim == splitDim)
+      continue;
+
+    arma::Col<ElemType> values(end - start);
+    arma::Col<size_t> points(end - start);
+    size_t left = 0;
+    size_t right = splitIndex - start;
+    for (size_t i = start; i < end; ++i)
+    {
+      const size_t point = sorted.points(i, dim);
+      const size_t j = sorted.goesLeft[point] ? left++ : right++;
+      values[j] = sorted.values(i, dim);
+      points[j] = point;
+    }
+
+    sorted.values(arma::span(start, end - 1), dim) = values;
+    sorted.points(arma::span(start, end - 1), dim) = points;
+  }
+}
+
+template<typename MatType, typename TagType>
+void DTree<MatType, TagType>::GrowChildren(MatType& data,
+                                           arma::Col<size_t>& oldFromNew,
+                                           const bool useVolReg,
+                                           const size_t maxLeafSize,
+                                           const size_t minLeafSize,
+                                           SortedDimensions* sorted,
+                                           double& leftG,
+                                           double& rightG)
+{
+#if defined(HAS_OPENMP) && (_OPENMP >= 200805)
+  // The two children hold disjoint sets of points (and disjoint parts of
+  // oldFromNew and of the sorted values), so they can be grown at the same
+  // time.  Small subtrees aren't worth a task.
+  if (end - start >= 1000)
+  {
+    if (!omp_in_parallel())
+    {
+      // This is the first node that is grown in parallel, so start the
+      // threads.
+      #pragma omp parallel
+      {
+        #pragma omp single
+        GrowChildren(data, oldFromNew, useVolReg, maxLeafSize, minLeafSize,
+            sorted, leftG, rightG);
+      }
+      return;
+    }
+
+    // The tasks get copies of the local variables, so use pointers.
+    MatType* dataPtr = &data;
+    arma::Col<size_t>* oldFromNewPtr = &oldFromNew;
+    double* leftGPtr = &leftG;
+    double* rightGPtr = &rightG;
+
+    #pragma omp task
+    *leftGPtr = left->Grow(*dataPtr, *oldFromNewPtr, useVolReg, maxLeafSize,
+        minLeafSize, sorted);
+
+    #pragma omp task
+    *rightGPtr = right->Grow(*dataPtr, *oldFromNewPtr, useVolReg, maxLeafSize,
+        minLeafSize, sorted);
+
+    #pragma omp taskwait
+    return;
+  }
+#endif
+
+  leftG = left->Grow(data, oldFromNew, useVolReg, maxLeafSize, minLeafSize,
+      sorted);
+  rightG = right->Grow(data, oldFromNew, useVolReg, maxLeafSize, minLeafSize,
+      sorted);
+}
+
 // Greedily expand the tree.
 template<typename MatType, typename TagType>
 double DTree<MatType, TagType>::Grow(MatType& data,
@@ -592,6 +749,27 @@ double DTree<MatType, TagType>::Grow(MatType& data,
                                      const bool useVolReg,
                                      const size_t maxLeafSize,
                                      const size_t minLeafSize)
+{
+  // Sort the values of each dimension once, if we can; the splits keep them
+  // sorted.
+  SortedDimensions sorted;
+  if (details::SortDimensions(data, start, end, sorted.values, sorted.points))
+  {
+    sorted.goesLeft.resize(data.n_cols);
+    return Grow(data, oldFromNew, useVolReg, maxLeafSize, minLeafSize,
+        &sorted);
+  }
+
+  return Grow(data, oldFromNew, useVolReg, maxLeafSize, minLeafSize, NULL);
+}
+
+template<typename MatType, typename TagType>
+double DTree<MatType, TagType>::Grow(MatType& data,
+                                     arma::Col<size_t>& oldFromNew,
+                                     const bool useVolReg,
+                                     const size_t maxLeafSize,
+                                     const size_t minLeafSize,
+                                     SortedDimensions* sorted)
 {
   Log::Assert(data.n_rows == maxVals.n_elem);
   Log::Assert(data.n_rows == minVals.n_elem);
@@ -614,11 +792,14 @@ double DTree<MatType, TagType>::Grow(MatType& data,
     size_t dim;
     double splitValueTmp;
     double leftError, rightError;
-    if (FindSplit(data, dim, splitValueTmp, leftError, rightError, minLeafSize))
+    if (FindSplit(data, dim, splitValueTmp, leftError, rightError, minLeafSize,
+        sorted ? &sorted->values : NULL))
     {
       // Move the data around for the children to have points in a node lie
       // contiguously (to increase efficiency during the training).
       const size_t splitIndex = SplitData(data, dim, splitValueTmp, oldFromNew);
+      if (sorted)
+        SplitSorted(*sorted, dim, splitIndex);
 
       // Make max and min vals for the children.
       StatType maxValsL(maxVals);
@@ -637,10 +818,8 @@ double DTree<MatType, TagType>::Grow(MatType& data,
       left = new DTree(maxValsL, minValsL, start, splitIndex, leftError);
       right = new DTree(maxValsR, minValsR, splitIndex, end, rightError);
 
-      leftG = left->Grow(data, oldFromNew, useVolReg, maxLeafSize,
-                         minLeafSize);
-      rightG = right->Grow(data, oldFromNew, useVolReg, maxLeafSize,
-                           minLeafSize);
+      GrowChildren(data, oldFromNew, useVolReg, maxLeafSize, minLeafSize,
+          sorted, leftG, rightG);
 
       // Store values of R(T~) and |T~|.
       subtreeLeaves = left->SubtreeLeaves() + right->SubtreeLeaves();
@@ -0,0 +1,107 @@
+/**
+ * @file concurrent_union_find.hpp
+ *
+ * A lock-free union-find structure, which can be used from several threads at
+ * once.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_EMST_CONCURRENT_UNION_FIND_HPP
+#define MLPACK_METHODS_EMST_CONCURRENT_UNION_FIND_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <atomic>
+
+namespace mlpack {
+namespace emst {
+
+/**
+ * A union-find structure (see UnionFind) whose Find() and Union() may be
+ * called from several threads at once without locks.  The parent of each
+ * element is an atomic, and a root is only linked below another root with a
+ * compare-and-swap, which fails (and is retried) if the root was linked by
+ * another thread in the meantime.  Roots are always linked below roots with a
+ * smaller index, so the parents only ever decrease, which keeps the structure
+ * acyclic without any ranks; Find() compresses the paths by halving.
+ *
+ * Since the smallest element of each component is its root, the components
+ * found do not depend on the order of the unions, and Find(x) returns the
+ * smallest element of the component of x.
+ */
+class ConcurrentUnionFind
+{
+ public:
+  //! Construct the object with the given size.
+  ConcurrentUnionFind(const size_t size) : parent(size)
+  {
+    for (size_t i = 0; i < size; ++i)
+      parent[i].store(i);
+  }
+
+  /**
+   * Returns the component containing an element (which is the smallest
+   * element of the component).
+   *
+   * @param x The element to find the component of.
+   * @return The index of the component containing x.
+   */
+  size_t Find(size_t x)
+  {
+    while (true)
+    {
+      size_t p = parent[x].load();
+      if (p == x)
+        return x;
+
+      // Path halving: point x to its grandparent, if nobody else changed it.
+      const size_t grandparent = parent[p].load();
+      if (grandparent != p)
+        parent[x].compare_exchange_weak(p, grandparent);
+
+      x = grandparent;
+    }
+  }
+
+  /**
+   * Union the components containing x and y.  If several threads union the
+   * same two components at once, only one of them merges them.
+   *
+   * @param x One element.
+   * @param y The other element.
+   * @return true if the components were merged by this call, false if x and y
+   *     were already in the same component.
+   */
+  bool Union(size_t x, size_t y)
+  {
+    while (true)
+    {
+      x = Find(x);
+      y = Find(y);
+      if (x == y)
+        return false;
+
+      // Link the root with the larger index below the other one.
+      if (x < y)
+        std::swap(x, y);
+
+      size_t expected = x;
+      if (parent[x].compare_exchange_strong(expected, y))
+        return true;
+    }
+  }
+
+  //! Get the number of elements.
+  size_t Size() const { return parent.size(); }
+
+ private:
+  //! The parent of each element.
+  std::vector<std::atomic<size_t>> parent;
+};
+
+} // namespace emst
+} // namespace mlpack
+
+#endif
@@ -27,6 +27,7 @@
 
 #include "dtb_stat.hpp"
 #include "edge_pair.hpp"
+#include "concurrent_union_find.hpp"
 
 #include <mlpack/prereqs.hpp>
 #include <mlpack/core/metrics/lmetric.hpp>
@@ -68,6 +69,14 @@ namespace emst /** Euclidean Minimum Spanning Trees. */ {
  * More advanced usage of the class can use different types of trees, pass in an
  * already-built tree, or compute the MST using the O(n^2) naive algorithm.
  *
+ * When mlpack is compiled with OpenMP, the search for the nearest neighbor of
+ * each component in each Boruvka round is parallelized: the query tree is
+ * split into subtrees near its root, which the threads traverse against the
+ * whole reference tree.  Each thread keeps its own candidate edges (three
+ * entries for each point), and the best candidate of each component is taken
+ * after the traversal.  The components are held in a ConcurrentUnionFind, so
+ * the edges found in a round are also added in parallel.
+ *
  * @tparam MetricType The metric to use.
  * @tparam MatType The type of data matrix to use.
  * @tparam TreeType Type of tree to use.  This should follow the TreeType policy
@@ -103,7 +112,7 @@ class DualTreeBoruvka
   std::vector<EdgePair> edges; // We must use vector with non-numerical types.
 
   //! Connections.
-  UnionFind connections;
+  ConcurrentUnionFind connections;
 
   //! List of edge nodes.
   arma::Col<size_t> neighborsInComponent;
@@ -182,6 +191,15 @@ class DualTreeBoruvka
    */
   void AddEdge(const size_t e1, const size_t e2, const double distance);
 
+  /**
+   * Find the nearest neighbor of each component (one Boruvka round), in
+   * parallel if possible.
+   *
+   * @param rules Rules of the traversal, with the candidate edges.
+   */
+  template<typename RuleType>
+  void FindNeighbors(RuleType& rules);
+
   /**
    * Adds all the edges found in one iteration to the list of neighbors.
    */
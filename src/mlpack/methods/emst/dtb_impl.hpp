@@ -13,6 +13,7 @@
 #define MLPACK_METHODS_EMST_DTB_IMPL_HPP
 
 #include "dtb_rules.hpp"
+#include <mlpack/core/tree/split_frontier.hpp>
 
 namespace mlpack {
 namespace emst {
@@ -128,18 +129,7 @@ void DualTreeBoruvka<MetricType, MatType, TreeType>::ComputeMST(
                  neighborsOutComponent, metric);
   while (edges.size() < (data.n_cols - 1))
   {
-    if (naive)
-    {
-      // Full O(N^2) traversal.
-      for (size_t i = 0; i < data.n_cols; ++i)
-        for (size_t j = 0; j < data.n_cols; ++j)
-          rules.BaseCase(i, j);
-    }
-    else
-    {
-      typename Tree::template DualTreeTraverser<RuleType> traverser(rules);
-      traverser.Traverse(*tree, *tree);
-    }
+    FindNeighbors(rules);
 
     AddAllEdges();
 
@@ -151,6 +141,7 @@ void DualTreeBoruvka<MetricType, MatType, TreeType>::ComputeMST(
       Log::Info << rules.BaseCases() << " cumulative base cases." << std::endl;
       Log::Info << rules.Scores() << " cumulative node combinations scored."
           << std::endl;
+      rules.Counters().Report();
     }
   }
 
@@ -184,6 +175,108 @@ void DualTreeBoruvka<MetricType, MatType, TreeType>::AddEdge(
     edges.push_back(EdgePair(e2, e1, distance));
 }
 
+/**
+ * Find the nearest neighbor of each component.
+ */
+template<
+    typename MetricType,
+    typename MatType,
+    template<typename TreeMetricType,
+             typename TreeStatType,
+             typename TreeMatType> class TreeType>
+template<typename RuleType>
+void DualTreeBoruvka<MetricType, MatType, TreeType>::FindNeighbors(
+    RuleType& rules)
+{
+#ifdef HAS_OPENMP
+  const size_t numThreads = omp_get_max_threads();
+  if (numThreads > 1)
+  {
+    // Split the query tree near the root until there are enough subtrees to
+    // keep all threads busy.
+    std::vector<Tree*> frontier;
+    if (!naive)
+      frontier = tree::SplitFrontier(*tree, 8 * numThreads);
+
+    // The points of a component may be in the subtrees of several threads, so
+    // each thread keeps its own candidate edges.
+    std::vector<arma::vec> threadDistances(numThreads);
+    std::vector<arma::Col<size_t>> threadInComponent(numThreads);
+    std::vector<arma::Col<size_t>> threadOutComponent(numThreads);
+
+    #pragma omp parallel
+    {
+      const size_t thread = omp_get_thread_num();
+      threadDistances[thread].set_size(data.n_cols);
+      threadDistances[thread].fill(DBL_MAX);
+      threadInComponent[thread].set_size(data.n_cols);
+      threadOutComponent[thread].set_size(data.n_cols);
+
+      RuleType threadRules(data, connections, threadDistances[thread],
+          threadInComponent[thread], threadOutComponent[thread], metric);
+
+      if (naive)
+      {
+        #pragma omp for schedule(dynamic, 16)
+        for (omp_size_t i = 0; i < (omp_size_t) data.n_cols; ++i)
+          for (size_t j = 0; j < data.n_cols; ++j)
+            threadRules.BaseCase(i, j);
+      }
+      else
+      {
+        const typename RuleType::TraversalInfoType initialInfo =
+            threadRules.TraversalInfo();
+        typename Tree::template DualTreeTraverser<RuleType>
+            traverser(threadRules);
+
+        #pragma omp for schedule(dynamic)
+        for (omp_size_t i = 0; i < (omp_size_t) frontier.size(); ++i)
+        {
+          // Nothing is known about the combination of this subtree and the
+          // reference root, so reset the traversal info.
+          threadRules.TraversalInfo() = initialInfo;
+          traverser.Traverse(*frontier[i], *tree);
+        }
+      }
+
+      #pragma omp critical
+      rules.Counters() += threadRules.Counters();
+    }
+
+    // Now take the best candidate of each component.
+    #pragma omp parallel for
+    for (omp_size_t c = 0; c < (omp_size_t) data.n_cols; ++c)
+    {
+      for (size_t t = 0; t < threadDistances.size(); ++t)
+      {
+        if (threadDistances[t].n_elem > 0 &&
+            threadDistances[t][c] < neighborsDistances[c])
+        {
+          neighborsDistances[c] = threadDistances[t][c];
+          neighborsInComponent[c] = threadInComponent[t][c];
+          neighborsOutComponent[c] = threadOutComponent[t][c];
+        }
+      }
+    }
+
+    return;
+  }
+#endif
+
+  if (naive)
+  {
+    // Full O(N^2) traversal.
+    for (size_t i = 0; i < data.n_cols; ++i)
+      for (size_t j = 0; j < data.n_cols; ++j)
+        rules.BaseCase(i, j);
+  }
+  else
+  {
+    typename Tree::template DualTreeTraverser<RuleType> traverser(rules);
+    traverser.Traverse(*tree, *tree);
+  }
+}
+
 /**
  * Adds all the edges found in one iteration to the list of neighbors.
  */
@@ -195,18 +288,43 @@ template<
              typename TreeMatType> class TreeType>
 void DualTreeBoruvka<MetricType, MatType, TreeType>::AddAllEdges()
 {
+  // Find the components of this round first; unions would change the roots
+  // while we look for them.
+  std::vector<size_t> components;
   for (size_t i = 0; i < data.n_cols; i++)
+    if (connections.Find(i) == i && neighborsDistances[i] != DBL_MAX)
+      components.push_back(i);
+
+  // Add the edge of each component, unless the two components were already
+  // joined by another edge of this round.  Only the thread whose union merges
+  // the components adds the edge.
+  #pragma omp parallel
   {
-    size_t component = connections.Find(i);
-    size_t inEdge = neighborsInComponent[component];
-    size_t outEdge = neighborsOutComponent[component];
-    if (connections.Find(inEdge) != connections.Find(outEdge))
+    std::vector<EdgePair> threadEdges;
+    double threadDist = 0.0;
+
+    #pragma omp for
+    for (omp_size_t i = 0; i < (omp_size_t) components.size(); ++i)
+    {
+      const size_t component = components[i];
+      const size_t inEdge = neighborsInComponent[component];
+      const size_t outEdge = neighborsOutComponent[component];
+      if (connections.Union(inEdge, outEdge))
+      {
+        // totalDist = totalDist + dist;
+        // changed to make this agree with the cover tree code
+        threadDist += neighborsDistances[component];
+        threadEdges.push_back(EdgePair(inEdge, outEdge,
+            neighborsDistances[component]));
+      }
+    }
+
+    #pragma omp critical
     {
-      // totalDist = totalDist + dist;
-      // changed to make this agree with the cover tree code
-      totalDist += neighborsDistances[component];
-      AddEdge(inEdge, outEdge, neighborsDistances[component]);
-      connections.Union(inEdge, outEdge);
+      totalDist += threadDist;
+      for (size_t i = 0; i < threadEdges.size(); ++i)
+        AddEdge(threadEdges[i].Lesser(), threadEdges[i].Greater(),
+            threadEdges[i].Distance());
     }
   }
 }
@@ -14,6 +14,7 @@
 
 #include <mlpack/prereqs.hpp>
 
+#include <mlpack/core/tree/traversal_counters.hpp>
 #include <mlpack/core/tree/traversal_info.hpp>
 
 namespace mlpack {
@@ -24,7 +25,7 @@ class DTBRules
 {
  public:
   DTBRules(const arma::mat& dataSet,
-           UnionFind& connections,
+           ConcurrentUnionFind& connections,
            arma::vec& neighborsDistances,
            arma::Col<size_t>& neighborsInComponent,
            arma::Col<size_t>& neighborsOutComponent,
@@ -32,6 +33,19 @@ class DTBRules
 
   double BaseCase(const size_t queryIndex, const size_t referenceIndex);
 
+  /**
+   * Compute the base cases between the given query point and each point of a
+   * contiguous block of reference points.  This is equivalent to calling
+   * BaseCase() for each of the reference points, but faster.
+   *
+   * @param queryIndex Index of query point.
+   * @param referenceBegin Index of the first reference point of the block.
+   * @param referenceCount Number of reference points in the block.
+   */
+  void BaseCaseBlock(const size_t queryIndex,
+                     const size_t referenceBegin,
+                     const size_t referenceCount);
+
   /**
    * Get the score for recursion order.  A low score indicates priority for
    * recursion, while DBL_MAX indicates that the node should not be recursed
@@ -88,21 +102,26 @@ class DTBRules
   TraversalInfoType& TraversalInfo() { return traversalInfo; }
 
   //! Get the number of base cases performed.
-  size_t BaseCases() const { return baseCases; }
+  size_t BaseCases() const { return counters.BaseCases(); }
   //! Modify the number of base cases performed.
-  size_t& BaseCases() { return baseCases; }
+  size_t& BaseCases() { return counters.BaseCases(); }
 
   //! Get the number of node combinations that have been scored.
-  size_t Scores() const { return scores; }
+  size_t Scores() const { return counters.Scores(); }
   //! Modify the number of node combinations that have been scored.
-  size_t& Scores() { return scores; }
+  size_t& Scores() { return counters.Scores(); }
+
+  //! Get the traversal counters.
+  const tree::TraversalCounters& Counters() const { return counters; }
+  //! Modify the traversal counters.
+  tree::TraversalCounters& Counters() { return counters; }
 
  private:
   //! The data points.
   const arma::mat& dataSet;
 
   //! Stores the tree structure so far
-  UnionFind& connections;
+  ConcurrentUnionFind& connections;
 
   //! The distance to the candidate nearest neighbor for each component.
   arma::vec& neighborsDistances;
@@ -118,6 +137,9 @@ class DTBRules
   //! The instantiated metric.
   MetricType& metric;
 
+  //! The distances computed by the last call to BaseCaseBlock().
+  arma::vec blockDistances;
+
   /**
    * Update the bound for the given query node.
    */
@@ -125,10 +147,8 @@ class DTBRules
 
   TraversalInfoType traversalInfo;
 
-  //! The number of base cases calculated.
-  size_t baseCases;
-  //! The number of node combinations that have been scored.
-  size_t scores;
+  //! The counters of base cases, scores, prunes, and node visits.
+  tree::TraversalCounters counters;
 }; // class DTBRules
 
 } // namespace emst
@@ -12,13 +12,15 @@
 #ifndef MLPACK_METHODS_EMST_DTB_RULES_IMPL_HPP
 #define MLPACK_METHODS_EMST_DTB_RULES_IMPL_HPP
 
+#include <mlpack/core/metrics/evaluate_block.hpp>
+
 namespace mlpack {
 namespace emst {
 
 template<typename MetricType, typename TreeType>
 DTBRules<MetricType, TreeType>::
 DTBRules(const arma::mat& dataSet,
-         UnionFind& connections,
+         ConcurrentUnionFind& connections,
          arma::vec& neighborsDistances,
          arma::Col<size_t>& neighborsInComponent,
          arma::Col<size_t>& neighborsOutComponent,
@@ -29,9 +31,7 @@ DTBRules(const arma::mat& dataSet,
   neighborsDistances(neighborsDistances),
   neighborsInComponent(neighborsInComponent),
   neighborsOutComponent(neighborsOutComponent),
-  metric(metric),
-  baseCases(0),
-  scores(0)
+  metric(metric)
 {
   // Nothing else to do.
 }
@@ -53,7 +53,7 @@ double DTBRules<MetricType, TreeType>::BaseCase(const size_t queryIndex,
 
   if (queryComponentIndex != referenceComponentIndex)
   {
-    ++baseCases;
+    counters.BaseCase();
     double distance = metric.Evaluate(dataSet.col(queryIndex),
                                       dataSet.col(referenceIndex));
 
@@ -75,6 +75,36 @@ double DTBRules<MetricType, TreeType>::BaseCase(const size_t queryIndex,
   return newUpperBound;
 }
 
+template<typename MetricType, typename TreeType>
+void DTBRules<MetricType, TreeType>::BaseCaseBlock(
+    const size_t queryIndex,
+    const size_t referenceBegin,
+    const size_t referenceCount)
+{
+  metric::EvaluateBlock(metric, dataSet.col(queryIndex), dataSet,
+      referenceBegin, referenceCount, blockDistances);
+
+  const size_t queryComponentIndex = connections.Find(queryIndex);
+  for (size_t i = 0; i < referenceCount; ++i)
+  {
+    const size_t referenceIndex = referenceBegin + i;
+
+    // Only points in other components are candidates.
+    if (queryComponentIndex == connections.Find(referenceIndex))
+      continue;
+
+    counters.BaseCase();
+    if (blockDistances[i] < neighborsDistances[queryComponentIndex])
+    {
+      Log::Assert(queryIndex != referenceIndex);
+
+      neighborsDistances[queryComponentIndex] = blockDistances[i];
+      neighborsInComponent[queryComponentIndex] = queryIndex;
+      neighborsOutComponent[queryComponentIndex] = referenceIndex;
+    }
+  }
+}
+
 template<typename MetricType, typename TreeType>
 double DTBRules<MetricType, TreeType>::Score(const size_t queryIndex,
                                              TreeType& referenceNode)
@@ -86,15 +116,15 @@ double DTBRules<MetricType, TreeType>::Score(const size_t queryIndex,
   // signed values.
   if (queryComponentIndex ==
       (size_t) referenceNode.Stat().ComponentMembership())
-    return DBL_MAX;
+    return counters.ScoreResult(DBL_MAX);
 
   const arma::vec queryPoint = dataSet.unsafe_col(queryIndex);
   const double distance = referenceNode.MinDistance(queryPoint);
 
   // If all the points in the reference node are farther than the candidate
   // nearest neighbor for the query's component, we prune.
-  return neighborsDistances[queryComponentIndex] < distance
-      ? DBL_MAX : distance;
+  return counters.ScoreResult(
+      neighborsDistances[queryComponentIndex] < distance ? DBL_MAX : distance);
 }
 
 template<typename MetricType, typename TreeType>
@@ -104,8 +134,9 @@ double DTBRules<MetricType, TreeType>::Rescore(const size_t queryIndex,
 {
   // We don't need to check component membership again, because it can't
   // change inside a single iteration.
-  return (oldScore > neighborsDistances[connections.Find(queryIndex)])
-      ? DBL_MAX : oldScore;
+  return counters.RescoreResult(oldScore,
+      (oldScore > neighborsDistances[connections.Find(queryIndex)])
+      ? DBL_MAX : oldScore);
 }
 
 template<typename MetricType, typename TreeType>
@@ -117,15 +148,15 @@ double DTBRules<MetricType, TreeType>::Score(TreeType& queryNode,
   if ((queryNode.Stat().ComponentMembership() >= 0) &&
       (queryNode.Stat().ComponentMembership() ==
            referenceNode.Stat().ComponentMembership()))
-    return DBL_MAX;
+    return counters.ScoreResult(DBL_MAX);
 
-  ++scores;
+  counters.Score();
   const double distance = queryNode.MinDistance(referenceNode);
   const double bound = CalculateBound(queryNode);
 
   // If all the points in the reference node are farther than the candidate
   // nearest neighbor for all queries in the node, we prune.
-  return (bound < distance) ? DBL_MAX : distance;
+  return counters.ScoreResult((bound < distance) ? DBL_MAX : distance);
 }
 
 template<typename MetricType, typename TreeType>
@@ -134,7 +165,8 @@ double DTBRules<MetricType, TreeType>::Rescore(TreeType& queryNode,
                                                const double oldScore) const
 {
   const double bound = CalculateBound(queryNode);
-  return (oldScore > bound) ? DBL_MAX : oldScore;
+  return counters.RescoreResult(oldScore,
+      (oldScore > bound) ? DBL_MAX : oldScore);
 }
 
 // Calculate the bound for a given query node in its current state and update
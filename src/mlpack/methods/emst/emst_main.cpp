@@ -29,6 +29,7 @@
 #include <mlpack/core/util/mlpack_main.hpp>
 
 #include "dtb.hpp"
+#include "single_linkage.hpp"
 
 PROGRAM_INFO("Fast Euclidean Minimum Spanning Tree",
     "This program can compute the Euclidean minimum spanning tree of a set of "
@@ -56,7 +57,29 @@ PROGRAM_INFO("Fast Euclidean Minimum Spanning Tree",
     "The output matrix is a three-dimensional matrix, where each row indicates "
     "an edge.  The first dimension corresponds to the lesser index of the edge;"
     " the second dimension corresponds to the greater index of the edge; and "
-    "the third column corresponds to the distance between the two points.");
+    "the third column corresponds to the distance between the two points."
+    "\n\n"
+    "The single-linkage hierarchical clustering of the points can also be "
+    "computed from the minimum spanning tree.  The dendrogram may be saved with"
+    " the " + PRINT_PARAM_STRING("dendrogram") + " output parameter, in the "
+    "format of SciPy's linkage matrices: each row is a merge, and holds the "
+    "two clusters that are merged, the distance between them, and the number "
+    "of points of the new cluster; the points are the clusters 0 to N - 1, and "
+    "the cluster made by the i'th merge is N + i.  The condensed cluster tree "
+    "of HDBSCAN may be saved with the " + PRINT_PARAM_STRING("condensed_tree") +
+    " output parameter; each row is an edge of the tree, and holds the parent "
+    "cluster, the child (a point, or a cluster), the lambda value (inverse "
+    "distance) where the child leaves the parent, and the number of points of "
+    "the child.  Splits that leave fewer than " +
+    PRINT_PARAM_STRING("min_cluster_size") + " points on one side are seen as "
+    "points falling out of the cluster."
+    "\n\n"
+    "For example, the condensed tree of " + PRINT_DATASET("data") + " with a "
+    "minimum cluster size of 10 can be stored as " + PRINT_DATASET("tree") +
+    " with the following command:"
+    "\n\n" +
+    PRINT_CALL("emst", "input", "data", "min_cluster_size", 10,
+        "condensed_tree", "tree"));
 
 PARAM_MATRIX_IN_REQ("input", "Input data matrix.", "i");
 PARAM_MATRIX_OUT("output", "Output data.  Stored as an edge list.", "o");
@@ -64,6 +87,12 @@ PARAM_FLAG("naive", "Compute the MST using O(n^2) naive algorithm.", "n");
 PARAM_INT_IN("leaf_size", "Leaf size in the kd-tree.  One-element leaves give "
     "the empirically best performance, but at the cost of greater memory "
     "requirements.", "l", 1);
+PARAM_MATRIX_OUT("dendrogram", "Single-linkage dendrogram of the points.",
+    "d");
+PARAM_MATRIX_OUT("condensed_tree", "Condensed cluster tree (as in HDBSCAN) of "
+    "the points.", "c");
+PARAM_INT_IN("min_cluster_size", "Minimum number of points of a cluster of the "
+    "condensed tree.", "m", 5);
 
 using namespace mlpack;
 using namespace mlpack::emst;
@@ -74,9 +103,17 @@ using namespace std;
 
 void mlpackMain()
 {
-  RequireAtLeastOnePassed({ "output" }, false, "no output will be saved");
+  RequireAtLeastOnePassed({ "output", "dendrogram", "condensed_tree" }, false,
+      "no output will be saved");
+  ReportIgnoredParam({{ "condensed_tree", false }}, "min_cluster_size");
+  if (CLI::HasParam("condensed_tree"))
+  {
+    RequireParamValue<int>("min_cluster_size", [](int x) { return x >= 2; },
+        true, "minimum cluster size must be at least 2");
+  }
 
   arma::mat dataPoints = std::move(CLI::GetParam<arma::mat>("input"));
+  arma::mat mst;
 
   // Do naive computation if necessary.
   if (CLI::GetParam<bool>("naive"))
@@ -87,9 +124,7 @@ void mlpackMain()
 
     arma::mat naiveResults;
     naive.ComputeMST(naiveResults);
-
-    if (CLI::HasParam("output"))
-      CLI::GetParam<arma::mat>("output") = std::move(naiveResults);
+    mst = std::move(naiveResults);
   }
   else
   {
@@ -138,7 +173,28 @@ void mlpackMain()
       unmappedResults(2, i) = results(2, i);
     }
 
-    if (CLI::HasParam("output"))
-      CLI::GetParam<arma::mat>("output") = std::move(unmappedResults);
+    mst = std::move(unmappedResults);
+  }
+
+  if (CLI::HasParam("dendrogram") || CLI::HasParam("condensed_tree"))
+  {
+    Timer::Start("single_linkage");
+    arma::mat dendrogram;
+    SingleLinkage::Dendrogram(mst, dendrogram);
+
+    if (CLI::HasParam("condensed_tree"))
+    {
+      arma::mat condensedTree;
+      SingleLinkage::CondensedTree(dendrogram,
+          (size_t) CLI::GetParam<int>("min_cluster_size"), condensedTree);
+      CLI::GetParam<arma::mat>("condensed_tree") = std::move(condensedTree);
+    }
+    Timer::Stop("single_linkage");
+
+    if (CLI::HasParam("dendrogram"))
+      CLI::GetParam<arma::mat>("dendrogram") = std::move(dendrogram);
   }
+
+  if (CLI::HasParam("output"))
+    CLI::GetParam<arma::mat>("output") = std::move(mst);
 }
@@ -0,0 +1,177 @@
+/**
+ * @file single_linkage.cpp
+ *
+ * Implementation of the SingleLinkage class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "single_linkage.hpp"
+#include "union_find.hpp"
+
+using namespace mlpack;
+using namespace mlpack::emst;
+
+void SingleLinkage::Dendrogram(const arma::mat& mst, arma::mat& dendrogram)
+{
+  if (mst.n_rows != 3)
+  {
+    std::ostringstream oss;
+    oss << "SingleLinkage::Dendrogram(): the minimum spanning tree must have "
+        << "3 rows, but it has " << mst.n_rows << "!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  const size_t numPoints = mst.n_cols + 1;
+
+  // The edges given by DualTreeBoruvka are sorted already, so the sort is
+  // cheap.
+  const arma::uvec order = arma::stable_sort_index(mst.row(2).t());
+
+  UnionFind connections(numPoints);
+  // The cluster and the number of points of the component of each root.
+  arma::Col<size_t> clusters = arma::linspace<arma::Col<size_t>>(0,
+      numPoints - 1, numPoints);
+  arma::Col<size_t> sizes(numPoints, arma::fill::ones);
+
+  dendrogram.set_size(4, mst.n_cols);
+  for (size_t i = 0; i < mst.n_cols; ++i)
+  {
+    const size_t edge = order[i];
+    const size_t rootA = connections.Find((size_t) mst(0, edge));
+    const size_t rootB = connections.Find((size_t) mst(1, edge));
+    if (rootA == rootB)
+    {
+      throw std::invalid_argument("SingleLinkage::Dendrogram(): the edges "
+          "don't form a spanning tree!");
+    }
+
+    const size_t clusterA = clusters[rootA];
+    const size_t clusterB = clusters[rootB];
+    dendrogram(0, i) = std::min(clusterA, clusterB);
+    dendrogram(1, i) = std::max(clusterA, clusterB);
+    dendrogram(2, i) = mst(2, edge);
+    dendrogram(3, i) = sizes[rootA] + sizes[rootB];
+
+    connections.Union(rootA, rootB);
+    const size_t root = connections.Find(rootA);
+    clusters[root] = numPoints + i;
+    sizes[root] = sizes[rootA] + sizes[rootB];
+  }
+}
+
+void SingleLinkage::CondensedTree(const arma::mat& dendrogram,
+                                  const size_t minClusterSize,
+                                  arma::mat& condensedTree)
+{
+  if (dendrogram.n_rows != 4)
+  {
+    std::ostringstream oss;
+    oss << "SingleLinkage::CondensedTree(): the dendrogram must have 4 rows, "
+        << "but it has " << dendrogram.n_rows << "!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  if (minClusterSize < 2)
+  {
+    throw std::invalid_argument("SingleLinkage::CondensedTree(): the minimum "
+        "cluster size must be at least 2!");
+  }
+
+  const size_t numPoints = dendrogram.n_cols + 1;
+  if (dendrogram.n_cols == 0)
+  {
+    condensedTree.set_size(4, 0);
+    return;
+  }
+
+  // The number of points of the given node of the dendrogram.
+  auto size = [&](const size_t node)
+  {
+    return (node < numPoints) ? 1 : (size_t) dendrogram(3, node - numPoints);
+  };
+
+  std::vector<double> edges;
+  edges.reserve(4 * 2 * numPoints);
+  auto addEdge = [&](const size_t parent, const size_t child,
+      const double lambda, const size_t childSize)
+  {
+    edges.push_back(parent);
+    edges.push_back(child);
+    edges.push_back(lambda);
+    edges.push_back(childSize);
+  };
+
+  // The points of a node that falls out of a cluster all leave it at once.
+  std::vector<size_t> fallStack;
+  auto fallOut = [&](const size_t cluster, const size_t node,
+      const double lambda)
+  {
+    fallStack.push_back(node);
+    while (!fallStack.empty())
+    {
+      const size_t n = fallStack.back();
+      fallStack.pop_back();
+      if (n < numPoints)
+      {
+        addEdge(cluster, n, lambda, 1);
+      }
+      else
+      {
+        fallStack.push_back((size_t) dendrogram(0, n - numPoints));
+        fallStack.push_back((size_t) dendrogram(1, n - numPoints));
+      }
+    }
+  };
+
+  // Each entry is a node of the dendrogram and the cluster it belongs to.
+  // Since clusters have at least two points, these nodes are never points.
+  std::vector<std::pair<size_t, size_t>> stack;
+  stack.push_back(std::make_pair(2 * numPoints - 2, numPoints));
+  size_t nextCluster = numPoints + 1;
+  while (!stack.empty())
+  {
+    const size_t node = stack.back().first;
+    const size_t cluster = stack.back().second;
+    stack.pop_back();
+
+    const size_t merge = node - numPoints;
+    const size_t left = (size_t) dendrogram(0, merge);
+    const size_t right = (size_t) dendrogram(1, merge);
+    const double distance = dendrogram(2, merge);
+    const double lambda = (distance > 0.0) ? 1.0 / distance : DBL_MAX;
+
+    const size_t leftSize = size(left);
+    const size_t rightSize = size(right);
+
+    if (leftSize >= minClusterSize && rightSize >= minClusterSize)
+    {
+      // A true split into two new clusters.
+      addEdge(cluster, nextCluster, lambda, leftSize);
+      stack.push_back(std::make_pair(left, nextCluster++));
+      addEdge(cluster, nextCluster, lambda, rightSize);
+      stack.push_back(std::make_pair(right, nextCluster++));
+    }
+    else if (leftSize < minClusterSize && rightSize < minClusterSize)
+    {
+      // The cluster vanishes.
+      fallOut(cluster, left, lambda);
+      fallOut(cluster, right, lambda);
+    }
+    else if (leftSize < minClusterSize)
+    {
+      // The cluster goes on as the right side.
+      fallOut(cluster, left, lambda);
+      stack.push_back(std::make_pair(right, cluster));
+    }
+    else
+    {
+      fallOut(cluster, right, lambda);
+      stack.push_back(std::make_pair(left, cluster));
+    }
+  }
+
+  condensedTree = arma::mat(edges.data(), 4, edges.size() / 4);
+}
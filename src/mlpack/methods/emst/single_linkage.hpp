@@ -0,0 +1,100 @@
+/**
+ * @file single_linkage.hpp
+ *
+ * Definition of the SingleLinkage class, which builds the single-linkage
+ * hierarchical clustering of a dataset from its minimum spanning tree.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_EMST_SINGLE_LINKAGE_HPP
+#define MLPACK_METHODS_EMST_SINGLE_LINKAGE_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace emst {
+
+/**
+ * The single-linkage hierarchical clustering of a dataset can be read off its
+ * minimum spanning tree: merging the points along the edges of the tree, from
+ * the shortest to the longest, gives the dendrogram.  This class builds the
+ * dendrogram from the edge list given by DualTreeBoruvka::ComputeMST() with one
+ * pass of a union-find structure over the sorted edges, and it can condense the
+ * dendrogram into the cluster tree used by HDBSCAN, where splits that separate
+ * fewer than a minimum number of points are seen as points falling out of a
+ * cluster rather than as new clusters.
+ *
+ * @code
+ * DualTreeBoruvka<> dtb(data);
+ * arma::mat mst, dendrogram, condensedTree;
+ * dtb.ComputeMST(mst);
+ *
+ * SingleLinkage::Dendrogram(mst, dendrogram);
+ * SingleLinkage::CondensedTree(dendrogram, 5, condensedTree);
+ * @endcode
+ *
+ * For more information on the condensed tree, see the following.
+ *
+ * @code
+ * @inproceedings{campello2013density,
+ *   author    = {Campello, Ricardo J.G.B. and Moulavi, Davoud and Sander,
+ *                Joerg},
+ *   title     = {Density-Based Clustering Based on Hierarchical Density
+ *                Estimates},
+ *   booktitle = {Advances in Knowledge Discovery and Data Mining (PAKDD
+ *                2013)},
+ *   pages     = {160--172},
+ *   year      = {2013}
+ * }
+ * @endcode
+ */
+class SingleLinkage
+{
+ public:
+  /**
+   * Build the single-linkage dendrogram from the given minimum spanning tree.
+   * The tree is given as by DualTreeBoruvka::ComputeMST(): a 3 x (N - 1)
+   * matrix, where each column holds the two indices and the length of an edge.
+   * The edges don't need to be sorted.
+   *
+   * The dendrogram is a 4 x (N - 1) matrix in the format of SciPy's linkage
+   * matrices: the i'th column is the i'th merge, and holds the two clusters
+   * that are merged, the distance between them, and the number of points of
+   * the new cluster.  The points are the clusters 0 to N - 1, and the cluster
+   * made by the i'th merge is N + i.  The lesser cluster is given first.
+   *
+   * @param mst Minimum spanning tree (edge list).
+   * @param dendrogram Matrix to store the dendrogram in.
+   */
+  static void Dendrogram(const arma::mat& mst, arma::mat& dendrogram);
+
+  /**
+   * Condense the given dendrogram into the cluster tree of HDBSCAN.  Starting
+   * from the root, a split where both sides have at least minClusterSize points
+   * makes two new clusters; otherwise, the points of the smaller side (or of
+   * both sides) fall out of the cluster, and the cluster goes on as the larger
+   * side.
+   *
+   * The condensed tree is a 4 x M matrix, where each column is an edge of the
+   * tree and holds the parent cluster, the child (a point, if it is less than
+   * N, or a cluster), the lambda value (the inverse of the distance) where the
+   * child leaves the parent, and the number of points of the child.  The root
+   * cluster is N, and the other clusters are numbered from N + 1 in the order
+   * they are found.  A distance of zero gives a lambda value of DBL_MAX.
+   *
+   * @param dendrogram Dendrogram, as given by Dendrogram().
+   * @param minClusterSize Minimum number of points of a cluster (at least 2).
+   * @param condensedTree Matrix to store the condensed tree in.
+   */
+  static void CondensedTree(const arma::mat& dendrogram,
+                            const size_t minClusterSize,
+                            arma::mat& condensedTree);
+};
+
+} // namespace emst
+} // namespace mlpack
+
+#endif
@@ -248,6 +248,14 @@ class FastMKS
   //! Modify whether or not brute-force (naive) search is used.
   bool& Naive() { return naive; }
 
+  //! Get whether or not the search is parallelized with OpenMP.  In dual-tree
+  //! mode, subtrees of the query tree are split between threads; in naive
+  //! mode, blocks of query points are.  Single-tree search is always serial,
+  //! since it caches kernel values in the nodes of the reference tree.
+  bool Parallel() const { return parallel; }
+  //! Modify whether or not the search is parallelized with OpenMP.
+  bool& Parallel() { return parallel; }
+
   //! Serialize the model.
   template<typename Archive>
   void serialize(Archive& ar, const unsigned int /* version */);
@@ -267,6 +275,8 @@ class FastMKS
   bool singleMode;
   //! If true, naive (brute-force) search is used.
   bool naive;
+  //! If true, the search is parallelized with OpenMP.
+  bool parallel;
 
   //! The instantiated inner-product metric induced by the given kernel.
   metric::IPMetric<KernelType> metric;
@@ -285,6 +295,33 @@ class FastMKS
   //! Use a priority queue to represent the list of candidate points.
   typedef std::priority_queue<Candidate, std::vector<Candidate>,
       CandidateCmp> CandidateList;
+
+  /**
+   * Run brute-force search.  The kernel is evaluated between blocks of query
+   * points and blocks of reference points with kernel::KernelMatrix(), so that
+   * kernels of the inner product take one matrix multiplication per pair of
+   * blocks.
+   *
+   * @param querySet Set of query points.
+   * @param k The number of maximum kernels to find.
+   * @param indices Matrix to store resulting indices in.
+   * @param kernels Matrix to store resulting kernel values in.
+   * @param sameSet If true, the query set is the reference set, and points are
+   *     not returned as their own candidates.
+   */
+  void NaiveSearch(const MatType& querySet,
+                   const size_t k,
+                   arma::Mat<size_t>& indices,
+                   arma::mat& kernels,
+                   const bool sameSet);
+
+  /**
+   * Run a dual-tree traversal of the given query tree and the reference tree
+   * with the given rules.  If parallel search is enabled (and OpenMP is
+   * available), subtrees of the query tree are traversed in parallel.
+   */
+  template<typename RuleType>
+  void DualTreeTraversal(Tree& queryTree, RuleType& rules);
 };
 
 } // namespace fastmks
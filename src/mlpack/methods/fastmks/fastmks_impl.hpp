@@ -16,6 +16,8 @@
 #include "fastmks.hpp"
 
 #include "fastmks_rules.hpp"
+#include <mlpack/core/kernels/kernel_matrix.hpp>
+#include <mlpack/core/tree/split_frontier.hpp>
 
 #include <mlpack/core/kernels/gaussian_kernel.hpp>
 
@@ -35,7 +37,8 @@ FastMKS<KernelType, MatType, TreeType>::FastMKS(const bool singleMode,
     treeOwner(true),
     setOwner(true),
     singleMode(singleMode),
-    naive(naive)
+    naive(naive),
+    parallel(false)
 {
   Timer::Start("tree_building");
   if (!naive)
@@ -58,7 +61,8 @@ FastMKS<KernelType, MatType, TreeType>::FastMKS(
     treeOwner(true),
     setOwner(false),
     singleMode(singleMode),
-    naive(naive)
+    naive(naive),
+    parallel(false)
 {
   Timer::Start("tree_building");
   if (!naive)
@@ -82,6 +86,7 @@ FastMKS<KernelType, MatType, TreeType>::FastMKS(const MatType& referenceSet,
     setOwner(false),
     singleMode(singleMode),
     naive(naive),
+    parallel(false),
     metric(kernel)
 {
   Timer::Start("tree_building");
@@ -107,6 +112,7 @@ FastMKS<KernelType, MatType, TreeType>::FastMKS(Tree* referenceTree,
     setOwner(false),
     singleMode(singleMode),
     naive(false),
+    parallel(false),
     metric(referenceTree->Metric())
 {
   // Nothing to do.
@@ -124,6 +130,7 @@ FastMKS<KernelType, MatType, TreeType>::FastMKS(const FastMKS& other) :
     setOwner(other.referenceTree == NULL),
     singleMode(other.singleMode),
     naive(other.naive),
+    parallel(other.parallel),
     metric(other.metric)
 {
   // Set reference set correctly.
@@ -145,6 +152,7 @@ FastMKS<KernelType, MatType, TreeType>::FastMKS(FastMKS&& other) :
     setOwner(other.setOwner),
     singleMode(other.singleMode),
     naive(other.naive),
+    parallel(other.parallel),
     metric(std::move(other.metric))
 {
   // Clear information from the other.
@@ -154,6 +162,7 @@ FastMKS<KernelType, MatType, TreeType>::FastMKS(FastMKS&& other) :
   other.setOwner = false;
   other.singleMode = false;
   other.naive = false;
+  other.parallel = false;
 }
 
 template<typename KernelType,
@@ -189,6 +198,7 @@ FastMKS<KernelType, MatType, TreeType>::operator=(const FastMKS& other)
 
   singleMode = other.singleMode;
   naive = other.naive;
+  parallel = other.parallel;
 }
 
 template<typename KernelType,
@@ -304,33 +314,7 @@ void FastMKS<KernelType, MatType, TreeType>::Search(
   // Naive implementation.
   if (naive)
   {
-    // Simple double loop.  Stupid, slow, but a good benchmark.
-    for (size_t q = 0; q < querySet.n_cols; ++q)
-    {
-      const Candidate def = std::make_pair(-DBL_MAX, size_t() - 1);
-      std::vector<Candidate> cList(k, def);
-      CandidateList pqueue(CandidateCmp(), std::move(cList));
-
-      for (size_t r = 0; r < referenceSet->n_cols; ++r)
-      {
-        const double eval = metric.Kernel().Evaluate(querySet.col(q),
-                                                     referenceSet->col(r));
-
-        if (eval > pqueue.top().first)
-        {
-          Candidate c = std::make_pair(eval, r);
-          pqueue.pop();
-          pqueue.push(c);
-        }
-      }
-
-      for (size_t j = 1; j <= k; j++)
-      {
-        indices(k - j, q) = pqueue.top().second;
-        kernels(k - j, q) = pqueue.top().first;
-        pqueue.pop();
-      }
-    }
+    NaiveSearch(querySet, k, indices, kernels, false);
 
     Timer::Stop("computing_products");
 
@@ -352,6 +336,8 @@ void FastMKS<KernelType, MatType, TreeType>::Search(
 
     Log::Info << rules.BaseCases() << " base cases." << std::endl;
     Log::Info << rules.Scores() << " scores." << std::endl;
+  rules.Counters().Report();
+    rules.Counters().Report();
 
     rules.GetResults(indices, kernels);
 
@@ -403,12 +389,11 @@ void FastMKS<KernelType, MatType, TreeType>::Search(
   typedef FastMKSRules<KernelType, Tree> RuleType;
   RuleType rules(*referenceSet, queryTree->Dataset(), k, metric.Kernel());
 
-  typename Tree::template DualTreeTraverser<RuleType> traverser(rules);
-
-  traverser.Traverse(*queryTree, *referenceTree);
+  DualTreeTraversal(*queryTree, rules);
 
   Log::Info << rules.BaseCases() << " base cases." << std::endl;
   Log::Info << rules.Scores() << " scores." << std::endl;
+  rules.Counters().Report();
 
   rules.GetResults(indices, kernels);
 
@@ -433,36 +418,7 @@ void FastMKS<KernelType, MatType, TreeType>::Search(
   // Naive implementation.
   if (naive)
   {
-    // Simple double loop.  Stupid, slow, but a good benchmark.
-    for (size_t q = 0; q < referenceSet->n_cols; ++q)
-    {
-      const Candidate def = std::make_pair(-DBL_MAX, size_t() - 1);
-      std::vector<Candidate> cList(k, def);
-      CandidateList pqueue(CandidateCmp(), std::move(cList));
-
-      for (size_t r = 0; r < referenceSet->n_cols; ++r)
-      {
-        if (q == r)
-          continue; // Don't return the point as its own candidate.
-
-        const double eval = metric.Kernel().Evaluate(referenceSet->col(q),
-                                                     referenceSet->col(r));
-
-        if (eval > pqueue.top().first)
-        {
-          Candidate c = std::make_pair(eval, r);
-          pqueue.pop();
-          pqueue.push(c);
-        }
-      }
-
-      for (size_t j = 1; j <= k; j++)
-      {
-        indices(k - j, q) = pqueue.top().second;
-        kernels(k - j, q) = pqueue.top().first;
-        pqueue.pop();
-      }
-    }
+    NaiveSearch(*referenceSet, k, indices, kernels, true);
 
     Timer::Stop("computing_products");
 
@@ -489,6 +445,8 @@ void FastMKS<KernelType, MatType, TreeType>::Search(
 
     Log::Info << rules.BaseCases() << " base cases." << std::endl;
     Log::Info << rules.Scores() << " scores." << std::endl;
+  rules.Counters().Report();
+    rules.Counters().Report();
 
     rules.GetResults(indices, kernels);
 
@@ -502,6 +460,105 @@ void FastMKS<KernelType, MatType, TreeType>::Search(
   Search(referenceTree, k, indices, kernels);
 }
 
+template<typename KernelType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void FastMKS<KernelType, MatType, TreeType>::NaiveSearch(
+    const MatType& querySet,
+    const size_t k,
+    arma::Mat<size_t>& indices,
+    arma::mat& kernels,
+    const bool sameSet)
+{
+  const size_t queryBlockSize = 64;
+  const size_t referenceBlockSize = 1024;
+  const size_t numQueryBlocks = (querySet.n_cols + queryBlockSize - 1) /
+      queryBlockSize;
+
+  #pragma omp parallel for schedule(dynamic) if (parallel)
+  for (omp_size_t b = 0; b < (omp_size_t) numQueryBlocks; ++b)
+  {
+    const size_t queryBegin = b * queryBlockSize;
+    const size_t queryEnd = std::min(queryBegin + queryBlockSize,
+        (size_t) querySet.n_cols);
+    const MatType queries = querySet.cols(queryBegin, queryEnd - 1);
+
+    const Candidate def = std::make_pair(-DBL_MAX, size_t() - 1);
+    std::vector<CandidateList> pqueues(queries.n_cols,
+        CandidateList(CandidateCmp(), std::vector<Candidate>(k, def)));
+
+    arma::mat products;
+    for (size_t refBegin = 0; refBegin < referenceSet->n_cols;
+         refBegin += referenceBlockSize)
+    {
+      const size_t refEnd = std::min(refBegin + referenceBlockSize,
+          (size_t) referenceSet->n_cols);
+      const MatType references = referenceSet->cols(refBegin, refEnd - 1);
+      kernel::KernelMatrix(metric.Kernel(), queries, references, products);
+
+      for (size_t j = 0; j < products.n_cols; ++j)
+      {
+        for (size_t i = 0; i < products.n_rows; ++i)
+        {
+          // Don't return the point as its own candidate.
+          if (sameSet && (queryBegin + i == refBegin + j))
+            continue;
+
+          if (products(i, j) > pqueues[i].top().first)
+          {
+            pqueues[i].pop();
+            pqueues[i].push(std::make_pair(products(i, j), refBegin + j));
+          }
+        }
+      }
+    }
+
+    for (size_t i = 0; i < pqueues.size(); ++i)
+    {
+      for (size_t j = 1; j <= k; j++)
+      {
+        indices(k - j, queryBegin + i) = pqueues[i].top().second;
+        kernels(k - j, queryBegin + i) = pqueues[i].top().first;
+        pqueues[i].pop();
+      }
+    }
+  }
+}
+
+template<typename KernelType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+template<typename RuleType>
+void FastMKS<KernelType, MatType, TreeType>::DualTreeTraversal(
+    Tree& queryTree,
+    RuleType& rules)
+{
+#ifdef HAS_OPENMP
+  const size_t numThreads = omp_get_max_threads();
+  if (parallel && numThreads > 1)
+  {
+    // Split the query tree near the root until there are enough subtrees to
+    // keep all threads busy; each thread shares the candidate lists, and no
+    // two subtrees in the frontier hold the same query point.  The traversals
+    // never score the nodes above the frontier, but their children use their
+    // bounds, so make sure those are not left over from an earlier search.
+    const std::vector<Tree*> frontier = tree::SplitFrontier(queryTree,
+        8 * numThreads, [](Tree& node) { node.Stat().Bound() = -DBL_MAX; });
+    typedef typename Tree::template DualTreeTraverser<RuleType> TraverserType;
+    tree::TraverseFrontier<TraverserType>(frontier, *referenceTree, rules);
+
+    return;
+  }
+#endif
+
+  typename Tree::template DualTreeTraverser<RuleType> traverser(rules);
+  traverser.Traverse(queryTree, *referenceTree);
+}
+
 //! Serialize the model.
 template<typename KernelType,
          typename MatType,
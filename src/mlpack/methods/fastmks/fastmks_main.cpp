@@ -79,6 +79,8 @@ PARAM_INT_IN("k", "Number of maximum kernels to find.", "k", 0);
 PARAM_FLAG("naive", "If true, O(n^2) naive mode is used for computation.", "N");
 PARAM_FLAG("single", "If true, single-tree search is used (as opposed to "
     "dual-tree search.", "S");
+PARAM_FLAG("parallel", "If true, the search is parallelized with OpenMP "
+    "(single-tree search is always serial).", "P");
 
 PARAM_MATRIX_OUT("kernels", "Output matrix of kernels.", "p");
 PARAM_UMATRIX_OUT("indices", "Output matrix of indices.", "i");
@@ -186,6 +188,7 @@ void mlpackMain()
   // Set search preferences.
   model.Naive() = CLI::HasParam("naive");
   model.SingleMode() = CLI::HasParam("single");
+  model.Parallel() = CLI::HasParam("parallel");
 
   // Should we do search?
   if (CLI::HasParam("k"))
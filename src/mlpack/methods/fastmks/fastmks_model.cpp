@@ -173,6 +173,52 @@ bool& FastMKSModel::Naive()
   throw std::runtime_error("invalid model type");
 }
 
+bool FastMKSModel::Parallel() const
+{
+  switch (kernelType)
+  {
+    case LINEAR_KERNEL:
+      return linear->Parallel();
+    case POLYNOMIAL_KERNEL:
+      return polynomial->Parallel();
+    case COSINE_DISTANCE:
+      return cosine->Parallel();
+    case GAUSSIAN_KERNEL:
+      return gaussian->Parallel();
+    case EPANECHNIKOV_KERNEL:
+      return epan->Parallel();
+    case TRIANGULAR_KERNEL:
+      return triangular->Parallel();
+    case HYPTAN_KERNEL:
+      return hyptan->Parallel();
+  }
+
+  throw std::runtime_error("invalid model type");
+}
+
+bool& FastMKSModel::Parallel()
+{
+  switch (kernelType)
+  {
+    case LINEAR_KERNEL:
+      return linear->Parallel();
+    case POLYNOMIAL_KERNEL:
+      return polynomial->Parallel();
+    case COSINE_DISTANCE:
+      return cosine->Parallel();
+    case GAUSSIAN_KERNEL:
+      return gaussian->Parallel();
+    case EPANECHNIKOV_KERNEL:
+      return epan->Parallel();
+    case TRIANGULAR_KERNEL:
+      return triangular->Parallel();
+    case HYPTAN_KERNEL:
+      return hyptan->Parallel();
+  }
+
+  throw std::runtime_error("invalid model type");
+}
+
 bool FastMKSModel::SingleMode() const
 {
   switch (kernelType)
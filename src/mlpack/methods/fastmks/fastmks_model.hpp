@@ -81,6 +81,11 @@ class FastMKSModel
   //! Set whether or not naive search is used.
   bool& Naive();
 
+  //! Get whether or not the search is parallelized with OpenMP.
+  bool Parallel() const;
+  //! Set whether or not the search is parallelized with OpenMP.
+  bool& Parallel();
+
   //! Get whether or not single-tree search is used.
   bool SingleMode() const;
   //! Set whether or not single-tree search is used.
@@ -15,6 +15,7 @@
 #include <mlpack/prereqs.hpp>
 #include <mlpack/core/kernels/kernel_traits.hpp>
 #include <mlpack/core/tree/cover_tree/cover_tree.hpp>
+#include <mlpack/core/tree/traversal_counters.hpp>
 #include <mlpack/core/tree/traversal_info.hpp>
 #include <boost/heap/priority_queue.hpp>
 
@@ -48,6 +49,17 @@ class FastMKSRules
                const size_t k,
                KernelType& kernel);
 
+  /**
+   * Construct a FastMKSRules object that shares the candidate lists and cached
+   * self-kernels of the given rules object, but has its own base case cache,
+   * traversal info, and counters.  This is used by parallel dual-tree
+   * traversals to give each thread its own rules object.  It is only safe as
+   * long as no two threads ever work on the same query node at the same time.
+   *
+   * @param other Rules object whose candidate lists will be shared.
+   */
+  FastMKSRules(FastMKSRules& other);
+
   /**
    * Store the list of candidates for each query point in the given matrices.
    *
@@ -110,14 +122,19 @@ class FastMKSRules
                  const double oldScore) const;
 
   //! Get the number of times BaseCase() was called.
-  size_t BaseCases() const { return baseCases; }
+  size_t BaseCases() const { return counters.BaseCases(); }
   //! Modify the number of times BaseCase() was called.
-  size_t& BaseCases() { return baseCases; }
+  size_t& BaseCases() { return counters.BaseCases(); }
 
   //! Get the number of times Score() was called.
-  size_t Scores() const { return scores; }
+  size_t Scores() const { return counters.Scores(); }
   //! Modify the number of times Score() was called.
-  size_t& Scores() { return scores; }
+  size_t& Scores() { return counters.Scores(); }
+
+  //! Get the traversal counters.
+  const tree::TraversalCounters& Counters() const { return counters; }
+  //! Modify the traversal counters.
+  tree::TraversalCounters& Counters() { return counters; }
 
   typedef typename tree::TraversalInfo<TreeType> TraversalInfoType;
 
@@ -148,16 +165,23 @@ class FastMKSRules
   typedef boost::heap::priority_queue<Candidate,
       boost::heap::compare<CandidateCmp>> CandidateList;
 
-  //! Set of candidates for each point.
-  std::vector<CandidateList> candidates;
+  //! Storage for the candidate lists, if this object owns them.
+  std::vector<CandidateList> candidateStorage;
+  //! Set of candidates for each point.  This may refer to the candidate lists
+  //! of another FastMKSRules object.
+  std::vector<CandidateList>& candidates;
 
   //! Number of points to search for.
   const size_t k;
 
+  //! Storage for the query set self-kernels, if this object owns them.
+  arma::vec queryKernelStorage;
   //! Cached query set self-kernels (|| q || for each q).
-  arma::vec queryKernels;
+  const arma::vec& queryKernels;
+  //! Storage for the reference set self-kernels, if this object owns them.
+  arma::vec referenceKernelStorage;
   //! Cached reference set self-kernels (|| r || for each r).
-  arma::vec referenceKernels;
+  const arma::vec& referenceKernels;
 
   //! The instantiated kernel.
   KernelType& kernel;
@@ -184,9 +208,7 @@ class FastMKSRules
                       const double product);
 
   //! For benchmarking.
-  size_t baseCases;
-  //! For benchmarking.
-  size_t scores;
+  tree::TraversalCounters counters;
 
   TraversalInfoType traversalInfo;
 };
@@ -26,24 +26,25 @@ FastMKSRules<KernelType, TreeType>::FastMKSRules(
     KernelType& kernel) :
     referenceSet(referenceSet),
     querySet(querySet),
+    candidates(candidateStorage),
     k(k),
+    queryKernels(queryKernelStorage),
+    referenceKernels(referenceKernelStorage),
     kernel(kernel),
     lastQueryIndex(-1),
     lastReferenceIndex(-1),
-    lastKernel(0.0),
-    baseCases(0),
-    scores(0)
+    lastKernel(0.0)
 {
   // Precompute each self-kernel.
-  queryKernels.set_size(querySet.n_cols);
+  queryKernelStorage.set_size(querySet.n_cols);
   for (size_t i = 0; i < querySet.n_cols; ++i)
-    queryKernels[i] = sqrt(kernel.Evaluate(querySet.col(i),
-                                           querySet.col(i)));
+    queryKernelStorage[i] = sqrt(kernel.Evaluate(querySet.col(i),
+                                                 querySet.col(i)));
 
-  referenceKernels.set_size(referenceSet.n_cols);
+  referenceKernelStorage.set_size(referenceSet.n_cols);
   for (size_t i = 0; i < referenceSet.n_cols; ++i)
-    referenceKernels[i] = sqrt(kernel.Evaluate(referenceSet.col(i),
-                                               referenceSet.col(i)));
+    referenceKernelStorage[i] = sqrt(kernel.Evaluate(referenceSet.col(i),
+                                                     referenceSet.col(i)));
 
   // Set to invalid memory, so that the first node combination does not try to
   // dereference null pointers.
@@ -64,6 +65,25 @@ FastMKSRules<KernelType, TreeType>::FastMKSRules(
   candidates.swap(tmp);
 }
 
+template<typename KernelType, typename TreeType>
+FastMKSRules<KernelType, TreeType>::FastMKSRules(FastMKSRules& other) :
+    referenceSet(other.referenceSet),
+    querySet(other.querySet),
+    candidates(other.candidates),
+    k(other.k),
+    queryKernels(other.queryKernels),
+    referenceKernels(other.referenceKernels),
+    kernel(other.kernel),
+    lastQueryIndex(-1),
+    lastReferenceIndex(-1),
+    lastKernel(0.0)
+{
+  // As in the other constructor, the last query and reference node pointers
+  // must be invalid but non-NULL.
+  traversalInfo.LastQueryNode() = (TreeType*) this;
+  traversalInfo.LastReferenceNode() = (TreeType*) this;
+}
+
 template<typename KernelType, typename TreeType>
 void FastMKSRules<KernelType, TreeType>::GetResults(
     arma::Mat<size_t>& indices,
@@ -105,7 +125,7 @@ double FastMKSRules<KernelType, TreeType>::BaseCase(
     lastReferenceIndex = referenceIndex;
   }
 
-  ++baseCases;
+  counters.BaseCase();
   double kernelEval = kernel.Evaluate(querySet.col(queryIndex),
                                       referenceSet.col(referenceIndex));
 
@@ -161,12 +181,12 @@ double FastMKSRules<KernelType, TreeType>::Score(const size_t queryIndex,
     }
 
     if (maxKernelBound < bestKernel)
-      return DBL_MAX;
+      return counters.ScoreResult(DBL_MAX);
   }
 
   // Calculate the maximum possible kernel value, either by calculating the
   // centroid or, if the centroid is a point, use that.
-  ++scores;
+  counters.Score();
   double kernelEval;
   if (tree::TreeTraits<TreeType>::FirstPointIsCentroid)
   {
@@ -215,7 +235,8 @@ double FastMKSRules<KernelType, TreeType>::Score(const size_t queryIndex,
 
   // We return the inverse of the maximum kernel so that larger kernels are
   // recursed into first.
-  return (maxKernel >= bestKernel) ? (1.0 / maxKernel) : DBL_MAX;
+  return counters.ScoreResult((maxKernel >= bestKernel) ? (1.0 / maxKernel) :
+      DBL_MAX);
 }
 
 template<typename KernelType, typename TreeType>
@@ -316,7 +337,7 @@ double FastMKSRules<KernelType, TreeType>::Score(TreeType& queryNode,
     // It is not possible that this node combination can contain a point
     // combination with kernel value better than the minimum kernel value to
     // improve any of the results, so we can prune it.
-    return DBL_MAX;
+    return counters.ScoreResult(DBL_MAX);
   }
 
   // We were unable to perform a parent-child or parent-parent prune, so now we
@@ -361,7 +382,7 @@ double FastMKSRules<KernelType, TreeType>::Score(TreeType& queryNode,
 
     traversalInfo.LastBaseCase() = kernelEval;
   }
-  ++scores;
+  counters.Score();
 
   double maxKernel;
   if (kernel::KernelTraits<KernelType>::IsNormalized)
@@ -404,7 +425,8 @@ double FastMKSRules<KernelType, TreeType>::Score(TreeType& queryNode,
 
   // We return the inverse of the maximum kernel so that larger kernels are
   // recursed into first.
-  return (maxKernel >= bestKernel) ? (1.0 / maxKernel) : DBL_MAX;
+  return counters.ScoreResult((maxKernel >= bestKernel) ? (1.0 / maxKernel) :
+      DBL_MAX);
 }
 
 template<typename KernelType, typename TreeType>
@@ -414,7 +436,8 @@ double FastMKSRules<KernelType, TreeType>::Rescore(const size_t queryIndex,
 {
   const double bestKernel = candidates[queryIndex].top().first;
 
-  return ((1.0 / oldScore) >= bestKernel) ? oldScore : DBL_MAX;
+  return counters.RescoreResult(oldScore,
+      ((1.0 / oldScore) >= bestKernel) ? oldScore : DBL_MAX);
 }
 
 template<typename KernelType, typename TreeType>
@@ -425,7 +448,8 @@ double FastMKSRules<KernelType, TreeType>::Rescore(TreeType& queryNode,
   queryNode.Stat().Bound() = CalculateBound(queryNode);
   const double bestKernel = queryNode.Stat().Bound();
 
-  return ((1.0 / oldScore) >= bestKernel) ? oldScore : DBL_MAX;
+  return counters.RescoreResult(oldScore,
+      ((1.0 / oldScore) >= bestKernel) ? oldScore : DBL_MAX);
 }
 
 /**
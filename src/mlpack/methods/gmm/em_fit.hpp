@@ -148,19 +148,42 @@ class EMFit
                          arma::vec& weights);
 
   /**
-   * Calculate the log-likelihood of a model.  Yes, this is reimplemented in the
-   * GMM code.  Intuition suggests that the log-likelihood is not the best way
-   * to determine if the EM algorithm has converged.
+   * The E-step: calculate the conditional probability of each Gaussian given
+   * each observation, and the log-likelihood of the model.  The probabilities
+   * are computed in the log domain and normalized with the log-sum-exp trick,
+   * for blocks of observations in parallel.  Yes, the log-likelihood is
+   * reimplemented in the GMM code.  Intuition suggests that the log-likelihood
+   * is not the best way to determine if the EM algorithm has converged.
    *
-   * @param data Data matrix.
-   * @param means Vector of means.
-   * @param covariances Vector of covariance matrices.
+   * @param observations List of observations.
+   * @param dists Gaussians of the model.
    * @param weights Vector of a priori weights.
+   * @param condProb Matrix to store the conditional probabilities in (one row
+   *     for each observation, one column for each Gaussian).
+   * @return The log-likelihood of the model.
+   */
+  double Expectation(const arma::mat& observations,
+                     const std::vector<distribution::GaussianDistribution>&
+                         dists,
+                     const arma::vec& weights,
+                     arma::mat& condProb) const;
+
+  /**
+   * The M-step: calculate the new means and covariances from the conditional
+   * probabilities (which may be weighted).  The scatter matrices are
+   * accumulated by each thread for its blocks of observations and then
+   * merged.  Gaussians with no probability are not updated.
+   *
+   * @param observations List of observations.
+   * @param condProb Conditional probabilities of each Gaussian given each
+   *     observation.
+   * @param probRowSums Sum of the conditional probabilities of each Gaussian.
+   * @param dists Gaussians to update.
    */
-  double LogLikelihood(const arma::mat& data,
-                       const std::vector<distribution::GaussianDistribution>&
-                           dists,
-                       const arma::vec& weights) const;
+  void Maximization(const arma::mat& observations,
+                    const arma::mat& condProb,
+                    const arma::vec& probRowSums,
+                    std::vector<distribution::GaussianDistribution>& dists);
 
   // Armadillo uses uword internally as an OpenMP index type, which crashes
   // Visual Studio.
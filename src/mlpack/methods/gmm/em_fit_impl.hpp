@@ -55,13 +55,15 @@ void EMFit<InitialClusteringType, CovarianceConstraintPolicy>::Estimate(
   if (!useInitialModel)
     InitialClustering(observations, dists, weights);
 
-  double l = LogLikelihood(observations, dists, weights);
+  // The E-step gives the log-likelihood of the model it is computed for, so
+  // each iteration computes the conditional probabilities for the next one.
+  arma::mat condProb;
+  double l = Expectation(observations, dists, weights, condProb);
 
   Log::Debug << "EMFit::Estimate(): initial clustering log-likelihood: "
       << l << std::endl;
 
   double lOld = -DBL_MAX;
-  arma::mat condProb(observations.n_cols, dists.size());
 
   // Iterate to update the model until no more improvement is found.
   size_t iteration = 1;
@@ -70,62 +72,21 @@ void EMFit<InitialClusteringType, CovarianceConstraintPolicy>::Estimate(
     Log::Info << "EMFit::Estimate(): iteration " << iteration << ", "
         << "log-likelihood " << l << "." << std::endl;
 
-    // Calculate the conditional probabilities of choosing a particular
-    // Gaussian given the observations and the present theta value.
-    for (size_t i = 0; i < dists.size(); i++)
-    {
-      // Store conditional probabilities into condProb vector for each
-      // Gaussian.  First we make an alias of the condProb vector.
-      arma::vec condProbAlias = condProb.unsafe_col(i);
-      dists[i].Probability(observations, condProbAlias);
-      condProbAlias *= weights[i];
-    }
-
-    // Normalize row-wise.
-    for (size_t i = 0; i < condProb.n_rows; i++)
-    {
-      // Avoid dividing by zero; if the probability for everything is 0, we
-      // don't want to make it NaN.
-      const double probSum = accu(condProb.row(i));
-      if (probSum != 0.0)
-        condProb.row(i) /= probSum;
-    }
-
     // Store the sum of the probability of each state over all the observations.
     arma::vec probRowSums = trans(arma::sum(condProb, 0 /* columnwise */));
 
-    // Calculate the new value of the means using the updated conditional
+    // Calculate the new means and covariances using the conditional
     // probabilities.
-    for (size_t i = 0; i < dists.size(); i++)
-    {
-      // Don't update if there's no probability of the Gaussian having points.
-      if (probRowSums[i] != 0)
-        dists[i].Mean() = (observations * condProb.col(i)) / probRowSums[i];
-
-      // Calculate the new value of the covariances using the updated
-      // conditional probabilities and the updated means.
-      arma::mat tmp = observations - (dists[i].Mean() *
-          arma::ones<arma::rowvec>(observations.n_cols));
-      arma::mat tmpB = tmp % (arma::ones<arma::vec>(observations.n_rows) *
-          trans(condProb.col(i)));
-
-      // Don't update if there's no probability of the Gaussian having points.
-      if (probRowSums[i] != 0.0)
-      {
-        arma::mat covariance = (tmp * trans(tmpB)) / probRowSums[i];
-        // Apply covariance constraint.
-        constraint.ApplyConstraint(covariance);
-        dists[i].Covariance(std::move(covariance));
-      }
-    }
+    Maximization(observations, condProb, probRowSums, dists);
 
     // Calculate the new values for omega using the updated conditional
     // probabilities.
     weights = probRowSums / observations.n_cols;
 
-    // Update values of l; calculate new log-likelihood.
+    // Update values of l; calculate new log-likelihood and the conditional
+    // probabilities of the new model.
     lOld = l;
-    l = LogLikelihood(observations, dists, weights);
+    l = Expectation(observations, dists, weights, condProb);
 
     iteration++;
   }
@@ -142,70 +103,29 @@ void EMFit<InitialClusteringType, CovarianceConstraintPolicy>::Estimate(
   if (!useInitialModel)
     InitialClustering(observations, dists, weights);
 
-  double l = LogLikelihood(observations, dists, weights);
+  arma::mat condProb;
+  double l = Expectation(observations, dists, weights, condProb);
 
   Log::Debug << "EMFit::Estimate(): initial clustering log-likelihood: "
       << l << std::endl;
 
   double lOld = -DBL_MAX;
-  arma::mat condProb(observations.n_cols, dists.size());
 
   // Iterate to update the model until no more improvement is found.
   size_t iteration = 1;
   while (std::abs(l - lOld) > tolerance && iteration != maxIterations)
   {
-    // Calculate the conditional probabilities of choosing a particular
-    // Gaussian given the observations and the present theta value.
-    for (size_t i = 0; i < dists.size(); i++)
-    {
-      // Store conditional probabilities into condProb vector for each
-      // Gaussian.  First we make an alias of the condProb vector.
-      arma::vec condProbAlias = condProb.unsafe_col(i);
-      dists[i].Probability(observations, condProbAlias);
-      condProbAlias *= weights[i];
-    }
-
-    // Normalize row-wise.
-    for (size_t i = 0; i < condProb.n_rows; i++)
-    {
-      // Avoid dividing by zero; if the probability for everything is 0, we
-      // don't want to make it NaN.
-      const double probSum = accu(condProb.row(i));
-      if (probSum != 0.0)
-        condProb.row(i) /= probSum;
-    }
+    // Weight the conditional probability of each point being from each
+    // Gaussian by the probability of the point being from this mixture model.
+    condProb.each_col() %= probabilities;
 
     // This will store the sum of probabilities of each state over all the
     // observations.
-    arma::vec probRowSums(dists.size());
+    arma::vec probRowSums = trans(arma::sum(condProb, 0 /* columnwise */));
 
-    // Calculate the new value of the means using the updated conditional
+    // Calculate the new means and covariances using the weighted conditional
     // probabilities.
-    for (size_t i = 0; i < dists.size(); i++)
-    {
-      // Calculate the sum of probabilities of points, which is the
-      // conditional probability of each point being from Gaussian i
-      // multiplied by the probability of the point being from this mixture
-      // model.
-      probRowSums[i] = accu(condProb.col(i) % probabilities);
-
-      dists[i].Mean() = (observations * (condProb.col(i) % probabilities)) /
-        probRowSums[i];
-
-      // Calculate the new value of the covariances using the updated
-      // conditional probabilities and the updated means.
-      arma::mat tmp = observations - (dists[i].Mean() *
-          arma::ones<arma::rowvec>(observations.n_cols));
-      arma::mat tmpB = tmp % (arma::ones<arma::vec>(observations.n_rows) *
-          trans(condProb.col(i) % probabilities));
-
-      arma::mat cov = (tmp * trans(tmpB)) / probRowSums[i];
-
-      // Apply covariance constraint.
-      constraint.ApplyConstraint(cov);
-
-      dists[i].Covariance(std::move(cov));
-    }
+    Maximization(observations, condProb, probRowSums, dists);
 
     // Calculate the new values for omega using the updated conditional
     // probabilities.
@@ -213,7 +133,7 @@ void EMFit<InitialClusteringType, CovarianceConstraintPolicy>::Estimate(
 
     // Update values of l; calculate new log-likelihood.
     lOld = l;
-    l = LogLikelihood(observations, dists, weights);
+    l = Expectation(observations, dists, weights, condProb);
 
     iteration++;
   }
@@ -287,31 +207,130 @@ InitialClustering(const arma::mat& observations,
 }
 
 template<typename InitialClusteringType, typename CovarianceConstraintPolicy>
-double EMFit<InitialClusteringType, CovarianceConstraintPolicy>::LogLikelihood(
+double EMFit<InitialClusteringType, CovarianceConstraintPolicy>::Expectation(
     const arma::mat& observations,
     const std::vector<distribution::GaussianDistribution>& dists,
-    const arma::vec& weights) const
+    const arma::vec& weights,
+    arma::mat& condProb) const
 {
-  double logLikelihood = 0;
+  condProb.set_size(observations.n_cols, dists.size());
+  const arma::vec logWeights = arma::log(weights);
+
+  double logLikelihood = 0.0;
+  size_t zeroLikelihoods = 0;
+
+  // The observations are processed in blocks, so that the temporaries of the
+  // log-density computations stay small.
+  const size_t blockSize = 1024;
+  const size_t numBlocks = (observations.n_cols + blockSize - 1) / blockSize;
+  #pragma omp parallel for schedule(dynamic) \
+      reduction(+:logLikelihood, zeroLikelihoods)
+  for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+  {
+    const size_t begin = b * blockSize;
+    const size_t end = std::min(begin + blockSize,
+        (size_t) observations.n_cols) - 1;
+    const arma::mat block = observations.cols(begin, end);
+
+    // Store the log of the joint probability of each observation and each
+    // Gaussian.
+    arma::vec logProbs;
+    for (size_t i = 0; i < dists.size(); ++i)
+    {
+      dists[i].LogProbability(block, logProbs);
+      condProb(arma::span(begin, end), i) = logProbs + logWeights[i];
+    }
 
-  arma::vec phis;
-  arma::mat likelihoods(dists.size(), observations.n_cols);
+    // Normalize row-wise with the log-sum-exp trick, so that points far from
+    // every Gaussian still get valid conditional probabilities.
+    for (size_t j = begin; j <= end; ++j)
+    {
+      const double maxLogProb = condProb.row(j).max();
+      if (maxLogProb == -std::numeric_limits<double>::infinity())
+      {
+        // Avoid making the probabilities NaN if the likelihood is 0.
+        condProb.row(j).zeros();
+        logLikelihood += maxLogProb;
+        ++zeroLikelihoods;
+        continue;
+      }
+
+      const double logSum = maxLogProb +
+          std::log(arma::accu(arma::exp(condProb.row(j) - maxLogProb)));
+      condProb.row(j) = arma::exp(condProb.row(j) - logSum);
+      logLikelihood += logSum;
+    }
+  }
+
+  if (zeroLikelihoods > 0)
+    Log::Info << "Likelihood of " << zeroLikelihoods << " points is 0!  They "
+        << "are probably outliers." << std::endl;
 
+  return logLikelihood;
+}
+
+template<typename InitialClusteringType, typename CovarianceConstraintPolicy>
+void EMFit<InitialClusteringType, CovarianceConstraintPolicy>::Maximization(
+    const arma::mat& observations,
+    const arma::mat& condProb,
+    const arma::vec& probRowSums,
+    std::vector<distribution::GaussianDistribution>& dists)
+{
+  // The new means are the weighted means of the observations.
+  const arma::mat means = observations * condProb;
   for (size_t i = 0; i < dists.size(); ++i)
   {
-    dists[i].Probability(observations, phis);
-    likelihoods.row(i) = weights(i) * trans(phis);
+    // Don't update if there's no probability of the Gaussian having points.
+    if (probRowSums[i] != 0.0)
+      dists[i].Mean() = means.col(i) / probRowSums[i];
   }
-  // Now sum over every point.
-  for (size_t j = 0; j < observations.n_cols; ++j)
+
+  // Accumulate the weighted scatter of each Gaussian around its new mean.
+  // Each thread sums the scatter of its blocks of observations, and then the
+  // sums are merged.
+  const size_t d = observations.n_rows;
+  arma::cube scatters(d, d, dists.size(), arma::fill::zeros);
+  const size_t blockSize = 1024;
+  const size_t numBlocks = (observations.n_cols + blockSize - 1) / blockSize;
+  #pragma omp parallel
   {
-    if (accu(likelihoods.col(j)) == 0)
-      Log::Info << "Likelihood of point " << j << " is 0!  It is probably an "
-          << "outlier." << std::endl;
-    logLikelihood += log(accu(likelihoods.col(j)));
+    arma::cube localScatters(d, d, dists.size(), arma::fill::zeros);
+
+    #pragma omp for schedule(dynamic)
+    for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+    {
+      const size_t begin = b * blockSize;
+      const size_t end = std::min(begin + blockSize,
+          (size_t) observations.n_cols) - 1;
+
+      for (size_t i = 0; i < dists.size(); ++i)
+      {
+        if (probRowSums[i] == 0.0)
+          continue;
+
+        arma::mat diffs = observations.cols(begin, end);
+        diffs.each_col() -= dists[i].Mean();
+        const arma::mat weightedDiffs = diffs.each_row() %
+            trans(condProb(arma::span(begin, end), i));
+        localScatters.slice(i) += weightedDiffs * trans(diffs);
+      }
+    }
+
+    #pragma omp critical
+    scatters += localScatters;
   }
 
-  return logLikelihood;
+  for (size_t i = 0; i < dists.size(); ++i)
+  {
+    // Don't update if there's no probability of the Gaussian having points.
+    if (probRowSums[i] != 0.0)
+    {
+      arma::mat covariance = scatters.slice(i) / probRowSums[i];
+      // Apply covariance constraint.
+      constraint.ApplyConstraint(covariance);
+      dists[i].Covariance(std::move(covariance));
+    }
+  }
 }
 
 template<typename InitialClusteringType, typename CovarianceConstraintPolicy>
@@ -27,7 +27,8 @@ GMM::GMM(const size_t gaussians, const size_t dimensionality) :
     gaussians(gaussians),
     dimensionality(dimensionality),
     dists(gaussians, distribution::GaussianDistribution(dimensionality)),
-    weights(gaussians)
+    weights(gaussians),
+    updates(0)
 {
   // Set equal weights.  Technically this model is still valid, but only barely.
   weights.fill(1.0 / gaussians);
@@ -38,7 +39,8 @@ GMM::GMM(const GMM& other) :
     gaussians(other.Gaussians()),
     dimensionality(other.dimensionality),
     dists(other.dists),
-    weights(other.weights) { /* Nothing to do. */ }
+    weights(other.weights),
+    updates(other.updates) { /* Nothing to do. */ }
 
 GMM& GMM::operator=(const GMM& other)
 {
@@ -46,6 +48,7 @@ GMM& GMM::operator=(const GMM& other)
   dimensionality = other.dimensionality;
   dists = other.dists;
   weights = other.weights;
+  updates = other.updates;
 
   return *this;
 }
@@ -76,6 +79,54 @@ double GMM::Probability(const arma::vec& observation,
   return weights[component] * dists[component].Probability(observation);
 }
 
+/**
+ * Compute the log-probability of each of the given observations.
+ */
+void GMM::LogProbability(const arma::mat& observations,
+                         arma::vec& logProbabilities) const
+{
+  arma::mat logProbs;
+  ComponentLogProbabilities(observations, logProbs);
+
+  // Sum the probabilities of the components of each observation in the log
+  // domain, for all the observations at once.  If every component gives an
+  // observation zero probability, the shift is 0, so that its log-probability
+  // comes out as -inf and not NaN.
+  arma::vec maxLogProbs = trans(arma::max(logProbs, 0));
+  maxLogProbs.elem(arma::find(maxLogProbs ==
+      -std::numeric_limits<double>::infinity())).zeros();
+  logProbs.each_row() -= trans(maxLogProbs);
+
+  logProbabilities = maxLogProbs +
+      trans(arma::log(arma::sum(arma::exp(logProbs), 0)));
+}
+
+/**
+ * Compute the probability of each of the given observations.
+ */
+void GMM::Probability(const arma::mat& observations,
+                      arma::vec& probabilities) const
+{
+  LogProbability(observations, probabilities);
+  probabilities = arma::exp(probabilities);
+}
+
+/**
+ * Compute the log-probability of each observation under each component,
+ * including the prior weight of the component.
+ */
+void GMM::ComponentLogProbabilities(const arma::mat& observations,
+                                    arma::mat& logProbs) const
+{
+  logProbs.set_size(gaussians, observations.n_cols);
+  arma::vec componentLogProbs;
+  for (size_t i = 0; i < gaussians; ++i)
+  {
+    dists[i].LogProbability(observations, componentLogProbs);
+    logProbs.row(i) = trans(componentLogProbs) + std::log(weights[i]);
+  }
+}
+
 /**
  * Return a randomly generated observation according to the probability
  * distribution defined by this object.
@@ -97,8 +148,116 @@ arma::vec GMM::Random() const
     }
   }
 
-  return trans(chol(dists[gaussian].Covariance())) *
-      arma::randn<arma::vec>(dimensionality) + dists[gaussian].Mean();
+  return dists[gaussian].Random();
+}
+
+/**
+ * Generate the given number of random observations at once.
+ */
+void GMM::Random(const size_t n, arma::mat& samples) const
+{
+  samples.set_size(dimensionality, n);
+
+  // Determine which Gaussian each observation will be coming from.
+  const arma::vec cumulativeWeights = arma::cumsum(weights);
+  arma::Col<size_t> components(n);
+  arma::Col<size_t> counts(gaussians, arma::fill::zeros);
+  for (size_t i = 0; i < n; ++i)
+  {
+    const double gaussRand = math::Random();
+    size_t gaussian = 0;
+    while (gaussian + 1 < gaussians && gaussRand > cumulativeWeights[gaussian])
+      ++gaussian;
+
+    components[i] = gaussian;
+    ++counts[gaussian];
+  }
+
+  // Generate the observations of each Gaussian together, and scatter them to
+  // their columns.
+  arma::mat componentSamples;
+  for (size_t g = 0; g < gaussians; ++g)
+  {
+    if (counts[g] == 0)
+      continue;
+
+    dists[g].Random(counts[g], componentSamples);
+    const arma::uvec indices = arma::find(components == g);
+    samples.cols(indices) = componentSamples;
+  }
+}
+
+/**
+ * Update the model with a batch of observations, with one step of stepwise EM.
+ */
+double GMM::Update(const arma::mat& observations,
+                   const double stepSizeExponent)
+{
+  ++updates;
+  const double stepSize = std::pow((double) updates + 1.0, -stepSizeExponent);
+  return Update(observations, arma::ones<arma::vec>(observations.n_cols),
+      stepSize);
+}
+
+/**
+ * Take one step of stepwise EM towards the given weighted observations.
+ */
+double GMM::Update(const arma::mat& observations,
+                   const arma::vec& probabilities,
+                   const double stepSize)
+{
+  if (observations.n_rows != dimensionality)
+  {
+    std::ostringstream oss;
+    oss << "GMM::Update(): observations have dimensionality "
+        << observations.n_rows << ", but the model has dimensionality "
+        << dimensionality << "!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  // The E-step: compute the conditional probability of each Gaussian for each
+  // observation in the log domain, and weight it by the probability of the
+  // observation.
+  arma::mat condProb;
+  ComponentLogProbabilities(observations, condProb);
+
+  double logLikelihood = 0.0;
+  for (size_t j = 0; j < observations.n_cols; ++j)
+  {
+    const double maxLogProb = condProb.col(j).max();
+    if (maxLogProb == -std::numeric_limits<double>::infinity())
+    {
+      condProb.col(j).zeros();
+      continue;
+    }
+
+    const double logSum = maxLogProb +
+        std::log(arma::accu(arma::exp(condProb.col(j) - maxLogProb)));
+    condProb.col(j) = probabilities[j] * arma::exp(condProb.col(j) - logSum);
+    logLikelihood += probabilities[j] * logSum;
+  }
+
+  const double sumProb = arma::accu(probabilities);
+  if (stepSize <= 0.0 || sumProb == 0.0)
+    return logLikelihood;
+
+  // The M-step: interpolate the weights, and then each Gaussian.  The
+  // statistics of each Gaussian are scaled by its weight, so its own step size
+  // is the share of its new weight that comes from the batch.
+  const arma::vec batchWeights = arma::sum(condProb, 1) / sumProb;
+  const arma::vec newWeights = (1.0 - stepSize) * weights +
+      stepSize * batchWeights;
+  for (size_t i = 0; i < gaussians; ++i)
+  {
+    if (newWeights[i] > 0.0)
+    {
+      dists[i].Update(observations, trans(condProb.row(i)),
+          stepSize * batchWeights[i] / newWeights[i]);
+    }
+  }
+  weights = newWeights;
+
+  return logLikelihood;
 }
 
 /**
@@ -108,24 +267,18 @@ arma::vec GMM::Random() const
 void GMM::Classify(const arma::mat& observations,
                    arma::Row<size_t>& labels) const
 {
-  // This is not the best way to do this!
+  // Compute the probabilities of all the components for all the observations
+  // at once, in the log domain, and take the most probable component of each
+  // observation.
+  arma::mat logProbs;
+  ComponentLogProbabilities(observations, logProbs);
 
-  // We should not have to fill this with values, because each one should be
-  // overwritten.
   labels.set_size(observations.n_cols);
+  arma::uword index;
   for (size_t i = 0; i < observations.n_cols; ++i)
   {
-    // Find maximum probability component.
-    double probability = 0;
-    for (size_t j = 0; j < gaussians; ++j)
-    {
-      double newProb = Probability(observations.unsafe_col(i), j);
-      if (newProb >= probability)
-      {
-        probability = newProb;
-        labels[i] = j;
-      }
-    }
+    logProbs.unsafe_col(i).max(index);
+    labels[i] = index;
   }
 }
 
@@ -148,8 +301,7 @@ double GMM::LogLikelihood(
   }
 
   // Now sum over every point.
-  for (size_t j = 0; j < data.n_cols; j++)
-    loglikelihood += log(accu(likelihoods.col(j)));
+  loglikelihood = accu(log(arma::sum(likelihoods, 0)));
   return loglikelihood;
 }
 
@@ -15,6 +15,7 @@
 #define MLPACK_METHODS_MOG_MOG_EM_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/core/math/random.hpp>
 
 // This is the default fitting method class.
 #include "em_fit.hpp"
@@ -90,13 +91,17 @@ class GMM
   //! Vector of a priori weights for each Gaussian.
   arma::vec weights;
 
+  //! The number of online updates done with Update().
+  size_t updates;
+
  public:
   /**
    * Create an empty Gaussian Mixture Model, with zero gaussians.
    */
   GMM() :
       gaussians(0),
-      dimensionality(0)
+      dimensionality(0),
+      updates(0)
   {
     // Warn the user.  They probably don't want to do this.  If this constructor
     // is being used (because it is required by some template classes), the user
@@ -125,7 +130,8 @@ class GMM
       gaussians(dists.size()),
       dimensionality((!dists.empty()) ? dists[0].Mean().n_elem : 0),
       dists(dists),
-      weights(weights) { /* Nothing to do. */ }
+      weights(weights),
+      updates(0) { /* Nothing to do. */ }
 
   //! Copy constructor for GMMs.
   GMM(const GMM& other);
@@ -175,6 +181,27 @@ class GMM
   double Probability(const arma::vec& observation,
                      const size_t component) const;
 
+  /**
+   * Compute the log-probability of each of the given observations under this
+   * distribution.  The log-probabilities of the components are combined in
+   * the log domain, so they do not underflow.
+   *
+   * @param observations Observations to evaluate the log-probability of.
+   * @param logProbabilities Vector to store the log-probabilities in.
+   */
+  void LogProbability(const arma::mat& observations,
+                      arma::vec& logProbabilities) const;
+
+  /**
+   * Compute the probability of each of the given observations under this
+   * distribution, for all the observations at once.
+   *
+   * @param observations Observations to evaluate the probability of.
+   * @param probabilities Vector to store the probabilities in.
+   */
+  void Probability(const arma::mat& observations,
+                   arma::vec& probabilities) const;
+
   /**
    * Return a randomly generated observation according to the probability
    * distribution defined by this object.
@@ -183,6 +210,16 @@ class GMM
    */
   arma::vec Random() const;
 
+  /**
+   * Generate the given number of random observations at once, as the columns of
+   * the given matrix.  The component of every observation is drawn first, and
+   * then the observations of each component are generated together.
+   *
+   * @param n Number of observations to generate.
+   * @param samples Matrix to store the observations in.
+   */
+  void Random(const size_t n, arma::mat& samples) const;
+
   /**
    * Estimate the probability distribution directly from the given observations,
    * using the given algorithm in the FittingType class to fit the data.
@@ -242,6 +279,58 @@ class GMM
                const bool useExistingModel = false,
                FittingType fitter = FittingType());
 
+  /**
+   * Update the model with a batch of observations, with one step of stepwise
+   * (online) EM: the sufficient statistics of the model (the weights, and the
+   * weighted means and second moments of the Gaussians) are replaced by
+   * (1 - eta) times their current value plus eta times their average over the
+   * batch, where eta = (t + 1)^(-stepSizeExponent) for the t'th update.  This
+   * allows a model to be trained on a stream of data that does not fit in
+   * memory; the model should be trained with Train() on a first batch, so that
+   * the Gaussians are not all the same.
+   *
+   * For more information, see the following paper.
+   *
+   * @code
+   * @inproceedings{liang2009online,
+   *   title={Online {EM} for Unsupervised Models},
+   *   author={Liang, Percy and Klein, Dan},
+   *   booktitle={Proceedings of Human Language Technologies: The 2009 Annual
+   *       Conference of the North American Chapter of the ACL},
+   *   pages={611--619},
+   *   year={2009}
+   * }
+   * @endcode
+   *
+   * @param observations Batch of observations.
+   * @param stepSizeExponent Exponent of the step size schedule, in (0.5, 1].
+   * @return The log-likelihood of the batch under the model before the update.
+   */
+  double Update(const arma::mat& observations,
+                const double stepSizeExponent = 0.7);
+
+  /**
+   * Take one step of stepwise EM towards the given batch of observations with
+   * the given step size, taking into account the probability of each
+   * observation actually being from this distribution (as used by HMM).  This
+   * does not change the number of updates.
+   *
+   * @param observations Batch of observations.
+   * @param probabilities Probability of each observation being from this GMM.
+   * @param stepSize Weight of the batch, in (0, 1].
+   * @return The weighted log-likelihood of the batch under the model before
+   *     the update.
+   */
+  double Update(const arma::mat& observations,
+                const arma::vec& probabilities,
+                const double stepSize);
+
+  //! Get the number of online updates done with Update().
+  size_t Updates() const { return updates; }
+  //! Modify the number of online updates (set it to 0 to restart the step
+  //! size schedule).
+  size_t& Updates() { return updates; }
+
   /**
    * Classify the given observations as being from an individual component in
    * this GMM.  The resultant classifications are stored in the 'labels' object,
@@ -268,6 +357,38 @@ class GMM
   void serialize(Archive& ar, const unsigned int /* version */);
 
  private:
+  /**
+   * Compute the log-probability of each observation under each component,
+   * including the a priori weight of the component, for all the observations
+   * at once.
+   *
+   * @param observations Observations to evaluate the log-probabilities of.
+   * @param logProbs Matrix to store the log-probabilities in (one row per
+   *     component, one column per observation).
+   */
+  void ComponentLogProbabilities(const arma::mat& observations,
+                                 arma::mat& logProbs) const;
+
+  /**
+   * Perform the given number of trials of the fitting in parallel, and keep
+   * the model with the greatest log-likelihood.  This is used by GMM::Train().
+   *
+   * @param observations Observations of the model.
+   * @param trials Number of trials to perform.
+   * @param useExistingModel If true, each trial starts from the existing model.
+   * @param fitter Fitter to copy for each trial.
+   * @param estimate Function that fits a model with the given fitter.
+   * @param log Stream to report the log-likelihood of each trial to.
+   * @return The log-likelihood of the best model.
+   */
+  template<typename FittingType, typename EstimateType>
+  double TrainTrials(const arma::mat& observations,
+                     const size_t trials,
+                     const bool useExistingModel,
+                     const FittingType& fitter,
+                     const EstimateType& estimate,
+                     util::PrefixedOutStream& log);
+
   /**
    * This function computes the loglikelihood of the given model.  This function
    * is used by GMM::Train().
@@ -286,6 +407,9 @@ class GMM
 } // namespace gmm
 } // namespace mlpack
 
+//! Set the serialization version of the GMM class.
+BOOST_CLASS_VERSION(mlpack::gmm::GMM, 1);
+
 // Include implementation.
 #include "gmm_impl.hpp"
 
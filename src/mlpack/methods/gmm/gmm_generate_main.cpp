@@ -59,9 +59,8 @@ void mlpackMain()
 
   size_t length = (size_t) CLI::GetParam<int>("samples");
   Log::Info << "Generating " << length << " samples..." << endl;
-  arma::mat samples(gmm.Dimensionality(), length);
-  for (size_t i = 0; i < length; ++i)
-    samples.col(i) = gmm.Random();
+  arma::mat samples;
+  gmm.Random(length, samples);
 
   // Save, if the user asked for it.
   if (CLI::HasParam("output"))
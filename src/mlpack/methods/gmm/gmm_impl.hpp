@@ -44,55 +44,14 @@ double GMM::Train(const arma::mat& observations,
     if (trials == 0)
       return -DBL_MAX; // It's what they asked for...
 
-    // If each trial must start from the same initial location, we must save it.
-    std::vector<distribution::GaussianDistribution> distsOrig;
-    arma::vec weightsOrig;
-    if (useExistingModel)
-    {
-      distsOrig = dists;
-      weightsOrig = weights;
-    }
-
-    // We need to keep temporary copies.  We'll do the first training into the
-    // actual model position, so that if it's the best we don't need to copy it.
-    fitter.Estimate(observations, dists, weights, useExistingModel);
-
-    bestLikelihood = LogLikelihood(observations, dists, weights);
-
-    Log::Info << "GMM::Train(): Log-likelihood of trial 0 is "
-        << bestLikelihood << "." << std::endl;
-
-    // Now the temporary model.
-    std::vector<distribution::GaussianDistribution> distsTrial(gaussians,
-        distribution::GaussianDistribution(dimensionality));
-    arma::vec weightsTrial(gaussians);
-
-    for (size_t trial = 1; trial < trials; ++trial)
-    {
-      if (useExistingModel)
-      {
-        distsTrial = distsOrig;
-        weightsTrial = weightsOrig;
-      }
-
-      fitter.Estimate(observations, distsTrial, weightsTrial, useExistingModel);
-
-      // Check to see if the log-likelihood of this one is better.
-      double newLikelihood = LogLikelihood(observations, distsTrial,
-          weightsTrial);
-
-      Log::Info << "GMM::Train(): Log-likelihood of trial " << trial << " is "
-          << newLikelihood << "." << std::endl;
-
-      if (newLikelihood > bestLikelihood)
-      {
-        // Save new likelihood and copy new model.
-        bestLikelihood = newLikelihood;
-
-        dists = distsTrial;
-        weights = weightsTrial;
-      }
-    }
+    bestLikelihood = TrainTrials(observations, trials, useExistingModel,
+        fitter, [&](FittingType& trialFitter,
+                    std::vector<distribution::GaussianDistribution>& trialDists,
+                    arma::vec& trialWeights)
+        {
+          trialFitter.Estimate(observations, trialDists, trialWeights,
+              useExistingModel);
+        }, Log::Info);
   }
 
   // Report final log-likelihood and return it.
@@ -128,57 +87,14 @@ double GMM::Train(const arma::mat& observations,
     if (trials == 0)
       return -DBL_MAX; // It's what they asked for...
 
-    // If each trial must start from the same initial location, we must save it.
-    std::vector<distribution::GaussianDistribution> distsOrig;
-    arma::vec weightsOrig;
-    if (useExistingModel)
-    {
-      distsOrig = dists;
-      weightsOrig = weights;
-    }
-
-    // We need to keep temporary copies.  We'll do the first training into the
-    // actual model position, so that if it's the best we don't need to copy it.
-    fitter.Estimate(observations, probabilities, dists, weights,
-        useExistingModel);
-
-    bestLikelihood = LogLikelihood(observations, dists, weights);
-
-    Log::Debug << "GMM::Train(): Log-likelihood of trial 0 is "
-        << bestLikelihood << "." << std::endl;
-
-    // Now the temporary model.
-    std::vector<distribution::GaussianDistribution> distsTrial(gaussians,
-        distribution::GaussianDistribution(dimensionality));
-    arma::vec weightsTrial(gaussians);
-
-    for (size_t trial = 1; trial < trials; ++trial)
-    {
-      if (useExistingModel)
-      {
-        distsTrial = distsOrig;
-        weightsTrial = weightsOrig;
-      }
-
-      fitter.Estimate(observations, probabilities, distsTrial, weightsTrial,
-          useExistingModel);
-
-      // Check to see if the log-likelihood of this one is better.
-      double newLikelihood = LogLikelihood(observations, distsTrial,
-          weightsTrial);
-
-      Log::Debug << "GMM::Train(): Log-likelihood of trial " << trial << " is "
-          << newLikelihood << "." << std::endl;
-
-      if (newLikelihood > bestLikelihood)
-      {
-        // Save new likelihood and copy new model.
-        bestLikelihood = newLikelihood;
-
-        dists = distsTrial;
-        weights = weightsTrial;
-      }
-    }
+    bestLikelihood = TrainTrials(observations, trials, useExistingModel,
+        fitter, [&](FittingType& trialFitter,
+                    std::vector<distribution::GaussianDistribution>& trialDists,
+                    arma::vec& trialWeights)
+        {
+          trialFitter.Estimate(observations, probabilities, trialDists,
+              trialWeights, useExistingModel);
+        }, Log::Debug);
   }
 
   // Report final log-likelihood and return it.
@@ -187,11 +103,61 @@ double GMM::Train(const arma::mat& observations,
   return bestLikelihood;
 }
 
+/**
+ * Run the trials of the fitting in parallel, and keep the best model.
+ */
+template<typename FittingType, typename EstimateType>
+double GMM::TrainTrials(const arma::mat& observations,
+                        const size_t trials,
+                        const bool useExistingModel,
+                        const FittingType& fitter,
+                        const EstimateType& estimate,
+                        util::PrefixedOutStream& log)
+{
+  // If each trial must start from the same initial location, each gets a copy
+  // of the current model.
+  std::vector<std::vector<distribution::GaussianDistribution>> trialDists(
+      trials, useExistingModel ? dists :
+      std::vector<distribution::GaussianDistribution>(gaussians,
+      distribution::GaussianDistribution(dimensionality)));
+  std::vector<arma::vec> trialWeights(trials,
+      useExistingModel ? weights : arma::vec(gaussians));
+  arma::vec likelihoods(trials);
+
+  // The trials are independent: each has its own copy of the fitter and its
+  // own random stream, so the result does not depend on the number of threads.
+  // The parallel loops of the fitting get a single thread inside this region,
+  // so the trials share the thread budget instead of oversubscribing it.
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t trial = 0; trial < (omp_size_t) trials; ++trial)
+  {
+    math::RandomStreamScope stream(trial);
+    FittingType trialFitter(fitter);
+    estimate(trialFitter, trialDists[trial], trialWeights[trial]);
+    likelihoods[trial] = LogLikelihood(observations, trialDists[trial],
+        trialWeights[trial]);
+  }
+
+  size_t best = 0;
+  for (size_t trial = 0; trial < trials; ++trial)
+  {
+    log << "GMM::Train(): Log-likelihood of trial " << trial << " is "
+        << likelihoods[trial] << "." << std::endl;
+
+    if (likelihoods[trial] > likelihoods[best])
+      best = trial;
+  }
+
+  dists = std::move(trialDists[best]);
+  weights = std::move(trialWeights[best]);
+  return likelihoods[best];
+}
+
 /**
  * Serialize the object.
  */
 template<typename Archive>
-void GMM::serialize(Archive& ar, const unsigned int /* version */)
+void GMM::serialize(Archive& ar, const unsigned int version)
 {
   ar & BOOST_SERIALIZATION_NVP(gaussians);
   ar & BOOST_SERIALIZATION_NVP(dimensionality);
@@ -205,6 +171,12 @@ void GMM::serialize(Archive& ar, const unsigned int /* version */)
   ar & BOOST_SERIALIZATION_NVP(dists);
 
   ar & BOOST_SERIALIZATION_NVP(weights);
+
+  // Older models don't have the number of online updates.
+  if (version > 0)
+    ar & BOOST_SERIALIZATION_NVP(updates);
+  else if (Archive::is_loading::value)
+    updates = 0;
 }
 
 } // namespace gmm
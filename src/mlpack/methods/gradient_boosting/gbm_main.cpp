@@ -0,0 +1,292 @@
+/**
+ * @file gbm_main.cpp
+ *
+ * A program to train and apply gradient boosted decision trees.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/methods/gradient_boosting/gradient_boosting.hpp>
+#include <mlpack/core/util/mlpack_main.hpp>
+
+using namespace mlpack;
+using namespace mlpack::tree;
+using namespace mlpack::util;
+using namespace std;
+
+PROGRAM_INFO("Gradient boosted decision trees",
+    "This program trains gradient boosted decision trees, in the style of "
+    "XGBoost and LightGBM, for regression or multiclass classification.  "
+    "Each round fits a regression tree to the gradients of the loss (the "
+    "squared error for regression, the softmax cross-entropy for "
+    "classification); splits are found with histograms of binned values."
+    "\n\n"
+    "To train a classifier, pass the " + PRINT_PARAM_STRING("training") +
+    " set with its " + PRINT_PARAM_STRING("labels") + "; to train a regression "
+    "model, pass the " + PRINT_PARAM_STRING("training") + " set with its " +
+    PRINT_PARAM_STRING("responses") + ".  If a " +
+    PRINT_PARAM_STRING("validation") + " set is given (with "
+    "its labels or responses), training stops when the loss on it has not "
+    "improved for " + PRINT_PARAM_STRING("early_stopping_rounds") + " rounds."
+    "\n\n"
+    "A trained model can be saved with " + PRINT_PARAM_STRING("output_model") +
+    " and loaded with " + PRINT_PARAM_STRING("input_model") + ".  The "
+    "predictions for the " + PRINT_PARAM_STRING("test") + " set are saved to "
+    + PRINT_PARAM_STRING("predictions") + " and " +
+    PRINT_PARAM_STRING("probabilities") + " for a classifier, and to " +
+    PRINT_PARAM_STRING("predicted_responses") + " for a regression model.");
+
+PARAM_MATRIX_IN("training", "Training dataset.", "t");
+PARAM_UROW_IN("labels", "Labels for the training dataset (for "
+    "classification).", "l");
+PARAM_ROW_IN("responses", "Responses for the training dataset (for "
+    "regression).", "r");
+
+PARAM_MATRIX_IN("validation", "Validation dataset, for early stopping.", "V");
+PARAM_UROW_IN("validation_labels", "Labels for the validation dataset.", "b");
+PARAM_ROW_IN("validation_responses", "Responses for the validation dataset.",
+    "u");
+
+PARAM_MATRIX_IN("test", "Test dataset to produce predictions for.", "T");
+
+PARAM_INT_IN("num_rounds", "Maximum number of boosting rounds.", "N", 100);
+PARAM_DOUBLE_IN("learning_rate", "Factor the output of each tree is scaled "
+    "by.", "e", 0.1);
+PARAM_INT_IN("max_depth", "Maximum depth of each tree.", "D", 6);
+PARAM_INT_IN("minimum_leaf_size", "Minimum number of points in each leaf.",
+    "n", 20);
+PARAM_DOUBLE_IN("lambda", "L2 regularization of the leaf values.", "A", 1.0);
+PARAM_DOUBLE_IN("row_subsample", "Fraction of the points used at each round.",
+    "R", 1.0);
+PARAM_DOUBLE_IN("column_subsample", "Fraction of the dimensions each tree may "
+    "split on.", "C", 1.0);
+PARAM_INT_IN("max_bins", "Maximum number of bins of each dimension (at most "
+    "256).", "B", 256);
+PARAM_INT_IN("early_stopping_rounds", "Number of rounds without improvement on "
+    "the validation set before stopping (0 means never stop early).", "E", 10);
+PARAM_INT_IN("seed", "Random seed.  If 0, 'std::time(NULL)' is used.", "s", 0);
+
+PARAM_UROW_OUT("predictions", "Predicted classes for each point in the test "
+    "set.", "p");
+PARAM_MATRIX_OUT("probabilities", "Predicted class probabilities for each "
+    "point in the test set.", "P");
+PARAM_ROW_OUT("predicted_responses", "Predicted responses for each point in "
+    "the test set.", "o");
+
+/**
+ * This is the class that we will serialize.  It is a simple wrapper around
+ * GradientBoosting.
+ */
+class GradientBoostingModel
+{
+ public:
+  // The model itself, left public for direct access by this program.
+  GradientBoosting gbm;
+
+  // Create the model.
+  GradientBoostingModel() { /* Nothing to do. */ }
+
+  // Serialize the model.
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */)
+  {
+    ar & BOOST_SERIALIZATION_NVP(gbm);
+  }
+};
+
+PARAM_MODEL_IN(GradientBoostingModel, "input_model", "Pre-trained model to use "
+    "for prediction.", "m");
+PARAM_MODEL_OUT(GradientBoostingModel, "output_model", "Model to save trained "
+    "gradient boosted trees to.", "M");
+
+void mlpackMain()
+{
+  if (CLI::GetParam<int>("seed") != 0)
+    math::RandomSeed((size_t) CLI::GetParam<int>("seed"));
+  else
+    math::RandomSeed((size_t) std::time(NULL));
+
+  // Check for incompatible input parameters.
+  RequireOnlyOnePassed({ "training", "input_model" }, true);
+  if (CLI::HasParam("training"))
+  {
+    RequireOnlyOnePassed({ "labels", "responses" }, true, "must pass labels "
+        "(for classification) or responses (for regression) with the training "
+        "set");
+  }
+
+  ReportIgnoredParam({{ "training", false }}, "validation");
+  ReportIgnoredParam({{ "validation", false }}, "validation_labels");
+  ReportIgnoredParam({{ "validation", false }}, "validation_responses");
+  if (CLI::HasParam("training") && CLI::HasParam("validation"))
+  {
+    if (CLI::HasParam("labels"))
+    {
+      RequireAtLeastOnePassed({ "validation_labels" }, true, "must pass labels "
+          "for the validation set");
+    }
+    else
+    {
+      RequireAtLeastOnePassed({ "validation_responses" }, true, "must pass "
+          "responses for the validation set");
+    }
+  }
+
+  RequireAtLeastOnePassed({ "test", "output_model" }, false, "the trained "
+      "model will not be used or saved");
+  if (CLI::HasParam("test"))
+  {
+    RequireAtLeastOnePassed({ "predictions", "probabilities",
+        "predicted_responses" }, false, "no test output will be saved");
+  }
+  ReportIgnoredParam({{ "test", false }}, "predictions");
+  ReportIgnoredParam({{ "test", false }}, "probabilities");
+  ReportIgnoredParam({{ "test", false }}, "predicted_responses");
+
+  RequireParamValue<int>("num_rounds", [](int x) { return x > 0; }, true,
+      "number of rounds must be positive");
+  RequireParamValue<double>("learning_rate", [](double x) { return x > 0.0; },
+      true, "learning rate must be positive");
+  RequireParamValue<int>("max_depth", [](int x) { return x >= 0; }, true,
+      "maximum depth must not be negative");
+  RequireParamValue<int>("minimum_leaf_size", [](int x) { return x > 0; },
+      true, "minimum leaf size must be positive");
+  RequireParamValue<double>("lambda", [](double x) { return x >= 0.0; }, true,
+      "lambda must not be negative");
+  RequireParamValue<double>("row_subsample",
+      [](double x) { return x > 0.0 && x <= 1.0; }, true,
+      "row subsample must be in (0, 1]");
+  RequireParamValue<double>("column_subsample",
+      [](double x) { return x > 0.0 && x <= 1.0; }, true,
+      "column subsample must be in (0, 1]");
+  RequireParamValue<int>("max_bins", [](int x) { return x >= 2 && x <= 256; },
+      true, "maximum number of bins must be between 2 and 256");
+  RequireParamValue<int>("early_stopping_rounds", [](int x) { return x >= 0; },
+      true, "early stopping rounds must not be negative");
+
+  // A loaded model is used in place.
+  GradientBoostingModel trainedModel;
+  GradientBoostingModel& model = CLI::HasParam("training") ? trainedModel :
+      CLI::GetParam<GradientBoostingModel>("input_model");
+  if (CLI::HasParam("training"))
+  {
+    GradientBoosting& gbm = model.gbm;
+    gbm.NumRounds() = (size_t) CLI::GetParam<int>("num_rounds");
+    gbm.LearningRate() = CLI::GetParam<double>("learning_rate");
+    gbm.MaxDepth() = (size_t) CLI::GetParam<int>("max_depth");
+    gbm.MinimumLeafSize() = (size_t) CLI::GetParam<int>("minimum_leaf_size");
+    gbm.Lambda() = CLI::GetParam<double>("lambda");
+    gbm.RowSubsample() = CLI::GetParam<double>("row_subsample");
+    gbm.ColumnSubsample() = CLI::GetParam<double>("column_subsample");
+    gbm.MaxBins() = (size_t) CLI::GetParam<int>("max_bins");
+    gbm.EarlyStoppingRounds() =
+        (size_t) CLI::GetParam<int>("early_stopping_rounds");
+
+    arma::mat data = std::move(CLI::GetParam<arma::mat>("training"));
+    const bool validation = CLI::HasParam("validation");
+    arma::mat validationData;
+    if (validation)
+      validationData = std::move(CLI::GetParam<arma::mat>("validation"));
+
+    Timer::Start("gbm_training");
+    if (CLI::HasParam("labels"))
+    {
+      arma::Row<size_t> labels =
+          std::move(CLI::GetParam<arma::Row<size_t>>("labels"));
+      const size_t numClasses = arma::max(labels) + 1;
+      Log::Info << "Training gradient boosted trees for " << numClasses
+          << " classes..." << endl;
+
+      if (validation)
+      {
+        arma::Row<size_t> validationLabels =
+            std::move(CLI::GetParam<arma::Row<size_t>>("validation_labels"));
+        gbm.Train(data, labels, std::max(numClasses, (size_t) 2),
+            validationData, validationLabels);
+      }
+      else
+      {
+        gbm.Train(data, labels, std::max(numClasses, (size_t) 2));
+      }
+    }
+    else
+    {
+      arma::rowvec responses =
+          std::move(CLI::GetParam<arma::rowvec>("responses"));
+      Log::Info << "Training gradient boosted regression trees..." << endl;
+
+      if (validation)
+      {
+        arma::rowvec validationResponses =
+            std::move(CLI::GetParam<arma::rowvec>("validation_responses"));
+        gbm.Train(data, responses, validationData, validationResponses);
+      }
+      else
+      {
+        gbm.Train(data, responses);
+      }
+    }
+    Timer::Stop("gbm_training");
+
+    Log::Info << "Trained " << gbm.NumTrees() << " trees." << endl;
+  }
+
+  if (CLI::HasParam("test"))
+  {
+    arma::mat testData = std::move(CLI::GetParam<arma::mat>("test"));
+
+    Timer::Start("gbm_prediction");
+    if (model.gbm.NumClasses() > 0)
+    {
+      if (CLI::HasParam("predicted_responses"))
+      {
+        Log::Warn << "The model is a classifier; "
+            << PRINT_PARAM_STRING("predicted_responses") << " will not be "
+            << "saved." << endl;
+      }
+
+      arma::Row<size_t> predictions;
+      arma::mat probabilities;
+      model.gbm.Classify(testData, predictions, probabilities);
+
+      if (CLI::HasParam("predictions"))
+      {
+        CLI::GetParam<arma::Row<size_t>>("predictions") =
+            std::move(predictions);
+      }
+      if (CLI::HasParam("probabilities"))
+        CLI::GetParam<arma::mat>("probabilities") = std::move(probabilities);
+    }
+    else
+    {
+      if (CLI::HasParam("predictions") || CLI::HasParam("probabilities"))
+      {
+        Log::Warn << "The model is a regression model; only "
+            << PRINT_PARAM_STRING("predicted_responses") << " will be saved."
+            << endl;
+      }
+
+      arma::rowvec predictions;
+      model.gbm.Predict(testData, predictions);
+
+      if (CLI::HasParam("predicted_responses"))
+      {
+        CLI::GetParam<arma::rowvec>("predicted_responses") =
+            std::move(predictions);
+      }
+    }
+    Timer::Stop("gbm_prediction");
+  }
+
+  // Did the user want to save the output model?
+  if (CLI::HasParam("output_model"))
+  {
+    if (CLI::HasParam("input_model"))
+      CLI::GetParam<GradientBoostingModel>("output_model") = model;
+    else
+      CLI::GetParam<GradientBoostingModel>("output_model") = std::move(model);
+  }
+}
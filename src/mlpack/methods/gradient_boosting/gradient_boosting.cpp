@@ -0,0 +1,389 @@
+/**
+ * @file gradient_boosting.cpp
+ *
+ * Implementation of the GradientBoosting class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "gradient_boosting.hpp"
+
+#include <mlpack/core/math/random.hpp>
+
+using namespace mlpack;
+using namespace mlpack::tree;
+
+GradientBoosting::GradientBoosting(const size_t numRounds,
+                                   const double learningRate,
+                                   const size_t maxDepth,
+                                   const size_t minimumLeafSize,
+                                   const double lambda,
+                                   const double rowSubsample,
+                                   const double columnSubsample,
+                                   const size_t maxBins,
+                                   const size_t earlyStoppingRounds) :
+    numRounds(numRounds),
+    learningRate(learningRate),
+    maxDepth(maxDepth),
+    minimumLeafSize(minimumLeafSize),
+    lambda(lambda),
+    rowSubsample(rowSubsample),
+    columnSubsample(columnSubsample),
+    maxBins(maxBins),
+    earlyStoppingRounds(earlyStoppingRounds),
+    numClasses(0)
+{
+  // Nothing to do.
+}
+
+void GradientBoosting::Train(const arma::mat& data,
+                             const arma::rowvec& responses)
+{
+  TrainModel(data, responses, 0, NULL, NULL);
+}
+
+void GradientBoosting::Train(const arma::mat& data,
+                             const arma::rowvec& responses,
+                             const arma::mat& validationData,
+                             const arma::rowvec& validationResponses)
+{
+  TrainModel(data, responses, 0, &validationData, &validationResponses);
+}
+
+void GradientBoosting::Train(const arma::mat& data,
+                             const arma::Row<size_t>& labels,
+                             const size_t numClasses)
+{
+  if (numClasses < 2)
+  {
+    throw std::invalid_argument("GradientBoosting::Train(): there must be at "
+        "least two classes!");
+  }
+
+  const arma::rowvec targets = arma::conv_to<arma::rowvec>::from(labels);
+  TrainModel(data, targets, numClasses, NULL, NULL);
+}
+
+void GradientBoosting::Train(const arma::mat& data,
+                             const arma::Row<size_t>& labels,
+                             const size_t numClasses,
+                             const arma::mat& validationData,
+                             const arma::Row<size_t>& validationLabels)
+{
+  if (numClasses < 2)
+  {
+    throw std::invalid_argument("GradientBoosting::Train(): there must be at "
+        "least two classes!");
+  }
+
+  const arma::rowvec targets = arma::conv_to<arma::rowvec>::from(labels);
+  const arma::rowvec validationTargets =
+      arma::conv_to<arma::rowvec>::from(validationLabels);
+  TrainModel(data, targets, numClasses, &validationData, &validationTargets);
+}
+
+void GradientBoosting::Predict(const arma::mat& points,
+                               arma::rowvec& predictions) const
+{
+  if (initialScores.n_elem == 0 || numClasses != 0)
+  {
+    throw std::invalid_argument("GradientBoosting::Predict(): the model is not "
+        "a trained regression model!");
+  }
+
+  arma::mat scores;
+  Scores(points, scores);
+  predictions = scores.row(0);
+}
+
+void GradientBoosting::Classify(const arma::mat& points,
+                                arma::Row<size_t>& predictions) const
+{
+  arma::mat probabilities;
+  Classify(points, predictions, probabilities);
+}
+
+void GradientBoosting::Classify(const arma::mat& points,
+                                arma::Row<size_t>& predictions,
+                                arma::mat& probabilities) const
+{
+  if (initialScores.n_elem == 0 || numClasses == 0)
+  {
+    throw std::invalid_argument("GradientBoosting::Classify(): the model is "
+        "not a trained classification model!");
+  }
+
+  Scores(points, probabilities);
+  predictions.set_size(points.n_cols);
+  for (size_t i = 0; i < points.n_cols; ++i)
+  {
+    // Take the softmax of the outputs.
+    arma::vec p = probabilities.unsafe_col(i); // Alias of column.
+    p = arma::exp(p - p.max());
+    p /= arma::accu(p);
+
+    arma::uword maxIndex = 0;
+    p.max(maxIndex);
+    predictions[i] = (size_t) maxIndex;
+  }
+}
+
+void GradientBoosting::TrainModel(const arma::mat& data,
+                                  const arma::rowvec& targets,
+                                  const size_t numClasses,
+                                  const arma::mat* validationData,
+                                  const arma::rowvec* validationTargets)
+{
+  if (data.n_cols == 0 || targets.n_elem != data.n_cols)
+  {
+    std::ostringstream oss;
+    oss << "GradientBoosting::Train(): the dataset has " << data.n_cols
+        << " points, but there are " << targets.n_elem << " targets!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  if (validationData && (validationTargets->n_elem != validationData->n_cols ||
+      validationData->n_rows != data.n_rows))
+  {
+    throw std::invalid_argument("GradientBoosting::Train(): the validation "
+        "set doesn't match the dataset!");
+  }
+
+  if (learningRate <= 0.0 || rowSubsample <= 0.0 || rowSubsample > 1.0 ||
+      columnSubsample <= 0.0 || columnSubsample > 1.0 || maxBins < 2 ||
+      maxBins > 256)
+  {
+    throw std::invalid_argument("GradientBoosting::Train(): the learning rate "
+        "must be positive, the subsampling fractions must be in (0, 1], and "
+        "the number of bins must be between 2 and 256!");
+  }
+
+  if (numClasses > 0 && (arma::max(targets) >= numClasses ||
+      (validationTargets && validationTargets->n_elem > 0 &&
+      arma::max(*validationTargets) >= numClasses)))
+  {
+    throw std::invalid_argument("GradientBoosting::Train(): labels must be "
+        "less than the number of classes!");
+  }
+
+  this->numClasses = numClasses;
+  const size_t numOutputs = (numClasses == 0) ? 1 : numClasses;
+
+  // Start from the mean response, or from the (smoothed) log-prior of each
+  // class.
+  if (numClasses == 0)
+  {
+    initialScores.set_size(1);
+    initialScores[0] = arma::mean(targets);
+  }
+  else
+  {
+    initialScores.ones(numClasses);
+    for (size_t i = 0; i < targets.n_elem; ++i)
+      ++initialScores[(size_t) targets[i]];
+    initialScores = arma::log(initialScores / (targets.n_elem + numClasses));
+  }
+  trees.clear();
+
+  std::vector<arma::vec> binThresholds;
+  arma::Mat<unsigned char> bins;
+  Bin(data, binThresholds, bins);
+
+  arma::mat scores = arma::repmat(initialScores, 1, data.n_cols);
+  arma::mat validationScores;
+  double bestLoss = DBL_MAX;
+  size_t bestRounds = 0;
+  if (validationData)
+  {
+    validationScores = arma::repmat(initialScores, 1, validationData->n_cols);
+    bestLoss = Loss(validationScores, *validationTargets);
+  }
+
+  arma::mat gradients, hessians;
+  for (size_t r = 0; r < numRounds; ++r)
+  {
+    Gradients(scores, targets, gradients, hessians);
+    const arma::uvec points = Subsample(data.n_cols, rowSubsample);
+
+    for (size_t k = 0; k < numOutputs; ++k)
+    {
+      const arma::uvec dimensions = Subsample(data.n_rows, columnSubsample);
+      const arma::rowvec outputGradients = gradients.row(k);
+      const arma::rowvec outputHessians = hessians.row(k);
+
+      trees.push_back(GradientBoostingTree());
+      GradientBoostingTree& tree = trees.back();
+      tree.Train(bins, binThresholds, outputGradients, outputHessians, points,
+          dimensions, maxDepth, minimumLeafSize, lambda, learningRate);
+
+      #pragma omp parallel for
+      for (omp_size_t i = 0; i < (omp_size_t) data.n_cols; ++i)
+        scores(k, i) += tree.Predict(bins, i);
+
+      if (validationData)
+      {
+        #pragma omp parallel for
+        for (omp_size_t i = 0; i < (omp_size_t) validationData->n_cols; ++i)
+          validationScores(k, i) += tree.Predict(validationData->col(i));
+      }
+    }
+
+    if (validationData)
+    {
+      const double loss = Loss(validationScores, *validationTargets);
+      Log::Debug << "GradientBoosting::Train(): round " << r + 1
+          << ", validation loss " << loss << "." << std::endl;
+
+      if (loss < bestLoss)
+      {
+        bestLoss = loss;
+        bestRounds = r + 1;
+      }
+      else if (earlyStoppingRounds > 0 &&
+          r + 1 - bestRounds >= earlyStoppingRounds)
+      {
+        Log::Info << "GradientBoosting::Train(): no improvement on the "
+            << "validation set for " << earlyStoppingRounds << " rounds; "
+            << "keeping the model of round " << bestRounds << "." << std::endl;
+        break;
+      }
+    }
+  }
+
+  // Keep the model of the best round.
+  if (validationData && earlyStoppingRounds > 0)
+    trees.resize(bestRounds * numOutputs);
+}
+
+void GradientBoosting::Bin(const arma::mat& data,
+                           std::vector<arma::vec>& binThresholds,
+                           arma::Mat<unsigned char>& bins) const
+{
+  binThresholds.resize(data.n_rows);
+  bins.set_size(data.n_cols, data.n_rows);
+
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t d = 0; d < (omp_size_t) data.n_rows; ++d)
+  {
+    const arma::rowvec sorted = arma::sort(data.row(d));
+    const arma::rowvec values = arma::unique(sorted);
+
+    // Each bin but the first starts at a cut value.  If there are few enough
+    // distinct values, each gets its own bin; otherwise the cuts are at the
+    // quantiles.
+    std::vector<double> cuts;
+    if (values.n_elem <= maxBins)
+    {
+      cuts.assign(values.begin() + 1, values.end());
+    }
+    else
+    {
+      for (size_t b = 1; b < maxBins; ++b)
+      {
+        const double cut = sorted[(b * sorted.n_elem) / maxBins];
+        if (cut > values[0] && (cuts.empty() || cut > cuts.back()))
+          cuts.push_back(cut);
+      }
+    }
+
+    // The boundary of each bin is halfway between the cut and the distinct
+    // value before it.
+    arma::vec& thresholds = binThresholds[d];
+    thresholds.set_size(cuts.size());
+    const double* valuesEnd = values.memptr() + values.n_elem;
+    for (size_t b = 0; b < cuts.size(); ++b)
+    {
+      const double* cut = std::lower_bound(values.memptr(), valuesEnd,
+          cuts[b]);
+      thresholds[b] = (*(cut - 1) + *cut) / 2.0;
+    }
+
+    const double* thresholdsEnd = thresholds.memptr() + thresholds.n_elem;
+    unsigned char* pointBins = bins.colptr(d);
+    for (size_t i = 0; i < data.n_cols; ++i)
+    {
+      pointBins[i] = (unsigned char) (std::lower_bound(thresholds.memptr(),
+          thresholdsEnd, data(d, i)) - thresholds.memptr());
+    }
+  }
+}
+
+void GradientBoosting::Gradients(const arma::mat& scores,
+                                 const arma::rowvec& targets,
+                                 arma::mat& gradients,
+                                 arma::mat& hessians) const
+{
+  if (numClasses == 0)
+  {
+    // The squared error (f - y)^2 / 2.
+    gradients = scores - targets;
+    hessians.ones(1, targets.n_elem);
+    return;
+  }
+
+  // The cross-entropy of the softmax of the outputs.
+  gradients.set_size(numClasses, targets.n_elem);
+  hessians.set_size(numClasses, targets.n_elem);
+
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) targets.n_elem; ++i)
+  {
+    arma::vec p = arma::exp(scores.col(i) - scores.col(i).max());
+    p /= arma::accu(p);
+    for (size_t k = 0; k < numClasses; ++k)
+    {
+      gradients(k, i) = p[k] - ((size_t) targets[i] == k ? 1.0 : 0.0);
+      hessians(k, i) = std::max(p[k] * (1.0 - p[k]), 1e-16);
+    }
+  }
+}
+
+double GradientBoosting::Loss(const arma::mat& scores,
+                              const arma::rowvec& targets) const
+{
+  if (targets.n_elem == 0)
+    return 0.0;
+
+  if (numClasses == 0)
+    return arma::accu(arma::square(scores - targets)) / targets.n_elem;
+
+  double loss = 0.0;
+  for (size_t i = 0; i < targets.n_elem; ++i)
+  {
+    const double maxScore = scores.col(i).max();
+    loss += maxScore + std::log(arma::accu(arma::exp(scores.col(i) -
+        maxScore))) - scores((size_t) targets[i], i);
+  }
+
+  return loss / targets.n_elem;
+}
+
+void GradientBoosting::Scores(const arma::mat& points, arma::mat& scores) const
+{
+  const size_t numOutputs = initialScores.n_elem;
+  scores = arma::repmat(initialScores, 1, points.n_cols);
+
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) points.n_cols; ++i)
+  {
+    for (size_t t = 0; t < trees.size(); ++t)
+      scores(t % numOutputs, i) += trees[t].Predict(points.col(i));
+  }
+}
+
+arma::uvec GradientBoosting::Subsample(const size_t n, const double fraction)
+{
+  arma::uvec indices = arma::linspace<arma::uvec>(0, n - 1, n);
+  if (fraction >= 1.0)
+    return indices;
+
+  const size_t count = std::max((size_t) (fraction * n + 0.5), (size_t) 1);
+
+  // Draw distinct indices with a partial Fisher-Yates shuffle.
+  for (size_t i = 0; i < count; ++i)
+    std::swap(indices[i], indices[math::RandInt(i, n)]);
+
+  return arma::sort(indices.head(count));
+}
@@ -0,0 +1,298 @@
+/**
+ * @file gradient_boosting.hpp
+ *
+ * Definition of the GradientBoosting class, which trains gradient boosted
+ * regression trees for regression and multiclass classification.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_GRADIENT_BOOSTING_GRADIENT_BOOSTING_HPP
+#define MLPACK_METHODS_GRADIENT_BOOSTING_GRADIENT_BOOSTING_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "gradient_boosting_tree.hpp"
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * An implementation of gradient boosted decision trees, in the style of XGBoost
+ * and LightGBM.  The model is a sum of regression trees (GradientBoostingTree),
+ * each of which is fit to the gradients and hessians of the loss at the current
+ * predictions and scaled by the learning rate.  For regression, the loss is the
+ * squared error; for classification, one tree is trained for each class at each
+ * round, and the loss is the cross-entropy of the softmax of the outputs.
+ *
+ * Before training, the values of each dimension are binned into at most 256
+ * bins at their quantiles, so that splits are found with histograms.  At each
+ * round, a random fraction of the points can be used (row subsampling), and
+ * each tree can be restricted to a random fraction of the dimensions (column
+ * subsampling).  If a validation set is given, training stops when the loss on
+ * it has not improved for a given number of rounds, and the model of the best
+ * round is kept.
+ *
+ * @code
+ * @inproceedings{chen2016xgboost,
+ *   title={{XGBoost}: A Scalable Tree Boosting System},
+ *   author={Chen, Tianqi and Guestrin, Carlos},
+ *   booktitle={Proceedings of the 22nd ACM SIGKDD International Conference on
+ *       Knowledge Discovery and Data Mining},
+ *   pages={785--794},
+ *   year={2016}
+ * }
+ * @endcode
+ */
+class GradientBoosting
+{
+ public:
+  /**
+   * Create the model with the given parameters.  The model can't be used
+   * until Train() is called.
+   *
+   * @param numRounds Maximum number of boosting rounds.
+   * @param learningRate Factor the output of each tree is scaled by.
+   * @param maxDepth Maximum depth of each tree.
+   * @param minimumLeafSize Minimum number of points in each leaf.
+   * @param lambda L2 regularization of the leaf values.
+   * @param rowSubsample Fraction of the points used at each round.
+   * @param columnSubsample Fraction of the dimensions each tree may split on.
+   * @param maxBins Maximum number of bins of each dimension (at most 256).
+   * @param earlyStoppingRounds If a validation set is given, stop after this
+   *     many rounds without improvement on it (0 means never stop early).
+   */
+  GradientBoosting(const size_t numRounds = 100,
+                   const double learningRate = 0.1,
+                   const size_t maxDepth = 6,
+                   const size_t minimumLeafSize = 20,
+                   const double lambda = 1.0,
+                   const double rowSubsample = 1.0,
+                   const double columnSubsample = 1.0,
+                   const size_t maxBins = 256,
+                   const size_t earlyStoppingRounds = 10);
+
+  /**
+   * Train a regression model on the given data and responses.
+   *
+   * @param data Dataset to train on.
+   * @param responses Response of each point.
+   */
+  void Train(const arma::mat& data, const arma::rowvec& responses);
+
+  /**
+   * Train a regression model on the given data and responses, stopping early
+   * when the squared error on the validation set stops improving.
+   *
+   * @param data Dataset to train on.
+   * @param responses Response of each point.
+   * @param validationData Validation dataset.
+   * @param validationResponses Response of each validation point.
+   */
+  void Train(const arma::mat& data,
+             const arma::rowvec& responses,
+             const arma::mat& validationData,
+             const arma::rowvec& validationResponses);
+
+  /**
+   * Train a classification model on the given data and labels.
+   *
+   * @param data Dataset to train on.
+   * @param labels Label of each point.
+   * @param numClasses Number of classes in the dataset.
+   */
+  void Train(const arma::mat& data,
+             const arma::Row<size_t>& labels,
+             const size_t numClasses);
+
+  /**
+   * Train a classification model on the given data and labels, stopping early
+   * when the cross-entropy on the validation set stops improving.
+   *
+   * @param data Dataset to train on.
+   * @param labels Label of each point.
+   * @param numClasses Number of classes in the dataset.
+   * @param validationData Validation dataset.
+   * @param validationLabels Label of each validation point.
+   */
+  void Train(const arma::mat& data,
+             const arma::Row<size_t>& labels,
+             const size_t numClasses,
+             const arma::mat& validationData,
+             const arma::Row<size_t>& validationLabels);
+
+  /**
+   * Predict the responses of the given points with a regression model.  If the
+   * model is not a trained regression model, std::invalid_argument is thrown.
+   *
+   * @param points Points to predict.
+   * @param predictions Output predicted responses.
+   */
+  void Predict(const arma::mat& points, arma::rowvec& predictions) const;
+
+  /**
+   * Predict the classes of the given points with a classification model.  If
+   * the model is not a trained classification model, std::invalid_argument is
+   * thrown.
+   *
+   * @param points Points to classify.
+   * @param predictions Output predicted classes.
+   */
+  void Classify(const arma::mat& points,
+                arma::Row<size_t>& predictions) const;
+
+  /**
+   * Predict the classes of the given points with a classification model, also
+   * returning the class probabilities of each point.  If the model is not a
+   * trained classification model, std::invalid_argument is thrown.
+   *
+   * @param points Points to classify.
+   * @param predictions Output predicted classes.
+   * @param probabilities Output class probabilities of each point.
+   */
+  void Classify(const arma::mat& points,
+                arma::Row<size_t>& predictions,
+                arma::mat& probabilities) const;
+
+  //! Get the number of classes (0 for a regression model).
+  size_t NumClasses() const { return numClasses; }
+
+  //! Get the number of trees in the model.
+  size_t NumTrees() const { return trees.size(); }
+  //! Get the given tree of the model.
+  const GradientBoostingTree& Tree(const size_t i) const { return trees[i]; }
+
+  //! Get the maximum number of boosting rounds.
+  size_t NumRounds() const { return numRounds; }
+  //! Modify the maximum number of boosting rounds.
+  size_t& NumRounds() { return numRounds; }
+
+  //! Get the learning rate.
+  double LearningRate() const { return learningRate; }
+  //! Modify the learning rate.
+  double& LearningRate() { return learningRate; }
+
+  //! Get the maximum depth of each tree.
+  size_t MaxDepth() const { return maxDepth; }
+  //! Modify the maximum depth of each tree.
+  size_t& MaxDepth() { return maxDepth; }
+
+  //! Get the minimum number of points in each leaf.
+  size_t MinimumLeafSize() const { return minimumLeafSize; }
+  //! Modify the minimum number of points in each leaf.
+  size_t& MinimumLeafSize() { return minimumLeafSize; }
+
+  //! Get the L2 regularization of the leaf values.
+  double Lambda() const { return lambda; }
+  //! Modify the L2 regularization of the leaf values.
+  double& Lambda() { return lambda; }
+
+  //! Get the fraction of the points used at each round.
+  double RowSubsample() const { return rowSubsample; }
+  //! Modify the fraction of the points used at each round.
+  double& RowSubsample() { return rowSubsample; }
+
+  //! Get the fraction of the dimensions each tree may split on.
+  double ColumnSubsample() const { return columnSubsample; }
+  //! Modify the fraction of the dimensions each tree may split on.
+  double& ColumnSubsample() { return columnSubsample; }
+
+  //! Get the maximum number of bins of each dimension.
+  size_t MaxBins() const { return maxBins; }
+  //! Modify the maximum number of bins of each dimension.
+  size_t& MaxBins() { return maxBins; }
+
+  //! Get the number of rounds without improvement before stopping early.
+  size_t EarlyStoppingRounds() const { return earlyStoppingRounds; }
+  //! Modify the number of rounds without improvement before stopping early.
+  size_t& EarlyStoppingRounds() { return earlyStoppingRounds; }
+
+  /**
+   * Serialize the model.
+   */
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */)
+  {
+    ar & BOOST_SERIALIZATION_NVP(numRounds);
+    ar & BOOST_SERIALIZATION_NVP(learningRate);
+    ar & BOOST_SERIALIZATION_NVP(maxDepth);
+    ar & BOOST_SERIALIZATION_NVP(minimumLeafSize);
+    ar & BOOST_SERIALIZATION_NVP(lambda);
+    ar & BOOST_SERIALIZATION_NVP(rowSubsample);
+    ar & BOOST_SERIALIZATION_NVP(columnSubsample);
+    ar & BOOST_SERIALIZATION_NVP(maxBins);
+    ar & BOOST_SERIALIZATION_NVP(earlyStoppingRounds);
+    ar & BOOST_SERIALIZATION_NVP(numClasses);
+    ar & BOOST_SERIALIZATION_NVP(initialScores);
+    ar & BOOST_SERIALIZATION_NVP(trees);
+  }
+
+ private:
+  /**
+   * Train the model on the given targets (responses, or labels if numClasses
+   * is not 0).  The validation set is used if it is not NULL.
+   */
+  void TrainModel(const arma::mat& data,
+                  const arma::rowvec& targets,
+                  const size_t numClasses,
+                  const arma::mat* validationData,
+                  const arma::rowvec* validationTargets);
+
+  /**
+   * Compute the upper boundaries of the bins of each dimension of the given
+   * data, and the bin of each point in each dimension (one column for each
+   * dimension).
+   */
+  void Bin(const arma::mat& data,
+           std::vector<arma::vec>& binThresholds,
+           arma::Mat<unsigned char>& bins) const;
+
+  //! Compute the gradients and hessians of the loss at the given outputs.
+  void Gradients(const arma::mat& scores,
+                 const arma::rowvec& targets,
+                 arma::mat& gradients,
+                 arma::mat& hessians) const;
+
+  //! Compute the mean loss at the given outputs.
+  double Loss(const arma::mat& scores, const arma::rowvec& targets) const;
+
+  //! Compute the outputs of the model (one row for each class) for the given
+  //! points.
+  void Scores(const arma::mat& points, arma::mat& scores) const;
+
+  //! Draw the given fraction of the indices 0, ..., n - 1 (at least one), in
+  //! increasing order.
+  static arma::uvec Subsample(const size_t n, const double fraction);
+
+  //! The maximum number of boosting rounds.
+  size_t numRounds;
+  //! The factor the output of each tree is scaled by.
+  double learningRate;
+  //! The maximum depth of each tree.
+  size_t maxDepth;
+  //! The minimum number of points in each leaf.
+  size_t minimumLeafSize;
+  //! The L2 regularization of the leaf values.
+  double lambda;
+  //! The fraction of the points used at each round.
+  double rowSubsample;
+  //! The fraction of the dimensions each tree may split on.
+  double columnSubsample;
+  //! The maximum number of bins of each dimension.
+  size_t maxBins;
+  //! The number of rounds without improvement before stopping early.
+  size_t earlyStoppingRounds;
+
+  //! The number of classes (0 for regression).
+  size_t numClasses;
+  //! The output of the model before the first tree, for each class.
+  arma::vec initialScores;
+  //! The trees; the tree of class k at round r is tree r * numOutputs + k.
+  std::vector<GradientBoostingTree> trees;
+};
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
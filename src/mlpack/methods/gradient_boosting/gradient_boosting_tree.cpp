@@ -0,0 +1,209 @@
+/**
+ * @file gradient_boosting_tree.cpp
+ *
+ * Implementation of the GradientBoostingTree class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "gradient_boosting_tree.hpp"
+
+using namespace mlpack;
+using namespace mlpack::tree;
+
+GradientBoostingTree::GradientBoostingTree() :
+    splitDimensions(1, 0),
+    splitBins(1, 0),
+    thresholds(1, 0.0),
+    leftChildren(1, 0),
+    values(1, 0.0)
+{
+  // Nothing to do.
+}
+
+void GradientBoostingTree::Train(const arma::Mat<unsigned char>& bins,
+                                 const std::vector<arma::vec>& binThresholds,
+                                 const arma::rowvec& gradients,
+                                 const arma::rowvec& hessians,
+                                 const arma::uvec& points,
+                                 const arma::uvec& dimensions,
+                                 const size_t maxDepth,
+                                 const size_t minimumLeafSize,
+                                 const double lambda,
+                                 const double learningRate)
+{
+  // Start with only the root.
+  splitDimensions.assign(1, 0);
+  splitBins.assign(1, 0);
+  thresholds.assign(1, 0.0);
+  leftChildren.assign(1, 0);
+  values.assign(1, 0.0);
+
+  if (points.n_elem == 0)
+    return;
+
+  std::vector<size_t> order(points.begin(), points.end());
+
+  size_t numBins = 1;
+  for (size_t j = 0; j < dimensions.n_elem; ++j)
+    numBins = std::max(numBins, binThresholds[dimensions[j]].n_elem + 1);
+
+  Histogram histogram;
+  histogram.gradients.set_size(numBins, dimensions.n_elem);
+  histogram.hessians.set_size(numBins, dimensions.n_elem);
+  histogram.counts.set_size(numBins, dimensions.n_elem);
+  BuildHistogram(bins, gradients, hessians, order, 0, order.size(), dimensions,
+      histogram);
+
+  Grow(0, bins, binThresholds, gradients, hessians, order, 0, order.size(),
+      dimensions, histogram, 0, maxDepth, std::max(minimumLeafSize, (size_t) 1),
+      lambda, learningRate);
+}
+
+void GradientBoostingTree::BuildHistogram(const arma::Mat<unsigned char>& bins,
+                                          const arma::rowvec& gradients,
+                                          const arma::rowvec& hessians,
+                                          const std::vector<size_t>& order,
+                                          const size_t begin,
+                                          const size_t end,
+                                          const arma::uvec& dimensions,
+                                          Histogram& histogram) const
+{
+  histogram.gradients.zeros();
+  histogram.hessians.zeros();
+  histogram.counts.zeros();
+
+  // Each thread fills the histograms of its own dimensions.
+  #pragma omp parallel for schedule(dynamic) if (end - begin >= 1000)
+  for (omp_size_t j = 0; j < (omp_size_t) dimensions.n_elem; ++j)
+  {
+    const unsigned char* pointBins = bins.colptr(dimensions[j]);
+    double* gradientSums = histogram.gradients.colptr(j);
+    double* hessianSums = histogram.hessians.colptr(j);
+    size_t* counts = histogram.counts.colptr(j);
+
+    for (size_t k = begin; k < end; ++k)
+    {
+      const size_t i = order[k];
+      const unsigned char b = pointBins[i];
+      gradientSums[b] += gradients[i];
+      hessianSums[b] += hessians[i];
+      ++counts[b];
+    }
+  }
+}
+
+void GradientBoostingTree::Grow(const size_t node,
+                                const arma::Mat<unsigned char>& bins,
+                                const std::vector<arma::vec>& binThresholds,
+                                const arma::rowvec& gradients,
+                                const arma::rowvec& hessians,
+                                std::vector<size_t>& order,
+                                const size_t begin,
+                                const size_t end,
+                                const arma::uvec& dimensions,
+                                Histogram& histogram,
+                                const size_t depth,
+                                const size_t maxDepth,
+                                const size_t minimumLeafSize,
+                                const double lambda,
+                                const double learningRate)
+{
+  const size_t count = end - begin;
+  double sumGradients = 0.0;
+  double sumHessians = 0.0;
+  for (size_t k = begin; k < end; ++k)
+  {
+    sumGradients += gradients[order[k]];
+    sumHessians += hessians[order[k]];
+  }
+  values[node] = -learningRate * sumGradients / (sumHessians + lambda);
+
+  if (depth >= maxDepth || count < 2 * minimumLeafSize)
+    return;
+
+  // Scan the histogram of each dimension for the split with the best gain.
+  const double parentScore = sumGradients * sumGradients /
+      (sumHessians + lambda);
+  double bestGain = 0.0;
+  size_t bestIndex = dimensions.n_elem;
+  size_t bestBin = 0;
+  for (size_t j = 0; j < dimensions.n_elem; ++j)
+  {
+    const size_t numBins = binThresholds[dimensions[j]].n_elem + 1;
+    double leftGradients = 0.0;
+    double leftHessians = 0.0;
+    size_t leftCount = 0;
+    for (size_t b = 0; b + 1 < numBins; ++b)
+    {
+      leftGradients += histogram.gradients(b, j);
+      leftHessians += histogram.hessians(b, j);
+      leftCount += histogram.counts(b, j);
+      if (leftCount < minimumLeafSize)
+        continue;
+      if (count - leftCount < minimumLeafSize)
+        break;
+
+      const double rightGradients = sumGradients - leftGradients;
+      const double rightHessians = sumHessians - leftHessians;
+      const double gain = leftGradients * leftGradients /
+          (leftHessians + lambda) + rightGradients * rightGradients /
+          (rightHessians + lambda) - parentScore;
+      if (gain > bestGain)
+      {
+        bestGain = gain;
+        bestIndex = j;
+        bestBin = b;
+      }
+    }
+  }
+
+  if (bestIndex == dimensions.n_elem)
+    return; // No split improves the loss.
+
+  const size_t bestDimension = dimensions[bestIndex];
+  const unsigned char* pointBins = bins.colptr(bestDimension);
+  const size_t middle = std::partition(order.begin() + begin,
+      order.begin() + end,
+      [&](const size_t i) { return pointBins[i] <= bestBin; }) - order.begin();
+
+  // Add the children.
+  const size_t left = values.size();
+  splitDimensions[node] = bestDimension;
+  splitBins[node] = (unsigned char) bestBin;
+  thresholds[node] = binThresholds[bestDimension][bestBin];
+  leftChildren[node] = left;
+
+  splitDimensions.resize(left + 2, 0);
+  splitBins.resize(left + 2, 0);
+  thresholds.resize(left + 2, 0.0);
+  leftChildren.resize(left + 2, 0);
+  values.resize(left + 2, 0.0);
+
+  // Build the histogram of the smaller child; the histogram of the larger
+  // child is what remains of the histogram of this node.
+  const bool leftSmaller = (middle - begin) <= (end - middle);
+  const size_t smallBegin = leftSmaller ? begin : middle;
+  const size_t smallEnd = leftSmaller ? middle : end;
+
+  Histogram smallHistogram;
+  smallHistogram.gradients.set_size(arma::size(histogram.gradients));
+  smallHistogram.hessians.set_size(arma::size(histogram.hessians));
+  smallHistogram.counts.set_size(arma::size(histogram.counts));
+  BuildHistogram(bins, gradients, hessians, order, smallBegin, smallEnd,
+      dimensions, smallHistogram);
+
+  histogram.gradients -= smallHistogram.gradients;
+  histogram.hessians -= smallHistogram.hessians;
+  histogram.counts -= smallHistogram.counts;
+
+  Grow(leftSmaller ? left : left + 1, bins, binThresholds, gradients, hessians,
+      order, smallBegin, smallEnd, dimensions, smallHistogram, depth + 1,
+      maxDepth, minimumLeafSize, lambda, learningRate);
+  Grow(leftSmaller ? left + 1 : left, bins, binThresholds, gradients, hessians,
+      order, leftSmaller ? middle : begin, leftSmaller ? end : middle,
+      dimensions, histogram, depth + 1, maxDepth, minimumLeafSize, lambda,
+      learningRate);
+}
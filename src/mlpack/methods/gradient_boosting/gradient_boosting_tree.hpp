@@ -0,0 +1,189 @@
+/**
+ * @file gradient_boosting_tree.hpp
+ *
+ * Definition of the GradientBoostingTree class, the regression tree that is fit
+ * to the gradients of the loss at each round of gradient boosting.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_GRADIENT_BOOSTING_GRADIENT_BOOSTING_TREE_HPP
+#define MLPACK_METHODS_GRADIENT_BOOSTING_GRADIENT_BOOSTING_TREE_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * A GradientBoostingTree is a binary regression tree that is trained on the
+ * first and second derivatives (gradients and hessians) of a loss, as in
+ * XGBoost and LightGBM.  The value of a leaf is the Newton step
+ * -G / (H + lambda), scaled by the learning rate, where G and H are the sums of
+ * the gradients and hessians of its points, and a node is split where the gain
+ *
+ *   G_L^2 / (H_L + lambda) + G_R^2 / (H_R + lambda) - G^2 / (H + lambda)
+ *
+ * is largest.  The tree is trained on points whose values have been binned (see
+ * GradientBoosting), so the best split of a dimension is found with a histogram
+ * of the gradients and hessians of each bin; the histograms of the dimensions
+ * are built in parallel with OpenMP, and only the histogram of the smaller
+ * child of each split is built, since the histogram of the other child is the
+ * difference with the histogram of the parent.
+ *
+ * The splits are stored both as bins (to predict on the binned training set)
+ * and as thresholds (to predict on any point).
+ */
+class GradientBoostingTree
+{
+ public:
+  /**
+   * Create an empty tree, which predicts 0 for every point.
+   */
+  GradientBoostingTree();
+
+  /**
+   * Train the tree on the given binned points.
+   *
+   * @param bins Bin of each point in each dimension, with one column for each
+   *     dimension and one row for each point.
+   * @param binThresholds The upper boundaries of the bins of each dimension: a
+   *     point is in the bin b of dimension d if and only if its value is
+   *     greater than binThresholds[d][b - 1] (if b > 0) and at most
+   *     binThresholds[d][b] (if b < binThresholds[d].n_elem).
+   * @param gradients The gradient of the loss at each point.
+   * @param hessians The hessian of the loss at each point.
+   * @param points Points to train on.
+   * @param dimensions Dimensions that may be split on.
+   * @param maxDepth Maximum depth of the tree.
+   * @param minimumLeafSize Minimum number of points in each leaf.
+   * @param lambda L2 regularization of the leaf values.
+   * @param learningRate Factor the values of the leaves are scaled by.
+   */
+  void Train(const arma::Mat<unsigned char>& bins,
+             const std::vector<arma::vec>& binThresholds,
+             const arma::rowvec& gradients,
+             const arma::rowvec& hessians,
+             const arma::uvec& points,
+             const arma::uvec& dimensions,
+             const size_t maxDepth,
+             const size_t minimumLeafSize,
+             const double lambda,
+             const double learningRate);
+
+  /**
+   * Predict the value of the given point.
+   *
+   * @param point Point to predict.
+   */
+  template<typename VecType>
+  double Predict(const VecType& point) const
+  {
+    size_t node = 0;
+    while (leftChildren[node] != 0)
+    {
+      node = leftChildren[node] +
+          ((point[splitDimensions[node]] <= thresholds[node]) ? 0 : 1);
+    }
+
+    return values[node];
+  }
+
+  /**
+   * Predict the value of the given point of the binned dataset the tree was
+   * trained on.
+   *
+   * @param bins Bin of each point in each dimension (see Train()).
+   * @param point Index of the point to predict.
+   */
+  double Predict(const arma::Mat<unsigned char>& bins, const size_t point) const
+  {
+    size_t node = 0;
+    while (leftChildren[node] != 0)
+    {
+      node = leftChildren[node] +
+          ((bins(point, splitDimensions[node]) <= splitBins[node]) ? 0 : 1);
+    }
+
+    return values[node];
+  }
+
+  //! Get the number of nodes in the tree.
+  size_t NumNodes() const { return values.size(); }
+
+  /**
+   * Serialize the tree.
+   */
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */)
+  {
+    ar & BOOST_SERIALIZATION_NVP(splitDimensions);
+    ar & BOOST_SERIALIZATION_NVP(splitBins);
+    ar & BOOST_SERIALIZATION_NVP(thresholds);
+    ar & BOOST_SERIALIZATION_NVP(leftChildren);
+    ar & BOOST_SERIALIZATION_NVP(values);
+  }
+
+ private:
+  //! The sums of the gradients, hessians, and points of each bin of each
+  //! candidate dimension of a node.
+  struct Histogram
+  {
+    arma::mat gradients;
+    arma::mat hessians;
+    arma::Mat<size_t> counts;
+  };
+
+  /**
+   * Fill the histogram of the points order[begin, end) in each of the given
+   * dimensions.  The matrices of the histogram must have the right size.
+   */
+  void BuildHistogram(const arma::Mat<unsigned char>& bins,
+                      const arma::rowvec& gradients,
+                      const arma::rowvec& hessians,
+                      const std::vector<size_t>& order,
+                      const size_t begin,
+                      const size_t end,
+                      const arma::uvec& dimensions,
+                      Histogram& histogram) const;
+
+  /**
+   * Make the given node a leaf or split it, and grow its children.  The node
+   * holds the points order[begin, end), whose histogram is given; the
+   * histogram is modified.
+   */
+  void Grow(const size_t node,
+            const arma::Mat<unsigned char>& bins,
+            const std::vector<arma::vec>& binThresholds,
+            const arma::rowvec& gradients,
+            const arma::rowvec& hessians,
+            std::vector<size_t>& order,
+            const size_t begin,
+            const size_t end,
+            const arma::uvec& dimensions,
+            Histogram& histogram,
+            const size_t depth,
+            const size_t maxDepth,
+            const size_t minimumLeafSize,
+            const double lambda,
+            const double learningRate);
+
+  //! The dimension each node splits on.
+  std::vector<size_t> splitDimensions;
+  //! The last bin of the points that go to the left child of each node.
+  std::vector<unsigned char> splitBins;
+  //! The largest value of the points that go to the left child of each node.
+  std::vector<double> thresholds;
+  //! The index of the left child of each node (the right child is next to it),
+  //! or 0 for leaves.
+  std::vector<size_t> leftChildren;
+  //! The value of each node (only used for leaves).
+  std::vector<double> values;
+};
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
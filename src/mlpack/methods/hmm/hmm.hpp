@@ -16,6 +16,7 @@
 
 #include <mlpack/prereqs.hpp>
 #include <mlpack/core/dists/discrete_distribution.hpp>
+#include <mlpack/core/dists/sparse_discrete_distribution.hpp>
 
 namespace mlpack {
 namespace hmm /** Hidden Markov Models. */ {
@@ -192,6 +193,27 @@ class HMM
   void Train(const std::vector<arma::mat>& dataSeq,
              const std::vector<arma::Row<size_t> >& stateSeq);
 
+  /**
+   * Update the model with a batch of unlabeled observation sequences, with one
+   * step of stepwise (online) EM instead of running the Baum-Welch algorithm
+   * to convergence.  The expected initial states, transitions, and state
+   * occupancies of the batch (averaged over its observations) are computed
+   * with the Forward-Backward algorithm, and the running statistics of the
+   * model are replaced by (1 - eta) times their current value plus eta times
+   * the batch statistics, where eta = (t + 1)^(-stepSizeExponent) for the
+   * t'th update.  Each emission is updated with its Update() method (see
+   * GaussianDistribution::Update()), with a step size that accounts for the
+   * occupancy of its state.  This allows a model to be trained continuously
+   * on a stream of sequences, without holding all of them in memory; the model
+   * should be initialized first, for instance with Train().
+   *
+   * @param dataSeq Batch of observation sequences.
+   * @param stepSizeExponent Exponent of the step size schedule, in (0.5, 1].
+   * @return Log-likelihood of the batch under the model before the update.
+   */
+  double Update(const std::vector<arma::mat>& dataSeq,
+                const double stepSizeExponent = 0.7);
+
   /**
    * Estimate the probabilities of each hidden state at each time step for each
    * given data observation, using the Forward-Backward algorithm.  Each matrix
@@ -267,6 +289,29 @@ class HMM
    */
   double LogLikelihood(const arma::mat& dataSeq) const;
 
+  /**
+   * Compute the most probable hidden state sequence for each of the given data
+   * sequences, using the Viterbi algorithm.  The sequences are split between
+   * OpenMP threads.  The state sequence of an empty data sequence is empty.
+   *
+   * @param dataSeq Vector of observation sequences.
+   * @param stateSeq Vector in which the most probable state sequence of each
+   *     data sequence will be stored.
+   */
+  void Predict(const std::vector<arma::mat>& dataSeq,
+               std::vector<arma::Row<size_t> >& stateSeq) const;
+
+  /**
+   * Compute the log-likelihood of each of the given data sequences.  The
+   * sequences are split between OpenMP threads.
+   *
+   * @param dataSeq Vector of data sequences to evaluate the likelihood of.
+   * @param logLikelihoods Vector in which the log-likelihood of each sequence
+   *     will be stored.
+   */
+  void LogLikelihood(const std::vector<arma::mat>& dataSeq,
+                     arma::vec& logLikelihoods) const;
+
   /**
    * HMM filtering. Computes the k-step-ahead expected emission at each time
    * conditioned only on prior observations. That is
@@ -322,6 +367,12 @@ class HMM
   //! Modify the tolerance of the Baum-Welch algorithm.
   double& Tolerance() { return tolerance; }
 
+  //! Get the number of online updates done with Update().
+  size_t Updates() const { return updates; }
+  //! Modify the number of online updates (set it to 0 to restart the step
+  //! size schedule and the running state occupancies).
+  size_t& Updates() { return updates; }
+
   /**
    * Serialize the object.
    */
@@ -359,6 +410,52 @@ class HMM
                 const arma::vec& scales,
                 arma::mat& backwardProb) const;
 
+  /**
+   * Compute the emission probabilities of each state for each observation in
+   * the given data sequence.  The states are split between OpenMP threads, and
+   * each emission is evaluated on the whole sequence at once (in the log
+   * domain, if the distribution has a batch LogProbability()).  To avoid
+   * underflow, each column of emissionProb is scaled so that its largest value
+   * is 1; the probability of observation t under state i is then
+   * emissionProb(i, t) * exp(logScales[t]).
+   *
+   * @param dataSeq Data sequence to compute probabilities for.
+   * @param emissionProb Matrix in which the scaled emission probabilities will
+   *     be saved.
+   * @param logScales Vector in which the logs of the scaling factors will be
+   *     saved.
+   */
+  void EmissionProbabilities(const arma::mat& dataSeq,
+                             arma::mat& emissionProb,
+                             arma::vec& logScales) const;
+
+  /**
+   * The Forward algorithm, from the (scaled) emission probabilities computed
+   * by EmissionProbabilities().
+   *
+   * @param emissionProb Emission probabilities of each state for each
+   *     observation.
+   * @param scales Vector in which scaling factors will be saved.
+   * @param forwardProb Matrix in which forward probabilities will be saved.
+   */
+  void ForwardProbabilities(const arma::mat& emissionProb,
+                            arma::vec& scales,
+                            arma::mat& forwardProb) const;
+
+  /**
+   * The Backward algorithm, from the (scaled) emission probabilities computed
+   * by EmissionProbabilities() and the scaling factors found by
+   * ForwardProbabilities().
+   *
+   * @param emissionProb Emission probabilities of each state for each
+   *     observation.
+   * @param scales Vector of scaling factors.
+   * @param backwardProb Matrix in which backward probabilities will be saved.
+   */
+  void BackwardProbabilities(const arma::mat& emissionProb,
+                             const arma::vec& scales,
+                             arma::mat& backwardProb) const;
+
   //! Set of emission probability distributions; one for each state.
   std::vector<Distribution> emission;
 
@@ -366,6 +463,45 @@ class HMM
   arma::mat transition;
 
  private:
+  /**
+   * Run the Forward-Backward algorithm, keeping the scaled emission
+   * probabilities (see EmissionProbabilities()); the scaling factors are those
+   * of the scaled emission probabilities.  Returns the log-likelihood of the
+   * sequence.
+   */
+  double ForwardBackward(const arma::mat& dataSeq,
+                         arma::mat& emissionProb,
+                         arma::mat& forwardProb,
+                         arma::mat& backwardProb,
+                         arma::vec& scales,
+                         arma::vec& logScales) const;
+
+  /**
+   * Run the E-step of the Baum-Welch algorithm on the given sequences, split
+   * between OpenMP threads: the expected initial states and transitions (before
+   * the multiplication by the old T_ij) are added to initialStats and
+   * transitionStats, and the observations and the probability of each state
+   * for each observation are stored in emissionList and emissionProb, which
+   * must already have one column (or element) per observation.  Empty sequences
+   * are skipped.  Returns the log-likelihood of the sequences.
+   */
+  double ExpectedStatistics(const std::vector<arma::mat>& dataSeq,
+                            arma::vec& initialStats,
+                            arma::mat& transitionStats,
+                            std::vector<arma::vec>& emissionProb,
+                            arma::mat& emissionList) const;
+
+  /**
+   * Add the expected number of transitions from each state j to each state i
+   * in one sequence, before the multiplication by the old T_ij, to the given
+   * matrix, with one matrix product.
+   */
+  void ExpectedTransitions(const arma::mat& emissionProb,
+                           const arma::mat& forwardProb,
+                           const arma::mat& backwardProb,
+                           const arma::vec& scales,
+                           arma::mat& transitions) const;
+
   //! Initial state probability vector.
   arma::vec initial;
 
@@ -374,11 +510,21 @@ class HMM
 
   //! Tolerance of Baum-Welch algorithm.
   double tolerance;
+
+  //! The number of online updates done with Update().
+  size_t updates;
+
+  //! The running average occupancy of each state, used by Update().
+  arma::vec occupancy;
 };
 
 } // namespace hmm
 } // namespace mlpack
 
+//! Set the serialization version of the HMM class.
+BOOST_TEMPLATE_CLASS_VERSION(template<typename Distribution>,
+    mlpack::hmm::HMM<Distribution>, 1);
+
 // Include implementation.
 #include "hmm_impl.hpp"
 
@@ -17,9 +17,121 @@
 // Just in case...
 #include "hmm.hpp"
 
+#include <mlpack/core/util/sfinae_utility.hpp>
+
 namespace mlpack {
 namespace hmm {
 
+HAS_MEM_FUNC(LogProbability, HasBatchLogProbabilityCheck);
+HAS_MEM_FUNC(Probability, HasBatchProbabilityCheck);
+HAS_MEM_FUNC(Random, HasBatchRandomCheck);
+
+/**
+ * 'value' is true if the Distribution class has a member
+ * LogProbability(const arma::mat& observations, arma::vec& logProbabilities).
+ */
+template<typename Distribution>
+struct HasBatchLogProbability
+{
+  static const bool value = HasBatchLogProbabilityCheck<Distribution,
+      void(Distribution::*)(const arma::mat&, arma::vec&) const>::value;
+};
+
+/**
+ * 'value' is true if the Distribution class has a member
+ * Probability(const arma::mat& observations, arma::vec& probabilities).
+ */
+template<typename Distribution>
+struct HasBatchProbability
+{
+  static const bool value = HasBatchProbabilityCheck<Distribution,
+      void(Distribution::*)(const arma::mat&, arma::vec&) const>::value;
+};
+
+/**
+ * 'value' is true if the Distribution class has a member
+ * Random(const size_t n, arma::mat& samples).
+ */
+template<typename Distribution>
+struct HasBatchRandom
+{
+  static const bool value = HasBatchRandomCheck<Distribution,
+      void(Distribution::*)(const size_t, arma::mat&) const>::value;
+};
+
+//! Generate all the observations at once, if the distribution can.
+template<typename Distribution>
+void EmissionRandom(
+    const Distribution& distribution,
+    const size_t n,
+    const size_t /* dimensionality */,
+    arma::mat& samples,
+    const typename std::enable_if<
+        HasBatchRandom<Distribution>::value>::type* = 0)
+{
+  distribution.Random(n, samples);
+}
+
+//! Generate each observation separately.
+template<typename Distribution>
+void EmissionRandom(
+    const Distribution& distribution,
+    const size_t n,
+    const size_t dimensionality,
+    arma::mat& samples,
+    const typename std::enable_if<
+        !HasBatchRandom<Distribution>::value>::type* = 0)
+{
+  samples.set_size(dimensionality, n);
+  for (size_t i = 0; i < n; ++i)
+    samples.col(i) = distribution.Random();
+}
+
+//! Compute the log-probabilities of all the observations at once, in the log
+//! domain, if the distribution can.
+template<typename Distribution>
+void EmissionLogProbabilities(
+    const Distribution& distribution,
+    const arma::mat& observations,
+    arma::vec& logProbabilities,
+    const typename std::enable_if<
+        HasBatchLogProbability<Distribution>::value>::type* = 0)
+{
+  distribution.LogProbability(observations, logProbabilities);
+}
+
+//! Compute the probabilities of all the observations at once, if the
+//! distribution can, and take their logs.
+template<typename Distribution>
+void EmissionLogProbabilities(
+    const Distribution& distribution,
+    const arma::mat& observations,
+    arma::vec& logProbabilities,
+    const typename std::enable_if<
+        !HasBatchLogProbability<Distribution>::value &&
+        HasBatchProbability<Distribution>::value>::type* = 0)
+{
+  distribution.Probability(observations, logProbabilities);
+  logProbabilities = arma::log(logProbabilities);
+}
+
+//! Compute the probability of each observation separately, and take their
+//! logs.
+template<typename Distribution>
+void EmissionLogProbabilities(
+    const Distribution& distribution,
+    const arma::mat& observations,
+    arma::vec& logProbabilities,
+    const typename std::enable_if<
+        !HasBatchLogProbability<Distribution>::value &&
+        !HasBatchProbability<Distribution>::value>::type* = 0)
+{
+  logProbabilities.set_size(observations.n_cols);
+  for (size_t i = 0; i < observations.n_cols; ++i)
+    logProbabilities[i] = std::log(distribution.Probability(
+        observations.unsafe_col(i)));
+}
+
 /**
  * Create the Hidden Markov Model with the given number of hidden states and the
  * given number of emission states.
@@ -32,7 +144,8 @@ HMM<Distribution>::HMM(const size_t states,
     transition(arma::randu<arma::mat>(states, states)),
     initial(arma::randu<arma::vec>(states) / (double) states),
     dimensionality(emissions.Dimensionality()),
-    tolerance(tolerance)
+    tolerance(tolerance),
+    updates(0)
 {
   // Normalize the transition probabilities and initial state probabilities.
   initial /= arma::accu(initial);
@@ -52,7 +165,8 @@ HMM<Distribution>::HMM(const arma::vec& initial,
     emission(emission),
     transition(transition),
     initial(initial),
-    tolerance(tolerance)
+    tolerance(tolerance),
+    updates(0)
 {
   // Set the dimensionality, if we can.
   if (emission.size() > 0)
@@ -120,54 +234,16 @@ void HMM<Distribution>::Train(const std::vector<arma::mat>& dataSeq)
     arma::mat newTransition(transition.n_rows, transition.n_cols);
     newTransition.zeros();
 
-    // Reset log likelihood.
-    loglik = 0;
-
-    // Sum over time.
-    size_t sumTime = 0;
-
-    // Loop over each sequence.
-    for (size_t seq = 0; seq < dataSeq.size(); seq++)
-    {
-      arma::mat stateProb;
-      arma::mat forward;
-      arma::mat backward;
-      arma::vec scales;
-
-      // Add the log-likelihood of this sequence.  This is the E-step.
-      loglik += Estimate(dataSeq[seq], stateProb, forward, backward, scales);
-
-      // Add to estimate of initial probability for state j.
-      for (size_t j = 0; j < transition.n_cols; ++j)
-        newInitial[j] += stateProb(j, 0);
-
-      // Now re-estimate the parameters.  This is the M-step.
-      //   pi_i = sum_d ((1 / P(seq[d])) sum_t (f(i, 0) b(i, 0))
-      //   T_ij = sum_d ((1 / P(seq[d])) sum_t (f(i, t) T_ij E_i(seq[d][t]) b(i,
-      //           t + 1)))
-      //   E_ij = sum_d ((1 / P(seq[d])) sum_{t | seq[d][t] = j} f(i, t) b(i, t)
-      // We store the new estimates in a different matrix.
-      for (size_t t = 0; t < dataSeq[seq].n_cols; ++t)
-      {
-        for (size_t j = 0; j < transition.n_cols; ++j)
-        {
-          if (t < dataSeq[seq].n_cols - 1)
-          {
-            // Estimate of T_ij (probability of transition from state j to state
-            // i).  We postpone multiplication of the old T_ij until later.
-            for (size_t i = 0; i < transition.n_rows; i++)
-              newTransition(i, j) += forward(j, t) * backward(i, t + 1) *
-                  emission[i].Probability(dataSeq[seq].unsafe_col(t + 1)) /
-                  scales[t + 1];
-          }
-
-          // Add to list of emission observations, for Distribution::Train().
-          emissionList.col(sumTime) = dataSeq[seq].col(t);
-          emissionProb[j][sumTime] = stateProb(j, t);
-        }
-        sumTime++;
-      }
-    }
+    // This is the E-step; the sequences are split between OpenMP threads.
+    // The new estimates of the parameters are then (the M-step):
+    //   pi_i = sum_d ((1 / P(seq[d])) sum_t (f(i, 0) b(i, 0))
+    //   T_ij = sum_d ((1 / P(seq[d])) sum_t (f(i, t) T_ij E_i(seq[d][t]) b(i,
+    //           t + 1)))
+    //   E_ij = sum_d ((1 / P(seq[d])) sum_{t | seq[d][t] = j} f(i, t) b(i, t)
+    // We store the new estimates in a different matrix.  We postpone
+    // multiplication of the old T_ij until later.
+    loglik = ExpectedStatistics(dataSeq, newInitial, newTransition,
+        emissionProb, emissionList);
 
     // Normalize the new initial probabilities.
     if (dataSeq.size() > 1)
@@ -303,6 +379,111 @@ void HMM<Distribution>::Train(const std::vector<arma::mat>& dataSeq,
   }
 }
 
+/**
+ * Update the model with a batch of unlabeled observation sequences, with one
+ * step of stepwise EM.
+ */
+template<typename Distribution>
+double HMM<Distribution>::Update(const std::vector<arma::mat>& dataSeq,
+                                 const double stepSizeExponent)
+{
+  // Find length of all sequences and ensure they are the correct size.
+  size_t totalLength = 0;
+  size_t totalTransitions = 0;
+  for (size_t seq = 0; seq < dataSeq.size(); seq++)
+  {
+    totalLength += dataSeq[seq].n_cols;
+    if (dataSeq[seq].n_cols > 0)
+      totalTransitions += dataSeq[seq].n_cols - 1;
+
+    if (dataSeq[seq].n_rows != dimensionality)
+      Log::Fatal << "HMM::Update(): data sequence " << seq << " has "
+          << "dimensionality " << dataSeq[seq].n_rows << " (expected "
+          << dimensionality << " dimensions)." << std::endl;
+  }
+
+  if (totalLength == 0)
+    return 0.0;
+
+  // The E-step, as in Train(): accumulate the expected initial states and
+  // transitions, and gather the observations with the probability of each
+  // state.
+  std::vector<arma::vec> emissionProb(transition.n_cols,
+      arma::vec(totalLength));
+  arma::mat emissionList(dimensionality, totalLength);
+  arma::vec batchInitial(transition.n_rows, arma::fill::zeros);
+  arma::mat batchTransition(transition.n_rows, transition.n_cols,
+      arma::fill::zeros);
+
+  // We postpone multiplication of the old T_ij until later.
+  const double loglik = ExpectedStatistics(dataSeq, batchInitial,
+      batchTransition, emissionProb, emissionList);
+
+  size_t sequences = 0;
+  for (size_t seq = 0; seq < dataSeq.size(); seq++)
+    if (dataSeq[seq].n_cols > 0)
+      ++sequences;
+
+  // Average the statistics of the batch over the sequences, transitions, and
+  // observations.
+  batchInitial /= sequences;
+  batchTransition %= transition;
+  if (totalTransitions > 0)
+    batchTransition /= totalTransitions;
+  arma::vec batchOccupancy(transition.n_cols);
+  for (size_t j = 0; j < transition.n_cols; ++j)
+    batchOccupancy[j] = arma::accu(emissionProb[j]) / totalLength;
+
+  // The occupancies are not part of the model, so on the first update all the
+  // states are assumed to be equally occupied.
+  if (updates == 0 || occupancy.n_elem != transition.n_cols)
+  {
+    occupancy.set_size(transition.n_cols);
+    occupancy.fill(1.0 / transition.n_cols);
+  }
+
+  ++updates;
+  const double stepSize = std::pow((double) updates + 1.0, -stepSizeExponent);
+
+  // The M-step.  The running statistic of each transition is the joint
+  // probability of the two states: T_ij times the occupancy of state j.
+  initial = (1.0 - stepSize) * initial + stepSize * batchInitial;
+
+  arma::mat jointTransition = transition;
+  jointTransition.each_row() %= trans(occupancy);
+  if (totalTransitions > 0)
+    transition = (1.0 - stepSize) * jointTransition + stepSize *
+        batchTransition;
+  for (size_t i = 0; i < transition.n_cols; i++)
+  {
+    const double sum = accu(transition.col(i));
+    if (sum > 0.0)
+      transition.col(i) /= sum;
+    else
+      transition.col(i).fill(1.0 / (double) transition.n_rows);
+  }
+
+  // The statistics of each emission are scaled by the occupancy of its state,
+  // so its own step size is the share of its new occupancy that comes from the
+  // batch.
+  const arma::vec newOccupancy = (1.0 - stepSize) * occupancy +
+      stepSize * batchOccupancy;
+  for (size_t state = 0; state < transition.n_cols; state++)
+  {
+    if (newOccupancy[state] > 0.0)
+    {
+      emission[state].Update(emissionList, emissionProb[state],
+          stepSize * batchOccupancy[state] / newOccupancy[state]);
+    }
+  }
+  occupancy = newOccupancy;
+
+  Log::Debug << "HMM::Update(): update " << updates << ": log-likelihood "
+      << loglik << "." << std::endl;
+
+  return loglik;
+}
+
 /**
  * Estimate the probabilities of each hidden state at each time step for each
  * given data observation.
@@ -315,15 +496,19 @@ double HMM<Distribution>::Estimate(const arma::mat& dataSeq,
                                    arma::vec& scales) const
 {
   // First run the forward-backward algorithm.
-  Forward(dataSeq, scales, forwardProb);
-  Backward(dataSeq, scales, backwardProb);
+  arma::mat emissions;
+  arma::vec logScales;
+  const double logLikelihood = ForwardBackward(dataSeq, emissions, forwardProb,
+      backwardProb, scales, logScales);
 
   // Now assemble the state probability matrix based on the forward and backward
   // probabilities.
   stateProb = forwardProb % backwardProb;
 
-  // Finally assemble the log-likelihood and return it.
-  return accu(log(scales));
+  // The scaling factors were computed for the scaled emission probabilities.
+  scales %= arma::exp(logScales);
+
+  return logLikelihood;
 }
 
 /**
@@ -359,18 +544,11 @@ void HMM<Distribution>::Generate(const size_t length,
   // Set start state (default is 0).
   stateSequence[0] = startState;
 
-  // Choose first emission state.
-  double randValue = math::Random();
-
-  // We just have to find where our random value sits in the probability
-  // distribution of emissions for our starting state.
-  dataSequence.col(0) = emission[startState].Random();
-
-  // Now choose the states and emissions for the rest of the sequence.
+  // Choose the states for the rest of the sequence first.
   for (size_t t = 1; t < length; t++)
   {
     // First choose the hidden state.
-    randValue = math::Random();
+    const double randValue = math::Random();
 
     // Now find where our random value sits in the probability distribution of
     // state changes.
@@ -384,9 +562,20 @@ void HMM<Distribution>::Generate(const size_t length,
         break;
       }
     }
+  }
 
-    // Now choose the emission.
-    dataSequence.col(t) = emission[stateSequence[t]].Random();
+  // Now generate the emissions of each state together, and scatter them to
+  // their columns.
+  arma::mat stateSamples;
+  for (size_t state = 0; state < transition.n_rows; state++)
+  {
+    const arma::uvec indices = arma::find(stateSequence == state);
+    if (indices.n_elem == 0)
+      continue;
+
+    EmissionRandom(emission[state], indices.n_elem, dimensionality,
+        stateSamples);
+    dataSequence.cols(indices) = stateSamples;
   }
 }
 
@@ -411,14 +600,20 @@ double HMM<Distribution>::Predict(const arma::mat& dataSeq,
   // will be using the rows of the transition matrix.
   arma::mat logTrans(log(trans(transition)));
 
+  // Compute the log-probabilities of all the emissions at once.
+  arma::mat emissions;
+  arma::vec logScales;
+  EmissionProbabilities(dataSeq, emissions, logScales);
+  const arma::mat logEmissions = log(emissions);
+
   // The calculation of the first state is slightly different; the probability
   // of the first state being state j is the maximum probability that the state
   // came to be j from another state.
   logStateProb.col(0).zeros();
   for (size_t state = 0; state < transition.n_rows; state++)
   {
-    logStateProb(state, 0) = log(initial[state] *
-        emission[state].Probability(dataSeq.unsafe_col(0)));
+    logStateProb(state, 0) = log(initial[state]) + logEmissions(state, 0) +
+        logScales[0];
     stateSeqBack(state, 0) = state;
   }
 
@@ -432,8 +627,8 @@ double HMM<Distribution>::Predict(const arma::mat& dataSeq,
     for (size_t j = 0; j < transition.n_rows; j++)
     {
       arma::vec prob = logStateProb.col(t - 1) + logTrans.col(j);
-      logStateProb(j, t) = prob.max(index) +
-          log(emission[j].Probability(dataSeq.unsafe_col(t)));
+      logStateProb(j, t) = prob.max(index) + logEmissions(j, t) +
+          logScales[t];
         stateSeqBack(j, t) = index;
     }
   }
@@ -454,13 +649,52 @@ double HMM<Distribution>::Predict(const arma::mat& dataSeq,
 template<typename Distribution>
 double HMM<Distribution>::LogLikelihood(const arma::mat& dataSeq) const
 {
+  arma::mat emissions;
   arma::mat forward;
   arma::vec scales;
+  arma::vec logScales;
 
-  Forward(dataSeq, scales, forward);
+  EmissionProbabilities(dataSeq, emissions, logScales);
+  ForwardProbabilities(emissions, scales, forward);
 
-  // The log-likelihood is the log of the scales for each time step.
-  return accu(log(scales));
+  // The log-likelihood is the log of the scales for each time step, plus the
+  // logs of the scales of the emission probabilities.
+  return accu(log(scales)) + accu(logScales);
+}
+
+/**
+ * Compute the most probable hidden state sequence of each data sequence, in
+ * parallel.
+ */
+template<typename Distribution>
+void HMM<Distribution>::Predict(
+    const std::vector<arma::mat>& dataSeq,
+    std::vector<arma::Row<size_t> >& stateSeq) const
+{
+  stateSeq.resize(dataSeq.size());
+
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t seq = 0; seq < (omp_size_t) dataSeq.size(); ++seq)
+  {
+    if (dataSeq[seq].n_cols == 0)
+      stateSeq[seq].reset();
+    else
+      Predict(dataSeq[seq], stateSeq[seq]);
+  }
+}
+
+/**
+ * Compute the log-likelihood of each data sequence, in parallel.
+ */
+template<typename Distribution>
+void HMM<Distribution>::LogLikelihood(const std::vector<arma::mat>& dataSeq,
+                                      arma::vec& logLikelihoods) const
+{
+  logLikelihoods.set_size(dataSeq.size());
+
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t seq = 0; seq < (omp_size_t) dataSeq.size(); ++seq)
+    logLikelihoods[seq] = LogLikelihood(dataSeq[seq]);
 }
 
 /**
@@ -512,20 +746,88 @@ template<typename Distribution>
 void HMM<Distribution>::Forward(const arma::mat& dataSeq,
                                 arma::vec& scales,
                                 arma::mat& forwardProb) const
+{
+  arma::mat emissions;
+  arma::vec logScales;
+  EmissionProbabilities(dataSeq, emissions, logScales);
+  ForwardProbabilities(emissions, scales, forwardProb);
+
+  // The scaling factors were computed for the scaled emission probabilities.
+  scales %= arma::exp(logScales);
+}
+
+template<typename Distribution>
+void HMM<Distribution>::Backward(const arma::mat& dataSeq,
+                                 const arma::vec& scales,
+                                 arma::mat& backwardProb) const
+{
+  arma::mat emissions;
+  arma::vec logScales;
+  EmissionProbabilities(dataSeq, emissions, logScales);
+  BackwardProbabilities(emissions, scales / arma::exp(logScales),
+      backwardProb);
+}
+
+/**
+ * Compute the emission probabilities of each state for each observation, with
+ * the states split between OpenMP threads.
+ */
+template<typename Distribution>
+void HMM<Distribution>::EmissionProbabilities(const arma::mat& dataSeq,
+                                              arma::mat& emissionProb,
+                                              arma::vec& logScales) const
+{
+  emissionProb.set_size(transition.n_rows, dataSeq.n_cols);
+
+  // Each state evaluates its emission distribution on the whole sequence at
+  // once, in the log domain if the distribution supports it.
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t state = 0; state < (omp_size_t) transition.n_rows; ++state)
+  {
+    arma::vec logProbs;
+    EmissionLogProbabilities(emission[state], dataSeq, logProbs);
+    emissionProb.row(state) = trans(logProbs);
+  }
+
+  // Scale the probabilities of each observation so that the largest is 1, so
+  // that they don't underflow even if every state gives the observation a
+  // tiny probability.
+  logScales.zeros(dataSeq.n_cols);
+  for (size_t t = 0; t < dataSeq.n_cols; ++t)
+  {
+    const double maxLogProb = emissionProb.col(t).max();
+    if (maxLogProb == -std::numeric_limits<double>::infinity())
+    {
+      emissionProb.col(t).zeros();
+      continue;
+    }
+
+    logScales[t] = maxLogProb;
+    emissionProb.col(t) = arma::exp(emissionProb.col(t) - maxLogProb);
+  }
+}
+
+/**
+ * The Forward procedure, from the emission probabilities.
+ */
+template<typename Distribution>
+void HMM<Distribution>::ForwardProbabilities(const arma::mat& emissionProb,
+                                             arma::vec& scales,
+                                             arma::mat& forwardProb) const
 {
   // Our goal is to calculate the forward probabilities:
   //  P(X_k | o_{1:k}) for all possible states X_k, for each time point k.
-  forwardProb.zeros(transition.n_rows, dataSeq.n_cols);
-  scales.zeros(dataSeq.n_cols);
+  forwardProb.zeros(transition.n_rows, emissionProb.n_cols);
+  scales.zeros(emissionProb.n_cols);
+  if (emissionProb.n_cols == 0)
+    return;
 
   // The first entry in the forward algorithm uses the initial state
   // probabilities.  Note that MATLAB assumes that the starting state (at
   // t = -1) is state 0; this is not our assumption here.  To force that
   // behavior, you could append a single starting state to every single data
   // sequence and that should produce results in line with MATLAB.
-  for (size_t state = 0; state < transition.n_rows; state++)
-    forwardProb(state, 0) = initial(state) *
-        emission[state].Probability(dataSeq.unsafe_col(0));
+  forwardProb.col(0) = initial % emissionProb.col(0);
 
   // Then normalize the column.
   scales[0] = accu(forwardProb.col(0));
@@ -533,17 +835,13 @@ void HMM<Distribution>::Forward(const arma::mat& dataSeq,
     forwardProb.col(0) /= scales[0];
 
   // Now compute the probabilities for each successive observation.
-  for (size_t t = 1; t < dataSeq.n_cols; t++)
+  for (size_t t = 1; t < emissionProb.n_cols; t++)
   {
-    for (size_t j = 0; j < transition.n_rows; j++)
-    {
-      // The forward probability of state j at time t is the sum over all states
-      // of the probability of the previous state transitioning to the current
-      // state and emitting the given observation.
-      forwardProb(j, t) = accu(forwardProb.col(t - 1) %
-          trans(transition.row(j))) *
-          emission[j].Probability(dataSeq.unsafe_col(t));
-    }
+    // The forward probability of state j at time t is the sum over all states
+    // of the probability of the previous state transitioning to the current
+    // state and emitting the given observation.
+    forwardProb.col(t) = (transition * forwardProb.col(t - 1)) %
+        emissionProb.col(t);
 
     // Normalize probability.
     scales[t] = accu(forwardProb.col(t));
@@ -552,42 +850,159 @@ void HMM<Distribution>::Forward(const arma::mat& dataSeq,
   }
 }
 
+/**
+ * The Backward procedure, from the emission probabilities.
+ */
 template<typename Distribution>
-void HMM<Distribution>::Backward(const arma::mat& dataSeq,
-                                 const arma::vec& scales,
-                                 arma::mat& backwardProb) const
+void HMM<Distribution>::BackwardProbabilities(const arma::mat& emissionProb,
+                                              const arma::vec& scales,
+                                              arma::mat& backwardProb) const
 {
   // Our goal is to calculate the backward probabilities:
   //  P(X_k | o_{k + 1:T}) for all possible states X_k, for each time point k.
-  backwardProb.zeros(transition.n_rows, dataSeq.n_cols);
+  backwardProb.zeros(transition.n_rows, emissionProb.n_cols);
+  if (emissionProb.n_cols == 0)
+    return;
 
   // The last element probability is 1.
-  backwardProb.col(dataSeq.n_cols - 1).fill(1);
+  backwardProb.col(emissionProb.n_cols - 1).fill(1);
 
   // Now step backwards through all other observations.
-  for (size_t t = dataSeq.n_cols - 2; t + 1 > 0; t--)
+  for (size_t t = emissionProb.n_cols - 2; t + 1 > 0; t--)
   {
-    for (size_t j = 0; j < transition.n_rows; j++)
+    // The backward probability of state j at time t is the sum over all states
+    // of the probability of the next state having been a transition from the
+    // current state multiplied by the probability of each of those states
+    // emitting the given observation.
+    backwardProb.col(t) = trans(transition) * (backwardProb.col(t + 1) %
+        emissionProb.col(t + 1));
+
+    // Normalize by the weights from the forward algorithm.
+    if (scales[t + 1] > 0.0)
+      backwardProb.col(t) /= scales[t + 1];
+  }
+}
+
+/**
+ * Run the Forward-Backward algorithm, keeping the scaled emission
+ * probabilities; the scaling factors are those of the scaled emission
+ * probabilities.  Returns the log-likelihood of the sequence.
+ */
+template<typename Distribution>
+double HMM<Distribution>::ForwardBackward(const arma::mat& dataSeq,
+                                          arma::mat& emissionProb,
+                                          arma::mat& forwardProb,
+                                          arma::mat& backwardProb,
+                                          arma::vec& scales,
+                                          arma::vec& logScales) const
+{
+  EmissionProbabilities(dataSeq, emissionProb, logScales);
+  ForwardProbabilities(emissionProb, scales, forwardProb);
+  BackwardProbabilities(emissionProb, scales, backwardProb);
+
+  return accu(log(scales)) + accu(logScales);
+}
+
+/**
+ * Add the expected number of transitions between each pair of states (before
+ * the multiplication by the old transition probabilities) to the given matrix.
+ */
+template<typename Distribution>
+void HMM<Distribution>::ExpectedTransitions(const arma::mat& emissionProb,
+                                            const arma::mat& forwardProb,
+                                            const arma::mat& backwardProb,
+                                            const arma::vec& scales,
+                                            arma::mat& transitions) const
+{
+  const size_t length = emissionProb.n_cols;
+  if (length < 2)
+    return;
+
+  // The sum over t of f(j, t) b(i, t + 1) E_i(t + 1) / s(t + 1) is one matrix
+  // product over all time steps.  (Scaling the emission probabilities of a
+  // time step scales its scaling factor too, so the quotient is unchanged.)
+  arma::mat next = backwardProb.cols(1, length - 1) %
+      emissionProb.cols(1, length - 1);
+  next.each_row() /= trans(scales.subvec(1, length - 1));
+  transitions += next * trans(forwardProb.cols(0, length - 2));
+}
+
+/**
+ * Run the E-step of the Baum-Welch algorithm on all the given sequences,
+ * splitting them between OpenMP threads.
+ */
+template<typename Distribution>
+double HMM<Distribution>::ExpectedStatistics(
+    const std::vector<arma::mat>& dataSeq,
+    arma::vec& initialStats,
+    arma::mat& transitionStats,
+    std::vector<arma::vec>& emissionProb,
+    arma::mat& emissionList) const
+{
+  // Each sequence has its own columns in the emission list, so the threads can
+  // fill them without synchronization.
+  std::vector<size_t> offsets(dataSeq.size());
+  size_t totalLength = 0;
+  for (size_t seq = 0; seq < dataSeq.size(); ++seq)
+  {
+    offsets[seq] = totalLength;
+    totalLength += dataSeq[seq].n_cols;
+  }
+
+  double loglik = 0.0;
+  #pragma omp parallel
+  {
+    // The initial state and transition statistics are accumulated separately
+    // by each thread, then merged.
+    arma::vec threadInitial(initialStats.n_elem, arma::fill::zeros);
+    arma::mat threadTransition(transitionStats.n_rows, transitionStats.n_cols,
+        arma::fill::zeros);
+    double threadLoglik = 0.0;
+
+    #pragma omp for schedule(dynamic)
+    for (omp_size_t seq = 0; seq < (omp_size_t) dataSeq.size(); ++seq)
+    {
+      const size_t length = dataSeq[seq].n_cols;
+      if (length == 0)
+        continue;
+
+      arma::mat emissions;
+      arma::mat forward;
+      arma::mat backward;
+      arma::vec scales;
+      arma::vec logScales;
+      threadLoglik += ForwardBackward(dataSeq[seq], emissions, forward,
+          backward, scales, logScales);
+      const arma::mat stateProb = forward % backward;
+
+      threadInitial += stateProb.col(0);
+      ExpectedTransitions(emissions, forward, backward, scales,
+          threadTransition);
+
+      const size_t offset = offsets[seq];
+      emissionList.cols(offset, offset + length - 1) = dataSeq[seq];
+      for (size_t j = 0; j < transition.n_cols; ++j)
+      {
+        emissionProb[j].subvec(offset, offset + length - 1) =
+            trans(stateProb.row(j));
+      }
+    }
+
+    #pragma omp critical(HMMExpectedStatistics)
     {
-      // The backward probability of state j at time t is the sum over all state
-      // of the probability of the next state having been a transition from the
-      // current state multiplied by the probability of each of those states
-      // emitting the given observation.
-      for (size_t state = 0; state < transition.n_rows; state++)
-        backwardProb(j, t) += transition(state, j) * backwardProb(state, t + 1)
-            * emission[state].Probability(dataSeq.unsafe_col(t + 1));
-
-      // Normalize by the weights from the forward algorithm.
-      if (scales[t + 1] > 0.0)
-        backwardProb(j, t) /= scales[t + 1];
+      initialStats += threadInitial;
+      transitionStats += threadTransition;
+      loglik += threadLoglik;
     }
   }
+
+  return loglik;
 }
 
 //! Serialize the HMM.
 template<typename Distribution>
 template<typename Archive>
-void HMM<Distribution>::serialize(Archive& ar, const unsigned int /* version */)
+void HMM<Distribution>::serialize(Archive& ar, const unsigned int version)
 {
   ar & BOOST_SERIALIZATION_NVP(dimensionality);
   ar & BOOST_SERIALIZATION_NVP(tolerance);
@@ -601,6 +1016,18 @@ void HMM<Distribution>::serialize(Archive& ar, const unsigned int /* version */)
 
   // Load the emissions; generate the correct name for each one.
     ar & BOOST_SERIALIZATION_NVP(emission);
+
+  // Older models don't have the state of the online updates.
+  if (version > 0)
+  {
+    ar & BOOST_SERIALIZATION_NVP(updates);
+    ar & BOOST_SERIALIZATION_NVP(occupancy);
+  }
+  else if (Archive::is_loading::value)
+  {
+    updates = 0;
+    occupancy.clear();
+  }
 }
 
 } // namespace hmm
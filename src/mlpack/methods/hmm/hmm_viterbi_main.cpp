@@ -41,10 +41,19 @@ PROGRAM_INFO("Hidden Markov Model (HMM) Viterbi State Prediction", "This "
     ", the following command could be used:"
     "\n\n" +
     PRINT_CALL("hmm_viterbi", "input", "obs", "input_model", "hmm", "output",
-        "states"));
+        "states") +
+    "\n\n"
+    "Many sequences can be decoded at once (in parallel, if mlpack was built "
+    "with OpenMP) by concatenating their observations in " +
+    PRINT_PARAM_STRING("input") + " and giving the length of each sequence "
+    "with " + PRINT_PARAM_STRING("lengths") + "; the predicted state sequences "
+    "are then concatenated in the same way in " +
+    PRINT_PARAM_STRING("output") + ".");
 
 PARAM_MATRIX_IN_REQ("input", "Matrix containing observations,", "i");
 PARAM_MODEL_IN_REQ(HMMModel, "input_model", "Trained HMM to use.", "m");
+PARAM_UROW_IN("lengths", "Lengths of the sequences whose observations are "
+    "concatenated in the input, if there are several.", "l");
 PARAM_UMATRIX_OUT("output", "File to save predicted state sequence to.", "o");
 
 // Because we don't know what the type of our HMM is, we need to write a
@@ -74,7 +83,43 @@ struct Viterbi
     }
 
     arma::Row<size_t> sequence;
-    hmm.Predict(dataSeq, sequence);
+    if (CLI::HasParam("lengths"))
+    {
+      // Split the observations into the sequences and decode them all at once.
+      const arma::Row<size_t>& lengths =
+          CLI::GetParam<arma::Row<size_t>>("lengths");
+      if (arma::accu(lengths) != dataSeq.n_cols)
+      {
+        Log::Fatal << "Sum of sequence lengths (" << arma::accu(lengths)
+            << ") does not match number of observations (" << dataSeq.n_cols
+            << ")!" << endl;
+      }
+
+      std::vector<arma::mat> dataSeqs(lengths.n_elem);
+      size_t start = 0;
+      for (size_t i = 0; i < lengths.n_elem; ++i)
+      {
+        if (lengths[i] > 0)
+          dataSeqs[i] = dataSeq.cols(start, start + lengths[i] - 1);
+        start += lengths[i];
+      }
+
+      std::vector<arma::Row<size_t>> stateSeqs;
+      hmm.Predict(dataSeqs, stateSeqs);
+
+      sequence.set_size(dataSeq.n_cols);
+      start = 0;
+      for (size_t i = 0; i < lengths.n_elem; ++i)
+      {
+        if (lengths[i] > 0)
+          sequence.cols(start, start + lengths[i] - 1) = stateSeqs[i];
+        start += lengths[i];
+      }
+    }
+    else
+    {
+      hmm.Predict(dataSeq, sequence);
+    }
 
     // Save output.
     if (CLI::HasParam("output"))
@@ -0,0 +1,197 @@
+/**
+ * @file hnsw_main.cpp
+ *
+ * This file computes approximate nearest neighbors with a hierarchical
+ * navigable small world graph.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/util/cli.hpp>
+#include <mlpack/core/util/mlpack_main.hpp>
+
+#include <mlpack/methods/lsh/lsh_search.hpp>
+
+#include "hnsw_search.hpp"
+
+using namespace std;
+using namespace mlpack;
+using namespace mlpack::neighbor;
+using namespace mlpack::util;
+
+// Information about the program itself.
+PROGRAM_INFO("K-Approximate-Nearest-Neighbor Search with HNSW",
+    "This program will calculate the k approximate-nearest-neighbors of a set "
+    "of points using a hierarchical navigable small world (HNSW) graph. You "
+    "may specify a separate set of reference points and query points, or just "
+    "a reference set which will be used as both the reference and query set "
+    "(in which case each point is not returned as its own neighbor)."
+    "\n\n"
+    "For example, the following will build a graph on the data in " +
+    PRINT_DATASET("input") + ", return 5 neighbors for each point, and store "
+    "the distances in " + PRINT_DATASET("distances") + " and the neighbors in "
+    + PRINT_DATASET("neighbors") + ":"
+    "\n\n" +
+    PRINT_CALL("hnsw", "k", 5, "reference", "input", "distances", "distances",
+        "neighbors", "neighbors") +
+    "\n\n"
+    "The output is organized such that row i and column j in the neighbors "
+    "output corresponds to the index of the point in the reference set which "
+    "is the j'th nearest neighbor from the point in the query set with index "
+    "i.  Row j and column i in the distances output file corresponds to the "
+    "distance between those two points."
+    "\n\n"
+    "Each point is linked to " + PRINT_PARAM_STRING("links") + " neighbors in "
+    "each layer of the graph, and " + PRINT_PARAM_STRING("ef_construction") +
+    " candidates are searched for when a point is inserted; larger values give "
+    "a better graph but take longer to build.  During the search, " +
+    PRINT_PARAM_STRING("ef") + " candidates are kept; larger values give "
+    "better recall but take longer.  A graph can be saved with " +
+    PRINT_PARAM_STRING("output_model") + " and reused with " +
+    PRINT_PARAM_STRING("input_model") + "."
+    "\n\n"
+    "If " + PRINT_PARAM_STRING("true_neighbors") + " is given, the recall of "
+    "the results is printed when " + PRINT_PARAM_STRING("verbose") + " is "
+    "specified.");
+
+// Define our input parameters that this program will take.
+PARAM_MATRIX_IN("reference", "Matrix containing the reference dataset.", "r");
+PARAM_MATRIX_OUT("distances", "Matrix to output distances into.", "d");
+PARAM_UMATRIX_OUT("neighbors", "Matrix to output neighbors into.", "n");
+
+// We can load or save models.
+PARAM_MODEL_IN(HNSWSearch<>, "input_model", "Input HNSW model.", "m");
+PARAM_MODEL_OUT(HNSWSearch<>, "output_model", "Output for trained HNSW model.",
+    "M");
+
+// For testing recall.
+PARAM_UMATRIX_IN("true_neighbors", "Matrix of true neighbors to compute "
+    "recall with (the recall is printed when -v is specified).", "t");
+
+PARAM_INT_IN("k", "Number of nearest neighbors to find.", "k", 0);
+PARAM_MATRIX_IN("query", "Matrix containing query points (optional).", "q");
+
+PARAM_INT_IN("links", "Number of neighbors each point is linked to in each "
+    "layer of the graph.", "l", 16);
+PARAM_INT_IN("ef_construction", "Number of candidates searched for when a "
+    "point is inserted into the graph.", "c", 200);
+PARAM_INT_IN("ef", "Number of candidates kept during the search (if 0, "
+    "--ef_construction is used).", "e", 0);
+PARAM_INT_IN("seed", "Random seed.  If 0, 'std::time(NULL)' is used.", "s", 0);
+
+void mlpackMain()
+{
+  if (CLI::GetParam<int>("seed") != 0)
+    math::RandomSeed((size_t) CLI::GetParam<int>("seed"));
+  else
+    math::RandomSeed((size_t) time(NULL));
+
+  // Get all the parameters after checking them.
+  if (CLI::HasParam("k"))
+  {
+    RequireParamValue<int>("k", [](int x) { return x > 0; }, true,
+        "k must be greater than 0");
+  }
+  RequireParamValue<int>("links", [](int x) { return x > 1; }, true,
+      "number of links must be greater than 1");
+  RequireParamValue<int>("ef_construction", [](int x) { return x > 0; }, true,
+      "ef_construction must be greater than 0");
+  RequireParamValue<int>("ef", [](int x) { return x >= 0; }, true,
+      "ef must be nonnegative");
+
+  RequireOnlyOnePassed({ "input_model", "reference" }, true);
+  RequireAtLeastOnePassed({ "neighbors", "distances", "output_model" }, false,
+      "no results will be saved");
+
+  ReportIgnoredParam({{ "k", false }}, "neighbors");
+  ReportIgnoredParam({{ "k", false }}, "distances");
+  ReportIgnoredParam({{ "k", false }}, "ef");
+
+  ReportIgnoredParam({{ "reference", false }}, "links");
+  ReportIgnoredParam({{ "reference", false }}, "ef_construction");
+
+  if (CLI::HasParam("input_model") && !CLI::HasParam("k"))
+  {
+    Log::Warn << PRINT_PARAM_STRING("k") << " not passed; no search will be "
+        << "performed!" << std::endl;
+  }
+
+  const size_t k = (size_t) CLI::GetParam<int>("k");
+  const size_t ef = (size_t) CLI::GetParam<int>("ef");
+
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+
+  HNSWSearch<> hnsw;
+  if (CLI::HasParam("reference"))
+  {
+    arma::mat referenceData = std::move(CLI::GetParam<arma::mat>("reference"));
+    Log::Info << "Using reference data from '"
+        << CLI::GetPrintableParam<arma::mat>("reference") << "' ("
+        << referenceData.n_rows << " x " << referenceData.n_cols << ")."
+        << endl;
+
+    const size_t links = (size_t) CLI::GetParam<int>("links");
+    const size_t efConstruction =
+        (size_t) CLI::GetParam<int>("ef_construction");
+    Log::Info << "Building HNSW graph with " << links << " links per point and "
+        << "ef_construction " << efConstruction << "." << endl;
+
+    hnsw.Train(std::move(referenceData), links, efConstruction);
+  }
+  else
+  {
+    hnsw = std::move(CLI::GetParam<HNSWSearch<>>("input_model"));
+  }
+
+  if (CLI::HasParam("k"))
+  {
+    Log::Info << "Computing " << k << " distance approximate nearest neighbors."
+        << endl;
+    if (CLI::HasParam("query"))
+    {
+      arma::mat queryData = std::move(CLI::GetParam<arma::mat>("query"));
+      Log::Info << "Loaded query data from '"
+          << CLI::GetPrintableParam<arma::mat>("query") << "' ("
+          << queryData.n_rows << " x " << queryData.n_cols << ")." << endl;
+
+      hnsw.Search(queryData, k, neighbors, distances, ef);
+    }
+    else
+    {
+      hnsw.Search(k, neighbors, distances, ef);
+    }
+
+    Log::Info << "Neighbors computed with " << hnsw.DistanceEvaluations()
+        << " distance evaluations." << endl;
+  }
+
+  // Compute recall, if desired.
+  if (CLI::HasParam("true_neighbors") && CLI::HasParam("k"))
+  {
+    arma::Mat<size_t> trueNeighbors =
+        std::move(CLI::GetParam<arma::Mat<size_t>>("true_neighbors"));
+    Log::Info << "Using true neighbor indices from '"
+        << CLI::GetPrintableParam<arma::Mat<size_t>>("true_neighbors") << "'."
+        << endl;
+
+    const double recallPercentage = 100 * LSHSearch<>::ComputeRecall(neighbors,
+        trueNeighbors);
+
+    Log::Info << "Recall: " << recallPercentage << endl;
+  }
+
+  // Save output, if desired.
+  if (CLI::HasParam("k"))
+  {
+    if (CLI::HasParam("distances"))
+      CLI::GetParam<arma::mat>("distances") = std::move(distances);
+    if (CLI::HasParam("neighbors"))
+      CLI::GetParam<arma::Mat<size_t>>("neighbors") = std::move(neighbors);
+  }
+  if (CLI::HasParam("output_model"))
+    CLI::GetParam<HNSWSearch<>>("output_model") = std::move(hnsw);
+}
@@ -0,0 +1,311 @@
+/**
+ * @file hnsw_search.hpp
+ *
+ * Defines the HNSWSearch class, which performs approximate nearest neighbor
+ * search with a hierarchical navigable small world graph.
+ *
+ * The details of this method can be found in the following paper:
+ *
+ * @code
+ * @article{malkov2018efficient,
+ *   title={Efficient and robust approximate nearest neighbor search using
+ *       Hierarchical Navigable Small World graphs},
+ *   author={Malkov, Y.A. and Yashunin, D.A.},
+ *   journal={IEEE Transactions on Pattern Analysis and Machine Intelligence},
+ *   volume={42},
+ *   number={4},
+ *   pages={824--836},
+ *   year={2018}
+ * }
+ * @endcode
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_HNSW_HNSW_SEARCH_HPP
+#define MLPACK_METHODS_HNSW_HNSW_SEARCH_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include <mlpack/core/metrics/lmetric.hpp>
+
+#include <algorithm>
+#include <queue>
+
+namespace mlpack {
+namespace neighbor {
+
+/**
+ * The HNSWSearch class builds a hierarchical navigable small world graph on
+ * the reference set and uses it to compute approximate nearest neighbors of
+ * the given queries.  Each point is a node of the bottom layer of the graph,
+ * and exponentially fewer points are also nodes of each higher layer.  A
+ * search descends greedily through the higher layers and then does a best-first
+ * search with a list of ef candidates in the bottom layer; larger values of ef
+ * give better recall at the price of more distance computations.
+ *
+ * The points are inserted in batches: the candidate neighbors of all points of
+ * a batch are searched for in parallel (if OpenMP is available), and the points
+ * are then linked into the graph one by one.  The batches only depend on the
+ * number of points, so the graph does not depend on the number of threads.
+ *
+ * @code
+ * HNSWSearch<> hnsw(referenceSet); // M = 16, efConstruction = 200.
+ * hnsw.Search(querySet, 10, neighbors, distances, 100); // ef = 100.
+ * @endcode
+ *
+ * The recall of the results can be computed with LSHSearch::ComputeRecall().
+ *
+ * @tparam MetricType Metric to use for distances; the distances between
+ *     neighbors must obey the triangle inequality for the graph to be
+ *     navigable.
+ * @tparam MatType Type of data matrix.
+ */
+template<typename MetricType = metric::EuclideanDistance,
+         typename MatType = arma::mat>
+class HNSWSearch
+{
+ public:
+  /**
+   * Build the graph on the given reference set.  In order to avoid copying the
+   * reference set, it is suggested to pass that parameter with std::move().
+   *
+   * @param referenceSet Set of reference points.
+   * @param m Number of neighbors each point is linked to in each layer (the
+   *     bottom layer allows up to 2 * m links).
+   * @param efConstruction Number of candidates searched for when inserting a
+   *     point.
+   * @param metric Instantiated metric.
+   */
+  HNSWSearch(MatType referenceSet,
+             const size_t m = 16,
+             const size_t efConstruction = 200,
+             const MetricType metric = MetricType());
+
+  /**
+   * Create an untrained HNSWSearch object.  Train() must be called before
+   * Search().
+   *
+   * @param m Number of neighbors each point is linked to in each layer.
+   * @param efConstruction Number of candidates searched for when inserting a
+   *     point.
+   * @param metric Instantiated metric.
+   */
+  HNSWSearch(const size_t m = 16,
+             const size_t efConstruction = 200,
+             const MetricType metric = MetricType());
+
+  /**
+   * Build the graph on the given reference set, replacing any existing graph.
+   * In order to avoid copying the reference set, it is suggested to pass that
+   * parameter with std::move().
+   *
+   * @param referenceSet Set of reference points.
+   * @param m Number of neighbors each point is linked to in each layer.
+   * @param efConstruction Number of candidates searched for when inserting a
+   *     point.
+   */
+  void Train(MatType referenceSet,
+             const size_t m = 16,
+             const size_t efConstruction = 200);
+
+  /**
+   * Compute the approximate nearest neighbors of the points in the given query
+   * set and store the output in the given matrices.  The matrices will be set
+   * to the size of k by n, where k is the number of neighbors and n is the
+   * number of points in the query set.  If fewer than k neighbors are found
+   * for a query point, the remaining neighbors are set to the number of
+   * reference points and their distances to DBL_MAX.
+   *
+   * @param querySet Set of query points.
+   * @param k Number of neighbors to search for.
+   * @param neighbors Matrix storing lists of neighbors for each query point.
+   * @param distances Matrix storing distances of neighbors for each query
+   *     point.
+   * @param ef Number of candidates kept in the bottom layer; if 0,
+   *     EfConstruction() is used.  At least k candidates are always kept.
+   */
+  void Search(const MatType& querySet,
+              const size_t k,
+              arma::Mat<size_t>& neighbors,
+              arma::mat& distances,
+              const size_t ef = 0);
+
+  /**
+   * Compute the approximate nearest neighbors of each point in the reference
+   * set (excluding the point itself) and store the output in the given
+   * matrices.
+   *
+   * @param k Number of neighbors to search for.
+   * @param neighbors Matrix storing lists of neighbors for each point.
+   * @param distances Matrix storing distances of neighbors for each point.
+   * @param ef Number of candidates kept in the bottom layer; if 0,
+   *     EfConstruction() is used.
+   */
+  void Search(const size_t k,
+              arma::Mat<size_t>& neighbors,
+              arma::mat& distances,
+              const size_t ef = 0);
+
+  //! Return the reference dataset.
+  const MatType& ReferenceSet() const { return referenceSet; }
+
+  //! Get the number of links per point and layer.
+  size_t M() const { return m; }
+  //! Get the number of candidates searched for when inserting a point.
+  size_t EfConstruction() const { return efConstruction; }
+
+  //! Get the number of layers of the graph.
+  size_t NumLayers() const { return referenceSet.n_cols == 0 ? 0 :
+      maxLayer + 1; }
+  //! Get the entry point of the graph.
+  size_t EntryPoint() const { return entryPoint; }
+  //! Get the highest layer of each point.
+  const arma::Col<size_t>& Layers() const { return layers; }
+  //! Get the number of bottom layer links of each point.
+  const arma::Col<size_t>& BaseDegrees() const { return baseDegrees; }
+  //! Get the bottom layer links; column i holds the links of point i.
+  const arma::Mat<size_t>& BaseLinks() const { return baseLinks; }
+
+  //! Return the number of distance evaluations of the last Search() call.
+  size_t DistanceEvaluations() const { return distanceEvaluations; }
+
+  //! Get the instantiated metric.
+  const MetricType& Metric() const { return metric; }
+  //! Modify the instantiated metric.
+  MetricType& Metric() { return metric; }
+
+  //! Serialize the HNSW model.
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */);
+
+ private:
+  //! A candidate neighbor: its distance and its index.
+  typedef std::pair<double, size_t> Candidate;
+
+  /**
+   * Find the candidate neighbors of point p in each of its layers, while the
+   * graph holds the points before begin.  The points in [begin, p) are not in
+   * the graph yet, so they are compared with p directly.
+   *
+   * @param p Point to find the candidate neighbors of.
+   * @param begin First point of the current batch.
+   * @param candidates Candidates of each layer, sorted by distance.
+   * @param visited Stamps of the points visited, one per reference point.
+   * @param epoch Stamp of the last search.
+   */
+  void FindCandidates(const size_t p,
+                      const size_t begin,
+                      std::vector<std::vector<Candidate>>& candidates,
+                      std::vector<size_t>& visited,
+                      size_t& epoch) const;
+
+  /**
+   * Link point p into the graph, given its candidate neighbors in each of its
+   * layers.
+   */
+  void LinkPoint(const size_t p,
+                 const std::vector<std::vector<Candidate>>& candidates);
+
+  /**
+   * Search the given layer from the given entry points, and return the ef
+   * closest points found, sorted by distance.
+   *
+   * @param query Point to search for.
+   * @param entryPoints Points to start from, with their distances.
+   * @param ef Number of candidates to keep.
+   * @param layer Layer to search.
+   * @param visited Stamps of the points visited, one per reference point.
+   * @param epoch Stamp of the current search; incremented on each call.
+   * @param evaluations Counter of distance evaluations.
+   */
+  template<typename VecType>
+  std::vector<Candidate> SearchLayer(const VecType& query,
+                                     const std::vector<Candidate>& entryPoints,
+                                     const size_t ef,
+                                     const size_t layer,
+                                     std::vector<size_t>& visited,
+                                     size_t& epoch,
+                                     size_t& evaluations) const;
+
+  /**
+   * Compute the nearest neighbors of a single point, descending through the
+   * layers from the entry point.  The point with index exclude (if it is a
+   * valid index) is skipped.
+   */
+  template<typename VecType>
+  void SearchPoint(const VecType& query,
+                   const size_t k,
+                   const size_t ef,
+                   const size_t exclude,
+                   size_t* neighborsOut,
+                   double* distancesOut,
+                   std::vector<size_t>& visited,
+                   size_t& epoch,
+                   size_t& evaluations) const;
+
+  /**
+   * Select at most maxLinks neighbors among the given candidates (sorted by
+   * distance) with the heuristic of the paper: a candidate is only kept if it
+   * is closer to the point than to every neighbor kept before it, so that the
+   * links point in diverse directions.
+   */
+  void SelectNeighbors(const std::vector<Candidate>& candidates,
+                       const size_t maxLinks,
+                       std::vector<size_t>& selected) const;
+
+  //! Add a link from point i to point j in the given layer, pruning the links
+  //! of i if it has too many.
+  void AddLink(const size_t i, const size_t j, const size_t layer);
+
+  //! Get the links of point i in the given layer and their number.
+  const size_t* Links(const size_t i,
+                      const size_t layer,
+                      size_t& count) const;
+
+  //! Set the links of point i in the given layer.
+  void SetLinks(const size_t i,
+                const size_t layer,
+                const std::vector<size_t>& links);
+
+  //! Maximum number of links of a point in the given layer.
+  size_t MaxLinks(const size_t layer) const { return layer == 0 ? 2 * m : m; }
+
+  //! Reference dataset.
+  MatType referenceSet;
+  //! Number of links per point and layer.
+  size_t m;
+  //! Number of candidates searched for when inserting a point.
+  size_t efConstruction;
+  //! Instantiated metric.
+  MetricType metric;
+
+  //! The highest layer of each point.
+  arma::Col<size_t> layers;
+  //! The highest layer of the graph.
+  size_t maxLayer;
+  //! The point the searches start from; it is in the highest layer.
+  size_t entryPoint;
+
+  //! The number of bottom layer links of each point.
+  arma::Col<size_t> baseDegrees;
+  //! The bottom layer links, one column of 2 * m entries per point; they are
+  //! kept contiguous since most of the distance evaluations happen there.
+  arma::Mat<size_t> baseLinks;
+  //! The links of the higher layers: upperLinks[i][l - 1] holds the links of
+  //! point i in layer l.
+  std::vector<std::vector<std::vector<size_t>>> upperLinks;
+
+  //! The number of distance evaluations of the last Search() call.
+  size_t distanceEvaluations;
+}; // class HNSWSearch
+
+} // namespace neighbor
+} // namespace mlpack
+
+// Include implementation.
+#include "hnsw_search_impl.hpp"
+
+#endif
@@ -0,0 +1,524 @@
+/**
+ * @file hnsw_search_impl.hpp
+ *
+ * Implementation of the HNSWSearch class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_HNSW_HNSW_SEARCH_IMPL_HPP
+#define MLPACK_METHODS_HNSW_HNSW_SEARCH_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "hnsw_search.hpp"
+
+#include <mlpack/core/math/random.hpp>
+
+namespace mlpack {
+namespace neighbor {
+
+// Construct and build the graph.
+template<typename MetricType, typename MatType>
+HNSWSearch<MetricType, MatType>::HNSWSearch(MatType referenceSet,
+                                            const size_t m,
+                                            const size_t efConstruction,
+                                            const MetricType metric) :
+    m(m),
+    efConstruction(efConstruction),
+    metric(metric),
+    maxLayer(0),
+    entryPoint(0),
+    distanceEvaluations(0)
+{
+  Train(std::move(referenceSet), m, efConstruction);
+}
+
+// Construct an empty object.
+template<typename MetricType, typename MatType>
+HNSWSearch<MetricType, MatType>::HNSWSearch(const size_t m,
+                                            const size_t efConstruction,
+                                            const MetricType metric) :
+    m(m),
+    efConstruction(efConstruction),
+    metric(metric),
+    maxLayer(0),
+    entryPoint(0),
+    distanceEvaluations(0)
+{
+  // Nothing to do.
+}
+
+template<typename MetricType, typename MatType>
+void HNSWSearch<MetricType, MatType>::Train(MatType referenceSet,
+                                            const size_t m,
+                                            const size_t efConstruction)
+{
+  if (m < 2)
+  {
+    throw std::invalid_argument("HNSWSearch::Train(): the number of links per "
+        "point (m) must be at least 2");
+  }
+
+  this->referenceSet = std::move(referenceSet);
+  this->m = m;
+  this->efConstruction = efConstruction;
+
+  const size_t n = this->referenceSet.n_cols;
+
+  // The highest layer of each point follows a geometric distribution, so that
+  // each layer has about 1 / m of the points of the layer below.
+  const double layerMult = 1.0 / std::log((double) m);
+  layers.set_size(n);
+  for (size_t i = 0; i < n; ++i)
+  {
+    layers[i] = (size_t) std::floor(-std::log(1.0 - math::Random()) *
+        layerMult);
+  }
+
+  baseDegrees.zeros(n);
+  baseLinks.set_size(MaxLinks(0), n);
+  upperLinks.clear();
+  upperLinks.resize(n);
+  for (size_t i = 0; i < n; ++i)
+    upperLinks[i].resize(layers[i]);
+
+  maxLayer = (n == 0) ? 0 : layers[0];
+  entryPoint = 0;
+  if (n <= 1)
+    return;
+
+  // The first point is the whole graph.  The following batches grow with the
+  // graph, so that each batch is small compared to the points it is searched
+  // against, and are capped since the points of a batch are compared with each
+  // other directly.
+  std::vector<size_t> batchBegins;
+  for (size_t begin = 1; begin < n;
+       begin += std::min(std::max(begin / 8, (size_t) 1), (size_t) 256))
+    batchBegins.push_back(begin);
+  batchBegins.push_back(n);
+
+  std::vector<std::vector<std::vector<Candidate>>> candidates(256);
+
+  Timer::Start("hnsw_construction");
+
+  #pragma omp parallel
+  {
+    // Each thread keeps its own stamps for the whole construction.
+    std::vector<size_t> visited(n, 0);
+    size_t epoch = 0;
+
+    for (size_t b = 0; b + 1 < batchBegins.size(); ++b)
+    {
+      const size_t begin = batchBegins[b];
+      const size_t end = batchBegins[b + 1];
+
+      // The graph is only modified in the single section below, after the
+      // barrier at the end of this loop.
+      #pragma omp for schedule(dynamic)
+      for (omp_size_t p = (omp_size_t) begin; p < (omp_size_t) end; ++p)
+        FindCandidates(p, begin, candidates[p - begin], visited, epoch);
+
+      #pragma omp single
+      {
+        for (size_t p = begin; p < end; ++p)
+          LinkPoint(p, candidates[p - begin]);
+      }
+    }
+  }
+
+  Timer::Stop("hnsw_construction");
+}
+
+template<typename MetricType, typename MatType>
+void HNSWSearch<MetricType, MatType>::Search(const MatType& querySet,
+                                             const size_t k,
+                                             arma::Mat<size_t>& neighbors,
+                                             arma::mat& distances,
+                                             const size_t ef)
+{
+  if (querySet.n_rows != referenceSet.n_rows)
+  {
+    std::ostringstream oss;
+    oss << "HNSWSearch::Search(): dimensionality of query set ("
+        << querySet.n_rows << ") is not equal to the dimensionality the model "
+        << "was trained on (" << referenceSet.n_rows << ")!" << std::endl;
+    throw std::invalid_argument(oss.str());
+  }
+
+  if (k > referenceSet.n_cols)
+  {
+    std::ostringstream oss;
+    oss << "HNSWSearch::Search(): requested " << k << " approximate nearest "
+        << "neighbors, but reference set has " << referenceSet.n_cols
+        << " points!" << std::endl;
+    throw std::invalid_argument(oss.str());
+  }
+
+  neighbors.set_size(k, querySet.n_cols);
+  distances.set_size(k, querySet.n_cols);
+  distanceEvaluations = 0;
+  if (k == 0)
+    return;
+
+  const size_t searchEf = std::max(ef == 0 ? efConstruction : ef, k);
+  size_t evaluations = 0;
+
+  Timer::Start("computing_neighbors");
+
+  #pragma omp parallel reduction(+:evaluations)
+  {
+    std::vector<size_t> visited(referenceSet.n_cols, 0);
+    size_t epoch = 0;
+
+    #pragma omp for schedule(dynamic, 16)
+    for (omp_size_t i = 0; i < (omp_size_t) querySet.n_cols; ++i)
+    {
+      SearchPoint(querySet.col(i), k, searchEf, referenceSet.n_cols,
+          neighbors.colptr(i), distances.colptr(i), visited, epoch,
+          evaluations);
+    }
+  }
+
+  Timer::Stop("computing_neighbors");
+
+  distanceEvaluations = evaluations;
+}
+
+template<typename MetricType, typename MatType>
+void HNSWSearch<MetricType, MatType>::Search(const size_t k,
+                                             arma::Mat<size_t>& neighbors,
+                                             arma::mat& distances,
+                                             const size_t ef)
+{
+  if (referenceSet.n_cols == 0 ? k > 0 : k > referenceSet.n_cols - 1)
+  {
+    std::ostringstream oss;
+    oss << "HNSWSearch::Search(): requested " << k << " approximate nearest "
+        << "neighbors, but reference set has " << referenceSet.n_cols
+        << " points!" << std::endl;
+    throw std::invalid_argument(oss.str());
+  }
+
+  neighbors.set_size(k, referenceSet.n_cols);
+  distances.set_size(k, referenceSet.n_cols);
+  distanceEvaluations = 0;
+  if (k == 0)
+    return;
+
+  const size_t searchEf = std::max(ef == 0 ? efConstruction : ef, k);
+  size_t evaluations = 0;
+
+  Timer::Start("computing_neighbors");
+
+  #pragma omp parallel reduction(+:evaluations)
+  {
+    std::vector<size_t> visited(referenceSet.n_cols, 0);
+    size_t epoch = 0;
+
+    #pragma omp for schedule(dynamic, 16)
+    for (omp_size_t i = 0; i < (omp_size_t) referenceSet.n_cols; ++i)
+    {
+      SearchPoint(referenceSet.col(i), k, searchEf, i, neighbors.colptr(i),
+          distances.colptr(i), visited, epoch, evaluations);
+    }
+  }
+
+  Timer::Stop("computing_neighbors");
+
+  distanceEvaluations = evaluations;
+}
+
+template<typename MetricType, typename MatType>
+template<typename VecType>
+std::vector<typename HNSWSearch<MetricType, MatType>::Candidate>
+HNSWSearch<MetricType, MatType>::SearchLayer(
+    const VecType& query,
+    const std::vector<Candidate>& entryPoints,
+    const size_t ef,
+    const size_t layer,
+    std::vector<size_t>& visited,
+    size_t& epoch,
+    size_t& evaluations) const
+{
+  // Stamping the visited points avoids clearing a set for every search.
+  ++epoch;
+
+  // The points whose links are still to be followed, closest first, and the
+  // ef closest points found so far, farthest first.
+  std::priority_queue<Candidate, std::vector<Candidate>,
+      std::greater<Candidate>> toVisit;
+  std::priority_queue<Candidate> found;
+  for (size_t i = 0; i < entryPoints.size(); ++i)
+  {
+    visited[entryPoints[i].second] = epoch;
+    toVisit.push(entryPoints[i]);
+    found.push(entryPoints[i]);
+    if (found.size() > ef)
+      found.pop();
+  }
+
+  while (!toVisit.empty())
+  {
+    const Candidate current = toVisit.top();
+
+    // No point left to visit can improve the results.
+    if (found.size() >= ef && current.first > found.top().first)
+      break;
+    toVisit.pop();
+
+    size_t count;
+    const size_t* links = Links(current.second, layer, count);
+    for (size_t j = 0; j < count; ++j)
+    {
+      const size_t neighbor = links[j];
+      if (visited[neighbor] == epoch)
+        continue;
+      visited[neighbor] = epoch;
+
+      const double distance = metric.Evaluate(query,
+          referenceSet.col(neighbor));
+      ++evaluations;
+
+      if (found.size() < ef || distance < found.top().first)
+      {
+        toVisit.push(Candidate(distance, neighbor));
+        found.push(Candidate(distance, neighbor));
+        if (found.size() > ef)
+          found.pop();
+      }
+    }
+  }
+
+  std::vector<Candidate> results(found.size());
+  for (size_t i = results.size(); i > 0; --i)
+  {
+    results[i - 1] = found.top();
+    found.pop();
+  }
+
+  return results;
+}
+
+template<typename MetricType, typename MatType>
+template<typename VecType>
+void HNSWSearch<MetricType, MatType>::SearchPoint(const VecType& query,
+                                                  const size_t k,
+                                                  const size_t ef,
+                                                  const size_t exclude,
+                                                  size_t* neighborsOut,
+                                                  double* distancesOut,
+                                                  std::vector<size_t>& visited,
+                                                  size_t& epoch,
+                                                  size_t& evaluations) const
+{
+  // Descend greedily to the bottom layer.
+  std::vector<Candidate> entryPoints(1, Candidate(metric.Evaluate(query,
+      referenceSet.col(entryPoint)), entryPoint));
+  ++evaluations;
+  for (size_t l = maxLayer; l > 0; --l)
+    entryPoints = SearchLayer(query, entryPoints, 1, l, visited, epoch,
+        evaluations);
+
+  // If the query is a reference point, it will be found too.
+  const size_t layerEf = (exclude < referenceSet.n_cols) ? ef + 1 : ef;
+  const std::vector<Candidate> results = SearchLayer(query, entryPoints,
+      layerEf, 0, visited, epoch, evaluations);
+
+  size_t found = 0;
+  for (size_t i = 0; i < results.size() && found < k; ++i)
+  {
+    if (results[i].second == exclude)
+      continue;
+
+    neighborsOut[found] = results[i].second;
+    distancesOut[found] = results[i].first;
+    ++found;
+  }
+
+  for (; found < k; ++found)
+  {
+    neighborsOut[found] = referenceSet.n_cols;
+    distancesOut[found] = DBL_MAX;
+  }
+}
+
+template<typename MetricType, typename MatType>
+void HNSWSearch<MetricType, MatType>::FindCandidates(
+    const size_t p,
+    const size_t begin,
+    std::vector<std::vector<Candidate>>& candidates,
+    std::vector<size_t>& visited,
+    size_t& epoch) const
+{
+  candidates.clear();
+  candidates.resize(layers[p] + 1);
+
+  const size_t ef = std::max(efConstruction, m);
+  size_t evaluations = 0;
+
+  // Descend greedily to the highest layer of the point, then keep ef
+  // candidates in each layer below.
+  std::vector<Candidate> entryPoints(1, Candidate(metric.Evaluate(
+      referenceSet.col(p), referenceSet.col(entryPoint)), entryPoint));
+  for (size_t l = maxLayer; l > layers[p]; --l)
+    entryPoints = SearchLayer(referenceSet.col(p), entryPoints, 1, l, visited,
+        epoch, evaluations);
+
+  for (size_t l = std::min(layers[p], maxLayer) + 1; l > 0; --l)
+  {
+    candidates[l - 1] = SearchLayer(referenceSet.col(p), entryPoints, ef,
+        l - 1, visited, epoch, evaluations);
+    entryPoints = candidates[l - 1];
+  }
+
+  for (size_t i = begin; i < p; ++i)
+  {
+    const double distance = metric.Evaluate(referenceSet.col(p),
+        referenceSet.col(i));
+    for (size_t l = 0; l <= std::min(layers[i], layers[p]); ++l)
+      candidates[l].push_back(Candidate(distance, i));
+  }
+
+  for (size_t l = 0; l < candidates.size(); ++l)
+    std::sort(candidates[l].begin(), candidates[l].end());
+}
+
+template<typename MetricType, typename MatType>
+void HNSWSearch<MetricType, MatType>::LinkPoint(
+    const size_t p,
+    const std::vector<std::vector<Candidate>>& candidates)
+{
+  std::vector<size_t> selected;
+  for (size_t l = 0; l < candidates.size(); ++l)
+  {
+    SelectNeighbors(candidates[l], m, selected);
+    SetLinks(p, l, selected);
+    for (size_t j = 0; j < selected.size(); ++j)
+      AddLink(selected[j], p, l);
+  }
+
+  if (layers[p] > maxLayer)
+  {
+    maxLayer = layers[p];
+    entryPoint = p;
+  }
+}
+
+template<typename MetricType, typename MatType>
+void HNSWSearch<MetricType, MatType>::SelectNeighbors(
+    const std::vector<Candidate>& candidates,
+    const size_t maxLinks,
+    std::vector<size_t>& selected) const
+{
+  selected.clear();
+  for (size_t i = 0; i < candidates.size() && selected.size() < maxLinks; ++i)
+  {
+    const size_t candidate = candidates[i].second;
+
+    bool keep = true;
+    for (size_t j = 0; j < selected.size(); ++j)
+    {
+      if (metric.Evaluate(referenceSet.col(candidate),
+          referenceSet.col(selected[j])) < candidates[i].first)
+      {
+        keep = false;
+        break;
+      }
+    }
+
+    if (keep)
+      selected.push_back(candidate);
+  }
+}
+
+template<typename MetricType, typename MatType>
+void HNSWSearch<MetricType, MatType>::AddLink(const size_t i,
+                                              const size_t j,
+                                              const size_t layer)
+{
+  size_t count;
+  const size_t* links = Links(i, layer, count);
+  if (count < MaxLinks(layer))
+  {
+    if (layer == 0)
+      baseLinks(baseDegrees[i]++, i) = j;
+    else
+      upperLinks[i][layer - 1].push_back(j);
+    return;
+  }
+
+  // The point has too many links, so they are selected again among the old
+  // links and the new one.
+  std::vector<Candidate> candidates(count + 1);
+  for (size_t t = 0; t < count; ++t)
+  {
+    candidates[t] = Candidate(metric.Evaluate(referenceSet.col(i),
+        referenceSet.col(links[t])), links[t]);
+  }
+  candidates[count] = Candidate(metric.Evaluate(referenceSet.col(i),
+      referenceSet.col(j)), j);
+  std::sort(candidates.begin(), candidates.end());
+
+  std::vector<size_t> selected;
+  SelectNeighbors(candidates, MaxLinks(layer), selected);
+  SetLinks(i, layer, selected);
+}
+
+template<typename MetricType, typename MatType>
+const size_t* HNSWSearch<MetricType, MatType>::Links(const size_t i,
+                                                     const size_t layer,
+                                                     size_t& count) const
+{
+  if (layer == 0)
+  {
+    count = baseDegrees[i];
+    return baseLinks.colptr(i);
+  }
+
+  count = upperLinks[i][layer - 1].size();
+  return upperLinks[i][layer - 1].data();
+}
+
+template<typename MetricType, typename MatType>
+void HNSWSearch<MetricType, MatType>::SetLinks(const size_t i,
+                                               const size_t layer,
+                                               const std::vector<size_t>& links)
+{
+  if (layer == 0)
+  {
+    baseDegrees[i] = links.size();
+    std::copy(links.begin(), links.end(), baseLinks.colptr(i));
+  }
+  else
+  {
+    upperLinks[i][layer - 1] = links;
+  }
+}
+
+template<typename MetricType, typename MatType>
+template<typename Archive>
+void HNSWSearch<MetricType, MatType>::serialize(
+    Archive& ar,
+    const unsigned int /* version */)
+{
+  ar & BOOST_SERIALIZATION_NVP(referenceSet);
+  ar & BOOST_SERIALIZATION_NVP(m);
+  ar & BOOST_SERIALIZATION_NVP(efConstruction);
+  ar & BOOST_SERIALIZATION_NVP(metric);
+  ar & BOOST_SERIALIZATION_NVP(layers);
+  ar & BOOST_SERIALIZATION_NVP(maxLayer);
+  ar & BOOST_SERIALIZATION_NVP(entryPoint);
+  ar & BOOST_SERIALIZATION_NVP(baseDegrees);
+  ar & BOOST_SERIALIZATION_NVP(baseLinks);
+  ar & BOOST_SERIALIZATION_NVP(upperLinks);
+
+  if (Archive::is_loading::value)
+    distanceEvaluations = 0;
+}
+
+} // namespace neighbor
+} // namespace mlpack
+
+#endif
@@ -107,7 +107,9 @@ class HoeffdingTree
    * Construct the Hoeffding tree with the given parameters, but training on no
    * data.  The dimensionMappings parameter is only used if it is desired that
    * this node does not create its own dimensionMappings object (for instance,
-   * if this is a child of another node in the tree).
+   * if this is a child of another node in the tree).  In that case the node
+   * does not copy datasetInfo either, but refers to it, so it must outlive the
+   * node just like the mappings.
    *
    * @param dimensionality Dimensionality of the dataset.
    * @param numClasses Number of classes in the dataset.
@@ -186,6 +188,24 @@ class HoeffdingTree
   template<typename VecType>
   void Train(const VecType& point, const size_t label);
 
+  /**
+   * Train on a set of points in streaming mode, in mini-batches of the given
+   * size.  The points of each mini-batch are routed to their leaves in
+   * parallel, and then the split statistics of each leaf and dimension are
+   * updated in parallel with the points that reached that leaf.  A leaf checks
+   * for a split after its mini-batch if it has passed a multiple of the check
+   * interval; so, unlike Train() in streaming mode, the points of a mini-batch
+   * that follow a split are not passed to the new children.
+   *
+   * @param data Data points to train on.
+   * @param labels Labels of data points.
+   * @param batchSize Number of points in each mini-batch.
+   */
+  template<typename MatType>
+  void MiniBatchTrain(const MatType& data,
+                      const arma::Row<size_t>& labels,
+                      const size_t batchSize = 10000);
+
   /**
    * Check if a split would satisfy the conditions of the Hoeffding bound with
    * the node's specified success probability.  If so, the number of children
@@ -299,7 +319,22 @@ class HoeffdingTree
                 arma::rowvec& probabilities) const;
 
   /**
-   * Given that this node should split, create the children.
+   * Build a compact copy of the tree for classification: the nodes are stored
+   * in one array in breadth-first order, with the children of each node next to
+   * each other, and each node holds only its split and its majority class.
+   * Until the tree is trained again, Classify() walks this array instead of
+   * the linked nodes, which touches much less memory for each point.  Training
+   * this node drops the copy (training a child directly does not, so call
+   * Flatten() again afterwards).
+   */
+  void Flatten();
+
+  //! Return whether Classify() uses the compact copy built by Flatten().
+  bool Flattened() const { return !flatNodes.empty(); }
+
+  /**
+   * Given that this node should split, create the children.  The split
+   * statistics of this node are freed, since only the leaves need them.
    */
   void CreateChildren();
 
@@ -308,6 +343,33 @@ class HoeffdingTree
   void serialize(Archive& ar, const unsigned int /* version */);
 
  private:
+  /**
+   * Update the split statistics of the given dimension of this (unsplit) node
+   * with the given points.  This does not update the number of samples seen.
+   */
+  template<typename MatType>
+  void TrainDimension(const MatType& data,
+                      const arma::Row<size_t>& labels,
+                      const std::vector<size_t>& points,
+                      const size_t dimension);
+
+  /**
+   * Account for the given number of new samples after the split statistics
+   * have been updated with them: update the majority class, and check for a
+   * split if a multiple of the check interval has been passed.
+   */
+  void FinishMiniBatch(const size_t samples);
+
+  /**
+   * Find the leaf of the compact copy built by Flatten() that the given point
+   * falls into, and return its index in flatNodes.
+   */
+  template<typename VecType>
+  size_t FlatLeaf(const VecType& point) const;
+
+  //! Drop the compact copy built by Flatten(), freeing its memory.
+  void ClearFlat();
+
   // We need to keep some information for before we have split.
 
   //! Information for splitting of numeric features (used before split).
@@ -352,6 +414,33 @@ class HoeffdingTree
   typename NumericSplitType<FitnessFunction>::SplitInfo numericSplit;
   //! If the split has occurred, these are the children.
   std::vector<HoeffdingTree*> children;
+
+  //! A node of the compact copy built by Flatten().
+  struct FlatNode
+  {
+    //! The dimension the node splits on (size_t(-1) for a leaf).
+    size_t splitDimension;
+    //! Whether the split dimension is categorical.
+    bool categorical;
+    //! The index of the split in flatNumericSplits or flatCategoricalSplits.
+    size_t splitIndex;
+    //! The index of the first child; the others follow it.
+    size_t firstChild;
+    //! The majority class of the node.
+    size_t majorityClass;
+    //! The probability of the majority class.
+    double majorityProbability;
+  };
+
+  //! The nodes of the compact copy, in breadth-first order (empty if there is
+  //! none).
+  std::vector<FlatNode> flatNodes;
+  //! The numeric splits of the compact copy.
+  std::vector<typename NumericSplitType<FitnessFunction>::SplitInfo>
+      flatNumericSplits;
+  //! The categorical splits of the compact copy.
+  std::vector<typename CategoricalSplitType<FitnessFunction>::SplitInfo>
+      flatCategoricalSplits;
 };
 
 } // namespace tree
@@ -103,8 +103,11 @@ HoeffdingTree<
     maxSamples((maxSamples == 0) ? size_t(-1) : maxSamples),
     checkInterval(checkInterval),
     minSamples(minSamples),
-    datasetInfo(new data::DatasetInfo(datasetInfo)),
-    ownsInfo(true),
+    // A child refers to the dataset information of the root, like the
+    // mappings, instead of holding a copy of it.
+    datasetInfo((dimensionMappingsIn != NULL) ? &datasetInfo :
+        new data::DatasetInfo(datasetInfo)),
+    ownsInfo(dimensionMappingsIn == NULL),
     successProbability(successProbability),
     splitDimension(size_t(-1)),
     categoricalSplit(0),
@@ -198,7 +201,10 @@ HoeffdingTree<FitnessFunction, NumericSplitType, CategoricalSplitType>::
     majorityClass(other.majorityClass),
     majorityProbability(other.majorityProbability),
     categoricalSplit(other.categoricalSplit),
-    numericSplit(other.numericSplit)
+    numericSplit(other.numericSplit),
+    flatNodes(other.flatNodes),
+    flatNumericSplits(other.flatNumericSplits),
+    flatCategoricalSplits(other.flatCategoricalSplits)
 {
   // Copy each of the children.
   for (size_t i = 0; i < other.children.size(); ++i)
@@ -348,6 +354,7 @@ void HoeffdingTree<
   for (size_t i = 0; i < children.size(); ++i)
     delete children[i];
   children.clear();
+  ClearFlat();
 
   // Now train.
   Train(data, labels, batchTraining);
@@ -364,6 +371,10 @@ void HoeffdingTree<
     CategoricalSplitType
 >::Train(const VecType& point, const size_t label)
 {
+  // The compact copy will not match the trained tree.
+  if (!flatNodes.empty())
+    ClearFlat();
+
   if (splitDimension == size_t(-1))
   {
     ++numSamples;
@@ -410,6 +421,140 @@ void HoeffdingTree<
   }
 }
 
+//! Train on a set of points in mini-batches.
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType>
+template<typename MatType>
+void HoeffdingTree<
+    FitnessFunction,
+    NumericSplitType,
+    CategoricalSplitType
+>::MiniBatchTrain(const MatType& data,
+                  const arma::Row<size_t>& labels,
+                  const size_t batchSize)
+{
+  // The compact copy will not match the trained tree.
+  ClearFlat();
+
+  const size_t step = std::max(batchSize, (size_t) 1);
+  std::vector<HoeffdingTree*> pointLeaves;
+  for (size_t begin = 0; begin < data.n_cols; begin += step)
+  {
+    const size_t end = std::min(begin + step, (size_t) data.n_cols);
+
+    // Route each point of the mini-batch to its leaf; the tree is not modified
+    // here, so this can be done in parallel.
+    pointLeaves.resize(end - begin);
+    #pragma omp parallel for
+    for (omp_size_t i = (omp_size_t) begin; i < (omp_size_t) end; ++i)
+    {
+      HoeffdingTree* node = this;
+      while (node->splitDimension != size_t(-1))
+        node = node->children[node->CalculateDirection(data.col(i))];
+      pointLeaves[i - begin] = node;
+    }
+
+    // Collect the points that reached each leaf.
+    std::unordered_map<HoeffdingTree*, size_t> leafIndices;
+    std::vector<HoeffdingTree*> leaves;
+    std::vector<std::vector<size_t>> leafPoints;
+    for (size_t i = begin; i < end; ++i)
+    {
+      HoeffdingTree* leaf = pointLeaves[i - begin];
+      auto it = leafIndices.find(leaf);
+      if (it == leafIndices.end())
+      {
+        it = leafIndices.insert(std::make_pair(leaf, leaves.size())).first;
+        leaves.push_back(leaf);
+        leafPoints.push_back(std::vector<size_t>());
+      }
+      leafPoints[it->second].push_back(i);
+    }
+
+    // The split statistics of each dimension of each leaf are independent, so
+    // each (leaf, dimension) pair can be updated by a different thread.
+    const size_t dimensions = datasetInfo->Dimensionality();
+    const size_t numTasks = leaves.size() * dimensions;
+    #pragma omp parallel for schedule(dynamic)
+    for (omp_size_t t = 0; t < (omp_size_t) numTasks; ++t)
+    {
+      const size_t l = t / dimensions;
+      leaves[l]->TrainDimension(data, labels, leafPoints[l], t % dimensions);
+    }
+
+    for (size_t l = 0; l < leaves.size(); ++l)
+      leaves[l]->FinishMiniBatch(leafPoints[l].size());
+  }
+}
+
+//! Update the split statistics of one dimension.
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType>
+template<typename MatType>
+void HoeffdingTree<
+    FitnessFunction,
+    NumericSplitType,
+    CategoricalSplitType
+>::TrainDimension(const MatType& data,
+                  const arma::Row<size_t>& labels,
+                  const std::vector<size_t>& points,
+                  const size_t dimension)
+{
+  const size_t type = dimensionMappings->at(dimension).first;
+  const size_t index = dimensionMappings->at(dimension).second;
+  if (type == data::Datatype::categorical)
+  {
+    for (size_t i = 0; i < points.size(); ++i)
+      categoricalSplits[index].Train(data(dimension, points[i]),
+          labels[points[i]]);
+  }
+  else if (type == data::Datatype::numeric)
+  {
+    for (size_t i = 0; i < points.size(); ++i)
+      numericSplits[index].Train(data(dimension, points[i]),
+          labels[points[i]]);
+  }
+}
+
+//! Finish training on a mini-batch.
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType>
+void HoeffdingTree<
+    FitnessFunction,
+    NumericSplitType,
+    CategoricalSplitType
+>::FinishMiniBatch(const size_t samples)
+{
+  const size_t oldSamples = numSamples;
+  numSamples += samples;
+
+  // Grab majority class from splits.
+  if (categoricalSplits.size() > 0)
+  {
+    majorityClass = categoricalSplits[0].MajorityClass();
+    majorityProbability = categoricalSplits[0].MajorityProbability();
+  }
+  else
+  {
+    majorityClass = numericSplits[0].MajorityClass();
+    majorityProbability = numericSplits[0].MajorityProbability();
+  }
+
+  // Check for a split, if we have passed a multiple of the check interval.
+  if (numSamples / checkInterval > oldSamples / checkInterval)
+  {
+    const size_t numChildren = SplitCheck();
+    if (numChildren > 0)
+    {
+      children.clear();
+      CreateChildren();
+    }
+  }
+}
+
 template<typename FitnessFunction,
          template<typename> class NumericSplitType,
          template<typename> class CategoricalSplitType>
@@ -619,6 +764,9 @@ size_t HoeffdingTree<
     CategoricalSplitType
 >::Classify(const VecType& point) const
 {
+  if (!flatNodes.empty())
+    return flatNodes[FlatLeaf(point)].majorityClass;
+
   if (children.size() == 0)
   {
     // If we're a leaf (or being considered a leaf), classify based on what we
@@ -646,6 +794,14 @@ void HoeffdingTree<
             size_t& prediction,
             double& probability) const
 {
+  if (!flatNodes.empty())
+  {
+    const FlatNode& leaf = flatNodes[FlatLeaf(point)];
+    prediction = leaf.majorityClass;
+    probability = leaf.majorityProbability;
+    return;
+  }
+
   if (children.size() == 0)
   {
     // We are a leaf, so classify accordingly.
@@ -673,8 +829,10 @@ void HoeffdingTree<
     CategoricalSplitType
 >::Classify(const MatType& data, arma::Row<size_t>& predictions) const
 {
+  // The points are independent, and the tree is not modified.
   predictions.set_size(data.n_cols);
-  for (size_t i = 0; i < data.n_cols; ++i)
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) data.n_cols; ++i)
     predictions[i] = Classify(data.col(i));
 }
 
@@ -693,12 +851,113 @@ void HoeffdingTree<
             arma::Row<size_t>& predictions,
             arma::rowvec& probabilities) const
 {
+  // The points are independent, and the tree is not modified.
   predictions.set_size(data.n_cols);
   probabilities.set_size(data.n_cols);
-  for (size_t i = 0; i < data.n_cols; ++i)
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) data.n_cols; ++i)
     Classify(data.col(i), predictions[i], probabilities[i]);
 }
 
+template<
+    typename FitnessFunction,
+    template<typename> class NumericSplitType,
+    template<typename> class CategoricalSplitType
+>
+void HoeffdingTree<
+    FitnessFunction,
+    NumericSplitType,
+    CategoricalSplitType
+>::Flatten()
+{
+  ClearFlat();
+
+  // Visit the nodes in breadth-first order; the children of a node are queued
+  // together, so they get consecutive indices.
+  std::vector<const HoeffdingTree*> nodes(1, this);
+  for (size_t i = 0; i < nodes.size(); ++i)
+  {
+    const HoeffdingTree* node = nodes[i];
+
+    FlatNode flatNode;
+    flatNode.splitDimension = size_t(-1);
+    flatNode.categorical = false;
+    flatNode.splitIndex = 0;
+    flatNode.firstChild = 0;
+    flatNode.majorityClass = node->majorityClass;
+    flatNode.majorityProbability = node->majorityProbability;
+
+    if (node->children.size() > 0)
+    {
+      flatNode.splitDimension = node->splitDimension;
+      flatNode.categorical = (datasetInfo->Type(node->splitDimension) ==
+          data::Datatype::categorical);
+      if (flatNode.categorical)
+      {
+        flatNode.splitIndex = flatCategoricalSplits.size();
+        flatCategoricalSplits.push_back(node->categoricalSplit);
+      }
+      else
+      {
+        flatNode.splitIndex = flatNumericSplits.size();
+        flatNumericSplits.push_back(node->numericSplit);
+      }
+
+      flatNode.firstChild = nodes.size();
+      for (size_t c = 0; c < node->children.size(); ++c)
+        nodes.push_back(node->children[c]);
+    }
+
+    flatNodes.push_back(flatNode);
+  }
+}
+
+template<
+    typename FitnessFunction,
+    template<typename> class NumericSplitType,
+    template<typename> class CategoricalSplitType
+>
+template<typename VecType>
+size_t HoeffdingTree<
+    FitnessFunction,
+    NumericSplitType,
+    CategoricalSplitType
+>::FlatLeaf(const VecType& point) const
+{
+  size_t i = 0;
+  while (flatNodes[i].splitDimension != size_t(-1))
+  {
+    const FlatNode& node = flatNodes[i];
+    const size_t direction = node.categorical ?
+        flatCategoricalSplits[node.splitIndex].CalculateDirection(
+            point[node.splitDimension]) :
+        flatNumericSplits[node.splitIndex].CalculateDirection(
+            point[node.splitDimension]);
+    i = node.firstChild + direction;
+  }
+
+  return i;
+}
+
+template<
+    typename FitnessFunction,
+    template<typename> class NumericSplitType,
+    template<typename> class CategoricalSplitType
+>
+void HoeffdingTree<
+    FitnessFunction,
+    NumericSplitType,
+    CategoricalSplitType
+>::ClearFlat()
+{
+  // Swapping with empty vectors frees the memory, unlike clear().
+  std::vector<FlatNode>().swap(flatNodes);
+  std::vector<typename NumericSplitType<FitnessFunction>::SplitInfo>().swap(
+      flatNumericSplits);
+  std::vector<typename CategoricalSplitType<FitnessFunction>::SplitInfo>().swap(
+      flatCategoricalSplits);
+}
+
 template<
     typename FitnessFunction,
     template<typename> class NumericSplitType,
@@ -759,9 +1018,10 @@ void HoeffdingTree<
     children[i]->MajorityClass() = childMajorities[i];
   }
 
-  // Eliminate now-unnecessary split information.
-  numericSplits.clear();
-  categoricalSplits.clear();
+  // Eliminate now-unnecessary split information.  Swapping with empty vectors
+  // frees the memory, unlike clear(); only the leaves need the statistics.
+  std::vector<NumericSplitType<FitnessFunction>>().swap(numericSplits);
+  std::vector<CategoricalSplitType<FitnessFunction>>().swap(categoricalSplits);
 }
 
 template<
@@ -802,6 +1062,9 @@ void HoeffdingTree<
     for (size_t i = 0; i < children.size(); ++i)
       delete children[i];
     children.clear();
+
+    // The compact copy is not saved; Flatten() must be called again.
+    ClearFlat();
   }
 
   ar & BOOST_SERIALIZATION_NVP(majorityClass);
@@ -872,8 +1135,9 @@ void HoeffdingTree<
         children[i]->ownsMappings = false;
       }
 
-      numericSplits.clear();
-      categoricalSplits.clear();
+      std::vector<NumericSplitType<FitnessFunction>>().swap(numericSplits);
+      std::vector<CategoricalSplitType<FitnessFunction>>().swap(
+          categoricalSplits);
 
       numSamples = 0;
       numClasses = 0;
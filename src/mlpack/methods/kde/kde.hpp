@@ -0,0 +1,345 @@
+/**
+ * @file kde.hpp
+ *
+ * Defines the KDE class, which performs kernel density estimation with trees.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KDE_KDE_HPP
+#define MLPACK_METHODS_KDE_KDE_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/metrics/lmetric.hpp>
+#include <mlpack/core/kernels/gaussian_kernel.hpp>
+#include <mlpack/core/tree/binary_space_tree.hpp>
+#include "kde_stat.hpp"
+
+namespace mlpack {
+namespace kde /** Kernel density estimation. */ {
+
+/**
+ * The KDE class is a template class for kernel density estimation.  The density
+ * estimate of a query point q is
+ *
+ *   f(q) = (1 / (N * C)) * sum_i K(d(q, r_i)),
+ *
+ * where the sum is over the N reference points, d is the metric, K is the
+ * kernel as a function of the distance, and C is the normalization constant of
+ * the kernel (1 for kernels that have none).
+ *
+ * It is implemented in the style of a generalized tree-independent dual-tree
+ * algorithm: when the kernel values between a query point (or node) and a
+ * reference node are known to within the error tolerances from the bounds on
+ * their distances, the node is estimated as a whole.  The estimate of each
+ * query point before normalization is then within
+ *
+ *   absError + relError * (true estimate before normalization)
+ *
+ * of the true one.  In single-tree mode, nodes can also be estimated by Monte
+ * Carlo sampling, which meets the relative error tolerance only with the given
+ * probability.  For more details, see the KDERules class.
+ *
+ * The kernel must be a function of the distance that does not increase with
+ * the distance, such as the Gaussian, Epanechnikov, Laplacian, spherical or
+ * triangular kernels.
+ *
+ * @tparam KernelType Kernel to use for density estimation.
+ * @tparam MetricType Metric to use for distance calculations.
+ * @tparam MatType Type of data to use.
+ * @tparam TreeType Type of tree to use; must satisfy the TreeType policy API.
+ */
+template<typename KernelType = kernel::GaussianKernel,
+         typename MetricType = metric::EuclideanDistance,
+         typename MatType = arma::mat,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType = tree::KDTree>
+class KDE
+{
+ public:
+  //! Convenience typedef.
+  typedef TreeType<MetricType, KDEStat, MatType> Tree;
+
+  /**
+   * Initialize the KDE object with the given settings, without training it.
+   * Call Train() before Evaluate().
+   *
+   * @param relError Relative error tolerance of each estimate, in [0, 1].
+   * @param absError Absolute error tolerance of each estimate, before
+   *      normalization; must not be negative.
+   * @param kernel Instantiated kernel.
+   * @param metric Instantiated distance metric.
+   * @param naive Whether the computation should be done in O(n^2) naive mode.
+   * @param singleMode Whether single-tree computation should be used (as
+   *      opposed to dual-tree computation).
+   */
+  KDE(const double relError = 0.05,
+      const double absError = 0.0,
+      const KernelType kernel = KernelType(),
+      const MetricType metric = MetricType(),
+      const bool naive = false,
+      const bool singleMode = false);
+
+  /**
+   * Construct the KDE object by copying the given object, including the
+   * reference tree (or reference set, in naive mode).
+   *
+   * @param other KDE object to copy.
+   */
+  KDE(const KDE& other);
+
+  /**
+   * Construct the KDE object by taking ownership of the given object's model;
+   * the other object is left untrained.
+   *
+   * @param other KDE object to take ownership of.
+   */
+  KDE(KDE&& other);
+
+  /**
+   * Copy the given KDE object.
+   *
+   * @param other KDE object to copy.
+   */
+  KDE& operator=(const KDE& other);
+
+  /**
+   * Take ownership of the given KDE object's model.
+   *
+   * @param other KDE object to take ownership of.
+   */
+  KDE& operator=(KDE&& other);
+
+  /**
+   * Destroy the KDE object, deleting the reference tree and set if they are
+   * owned by this object.
+   */
+  ~KDE();
+
+  /**
+   * Set the reference set to a new reference set, and build a tree if
+   * necessary.  This method is called 'Train()' in order to match the rest of
+   * the mlpack abstractions, even though calling this "training" is maybe a
+   * bit of a stretch.
+   *
+   * @param referenceSet New set of reference data.
+   */
+  void Train(const MatType& referenceSet);
+
+  /**
+   * Set the reference set to a new reference set, taking ownership of the set,
+   * and build a tree if necessary.  Depending on the type of tree, the points
+   * may be rearranged.
+   *
+   * @param referenceSet New set of reference data.
+   */
+  void Train(MatType&& referenceSet);
+
+  /**
+   * Estimate the density of each point of the query set.  estimations will be
+   * set to the length of the query set.
+   *
+   * @param querySet Set of query points to estimate the density of.
+   * @param estimations Vector which will hold the density estimates.
+   */
+  void Evaluate(const MatType& querySet, arma::vec& estimations);
+
+  /**
+   * Estimate the density of each point of the reference set.  This means that
+   * the query set and the reference set are the same.  Each estimate includes
+   * the kernel value of the point with itself.
+   *
+   * @param estimations Vector which will hold the density estimates.
+   */
+  void Evaluate(arma::vec& estimations);
+
+  //! Get the relative error tolerance.
+  double RelativeError() const { return relError; }
+  //! Set the relative error tolerance; it must be in [0, 1].
+  void RelativeError(const double newError);
+
+  //! Get the absolute error tolerance.
+  double AbsoluteError() const { return absError; }
+  //! Set the absolute error tolerance; it must not be negative.
+  void AbsoluteError(const double newError);
+
+  //! Get the kernel.
+  const KernelType& Kernel() const { return kernel; }
+  //! Modify the kernel.
+  KernelType& Kernel() { return kernel; }
+
+  //! Get the distance metric.
+  const MetricType& Metric() const { return metric; }
+  //! Modify the distance metric.
+  MetricType& Metric() { return metric; }
+
+  //! Get whether naive computation is being used.
+  bool Naive() const { return naive; }
+  //! Get whether single-tree computation is being used.
+  bool SingleMode() const { return singleMode; }
+  //! Modify whether single-tree computation is being used.  Naive mode can't
+  //! be changed once the object is built, since it decides whether a tree is
+  //! built.
+  bool& SingleMode() { return singleMode; }
+
+  //! Get whether Monte Carlo estimation is used.
+  bool MonteCarlo() const { return monteCarlo; }
+  //! Modify whether Monte Carlo estimation is used.  It is only used in
+  //! single-tree mode, with a nonzero relative error tolerance.
+  bool& MonteCarlo() { return monteCarlo; }
+
+  //! Get the probability that a Monte Carlo estimate is within the relative
+  //! error tolerance.
+  double MCProbability() const { return mcProb; }
+  //! Set the probability that a Monte Carlo estimate is within the relative
+  //! error tolerance; it must be in [0, 1).
+  void MCProbability(const double newProb);
+
+  //! Get the number of samples of the first round of a Monte Carlo estimate.
+  size_t MCInitialSampleSize() const { return initialSampleSize; }
+  //! Modify the number of samples of the first round of a Monte Carlo
+  //! estimate.  Fewer than 2 samples disable Monte Carlo estimation.
+  size_t& MCInitialSampleSize() { return initialSampleSize; }
+
+  //! Get the Monte Carlo entry coefficient.
+  double MCEntryCoefficient() const { return mcEntryCoef; }
+  //! Modify the Monte Carlo entry coefficient: a node is only estimated with
+  //! Monte Carlo sampling if it has at least this many times the initial
+  //! sample size points.
+  double& MCEntryCoefficient() { return mcEntryCoef; }
+
+  //! Get the Monte Carlo break coefficient.
+  double MCBreakCoefficient() const { return mcBreakCoef; }
+  //! Modify the Monte Carlo break coefficient: Monte Carlo estimation of a node
+  //! is abandoned if it would need more than this fraction of the points of
+  //! the node.
+  double& MCBreakCoefficient() { return mcBreakCoef; }
+
+  //! Get whether tree traversals are parallelized with OpenMP.
+  bool Parallel() const { return parallel; }
+  //! Modify whether tree traversals are parallelized with OpenMP.  In
+  //! dual-tree mode, subtrees of the query tree are split between threads; in
+  //! single-tree and naive mode, query points are (except for trees with
+  //! self-children, such as cover trees, which are always traversed serially
+  //! in single-tree mode).  This setting is not serialized.
+  bool& Parallel() { return parallel; }
+
+  //! Return the reference set.
+  const MatType& ReferenceSet() const { return *referenceSet; }
+  //! Return the reference tree (or NULL if in naive mode).
+  Tree* ReferenceTree() { return referenceTree; }
+
+  //! Get the number of base cases during the last evaluation.
+  size_t BaseCases() const { return baseCases; }
+  //! Get the number of scores during the last evaluation.
+  size_t Scores() const { return scores; }
+
+  //! Serialize the model.
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int version);
+
+ private:
+  //! Mappings to old reference indices (used when this object builds trees).
+  std::vector<size_t> oldFromNewReferences;
+  //! Reference tree.
+  Tree* referenceTree;
+  //! Reference set (data should be accessed using this).  In some situations we
+  //! may be the owner of this.
+  const MatType* referenceSet;
+
+  //! If true, this object is responsible for deleting the tree.
+  bool treeOwner;
+  //! If true, we own the reference set.
+  bool setOwner;
+
+  //! The relative error tolerance.
+  double relError;
+  //! The absolute error tolerance.
+  double absError;
+
+  //! Instantiated kernel.
+  KernelType kernel;
+  //! Instantiated distance metric.
+  MetricType metric;
+
+  //! If true, O(n^2) naive computation is used.
+  bool naive;
+  //! If true, single-tree computation is used.
+  bool singleMode;
+
+  //! If true, Monte Carlo estimation is used in single-tree mode.
+  bool monteCarlo;
+  //! Probability that a Monte Carlo estimate is within the relative error.
+  double mcProb;
+  //! Number of samples of the first round of a Monte Carlo estimate.
+  size_t initialSampleSize;
+  //! Monte Carlo entry coefficient.
+  double mcEntryCoef;
+  //! Monte Carlo break coefficient.
+  double mcBreakCoef;
+
+  //! If true, tree traversals are parallelized with OpenMP.
+  bool parallel;
+
+  //! The total number of base cases during the last evaluation.
+  size_t baseCases;
+  //! The total number of scores during the last evaluation.
+  size_t scores;
+
+  //! Check that the relative error tolerance is in [0, 1].
+  static void CheckRelativeError(const double relError);
+  //! Check that the absolute error tolerance is not negative.
+  static void CheckAbsoluteError(const double absError);
+
+  //! Divide the sums of kernel values by the number of reference points and
+  //! the normalization constant of the kernel.
+  void Normalize(arma::vec& estimations);
+
+  /**
+   * Evaluate every pair of the given number of query points and the reference
+   * points with the given rules.  If parallel evaluation is enabled (and
+   * OpenMP is available), the query points are split between threads.
+   *
+   * @param numQueries Number of query points.
+   * @param rules Rules to use for the evaluation.
+   */
+  template<typename RuleType>
+  void NaiveTraversal(const size_t numQueries, RuleType& rules);
+
+  /**
+   * Perform a dual-tree traversal of the given query tree and the reference
+   * tree with the given rules.  If parallel evaluation is enabled (and OpenMP
+   * is available), the query tree is split into disjoint subtrees near its
+   * root, and each subtree is traversed by one thread with its own copy of the
+   * rules.
+   *
+   * @param queryTree Tree built on the query points.
+   * @param rules Rules to use for the traversal.
+   */
+  template<typename RuleType>
+  void DualTreeTraversal(Tree& queryTree, RuleType& rules);
+
+  /**
+   * Run a single-tree traversal of the reference tree for each of the given
+   * number of query points with the given rules.  If parallel evaluation is
+   * enabled (and OpenMP is available), the query points are split between
+   * threads.  The Monte Carlo sampling of each query point uses its own seed,
+   * so it does not depend on the number of threads.
+   *
+   * @param numQueries Number of query points.
+   * @param rules Rules to use for the traversal.
+   */
+  template<typename RuleType>
+  void SingleTreeTraversal(const size_t numQueries, RuleType& rules);
+};
+
+} // namespace kde
+} // namespace mlpack
+
+// Include implementation.
+#include "kde_impl.hpp"
+
+#endif
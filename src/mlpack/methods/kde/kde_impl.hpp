@@ -0,0 +1,813 @@
+/**
+ * @file kde_impl.hpp
+ *
+ * Implementation of the KDE class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KDE_KDE_IMPL_HPP
+#define MLPACK_METHODS_KDE_KDE_IMPL_HPP
+
+// Just in case it hasn't been included.
+#include "kde.hpp"
+
+// The rules for traversal.
+#include "kde_rules.hpp"
+#include "kernel_normalizer.hpp"
+#include <mlpack/core/tree/split_frontier.hpp>
+
+namespace mlpack {
+namespace kde {
+
+//! Call the tree constructor that does mapping.
+template<typename TreeType, typename MatType>
+TreeType* BuildTree(
+    MatType&& dataset,
+    std::vector<size_t>& oldFromNew,
+    const typename std::enable_if<
+        tree::TreeTraits<TreeType>::RearrangesDataset>::type* = 0)
+{
+  return new TreeType(std::forward<MatType>(dataset), oldFromNew);
+}
+
+//! Call the tree constructor that does not do mapping.
+template<typename TreeType, typename MatType>
+TreeType* BuildTree(
+    MatType&& dataset,
+    const std::vector<size_t>& /* oldFromNew */,
+    const typename std::enable_if<
+        !tree::TreeTraits<TreeType>::RearrangesDataset>::type* = 0)
+{
+  return new TreeType(std::forward<MatType>(dataset));
+}
+
+template<typename KernelType,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+KDE<KernelType, MetricType, MatType, TreeType>::KDE(
+    const double relError,
+    const double absError,
+    const KernelType kernel,
+    const MetricType metric,
+    const bool naive,
+    const bool singleMode) :
+    referenceTree(NULL),
+    referenceSet(new MatType()), // Empty matrix.
+    treeOwner(false),
+    setOwner(true),
+    relError(relError),
+    absError(absError),
+    kernel(kernel),
+    metric(metric),
+    naive(naive),
+    singleMode(!naive && singleMode), // Naive overrides single mode.
+    monteCarlo(false),
+    mcProb(0.95),
+    initialSampleSize(100),
+    mcEntryCoef(3.0),
+    mcBreakCoef(0.4),
+    parallel(false),
+    baseCases(0),
+    scores(0)
+{
+  CheckRelativeError(relError);
+  CheckAbsoluteError(absError);
+
+  // Build the tree on the empty dataset, if necessary.
+  if (!naive)
+  {
+    referenceTree = BuildTree<Tree>(const_cast<MatType&>(*referenceSet),
+        oldFromNewReferences);
+    treeOwner = true;
+  }
+}
+
+template<typename KernelType,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+KDE<KernelType, MetricType, MatType, TreeType>::KDE(const KDE& other) :
+    oldFromNewReferences(other.oldFromNewReferences),
+    referenceTree(other.referenceTree ? new Tree(*other.referenceTree) : NULL),
+    referenceSet(other.referenceTree ? &referenceTree->Dataset() :
+        new MatType(*other.referenceSet)),
+    treeOwner(other.referenceTree),
+    setOwner(!other.referenceTree),
+    relError(other.relError),
+    absError(other.absError),
+    kernel(other.kernel),
+    metric(other.metric),
+    naive(other.naive),
+    singleMode(other.singleMode),
+    monteCarlo(other.monteCarlo),
+    mcProb(other.mcProb),
+    initialSampleSize(other.initialSampleSize),
+    mcEntryCoef(other.mcEntryCoef),
+    mcBreakCoef(other.mcBreakCoef),
+    parallel(other.parallel),
+    baseCases(other.baseCases),
+    scores(other.scores)
+{
+  // Nothing to do.
+}
+
+template<typename KernelType,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+KDE<KernelType, MetricType, MatType, TreeType>::KDE(KDE&& other) :
+    oldFromNewReferences(std::move(other.oldFromNewReferences)),
+    referenceTree(other.referenceTree),
+    referenceSet(other.referenceSet),
+    treeOwner(other.treeOwner),
+    setOwner(other.setOwner),
+    relError(other.relError),
+    absError(other.absError),
+    kernel(std::move(other.kernel)),
+    metric(std::move(other.metric)),
+    naive(other.naive),
+    singleMode(other.singleMode),
+    monteCarlo(other.monteCarlo),
+    mcProb(other.mcProb),
+    initialSampleSize(other.initialSampleSize),
+    mcEntryCoef(other.mcEntryCoef),
+    mcBreakCoef(other.mcBreakCoef),
+    parallel(other.parallel),
+    baseCases(other.baseCases),
+    scores(other.scores)
+{
+  // Leave the other object untrained.
+  other.referenceSet = new MatType();
+  other.referenceTree = other.naive ? NULL :
+      BuildTree<Tree>(const_cast<MatType&>(*other.referenceSet),
+      other.oldFromNewReferences);
+  other.treeOwner = !other.naive;
+  other.setOwner = true;
+  other.baseCases = 0;
+  other.scores = 0;
+}
+
+template<typename KernelType,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+KDE<KernelType, MetricType, MatType, TreeType>&
+KDE<KernelType, MetricType, MatType, TreeType>::operator=(const KDE& other)
+{
+  if (this == &other)
+    return *this;
+
+  // Clean memory first.
+  if (treeOwner)
+    delete referenceTree;
+  if (setOwner)
+    delete referenceSet;
+
+  // Copy the other model.
+  oldFromNewReferences = other.oldFromNewReferences;
+  referenceTree = other.referenceTree ? new Tree(*other.referenceTree) : NULL;
+  referenceSet = other.referenceTree ? &referenceTree->Dataset() :
+      new MatType(*other.referenceSet);
+  treeOwner = other.referenceTree;
+  setOwner = !other.referenceTree;
+  relError = other.relError;
+  absError = other.absError;
+  kernel = other.kernel;
+  metric = other.metric;
+  naive = other.naive;
+  singleMode = other.singleMode;
+  monteCarlo = other.monteCarlo;
+  mcProb = other.mcProb;
+  initialSampleSize = other.initialSampleSize;
+  mcEntryCoef = other.mcEntryCoef;
+  mcBreakCoef = other.mcBreakCoef;
+  parallel = other.parallel;
+  baseCases = other.baseCases;
+  scores = other.scores;
+
+  return *this;
+}
+
+template<typename KernelType,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+KDE<KernelType, MetricType, MatType, TreeType>&
+KDE<KernelType, MetricType, MatType, TreeType>::operator=(KDE&& other)
+{
+  if (this == &other)
+    return *this;
+
+  // Clean memory first.
+  if (treeOwner)
+    delete referenceTree;
+  if (setOwner)
+    delete referenceSet;
+
+  // Move the other model.
+  oldFromNewReferences = std::move(other.oldFromNewReferences);
+  referenceTree = other.referenceTree;
+  referenceSet = other.referenceSet;
+  treeOwner = other.treeOwner;
+  setOwner = other.setOwner;
+  relError = other.relError;
+  absError = other.absError;
+  kernel = std::move(other.kernel);
+  metric = std::move(other.metric);
+  naive = other.naive;
+  singleMode = other.singleMode;
+  monteCarlo = other.monteCarlo;
+  mcProb = other.mcProb;
+  initialSampleSize = other.initialSampleSize;
+  mcEntryCoef = other.mcEntryCoef;
+  mcBreakCoef = other.mcBreakCoef;
+  parallel = other.parallel;
+  baseCases = other.baseCases;
+  scores = other.scores;
+
+  // Leave the other object untrained.
+  other.referenceSet = new MatType();
+  other.referenceTree = other.naive ? NULL :
+      BuildTree<Tree>(const_cast<MatType&>(*other.referenceSet),
+      other.oldFromNewReferences);
+  other.treeOwner = !other.naive;
+  other.setOwner = true;
+  other.baseCases = 0;
+  other.scores = 0;
+
+  return *this;
+}
+
+template<typename KernelType,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+KDE<KernelType, MetricType, MatType, TreeType>::~KDE()
+{
+  if (treeOwner && referenceTree)
+    delete referenceTree;
+  if (setOwner && referenceSet)
+    delete referenceSet;
+}
+
+template<typename KernelType,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void KDE<KernelType, MetricType, MatType, TreeType>::Train(
+    const MatType& referenceSet)
+{
+  // Clean up the old tree, if we built one.
+  if (treeOwner && referenceTree)
+    delete referenceTree;
+
+  // Rebuild the tree, if necessary.
+  if (!naive)
+  {
+    Timer::Start("kde/tree_building");
+    referenceTree = BuildTree<Tree>(const_cast<MatType&>(referenceSet),
+        oldFromNewReferences);
+    Timer::Stop("kde/tree_building");
+    treeOwner = true;
+  }
+  else
+  {
+    treeOwner = false;
+  }
+
+  // Delete the old reference set, if we owned it.
+  if (setOwner && this->referenceSet)
+    delete this->referenceSet;
+
+  if (!naive)
+    this->referenceSet = &referenceTree->Dataset();
+  else
+    this->referenceSet = &referenceSet;
+  setOwner = false;
+}
+
+template<typename KernelType,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void KDE<KernelType, MetricType, MatType, TreeType>::Train(
+    MatType&& referenceSet)
+{
+  // Clean up the old tree, if we built one.
+  if (treeOwner && referenceTree)
+    delete referenceTree;
+
+  // We may need to rebuild the tree.
+  if (!naive)
+  {
+    Timer::Start("kde/tree_building");
+    referenceTree = BuildTree<Tree>(std::move(referenceSet),
+        oldFromNewReferences);
+    Timer::Stop("kde/tree_building");
+    treeOwner = true;
+  }
+  else
+  {
+    treeOwner = false;
+  }
+
+  // Delete the old reference set, if we owned it.
+  if (setOwner && this->referenceSet)
+    delete this->referenceSet;
+
+  if (!naive)
+  {
+    this->referenceSet = &referenceTree->Dataset();
+    setOwner = false;
+  }
+  else
+  {
+    this->referenceSet = new MatType(std::move(referenceSet));
+    setOwner = true;
+  }
+}
+
+template<typename KernelType,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void KDE<KernelType, MetricType, MatType, TreeType>::Evaluate(
+    const MatType& querySet,
+    arma::vec& estimations)
+{
+  if (querySet.n_rows != referenceSet->n_rows)
+  {
+    std::ostringstream oss;
+    oss << "KDE::Evaluate(): dimensionalities of query set ("
+        << querySet.n_rows << ") and reference set (" << referenceSet->n_rows
+        << ") do not match!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  if (referenceSet->n_cols == 0)
+  {
+    throw std::invalid_argument("KDE::Evaluate(): the model has no reference "
+        "points; call Train() first!");
+  }
+
+  estimations.zeros(querySet.n_cols);
+
+  Timer::Start("kde/computing_estimations");
+
+  typedef KDERules<MetricType, KernelType, Tree> RuleType;
+
+  if (naive)
+  {
+    RuleType rules(*referenceSet, querySet, estimations, relError, absError,
+        metric, kernel);
+    NaiveTraversal(querySet.n_cols, rules);
+
+    baseCases = (querySet.n_cols * referenceSet->n_cols);
+    scores = 0;
+  }
+  else if (singleMode)
+  {
+    RuleType rules(*referenceSet, querySet, estimations, relError, absError,
+        metric, kernel, monteCarlo, mcProb, initialSampleSize, mcEntryCoef,
+        mcBreakCoef);
+    SingleTreeTraversal(querySet.n_cols, rules);
+
+    baseCases = rules.BaseCases();
+    scores = rules.Scores();
+    rules.Counters().Report();
+  }
+  else // Dual-tree recursion.
+  {
+    // Build the query tree.
+    std::vector<size_t> oldFromNewQueries;
+    Timer::Stop("kde/computing_estimations");
+    Timer::Start("kde/tree_building");
+    Tree* queryTree = BuildTree<Tree>(querySet, oldFromNewQueries);
+    Timer::Stop("kde/tree_building");
+    Timer::Start("kde/computing_estimations");
+
+    // The estimates are in the order of the query tree's dataset.
+    arma::vec treeEstimations(querySet.n_cols, arma::fill::zeros);
+    RuleType rules(*referenceSet, queryTree->Dataset(), treeEstimations,
+        relError, absError, metric, kernel);
+    DualTreeTraversal(*queryTree, rules);
+
+    baseCases = rules.BaseCases();
+    scores = rules.Scores();
+    rules.Counters().Report();
+
+    // Map the estimates back to the original query indices, if necessary.
+    if (tree::TreeTraits<Tree>::RearrangesDataset)
+    {
+      for (size_t i = 0; i < treeEstimations.n_elem; ++i)
+        estimations[oldFromNewQueries[i]] = treeEstimations[i];
+    }
+    else
+    {
+      estimations = std::move(treeEstimations);
+    }
+
+    delete queryTree;
+  }
+
+  Normalize(estimations);
+
+  Timer::Stop("kde/computing_estimations");
+}
+
+template<typename KernelType,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void KDE<KernelType, MetricType, MatType, TreeType>::Evaluate(
+    arma::vec& estimations)
+{
+  if (referenceSet->n_cols == 0)
+  {
+    throw std::invalid_argument("KDE::Evaluate(): the model has no reference "
+        "points; call Train() first!");
+  }
+
+  Timer::Start("kde/computing_estimations");
+
+  // The estimates are in the order of the reference tree's dataset.
+  arma::vec treeEstimations(referenceSet->n_cols, arma::fill::zeros);
+  typedef KDERules<MetricType, KernelType, Tree> RuleType;
+
+  if (naive)
+  {
+    RuleType rules(*referenceSet, *referenceSet, treeEstimations, relError,
+        absError, metric, kernel);
+    NaiveTraversal(referenceSet->n_cols, rules);
+
+    baseCases = (referenceSet->n_cols * referenceSet->n_cols);
+    scores = 0;
+  }
+  else if (singleMode)
+  {
+    RuleType rules(*referenceSet, *referenceSet, treeEstimations, relError,
+        absError, metric, kernel, monteCarlo, mcProb, initialSampleSize,
+        mcEntryCoef, mcBreakCoef);
+    SingleTreeTraversal(referenceSet->n_cols, rules);
+
+    baseCases = rules.BaseCases();
+    scores = rules.Scores();
+    rules.Counters().Report();
+  }
+  else // Dual-tree recursion.
+  {
+    RuleType rules(*referenceSet, *referenceSet, treeEstimations, relError,
+        absError, metric, kernel);
+    DualTreeTraversal(*referenceTree, rules);
+
+    baseCases = rules.BaseCases();
+    scores = rules.Scores();
+    rules.Counters().Report();
+  }
+
+  Normalize(treeEstimations);
+
+  Timer::Stop("kde/computing_estimations");
+
+  // Map the estimates back to the original indices, if necessary.
+  if (treeOwner && tree::TreeTraits<Tree>::RearrangesDataset)
+  {
+    estimations.set_size(treeEstimations.n_elem);
+    for (size_t i = 0; i < treeEstimations.n_elem; ++i)
+      estimations[oldFromNewReferences[i]] = treeEstimations[i];
+  }
+  else
+  {
+    estimations = std::move(treeEstimations);
+  }
+}
+
+template<typename KernelType,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void KDE<KernelType, MetricType, MatType, TreeType>::RelativeError(
+    const double newError)
+{
+  CheckRelativeError(newError);
+  relError = newError;
+}
+
+template<typename KernelType,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void KDE<KernelType, MetricType, MatType, TreeType>::AbsoluteError(
+    const double newError)
+{
+  CheckAbsoluteError(newError);
+  absError = newError;
+}
+
+template<typename KernelType,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void KDE<KernelType, MetricType, MatType, TreeType>::MCProbability(
+    const double newProb)
+{
+  if (newProb < 0.0 || newProb >= 1.0)
+  {
+    std::ostringstream oss;
+    oss << "KDE::MCProbability(): probability must be in [0, 1) (given "
+        << newProb << ")!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  mcProb = newProb;
+}
+
+template<typename KernelType,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void KDE<KernelType, MetricType, MatType, TreeType>::CheckRelativeError(
+    const double relError)
+{
+  if (relError < 0.0 || relError > 1.0)
+  {
+    std::ostringstream oss;
+    oss << "KDE: relative error tolerance must be in [0, 1] (given "
+        << relError << ")!";
+    throw std::invalid_argument(oss.str());
+  }
+}
+
+template<typename KernelType,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void KDE<KernelType, MetricType, MatType, TreeType>::CheckAbsoluteError(
+    const double absError)
+{
+  if (absError < 0.0)
+  {
+    std::ostringstream oss;
+    oss << "KDE: absolute error tolerance must not be negative (given "
+        << absError << ")!";
+    throw std::invalid_argument(oss.str());
+  }
+}
+
+template<typename KernelType,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void KDE<KernelType, MetricType, MatType, TreeType>::Normalize(
+    arma::vec& estimations)
+{
+  estimations /= referenceSet->n_cols;
+  ApplyNormalizer(kernel, referenceSet->n_rows, estimations);
+}
+
+template<typename KernelType,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+template<typename RuleType>
+void KDE<KernelType, MetricType, MatType, TreeType>::NaiveTraversal(
+    const size_t numQueries,
+    RuleType& rules)
+{
+#ifdef HAS_OPENMP
+  if (parallel && omp_get_max_threads() > 1)
+  {
+    #pragma omp parallel
+    {
+      // Each thread has its own rules and works on its own query points.
+      RuleType threadRules(rules);
+
+      #pragma omp for schedule(dynamic, 16)
+      for (omp_size_t i = 0; i < (omp_size_t) numQueries; ++i)
+        for (size_t j = 0; j < referenceSet->n_cols; ++j)
+          threadRules.BaseCase(i, j);
+    }
+
+    return;
+  }
+#endif
+
+  for (size_t i = 0; i < numQueries; ++i)
+    for (size_t j = 0; j < referenceSet->n_cols; ++j)
+      rules.BaseCase(i, j);
+}
+
+template<typename KernelType,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+template<typename RuleType>
+void KDE<KernelType, MetricType, MatType, TreeType>::DualTreeTraversal(
+    Tree& queryTree,
+    RuleType& rules)
+{
+#ifdef HAS_OPENMP
+  const size_t numThreads = omp_get_max_threads();
+  if (parallel && numThreads > 1)
+  {
+    // Split the query tree near the root until there are enough subtrees to
+    // keep all threads busy; each thread shares the estimates, and no two
+    // subtrees in the frontier hold the same query point.
+    const std::vector<Tree*> frontier = tree::SplitFrontier(queryTree,
+        8 * numThreads);
+    typedef typename Tree::template DualTreeTraverser<RuleType> TraverserType;
+    tree::TraverseFrontier<TraverserType>(frontier, *referenceTree, rules);
+
+    return;
+  }
+#endif
+
+  typename Tree::template DualTreeTraverser<RuleType> traverser(rules);
+  traverser.Traverse(queryTree, *referenceTree);
+}
+
+template<typename KernelType,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+template<typename RuleType>
+void KDE<KernelType, MetricType, MatType, TreeType>::SingleTreeTraversal(
+    const size_t numQueries,
+    RuleType& rules)
+{
+  // Each query point is sampled with its own seed, so the results are the same
+  // whether or not the evaluation is parallel, and for any number of threads.
+  const size_t seed = math::randGen();
+
+#ifdef HAS_OPENMP
+  // Trees with self-children cache base cases in the statistics of reference
+  // nodes while scoring, so those reference trees can't be shared between
+  // threads.
+  if (parallel && omp_get_max_threads() > 1 &&
+      !tree::TreeTraits<Tree>::HasSelfChildren)
+  {
+    #pragma omp parallel
+    {
+      // Each thread has its own rules and traverser, and works on its own
+      // query points, so the shared estimates are never touched by two threads
+      // at once.
+      RuleType threadRules(rules);
+      typename Tree::template SingleTreeTraverser<RuleType>
+          traverser(threadRules);
+
+      #pragma omp for schedule(dynamic, 16)
+      for (omp_size_t i = 0; i < (omp_size_t) numQueries; ++i)
+      {
+        if (monteCarlo)
+          threadRules.Generator().seed((uint32_t) (seed + i));
+        traverser.Traverse(i, *referenceTree);
+      }
+
+      #pragma omp critical
+      rules.Counters() += threadRules.Counters();
+    }
+
+    return;
+  }
+#endif
+
+  typename Tree::template SingleTreeTraverser<RuleType> traverser(rules);
+  for (size_t i = 0; i < numQueries; ++i)
+  {
+    if (monteCarlo)
+      rules.Generator().seed((uint32_t) (seed + i));
+    traverser.Traverse(i, *referenceTree);
+  }
+}
+
+template<typename KernelType,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+template<typename Archive>
+void KDE<KernelType, MetricType, MatType, TreeType>::serialize(
+    Archive& ar,
+    const unsigned int /* version */)
+{
+  // Serialize the settings.
+  ar & BOOST_SERIALIZATION_NVP(relError);
+  ar & BOOST_SERIALIZATION_NVP(absError);
+  ar & BOOST_SERIALIZATION_NVP(kernel);
+  ar & BOOST_SERIALIZATION_NVP(naive);
+  ar & BOOST_SERIALIZATION_NVP(singleMode);
+  ar & BOOST_SERIALIZATION_NVP(monteCarlo);
+  ar & BOOST_SERIALIZATION_NVP(mcProb);
+  ar & BOOST_SERIALIZATION_NVP(initialSampleSize);
+  ar & BOOST_SERIALIZATION_NVP(mcEntryCoef);
+  ar & BOOST_SERIALIZATION_NVP(mcBreakCoef);
+
+  // Reset base cases and scores if we are loading.
+  if (Archive::is_loading::value)
+  {
+    baseCases = 0;
+    scores = 0;
+  }
+
+  // If we are doing naive computation, we serialize the dataset.  Otherwise we
+  // serialize the tree.
+  if (naive)
+  {
+    if (Archive::is_loading::value)
+    {
+      if (setOwner && referenceSet)
+        delete referenceSet;
+
+      setOwner = true;
+    }
+
+    ar & BOOST_SERIALIZATION_NVP(referenceSet);
+    ar & BOOST_SERIALIZATION_NVP(metric);
+
+    // If we are loading, set the tree to NULL and clean up memory if necessary.
+    if (Archive::is_loading::value)
+    {
+      if (treeOwner && referenceTree)
+        delete referenceTree;
+
+      referenceTree = NULL;
+      oldFromNewReferences.clear();
+      treeOwner = false;
+    }
+  }
+  else
+  {
+    // Delete the current reference tree, if necessary and if we are loading.
+    if (Archive::is_loading::value)
+    {
+      if (treeOwner && referenceTree)
+        delete referenceTree;
+
+      // After we load the tree, we will own it.
+      treeOwner = true;
+    }
+
+    ar & BOOST_SERIALIZATION_NVP(referenceTree);
+    ar & BOOST_SERIALIZATION_NVP(oldFromNewReferences);
+
+    // If we are loading, set the dataset accordingly and clean up memory if
+    // necessary.
+    if (Archive::is_loading::value)
+    {
+      if (setOwner && referenceSet)
+        delete referenceSet;
+
+      referenceSet = &referenceTree->Dataset();
+      metric = referenceTree->Metric(); // Get the metric from the tree.
+      setOwner = false;
+    }
+  }
+}
+
+} // namespace kde
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,225 @@
+/**
+ * @file kde_main.cpp
+ *
+ * This file estimates the density of a set of points with kernel density
+ * estimation, using trees.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/util/cli.hpp>
+#include <mlpack/core/util/mlpack_main.hpp>
+
+#include "kde_model.hpp"
+
+using namespace std;
+using namespace mlpack;
+using namespace mlpack::kde;
+using namespace mlpack::util;
+
+// Information about the program itself.
+PROGRAM_INFO("Kernel Density Estimation",
+    "This program performs kernel density estimation: it estimates the density "
+    "of the distribution of a set of reference points at each point of a set "
+    "of query points, by averaging the values of a kernel function between the "
+    "query point and every reference point.  If no query set is given, the "
+    "density is estimated at each reference point (including the point "
+    "itself)."
+    "\n\n"
+    "Trees are used so that, when the kernel values between a query point (or "
+    "a group of query points) and a group of reference points are known well "
+    "enough from the bounds of the tree, they are estimated all at once.  "
+    "Each estimate before normalization is within " +
+    PRINT_PARAM_STRING("abs_error") + " plus " +
+    PRINT_PARAM_STRING("rel_error") + " times the true value; if both are 0, "
+    "the results are exact."
+    "\n\n"
+    "For example, the following will estimate the density of the points in " +
+    PRINT_DATASET("query") + " from the points in " +
+    PRINT_DATASET("reference") + " with a Gaussian kernel of bandwidth 0.2 and "
+    "a relative error of 5%, storing the estimates in " +
+    PRINT_DATASET("out_data") + ":"
+    "\n\n" +
+    PRINT_CALL("kde", "reference", "reference", "query", "query", "bandwidth",
+        0.2, "rel_error", 0.05, "predictions", "out_data") +
+    "\n\n"
+    "The kernel can be chosen with " + PRINT_PARAM_STRING("kernel") + " and "
+    "the tree with " + PRINT_PARAM_STRING("tree") + ".  In single-tree mode ("
+    + PRINT_PARAM_STRING("single_mode") + "), groups of reference points can "
+    "also be estimated by Monte Carlo sampling with " +
+    PRINT_PARAM_STRING("monte_carlo") + "; each such estimate is then within "
+    "the relative error with probability " +
+    PRINT_PARAM_STRING("mc_probability") + ".  A model can be saved with " + PRINT_PARAM_STRING("output_model") +
+    " and reused with " + PRINT_PARAM_STRING("input_model") + ".");
+
+// Required options.
+PARAM_MATRIX_IN("reference", "Input reference dataset.", "r");
+PARAM_MATRIX_IN("query", "Query dataset (if not given, the densities of the "
+    "reference points are estimated).", "q");
+
+// The option exists to load or save models.
+PARAM_MODEL_IN(KDEModel, "input_model", "File containing pre-trained KDE "
+    "model.", "m");
+PARAM_MODEL_OUT(KDEModel, "output_model", "If specified, the KDE model will "
+    "be saved to the given file.", "M");
+
+// Model parameters.
+PARAM_DOUBLE_IN("bandwidth", "Bandwidth of the kernel.", "b", 1.0);
+PARAM_STRING_IN("kernel", "Kernel to use: 'gaussian', 'epanechnikov', "
+    "'laplacian', 'spherical', 'triangular'.", "k", "gaussian");
+PARAM_STRING_IN("tree", "Type of tree to use: 'kd-tree', 'ball-tree', "
+    "'cover-tree', 'octree'.", "t", "kd-tree");
+
+// Evaluation settings.
+PARAM_DOUBLE_IN("rel_error", "Relative error tolerance of each estimate, "
+    "before normalization.", "e", 0.05);
+PARAM_DOUBLE_IN("abs_error", "Absolute error tolerance of each estimate, "
+    "before normalization.", "E", 0.0);
+PARAM_FLAG("naive", "If true, O(n^2) naive mode is used for computation.", "N");
+PARAM_FLAG("single_mode", "If true, single-tree computation is used (as "
+    "opposed to dual-tree computation).", "S");
+PARAM_FLAG("monte_carlo", "If set, Monte Carlo estimation may be used in "
+    "single-tree mode.", "c");
+PARAM_DOUBLE_IN("mc_probability", "Probability that a Monte Carlo estimate "
+    "is within the relative error tolerance.", "P", 0.95);
+PARAM_INT_IN("initial_sample_size", "Number of samples of the first round of "
+    "a Monte Carlo estimate.", "s", 100);
+PARAM_DOUBLE_IN("mc_entry_coef", "Groups of reference points are only "
+    "estimated by Monte Carlo sampling if they have at least this many times "
+    "the initial sample size points.", "C", 3.0);
+PARAM_DOUBLE_IN("mc_break_coef", "Monte Carlo estimation of a group of "
+    "reference points is abandoned if it would need more than this fraction of "
+    "its points.", "B", 0.4);
+PARAM_FLAG("parallel", "If set, the tree traversal is split between OpenMP "
+    "threads (the number of threads can be controlled with the OMP_NUM_THREADS "
+    "environment variable).", "p");
+PARAM_INT_IN("seed", "Random seed (if 0, std::time(NULL) is used).", "x", 0);
+
+// Output.
+PARAM_COL_OUT("predictions", "Vector to store the density estimates in.", "o");
+
+void mlpackMain()
+{
+  if (CLI::GetParam<int>("seed") != 0)
+    math::RandomSeed((size_t) CLI::GetParam<int>("seed"));
+  else
+    math::RandomSeed((size_t) std::time(NULL));
+
+  // A user cannot specify both reference data and a model.
+  RequireOnlyOnePassed({ "reference", "input_model" }, true);
+
+  ReportIgnoredParam({{ "input_model", true }}, "tree");
+  ReportIgnoredParam({{ "input_model", true }}, "kernel");
+  ReportIgnoredParam({{ "input_model", true }}, "bandwidth");
+  ReportIgnoredParam({{ "input_model", true }}, "naive");
+  ReportIgnoredParam({{ "single_mode", false }}, "monte_carlo");
+
+  RequireAtLeastOnePassed({ "predictions", "output_model" }, false,
+      "no results will be saved");
+
+  RequireParamValue<double>("bandwidth", [](double x) { return x > 0.0; },
+      true, "bandwidth must be positive");
+  RequireParamValue<double>("rel_error",
+      [](double x) { return x >= 0.0 && x <= 1.0; }, true,
+      "relative error must be in [0, 1]");
+  RequireParamValue<double>("abs_error", [](double x) { return x >= 0.0; },
+      true, "absolute error must be nonnegative");
+  RequireParamValue<double>("mc_probability",
+      [](double x) { return x >= 0.0 && x < 1.0; }, true,
+      "Monte Carlo probability must be in [0, 1)");
+  RequireParamValue<int>("initial_sample_size", [](int x) { return x > 1; },
+      true, "initial sample size must be greater than 1");
+  RequireParamValue<double>("mc_entry_coef", [](double x) { return x >= 1.0; },
+      true, "Monte Carlo entry coefficient must be at least 1");
+  RequireParamValue<double>("mc_break_coef",
+      [](double x) { return x > 0.0 && x <= 1.0; }, true,
+      "Monte Carlo break coefficient must be in (0, 1]");
+
+  KDEModel kde;
+  if (CLI::HasParam("reference"))
+  {
+    const string kernelType = CLI::GetParam<string>("kernel");
+    RequireParamInSet<string>("kernel", { "gaussian", "epanechnikov",
+        "laplacian", "spherical", "triangular" }, true, "unknown kernel type");
+    const string treeType = CLI::GetParam<string>("tree");
+    RequireParamInSet<string>("tree", { "kd-tree", "ball-tree", "cover-tree",
+        "octree" }, true, "unknown tree type");
+
+    if (kernelType == "gaussian")
+      kde.KernelType() = KDEModel::GAUSSIAN_KERNEL;
+    else if (kernelType == "epanechnikov")
+      kde.KernelType() = KDEModel::EPANECHNIKOV_KERNEL;
+    else if (kernelType == "laplacian")
+      kde.KernelType() = KDEModel::LAPLACIAN_KERNEL;
+    else if (kernelType == "spherical")
+      kde.KernelType() = KDEModel::SPHERICAL_KERNEL;
+    else if (kernelType == "triangular")
+      kde.KernelType() = KDEModel::TRIANGULAR_KERNEL;
+
+    if (treeType == "kd-tree")
+      kde.TreeType() = KDEModel::KD_TREE;
+    else if (treeType == "ball-tree")
+      kde.TreeType() = KDEModel::BALL_TREE;
+    else if (treeType == "cover-tree")
+      kde.TreeType() = KDEModel::COVER_TREE;
+    else if (treeType == "octree")
+      kde.TreeType() = KDEModel::OCTREE;
+
+    kde.Bandwidth() = CLI::GetParam<double>("bandwidth");
+
+    arma::mat referenceSet = std::move(CLI::GetParam<arma::mat>("reference"));
+
+    Log::Info << "Using reference data from '"
+        << CLI::GetPrintableParam<arma::mat>("reference") << "' ("
+        << referenceSet.n_rows << "x" << referenceSet.n_cols << ")." << endl;
+
+    kde.BuildModel(std::move(referenceSet), CLI::HasParam("naive"));
+  }
+  else
+  {
+    // Load the model from file.
+    kde = std::move(CLI::GetParam<KDEModel>("input_model"));
+
+    Log::Info << "Loaded KDE model from '"
+        << CLI::GetPrintableParam<KDEModel>("input_model") << "' (trained on "
+        << kde.KernelName() << " kernel, " << kde.TreeName() << ")." << endl;
+  }
+
+  // The evaluation settings can be changed for loaded models too.
+  kde.RelativeError() = CLI::GetParam<double>("rel_error");
+  kde.AbsoluteError() = CLI::GetParam<double>("abs_error");
+  kde.SingleMode() = CLI::HasParam("single_mode");
+  kde.MonteCarlo() = CLI::HasParam("monte_carlo");
+  kde.MCProbability() = CLI::GetParam<double>("mc_probability");
+  kde.MCInitialSampleSize() =
+      (size_t) CLI::GetParam<int>("initial_sample_size");
+  kde.MCEntryCoefficient() = CLI::GetParam<double>("mc_entry_coef");
+  kde.MCBreakCoefficient() = CLI::GetParam<double>("mc_break_coef");
+  kde.Parallel() = CLI::HasParam("parallel");
+
+  if (CLI::HasParam("predictions"))
+  {
+    arma::vec estimations;
+    if (CLI::HasParam("query"))
+    {
+      arma::mat querySet = std::move(CLI::GetParam<arma::mat>("query"));
+      Log::Info << "Loaded query data from '"
+          << CLI::GetPrintableParam<arma::mat>("query") << "' ("
+          << querySet.n_rows << "x" << querySet.n_cols << ")." << endl;
+
+      kde.Evaluate(std::move(querySet), estimations);
+    }
+    else
+    {
+      kde.Evaluate(estimations);
+    }
+
+    CLI::GetParam<arma::vec>("predictions") = std::move(estimations);
+  }
+
+  if (CLI::HasParam("output_model"))
+    CLI::GetParam<KDEModel>("output_model") = std::move(kde);
+}
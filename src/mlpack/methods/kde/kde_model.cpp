@@ -0,0 +1,285 @@
+/**
+ * @file kde_model.cpp
+ *
+ * Implementation of the KDEModel class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "kde_model.hpp"
+
+using namespace mlpack;
+using namespace mlpack::kde;
+
+//! Create a KDE object with the given kernel type, for the given tree type.
+template<typename KernelType>
+static KDEModel::KDEVariant NewKDE(const KDEModel::TreeTypes treeType,
+                                   const double bandwidth,
+                                   const double relError,
+                                   const double absError,
+                                   const bool naive)
+{
+  const KernelType kernel(bandwidth);
+  const metric::EuclideanDistance metric;
+
+  switch (treeType)
+  {
+    case KDEModel::KD_TREE:
+      return new KDEType<KernelType, tree::KDTree>(relError, absError, kernel,
+          metric, naive);
+    case KDEModel::BALL_TREE:
+      return new KDEType<KernelType, tree::BallTree>(relError, absError,
+          kernel, metric, naive);
+    case KDEModel::COVER_TREE:
+      return new KDEType<KernelType, tree::StandardCoverTree>(relError,
+          absError, kernel, metric, naive);
+    case KDEModel::OCTREE:
+      return new KDEType<KernelType, tree::Octree>(relError, absError, kernel,
+          metric, naive);
+  }
+
+  throw std::invalid_argument("KDEModel::BuildModel(): unknown tree type");
+}
+
+KDEModel::KDEModel(const double bandwidth,
+                   const double relError,
+                   const double absError,
+                   const KernelTypes kernelType,
+                   const TreeTypes treeType) :
+    bandwidth(bandwidth),
+    relError(relError),
+    absError(absError),
+    kernelType(kernelType),
+    treeType(treeType),
+    naive(false),
+    singleMode(false),
+    monteCarlo(false),
+    mcProb(0.95),
+    initialSampleSize(100),
+    mcEntryCoef(3.0),
+    mcBreakCoef(0.4),
+    parallel(false)
+{
+  // Nothing to do.
+}
+
+// Copy constructor.
+KDEModel::KDEModel(const KDEModel& other) :
+    bandwidth(other.bandwidth),
+    relError(other.relError),
+    absError(other.absError),
+    kernelType(other.kernelType),
+    treeType(other.treeType),
+    naive(other.naive),
+    singleMode(other.singleMode),
+    monteCarlo(other.monteCarlo),
+    mcProb(other.mcProb),
+    initialSampleSize(other.initialSampleSize),
+    mcEntryCoef(other.mcEntryCoef),
+    mcBreakCoef(other.mcBreakCoef),
+    parallel(other.parallel),
+    kdeModel(boost::apply_visitor(CopyVisitor<KDEVariant>(), other.kdeModel))
+{
+  // Nothing to do.
+}
+
+// Move constructor.
+KDEModel::KDEModel(KDEModel&& other) :
+    bandwidth(other.bandwidth),
+    relError(other.relError),
+    absError(other.absError),
+    kernelType(other.kernelType),
+    treeType(other.treeType),
+    naive(other.naive),
+    singleMode(other.singleMode),
+    monteCarlo(other.monteCarlo),
+    mcProb(other.mcProb),
+    initialSampleSize(other.initialSampleSize),
+    mcEntryCoef(other.mcEntryCoef),
+    mcBreakCoef(other.mcBreakCoef),
+    parallel(other.parallel),
+    kdeModel(std::move(other.kdeModel))
+{
+  // Reset other model.
+  other.kdeModel = decltype(other.kdeModel)();
+}
+
+// Copy operator.
+KDEModel& KDEModel::operator=(const KDEModel& other)
+{
+  if (this == &other)
+    return *this;
+
+  boost::apply_visitor(DeleteVisitor(), kdeModel);
+
+  bandwidth = other.bandwidth;
+  relError = other.relError;
+  absError = other.absError;
+  kernelType = other.kernelType;
+  treeType = other.treeType;
+  naive = other.naive;
+  singleMode = other.singleMode;
+  monteCarlo = other.monteCarlo;
+  mcProb = other.mcProb;
+  initialSampleSize = other.initialSampleSize;
+  mcEntryCoef = other.mcEntryCoef;
+  mcBreakCoef = other.mcBreakCoef;
+  parallel = other.parallel;
+  kdeModel = boost::apply_visitor(CopyVisitor<KDEVariant>(), other.kdeModel);
+
+  return *this;
+}
+
+// Move operator.
+KDEModel& KDEModel::operator=(KDEModel&& other)
+{
+  if (this == &other)
+    return *this;
+
+  boost::apply_visitor(DeleteVisitor(), kdeModel);
+
+  bandwidth = other.bandwidth;
+  relError = other.relError;
+  absError = other.absError;
+  kernelType = other.kernelType;
+  treeType = other.treeType;
+  naive = other.naive;
+  singleMode = other.singleMode;
+  monteCarlo = other.monteCarlo;
+  mcProb = other.mcProb;
+  initialSampleSize = other.initialSampleSize;
+  mcEntryCoef = other.mcEntryCoef;
+  mcBreakCoef = other.mcBreakCoef;
+  parallel = other.parallel;
+  kdeModel = std::move(other.kdeModel);
+
+  // Reset other model.
+  other.kdeModel = decltype(other.kdeModel)();
+
+  return *this;
+}
+
+// Clean memory, if necessary.
+KDEModel::~KDEModel()
+{
+  boost::apply_visitor(DeleteVisitor(), kdeModel);
+}
+
+void KDEModel::BuildModel(arma::mat&& referenceSet, const bool naive)
+{
+  this->naive = naive;
+
+  // Clean memory, if necessary.
+  boost::apply_visitor(DeleteVisitor(), kdeModel);
+  kdeModel = decltype(kdeModel)();
+
+  switch (kernelType)
+  {
+    case GAUSSIAN_KERNEL:
+      kdeModel = NewKDE<kernel::GaussianKernel>(treeType, bandwidth, relError,
+          absError, naive);
+      break;
+
+    case EPANECHNIKOV_KERNEL:
+      kdeModel = NewKDE<kernel::EpanechnikovKernel>(treeType, bandwidth,
+          relError, absError, naive);
+      break;
+
+    case LAPLACIAN_KERNEL:
+      kdeModel = NewKDE<kernel::LaplacianKernel>(treeType, bandwidth, relError,
+          absError, naive);
+      break;
+
+    case SPHERICAL_KERNEL:
+      kdeModel = NewKDE<kernel::SphericalKernel>(treeType, bandwidth, relError,
+          absError, naive);
+      break;
+
+    case TRIANGULAR_KERNEL:
+      kdeModel = NewKDE<kernel::TriangularKernel>(treeType, bandwidth,
+          relError, absError, naive);
+      break;
+  }
+
+  if (!naive)
+    Log::Info << "Building reference tree..." << std::endl;
+
+  TrainVisitor tn(std::move(referenceSet));
+  boost::apply_visitor(tn, kdeModel);
+
+  if (!naive)
+    Log::Info << "Tree built." << std::endl;
+}
+
+// Perform bichromatic evaluation.
+void KDEModel::Evaluate(arma::mat&& querySet, arma::vec& estimations)
+{
+  PrepareEvaluation();
+
+  BiEvaluateVisitor evaluate(querySet, estimations);
+  boost::apply_visitor(evaluate, kdeModel);
+}
+
+// Perform monochromatic evaluation.
+void KDEModel::Evaluate(arma::vec& estimations)
+{
+  PrepareEvaluation();
+
+  MonoEvaluateVisitor evaluate(estimations);
+  boost::apply_visitor(evaluate, kdeModel);
+}
+
+void KDEModel::PrepareEvaluation()
+{
+  boost::apply_visitor(SettingsVisitor(*this), kdeModel);
+
+  Log::Info << "Estimating densities with the " << KernelName() << " kernel "
+      << "using ";
+  if (naive)
+    Log::Info << "brute-force (naive) computation..." << std::endl;
+  else if (!singleMode)
+    Log::Info << "dual-tree " << TreeName() << " computation..." << std::endl;
+  else
+    Log::Info << "single-tree " << TreeName() << " computation..."
+        << std::endl;
+}
+
+// Get the name of the tree type.
+std::string KDEModel::TreeName() const
+{
+  switch (treeType)
+  {
+    case KD_TREE:
+      return "kd-tree";
+    case BALL_TREE:
+      return "ball tree";
+    case COVER_TREE:
+      return "cover tree";
+    case OCTREE:
+      return "octree";
+    default:
+      return "unknown tree";
+  }
+}
+
+// Get the name of the kernel type.
+std::string KDEModel::KernelName() const
+{
+  switch (kernelType)
+  {
+    case GAUSSIAN_KERNEL:
+      return "Gaussian";
+    case EPANECHNIKOV_KERNEL:
+      return "Epanechnikov";
+    case LAPLACIAN_KERNEL:
+      return "Laplacian";
+    case SPHERICAL_KERNEL:
+      return "spherical";
+    case TRIANGULAR_KERNEL:
+      return "triangular";
+    default:
+      return "unknown";
+  }
+}
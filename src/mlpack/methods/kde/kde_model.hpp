@@ -0,0 +1,410 @@
+/**
+ * @file kde_model.hpp
+ *
+ * This is a model for kernel density estimation.  It is useful in that it
+ * provides an easy way to serialize a model, abstracts away the different types
+ * of trees and kernels, and also reflects the KDE API.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KDE_KDE_MODEL_HPP
+#define MLPACK_METHODS_KDE_KDE_MODEL_HPP
+
+#include <mlpack/core/tree/binary_space_tree.hpp>
+#include <mlpack/core/tree/cover_tree.hpp>
+#include <mlpack/core/tree/octree.hpp>
+#include <mlpack/core/kernels/gaussian_kernel.hpp>
+#include <mlpack/core/kernels/epanechnikov_kernel.hpp>
+#include <mlpack/core/kernels/laplacian_kernel.hpp>
+#include <mlpack/core/kernels/spherical_kernel.hpp>
+#include <mlpack/core/kernels/triangular_kernel.hpp>
+#include <boost/variant.hpp>
+#include "kde.hpp"
+
+namespace mlpack {
+namespace kde {
+
+/**
+ * Alias template for KDE with the Euclidean distance.
+ */
+template<typename KernelType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+using KDEType = KDE<KernelType, metric::EuclideanDistance, arma::mat,
+    TreeType>;
+
+//! Forward declaration.
+class KDEModel;
+
+/**
+ * TrainVisitor sets the reference set to a new reference set on the given
+ * KDEType, building the reference tree if necessary.
+ */
+class TrainVisitor : public boost::static_visitor<void>
+{
+ private:
+  //! The reference set to use for training.
+  arma::mat&& referenceSet;
+
+ public:
+  //! Train the given KDE object.
+  template<typename KDEType>
+  void operator()(KDEType* kde) const;
+
+  //! Construct the TrainVisitor object with the given reference set.
+  TrainVisitor(arma::mat&& referenceSet);
+};
+
+/**
+ * SettingsVisitor copies the settings of a KDEModel (error tolerances,
+ * single-tree mode, Monte Carlo and parallel settings) to the given KDEType.
+ */
+class SettingsVisitor : public boost::static_visitor<void>
+{
+ private:
+  //! The model whose settings are copied.
+  const KDEModel& model;
+
+ public:
+  //! Copy the settings to the given KDE object.
+  template<typename KDEType>
+  void operator()(KDEType* kde) const;
+
+  //! Construct the SettingsVisitor object with the given model.
+  SettingsVisitor(const KDEModel& model) : model(model) { }
+};
+
+/**
+ * BiEvaluateVisitor estimates the density of each point of a query set with the
+ * given KDEType.
+ */
+class BiEvaluateVisitor : public boost::static_visitor<void>
+{
+ private:
+  //! The query set.
+  const arma::mat& querySet;
+  //! The output estimates.
+  arma::vec& estimations;
+
+ public:
+  //! Evaluate with the given KDE object.
+  template<typename KDEType>
+  void operator()(KDEType* kde) const;
+
+  //! Construct the BiEvaluateVisitor.
+  BiEvaluateVisitor(const arma::mat& querySet, arma::vec& estimations) :
+      querySet(querySet),
+      estimations(estimations)
+  { }
+};
+
+/**
+ * MonoEvaluateVisitor estimates the density of each point of the reference
+ * set with the given KDEType.
+ */
+class MonoEvaluateVisitor : public boost::static_visitor<void>
+{
+ private:
+  //! The output estimates.
+  arma::vec& estimations;
+
+ public:
+  //! Evaluate with the given KDE object.
+  template<typename KDEType>
+  void operator()(KDEType* kde) const;
+
+  //! Construct the MonoEvaluateVisitor.
+  MonoEvaluateVisitor(arma::vec& estimations) : estimations(estimations) { }
+};
+
+/**
+ * CopyVisitor returns a deep copy of the given KDEType, as the variant type
+ * VariantType.
+ */
+template<typename VariantType>
+class CopyVisitor : public boost::static_visitor<VariantType>
+{
+ public:
+  //! Return a copy of the given KDE object.
+  template<typename KDEType>
+  VariantType operator()(KDEType* kde) const;
+};
+
+/**
+ * DeleteVisitor deletes the given KDEType instance.
+ */
+class DeleteVisitor : public boost::static_visitor<void>
+{
+ public:
+  //! Delete the KDE object.
+  template<typename KDEType>
+  void operator()(KDEType* kde) const;
+};
+
+/**
+ * The KDEModel class provides an easy way to serialize a kernel density
+ * estimation model, abstracts away the different types of trees and kernels,
+ * and also reflects the KDE API.  The settings of the model are applied to the
+ * underlying KDE object before each evaluation.
+ */
+class KDEModel
+{
+ public:
+  enum TreeTypes
+  {
+    KD_TREE,
+    BALL_TREE,
+    COVER_TREE,
+    OCTREE
+  };
+
+  enum KernelTypes
+  {
+    GAUSSIAN_KERNEL,
+    EPANECHNIKOV_KERNEL,
+    LAPLACIAN_KERNEL,
+    SPHERICAL_KERNEL,
+    TRIANGULAR_KERNEL
+  };
+
+  //! The type of the variant holding the KDE object.
+  typedef boost::variant<KDEType<kernel::GaussianKernel, tree::KDTree>*,
+                         KDEType<kernel::GaussianKernel, tree::BallTree>*,
+                         KDEType<kernel::GaussianKernel,
+                             tree::StandardCoverTree>*,
+                         KDEType<kernel::GaussianKernel, tree::Octree>*,
+                         KDEType<kernel::EpanechnikovKernel, tree::KDTree>*,
+                         KDEType<kernel::EpanechnikovKernel, tree::BallTree>*,
+                         KDEType<kernel::EpanechnikovKernel,
+                             tree::StandardCoverTree>*,
+                         KDEType<kernel::EpanechnikovKernel, tree::Octree>*,
+                         KDEType<kernel::LaplacianKernel, tree::KDTree>*,
+                         KDEType<kernel::LaplacianKernel, tree::BallTree>*,
+                         KDEType<kernel::LaplacianKernel,
+                             tree::StandardCoverTree>*,
+                         KDEType<kernel::LaplacianKernel, tree::Octree>*,
+                         KDEType<kernel::SphericalKernel, tree::KDTree>*,
+                         KDEType<kernel::SphericalKernel, tree::BallTree>*,
+                         KDEType<kernel::SphericalKernel,
+                             tree::StandardCoverTree>*,
+                         KDEType<kernel::SphericalKernel, tree::Octree>*,
+                         KDEType<kernel::TriangularKernel, tree::KDTree>*,
+                         KDEType<kernel::TriangularKernel, tree::BallTree>*,
+                         KDEType<kernel::TriangularKernel,
+                             tree::StandardCoverTree>*,
+                         KDEType<kernel::TriangularKernel, tree::Octree>*>
+      KDEVariant;
+
+ private:
+  //! The bandwidth of the kernel.
+  double bandwidth;
+  //! The relative error tolerance.
+  double relError;
+  //! The absolute error tolerance.
+  double absError;
+  //! The type of kernel.
+  KernelTypes kernelType;
+  //! The type of tree.
+  TreeTypes treeType;
+
+  //! If true, naive computation is used.
+  bool naive;
+  //! If true, single-tree computation is used.
+  bool singleMode;
+  //! If true, Monte Carlo estimation is used in single-tree mode.
+  bool monteCarlo;
+  //! Probability that a Monte Carlo estimate is within the relative error.
+  double mcProb;
+  //! Number of samples of the first round of a Monte Carlo estimate.
+  size_t initialSampleSize;
+  //! Monte Carlo entry coefficient.
+  double mcEntryCoef;
+  //! Monte Carlo break coefficient.
+  double mcBreakCoef;
+  //! If true, tree traversals are parallelized with OpenMP.
+  bool parallel;
+
+  /**
+   * kdeModel holds an instance of the KDE class for the current kernel and
+   * tree type.  It is initialized every time BuildModel() is executed.  We
+   * access the contained value through the visitor classes defined above.
+   */
+  KDEVariant kdeModel;
+
+ public:
+  /**
+   * Initialize the KDEModel with the given settings.
+   *
+   * @param bandwidth Bandwidth of the kernel.
+   * @param relError Relative error tolerance, in [0, 1].
+   * @param absError Absolute error tolerance, before normalization.
+   * @param kernelType Type of kernel to use.
+   * @param treeType Type of tree to use.
+   */
+  KDEModel(const double bandwidth = 1.0,
+           const double relError = 0.05,
+           const double absError = 0.0,
+           const KernelTypes kernelType = KernelTypes::GAUSSIAN_KERNEL,
+           const TreeTypes treeType = TreeTypes::KD_TREE);
+
+  /**
+   * Copy the given KDEModel.
+   *
+   * @param other KDEModel to copy.
+   */
+  KDEModel(const KDEModel& other);
+
+  /**
+   * Take ownership of the given KDEModel.
+   *
+   * @param other KDEModel to take ownership of.
+   */
+  KDEModel(KDEModel&& other);
+
+  /**
+   * Copy the given KDEModel.
+   *
+   * @param other KDEModel to copy.
+   */
+  KDEModel& operator=(const KDEModel& other);
+
+  /**
+   * Take ownership of the given KDEModel.
+   *
+   * @param other KDEModel to take ownership of.
+   */
+  KDEModel& operator=(KDEModel&& other);
+
+  /**
+   * Clean memory, if necessary.
+   */
+  ~KDEModel();
+
+  //! Serialize the KDE model.
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */);
+
+  //! Get the bandwidth of the kernel.
+  double Bandwidth() const { return bandwidth; }
+  //! Modify the bandwidth of the kernel (don't do this after the model has
+  //! been built).
+  double& Bandwidth() { return bandwidth; }
+
+  //! Get the relative error tolerance.
+  double RelativeError() const { return relError; }
+  //! Modify the relative error tolerance.
+  double& RelativeError() { return relError; }
+
+  //! Get the absolute error tolerance.
+  double AbsoluteError() const { return absError; }
+  //! Modify the absolute error tolerance.
+  double& AbsoluteError() { return absError; }
+
+  //! Get the type of kernel.
+  KernelTypes KernelType() const { return kernelType; }
+  //! Modify the type of kernel (don't do this after the model has been built).
+  KernelTypes& KernelType() { return kernelType; }
+
+  //! Get the type of tree.
+  TreeTypes TreeType() const { return treeType; }
+  //! Modify the type of tree (don't do this after the model has been built).
+  TreeTypes& TreeType() { return treeType; }
+
+  //! Get whether naive computation is used; this is set by BuildModel().
+  bool Naive() const { return naive; }
+
+  //! Get whether single-tree computation is used.
+  bool SingleMode() const { return singleMode; }
+  //! Modify whether single-tree computation is used.
+  bool& SingleMode() { return singleMode; }
+
+  //! Get whether Monte Carlo estimation is used.
+  bool MonteCarlo() const { return monteCarlo; }
+  //! Modify whether Monte Carlo estimation is used (only in single-tree mode).
+  bool& MonteCarlo() { return monteCarlo; }
+
+  //! Get the probability that a Monte Carlo estimate is within the relative
+  //! error tolerance.
+  double MCProbability() const { return mcProb; }
+  //! Modify the probability that a Monte Carlo estimate is within the relative
+  //! error tolerance.
+  double& MCProbability() { return mcProb; }
+
+  //! Get the number of samples of the first round of a Monte Carlo estimate.
+  size_t MCInitialSampleSize() const { return initialSampleSize; }
+  //! Modify the number of samples of the first round of a Monte Carlo
+  //! estimate.
+  size_t& MCInitialSampleSize() { return initialSampleSize; }
+
+  //! Get the Monte Carlo entry coefficient.
+  double MCEntryCoefficient() const { return mcEntryCoef; }
+  //! Modify the Monte Carlo entry coefficient.
+  double& MCEntryCoefficient() { return mcEntryCoef; }
+
+  //! Get the Monte Carlo break coefficient.
+  double MCBreakCoefficient() const { return mcBreakCoef; }
+  //! Modify the Monte Carlo break coefficient.
+  double& MCBreakCoefficient() { return mcBreakCoef; }
+
+  //! Get whether tree traversals are parallelized with OpenMP.
+  bool Parallel() const { return parallel; }
+  //! Modify whether tree traversals are parallelized with OpenMP.  This
+  //! setting is not serialized.
+  bool& Parallel() { return parallel; }
+
+  /**
+   * Build the KDE object for the current kernel and tree type on the given
+   * reference set.  This takes possession of the reference set to avoid a
+   * copy.
+   *
+   * @param referenceSet Set of reference points.
+   * @param naive Whether naive computation should be used.
+   */
+  void BuildModel(arma::mat&& referenceSet, const bool naive = false);
+
+  /**
+   * Estimate the density of each point of the query set.  This takes
+   * possession of the query set, so the query set will not be usable after
+   * the evaluation.
+   *
+   * @param querySet Set of query points.
+   * @param estimations Output: density estimate of each query point.
+   */
+  void Evaluate(arma::mat&& querySet, arma::vec& estimations);
+
+  /**
+   * Estimate the density of each point of the reference set.  Each estimate
+   * includes the kernel value of the point with itself.
+   *
+   * @param estimations Output: density estimate of each reference point.
+   */
+  void Evaluate(arma::vec& estimations);
+
+  /**
+   * Return a string representing the name of the tree.  This is used for
+   * logging output.
+   */
+  std::string TreeName() const;
+
+  /**
+   * Return a string representing the name of the kernel.  This is used for
+   * logging output.
+   */
+  std::string KernelName() const;
+
+ private:
+  //! Log the kind of evaluation and copy the settings to the KDE object.
+  void PrepareEvaluation();
+};
+
+} // namespace kde
+} // namespace mlpack
+
+// Include implementation (of serialize() and templated functions).
+#include "kde_model_impl.hpp"
+
+#endif
@@ -0,0 +1,118 @@
+/**
+ * @file kde_model_impl.hpp
+ *
+ * Implementation of the visitors of KDEModel and of its serialization.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KDE_KDE_MODEL_IMPL_HPP
+#define MLPACK_METHODS_KDE_KDE_MODEL_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "kde_model.hpp"
+
+#include <boost/serialization/variant.hpp>
+
+namespace mlpack {
+namespace kde {
+
+//! Save the reference set for training.
+inline TrainVisitor::TrainVisitor(arma::mat&& referenceSet) :
+    referenceSet(std::move(referenceSet))
+{
+  // Nothing to do.
+}
+
+//! Train the given KDE object.
+template<typename KDEType>
+void TrainVisitor::operator()(KDEType* kde) const
+{
+  if (kde)
+    return kde->Train(std::move(referenceSet));
+  throw std::runtime_error("no KDE model initialized");
+}
+
+//! Copy the settings of the model to the given KDE object.
+template<typename KDEType>
+void SettingsVisitor::operator()(KDEType* kde) const
+{
+  if (!kde)
+    throw std::runtime_error("no KDE model initialized");
+
+  kde->RelativeError(model.RelativeError());
+  kde->AbsoluteError(model.AbsoluteError());
+  kde->SingleMode() = model.SingleMode() && !kde->Naive();
+  kde->MonteCarlo() = model.MonteCarlo();
+  kde->MCProbability(model.MCProbability());
+  kde->MCInitialSampleSize() = model.MCInitialSampleSize();
+  kde->MCEntryCoefficient() = model.MCEntryCoefficient();
+  kde->MCBreakCoefficient() = model.MCBreakCoefficient();
+  kde->Parallel() = model.Parallel();
+}
+
+//! Bichromatic evaluation with the given KDE object.
+template<typename KDEType>
+void BiEvaluateVisitor::operator()(KDEType* kde) const
+{
+  if (kde)
+    return kde->Evaluate(querySet, estimations);
+  throw std::runtime_error("no KDE model initialized");
+}
+
+//! Monochromatic evaluation with the given KDE object.
+template<typename KDEType>
+void MonoEvaluateVisitor::operator()(KDEType* kde) const
+{
+  if (kde)
+    return kde->Evaluate(estimations);
+  throw std::runtime_error("no KDE model initialized");
+}
+
+//! Return a deep copy of the given KDE object.
+template<typename VariantType>
+template<typename KDEType>
+VariantType CopyVisitor<VariantType>::operator()(KDEType* kde) const
+{
+  return VariantType(kde ? new KDEType(*kde) : (KDEType*) NULL);
+}
+
+//! Delete the given KDE object.
+template<typename KDEType>
+void DeleteVisitor::operator()(KDEType* kde) const
+{
+  if (kde)
+    delete kde;
+}
+
+// Serialize the model.
+template<typename Archive>
+void KDEModel::serialize(Archive& ar, const unsigned int /* version */)
+{
+  ar & BOOST_SERIALIZATION_NVP(bandwidth);
+  ar & BOOST_SERIALIZATION_NVP(relError);
+  ar & BOOST_SERIALIZATION_NVP(absError);
+  ar & BOOST_SERIALIZATION_NVP(kernelType);
+  ar & BOOST_SERIALIZATION_NVP(treeType);
+  ar & BOOST_SERIALIZATION_NVP(naive);
+  ar & BOOST_SERIALIZATION_NVP(singleMode);
+  ar & BOOST_SERIALIZATION_NVP(monteCarlo);
+  ar & BOOST_SERIALIZATION_NVP(mcProb);
+  ar & BOOST_SERIALIZATION_NVP(initialSampleSize);
+  ar & BOOST_SERIALIZATION_NVP(mcEntryCoef);
+  ar & BOOST_SERIALIZATION_NVP(mcBreakCoef);
+
+  // This should never happen, but just in case...
+  if (Archive::is_loading::value)
+    boost::apply_visitor(DeleteVisitor(), kdeModel);
+
+  // We'll only need to serialize one of the model objects, based on the type.
+  ar & BOOST_SERIALIZATION_NVP(kdeModel);
+}
+
+} // namespace kde
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,245 @@
+/**
+ * @file kde_rules.hpp
+ *
+ * Rules for kernel density estimation, so that it can be done with arbitrary
+ * tree types.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KDE_KDE_RULES_HPP
+#define MLPACK_METHODS_KDE_KDE_RULES_HPP
+
+#include <mlpack/core/tree/traversal_counters.hpp>
+#include <mlpack/core/tree/traversal_info.hpp>
+
+namespace mlpack {
+namespace kde {
+
+/**
+ * The KDERules class is a template helper class used by the KDE class when
+ * computing kernel density estimates.  The kernel must be a function of the
+ * distance that does not increase with the distance, so that the bounds on the
+ * distances between two nodes give bounds on the kernel values.
+ *
+ * When the kernel values between a query point (or node) and a reference node
+ * are known to within the error tolerance, all of them are replaced by the
+ * middle of the bounds and the node is pruned.  Each pair then has an error of
+ * at most absError + relError * K, so the sums also meet the tolerances.
+ *
+ * In single-tree mode, nodes that can't be pruned this way may also be
+ * estimated by Monte Carlo sampling: kernel values with random points of the
+ * node are evaluated until the estimate of their mean is within relError of
+ * the true mean with probability mcProb, or until too many points would be
+ * needed.
+ *
+ * @tparam MetricType The metric to use for computation.
+ * @tparam KernelType The kernel to use for computation.
+ * @tparam TreeType The tree type to use; must adhere to the TreeType API.
+ */
+template<typename MetricType, typename KernelType, typename TreeType>
+class KDERules
+{
+ public:
+  /**
+   * Construct the KDERules object.  This is usually done from within the KDE
+   * class at evaluation time.
+   *
+   * @param referenceSet Set of reference data.
+   * @param querySet Set of query data.
+   * @param densities Vector to add the sums of kernel values to; it must
+   *     already be filled with zeros.
+   * @param relError Relative error tolerance.
+   * @param absError Absolute error tolerance.
+   * @param metric Instantiated metric.
+   * @param kernel Instantiated kernel.
+   * @param monteCarlo If true, Monte Carlo estimation may be used.
+   * @param mcProb Probability that a Monte Carlo estimate is within the
+   *     relative error tolerance.
+   * @param initialSampleSize Number of samples of the first round of a Monte
+   *     Carlo estimate.
+   * @param mcEntryCoef A node is only estimated with Monte Carlo sampling if
+   *     it has at least mcEntryCoef * initialSampleSize points.
+   * @param mcBreakCoef Monte Carlo estimation of a node is abandoned if it
+   *     needs more than mcBreakCoef times the number of points of the node.
+   */
+  KDERules(const typename TreeType::Mat& referenceSet,
+           const typename TreeType::Mat& querySet,
+           arma::vec& densities,
+           const double relError,
+           const double absError,
+           MetricType& metric,
+           KernelType& kernel,
+           const bool monteCarlo = false,
+           const double mcProb = 0.95,
+           const size_t initialSampleSize = 100,
+           const double mcEntryCoef = 3.0,
+           const double mcBreakCoef = 0.4);
+
+  /**
+   * Construct a KDERules object that shares the densities of the given rules
+   * object, but has its own base case cache, traversal info, random number
+   * generator, and counters.  This is used by parallel traversals to give each
+   * thread its own rules object.  It is only safe as long as no two threads
+   * ever work on the same query point (or query node) at the same time.
+   *
+   * @param other Rules object whose densities will be shared.
+   */
+  KDERules(KDERules& other);
+
+  /**
+   * Evaluate the kernel between the given query point and reference point, and
+   * add it to the density of the query point.
+   *
+   * @param queryIndex Index of query point.
+   * @param referenceIndex Index of reference point.
+   */
+  double BaseCase(const size_t queryIndex, const size_t referenceIndex);
+
+  /**
+   * Compute the base cases between the given query point and each point of a
+   * contiguous block of reference points.  This is equivalent to calling
+   * BaseCase() for each of the reference points, but faster.
+   *
+   * @param queryIndex Index of query point.
+   * @param referenceBegin Index of the first reference point of the block.
+   * @param referenceCount Number of reference points in the block.
+   */
+  void BaseCaseBlock(const size_t queryIndex,
+                     const size_t referenceBegin,
+                     const size_t referenceCount);
+
+  /**
+   * Get the score for recursion order.  DBL_MAX indicates that the node was
+   * estimated as a whole and should not be recursed into.
+   *
+   * @param queryIndex Index of query point.
+   * @param referenceNode Candidate node to be recursed into.
+   */
+  double Score(const size_t queryIndex, TreeType& referenceNode);
+
+  /**
+   * Re-evaluate the score for recursion order.  The bounds do not change
+   * during density estimation, so this returns the old score.
+   *
+   * @param queryIndex Index of query point.
+   * @param referenceNode Candidate node to be recursed into.
+   * @param oldScore Old score produced by Score() (or Rescore()).
+   */
+  double Rescore(const size_t queryIndex,
+                 TreeType& referenceNode,
+                 const double oldScore) const;
+
+  /**
+   * Get the score for recursion order.  DBL_MAX indicates that the node
+   * combination was estimated as a whole and should not be recursed into.
+   *
+   * @param queryNode Candidate query node to recurse into.
+   * @param referenceNode Candidate reference node to recurse into.
+   */
+  double Score(TreeType& queryNode, TreeType& referenceNode);
+
+  /**
+   * Re-evaluate the score for recursion order.  The bounds do not change
+   * during density estimation, so this returns the old score.
+   *
+   * @param queryNode Candidate query node to recurse into.
+   * @param referenceNode Candidate reference node to recurse into.
+   * @param oldScore Old score produced by Score() (or Rescore()).
+   */
+  double Rescore(TreeType& queryNode,
+                 TreeType& referenceNode,
+                 const double oldScore) const;
+
+  typedef typename tree::TraversalInfo<TreeType> TraversalInfoType;
+
+  const TraversalInfoType& TraversalInfo() const { return traversalInfo; }
+  TraversalInfoType& TraversalInfo() { return traversalInfo; }
+
+  //! Get the number of base cases.
+  size_t BaseCases() const { return counters.BaseCases(); }
+  //! Get the number of scores.
+  size_t Scores() const { return counters.Scores(); }
+
+  //! Get the traversal counters.
+  const tree::TraversalCounters& Counters() const { return counters; }
+  //! Modify the traversal counters.
+  tree::TraversalCounters& Counters() { return counters; }
+
+  //! Modify the random number generator used for Monte Carlo estimation.
+  //! Reseeding it before traversing a fixed part of the work makes the
+  //! sampling of that part reproducible, whichever thread does it.
+  std::mt19937& Generator() { return generator; }
+
+ private:
+  //! Return true if the kernel values between the query point and the
+  //! reference node are known well enough, given bounds on the distances.
+  bool CanPrune(const math::Range& distances, double& estimate) const;
+
+  //! Add the given kernel value, once for each point in the reference node, to
+  //! the density of the given query point.  If the base case with the first
+  //! point of the node has already been added, it is not added twice.
+  void AddEstimate(const size_t queryIndex,
+                   TreeType& referenceNode,
+                   const double kernelValue);
+
+  //! Try to estimate the kernel values between the given query point and the
+  //! points of the reference node by Monte Carlo sampling; return true and add
+  //! the estimate to the density if it succeeds.
+  bool MonteCarloEstimate(const size_t queryIndex, TreeType& referenceNode);
+
+  //! The reference set.
+  const typename TreeType::Mat& referenceSet;
+
+  //! The query set.
+  const typename TreeType::Mat& querySet;
+
+  //! The sums of kernel values of each query point.
+  arma::vec& densities;
+
+  //! The relative error tolerance.
+  double relError;
+  //! The absolute error tolerance.
+  double absError;
+
+  //! The instantiated metric.
+  MetricType& metric;
+  //! The instantiated kernel.
+  KernelType& kernel;
+
+  //! If true, Monte Carlo estimation may be used.
+  bool monteCarlo;
+  //! The quantile of the standard normal distribution for mcProb.
+  double mcQuantile;
+  //! Number of samples of the first round of a Monte Carlo estimate.
+  size_t initialSampleSize;
+  //! Entry coefficient for Monte Carlo estimation.
+  double mcEntryCoef;
+  //! Break coefficient for Monte Carlo estimation.
+  double mcBreakCoef;
+
+  //! The random number generator for Monte Carlo estimation.
+  std::mt19937 generator;
+
+  //! The last query index.
+  size_t lastQueryIndex;
+  //! The last reference index.
+  size_t lastReferenceIndex;
+  //! The distances computed by the last call to BaseCaseBlock().
+  arma::vec blockDistances;
+
+  TraversalInfoType traversalInfo;
+
+  //! The counters of base cases, scores, prunes, and node visits.
+  tree::TraversalCounters counters;
+};
+
+} // namespace kde
+} // namespace mlpack
+
+// Include implementation.
+#include "kde_rules_impl.hpp"
+
+#endif
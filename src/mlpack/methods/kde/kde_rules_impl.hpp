@@ -0,0 +1,354 @@
+/**
+ * @file kde_rules_impl.hpp
+ *
+ * Implementation of rules for kernel density estimation with generic trees.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KDE_KDE_RULES_IMPL_HPP
+#define MLPACK_METHODS_KDE_KDE_RULES_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "kde_rules.hpp"
+#include <mlpack/core/metrics/evaluate_block.hpp>
+
+#include <boost/math/distributions/normal.hpp>
+
+namespace mlpack {
+namespace kde {
+
+template<typename MetricType, typename KernelType, typename TreeType>
+KDERules<MetricType, KernelType, TreeType>::KDERules(
+    const typename TreeType::Mat& referenceSet,
+    const typename TreeType::Mat& querySet,
+    arma::vec& densities,
+    const double relError,
+    const double absError,
+    MetricType& metric,
+    KernelType& kernel,
+    const bool monteCarlo,
+    const double mcProb,
+    const size_t initialSampleSize,
+    const double mcEntryCoef,
+    const double mcBreakCoef) :
+    referenceSet(referenceSet),
+    querySet(querySet),
+    densities(densities),
+    relError(relError),
+    absError(absError),
+    metric(metric),
+    kernel(kernel),
+    monteCarlo(monteCarlo),
+    mcQuantile(0.0),
+    initialSampleSize(initialSampleSize),
+    mcEntryCoef(mcEntryCoef),
+    mcBreakCoef(mcBreakCoef),
+    generator(math::randGen()),
+    lastQueryIndex(querySet.n_cols),
+    lastReferenceIndex(referenceSet.n_cols)
+{
+  // The estimate of a mean is within z standard errors of the true mean with
+  // probability mcProb, where z is this quantile of the normal distribution.
+  if (monteCarlo)
+  {
+    mcQuantile = boost::math::quantile(boost::math::normal(),
+        (1.0 + mcProb) / 2.0);
+  }
+}
+
+template<typename MetricType, typename KernelType, typename TreeType>
+KDERules<MetricType, KernelType, TreeType>::KDERules(KDERules& other) :
+    referenceSet(other.referenceSet),
+    querySet(other.querySet),
+    densities(other.densities),
+    relError(other.relError),
+    absError(other.absError),
+    metric(other.metric),
+    kernel(other.kernel),
+    monteCarlo(other.monteCarlo),
+    mcQuantile(other.mcQuantile),
+    initialSampleSize(other.initialSampleSize),
+    mcEntryCoef(other.mcEntryCoef),
+    mcBreakCoef(other.mcBreakCoef),
+    generator(other.generator),
+    lastQueryIndex(querySet.n_cols),
+    lastReferenceIndex(referenceSet.n_cols)
+{
+  // Nothing to do.
+}
+
+template<typename MetricType, typename KernelType, typename TreeType>
+inline force_inline
+double KDERules<MetricType, KernelType, TreeType>::BaseCase(
+    const size_t queryIndex,
+    const size_t referenceIndex)
+{
+  // If we have just performed this base case, don't do it again.
+  if ((lastQueryIndex == queryIndex) && (lastReferenceIndex == referenceIndex))
+    return 0.0;
+
+  const double distance = metric.Evaluate(querySet.unsafe_col(queryIndex),
+      referenceSet.unsafe_col(referenceIndex));
+  counters.BaseCase();
+
+  lastQueryIndex = queryIndex;
+  lastReferenceIndex = referenceIndex;
+
+  densities[queryIndex] += kernel.Evaluate(distance);
+
+  return distance;
+}
+
+template<typename MetricType, typename KernelType, typename TreeType>
+void KDERules<MetricType, KernelType, TreeType>::BaseCaseBlock(
+    const size_t queryIndex,
+    const size_t referenceBegin,
+    const size_t referenceCount)
+{
+  metric::EvaluateBlock(metric, querySet.unsafe_col(queryIndex), referenceSet,
+      referenceBegin, referenceCount, blockDistances);
+
+  for (size_t i = 0; i < referenceCount; ++i)
+  {
+    const size_t referenceIndex = referenceBegin + i;
+
+    // Skip the same base case that BaseCase() would skip.
+    if ((lastQueryIndex == queryIndex) &&
+        (lastReferenceIndex == referenceIndex))
+      continue;
+
+    counters.BaseCase();
+    lastQueryIndex = queryIndex;
+    lastReferenceIndex = referenceIndex;
+
+    densities[queryIndex] += kernel.Evaluate(blockDistances[i]);
+  }
+}
+
+template<typename MetricType, typename KernelType, typename TreeType>
+double KDERules<MetricType, KernelType, TreeType>::Score(
+    const size_t queryIndex,
+    TreeType& referenceNode)
+{
+  math::Range distances;
+
+  if (tree::TreeTraits<TreeType>::FirstPointIsCentroid)
+  {
+    double baseCase;
+    if (tree::TreeTraits<TreeType>::HasSelfChildren &&
+        (referenceNode.Parent() != NULL) &&
+        (referenceNode.Point(0) == referenceNode.Parent()->Point(0)))
+    {
+      // The base case of a self-child was already calculated.
+      baseCase = referenceNode.Parent()->Stat().LastDistance();
+      lastQueryIndex = queryIndex;
+      lastReferenceIndex = referenceNode.Point(0);
+    }
+    else
+    {
+      baseCase = BaseCase(queryIndex, referenceNode.Point(0));
+    }
+
+    distances.Lo() = baseCase - referenceNode.FurthestDescendantDistance();
+    distances.Hi() = baseCase + referenceNode.FurthestDescendantDistance();
+
+    referenceNode.Stat().LastDistance() = baseCase;
+  }
+  else
+  {
+    distances = referenceNode.RangeDistance(querySet.unsafe_col(queryIndex));
+    counters.Score();
+  }
+
+  // If the kernel values are known well enough, estimate them all at once.
+  double estimate;
+  if (CanPrune(distances, estimate))
+  {
+    AddEstimate(queryIndex, referenceNode, estimate);
+    return counters.ScoreResult(DBL_MAX);
+  }
+
+  if (monteCarlo && MonteCarloEstimate(queryIndex, referenceNode))
+    return counters.ScoreResult(DBL_MAX);
+
+  // Otherwise, recurse into the closest nodes first.
+  return counters.ScoreResult(std::max(distances.Lo(), 0.0));
+}
+
+template<typename MetricType, typename KernelType, typename TreeType>
+double KDERules<MetricType, KernelType, TreeType>::Rescore(
+    const size_t /* queryIndex */,
+    TreeType& /* referenceNode */,
+    const double oldScore) const
+{
+  return oldScore;
+}
+
+template<typename MetricType, typename KernelType, typename TreeType>
+double KDERules<MetricType, KernelType, TreeType>::Score(
+    TreeType& queryNode,
+    TreeType& referenceNode)
+{
+  math::Range distances;
+  if (tree::TreeTraits<TreeType>::FirstPointIsCentroid)
+  {
+    // It is possible that the base case has already been calculated.
+    double baseCase = 0.0;
+    if ((traversalInfo.LastQueryNode() != NULL) &&
+        (traversalInfo.LastReferenceNode() != NULL) &&
+        (traversalInfo.LastQueryNode()->Point(0) == queryNode.Point(0)) &&
+        (traversalInfo.LastReferenceNode()->Point(0) == referenceNode.Point(0)))
+    {
+      baseCase = traversalInfo.LastBaseCase();
+      lastQueryIndex = queryNode.Point(0);
+      lastReferenceIndex = referenceNode.Point(0);
+    }
+    else
+    {
+      baseCase = BaseCase(queryNode.Point(0), referenceNode.Point(0));
+    }
+
+    distances.Lo() = baseCase - queryNode.FurthestDescendantDistance()
+        - referenceNode.FurthestDescendantDistance();
+    distances.Hi() = baseCase + queryNode.FurthestDescendantDistance()
+        + referenceNode.FurthestDescendantDistance();
+
+    traversalInfo.LastBaseCase() = baseCase;
+  }
+  else
+  {
+    distances = referenceNode.RangeDistance(queryNode);
+    counters.Score();
+  }
+
+  // If the kernel values of every pair are known well enough, estimate the
+  // reference node once for each query point.
+  double estimate;
+  if (CanPrune(distances, estimate))
+  {
+    for (size_t i = 0; i < queryNode.NumDescendants(); ++i)
+      AddEstimate(queryNode.Descendant(i), referenceNode, estimate);
+    return counters.ScoreResult(DBL_MAX);
+  }
+
+  traversalInfo.LastQueryNode() = &queryNode;
+  traversalInfo.LastReferenceNode() = &referenceNode;
+  return counters.ScoreResult(std::max(distances.Lo(), 0.0));
+}
+
+template<typename MetricType, typename KernelType, typename TreeType>
+double KDERules<MetricType, KernelType, TreeType>::Rescore(
+    TreeType& /* queryNode */,
+    TreeType& /* referenceNode */,
+    const double oldScore) const
+{
+  return oldScore;
+}
+
+template<typename MetricType, typename KernelType, typename TreeType>
+bool KDERules<MetricType, KernelType, TreeType>::CanPrune(
+    const math::Range& distances,
+    double& estimate) const
+{
+  // The kernel does not increase with the distance, so the kernel value of
+  // every pair lies between these bounds.
+  const double maxKernel = kernel.Evaluate(std::max(distances.Lo(), 0.0));
+  const double minKernel = kernel.Evaluate(distances.Hi());
+
+  // The middle of the bounds is off by at most half their width for each pair,
+  // and minKernel is no larger than the true kernel value.
+  if ((maxKernel - minKernel) / 2.0 <= absError + relError * minKernel)
+  {
+    estimate = (maxKernel + minKernel) / 2.0;
+    return true;
+  }
+
+  return false;
+}
+
+template<typename MetricType, typename KernelType, typename TreeType>
+void KDERules<MetricType, KernelType, TreeType>::AddEstimate(
+    const size_t queryIndex,
+    TreeType& referenceNode,
+    const double kernelValue)
+{
+  // Some types of trees calculate the base case evaluation before Score() is
+  // called; that point has already been added to the density.
+  size_t baseCaseMod = 0;
+  if (tree::TreeTraits<TreeType>::FirstPointIsCentroid &&
+      (queryIndex == lastQueryIndex) &&
+      (referenceNode.Point(0) == lastReferenceIndex))
+  {
+    baseCaseMod = 1;
+  }
+
+  densities[queryIndex] += (referenceNode.NumDescendants() - baseCaseMod) *
+      kernelValue;
+}
+
+template<typename MetricType, typename KernelType, typename TreeType>
+bool KDERules<MetricType, KernelType, TreeType>::MonteCarloEstimate(
+    const size_t queryIndex,
+    TreeType& referenceNode)
+{
+  // Monte Carlo estimates can only meet a relative error tolerance, and are
+  // not worth it for small nodes.
+  const size_t numDescendants = referenceNode.NumDescendants();
+  if (relError == 0.0 || initialSampleSize < 2 ||
+      numDescendants < mcEntryCoef * initialSampleSize)
+    return false;
+
+  std::uniform_int_distribution<size_t> dist(0, numDescendants - 1);
+  const double maxSamples = mcBreakCoef * numDescendants;
+
+  double sum = 0.0;
+  double sumSquares = 0.0;
+  size_t taken = 0;
+  size_t toTake = initialSampleSize;
+  while (true)
+  {
+    for (; taken < toTake; ++taken)
+    {
+      const size_t referenceIndex = referenceNode.Descendant(dist(generator));
+      const double value = kernel.Evaluate(metric.Evaluate(
+          querySet.unsafe_col(queryIndex),
+          referenceSet.unsafe_col(referenceIndex)));
+      sum += value;
+      sumSquares += value * value;
+    }
+
+    // Without a positive mean, no number of samples can bound the relative
+    // error.
+    const double mean = sum / taken;
+    if (mean <= 0.0)
+      return false;
+
+    const double variance = std::max(
+        (sumSquares - taken * mean * mean) / (taken - 1), 0.0);
+
+    // Number of samples needed for the standard error of the mean, times the
+    // quantile, to be within the relative error tolerance.
+    const double zError = mcQuantile / (relError * mean);
+    const double required = std::ceil(zError * zError * variance);
+
+    if (required <= taken)
+    {
+      AddEstimate(queryIndex, referenceNode, mean);
+      return true;
+    }
+
+    // Give up if the estimate needs too large a fraction of the node.
+    if (required > maxSamples)
+      return false;
+
+    toTake = (size_t) required;
+  }
+}
+
+} // namespace kde
+} // namespace mlpack
+
+#endif
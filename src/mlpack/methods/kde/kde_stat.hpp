@@ -0,0 +1,61 @@
+/**
+ * @file kde_stat.hpp
+ *
+ * Statistic for kernel density estimation with trees.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KDE_KDE_STAT_HPP
+#define MLPACK_METHODS_KDE_KDE_STAT_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace kde {
+
+/**
+ * Statistic class for KDE, to be set to the StatisticType of the tree type
+ * that kernel density estimation is performed with.  This class just holds the
+ * last distance evaluation with the first point of the node, which trees with
+ * self-children reuse in single-tree mode.
+ */
+class KDEStat
+{
+ public:
+  /**
+   * Initialize the statistic.
+   */
+  KDEStat() : lastDistance(0.0) { }
+
+  /**
+   * Initialize the statistic given a tree node that this statistic belongs to.
+   * In this case, we ignore the node.
+   */
+  template<typename TreeType>
+  KDEStat(TreeType& /* node */) :
+      lastDistance(0.0) { }
+
+  //! Get the last distance evaluation.
+  double LastDistance() const { return lastDistance; }
+  //! Modify the last distance evaluation.
+  double& LastDistance() { return lastDistance; }
+
+  //! Serialize the statistic.
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */)
+  {
+    ar & BOOST_SERIALIZATION_NVP(lastDistance);
+  }
+
+ private:
+  //! The last distance evaluation.
+  double lastDistance;
+};
+
+} // namespace kde
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,67 @@
+/**
+ * @file kernel_normalizer.hpp
+ *
+ * Normalization of kernel density estimates, for the kernels that have a
+ * normalization constant.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KDE_KERNEL_NORMALIZER_HPP
+#define MLPACK_METHODS_KDE_KERNEL_NORMALIZER_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/kernels/gaussian_kernel.hpp>
+#include <mlpack/core/kernels/epanechnikov_kernel.hpp>
+#include <mlpack/core/kernels/spherical_kernel.hpp>
+
+namespace mlpack {
+namespace kde {
+
+/**
+ * Divide the given estimates by the normalization constant of the kernel, so
+ * that they are densities.  This overload is used for kernels without a
+ * normalization constant, and leaves the estimates as they are.
+ *
+ * @param kernel Kernel the estimates were computed with.
+ * @param dimension Dimensionality of the data.
+ * @param estimations Estimates to normalize.
+ */
+template<typename KernelType>
+void ApplyNormalizer(KernelType& /* kernel */,
+                     const size_t /* dimension */,
+                     arma::vec& /* estimations */)
+{
+  // Nothing to do.
+}
+
+//! Normalize estimates computed with the Gaussian kernel.
+inline void ApplyNormalizer(kernel::GaussianKernel& kernel,
+                            const size_t dimension,
+                            arma::vec& estimations)
+{
+  estimations /= kernel.Normalizer(dimension);
+}
+
+//! Normalize estimates computed with the Epanechnikov kernel.
+inline void ApplyNormalizer(kernel::EpanechnikovKernel& kernel,
+                            const size_t dimension,
+                            arma::vec& estimations)
+{
+  estimations /= kernel.Normalizer(dimension);
+}
+
+//! Normalize estimates computed with the spherical kernel.
+inline void ApplyNormalizer(kernel::SphericalKernel& kernel,
+                            const size_t dimension,
+                            arma::vec& estimations)
+{
+  estimations /= kernel.Normalizer(dimension);
+}
+
+} // namespace kde
+} // namespace mlpack
+
+#endif
@@ -16,6 +16,7 @@
 
 #include <mlpack/prereqs.hpp>
 #include <mlpack/methods/kernel_pca/kernel_rules/naive_method.hpp>
+#include <mlpack/methods/kernel_pca/kernel_rules/randomized_method.hpp>
 
 namespace mlpack {
 namespace kpca {
@@ -32,6 +33,16 @@ namespace kpca {
  * There are numerous available kernels in the mlpack::kernel namespace (see
  * files in mlpack/core/kernels/) and it is easy to write your own; see other
  * implementations for examples.
+ *
+ * The KernelRule decides how the eigenvectors of the kernel matrix are found:
+ * NaiveKernelRule builds the whole kernel matrix and decomposes it exactly,
+ * RandomizedKernelRule finds only the top eigenvectors without storing the
+ * kernel matrix, and NystroemKernelRule approximates the kernel matrix.
+ *
+ * After Apply(), the reference points, the kept eigenvectors and the means of
+ * the kernel matrix are stored, so that new points can be projected onto the
+ * same components with Transform() (this isn't possible with
+ * NystroemKernelRule).
  */
 template <
   typename KernelType,
@@ -106,6 +117,21 @@ class KernelPCA
    */
   void Apply(arma::mat& data, const size_t newDimension);
 
+  /**
+   * Project new points onto the kernel principal components found by the last
+   * call to Apply(), without recomputing them.  Only the kernel values between
+   * the new points and the reference points are computed, one block of new
+   * points at a time.  The transformed points have as many dimensions as were
+   * kept by Apply().  If CenterTransformedData() is set, the mean of the
+   * transformed reference points is subtracted.
+   *
+   * @param points Points to project.
+   * @param transformedPoints Matrix to store the projected points in.
+   * @throw std::logic_error if Apply() wasn't called or the KernelRule does
+   *     not support projecting new points.
+   */
+  void Transform(const arma::mat& points, arma::mat& transformedPoints) const;
+
   //! Get the kernel.
   const KernelType& Kernel() const { return kernel; }
   //! Modify the kernel.
@@ -122,6 +148,15 @@ class KernelPCA
   //! If true, the data will be scaled (by standard deviation) when Apply() is
   //! run.
   bool centerTransformedData;
+
+  //! The reference points of the last call to Apply().
+  arma::mat referenceData;
+  //! The means of the columns of the kernel matrix of the reference points.
+  arma::rowvec kernelMeans;
+  //! The kept eigenvectors, each divided by the square root of its eigenvalue.
+  arma::mat projection;
+  //! The mean of the transformed reference points.
+  arma::vec transformedMean;
 }; // class KernelPCA
 
 } // namespace kpca
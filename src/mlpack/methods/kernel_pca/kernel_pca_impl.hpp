@@ -35,18 +35,80 @@ void KernelPCA<KernelType, KernelRule>::Apply(const arma::mat& data,
                                   arma::mat& eigvec,
                                   const size_t newDimension)
 {
+  // The data may be modified in-place, so keep the reference points first.
+  referenceData = data;
+
   KernelRule::ApplyKernelMatrix(data, transformedData, eigval,
-                                eigvec, newDimension, kernel);
+                                eigvec, newDimension, kernelMeans, kernel);
+
+  // Keep what is needed to project new points with Transform().
+  const size_t dimension = (newDimension == 0) ? eigvec.n_cols :
+      std::min(newDimension, (size_t) eigvec.n_cols);
+  arma::colvec transformedDataMean = arma::mean(transformedData, 1);
+  if (kernelMeans.n_elem == referenceData.n_cols &&
+      eigvec.n_rows == referenceData.n_cols && dimension > 0)
+  {
+    projection = eigvec.cols(0, dimension - 1);
+    projection.each_row() /= arma::sqrt(eigval.subvec(0, dimension - 1)).t();
+    transformedMean = transformedDataMean.subvec(0, dimension - 1);
+  }
+  else
+  {
+    referenceData.reset();
+    kernelMeans.reset();
+    projection.reset();
+    transformedMean.reset();
+  }
 
   // Center the transformed data, if the user asked for it.
   if (centerTransformedData)
   {
-    arma::colvec transformedDataMean = arma::mean(transformedData, 1);
     transformedData = transformedData - (transformedDataMean *
         arma::ones<arma::rowvec>(transformedData.n_cols));
   }
 }
 
+//! Project new points onto the kernel principal components.
+template <typename KernelType, typename KernelRule>
+void KernelPCA<KernelType, KernelRule>::Transform(
+    const arma::mat& points,
+    arma::mat& transformedPoints) const
+{
+  if (kernelMeans.n_elem == 0)
+  {
+    throw std::logic_error("KernelPCA::Transform(): no components to project "
+        "onto; Apply() must be called first, with a KernelRule that supports "
+        "new points");
+  }
+
+  // The kernel values k(x_i, y) are centered like the kernel matrix of the
+  // reference points was: k(x_i, y) - mean_j k(x_j, y) - mean_j k(x_i, x_j) +
+  // mean_{j, l} k(x_j, x_l).
+  const arma::vec referenceOffsets = kernelMeans.t() -
+      arma::mean(kernelMeans);
+
+  // Keep each block of kernel values to about 2^24 elements.
+  const size_t blockSize = std::max((size_t) 1,
+      ((size_t) 1 << 24) / std::max((size_t) referenceData.n_cols, (size_t) 1));
+
+  KernelType blockKernel(kernel);
+  transformedPoints.set_size(projection.n_cols, points.n_cols);
+  arma::mat kernelValues;
+  for (size_t begin = 0; begin < points.n_cols; begin += blockSize)
+  {
+    const size_t end = std::min(begin + blockSize, (size_t) points.n_cols);
+    const arma::mat block = points.cols(begin, end - 1);
+    kernel::KernelMatrix(blockKernel, referenceData, block, kernelValues);
+
+    kernelValues.each_row() -= arma::mean(kernelValues, 0);
+    kernelValues.each_col() -= referenceOffsets;
+    transformedPoints.cols(begin, end - 1) = projection.t() * kernelValues;
+  }
+
+  if (centerTransformedData)
+    transformedPoints.each_col() -= transformedMean;
+}
+
 //! Apply Kernel Principal Component Analysis to the provided data set.
 template <typename KernelType, typename KernelRule>
 void KernelPCA<KernelType, KernelRule>::Apply(const arma::mat& data,
@@ -93,7 +93,13 @@ PROGRAM_INFO("Kernel Principal Components Analysis",
     "the kernel matrix; to specify the sampling scheme, the " +
     PRINT_PARAM_STRING("sampling") + " parameter is used.  The "
     "sampling scheme for the Nystr\u00F6m method can be chosen from the "
-    "following list: 'kmeans', 'random', 'ordered'.");
+    "following list: 'kmeans', 'random', 'ordered'."
+    "\n\n"
+    "Alternatively, if " + PRINT_PARAM_STRING("randomized") + " is specified, "
+    "only the top " + PRINT_PARAM_STRING("new_dimensionality") + " kernel "
+    "principal components are found with a randomized SVD, and the kernel "
+    "matrix is computed in blocks instead of being stored; this needs much "
+    "less memory and time for large datasets.");
 
 PARAM_MATRIX_IN_REQ("input", "Input dataset to perform KPCA on.", "i");
 PARAM_MATRIX_OUT("output", "Matrix to save modified dataset to.", "o");
@@ -108,6 +114,8 @@ PARAM_FLAG("center", "If set, the transformed data will be centered about the "
     "origin.", "c");
 
 PARAM_FLAG("nystroem_method", "If set, the nystroem method will be used.", "n");
+PARAM_FLAG("randomized", "If set, the top kernel principal components will be "
+    "found with a randomized SVD, without storing the kernel matrix.", "r");
 
 PARAM_STRING_IN("sampling", "Sampling scheme to use for the nystroem method: "
     "'kmeans', 'random', 'ordered'", "s", "kmeans");
@@ -125,6 +133,7 @@ template<typename KernelType>
 void RunKPCA(arma::mat& dataset,
              const bool centerTransformedData,
              const bool nystroem,
+             const bool randomized,
              const size_t newDim,
              const string& sampling,
              KernelType& kernel)
@@ -157,6 +166,12 @@ void RunKPCA(arma::mat& dataset,
         << "choices are 'kmeans', 'random' and 'ordered'" << endl;
     }
   }
+  else if (randomized)
+  {
+    KernelPCA<KernelType, RandomizedKernelRule<KernelType> > kpca(kernel,
+        centerTransformedData);
+    kpca.Apply(dataset, newDim);
+  }
   else
   {
     KernelPCA<KernelType> kpca(kernel, centerTransformedData);
@@ -193,21 +208,28 @@ void mlpackMain()
 
   const bool centerTransformedData = CLI::HasParam("center");
   const bool nystroem = CLI::HasParam("nystroem_method");
+  const bool randomized = CLI::HasParam("randomized");
+  if (nystroem && randomized)
+  {
+    Log::Fatal << "Can only pass one of "
+        << PRINT_PARAM_STRING("nystroem_method") << " or "
+        << PRINT_PARAM_STRING("randomized") << "!" << endl;
+  }
   const string sampling = CLI::GetParam<string>("sampling");
 
   if (kernelType == "linear")
   {
     LinearKernel kernel;
-    RunKPCA<LinearKernel>(dataset, centerTransformedData, nystroem, newDim,
-        sampling, kernel);
+    RunKPCA<LinearKernel>(dataset, centerTransformedData, nystroem,
+        randomized, newDim, sampling, kernel);
   }
   else if (kernelType == "gaussian")
   {
     const double bandwidth = CLI::GetParam<double>("bandwidth");
 
     GaussianKernel kernel(bandwidth);
-    RunKPCA<GaussianKernel>(dataset, centerTransformedData, nystroem, newDim,
-        sampling, kernel);
+    RunKPCA<GaussianKernel>(dataset, centerTransformedData, nystroem,
+        randomized, newDim, sampling, kernel);
   }
   else if (kernelType == "polynomial")
   {
@@ -216,7 +238,7 @@ void mlpackMain()
 
     PolynomialKernel kernel(degree, offset);
     RunKPCA<PolynomialKernel>(dataset, centerTransformedData, nystroem,
-        newDim, sampling, kernel);
+        randomized, newDim, sampling, kernel);
   }
   else if (kernelType == "hyptan")
   {
@@ -225,15 +247,15 @@ void mlpackMain()
 
     HyperbolicTangentKernel kernel(scale, offset);
     RunKPCA<HyperbolicTangentKernel>(dataset, centerTransformedData, nystroem,
-        newDim, sampling, kernel);
+        randomized, newDim, sampling, kernel);
   }
   else if (kernelType == "laplacian")
   {
     const double bandwidth = CLI::GetParam<double>("bandwidth");
 
     LaplacianKernel kernel(bandwidth);
-    RunKPCA<LaplacianKernel>(dataset, centerTransformedData, nystroem, newDim,
-        sampling, kernel);
+    RunKPCA<LaplacianKernel>(dataset, centerTransformedData, nystroem,
+        randomized, newDim, sampling, kernel);
   }
   else if (kernelType == "epanechnikov")
   {
@@ -241,13 +263,13 @@ void mlpackMain()
 
     EpanechnikovKernel kernel(bandwidth);
     RunKPCA<EpanechnikovKernel>(dataset, centerTransformedData, nystroem,
-        newDim, sampling, kernel);
+        randomized, newDim, sampling, kernel);
   }
   else if (kernelType == "cosine")
   {
     CosineDistance kernel;
-    RunKPCA<CosineDistance>(dataset, centerTransformedData, nystroem, newDim,
-        sampling, kernel);
+    RunKPCA<CosineDistance>(dataset, centerTransformedData, nystroem,
+        randomized, newDim, sampling, kernel);
   }
 
   // Save the output dataset.
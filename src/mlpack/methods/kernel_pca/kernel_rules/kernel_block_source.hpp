@@ -0,0 +1,113 @@
+/**
+ * @file kernel_block_source.hpp
+ *
+ * A column block source for the block-streaming RandomizedSVD that computes
+ * blocks of the kernel matrix on demand, so that it never has to be stored.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KERNEL_PCA_KERNEL_RULES_KERNEL_BLOCK_SOURCE_HPP
+#define MLPACK_METHODS_KERNEL_PCA_KERNEL_RULES_KERNEL_BLOCK_SOURCE_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/kernels/kernel_matrix.hpp>
+
+namespace mlpack {
+namespace kpca {
+
+/**
+ * This class serves consecutive blocks of columns of the kernel matrix K of a
+ * dataset, with the mean of each column subtracted (that is, blocks of H K,
+ * where H = I - 1 1^T / n is the centering matrix).  RandomizedSVD subtracts
+ * the mean of the rows of what it reads, so it decomposes H K H, the centered
+ * kernel matrix used by kernel PCA.  See svd::BinaryFileBlockSource for the
+ * block source API.
+ *
+ * Each block is computed with kernel::KernelMatrix() when it is requested, so
+ * only one block of n x BlockSize() values is stored at a time.  The means of
+ * the columns of K are saved as the blocks are served; after one full pass,
+ * they are available with KernelMeans().
+ *
+ * @tparam KernelType Type of kernel.
+ */
+template<typename KernelType>
+class KernelBlockSource
+{
+ public:
+  /**
+   * Create the block source.  The dataset and the kernel are not copied, so
+   * they must stay alive while the source is used.
+   *
+   * @param data Dataset to compute the kernel matrix of.
+   * @param kernel Kernel to use.
+   * @param blockSize Number of columns in each block.
+   */
+  KernelBlockSource(const arma::mat& data,
+                    KernelType& kernel,
+                    const size_t blockSize) :
+      data(data),
+      kernel(kernel),
+      blockSize(std::max(blockSize, (size_t) 1)),
+      position(0),
+      kernelMeans(data.n_cols, arma::fill::zeros)
+  {
+    // Nothing to do.
+  }
+
+  //! Get the number of rows of the kernel matrix.
+  size_t NumRows() const { return data.n_cols; }
+  //! Get the number of columns of the kernel matrix.
+  size_t NumCols() const { return data.n_cols; }
+
+  //! Start a new pass over the columns.
+  void Reset() { position = 0; }
+
+  /**
+   * Compute the next block of columns of H K.  Returns false when the pass is
+   * over.
+   *
+   * @param block Matrix to store the block in.
+   */
+  bool NextBlock(arma::mat& block)
+  {
+    if (position >= data.n_cols)
+      return false;
+
+    const size_t end = std::min(position + blockSize, (size_t) data.n_cols);
+    const arma::mat points = data.cols(position, end - 1);
+    kernel::KernelMatrix(kernel, data, points, block);
+
+    const arma::rowvec means = arma::mean(block, 0);
+    kernelMeans.subvec(position, end - 1) = means;
+    block.each_row() -= means;
+
+    position = end;
+    return true;
+  }
+
+  //! Get the number of columns in each block.
+  size_t BlockSize() const { return blockSize; }
+
+  //! Get the means of the columns of the (uncentered) kernel matrix.
+  const arma::rowvec& KernelMeans() const { return kernelMeans; }
+
+ private:
+  //! The dataset.
+  const arma::mat& data;
+  //! The kernel.
+  KernelType& kernel;
+  //! Number of columns in each block.
+  size_t blockSize;
+  //! First column of the next block.
+  size_t position;
+  //! The means of the columns of the kernel matrix.
+  arma::rowvec kernelMeans;
+};
+
+} // namespace kpca
+} // namespace mlpack
+
+#endif
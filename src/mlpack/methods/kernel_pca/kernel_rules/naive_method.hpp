@@ -14,6 +14,7 @@
 #define MLPACK_METHODS_KERNEL_PCA_NAIVE_METHOD_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/core/kernels/kernel_matrix.hpp>
 
 namespace mlpack {
 namespace kpca {
@@ -36,31 +37,41 @@ class NaiveKernelRule
                                 arma::mat& transformedData,
                                 arma::vec& eigval,
                                 arma::mat& eigvec,
-                                const size_t /* unused */,
+                                const size_t rank,
                                 KernelType kernel = KernelType())
-{
-  // Construct the kernel matrix.
-  arma::mat kernelMatrix;
-  // Resize the kernel matrix to the right size.
-  kernelMatrix.set_size(data.n_cols, data.n_cols);
-
-  // Note that we only need to calculate the upper triangular part of the
-  // kernel matrix, since it is symmetric. This helps minimize the number of
-  // kernel evaluations.
-  for (size_t i = 0; i < data.n_cols; ++i)
   {
-    for (size_t j = i; j < data.n_cols; ++j)
-    {
-      // Evaluate the kernel on these two points.
-      kernelMatrix(i, j) = kernel.Evaluate(data.unsafe_col(i),
-                                           data.unsafe_col(j));
-    }
+    arma::rowvec kernelMeans;
+    ApplyKernelMatrix(data, transformedData, eigval, eigvec, rank,
+        kernelMeans, kernel);
   }
 
-  // Copy to the lower triangular part of the matrix.
-  for (size_t i = 1; i < data.n_cols; ++i)
-    for (size_t j = 0; j < i; ++j)
-      kernelMatrix(i, j) = kernelMatrix(j, i);
+  /**
+   * Construct the exact kernel matrix, and also return the means of the
+   * columns of the (uncentered) kernel matrix, which are needed to project
+   * new points with KernelPCA::Transform().
+   *
+   * @param data Input data points.
+   * @param transformedData Matrix to output results into.
+   * @param eigval KPCA eigenvalues will be written to this vector.
+   * @param eigvec KPCA eigenvectors will be written to this matrix.
+   * @param rank Rank to be used for matrix approximation.
+   * @param kernelMeans Means of the columns of the kernel matrix will be
+   *     written to this vector.
+   * @param kernel Kernel to be used for computation.
+   */
+  static void ApplyKernelMatrix(const arma::mat& data,
+                                arma::mat& transformedData,
+                                arma::vec& eigval,
+                                arma::mat& eigvec,
+                                const size_t /* unused */,
+                                arma::rowvec& kernelMeans,
+                                KernelType kernel = KernelType())
+{
+  // Construct the kernel matrix.  Since it is symmetric, only half of the
+  // kernel evaluations are needed; KernelMatrix() also uses one matrix
+  // multiplication for the kernels that allow it.
+  arma::mat kernelMatrix;
+  kernel::KernelMatrix(kernel, data, kernelMatrix);
 
   // For PCA the data has to be centered, even if the data is centered. But it
   // is not guaranteed that the data, when mapped to the kernel space, is also
@@ -68,6 +79,7 @@ class NaiveKernelRule
   // center the data. So, we perform a "psuedo-centering" using the kernel
   // matrix.
   arma::rowvec rowMean = arma::sum(kernelMatrix, 0) / kernelMatrix.n_cols;
+  kernelMeans = rowMean;
   kernelMatrix.each_col() -= arma::sum(kernelMatrix, 1) / kernelMatrix.n_cols;
   kernelMatrix.each_row() -= rowMean;
   kernelMatrix += arma::sum(rowMean) / kernelMatrix.n_cols;
@@ -51,7 +51,7 @@ class NystroemKernelRule
     transformedData = G.t() * G;
 
     // Center the reconstructed approximation.
-    math::Center(transformedData, transformedData);
+    math::CenterInPlace(transformedData);
 
     // For PCA the data has to be centered, even if the data is centered. But
     // it is not guaranteed that the data, when mapped to the kernel space, is
@@ -76,6 +76,32 @@ class NystroemKernelRule
 
     transformedData = eigvec.t() * G.t();
   }
+
+  /**
+   * Construct the kernel matrix approximation using the nystroem method.  The
+   * approximation is not expressed in terms of the kernel values between the
+   * data points, so new points can't be projected with KernelPCA::Transform()
+   * and kernelMeans is left empty.
+   *
+   * @param data Input data points.
+   * @param transformedData Matrix to output results into.
+   * @param eigval KPCA eigenvalues will be written to this vector.
+   * @param eigvec KPCA eigenvectors will be written to this matrix.
+   * @param rank Rank to be used for matrix approximation.
+   * @param kernelMeans Cleared, since it is not available.
+   * @param kernel Kernel to be used for computation.
+   */
+  static void ApplyKernelMatrix(const arma::mat& data,
+                                arma::mat& transformedData,
+                                arma::vec& eigval,
+                                arma::mat& eigvec,
+                                const size_t rank,
+                                arma::rowvec& kernelMeans,
+                                KernelType kernel = KernelType())
+  {
+    kernelMeans.reset();
+    ApplyKernelMatrix(data, transformedData, eigval, eigvec, rank, kernel);
+  }
 };
 
 } // namespace kpca
@@ -0,0 +1,127 @@
+/**
+ * @file randomized_method.hpp
+ *
+ * Use the randomized SVD to find the top eigenvectors of the centered kernel
+ * matrix, without storing the kernel matrix.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KERNEL_PCA_RANDOMIZED_METHOD_HPP
+#define MLPACK_METHODS_KERNEL_PCA_RANDOMIZED_METHOD_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/methods/randomized_svd/randomized_svd.hpp>
+#include "kernel_block_source.hpp"
+#include "naive_method.hpp"
+
+namespace mlpack {
+namespace kpca {
+
+/**
+ * Compute only the top eigenvectors of the centered kernel matrix with the
+ * block-streaming randomized SVD (Halko, Martinsson and Tropp, 2011).  The
+ * kernel matrix is computed in blocks of columns with KernelBlockSource in
+ * each of the MaxIterations + 2 passes of the randomized SVD, so only
+ * O(n * (rank + Oversampling)) memory is needed (plus one block of the kernel
+ * matrix) and the eigensolver takes O(n^2 * (rank + Oversampling)) time,
+ * instead of the O(n^2) memory and O(n^3) time of NaiveKernelRule.
+ *
+ * The centered kernel matrix is positive semidefinite for positive definite
+ * kernels, so its singular values are its eigenvalues; for other kernels the
+ * eigenvalues with the largest magnitude are found.  If the rank is large
+ * enough that nothing would be saved, NaiveKernelRule is used.
+ *
+ * @tparam KernelType Type of kernel.
+ * @tparam Oversampling Number of extra random directions used to find the
+ *     range of the kernel matrix.
+ * @tparam MaxIterations Number of power iterations of the randomized SVD.
+ */
+template<
+  typename KernelType,
+  size_t Oversampling = 10,
+  size_t MaxIterations = 2
+>
+class RandomizedKernelRule
+{
+ public:
+  /**
+   * Find the top eigenvectors of the kernel matrix with the randomized SVD.
+   *
+   * @param data Input data points.
+   * @param transformedData Matrix to output results into.
+   * @param eigval KPCA eigenvalues will be written to this vector.
+   * @param eigvec KPCA eigenvectors will be written to this matrix.
+   * @param rank Number of eigenvectors to compute.
+   * @param kernel Kernel to be used for computation.
+   */
+  static void ApplyKernelMatrix(const arma::mat& data,
+                                arma::mat& transformedData,
+                                arma::vec& eigval,
+                                arma::mat& eigvec,
+                                const size_t rank,
+                                KernelType kernel = KernelType())
+  {
+    arma::rowvec kernelMeans;
+    ApplyKernelMatrix(data, transformedData, eigval, eigvec, rank,
+        kernelMeans, kernel);
+  }
+
+  /**
+   * Find the top eigenvectors of the kernel matrix with the randomized SVD,
+   * and also return the means of the columns of the (uncentered) kernel
+   * matrix, which are needed to project new points with
+   * KernelPCA::Transform().
+   *
+   * @param data Input data points.
+   * @param transformedData Matrix to output results into.
+   * @param eigval KPCA eigenvalues will be written to this vector.
+   * @param eigvec KPCA eigenvectors will be written to this matrix.
+   * @param rank Number of eigenvectors to compute.
+   * @param kernelMeans Means of the columns of the kernel matrix will be
+   *     written to this vector.
+   * @param kernel Kernel to be used for computation.
+   */
+  static void ApplyKernelMatrix(const arma::mat& data,
+                                arma::mat& transformedData,
+                                arma::vec& eigval,
+                                arma::mat& eigvec,
+                                const size_t rank,
+                                arma::rowvec& kernelMeans,
+                                KernelType kernel = KernelType())
+  {
+    const size_t n = data.n_cols;
+    if (rank == 0 || rank + Oversampling >= n)
+    {
+      NaiveKernelRule<KernelType>::ApplyKernelMatrix(data, transformedData,
+          eigval, eigvec, rank, kernelMeans, kernel);
+      return;
+    }
+
+    // Keep each block of the kernel matrix to about 2^24 elements.
+    const size_t blockSize = std::max((size_t) 1,
+        std::min(n, ((size_t) 1 << 24) / n));
+    KernelBlockSource<KernelType> source(data, kernel, blockSize);
+
+    arma::mat u;
+    arma::vec s;
+    svd::RandomizedSVD rsvd(rank + Oversampling, MaxIterations);
+    rsvd.Apply(source, u, s, rank);
+
+    eigval = s.subvec(0, rank - 1);
+    eigvec = u.cols(0, rank - 1);
+    kernelMeans = source.KernelMeans();
+
+    // Since eigvec^T K = diag(eigval) eigvec^T, the projection
+    // eigvec^T K / sqrt(eigval) of NaiveKernelRule is sqrt(eigval) eigvec^T.
+    transformedData = eigvec.t();
+    transformedData.each_col() %= arma::sqrt(eigval);
+  }
+};
+
+} // namespace kpca
+} // namespace mlpack
+
+#endif
@@ -166,6 +166,7 @@ double DualTreeKMeans<MetricType, MatType, TreeType>::Iterate(
   tree->Stat().Pruned() = 0;
   traverser.Traverse(*tree, nns.ReferenceTree());
   distanceCalculations += rules.BaseCases() + rules.Scores();
+  rules.Counters().Report();
 
   Timer::Start("tree_mod");
   DecoalesceTree(*tree);
@@ -14,6 +14,7 @@
 #ifndef MLPACK_METHODS_KMEANS_DUAL_TREE_KMEANS_RULES_HPP
 #define MLPACK_METHODS_KMEANS_DUAL_TREE_KMEANS_RULES_HPP
 
+#include <mlpack/core/tree/traversal_counters.hpp>
 #include <mlpack/core/tree/traversal_info.hpp>
 
 namespace mlpack {
@@ -49,11 +50,14 @@ class DualTreeKMeansRules
   TraversalInfoType& TraversalInfo() { return traversalInfo; }
   const TraversalInfoType& TraversalInfo() const { return traversalInfo; }
 
-  size_t BaseCases() const { return baseCases; }
-  size_t& BaseCases() { return baseCases; }
+  size_t BaseCases() const { return counters.BaseCases(); }
+  size_t& BaseCases() { return counters.BaseCases(); }
 
-  size_t Scores() const { return scores; }
-  size_t& Scores() { return scores; }
+  size_t Scores() const { return counters.Scores(); }
+  size_t& Scores() { return counters.Scores(); }
+
+  const tree::TraversalCounters& Counters() const { return counters; }
+  tree::TraversalCounters& Counters() { return counters; }
 
  private:
   const arma::mat& centroids;
@@ -69,8 +73,7 @@ class DualTreeKMeansRules
 
   std::vector<bool>& visited;
 
-  size_t baseCases;
-  size_t scores;
+  tree::TraversalCounters counters;
 
   TraversalInfoType traversalInfo;
 
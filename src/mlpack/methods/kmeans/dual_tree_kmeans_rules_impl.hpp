@@ -37,8 +37,6 @@ DualTreeKMeansRules<MetricType, TreeType>::DualTreeKMeansRules(
     prunedPoints(prunedPoints),
     oldFromNewCentroids(oldFromNewCentroids),
     visited(visited),
-    baseCases(0),
-    scores(0),
     lastQueryIndex(dataset.n_cols),
     lastReferenceIndex(centroids.n_cols)
 {
@@ -65,7 +63,7 @@ inline force_inline double DualTreeKMeansRules<MetricType, TreeType>::BaseCase(
   visited[queryIndex] = true;
 
   // Calculate the distance.
-  ++baseCases;
+  counters.BaseCase();
   const double distance = metric.Evaluate(dataset.col(queryIndex),
                                           centroids.col(referenceIndex));
 
@@ -96,11 +94,11 @@ inline double DualTreeKMeansRules<MetricType, TreeType>::Score(
 {
   // If the query point has already been pruned, then don't recurse further.
   if (prunedPoints[queryIndex])
-    return DBL_MAX;
+    return counters.ScoreResult(DBL_MAX);
 
   // No pruning at this level; we're not likely to encounter a single query
   // point with a reference node..
-  return 0;
+  return counters.ScoreResult(0);
 }
 
 template<typename MetricType, typename TreeType>
@@ -109,7 +107,7 @@ inline double DualTreeKMeansRules<MetricType, TreeType>::Score(
     TreeType& referenceNode)
 {
   if (queryNode.Stat().StaticPruned() == true)
-    return DBL_MAX;
+    return counters.ScoreResult(DBL_MAX);
 
   // Pruned() for the root node must never be set to size_t(-1).
   if (queryNode.Stat().Pruned() == size_t(-1))
@@ -120,7 +118,7 @@ inline double DualTreeKMeansRules<MetricType, TreeType>::Score(
   }
 
   if (queryNode.Stat().Pruned() == centroids.n_cols)
-    return DBL_MAX;
+    return counters.ScoreResult(DBL_MAX);
 
   // This looks a lot like the hackery used in NeighborSearchRules to avoid
   // distance computations.  We'll use the traversal info to see if a
@@ -222,7 +220,7 @@ inline double DualTreeKMeansRules<MetricType, TreeType>::Score(
         // If this might affect the lower bound, make it more exact.
         queryNode.Stat().LowerBound() = std::min(queryNode.Stat().LowerBound(),
             queryNode.MinDistance(referenceNode));
-        ++scores;
+        counters.Score();
       }
 
       queryNode.Stat().Pruned() += referenceNode.NumDescendants();
@@ -236,7 +234,7 @@ inline double DualTreeKMeansRules<MetricType, TreeType>::Score(
     const math::Range distances = queryNode.RangeDistance(referenceNode);
 
     score = distances.Lo();
-    ++scores;
+    counters.Score();
     if (distances.Lo() > queryNode.Stat().UpperBound())
     {
       // The reference node can own no points in this query node.  We may
@@ -254,7 +252,7 @@ inline double DualTreeKMeansRules<MetricType, TreeType>::Score(
       // Tighten upper bound.
       const double tighterBound =
           queryNode.MaxDistance(centroids.col(referenceNode.Descendant(0)));
-      ++scores; // Count extra distance calculation.
+      counters.Score(); // Count extra distance calculation.
 
       if (tighterBound <= queryNode.Stat().UpperBound())
       {
@@ -278,7 +276,7 @@ inline double DualTreeKMeansRules<MetricType, TreeType>::Score(
   if (queryNode.Stat().Pruned() == centroids.n_cols - 1)
   {
     queryNode.Stat().Pruned() = centroids.n_cols; // Owner() is already set.
-    return DBL_MAX;
+    return counters.ScoreResult(DBL_MAX);
   }
 
 
@@ -287,7 +285,7 @@ inline double DualTreeKMeansRules<MetricType, TreeType>::Score(
   traversalInfo.LastReferenceNode() = &referenceNode;
   traversalInfo.LastScore() = score;
 
-  return score;
+  return counters.ScoreResult(score);
 }
 
 template<typename MetricType, typename TreeType>
@@ -320,14 +318,14 @@ inline double DualTreeKMeansRules<MetricType, TreeType>::Rescore(
 
     // This assumes that reference clusters don't appear elsewhere in the tree.
     queryNode.Stat().Pruned() += referenceNode.NumDescendants();
-    return DBL_MAX;
+    return counters.RescoreResult(oldScore, DBL_MAX);
   }
 
   // Also, check if everything has been pruned.
   if (queryNode.Stat().Pruned() == centroids.n_cols - 1)
   {
     queryNode.Stat().Pruned() = centroids.n_cols; // Owner() is already set.
-    return DBL_MAX;
+    return counters.RescoreResult(oldScore, DBL_MAX);
   }
 
   return oldScore;
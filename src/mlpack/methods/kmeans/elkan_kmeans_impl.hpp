@@ -46,9 +46,6 @@ double ElkanKMeans<MetricType, MatType>::Iterate(const arma::mat& centroids,
   // being the closest cluster centroid.
   clusterDistances.diag().fill(DBL_MAX);
 
-  // Initially set r(x) to true.
-  std::vector<bool> mustRecalculate(dataset.n_cols, true);
-
   // If this is the first iteration, we must reset all the bounds.
   if (lowerBounds.n_rows != centroids.n_cols)
   {
@@ -62,40 +59,56 @@ double ElkanKMeans<MetricType, MatType>::Iterate(const arma::mat& centroids,
   }
 
   // Step 1: for all centers, compute between-cluster distances.  For all
-  // centers, compute s(c) = 1/2 min d(c, c').
-  for (size_t i = 0; i < centroids.n_cols; ++i)
+  // centers, compute s(c) = 1/2 min d(c, c').  The rows get shorter, so they
+  // are scheduled dynamically.
+  size_t centroidDistanceCalculations = 0;
+  #pragma omp parallel for schedule(dynamic) \
+      reduction(+:centroidDistanceCalculations)
+  for (omp_size_t i = 0; i < (omp_size_t) centroids.n_cols; ++i)
   {
     for (size_t j = i + 1; j < centroids.n_cols; ++j)
     {
       const double distance = metric.Evaluate(centroids.col(i),
                                               centroids.col(j));
-      distanceCalculations++;
+      centroidDistanceCalculations++;
       clusterDistances(i, j) = distance;
       clusterDistances(j, i) = distance;
     }
   }
+  distanceCalculations += centroidDistanceCalculations;
 
   // Now find the closest cluster to each other cluster.  We multiply by 0.5 so
   // that this is equivalent to s(c) for each cluster c.
   minClusterDistances = 0.5 * arma::min(clusterDistances).t();
 
-  // Now loop over all points, and see which ones need to be updated.
-  for (size_t i = 0; i < dataset.n_cols; ++i)
+  // Now loop over all points, and see which ones need to be updated.  The
+  // bounds of each point are independent, so the points are split between the
+  // threads, and each thread sums its points into its own centroids.
+  size_t pointDistanceCalculations = 0;
+  #pragma omp parallel reduction(+:pointDistanceCalculations)
   {
-    // Step 2: identify all points such that u(x) <= s(c(x)).
-    if (upperBounds(i) <= minClusterDistances(assignments[i]))
-    {
-      // No change needed.  This point must still belong to that cluster.
-      counts(assignments[i])++;
-      newCentroids.col(assignments[i]) += arma::vec(dataset.col(i));
-      continue;
-    }
-    else
+    arma::mat localCentroids(centroids.n_rows, centroids.n_cols,
+        arma::fill::zeros);
+    arma::Col<size_t> localCounts(centroids.n_cols, arma::fill::zeros);
+
+    #pragma omp for
+    for (omp_size_t i = 0; i < (omp_size_t) dataset.n_cols; ++i)
     {
+      // Step 2: identify all points such that u(x) <= s(c(x)).
+      if (upperBounds(i) <= minClusterDistances(assignments[i]))
+      {
+        // No change needed.  This point must still belong to that cluster.
+        localCounts(assignments[i])++;
+        localCentroids.col(assignments[i]) += arma::vec(dataset.col(i));
+        continue;
+      }
+
+      // r(x) is true at the start of every iteration.
+      bool mustRecalculate = true;
       for (size_t c = 0; c < centroids.n_cols; ++c)
       {
-        // Step 3: for all remaining points x and centers c such that c != c(x),
-        // u(x) > l(x, c) and u(x) > 0.5 d(c(x), c)...
+        // Step 3: for all remaining points x and centers c such that
+        // c != c(x), u(x) > l(x, c) and u(x) > 0.5 d(c(x), c)...
         if (assignments[i] == c)
           continue; // Pruned because this cluster is already the assignment.
 
@@ -108,13 +121,13 @@ double ElkanKMeans<MetricType, MatType>::Iterate(const arma::mat& centroids,
         // Step 3a: if r(x) then compute d(x, c(x)) and assign r(x) = false.
         // Otherwise, d(x, c(x)) = u(x).
         double dist;
-        if (mustRecalculate[i])
+        if (mustRecalculate)
         {
-          mustRecalculate[i] = false;
+          mustRecalculate = false;
           dist = metric.Evaluate(dataset.col(i), centroids.col(assignments[i]));
           lowerBounds(assignments[i], i) = dist;
           upperBounds(i) = dist;
-          distanceCalculations++;
+          pointDistanceCalculations++;
 
           // Check if we can prune again.
           if (upperBounds(i) <= lowerBounds(c, i))
@@ -136,7 +149,7 @@ double ElkanKMeans<MetricType, MatType>::Iterate(const arma::mat& centroids,
           const double pointDist = metric.Evaluate(dataset.col(i),
                                                    centroids.col(c));
           lowerBounds(c, i) = pointDist;
-          distanceCalculations++;
+          pointDistanceCalculations++;
           if (pointDist < dist)
           {
             upperBounds(i) = pointDist;
@@ -144,14 +157,22 @@ double ElkanKMeans<MetricType, MatType>::Iterate(const arma::mat& centroids,
           }
         }
       }
+
+      // At this point, we know the new cluster assignment.
+      // Step 4: for each center c, let m(c) be the mean of the points assigned
+      // to c.
+      localCentroids.col(assignments[i]) += arma::vec(dataset.col(i));
+      localCounts[assignments[i]]++;
     }
 
-    // At this point, we know the new cluster assignment.
-    // Step 4: for each center c, let m(c) be the mean of the points assigned to
-    // c.
-    newCentroids.col(assignments[i]) += arma::vec(dataset.col(i));
-    counts[assignments[i]]++;
+    // Combine the sums of each thread.
+    #pragma omp critical
+    {
+      newCentroids += localCentroids;
+      counts += localCounts;
+    }
   }
+  distanceCalculations += pointDistanceCalculations;
 
   // Now, normalize and calculate the distance each cluster has moved.
   arma::vec moveDistances(centroids.n_cols);
@@ -166,13 +187,13 @@ double ElkanKMeans<MetricType, MatType>::Iterate(const arma::mat& centroids,
     distanceCalculations++;
   }
 
-  for (size_t i = 0; i < dataset.n_cols; ++i)
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) dataset.n_cols; ++i)
   {
     // Step 5: for each point x and center c, assign
     //   l(x, c) = max { l(x, c) - d(c, m(c)), 0 }.
     // But it doesn't actually matter if l(x, c) is positive.
-    for (size_t c = 0; c < centroids.n_cols; ++c)
-      lowerBounds(c, i) -= moveDistances(c);
+    lowerBounds.col(i) -= moveDistances;
 
     // Step 6: for each point x, assign
     //   u(x) = u(x) + d(m(c(x)), c(x))
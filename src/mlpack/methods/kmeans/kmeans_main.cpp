@@ -12,15 +12,19 @@
 #include <mlpack/prereqs.hpp>
 #include <mlpack/core/util/cli.hpp>
 #include <mlpack/core/util/mlpack_main.hpp>
+#include <mlpack/core/data/first_touch.hpp>
 
 #include "kmeans.hpp"
 #include "allow_empty_clusters.hpp"
 #include "kill_empty_clusters.hpp"
 #include "refined_start.hpp"
+#include "kmeans_plus_plus_initialization.hpp"
+#include "kmeans_parallel_initialization.hpp"
 #include "elkan_kmeans.hpp"
 #include "hamerly_kmeans.hpp"
 #include "pelleg_moore_kmeans.hpp"
 #include "dual_tree_kmeans.hpp"
+#include "mini_batch_kmeans.hpp"
 
 using namespace mlpack;
 using namespace mlpack::kmeans;
@@ -43,14 +47,26 @@ PROGRAM_INFO("K-Means Clustering", "This program performs K-Means clustering "
     "used in each sample, the " + PRINT_PARAM_STRING("percentage") +
     " parameter is used (it should be a value between 0.0 and 1.0)."
     "\n\n"
+    "Alternatively, the k-means++ initialization (\"k-means++: The advantages "
+    "of careful seeding\", 2007) can be used by specifying the " +
+    PRINT_PARAM_STRING("kmeans_plus_plus") + " parameter, or its scalable "
+    "variant k-means|| (\"Scalable k-means++\", 2012) by specifying the " +
+    PRINT_PARAM_STRING("kmeans_parallel") + " parameter.  k-means|| samples "
+    "candidate centroids over a number of rounds set with the " +
+    PRINT_PARAM_STRING("rounds") + " parameter, and so needs far fewer passes "
+    "over the data than k-means++ when there are many clusters."
+    "\n\n"
     "There are several options available for the algorithm used for each Lloyd "
     "iteration, specified with the " + PRINT_PARAM_STRING("algorithm") + " "
     " option.  The standard O(kN) approach can be used ('naive').  Other "
     "options include the Pelleg-Moore tree-based algorithm ('pelleg-moore'), "
     "Elkan's triangle-inequality based algorithm ('elkan'), Hamerly's "
     "modification to Elkan's algorithm ('hamerly'), the dual-tree k-means "
-    "algorithm ('dualtree'), and the dual-tree k-means algorithm using the "
-    "cover tree ('dualtree-covertree')."
+    "algorithm ('dualtree'), the dual-tree k-means algorithm using the "
+    "cover tree ('dualtree-covertree'), and mini-batch k-means ('minibatch'), "
+    "which only approximates the Lloyd iteration but updates the centroids "
+    "from a random sample of 1000 points in each iteration, and so is much "
+    "faster on very large datasets."
     "\n\n"
     "The behavior for when an empty cluster is encountered can be modified with"
     " the " + PRINT_PARAM_STRING("allow_empty_clusters") + " option.  When "
@@ -120,9 +136,17 @@ PARAM_INT_IN("samplings", "Number of samplings to perform for refined start "
 PARAM_DOUBLE_IN("percentage", "Percentage of dataset to use for each refined "
     "start sampling (use when --refined_start is specified).", "p", 0.02);
 
+// Parameters for the k-means++ and k-means|| initializations.
+PARAM_FLAG("kmeans_plus_plus", "Use the k-means++ initialization strategy to "
+    "choose initial points.", "K");
+PARAM_FLAG("kmeans_parallel", "Use the k-means|| initialization strategy to "
+    "choose initial points.", "k");
+PARAM_INT_IN("rounds", "Number of sampling rounds for k-means|| (use when "
+    "--kmeans_parallel is specified).", "R", 5);
+
 PARAM_STRING_IN("algorithm", "Algorithm to use for the Lloyd iteration "
-    "('naive', 'pelleg-moore', 'elkan', 'hamerly', 'dualtree', or "
-    "'dualtree-covertree').", "a", "naive");
+    "('naive', 'pelleg-moore', 'elkan', 'hamerly', 'dualtree', "
+    "'dualtree-covertree', or 'minibatch').", "a", "naive");
 
 // Given the type of initial partition policy, figure out the empty cluster
 // policy and run k-means.
@@ -151,6 +175,9 @@ void mlpackMain()
   // Now, start building the KMeans type that we'll be using.  Start with the
   // initial partition policy.  The call to FindEmptyClusterPolicy<> results in
   // a call to RunKMeans<> and the algorithm is completed.
+  RequireOnlyOnePassed({ "refined_start", "kmeans_plus_plus",
+      "kmeans_parallel" }, true);
+
   if (CLI::HasParam("refined_start"))
   {
     RequireParamValue<int>("samplings", [](int x) { return x > 0; }, true,
@@ -163,6 +190,20 @@ void mlpackMain()
 
     FindEmptyClusterPolicy<RefinedStart>(RefinedStart(samplings, percentage));
   }
+  else if (CLI::HasParam("kmeans_plus_plus"))
+  {
+    FindEmptyClusterPolicy<KMeansPlusPlusInitialization>(
+        KMeansPlusPlusInitialization());
+  }
+  else if (CLI::HasParam("kmeans_parallel"))
+  {
+    RequireParamValue<int>("rounds", [](int x) { return x > 0; }, true,
+        "number of rounds must be positive");
+    const int rounds = CLI::GetParam<int>("rounds");
+
+    FindEmptyClusterPolicy<KMeansParallelInitialization>(
+        KMeansParallelInitialization(rounds));
+  }
   else
   {
     FindEmptyClusterPolicy<SampleInitialization>(SampleInitialization());
@@ -190,8 +231,8 @@ template<typename InitialPartitionPolicy, typename EmptyClusterPolicy>
 void FindLloydStepType(const InitialPartitionPolicy& ipp)
 {
   RequireParamInSet<string>("algorithm", { "elkan", "hamerly", "pelleg-moore",
-      "dualtree", "dualtree-covertree", "naive" }, true, "unknown k-means "
-      "algorithm");
+      "dualtree", "dualtree-covertree", "naive", "minibatch" }, true,
+      "unknown k-means algorithm");
 
   const string algorithm = CLI::GetParam<string>("algorithm");
   if (algorithm == "elkan")
@@ -209,6 +250,9 @@ void FindLloydStepType(const InitialPartitionPolicy& ipp)
         CoverTreeDualTreeKMeans>(ipp);
   else if (algorithm == "naive")
     RunKMeans<InitialPartitionPolicy, EmptyClusterPolicy, NaiveKMeans>(ipp);
+  else if (algorithm == "minibatch")
+    RunKMeans<InitialPartitionPolicy, EmptyClusterPolicy,
+        MiniBatchKMeans>(ipp);
 }
 
 // Given the template parameters, sanitize/load input and run k-means.
@@ -243,8 +287,10 @@ void RunKMeans(const InitialPartitionPolicy& ipp)
   RequireAtLeastOnePassed({ "in_place", "output", "centroid" }, false,
       "no results will be saved");
 
-  // Load our dataset.
-  arma::mat dataset = CLI::GetParam<arma::mat>("input");
+  // Load our dataset.  The copy is made in parallel, so that the points of
+  // each thread are in the memory of its NUMA node.
+  arma::mat dataset;
+  data::FirstTouch(CLI::GetParam<arma::mat>("input"), dataset);
   arma::mat centroids;
 
   const bool initialCentroidGuess = CLI::HasParam("initial_centroids");
@@ -256,8 +302,11 @@ void RunKMeans(const InitialPartitionPolicy& ipp)
       clusters = centroids.n_cols;
 
     ReportIgnoredParam({{ "refined_start", true }}, "initial_centroids");
+    ReportIgnoredParam({{ "kmeans_plus_plus", true }}, "initial_centroids");
+    ReportIgnoredParam({{ "kmeans_parallel", true }}, "initial_centroids");
 
-    if (!CLI::HasParam("refined_start"))
+    if (!CLI::HasParam("refined_start") && !CLI::HasParam("kmeans_plus_plus")
+        && !CLI::HasParam("kmeans_parallel"))
       Log::Info << "Using initial centroid guesses." << endl;
   }
 
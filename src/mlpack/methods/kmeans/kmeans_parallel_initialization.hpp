@@ -0,0 +1,107 @@
+/**
+ * @file kmeans_parallel_initialization.hpp
+ *
+ * An implementation of the k-means|| (scalable k-means++) initialization of
+ * Bahmani et al., which oversamples candidate centroids over a few rounds and
+ * then reduces them to the initial centroids.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KMEANS_KMEANS_PARALLEL_INITIALIZATION_HPP
+#define MLPACK_METHODS_KMEANS_KMEANS_PARALLEL_INITIALIZATION_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "kmeans_plus_plus_initialization.hpp"
+
+namespace mlpack {
+namespace kmeans {
+
+/**
+ * The k-means|| initial partition policy.  k-means++ (see
+ * KMeansPlusPlusInitialization) needs k passes over the data, one for each
+ * centroid; k-means|| instead samples about (oversampling * k) candidate
+ * centroids in each of a few rounds, where each point is sampled independently
+ * with a probability proportional to its squared distance to the nearest
+ * candidate.  Each candidate is then weighted by the number of points nearest
+ * to it, and the weighted candidates are reduced to k centroids with
+ * k-means++.  The distances of the points are updated in parallel with OpenMP,
+ * and the quality of the centroids is close to the one of k-means++.
+ *
+ * For more information, see the following paper.
+ *
+ * @code
+ * @article{bahmani2012scalable,
+ *   title={Scalable k-means++},
+ *   author={Bahmani, Bahman and Moseley, Benjamin and Vattani, Andrea and
+ *       Kumar, Ravi and Vassilvitskii, Sergei},
+ *   journal={Proceedings of the VLDB Endowment},
+ *   volume={5},
+ *   number={7},
+ *   pages={622--633},
+ *   year={2012}
+ * }
+ * @endcode
+ */
+class KMeansParallelInitialization
+{
+ public:
+  /**
+   * Create the KMeansParallelInitialization object, optionally specifying the
+   * number of rounds and the oversampling factor.
+   *
+   * @param rounds Number of sampling rounds.
+   * @param oversampling Expected number of candidates sampled in each round,
+   *     as a multiple of the number of clusters.
+   */
+  KMeansParallelInitialization(const size_t rounds = 5,
+                               const double oversampling = 2.0) :
+      rounds(rounds), oversampling(oversampling) { }
+
+  /**
+   * Initialize the centroids matrix with the k-means|| sampling.
+   *
+   * @tparam MatType Type of data (arma::mat or arma::sp_mat).
+   * @param data Dataset.
+   * @param clusters Number of clusters.
+   * @param centroids Matrix to put initial centroids into.
+   */
+  template<typename MatType>
+  void Cluster(const MatType& data,
+               const size_t clusters,
+               arma::mat& centroids);
+
+  //! Get the number of sampling rounds.
+  size_t Rounds() const { return rounds; }
+  //! Modify the number of sampling rounds.
+  size_t& Rounds() { return rounds; }
+
+  //! Get the oversampling factor.
+  double Oversampling() const { return oversampling; }
+  //! Modify the oversampling factor.
+  double& Oversampling() { return oversampling; }
+
+  //! Serialize the object.
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */)
+  {
+    ar & BOOST_SERIALIZATION_NVP(rounds);
+    ar & BOOST_SERIALIZATION_NVP(oversampling);
+  }
+
+ private:
+  //! The number of sampling rounds.
+  size_t rounds;
+  //! The oversampling factor.
+  double oversampling;
+};
+
+} // namespace kmeans
+} // namespace mlpack
+
+// Include implementation.
+#include "kmeans_parallel_initialization_impl.hpp"
+
+#endif
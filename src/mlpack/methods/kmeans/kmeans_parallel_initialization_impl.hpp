@@ -0,0 +1,88 @@
+/**
+ * @file kmeans_parallel_initialization_impl.hpp
+ *
+ * Implementation of the k-means|| initialization.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KMEANS_KMEANS_PARALLEL_INITIALIZATION_IMPL_HPP
+#define MLPACK_METHODS_KMEANS_KMEANS_PARALLEL_INITIALIZATION_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "kmeans_parallel_initialization.hpp"
+
+namespace mlpack {
+namespace kmeans {
+
+template<typename MatType>
+void KMeansParallelInitialization::Cluster(const MatType& data,
+                                           const size_t clusters,
+                                           arma::mat& centroids)
+{
+  arma::vec norms;
+  KMeansPlusPlusInitialization::SquaredNorms(data, norms);
+
+  arma::vec distances(data.n_cols);
+  distances.fill(DBL_MAX);
+  arma::Col<size_t> nearest(data.n_cols);
+
+  // The first candidate is sampled uniformly.
+  arma::mat candidates(data.n_rows, 1);
+  candidates.col(0) = data.col(math::RandInt(0, data.n_cols));
+  KMeansPlusPlusInitialization::UpdateDistances(data, norms, candidates, 0, 1,
+      distances, nearest);
+
+  for (size_t r = 0; r < rounds; ++r)
+  {
+    const double cost = arma::accu(distances);
+    if (!(cost > 0.0))
+      break; // Every point is a candidate already.
+
+    // Sample each point independently with a probability of
+    // (oversampling * k) * d(x)^2 / cost.
+    const arma::vec u = arma::randu<arma::vec>(data.n_cols);
+    const arma::uvec sampled = arma::find(u < (oversampling * clusters / cost) *
+        distances);
+    if (sampled.n_elem == 0)
+      continue;
+
+    const size_t begin = candidates.n_cols;
+    candidates.resize(data.n_rows, begin + sampled.n_elem);
+    for (size_t i = 0; i < sampled.n_elem; ++i)
+      candidates.col(begin + i) = data.col(sampled[i]);
+
+    KMeansPlusPlusInitialization::UpdateDistances(data, norms, candidates,
+        begin, candidates.n_cols, distances, nearest);
+  }
+
+  Log::Info << "KMeansParallelInitialization::Cluster(): sampled "
+      << candidates.n_cols << " candidates." << std::endl;
+
+  if (candidates.n_cols <= clusters)
+  {
+    // There are too few candidates, so take them all, and sample the other
+    // centroids uniformly.
+    centroids.set_size(data.n_rows, clusters);
+    centroids.cols(0, candidates.n_cols - 1) = candidates;
+    for (size_t i = candidates.n_cols; i < clusters; ++i)
+      centroids.col(i) = data.col(math::RandInt(0, data.n_cols));
+    return;
+  }
+
+  // Weight each candidate by the number of points nearest to it, and reduce
+  // the candidates to the centroids with k-means++.
+  arma::vec weights(candidates.n_cols, arma::fill::zeros);
+  for (size_t i = 0; i < data.n_cols; ++i)
+    weights[nearest[i]] += 1.0;
+
+  KMeansPlusPlusInitialization::Cluster(candidates, clusters, centroids,
+      weights);
+}
+
+} // namespace kmeans
+} // namespace mlpack
+
+#endif
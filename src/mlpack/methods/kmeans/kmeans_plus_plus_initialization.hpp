@@ -0,0 +1,185 @@
+/**
+ * @file kmeans_plus_plus_initialization.hpp
+ *
+ * An implementation of the k-means++ initialization of Arthur and
+ * Vassilvitskii, which samples each initial centroid with a probability
+ * proportional to its squared distance to the centroids sampled before it.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KMEANS_KMEANS_PLUS_PLUS_INITIALIZATION_HPP
+#define MLPACK_METHODS_KMEANS_KMEANS_PLUS_PLUS_INITIALIZATION_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/math/random.hpp>
+
+namespace mlpack {
+namespace kmeans {
+
+/**
+ * The k-means++ initial partition policy.  The first centroid is a point of
+ * the dataset sampled uniformly at random, and each next centroid is a point
+ * sampled with a probability proportional to its squared Euclidean distance
+ * to the nearest centroid sampled so far.  This gives initial centroids that
+ * are O(log k)-competitive with the optimal clustering, and usually far fewer
+ * Lloyd iterations than random initial centroids.  The distances of the points
+ * to their nearest centroid are updated in parallel with OpenMP.
+ *
+ * For more information, see the following paper.
+ *
+ * @code
+ * @inproceedings{arthur2007k,
+ *   title={k-means++: The advantages of careful seeding},
+ *   author={Arthur, David and Vassilvitskii, Sergei},
+ *   booktitle={Proceedings of the Eighteenth Annual ACM-SIAM Symposium on
+ *       Discrete Algorithms (SODA '07)},
+ *   pages={1027--1035},
+ *   year={2007}
+ * }
+ * @endcode
+ */
+class KMeansPlusPlusInitialization
+{
+ public:
+  //! Empty constructor, required by the InitialPartitionPolicy type definition.
+  KMeansPlusPlusInitialization() { }
+
+  /**
+   * Initialize the centroids matrix with the k-means++ sampling.
+   *
+   * @param data Dataset.
+   * @param clusters Number of clusters.
+   * @param centroids Matrix to put initial centroids into.
+   */
+  template<typename MatType>
+  inline static void Cluster(const MatType& data,
+                             const size_t clusters,
+                             arma::mat& centroids)
+  {
+    Cluster(data, clusters, centroids, arma::ones<arma::vec>(data.n_cols));
+  }
+
+  /**
+   * Initialize the centroids matrix with the k-means++ sampling of the given
+   * weighted points: each point is sampled with a probability proportional to
+   * its weight times its squared distance to the nearest centroid.
+   *
+   * @param data Dataset.
+   * @param clusters Number of clusters.
+   * @param centroids Matrix to put initial centroids into.
+   * @param weights Weight of each point.
+   */
+  template<typename MatType>
+  inline static void Cluster(const MatType& data,
+                             const size_t clusters,
+                             arma::mat& centroids,
+                             const arma::vec& weights)
+  {
+    centroids.set_size(data.n_rows, clusters);
+    if (clusters == 0)
+      return;
+
+    arma::vec norms;
+    SquaredNorms(data, norms);
+
+    arma::vec distances(data.n_cols);
+    distances.fill(DBL_MAX);
+    arma::Col<size_t> nearest(data.n_cols);
+
+    centroids.col(0) = data.col(Sample(weights));
+    for (size_t c = 1; c < clusters; ++c)
+    {
+      UpdateDistances(data, norms, centroids, c - 1, c, distances, nearest);
+      centroids.col(c) = data.col(Sample(weights % distances));
+    }
+  }
+
+  /**
+   * Compute the squared norm of each point in the dataset, for
+   * UpdateDistances().
+   *
+   * @param data Dataset.
+   * @param norms Vector to store the squared norms in.
+   */
+  template<typename MatType>
+  inline static void SquaredNorms(const MatType& data, arma::vec& norms)
+  {
+    norms.set_size(data.n_cols);
+
+    #pragma omp parallel for
+    for (omp_size_t i = 0; i < (omp_size_t) data.n_cols; ++i)
+      norms[i] = arma::dot(data.col(i), data.col(i));
+  }
+
+  /**
+   * Update the squared distance of each point to its nearest center with the
+   * centers of the given range, in parallel over the points.  The squared
+   * distance is computed as ||x||^2 - 2 x^T c + ||c||^2, so the only work done
+   * on the dimensions of the points is a (vectorized) dot product.
+   *
+   * @param data Dataset.
+   * @param norms Squared norms of the points (see SquaredNorms()).
+   * @param centers Matrix holding the centers.
+   * @param begin Index of the first center to update with.
+   * @param end One past the index of the last center to update with.
+   * @param distances Squared distance of each point to its nearest center; it
+   *     is updated with the given centers.
+   * @param nearest Index of the nearest center of each point; it is updated
+   *     for the points whose nearest center is one of the given centers.
+   */
+  template<typename MatType>
+  inline static void UpdateDistances(const MatType& data,
+                                     const arma::vec& norms,
+                                     const arma::mat& centers,
+                                     const size_t begin,
+                                     const size_t end,
+                                     arma::vec& distances,
+                                     arma::Col<size_t>& nearest)
+  {
+    arma::vec centerNorms(end - begin);
+    for (size_t c = begin; c < end; ++c)
+      centerNorms[c - begin] = arma::dot(centers.col(c), centers.col(c));
+
+    #pragma omp parallel for
+    for (omp_size_t i = 0; i < (omp_size_t) data.n_cols; ++i)
+    {
+      for (size_t c = begin; c < end; ++c)
+      {
+        // Rounding can make the distance slightly negative.
+        const double distance = std::max(norms[i] - 2.0 * arma::dot(
+            data.col(i), centers.unsafe_col(c)) + centerNorms[c - begin], 0.0);
+        if (distance < distances[i])
+        {
+          distances[i] = distance;
+          nearest[i] = c;
+        }
+      }
+    }
+  }
+
+ private:
+  /**
+   * Sample an index with a probability proportional to the given weights.  If
+   * all the weights are zero, the index is sampled uniformly.
+   */
+  inline static size_t Sample(const arma::vec& weights)
+  {
+    const arma::vec cumulative = arma::cumsum(weights);
+    const double total = cumulative[cumulative.n_elem - 1];
+    if (!(total > 0.0))
+      return math::RandInt(0, weights.n_elem);
+
+    const double r = math::Random() * total;
+    const size_t index = std::upper_bound(cumulative.begin(),
+        cumulative.end(), r) - cumulative.begin();
+    return std::min(index, (size_t) weights.n_elem - 1);
+  }
+};
+
+} // namespace kmeans
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,119 @@
+/**
+ * @file mini_batch_kmeans.hpp
+ *
+ * An implementation of mini-batch k-means (Sculley, 2010), which updates the
+ * centroids from a small random sample of the points in each iteration instead
+ * of from the whole dataset.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KMEANS_MINI_BATCH_KMEANS_HPP
+#define MLPACK_METHODS_KMEANS_MINI_BATCH_KMEANS_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace kmeans {
+
+/**
+ * An implementation of mini-batch k-means, for use as the LloydStepType of
+ * KMeans.  Instead of a full Lloyd iteration, each call to Iterate() samples a
+ * batch of points uniformly at random, assigns each of them to its nearest
+ * centroid (in parallel with OpenMP), and then moves each centroid towards its
+ * points with a per-centroid learning rate of 1 / (the number of points the
+ * centroid has been given so far).  So, an iteration costs O(bk) instead of
+ * O(nk), and the result approximates the one of Lloyd's algorithm; since the
+ * centroids keep moving a little, KMeans usually stops at its maximum number
+ * of iterations rather than at convergence.
+ *
+ * The counts returned by Iterate() are the total number of points each
+ * centroid has been given over all the iterations, so that only centroids that
+ * were never given a point are treated as empty clusters.
+ *
+ * The dataset is only accessed through n_cols and col(), one batch at a time,
+ * so Iterate() can be used directly with a MatType that reads its points from
+ * a stream or from disk.  (KMeans itself still makes full passes over the
+ * dataset, to find the initial centroids and the final assignments.)
+ *
+ * For more information, see the following paper.
+ *
+ * @code
+ * @inproceedings{sculley2010web,
+ *   title={Web-scale k-means clustering},
+ *   author={Sculley, D.},
+ *   booktitle={Proceedings of the 19th International Conference on World Wide
+ *       Web (WWW '10)},
+ *   pages={1177--1178},
+ *   year={2010}
+ * }
+ * @endcode
+ *
+ * @tparam MetricType Type of metric used with this implementation.
+ * @tparam MatType Matrix type (arma::mat or arma::sp_mat).
+ */
+template<typename MetricType, typename MatType>
+class MiniBatchKMeans
+{
+ public:
+  /**
+   * Construct the MiniBatchKMeans object with the given dataset, metric, and
+   * batch size.
+   *
+   * @param dataset Dataset.
+   * @param metric Instantiated metric.
+   * @param batchSize Number of points sampled in each iteration.  If it is 0,
+   *     or the dataset has no more points than this, each iteration uses every
+   *     point.
+   */
+  MiniBatchKMeans(const MatType& dataset,
+                  MetricType& metric,
+                  const size_t batchSize = 1000);
+
+  /**
+   * Run a single iteration of mini-batch k-means, updating the given centroids
+   * into the newCentroids matrix.
+   *
+   * @param centroids Current cluster centroids.
+   * @param newCentroids New cluster centroids.
+   * @param counts Number of points given to each cluster over all the
+   *     iterations so far.
+   * @return The norm of the change of the centroids.
+   */
+  double Iterate(const arma::mat& centroids,
+                 arma::mat& newCentroids,
+                 arma::Col<size_t>& counts);
+
+  //! Get the number of distance calculations.
+  size_t DistanceCalculations() const { return distanceCalculations; }
+
+  //! Get the number of points sampled in each iteration.
+  size_t BatchSize() const { return batchSize; }
+  //! Modify the number of points sampled in each iteration.
+  size_t& BatchSize() { return batchSize; }
+
+ private:
+  //! The dataset.
+  const MatType& dataset;
+  //! The instantiated metric.
+  MetricType& metric;
+
+  //! The number of points sampled in each iteration.
+  size_t batchSize;
+
+  //! The number of points given to each centroid so far.
+  arma::Col<size_t> totalCounts;
+
+  //! Number of distance calculations.
+  size_t distanceCalculations;
+};
+
+} // namespace kmeans
+} // namespace mlpack
+
+// Include implementation.
+#include "mini_batch_kmeans_impl.hpp"
+
+#endif
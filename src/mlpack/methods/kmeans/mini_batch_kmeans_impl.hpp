@@ -0,0 +1,101 @@
+/**
+ * @file mini_batch_kmeans_impl.hpp
+ *
+ * Implementation of mini-batch k-means.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KMEANS_MINI_BATCH_KMEANS_IMPL_HPP
+#define MLPACK_METHODS_KMEANS_MINI_BATCH_KMEANS_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "mini_batch_kmeans.hpp"
+
+namespace mlpack {
+namespace kmeans {
+
+template<typename MetricType, typename MatType>
+MiniBatchKMeans<MetricType, MatType>::MiniBatchKMeans(const MatType& dataset,
+                                                      MetricType& metric,
+                                                      const size_t batchSize) :
+    dataset(dataset),
+    metric(metric),
+    batchSize(batchSize),
+    distanceCalculations(0)
+{ /* Nothing to do. */ }
+
+// Run a single iteration.
+template<typename MetricType, typename MatType>
+double MiniBatchKMeans<MetricType, MatType>::Iterate(
+    const arma::mat& centroids,
+    arma::mat& newCentroids,
+    arma::Col<size_t>& counts)
+{
+  if (totalCounts.n_elem != centroids.n_cols)
+    totalCounts.zeros(centroids.n_cols);
+
+  // Sample the batch (with replacement), unless the whole dataset fits in it.
+  const bool fullBatch = (batchSize == 0 || batchSize >= dataset.n_cols);
+  const size_t numPoints = fullBatch ? dataset.n_cols : batchSize;
+  arma::Col<size_t> batch(numPoints);
+  for (size_t i = 0; i < numPoints; ++i)
+    batch[i] = fullBatch ? i : (size_t) math::RandInt(dataset.n_cols);
+
+  // Find the closest centroid to each point of the batch, in parallel.
+  arma::Col<size_t> closest(numPoints);
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) numPoints; ++i)
+  {
+    double minDistance = std::numeric_limits<double>::infinity();
+    size_t closestCluster = centroids.n_cols; // Invalid value.
+
+    for (size_t j = 0; j < centroids.n_cols; j++)
+    {
+      const double distance = metric.Evaluate(dataset.col(batch[i]),
+          centroids.unsafe_col(j));
+      if (distance < minDistance)
+      {
+        minDistance = distance;
+        closestCluster = j;
+      }
+    }
+
+    Log::Assert(closestCluster != centroids.n_cols);
+    closest[i] = closestCluster;
+  }
+
+  // Now take a gradient step for each point, with a learning rate of one over
+  // the number of points its centroid has been given.  This makes each
+  // centroid the running mean of its points.
+  newCentroids = centroids;
+  for (size_t i = 0; i < numPoints; ++i)
+  {
+    const size_t c = closest[i];
+    ++totalCounts[c];
+    const double eta = 1.0 / totalCounts[c];
+    newCentroids.col(c) += eta * (arma::vec(dataset.col(batch[i])) -
+        newCentroids.col(c));
+  }
+
+  counts = totalCounts;
+  distanceCalculations += centroids.n_cols * numPoints;
+
+  // Calculate the change of the centroids for this iteration.
+  double cNorm = 0.0;
+  for (size_t i = 0; i < centroids.n_cols; ++i)
+  {
+    cNorm += std::pow(metric.Evaluate(centroids.col(i), newCentroids.col(i)),
+        2.0);
+  }
+  distanceCalculations += centroids.n_cols;
+
+  return std::sqrt(cNorm);
+}
+
+} // namespace kmeans
+} // namespace mlpack
+
+#endif
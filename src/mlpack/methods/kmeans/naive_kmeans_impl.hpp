@@ -48,7 +48,10 @@ double NaiveKMeans<MetricType, MatType>::Iterate(const arma::mat& centroids,
         arma::fill::zeros);
     arma::Col<size_t> localCounts(centroids.n_cols, arma::fill::zeros);
 
-    #pragma omp for
+    // The points are split statically, so that each thread processes the
+    // same points in every iteration; with data::FirstTouch(), they are in
+    // the memory of its NUMA node.
+    #pragma omp for schedule(static)
     for (omp_size_t i = 0; i < (omp_size_t) dataset.n_cols; ++i)
     {
       // Find the closest centroid to this point.
@@ -132,6 +132,135 @@ void LARS::Train(const arma::mat& matX,
 {
   Timer::Start("lars_regression");
 
+  // This matrix may end up holding the transpose -- if necessary.
+  arma::mat dataTrans;
+  // dataRef is row-major.
+  const arma::mat& dataRef = (transposeData ? dataTrans : matX);
+  if (transposeData)
+    dataTrans = trans(matX);
+
+  // Compute X' * y.
+  arma::vec vecXTy = trans(y * dataRef);
+
+  // Compute the Gram matrix, unless one was given or LARS would stop right
+  // away.  Since all of the iterations only use the Gram matrix, it must be
+  // recomputed for each new dataset.  If this is the elastic net problem, we
+  // will add lambda2 * I_n to the matrix.
+  if ((matGram == &matGramInternal) && (vecXTy.n_elem > 0) &&
+      (arma::max(arma::abs(vecXTy)) >= lambda1))
+  {
+    matGramInternal = trans(dataRef) * dataRef;
+
+    if (elasticNet && !useCholesky)
+      matGramInternal += lambda2 * arma::eye(dataRef.n_cols, dataRef.n_cols);
+  }
+
+  TrainGram(vecXTy, beta);
+
+  Timer::Stop("lars_regression");
+}
+
+void LARS::Train(const arma::sp_mat& data,
+                 const arma::rowvec& responses,
+                 arma::vec& beta,
+                 const bool transposeData)
+{
+  Timer::Start("lars_regression");
+
+  // Compute X' * y and X' * X with sparse products; X is the row-major data.
+  const size_t dimensionality = transposeData ? data.n_rows : data.n_cols;
+  arma::vec vecXTy;
+  if (transposeData)
+    vecXTy = data * responses.t();
+  else
+    vecXTy = trans(responses * data);
+
+  if ((matGram == &matGramInternal) && (vecXTy.n_elem > 0) &&
+      (arma::max(arma::abs(vecXTy)) >= lambda1))
+  {
+    if (transposeData)
+      matGramInternal = arma::mat(data * data.t());
+    else
+      matGramInternal = arma::mat(data.t() * data);
+
+    if (elasticNet && !useCholesky)
+      matGramInternal += lambda2 * arma::eye(dimensionality, dimensionality);
+  }
+
+  TrainGram(vecXTy, beta);
+
+  Timer::Stop("lars_regression");
+}
+
+void LARS::TrainPath(const arma::mat& data,
+                     const arma::rowvec& responses,
+                     const arma::vec& lambdas,
+                     arma::mat& betas,
+                     const bool transposeData)
+{
+  if (lambdas.n_elem == 0)
+  {
+    throw std::invalid_argument("LARS::TrainPath(): no values of lambda1 "
+        "given");
+  }
+
+  // Stop the path at the smallest value.  The LASSO modification is used even
+  // if that value is 0, so that every solution on the path is a LASSO
+  // solution.
+  lambda1 = std::max(arma::min(lambdas), 0.0);
+  lasso = true;
+  elasticNet = (lambda2 != 0);
+
+  Train(data, responses, transposeData);
+
+  betas.set_size(betaPath.back().n_elem, lambdas.n_elem);
+  for (size_t i = 0; i < lambdas.n_elem; ++i)
+  {
+    arma::vec beta;
+    PathSolution(lambdas[i], beta);
+    betas.col(i) = beta;
+  }
+}
+
+void LARS::PathSolution(const double lambda, arma::vec& beta) const
+{
+  if (betaPath.empty())
+  {
+    throw std::logic_error("LARS::PathSolution(): no path available; Train() "
+        "must be called first");
+  }
+
+  // The values of lambda1 decrease along the path, and the solutions are
+  // linear in lambda1 between two consecutive points of the path.
+  if (lambda >= lambdaPath[0])
+  {
+    beta = betaPath[0];
+    return;
+  }
+
+  for (size_t i = 1; i < lambdaPath.size(); ++i)
+  {
+    if (lambda >= lambdaPath[i])
+    {
+      if (lambdaPath[i - 1] == lambdaPath[i])
+      {
+        beta = betaPath[i];
+      }
+      else
+      {
+        const double interp = (lambdaPath[i - 1] - lambda) /
+            (lambdaPath[i - 1] - lambdaPath[i]);
+        beta = (1 - interp) * betaPath[i - 1] + interp * betaPath[i];
+      }
+      return;
+    }
+  }
+
+  beta = betaPath.back();
+}
+
+void LARS::TrainGram(const arma::vec& vecXTy, arma::vec& beta)
+{
   // Clear any previous solution information.
   betaPath.clear();
   lambdaPath.clear();
@@ -141,27 +270,22 @@ void LARS::Train(const arma::mat& matX,
   isIgnored.clear();
   matUtriCholFactor.reset();
 
-  // This matrix may end up holding the transpose -- if necessary.
-  arma::mat dataTrans;
-  // dataRef is row-major.
-  const arma::mat& dataRef = (transposeData ? dataTrans : matX);
-  if (transposeData)
-    dataTrans = trans(matX);
+  const size_t dimensionality = vecXTy.n_elem;
 
-  // Compute X' * y.
-  arma::vec vecXTy = trans(y * dataRef);
+  // The internal Gram matrix already holds the lambda2 * I_n term of the
+  // elastic net if the Cholesky factorization is not used.
+  const bool gramHasLambda2 = (matGram == &matGramInternal) && elasticNet &&
+      !useCholesky;
 
   // Set up active set variables.  In the beginning, the active set has size 0
   // (all dimensions are inactive).
-  isActive.resize(dataRef.n_cols, false);
+  isActive.resize(dimensionality, false);
 
   // Set up ignores set variables. Initialized empty.
-  isIgnored.resize(dataRef.n_cols, false);
+  isIgnored.resize(dimensionality, false);
 
-  // Initialize yHat and beta.
-  beta = arma::zeros(dataRef.n_cols);
-  arma::vec yHat = arma::zeros(dataRef.n_rows);
-  arma::vec yHatDirection(dataRef.n_rows);
+  // Initialize beta.
+  beta = arma::zeros(dimensionality);
 
   bool lassocond = false;
 
@@ -185,28 +309,16 @@ void LARS::Train(const arma::mat& matX,
   if (maxCorr < lambda1)
   {
     lambdaPath[0] = lambda1;
-    Timer::Stop("lars_regression");
     return;
   }
 
-  // Compute the Gram matrix.  If this is the elastic net problem, we will add
-  // lambda2 * I_n to the matrix.
-  if (matGram->n_elem != dataRef.n_cols * dataRef.n_cols)
-  {
-    // In this case, matGram should reference matGramInternal.
-    matGramInternal = trans(dataRef) * dataRef;
-
-    if (elasticNet && !useCholesky)
-      matGramInternal += lambda2 * arma::eye(dataRef.n_cols, dataRef.n_cols);
-  }
-
   // Main loop.
-  while (((activeSet.size() + ignoreSet.size()) < dataRef.n_cols) &&
+  while (((activeSet.size() + ignoreSet.size()) < dimensionality) &&
          (maxCorr > tolerance))
   {
     // Compute the maximum correlation among inactive dimensions.
     maxCorr = 0;
-    for (size_t i = 0; i < dataRef.n_cols; i++)
+    for (size_t i = 0; i < dimensionality; i++)
     {
       if ((!isActive[i]) && (!isIgnored[i]) && (fabs(corr(i)) > maxCorr))
       {
@@ -225,7 +337,7 @@ void LARS::Train(const arma::mat& matX,
         //   newGramCol[i] = dot(matX.col(activeSet[i]), matX.col(changeInd));
         // }
         // This is equivalent to the above 5 lines.
-        arma::vec newGramCol = matGram->elem(changeInd * dataRef.n_cols +
+        arma::vec newGramCol = matGram->elem(changeInd * dimensionality +
             arma::conv_to<arma::uvec>::from(activeSet));
 
         CholeskyInsert((*matGram)(changeInd, changeInd), newGramCol);
@@ -286,10 +398,10 @@ void LARS::Train(const arma::mat& matX,
     }
     else
     {
-      arma::mat matGramActive = arma::mat(activeSet.size(), activeSet.size());
-      for (size_t i = 0; i < activeSet.size(); i++)
-        for (size_t j = 0; j < activeSet.size(); j++)
-          matGramActive(i, j) = (*matGram)(activeSet[i], activeSet[j]);
+      const arma::uvec activeIndices =
+          arma::conv_to<arma::uvec>::from(activeSet);
+      const arma::mat matGramActive = matGram->submat(activeIndices,
+          activeIndices);
 
       // Check for singularity.
       arma::mat matS = s * arma::ones<arma::mat>(1, activeSet.size());
@@ -315,21 +427,24 @@ void LARS::Train(const arma::mat& matX,
       }
     }
 
-    // compute "equiangular" direction in output space
-    ComputeYHatDirection(dataRef, betaDirection, yHatDirection);
+    // Compute the correlations of every dimension with the "equiangular"
+    // direction in output space, X * betaDirection.
+    const arma::uvec activeIndices =
+        arma::conv_to<arma::uvec>::from(activeSet);
+    const arma::vec dirCorrs = matGram->cols(activeIndices) * betaDirection;
 
     double gamma = maxCorr / normalization;
 
     // If not all variables are active.
-    if ((activeSet.size() + ignoreSet.size()) < dataRef.n_cols)
+    if ((activeSet.size() + ignoreSet.size()) < dimensionality)
     {
       // Compute correlations with direction.
-      for (size_t ind = 0; ind < dataRef.n_cols; ind++)
+      for (size_t ind = 0; ind < dimensionality; ind++)
       {
         if (isActive[ind] || isIgnored[ind])
           continue;
 
-        double dirCorr = dot(dataRef.col(ind), yHatDirection);
+        double dirCorr = dirCorrs(ind);
         double val1 = (maxCorr - corr(ind)) / (normalization - dirCorr);
         double val2 = (maxCorr + corr(ind)) / (normalization + dirCorr);
         if ((val1 > 0) && (val1 < gamma))
@@ -364,9 +479,6 @@ void LARS::Train(const arma::mat& matX,
       }
     }
 
-    // Update the prediction.
-    yHat += gamma * yHatDirection;
-
     // Update the estimator.
     for (size_t i = 0; i < activeSet.size(); i++)
     {
@@ -391,8 +503,13 @@ void LARS::Train(const arma::mat& matX,
       Deactivate(changeInd);
     }
 
-    corr = vecXTy - trans(dataRef) * yHat;
-    if (elasticNet)
+    // The correlations are X^T (y - X beta); only the active dimensions of
+    // beta are nonzero.
+    const arma::uvec nonzeroIndices =
+        arma::conv_to<arma::uvec>::from(activeSet);
+    corr = vecXTy - matGram->cols(nonzeroIndices) *
+        beta.elem(nonzeroIndices);
+    if (elasticNet && !gramHasLambda2)
       corr -= lambda2 * beta;
 
     double curLambda = 0;
@@ -412,12 +529,11 @@ void LARS::Train(const arma::mat& matX,
         break;
       }
     }
+  
   }
 
   // Unfortunate copy...
   beta = betaPath.back();
-
-  Timer::Stop("lars_regression");
 }
 
 void LARS::Train(const arma::mat& data,
@@ -467,15 +583,6 @@ void LARS::Ignore(const size_t varInd)
   ignoreSet.push_back(varInd);
 }
 
-void LARS::ComputeYHatDirection(const arma::mat& matX,
-                                const arma::vec& betaDirection,
-                                arma::vec& yHatDirection)
-{
-  yHatDirection.fill(0);
-  for (size_t i = 0; i < activeSet.size(); i++)
-    yHatDirection += betaDirection(i) * matX.col(activeSet[i]);
-}
-
 void LARS::InterpolateBeta()
 {
   int pathLength = betaPath.size();
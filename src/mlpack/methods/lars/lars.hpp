@@ -290,6 +290,55 @@ class LARS
              const arma::rowvec& responses,
              const bool transposeData = true);
 
+  /**
+   * Run LARS on sparse data.  Only X^T X and X^T y are computed from the data,
+   * with sparse matrix products, and then the same algorithm as for dense data
+   * is used, so the results are the same as for the equivalent dense matrix.
+   *
+   * @param data Column-major input data (or row-major input data if
+   *     transposeData = false).
+   * @param responses A vector of targets.
+   * @param beta Vector to store the solution (the coefficients) in.
+   * @param transposeData Set to false if the data is row-major.
+   */
+  void Train(const arma::sp_mat& data,
+             const arma::rowvec& responses,
+             arma::vec& beta,
+             const bool transposeData = true);
+
+  /**
+   * Compute the LASSO (or elastic net, if lambda2 is not 0) solutions for
+   * each of the given values of lambda1, with one run of LARS.  LARS computes
+   * the whole piecewise linear path of solutions down to the smallest value of
+   * lambda1, so each solution is then interpolated from the path (see
+   * PathSolution()).  After this call, lambda1 is the smallest of the given
+   * values, and the model holds its solution.
+   *
+   * @param data Column-major input data (or row-major input data if
+   *     transposeData = false).
+   * @param responses A vector of targets.
+   * @param lambdas Values of lambda1 to compute the solutions for.
+   * @param betas Matrix to store the solutions in (one column for each value
+   *     of lambda1).
+   * @param transposeData Set to false if the data is row-major.
+   */
+  void TrainPath(const arma::mat& data,
+                 const arma::rowvec& responses,
+                 const arma::vec& lambdas,
+                 arma::mat& betas,
+                 const bool transposeData = true);
+
+  /**
+   * Get the LASSO solution for the given value of lambda1, by interpolating
+   * the path of solutions computed by the last call to Train().  The value
+   * should not be smaller than the lambda1 used for training; if it is, the
+   * last solution of the path is returned.
+   *
+   * @param lambda Value of lambda1.
+   * @param beta Vector to store the solution in.
+   */
+  void PathSolution(const double lambda, arma::vec& beta) const;
+
   /**
    * Predict y_i for each data point in the given data matrix, using the
    * currently-trained LARS model (so make sure you run Regress() first).  If
@@ -406,10 +455,16 @@ class LARS
    */
   void Ignore(const size_t varInd);
 
-  // compute "equiangular" direction in output space
-  void ComputeYHatDirection(const arma::mat& matX,
-                            const arma::vec& betaDirection,
-                            arma::vec& yHatDirection);
+  /**
+   * Run the LARS iterations, given X^T y; the Gram matrix X^T X must already
+   * be available in matGram.  The data itself is not needed: the correlations
+   * are X^T y - (X^T X) beta, and the correlations with the direction of each
+   * step are (X^T X) times the direction.
+   *
+   * @param vecXTy X^T y.
+   * @param beta Vector to store the solution in.
+   */
+  void TrainGram(const arma::vec& vecXTy, arma::vec& beta);
 
   // interpolate to compute last solution vector
   void InterpolateBeta();
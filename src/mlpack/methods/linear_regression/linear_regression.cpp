@@ -64,62 +64,129 @@ void LinearRegression::Train(const arma::mat& predictors,
 {
   this->intercept = intercept;
 
-  /*
-   * We want to calculate the a_i coefficients of:
-   * \sum_{i=0}^n (a_i * x_i^i)
-   * In order to get the intercept value, we will add a row of ones.
-   */
-
-  // We store the number of rows and columns of the predictors.
-  // Reminder: Armadillo stores the data transposed from how we think of it,
-  //           that is, columns are actually rows (see: column major order).
-  const size_t nCols = predictors.n_cols;
+  // Rather than solving the least-squares problem on the whole (copied) design
+  // matrix, accumulate the normal equations over the points and solve those.
+  ResetStatistics();
+  Update(predictors, responses, weights);
+  Solve();
+}
 
-  arma::mat p = predictors;
-  arma::rowvec r = responses;
+void LinearRegression::Update(const arma::mat& predictors,
+                              const arma::rowvec& responses)
+{
+  Update(predictors, responses, arma::rowvec());
+}
 
-  // Here we add the row of ones to the predictors.
-  // The intercept is not penalized. Add an "all ones" row to design and set
-  // intercept = false to get a penalized intercept.
-  if (intercept)
+void LinearRegression::Update(const arma::mat& predictors,
+                              const arma::rowvec& responses,
+                              const arma::rowvec& weights)
+{
+  if (responses.n_elem != predictors.n_cols ||
+      (weights.n_elem > 0 && weights.n_elem != predictors.n_cols))
   {
-    p.insert_rows(0, arma::ones<arma::mat>(1, nCols));
+    throw std::invalid_argument("LinearRegression::Update(): the number of "
+        "responses and weights must be the number of points");
   }
 
-  if (weights.n_elem > 0)
+  // The intercept is handled as an extra first dimension whose value is always
+  // 1, but no row of ones is actually added to the data.
+  const size_t offset = intercept ? 1 : 0;
+  const size_t dimensionality = predictors.n_rows + offset;
+  if (gram.is_empty())
+  {
+    gram.zeros(dimensionality, dimensionality);
+    xty.zeros(dimensionality);
+  }
+  else if (gram.n_rows != dimensionality)
   {
-    p = p * diagmat(sqrt(weights));
-    r = sqrt(weights) % responses;
+    throw std::invalid_argument("LinearRegression::Update(): the data does not "
+        "have the same dimensionality as the data given before");
   }
 
-  if (lambda != 0.0)
+  if (predictors.n_cols == 0)
+    return;
+
+  // The points are split in blocks, so that the products are done with BLAS,
+  // and each thread accumulates the statistics of its blocks.
+  const size_t blockSize = 1024;
+  const size_t numBlocks = (predictors.n_cols + blockSize - 1) / blockSize;
+  const size_t last = dimensionality - 1;
+
+  #pragma omp parallel
   {
-    // Add the identity matrix to the predictors (this is equivalent to ridge
-    // regression).  See http://math.stackexchange.com/questions/299481/ for
-    // more information.
-    p.insert_cols(nCols, predictors.n_rows);
-    p.submat(p.n_rows - predictors.n_rows, nCols, p.n_rows - 1, nCols +
-    predictors.n_rows - 1) = sqrt(lambda) *
-        arma::eye<arma::mat>(predictors.n_rows, predictors.n_rows);
+    arma::mat localGram(dimensionality, dimensionality, arma::fill::zeros);
+    arma::vec localXTy(dimensionality, arma::fill::zeros);
+
+    #pragma omp for schedule(dynamic)
+    for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+    {
+      const size_t begin = b * blockSize;
+      const size_t end = std::min(begin + blockSize, predictors.n_cols) - 1;
+      const arma::mat block = predictors.cols(begin, end);
+      const arma::rowvec blockResponses = responses.subvec(begin, end);
+
+      // The weighted points; without weights, this is the block itself.
+      arma::mat weightedBlock;
+      if (weights.n_elem > 0)
+      {
+        weightedBlock = block;
+        weightedBlock.each_row() %= weights.subvec(begin, end);
+      }
+      const arma::mat& wb = (weights.n_elem > 0) ? weightedBlock : block;
+
+      localGram.submat(offset, offset, last, last) += wb * block.t();
+      localXTy.subvec(offset, last) += wb * blockResponses.t();
+
+      if (intercept)
+      {
+        const arma::vec sums = arma::sum(wb, 1);
+        localGram(0, 0) += (weights.n_elem > 0) ?
+            arma::accu(weights.subvec(begin, end)) : (double) block.n_cols;
+        localGram.submat(1, 0, last, 0) += sums;
+        localGram.submat(0, 1, 0, last) += sums.t();
+        localXTy(0) += (weights.n_elem > 0) ?
+            arma::dot(weights.subvec(begin, end), blockResponses) :
+            arma::accu(blockResponses);
+      }
+    }
+
+    #pragma omp critical
+    {
+      gram += localGram;
+      xty += localXTy;
+    }
   }
+}
 
-  // We compute the QR decomposition of the predictors.
-  // We transpose the predictors because they are in column major order.
-  arma::mat Q, R;
-  arma::qr(Q, R, arma::trans(p));
-
-  // We compute the parameters, B, like so:
-  // R * B = Q^T * responses
-  // B = Q^T * responses * R^-1
-  // If lambda > 0, then we must add a bunch of empty responses.
-  if (lambda == 0.0)
-    arma::solve(parameters, R, arma::trans(r * Q));
-  else
+void LinearRegression::Solve()
+{
+  if (gram.is_empty())
   {
-    // Copy responses into larger vector.
-    r.insert_cols(nCols, p.n_cols - nCols);
-    arma::solve(parameters, R, arma::trans(r * Q));
+    throw std::logic_error("LinearRegression::Solve(): no data has been given "
+        "to Train() or Update()");
   }
+
+  // For ridge regression, add lambda * I to X * X^T.  The intercept is not
+  // penalized.  (Add an "all ones" row to the data and set intercept = false to
+  // get a penalized intercept.)
+  arma::mat a = gram;
+  if (lambda != 0.0)
+  {
+    a.diag() += lambda;
+    if (intercept)
+      a(0, 0) -= lambda;
+  }
+
+  // X * X^T may be singular without regularization, in which case we take the
+  // minimum-norm least-squares solution.
+  if (!arma::solve(parameters, a, xty))
+    parameters = arma::pinv(a) * xty;
+}
+
+void LinearRegression::ResetStatistics()
+{
+  gram.reset();
+  xty.reset();
 }
 
 void LinearRegression::Predict(const arma::mat& points, arma::vec& predictions)
@@ -78,10 +78,10 @@ class LinearRegression
 
   /**
    * Train the LinearRegression model on the given data.  Careful!  This will
-   * completely ignore and overwrite the existing model.  This particular
-   * implementation does not have an incremental training algorithm.  To set the
-   * regularization parameter lambda, call Lambda() or set a different value in
-   * the constructor.
+   * completely ignore and overwrite the existing model.  To train
+   * incrementally, use Update() and Solve().  To set the regularization
+   * parameter lambda, call Lambda() or set a different value in the
+   * constructor.
    *
    * @param predictors X, the matrix of data points to train the model on.
    * @param responses y, the vector of responses to each data point.
@@ -95,10 +95,10 @@ class LinearRegression
 
   /**
    * Train the LinearRegression model on the given data. Careful! This will
-   * completely ignore and overwrite the existing model. This particular
-   * implementation does not have an incremental training algorithm.  To set the
-   * regularization parameter lambda, call Lambda() or set a different value in
-   * the constructor.
+   * completely ignore and overwrite the existing model.  To train
+   * incrementally, use Update() and Solve().  To set the regularization
+   * parameter lambda, call Lambda() or set a different value in the
+   * constructor.
    *
    * @param predictors X, the matrix of data points to train the model on.
    * @param responses y, the responses to the data points.
@@ -110,10 +110,10 @@ class LinearRegression
 
   /**
    * Train the LinearRegression model on the given data and weights. Careful!
-   * This will completely ignore and overwrite the existing model. This
-   * particular implementation does not have an incremental training algorithm.
-   * To set the regularization parameter lambda, call Lambda() or set a
-   * different value in the constructor.
+   * This will completely ignore and overwrite the existing model.  To train
+   * incrementally, use Update() and Solve().  To set the regularization
+   * parameter lambda, call Lambda() or set a different value in the
+   * constructor.
    *
    * @param predictors X, the matrix of data points to train the model on.
    * @param responses y, the responses to the data points.
@@ -125,6 +125,46 @@ class LinearRegression
              const arma::rowvec& weights,
              const bool intercept = true);
 
+  /**
+   * Add the given data to the statistics of the model (X * X^T and X * y),
+   * without solving for the parameters; call Solve() once all the data has
+   * been given.  This allows the model to be trained on data that does not fit
+   * in memory at once, by calling Update() on each chunk of the data.  The
+   * points are split between OpenMP threads.  The intercept setting should not
+   * be changed between calls to Update(), and all chunks must have the same
+   * dimensionality.
+   *
+   * @param predictors X, a chunk of the data points to train the model on.
+   * @param responses y, the responses to the data points.
+   */
+  void Update(const arma::mat& predictors, const arma::rowvec& responses);
+
+  /**
+   * Add the given weighted data to the statistics of the model, without
+   * solving for the parameters; call Solve() once all the data has been given.
+   * See the other overload of Update() for details.
+   *
+   * @param predictors X, a chunk of the data points to train the model on.
+   * @param responses y, the responses to the data points.
+   * @param weights Observation weights (for boosting).
+   */
+  void Update(const arma::mat& predictors,
+              const arma::rowvec& responses,
+              const arma::rowvec& weights);
+
+  /**
+   * Compute the parameters of the model from the statistics accumulated by
+   * Train() and Update(), with the current value of lambda.  An exception is
+   * thrown if no data has been given.
+   */
+  void Solve();
+
+  /**
+   * Forget the statistics accumulated by Train() and Update(), so that the
+   * next call to Update() starts a new model.  The parameters are not changed.
+   */
+  void ResetStatistics();
+
   /**
    * Calculate y_i for each data point in points.
    *
@@ -194,6 +234,8 @@ class LinearRegression
 
   //! Return whether or not an intercept term is used in the model.
   bool Intercept() const { return intercept; }
+  //! Modify whether or not an intercept term is used in the model.
+  bool& Intercept() { return intercept; }
 
   /**
    * Serialize the model.
@@ -221,6 +263,15 @@ class LinearRegression
 
   //! Indicates whether first parameter is intercept.
   bool intercept;
+
+  /**
+   * The accumulated X * W * X^T (with the intercept as the first dimension, if
+   * it is used).  This is not serialized.
+   */
+  arma::mat gram;
+
+  //! The accumulated X * W * y (not serialized).
+  arma::vec xty;
 };
 
 } // namespace regression
@@ -35,31 +35,50 @@ void LocalCoordinateCoding::Encode(const arma::mat& data, arma::mat& codes)
       * data);
 
   arma::mat dictGram = trans(dictionary) * dictionary;
-  arma::mat dictGramTD(dictGram.n_rows, dictGram.n_cols);
 
   codes.set_size(atoms, data.n_cols);
-  for (size_t i = 0; i < data.n_cols; i++)
-  {
-    // Report progress.
-    if ((i % 100) == 0)
-    {
-      Log::Debug << "Optimization at point " << i << "." << std::endl;
-    }
-
-    arma::vec invW = invSqDists.unsafe_col(i);
-    arma::mat dictPrime = dictionary * diagmat(invW);
 
-    arma::mat dictGramTD = diagmat(invW) * dictGram * diagmat(invW);
+  // The points are encoded independently, so they are split between threads.
+  #pragma omp parallel
+  {
+    // Each thread reuses its weighted dictionary, weighted Gram matrix, LARS
+    // object and response vector for all of its points, so nothing is
+    // allocated for each point.  LARS refers to dictGramTD, which is updated
+    // in place before each solve.
+    arma::mat dictPrime(dictionary.n_rows, dictionary.n_cols);
+    arma::mat dictGramTD(dictGram.n_rows, dictGram.n_cols);
+    arma::rowvec responses(data.n_rows);
 
     bool useCholesky = false;
     regression::LARS lars(useCholesky, dictGramTD, 0.5 * lambda);
 
-    // Run LARS for this point, by making an alias of the point and passing
-    // that.
-    arma::vec beta = codes.unsafe_col(i);
-    arma::rowvec responses = data.unsafe_col(i).t();
-    lars.Train(dictPrime, responses, beta, false);
-    beta %= invW; // Remember, beta is an alias of codes.col(i).
+    #pragma omp for schedule(dynamic, 16)
+    for (omp_size_t i = 0; i < (omp_size_t) data.n_cols; ++i)
+    {
+      // Report progress.
+      if ((i % 100) == 0)
+      {
+        #pragma omp critical
+        Log::Debug << "Optimization at point " << i << "." << std::endl;
+      }
+
+      // Weight the dictionary and its Gram matrix by the inverse squared
+      // distances of the atoms to the point; this is the same as multiplying
+      // by diagmat(invW), without building the diagonal matrix.
+      const arma::vec invW = invSqDists.unsafe_col(i);
+      dictPrime = dictionary;
+      dictPrime.each_row() %= invW.t();
+      dictGramTD = dictGram;
+      dictGramTD.each_col() %= invW;
+      dictGramTD.each_row() %= invW.t();
+
+      // Run LARS for this point, by making an alias of the point and passing
+      // that.
+      arma::vec beta = codes.unsafe_col(i);
+      responses = data.col(i).t();
+      lars.Train(dictPrime, responses, beta, false);
+      beta %= invW; // Remember, beta is an alias of codes.col(i).
+    }
   }
 }
 
@@ -16,6 +16,7 @@
 
 #include <mlpack/prereqs.hpp>
 #include <mlpack/core/optimizers/lbfgs/lbfgs.hpp>
+#include <mlpack/core/optimizers/sgd/streaming_function.hpp>
 
 #include "logistic_regression_function.hpp"
 
@@ -151,6 +152,24 @@ class LogisticRegression
              const arma::Row<size_t>& responses,
              OptimizerType& optimizer);
 
+  /**
+   * Train the LogisticRegression model on a dataset that is streamed from disk
+   * with the given instantiated optimizer, which must be SGD or one of the
+   * optimizers built on it (see optimization::StreamingFunction).  The last
+   * dimension of each point in the dataset holds its response.  Only one chunk
+   * of the dataset is held in memory at a time.
+   *
+   * As with the other Train() overloads, the existing parameters are used as
+   * the starting point (unless their size doesn't match the dataset, in which
+   * case they are reset to zeros).
+   *
+   * @param dataset Streamed dataset, holding predictors and responses.
+   * @param optimizer Instantiated optimizer.
+   */
+  template<typename OptimizerType>
+  void Train(data::StreamingDataset<typename MatType::elem_type>& dataset,
+             OptimizerType& optimizer);
+
   //! Return the parameters (the b vector).
   const arma::rowvec& Parameters() const { return parameters; }
   //! Modify the parameters (the b vector).
@@ -119,6 +119,57 @@ class LogisticRegressionFunction
                 GradType& gradient,
                 const size_t batchSize = 1) const;
 
+  /**
+   * Evaluate the gradient of the logistic regression log-likelihood function
+   * with the given parameters, for the given batch size from a given point in
+   * the dataset, as a sparse matrix.  Only the features that are nonzero in
+   * some point of the batch have a nonzero gradient (unless lambda is not 0),
+   * so with sparse data, SGD with an update policy for sparse gradients (such
+   * as SparseAdaGradUpdate) only has to update those.
+   *
+   * @param parameters Vector of logistic regression parameters.
+   * @param begin Index of the starting point to use for objective function
+   *     gradient evaluation.
+   * @param gradient Sparse matrix to output gradient into.
+   * @param batchSize Number of points to be processed as a batch for objective
+   *     function gradient evaluation.
+   */
+  void Gradient(const arma::mat& parameters,
+                const size_t begin,
+                arma::sp_mat& gradient,
+                const size_t batchSize = 1) const;
+
+  /**
+   * Evaluate the logistic regression log-likelihood function and its gradient
+   * with the given parameters.  This is faster than calling Evaluate() and
+   * Gradient() one after the other, since the sigmoids are only computed once.
+   *
+   * @param parameters Vector of logistic regression parameters.
+   * @param gradient Vector to output gradient into.
+   * @return The objective function with the given parameters.
+   */
+  double EvaluateWithGradient(const arma::mat& parameters,
+                              arma::mat& gradient) const;
+
+  /**
+   * Evaluate the logistic regression log-likelihood function and its gradient
+   * with the given parameters, for the given batch size from the given point
+   * index.  This is faster than calling Evaluate() and Gradient() one after
+   * the other, since the sigmoids are only computed once.
+   *
+   * @param parameters Vector of logistic regression parameters.
+   * @param begin Index of the starting point to use for objective function
+   *     evaluation.
+   * @param gradient Vector to output gradient into.
+   * @param batchSize Number of points to be processed as a batch for objective
+   *     function evaluation.
+   * @return The objective function of the batch with the given parameters.
+   */
+  double EvaluateWithGradient(const arma::mat& parameters,
+                              const size_t begin,
+                              arma::mat& gradient,
+                              const size_t batchSize = 1) const;
+
   /**
    * Evaluate the gradient of the logistic regression log-likelihood function
    * with the given parameters, and with respect to only one feature in the
@@ -209,6 +209,111 @@ void LogisticRegressionFunction<MatType>::Gradient(
       -predictors.cols(begin, begin + batchSize - 1).t(), 0) + regularization;
 }
 
+//! Evaluate the gradient of the logistic regression objective function for a
+//! given batch size, as a sparse matrix.
+template<typename MatType>
+void LogisticRegressionFunction<MatType>::Gradient(
+                const arma::mat& parameters,
+                const size_t begin,
+                arma::sp_mat& gradient,
+                const size_t batchSize) const
+{
+  const arma::rowvec exponents = parameters(0, 0) +
+      parameters.tail_cols(parameters.n_elem - 1) *
+      predictors.cols(begin, begin + batchSize - 1);
+  // Calculating the sigmoid function values.
+  const arma::rowvec errors = 1.0 / (1.0 + arma::exp(-exponents)) -
+      responses.subvec(begin, begin + batchSize - 1);
+
+  // The product of two sparse matrices stays sparse, so only the features
+  // that appear in the batch get a nonzero gradient.
+  gradient.zeros(parameters.n_rows, parameters.n_cols);
+  gradient(0, 0) = arma::accu(errors);
+  gradient.cols(1, parameters.n_elem - 1) = arma::sp_mat(errors) *
+      arma::sp_mat(predictors.cols(begin, begin + batchSize - 1)).t();
+
+  // Regularization term (which makes the gradient dense).
+  if (lambda != 0.0)
+  {
+    gradient.cols(1, parameters.n_elem - 1) += lambda *
+        parameters.tail_cols(parameters.n_elem - 1) / predictors.n_cols *
+        batchSize;
+  }
+}
+
+//! Evaluate the logistic regression objective function and its gradient.
+template<typename MatType>
+double LogisticRegressionFunction<MatType>::EvaluateWithGradient(
+    const arma::mat& parameters,
+    arma::mat& gradient) const
+{
+  const arma::mat regularization = lambda *
+      parameters.tail_cols(parameters.n_elem - 1);
+  const double objectiveRegularization = 0.5 * arma::dot(regularization,
+      parameters.tail_cols(parameters.n_elem - 1));
+
+  const arma::rowvec sigmoids = (1 / (1 + arma::exp(-parameters(0, 0)
+      - parameters.tail_cols(parameters.n_elem - 1) * predictors)));
+
+  gradient.set_size(arma::size(parameters));
+  gradient[0] = -arma::accu(responses - sigmoids);
+  gradient.tail_cols(parameters.n_elem - 1) = (sigmoids - responses) *
+      predictors.t() + regularization;
+
+  double result = 0.0;
+  for (size_t i = 0; i < responses.n_elem; ++i)
+  {
+    if (responses[i] == 1)
+      result += log(sigmoids[i]);
+    else
+      result += log(1.0 - sigmoids[i]);
+  }
+
+  // Invert the result, because it's a minimization.
+  return -result + objectiveRegularization;
+}
+
+//! Evaluate the logistic regression objective function and its gradient for a
+//! given batch size.
+template<typename MatType>
+double LogisticRegressionFunction<MatType>::EvaluateWithGradient(
+    const arma::mat& parameters,
+    const size_t begin,
+    arma::mat& gradient,
+    const size_t batchSize) const
+{
+  const arma::mat regularization = lambda *
+      parameters.tail_cols(parameters.n_elem - 1) / predictors.n_cols *
+      batchSize;
+  const double objectiveRegularization = 0.5 * arma::dot(regularization,
+      parameters.tail_cols(parameters.n_elem - 1));
+
+  const arma::rowvec exponents = parameters(0, 0) +
+      parameters.tail_cols(parameters.n_elem - 1) *
+      predictors.cols(begin, begin + batchSize - 1);
+  // Calculating the sigmoid function values.
+  const arma::rowvec sigmoids = 1.0 / (1.0 + arma::exp(-exponents));
+
+  gradient.set_size(parameters.n_rows, parameters.n_cols);
+  gradient[0] = -arma::accu(responses.subvec(begin, begin + batchSize - 1) -
+      sigmoids);
+  gradient.tail_cols(parameters.n_elem - 1) =
+      arma::sum((responses.subvec(begin, begin + batchSize - 1) - sigmoids) *
+      -predictors.cols(begin, begin + batchSize - 1).t(), 0) + regularization;
+
+  double result = 0.0;
+  for (size_t i = 0; i < batchSize; ++i)
+  {
+    if (responses[i + begin] == 1)
+      result += log(sigmoids[i]);
+    else
+      result += log(1.0 - sigmoids[i]);
+  }
+
+  // Invert the result, because it's a minimization.
+  return -result + objectiveRegularization;
+}
+
 /**
  * Evaluate the partial gradient of the logistic regression objective
  * function with respect to the individual features in the parameter.
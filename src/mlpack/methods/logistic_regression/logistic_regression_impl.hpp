@@ -96,6 +96,45 @@ void LogisticRegression<MatType>::Train(
 }
 
 
+template<typename MatType>
+template<typename OptimizerType>
+void LogisticRegression<MatType>::Train(
+    data::StreamingDataset<typename MatType::elem_type>& dataset,
+    OptimizerType& optimizer)
+{
+  typedef typename MatType::elem_type ElemType;
+  typedef LogisticRegressionFunction<MatType> FunctionType;
+
+  if (dataset.NumPoints() == 0)
+  {
+    Log::Fatal << "LogisticRegression::Train(): cannot train on an empty "
+        << "dataset!" << std::endl;
+  }
+
+  // The intercept takes the place of the response dimension.
+  if (parameters.n_elem != dataset.Dimensionality())
+    parameters.zeros(dataset.Dimensionality());
+
+  // Each chunk only holds part of the points, so the regularization is scaled
+  // to keep the same total over a pass through the dataset.
+  const double pointLambda = lambda / dataset.NumPoints();
+  optimization::StreamingFunction<FunctionType, ElemType> errorFunction(
+      dataset, [pointLambda](const MatType& predictors,
+                             const arma::Row<size_t>& responses)
+      {
+        return FunctionType(predictors, responses,
+            pointLambda * predictors.n_cols);
+      });
+
+  Timer::Start("logistic_regression_optimization");
+  const double out = optimizer.Optimize(errorFunction, parameters);
+  Timer::Stop("logistic_regression_optimization");
+
+  Log::Info << "LogisticRegression::LogisticRegression(): final objective of "
+      << "trained model is " << out << "." << std::endl;
+}
+
+
 template<typename MatType>
 void LogisticRegression<MatType>::Predict(const MatType& predictors,
                                           arma::Row<size_t>& responses,
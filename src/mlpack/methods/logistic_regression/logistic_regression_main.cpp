@@ -16,6 +16,7 @@
 #include "logistic_regression.hpp"
 
 #include <mlpack/core/optimizers/sgd/sgd.hpp>
+#include <mlpack/core/data/load_libsvm.hpp>
 
 using namespace std;
 using namespace mlpack;
@@ -78,6 +79,15 @@ PROGRAM_INFO("L2-regularized Logistic Regression and Prediction",
     "from the logistic regression model may be saved with the " +
     PRINT_PARAM_STRING("output") + " parameter."
     "\n\n"
+    "Sparse datasets (such as bag-of-words or hashed features) can be given "
+    "in the libsvm (svmlight) format, with the " +
+    PRINT_PARAM_STRING("training_libsvm") + " parameter instead of " +
+    PRINT_PARAM_STRING("training") + " and " + PRINT_PARAM_STRING("labels") +
+    ", and with the " + PRINT_PARAM_STRING("test_libsvm") + " parameter "
+    "instead of " + PRINT_PARAM_STRING("test") + " (the labels in that file "
+    "are ignored).  These datasets are loaded into sparse matrices and are "
+    "never converted to dense matrices."
+    "\n\n"
     "This implementation of logistic regression does not support the general "
     "multi-class case but instead only the two-class case.  Any labels must "
     "be either 0 or 1.  For more classes, see the softmax_regression program."
@@ -129,27 +139,55 @@ PARAM_UROW_OUT("output", "If test data is specified, this matrix is where "
 PARAM_MATRIX_OUT("output_probabilities", "If test data is specified, this "
     "matrix is where the class probabilities for the test set will be saved.",
     "p");
+// Sparse datasets.
+PARAM_STRING_IN("training_libsvm", "File containing the training set and its "
+    "labels in the libsvm format; it is loaded as a sparse matrix.", "", "");
+PARAM_STRING_IN("test_libsvm", "File containing the test set in the libsvm "
+    "format; it is loaded as a sparse matrix.", "", "");
+
 PARAM_DOUBLE_IN("decision_boundary", "Decision boundary for prediction; if the "
     "logistic function for a point is less than the boundary, the class is "
     "taken to be 0; otherwise, the class is 1.", "d", 0.5);
 
+BINDING_SERVER_MODE();
+
+// Train the model with the optimizer given on the command line.
+template<typename MatType>
+void TrainModel(LogisticRegression<MatType>& model,
+                const MatType& regressors,
+                const arma::Row<size_t>& responses);
+
+// Compute the outputs for the test set that were asked for.
+template<typename MatType>
+void ClassifyTestSet(const LogisticRegression<MatType>& model,
+                     const MatType& testSet,
+                     const string& testName);
+
 void mlpackMain()
 {
   // Collect command-line options.
   const double lambda = CLI::GetParam<double>("lambda");
   const string optimizerType = CLI::GetParam<string>("optimizer");
-  const double tolerance = CLI::GetParam<double>("tolerance");
-  const double stepSize = CLI::GetParam<double>("step_size");
-  const size_t batchSize = (size_t) CLI::GetParam<int>("batch_size");
-  const size_t maxIterations = (size_t) CLI::GetParam<int>("max_iterations");
-  const double decisionBoundary = CLI::GetParam<double>("decision_boundary");
 
   // One of training and input_model must be specified.
-  RequireAtLeastOnePassed({ "training", "input_model" }, true);
+  RequireAtLeastOnePassed({ "training", "training_libsvm", "input_model" },
+      true);
+  const bool training = CLI::HasParam("training") ||
+      CLI::HasParam("training_libsvm");
+  if (CLI::HasParam("training") && CLI::HasParam("training_libsvm"))
+  {
+    Log::Fatal << "Can only pass one of " << PRINT_PARAM_STRING("training")
+        << " or " << PRINT_PARAM_STRING("training_libsvm") << "!" << endl;
+  }
+  if (CLI::HasParam("test") && CLI::HasParam("test_libsvm"))
+  {
+    Log::Fatal << "Can only pass one of " << PRINT_PARAM_STRING("test")
+        << " or " << PRINT_PARAM_STRING("test_libsvm") << "!" << endl;
+  }
 
   // If no output file is given, the user should know that the model will not be
   // saved, but only if a model is being trained.
-  if (CLI::HasParam("training"))
+  if (training)
   {
     RequireAtLeastOnePassed({ "output_model" }, false, "trained model will not "
         "be saved");
@@ -158,8 +196,9 @@ void mlpackMain()
   RequireAtLeastOnePassed({ "output_model", "output", "output_probabilities" },
       false, "no output will be saved");
 
-  ReportIgnoredParam({{ "test", false }}, "output");
-  ReportIgnoredParam({{ "test", false }}, "output_probabilities");
+  ReportIgnoredParam({{ "test", false }, { "test_libsvm", false }}, "output");
+  ReportIgnoredParam({{ "test", false }, { "test_libsvm", false }},
+      "output_probabilities");
 
   // Tolerance needs to be positive.
   RequireParamValue<double>("tolerance", [](double x) { return x > 0.0; },
@@ -195,28 +234,50 @@ void mlpackMain()
     }
   }
 
-  // These are the matrices we might use.
+  // These are the matrices we might use.  Sparse data is never densified.
   arma::mat regressors;
+  arma::sp_mat sparseRegressors;
   arma::Row<size_t> responses;
-  arma::mat testSet;
-  arma::Row<size_t> predictions;
 
   // Load data matrix.
   if (CLI::HasParam("training"))
+  {
     regressors = std::move(CLI::GetParam<arma::mat>("training"));
+  }
+  else if (CLI::HasParam("training_libsvm"))
+  {
+    try
+    {
+      data::LoadLibSVM(CLI::GetParam<string>("training_libsvm"),
+          sparseRegressors, responses);
+    }
+    catch (std::runtime_error& e)
+    {
+      Log::Fatal << e.what() << endl;
+    }
+  }
 
-  // Load the model, if necessary.
-  LogisticRegression<> model(0, 0); // Empty model.
-  if (CLI::HasParam("input_model"))
-    model = std::move(CLI::GetParam<LogisticRegression<>>("input_model"));
-  else
+  // Load the model, if necessary.  A loaded model is used in place, so that
+  // it stays loaded in server mode, unless it is trained further.
+  const bool useLoadedModel = CLI::HasParam("input_model") && !training;
+  LogisticRegression<> newModel(0, 0); // Empty model.
+  if (CLI::HasParam("input_model") && !useLoadedModel)
+    newModel = CLI::GetParam<LogisticRegression<>>("input_model");
+  else if (!CLI::HasParam("input_model"))
   {
     // Set the size of the parameters vector, if necessary.
-    if (!CLI::HasParam("labels"))
-      model.Parameters() = arma::zeros<arma::rowvec>(regressors.n_rows);
+    if (CLI::HasParam("training_libsvm"))
+    {
+      newModel.Parameters() = arma::zeros<arma::rowvec>(
+          sparseRegressors.n_rows + 1);
+    }
+    else if (!CLI::HasParam("labels"))
+      newModel.Parameters() = arma::zeros<arma::rowvec>(regressors.n_rows);
     else
-      model.Parameters() = arma::zeros<arma::rowvec>(regressors.n_rows + 1);
+      newModel.Parameters() = arma::zeros<arma::rowvec>(regressors.n_rows + 1);
   }
+  LogisticRegression<>& model = useLoadedModel ?
+      CLI::GetParam<LogisticRegression<>>("input_model") : newModel;
 
   // Check if the responses are in a separate file.
   if (CLI::HasParam("training") && CLI::HasParam("labels"))
@@ -235,66 +296,123 @@ void mlpackMain()
   }
 
   // Verify the labels.
-  if (CLI::HasParam("training") && max(responses) > 1)
+  if (training && max(responses) > 1)
     Log::Fatal << "The labels must be either 0 or 1, not " << max(responses)
         << "!" << endl;
 
   // Now, do the training.
+  if (training)
+    model.Lambda() = lambda;
+
   if (CLI::HasParam("training"))
   {
-    model.Lambda() = lambda;
+    TrainModel(model, regressors, responses);
+  }
+  else if (CLI::HasParam("training_libsvm"))
+  {
+    // A model for sparse data has the same parameters.
+    LogisticRegression<arma::sp_mat> sparseModel(0, lambda);
+    sparseModel.Parameters() = std::move(model.Parameters());
+    TrainModel(sparseModel, sparseRegressors, responses);
+    model.Parameters() = std::move(sparseModel.Parameters());
+  }
 
-    if (optimizerType == "sgd")
+  if (CLI::HasParam("test"))
+  {
+    const arma::mat testSet = std::move(CLI::GetParam<arma::mat>("test"));
+    ClassifyTestSet(model, testSet,
+        CLI::GetPrintableParam<arma::mat>("test"));
+  }
+  else if (CLI::HasParam("test_libsvm"))
+  {
+    arma::sp_mat testSet;
+    arma::Row<size_t> testLabels; // Ignored.
+    try
     {
-      SGD<> sgdOpt;
-      sgdOpt.MaxIterations() = maxIterations;
-      sgdOpt.Tolerance() = tolerance;
-      sgdOpt.StepSize() = stepSize;
-      sgdOpt.BatchSize() = batchSize;
-      Log::Info << "Training model with SGD optimizer." << endl;
-
-      // This will train the model.
-      model.Train(regressors, responses, sgdOpt);
+      data::LoadLibSVM(CLI::GetParam<string>("test_libsvm"), testSet,
+          testLabels, model.Parameters().n_elem - 1);
     }
-    else if (optimizerType == "lbfgs")
+    catch (std::runtime_error& e)
     {
-      L_BFGS lbfgsOpt;
-      lbfgsOpt.MaxIterations() = maxIterations;
-      lbfgsOpt.MinGradientNorm() = tolerance;
-      Log::Info << "Training model with L-BFGS optimizer." << endl;
-
-      // This will train the model.
-      model.Train(regressors, responses, lbfgsOpt);
+      Log::Fatal << e.what() << endl;
     }
+
+    LogisticRegression<arma::sp_mat> sparseModel(0, model.Lambda());
+    sparseModel.Parameters() = std::move(model.Parameters());
+    ClassifyTestSet(sparseModel, testSet,
+        CLI::GetParam<string>("test_libsvm"));
+    model.Parameters() = std::move(sparseModel.Parameters());
   }
 
-  if (CLI::HasParam("test"))
+  if (CLI::HasParam("output_model"))
   {
-    testSet = std::move(CLI::GetParam<arma::mat>("test"));
+    // A loaded model is copied, since it may be used again in server mode.
+    if (useLoadedModel)
+      CLI::GetParam<LogisticRegression<>>("output_model") = model;
+    else
+      CLI::GetParam<LogisticRegression<>>("output_model") = std::move(model);
+  }
+}
 
-    // We must perform predictions on the test set.  Training (and the
-    // optimizer) are irrelevant here; we'll pass in the model we have.
-    if (CLI::HasParam("output"))
-    {
-      Log::Info << "Predicting classes of points in '"
-          << CLI::GetPrintableParam<arma::mat>("test") << "'." << endl;
-      model.Classify(testSet, predictions, decisionBoundary);
+template<typename MatType>
+void TrainModel(LogisticRegression<MatType>& model,
+                const MatType& regressors,
+                const arma::Row<size_t>& responses)
+{
+  const string optimizerType = CLI::GetParam<string>("optimizer");
+  const double tolerance = CLI::GetParam<double>("tolerance");
+  const size_t maxIterations = (size_t) CLI::GetParam<int>("max_iterations");
 
-      CLI::GetParam<arma::Row<size_t>>("output") = std::move(predictions);
-    }
+  if (optimizerType == "sgd")
+  {
+    SGD<> sgdOpt;
+    sgdOpt.MaxIterations() = maxIterations;
+    sgdOpt.Tolerance() = tolerance;
+    sgdOpt.StepSize() = CLI::GetParam<double>("step_size");
+    sgdOpt.BatchSize() = (size_t) CLI::GetParam<int>("batch_size");
+    Log::Info << "Training model with SGD optimizer." << endl;
+
+    // This will train the model.
+    model.Train(regressors, responses, sgdOpt);
+  }
+  else if (optimizerType == "lbfgs")
+  {
+    L_BFGS lbfgsOpt;
+    lbfgsOpt.MaxIterations() = maxIterations;
+    lbfgsOpt.MinGradientNorm() = tolerance;
+    Log::Info << "Training model with L-BFGS optimizer." << endl;
 
-    if (CLI::HasParam("output_probabilities"))
-    {
-      Log::Info << "Calculating class probabilities of points in '"
-          << CLI::GetPrintableParam<arma::mat>("test") << "'." << endl;
-      arma::mat probabilities;
-      model.Classify(testSet, probabilities);
+    // This will train the model.
+    model.Train(regressors, responses, lbfgsOpt);
+  }
+}
 
-      CLI::GetParam<arma::mat>("output_probabilities") =
-          std::move(probabilities);
-    }
+template<typename MatType>
+void ClassifyTestSet(const LogisticRegression<MatType>& model,
+                     const MatType& testSet,
+                     const string& testName)
+{
+  // We must perform predictions on the test set.  Training (and the
+  // optimizer) are irrelevant here; we'll pass in the model we have.
+  if (CLI::HasParam("output"))
+  {
+    Log::Info << "Predicting classes of points in '" << testName << "'."
+        << endl;
+    arma::Row<size_t> predictions;
+    model.Classify(testSet, predictions,
+        CLI::GetParam<double>("decision_boundary"));
+
+    CLI::GetParam<arma::Row<size_t>>("output") = std::move(predictions);
   }
 
-  if (CLI::HasParam("output_model"))
-    CLI::GetParam<LogisticRegression<>>("output_model") = std::move(model);
+  if (CLI::HasParam("output_probabilities"))
+  {
+    Log::Info << "Calculating class probabilities of points in '" << testName
+        << "'." << endl;
+    arma::mat probabilities;
+    model.Classify(testSet, probabilities);
+
+    CLI::GetParam<arma::mat>("output_probabilities") =
+        std::move(probabilities);
+  }
 }
@@ -47,6 +47,7 @@
 
 #include <mlpack/core/metrics/lmetric.hpp>
 #include <mlpack/methods/neighbor_search/sort_policies/nearest_neighbor_sort.hpp>
+#include <mlpack/methods/neighbor_search/candidate_list.hpp>
 
 #include <queue>
 
@@ -188,6 +189,20 @@ class LSHSearch
              const size_t bucketSize = 500,
              const arma::cube& projection = arma::cube());
 
+  /**
+   * Insert new points into the trained model, without rebuilding it.  The new
+   * points are hashed with the existing projections and offsets, and appended
+   * to the reference set and to the buckets they fall into, so they get the
+   * indices ReferenceSet().n_cols onwards.  As in Train(), no bucket grows past
+   * BucketSize() points; the new points that do not fit in a full bucket are
+   * not added to that bucket.  This takes time linear in the size of the hash
+   * table plus the number of new points, so it is best to insert points in
+   * batches.
+   *
+   * @param newPoints Points to insert; each column is a point.
+   */
+  void Insert(const arma::mat& newPoints);
+
   /**
    * Compute the nearest neighbors of the points in the given query set and
    * store the output in the given matrices.  The matrices will be set to the
@@ -280,9 +295,14 @@ class LSHSearch
   //! Get the bucket size of the second hash.
   size_t BucketSize() const { return bucketSize; }
 
-  //! Get the second hash table.
-  const std::vector<arma::Col<size_t>>& SecondHashTable() const
-      { return secondHashTable; }
+  //! Get the offsets of the buckets of the second hash table in
+  //! BucketContents(): bucket i holds the points in
+  //! [BucketOffsets()[i], BucketOffsets()[i + 1]).
+  const arma::Col<size_t>& BucketOffsets() const { return bucketOffsets; }
+
+  //! Get the points in the buckets of the second hash table, stored one
+  //! bucket after another.
+  const arma::Col<arma::u32>& BucketContents() const { return bucketContents; }
 
   //! Get the projection tables.
   const arma::cube& Projections() { return projections; }
@@ -297,25 +317,85 @@ class LSHSearch
 
  private:
   /**
-   * This function takes a query and hashes it into each of the hash tables to
-   * get keys for the query and then the key is hashed to a bucket of the second
-   * hash table and all the points (if any) in those buckets are collected as
+   * Hash the given points into every hash table, and then into the second hash
+   * table, using the current projections, offsets and second hash weights.
+   *
+   * @param points Points to hash.
+   * @param secondHashVectors Matrix to store the bucket of each point in each
+   *     table into (numTables x points.n_cols).
+   */
+  void SecondHashCodes(const arma::mat& points,
+                       arma::Mat<size_t>& secondHashVectors) const;
+
+  /**
+   * Hash a block of consecutive queries into each of the first
+   * 'numTablesToSearch' hash tables, and hash each of the resulting keys into
+   * a bucket of the second hash table.  The projections of all the queries in
+   * all the tables are computed with a single matrix multiplication.
+   *
+   * @param querySet Set of query points.
+   * @param begin Index of the first query of the block.
+   * @param count Number of queries in the block.
+   * @param numTablesToSearch The number of tables to hash the queries into.
+   * @param queryCodesNotFloored Matrix to store the projection locations of
+   *    the queries into; column (q * numTablesToSearch + i) holds the location
+   *    of query q of the block in table i.
+   * @param allProjInTables Matrix to store the keys of the queries into (the
+   *    floored projection locations), with the same layout.
+   * @param primaryHashes Row to store the bucket of each key in the second
+   *    hash table into, with the same layout.
+   */
+  void HashQueries(const arma::mat& querySet,
+                   const size_t begin,
+                   const size_t count,
+                   const size_t numTablesToSearch,
+                   arma::mat& queryCodesNotFloored,
+                   arma::mat& allProjInTables,
+                   arma::Row<size_t>& primaryHashes) const;
+
+  /**
+   * This function takes a query that was hashed by HashQueries(), probes the
+   * buckets of the second hash table it falls into (and any additional
+   * probing bins), and collects all the points (if any) in those buckets as
    * the potential neighbor candidates.
    *
-   * @param queryPoint The query point currently being processed.
+   * @param queryIndex The index of the query in the block given to
+   *    HashQueries().
+   * @param queryCodesNotFloored Projection locations computed by
+   *    HashQueries().
+   * @param allProjInTables Keys computed by HashQueries().
+   * @param primaryHashes Second hash table buckets computed by HashQueries().
+   * @param numTablesToSearch The number of tables to perform the search in.
+   * @param T The number of additional probing bins for multiprobe LSH. If 0,
+   *    single-probe is used.
    * @param referenceIndices The list of neighbor candidates obtained from
    *    hashing the query into all the hash tables and eventually into
    *    multiple buckets of the second hash table.
-   * @param numTablesToSearch The number of tables to perform the search in. If
-   *    0, all tables are searched.
-   * @param T The number of additional probing bins for multiprobe LSH. If 0,
-   *    single-probe is used.
+   * @param visited Stamps of the reference points, used to skip the points
+   *    that were already collected for this query; it is allocated on the
+   *    first call, and should be reused for the following queries.
+   * @param epoch Stamp of the previous query; it is advanced for this query.
    */
-  template<typename VecType>
-  void ReturnIndicesFromTable(const VecType& queryPoint,
+  void ReturnIndicesFromTable(const size_t queryIndex,
+                              const arma::mat& queryCodesNotFloored,
+                              const arma::mat& allProjInTables,
+                              const arma::Row<size_t>& primaryHashes,
+                              const size_t numTablesToSearch,
+                              const size_t T,
                               arma::uvec& referenceIndices,
-                              size_t numTablesToSearch,
-                              const size_t T) const;
+                              arma::Col<arma::u16>& visited,
+                              arma::u16& epoch) const;
+
+  /**
+   * Compute the Euclidean distances from the given query to each of the given
+   * reference points.
+   *
+   * @param queryPoint The query point.
+   * @param referenceIndices The indices of the candidate neighbors.
+   * @return Distance to each candidate, in the same order.
+   */
+  arma::rowvec CandidateDistances(const arma::vec& queryPoint,
+                                  const arma::uvec& referenceIndices) const;
 
   /**
    * This is a helper function that computes the distance of the query to the
@@ -440,35 +520,22 @@ class LSHSearch
   //! The bucket size of the second hash.
   size_t bucketSize;
 
-  //! The final hash table; should be (< secondHashSize) vectors each with
-  //! (<= bucketSize) elements.
-  std::vector<arma::Col<size_t>> secondHashTable;
+  //! The final hash table, in compressed sparse row form: the
+  //! (< secondHashSize) nonempty buckets, each with (<= bucketSize) points, are
+  //! stored one after another in bucketContents, and bucket i starts at
+  //! bucketOffsets[i].  Length (number of nonempty buckets + 1).
+  arma::Col<size_t> bucketOffsets;
 
-  //! The number of elements present in each hash bucket; should be
-  //! secondHashSize.
-  arma::Col<size_t> bucketContentSize;
+  //! The points of all the buckets of the second hash table.  32-bit indices
+  //! are used to halve the memory used by the table.
+  arma::Col<arma::u32> bucketContents;
 
-  //! For a particular hash value, points to the row in secondHashTable
+  //! For a particular hash value, points to the bucket in bucketOffsets
   //! corresponding to this value. Length secondHashSize.
   arma::Col<size_t> bucketRowInHashTable;
 
   //! The number of distance evaluations.
   size_t distanceEvaluations;
-
-  //! Candidate represents a possible candidate neighbor (distance, index).
-  typedef std::pair<double, size_t> Candidate;
-
-  //! Compare two candidates based on the distance.
-  struct CandidateCmp {
-    bool operator()(const Candidate& c1, const Candidate& c2)
-    {
-      return !SortPolicy::IsBetter(c2.first, c1.first);
-    };
-  };
-
-  //! Use a priority queue to represent the list of candidate neighbors.
-  typedef std::priority_queue<Candidate, std::vector<Candidate>, CandidateCmp>
-      CandidateList;
 }; // class LSHSearch
 
 } // namespace neighbor
@@ -476,7 +543,7 @@ class LSHSearch
 
 //! Set the serialization version of the LSHSearch class.
 BOOST_TEMPLATE_CLASS_VERSION(template<typename SortPolicy>,
-    mlpack::neighbor::LSHSearch<SortPolicy>, 1);
+    mlpack::neighbor::LSHSearch<SortPolicy>, 2);
 
 // Include implementation.
 #include "lsh_search_impl.hpp"
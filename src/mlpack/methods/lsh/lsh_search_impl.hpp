@@ -83,8 +83,8 @@ LSHSearch<SortPolicy>::LSHSearch(const LSHSearch& other) :
     secondHashSize(other.secondHashSize),
     secondHashWeights(other.secondHashWeights),
     bucketSize(other.bucketSize),
-    secondHashTable(other.secondHashTable),
-    bucketContentSize(other.bucketContentSize),
+    bucketOffsets(other.bucketOffsets),
+    bucketContents(other.bucketContents),
     bucketRowInHashTable(other.bucketRowInHashTable),
     distanceEvaluations(other.distanceEvaluations)
 {
@@ -103,8 +103,8 @@ LSHSearch<SortPolicy>::LSHSearch(LSHSearch&& other) :
     secondHashSize(other.secondHashSize),
     secondHashWeights(std::move(other.secondHashWeights)),
     bucketSize(other.bucketSize),
-    secondHashTable(std::move(other.secondHashTable)),
-    bucketContentSize(std::move(other.bucketContentSize)),
+    bucketOffsets(std::move(other.bucketOffsets)),
+    bucketContents(std::move(other.bucketContents)),
     bucketRowInHashTable(std::move(other.bucketRowInHashTable)),
     distanceEvaluations(other.distanceEvaluations)
 {
@@ -130,8 +130,8 @@ LSHSearch<SortPolicy>& LSHSearch<SortPolicy>::operator=(const LSHSearch& other)
   secondHashSize = other.secondHashSize;
   secondHashWeights = other.secondHashWeights;
   bucketSize = other.bucketSize;
-  secondHashTable = other.secondHashTable;
-  bucketContentSize = other.bucketContentSize;
+  bucketOffsets = other.bucketOffsets;
+  bucketContents = other.bucketContents;
   bucketRowInHashTable = other.bucketRowInHashTable;
   distanceEvaluations = other.distanceEvaluations;
 
@@ -151,8 +151,8 @@ LSHSearch<SortPolicy>& LSHSearch<SortPolicy>::operator=(LSHSearch&& other)
   secondHashSize = other.secondHashSize;
   secondHashWeights = std::move(other.secondHashWeights);
   bucketSize = other.bucketSize;
-  secondHashTable = std::move(other.secondHashTable);
-  bucketContentSize = std::move(other.bucketContentSize);
+  bucketOffsets = std::move(other.bucketOffsets);
+  bucketContents = std::move(other.bucketContents);
   bucketRowInHashTable = std::move(other.bucketRowInHashTable);
   distanceEvaluations = other.distanceEvaluations;
 
@@ -180,6 +180,16 @@ void LSHSearch<SortPolicy>::Train(arma::mat referenceSet,
   // Set new reference set.
   this->referenceSet = std::move(referenceSet);
 
+  // The points are stored in the hash table as 32-bit indices.
+  if (this->referenceSet.n_cols > std::numeric_limits<arma::u32>::max())
+  {
+    std::ostringstream oss;
+    oss << "LSHSearch::Train(): reference set has " << this->referenceSet.n_cols
+        << " points, but at most " << std::numeric_limits<arma::u32>::max()
+        << " points are supported!";
+    throw std::invalid_argument(oss.str());
+  }
+
   // Set new parameters.
   this->numProj = numProj;
   this->numTables = numTables;
@@ -251,10 +261,173 @@ void LSHSearch<SortPolicy>::Train(arma::mat referenceSet,
         "tables provided must be equal to numProj");
   }
 
-  // We will store the second hash vectors in this matrix; the second hash
-  // vector for table i will be held in row i.  We have to use int and not
-  // size_t, otherwise negative numbers are cast to 0.
-  arma::Mat<size_t> secondHashVectors(numTables, this->referenceSet.n_cols);
+  // Step IV and V: hash every point into every table; the second hash vector
+  // for table i will be held in row i.
+  arma::Mat<size_t> secondHashVectors;
+  SecondHashCodes(this->referenceSet, secondHashVectors);
+
+  // Now, using the hash vectors for each table, count the number of rows we
+  // have in the second hash table.
+  arma::Row<size_t> secondHashBinCounts(secondHashSize, arma::fill::zeros);
+  for (size_t i = 0; i < secondHashVectors.n_elem; ++i)
+    secondHashBinCounts[secondHashVectors[i]]++;
+
+  // Enforce the maximum bucket size.
+  const size_t effectiveBucketSize = (bucketSize == 0) ? SIZE_MAX : bucketSize;
+  secondHashBinCounts.transform([effectiveBucketSize](size_t val)
+      { return std::min(val, effectiveBucketSize); });
+
+  const size_t numRowsInTable = arma::accu(secondHashBinCounts > 0);
+
+  // Give each nonempty bucket a row, in the order in which the buckets are
+  // first seen, and compute where each row starts in the compressed table.
+  size_t currentRow = 0;
+  for (size_t i = 0; i < numTables; ++i)
+  {
+    for (size_t j = 0; j < secondHashVectors.n_cols; ++j)
+    {
+      const size_t hashInd = secondHashVectors(i, j);
+      if (bucketRowInHashTable[hashInd] == secondHashSize)
+        bucketRowInHashTable[hashInd] = currentRow++;
+    }
+  }
+
+  bucketOffsets.zeros(numRowsInTable + 1);
+  for (size_t hashInd = 0; hashInd < secondHashSize; ++hashInd)
+  {
+    if (bucketRowInHashTable[hashInd] < secondHashSize)
+    {
+      bucketOffsets[bucketRowInHashTable[hashInd] + 1] =
+          secondHashBinCounts[hashInd];
+    }
+  }
+  bucketOffsets = arma::cumsum(bucketOffsets);
+  bucketContents.set_size(bucketOffsets[numRowsInTable]);
+
+  // Next we must assign each point in each table to the right bucket; the
+  // first points hashed to a bucket are kept if it is too small for all of
+  // them.
+  arma::Col<size_t> nextInRow = bucketOffsets.head(numRowsInTable);
+  for (size_t i = 0; i < numTables; ++i)
+  {
+    for (size_t j = 0; j < secondHashVectors.n_cols; j++)
+    {
+      // The point ID is 'j'.
+      const size_t row = bucketRowInHashTable[secondHashVectors(i, j)];
+      if (nextInRow[row] < bucketOffsets[row + 1])
+        bucketContents[nextInRow[row]++] = (arma::u32) j;
+    } // Loop over all points in the reference set.
+  } // Loop over tables.
+
+  Log::Info << "Final hash table size: " << numRowsInTable << " rows, with a "
+            << "maximum length of " << arma::max(secondHashBinCounts) << ", "
+            << "totaling " << arma::accu(secondHashBinCounts) << " elements."
+            << std::endl;
+}
+
+// Insert new points into the trained model.
+template<typename SortPolicy>
+void LSHSearch<SortPolicy>::Insert(const arma::mat& newPoints)
+{
+  if (newPoints.n_cols == 0)
+    return;
+
+  if (projections.n_slices == 0)
+  {
+    throw std::invalid_argument("LSHSearch::Insert(): the model must be "
+        "trained before points can be inserted");
+  }
+
+  if (newPoints.n_rows != referenceSet.n_rows)
+  {
+    std::ostringstream oss;
+    oss << "LSHSearch::Insert(): dimensionality of new points ("
+        << newPoints.n_rows << ") does not match dimensionality of reference "
+        << "set (" << referenceSet.n_rows << ")!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  const size_t oldPoints = referenceSet.n_cols;
+  if (newPoints.n_cols > std::numeric_limits<arma::u32>::max() - oldPoints)
+  {
+    std::ostringstream oss;
+    oss << "LSHSearch::Insert(): reference set would have "
+        << oldPoints + newPoints.n_cols << " points, but at most "
+        << std::numeric_limits<arma::u32>::max() << " points are supported!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  // Hash the new points with the existing projections and offsets.
+  arma::Mat<size_t> secondHashVectors;
+  SecondHashCodes(newPoints, secondHashVectors);
+
+  // Buckets that were empty get new rows at the end of the table, in the order
+  // in which they are first seen, just like in Train().
+  const size_t oldRows = bucketOffsets.n_elem - 1;
+  size_t numRowsInTable = oldRows;
+  for (size_t i = 0; i < numTables; ++i)
+  {
+    for (size_t j = 0; j < secondHashVectors.n_cols; ++j)
+    {
+      const size_t hashInd = secondHashVectors(i, j);
+      if (bucketRowInHashTable[hashInd] == secondHashSize)
+        bucketRowInHashTable[hashInd] = numRowsInTable++;
+    }
+  }
+
+  // Count the points that go into each bucket, without letting any bucket
+  // grow past the maximum bucket size.
+  const size_t effectiveBucketSize = (bucketSize == 0) ? SIZE_MAX : bucketSize;
+  arma::Col<size_t> rowSizes(numRowsInTable, arma::fill::zeros);
+  for (size_t row = 0; row < oldRows; ++row)
+    rowSizes[row] = bucketOffsets[row + 1] - bucketOffsets[row];
+  for (size_t i = 0; i < secondHashVectors.n_elem; ++i)
+  {
+    const size_t row = bucketRowInHashTable[secondHashVectors[i]];
+    if (rowSizes[row] < effectiveBucketSize)
+      ++rowSizes[row];
+  }
+
+  arma::Col<size_t> newOffsets(numRowsInTable + 1);
+  newOffsets[0] = 0;
+  newOffsets.tail(numRowsInTable) = arma::cumsum(rowSizes);
+
+  // Move the existing contents of each bucket to its new position; the new
+  // points are appended after them.
+  arma::Col<arma::u32> newContents(newOffsets[numRowsInTable]);
+  arma::Col<size_t> nextInRow = newOffsets.head(numRowsInTable);
+  for (size_t row = 0; row < oldRows; ++row)
+  {
+    for (size_t j = bucketOffsets[row]; j < bucketOffsets[row + 1]; ++j)
+      newContents[nextInRow[row]++] = bucketContents[j];
+  }
+
+  for (size_t i = 0; i < numTables; ++i)
+  {
+    for (size_t j = 0; j < secondHashVectors.n_cols; ++j)
+    {
+      const size_t row = bucketRowInHashTable[secondHashVectors(i, j)];
+      if (nextInRow[row] < newOffsets[row + 1])
+        newContents[nextInRow[row]++] = (arma::u32) (oldPoints + j);
+    }
+  }
+
+  bucketOffsets = std::move(newOffsets);
+  bucketContents = std::move(newContents);
+  referenceSet.insert_cols(oldPoints, newPoints);
+
+  Log::Info << "Inserted " << newPoints.n_cols << " points; hash table size: "
+            << numRowsInTable << " rows, totaling " << bucketContents.n_elem
+            << " elements." << std::endl;
+}
+
+// Hash the given points into the second hash table of every table.
+template<typename SortPolicy>
+void LSHSearch<SortPolicy>::SecondHashCodes(
+    const arma::mat& points,
+    arma::Mat<size_t>& secondHashVectors) const
+{
+  secondHashVectors.set_size(numTables, points.n_cols);
 
   for (size_t i = 0; i < numTables; i++)
   {
@@ -263,19 +436,19 @@ void LSHSearch<SortPolicy>::Train(arma::mat referenceSet,
 
     // The following code performs the task of hashing each point to a
     // 'numProj'-dimensional integer key.  Hence you get a ('numProj' x
-    // 'referenceSet.n_cols') key matrix.
+    // 'points.n_cols') key matrix.
     //
     // For a single table, let the 'numProj' projections be denoted by 'proj_i'
     // and the corresponding offset be 'offset_i'.  Then the key of a single
     // point is obtained as:
     // key = { floor((<proj_i, point> + offset_i) / 'hashWidth') forall i }
     arma::mat offsetMat = arma::repmat(offsets.unsafe_col(i), 1,
-                                       this->referenceSet.n_cols);
-    arma::mat hashMat = projections.slice(i).t() * (this->referenceSet);
+                                       points.n_cols);
+    arma::mat hashMat = projections.slice(i).t() * points;
     hashMat += offsetMat;
     hashMat /= hashWidth;
 
-    // Step V: Putting the points in the 'secondHashTable' by hashing the key.
+    // Step V: Putting the points in the second hash table by hashing the key.
     // Now we hash every key, point ID to its corresponding bucket.  We must
     // also normalize the hashes to the range [0, secondHashSize).
     arma::rowvec unmodVector = secondHashWeights.t() * arma::floor(hashMat);
@@ -295,56 +468,20 @@ void LSHSearch<SortPolicy>::Train(arma::mat referenceSet,
       }
     }
   }
+}
 
-  // Now, using the hash vectors for each table, count the number of rows we
-  // have in the second hash table.
-  arma::Row<size_t> secondHashBinCounts(secondHashSize, arma::fill::zeros);
-  for (size_t i = 0; i < secondHashVectors.n_elem; ++i)
-    secondHashBinCounts[secondHashVectors[i]]++;
-
-  // Enforce the maximum bucket size.
-  const size_t effectiveBucketSize = (bucketSize == 0) ? SIZE_MAX : bucketSize;
-  secondHashBinCounts.transform([effectiveBucketSize](size_t val)
-      { return std::min(val, effectiveBucketSize); });
-
-  const size_t numRowsInTable = arma::accu(secondHashBinCounts > 0);
-  bucketContentSize.zeros(numRowsInTable);
-  secondHashTable.resize(numRowsInTable);
-
-  // Next we must assign each point in each table to the right second hash
-  // table.
-  size_t currentRow = 0;
-  for (size_t i = 0; i < numTables; ++i)
-  {
-    // Insert the point in the corresponding row to its bucket in the
-    // 'secondHashTable'.
-    for (size_t j = 0; j < secondHashVectors.n_cols; j++)
-    {
-      // This is the bucket number.
-      size_t hashInd = (size_t) secondHashVectors(i, j);
-      // The point ID is 'j'.
-
-      // If this is currently an empty bucket, start a new row keep track of
-      // which row corresponds to the bucket.
-      const size_t maxSize = secondHashBinCounts[hashInd];
-      if (bucketRowInHashTable[hashInd] == secondHashSize)
-      {
-        bucketRowInHashTable[hashInd] = currentRow;
-        secondHashTable[currentRow].set_size(maxSize);
-        currentRow++;
-      }
-
-      // If this vector in the hash table is not full, add the point.
-      const size_t index = bucketRowInHashTable[hashInd];
-      if (bucketContentSize[index] < maxSize)
-        secondHashTable[index](bucketContentSize[index]++) = j;
-    } // Loop over all points in the reference set.
-  } // Loop over tables.
-
-  Log::Info << "Final hash table size: " << numRowsInTable << " rows, with a "
-            << "maximum length of " << arma::max(secondHashBinCounts) << ", "
-            << "totaling " << arma::accu(secondHashBinCounts) << " elements."
-            << std::endl;
+// Compute the distances from a query to all of its candidates.
+template<typename SortPolicy>
+inline force_inline
+arma::rowvec LSHSearch<SortPolicy>::CandidateDistances(
+    const arma::vec& queryPoint,
+    const arma::uvec& referenceIndices) const
+{
+  // Gather the candidates into one matrix so that the differences, squares
+  // and sums run as vectorized passes over contiguous memory.
+  arma::mat candidates = referenceSet.cols(referenceIndices);
+  candidates.each_col() -= queryPoint;
+  return arma::sqrt(arma::sum(arma::square(candidates), 0));
 }
 
 // Base case where the query set is the reference set.  (So, we can't return
@@ -360,10 +497,11 @@ void LSHSearch<SortPolicy>::BaseCase(const size_t queryIndex,
   // Let's build the list of candidate neighbors for the given query point.
   // It will be initialized with k candidates:
   // (WorstDistance, referenceSet.n_cols)
-  const Candidate def = std::make_pair(SortPolicy::WorstDistance(),
-      referenceSet.n_cols);
-  std::vector<Candidate> vect(k, def);
-  CandidateList pqueue(CandidateCmp(), std::move(vect));
+  CandidateList<SortPolicy> candidates(k, 1, referenceSet.n_cols);
+
+  // Compute the distances to all the candidates at once.
+  const arma::rowvec candidateDistances = CandidateDistances(
+      referenceSet.unsafe_col(queryIndex), referenceIndices);
 
   for (size_t j = 0; j < referenceIndices.n_elem; ++j)
   {
@@ -372,25 +510,14 @@ void LSHSearch<SortPolicy>::BaseCase(const size_t queryIndex,
     if (queryIndex == referenceIndex)
       continue;
 
-    const double distance = metric::EuclideanDistance::Evaluate(
-        referenceSet.unsafe_col(queryIndex),
-        referenceSet.unsafe_col(referenceIndex));
+    const double distance = candidateDistances[j];
 
-    Candidate c = std::make_pair(distance, referenceIndex);
-    // If this distance is better than the worst candidate, let's insert it.
-    if (CandidateCmp()(c, pqueue.top()))
-    {
-      pqueue.pop();
-      pqueue.push(c);
-    }
+    // If this distance is better than the worst candidate, it is inserted.
+    candidates.Insert(0, referenceIndex, distance);
   }
 
-  for (size_t j = 1; j <= k; j++)
-  {
-    neighbors(k - j, queryIndex) = pqueue.top().second;
-    distances(k - j, queryIndex) = pqueue.top().first;
-    pqueue.pop();
-  }
+  candidates.Get(0, neighbors.colptr(queryIndex),
+      distances.colptr(queryIndex));
 }
 
 // Base case for bichromatic search.
@@ -406,33 +533,23 @@ void LSHSearch<SortPolicy>::BaseCase(const size_t queryIndex,
   // Let's build the list of candidate neighbors for the given query point.
   // It will be initialized with k candidates:
   // (WorstDistance, referenceSet.n_cols)
-  const Candidate def = std::make_pair(SortPolicy::WorstDistance(),
-      referenceSet.n_cols);
-  std::vector<Candidate> vect(k, def);
-  CandidateList pqueue(CandidateCmp(), std::move(vect));
+  CandidateList<SortPolicy> candidates(k, 1, referenceSet.n_cols);
+
+  // Compute the distances to all the candidates at once.
+  const arma::rowvec candidateDistances = CandidateDistances(
+      querySet.unsafe_col(queryIndex), referenceIndices);
 
   for (size_t j = 0; j < referenceIndices.n_elem; ++j)
   {
     const size_t referenceIndex = referenceIndices[j];
-    const double distance = metric::EuclideanDistance::Evaluate(
-        querySet.unsafe_col(queryIndex),
-        referenceSet.unsafe_col(referenceIndex));
+    const double distance = candidateDistances[j];
 
-    Candidate c = std::make_pair(distance, referenceIndex);
-    // If this distance is better than the worst candidate, let's insert it.
-    if (CandidateCmp()(c, pqueue.top()))
-    {
-      pqueue.pop();
-      pqueue.push(c);
-    }
+    // If this distance is better than the worst candidate, it is inserted.
+    candidates.Insert(0, referenceIndex, distance);
   }
 
-  for (size_t j = 1; j <= k; j++)
-  {
-    neighbors(k - j, queryIndex) = pqueue.top().second;
-    distances(k - j, queryIndex) = pqueue.top().first;
-    pqueue.pop();
-  }
+  candidates.Get(0, neighbors.colptr(queryIndex),
+      distances.colptr(queryIndex));
 }
 
 template<typename SortPolicy>
@@ -697,48 +814,70 @@ void LSHSearch<SortPolicy>::GetAdditionalProbingBins(
 }
 
 template<typename SortPolicy>
-template<typename VecType>
-void LSHSearch<SortPolicy>::ReturnIndicesFromTable(
-    const VecType& queryPoint,
-    arma::uvec& referenceIndices,
-    size_t numTablesToSearch,
-    const size_t T) const
+void LSHSearch<SortPolicy>::HashQueries(
+    const arma::mat& querySet,
+    const size_t begin,
+    const size_t count,
+    const size_t numTablesToSearch,
+    arma::mat& queryCodesNotFloored,
+    arma::mat& allProjInTables,
+    arma::Row<size_t>& primaryHashes) const
 {
-  // Decide on the number of tables to look into.
-  if (numTablesToSearch == 0) // If no user input is given, search all.
-    numTablesToSearch = numTables;
-
-  // Sanity check to make sure that the existing number of tables is not
-  // exceeded.
-  if (numTablesToSearch > numTables)
-    numTablesToSearch = numTables;
-
-  // Hash the query in each of the 'numTablesToSearch' hash tables using the
+  // Hash the queries in each of the 'numTablesToSearch' hash tables using the
   // 'numProj' projections for each table. This gives us 'numTablesToSearch'
-  // keys for the query where each key is a 'numProj' dimensional integer
+  // keys for each query where each key is a 'numProj' dimensional integer
   // vector.
 
-  // Compute the projection of the query in each table.
-  arma::mat allProjInTables(numProj, numTablesToSearch);
-  arma::mat queryCodesNotFloored(numProj, numTablesToSearch);
-  for (size_t i = 0; i < numTablesToSearch; i++)
-    queryCodesNotFloored.unsafe_col(i) = projections.slice(i).t() * queryPoint;
+  // The slices of the projection cube are stored one after another, so the
+  // first 'numTablesToSearch' slices form a single (d x (numProj *
+  // numTablesToSearch)) matrix, and the projections of the whole block of
+  // queries in every table are computed with one matrix multiplication.  For
+  // each query, column i of the projections is then the projection in table
+  // i.
+  const size_t stackedProj = numProj * numTablesToSearch;
+  const arma::mat stackedProjections(const_cast<double*>(
+      projections.memptr()), projections.n_rows, stackedProj, false, true);
+  const arma::mat queries(const_cast<double*>(querySet.colptr(begin)),
+      querySet.n_rows, count, false, true);
+
+  queryCodesNotFloored.set_size(numProj, numTablesToSearch * count);
+  arma::mat codes(queryCodesNotFloored.memptr(), stackedProj, count, false,
+      true);
+  codes = stackedProjections.t() * queries;
+  codes.each_col() += arma::vectorise(offsets.cols(0, numTablesToSearch - 1));
 
-  queryCodesNotFloored += offsets.cols(0, numTablesToSearch - 1);
   allProjInTables = arma::floor(queryCodesNotFloored / hashWidth);
 
+  // Compute the primary hash value of each key of each query into a bucket of
+  // the second hash table using the secondHashWeights.
+  primaryHashes = arma::conv_to<arma::Row<size_t>> // Floor by typecasting
+      ::from(secondHashWeights.t() * allProjInTables);
+  // Mod to compute 2nd-level codes.
+  primaryHashes.transform([this](size_t val) { return val % secondHashSize; });
+}
+
+template<typename SortPolicy>
+void LSHSearch<SortPolicy>::ReturnIndicesFromTable(
+    const size_t queryIndex,
+    const arma::mat& queryCodesNotFloored,
+    const arma::mat& allProjInTables,
+    const arma::Row<size_t>& primaryHashes,
+    const size_t numTablesToSearch,
+    const size_t T,
+    arma::uvec& referenceIndices,
+    arma::Col<arma::u16>& visited,
+    arma::u16& epoch) const
+{
+  // The codes of this query in table i are in column
+  // (queryIndex * numTablesToSearch + i).
+  const size_t firstCol = queryIndex * numTablesToSearch;
+
   // Use hashMat to store the primary probing codes and any additional codes
   // from multiprobe LSH.
   arma::Mat<size_t> hashMat;
   hashMat.set_size(T + 1, numTablesToSearch);
-
-  // Compute the primary hash value of each key of the query into a bucket of
-  // the secondHashTable using the secondHashWeights.
-  hashMat.row(0) = arma::conv_to<arma::Row<size_t>> // Floor by typecasting
-      ::from(secondHashWeights.t() * allProjInTables);
-  // Mod to compute 2nd-level codes.
-  for (size_t i = 0; i < numTablesToSearch; i++)
-    hashMat(0, i) = (hashMat(0, i) % secondHashSize);
+  hashMat.row(0) = primaryHashes.cols(firstCol,
+      firstCol + numTablesToSearch - 1);
 
   // Compute hash codes of additional probing bins.
   if (T > 0)
@@ -747,13 +886,13 @@ void LSHSearch<SortPolicy>::ReturnIndicesFromTable(
     {
       // Construct this table's probing sequence of length T.
       arma::mat additionalProbingBins;
-      GetAdditionalProbingBins(allProjInTables.unsafe_col(i),
-                                queryCodesNotFloored.unsafe_col(i),
-                                T,
-                                additionalProbingBins);
+      GetAdditionalProbingBins(allProjInTables.unsafe_col(firstCol + i),
+                               queryCodesNotFloored.unsafe_col(firstCol + i),
+                               T,
+                               additionalProbingBins);
 
-      // Map each probing bin to a bin in secondHashTable (just like we did for
-      // the primary hash table).
+      // Map each probing bin to a bin in the second hash table (just like we
+      // did for the primary hash table).
       hashMat(arma::span(1, T), i) = // Compute code of rows 1:end of column i
         arma::conv_to< arma::Col<size_t> >:: // floor by typecasting to size_t
         from(secondHashWeights.t() * additionalProbingBins);
@@ -770,82 +909,55 @@ void LSHSearch<SortPolicy>::ReturnIndicesFromTable(
     {
       const size_t hashInd = hashMat(p, i); // find query's bucket
       const size_t tableRow = bucketRowInHashTable[hashInd];
-      if (tableRow < secondHashSize)
-        maxNumPoints += bucketContentSize[tableRow]; // count bucket contents
+      if (tableRow < secondHashSize) // count bucket contents
+        maxNumPoints += bucketOffsets[tableRow + 1] - bucketOffsets[tableRow];
     }
   }
 
-  // There are two ways to proceed here:
-  // Either allocate a maxNumPoints-size vector, place all candidates, and run
-  // unique on the vector to discard duplicates.
-  // Or allocate a referenceSet.n_cols size vector (i.e. number of reference
-  // points) of zeros, and mark found indices as 1.
-  // Option 1 runs faster for small maxNumPoints but worse for larger values, so
-  // we choose based on a heuristic.
-  const float cutoff = 0.1;
-  const float selectivity = static_cast<float>(maxNumPoints) /
-      static_cast<float>(referenceSet.n_cols);
-
-  if (selectivity > cutoff)
+  // Each candidate is only kept the first time it is seen.  Instead of
+  // clearing a mark for every reference point for each query, points are
+  // stamped with a number that changes with every query, and the stamps only
+  // have to be cleared when that number wraps around.
+  if (visited.n_elem != referenceSet.n_cols)
   {
-    // Heuristic: larger maxNumPoints means we should use find() because it
-    // should be faster.
-    // Reference points hashed in the same bucket as the query are set to >0.
-    arma::Col<size_t> refPointsConsidered;
-    refPointsConsidered.zeros(referenceSet.n_cols);
-
-    for (size_t i = 0; i < numTablesToSearch; ++i) // for all tables
-    {
-      for (size_t p = 0; p < T + 1; ++p) // For entire probing sequence.
-      {
-        // get the sequence code
-        size_t hashInd = hashMat(p, i);
-        size_t tableRow = bucketRowInHashTable[hashInd];
-
-        if (tableRow < secondHashSize && bucketContentSize[tableRow] > 0)
-        {
-          // Pick the indices in the bucket corresponding to hashInd.
-          for (size_t j = 0; j < bucketContentSize[tableRow]; ++j)
-            refPointsConsidered[ secondHashTable[tableRow](j) ]++;
-        }
-      }
-    }
-
-    // Only keep reference points found in at least one bucket.
-    referenceIndices = arma::find(refPointsConsidered > 0);
-    return;
+    visited.zeros(referenceSet.n_cols);
+    epoch = 0;
   }
-  else
+  if (++epoch == 0)
   {
-    // Heuristic: smaller maxNumPoints means we should use unique() because it
-    // should be faster.
-    // Allocate space for the query's potential neighbors.
-    arma::uvec refPointsConsideredSmall;
-    refPointsConsideredSmall.zeros(maxNumPoints);
-
-    // Retrieve candidates.
-    size_t start = 0;
+    visited.zeros();
+    epoch = 1;
+  }
 
-    for (size_t i = 0; i < numTablesToSearch; ++i) // For all tables
+  // Retrieve candidates.
+  referenceIndices.set_size(maxNumPoints);
+  size_t numCandidates = 0;
+  for (size_t i = 0; i < numTablesToSearch; ++i) // For all tables.
+  {
+    for (size_t p = 0; p < T + 1; ++p) // For entire probing sequence.
     {
-      for (size_t p = 0; p < T + 1; ++p)
-      {
-        const size_t hashInd =  hashMat(p, i); // Find the query's bucket.
-        const size_t tableRow = bucketRowInHashTable[hashInd];
+      const size_t hashInd = hashMat(p, i); // Find the query's bucket.
+      const size_t tableRow = bucketRowInHashTable[hashInd];
+      if (tableRow >= secondHashSize)
+        continue;
 
-        if (tableRow < secondHashSize)
+      for (size_t j = bucketOffsets[tableRow]; j < bucketOffsets[tableRow + 1];
+          ++j)
+      {
+        const arma::u32 index = bucketContents[j];
+        if (visited[index] != epoch)
         {
-          // Store all secondHashTable points in the candidates set.
-          for (size_t j = 0; j < bucketContentSize[tableRow]; ++j)
-            refPointsConsideredSmall(start++) = secondHashTable[tableRow](j);
-       }
+          visited[index] = epoch;
+          referenceIndices[numCandidates++] = index;
+        }
       }
     }
-
-    // Keep only one copy of each candidate.
-    referenceIndices = arma::unique(refPointsConsideredSmall);
-    return;
   }
+
+  // Keep one copy of each candidate, in increasing order, so that the
+  // reference points are visited in memory order.
+  referenceIndices.resize(numCandidates);
+  std::sort(referenceIndices.begin(), referenceIndices.end());
 }
 
 // Search for nearest neighbors in a given query set.
@@ -900,33 +1012,62 @@ void LSHSearch<SortPolicy>::Search(const arma::mat& querySet,
     Log::Info << "Running multiprobe LSH with " << Teffective
         <<" additional probing bins per table per query." << std::endl;
 
+  // Decide on the number of tables to look into.  If no user input is given,
+  // search all; make sure that the existing number of tables is not exceeded.
+  const size_t tablesToSearch = (numTablesToSearch == 0 ||
+      numTablesToSearch > numTables) ? numTables : numTablesToSearch;
+
+  // The queries are hashed in blocks, so that the projections of a whole
+  // block are computed with one matrix multiplication.
+  const size_t blockSize = 64;
+  const size_t numBlocks = (querySet.n_cols + blockSize - 1) / blockSize;
+
   size_t avgIndicesReturned = 0;
 
   Timer::Start("computing_neighbors");
 
-  // Parallelization to process more than one query at a time.
-  #pragma omp parallel for \
-      shared(resultingNeighbors, distances) \
-      schedule(dynamic)\
+  // Parallelization to process more than one block of queries at a time.
+  #pragma omp parallel shared(resultingNeighbors, distances) \
       reduction(+:avgIndicesReturned)
-  for (omp_size_t i = 0; i < (omp_size_t) querySet.n_cols; ++i)
   {
-    // Go through every query point.
-    // Hash every query into every hash table and eventually into the
-    // 'secondHashTable' to obtain the neighbor candidates.
+    // Each thread keeps its own stamps for deduplicating candidates, and its
+    // own hash codes of the current block.
+    arma::Col<arma::u16> visited;
+    arma::u16 epoch = 0;
     arma::uvec refIndices;
-    ReturnIndicesFromTable(querySet.col(i), refIndices, numTablesToSearch,
-        Teffective);
-
-    // An informative book-keeping for the number of neighbor candidates
-    // returned on average.
-    // Make atomic to avoid race conditions when multiple threads are running
-    // #pragma omp atomic
-    avgIndicesReturned = avgIndicesReturned + refIndices.n_elem;
-
-    // Sequentially go through all the candidates and save the best 'k'
-    // candidates.
-    BaseCase(i, refIndices, k, querySet, resultingNeighbors, distances);
+    arma::mat queryCodesNotFloored, allProjInTables;
+    arma::Row<size_t> primaryHashes;
+
+    #pragma omp for schedule(dynamic)
+    for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+    {
+      const size_t begin = b * blockSize;
+      const size_t count = std::min(blockSize,
+          (size_t) querySet.n_cols - begin);
+
+      // Hash every query of the block into every hash table.
+      HashQueries(querySet, begin, count, tablesToSearch,
+          queryCodesNotFloored, allProjInTables, primaryHashes);
+
+      for (size_t q = 0; q < count; ++q)
+      {
+        // Go through every query point.
+        // Hash every query into the second hash table (probing any
+        // additional bins) to obtain the neighbor candidates.
+        ReturnIndicesFromTable(q, queryCodesNotFloored, allProjInTables,
+            primaryHashes, tablesToSearch, Teffective, refIndices, visited,
+            epoch);
+
+        // An informative book-keeping for the number of neighbor candidates
+        // returned on average.
+        avgIndicesReturned += refIndices.n_elem;
+
+        // Compute the distances to all the candidates and save the best 'k'
+        // candidates.
+        BaseCase(begin + q, refIndices, k, querySet, resultingNeighbors,
+            distances);
+      }
+    }
   }
 
   Timer::Stop("computing_neighbors");
@@ -966,33 +1107,61 @@ Search(const size_t k,
     Log::Info << "Running multiprobe LSH with " << Teffective <<
       " additional probing bins per table per query."<< std::endl;
 
+  // Decide on the number of tables to look into.  If no user input is given,
+  // search all; make sure that the existing number of tables is not exceeded.
+  const size_t tablesToSearch = (numTablesToSearch == 0 ||
+      numTablesToSearch > numTables) ? numTables : numTablesToSearch;
+
+  // The queries are hashed in blocks, so that the projections of a whole
+  // block are computed with one matrix multiplication.
+  const size_t blockSize = 64;
+  const size_t numBlocks = (referenceSet.n_cols + blockSize - 1) / blockSize;
+
   size_t avgIndicesReturned = 0;
 
   Timer::Start("computing_neighbors");
 
-  // Parallelization to process more than one query at a time.
-  #pragma omp parallel for \
-      shared(resultingNeighbors, distances) \
-      schedule(dynamic)\
+  // Parallelization to process more than one block of queries at a time.
+  #pragma omp parallel shared(resultingNeighbors, distances) \
       reduction(+:avgIndicesReturned)
-  for (omp_size_t i = 0; i < (omp_size_t) referenceSet.n_cols; ++i)
   {
-    // Go through every query point.
-    // Hash every query into every hash table and eventually into the
-    // 'secondHashTable' to obtain the neighbor candidates.
+    // Each thread keeps its own stamps for deduplicating candidates, and its
+    // own hash codes of the current block.
+    arma::Col<arma::u16> visited;
+    arma::u16 epoch = 0;
     arma::uvec refIndices;
-    ReturnIndicesFromTable(referenceSet.col(i), refIndices, numTablesToSearch,
-        Teffective);
-
-    // An informative book-keeping for the number of neighbor candidates
-    // returned on average.
-    // Make atomic to avoid race conditions when multiple threads are running.
-    // #pragma omp atomic
-    avgIndicesReturned += refIndices.n_elem;
-
-    // Sequentially go through all the candidates and save the best 'k'
-    // candidates.
-    BaseCase(i, refIndices, k, resultingNeighbors, distances);
+    arma::mat queryCodesNotFloored, allProjInTables;
+    arma::Row<size_t> primaryHashes;
+
+    #pragma omp for schedule(dynamic)
+    for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+    {
+      const size_t begin = b * blockSize;
+      const size_t count = std::min(blockSize,
+          (size_t) referenceSet.n_cols - begin);
+
+      // Hash every query of the block into every hash table.
+      HashQueries(referenceSet, begin, count, tablesToSearch,
+          queryCodesNotFloored, allProjInTables, primaryHashes);
+
+      for (size_t q = 0; q < count; ++q)
+      {
+        // Go through every query point.
+        // Hash every query into the second hash table (probing any
+        // additional bins) to obtain the neighbor candidates.
+        ReturnIndicesFromTable(q, queryCodesNotFloored, allProjInTables,
+            primaryHashes, tablesToSearch, Teffective, refIndices, visited,
+            epoch);
+
+        // An informative book-keeping for the number of neighbor candidates
+        // returned on average.
+        avgIndicesReturned += refIndices.n_elem;
+
+        // Compute the distances to all the candidates and save the best 'k'
+        // candidates.
+        BaseCase(begin + q, refIndices, k, resultingNeighbors, distances);
+      }
+    }
   }
 
   Timer::Stop("computing_neighbors");
@@ -1066,73 +1235,85 @@ void LSHSearch<SortPolicy>::serialize(Archive& ar,
   ar & BOOST_SERIALIZATION_NVP(bucketSize);
   // needs specific handling for new version
 
-  // Backward compatibility: in older versions of LSHSearch, the secondHashTable
-  // was stored as an arma::Mat<size_t>.  So we need to properly load that, then
-  // prune it down to size.
-  if (version == 0)
+  // Backward compatibility: before version 2, the buckets were stored as a
+  // std::vector<arma::Col<size_t>> along with the size of each bucket, so we
+  // load that and pack it into the contiguous table.
+  if (version < 2)
   {
-    arma::Mat<size_t> tmpSecondHashTable;
-    ar & BOOST_SERIALIZATION_NVP(tmpSecondHashTable);
-
-    // The old secondHashTable was stored in row-major format, so we transpose
-    // it.
-    tmpSecondHashTable = tmpSecondHashTable.t();
+    std::vector<arma::Col<size_t>> secondHashTable;
+    arma::Col<size_t> bucketContentSize;
 
-    secondHashTable.resize(tmpSecondHashTable.n_cols);
-    for (size_t i = 0; i < tmpSecondHashTable.n_cols; ++i)
+    // In version 0, the secondHashTable was stored as an arma::Mat<size_t>.  So
+    // we need to properly load that, then prune it down to size.
+    if (version == 0)
     {
-      // Find length of each column.  We know we are at the end of the list when
-      // the value referenceSet.n_cols is seen.
+      arma::Mat<size_t> tmpSecondHashTable;
+      ar & BOOST_SERIALIZATION_NVP(tmpSecondHashTable);
 
-      size_t len = 0;
-      for (; len < tmpSecondHashTable.n_rows; ++len)
-        if (tmpSecondHashTable(len, i) == referenceSet.n_cols)
-          break;
+      // The old secondHashTable was stored in row-major format, so we transpose
+      // it.
+      tmpSecondHashTable = tmpSecondHashTable.t();
 
-      // Set the size of the new column correctly.
-      secondHashTable[i].set_size(len);
-      for (size_t j = 0; j < len; ++j)
-        secondHashTable[i](j) = tmpSecondHashTable(j, i);
-    }
-  }
-  else
-  {
-    size_t tables;
-    if (Archive::is_saving::value)
-      tables = secondHashTable.size();
-    ar & BOOST_SERIALIZATION_NVP(tables);
+      secondHashTable.resize(tmpSecondHashTable.n_cols);
+      for (size_t i = 0; i < tmpSecondHashTable.n_cols; ++i)
+      {
+        // Find length of each column.  We know we are at the end of the list
+        // when the value referenceSet.n_cols is seen.
+
+        size_t len = 0;
+        for (; len < tmpSecondHashTable.n_rows; ++len)
+          if (tmpSecondHashTable(len, i) == referenceSet.n_cols)
+            break;
+
+        // Set the size of the new column correctly.
+        secondHashTable[i].set_size(len);
+        for (size_t j = 0; j < len; ++j)
+          secondHashTable[i](j) = tmpSecondHashTable(j, i);
+      }
 
-    // Set size of second hash table if needed.
-    if (Archive::is_loading::value)
+      // Version 0 also held bucketContentSize for all possible buckets (of
+      // size secondHashSize).  We can't compress it until we have
+      // bucketRowInHashTable, so we also have to load that.
+      arma::Col<size_t> tmpBucketContentSize;
+      ar & BOOST_SERIALIZATION_NVP(tmpBucketContentSize);
+      ar & BOOST_SERIALIZATION_NVP(bucketRowInHashTable);
+
+      // Compress into a smaller vector by just dropping all of the zeros.
+      bucketContentSize.zeros(secondHashTable.size());
+      for (size_t i = 0; i < tmpBucketContentSize.n_elem; ++i)
+        if (tmpBucketContentSize[i] > 0)
+          bucketContentSize[bucketRowInHashTable[i]] = tmpBucketContentSize[i];
+    }
+    else
     {
-      secondHashTable.clear();
+      size_t tables;
+      ar & BOOST_SERIALIZATION_NVP(tables);
       secondHashTable.resize(tables);
-    }
 
-    ar & BOOST_SERIALIZATION_NVP(secondHashTable);
-  }
+      ar & BOOST_SERIALIZATION_NVP(secondHashTable);
+      ar & BOOST_SERIALIZATION_NVP(bucketContentSize);
+      ar & BOOST_SERIALIZATION_NVP(bucketRowInHashTable);
+    }
 
-  // Backward compatibility: old versions of LSHSearch held bucketContentSize
-  // for all possible buckets (of size secondHashSize), but now we hold a
-  // compressed representation.
-  if (version == 0)
-  {
-    // The vector was stored in the old uncompressed form.  So we need to shrink
-    // it.  But we can't do that until we have bucketRowInHashTable, so we also
-    // have to load that.
-    arma::Col<size_t> tmpBucketContentSize;
-    ar & BOOST_SERIALIZATION_NVP(tmpBucketContentSize);
-    ar & BOOST_SERIALIZATION_NVP(bucketRowInHashTable);
+    // Now pack the buckets.
+    bucketOffsets.zeros(secondHashTable.size() + 1);
+    for (size_t i = 0; i < secondHashTable.size(); ++i)
+    {
+      bucketOffsets[i + 1] = bucketOffsets[i] +
+          std::min((size_t) secondHashTable[i].n_elem, bucketContentSize[i]);
+    }
 
-    // Compress into a smaller vector by just dropping all of the zeros.
-    bucketContentSize.set_size(secondHashTable.size());
-    for (size_t i = 0; i < tmpBucketContentSize.n_elem; ++i)
-      if (tmpBucketContentSize[i] > 0)
-        bucketContentSize[bucketRowInHashTable[i]] = tmpBucketContentSize[i];
+    bucketContents.set_size(bucketOffsets[secondHashTable.size()]);
+    for (size_t i = 0; i < secondHashTable.size(); ++i)
+    {
+      for (size_t j = bucketOffsets[i]; j < bucketOffsets[i + 1]; ++j)
+        bucketContents[j] = secondHashTable[i][j - bucketOffsets[i]];
+    }
   }
   else
   {
-    ar & BOOST_SERIALIZATION_NVP(bucketContentSize);
+    ar & BOOST_SERIALIZATION_NVP(bucketOffsets);
+    ar & BOOST_SERIALIZATION_NVP(bucketContents);
     ar & BOOST_SERIALIZATION_NVP(bucketRowInHashTable);
   }
 
@@ -19,12 +19,18 @@ MatrixCompletion::MatrixCompletion(const size_t m,
                                    const size_t n,
                                    const arma::umat& indices,
                                    const arma::vec& values,
-                                   const size_t r) :
-    m(m), n(n), indices(indices), values(values),
-    sdp(indices.n_cols, 0, arma::randu<arma::mat>(m + n, r))
+                                   const size_t r,
+                                   const Solver solver) :
+    m(m), n(n), indices(indices), values(values), rank(r), solver(solver),
+    lambda(1e-6), maxIterations(100),
+    // Alternating least squares does not need the SDP, so it is left empty.
+    sdp((solver == NUCLEAR_NORM_SDP) ? indices.n_cols : 0, 0,
+        (solver == NUCLEAR_NORM_SDP) ? arma::mat(arma::randu<arma::mat>(m + n,
+        r)) : arma::mat())
 {
   CheckValues();
-  InitSDP();
+  if (solver == NUCLEAR_NORM_SDP)
+    InitSDP();
 }
 
 MatrixCompletion::MatrixCompletion(const size_t m,
@@ -32,7 +38,8 @@ MatrixCompletion::MatrixCompletion(const size_t m,
                                    const arma::umat& indices,
                                    const arma::vec& values,
                                    const arma::mat& initialPoint) :
-    m(m), n(n), indices(indices), values(values),
+    m(m), n(n), indices(indices), values(values), rank(initialPoint.n_cols),
+    solver(NUCLEAR_NORM_SDP), lambda(1e-6), maxIterations(100),
     sdp(indices.n_cols, 0, initialPoint)
 {
   CheckValues();
@@ -44,6 +51,8 @@ MatrixCompletion::MatrixCompletion(const size_t m,
                                    const arma::umat& indices,
                                    const arma::vec& values) :
     m(m), n(n), indices(indices), values(values),
+    rank(DefaultRank(m, n, indices.n_cols)), solver(NUCLEAR_NORM_SDP),
+    lambda(1e-6), maxIterations(100),
     sdp(indices.n_cols, 0,
         arma::randu<arma::mat>(m + n, DefaultRank(m, n, indices.n_cols)))
 {
@@ -92,12 +101,43 @@ void MatrixCompletion::InitSDP()
 
 void MatrixCompletion::Recover(arma::mat& recovered)
 {
+  if (solver == ALTERNATING_LEAST_SQUARES)
+  {
+    arma::mat w, h;
+    Recover(w, h);
+    recovered = w * h;
+    return;
+  }
+
   recovered = sdp.Function().GetInitialPoint();
   sdp.Optimize(recovered);
   recovered = recovered * trans(recovered);
   recovered = recovered(arma::span(0, m - 1), arma::span(m, m + n - 1));
 }
 
+void MatrixCompletion::Recover(arma::mat& w, arma::mat& h)
+{
+  if (solver == NUCLEAR_NORM_SDP)
+  {
+    // The solution of the SDP is R R^T, and the completed matrix is its upper
+    // right block.
+    arma::mat r = sdp.Function().GetInitialPoint();
+    sdp.Optimize(r);
+    w = r.rows(0, m - 1);
+    h = trans(r.rows(m, m + n - 1));
+    return;
+  }
+
+  // The known entries are the nonzero entries of a sparse matrix, so only they
+  // are fit.
+  const arma::sp_mat known(indices, values, m, n);
+
+  amf::AMF<amf::MaxIterationTermination, amf::RandomInitialization,
+      amf::ParallelALSUpdate> als(amf::MaxIterationTermination(maxIterations),
+      amf::RandomInitialization(), amf::ParallelALSUpdate(lambda));
+  als.Apply(known, rank, w, h);
+}
+
 size_t MatrixCompletion::DefaultRank(const size_t m,
                                      const size_t n,
                                      const size_t p)
@@ -15,6 +15,8 @@
 
 #include <mlpack/core/optimizers/sdp/sdp.hpp>
 #include <mlpack/core/optimizers/sdp/lrsdp.hpp>
+#include <mlpack/methods/amf/amf.hpp>
+#include <mlpack/methods/amf/termination_policies/max_iteration_termination.hpp>
 
 namespace mlpack {
 namespace matrix_completion {
@@ -48,11 +50,38 @@ namespace matrix_completion {
  * mc.Recover(recovered);
  * @endcode
  *
- * @see LRSDP
+ * The SDP has one constraint per known entry, so it is only practical for up
+ * to about 100,000 known entries.  For larger problems, the matrix can instead
+ * be completed with a rank-r factorization X = W H, found with parallel
+ * alternating least squares over the known entries (AMF with
+ * ParallelALSUpdate).  The factors W (m x r) and H (r x n) have the same
+ * layout as those of AMF, and can be recovered directly instead of the whole
+ * matrix, which may be too large to hold in memory:
+ *
+ * @code
+ * MatrixCompletion mc(m, n, indices, values, r,
+ *     MatrixCompletion::ALTERNATING_LEAST_SQUARES);
+ * arma::mat w, h;
+ * mc.Recover(w, h); // The completed matrix is w * h.
+ * @endcode
+ *
+ * Alternating least squares stores the known entries in a sparse matrix, so
+ * known entries whose value is exactly zero are ignored by it.
+ *
+ * @see LRSDP, AMF, ParallelALSUpdate
  */
 class MatrixCompletion
 {
  public:
+  //! The solvers that can be used to complete the matrix.
+  enum Solver
+  {
+    //! Minimize the nuclear norm, solving an SDP with LRSDP.
+    NUCLEAR_NORM_SDP,
+    //! Find a rank-r factorization with parallel alternating least squares.
+    ALTERNATING_LEAST_SQUARES
+  };
+
   /**
    * Construct a matrix completion problem, specifying the maximum rank of the
    * solution.
@@ -64,12 +93,14 @@ class MatrixCompletion
    * @param values Vector containing the values of the known entries (must be
    *    length p).
    * @param r Maximum rank of solution.
+   * @param solver Solver to use to complete the matrix.
    */
   MatrixCompletion(const size_t m,
                    const size_t n,
                    const arma::umat& indices,
                    const arma::vec& values,
-                   const size_t r);
+                   const size_t r,
+                   const Solver solver = NUCLEAR_NORM_SDP);
 
   /**
    * Construct a matrix completion problem, specifying the initial point of the
@@ -111,7 +142,29 @@ class MatrixCompletion
    */
   void Recover(arma::mat& recovered);
 
-  //! Return the underlying SDP.
+  /**
+   * Fill in the remaining values, and return the completed matrix as the
+   * product w * h of two factors, without forming it.
+   *
+   * @param w Will contain the m x r left factor.
+   * @param h Will contain the r x n right factor.
+   */
+  void Recover(arma::mat& w, arma::mat& h);
+
+  //! Get the solver used to complete the matrix.
+  Solver SolverType() const { return solver; }
+
+  //! Get the regularization constant of alternating least squares.
+  double Lambda() const { return lambda; }
+  //! Modify the regularization constant of alternating least squares.
+  double& Lambda() { return lambda; }
+
+  //! Get the number of iterations of alternating least squares.
+  size_t MaxIterations() const { return maxIterations; }
+  //! Modify the number of iterations of alternating least squares.
+  size_t& MaxIterations() { return maxIterations; }
+
+  //! Return the underlying SDP (empty if alternating least squares is used).
   const optimization::LRSDP<optimization::SDP<arma::sp_mat>>& Sdp() const
   {
     return sdp;
@@ -128,6 +181,14 @@ class MatrixCompletion
   arma::umat indices;
   //! Vector containing the values of the known entries.
   arma::mat values;
+  //! Rank of the factorization (for alternating least squares).
+  size_t rank;
+  //! Solver used to complete the matrix.
+  Solver solver;
+  //! Regularization constant of alternating least squares.
+  double lambda;
+  //! Number of iterations of alternating least squares.
+  size_t maxIterations;
 
   //! The underlying SDP to be solved.
   optimization::LRSDP<optimization::SDP<arma::sp_mat>> sdp;
@@ -65,7 +65,10 @@ class MeanShift
             const KernelType kernel = KernelType());
 
   /**
-   * Give an estimation of radius based on given dataset.
+   * Give an estimation of radius based on given dataset: the mean, over the
+   * points, of the distance to the farthest of their (ratio * n) nearest
+   * neighbors.  The neighbors are searched for blocks of points at a time, so
+   * that the memory used stays bounded for large datasets.
    *
    * @param data Dataset for estimation.
    * @param ratio Percentage of dataset to use for nearest neighbor search.
@@ -74,7 +77,12 @@ class MeanShift
 
   /**
    * Perform mean shift clustering on the data, returning a list of cluster
-   * assignments and centroids.
+   * assignments and centroids.  All the seeds that have not converged are
+   * shifted together: each iteration finds their neighbors with one batched
+   * range search, and then computes their shifted positions in parallel with
+   * OpenMP.  Converged seeds closer than the radius to a centroid found from
+   * an earlier seed are merged into it, using a range search between the
+   * converged seeds.
    *
    * @tparam MatType Type of matrix.
    * @param data Dataset to cluster.
@@ -133,7 +141,7 @@ class MeanShift
   CalculateCentroid(const MatType& data,
                     const std::vector<size_t>& neighbors,
                     const std::vector<double>& distances,
-                    arma::colvec& centroid);
+                    arma::colvec& centroid) const;
 
   /**
    * Use mean to calculate new centroid given dataset and valid neighbors.
@@ -148,7 +156,7 @@ class MeanShift
   CalculateCentroid(const MatType& data,
                     const std::vector<size_t>& neighbors,
                     const std::vector<double>&, /*unused*/
-                    arma::colvec& centroid);
+                    arma::colvec& centroid) const;
 
   /**
    * If distance of two centroids is less than radius, one will be removed.
@@ -57,18 +57,39 @@ EstimateRadius(const MatType& data, double ratio)
   /**
    * For each point in dataset, select nNeighbors nearest points and get
    * nNeighbors distances.  Use the maximum distance to estimate the duplicate
-   * threshhold.
+   * threshhold.  The nNeighbors x n results of a search for all the points
+   * would be huge for large datasets, so the points are searched in blocks
+   * that hold about ten million results.
    */
   const size_t nNeighbors = size_t(data.n_cols * ratio);
+  const size_t blockSize = std::max((size_t) 1,
+      (size_t) 10000000 / std::max(nNeighbors, (size_t) 1));
+  const size_t nBlockNeighbors = std::min(nNeighbors + 1,
+      (size_t) data.n_cols);
   arma::Mat<size_t> neighbors;
   arma::mat distances;
-  neighborSearch.Search(nNeighbors, neighbors, distances);
+  double sumDistances = 0.0;
+  for (size_t begin = 0; begin < data.n_cols; begin += blockSize)
+  {
+    const size_t end = std::min(begin + blockSize, (size_t) data.n_cols) - 1;
+    if (blockSize >= data.n_cols)
+    {
+      neighborSearch.Search(nNeighbors, neighbors, distances);
+    }
+    else
+    {
+      // Each point of the block finds itself (at distance 0) too, so one more
+      // neighbor is needed.
+      const MatType block(data.cols(begin, end));
+      neighborSearch.Search(block, nBlockNeighbors, neighbors, distances);
+    }
 
-  // Get max distance for each point.
-  arma::rowvec maxDistances = max(distances);
+    // Get max distance for each point.
+    sumDistances += arma::accu(arma::max(distances));
+  }
 
   // Calculate and return the radius.
-  return sum(maxDistances) / (double) data.n_cols;
+  return sumDistances / (double) data.n_cols;
 }
 
 // Class to compare two vectors.
@@ -137,7 +158,7 @@ MeanShift<UseKernel, KernelType, MatType>::
 CalculateCentroid(const MatType& data,
                   const std::vector<size_t>& neighbors,
                   const std::vector<double>& distances,
-                  arma::colvec& centroid)
+                  arma::colvec& centroid) const
 {
   double sumWeight = 0;
   for (size_t i = 0; i < neighbors.size(); ++i)
@@ -167,7 +188,7 @@ MeanShift<UseKernel, KernelType, MatType>::
 CalculateCentroid(const MatType& data,
                   const std::vector<size_t>& neighbors,
                   const std::vector<double>&, /*unused*/
-                  arma::colvec& centroid)
+                  arma::colvec& centroid) const
 {
   for (size_t i = 0; i < neighbors.size(); ++i)
     centroid += data.unsafe_col(neighbors[i]);
@@ -201,8 +222,13 @@ inline void MeanShift<UseKernel, KernelType, MatType>::Cluster(
     pSeeds = &seeds;
   }
 
-  // Holds all centroids before removing duplicate ones.
-  arma::mat allCentroids(pSeeds->n_rows, pSeeds->n_cols);
+  // Holds all centroids before removing duplicate ones.  Initially, each
+  // centroid is the seed itself.
+  arma::mat allCentroids(*pSeeds);
+
+  // Whether each seed converged (seeds that have too few neighbors or that do
+  // not converge in maxIterations iterations don't give a centroid).
+  arma::Col<size_t> converged(pSeeds->n_cols, arma::fill::zeros);
 
   assignments.set_size(data.n_cols);
 
@@ -211,54 +237,76 @@ inline void MeanShift<UseKernel, KernelType, MatType>::Cluster(
   std::vector<std::vector<size_t> > neighbors;
   std::vector<std::vector<double> > distances;
 
-  // For each seed, perform mean shift algorithm.
-  for (size_t i = 0; i < pSeeds->n_cols; ++i)
+  // The seeds that are still being shifted.
+  arma::uvec active;
+  if (pSeeds->n_cols > 0)
+    active = arma::linspace<arma::uvec>(0, pSeeds->n_cols - 1, pSeeds->n_cols);
+  for (size_t completedIterations = 0; completedIterations < maxIterations &&
+       active.n_elem > 0; completedIterations++)
   {
-    // Initial centroid is the seed itself.
-    allCentroids.col(i) = pSeeds->unsafe_col(i);
-    for (size_t completedIterations = 0; completedIterations < maxIterations;
-         completedIterations++)
+    // Find the neighbors of all the active seeds at once.
+    const arma::mat activeCentroids = allCentroids.cols(active);
+    rangeSearcher.Search(activeCentroids, validRadius, neighbors, distances);
+
+    // Shift each active seed; the seeds are independent.
+    arma::Col<size_t> stillActive(active.n_elem, arma::fill::zeros);
+    #pragma omp parallel for schedule(dynamic)
+    for (omp_size_t j = 0; j < (omp_size_t) active.n_elem; ++j)
     {
-      // Store new centroid in this.
-      arma::colvec newCentroid = arma::zeros<arma::colvec>(pSeeds->n_rows);
-
-      rangeSearcher.Search(allCentroids.unsafe_col(i), validRadius,
-          neighbors, distances);
-      if (neighbors[0].size() <= 1)
-        break;
+      const size_t i = active[j];
+      if (neighbors[j].size() <= 1)
+        continue;
 
       // Calculate new centroid.
-      if (!CalculateCentroid(data, neighbors[0], distances[0], newCentroid))
+      arma::colvec newCentroid = arma::zeros<arma::colvec>(pSeeds->n_rows);
+      if (!CalculateCentroid(data, neighbors[j], distances[j], newCentroid))
         newCentroid = allCentroids.unsafe_col(i);
 
       // If the mean shift vector is small enough, it has converged.
       if (metric::EuclideanDistance::Evaluate(newCentroid,
           allCentroids.unsafe_col(i)) < 1e-3 * radius)
       {
-        // Determine if the new centroid is duplicate with old ones.
-        bool isDuplicated = false;
-        for (size_t k = 0; k < centroids.n_cols; ++k)
-        {
-          const double distance = metric::EuclideanDistance::Evaluate(
-              allCentroids.unsafe_col(i), centroids.unsafe_col(k));
-          if (distance < radius)
-          {
-            isDuplicated = true;
-            break;
-          }
-        }
+        converged[i] = 1;
+      }
+      else
+      {
+        // Update the centroid.
+        allCentroids.col(i) = newCentroid;
+        stillActive[j] = 1;
+      }
+    }
+
+    active = active.elem(arma::find(stillActive));
+  }
 
-        if (!isDuplicated)
-          centroids.insert_cols(centroids.n_cols, allCentroids.unsafe_col(i));
+  // Now remove the duplicate centroids: in the order of the seeds, a
+  // converged seed gives a new centroid unless it is closer than the radius to
+  // a centroid given by an earlier seed.
+  const arma::mat candidates = allCentroids.cols(arma::find(converged));
+  arma::Col<size_t> isCentroid(candidates.n_cols, arma::fill::zeros);
+  if (candidates.n_cols > 0)
+  {
+    range::RangeSearch<> duplicateSearcher(candidates);
+    duplicateSearcher.Search(validRadius, neighbors, distances);
 
-        // Get out of the loop.
-        break;
+    for (size_t i = 0; i < candidates.n_cols; ++i)
+    {
+      bool isDuplicated = false;
+      for (size_t j = 0; j < neighbors[i].size(); ++j)
+      {
+        if (neighbors[i][j] < i && isCentroid[neighbors[i][j]] &&
+            distances[i][j] < radius)
+        {
+          isDuplicated = true;
+          break;
+        }
       }
 
-      // Update the centroid.
-      allCentroids.col(i) = newCentroid;
+      if (!isDuplicated)
+        isCentroid[i] = 1;
     }
   }
+  centroids = candidates.cols(arma::find(isCentroid));
 
   // Assign centroids to each point.
   neighbor::KNN neighborSearcher(centroids);
@@ -3,11 +3,9 @@
  * @author Ryan Curtin
  *
  * An implementation of Maximum Variance Unfolding.  This file defines an MVU
- * class as well as a class representing the objective function (a semidefinite
- * program) which MVU seeks to minimize.  Minimization is performed by the
- * Augmented Lagrangian optimizer (which in turn uses the L-BFGS optimizer).
- *
- * Note: this implementation of MVU does not work.  See #189.
+ * class; the objective function which MVU seeks to minimize is the MVUFunction
+ * class.  Minimization is performed by the Augmented Lagrangian optimizer
+ * (which in turn uses the L-BFGS optimizer).
  *
  * mlpack is free software; you may redistribute it and/or modify it under the
  * terms of the 3-clause BSD license.  You should have received a copy of the
@@ -32,8 +30,25 @@ namespace mvu {
 class MVU
 {
  public:
+  /**
+   * Create the MVU object for the given dataset.
+   *
+   * @param dataIn Dataset to unfold (one point per column).
+   */
   MVU(const arma::mat& dataIn);
 
+  /**
+   * Unfold the dataset: find the points of the given dimensionality with the
+   * largest variance such that the distances between each point and its
+   * nearest neighbors are kept.  A std::invalid_argument is thrown if newDim
+   * or numNeighbors is not valid for the dataset.
+   *
+   * @param newDim Dimensionality of the unfolded dataset.
+   * @param numNeighbors Number of nearest neighbors of each point whose
+   *     distances are kept.
+   * @param outputCoordinates Matrix to store the unfolded dataset in (one
+   *     point per column).
+   */
   void Unfold(const size_t newDim,
               const size_t numNeighbors,
               arma::mat& outputCoordinates);
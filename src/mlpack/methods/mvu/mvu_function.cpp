@@ -0,0 +1,242 @@
+/**
+ * @file mvu_function.cpp
+ *
+ * Implementation of the MVUFunction class, and of the specialization of
+ * AugLagrangianFunction for it.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "mvu_function.hpp"
+
+#include <mlpack/methods/neighbor_search/neighbor_search.hpp>
+
+using namespace mlpack;
+using namespace mlpack::mvu;
+using namespace mlpack::neighbor;
+
+MVUFunction::MVUFunction(const arma::mat& data,
+                         const size_t newDim,
+                         const size_t numNeighbors)
+{
+  if (newDim == 0 || newDim > data.n_rows)
+  {
+    std::ostringstream oss;
+    oss << "MVUFunction::MVUFunction(): the new dimensionality (" << newDim
+        << ") must be between 1 and the dimensionality of the dataset ("
+        << data.n_rows << ")";
+    throw std::invalid_argument(oss.str());
+  }
+
+  if (numNeighbors == 0 || numNeighbors >= data.n_cols)
+  {
+    std::ostringstream oss;
+    oss << "MVUFunction::MVUFunction(): the number of neighbors ("
+        << numNeighbors << ") must be between 1 and the number of points minus "
+        << "one (" << data.n_cols - 1 << ")";
+    throw std::invalid_argument(oss.str());
+  }
+
+  const size_t n = data.n_cols;
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+
+  KNN knn(data);
+  knn.Search(numNeighbors, neighbors, distances);
+
+  // If two points are neighbors of each other, the constraint between them is
+  // only kept for the point with the smaller index.
+  auto keep = [&neighbors](const size_t i, const size_t j)
+  {
+    if (i < j)
+      return true;
+
+    for (size_t k = 0; k < neighbors.n_rows; ++k)
+      if (neighbors(k, j) == i)
+        return false;
+
+    return true;
+  };
+
+  // Count the constraints of each point, so that each point knows where to
+  // write its constraints, and they can be written in parallel.
+  arma::uvec offsets(n + 1, arma::fill::zeros);
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) n; ++i)
+  {
+    for (size_t k = 0; k < numNeighbors; ++k)
+      if (keep(i, neighbors(k, i)))
+        ++offsets[i + 1];
+  }
+  offsets = arma::cumsum(offsets);
+
+  const size_t numConstraints = offsets[n];
+  first.set_size(numConstraints);
+  second.set_size(numConstraints);
+  squaredDistances.set_size(numConstraints);
+
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) n; ++i)
+  {
+    size_t c = offsets[i];
+    for (size_t k = 0; k < numNeighbors; ++k)
+    {
+      if (keep(i, neighbors(k, i)))
+      {
+        first[c] = i;
+        second[c] = neighbors(k, i);
+        squaredDistances[c] = distances(k, i) * distances(k, i);
+        ++c;
+      }
+    }
+  }
+
+  // List the constraints incident to each point.
+  incidentOffsets.zeros(n + 1);
+  for (size_t c = 0; c < numConstraints; ++c)
+  {
+    ++incidentOffsets[first[c] + 1];
+    ++incidentOffsets[second[c] + 1];
+  }
+  incidentOffsets = arma::cumsum(incidentOffsets);
+
+  incidentConstraints.set_size(2 * numConstraints);
+  arma::uvec position = incidentOffsets.head(n);
+  for (size_t c = 0; c < numConstraints; ++c)
+  {
+    incidentConstraints[position[first[c]]++] = c;
+    incidentConstraints[position[second[c]]++] = c;
+  }
+
+  // Start from the projection of the data on its principal components, which
+  // nearly satisfies the constraints if the data is close to a linear
+  // subspace.  The eigenvalues are in ascending order.
+  arma::mat centered = data;
+  centered.each_col() -= arma::mean(data, 1);
+  arma::vec eigenvalues;
+  arma::mat eigenvectors;
+  arma::eig_sym(eigenvalues, eigenvectors, centered * centered.t());
+  initialPoint = arma::fliplr(eigenvectors.tail_cols(newDim)).t() * centered;
+}
+
+double MVUFunction::Evaluate(const arma::mat& coordinates) const
+{
+  // The variance is sum_i ||y_i||^2 - n ||mean(y)||^2.
+  const arma::vec mean = arma::mean(coordinates, 1);
+  return -(arma::accu(arma::square(coordinates)) - coordinates.n_cols *
+      arma::dot(mean, mean));
+}
+
+void MVUFunction::Gradient(const arma::mat& coordinates,
+                           arma::mat& gradient) const
+{
+  gradient = coordinates;
+  gradient.each_col() -= arma::mean(coordinates, 1);
+  gradient *= -2.0;
+}
+
+double MVUFunction::EvaluateConstraint(const size_t index,
+                                       const arma::mat& coordinates) const
+{
+  return arma::accu(arma::square(coordinates.col(first[index]) -
+      coordinates.col(second[index]))) - squaredDistances[index];
+}
+
+void MVUFunction::GradientConstraint(const size_t index,
+                                     const arma::mat& coordinates,
+                                     arma::mat& gradient) const
+{
+  const arma::vec difference = coordinates.col(first[index]) -
+      coordinates.col(second[index]);
+
+  gradient.zeros(coordinates.n_rows, coordinates.n_cols);
+  gradient.col(first[index]) = 2 * difference;
+  gradient.col(second[index]) = -2 * difference;
+}
+
+void MVUFunction::EvaluateConstraints(const arma::mat& coordinates,
+                                      arma::vec& constraints) const
+{
+  const size_t dim = coordinates.n_rows;
+  constraints.set_size(squaredDistances.n_elem);
+
+  #pragma omp parallel for
+  for (omp_size_t c = 0; c < (omp_size_t) squaredDistances.n_elem; ++c)
+  {
+    const double* a = coordinates.colptr(first[c]);
+    const double* b = coordinates.colptr(second[c]);
+
+    double sum = 0.0;
+    for (size_t d = 0; d < dim; ++d)
+      sum += (a[d] - b[d]) * (a[d] - b[d]);
+
+    constraints[c] = sum - squaredDistances[c];
+  }
+}
+
+void MVUFunction::WeightedConstraintsGradient(const arma::vec& weights,
+                                              const arma::mat& coordinates,
+                                              arma::mat& gradient) const
+{
+  const size_t dim = coordinates.n_rows;
+  gradient.zeros(coordinates.n_rows, coordinates.n_cols);
+
+  // Each point only accumulates the gradients of its own constraints, so the
+  // points can be handled in parallel.  The gradient of ||y_p - y_q||^2 with
+  // respect to y_p is 2 (y_p - y_q).
+  #pragma omp parallel for schedule(dynamic, 256)
+  for (omp_size_t p = 0; p < (omp_size_t) coordinates.n_cols; ++p)
+  {
+    double* g = gradient.colptr(p);
+    const double* y = coordinates.colptr(p);
+
+    for (size_t k = incidentOffsets[p]; k < incidentOffsets[p + 1]; ++k)
+    {
+      const size_t c = incidentConstraints[k];
+      const size_t q = (first[c] == (size_t) p) ? second[c] : first[c];
+      const double* other = coordinates.colptr(q);
+      const double weight = 2 * weights[c];
+
+      for (size_t d = 0; d < dim; ++d)
+        g[d] += weight * (y[d] - other[d]);
+    }
+  }
+}
+
+namespace mlpack {
+namespace optimization {
+
+template<>
+double AugLagrangianFunction<mvu::MVUFunction>::Evaluate(
+    const arma::mat& coordinates) const
+{
+  // L(Y, lambda, sigma) = f(Y) - sum_c lambda_c c(Y) +
+  //     (sigma / 2) sum_c c(Y)^2.
+  arma::vec constraints;
+  function.EvaluateConstraints(coordinates, constraints);
+
+  return function.Evaluate(coordinates) - arma::dot(lambda, constraints) +
+      (sigma / 2.) * arma::dot(constraints, constraints);
+}
+
+template<>
+void AugLagrangianFunction<mvu::MVUFunction>::Gradient(
+    const arma::mat& coordinates,
+    arma::mat& gradient) const
+{
+  // L'(Y, lambda, sigma) = f'(Y) + sum_c (sigma c(Y) - lambda_c) c'(Y).
+  arma::vec constraints;
+  function.EvaluateConstraints(coordinates, constraints);
+
+  arma::mat constraintsGradient;
+  function.WeightedConstraintsGradient(sigma * constraints - lambda,
+      coordinates, constraintsGradient);
+
+  function.Gradient(coordinates, gradient);
+  gradient += constraintsGradient;
+}
+
+} // namespace optimization
+} // namespace mlpack
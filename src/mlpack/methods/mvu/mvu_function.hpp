@@ -0,0 +1,143 @@
+/**
+ * @file mvu_function.hpp
+ *
+ * Definition of the MVUFunction class, the constrained objective function of
+ * Maximum Variance Unfolding, for use with the AugLagrangian optimizer.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_MVU_MVU_FUNCTION_HPP
+#define MLPACK_METHODS_MVU_MVU_FUNCTION_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/optimizers/aug_lagrangian/aug_lagrangian.hpp>
+
+namespace mlpack {
+namespace mvu {
+
+/**
+ * The objective function of Maximum Variance Unfolding, written directly in
+ * terms of the low-dimensional coordinates Y (one point per column) instead of
+ * as a semidefinite program over the kernel matrix K = Y^T Y:
+ *
+ *   max sum_i ||y_i - mean(y)||^2
+ *   subj. to ||y_i - y_j||^2 = ||x_i - x_j||^2 for each neighbor pair (i, j).
+ *
+ * The variance does not change when the points are translated, so the
+ * centering constraint sum_ij K_ij = 0 of the semidefinite program (which
+ * would be a dense n x n constraint) is not needed; the solution only has to
+ * be centered afterwards.
+ *
+ * The constraints are stored as index triples (i, j, squared distance), one per
+ * distinct neighbor pair, and the constraints incident to each point are
+ * listed so that the gradient can be accumulated in parallel over the points.
+ * The neighbor pairs are found with a tree-based KNN search, and the
+ * constraints are built in parallel.  With the specialization of
+ * AugLagrangianFunction below, one evaluation of the augmented Lagrangian or
+ * its gradient takes O((n + c) d) time for n points, c constraints and d
+ * output dimensions.
+ */
+class MVUFunction
+{
+ public:
+  /**
+   * Construct the MVU function for the given dataset.
+   *
+   * @param data Dataset to unfold (one point per column).
+   * @param newDim Dimensionality of the unfolded dataset.
+   * @param numNeighbors Number of nearest neighbors of each point whose
+   *     distances are kept.
+   */
+  MVUFunction(const arma::mat& data,
+              const size_t newDim,
+              const size_t numNeighbors);
+
+  //! Evaluate the objective (the negative variance) at the given coordinates.
+  double Evaluate(const arma::mat& coordinates) const;
+
+  //! Evaluate the gradient of the objective at the given coordinates.
+  void Gradient(const arma::mat& coordinates, arma::mat& gradient) const;
+
+  //! Get the number of constraints.
+  size_t NumConstraints() const { return squaredDistances.n_elem; }
+
+  //! Evaluate the given constraint at the given coordinates.
+  double EvaluateConstraint(const size_t index,
+                            const arma::mat& coordinates) const;
+
+  //! Evaluate the gradient of the given constraint at the given coordinates.
+  void GradientConstraint(const size_t index,
+                          const arma::mat& coordinates,
+                          arma::mat& gradient) const;
+
+  /**
+   * Evaluate all the constraints at the given coordinates, in parallel.
+   *
+   * @param coordinates The coordinates.
+   * @param constraints Vector to store the values of the constraints in.
+   */
+  void EvaluateConstraints(const arma::mat& coordinates,
+                           arma::vec& constraints) const;
+
+  /**
+   * Compute the gradient of sum_c w_c c(Y) for the given weights w_c of the
+   * constraints, in parallel over the points.
+   *
+   * @param weights The weight of each constraint.
+   * @param coordinates The coordinates.
+   * @param gradient Matrix to store the gradient in.
+   */
+  void WeightedConstraintsGradient(const arma::vec& weights,
+                                   const arma::mat& coordinates,
+                                   arma::mat& gradient) const;
+
+  //! Get the initial point (the projection of the data on its principal
+  //! components).
+  const arma::mat& GetInitialPoint() const { return initialPoint; }
+
+  //! Get the first point of each constraint.
+  const arma::uvec& First() const { return first; }
+  //! Get the second point of each constraint.
+  const arma::uvec& Second() const { return second; }
+  //! Get the squared distance of each constraint.
+  const arma::vec& SquaredDistances() const { return squaredDistances; }
+
+ private:
+  //! The first point of each constraint.
+  arma::uvec first;
+  //! The second point of each constraint.
+  arma::uvec second;
+  //! The squared distance between the points of each constraint.
+  arma::vec squaredDistances;
+
+  //! The constraints incident to point i are incidentConstraints[j] for j from
+  //! incidentOffsets[i] to incidentOffsets[i + 1] - 1.
+  arma::uvec incidentOffsets;
+  //! The constraints incident to each point, point by point.
+  arma::uvec incidentConstraints;
+
+  //! The initial point.
+  arma::mat initialPoint;
+};
+
+} // namespace mvu
+
+namespace optimization {
+
+// Declare specializations in mvu_function.cpp.
+template<>
+double AugLagrangianFunction<mvu::MVUFunction>::Evaluate(
+    const arma::mat& coordinates) const;
+
+template<>
+void AugLagrangianFunction<mvu::MVUFunction>::Gradient(
+    const arma::mat& coordinates,
+    arma::mat& gradient) const;
+
+} // namespace optimization
+} // namespace mlpack
+
+#endif
@@ -13,6 +13,7 @@
  */
 #include <mlpack/prereqs.hpp>
 #include <mlpack/core/util/cli.hpp>
+#include <mlpack/core/util/mlpack_main.hpp>
 #include "mvu.hpp"
 
 PROGRAM_INFO("Maximum Variance Unfolding (MVU)", "This program implements "
@@ -30,30 +31,18 @@ PARAM_INT_IN("num_neighbors", "Number of nearest neighbors to consider while "
 
 using namespace mlpack;
 using namespace mlpack::mvu;
-using namespace mlpack::math;
 using namespace mlpack::util;
 using namespace arma;
 using namespace std;
 
-int main(int argc, char **argv)
+static void mlpackMain()
 {
-  // Read from command line.
-  CLI::ParseCommandLine(argc, argv);
-  const string inputFile = CLI::GetParam<string>("input_file");
-  const string outputFile = CLI::GetParam<string>("output_file");
-  const int newDim = CLI::GetParam<int>("new_dim");
-  const int numNeighbors = CLI::GetParam<int>("num_neighbors");
-
-  if (!CLI::HasParam("output"))
-  {
-    Log::Warn << "--output_file (-o) is not specified; no results will be "
-        << "saved!" << endl;
-  }
-
-  RandomSeed(time(NULL));
+  RequireAtLeastOnePassed({ "output" }, false, "no results will be saved");
 
   // Load input dataset.
   mat data = std::move(CLI::GetParam<arma::mat>("input"));
+  const int newDim = CLI::GetParam<int>("new_dim");
+  const int numNeighbors = CLI::GetParam<int>("num_neighbors");
 
   // Verify that the requested dimensionality is valid.
   if (newDim <= 0 || newDim > (int) data.n_rows)
@@ -64,11 +53,11 @@ int main(int argc, char **argv)
   }
 
   // Verify that the number of neighbors is valid.
-  if (numNeighbors <= 0 || numNeighbors > (int) data.n_cols)
+  if (numNeighbors <= 0 || numNeighbors >= (int) data.n_cols)
   {
     Log::Fatal << "Invalid number of neighbors (" << numNeighbors << ").  Must "
-        << "be between 1 and the number of points in the input dataset ("
-        << data.n_cols << ")." << std::endl;
+        << "be between 1 and the number of points in the input dataset minus "
+        << "one (" << data.n_cols - 1 << ")." << std::endl;
   }
 
   // Now run MVU.
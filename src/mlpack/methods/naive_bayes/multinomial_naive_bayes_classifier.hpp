@@ -0,0 +1,186 @@
+/**
+ * @file multinomial_naive_bayes_classifier.hpp
+ *
+ * A Naive Bayes classifier for count data (such as word counts of documents),
+ * which models the features of each class with a multinomial distribution.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_NAIVE_BAYES_MULTINOMIAL_NAIVE_BAYES_CLASSIFIER_HPP
+#define MLPACK_METHODS_NAIVE_BAYES_MULTINOMIAL_NAIVE_BAYES_CLASSIFIER_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace naive_bayes {
+
+/**
+ * The multinomial Naive Bayes classifier.  Each feature of a point is a count
+ * (for text, the number of times a word occurs in a document), and the counts
+ * of a point of class y_j are assumed to be drawn from a multinomial
+ * distribution with parameters theta_j.  The classifier trains by counting the
+ * occurrences of each feature in the points of each class; theta_j is then
+ * estimated with additive (Laplace) smoothing, as
+ *
+ *   theta_ij = (N_ij + alpha) / (N_j + alpha * d),
+ *
+ * where N_ij is the total count of feature i in class j, N_j is the total count
+ * of all features in class j, and d is the number of features.  A point x is
+ * classified as arg max_j (log P(Y = y_j) + sum_i x_i log theta_ij), which is
+ * a single matrix product for a set of points; so, this classifier works well
+ * with sparse data (arma::sp_mat), and only visits the nonzero counts.
+ *
+ * Training is always incremental: calling Train() again adds the counts of the
+ * new points to the model.
+ *
+ * @code
+ * extern arma::sp_mat documents, testDocuments;
+ * extern arma::Row<size_t> labels;
+ * MultinomialNaiveBayesClassifier<> mnb(documents, labels, 20);
+ * arma::Row<size_t> predictions;
+ * mnb.Classify(testDocuments, predictions);
+ * @endcode
+ *
+ * @tparam ModelMatType Internal (dense) matrix type to use to store the model.
+ */
+template<typename ModelMatType = arma::mat>
+class MultinomialNaiveBayesClassifier
+{
+ public:
+  // Convenience typedef.
+  typedef typename ModelMatType::elem_type ElemType;
+
+  /**
+   * Train the classifier on the given counts.
+   *
+   * @param data Training points (dense or sparse); each column is a point.
+   * @param labels Labels of the training points.
+   * @param numClasses Number of classes.
+   * @param smoothing Additive smoothing parameter (alpha).
+   */
+  template<typename MatType>
+  MultinomialNaiveBayesClassifier(const MatType& data,
+                                  const arma::Row<size_t>& labels,
+                                  const size_t numClasses,
+                                  const double smoothing = 1.0);
+
+  /**
+   * Initialize the classifier without performing training.  All counts are
+   * set to zero.
+   *
+   * @param dimensionality Number of features.
+   * @param numClasses Number of classes.
+   * @param smoothing Additive smoothing parameter (alpha).
+   */
+  MultinomialNaiveBayesClassifier(const size_t dimensionality = 0,
+                                  const size_t numClasses = 0,
+                                  const double smoothing = 1.0);
+
+  /**
+   * Add the counts of the given points to the model.  If the dimensionality or
+   * number of classes does not match the model, the model is reset first.
+   *
+   * @param data Training points (dense or sparse); each column is a point.
+   * @param labels Labels of the training points.
+   * @param numClasses Number of classes.
+   */
+  template<typename MatType>
+  void Train(const MatType& data,
+             const arma::Row<size_t>& labels,
+             const size_t numClasses);
+
+  /**
+   * Classify the given point, returning the predicted class.
+   *
+   * @param point Point to classify (dense or sparse).
+   */
+  template<typename VecType>
+  size_t Classify(const VecType& point) const;
+
+  /**
+   * Classify the given point, also returning the probability of each class.
+   *
+   * @param point Point to classify (dense or sparse).
+   * @param prediction This will be set to the predicted class of the point.
+   * @param probabilities This will be filled with class probabilities.
+   */
+  template<typename VecType, typename ProbabilitiesVecType>
+  void Classify(const VecType& point,
+                size_t& prediction,
+                ProbabilitiesVecType& probabilities) const;
+
+  /**
+   * Classify the given points.
+   *
+   * @param data Points to classify (dense or sparse).
+   * @param predictions This will be filled with the predicted classes.
+   */
+  template<typename MatType>
+  void Classify(const MatType& data, arma::Row<size_t>& predictions) const;
+
+  /**
+   * Classify the given points, also returning the probability of each class
+   * for each point (one column for each point).
+   *
+   * @param data Points to classify (dense or sparse).
+   * @param predictions This will be filled with the predicted classes.
+   * @param probabilities This will be filled with class probabilities.
+   */
+  template<typename MatType, typename ProbabilitiesMatType>
+  void Classify(const MatType& data,
+                arma::Row<size_t>& predictions,
+                ProbabilitiesMatType& probabilities) const;
+
+  //! Get the total count of each feature (row) in each class (column).
+  const ModelMatType& FeatureCounts() const { return featureCounts; }
+  //! Get the number of training points of each class.
+  const ModelMatType& ClassCounts() const { return classCounts; }
+
+  //! Get the log of theta (one column for each class).
+  const ModelMatType& LogTheta() const { return logTheta; }
+  //! Get the log prior probability of each class.
+  const ModelMatType& LogPriors() const { return logPriors; }
+
+  //! Get the smoothing parameter.
+  double Smoothing() const { return smoothing; }
+  //! Set the smoothing parameter; the model is updated.
+  void Smoothing(const double smoothing);
+
+  //! Serialize the classifier.
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */);
+
+ private:
+  //! Recompute logTheta and logPriors from the counts.
+  void UpdateModel();
+
+  /**
+   * Compute the unnormalized log posterior of each class (row) for each of the
+   * given points (column).
+   */
+  template<typename MatType>
+  void LogLikelihood(const MatType& data, ModelMatType& logLikelihoods) const;
+
+  //! The total count of each feature (row) in each class (column).
+  ModelMatType featureCounts;
+  //! The number of training points of each class; a column vector.
+  ModelMatType classCounts;
+  //! The additive smoothing parameter.
+  double smoothing;
+
+  //! The log of theta (one column for each class).
+  ModelMatType logTheta;
+  //! The log prior probability of each class; a column vector.
+  ModelMatType logPriors;
+};
+
+} // namespace naive_bayes
+} // namespace mlpack
+
+// Include implementation.
+#include "multinomial_naive_bayes_classifier_impl.hpp"
+
+#endif
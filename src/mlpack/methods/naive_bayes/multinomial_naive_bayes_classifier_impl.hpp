@@ -0,0 +1,237 @@
+/**
+ * @file multinomial_naive_bayes_classifier_impl.hpp
+ *
+ * Implementation of the multinomial Naive Bayes classifier.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_NAIVE_BAYES_MULTINOMIAL_NAIVE_BAYES_CLASSIFIER_IMPL_HPP
+#define MLPACK_METHODS_NAIVE_BAYES_MULTINOMIAL_NAIVE_BAYES_CLASSIFIER_IMPL_HPP
+
+// In case it hasn't been included already.
+#include "multinomial_naive_bayes_classifier.hpp"
+
+namespace mlpack {
+namespace naive_bayes {
+
+template<typename ModelMatType>
+template<typename MatType>
+MultinomialNaiveBayesClassifier<ModelMatType>::MultinomialNaiveBayesClassifier(
+    const MatType& data,
+    const arma::Row<size_t>& labels,
+    const size_t numClasses,
+    const double smoothing) :
+    smoothing(smoothing)
+{
+  Train(data, labels, numClasses);
+}
+
+template<typename ModelMatType>
+MultinomialNaiveBayesClassifier<ModelMatType>::MultinomialNaiveBayesClassifier(
+    const size_t dimensionality,
+    const size_t numClasses,
+    const double smoothing) :
+    smoothing(smoothing)
+{
+  featureCounts.zeros(dimensionality, numClasses);
+  classCounts.zeros(numClasses, 1);
+  UpdateModel();
+}
+
+template<typename ModelMatType>
+template<typename MatType>
+void MultinomialNaiveBayesClassifier<ModelMatType>::Train(
+    const MatType& data,
+    const arma::Row<size_t>& labels,
+    const size_t numClasses)
+{
+  static_assert(std::is_same<ElemType, typename MatType::elem_type>::value,
+      "MultinomialNaiveBayesClassifier: element type of given data must match "
+      "the element type of the model!");
+
+  // Do we need to reset the model?
+  if (featureCounts.n_rows != data.n_rows || featureCounts.n_cols != numClasses)
+  {
+    featureCounts.zeros(data.n_rows, numClasses);
+    classCounts.zeros(numClasses, 1);
+  }
+
+  if (data.n_cols > 0)
+  {
+    // The counts of each class are the product of the data with the sparse
+    // indicator matrix of the labels; for sparse data, only the nonzero counts
+    // are visited.
+    arma::umat locations(2, data.n_cols);
+    for (size_t j = 0; j < data.n_cols; ++j)
+    {
+      locations(0, j) = j;
+      locations(1, j) = labels[j];
+      ++classCounts[labels[j]];
+    }
+    const arma::Col<ElemType> values(data.n_cols, arma::fill::ones);
+    const arma::SpMat<ElemType> indicator(locations, values, data.n_cols,
+        numClasses);
+
+    featureCounts += ModelMatType(data * indicator);
+  }
+
+  UpdateModel();
+}
+
+template<typename ModelMatType>
+void MultinomialNaiveBayesClassifier<ModelMatType>::UpdateModel()
+{
+  const ModelMatType smoothedCounts = featureCounts + smoothing;
+  logTheta = arma::log(smoothedCounts);
+  logTheta.each_row() -= arma::log(arma::sum(smoothedCounts, 0));
+
+  // With no training points, the prior is uniform.
+  const ElemType totalPoints = arma::accu(classCounts);
+  if (totalPoints > 0)
+  {
+    logPriors = arma::log(classCounts / totalPoints);
+  }
+  else
+  {
+    logPriors.set_size(classCounts.n_rows, 1);
+    logPriors.fill(-std::log((double) std::max(classCounts.n_rows,
+        (arma::uword) 1)));
+  }
+}
+
+template<typename ModelMatType>
+void MultinomialNaiveBayesClassifier<ModelMatType>::Smoothing(
+    const double smoothing)
+{
+  this->smoothing = smoothing;
+  UpdateModel();
+}
+
+template<typename ModelMatType>
+template<typename MatType>
+void MultinomialNaiveBayesClassifier<ModelMatType>::LogLikelihood(
+    const MatType& data,
+    ModelMatType& logLikelihoods) const
+{
+  static_assert(std::is_same<ElemType, typename MatType::elem_type>::value,
+      "MultinomialNaiveBayesClassifier: element type of given data must match "
+      "the element type of the model!");
+
+  // The log likelihoods are a single matrix product, which is split into
+  // batches of points that are computed in parallel.
+  logLikelihoods.set_size(logTheta.n_cols, data.n_cols);
+  const size_t batchSize = 1024;
+  const size_t numBatches = (data.n_cols + batchSize - 1) / batchSize;
+  #pragma omp parallel for
+  for (omp_size_t b = 0; b < (omp_size_t) numBatches; ++b)
+  {
+    const size_t begin = b * batchSize;
+    const size_t end = std::min(begin + batchSize, (size_t) data.n_cols);
+    logLikelihoods.cols(begin, end - 1) = logTheta.t() *
+        data.cols(begin, end - 1);
+  }
+
+  logLikelihoods.each_col() += logPriors.col(0);
+}
+
+template<typename ModelMatType>
+template<typename VecType>
+size_t MultinomialNaiveBayesClassifier<ModelMatType>::Classify(
+    const VecType& point) const
+{
+  ModelMatType logLikelihoods;
+  LogLikelihood(point, logLikelihoods);
+
+  arma::uword maxIndex = 0;
+  logLikelihoods.max(maxIndex);
+  return maxIndex;
+}
+
+template<typename ModelMatType>
+template<typename VecType, typename ProbabilitiesVecType>
+void MultinomialNaiveBayesClassifier<ModelMatType>::Classify(
+    const VecType& point,
+    size_t& prediction,
+    ProbabilitiesVecType& probabilities) const
+{
+  arma::Row<size_t> predictions;
+  ModelMatType probabilitiesMat;
+  Classify(point, predictions, probabilitiesMat);
+
+  prediction = predictions[0];
+  probabilities = probabilitiesMat.col(0);
+}
+
+template<typename ModelMatType>
+template<typename MatType>
+void MultinomialNaiveBayesClassifier<ModelMatType>::Classify(
+    const MatType& data,
+    arma::Row<size_t>& predictions) const
+{
+  ModelMatType logLikelihoods;
+  LogLikelihood(data, logLikelihoods);
+
+  predictions.set_size(data.n_cols);
+  for (size_t i = 0; i < data.n_cols; ++i)
+  {
+    arma::uword maxIndex = 0;
+    logLikelihoods.unsafe_col(i).max(maxIndex);
+    predictions[i] = maxIndex;
+  }
+}
+
+template<typename ModelMatType>
+template<typename MatType, typename ProbabilitiesMatType>
+void MultinomialNaiveBayesClassifier<ModelMatType>::Classify(
+    const MatType& data,
+    arma::Row<size_t>& predictions,
+    ProbabilitiesMatType& probabilities) const
+{
+  static_assert(std::is_same<ElemType,
+                             typename ProbabilitiesMatType::elem_type>::value,
+      "MultinomialNaiveBayesClassifier: element type of given probabilities "
+      "must match the element type of the model!");
+
+  ModelMatType logLikelihoods;
+  LogLikelihood(data, logLikelihoods);
+
+  // Normalize each column, subtracting the largest log likelihood first so
+  // that the exponentials can't all underflow.
+  predictions.set_size(data.n_cols);
+  for (size_t i = 0; i < data.n_cols; ++i)
+  {
+    arma::uword maxIndex = 0;
+    const ElemType maxLogLikelihood =
+        logLikelihoods.unsafe_col(i).max(maxIndex);
+    predictions[i] = maxIndex;
+
+    logLikelihoods.col(i) = arma::exp(logLikelihoods.col(i) -
+        maxLogLikelihood);
+    logLikelihoods.col(i) /= arma::accu(logLikelihoods.col(i));
+  }
+
+  probabilities = std::move(logLikelihoods);
+}
+
+template<typename ModelMatType>
+template<typename Archive>
+void MultinomialNaiveBayesClassifier<ModelMatType>::serialize(
+    Archive& ar,
+    const unsigned int /* version */)
+{
+  ar & BOOST_SERIALIZATION_NVP(featureCounts);
+  ar & BOOST_SERIALIZATION_NVP(classCounts);
+  ar & BOOST_SERIALIZATION_NVP(smoothing);
+
+  // The rest of the model is computed from the counts.
+  if (Archive::is_loading::value)
+    UpdateModel();
+}
+
+} // namespace naive_bayes
+} // namespace mlpack
+
+#endif
@@ -208,23 +208,38 @@ void NaiveBayesClassifier<ModelMatType>::LogLikelihood(
       "NaiveBayesClassifier: element type of given data must match the element "
       "type of the model!");
 
-  logLikelihoods = arma::log(arma::repmat(probabilities, 1, data.n_cols));
-  ModelMatType invVar = 1.0 / variances;
-
-  // Calculate the joint log likelihood of point for each of the
-  // means.n_cols.
-
-  // Loop over every class.
-  for (size_t i = 0; i < means.n_cols; i++)
+  logLikelihoods.set_size(means.n_cols, data.n_cols);
+  const ModelMatType invVar = 1.0 / variances;
+
+  // The log likelihood of a point for a class is the log prior of the class,
+  // plus the log normalization of the Gaussian of the class, plus the exponent.
+  // Only the exponent depends on the point.  (The log normalization is a sum of
+  // logarithms, so that it can't underflow like the determinant.)
+  const ModelMatType classTerms = arma::log(probabilities) - 0.5 *
+      (data.n_rows * std::log(2 * M_PI) +
+      arma::sum(arma::log(variances), 0).t());
+
+  // The points are processed in batches, in parallel.  For each class, the
+  // exponents of all the points in a batch are computed at once.  The exponents
+  // are computed from the differences to the means, so that they stay accurate
+  // even when a variance is tiny.
+  const size_t batchSize = 1024;
+  const size_t numBatches = (data.n_cols + batchSize - 1) / batchSize;
+  #pragma omp parallel for
+  for (omp_size_t b = 0; b < (omp_size_t) numBatches; ++b)
   {
-    // This is an adaptation of gmm::phi() for the case where the covariance is
-    // a diagonal matrix.
-    ModelMatType diffs = data - arma::repmat(means.col(i), 1, data.n_cols);
-    ModelMatType rhs = -0.5 * arma::diagmat(invVar.col(i)) * diffs;
-    arma::Mat<ElemType> exponents = arma::sum(diffs % rhs, 0);
-
-    logLikelihoods.row(i) += (data.n_rows / -2.0 * log(2 * M_PI) - 0.5 *
-        std::log(arma::det(arma::diagmat(variances.col(i)))) + exponents);
+    const size_t begin = b * batchSize;
+    const size_t end = std::min(begin + batchSize, (size_t) data.n_cols);
+    const arma::Mat<ElemType> batch(data.cols(begin, end - 1));
+
+    for (size_t i = 0; i < means.n_cols; ++i)
+    {
+      arma::Mat<ElemType> diffs = arma::square(batch.each_col() -
+          means.col(i));
+      diffs.each_col() %= invVar.col(i);
+      logLikelihoods.submat(i, begin, i, end - 1) = classTerms[i] - 0.5 *
+          arma::sum(diffs, 0);
+    }
   }
 }
 
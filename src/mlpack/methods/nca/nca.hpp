@@ -86,6 +86,13 @@ class NCA
   const OptimizerType& Optimizer() const { return optimizer; }
   OptimizerType& Optimizer() { return optimizer; }
 
+  //! Get the number of nearest neighbors of each point used to approximate the
+  //! objective function (0 means all points are used).
+  size_t Neighbors() const { return errorFunction.Neighbors(); }
+  //! Modify the number of nearest neighbors of each point used to approximate
+  //! the objective function (0 means all points are used).
+  size_t& Neighbors() { return errorFunction.Neighbors(); }
+
  private:
   //! Dataset reference.
   const arma::mat& dataset;
@@ -115,6 +115,10 @@ PARAM_DOUBLE_IN("min_step", "Minimum step of line search for L-BFGS.", "m",
 PARAM_DOUBLE_IN("max_step", "Maximum step of line search for L-BFGS.", "M",
     1e20);
 
+PARAM_INT_IN("neighbors", "If not 0, approximate the objective function by "
+    "only using this many nearest neighbors of each point (found with a "
+    "kd-tree).", "k", 0);
+
 PARAM_INT_IN("seed", "Random seed.  If 0, 'std::time(NULL)' is used.", "s", 0);
 
 using namespace mlpack;
@@ -169,6 +173,10 @@ void mlpackMain()
   const double maxStep = CLI::GetParam<double>("max_step");
   const size_t batchSize = (size_t) CLI::GetParam<int>("batch_size");
 
+  RequireParamValue<int>("neighbors", [](int x) { return x >= 0; }, true,
+      "number of neighbors must be nonnegative");
+  const size_t neighbors = (size_t) CLI::GetParam<int>("neighbors");
+
   // Load data.
   arma::mat data = std::move(CLI::GetParam<arma::mat>("input"));
 
@@ -216,6 +224,7 @@ void mlpackMain()
   if (optimizerType == "sgd")
   {
     NCA<LMetric<2> > nca(data, labels);
+    nca.Neighbors() = neighbors;
     nca.Optimizer().StepSize() = stepSize;
     nca.Optimizer().MaxIterations() = maxIterations;
     nca.Optimizer().Tolerance() = tolerance;
@@ -227,6 +236,7 @@ void mlpackMain()
   else if (optimizerType == "lbfgs")
   {
     NCA<LMetric<2>, L_BFGS> nca(data, labels);
+    nca.Neighbors() = neighbors;
     nca.Optimizer().NumBasis() = numBasis;
     nca.Optimizer().MaxIterations() = maxIterations;
     nca.Optimizer().ArmijoConstant() = armijoConstant;
@@ -15,6 +15,7 @@
 
 #include <mlpack/prereqs.hpp>
 #include <mlpack/core/metrics/lmetric.hpp>
+#include <mlpack/methods/neighbor_search/neighbor_search.hpp>
 
 namespace mlpack {
 namespace nca {
@@ -38,6 +39,13 @@ namespace nca {
  * optimizers use, overloads of Evaluate() and Gradient() are given which only
  * operate on one point in the dataset.  This is useful for optimizers like
  * stochastic gradient descent (see mlpack::optimization::SGD).
+ *
+ * Computing p_ij for every pair of points takes O(n^2) time per evaluation,
+ * but most of the terms exp(-|| A x_i - A x_j ||^2) are negligible.  If
+ * Neighbors() is set to some k > 0, only the k nearest neighbors of each point
+ * in the stretched dataset (found with a kd-tree and the Euclidean distance)
+ * are used in the sums, and the gradient is accumulated in parallel with
+ * OpenMP.  The results are then an approximation.
  */
 template<typename MetricType = metric::SquaredEuclideanDistance>
 class SoftmaxErrorFunction
@@ -52,10 +60,13 @@ class SoftmaxErrorFunction
    * @param dataset Matrix containing the dataset.
    * @param labels Vector of class labels for each point in the dataset.
    * @param kernel Instantiated kernel (optional).
+   * @param neighbors Number of nearest neighbors of each point to use in the
+   *     approximation (if 0, all points are used).
    */
   SoftmaxErrorFunction(const arma::mat& dataset,
                        const arma::Row<size_t>& labels,
-                       MetricType metric = MetricType());
+                       MetricType metric = MetricType(),
+                       const size_t neighbors = 0);
 
   /**
    * Shuffle the dataset.
@@ -129,6 +140,11 @@ class SoftmaxErrorFunction
    */
   size_t NumFunctions() const { return dataset.n_cols; }
 
+  //! Get the number of neighbors used in the approximation (0 means exact).
+  size_t Neighbors() const { return neighbors; }
+  //! Modify the number of neighbors used in the approximation (0 means exact).
+  size_t& Neighbors() { return neighbors; }
+
  private:
   //! The dataset.  This is an alias until Shuffle() is called.
   arma::mat dataset;
@@ -138,6 +154,11 @@ class SoftmaxErrorFunction
 
   //! The instantiated metric.
   MetricType metric;
+  //! The number of neighbors used in the approximation (0 means exact).
+  size_t neighbors;
+  //! The nearest neighbors of each point, for the approximate non-separable
+  //! Evaluate() and Gradient().
+  arma::Mat<size_t> neighborIndices;
 
   //! Last coordinates.  Used for the non-separable Evaluate() and Gradient().
   arma::mat lastCoordinates;
@@ -166,6 +187,24 @@ class SoftmaxErrorFunction
    * @param coordinates Coordinates matrix to use for precalculation.
    */
   void Precalculate(const arma::mat& coordinates);
+
+  //! Return true if only the nearest neighbors of each point are used.
+  bool Approximate() const
+  {
+    return (neighbors > 0) && (neighbors + 1 < dataset.n_cols);
+  }
+
+  /**
+   * Find the Neighbors() + 1 nearest neighbors (including, usually, the point
+   * itself) of the given points of the stretched dataset.
+   *
+   * @param begin Index of the first point.
+   * @param batchSize Number of points.
+   * @param batchNeighbors Matrix to store the indices of the neighbors in.
+   */
+  void SearchNeighbors(const size_t begin,
+                       const size_t batchSize,
+                       arma::Mat<size_t>& batchNeighbors);
 };
 
 } // namespace nca
@@ -23,10 +23,12 @@ template<typename MetricType>
 SoftmaxErrorFunction<MetricType>::SoftmaxErrorFunction(
     const arma::mat& dataset,
     const arma::Row<size_t>& labels,
-    MetricType metric) :
+    MetricType metric,
+    const size_t neighbors) :
     dataset(math::MakeAlias(const_cast<arma::mat&>(dataset), false)),
     labels(math::MakeAlias(const_cast<arma::Row<size_t>&>(labels), false)),
     metric(metric),
+    neighbors(neighbors),
     precalculated(false)
 { /* nothing to do */ }
 
@@ -65,17 +67,29 @@ double SoftmaxErrorFunction<MetricType>::Evaluate(const arma::mat& coordinates,
                                                   const size_t batchSize)
 {
   // Unfortunately each evaluation will take O(N) time because it requires a
-  // scan over all points in the dataset.  Our objective is to compute p_i.
-  double denominator = 0;
-  double numerator = 0;
+  // scan over all points in the dataset (or a nearest neighbor search, in the
+  // approximate case).  Our objective is to compute p_i.
   double result = 0;
 
   // It's quicker to do this now than one point at a time later.
   stretchedDataset = coordinates * dataset;
+
+  arma::Mat<size_t> batchNeighbors;
+  const bool approximate = Approximate();
+  if (approximate)
+    SearchNeighbors(begin, batchSize, batchNeighbors);
+  const size_t numCandidates = approximate ? batchNeighbors.n_rows :
+      dataset.n_cols;
+
   for (size_t i = begin; i < begin + batchSize; i++)
   {
-    for (size_t k = 0; k < dataset.n_cols; ++k)
+    double denominator = 0;
+    double numerator = 0;
+
+    for (size_t c = 0; c < numCandidates; ++c)
     {
+      const size_t k = approximate ? batchNeighbors(c, i - begin) : c;
+
       // Don't consider the case where the points are the same.
       if (k == i)
         continue;
@@ -127,6 +141,46 @@ void SoftmaxErrorFunction<MetricType>::Gradient(const arma::mat& coordinates,
   //     (p_i p_ik + p_k p_ki) x_ik x_ik^T
   arma::mat sum;
   sum.zeros(stretchedDataset.n_rows, stretchedDataset.n_rows);
+
+  if (Approximate())
+  {
+    // Only the nearest neighbors k of each point i are used, so the pairs are
+    // not symmetric; for each ordered pair (i, k) we add
+    //   (p_i - 1) p_ik x_ik x_ik^T  if i and k are in the same class, and
+    //   p_i p_ik x_ik x_ik^T        otherwise.
+    // Each thread accumulates its own sum.
+    #pragma omp parallel
+    {
+      arma::mat threadSum(dataset.n_rows, dataset.n_rows, arma::fill::zeros);
+
+      #pragma omp for schedule(dynamic, 16)
+      for (omp_size_t i = 0; i < (omp_size_t) stretchedDataset.n_cols; ++i)
+      {
+        for (size_t j = 0; j < neighborIndices.n_rows; ++j)
+        {
+          const size_t k = neighborIndices(j, i);
+          const double eval = exp(-metric.Evaluate(
+              stretchedDataset.unsafe_col(i), stretchedDataset.unsafe_col(k)));
+          const double p_ik = eval / denominators(i);
+
+          // We are not using stretched points here.
+          const arma::vec x_ik = dataset.col(i) - dataset.col(k);
+          if (labels[i] == labels[k])
+            threadSum += ((p[i] - 1) * p_ik) * (x_ik * trans(x_ik));
+          else
+            threadSum += (p[i] * p_ik) * (x_ik * trans(x_ik));
+        }
+      }
+
+      #pragma omp critical
+      sum += threadSum;
+    }
+
+    // Assemble the final gradient.
+    gradient = -2 * coordinates * sum;
+    return;
+  }
+
   for (size_t i = 0; i < stretchedDataset.n_cols; i++)
   {
     for (size_t k = (i + 1); k < stretchedDataset.n_cols; k++)
@@ -172,6 +226,14 @@ void SoftmaxErrorFunction<MetricType>::Gradient(const arma::mat& coordinates,
 
   // Compute the stretched dataset.
   stretchedDataset = coordinates * dataset;
+
+  arma::Mat<size_t> batchNeighbors;
+  const bool approximate = Approximate();
+  if (approximate)
+    SearchNeighbors(begin, batchSize, batchNeighbors);
+  const size_t numCandidates = approximate ? batchNeighbors.n_rows :
+      dataset.n_cols;
+
   for (size_t i = begin; i < begin + batchSize; i++)
   {
     numerator = 0;
@@ -180,8 +242,10 @@ void SoftmaxErrorFunction<MetricType>::Gradient(const arma::mat& coordinates,
     firstTerm.zeros(coordinates.n_rows, coordinates.n_cols);
     secondTerm.zeros(coordinates.n_rows, coordinates.n_cols);
 
-    for (size_t k = 0; k < dataset.n_cols; ++k)
+    for (size_t c = 0; c < numCandidates; ++c)
     {
+      const size_t k = approximate ? batchNeighbors(c, i - begin) : c;
+
       // Don't consider the case where the points are the same.
       if (i == k)
         continue;
@@ -259,23 +323,51 @@ void SoftmaxErrorFunction<MetricType>::Precalculate(
   // order of O((n * (n + 1)) / 2), which really isn't all that great.
   p.zeros(stretchedDataset.n_cols);
   denominators.zeros(stretchedDataset.n_cols);
-  for (size_t i = 0; i < stretchedDataset.n_cols; i++)
+
+  if (Approximate())
   {
-    for (size_t j = (i + 1); j < stretchedDataset.n_cols; j++)
+    // Only use the nearest neighbors of each point; then each p_i can be
+    // computed independently.
+    arma::mat distances;
+    neighbor::KNN knn(stretchedDataset);
+    knn.Parallel() = true;
+    knn.Search(neighbors, neighborIndices, distances);
+
+    #pragma omp parallel for schedule(dynamic, 16)
+    for (omp_size_t i = 0; i < (omp_size_t) stretchedDataset.n_cols; ++i)
     {
-      // Evaluate exp(-d(x_i, x_j)).
-      double eval = exp(-metric.Evaluate(stretchedDataset.unsafe_col(i),
-                                         stretchedDataset.unsafe_col(j)));
-
-      // Add this to the denominators of both p_i and p_j: K(i, j) = K(j, i).
-      denominators[i] += eval;
-      denominators[j] += eval;
+      for (size_t j = 0; j < neighborIndices.n_rows; ++j)
+      {
+        const size_t k = neighborIndices(j, i);
+        const double eval = exp(-metric.Evaluate(
+            stretchedDataset.unsafe_col(i), stretchedDataset.unsafe_col(k)));
 
-      // If i and j are the same class, add to numerator of both.
-      if (labels[i] == labels[j])
+        denominators[i] += eval;
+        if (labels[i] == labels[k])
+          p[i] += eval;
+      }
+    }
+  }
+  else
+  {
+    for (size_t i = 0; i < stretchedDataset.n_cols; i++)
+    {
+      for (size_t j = (i + 1); j < stretchedDataset.n_cols; j++)
       {
-        p[i] += eval;
-        p[j] += eval;
+        // Evaluate exp(-d(x_i, x_j)).
+        double eval = exp(-metric.Evaluate(stretchedDataset.unsafe_col(i),
+                                           stretchedDataset.unsafe_col(j)));
+
+        // Add this to the denominators of both p_i and p_j: K(i, j) = K(j, i).
+        denominators[i] += eval;
+        denominators[j] += eval;
+
+        // If i and j are the same class, add to numerator of both.
+        if (labels[i] == labels[j])
+        {
+          p[i] += eval;
+          p[j] += eval;
+        }
       }
     }
   }
@@ -300,6 +392,21 @@ void SoftmaxErrorFunction<MetricType>::Precalculate(
   precalculated = true;
 }
 
+template<typename MetricType>
+void SoftmaxErrorFunction<MetricType>::SearchNeighbors(
+    const size_t begin,
+    const size_t batchSize,
+    arma::Mat<size_t>& batchNeighbors)
+{
+  // The points are part of the reference set, so search for one more neighbor;
+  // the point itself is skipped by the caller.
+  arma::mat distances;
+  neighbor::KNN knn(stretchedDataset);
+  knn.Parallel() = true;
+  knn.Search(stretchedDataset.cols(begin, begin + batchSize - 1),
+      neighbors + 1, batchNeighbors, distances);
+}
+
 } // namespace nca
 } // namespace mlpack
 
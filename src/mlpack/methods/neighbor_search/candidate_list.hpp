@@ -0,0 +1,194 @@
+/**
+ * @file candidate_list.hpp
+ *
+ * Definition of the CandidateList class, which holds the k best candidate
+ * neighbors of each query point during a neighbor search.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_NEIGHBOR_SEARCH_CANDIDATE_LIST_HPP
+#define MLPACK_METHODS_NEIGHBOR_SEARCH_CANDIDATE_LIST_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include <algorithm>
+
+namespace mlpack {
+namespace neighbor {
+
+/**
+ * The lists of the k best candidate neighbors of a set of query points, stored
+ * contiguously, k candidates per query.  This replaces one
+ * std::priority_queue per query point: there is a single allocation for all the
+ * queries, and for the usual small values of k the list of each query is kept
+ * as a sorted array, which is cheaper to update than a heap.
+ *
+ * For k up to SortedLimit, the candidates of each query are sorted from the
+ * best to the worst, and a new candidate is inserted by counting the candidates
+ * that are better than it (without branching) and shifting the others down.  For k up to 10 this insertion is instantiated with k known at
+ * compile time, so that the loops are fully unrolled.  For larger k, the
+ * candidates of each query form a binary heap with the worst candidate first.
+ *
+ * @tparam SortPolicy The sort policy for distances.
+ */
+template<typename SortPolicy>
+class CandidateList
+{
+ public:
+  //! A candidate neighbor (distance, index).
+  typedef std::pair<double, size_t> Candidate;
+
+  //! The largest k for which the candidates are kept sorted instead of in a
+  //! heap.
+  static constexpr size_t SortedLimit = 32;
+
+  //! Create an empty set of candidate lists.
+  CandidateList() : k(0), sorted(true) { }
+
+  /**
+   * Create the candidate lists of the given number of query points, each
+   * holding k candidates with the worst possible distance and the given
+   * index.
+   *
+   * @param k Number of candidates of each query point.
+   * @param numQueries Number of query points.
+   * @param defaultIndex Index of the initial candidates.
+   */
+  CandidateList(const size_t k,
+                const size_t numQueries,
+                const size_t defaultIndex = size_t() - 1) :
+      k(k),
+      sorted(k <= SortedLimit),
+      candidates(k * numQueries,
+          std::make_pair(SortPolicy::WorstDistance(), defaultIndex))
+  { }
+
+  //! Get the number of candidates of each query point.
+  size_t K() const { return k; }
+
+  //! Get the distance of the worst candidate of the given query point.
+  double Worst(const size_t queryIndex) const
+  {
+    return candidates[queryIndex * k + (sorted ? k - 1 : 0)].first;
+  }
+
+  /**
+   * Insert a candidate neighbor of the given query point, if it is better than
+   * the worst candidate of the query point (which it then replaces).  A
+   * candidate that ties with the worst one is not inserted.
+   *
+   * @param queryIndex Index of the query point.
+   * @param neighbor Index of the candidate neighbor.
+   * @param distance Distance from the query point to the candidate neighbor.
+   */
+  void Insert(const size_t queryIndex,
+              const size_t neighbor,
+              const double distance)
+  {
+    Candidate* list = candidates.data() + queryIndex * k;
+    const Candidate c = std::make_pair(distance, neighbor);
+
+    if (!sorted)
+    {
+      if (SortPolicy::IsBetter(list[0].first, distance))
+        return;
+
+      std::pop_heap(list, list + k, CandidateCmp());
+      list[k - 1] = c;
+      std::push_heap(list, list + k, CandidateCmp());
+      return;
+    }
+
+    if (SortPolicy::IsBetter(list[k - 1].first, distance))
+      return;
+
+    // k is the same for the whole search, so this branch is always predicted.
+    switch (k)
+    {
+      case 1: InsertSorted<1>(list, k, c); break;
+      case 2: InsertSorted<2>(list, k, c); break;
+      case 3: InsertSorted<3>(list, k, c); break;
+      case 4: InsertSorted<4>(list, k, c); break;
+      case 5: InsertSorted<5>(list, k, c); break;
+      case 6: InsertSorted<6>(list, k, c); break;
+      case 7: InsertSorted<7>(list, k, c); break;
+      case 8: InsertSorted<8>(list, k, c); break;
+      case 9: InsertSorted<9>(list, k, c); break;
+      case 10: InsertSorted<10>(list, k, c); break;
+      default: InsertSorted<0>(list, k, c); break;
+    }
+  }
+
+  /**
+   * Write the candidates of the given query point, from the best to the worst,
+   * into the given arrays of length k.  If the candidates are kept in a heap,
+   * this sorts them, so afterwards no more candidates may be inserted for this
+   * query point.
+   *
+   * @param queryIndex Index of the query point.
+   * @param neighbors Array to store the indices of the candidates in.
+   * @param distances Array to store the distances of the candidates in.
+   */
+  void Get(const size_t queryIndex, size_t* neighbors, double* distances)
+  {
+    Candidate* list = candidates.data() + queryIndex * k;
+    if (!sorted)
+      std::sort_heap(list, list + k, CandidateCmp());
+
+    for (size_t j = 0; j < k; ++j)
+    {
+      neighbors[j] = list[j].second;
+      distances[j] = list[j].first;
+    }
+  }
+
+ private:
+  //! Compare two candidates based on the distance; the worst candidate is the
+  //! largest, so it is at the top of the heap.  SortPolicy::IsBetter() also
+  //! holds for equal distances, so it is negated to get a strict ordering.
+  struct CandidateCmp
+  {
+    bool operator()(const Candidate& c1, const Candidate& c2) const
+    {
+      return !SortPolicy::IsBetter(c2.first, c1.first);
+    }
+  };
+
+  /**
+   * Insert a candidate into a sorted list, dropping the worst candidate.  K is
+   * the length of the list, or 0 if it is only known at runtime.
+   */
+  template<size_t K>
+  static void InsertSorted(Candidate* list,
+                           const size_t runtimeK,
+                           const Candidate& c)
+  {
+    const size_t n = (K == 0) ? runtimeK : K;
+
+    // The candidates that are better than the new one are a prefix of the
+    // list, so counting them gives the position of the new candidate, which
+    // goes before any candidates with the same distance.
+    size_t position = 0;
+    for (size_t j = 0; j + 1 < n; ++j)
+      position += !SortPolicy::IsBetter(c.first, list[j].first);
+
+    for (size_t j = n - 1; j > position; --j)
+      list[j] = list[j - 1];
+    list[position] = c;
+  }
+
+  //! The number of candidates of each query point.
+  size_t k;
+  //! Whether the candidates of each query are sorted (or in a heap).
+  bool sorted;
+  //! The candidates of all the query points, k per query.
+  std::vector<Candidate> candidates;
+};
+
+} // namespace neighbor
+} // namespace mlpack
+
+#endif
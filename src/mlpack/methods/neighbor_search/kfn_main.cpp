@@ -88,6 +88,9 @@ PARAM_INT_IN("seed", "Random seed (if 0, std::time(NULL) is used).", "s", 0);
 // Search settings.
 PARAM_STRING_IN("algorithm", "Type of neighbor search: 'naive', 'single_tree', "
     "'dual_tree', 'greedy'.", "a", "dual_tree");
+PARAM_FLAG("parallel", "If set, the tree traversal is split between OpenMP "
+    "threads (the number of threads can be controlled with the OMP_NUM_THREADS "
+    "environment variable).", "P");
 PARAM_DOUBLE_IN("epsilon", "If specified, will do approximate furthest neighbor"
     " search with given relative error. Must be in the range [0,1).", "e", 0);
 PARAM_DOUBLE_IN("percentage", "If specified, will do approximate furthest "
@@ -244,6 +247,8 @@ void mlpackMain()
         << endl;
   }
 
+  kfn.Parallel() = CLI::HasParam("parallel");
+
   // Perform search, if desired.
   if (CLI::HasParam("k"))
   {
@@ -15,6 +15,7 @@
 #include <mlpack/core/metrics/lmetric.hpp>
 #include <mlpack/core/tree/cover_tree.hpp>
 #include <mlpack/core/util/mlpack_main.hpp>
+#include <mlpack/core/data/first_touch.hpp>
 
 #include <string>
 #include <fstream>
@@ -79,7 +80,8 @@ PARAM_INT_IN("k", "Number of nearest neighbors to find.", "k", 0);
 // building.
 PARAM_STRING_IN("tree_type", "Type of tree to use: 'kd', 'vp', 'rp', 'max-rp', "
     "'ub', 'cover', 'r', 'r-star', 'x', 'ball', 'hilbert-r', 'r-plus', "
-    "'r-plus-plus', 'spill', 'oct'.", "t", "kd");
+    "'r-plus-plus', 'spill', 'oct', or 'auto' to choose the tree type and the "
+    "leaf size by timing them on a sample of the reference set.", "t", "kd");
 PARAM_INT_IN("leaf_size", "Leaf size for tree building (used for kd-trees, vp "
     "trees, random projection trees, UB trees, R trees, R* trees, X trees, "
     "Hilbert R trees, R+ trees, R++ trees, spill trees, and octrees).", "l",
@@ -95,9 +97,23 @@ PARAM_INT_IN("seed", "Random seed (if 0, std::time(NULL) is used).", "s", 0);
 
 // Search settings.
 PARAM_STRING_IN("algorithm", "Type of neighbor search: 'naive', 'single_tree', "
-    "'dual_tree', 'greedy'.", "a", "dual_tree");
+    "'dual_tree', 'greedy', 'best_first'.", "a", "dual_tree");
+PARAM_FLAG("parallel", "If set, the tree traversal is split between OpenMP "
+    "threads (the number of threads can be controlled with the OMP_NUM_THREADS "
+    "environment variable).", "P");
 PARAM_DOUBLE_IN("epsilon", "If specified, will do approximate nearest neighbor "
     "search with given relative error.", "e", 0);
+PARAM_INT_IN("max_visits", "Maximum number of tree nodes visited for each "
+    "query point by the 'best_first' algorithm (0 means no limit); with a "
+    "limit, the search is approximate but its time is bounded.", "B", 0);
+PARAM_INT_IN("cache_size", "Memory budget of the cache of query results, in "
+    "kilobytes (0 disables it).  In server mode, the cache is kept with the "
+    "model, so repeated query points are answered without a search.", "", 0);
+PARAM_DOUBLE_IN("cache_quantum", "If positive, query points are rounded down "
+    "to multiples of this value before they are looked up in the cache, so "
+    "that nearby points share results (which are then approximate).", "", 0.0);
+
+BINDING_SERVER_MODE();
 
 void mlpackMain()
 {
@@ -165,12 +181,23 @@ void mlpackMain()
   RequireParamValue<double>("epsilon", [](double x) { return x >= 0.0; }, true,
       "epsilon must be positive");
 
+  // Sanity check on the maximum number of visits.
+  RequireParamValue<int>("max_visits", [](int x) { return x >= 0; }, true,
+      "maximum number of visits must be non-negative");
+  RequireParamValue<int>("cache_size", [](int x) { return x >= 0; }, true,
+      "cache size must be non-negative");
+  RequireParamValue<double>("cache_quantum", [](double x) { return x >= 0.0; },
+      true, "cache quantum must be non-negative");
+
   // We either have to load the reference data, or we have to load the model.
-  KNNModel knn;
+  // A loaded model is used in place, so that it stays loaded in server mode.
+  KNNModel builtModel;
+  KNNModel& knn = CLI::HasParam("reference") ? builtModel :
+      CLI::GetParam<KNNModel>("input_model");
 
   const string algorithm = CLI::GetParam<string>("algorithm");
   RequireParamInSet<string>("algorithm", { "naive", "single_tree", "dual_tree",
-      "greedy" }, true, "unknown neighbor search algorithm");
+      "greedy", "best_first" }, true, "unknown neighbor search algorithm");
   NeighborSearchMode searchMode = DUAL_TREE_MODE;
 
   if (algorithm == "naive")
@@ -181,6 +208,14 @@ void mlpackMain()
     searchMode = DUAL_TREE_MODE;
   else if (algorithm == "greedy")
     searchMode = GREEDY_SINGLE_TREE_MODE;
+  else if (algorithm == "best_first")
+    searchMode = BEST_FIRST_SINGLE_TREE_MODE;
+
+  if (algorithm != "best_first")
+  {
+    ReportIgnoredParam("max_visits", "the 'best_first' algorithm is not being "
+        "used");
+  }
 
   if (CLI::HasParam("reference"))
   {
@@ -191,7 +226,7 @@ void mlpackMain()
     KNNModel::TreeTypes tree = KNNModel::KD_TREE;
     RequireParamInSet<string>("tree_type", { "kd", "cover", "r", "r-star",
         "ball", "x", "hilbert-r", "r-plus", "r-plus-plus", "spill", "vp", "rp",
-        "max-rp", "ub", "oct" }, true, "unknown tree type");
+        "max-rp", "ub", "oct", "auto" }, true, "unknown tree type");
     if (treeType == "kd")
       tree = KNNModel::KD_TREE;
     else if (treeType == "cover")
@@ -236,13 +271,23 @@ void mlpackMain()
         << referenceSet.n_rows << " x " << referenceSet.n_cols << ")."
         << endl;
 
-    knn.BuildModel(std::move(referenceSet), size_t(lsInt), searchMode, epsilon);
+    // The naive search uses the points as they are, so place them in the
+    // memory of the threads that will process them.
+    if (searchMode == NAIVE_MODE)
+      data::FirstTouch(referenceSet);
+
+    if (treeType == "auto")
+    {
+      const size_t k = CLI::HasParam("k") ? (size_t) CLI::GetParam<int>("k") :
+          1;
+      knn.Tune(referenceSet, std::max(k, (size_t) 1), searchMode, epsilon);
+    }
+
+    knn.BuildModel(std::move(referenceSet), knn.LeafSize(), searchMode,
+        epsilon);
   }
   else
   {
-    // Load the model from file.
-    knn = std::move(CLI::GetParam<KNNModel>("input_model"));
-
     // Adjust search mode.
     knn.SearchMode() = searchMode;
     knn.Epsilon() = epsilon;
@@ -259,6 +304,11 @@ void mlpackMain()
         << endl;
   }
 
+  knn.Parallel() = CLI::HasParam("parallel");
+  knn.MaxVisits() = (size_t) CLI::GetParam<int>("max_visits");
+  knn.Cache().Quantum(CLI::GetParam<double>("cache_quantum"));
+  knn.Cache().MemoryBudget(1024 * (size_t) CLI::GetParam<int>("cache_size"));
+
   // Perform search, if desired.
   if (CLI::HasParam("k"))
   {
@@ -271,6 +321,9 @@ void mlpackMain()
       Log::Info << "Loaded query data from '"
           << CLI::GetPrintableParam<arma::mat>("query") << "' ("
           << queryData.n_rows << "x" << queryData.n_cols << ")." << endl;
+
+      if (knn.SearchMode() == NAIVE_MODE)
+        data::FirstTouch(queryData);
     }
 
     // Sanity check on k value: must be greater than 0, must be less than the
@@ -292,6 +345,13 @@ void mlpackMain()
     else
       knn.Search(k, neighbors, distances);
     Log::Info << "Search complete." << endl;
+    if (knn.Cache().MemoryBudget() > 0)
+    {
+      Log::Info << "Query cache: " << knn.Cache().Hits() << " hits, "
+          << knn.Cache().Misses() << " misses (hit rate "
+          << 100.0 * knn.Cache().HitRate() << "%), " << knn.Cache().Size()
+          << " entries." << endl;
+    }
 
     // Save output, if desired.
     if (CLI::HasParam("neighbors"))
@@ -340,5 +400,11 @@ void mlpackMain()
   }
 
   if (CLI::HasParam("output_model"))
-    CLI::GetParam<KNNModel>("output_model") = std::move(knn);
+  {
+    // A loaded model is copied, since it may be used again in server mode.
+    if (CLI::HasParam("input_model"))
+      CLI::GetParam<KNNModel>("output_model") = knn;
+    else
+      CLI::GetParam<KNNModel>("output_model") = std::move(knn);
+  }
 }
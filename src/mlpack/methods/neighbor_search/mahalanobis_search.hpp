@@ -0,0 +1,135 @@
+/**
+ * @file mahalanobis_search.hpp
+ *
+ * Definition of the MahalanobisSearch class, which performs neighbor searches
+ * under a Mahalanobis distance with trees built in Euclidean space.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_NEIGHBOR_SEARCH_MAHALANOBIS_SEARCH_HPP
+#define MLPACK_METHODS_NEIGHBOR_SEARCH_MAHALANOBIS_SEARCH_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/metrics/mahalanobis_distance.hpp>
+#include "neighbor_search.hpp"
+
+namespace mlpack {
+namespace neighbor {
+
+/**
+ * Search for neighbors under the Mahalanobis distance
+ * d(x, y) = sqrt((x - y)^T Q (x - y)).  With Q = L^T L, this is the Euclidean
+ * distance between L x and L y, so the reference set is transformed once by L
+ * (see MahalanobisDistance::Transform()) and searched with a NeighborSearch
+ * under the Euclidean distance.  The trees then have tight bounds and the
+ * distances are computed with the fast Euclidean kernels, instead of one
+ * quadratic form per pair of points.  The transformation does not change the
+ * order of the points, so the neighbor indices need no mapping; if the
+ * Mahalanobis distance does not take the root, the distances are squared
+ * afterwards.
+ *
+ * This is how a metric learned by NCA or LMNN is best used for search.
+ *
+ * @tparam SortPolicy The sort policy for distances; see NearestNeighborSort.
+ * @tparam TakeRoot Whether the Mahalanobis distance takes the root.
+ * @tparam TreeType The tree type to use.
+ */
+template<typename SortPolicy = NearestNeighborSort,
+         bool TakeRoot = true,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType = tree::KDTree>
+class MahalanobisSearch
+{
+ public:
+  //! The Euclidean neighbor search used in the transformed space.
+  typedef NeighborSearch<SortPolicy, metric::EuclideanDistance, arma::mat,
+      TreeType> SearchType;
+
+  /**
+   * Transform the reference set with the given Mahalanobis distance and build
+   * the Euclidean neighbor search on it.
+   *
+   * @param referenceSet Set of reference points.
+   * @param metric The Mahalanobis distance to search with.
+   * @param mode Neighbor search mode.
+   * @param epsilon Relative approximate error (non-negative).
+   */
+  MahalanobisSearch(const arma::mat& referenceSet,
+                    const metric::MahalanobisDistance<TakeRoot>& metric,
+                    const NeighborSearchMode mode = DUAL_TREE_MODE,
+                    const double epsilon = 0) :
+      metric(metric),
+      search(mode, epsilon)
+  {
+    arma::mat transformed;
+    metric.Transform(referenceSet, transformed);
+    search.Train(std::move(transformed));
+  }
+
+  /**
+   * Find the k neighbors in the reference set of each point in the query set.
+   *
+   * @param querySet Set of query points.
+   * @param k Number of neighbors to search for.
+   * @param neighbors Matrix storing lists of neighbors for each query point.
+   * @param distances Matrix storing distances of neighbors for each query
+   *     point.
+   */
+  void Search(const arma::mat& querySet,
+              const size_t k,
+              arma::Mat<size_t>& neighbors,
+              arma::mat& distances)
+  {
+    arma::mat transformed;
+    metric.Transform(querySet, transformed);
+    search.Search(transformed, k, neighbors, distances);
+    MapDistances(distances);
+  }
+
+  /**
+   * Find the k neighbors of each point in the reference set, excluding the
+   * point itself.
+   *
+   * @param k Number of neighbors to search for.
+   * @param neighbors Matrix storing lists of neighbors for each point.
+   * @param distances Matrix storing distances of neighbors for each point.
+   */
+  void Search(const size_t k,
+              arma::Mat<size_t>& neighbors,
+              arma::mat& distances)
+  {
+    search.Search(k, neighbors, distances);
+    MapDistances(distances);
+  }
+
+  //! Get the Mahalanobis distance.
+  const metric::MahalanobisDistance<TakeRoot>& Metric() const { return metric; }
+
+  //! Get the Euclidean neighbor search in the transformed space.
+  const SearchType& Searcher() const { return search; }
+  //! Modify the Euclidean neighbor search in the transformed space.
+  SearchType& Searcher() { return search; }
+
+ private:
+  //! Map Euclidean distances in the transformed space back to the Mahalanobis
+  //! distance.
+  static void MapDistances(arma::mat& distances)
+  {
+    if (!TakeRoot)
+      distances = arma::square(distances);
+  }
+
+  //! The Mahalanobis distance.
+  metric::MahalanobisDistance<TakeRoot> metric;
+  //! The Euclidean neighbor search in the transformed space.
+  SearchType search;
+};
+
+} // namespace neighbor
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,21 @@
+/**
+ * @file neighbor_search.cpp
+ *
+ * Force instantiation of the KNN and KFN classes to reduce compile time.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "neighbor_search.hpp"
+
+namespace mlpack {
+namespace neighbor {
+
+template class NeighborSearch<NearestNeighborSort, metric::EuclideanDistance>;
+
+template class NeighborSearch<FurthestNeighborSort, metric::EuclideanDistance>;
+
+} // namespace neighbor
+} // namespace mlpack
@@ -20,6 +20,7 @@
 #include <mlpack/core/tree/binary_space_tree.hpp>
 #include <mlpack/core/tree/rectangle_tree.hpp>
 #include <mlpack/core/tree/binary_space_tree/binary_space_tree.hpp>
+#include <mlpack/core/tree/best_first_single_tree_traverser.hpp>
 
 #include "neighbor_search_stat.hpp"
 #include "sort_policies/nearest_neighbor_sort.hpp"
@@ -40,7 +41,8 @@ enum NeighborSearchMode
   NAIVE_MODE,
   SINGLE_TREE_MODE,
   DUAL_TREE_MODE,
-  GREEDY_SINGLE_TREE_MODE
+  GREEDY_SINGLE_TREE_MODE,
+  BEST_FIRST_SINGLE_TREE_MODE
 };
 
 /**
@@ -189,6 +191,36 @@ class NeighborSearch
       const double epsilon = 0,
       const MetricType metric = MetricType());
 
+  /**
+   * Initialize the NeighborSearch object with the given pre-constructed
+   * reference tree, without copying it or taking ownership of it (like
+   * RangeSearch, RASearch and FastMKS do).  The tree (and its dataset) can
+   * then be shared by several NeighborSearch objects, for instance with
+   * different search modes or approximation levels, and it must outlive them.
+   * Naive mode is not available as an option for this constructor.
+   *
+   * Searches may modify the statistics of the tree, so two searches on the
+   * same tree must not run at the same time; the statistics are reset before
+   * each monochromatic dual-tree search.
+   *
+   * @note
+   * Mapping the points of the matrix back to their original indices is not done
+   * when this constructor is used, so if the tree type you are using maps
+   * points (like BinarySpaceTree), then you will have to perform the re-mapping
+   * manually.
+   * @endnote
+   *
+   * @param referenceTree Pre-built tree for reference points.
+   * @param mode Neighbor search mode.
+   * @param epsilon Relative approximate error (non-negative).
+   * @param metric Instantiated distance metric.
+   */
+  NeighborSearch(
+      Tree* referenceTree,
+      const NeighborSearchMode mode = DUAL_TREE_MODE,
+      const double epsilon = 0,
+      const MetricType metric = MetricType());
+
   /**
    * Create a NeighborSearch object without any reference data.  If Search() is
    * called before a reference set is set with Train(), an exception will be
@@ -277,6 +309,52 @@ class NeighborSearch
    */
   void Train(Tree&& referenceTree);
 
+  /**
+   * Set the reference tree to the given reference tree, without copying it or
+   * taking ownership of it; see the constructor that takes a Tree*.
+   *
+   * @param referenceTree Pre-built tree for reference points.
+   */
+  void Train(Tree* referenceTree);
+
+  /**
+   * Insert the given points into the reference tree, without rebuilding the
+   * whole tree.  This is only possible for trees that support insertion (like
+   * kd-trees and ball trees) and that were built by this object; in naive mode,
+   * or if no tree was built, a std::invalid_argument is thrown.  The new points
+   * are given the indices after all the existing reference points, in order;
+   * the indices of the existing reference points do not change.
+   *
+   * Subtrees that become unbalanced (or too small) are rebuilt; see
+   * BinarySpaceTree::InsertPoints() for the meaning of the parameters.
+   *
+   * @param points Points to insert.
+   * @param maxLeafSize Maximum number of points in a leaf.
+   * @param rebuildFraction Fraction of points of a subtree that can change
+   *     before that subtree is rebuilt.
+   */
+  void InsertPoints(const MatType& points,
+                    const size_t maxLeafSize = 20,
+                    const double rebuildFraction = 0.5);
+
+  /**
+   * Delete the reference points with the given indices from the reference tree,
+   * without rebuilding the whole tree.  The same restrictions as for
+   * InsertPoints() apply, and a std::invalid_argument is also thrown if a point
+   * does not exist or was already deleted.  Deleted points keep their index (so
+   * the indices of other points do not change) and will not be returned by any
+   * later search; the columns of the results of a monochromatic search that
+   * correspond to deleted points should be ignored.
+   *
+   * @param indices Indices of reference points to delete.
+   * @param maxLeafSize Maximum number of points in a leaf.
+   * @param rebuildFraction Fraction of points of a subtree that can change
+   *     before that subtree is rebuilt.
+   */
+  void DeletePoints(const std::vector<size_t>& indices,
+                    const size_t maxLeafSize = 20,
+                    const double rebuildFraction = 0.5);
+
   /**
    * For each point in the query set, compute the nearest neighbors and store
    * the output in the given matrices.  The matrices will be set to the size of
@@ -392,7 +470,23 @@ class NeighborSearch
   //! Modify the relative error to be considered in approximate search.
   double& Epsilon() { return epsilon; }
 
-  //! Access the reference dataset.
+  //! Access whether or not tree traversals are parallelized with OpenMP.  In
+  //! single-tree and greedy mode, query points are split between threads; in
+  //! dual-tree mode, subtrees of the query tree are.
+  bool Parallel() const { return parallel; }
+  //! Modify whether or not tree traversals are parallelized with OpenMP.
+  bool& Parallel() { return parallel; }
+
+  //! Access the maximum number of reference nodes visited for each query point
+  //! in best-first mode (0 means no limit).  With a limit, the results are
+  //! approximate.
+  size_t MaxVisits() const { return maxVisits; }
+  //! Modify the maximum number of reference nodes visited for each query point
+  //! in best-first mode (0 means no limit).
+  size_t& MaxVisits() { return maxVisits; }
+
+  //! Access the reference dataset.  If points have been deleted with
+  //! DeletePoints(), they are still held at the end of the dataset.
   const MatType& ReferenceSet() const { return *referenceSet; }
 
   //! Access the reference tree.
@@ -421,6 +515,10 @@ class NeighborSearch
   NeighborSearchMode searchMode;
   //! Indicates the relative error to be considered in approximate search.
   double epsilon;
+  //! If true, tree traversals are split between OpenMP threads.
+  bool parallel;
+  //! The maximum number of nodes visited for each query in best-first mode.
+  size_t maxVisits;
 
   //! Instantiation of metric.
   MetricType metric;
@@ -434,6 +532,78 @@ class NeighborSearch
   //! Search() without a query set.
   bool treeNeedsReset;
 
+  //! Return the number of reference points that can be returned by a search
+  //! (that is, those that have not been deleted).
+  size_t NumReferencePoints() const
+  {
+    return (treeOwner && referenceTree) ? referenceTree->NumDescendants() :
+        referenceSet->n_cols;
+  }
+
+  //! Make sure that points can be inserted into or deleted from the reference
+  //! tree, and that a mapping of the reference points exists.
+  void CheckModifiable(const char* function);
+
+  /**
+   * Perform a dual-tree traversal of the given query and reference trees with
+   * the given rules.  If parallel search is enabled (and OpenMP is available),
+   * the query tree is split into a number of disjoint subtrees near its root,
+   * and each subtree is traversed against the whole reference tree by one
+   * thread, with its own traverser and its own copy of the rules (sharing the
+   * candidate lists).  The base case and score counts of the rules are
+   * updated.
+   *
+   * @param queryTree Tree built on the query points.
+   * @param referenceTree Tree built on the reference points.
+   * @param rules Rules to use for the traversal.
+   */
+  template<typename RuleType>
+  void DualTreeTraversal(Tree& queryTree,
+                         Tree& referenceTree,
+                         RuleType& rules);
+
+  /**
+   * Perform the naive (brute-force) search of the given query points, with the
+   * given rules.  The query and reference points are split into tiles, the
+   * distances of each pair of tiles are computed at once with
+   * metric::EvaluateTile() (a matrix multiplication for the Euclidean
+   * distance), and each query point's row of the tile is given to the rules.
+   * If parallel search is enabled (and OpenMP is available), the query tiles
+   * are split between threads, each of which has its own copy of the rules
+   * (sharing the candidate lists).
+   *
+   * @param querySet Set of query points.
+   * @param rules Rules to use for the search.
+   */
+  template<typename RuleType>
+  void NaiveSearch(const MatType& querySet, RuleType& rules);
+
+  /**
+   * Run a single-tree traversal of the reference tree for each of the given
+   * number of query points, using the given traverser type and rules.  If
+   * parallel search is enabled (and OpenMP is available), the query points are
+   * split between threads, each of which has its own traverser and its own
+   * copy of the rules (sharing the candidate lists).  The base case and score
+   * counts of the rules are updated.
+   *
+   * @param numQueries Number of query points.
+   * @param rules Rules to use for the traversal.
+   */
+  template<typename TraverserType, typename RuleType>
+  void SingleTreeTraversal(const size_t numQueries, RuleType& rules);
+
+  //! Give the maximum number of visits to a best-first traverser.
+  template<typename RuleType>
+  void SetMaxVisits(
+      tree::BestFirstSingleTreeTraverser<Tree, RuleType>& traverser) const
+  {
+    traverser.MaxVisits() = maxVisits;
+  }
+
+  //! Other traversers have no maximum number of visits.
+  template<typename TraverserType>
+  void SetMaxVisits(TraverserType& /* traverser */) const { }
+
   //! The NSModel class should have access to internal members.
   template<typename SortPol>
   friend class TrainVisitor;
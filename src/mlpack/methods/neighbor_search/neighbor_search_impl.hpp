@@ -15,7 +15,9 @@
 
 #include <mlpack/prereqs.hpp>
 #include <mlpack/core/tree/greedy_single_tree_traverser.hpp>
+#include <mlpack/core/tree/split_frontier.hpp>
 #include "neighbor_search_rules.hpp"
+#include "unmap.hpp"
 #include <mlpack/core/tree/spill_tree/is_spill_tree.hpp>
 
 namespace mlpack {
@@ -67,6 +69,8 @@ SingleTreeTraversalType>::NeighborSearch(const MatType& referenceSetIn,
     setOwner(false),
     searchMode(mode),
     epsilon(epsilon),
+    parallel(false),
+    maxVisits(0),
     metric(metric),
     baseCases(0),
     scores(0),
@@ -98,6 +102,8 @@ SingleTreeTraversalType>::NeighborSearch(MatType&& referenceSetIn,
     setOwner(mode == NAIVE_MODE),
     searchMode(mode),
     epsilon(epsilon),
+    parallel(false),
+    maxVisits(0),
     metric(metric),
     baseCases(0),
     scores(0),
@@ -127,6 +133,8 @@ SingleTreeTraversalType>::NeighborSearch(const Tree& referenceTree,
     setOwner(false),
     searchMode(mode),
     epsilon(epsilon),
+    parallel(false),
+    maxVisits(0),
     metric(metric),
     baseCases(0),
     scores(0),
@@ -156,6 +164,8 @@ SingleTreeTraversalType>::NeighborSearch(Tree&& referenceTree,
     setOwner(false),
     searchMode(mode),
     epsilon(epsilon),
+    parallel(false),
+    maxVisits(0),
     metric(metric),
     baseCases(0),
     scores(0),
@@ -165,6 +175,40 @@ SingleTreeTraversalType>::NeighborSearch(Tree&& referenceTree,
     throw std::invalid_argument("epsilon must be non-negative");
 }
 
+// Construct the object with a tree that it doesn't own.
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+NeighborSearch<SortPolicy, MetricType, MatType, TreeType, DualTreeTraversalType,
+SingleTreeTraversalType>::NeighborSearch(Tree* referenceTree,
+                                         const NeighborSearchMode mode,
+                                         const double epsilon,
+                                         const MetricType metric) :
+    referenceTree(referenceTree),
+    referenceSet(&referenceTree->Dataset()),
+    treeOwner(false),
+    setOwner(false),
+    searchMode(mode),
+    epsilon(epsilon),
+    parallel(false),
+    maxVisits(0),
+    metric(metric),
+    baseCases(0),
+    scores(0),
+    treeNeedsReset(true) // Another object may have used the statistics.
+{
+  if (mode == NAIVE_MODE)
+    throw std::invalid_argument("cannot use a reference tree when naive search "
+        "(without trees) is desired");
+  if (epsilon < 0)
+    throw std::invalid_argument("epsilon must be non-negative");
+}
+
 // Construct the object without a reference dataset.
 template<typename SortPolicy,
          typename MetricType,
@@ -184,6 +228,8 @@ SingleTreeTraversalType>::NeighborSearch(const NeighborSearchMode mode,
     setOwner(true),
     searchMode(mode),
     epsilon(epsilon),
+    parallel(false),
+    maxVisits(0),
     metric(metric),
     baseCases(0),
     scores(0),
@@ -219,6 +265,8 @@ SingleTreeTraversalType>::NeighborSearch(const NeighborSearch& other) :
     setOwner(!other.referenceTree),
     searchMode(other.searchMode),
     epsilon(other.epsilon),
+    parallel(other.parallel),
+    maxVisits(other.maxVisits),
     metric(other.metric),
     baseCases(other.baseCases),
     scores(other.scores),
@@ -245,6 +293,8 @@ SingleTreeTraversalType>::NeighborSearch(NeighborSearch&& other) :
     setOwner(other.setOwner),
     searchMode(other.searchMode),
     epsilon(other.epsilon),
+    parallel(other.parallel),
+    maxVisits(other.maxVisits),
     metric(std::move(other.metric)),
     baseCases(other.baseCases),
     scores(other.scores),
@@ -258,6 +308,8 @@ SingleTreeTraversalType>::NeighborSearch(NeighborSearch&& other) :
   other.setOwner = true;
   other.searchMode = DUAL_TREE_MODE,
   other.epsilon = 0.0;
+  other.parallel = false;
+  other.maxVisits = 0;
   other.baseCases = 0;
   other.scores = 0;
   other.treeNeedsReset = false;
@@ -299,6 +351,8 @@ NeighborSearch<SortPolicy,
   setOwner = (other.referenceTree == NULL);
   searchMode = other.searchMode;
   epsilon = other.epsilon;
+  parallel = other.parallel;
+  maxVisits = other.maxVisits;
   metric = other.metric;
   baseCases = other.baseCases;
   scores = other.scores;
@@ -340,6 +394,8 @@ NeighborSearch<SortPolicy,
   setOwner = other.setOwner;
   searchMode = other.searchMode;
   epsilon = other.epsilon;
+  parallel = other.parallel;
+  maxVisits = other.maxVisits;
   metric = other.metric;
   baseCases = other.baseCases;
   scores = other.scores;
@@ -353,6 +409,8 @@ NeighborSearch<SortPolicy,
   other.setOwner = true;
   other.searchMode = DUAL_TREE_MODE,
   other.epsilon = 0.0;
+  other.parallel = false;
+  other.maxVisits = 0;
   other.baseCases = 0;
   other.scores = 0;
   other.treeNeedsReset = false;
@@ -524,6 +582,134 @@ DualTreeTraversalType, SingleTreeTraversalType>::Train(Tree&& referenceTree)
   setOwner = false;
 }
 
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+void NeighborSearch<SortPolicy, MetricType, MatType, TreeType,
+DualTreeTraversalType, SingleTreeTraversalType>::Train(Tree* referenceTree)
+{
+  if (searchMode == NAIVE_MODE)
+    throw std::invalid_argument("cannot train on given reference tree when "
+        "naive search (without trees) is desired");
+
+  if (treeOwner && this->referenceTree)
+  {
+    oldFromNewReferences.clear();
+    delete this->referenceTree;
+  }
+
+  if (setOwner && referenceSet)
+    delete this->referenceSet;
+
+  this->referenceTree = referenceTree;
+  this->referenceSet = &this->referenceTree->Dataset();
+  treeOwner = false;
+  setOwner = false;
+
+  // Another object may have used the statistics of the tree.
+  treeNeedsReset = true;
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+void NeighborSearch<SortPolicy, MetricType, MatType, TreeType,
+DualTreeTraversalType, SingleTreeTraversalType>::CheckModifiable(
+    const char* function)
+{
+  if (searchMode == NAIVE_MODE || !treeOwner || !referenceTree)
+  {
+    std::stringstream ss;
+    ss << "NeighborSearch::" << function << "(): points can only be modified "
+        << "when a reference tree is held (not in naive mode)";
+    throw std::invalid_argument(ss.str());
+  }
+
+  // If the tree was given to us, the indices of the reference points are their
+  // indices in the tree's dataset; they must be kept stable from now on.
+  if (oldFromNewReferences.empty())
+  {
+    oldFromNewReferences.resize(referenceSet->n_cols);
+    for (size_t i = 0; i < oldFromNewReferences.size(); ++i)
+      oldFromNewReferences[i] = i;
+  }
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+void NeighborSearch<SortPolicy, MetricType, MatType, TreeType,
+DualTreeTraversalType, SingleTreeTraversalType>::InsertPoints(
+    const MatType& points,
+    const size_t maxLeafSize,
+    const double rebuildFraction)
+{
+  CheckModifiable("InsertPoints");
+
+  // The dataset is modified in place, so referenceSet stays valid.
+  referenceTree->InsertPoints(points, oldFromNewReferences, maxLeafSize,
+      rebuildFraction);
+
+  // Only the modified nodes had their statistics recomputed.
+  treeNeedsReset = true;
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+void NeighborSearch<SortPolicy, MetricType, MatType, TreeType,
+DualTreeTraversalType, SingleTreeTraversalType>::DeletePoints(
+    const std::vector<size_t>& indices,
+    const size_t maxLeafSize,
+    const double rebuildFraction)
+{
+  CheckModifiable("DeletePoints");
+
+  // Find where each of the points that are still in the tree is held.
+  std::vector<size_t> newFromOld(oldFromNewReferences.size(), size_t(-1));
+  for (size_t i = 0; i < referenceTree->NumDescendants(); ++i)
+    newFromOld[oldFromNewReferences[i]] = i;
+
+  std::vector<size_t> points(indices.size());
+  for (size_t i = 0; i < indices.size(); ++i)
+  {
+    if (indices[i] >= newFromOld.size() || newFromOld[indices[i]] == size_t(-1))
+    {
+      std::stringstream ss;
+      ss << "NeighborSearch::DeletePoints(): reference point " << indices[i]
+          << " does not exist or was already deleted";
+      throw std::invalid_argument(ss.str());
+    }
+
+    points[i] = newFromOld[indices[i]];
+  }
+
+  referenceTree->DeletePoints(points, oldFromNewReferences, maxLeafSize,
+      rebuildFraction);
+
+  treeNeedsReset = true;
+}
+
 /**
  * Computes the best neighbors and stores them in resultingNeighbors and
  * distances.
@@ -543,11 +729,11 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
     arma::Mat<size_t>& neighbors,
     arma::mat& distances)
 {
-  if (k > referenceSet->n_cols)
+  if (k > NumReferencePoints())
   {
     std::stringstream ss;
     ss << "requested value of k (" << k << ") is greater than the number of "
-        << "points in the reference set (" << referenceSet->n_cols << ")";
+        << "points in the reference set (" << NumReferencePoints() << ")";
     throw std::invalid_argument(ss.str());
   }
 
@@ -574,8 +760,7 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
       distancePtr = new arma::mat; // Query indices need to be mapped.
       neighborPtr = new arma::Mat<size_t>;
     }
-    else if (!oldFromNewReferences.empty())
-      neighborPtr = new arma::Mat<size_t>; // Reference indices need mapping.
+    // Otherwise, reference indices are mapped in place, if necessary.
   }
 
   // Set the size of the neighbor and distance matrices.
@@ -592,11 +777,9 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
       RuleType rules(*referenceSet, querySet, k, metric, epsilon);
 
       // The naive brute-force traversal.
-      for (size_t i = 0; i < querySet.n_cols; ++i)
-        for (size_t j = 0; j < referenceSet->n_cols; ++j)
-          rules.BaseCase(i, j);
+      NaiveSearch(querySet, rules);
 
-      baseCases += querySet.n_cols * referenceSet->n_cols;
+      baseCases += querySet.n_cols * NumReferencePoints();
 
       rules.GetResults(*neighborPtr, *distancePtr);
       break;
@@ -606,12 +789,9 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
       // Create the helper object for the tree traversal.
       RuleType rules(*referenceSet, querySet, k, metric, epsilon);
 
-      // Create the traverser.
-      SingleTreeTraversalType<RuleType> traverser(rules);
-
-      // Now have it traverse for each point.
-      for (size_t i = 0; i < querySet.n_cols; ++i)
-        traverser.Traverse(i, *referenceTree);
+      // Now traverse for each point.
+      SingleTreeTraversal<SingleTreeTraversalType<RuleType>>(querySet.n_cols,
+          rules);
 
       scores += rules.Scores();
       baseCases += rules.BaseCases();
@@ -620,6 +800,7 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
           << std::endl;
       Log::Info << rules.BaseCases() << " base cases were calculated."
           << std::endl;
+      rules.Counters().Report();
 
       rules.GetResults(*neighborPtr, *distancePtr);
       break;
@@ -636,10 +817,7 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
       // Create the helper object for the tree traversal.
       RuleType rules(*referenceSet, queryTree->Dataset(), k, metric, epsilon);
 
-      // Create the traverser.
-      DualTreeTraversalType<RuleType> traverser(rules);
-
-      traverser.Traverse(*queryTree, *referenceTree);
+      DualTreeTraversal(*queryTree, *referenceTree, rules);
 
       scores += rules.Scores();
       baseCases += rules.BaseCases();
@@ -648,6 +826,7 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
           << std::endl;
       Log::Info << rules.BaseCases() << " base cases were calculated."
           << std::endl;
+      rules.Counters().Report();
 
       rules.GetResults(*neighborPtr, *distancePtr);
 
@@ -659,12 +838,38 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
       // Create the helper object for the tree traversal.
       RuleType rules(*referenceSet, querySet, k, metric);
 
-      // Create the traverser.
-      tree::GreedySingleTreeTraverser<Tree, RuleType> traverser(rules);
+      // Now traverse for each point.
+      SingleTreeTraversal<tree::GreedySingleTreeTraverser<Tree, RuleType>>(
+          querySet.n_cols, rules);
 
-      // Now have it traverse for each point.
-      for (size_t i = 0; i < querySet.n_cols; ++i)
-        traverser.Traverse(i, *referenceTree);
+      scores += rules.Scores();
+      baseCases += rules.BaseCases();
+
+      Log::Info << rules.Scores() << " node combinations were scored."
+          << std::endl;
+      Log::Info << rules.BaseCases() << " base cases were calculated."
+          << std::endl;
+      rules.Counters().Report();
+
+      rules.GetResults(*neighborPtr, *distancePtr);
+      break;
+    }
+    case BEST_FIRST_SINGLE_TREE_MODE:
+    {
+      // Overlapping nodes of spill trees hold the same points, which would be
+      // added as neighbors more than once.
+      if (tree::IsSpillTree<Tree>::value)
+      {
+        throw std::invalid_argument("best-first search can't be used with "
+            "spill trees");
+      }
+
+      // Create the helper object for the tree traversal.
+      RuleType rules(*referenceSet, querySet, k, metric, epsilon);
+
+      // Now traverse for each point.
+      SingleTreeTraversal<tree::BestFirstSingleTreeTraverser<Tree, RuleType>>(
+          querySet.n_cols, rules);
 
       scores += rules.Scores();
       baseCases += rules.BaseCases();
@@ -673,6 +878,7 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
           << std::endl;
       Log::Info << rules.BaseCases() << " base cases were calculated."
           << std::endl;
+      rules.Counters().Report();
 
       rules.GetResults(*neighborPtr, *distancePtr);
       break;
@@ -687,21 +893,8 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
     if (searchMode == DUAL_TREE_MODE && !oldFromNewReferences.empty())
     {
       // We must map both query and reference indices.
-      neighbors.set_size(k, querySet.n_cols);
-      distances.set_size(k, querySet.n_cols);
-
-      for (size_t i = 0; i < distances.n_cols; i++)
-      {
-        // Map distances (copy a column).
-        distances.col(oldFromNewQueries[i]) = distancePtr->col(i);
-
-        // Map indices of neighbors.
-        for (size_t j = 0; j < distances.n_rows; j++)
-        {
-          neighbors(j, oldFromNewQueries[i]) =
-              oldFromNewReferences[(*neighborPtr)(j, i)];
-        }
-      }
+      Unmap(*neighborPtr, *distancePtr, oldFromNewReferences,
+          oldFromNewQueries, neighbors, distances);
 
       // Finished with temporary matrices.
       delete neighborPtr;
@@ -713,7 +906,8 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
       neighbors.set_size(k, querySet.n_cols);
       distances.set_size(k, querySet.n_cols);
 
-      for (size_t i = 0; i < distances.n_cols; ++i)
+      #pragma omp parallel for
+      for (omp_size_t i = 0; i < (omp_size_t) distances.n_cols; ++i)
       {
         // Map distances (copy a column).
         const size_t queryMapping = oldFromNewQueries[i];
@@ -727,16 +921,8 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
     }
     else if (!oldFromNewReferences.empty())
     {
-      // We must map reference indices only.
-      neighbors.set_size(k, querySet.n_cols);
-
-      // Map indices of neighbors.
-      for (size_t i = 0; i < neighbors.n_cols; i++)
-        for (size_t j = 0; j < neighbors.n_rows; j++)
-          neighbors(j, i) = oldFromNewReferences[(*neighborPtr)(j, i)];
-
-      // Finished with temporary matrix.
-      delete neighborPtr;
+      // We must map reference indices only, which is done in place.
+      UnmapInPlace(neighbors, distances, oldFromNewReferences);
     }
   }
 } // Search()
@@ -757,11 +943,11 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
     arma::mat& distances,
     bool sameSet)
 {
-  if (k > referenceSet->n_cols)
+  if (k > NumReferencePoints())
   {
     std::stringstream ss;
     ss << "requested value of k (" << k << ") is greater than the number of "
-        << "points in the reference set (" << referenceSet->n_cols << ")";
+        << "points in the reference set (" << NumReferencePoints() << ")";
     throw std::invalid_argument(ss.str());
   }
 
@@ -778,31 +964,25 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
   // Get a reference to the query set.
   const MatType& querySet = queryTree.Dataset();
 
-  // We won't need to map query indices, but will we need to map distances?
-  arma::Mat<size_t>* neighborPtr = &neighbors;
-
-  if (!oldFromNewReferences.empty() &&
-      tree::TreeTraits<Tree>::RearrangesDataset)
-    neighborPtr = new arma::Mat<size_t>;
-
-  neighborPtr->set_size(k, querySet.n_cols);
+  // We won't need to map query indices, and reference indices are mapped in
+  // place.
+  neighbors.set_size(k, querySet.n_cols);
   distances.set_size(k, querySet.n_cols);
 
   // Create the helper object for the traversal.
   typedef NeighborSearchRules<SortPolicy, MetricType, Tree> RuleType;
   RuleType rules(*referenceSet, querySet, k, metric, epsilon, sameSet);
 
-  // Create the traverser.
-  DualTreeTraversalType<RuleType> traverser(rules);
-  traverser.Traverse(queryTree, *referenceTree);
+  DualTreeTraversal(queryTree, *referenceTree, rules);
 
   scores += rules.Scores();
   baseCases += rules.BaseCases();
 
   Log::Info << rules.Scores() << " node combinations were scored." << std::endl;
   Log::Info << rules.BaseCases() << " base cases were calculated." << std::endl;
+  rules.Counters().Report();
 
-  rules.GetResults(*neighborPtr, distances);
+  rules.GetResults(neighbors, distances);
 
   Log::Info << rules.Scores() << " node combinations were scored.\n";
   Log::Info << rules.BaseCases() << " base cases were calculated.\n";
@@ -814,15 +994,7 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
       tree::TreeTraits<Tree>::RearrangesDataset)
   {
     // We must map reference indices only.
-    neighbors.set_size(k, querySet.n_cols);
-
-    // Map indices of neighbors.
-    for (size_t i = 0; i < neighbors.n_cols; i++)
-      for (size_t j = 0; j < neighbors.n_rows; j++)
-        neighbors(j, i) = oldFromNewReferences[(*neighborPtr)(j, i)];
-
-    // Finished with temporary matrix.
-    delete neighborPtr;
+    UnmapInPlace(neighbors, distances, oldFromNewReferences);
   }
 }
 
@@ -840,11 +1012,11 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
     arma::Mat<size_t>& neighbors,
     arma::mat& distances)
 {
-  if (k > referenceSet->n_cols)
+  if (k > NumReferencePoints())
   {
     std::stringstream ss;
     ss << "requested value of k (" << k << ") is greater than the number of "
-        << "points in the reference set (" << referenceSet->n_cols << ")";
+        << "points in the reference set (" << NumReferencePoints() << ")";
     throw std::invalid_argument(ss.str());
   }
 
@@ -878,21 +1050,16 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
     case NAIVE_MODE:
     {
       // The naive brute-force solution.
-      for (size_t i = 0; i < referenceSet->n_cols; ++i)
-        for (size_t j = 0; j < referenceSet->n_cols; ++j)
-          rules.BaseCase(i, j);
+      NaiveSearch(*referenceSet, rules);
 
-      baseCases += referenceSet->n_cols * referenceSet->n_cols;
+      baseCases += referenceSet->n_cols * NumReferencePoints();
       break;
     }
     case SINGLE_TREE_MODE:
     {
-      // Create the traverser.
-      SingleTreeTraversalType<RuleType> traverser(rules);
-
-      // Now have it traverse for each point.
-      for (size_t i = 0; i < referenceSet->n_cols; ++i)
-        traverser.Traverse(i, *referenceTree);
+      // Now traverse for each point.
+      SingleTreeTraversal<SingleTreeTraversalType<RuleType>>(
+          referenceSet->n_cols, rules);
 
       scores += rules.Scores();
       baseCases += rules.BaseCases();
@@ -901,13 +1068,15 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
           << std::endl;
       Log::Info << rules.BaseCases() << " base cases were calculated."
           << std::endl;
+      rules.Counters().Report();
       break;
     }
     case DUAL_TREE_MODE:
     {
       // The dual-tree monochromatic search case may require resetting the
-      // bounds in the tree.
-      if (treeNeedsReset)
+      // bounds in the tree.  A tree we don't own may have been searched by
+      // another object since, so it is always reset.
+      if (treeNeedsReset || !treeOwner)
       {
         std::stack<Tree*> nodes;
         nodes.push(referenceTree);
@@ -925,19 +1094,16 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
         }
       }
 
-      // Create the traverser.
-      DualTreeTraversalType<RuleType> traverser(rules);
-
       if (tree::IsSpillTree<Tree>::value)
       {
         // For Dual Tree Search on SpillTree, the queryTree must be built with
         // non overlapping (tau = 0).
         Tree queryTree(*referenceSet);
-        traverser.Traverse(queryTree, *referenceTree);
+        DualTreeTraversal(queryTree, *referenceTree, rules);
       }
       else
       {
-        traverser.Traverse(*referenceTree, *referenceTree);
+        DualTreeTraversal(*referenceTree, *referenceTree, rules);
         // Next time we perform this search, we'll need to reset the tree.
         treeNeedsReset = true;
       }
@@ -949,6 +1115,7 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
           << std::endl;
       Log::Info << rules.BaseCases() << " base cases were calculated."
           << std::endl;
+      rules.Counters().Report();
 
       // Next time we perform this search, we'll need to reset the tree.
       treeNeedsReset = true;
@@ -956,12 +1123,33 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
     }
     case GREEDY_SINGLE_TREE_MODE:
     {
-      // Create the traverser.
-      tree::GreedySingleTreeTraverser<Tree, RuleType> traverser(rules);
+      // Now traverse for each point.
+      SingleTreeTraversal<tree::GreedySingleTreeTraverser<Tree, RuleType>>(
+          referenceSet->n_cols, rules);
 
-      // Now have it traverse for each point.
-      for (size_t i = 0; i < referenceSet->n_cols; ++i)
-        traverser.Traverse(i, *referenceTree);
+      scores += rules.Scores();
+      baseCases += rules.BaseCases();
+
+      Log::Info << rules.Scores() << " node combinations were scored."
+          << std::endl;
+      Log::Info << rules.BaseCases() << " base cases were calculated."
+          << std::endl;
+      rules.Counters().Report();
+      break;
+    }
+    case BEST_FIRST_SINGLE_TREE_MODE:
+    {
+      // Overlapping nodes of spill trees hold the same points, which would be
+      // added as neighbors more than once.
+      if (tree::IsSpillTree<Tree>::value)
+      {
+        throw std::invalid_argument("best-first search can't be used with "
+            "spill trees");
+      }
+
+      // Now traverse for each point.
+      SingleTreeTraversal<tree::BestFirstSingleTreeTraverser<Tree, RuleType>>(
+          referenceSet->n_cols, rules);
 
       scores += rules.Scores();
       baseCases += rules.BaseCases();
@@ -970,6 +1158,7 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
           << std::endl;
       Log::Info << rules.BaseCases() << " base cases were calculated."
           << std::endl;
+      rules.Counters().Report();
       break;
     }
   }
@@ -985,15 +1174,21 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
     neighbors.set_size(k, referenceSet->n_cols);
     distances.set_size(k, referenceSet->n_cols);
 
-    for (size_t i = 0; i < distances.n_cols; ++i)
+    #pragma omp parallel for
+    for (omp_size_t i = 0; i < (omp_size_t) distances.n_cols; ++i)
     {
       // Map distances (copy a column).
       const size_t refMapping = oldFromNewReferences[i];
       distances.col(refMapping) = distancePtr->col(i);
 
-      // Map each neighbor's index.
+      // Map each neighbor's index.  Deleted points are not searched for in
+      // dual-tree mode, so their columns may hold invalid indices.
       for (size_t j = 0; j < distances.n_rows; ++j)
-        neighbors(j, refMapping) = oldFromNewReferences[(*neighborPtr)(j, i)];
+      {
+        const size_t neighbor = (*neighborPtr)(j, i);
+        neighbors(j, refMapping) = (neighbor < oldFromNewReferences.size()) ?
+            oldFromNewReferences[neighbor] : neighbor;
+      }
     }
 
     // Finished with temporary matrices.
@@ -1002,6 +1197,151 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
   }
 }
 
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+template<typename RuleType>
+void NeighborSearch<SortPolicy, MetricType, MatType, TreeType,
+DualTreeTraversalType, SingleTreeTraversalType>::DualTreeTraversal(
+    Tree& queryTree,
+    Tree& referenceTree,
+    RuleType& rules)
+{
+#ifdef HAS_OPENMP
+  // Nodes of spill trees may overlap, so two threads could end up updating the
+  // candidate list of the same query point; those are always traversed
+  // serially.
+  const size_t numThreads = omp_get_max_threads();
+  if (parallel && numThreads > 1 && !tree::IsSpillTree<Tree>::value)
+  {
+    // Split the query tree near the root until there are enough subtrees to
+    // keep all threads busy; each thread shares the candidate lists, and no
+    // two subtrees in the frontier hold the same query point.
+    const std::vector<Tree*> frontier = tree::SplitFrontier(queryTree,
+        8 * numThreads);
+    tree::TraverseFrontier<DualTreeTraversalType<RuleType>>(frontier,
+        referenceTree, rules);
+
+    return;
+  }
+#endif
+
+  DualTreeTraversalType<RuleType> traverser(rules);
+  traverser.Traverse(queryTree, referenceTree);
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+template<typename RuleType>
+void NeighborSearch<SortPolicy, MetricType, MatType, TreeType,
+DualTreeTraversalType, SingleTreeTraversalType>::NaiveSearch(
+    const MatType& querySet,
+    RuleType& rules)
+{
+  // Tiles of this many points fit in cache along with their distances.
+  const size_t tileSize = 256;
+  const size_t numQueryTiles = (querySet.n_cols + tileSize - 1) / tileSize;
+
+  // Each thread has its own rules, and works on its own query points, so the
+  // shared candidate lists are never touched by two threads at once.  All
+  // tiles cost the same, so they are split statically, which gives each
+  // thread the query points that data::FirstTouch() placed in the memory of
+  // its NUMA node.
+  #pragma omp parallel if (parallel)
+  {
+    RuleType threadRules(rules);
+    arma::mat distances;
+
+    #pragma omp for schedule(static)
+    for (omp_size_t t = 0; t < (omp_size_t) numQueryTiles; ++t)
+    {
+      const size_t queryBegin = t * tileSize;
+      const size_t queryCount = std::min(tileSize,
+          (size_t) querySet.n_cols - queryBegin);
+
+      for (size_t referenceBegin = 0; referenceBegin < referenceSet->n_cols;
+           referenceBegin += tileSize)
+      {
+        const size_t referenceCount = std::min(tileSize,
+            (size_t) referenceSet->n_cols - referenceBegin);
+        const double tolerance = metric::EvaluateTile(metric, querySet,
+            queryBegin, queryCount, *referenceSet, referenceBegin,
+            referenceCount, distances);
+
+        for (size_t i = 0; i < queryCount; ++i)
+        {
+          const arma::vec queryDistances(distances.colptr(i), referenceCount,
+              false, true);
+          threadRules.BaseCaseBlock(queryBegin + i, referenceBegin,
+              queryDistances, tolerance);
+        }
+      }
+    }
+
+    #pragma omp critical
+    rules.Counters() += threadRules.Counters();
+  }
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+template<typename TraverserType, typename RuleType>
+void NeighborSearch<SortPolicy, MetricType, MatType, TreeType,
+DualTreeTraversalType, SingleTreeTraversalType>::SingleTreeTraversal(
+    const size_t numQueries,
+    RuleType& rules)
+{
+#ifdef HAS_OPENMP
+  // Trees with self-children cache base cases in the statistics of reference
+  // nodes while scoring, so those reference trees can't be shared between
+  // threads.
+  if (parallel && omp_get_max_threads() > 1 &&
+      !tree::TreeTraits<Tree>::HasSelfChildren)
+  {
+    #pragma omp parallel
+    {
+      // Each thread has its own rules and traverser, and works on its own
+      // query points, so the shared candidate lists are never touched by two
+      // threads at once.
+      RuleType threadRules(rules);
+      TraverserType traverser(threadRules);
+      SetMaxVisits(traverser);
+
+      #pragma omp for schedule(dynamic, 16)
+      for (omp_size_t i = 0; i < (omp_size_t) numQueries; ++i)
+        traverser.Traverse(i, *referenceTree);
+
+      #pragma omp critical
+      rules.Counters() += threadRules.Counters();
+    }
+
+    return;
+  }
+#endif
+
+  TraverserType traverser(rules);
+  SetMaxVisits(traverser);
+  for (size_t i = 0; i < numQueries; ++i)
+    traverser.Traverse(i, *referenceTree);
+}
+
 //! Calculate the average relative error.
 template<typename SortPolicy,
          typename MetricType,
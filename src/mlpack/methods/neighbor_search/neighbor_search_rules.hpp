@@ -13,9 +13,10 @@
 #ifndef MLPACK_METHODS_NEIGHBOR_SEARCH_NEIGHBOR_SEARCH_RULES_HPP
 #define MLPACK_METHODS_NEIGHBOR_SEARCH_NEIGHBOR_SEARCH_RULES_HPP
 
+#include <mlpack/core/tree/traversal_counters.hpp>
 #include <mlpack/core/tree/traversal_info.hpp>
 
-#include <queue>
+#include "candidate_list.hpp"
 
 namespace mlpack {
 namespace neighbor {
@@ -54,6 +55,17 @@ class NeighborSearchRules
                       const double epsilon = 0,
                       const bool sameSet = false);
 
+  /**
+   * Construct a NeighborSearchRules object that shares the candidate lists of
+   * the given rules object, but has its own base case cache, traversal info,
+   * and counters.  This is used by parallel traversals to give each thread its
+   * own rules object.  It is only safe as long as no two threads ever work on
+   * the same query point (or query node) at the same time.
+   *
+   * @param other Rules object whose candidate lists will be shared.
+   */
+  NeighborSearchRules(NeighborSearchRules& other);
+
   /**
    * Store the list of candidates for each query point in the given matrices.
    *
@@ -73,6 +85,39 @@ class NeighborSearchRules
    */
   double BaseCase(const size_t queryIndex, const size_t referenceIndex);
 
+  /**
+   * Perform the base cases between the query point and each point of a
+   * contiguous block of reference points.  This is equivalent to calling
+   * BaseCase() for each of the reference points, but the distances are all
+   * computed at once, which is faster.
+   *
+   * @param queryIndex Index of query point.
+   * @param referenceBegin Index of the first reference point of the block.
+   * @param referenceCount Number of reference points in the block.
+   */
+  void BaseCaseBlock(const size_t queryIndex,
+                     const size_t referenceBegin,
+                     const size_t referenceCount);
+
+  /**
+   * Perform the base cases between the query point and each point of a
+   * contiguous block of reference points, given distances that were already
+   * computed for the block (for instance by metric::EvaluateTile()), up to the
+   * given absolute tolerance.  If the tolerance is zero, the distances are
+   * used as they are; otherwise they only decide which reference points can
+   * be candidates, and BaseCase() computes the exact distances of those.
+   * Either way, the results are the ones BaseCase() would give.
+   *
+   * @param queryIndex Index of query point.
+   * @param referenceBegin Index of the first reference point of the block.
+   * @param distances Distances between the query point and the block.
+   * @param tolerance Bound on the absolute error of the distances.
+   */
+  void BaseCaseBlock(const size_t queryIndex,
+                     const size_t referenceBegin,
+                     const arma::vec& distances,
+                     const double tolerance);
+
   /**
    * Get the score for recursion order.  A low score indicates priority for
    * recursion, while DBL_MAX indicates that the node should not be recursed
@@ -140,14 +185,19 @@ class NeighborSearchRules
                  const double oldScore) const;
 
   //! Get the number of base cases that have been performed.
-  size_t BaseCases() const { return baseCases; }
+  size_t BaseCases() const { return counters.BaseCases(); }
   //! Modify the number of base cases that have been performed.
-  size_t& BaseCases() { return baseCases; }
+  size_t& BaseCases() { return counters.BaseCases(); }
 
   //! Get the number of scores that have been performed.
-  size_t Scores() const { return scores; }
+  size_t Scores() const { return counters.Scores(); }
   //! Modify the number of scores that have been performed.
-  size_t& Scores() { return scores; }
+  size_t& Scores() { return counters.Scores(); }
+
+  //! Get the traversal counters.
+  const tree::TraversalCounters& Counters() const { return counters; }
+  //! Modify the traversal counters.
+  tree::TraversalCounters& Counters() { return counters; }
 
   //! Convenience typedef.
   typedef typename tree::TraversalInfo<TreeType> TraversalInfoType;
@@ -164,23 +214,12 @@ class NeighborSearchRules
   //! The query set.
   const typename TreeType::Mat& querySet;
 
-  //! Candidate represents a possible candidate neighbor (distance, index).
-  typedef std::pair<double, size_t> Candidate;
-
-  //! Compare two candidates based on the distance.
-  struct CandidateCmp {
-    bool operator()(const Candidate& c1, const Candidate& c2)
-    {
-      return !SortPolicy::IsBetter(c2.first, c1.first);
-    };
-  };
-
-  //! Use a priority queue to represent the list of candidate neighbors.
-  typedef std::priority_queue<Candidate, std::vector<Candidate>, CandidateCmp>
-      CandidateList;
+  //! Storage for the candidate lists, if this object owns them.
+  CandidateList<SortPolicy> candidateStorage;
 
-  //! Set of candidate neighbors for each point.
-  std::vector<CandidateList> candidates;
+  //! Set of candidate neighbors for each point.  This may refer to the
+  //! candidate lists of another NeighborSearchRules object.
+  CandidateList<SortPolicy>& candidates;
 
   //! Number of neighbors to search for.
   const size_t k;
@@ -200,11 +239,11 @@ class NeighborSearchRules
   size_t lastReferenceIndex;
   //! The last base case result.
   double lastBaseCase;
+  //! The distances computed by the last call to BaseCaseBlock().
+  arma::vec blockDistances;
 
-  //! The number of base cases that have been performed.
-  size_t baseCases;
-  //! The number of scores that have been performed.
-  size_t scores;
+  //! The counters of base cases, scores, prunes, and node visits.
+  tree::TraversalCounters counters;
 
   //! Traversal info for the parent combination; this is updated by the
   //! traversal before each call to Score().
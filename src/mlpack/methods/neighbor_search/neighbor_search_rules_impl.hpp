@@ -15,6 +15,7 @@
 // In case it hasn't been included yet.
 #include "neighbor_search_rules.hpp"
 #include <mlpack/core/tree/spill_tree/is_spill_tree.hpp>
+#include <mlpack/core/metrics/evaluate_block.hpp>
 
 namespace mlpack {
 namespace neighbor {
@@ -29,34 +30,39 @@ NeighborSearchRules<SortPolicy, MetricType, TreeType>::NeighborSearchRules(
     const bool sameSet) :
     referenceSet(referenceSet),
     querySet(querySet),
+    candidateStorage(k, querySet.n_cols),
+    candidates(candidateStorage),
     k(k),
     metric(metric),
     sameSet(sameSet),
     epsilon(epsilon),
     lastQueryIndex(querySet.n_cols),
-    lastReferenceIndex(referenceSet.n_cols),
-    baseCases(0),
-    scores(0)
+    lastReferenceIndex(referenceSet.n_cols)
 {
   // We must set the traversal info last query and reference node pointers to
   // something that is both invalid (i.e. not a tree node) and not NULL.  We'll
   // use the this pointer.
   traversalInfo.LastQueryNode() = (TreeType*) this;
   traversalInfo.LastReferenceNode() = (TreeType*) this;
+}
 
-  // Let's build the list of candidate neighbors for each query point.
-  // It will be initialized with k candidates: (WorstDistance, size_t() - 1)
-  // The list of candidates will be updated when visiting new points with the
-  // BaseCase() method.
-  const Candidate def = std::make_pair(SortPolicy::WorstDistance(),
-      size_t() - 1);
-
-  std::vector<Candidate> vect(k, def);
-  CandidateList pqueue(CandidateCmp(), std::move(vect));
-
-  candidates.reserve(querySet.n_cols);
-  for (size_t i = 0; i < querySet.n_cols; i++)
-    candidates.push_back(pqueue);
+template<typename SortPolicy, typename MetricType, typename TreeType>
+NeighborSearchRules<SortPolicy, MetricType, TreeType>::NeighborSearchRules(
+    NeighborSearchRules& other) :
+    referenceSet(other.referenceSet),
+    querySet(other.querySet),
+    candidates(other.candidates),
+    k(other.k),
+    metric(other.metric),
+    sameSet(other.sameSet),
+    epsilon(other.epsilon),
+    lastQueryIndex(querySet.n_cols),
+    lastReferenceIndex(referenceSet.n_cols)
+{
+  // As in the other constructor, the last query and reference node pointers
+  // must be invalid but non-NULL.
+  traversalInfo.LastQueryNode() = (TreeType*) this;
+  traversalInfo.LastReferenceNode() = (TreeType*) this;
 }
 
 template<typename SortPolicy, typename MetricType, typename TreeType>
@@ -67,16 +73,10 @@ void NeighborSearchRules<SortPolicy, MetricType, TreeType>::GetResults(
   neighbors.set_size(k, querySet.n_cols);
   distances.set_size(k, querySet.n_cols);
 
-  for (size_t i = 0; i < querySet.n_cols; i++)
-  {
-    CandidateList& pqueue = candidates[i];
-    for (size_t j = 1; j <= k; j++)
-    {
-      neighbors(k - j, i) = pqueue.top().second;
-      distances(k - j, i) = pqueue.top().first;
-      pqueue.pop();
-    }
-  }
+  // The candidate lists of the query points are independent.
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) querySet.n_cols; i++)
+    candidates.Get(i, neighbors.colptr(i), distances.colptr(i));
 };
 
 template<typename SortPolicy, typename MetricType, typename TreeType>
@@ -95,7 +95,7 @@ BaseCase(const size_t queryIndex, const size_t referenceIndex)
 
   double distance = metric.Evaluate(querySet.col(queryIndex),
                                     referenceSet.col(referenceIndex));
-  ++baseCases;
+  counters.BaseCase();
 
   InsertNeighbor(queryIndex, referenceIndex, distance);
 
@@ -107,12 +107,65 @@ BaseCase(const size_t queryIndex, const size_t referenceIndex)
   return distance;
 }
 
+template<typename SortPolicy, typename MetricType, typename TreeType>
+inline force_inline
+void NeighborSearchRules<SortPolicy, MetricType, TreeType>::BaseCaseBlock(
+    const size_t queryIndex,
+    const size_t referenceBegin,
+    const size_t referenceCount)
+{
+  metric::EvaluateBlock(metric, querySet.col(queryIndex), referenceSet,
+      referenceBegin, referenceCount, blockDistances);
+  BaseCaseBlock(queryIndex, referenceBegin, blockDistances, 0.0);
+}
+
+template<typename SortPolicy, typename MetricType, typename TreeType>
+void NeighborSearchRules<SortPolicy, MetricType, TreeType>::BaseCaseBlock(
+    const size_t queryIndex,
+    const size_t referenceBegin,
+    const arma::vec& distances,
+    const double tolerance)
+{
+  if (tolerance == 0.0)
+  {
+    for (size_t i = 0; i < distances.n_elem; ++i)
+    {
+      const size_t referenceIndex = referenceBegin + i;
+
+      // Skip the same base cases that BaseCase() would skip.
+      if (sameSet && (queryIndex == referenceIndex))
+        continue;
+      if ((lastQueryIndex == queryIndex) &&
+          (lastReferenceIndex == referenceIndex))
+        continue;
+
+      counters.BaseCase();
+      InsertNeighbor(queryIndex, referenceIndex, distances[i]);
+
+      lastQueryIndex = queryIndex;
+      lastReferenceIndex = referenceIndex;
+      lastBaseCase = distances[i];
+    }
+
+    return;
+  }
+
+  // Only the reference points that could still be inserted in the candidate
+  // list are evaluated exactly.
+  for (size_t i = 0; i < distances.n_elem; ++i)
+  {
+    const double bound = SortPolicy::CombineBest(distances[i], tolerance);
+    if (!SortPolicy::IsBetter(candidates.Worst(queryIndex), bound))
+      BaseCase(queryIndex, referenceBegin + i);
+  }
+}
+
 template<typename SortPolicy, typename MetricType, typename TreeType>
 inline double NeighborSearchRules<SortPolicy, MetricType, TreeType>::Score(
     const size_t queryIndex,
     TreeType& referenceNode)
 {
-  ++scores; // Count number of Score() calls.
+  counters.Score(); // Count number of Score() calls.
   double distance;
   if (tree::TreeTraits<TreeType>::FirstPointIsCentroid)
   {
@@ -143,18 +196,18 @@ inline double NeighborSearchRules<SortPolicy, MetricType, TreeType>::Score(
   }
 
   // Compare against the best k'th distance for this query point so far.
-  double bestDistance = candidates[queryIndex].top().first;
+  double bestDistance = candidates.Worst(queryIndex);
   bestDistance = SortPolicy::Relax(bestDistance, epsilon);
 
-  return (SortPolicy::IsBetter(distance, bestDistance)) ?
-      SortPolicy::ConvertToScore(distance) : DBL_MAX;
+  return counters.ScoreResult((SortPolicy::IsBetter(distance, bestDistance)) ?
+      SortPolicy::ConvertToScore(distance) : DBL_MAX);
 }
 
 template<typename SortPolicy, typename MetricType, typename TreeType>
 inline size_t NeighborSearchRules<SortPolicy, MetricType, TreeType>::
 GetBestChild(const size_t queryIndex, TreeType& referenceNode)
 {
-  ++scores;
+  counters.Score();
   return SortPolicy::GetBestChild(querySet.col(queryIndex), referenceNode);
 }
 
@@ -162,7 +215,7 @@ template<typename SortPolicy, typename MetricType, typename TreeType>
 inline size_t NeighborSearchRules<SortPolicy, MetricType, TreeType>::
 GetBestChild(const TreeType& queryNode, TreeType& referenceNode)
 {
-  ++scores;
+  counters.Score();
   return SortPolicy::GetBestChild(queryNode, referenceNode);
 }
 
@@ -179,10 +232,11 @@ inline double NeighborSearchRules<SortPolicy, MetricType, TreeType>::Rescore(
   const double distance = SortPolicy::ConvertToDistance(oldScore);
 
   // Just check the score again against the distances.
-  double bestDistance = candidates[queryIndex].top().first;
+  double bestDistance = candidates.Worst(queryIndex);
   bestDistance = SortPolicy::Relax(bestDistance, epsilon);
 
-  return (SortPolicy::IsBetter(distance, bestDistance)) ? oldScore : DBL_MAX;
+  return counters.RescoreResult(oldScore,
+      (SortPolicy::IsBetter(distance, bestDistance)) ? oldScore : DBL_MAX);
 }
 
 template<typename SortPolicy, typename MetricType, typename TreeType>
@@ -190,7 +244,7 @@ inline double NeighborSearchRules<SortPolicy, MetricType, TreeType>::Score(
     TreeType& queryNode,
     TreeType& referenceNode)
 {
-  ++scores; // Count number of Score() calls.
+  counters.Score(); // Count number of Score() calls.
 
   // Update our bound.
   const double bestDistance = CalculateBound(queryNode);
@@ -290,7 +344,7 @@ inline double NeighborSearchRules<SortPolicy, MetricType, TreeType>::Score(
       // There isn't any need to set the traversal information because no
       // descendant combinations will be visited, and those are the only
       // combinations that would depend on the traversal information.
-      return DBL_MAX;
+      return counters.ScoreResult(DBL_MAX);
     }
   }
 
@@ -335,14 +389,14 @@ inline double NeighborSearchRules<SortPolicy, MetricType, TreeType>::Score(
     traversalInfo.LastReferenceNode() = &referenceNode;
     traversalInfo.LastScore() = distance;
 
-    return SortPolicy::ConvertToScore(distance);
+    return counters.ScoreResult(SortPolicy::ConvertToScore(distance));
   }
   else
   {
     // There isn't any need to set the traversal information because no
     // descendant combinations will be visited, and those are the only
     // combinations that would depend on the traversal information.
-    return DBL_MAX;
+    return counters.ScoreResult(DBL_MAX);
   }
 }
 
@@ -360,7 +414,8 @@ inline double NeighborSearchRules<SortPolicy, MetricType, TreeType>::Rescore(
   // Update our bound.
   const double bestDistance = CalculateBound(queryNode);
 
-  return (SortPolicy::IsBetter(distance, bestDistance)) ? oldScore : DBL_MAX;
+  return counters.RescoreResult(oldScore,
+      (SortPolicy::IsBetter(distance, bestDistance)) ? oldScore : DBL_MAX);
 }
 
 // Calculate the bound for a given query node in its current state and update
@@ -404,7 +459,7 @@ inline double NeighborSearchRules<SortPolicy, MetricType, TreeType>::
   // Loop over points held in the node.
   for (size_t i = 0; i < queryNode.NumPoints(); ++i)
   {
-    const double distance = candidates[queryNode.Point(i)].top().first;
+    const double distance = candidates.Worst(queryNode.Point(i));
     if (SortPolicy::IsBetter(worstDistance, distance))
       worstDistance = distance;
     if (SortPolicy::IsBetter(distance, bestPointDistance))
@@ -499,14 +554,7 @@ InsertNeighbor(
     const size_t neighbor,
     const double distance)
 {
-  CandidateList& pqueue = candidates[queryIndex];
-  Candidate c = std::make_pair(distance, neighbor);
-
-  if (CandidateCmp()(c, pqueue.top()))
-  {
-    pqueue.pop();
-    pqueue.push(c);
-  }
+  candidates.Insert(queryIndex, neighbor, distance);
 }
 
 } // namespace neighbor
@@ -22,6 +22,7 @@
 #include <mlpack/core/tree/octree.hpp>
 #include <boost/variant.hpp>
 #include "neighbor_search.hpp"
+#include "query_cache.hpp"
 
 namespace mlpack {
 namespace neighbor {
@@ -32,14 +33,15 @@ namespace neighbor {
 template<typename SortPolicy,
          template<typename TreeMetricType,
                   typename TreeStatType,
-                  typename TreeMatType> class TreeType>
+                  typename TreeMatType> class TreeType,
+         typename MatType = arma::mat>
 using NSType = NeighborSearch<SortPolicy,
                               metric::EuclideanDistance,
-                              arma::mat,
+                              MatType,
                               TreeType,
                               TreeType<metric::EuclideanDistance,
                                   NeighborSearchStat<SortPolicy>,
-                                  arma::mat>::template DualTreeTraverser>;
+                                  MatType>::template DualTreeTraverser>;
 
 /**
  * MonoSearchVisitor executes a monochromatic neighbor search on the given
@@ -76,12 +78,12 @@ class MonoSearchVisitor : public boost::static_visitor<void>
  * accept leafSize as a parameter. In these cases, before doing neighbor search,
  * a query tree with proper leafSize is built from the querySet.
  */
-template<typename SortPolicy>
+template<typename SortPolicy, typename MatType = arma::mat>
 class BiSearchVisitor : public boost::static_visitor<void>
 {
  private:
   //! The query set for the bichromatic search.
-  const arma::mat& querySet;
+  const MatType& querySet;
   //! The number of neighbors to search for.
   const size_t k;
   //! The result matrix for neighbors.
@@ -104,7 +106,10 @@ class BiSearchVisitor : public boost::static_visitor<void>
   template<template<typename TreeMetricType,
                     typename TreeStatType,
                     typename TreeMatType> class TreeType>
-  using NSTypeT = NSType<SortPolicy, TreeType>;
+  using NSTypeT = NSType<SortPolicy, TreeType, MatType>;
+
+  //! The type of neighbor search used for spill trees.
+  typedef DefeatistKNN<tree::SPTree, MatType> SpillNSType;
 
   //! Default Bichromatic neighbor search on the given NSType instance.
   template<template<typename TreeMetricType,
@@ -119,13 +124,13 @@ class BiSearchVisitor : public boost::static_visitor<void>
   void operator()(NSTypeT<tree::BallTree>* ns) const;
 
   //! Bichromatic neighbor search specialized for SPTrees.
-  void operator()(SpillKNN* ns) const;
+  void operator()(SpillNSType* ns) const;
 
   //! Bichromatic neighbor search specialized for octrees.
   void operator()(NSTypeT<tree::Octree>* ns) const;
 
   //! Construct the BiSearchVisitor.
-  BiSearchVisitor(const arma::mat& querySet,
+  BiSearchVisitor(const MatType& querySet,
                   const size_t k,
                   arma::Mat<size_t>& neighbors,
                   arma::mat& distances,
@@ -140,12 +145,12 @@ class BiSearchVisitor : public boost::static_visitor<void>
  * accept leafSize as a parameter. In these cases, a reference tree with proper
  * leafSize is built from the referenceSet.
  */
-template<typename SortPolicy>
+template<typename SortPolicy, typename MatType = arma::mat>
 class TrainVisitor : public boost::static_visitor<void>
 {
  private:
   //! The reference set to use for training.
-  arma::mat&& referenceSet;
+  MatType&& referenceSet;
   //! The leaf size, used only by BinarySpaceTree.
   size_t leafSize;
   //! Overlapping size (for spill trees).
@@ -157,12 +162,19 @@ class TrainVisitor : public boost::static_visitor<void>
   template<typename NSType>
   void TrainLeaf(NSType* ns) const;
 
+  //! Train on the given NSType by bulk-loading a rectangle tree.
+  template<typename NSType>
+  void TrainBulkLoad(NSType* ns, const tree::BulkLoadType bulkLoad) const;
+
  public:
   //! Alias template necessary for visual c++ compiler.
   template<template<typename TreeMetricType,
                     typename TreeStatType,
                     typename TreeMatType> class TreeType>
-  using NSTypeT = NSType<SortPolicy, TreeType>;
+  using NSTypeT = NSType<SortPolicy, TreeType, MatType>;
+
+  //! The type of neighbor search used for spill trees.
+  typedef DefeatistKNN<tree::SPTree, MatType> SpillNSType;
 
   //! Default Train on the given NSType instance.
   template<template<typename TreeMetricType,
@@ -176,20 +188,105 @@ class TrainVisitor : public boost::static_visitor<void>
   //! Train on the given NSType specialized for BallTrees.
   void operator()(NSTypeT<tree::BallTree>* ns) const;
 
+  //! Train on the given NSType specialized for R trees.
+  void operator()(NSTypeT<tree::RTree>* ns) const;
+
+  //! Train on the given NSType specialized for R* trees.
+  void operator()(NSTypeT<tree::RStarTree>* ns) const;
+
+  //! Train on the given NSType specialized for X trees.
+  void operator()(NSTypeT<tree::XTree>* ns) const;
+
+  //! Train on the given NSType specialized for Hilbert R trees.
+  void operator()(NSTypeT<tree::HilbertRTree>* ns) const;
+
   //! Train specialized for SPTrees.
-  void operator()(SpillKNN* ns) const;
+  void operator()(SpillNSType* ns) const;
 
   //! Train specialized for octrees.
   void operator()(NSTypeT<tree::Octree>* ns) const;
 
   //! Construct the TrainVisitor object with the given reference set, leafSize
   //! for BinarySpaceTrees, and tau and rho for spill trees.
-  TrainVisitor(arma::mat&& referenceSet,
+  TrainVisitor(MatType&& referenceSet,
                const size_t leafSize,
                const double tau,
                const double rho);
 };
 
+/**
+ * InsertPointsVisitor inserts new points into the reference tree of the given
+ * NSType.  Only kd-trees and ball trees support this; for other tree types, a
+ * std::invalid_argument is thrown.
+ */
+template<typename SortPolicy, typename MatType = arma::mat>
+class InsertPointsVisitor : public boost::static_visitor<void>
+{
+ private:
+  //! The points to insert.
+  const MatType& points;
+  //! The leaf size, used when subtrees are rebuilt.
+  size_t leafSize;
+
+ public:
+  //! Alias template necessary for visual c++ compiler.
+  template<template<typename TreeMetricType,
+                    typename TreeStatType,
+                    typename TreeMatType> class TreeType>
+  using NSTypeT = NSType<SortPolicy, TreeType, MatType>;
+
+  //! Default InsertPoints on the given NSType instance (not supported).
+  template<typename NSType>
+  void operator()(NSType* ns) const;
+
+  //! Insert points specialized for KDTrees.
+  void operator()(NSTypeT<tree::KDTree>* ns) const;
+
+  //! Insert points specialized for BallTrees.
+  void operator()(NSTypeT<tree::BallTree>* ns) const;
+
+  //! Construct the InsertPointsVisitor object with the given points and
+  //! leafSize.
+  InsertPointsVisitor(const MatType& points, const size_t leafSize);
+};
+
+/**
+ * DeletePointsVisitor deletes reference points from the reference tree of the
+ * given NSType.  Only kd-trees and ball trees support this; for other tree
+ * types, a std::invalid_argument is thrown.
+ */
+template<typename SortPolicy, typename MatType = arma::mat>
+class DeletePointsVisitor : public boost::static_visitor<void>
+{
+ private:
+  //! The indices of the points to delete.
+  const std::vector<size_t>& indices;
+  //! The leaf size, used when subtrees are rebuilt.
+  size_t leafSize;
+
+ public:
+  //! Alias template necessary for visual c++ compiler.
+  template<template<typename TreeMetricType,
+                    typename TreeStatType,
+                    typename TreeMatType> class TreeType>
+  using NSTypeT = NSType<SortPolicy, TreeType, MatType>;
+
+  //! Default DeletePoints on the given NSType instance (not supported).
+  template<typename NSType>
+  void operator()(NSType* ns) const;
+
+  //! Delete points specialized for KDTrees.
+  void operator()(NSTypeT<tree::KDTree>* ns) const;
+
+  //! Delete points specialized for BallTrees.
+  void operator()(NSTypeT<tree::BallTree>* ns) const;
+
+  //! Construct the DeletePointsVisitor object with the given indices and
+  //! leafSize.
+  DeletePointsVisitor(const std::vector<size_t>& indices,
+                      const size_t leafSize);
+};
+
 /**
  * SearchModeVisitor exposes the SearchMode() method of the given NSType.
  */
@@ -212,15 +309,38 @@ class EpsilonVisitor : public boost::static_visitor<double&>
   double& operator()(NSType *ns) const;
 };
 
+/**
+ * ParallelVisitor exposes the Parallel() method of the given NSType.
+ */
+class ParallelVisitor : public boost::static_visitor<bool&>
+{
+ public:
+  //! Return whether or not the search is parallelized.
+  template<typename NSType>
+  bool& operator()(NSType *ns) const;
+};
+
+/**
+ * MaxVisitsVisitor exposes the MaxVisits() method of the given NSType.
+ */
+class MaxVisitsVisitor : public boost::static_visitor<size_t&>
+{
+ public:
+  //! Return the maximum number of nodes visited in best-first search.
+  template<typename NSType>
+  size_t& operator()(NSType *ns) const;
+};
+
 /**
  * ReferenceSetVisitor exposes the referenceSet of the given NSType.
  */
-class ReferenceSetVisitor : public boost::static_visitor<const arma::mat&>
+template<typename MatType = arma::mat>
+class ReferenceSetVisitor : public boost::static_visitor<const MatType&>
 {
  public:
   //! Return the reference set.
   template<typename NSType>
-  const arma::mat& operator()(NSType *ns) const;
+  const MatType& operator()(NSType *ns) const;
 };
 
 /**
@@ -242,9 +362,14 @@ class DeleteVisitor : public boost::static_visitor<void>
  * flexibility as the NeighborSearch class.  So if you are using it outside of
  * mlpack_knn and mlpack_kfn, be aware that it is limited!
  *
+ * The model can hold datasets of any dense Armadillo matrix type; for instance,
+ * NSModel<NearestNeighborSort, arma::fmat> holds its dataset, its trees and
+ * their bounds in single precision, which halves the memory used.
+ *
  * @tparam SortPolicy The sort policy for distances; see NearestNeighborSort.
+ * @tparam MatType The type of data matrix.
  */
-template<typename SortPolicy>
+template<typename SortPolicy, typename MatType = arma::mat>
 class NSModel
 {
  public:
@@ -283,28 +408,38 @@ class NSModel
   //! If true, random projections are used.
   bool randomBasis;
   //! This is the random projection matrix; only used if randomBasis is true.
-  arma::mat q;
+  MatType q;
+
+  //! If true, treeType and leafSize were chosen by Tune().
+  bool tuned;
+
+  //! The cache of bichromatic search results (not serialized).
+  QueryCache<typename MatType::elem_type> cache;
+  //! The search mode of the results in the cache.
+  NeighborSearchMode cacheSearchMode;
+  //! The approximation parameter of the results in the cache.
+  double cacheEpsilon;
 
   /**
    * nSearch holds an instance of the NeigborSearch class for the current
    * treeType. It is initialized every time BuildModel is executed.
    * We access to the contained value through the visitor classes defined above.
    */
-  boost::variant<NSType<SortPolicy, tree::KDTree>*,
-                 NSType<SortPolicy, tree::StandardCoverTree>*,
-                 NSType<SortPolicy, tree::RTree>*,
-                 NSType<SortPolicy, tree::RStarTree>*,
-                 NSType<SortPolicy, tree::BallTree>*,
-                 NSType<SortPolicy, tree::XTree>*,
-                 NSType<SortPolicy, tree::HilbertRTree>*,
-                 NSType<SortPolicy, tree::RPlusTree>*,
-                 NSType<SortPolicy, tree::RPlusPlusTree>*,
-                 NSType<SortPolicy, tree::VPTree>*,
-                 NSType<SortPolicy, tree::RPTree>*,
-                 NSType<SortPolicy, tree::MaxRPTree>*,
-                 SpillKNN*,
-                 NSType<SortPolicy, tree::UBTree>*,
-                 NSType<SortPolicy, tree::Octree>*> nSearch;
+  boost::variant<NSType<SortPolicy, tree::KDTree, MatType>*,
+                 NSType<SortPolicy, tree::StandardCoverTree, MatType>*,
+                 NSType<SortPolicy, tree::RTree, MatType>*,
+                 NSType<SortPolicy, tree::RStarTree, MatType>*,
+                 NSType<SortPolicy, tree::BallTree, MatType>*,
+                 NSType<SortPolicy, tree::XTree, MatType>*,
+                 NSType<SortPolicy, tree::HilbertRTree, MatType>*,
+                 NSType<SortPolicy, tree::RPlusTree, MatType>*,
+                 NSType<SortPolicy, tree::RPlusPlusTree, MatType>*,
+                 NSType<SortPolicy, tree::VPTree, MatType>*,
+                 NSType<SortPolicy, tree::RPTree, MatType>*,
+                 NSType<SortPolicy, tree::MaxRPTree, MatType>*,
+                 DefeatistKNN<tree::SPTree, MatType>*,
+                 NSType<SortPolicy, tree::UBTree, MatType>*,
+                 NSType<SortPolicy, tree::Octree, MatType>*> nSearch;
 
  public:
   /**
@@ -353,7 +488,7 @@ class NSModel
   void serialize(Archive& ar, const unsigned int /* version */);
 
   //! Expose the dataset.
-  const arma::mat& Dataset() const;
+  const MatType& Dataset() const;
 
   //! Expose SearchMode.
   NeighborSearchMode SearchMode() const;
@@ -363,6 +498,14 @@ class NSModel
   double Epsilon() const;
   double& Epsilon();
 
+  //! Expose Parallel.
+  bool Parallel() const;
+  bool& Parallel();
+
+  //! Expose MaxVisits.
+  size_t MaxVisits() const;
+  size_t& MaxVisits();
+
   //! Expose leafSize.
   size_t LeafSize() const { return leafSize; }
   size_t& LeafSize() { return leafSize; }
@@ -383,14 +526,79 @@ class NSModel
   bool RandomBasis() const { return randomBasis; }
   bool& RandomBasis() { return randomBasis; }
 
+  //! Get whether the tree type and leaf size were chosen by Tune().
+  bool Tuned() const { return tuned; }
+
+  /**
+   * Choose the tree type and the leaf size by timing them on a sample of the
+   * reference set.  For each candidate configuration, a model is built on a
+   * random sample of sampleSize reference points, and numQueries other random
+   * reference points are searched for their k neighbors; the configuration
+   * with the smallest total time is set in the model (as TreeType() and
+   * LeafSize()), and Tuned() becomes true.  The choice is serialized with the
+   * model.  BuildModel() must be called afterwards, with LeafSize().
+   *
+   * The leaf size is only tuned for the trees that use it (kd-trees, ball
+   * trees, spill trees and octrees); the other trees are timed once.  By
+   * default, all the exact trees are candidates (so not spill trees), except
+   * octrees in more than 8 dimensions, which have 2^d children per node, and
+   * the leaf sizes 5, 10, 20, 40 and 80 are tried.  In naive mode no tree is
+   * used, and nothing is done.
+   *
+   * @param referenceSet Reference set the model will be built on.
+   * @param k Number of neighbors that will be searched for.
+   * @param searchMode Search mode that will be used.
+   * @param epsilon Relative approximation error that will be used.
+   * @param candidates Tree types to try (empty for the default set).
+   * @param leafSizes Leaf sizes to try (empty for the default set).
+   * @param sampleSize Number of reference points to build the trees on.
+   * @param numQueries Number of points to search for.
+   */
+  void Tune(const MatType& referenceSet,
+            const size_t k,
+            const NeighborSearchMode searchMode,
+            const double epsilon = 0,
+            std::vector<TreeTypes> candidates = std::vector<TreeTypes>(),
+            std::vector<size_t> leafSizes = std::vector<size_t>(),
+            const size_t sampleSize = 5000,
+            const size_t numQueries = 500);
+
   //! Build the reference tree.
-  void BuildModel(arma::mat&& referenceSet,
+  void BuildModel(MatType&& referenceSet,
                   const size_t leafSize,
                   const NeighborSearchMode searchMode,
                   const double epsilon = 0);
 
+  /**
+   * Insert the given points into the reference tree without rebuilding it (if
+   * a random basis is used, the points are projected onto it first).  The new
+   * points are given the indices after the existing reference points.  This is
+   * only supported for kd-trees and ball trees, and not in naive mode;
+   * otherwise, a std::invalid_argument is thrown.
+   */
+  void InsertPoints(MatType&& points);
+
+  /**
+   * Delete the reference points with the given indices from the reference
+   * tree without rebuilding it.  The indices of the other points do not
+   * change.  The same restrictions as for InsertPoints() apply.
+   */
+  void DeletePoints(const std::vector<size_t>& indices);
+
+  /**
+   * Get the cache of search results.  It is disabled until it is given a
+   * memory budget; then the results of bichromatic searches are stored in it,
+   * keyed by the query points (before any random basis is applied), and
+   * repeated queries are answered from it.  The cache is cleared when the
+   * reference set, the search mode or epsilon change, and it is not
+   * serialized.
+   */
+  const QueryCache<typename MatType::elem_type>& Cache() const { return cache; }
+  //! Modify the cache of search results.
+  QueryCache<typename MatType::elem_type>& Cache() { return cache; }
+
   //! Perform neighbor search.  The query set will be reordered.
-  void Search(arma::mat&& querySet,
+  void Search(MatType&& querySet,
               const size_t k,
               arma::Mat<size_t>& neighbors,
               arma::mat& distances);
@@ -402,14 +610,22 @@ class NSModel
 
   //! Return a string representation of the current tree type.
   std::string TreeName() const;
+
+ private:
+  //! Perform neighbor search without the cache.
+  void UncachedSearch(MatType&& querySet,
+                      const size_t k,
+                      arma::Mat<size_t>& neighbors,
+                      arma::mat& distances);
 };
 
 } // namespace neighbor
 } // namespace mlpack
 
 //! Set the serialization version of the NSModel class.
-BOOST_TEMPLATE_CLASS_VERSION(template<typename SortPolicy>,
-    mlpack::neighbor::NSModel<SortPolicy>, 1);
+BOOST_TEMPLATE_CLASS_VERSION(SINGLE_ARG(template<typename SortPolicy,
+    typename MatType>), SINGLE_ARG(mlpack::neighbor::NSModel<SortPolicy,
+    MatType>), 2);
 
 // Include implementation.
 #include "ns_model_impl.hpp"
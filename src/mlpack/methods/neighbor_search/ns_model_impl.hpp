@@ -19,6 +19,7 @@
 #include "ns_model.hpp"
 
 #include <boost/serialization/variant.hpp>
+#include <chrono>
 
 namespace mlpack {
 namespace neighbor {
@@ -33,14 +34,15 @@ void MonoSearchVisitor::operator()(NSType *ns) const
 }
 
 //! Save parameters for bichromatic neighbor search.
-template<typename SortPolicy>
-BiSearchVisitor<SortPolicy>::BiSearchVisitor(const arma::mat& querySet,
-                                             const size_t k,
-                                             arma::Mat<size_t>& neighbors,
-                                             arma::mat& distances,
-                                             const size_t leafSize,
-                                             const double tau,
-                                             const double rho) :
+template<typename SortPolicy, typename MatType>
+BiSearchVisitor<SortPolicy, MatType>::BiSearchVisitor(
+    const MatType& querySet,
+    const size_t k,
+    arma::Mat<size_t>& neighbors,
+    arma::mat& distances,
+    const size_t leafSize,
+    const double tau,
+    const double rho) :
     querySet(querySet),
     k(k),
     neighbors(neighbors),
@@ -51,11 +53,12 @@ BiSearchVisitor<SortPolicy>::BiSearchVisitor(const arma::mat& querySet,
 {}
 
 //! Default Bichromatic neighbor search on the given NSType instance.
-template<typename SortPolicy>
+template<typename SortPolicy, typename MatType>
 template<template<typename TreeMetricType,
                   typename TreeStatType,
                   typename TreeMatType> class TreeType>
-void BiSearchVisitor<SortPolicy>::operator()(NSTypeT<TreeType>* ns) const
+void BiSearchVisitor<SortPolicy, MatType>::operator()(
+    NSTypeT<TreeType>* ns) const
 {
   if (ns)
     return ns->Search(querySet, k, neighbors, distances);
@@ -63,8 +66,9 @@ void BiSearchVisitor<SortPolicy>::operator()(NSTypeT<TreeType>* ns) const
 }
 
 //! Bichromatic neighbor search on the given NSType specialized for KDTrees.
-template<typename SortPolicy>
-void BiSearchVisitor<SortPolicy>::operator()(NSTypeT<tree::KDTree>* ns) const
+template<typename SortPolicy, typename MatType>
+void BiSearchVisitor<SortPolicy, MatType>::operator()(
+    NSTypeT<tree::KDTree>* ns) const
 {
   if (ns)
     return SearchLeaf(ns);
@@ -72,8 +76,9 @@ void BiSearchVisitor<SortPolicy>::operator()(NSTypeT<tree::KDTree>* ns) const
 }
 
 //! Bichromatic neighbor search on the given NSType specialized for BallTrees.
-template<typename SortPolicy>
-void BiSearchVisitor<SortPolicy>::operator()(NSTypeT<tree::BallTree>* ns) const
+template<typename SortPolicy, typename MatType>
+void BiSearchVisitor<SortPolicy, MatType>::operator()(
+    NSTypeT<tree::BallTree>* ns) const
 {
   if (ns)
     return SearchLeaf(ns);
@@ -81,8 +86,8 @@ void BiSearchVisitor<SortPolicy>::operator()(NSTypeT<tree::BallTree>* ns) const
 }
 
 //! Bichromatic neighbor search specialized for SPTrees.
-template<typename SortPolicy>
-void BiSearchVisitor<SortPolicy>::operator()(SpillKNN* ns) const
+template<typename SortPolicy, typename MatType>
+void BiSearchVisitor<SortPolicy, MatType>::operator()(SpillNSType* ns) const
 {
   if (ns)
   {
@@ -90,7 +95,7 @@ void BiSearchVisitor<SortPolicy>::operator()(SpillKNN* ns) const
     {
       // For Dual Tree Search on SpillTrees, the queryTree must be built with
       // non overlapping (tau = 0).
-      typename SpillKNN::Tree queryTree(std::move(querySet), 0 /* tau*/,
+      typename SpillNSType::Tree queryTree(std::move(querySet), 0 /* tau*/,
           leafSize, rho);
       ns->Search(queryTree, k, neighbors, distances);
     }
@@ -102,8 +107,9 @@ void BiSearchVisitor<SortPolicy>::operator()(SpillKNN* ns) const
 }
 
 //! Bichromatic neighbor search specialized for octrees.
-template<typename SortPolicy>
-void BiSearchVisitor<SortPolicy>::operator()(NSTypeT<tree::Octree>* ns) const
+template<typename SortPolicy, typename MatType>
+void BiSearchVisitor<SortPolicy, MatType>::operator()(
+    NSTypeT<tree::Octree>* ns) const
 {
   if (ns)
     return SearchLeaf(ns);
@@ -111,9 +117,9 @@ void BiSearchVisitor<SortPolicy>::operator()(NSTypeT<tree::Octree>* ns) const
 }
 
 //! Bichromatic neighbor search on the given NSType considering the leafSize.
-template<typename SortPolicy>
+template<typename SortPolicy, typename MatType>
 template<typename NSType>
-void BiSearchVisitor<SortPolicy>::SearchLeaf(NSType* ns) const
+void BiSearchVisitor<SortPolicy, MatType>::SearchLeaf(NSType* ns) const
 {
   if (ns->SearchMode() == DUAL_TREE_MODE)
   {
@@ -139,11 +145,11 @@ void BiSearchVisitor<SortPolicy>::SearchLeaf(NSType* ns) const
 }
 
 //! Save parameters for Train.
-template<typename SortPolicy>
-TrainVisitor<SortPolicy>::TrainVisitor(arma::mat&& referenceSet,
-                                       const size_t leafSize,
-                                       const double tau,
-                                       const double rho) :
+template<typename SortPolicy, typename MatType>
+TrainVisitor<SortPolicy, MatType>::TrainVisitor(MatType&& referenceSet,
+                                                const size_t leafSize,
+                                                const double tau,
+                                                const double rho) :
     referenceSet(std::move(referenceSet)),
     leafSize(leafSize),
     tau(tau),
@@ -151,11 +157,12 @@ TrainVisitor<SortPolicy>::TrainVisitor(arma::mat&& referenceSet,
 {}
 
 //! Default Train on the given NSType instance.
-template<typename SortPolicy>
+template<typename SortPolicy, typename MatType>
 template<template<typename TreeMetricType,
                   typename TreeStatType,
                   typename TreeMatType> class TreeType>
-void TrainVisitor<SortPolicy>::operator()(NSTypeT<TreeType>* ns) const
+void TrainVisitor<SortPolicy, MatType>::operator()(
+    NSTypeT<TreeType>* ns) const
 {
   if (ns)
     return ns->Train(std::move(referenceSet));
@@ -163,8 +170,9 @@ void TrainVisitor<SortPolicy>::operator()(NSTypeT<TreeType>* ns) const
 }
 
 //! Train on the given NSType specialized for KDTrees.
-template<typename SortPolicy>
-void TrainVisitor<SortPolicy>::operator()(NSTypeT<tree::KDTree>* ns) const
+template<typename SortPolicy, typename MatType>
+void TrainVisitor<SortPolicy, MatType>::operator()(
+    NSTypeT<tree::KDTree>* ns) const
 {
   if (ns)
     return TrainLeaf(ns);
@@ -172,17 +180,58 @@ void TrainVisitor<SortPolicy>::operator()(NSTypeT<tree::KDTree>* ns) const
 }
 
 //! Train on the given NSType specialized for BallTrees.
-template<typename SortPolicy>
-void TrainVisitor<SortPolicy>::operator()(NSTypeT<tree::BallTree>* ns) const
+template<typename SortPolicy, typename MatType>
+void TrainVisitor<SortPolicy, MatType>::operator()(
+    NSTypeT<tree::BallTree>* ns) const
 {
   if (ns)
     return TrainLeaf(ns);
   throw std::runtime_error("no neighbor search model initialized");
 }
 
+//! Train on the given NSType specialized for R trees.
+template<typename SortPolicy, typename MatType>
+void TrainVisitor<SortPolicy, MatType>::operator()(
+    NSTypeT<tree::RTree>* ns) const
+{
+  if (ns)
+    return TrainBulkLoad(ns, tree::STR_BULK_LOAD);
+  throw std::runtime_error("no neighbor search model initialized");
+}
+
+//! Train on the given NSType specialized for R* trees.
+template<typename SortPolicy, typename MatType>
+void TrainVisitor<SortPolicy, MatType>::operator()(
+    NSTypeT<tree::RStarTree>* ns) const
+{
+  if (ns)
+    return TrainBulkLoad(ns, tree::STR_BULK_LOAD);
+  throw std::runtime_error("no neighbor search model initialized");
+}
+
+//! Train on the given NSType specialized for X trees.
+template<typename SortPolicy, typename MatType>
+void TrainVisitor<SortPolicy, MatType>::operator()(
+    NSTypeT<tree::XTree>* ns) const
+{
+  if (ns)
+    return TrainBulkLoad(ns, tree::STR_BULK_LOAD);
+  throw std::runtime_error("no neighbor search model initialized");
+}
+
+//! Train on the given NSType specialized for Hilbert R trees.
+template<typename SortPolicy, typename MatType>
+void TrainVisitor<SortPolicy, MatType>::operator()(
+    NSTypeT<tree::HilbertRTree>* ns) const
+{
+  if (ns)
+    return TrainBulkLoad(ns, tree::HILBERT_BULK_LOAD);
+  throw std::runtime_error("no neighbor search model initialized");
+}
+
 //! Train specialized for SPTrees.
-template<typename SortPolicy>
-void TrainVisitor<SortPolicy>::operator()(SpillKNN* ns) const
+template<typename SortPolicy, typename MatType>
+void TrainVisitor<SortPolicy, MatType>::operator()(SpillNSType* ns) const
 {
   if (ns)
   {
@@ -190,7 +239,8 @@ void TrainVisitor<SortPolicy>::operator()(SpillKNN* ns) const
       ns->Train(std::move(referenceSet));
     else
     {
-      typename SpillKNN::Tree tree(std::move(referenceSet), tau, leafSize, rho);
+      typename SpillNSType::Tree tree(std::move(referenceSet), tau, leafSize,
+          rho);
       ns->Train(std::move(tree));
     }
   }
@@ -199,8 +249,9 @@ void TrainVisitor<SortPolicy>::operator()(SpillKNN* ns) const
 }
 
 //! Train specialized for Octrees.
-template<typename SortPolicy>
-void TrainVisitor<SortPolicy>::operator()(NSTypeT<tree::Octree>* ns) const
+template<typename SortPolicy, typename MatType>
+void TrainVisitor<SortPolicy, MatType>::operator()(
+    NSTypeT<tree::Octree>* ns) const
 {
   if (ns)
     return TrainLeaf(ns);
@@ -208,9 +259,9 @@ void TrainVisitor<SortPolicy>::operator()(NSTypeT<tree::Octree>* ns) const
 }
 
 //! Train on the given NSType considering the leafSize.
-template<typename SortPolicy>
+template<typename SortPolicy, typename MatType>
 template<typename NSType>
-void TrainVisitor<SortPolicy>::TrainLeaf(NSType* ns) const
+void TrainVisitor<SortPolicy, MatType>::TrainLeaf(NSType* ns) const
 {
   if (ns->SearchMode() == NAIVE_MODE)
     ns->Train(std::move(referenceSet));
@@ -225,6 +276,103 @@ void TrainVisitor<SortPolicy>::TrainLeaf(NSType* ns) const
   }
 }
 
+//! Train on the given NSType by bulk-loading a rectangle tree.
+template<typename SortPolicy, typename MatType>
+template<typename NSType>
+void TrainVisitor<SortPolicy, MatType>::TrainBulkLoad(
+    NSType* ns,
+    const tree::BulkLoadType bulkLoad) const
+{
+  if (ns->SearchMode() == NAIVE_MODE)
+    ns->Train(std::move(referenceSet));
+  else
+  {
+    // Rectangle trees don't reorder the points, so no mappings are needed.
+    typename NSType::Tree referenceTree(std::move(referenceSet), bulkLoad);
+    ns->Train(std::move(referenceTree));
+  }
+}
+
+//! Save parameters for InsertPoints.
+template<typename SortPolicy, typename MatType>
+InsertPointsVisitor<SortPolicy, MatType>::InsertPointsVisitor(
+    const MatType& points,
+    const size_t leafSize) :
+    points(points),
+    leafSize(leafSize)
+{}
+
+//! Default InsertPoints on the given NSType instance (not supported).
+template<typename SortPolicy, typename MatType>
+template<typename NSType>
+void InsertPointsVisitor<SortPolicy, MatType>::operator()(NSType* ns) const
+{
+  if (ns)
+    throw std::invalid_argument("points can only be inserted into kd-trees "
+        "and ball trees");
+  throw std::runtime_error("no neighbor search model initialized");
+}
+
+//! Insert points specialized for KDTrees.
+template<typename SortPolicy, typename MatType>
+void InsertPointsVisitor<SortPolicy, MatType>::operator()(
+    NSTypeT<tree::KDTree>* ns) const
+{
+  if (ns)
+    return ns->InsertPoints(points, leafSize);
+  throw std::runtime_error("no neighbor search model initialized");
+}
+
+//! Insert points specialized for BallTrees.
+template<typename SortPolicy, typename MatType>
+void InsertPointsVisitor<SortPolicy, MatType>::operator()(
+    NSTypeT<tree::BallTree>* ns) const
+{
+  if (ns)
+    return ns->InsertPoints(points, leafSize);
+  throw std::runtime_error("no neighbor search model initialized");
+}
+
+//! Save parameters for DeletePoints.
+template<typename SortPolicy, typename MatType>
+DeletePointsVisitor<SortPolicy, MatType>::DeletePointsVisitor(
+    const std::vector<size_t>& indices,
+    const size_t leafSize) :
+    indices(indices),
+    leafSize(leafSize)
+{}
+
+//! Default DeletePoints on the given NSType instance (not supported).
+template<typename SortPolicy, typename MatType>
+template<typename NSType>
+void DeletePointsVisitor<SortPolicy, MatType>::operator()(NSType* ns) const
+{
+  if (ns)
+    throw std::invalid_argument("points can only be deleted from kd-trees "
+        "and ball trees");
+  throw std::runtime_error("no neighbor search model initialized");
+}
+
+//! Delete points specialized for KDTrees.
+template<typename SortPolicy, typename MatType>
+void DeletePointsVisitor<SortPolicy, MatType>::operator()(
+    NSTypeT<tree::KDTree>* ns) const
+{
+  if (ns)
+    return ns->DeletePoints(indices, leafSize);
+  throw std::runtime_error("no neighbor search model initialized");
+}
+
+//! Delete points specialized for BallTrees.
+template<typename SortPolicy, typename MatType>
+void DeletePointsVisitor<SortPolicy, MatType>::operator()(
+    NSTypeT<tree::BallTree>* ns) const
+{
+  if (ns)
+    return ns->DeletePoints(indices, leafSize);
+  throw std::runtime_error("no neighbor search model initialized");
+}
+
 //! Return the search mode.
 template<typename NSType>
 NeighborSearchMode& SearchModeVisitor::operator()(NSType* ns) const
@@ -243,9 +391,28 @@ double& EpsilonVisitor::operator()(NSType* ns) const
   throw std::runtime_error("no neighbor search model initialized");
 }
 
+//! Expose the Parallel method of the given NSType.
+template<typename NSType>
+bool& ParallelVisitor::operator()(NSType* ns) const
+{
+  if (ns)
+    return ns->Parallel();
+  throw std::runtime_error("no neighbor search model initialized");
+}
+
+//! Expose the MaxVisits method of the given NSType.
+template<typename NSType>
+size_t& MaxVisitsVisitor::operator()(NSType* ns) const
+{
+  if (ns)
+    return ns->MaxVisits();
+  throw std::runtime_error("no neighbor search model initialized");
+}
+
 //! Expose the referenceSet of the given NSType.
+template<typename MatType>
 template<typename NSType>
-const arma::mat& ReferenceSetVisitor::operator()(NSType* ns) const
+const MatType& ReferenceSetVisitor<MatType>::operator()(NSType* ns) const
 {
   if (ns)
     return ns->ReferenceSet();
@@ -264,38 +431,49 @@ void DeleteVisitor::operator()(NSType* ns) const
  * Initialize the NSModel with the given type and whether or not a random
  * basis should be used.
  */
-template<typename SortPolicy>
-NSModel<SortPolicy>::NSModel(TreeTypes treeType, bool randomBasis) :
+template<typename SortPolicy, typename MatType>
+NSModel<SortPolicy, MatType>::NSModel(TreeTypes treeType, bool randomBasis) :
     treeType(treeType),
     leafSize(20),
     tau(0),
     rho(0.7),
-    randomBasis(randomBasis)
+    randomBasis(randomBasis),
+    tuned(false),
+    cacheSearchMode(DUAL_TREE_MODE),
+    cacheEpsilon(0)
 {
   // Nothing to do.
 }
 
-template<typename SortPolicy>
-NSModel<SortPolicy>::NSModel(const NSModel& other) :
+template<typename SortPolicy, typename MatType>
+NSModel<SortPolicy, MatType>::NSModel(const NSModel& other) :
     treeType(other.treeType),
     leafSize(other.leafSize),
     tau(other.tau),
     rho(other.rho),
     randomBasis(other.randomBasis),
     q(other.q),
+    tuned(other.tuned),
+    cache(other.cache),
+    cacheSearchMode(other.cacheSearchMode),
+    cacheEpsilon(other.cacheEpsilon),
     nSearch(other.nSearch)
 {
   // Nothing to do.
 }
 
-template<typename SortPolicy>
-NSModel<SortPolicy>::NSModel(NSModel&& other) :
+template<typename SortPolicy, typename MatType>
+NSModel<SortPolicy, MatType>::NSModel(NSModel&& other) :
     treeType(other.treeType),
     leafSize(other.leafSize),
     tau(other.tau),
     rho(other.rho),
     randomBasis(other.randomBasis),
     q(std::move(other.q)),
+    tuned(other.tuned),
+    cache(std::move(other.cache)),
+    cacheSearchMode(other.cacheSearchMode),
+    cacheEpsilon(other.cacheEpsilon),
     nSearch(other.nSearch)
 {
   // Reset parameters of the other model.
@@ -304,11 +482,14 @@ NSModel<SortPolicy>::NSModel(NSModel&& other) :
   other.tau = 0;
   other.rho = 0.7;
   other.randomBasis = false;
+  other.tuned = false;
+  other.cache = QueryCache<typename MatType::elem_type>();
   other.nSearch = decltype(other.nSearch)();
 }
 
-template<typename SortPolicy>
-NSModel<SortPolicy>& NSModel<SortPolicy>::operator=(const NSModel& other)
+template<typename SortPolicy, typename MatType>
+NSModel<SortPolicy, MatType>& NSModel<SortPolicy, MatType>::operator=(
+    const NSModel& other)
 {
   boost::apply_visitor(DeleteVisitor(), nSearch);
 
@@ -318,13 +499,18 @@ NSModel<SortPolicy>& NSModel<SortPolicy>::operator=(const NSModel& other)
   rho = other.rho;
   randomBasis = other.randomBasis;
   q = other.q;
+  tuned = other.tuned;
+  cache = other.cache;
+  cacheSearchMode = other.cacheSearchMode;
+  cacheEpsilon = other.cacheEpsilon;
   nSearch = other.nSearch;
 
   return *this;
 }
 
-template<typename SortPolicy>
-NSModel<SortPolicy>& NSModel<SortPolicy>::operator=(NSModel&& other)
+template<typename SortPolicy, typename MatType>
+NSModel<SortPolicy, MatType>& NSModel<SortPolicy, MatType>::operator=(
+    NSModel&& other)
 {
   boost::apply_visitor(DeleteVisitor(), nSearch);
 
@@ -334,6 +520,10 @@ NSModel<SortPolicy>& NSModel<SortPolicy>::operator=(NSModel&& other)
   rho = other.rho;
   randomBasis = other.randomBasis;
   q = std::move(other.q);
+  tuned = other.tuned;
+  cache = std::move(other.cache);
+  cacheSearchMode = other.cacheSearchMode;
+  cacheEpsilon = other.cacheEpsilon;
   // Copy the pointer and type.
   nSearch = other.nSearch;
 
@@ -343,22 +533,25 @@ NSModel<SortPolicy>& NSModel<SortPolicy>::operator=(NSModel&& other)
   other.tau = 0;
   other.rho = 0.7;
   other.randomBasis = false;
+  other.tuned = false;
+  other.cache = QueryCache<typename MatType::elem_type>();
   other.nSearch = decltype(other.nSearch)();
 
   return *this;
 }
 
 //! Clean memory, if necessary.
-template<typename SortPolicy>
-NSModel<SortPolicy>::~NSModel()
+template<typename SortPolicy, typename MatType>
+NSModel<SortPolicy, MatType>::~NSModel()
 {
   boost::apply_visitor(DeleteVisitor(), nSearch);
 }
 
 //! Serialize the kNN model.
-template<typename SortPolicy>
+template<typename SortPolicy, typename MatType>
 template<typename Archive>
-void NSModel<SortPolicy>::serialize(Archive& ar, const unsigned int version)
+void NSModel<SortPolicy, MatType>::serialize(Archive& ar,
+                                             const unsigned int version)
 {
   ar & BOOST_SERIALIZATION_NVP(treeType);
   // Backward compatibility: older versions of NSModel didn't include these
@@ -372,52 +565,87 @@ void NSModel<SortPolicy>::serialize(Archive& ar, const unsigned int version)
   ar & BOOST_SERIALIZATION_NVP(randomBasis);
   ar & BOOST_SERIALIZATION_NVP(q);
 
-  // This should never happen, but just in case, be clean with memory.
+  // Version 2 records whether the tree type and leaf size were tuned.
+  if (version > 1)
+    ar & BOOST_SERIALIZATION_NVP(tuned);
+  else if (Archive::is_loading::value)
+    tuned = false;
+
+  // This should never happen, but just in case, be clean with memory.  The
+  // cached results belong to the old reference set.
   if (Archive::is_loading::value)
+  {
     boost::apply_visitor(DeleteVisitor(), nSearch);
+    cache.Clear();
+  }
 
   ar & BOOST_SERIALIZATION_NVP(nSearch);
 }
 
 //! Expose the dataset.
-template<typename SortPolicy>
-const arma::mat& NSModel<SortPolicy>::Dataset() const
+template<typename SortPolicy, typename MatType>
+const MatType& NSModel<SortPolicy, MatType>::Dataset() const
 {
-  return boost::apply_visitor(ReferenceSetVisitor(), nSearch);
+  return boost::apply_visitor(ReferenceSetVisitor<MatType>(), nSearch);
 }
 
 //! Access the search mode.
-template<typename SortPolicy>
-NeighborSearchMode NSModel<SortPolicy>::SearchMode() const
+template<typename SortPolicy, typename MatType>
+NeighborSearchMode NSModel<SortPolicy, MatType>::SearchMode() const
 {
   return boost::apply_visitor(SearchModeVisitor(), nSearch);
 }
 
 //! Modify the search mode.
-template<typename SortPolicy>
-NeighborSearchMode& NSModel<SortPolicy>::SearchMode()
+template<typename SortPolicy, typename MatType>
+NeighborSearchMode& NSModel<SortPolicy, MatType>::SearchMode()
 {
   return boost::apply_visitor(SearchModeVisitor(), nSearch);
 }
 
-template<typename SortPolicy>
-double NSModel<SortPolicy>::Epsilon() const
+template<typename SortPolicy, typename MatType>
+double NSModel<SortPolicy, MatType>::Epsilon() const
 {
   return boost::apply_visitor(EpsilonVisitor(), nSearch);
 }
 
-template<typename SortPolicy>
-double& NSModel<SortPolicy>::Epsilon()
+template<typename SortPolicy, typename MatType>
+double& NSModel<SortPolicy, MatType>::Epsilon()
 {
   return boost::apply_visitor(EpsilonVisitor(), nSearch);
 }
 
+template<typename SortPolicy, typename MatType>
+bool NSModel<SortPolicy, MatType>::Parallel() const
+{
+  return boost::apply_visitor(ParallelVisitor(), nSearch);
+}
+
+template<typename SortPolicy, typename MatType>
+bool& NSModel<SortPolicy, MatType>::Parallel()
+{
+  return boost::apply_visitor(ParallelVisitor(), nSearch);
+}
+
+template<typename SortPolicy, typename MatType>
+size_t NSModel<SortPolicy, MatType>::MaxVisits() const
+{
+  return boost::apply_visitor(MaxVisitsVisitor(), nSearch);
+}
+
+template<typename SortPolicy, typename MatType>
+size_t& NSModel<SortPolicy, MatType>::MaxVisits()
+{
+  return boost::apply_visitor(MaxVisitsVisitor(), nSearch);
+}
+
 //! Build the reference tree.
-template<typename SortPolicy>
-void NSModel<SortPolicy>::BuildModel(arma::mat&& referenceSet,
-                                     const size_t leafSize,
-                                     const NeighborSearchMode searchMode,
-                                     const double epsilon)
+template<typename SortPolicy, typename MatType>
+void NSModel<SortPolicy, MatType>::BuildModel(
+    MatType&& referenceSet,
+    const size_t leafSize,
+    const NeighborSearchMode searchMode,
+    const double epsilon)
 {
   this->leafSize = leafSize;
   // Initialize random basis if necessary.
@@ -428,11 +656,11 @@ void NSModel<SortPolicy>::BuildModel(arma::mat&& referenceSet,
     {
       // [Q, R] = qr(randn(d, d));
       // Q = Q * diag(sign(diag(R)));
-      arma::mat r;
-      if (arma::qr(q, r, arma::randn<arma::mat>(referenceSet.n_rows,
+      MatType r;
+      if (arma::qr(q, r, arma::randn<MatType>(referenceSet.n_rows,
               referenceSet.n_rows)))
       {
-        arma::vec rDiag(r.n_rows);
+        arma::Col<typename MatType::elem_type> rDiag(r.n_rows);
         for (size_t i = 0; i < rDiag.n_elem; ++i)
         {
           if (r(i, i) < 0)
@@ -454,6 +682,7 @@ void NSModel<SortPolicy>::BuildModel(arma::mat&& referenceSet,
 
   // Clean memory, if necessary.
   boost::apply_visitor(DeleteVisitor(), nSearch);
+  cache.Clear();
 
   // Do we need to modify the reference set?
   if (randomBasis)
@@ -468,55 +697,68 @@ void NSModel<SortPolicy>::BuildModel(arma::mat&& referenceSet,
   switch (treeType)
   {
     case KD_TREE:
-      nSearch = new NSType<SortPolicy, tree::KDTree>(searchMode, epsilon);
+      nSearch = new NSType<SortPolicy, tree::KDTree, MatType>(
+          searchMode, epsilon);
       break;
     case COVER_TREE:
-      nSearch = new NSType<SortPolicy, tree::StandardCoverTree>(searchMode,
-          epsilon);
+      nSearch = new NSType<SortPolicy, tree::StandardCoverTree, MatType>(
+          searchMode, epsilon);
       break;
     case R_TREE:
-      nSearch = new NSType<SortPolicy, tree::RTree>(searchMode, epsilon);
+      nSearch = new NSType<SortPolicy, tree::RTree, MatType>(
+          searchMode, epsilon);
       break;
     case R_STAR_TREE:
-      nSearch = new NSType<SortPolicy, tree::RStarTree>(searchMode, epsilon);
+      nSearch = new NSType<SortPolicy, tree::RStarTree, MatType>(
+          searchMode, epsilon);
       break;
     case BALL_TREE:
-      nSearch = new NSType<SortPolicy, tree::BallTree>(searchMode, epsilon);
+      nSearch = new NSType<SortPolicy, tree::BallTree, MatType>(
+          searchMode, epsilon);
       break;
     case X_TREE:
-      nSearch = new NSType<SortPolicy, tree::XTree>(searchMode, epsilon);
+      nSearch = new NSType<SortPolicy, tree::XTree, MatType>(
+          searchMode, epsilon);
       break;
     case HILBERT_R_TREE:
-      nSearch = new NSType<SortPolicy, tree::HilbertRTree>(searchMode, epsilon);
+      nSearch = new NSType<SortPolicy, tree::HilbertRTree, MatType>(
+          searchMode, epsilon);
       break;
     case R_PLUS_TREE:
-      nSearch = new NSType<SortPolicy, tree::RPlusTree>(searchMode, epsilon);
+      nSearch = new NSType<SortPolicy, tree::RPlusTree, MatType>(
+          searchMode, epsilon);
       break;
     case R_PLUS_PLUS_TREE:
-      nSearch = new NSType<SortPolicy, tree::RPlusPlusTree>(searchMode,
-          epsilon);
+      nSearch = new NSType<SortPolicy, tree::RPlusPlusTree, MatType>(
+          searchMode, epsilon);
       break;
     case VP_TREE:
-      nSearch = new NSType<SortPolicy, tree::VPTree>(searchMode, epsilon);
+      nSearch = new NSType<SortPolicy, tree::VPTree, MatType>(
+          searchMode, epsilon);
       break;
     case RP_TREE:
-      nSearch = new NSType<SortPolicy, tree::RPTree>(searchMode, epsilon);
+      nSearch = new NSType<SortPolicy, tree::RPTree, MatType>(
+          searchMode, epsilon);
       break;
     case MAX_RP_TREE:
-      nSearch = new NSType<SortPolicy, tree::MaxRPTree>(searchMode, epsilon);
+      nSearch = new NSType<SortPolicy, tree::MaxRPTree, MatType>(
+          searchMode, epsilon);
       break;
     case SPILL_TREE:
-      nSearch = new SpillKNN(searchMode, epsilon);
+      nSearch = new DefeatistKNN<tree::SPTree, MatType>(searchMode, epsilon);
       break;
     case UB_TREE:
-      nSearch = new NSType<SortPolicy, tree::UBTree>(searchMode, epsilon);
+      nSearch = new NSType<SortPolicy, tree::UBTree, MatType>(
+          searchMode, epsilon);
       break;
     case OCTREE:
-      nSearch = new NSType<SortPolicy, tree::Octree>(searchMode, epsilon);
+      nSearch = new NSType<SortPolicy, tree::Octree, MatType>(
+          searchMode, epsilon);
       break;
   }
 
-  TrainVisitor<SortPolicy> tn(std::move(referenceSet), leafSize, tau, rho);
+  TrainVisitor<SortPolicy, MatType> tn(std::move(referenceSet), leafSize, tau,
+      rho);
   boost::apply_visitor(tn, nSearch);
 
   if (searchMode != NAIVE_MODE)
@@ -526,12 +768,195 @@ void NSModel<SortPolicy>::BuildModel(arma::mat&& referenceSet,
   }
 }
 
+//! Choose the tree type and leaf size by timing them on a sample.
+template<typename SortPolicy, typename MatType>
+void NSModel<SortPolicy, MatType>::Tune(const MatType& referenceSet,
+                                        const size_t k,
+                                        const NeighborSearchMode searchMode,
+                                        const double epsilon,
+                                        std::vector<TreeTypes> candidates,
+                                        std::vector<size_t> leafSizes,
+                                        const size_t sampleSize,
+                                        const size_t numQueries)
+{
+  if (referenceSet.n_cols < 2)
+  {
+    throw std::invalid_argument("NSModel::Tune(): the reference set must have "
+        "at least 2 points");
+  }
+  if (sampleSize == 0 || numQueries == 0 || k == 0)
+  {
+    throw std::invalid_argument("NSModel::Tune(): k, sampleSize and "
+        "numQueries must be positive");
+  }
+
+  // The naive search does not build a tree.
+  if (searchMode == NAIVE_MODE)
+  {
+    Log::Info << "No tree is used in naive mode; nothing to tune." << std::endl;
+    return;
+  }
+
+  if (candidates.empty())
+  {
+    candidates = { KD_TREE, BALL_TREE, COVER_TREE, VP_TREE, RP_TREE,
+        MAX_RP_TREE, UB_TREE, R_TREE, R_STAR_TREE, X_TREE, HILBERT_R_TREE,
+        R_PLUS_TREE, R_PLUS_PLUS_TREE };
+    if (referenceSet.n_rows <= 8)
+      candidates.push_back(OCTREE);
+  }
+  if (leafSizes.empty())
+    leafSizes = { 5, 10, 20, 40, 80 };
+
+  // Split a random permutation of the points into the sample and the queries;
+  // if there are few points, the queries are taken from the sample.
+  const arma::uvec order = arma::randperm(referenceSet.n_cols);
+  const size_t numSample = std::min(sampleSize, (size_t) order.n_elem);
+  const arma::uvec sampleIndices = order.head(numSample);
+  const arma::uvec queryIndices = (numSample + numQueries <= order.n_elem) ?
+      arma::uvec(order.subvec(numSample, numSample + numQueries - 1)) :
+      arma::uvec(order.head(std::min(numQueries, (size_t) order.n_elem)));
+  const MatType sample = referenceSet.cols(sampleIndices);
+  const MatType queries = referenceSet.cols(queryIndices);
+  const size_t sampleK = std::min(k, numSample);
+
+  Log::Info << "Tuning the tree type and leaf size on " << numSample
+      << " reference points and " << queries.n_cols << " queries..."
+      << std::endl;
+
+  double bestTime = std::numeric_limits<double>::max();
+  TreeTypes bestTreeType = treeType;
+  size_t bestLeafSize = leafSize;
+  for (const TreeTypes candidate : candidates)
+  {
+    const bool usesLeafSize = (candidate == KD_TREE ||
+        candidate == BALL_TREE || candidate == SPILL_TREE ||
+        candidate == OCTREE);
+    const size_t numLeafSizes = usesLeafSize ? leafSizes.size() : 1;
+    for (size_t l = 0; l < numLeafSizes; ++l)
+    {
+      const size_t candidateLeafSize = usesLeafSize ? leafSizes[l] : leafSize;
+
+      NSModel model(candidate, randomBasis);
+      model.Tau() = tau;
+      model.Rho() = rho;
+
+      arma::Mat<size_t> neighbors;
+      arma::mat distances;
+      const std::chrono::steady_clock::time_point start =
+          std::chrono::steady_clock::now();
+      model.BuildModel(MatType(sample), candidateLeafSize, searchMode,
+          epsilon);
+      model.Search(MatType(queries), sampleK, neighbors, distances);
+      const double time = std::chrono::duration<double>(
+          std::chrono::steady_clock::now() - start).count();
+
+      Log::Info << "  " << model.TreeName();
+      if (usesLeafSize)
+        Log::Info << " (leaf size " << candidateLeafSize << ")";
+      Log::Info << ": " << time << "s." << std::endl;
+
+      if (time < bestTime)
+      {
+        bestTime = time;
+        bestTreeType = candidate;
+        bestLeafSize = candidateLeafSize;
+      }
+    }
+  }
+
+  treeType = bestTreeType;
+  leafSize = bestLeafSize;
+  tuned = true;
+
+  Log::Info << "Selected the " << TreeName() << " with leaf size " << leafSize
+      << "." << std::endl;
+}
+
+//! Insert points into the reference tree.
+template<typename SortPolicy, typename MatType>
+void NSModel<SortPolicy, MatType>::InsertPoints(MatType&& points)
+{
+  // The points must be in the same basis as the reference set.
+  if (randomBasis)
+    points = q * points;
+
+  Log::Info << "Inserting " << points.n_cols << " points into the "
+      << TreeName() << "..." << std::endl;
+
+  InsertPointsVisitor<SortPolicy, MatType> insert(points, leafSize);
+  boost::apply_visitor(insert, nSearch);
+  cache.Clear();
+}
+
+//! Delete points from the reference tree.
+template<typename SortPolicy, typename MatType>
+void NSModel<SortPolicy, MatType>::DeletePoints(
+    const std::vector<size_t>& indices)
+{
+  Log::Info << "Deleting " << indices.size() << " points from the "
+      << TreeName() << "..." << std::endl;
+
+  DeletePointsVisitor<SortPolicy, MatType> del(indices, leafSize);
+  boost::apply_visitor(del, nSearch);
+  cache.Clear();
+}
+
+//! Perform neighbor search, answering repeated queries from the cache.
+template<typename SortPolicy, typename MatType>
+void NSModel<SortPolicy, MatType>::Search(MatType&& querySet,
+                                          const size_t k,
+                                          arma::Mat<size_t>& neighbors,
+                                          arma::mat& distances)
+{
+  if (cache.MemoryBudget() == 0)
+  {
+    UncachedSearch(std::move(querySet), k, neighbors, distances);
+    return;
+  }
+
+  // The cached results were found with the old settings.
+  if (SearchMode() != cacheSearchMode || Epsilon() != cacheEpsilon)
+  {
+    cache.Clear();
+    cacheSearchMode = SearchMode();
+    cacheEpsilon = Epsilon();
+  }
+
+  neighbors.set_size(k, querySet.n_cols);
+  distances.set_size(k, querySet.n_cols);
+  std::vector<size_t> misses;
+  for (size_t i = 0; i < querySet.n_cols; ++i)
+    if (!cache.Lookup(querySet.unsafe_col(i), k, neighbors, distances, i))
+      misses.push_back(i);
+
+  Log::Info << querySet.n_cols - misses.size() << " of " << querySet.n_cols
+      << " queries were answered from the cache." << std::endl;
+  if (misses.empty())
+    return;
+
+  // Search for the other queries, and store their results.
+  const arma::uvec missIndices = arma::conv_to<arma::uvec>::from(misses);
+  const MatType missQueries = querySet.cols(missIndices);
+  arma::Mat<size_t> missNeighbors;
+  arma::mat missDistances;
+  UncachedSearch(MatType(missQueries), k, missNeighbors, missDistances);
+
+  for (size_t j = 0; j < misses.size(); ++j)
+  {
+    neighbors.col(misses[j]) = missNeighbors.col(j);
+    distances.col(misses[j]) = missDistances.col(j);
+    cache.Insert(missQueries.col(j), arma::Col<size_t>(missNeighbors.col(j)),
+        arma::vec(missDistances.col(j)));
+  }
+}
+
 //! Perform neighbor search.  The query set will be reordered.
-template<typename SortPolicy>
-void NSModel<SortPolicy>::Search(arma::mat&& querySet,
-                                 const size_t k,
-                                 arma::Mat<size_t>& neighbors,
-                                 arma::mat& distances)
+template<typename SortPolicy, typename MatType>
+void NSModel<SortPolicy, MatType>::UncachedSearch(MatType&& querySet,
+                                                  const size_t k,
+                                                  arma::Mat<size_t>& neighbors,
+                                                  arma::mat& distances)
 {
   // We may need to map the query set randomly.
   if (randomBasis)
@@ -554,18 +979,22 @@ void NSModel<SortPolicy>::Search(arma::mat&& querySet,
       Log::Info << "greedy single-tree " << TreeName() << " search..."
           << std::endl;
       break;
+    case BEST_FIRST_SINGLE_TREE_MODE:
+      Log::Info << "best-first single-tree " << TreeName() << " search..."
+          << std::endl;
+      break;
   }
 
-  BiSearchVisitor<SortPolicy> search(querySet, k, neighbors, distances,
+  BiSearchVisitor<SortPolicy, MatType> search(querySet, k, neighbors, distances,
       leafSize, tau, rho);
   boost::apply_visitor(search, nSearch);
 }
 
 //! Perform neighbor search.
-template<typename SortPolicy>
-void NSModel<SortPolicy>::Search(const size_t k,
-                                 arma::Mat<size_t>& neighbors,
-                                 arma::mat& distances)
+template<typename SortPolicy, typename MatType>
+void NSModel<SortPolicy, MatType>::Search(const size_t k,
+                                          arma::Mat<size_t>& neighbors,
+                                          arma::mat& distances)
 {
   Log::Info << "Searching for " << k << " neighbors with ";
 
@@ -584,6 +1013,10 @@ void NSModel<SortPolicy>::Search(const size_t k,
       Log::Info << "greedy single-tree " << TreeName() << " search..."
           << std::endl;
       break;
+    case BEST_FIRST_SINGLE_TREE_MODE:
+      Log::Info << "best-first single-tree " << TreeName() << " search..."
+          << std::endl;
+      break;
   }
 
   if (Epsilon() != 0 && SearchMode() != NAIVE_MODE)
@@ -595,8 +1028,8 @@ void NSModel<SortPolicy>::Search(const size_t k,
 }
 
 //! Get the name of the tree type.
-template<typename SortPolicy>
-std::string NSModel<SortPolicy>::TreeName() const
+template<typename SortPolicy, typename MatType>
+std::string NSModel<SortPolicy, MatType>::TreeName() const
 {
   switch (treeType)
   {
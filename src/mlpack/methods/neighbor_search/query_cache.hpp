@@ -0,0 +1,303 @@
+/**
+ * @file query_cache.hpp
+ *
+ * Definition of the QueryCache class, a least-recently-used cache of neighbor
+ * search results, keyed by the query point.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_NEIGHBOR_SEARCH_QUERY_CACHE_HPP
+#define MLPACK_METHODS_NEIGHBOR_SEARCH_QUERY_CACHE_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include <list>
+#include <unordered_map>
+
+namespace mlpack {
+namespace neighbor {
+
+/**
+ * A least-recently-used cache of neighbor search results.  Each entry holds
+ * the neighbors and distances found for one query point; a later search for
+ * the same point (and the same number of neighbors or fewer) is answered from
+ * the entry.  When the entries take more memory than the budget, the least
+ * recently used ones are dropped.
+ *
+ * The points are the keys.  With a quantum of 0, a point only matches itself,
+ * bit for bit.  With a positive quantum, each coordinate is rounded down to a
+ * multiple of the quantum, so all the points in a cell of that width share the
+ * results of the first one searched for; the results are then approximate.
+ *
+ * The cache does not know when its results become stale: its owner must call
+ * Clear() when the reference set or the search settings change.  NSModel does
+ * this.
+ *
+ * @tparam eT Type of the elements of the query points.
+ */
+template<typename eT = double>
+class QueryCache
+{
+ public:
+  /**
+   * Create the cache.
+   *
+   * @param memoryBudget Maximum memory the entries may take, in bytes (0
+   *     disables the cache).
+   * @param quantum Width of the cells that share results (0 for exact keys).
+   */
+  QueryCache(const size_t memoryBudget = 0, const double quantum = 0.0) :
+      memoryBudget(memoryBudget),
+      quantum(quantum),
+      memoryUsage(0),
+      hits(0),
+      misses(0)
+  { }
+
+  //! Copy the given cache.
+  QueryCache(const QueryCache& other) :
+      memoryBudget(other.memoryBudget),
+      quantum(other.quantum),
+      entries(other.entries),
+      memoryUsage(other.memoryUsage),
+      hits(other.hits),
+      misses(other.misses)
+  {
+    // The iterators of the index must point into our own list.
+    for (typename EntryList::iterator it = entries.begin();
+        it != entries.end(); ++it)
+      index[it->key] = it;
+  }
+
+  //! Copy the given cache.
+  QueryCache& operator=(const QueryCache& other)
+  {
+    if (this != &other)
+    {
+      QueryCache copy(other);
+      Swap(copy);
+    }
+    return *this;
+  }
+
+  //! Take the entries of the given cache.  The iterators of the index stay
+  //! valid, since std::list moves its nodes.
+  QueryCache(QueryCache&& other) = default;
+  //! Take the entries of the given cache.
+  QueryCache& operator=(QueryCache&& other) = default;
+
+  /**
+   * Look up the results for the given query point.  On a hit, the first k
+   * neighbors and distances of the entry are written to the given column of
+   * neighbors and distances, and the entry becomes the most recently used.
+   *
+   * @param query Query point.
+   * @param k Number of neighbors to return.
+   * @param neighbors Matrix to write the neighbors to.
+   * @param distances Matrix to write the distances to.
+   * @param column Column of neighbors and distances to write to.
+   * @return Whether the results were in the cache.
+   */
+  template<typename VecType>
+  bool Lookup(const VecType& query,
+              const size_t k,
+              arma::Mat<size_t>& neighbors,
+              arma::mat& distances,
+              const size_t column)
+  {
+    if (memoryBudget == 0)
+      return false;
+
+    typename Index::iterator it = index.find(Key(query));
+    if (it == index.end() || it->second->neighbors.n_elem < k)
+    {
+      ++misses;
+      return false;
+    }
+
+    entries.splice(entries.begin(), entries, it->second);
+    neighbors.col(column) = it->second->neighbors.head(k);
+    distances.col(column) = it->second->distances.head(k);
+    ++hits;
+    return true;
+  }
+
+  /**
+   * Store the results for the given query point, replacing the results already
+   * stored for its key, and drop the least recently used entries if the
+   * budget is exceeded.
+   *
+   * @param query Query point.
+   * @param neighbors Neighbors of the query point.
+   * @param distances Distances to the neighbors.
+   */
+  template<typename VecType>
+  void Insert(const VecType& query,
+              const arma::Col<size_t>& neighbors,
+              const arma::vec& distances)
+  {
+    if (memoryBudget == 0)
+      return;
+
+    std::string key = Key(query);
+    typename Index::iterator it = index.find(key);
+    if (it != index.end())
+    {
+      memoryUsage -= EntryMemory(*it->second);
+      entries.erase(it->second);
+      index.erase(it);
+    }
+
+    entries.push_front(Entry());
+    Entry& entry = entries.front();
+    entry.key = std::move(key);
+    entry.neighbors = neighbors;
+    entry.distances = distances;
+    index[entry.key] = entries.begin();
+    memoryUsage += EntryMemory(entry);
+
+    Evict();
+  }
+
+  //! Drop all the entries.  The counters are kept.
+  void Clear()
+  {
+    entries.clear();
+    index.clear();
+    memoryUsage = 0;
+  }
+
+  //! Reset the hit and miss counters.
+  void ResetCounters() { hits = misses = 0; }
+
+  //! Get the memory budget, in bytes.
+  size_t MemoryBudget() const { return memoryBudget; }
+  //! Set the memory budget, in bytes, dropping entries if needed (0 disables
+  //! the cache and drops all of them).
+  void MemoryBudget(const size_t budget)
+  {
+    memoryBudget = budget;
+    Evict();
+  }
+
+  //! Get the width of the cells that share results.
+  double Quantum() const { return quantum; }
+  //! Set the width of the cells that share results (0 for exact keys).  The
+  //! entries are dropped if it changes, since their keys do not match.
+  void Quantum(const double newQuantum)
+  {
+    if (newQuantum != quantum)
+      Clear();
+    quantum = newQuantum;
+  }
+
+  //! Get the number of entries.
+  size_t Size() const { return entries.size(); }
+  //! Get the (approximate) memory taken by the entries, in bytes.
+  size_t MemoryUsage() const { return memoryUsage; }
+
+  //! Get the number of lookups answered from the cache.
+  size_t Hits() const { return hits; }
+  //! Get the number of lookups not answered from the cache.
+  size_t Misses() const { return misses; }
+  //! Get the fraction of lookups answered from the cache.
+  double HitRate() const
+  {
+    return (hits + misses == 0) ? 0.0 : double(hits) / (hits + misses);
+  }
+
+ private:
+  //! The results for one key.
+  struct Entry
+  {
+    std::string key;
+    arma::Col<size_t> neighbors;
+    arma::vec distances;
+  };
+
+  //! The entries, the most recently used first.
+  typedef std::list<Entry> EntryList;
+  //! The position of the entry of each key.
+  typedef std::unordered_map<std::string, typename EntryList::iterator> Index;
+
+  //! Compute the key of a query point.
+  template<typename VecType>
+  std::string Key(const VecType& query) const
+  {
+    std::string key;
+    if (quantum > 0.0)
+    {
+      key.resize(query.n_elem * sizeof(int64_t));
+      for (size_t i = 0; i < query.n_elem; ++i)
+      {
+        const int64_t cell = (int64_t) std::floor(query[i] / quantum);
+        std::memcpy(&key[i * sizeof(int64_t)], &cell, sizeof(int64_t));
+      }
+    }
+    else
+    {
+      key.resize(query.n_elem * sizeof(eT));
+      for (size_t i = 0; i < query.n_elem; ++i)
+      {
+        const eT value = query[i];
+        std::memcpy(&key[i * sizeof(eT)], &value, sizeof(eT));
+      }
+    }
+
+    return key;
+  }
+
+  //! Estimate the memory taken by an entry, including the list node and the
+  //! index node.
+  static size_t EntryMemory(const Entry& entry)
+  {
+    return sizeof(Entry) + 2 * entry.key.size() + 6 * sizeof(void*) +
+        entry.neighbors.n_elem * (sizeof(size_t) + sizeof(double));
+  }
+
+  //! Drop the least recently used entries until the budget is met.
+  void Evict()
+  {
+    while (!entries.empty() && memoryUsage > memoryBudget)
+    {
+      memoryUsage -= EntryMemory(entries.back());
+      index.erase(entries.back().key);
+      entries.pop_back();
+    }
+  }
+
+  //! Swap the contents of two caches.
+  void Swap(QueryCache& other)
+  {
+    std::swap(memoryBudget, other.memoryBudget);
+    std::swap(quantum, other.quantum);
+    entries.swap(other.entries);
+    index.swap(other.index);
+    std::swap(memoryUsage, other.memoryUsage);
+    std::swap(hits, other.hits);
+    std::swap(misses, other.misses);
+  }
+
+  //! The maximum memory the entries may take, in bytes.
+  size_t memoryBudget;
+  //! The width of the cells that share results (0 for exact keys).
+  double quantum;
+  //! The entries, the most recently used first.
+  EntryList entries;
+  //! The position of the entry of each key.
+  Index index;
+  //! The memory taken by the entries, in bytes.
+  size_t memoryUsage;
+  //! The number of lookups answered from the cache.
+  size_t hits;
+  //! The number of lookups not answered from the cache.
+  size_t misses;
+};
+
+} // namespace neighbor
+} // namespace mlpack
+
+#endif
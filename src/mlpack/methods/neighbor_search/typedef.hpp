@@ -43,21 +43,23 @@ typedef NeighborSearch<FurthestNeighborSort, metric::EuclideanDistance> KFN;
  * the k nearest neighbors found.
  * @tparam TreeType The tree type to use; must adhere to the TreeType API,
  *     and implement Defeatist Traversers.
+ * @tparam MatType The type of data matrix.
  */
 template<template<typename TreeMetricType,
                   typename TreeStatType,
-                  typename TreeMatType> class TreeType = tree::SPTree>
+                  typename TreeMatType> class TreeType = tree::SPTree,
+         typename MatType = arma::mat>
 using DefeatistKNN = NeighborSearch<
     NearestNeighborSort,
     metric::EuclideanDistance,
-    arma::mat,
+    MatType,
     TreeType,
     TreeType<metric::EuclideanDistance,
         NeighborSearchStat<NearestNeighborSort>,
-        arma::mat>::template DefeatistDualTreeTraverser,
+        MatType>::template DefeatistDualTreeTraverser,
     TreeType<metric::EuclideanDistance,
         NeighborSearchStat<NearestNeighborSort>,
-        arma::mat>::template DefeatistSingleTreeTraverser>;
+        MatType>::template DefeatistSingleTreeTraverser>;
 
 /**
  * The SpillKNN class is the k-nearest-neighbors method considering defeatist
@@ -82,6 +84,25 @@ typedef NeighborSearch<NearestNeighborSort, metric::EuclideanDistance> AllkNN;
  */
 typedef NeighborSearch<FurthestNeighborSort, metric::EuclideanDistance> AllkFN;
 
+/**
+ * Don't document these with doxygen; these declarations aren't helpful to
+ * users.
+ *
+ * @cond
+ */
+
+// KNN and KFN are compiled into the mlpack library (see neighbor_search.cpp),
+// so they are not instantiated again in every translation unit that uses them.
+extern template class NeighborSearch<NearestNeighborSort,
+                                     metric::EuclideanDistance>;
+
+extern template class NeighborSearch<FurthestNeighborSort,
+                                     metric::EuclideanDistance>;
+
+/**
+ * @endcond
+ */
+
 } // namespace neighbor
 } // namespace mlpack
 
@@ -24,6 +24,10 @@ namespace neighbor {
  * unmap the entries in each row of neighbors.  This is useful for the dual-tree
  * case.
  *
+ * The index types can be smaller than size_t (for instance arma::u32, for
+ * datasets with fewer than 2^32 points) to halve the memory used by the
+ * indices.  The columns are unmapped in parallel, if OpenMP is available.
+ *
  * @param neighbors Matrix of neighbors resulting from neighbor search.
  * @param distances Matrix of distances resulting from neighbor search.
  * @param referenceMap Mapping of reference set to old points.
@@ -32,11 +36,12 @@ namespace neighbor {
  * @param distancesOut Matrix to store unmapped distances into.
  * @param squareRoot If true, take the square root of the distances.
  */
-void Unmap(const arma::Mat<size_t>& neighbors,
+template<typename IndexType, typename MapIndexType>
+void Unmap(const arma::Mat<IndexType>& neighbors,
            const arma::mat& distances,
-           const std::vector<size_t>& referenceMap,
-           const std::vector<size_t>& queryMap,
-           arma::Mat<size_t>& neighborsOut,
+           const std::vector<MapIndexType>& referenceMap,
+           const std::vector<MapIndexType>& queryMap,
+           arma::Mat<IndexType>& neighborsOut,
            arma::mat& distancesOut,
            const bool squareRoot = false);
 
@@ -53,14 +58,35 @@ void Unmap(const arma::Mat<size_t>& neighbors,
  * @param distancesOut Matrix to store unmapped distances into.
  * @param squareRoot If true, take the square root of the distances.
  */
-void Unmap(const arma::Mat<size_t>& neighbors,
+template<typename IndexType, typename MapIndexType>
+void Unmap(const arma::Mat<IndexType>& neighbors,
            const arma::mat& distances,
-           const std::vector<size_t>& referenceMap,
-           arma::Mat<size_t>& neighborsOut,
+           const std::vector<MapIndexType>& referenceMap,
+           arma::Mat<IndexType>& neighborsOut,
            arma::mat& distancesOut,
            const bool squareRoot = false);
 
+/**
+ * Unmap the neighbors (and take the square root of the distances, if
+ * requested) in place, for the single-tree case, where only the reference set
+ * has been mapped.  No temporary matrix is needed, and the columns are
+ * unmapped in parallel, if OpenMP is available.
+ *
+ * @param neighbors Matrix of neighbors to unmap.
+ * @param distances Matrix of distances.
+ * @param referenceMap Mapping of reference set to old points.
+ * @param squareRoot If true, take the square root of the distances.
+ */
+template<typename IndexType, typename MapIndexType>
+void UnmapInPlace(arma::Mat<IndexType>& neighbors,
+                  arma::mat& distances,
+                  const std::vector<MapIndexType>& referenceMap,
+                  const bool squareRoot = false);
+
 } // namespace neighbor
 } // namespace mlpack
 
+// Include implementation.
+#include "unmap_impl.hpp"
+
 #endif
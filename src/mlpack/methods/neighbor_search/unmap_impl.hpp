@@ -0,0 +1,95 @@
+/**
+ * @file unmap_impl.hpp
+ * @author Ryan Curtin
+ *
+ * Auxiliary functions to unmap neighbor search results.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_NEIGHBOR_SEARCH_UNMAP_IMPL_HPP
+#define MLPACK_METHODS_NEIGHBOR_SEARCH_UNMAP_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "unmap.hpp"
+
+namespace mlpack {
+namespace neighbor {
+
+// Useful in the dual-tree setting.
+template<typename IndexType, typename MapIndexType>
+void Unmap(const arma::Mat<IndexType>& neighbors,
+           const arma::mat& distances,
+           const std::vector<MapIndexType>& referenceMap,
+           const std::vector<MapIndexType>& queryMap,
+           arma::Mat<IndexType>& neighborsOut,
+           arma::mat& distancesOut,
+           const bool squareRoot)
+{
+  // Set matrices to correct size.
+  neighborsOut.set_size(neighbors.n_rows, neighbors.n_cols);
+  distancesOut.set_size(distances.n_rows, distances.n_cols);
+
+  // Each column goes to a different place, so the columns can be unmapped in
+  // parallel.
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) distances.n_cols; ++i)
+  {
+    const size_t queryMapping = queryMap[i];
+
+    // Map columns to the correct place.  The ternary operator does not work
+    // here...
+    if (squareRoot)
+      distancesOut.col(queryMapping) = sqrt(distances.col(i));
+    else
+      distancesOut.col(queryMapping) = distances.col(i);
+
+    // Map indices of neighbors.
+    for (size_t j = 0; j < distances.n_rows; ++j)
+    {
+      neighborsOut(j, queryMapping) =
+          (IndexType) referenceMap[neighbors(j, i)];
+    }
+  }
+}
+
+// Useful in the single-tree setting.
+template<typename IndexType, typename MapIndexType>
+void Unmap(const arma::Mat<IndexType>& neighbors,
+           const arma::mat& distances,
+           const std::vector<MapIndexType>& referenceMap,
+           arma::Mat<IndexType>& neighborsOut,
+           arma::mat& distancesOut,
+           const bool squareRoot)
+{
+  neighborsOut = neighbors;
+  distancesOut = distances;
+  UnmapInPlace(neighborsOut, distancesOut, referenceMap, squareRoot);
+}
+
+// Useful in the single-tree setting, without a copy.
+template<typename IndexType, typename MapIndexType>
+void UnmapInPlace(arma::Mat<IndexType>& neighbors,
+                  arma::mat& distances,
+                  const std::vector<MapIndexType>& referenceMap,
+                  const bool squareRoot)
+{
+  // Take square root of distances, if necessary.
+  if (squareRoot)
+    distances = sqrt(distances);
+
+  // Map neighbors back to original locations.
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) neighbors.n_cols; ++i)
+  {
+    for (size_t j = 0; j < neighbors.n_rows; ++j)
+      neighbors(j, i) = (IndexType) referenceMap[neighbors(j, i)];
+  }
+}
+
+} // namespace neighbor
+} // namespace mlpack
+
+#endif
@@ -53,6 +53,12 @@ PROGRAM_INFO("Non-negative Matrix Factorization", "This program performs "
     "required for algorithm termination is specified with the " +
     PRINT_PARAM_STRING("min_residue") + " parameter."
     "\n\n"
+    "If the input matrix is mostly zeros (such as a term-document matrix), the "
+    + PRINT_PARAM_STRING("sparse") + " flag can be specified to convert it to "
+    "a sparse matrix before the factorization; the multiplicative update rules "
+    "then only use its nonzero entries, so no dense matrix of the size of the "
+    "input is allocated during the factorization."
+    "\n\n"
     "For example, to run NMF on the input matrix " + PRINT_DATASET("V") + " "
     "using the 'multdist' update rules with a rank-10 decomposition and "
     "storing the decomposed matrices into " + PRINT_DATASET("W") + " and " +
@@ -75,6 +81,46 @@ PARAM_DOUBLE_IN("min_residue", "The minimum root mean square residue allowed "
 
 PARAM_STRING_IN("update_rules", "Update rules for each iteration; ( multdist | "
     "multdiv | als ).", "u", "multdist");
+PARAM_FLAG("sparse", "If set, the input matrix is converted to a sparse "
+    "matrix before the factorization.", "");
+
+// Perform NMF of the given matrix with the given update rules.
+template<typename MatType>
+void ApplyFactorization(const MatType& V,
+                        const size_t r,
+                        const string& updateRules,
+                        const size_t maxIterations,
+                        const double minResidue,
+                        arma::mat& W,
+                        arma::mat& H)
+{
+  SimpleResidueTermination srt(minResidue, maxIterations);
+  if (updateRules == "multdist")
+  {
+    Log::Info << "Performing NMF with multiplicative distance-based update "
+        << "rules." << std::endl;
+    AMF<> amf(srt);
+    amf.Apply(V, r, W, H);
+  }
+  else if (updateRules == "multdiv")
+  {
+    Log::Info << "Performing NMF with multiplicative divergence-based update "
+        << "rules." << std::endl;
+    AMF<SimpleResidueTermination,
+        RandomInitialization,
+        NMFMultiplicativeDivergenceUpdate> amf(srt);
+    amf.Apply(V, r, W, H);
+  }
+  else if (updateRules == "als")
+  {
+    Log::Info << "Performing NMF with alternating least squared update rules."
+        << std::endl;
+    AMF<SimpleResidueTermination,
+        RandomInitialization,
+        NMFALSUpdate> amf(srt);
+    amf.Apply(V, r, W, H);
+  }
+}
 
 void mlpackMain()
 {
@@ -105,34 +151,19 @@ void mlpackMain()
   arma::mat H;
 
   // Perform NMF with the specified update rules.
-  if (updateRules == "multdist")
+  if (CLI::HasParam("sparse"))
   {
-    Log::Info << "Performing NMF with multiplicative distance-based update "
-        << "rules." << std::endl;
-
-    SimpleResidueTermination srt(minResidue, maxIterations);
-    AMF<> amf(srt);
-    amf.Apply(V, r, W, H);
+    // Free the dense matrix before the factorization.
+    const arma::sp_mat sparseV(V);
+    V.reset();
+    Log::Info << "Input matrix has " << sparseV.n_nonzero << " nonzero "
+        << "entries." << std::endl;
+    ApplyFactorization(sparseV, r, updateRules, maxIterations, minResidue, W,
+        H);
   }
-  else if (updateRules == "multdiv")
-  {
-    Log::Info << "Performing NMF with multiplicative divergence-based update "
-        << "rules." << std::endl;
-    SimpleResidueTermination srt(minResidue, maxIterations);
-    AMF<SimpleResidueTermination,
-        RandomInitialization,
-        NMFMultiplicativeDivergenceUpdate> amf(srt);
-    amf.Apply(V, r, W, H);
-  }
-  else if (updateRules == "als")
+  else
   {
-    Log::Info << "Performing NMF with alternating least squared update rules."
-        << std::endl;
-    SimpleResidueTermination srt(minResidue, maxIterations);
-    AMF<SimpleResidueTermination,
-        RandomInitialization,
-        NMFALSUpdate> amf(srt);
-    amf.Apply(V, r, W, H);
+    ApplyFactorization(V, r, updateRules, maxIterations, minResidue, W, H);
   }
 
   // Save results.
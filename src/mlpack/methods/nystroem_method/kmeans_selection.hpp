@@ -39,12 +39,12 @@ class KMeansSelection
    */
   const static arma::mat* Select(const arma::mat& data, const size_t m)
   {
-    arma::Row<size_t> assignments;
     arma::mat* centroids = new arma::mat;
 
-    // Perform the K-Means clustering method.
+    // Perform the K-Means clustering method.  Only the centroids are needed,
+    // so the final assignment of every point is not computed.
     ClusteringType kmeans(maxIterations);
-    kmeans.Cluster(data, m, assignments, *centroids);
+    kmeans.Cluster(data, m, *centroids);
 
     return centroids;
   }
@@ -16,6 +16,7 @@
 #define MLPACK_METHODS_NYSTROEM_METHOD_NYSTROEM_METHOD_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/core/kernels/kernel_matrix.hpp>
 #include "kmeans_selection.hpp"
 
 namespace mlpack {
@@ -40,12 +41,29 @@ class NystroemMethod
 
   /**
    * Apply the low-rank factorization to obtain an output matrix G such that
-   * K' = G * G^T.
+   * K' = G * G^T.  The selected points and the factorization of the
+   * mini-kernel matrix are kept, so that other points can then be mapped with
+   * Apply(points, output).
    *
    * @param output Matrix to store kernel approximation into.
    */
   void Apply(arma::mat& output);
 
+  /**
+   * Map new points with the factorization computed by the last call to
+   * Apply(output): each row of the output is the feature vector of a point,
+   * such that k(x, y) is approximated by the dot product of the feature
+   * vectors of x and y.  For the points of the dataset, this gives the same
+   * rows as Apply(output).  Only the kernel values between the new points and
+   * the selected points are computed.
+   *
+   * @param points Points to map.
+   * @param output Matrix to store the feature vectors into (one row for each
+   *     point).
+   * @throw std::logic_error if Apply(output) wasn't called first.
+   */
+  void Apply(const arma::mat& points, arma::mat& output) const;
+
   /**
    * Construct the kernel matrix with matrix that contains the selected points.
    *
@@ -75,6 +93,10 @@ class NystroemMethod
   KernelType& kernel;
   //! Rank used for matrix approximation.
   const size_t rank;
+  //! The selected points of the last call to Apply().
+  arma::mat selectedData;
+  //! The map from kernel values with the selected points to feature vectors.
+  arma::mat projection;
 };
 
 } // namespace kernel
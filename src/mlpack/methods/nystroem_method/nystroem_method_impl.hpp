@@ -31,24 +31,20 @@ NystroemMethod<KernelType, PointSelectionPolicy>::NystroemMethod(
 
 template<typename KernelType, typename PointSelectionPolicy>
 void NystroemMethod<KernelType, PointSelectionPolicy>::GetKernelMatrix(
-    const arma::mat* selectedData,
+    const arma::mat* points,
     arma::mat& miniKernel,
     arma::mat& semiKernel)
 {
+  // Keep the selected points to map other points later.
+  selectedData = *points;
+  delete points;
+
   // Assemble mini-kernel matrix.
-  for (size_t i = 0; i < rank; ++i)
-    for (size_t j = 0; j < rank; ++j)
-      miniKernel(i, j) = kernel.Evaluate(selectedData->col(i),
-                                         selectedData->col(j));
+  KernelMatrix(kernel, selectedData, miniKernel);
 
   // Construct semi-kernel matrix with interactions between selected data and
   // all points.
-  for (size_t i = 0; i < data.n_cols; ++i)
-    for (size_t j = 0; j < rank; ++j)
-      semiKernel(i, j) = kernel.Evaluate(data.col(i),
-                                         selectedData->col(j));
-  // Clean the memory.
-  delete selectedData;
+  KernelMatrix(kernel, data, selectedData, semiKernel);
 }
 
 template<typename KernelType, typename PointSelectionPolicy>
@@ -57,18 +53,15 @@ void NystroemMethod<KernelType, PointSelectionPolicy>::GetKernelMatrix(
     arma::mat& miniKernel,
     arma::mat& semiKernel)
 {
+  // Keep the selected points to map other points later.
+  selectedData = data.cols(selectedPoints);
+
   // Assemble mini-kernel matrix.
-  for (size_t i = 0; i < rank; ++i)
-    for (size_t j = 0; j < rank; ++j)
-      miniKernel(i, j) = kernel.Evaluate(data.col(selectedPoints(i)),
-                                         data.col(selectedPoints(j)));
+  KernelMatrix(kernel, selectedData, miniKernel);
 
   // Construct semi-kernel matrix with interactions between selected points and
   // all points.
-  for (size_t i = 0; i < data.n_cols; ++i)
-    for (size_t j = 0; j < rank; ++j)
-      semiKernel(i, j) = kernel.Evaluate(data.col(i),
-                                         data.col(selectedPoints(j)));
+  KernelMatrix(kernel, data, selectedData, semiKernel);
 }
 
 template<typename KernelType, typename PointSelectionPolicy>
@@ -85,9 +78,26 @@ void NystroemMethod<KernelType, PointSelectionPolicy>::Apply(arma::mat& output)
   arma::vec s;
   arma::svd(U, s, V, miniKernel);
 
-  // Construct the output matrix.
+  // Construct the output matrix, and keep the map for other points.
   arma::mat normalization = arma::diagmat(1.0 / sqrt(s));
-  output = semiKernel * U * normalization * V;
+  projection = U * normalization * V;
+  output = semiKernel * projection;
+}
+
+template<typename KernelType, typename PointSelectionPolicy>
+void NystroemMethod<KernelType, PointSelectionPolicy>::Apply(
+    const arma::mat& points,
+    arma::mat& output) const
+{
+  if (projection.is_empty())
+  {
+    throw std::logic_error("NystroemMethod::Apply(): Apply(output) must be "
+        "called before other points can be mapped");
+  }
+
+  arma::mat semiKernel;
+  KernelMatrix(kernel, points, selectedData, semiKernel);
+  output = semiKernel * projection;
 }
 
 } // namespace kernel
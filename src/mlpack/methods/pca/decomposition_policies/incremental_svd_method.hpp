@@ -0,0 +1,260 @@
+/**
+ * @file incremental_svd_method.hpp
+ *
+ * Implementation of the incremental SVD method for use in the Principal
+ * Components Analysis method.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_PCA_DECOMPOSITION_POLICIES_INCREMENTAL_SVD_METHOD_HPP
+#define MLPACK_METHODS_PCA_DECOMPOSITION_POLICIES_INCREMENTAL_SVD_METHOD_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace pca {
+
+/**
+ * Implementation of the incremental SVD policy.  The mean, the leading
+ * principal components and their singular values are updated with each new
+ * mini-batch of points, without revisiting the points that were seen before,
+ * using the rank-k update with mean correction described in the following
+ * paper:
+ *
+ * @code
+ * @article{ross2008incremental,
+ *   title={Incremental learning for robust visual tracking},
+ *   author={Ross, D.A. and Lim, J. and Lin, R.-S. and Yang, M.-H.},
+ *   journal={International Journal of Computer Vision},
+ *   volume={77},
+ *   number={1--3},
+ *   pages={125--141},
+ *   year={2008}
+ * }
+ * @endcode
+ *
+ * For a batch of m points, the thin SVD of the d x (k + m + 1) matrix
+ * [U diag(s), X - mean(X), c (mean(X) - mean)] is computed, so each update
+ * costs O(d (k + m)^2), and the memory used does not depend on the number of
+ * points seen.  When used as a policy of PCAType, the data is fed in batches
+ * of BatchSize() points.  To keep a model up to date as new data arrives,
+ * call Update() directly:
+ *
+ * @code
+ * IncrementalSVDPolicy ipca(10); // Keep 10 components.
+ * ipca.Update(firstBatch);
+ * ipca.Update(secondBatch);
+ *
+ * arma::vec eigVal;
+ * arma::mat eigvec, transformedData;
+ * ipca.EigenDecomposition(eigVal, eigvec);
+ * ipca.Transform(newPoints, transformedData);
+ * @endcode
+ *
+ * The results are exact if the number of components kept is at least the rank
+ * of the data seen so far; otherwise the discarded directions are lost, which
+ * is usually a good approximation when the spectrum decays quickly.
+ */
+class IncrementalSVDPolicy
+{
+ public:
+  /**
+   * Create the incremental SVD policy.
+   *
+   * @param rank Number of components to keep in Update() (0 keeps all of
+   *     them).
+   * @param batchSize Number of points in each update done by Apply().
+   */
+  IncrementalSVDPolicy(const size_t rank = 0,
+                       const size_t batchSize = 1000) :
+      rank(rank),
+      batchSize(batchSize),
+      numPoints(0)
+  {
+    /* Nothing to do here */
+  }
+
+  /**
+   * Apply Principal Component Analysis to the provided data set by feeding it
+   * to a new incremental decomposition in batches of BatchSize() points.  Any
+   * state from previous calls to Update() is discarded.  As in Update(), at
+   * most Rank() components are kept; the given rank is not used, since the
+   * discarded directions would make the variance of all the data unknown.
+   *
+   * @param data Data matrix.
+   * @param centeredData Centered data matrix.
+   * @param transformedData Matrix to put results of PCA into.
+   * @param eigVal Vector to put eigenvalues into.
+   * @param eigvec Matrix to put eigenvectors (loadings) into.
+   * @param rank Rank of the decomposition.
+   */
+  void Apply(const arma::mat& data,
+             const arma::mat& centeredData,
+             arma::mat& transformedData,
+             arma::vec& eigVal,
+             arma::mat& eigvec,
+             const size_t /* rank */)
+  {
+    Reset();
+
+    const size_t step = std::max(batchSize, (size_t) 1);
+    for (size_t i = 0; i < data.n_cols; i += step)
+    {
+      const size_t end = std::min(i + step, (size_t) data.n_cols) - 1;
+      Update(data.cols(i, end));
+    }
+
+    EigenDecomposition(eigVal, eigvec);
+
+    // Project the samples to the principals.
+    transformedData = arma::trans(eigvec) * centeredData;
+  }
+
+  /**
+   * Update the mean and the principal components with a new batch of points.
+   * At most Rank() components are kept (or all of them if Rank() is 0).
+   *
+   * @param batch New points; each column is a point.
+   */
+  void Update(const arma::mat& batch)
+  {
+    if (batch.n_cols == 0)
+      return;
+
+    if (numPoints > 0 && batch.n_rows != mean.n_elem)
+    {
+      Log::Fatal << "IncrementalSVDPolicy::Update(): batch dimensionality ("
+          << batch.n_rows << ") does not match dimensionality of previous "
+          << "points (" << mean.n_elem << ")!" << std::endl;
+    }
+
+    const double oldPoints = numPoints;
+    const double newPoints = numPoints + batch.n_cols;
+    const arma::vec batchMean = arma::mean(batch, 1);
+
+    // The scatter matrix of all the points is the scatter of the old points,
+    // plus the scatter of the batch, plus a term for the shift of the mean, so
+    // the new components are the left singular vectors of this matrix.
+    arma::mat m(batch.n_rows, components.n_cols + batch.n_cols +
+        (numPoints > 0 ? 1 : 0));
+    if (components.n_cols > 0)
+    {
+      m.cols(0, components.n_cols - 1) = components *
+          arma::diagmat(singularValues);
+    }
+    m.cols(components.n_cols, components.n_cols + batch.n_cols - 1) = batch;
+    m.cols(components.n_cols, components.n_cols + batch.n_cols - 1).each_col()
+        -= batchMean;
+    if (numPoints > 0)
+    {
+      m.col(m.n_cols - 1) = std::sqrt(oldPoints * batch.n_cols / newPoints) *
+          (batchMean - mean);
+      mean += (batch.n_cols / newPoints) * (batchMean - mean);
+    }
+    else
+    {
+      mean = batchMean;
+    }
+    numPoints += batch.n_cols;
+
+    arma::mat u, v;
+    arma::vec s;
+    arma::svd_econ(u, s, v, m, 'l');
+
+    const size_t newRank = (rank == 0) ? s.n_elem :
+        std::min(rank, (size_t) s.n_elem);
+    components = u.cols(0, newRank - 1);
+    singularValues = s.subvec(0, newRank - 1);
+  }
+
+  /**
+   * Get the current principal components and the eigenvalues of the
+   * covariance matrix of all the points seen so far.
+   *
+   * @param eigVal Vector to put eigenvalues into.
+   * @param eigvec Matrix to put eigenvectors (loadings) into.
+   */
+  void EigenDecomposition(arma::vec& eigVal, arma::mat& eigvec) const
+  {
+    eigvec = components;
+
+    // The covariance matrix is X * X' / (N - 1).
+    eigVal = arma::square(singularValues) / std::max(numPoints - 1.0, 1.0);
+  }
+
+  /**
+   * Project the given points onto the current principal components.
+   *
+   * @param data Points to project.
+   * @param transformedData Matrix to put the projected points into.
+   */
+  void Transform(const arma::mat& data, arma::mat& transformedData) const
+  {
+    arma::mat centeredData = data;
+    centeredData.each_col() -= mean;
+    transformedData = arma::trans(components) * centeredData;
+  }
+
+  //! Forget all the points seen so far.
+  void Reset()
+  {
+    mean.reset();
+    components.reset();
+    singularValues.reset();
+    numPoints = 0;
+  }
+
+  //! Get the number of components kept by Update().
+  size_t Rank() const { return rank; }
+  //! Modify the number of components kept by Update().
+  size_t& Rank() { return rank; }
+
+  //! Get the number of points in each update done by Apply().
+  size_t BatchSize() const { return batchSize; }
+  //! Modify the number of points in each update done by Apply().
+  size_t& BatchSize() { return batchSize; }
+
+  //! Get the number of points seen so far.
+  size_t NumPoints() const { return numPoints; }
+  //! Get the mean of the points seen so far.
+  const arma::vec& Mean() const { return mean; }
+  //! Get the current principal components.
+  const arma::mat& Components() const { return components; }
+  //! Get the singular values of the centered points seen so far.
+  const arma::vec& SingularValues() const { return singularValues; }
+
+  //! Serialize the state of the decomposition.
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */)
+  {
+    ar & BOOST_SERIALIZATION_NVP(rank);
+    ar & BOOST_SERIALIZATION_NVP(batchSize);
+    ar & BOOST_SERIALIZATION_NVP(numPoints);
+    ar & BOOST_SERIALIZATION_NVP(mean);
+    ar & BOOST_SERIALIZATION_NVP(components);
+    ar & BOOST_SERIALIZATION_NVP(singularValues);
+  }
+
+ private:
+  //! Number of components kept by Update().
+  size_t rank;
+  //! Number of points in each update done by Apply().
+  size_t batchSize;
+
+  //! Number of points seen so far.
+  size_t numPoints;
+  //! Mean of the points seen so far.
+  arma::vec mean;
+  //! Current principal components.
+  arma::mat components;
+  //! Singular values of the centered points seen so far.
+  arma::vec singularValues;
+};
+
+} // namespace pca
+} // namespace mlpack
+
+#endif
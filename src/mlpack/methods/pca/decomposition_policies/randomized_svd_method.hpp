@@ -77,6 +77,33 @@ class RandomizedSVDPolicy
     transformedData = arma::trans(eigvec) * centeredData;
   }
 
+  /**
+   * Compute the principal components of data that is too large to be held in
+   * memory, using the block-streaming randomized SVD; the data is read from
+   * the given block source (such as svd::BinaryFileBlockSource) in
+   * MaxIterations() + 2 passes.  The data is not transformed, since the
+   * transformed data would be as large as the data; the points can be
+   * projected block by block with eigvec.t() * (block - mean).
+   *
+   * @param source Block source to read the data from.
+   * @param eigVal Vector to put eigenvalues into.
+   * @param eigvec Matrix to put eigenvectors (loadings) into.
+   * @param rank Rank of the decomposition.
+   */
+  template<typename BlockSourceType>
+  void Apply(BlockSourceType& source,
+             arma::vec& eigVal,
+             arma::mat& eigvec,
+             const size_t rank)
+  {
+    svd::RandomizedSVD rsvd(iteratedPower, maxIterations);
+    rsvd.Apply(source, eigvec, eigVal, rank);
+
+    // Square the singular values to get the eigenvalues of the covariance
+    // matrix, as above.
+    eigVal %= eigVal / (source.NumCols() - 1);
+  }
+
   //! Get the size of the normalized power iterations.
   size_t IteratedPower() const { return iteratedPower; }
   //! Modify the size of the normalized power iterations.
@@ -106,6 +106,30 @@ class Perceptron
              const size_t numClasses,
              const arma::rowvec& instanceWeights = arma::rowvec());
 
+  /**
+   * Train the perceptron in parallel with iterative parameter mixing.  In each
+   * iteration, the dataset is split into one contiguous shard per OpenMP
+   * thread; each thread makes a pass through its shard, starting from the
+   * current weights and updating its own copy of them, and the weights and
+   * biases of all threads are then averaged.  Training stops when no point is
+   * misclassified during an iteration, or after the maximum number of
+   * iterations.  If the data is linearly separable, this converges, but the
+   * model may be different from the one that Train() would give.  Without
+   * OpenMP (or with one thread), this is the same as Train().
+   *
+   * Like Train(), this does not reset the model weights.
+   *
+   * @param data Dataset on which training should be performed.
+   * @param labels Labels of the dataset.
+   * @param numClasses Number of classes in the data.
+   * @param instanceWeights Cost matrix. Stores the cost of mispredicting
+   *      instances.  This is useful for boosting.
+   */
+  void ParallelTrain(const MatType& data,
+                     const arma::Row<size_t>& labels,
+                     const size_t numClasses,
+                     const arma::rowvec& instanceWeights = arma::rowvec());
+
   /**
    * Classification function. After training, use the weights matrix to
    * classify test, and put the predicted classes in predictedLabels.
@@ -154,6 +178,19 @@ class Perceptron
 
   //! The biases for each class.
   arma::vec biases;
+
+  /**
+   * Make a single pass through the points in [begin, end), updating the given
+   * weights and biases for every misclassified point.  The number of
+   * misclassified points is returned.
+   */
+  static size_t TrainingPass(const MatType& data,
+                             const arma::Row<size_t>& labels,
+                             const arma::rowvec& instanceWeights,
+                             const size_t begin,
+                             const size_t end,
+                             arma::mat& weights,
+                             arma::vec& biases);
 };
 
 } // namespace perceptron
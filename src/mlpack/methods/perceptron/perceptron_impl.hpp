@@ -14,6 +14,10 @@
 
 #include "perceptron.hpp"
 
+#ifdef HAS_OPENMP
+  #include <omp.h>
+#endif
+
 namespace mlpack {
 namespace perceptron {
 
@@ -106,15 +110,18 @@ void Perceptron<LearnPolicy, WeightInitializationPolicy, MatType>::Classify(
     const MatType& test,
     arma::Row<size_t>& predictedLabels)
 {
-  arma::vec tempLabelMat;
-  arma::uword maxIndex = 0;
+  // Compute the scores of all the points at once, with a single matrix
+  // multiplication.
+  arma::mat scores = weights.t() * test;
+  scores.each_col() += biases;
 
-  // Could probably be faster if done in batch.
-  for (size_t i = 0; i < test.n_cols; i++)
+  predictedLabels.set_size(test.n_cols);
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) test.n_cols; i++)
   {
-    tempLabelMat = weights.t() * test.col(i) + biases;
-    tempLabelMat.max(maxIndex);
-    predictedLabels(0, i) = maxIndex;
+    arma::uword maxIndex = 0;
+    scores.unsafe_col(i).max(maxIndex);
+    predictedLabels[i] = maxIndex;
   }
 }
 
@@ -145,51 +152,145 @@ void Perceptron<LearnPolicy, WeightInitializationPolicy, MatType>::Train(
     wip.Initialize(weights, biases, data.n_rows, numClasses);
   }
 
-  size_t j, i = 0;
+  size_t i = 0;
   bool converged = false;
-  size_t tempLabel;
-  arma::uword maxIndexRow, maxIndexCol;
-  arma::mat tempLabelMat;
+  while ((i < maxIterations) && (!converged))
+  {
+    // Each iteration is a single pass through the dataset; we have converged
+    // if no point was misclassified.
+    i++;
+    converged = (TrainingPass(data, labels, instanceWeights, 0, data.n_cols,
+        weights, biases) == 0);
+  }
+}
 
-  LearnPolicy LP;
+/**
+ * Parallel training function, with iterative parameter mixing: the weights
+ * found by each thread on its shard of the data are averaged after every pass.
+ */
+template<
+    typename LearnPolicy,
+    typename WeightInitializationPolicy,
+    typename MatType
+>
+void Perceptron<LearnPolicy, WeightInitializationPolicy, MatType>::
+ParallelTrain(const MatType& data,
+              const arma::Row<size_t>& labels,
+              const size_t numClasses,
+              const arma::rowvec& instanceWeights)
+{
+#ifdef HAS_OPENMP
+  const size_t numThreads = std::min((size_t) omp_get_max_threads(),
+      (size_t) data.n_cols);
+#else
+  const size_t numThreads = 1;
+#endif
+  if (numThreads <= 1)
+  {
+    Train(data, labels, numClasses, instanceWeights);
+    return;
+  }
 
-  const bool hasWeights = (instanceWeights.n_elem > 0);
+  // Do we need to resize the weights?
+  if (weights.n_elem != numClasses)
+  {
+    WeightInitializationPolicy wip;
+    wip.Initialize(weights, biases, data.n_rows, numClasses);
+  }
+
+  std::vector<arma::mat> threadWeights(numThreads);
+  std::vector<arma::vec> threadBiases(numThreads);
 
+  size_t i = 0;
+  bool converged = false;
   while ((i < maxIterations) && (!converged))
   {
-    // This outer loop is for each iteration, and we use the 'converged'
-    // variable for noting whether or not convergence has been reached.
     i++;
-    converged = true;
 
-    // Now this inner loop is for going through the dataset in each iteration.
-    for (j = 0; j < data.n_cols; j++)
+    size_t mistakes = 0;
+    #pragma omp parallel for reduction(+:mistakes)
+    for (omp_size_t t = 0; t < (omp_size_t) numThreads; ++t)
     {
-      // Multiply for each variable and check whether the current weight vector
-      // correctly classifies this.
-      tempLabelMat = weights.t() * data.col(j) + biases;
+      const size_t begin = t * data.n_cols / numThreads;
+      const size_t end = (t + 1) * data.n_cols / numThreads;
 
-      tempLabelMat.max(maxIndexRow, maxIndexCol);
+      threadWeights[t] = weights;
+      threadBiases[t] = biases;
+      mistakes += TrainingPass(data, labels, instanceWeights, begin, end,
+          threadWeights[t], threadBiases[t]);
+    }
 
-      // Check whether prediction is correct.
-      if (maxIndexRow != labels(0, j))
+    // If no thread misclassified any point, the weights of every thread are
+    // the same as before, and so is their average.
+    converged = (mistakes == 0);
+    if (!converged)
+    {
+      weights = threadWeights[0];
+      biases = threadBiases[0];
+      for (size_t t = 1; t < numThreads; ++t)
       {
-        // Due to incorrect prediction, convergence set to false.
-        converged = false;
-        tempLabel = labels(0, j);
-
-        // Send maxIndexRow for knowing which weight to update, send j to know
-        // the value of the vector to update it with.  Send tempLabel to know
-        // the correct class.
-        if (hasWeights)
-          LP.UpdateWeights(data.col(j), weights, biases, maxIndexRow, tempLabel,
-              instanceWeights(j));
-        else
-          LP.UpdateWeights(data.col(j), weights, biases, maxIndexRow,
-              tempLabel);
+        weights += threadWeights[t];
+        biases += threadBiases[t];
       }
+      weights /= numThreads;
+      biases /= numThreads;
+    }
+  }
+}
+
+/**
+ * Make a single pass through the given range of points, and update the weights
+ * and biases for every misclassified point.
+ */
+template<
+    typename LearnPolicy,
+    typename WeightInitializationPolicy,
+    typename MatType
+>
+size_t Perceptron<LearnPolicy, WeightInitializationPolicy, MatType>::
+TrainingPass(const MatType& data,
+             const arma::Row<size_t>& labels,
+             const arma::rowvec& instanceWeights,
+             const size_t begin,
+             const size_t end,
+             arma::mat& weights,
+             arma::vec& biases)
+{
+  size_t mistakes = 0;
+  arma::uword maxIndexRow, maxIndexCol;
+  arma::mat tempLabelMat;
+
+  LearnPolicy LP;
+
+  const bool hasWeights = (instanceWeights.n_elem > 0);
+
+  for (size_t j = begin; j < end; j++)
+  {
+    // Multiply for each variable and check whether the current weight vector
+    // correctly classifies this.
+    tempLabelMat = weights.t() * data.col(j) + biases;
+
+    tempLabelMat.max(maxIndexRow, maxIndexCol);
+
+    // Check whether prediction is correct.
+    if (maxIndexRow != labels(0, j))
+    {
+      ++mistakes;
+      const size_t tempLabel = labels(0, j);
+
+      // Send maxIndexRow for knowing which weight to update, send j to know
+      // the value of the vector to update it with.  Send tempLabel to know
+      // the correct class.
+      if (hasWeights)
+        LP.UpdateWeights(data.col(j), weights, biases, maxIndexRow, tempLabel,
+            instanceWeights(j));
+      else
+        LP.UpdateWeights(data.col(j), weights, biases, maxIndexRow,
+            tempLabel);
     }
   }
+
+  return mistakes;
 }
 
 //! Serialize the perceptron.
@@ -12,6 +12,7 @@
 #include <mlpack/prereqs.hpp>
 #include <mlpack/core/util/cli.hpp>
 #include <mlpack/core/util/mlpack_main.hpp>
+#include <mlpack/core/data/describe_statistics.hpp>
 
 #include <boost/format.hpp>
 #include <boost/lexical_cast.hpp>
@@ -63,82 +64,28 @@ PARAM_FLAG("row_major", "If specified, the program will calculate statistics "
     "represents a point, so this option is generally not necessary.)", "r");
 
 /**
- * Calculates the sum of deviations to the Nth Power.
+ * Calculates the median of the given vector by selection, which takes linear
+ * time.
  *
  * @param input Vector that captures a dimension of a dataset.
- * @param rowMean Mean of the given vector.
- * @param n Degree of power.
- * @return sum of nth power deviations.
+ * @return Median of the given vector.
  */
-double SumNthPowerDeviations(const arma::rowvec& input,
-                             const double& fMean,
-                             size_t n)
+double Median(const arma::rowvec& input)
 {
-  return arma::sum(arma::pow(input - fMean, static_cast<double>(n)));
-}
-
-/**
- * Calculates Skewness of the given vector.
- *
- * @param input Vector that captures a dimension of a dataset
- * @param rowStd Standard Deviation of the given vector.
- * @param rowMean Mean of the given vector.
- * @return Skewness of the given vector.
- */
-double Skewness(const arma::rowvec& input,
-                const double& fStd,
-                const double& fMean,
-                const bool population)
-{
-  double skewness = 0;
-  const double S3 = pow(fStd, 3);
-  const double M3 = SumNthPowerDeviations(input, fMean, 3);
-  const double n = input.n_elem;
-  if (population)
-  {
-    // Calculate population skewness
-    skewness = M3 / (n * S3);
-  }
-  else
-  {
-    // Calculate sample skewness.
-    skewness = n * M3 / ((n - 1) * (n - 2) * S3);
-  }
-  return skewness;
-}
-
-/**
- * Calculates excess kurtosis of the given vector.
- *
- * @param input Vector that captures a dimension of a dataset
- * @param rowStd Standard Deviation of the given vector.
- * @param rowMean Mean of the given vector.
- * @return Kurtosis of the given vector.
- */
-double Kurtosis(const arma::rowvec& input,
-                const double& fStd,
-                const double& fMean,
-                const bool population)
-{
-  double kurtosis = 0;
-  const double M4 = SumNthPowerDeviations(input, fMean, 4);
-  const double n = input.n_elem;
-  if (population)
-  {
-    // Calculate population excess kurtosis.
-    const double M2 = SumNthPowerDeviations(input, fMean, 2);
-    kurtosis = n * (M4 / pow(M2, 2)) - 3;
-  }
-  else
-  {
-    // Calculate sample excess kurtosis.
-    const double S4 = pow(fStd, 4);
-    const double norm3 = (3 * (n - 1) * (n - 1)) / ((n - 2) * (n - 3));
-    const double normC = (n * (n + 1)) / ((n - 1) * (n - 2) * (n - 3));
-    const double normM = M4 / S4;
-    kurtosis = normC * normM - norm3;
-  }
-  return kurtosis;
+  std::vector<double> values(input.begin(), input.end());
+  if (values.empty())
+    return arma::datum::nan;
+
+  const size_t middle = values.size() / 2;
+  std::nth_element(values.begin(), values.begin() + middle, values.end());
+  if (values.size() % 2 == 1)
+    return values[middle];
+
+  // With an even number of values, the median is the mean of the two middle
+  // ones, and the smaller one is the largest of the values before the middle.
+  const double lower = *std::max_element(values.begin(),
+      values.begin() + middle);
+  return (lower + values[middle]) / 2.0;
 }
 
 /**
@@ -184,50 +131,53 @@ void mlpackMain()
       % "dim" % "var" % "mean" % "std" % "median" % "min" % "max"
       % "range" % "skew" % "kurt" % "SE" << endl;
 
-  // Lambda function to print out the results.
-  auto PrintStatResults = [&](size_t dim, bool rowMajor)
+  // If the user specified dimension, describe statistics of the given
+  // dimension. If a dimension is not specified, describe all dimensions.
+  // The dimensions to describe are the rows of features.
+  const bool oneDimension = CLI::HasParam("dimension");
+  arma::mat selected;
+  if (oneDimension && rowMajor)
+    selected = data.col(dimension).t();
+  else if (oneDimension)
+    selected = data.row(dimension);
+  else if (rowMajor)
+    selected = data.t();
+  const arma::mat& features = (oneDimension || rowMajor) ? selected : data;
+
+  // All the statistics but the median are computed in one pass over the data.
+  DescribeStatistics statistics(features.n_rows);
+  statistics.Update(features);
+
+  arma::vec medians(features.n_rows);
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t i = 0; i < (omp_size_t) features.n_rows; ++i)
+    medians[i] = Median(features.row(i));
+
+  const arma::vec variances = statistics.Variance(population);
+  const arma::vec stds = statistics.StandardDeviation(population);
+  const arma::vec skewnesses = statistics.Skewness(population);
+  const arma::vec kurtoses = statistics.Kurtosis(population);
+
+  for (size_t i = 0; i < features.n_rows; ++i)
   {
-    arma::rowvec feature;
-    if (rowMajor)
-      feature = arma::conv_to<arma::rowvec>::from(data.col(dim));
-    else
-      feature = data.row(dim);
-
     // f at the front of the variable names means "feature".
-    const double fMax = arma::max(feature);
-    const double fMin = arma::min(feature);
-    const double fMean = arma::mean(feature);
-    const double fStd = arma::stddev(feature, population);
+    const double fMax = statistics.Max()[i];
+    const double fMin = statistics.Min()[i];
 
     // Print statistics of the given dimension.
     Log::Info << boost::format(numberFormat)
-        % dim
-        % arma::var(feature, population)
-        % fMean
-        % fStd
-        % arma::median(feature)
+        % (oneDimension ? dimension : i)
+        % variances[i]
+        % statistics.Mean()[i]
+        % stds[i]
+        % medians[i]
         % fMin
         % fMax
         % (fMax - fMin) // range
-        % Skewness(feature, fStd, fMean, population)
-        % Kurtosis(feature, fStd, fMean, population)
-        % StandardError(feature.n_elem, fStd)
+        % skewnesses[i]
+        % kurtoses[i]
+        % StandardError(statistics.Count(), stds[i])
         << endl;
-  };
-
-  // If the user specified dimension, describe statistics of the given
-  // dimension. If a dimension is not specified, describe all dimensions.
-  if (CLI::HasParam("dimension"))
-  {
-    PrintStatResults(dimension, rowMajor);
-  }
-  else
-  {
-    const size_t dimensions = rowMajor ? data.n_cols : data.n_rows;
-    for (size_t i = 0; i < dimensions; ++i)
-    {
-      PrintStatResults(i, rowMajor);
-    }
   }
   Timer::Stop("statistics");
 }
@@ -0,0 +1,111 @@
+/**
+ * @file preprocess_encode_main.cpp
+ *
+ * A CLI executable to encode the categorical dimensions of a dataset into a
+ * sparse matrix, with one-hot encoding or the hashing trick.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/data/load.hpp>
+#include <mlpack/core/util/cli.hpp>
+#include <mlpack/core/util/mlpack_main.hpp>
+#include <mlpack/core/data/one_hot_encoding.hpp>
+#include <mlpack/core/data/feature_hasher.hpp>
+
+PROGRAM_INFO("Encode Data", "This utility takes a dataset with categorical "
+    "dimensions (such as an ARFF file, or a CSV file with strings) and encodes "
+    "it into a sparse matrix, which is saved in coordinate format (one line "
+    "per nonzero value, with its dimension, its point and its value) to the "
+    "file given with --output_file (-o)."
+    "\n\n"
+    "With the 'one_hot' method (the default), each categorical dimension is "
+    "replaced by one dimension per category, which is 1 for the points of "
+    "that category and 0 otherwise; numeric dimensions are kept as they are.  "
+    "With the 'hash' method, the categories and the numeric dimensions are "
+    "hashed into --num_features (-n) dimensions (the hashing trick), so the "
+    "dimensionality does not depend on the number of categories, and datasets "
+    "with different categories are encoded consistently.  By default the "
+    "values are added with a sign given by the hash, so that collisions cancel "
+    "out on average; --no_alternate_sign (-N) disables that."
+    "\n\n"
+    "For example, to one-hot encode the dataset in dataset.arff and save the "
+    "result to encoded.txt, we could run"
+    "\n\n"
+    "$ mlpack_preprocess_encode -i dataset.arff -o encoded.txt"
+    "\n\n"
+    "and to hash it into 4096 dimensions instead, we could run"
+    "\n\n"
+    "$ mlpack_preprocess_encode -i dataset.arff -o encoded.txt -m hash "
+    "-n 4096");
+
+PARAM_STRING_IN_REQ("input_file", "File containing data.", "i");
+PARAM_STRING_OUT("output_file", "File to save the encoded sparse matrix into "
+    "(in coordinate format).", "o");
+PARAM_STRING_IN("method", "Encoding method: 'one_hot' or 'hash'.", "m",
+    "one_hot");
+PARAM_INT_IN("num_features", "Number of output dimensions for the 'hash' "
+    "method.", "n", 1048576);
+PARAM_FLAG("no_alternate_sign", "Add the hashed values without the sign given "
+    "by the hash.", "N");
+
+using namespace mlpack;
+using namespace mlpack::util;
+using namespace arma;
+using namespace std;
+using namespace data;
+
+void mlpackMain()
+{
+  const string inputFile = CLI::GetParam<string>("input_file");
+  const string outputFile = CLI::GetParam<string>("output_file");
+  const string method = CLI::GetParam<string>("method");
+
+  RequireParamInSet<string>("method", { "one_hot", "hash" }, true,
+      "unknown encoding method");
+  RequireAtLeastOnePassed({ "output_file" }, false, "no output will be saved");
+
+  if (method == "hash")
+  {
+    RequireParamValue<int>("num_features", [](int x) { return x > 0; }, true,
+        "number of features must be positive");
+  }
+  else
+  {
+    ReportIgnoredParam("num_features", "not using the 'hash' method");
+    ReportIgnoredParam("no_alternate_sign", "not using the 'hash' method");
+  }
+
+  arma::mat input;
+  DatasetInfo info;
+  data::Load(inputFile, input, info, true);
+
+  Timer::Start("encoding");
+  arma::sp_mat output;
+  if (method == "one_hot")
+  {
+    OneHotEncoding(input, info, output);
+  }
+  else
+  {
+    FeatureHasher hasher((size_t) CLI::GetParam<int>("num_features"),
+        !CLI::HasParam("no_alternate_sign"));
+    hasher.Transform(input, info, output);
+  }
+  Timer::Stop("encoding");
+
+  Log::Info << "Encoded " << input.n_cols << " points into " << output.n_rows
+      << " dimensions, with " << output.n_nonzero << " nonzero values."
+      << endl;
+
+  if (!outputFile.empty())
+  {
+    Log::Info << "Saving encoded data to '" << outputFile << "'." << endl;
+    if (!output.save(outputFile, arma::coord_ascii))
+      Log::Fatal << "Cannot save encoded data to '" << outputFile << "'!"
+          << endl;
+  }
+}
@@ -48,10 +48,24 @@ PROGRAM_INFO("Split Data", "This utility takes a dataset and optionally labels "
     "\n\n" +
     PRINT_CALL("preprocess_split", "input", "X", "input_labels", "y",
         "test_ratio", 0.3, "training", "X_train", "training_labels", "y_train",
-        "test", "X_test", "test_labels", "y_test"));
+        "test", "X_test", "test_labels", "y_test") +
+    "\n\n"
+    "With the " + PRINT_PARAM_STRING("stratify") + " flag, the labels are "
+    "split so that each label has the same proportion of its points in the "
+    "test set, which is useful when some labels are rare."
+    "\n\n"
+    "A dataset too large to fit in memory can be split by giving the name of "
+    "its file with " + PRINT_PARAM_STRING("input_file") + " instead of " +
+    PRINT_PARAM_STRING("input") + "; it is then read " +
+    PRINT_PARAM_STRING("chunk_size") + " points at a time, and the training "
+    "and test points are written as they are read to the files given with " +
+    PRINT_PARAM_STRING("training_file") + " and " +
+    PRINT_PARAM_STRING("test_file") + " (which must be csv, tsv or txt "
+    "files).  In that case the points keep their order, and labels can be "
+    "split along with the points by storing them in the last dimension.");
 
 // Define parameters for data.
-PARAM_MATRIX_IN_REQ("input", "Matrix containing data.", "i");
+PARAM_MATRIX_IN("input", "Matrix containing data.", "i");
 PARAM_MATRIX_OUT("training", "Matrix to save training data to.", "t");
 PARAM_MATRIX_OUT("test", "Matrix to save test data to.", "T");
 
@@ -66,6 +80,19 @@ PARAM_DOUBLE_IN("test_ratio", "Ratio of test set; if not set,"
 
 PARAM_INT_IN("seed", "Random seed (0 for std::time(NULL)).", "s", 0);
 
+PARAM_FLAG("stratify", "Split the labels so that each label has the same "
+    "proportion of its points in the test set.", "S");
+
+// Define parameters for splitting a file a chunk at a time.
+PARAM_STRING_IN("input_file", "File containing data, to be read a chunk at a "
+    "time.", "f", "");
+PARAM_STRING_IN("training_file", "File to write training data to, when "
+    "--input_file is given.", "F", "");
+PARAM_STRING_IN("test_file", "File to write test data to, when --input_file "
+    "is given.", "E", "");
+PARAM_INT_IN("chunk_size", "Number of points read at a time from the input "
+    "file.", "c", 10000);
+
 using namespace mlpack;
 using namespace mlpack::util;
 using namespace arma;
@@ -81,6 +108,39 @@ void mlpackMain()
   else
     mlpack::math::RandomSeed((size_t) CLI::GetParam<int>("seed"));
 
+  RequireOnlyOnePassed({ "input", "input_file" }, true);
+
+  // Check test_ratio.
+  RequireParamValue<double>("test_ratio",
+      [](double x) { return x >= 0.0 && x <= 1.0; }, true,
+      "test ratio must be between 0.0 and 1.0");
+
+  // Split the input file a chunk at a time if one was given.
+  if (CLI::HasParam("input_file"))
+  {
+    RequireAtLeastOnePassed({ "training_file" }, true);
+    RequireAtLeastOnePassed({ "test_file" }, true);
+    RequireParamValue<int>("chunk_size", [](int x) { return x > 0; }, true,
+        "chunk size must be positive");
+    ReportIgnoredParam({{ "input_file", true }}, "input_labels");
+    ReportIgnoredParam({{ "input_file", true }}, "stratify");
+
+    data::StreamingDataset<double> input(
+        CLI::GetParam<string>("input_file"),
+        (size_t) CLI::GetParam<int>("chunk_size"));
+    data::Split(input, CLI::GetParam<string>("training_file"),
+        CLI::GetParam<string>("test_file"), testRatio);
+
+    const size_t testSize = (size_t) (input.NumPoints() * testRatio);
+    Log::Info << "Training data contains " << input.NumPoints() - testSize
+        << " points." << endl;
+    Log::Info << "Test data contains " << testSize << " points." << endl;
+    return;
+  }
+
+  ReportIgnoredParam({{ "input", true }}, "training_file");
+  ReportIgnoredParam({{ "input", true }}, "test_file");
+
   // Make sure the user specified output filenames.
   RequireAtLeastOnePassed({ "training" }, false, "no training set will be "
       "saved");
@@ -98,13 +158,9 @@ void mlpackMain()
   {
     ReportIgnoredParam({{ "input_labels", true }}, "training_labels");
     ReportIgnoredParam({{ "input_labels", true }}, "test_labels");
+    ReportIgnoredParam({{ "input_labels", false }}, "stratify");
   }
 
-  // Check test_ratio.
-  RequireParamValue<double>("test_ratio",
-      [](double x) { return x >= 0.0 && x <= 1.0; }, true,
-      "test ratio must be between 0.0 and 1.0");
-
   if (!CLI::HasParam("test_ratio")) // If test_ratio is not set, warn the user.
   {
     Log::Warn << "You did not specify " << PRINT_PARAM_STRING("test_ratio")
@@ -121,7 +177,9 @@ void mlpackMain()
         CLI::GetParam<arma::Mat<size_t>>("input_labels");
     arma::Row<size_t> labelsRow = labels.row(0);
 
-    const auto value = data::Split(data, labelsRow, testRatio);
+    const auto value = CLI::HasParam("stratify") ?
+        data::StratifiedSplit(data, labelsRow, testRatio) :
+        data::Split(data, labelsRow, testRatio);
     Log::Info << "Training data contains " << get<0>(value).n_cols << " points."
         << endl;
     Log::Info << "Test data contains " << get<1>(value).n_cols << " points."
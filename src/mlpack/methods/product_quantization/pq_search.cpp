@@ -0,0 +1,159 @@
+/**
+ * @file pq_search.cpp
+ *
+ * Implementation of the PQSearch class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "pq_search.hpp"
+
+#include <queue>
+
+namespace mlpack {
+namespace neighbor {
+
+PQSearch::PQSearch(const arma::mat& referenceSet,
+                   const ProductQuantizer& quantizer)
+{
+  Train(referenceSet, quantizer);
+}
+
+void PQSearch::Train(const arma::mat& referenceSet,
+                     const ProductQuantizer& quantizer)
+{
+  this->quantizer = quantizer;
+  if (this->quantizer.Dimensionality() == 0)
+    this->quantizer.Train(referenceSet);
+
+  this->quantizer.Encode(referenceSet, codes);
+}
+
+void PQSearch::Search(const arma::mat& querySet,
+                      const size_t k,
+                      arma::Mat<size_t>& neighbors,
+                      arma::mat& distances) const
+{
+  CheckQueries(querySet, k);
+
+  neighbors.set_size(k, querySet.n_cols);
+  distances.set_size(k, querySet.n_cols);
+  if (k == 0)
+    return;
+
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t i = 0; i < (omp_size_t) querySet.n_cols; ++i)
+  {
+    arma::mat table;
+    quantizer.DistanceTable(querySet.col(i), table);
+
+    // The k best points so far, farthest first.
+    std::priority_queue<std::pair<double, size_t>> best;
+    for (size_t j = 0; j < codes.n_cols; ++j)
+    {
+      const double distance = ProductQuantizer::Distance(table,
+          codes.colptr(j));
+      if (best.size() < k)
+        best.push(std::make_pair(distance, j));
+      else if (distance < best.top().first)
+      {
+        best.pop();
+        best.push(std::make_pair(distance, j));
+      }
+    }
+
+    for (size_t j = k; j > 0; --j)
+    {
+      neighbors(j - 1, i) = best.top().second;
+      distances(j - 1, i) = std::sqrt(best.top().first);
+      best.pop();
+    }
+  }
+}
+
+void PQSearch::Search(const arma::mat& querySet,
+                      const arma::Mat<size_t>& candidates,
+                      const size_t k,
+                      arma::Mat<size_t>& neighbors,
+                      arma::mat& distances) const
+{
+  CheckQueries(querySet, k);
+
+  if (candidates.n_cols != querySet.n_cols)
+  {
+    std::ostringstream oss;
+    oss << "PQSearch::Search(): number of candidate lists ("
+        << candidates.n_cols << ") is not equal to the number of queries ("
+        << querySet.n_cols << ")!" << std::endl;
+    throw std::invalid_argument(oss.str());
+  }
+
+  neighbors.set_size(k, querySet.n_cols);
+  distances.set_size(k, querySet.n_cols);
+  if (k == 0)
+    return;
+
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t i = 0; i < (omp_size_t) querySet.n_cols; ++i)
+  {
+    arma::mat table;
+    quantizer.DistanceTable(querySet.col(i), table);
+
+    std::vector<std::pair<double, size_t>> ranked;
+    ranked.reserve(candidates.n_rows);
+    for (size_t j = 0; j < candidates.n_rows; ++j)
+    {
+      const size_t candidate = candidates(j, i);
+      if (candidate >= codes.n_cols)
+        continue;
+
+      ranked.push_back(std::make_pair(ProductQuantizer::Distance(table,
+          codes.colptr(candidate)), candidate));
+    }
+
+    // Candidate lists may hold the same point more than once.
+    std::sort(ranked.begin(), ranked.end());
+    ranked.erase(std::unique(ranked.begin(), ranked.end()), ranked.end());
+
+    for (size_t j = 0; j < k; ++j)
+    {
+      if (j < ranked.size())
+      {
+        neighbors(j, i) = ranked[j].second;
+        distances(j, i) = std::sqrt(ranked[j].first);
+      }
+      else
+      {
+        neighbors(j, i) = codes.n_cols;
+        distances(j, i) = DBL_MAX;
+      }
+    }
+  }
+}
+
+void PQSearch::CheckQueries(const arma::mat& querySet, const size_t k) const
+{
+  if (querySet.n_rows != quantizer.Dimensionality())
+  {
+    std::ostringstream oss;
+    oss << "PQSearch::Search(): dimensionality of query set ("
+        << querySet.n_rows << ") is not equal to the dimensionality the model "
+        << "was trained on (" << quantizer.Dimensionality() << ")!"
+        << std::endl;
+    throw std::invalid_argument(oss.str());
+  }
+
+  if (k > codes.n_cols)
+  {
+    std::ostringstream oss;
+    oss << "PQSearch::Search(): requested " << k << " approximate nearest "
+        << "neighbors, but reference set has " << codes.n_cols << " points!"
+        << std::endl;
+    throw std::invalid_argument(oss.str());
+  }
+}
+
+} // namespace neighbor
+} // namespace mlpack
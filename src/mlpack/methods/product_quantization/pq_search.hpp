@@ -0,0 +1,140 @@
+/**
+ * @file pq_search.hpp
+ *
+ * Approximate nearest neighbor search over points compressed with a product
+ * quantizer.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_PRODUCT_QUANTIZATION_PQ_SEARCH_HPP
+#define MLPACK_METHODS_PRODUCT_QUANTIZATION_PQ_SEARCH_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include "product_quantizer.hpp"
+
+namespace mlpack {
+namespace neighbor {
+
+/**
+ * The PQSearch class encodes a reference set with a ProductQuantizer and only
+ * keeps the codes, so that each reference point takes NumSubspaces() bytes
+ * instead of 8 bytes per dimension.  Queries are not encoded: the distances
+ * between a query and the centroids are computed once, and the distance to
+ * each reference point is then the sum of NumSubspaces() table entries.
+ *
+ * The search can scan every code, or only the candidates found by another
+ * method (for instance the neighbors returned by LSHSearch or a tree search
+ * with a larger k), which re-ranks the candidates without the original
+ * reference points:
+ *
+ * @code
+ * LSHSearch<> lsh(referenceSet);
+ * arma::Mat<size_t> candidates;
+ * arma::mat candidateDistances;
+ * lsh.Search(querySet, 100, candidates, candidateDistances);
+ *
+ * PQSearch pq(referenceSet, ProductQuantizer(16, 256));
+ * pq.Search(querySet, candidates, 10, neighbors, distances);
+ * @endcode
+ *
+ * All distances are approximate Euclidean distances.
+ */
+class PQSearch
+{
+ public:
+  /**
+   * Encode the given reference set.  If the given quantizer is not trained
+   * yet, it is trained on the reference set first.  The reference set is not
+   * kept.
+   *
+   * @param referenceSet Set of reference points.
+   * @param quantizer Product quantizer, trained or not.
+   */
+  PQSearch(const arma::mat& referenceSet,
+           const ProductQuantizer& quantizer = ProductQuantizer());
+
+  /**
+   * Create an empty PQSearch object.  Train() must be called before Search().
+   */
+  PQSearch() { }
+
+  /**
+   * Encode the given reference set, replacing the existing codes.  If the
+   * given quantizer is not trained yet, it is trained on the reference set
+   * first.
+   *
+   * @param referenceSet Set of reference points.
+   * @param quantizer Product quantizer, trained or not.
+   */
+  void Train(const arma::mat& referenceSet,
+             const ProductQuantizer& quantizer = ProductQuantizer());
+
+  /**
+   * Compute the approximate nearest neighbors of the given queries by scanning
+   * every code.  The matrices will be set to the size of k by n, where n is
+   * the number of queries.
+   *
+   * @param querySet Set of query points.
+   * @param k Number of neighbors to search for.
+   * @param neighbors Matrix storing lists of neighbors for each query point.
+   * @param distances Matrix storing distances of neighbors for each query
+   *     point.
+   */
+  void Search(const arma::mat& querySet,
+              const size_t k,
+              arma::Mat<size_t>& neighbors,
+              arma::mat& distances) const;
+
+  /**
+   * Re-rank the given candidates of each query with the approximate distances,
+   * and return the k best.  Column i of candidates holds the candidates of
+   * query i; entries that are not valid reference indices (such as the
+   * placeholders returned by LSHSearch when too few neighbors were found) are
+   * skipped.  If a query has fewer than k valid candidates, the remaining
+   * neighbors are set to the number of reference points and their distances to
+   * DBL_MAX.
+   *
+   * @param querySet Set of query points.
+   * @param candidates Candidate reference points of each query.
+   * @param k Number of neighbors to return.
+   * @param neighbors Matrix storing lists of neighbors for each query point.
+   * @param distances Matrix storing distances of neighbors for each query
+   *     point.
+   */
+  void Search(const arma::mat& querySet,
+              const arma::Mat<size_t>& candidates,
+              const size_t k,
+              arma::Mat<size_t>& neighbors,
+              arma::mat& distances) const;
+
+  //! Get the product quantizer.
+  const ProductQuantizer& Quantizer() const { return quantizer; }
+  //! Get the codes of the reference points.
+  const arma::Mat<arma::u8>& Codes() const { return codes; }
+
+  //! Serialize the model.
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */)
+  {
+    ar & BOOST_SERIALIZATION_NVP(quantizer);
+    ar & BOOST_SERIALIZATION_NVP(codes);
+  }
+
+ private:
+  //! Check the dimensionality of the queries and k.
+  void CheckQueries(const arma::mat& querySet, const size_t k) const;
+
+  //! The product quantizer.
+  ProductQuantizer quantizer;
+  //! The codes of the reference points; one column per point.
+  arma::Mat<arma::u8> codes;
+};
+
+} // namespace neighbor
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,137 @@
+/**
+ * @file product_quantizer.cpp
+ *
+ * Implementation of the ProductQuantizer class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "product_quantizer.hpp"
+
+#include <mlpack/methods/kmeans/kmeans.hpp>
+
+namespace mlpack {
+namespace neighbor {
+
+ProductQuantizer::ProductQuantizer(const size_t numSubspaces,
+                                   const size_t codebookSize,
+                                   const size_t maxIterations) :
+    numSubspaces(numSubspaces),
+    codebookSize(codebookSize),
+    maxIterations(maxIterations)
+{
+  // Nothing to do.
+}
+
+void ProductQuantizer::Train(const arma::mat& data)
+{
+  if (codebookSize == 0 || codebookSize > 256)
+  {
+    throw std::invalid_argument("ProductQuantizer::Train(): codebook size "
+        "must be between 1 and 256");
+  }
+
+  if (numSubspaces == 0 || numSubspaces > data.n_rows)
+  {
+    std::ostringstream oss;
+    oss << "ProductQuantizer::Train(): number of subspaces (" << numSubspaces
+        << ") must be between 1 and the dimensionality of the data ("
+        << data.n_rows << ")!" << std::endl;
+    throw std::invalid_argument(oss.str());
+  }
+
+  if (data.n_cols < codebookSize)
+  {
+    std::ostringstream oss;
+    oss << "ProductQuantizer::Train(): " << data.n_cols << " training points "
+        << "are not enough for " << codebookSize << " centroids!" << std::endl;
+    throw std::invalid_argument(oss.str());
+  }
+
+  // The subspaces differ in size by at most one dimension.
+  offsets.set_size(numSubspaces + 1);
+  for (size_t s = 0; s <= numSubspaces; ++s)
+    offsets[s] = s * data.n_rows / numSubspaces;
+
+  codebooks.resize(numSubspaces);
+  kmeans::KMeans<> kmeans(maxIterations);
+  for (size_t s = 0; s < numSubspaces; ++s)
+  {
+    const arma::mat subspaceData = data.rows(offsets[s], offsets[s + 1] - 1);
+    kmeans.Cluster(subspaceData, codebookSize, codebooks[s]);
+  }
+}
+
+void ProductQuantizer::Encode(const arma::mat& data,
+                              arma::Mat<arma::u8>& codes) const
+{
+  if (data.n_rows != Dimensionality())
+  {
+    std::ostringstream oss;
+    oss << "ProductQuantizer::Encode(): dimensionality of data ("
+        << data.n_rows << ") is not equal to the dimensionality the quantizer "
+        << "was trained on (" << Dimensionality() << ")!" << std::endl;
+    throw std::invalid_argument(oss.str());
+  }
+
+  codes.set_size(numSubspaces, data.n_cols);
+
+  // The points are encoded in blocks, so that the distances between a block
+  // and a codebook are computed with one matrix multiplication.
+  const size_t blockSize = 1024;
+  const size_t numBlocks = (data.n_cols + blockSize - 1) / blockSize;
+
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+  {
+    const size_t begin = b * blockSize;
+    const size_t end = std::min(begin + blockSize, (size_t) data.n_cols);
+
+    for (size_t s = 0; s < numSubspaces; ++s)
+    {
+      // The norm of each point is the same for every centroid, so it is left
+      // out of the distances.
+      const arma::mat& codebook = codebooks[s];
+      arma::mat distances = -2.0 * codebook.t() *
+          data.submat(offsets[s], begin, offsets[s + 1] - 1, end - 1);
+      distances.each_col() += arma::sum(arma::square(codebook), 0).t();
+
+      for (size_t i = 0; i < distances.n_cols; ++i)
+      {
+        arma::uword index;
+        distances.col(i).min(index);
+        codes(s, begin + i) = (arma::u8) index;
+      }
+    }
+  }
+}
+
+void ProductQuantizer::Decode(const arma::Mat<arma::u8>& codes,
+                              arma::mat& data) const
+{
+  data.set_size(Dimensionality(), codes.n_cols);
+  for (size_t i = 0; i < codes.n_cols; ++i)
+  {
+    for (size_t s = 0; s < numSubspaces; ++s)
+    {
+      data.submat(offsets[s], i, offsets[s + 1] - 1, i) =
+          codebooks[s].col(codes(s, i));
+    }
+  }
+}
+
+void ProductQuantizer::DistanceTable(const arma::vec& query,
+                                     arma::mat& table) const
+{
+  table.set_size(codebookSize, numSubspaces);
+  for (size_t s = 0; s < numSubspaces; ++s)
+  {
+    table.col(s) = arma::sum(arma::square(codebooks[s].each_col() -
+        query.subvec(offsets[s], offsets[s + 1] - 1)), 0).t();
+  }
+}
+
+} // namespace neighbor
+} // namespace mlpack
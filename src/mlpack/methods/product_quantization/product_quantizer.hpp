@@ -0,0 +1,171 @@
+/**
+ * @file product_quantizer.hpp
+ *
+ * A product quantizer, which compresses vectors into a few bytes each so that
+ * approximate distances can be computed without the original vectors.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_PRODUCT_QUANTIZATION_PRODUCT_QUANTIZER_HPP
+#define MLPACK_METHODS_PRODUCT_QUANTIZATION_PRODUCT_QUANTIZER_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace neighbor {
+
+/**
+ * This class implements product quantization, as described in the following
+ * paper:
+ *
+ * @code
+ * @article{jegou2011product,
+ *   title={Product quantization for nearest neighbor search},
+ *   author={J{\'e}gou, H. and Douze, M. and Schmid, C.},
+ *   journal={IEEE Transactions on Pattern Analysis and Machine Intelligence},
+ *   volume={33},
+ *   number={1},
+ *   pages={117--128},
+ *   year={2011}
+ * }
+ * @endcode
+ *
+ * The dimensions are split into NumSubspaces() contiguous subspaces, and a
+ * codebook of at most 256 centroids is trained on each subspace with k-means.
+ * A vector is then encoded as the index of the nearest centroid in each
+ * subspace, so 8 subspaces give 8-byte codes.  The squared distance between a
+ * query and an encoded vector is approximated by the sum over the subspaces of
+ * the squared distances between the query and the centroids (the asymmetric
+ * distance), which are looked up in a table computed once per query with
+ * DistanceTable().
+ *
+ * @code
+ * ProductQuantizer pq(8, 256); // 8 subspaces of 256 centroids.
+ * pq.Train(trainingSet);
+ *
+ * arma::Mat<arma::u8> codes;
+ * pq.Encode(referenceSet, codes);
+ *
+ * arma::mat table;
+ * pq.DistanceTable(query, table);
+ * const double squaredDistance = pq.Distance(table, codes.col(0));
+ * @endcode
+ */
+class ProductQuantizer
+{
+ public:
+  /**
+   * Create the product quantizer.  Train() must be called before vectors can
+   * be encoded.
+   *
+   * @param numSubspaces Number of subspaces (bytes per code).
+   * @param codebookSize Number of centroids of each subspace (at most 256).
+   * @param maxIterations Maximum number of k-means iterations for each
+   *     codebook.
+   */
+  ProductQuantizer(const size_t numSubspaces = 8,
+                   const size_t codebookSize = 256,
+                   const size_t maxIterations = 25);
+
+  /**
+   * Train the codebooks on the given data, which must have at least
+   * CodebookSize() points and NumSubspaces() dimensions.  A sample of the data
+   * that will be encoded is usually enough.  A std::invalid_argument is thrown
+   * if the parameters or the data are not valid.
+   *
+   * @param data Training points.
+   */
+  void Train(const arma::mat& data);
+
+  /**
+   * Encode the given points; column i of codes holds the code of point i.
+   *
+   * @param data Points to encode.
+   * @param codes Matrix to store the codes in (NumSubspaces() x data.n_cols).
+   */
+  void Encode(const arma::mat& data, arma::Mat<arma::u8>& codes) const;
+
+  /**
+   * Reconstruct points from their codes; each point is replaced by the
+   * concatenation of its centroids.
+   *
+   * @param codes Codes to decode.
+   * @param data Matrix to store the reconstructed points in.
+   */
+  void Decode(const arma::Mat<arma::u8>& codes, arma::mat& data) const;
+
+  /**
+   * Compute the squared distances between the given query and every centroid;
+   * entry (c, s) of the table is the squared distance between the part of the
+   * query in subspace s and centroid c of that subspace.
+   *
+   * @param query Query point.
+   * @param table Matrix to store the table in (CodebookSize() x
+   *     NumSubspaces()).
+   */
+  void DistanceTable(const arma::vec& query, arma::mat& table) const;
+
+  /**
+   * Get the approximate squared distance between the query of the given table
+   * and an encoded point.
+   *
+   * @param table Distance table of the query.
+   * @param code Code of the point.
+   */
+  static double Distance(const arma::mat& table, const arma::u8* code)
+  {
+    double distance = 0.0;
+    for (size_t s = 0; s < table.n_cols; ++s)
+      distance += table(code[s], s);
+    return distance;
+  }
+
+  //! Get the number of subspaces.
+  size_t NumSubspaces() const { return numSubspaces; }
+  //! Get the number of centroids of each subspace.
+  size_t CodebookSize() const { return codebookSize; }
+  //! Get the maximum number of k-means iterations.
+  size_t MaxIterations() const { return maxIterations; }
+  //! Modify the maximum number of k-means iterations.
+  size_t& MaxIterations() { return maxIterations; }
+
+  //! Get the dimensionality of the data (0 if the quantizer is not trained).
+  size_t Dimensionality() const
+  { return offsets.n_elem == 0 ? 0 : offsets[offsets.n_elem - 1]; }
+  //! Get the first dimension of each subspace, followed by the dimensionality.
+  const arma::Col<size_t>& Offsets() const { return offsets; }
+  //! Get the centroids of the given subspace.
+  const arma::mat& Codebook(const size_t s) const { return codebooks[s]; }
+
+  //! Serialize the product quantizer.
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */)
+  {
+    ar & BOOST_SERIALIZATION_NVP(numSubspaces);
+    ar & BOOST_SERIALIZATION_NVP(codebookSize);
+    ar & BOOST_SERIALIZATION_NVP(maxIterations);
+    ar & BOOST_SERIALIZATION_NVP(offsets);
+    ar & BOOST_SERIALIZATION_NVP(codebooks);
+  }
+
+ private:
+  //! Number of subspaces.
+  size_t numSubspaces;
+  //! Number of centroids of each subspace.
+  size_t codebookSize;
+  //! Maximum number of k-means iterations.
+  size_t maxIterations;
+
+  //! First dimension of each subspace, followed by the dimensionality.
+  arma::Col<size_t> offsets;
+  //! Centroids of each subspace; one column per centroid.
+  std::vector<arma::mat> codebooks;
+};
+
+} // namespace neighbor
+} // namespace mlpack
+
+#endif
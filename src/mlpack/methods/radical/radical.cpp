@@ -45,7 +45,8 @@ void Radical::CopyAndPerturb(mat& xNew, const mat& x) const
 
 double Radical::Vasicek(vec& z) const
 {
-  z = sort(z);
+  // Sort in place, to avoid allocating a new vector for each estimate.
+  std::sort(z.begin(), z.end());
 
   // Apparently slower.
   /*
@@ -70,26 +71,29 @@ double Radical::DoRadical2D(const mat& matX)
 {
   CopyAndPerturb(perturbed, matX);
 
-  mat::fixed<2, 2> matJacobi;
-
   vec values(angles);
 
-  for (size_t i = 0; i < angles; i++)
+  // The candidate angles are independent, so they are split between OpenMP
+  // threads.  Each thread rotates the perturbed data into its own vectors,
+  // which are then sorted in place by Vasicek().
+  #pragma omp parallel
   {
-    const double theta = (i / (double) angles) * M_PI / 2.0;
-    const double cosTheta = cos(theta);
-    const double sinTheta = sin(theta);
+    vec candidateY1(perturbed.n_rows);
+    vec candidateY2(perturbed.n_rows);
 
-    matJacobi(0, 0) = cosTheta;
-    matJacobi(1, 0) = -sinTheta;
-    matJacobi(0, 1) = sinTheta;
-    matJacobi(1, 1) = cosTheta;
+    #pragma omp for
+    for (omp_size_t i = 0; i < (omp_size_t) angles; i++)
+    {
+      const double theta = (i / (double) angles) * M_PI / 2.0;
+      const double cosTheta = cos(theta);
+      const double sinTheta = sin(theta);
 
-    candidate = perturbed * matJacobi;
-    vec candidateY1 = candidate.unsafe_col(0);
-    vec candidateY2 = candidate.unsafe_col(1);
+      // The two columns of perturbed * [cos sin; -sin cos].
+      candidateY1 = cosTheta * perturbed.col(0) - sinTheta * perturbed.col(1);
+      candidateY2 = sinTheta * perturbed.col(0) + cosTheta * perturbed.col(1);
 
-    values(i) = Vasicek(candidateY1) + Vasicek(candidateY2);
+      values(i) = Vasicek(candidateY1) + Vasicek(candidateY2);
+    }
   }
 
   uword indOpt = 0;
@@ -134,8 +138,6 @@ void Radical::DoRadical(const mat& matXT, mat& matY, mat& matW)
 
   mat matYSubspace(nPoints, 2);
 
-  mat matJ = eye(nDims, nDims);
-
   for (size_t sweepNum = 0; sweepNum < sweeps; sweepNum++)
   {
     Log::Info << "RADICAL: sweep " << sweepNum << "." << std::endl;
@@ -155,19 +157,16 @@ void Radical::DoRadical(const mat& matXT, mat& matY, mat& matW)
         const double cosThetaOpt = cos(thetaOpt);
         const double sinThetaOpt = sin(thetaOpt);
 
-        // Set elements of transformation matrix.
-        matJ(i, i) = cosThetaOpt;
-        matJ(j, i) = -sinThetaOpt;
-        matJ(i, j) = sinThetaOpt;
-        matJ(j, j) = cosThetaOpt;
-
-        matY *= matJ;
+        // The Jacobi rotation only changes columns i and j, so we rotate those
+        // instead of multiplying by the full nDims x nDims rotation matrix.
+        // The unmixing matrix is rotated in the same way.
+        const vec yI = matY.col(i);
+        matY.col(i) = cosThetaOpt * yI - sinThetaOpt * matY.col(j);
+        matY.col(j) = sinThetaOpt * yI + cosThetaOpt * matY.col(j);
 
-        // Unset elements of transformation matrix, so matJ = eye() again.
-        matJ(i, i) = 1;
-        matJ(j, i) = 0;
-        matJ(i, j) = 0;
-        matJ(j, j) = 1;
+        const vec wI = matW.col(i);
+        matW.col(i) = cosThetaOpt * wI - sinThetaOpt * matW.col(j);
+        matW.col(j) = sinThetaOpt * wI + cosThetaOpt * matW.col(j);
       }
     }
   }
@@ -88,7 +88,10 @@ class Radical
    */
   void CopyAndPerturb(arma::mat& xNew, const arma::mat& x) const;
 
-  //! Two-dimensional version of RADICAL.
+  /**
+   * Two-dimensional version of RADICAL.  The candidate angles are evaluated in
+   * parallel with OpenMP.
+   */
   double DoRadical2D(const arma::mat& matX);
 
   //! Get the standard deviation of the additive Gaussian noise.
@@ -131,8 +134,6 @@ class Radical
 
   //! Internal matrix, held as member variable to prevent memory reallocations.
   arma::mat perturbed;
-  //! Internal matrix, held as member variable to prevent memory reallocations.
-  arma::mat candidate;
 };
 
 void WhitenFeatureMajorMatrix(const arma::mat& matX,
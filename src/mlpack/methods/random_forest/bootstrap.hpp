@@ -13,6 +13,8 @@ namespace tree {
 
 /**
  * Given a dataset, create another dataset via bootstrap sampling, with labels.
+ * Each sampled point is copied once for each time it is drawn; to avoid those
+ * copies, use BootstrapCounts() and train with the counts as weights.
  */
 template<bool UseWeights,
          typename MatType,
@@ -42,6 +44,29 @@ void Bootstrap(const MatType& dataset,
   }
 }
 
+/**
+ * Draw a bootstrap sample of the points 0, ..., n - 1 by weight instead of by
+ * copy: counts[i] is set to the number of times point i is drawn when n points
+ * are sampled with replacement.  Training on the points with a nonzero count,
+ * weighted by their counts, is equivalent to training on the bootstrapped
+ * dataset, and the points with a count of zero are out of the bag.
+ *
+ * @param n Number of points in the dataset.
+ * @param counts Output number of times each point is drawn.
+ */
+inline void BootstrapCounts(const size_t n, arma::Col<size_t>& counts)
+{
+  counts.zeros(n);
+  if (n == 0)
+    return;
+
+  // Random sampling with replacement.
+  const arma::uvec indices = arma::randi<arma::uvec>(n,
+      arma::distr_param(0, n - 1));
+  for (size_t i = 0; i < n; ++i)
+    ++counts[indices[i]];
+}
+
 } // namespace tree
 } // namespace mlpack
 
@@ -8,6 +8,7 @@
 #define MLPACK_METHODS_RANDOM_FOREST_RANDOM_FOREST_HPP
 
 #include <mlpack/methods/decision_tree/decision_tree.hpp>
+#include <mlpack/methods/decision_tree/flat_decision_forest.hpp>
 #include <mlpack/methods/decision_tree/multiple_random_dimension_select.hpp>
 #include "bootstrap.hpp"
 
@@ -30,7 +31,7 @@ class RandomForest
    * Construct the random forest without any training or specifying the number
    * of trees.  Predict() will throw an exception until Train() is called.
    */
-  RandomForest() { }
+  RandomForest() : oobError(std::numeric_limits<double>::quiet_NaN()) { }
 
   /**
    * Create a random forest, training on the given labeled training data with
@@ -244,6 +245,13 @@ class RandomForest
                 arma::Row<size_t>& predictions,
                 arma::mat& probabilities) const;
 
+  /**
+   * Pack the trees of the forest into a FlatDecisionForest, which gives the
+   * same predictions as Classify() but is faster.  If the random forest has not
+   * been trained, this will throw an exception.
+   */
+  FlatDecisionForest<DecisionTreeType> Flatten() const;
+
   //! Access a tree in the forest.
   const DecisionTreeType& Tree(const size_t i) const { return trees[i]; }
   //! Modify a tree in the forest (be careful!).
@@ -252,6 +260,15 @@ class RandomForest
   //! Get the number of trees in the forest.
   size_t NumTrees() const { return trees.size(); }
 
+  /**
+   * Get the out-of-bag error of the forest: the fraction of the training points
+   * misclassified by the trees that were not trained on them.  Each tree is
+   * trained on a bootstrap sample, so each point is out of the bag for about a
+   * third of the trees.  This is NaN if the forest has not been trained, or if
+   * no point was out of the bag.
+   */
+  double OOBError() const { return oobError; }
+
   /**
    * Serialize the random forest.
    */
@@ -286,11 +303,22 @@ class RandomForest
 
   //! The trees in the forest.
   std::vector<DecisionTreeType> trees;
+  //! The out-of-bag error computed during training.
+  double oobError;
 };
 
 } // namespace tree
 } // namespace mlpack
 
+//! Set the serialization version of the RandomForest class.
+BOOST_TEMPLATE_CLASS_VERSION(SINGLE_ARG(template<typename FitnessFunction,
+    typename DimensionSelectionType,
+    template<typename> class NumericSplitType,
+    template<typename> class CategoricalSplitType,
+    typename ElemType>), SINGLE_ARG(mlpack::tree::RandomForest<FitnessFunction,
+    DimensionSelectionType, NumericSplitType, CategoricalSplitType,
+    ElemType>), 1);
+
 // Include implementation.
 #include "random_forest_impl.hpp"
 
@@ -371,6 +371,38 @@ void RandomForest<
   }
 }
 
+template<
+    typename FitnessFunction,
+    typename DimensionSelectionType,
+    template<typename> class NumericSplitType,
+    template<typename> class CategoricalSplitType,
+    typename ElemType
+>
+FlatDecisionForest<typename RandomForest<
+    FitnessFunction,
+    DimensionSelectionType,
+    NumericSplitType,
+    CategoricalSplitType,
+    ElemType
+>::DecisionTreeType> RandomForest<
+    FitnessFunction,
+    DimensionSelectionType,
+    NumericSplitType,
+    CategoricalSplitType,
+    ElemType
+>::Flatten() const
+{
+  if (trees.size() == 0)
+    throw std::invalid_argument("RandomForest::Flatten(): no random forest "
+        "trained!");
+
+  FlatDecisionForest<DecisionTreeType> flat;
+  for (size_t i = 0; i < trees.size(); ++i)
+    flat.Add(trees[i]);
+
+  return flat;
+}
+
 template<
     typename FitnessFunction,
     typename DimensionSelectionType,
@@ -385,7 +417,7 @@ void RandomForest<
     NumericSplitType,
     CategoricalSplitType,
     ElemType
->::serialize(Archive& ar, const unsigned int /* version */)
+>::serialize(Archive& ar, const unsigned int version)
 {
   size_t numTrees;
   if (Archive::is_loading::value)
@@ -400,6 +432,12 @@ void RandomForest<
     trees.resize(numTrees);
 
   ar & BOOST_SERIALIZATION_NVP(trees);
+
+  // Older models did not store the out-of-bag error.
+  if (version > 0)
+    ar & BOOST_SERIALIZATION_NVP(oobError);
+  else if (Archive::is_loading::value)
+    oobError = std::numeric_limits<double>::quiet_NaN();
 }
 
 template<
@@ -427,41 +465,75 @@ void RandomForest<
   // Train each tree individually.
   trees.resize(numTrees); // This will fill the vector with untrained trees.
 
+  // The sums of the class probabilities given to each point by the trees it
+  // is out of the bag for, and the number of those trees.
+  arma::mat oobProbabilities(numClasses, dataset.n_cols, arma::fill::zeros);
+  arma::Col<size_t> oobTrees(dataset.n_cols, arma::fill::zeros);
+
   #pragma omp parallel for
   for (omp_size_t i = 0; i < numTrees; ++i)
   {
-    MatType bootstrapDataset;
-    arma::Row<size_t> bootstrapLabels;
-    arma::rowvec bootstrapWeights;
-    Bootstrap<UseWeights>(dataset, labels, weights, bootstrapDataset,
-        bootstrapLabels, bootstrapWeights);
+    // Sample by weight: each tree is trained only on the points drawn at least
+    // once, weighted by the number of times they are drawn.
+    arma::Col<size_t> counts;
+    BootstrapCounts(dataset.n_cols, counts);
+    const arma::uvec inBag = arma::find(counts > 0);
+    const arma::uvec outOfBag = arma::find(counts == 0);
+
+    arma::rowvec bootstrapWeights = arma::conv_to<arma::rowvec>::from(
+        arma::Col<size_t>(counts.elem(inBag)));
+    if (UseWeights)
+      bootstrapWeights %= weights.cols(inBag);
 
     // Now build the decision tree.
-    if (UseWeights)
+    if (UseDatasetInfo)
     {
-      if (UseDatasetInfo)
-      {
-        trees[i].Train(dataset, datasetInfo, labels, numClasses, weights,
-            minimumLeafSize);
-      }
-      else
-      {
-        trees[i].Train(dataset, labels, numClasses, weights, minimumLeafSize);
-      }
+      trees[i].Train(MatType(dataset.cols(inBag)), datasetInfo,
+          arma::Row<size_t>(labels.cols(inBag)), numClasses,
+          std::move(bootstrapWeights), minimumLeafSize);
     }
     else
     {
-      if (UseDatasetInfo)
-      {
-        trees[i].Train(dataset, datasetInfo, labels, numClasses,
-            minimumLeafSize);
-      }
-      else
-      {
-        trees[i].Train(dataset, labels, numClasses, minimumLeafSize);
-      }
+      trees[i].Train(MatType(dataset.cols(inBag)),
+          arma::Row<size_t>(labels.cols(inBag)), numClasses,
+          std::move(bootstrapWeights), minimumLeafSize);
+    }
+
+    // Let the tree vote on the points it did not see.
+    arma::mat treeProbabilities(numClasses, outOfBag.n_elem);
+    for (size_t j = 0; j < outOfBag.n_elem; ++j)
+    {
+      size_t prediction;
+      arma::vec probabilities;
+      trees[i].Classify(dataset.col(outOfBag[j]), prediction, probabilities);
+      treeProbabilities.col(j) = probabilities;
+    }
+
+    #pragma omp critical
+    {
+      oobProbabilities.cols(outOfBag) += treeProbabilities;
+      oobTrees.elem(outOfBag) += 1;
     }
   }
+
+  // Compute the out-of-bag error over the points that were out of the bag for
+  // at least one tree.
+  size_t oobPoints = 0;
+  size_t oobErrors = 0;
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+  {
+    if (oobTrees[i] == 0)
+      continue;
+
+    arma::uword prediction;
+    oobProbabilities.col(i).max(prediction);
+    ++oobPoints;
+    if ((size_t) prediction != labels[i])
+      ++oobErrors;
+  }
+
+  oobError = (oobPoints == 0) ? std::numeric_limits<double>::quiet_NaN() :
+      (double) oobErrors / (double) oobPoints;
 }
 
 } // namespace tree
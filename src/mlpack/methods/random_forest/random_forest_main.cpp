@@ -68,6 +68,8 @@ PARAM_MODEL_IN(RandomForestModel, "input_model", "Pre-trained random forest to "
 PARAM_MODEL_OUT(RandomForestModel, "output_model", "Model to save trained "
     "random forest to.", "M");
 
+BINDING_SERVER_MODE();
+
 void mlpackMain()
 {
   // Check for incompatible input parameters.
@@ -104,7 +106,10 @@ void mlpackMain()
   ReportIgnoredParam({{ "training", false }}, "num_trees");
   ReportIgnoredParam({{ "training", false }}, "minimum_leaf_size");
 
-  RandomForestModel rfModel;
+  // A loaded model is used in place, so that it stays loaded in server mode.
+  RandomForestModel trainedModel;
+  RandomForestModel& rfModel = CLI::HasParam("training") ? trainedModel :
+      CLI::GetParam<RandomForestModel>("input_model");
   if (CLI::HasParam("training"))
   {
     // Train the model on the given input data.
@@ -122,6 +127,7 @@ void mlpackMain()
 
     // Train the model.
     rfModel.rf.Train(data, labels, numClasses, numTrees, minimumLeafSize);
+    Log::Info << "Out-of-bag error: " << rfModel.rf.OOBError() << "." << endl;
 
     // Did we want training accuracy?
     if (CLI::HasParam("print_training_accuracy"))
@@ -136,11 +142,6 @@ void mlpackMain()
           << endl;
     }
   }
-  else
-  {
-    // Then we must be loading a model.
-    rfModel = std::move(CLI::GetParam<RandomForestModel>("input_model"));
-  }
 
   if (CLI::HasParam("test"))
   {
@@ -173,5 +174,11 @@ void mlpackMain()
 
   // Did the user want to save the output model?
   if (CLI::HasParam("output_model"))
-    CLI::GetParam<RandomForestModel>("output_model") = std::move(rfModel);
+  {
+    // A loaded model is copied, since it may be used again in server mode.
+    if (CLI::HasParam("input_model"))
+      CLI::GetParam<RandomForestModel>("output_model") = rfModel;
+    else
+      CLI::GetParam<RandomForestModel>("output_model") = std::move(rfModel);
+  }
 }
@@ -0,0 +1,132 @@
+/**
+ * @file binary_file_block_source.hpp
+ *
+ * A column block source for the out-of-core randomized SVD that streams blocks
+ * from a matrix saved in Armadillo's binary format.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_RANDOMIZED_SVD_BINARY_FILE_BLOCK_SOURCE_HPP
+#define MLPACK_METHODS_RANDOMIZED_SVD_BINARY_FILE_BLOCK_SOURCE_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <fstream>
+
+namespace mlpack {
+namespace svd {
+
+/**
+ * This class streams consecutive blocks of columns of a matrix of doubles that
+ * was saved in Armadillo's binary format (with
+ * matrix.save("file.bin", arma::arma_binary)), without ever loading the whole
+ * matrix.  Since Armadillo stores matrices in column-major order, each block
+ * is one contiguous read from the file.  (Note that data::Save() transposes
+ * the matrix by default.)
+ *
+ * A block source has to provide the following API, used by the
+ * block-streaming RandomizedSVD::Apply():
+ *
+ * @code
+ * size_t NumRows() const;
+ * size_t NumCols() const;
+ * void Reset();                     // Start a new pass over the columns.
+ * bool NextBlock(arma::mat& block); // Returns false once the pass is over.
+ * @endcode
+ */
+class BinaryFileBlockSource
+{
+ public:
+  /**
+   * Open the given file and read its header.  A std::runtime_error is thrown
+   * if the file can't be opened or isn't a binary Armadillo matrix of doubles.
+   *
+   * @param filename File to read.
+   * @param blockSize Number of columns in each block.
+   */
+  BinaryFileBlockSource(const std::string& filename,
+                        const size_t blockSize = 1024) :
+      stream(filename.c_str(), std::fstream::binary),
+      blockSize(std::max(blockSize, (size_t) 1)),
+      numRows(0),
+      numCols(0),
+      position(0)
+  {
+    if (!stream.is_open())
+    {
+      throw std::runtime_error("BinaryFileBlockSource: cannot open file '" +
+          filename + "'");
+    }
+
+    std::string header;
+    stream >> header >> numRows >> numCols;
+    if (!stream.good() || header != "ARMA_MAT_BIN_FN008")
+    {
+      throw std::runtime_error("BinaryFileBlockSource: '" + filename + "' is "
+          "not a binary Armadillo matrix of doubles");
+    }
+
+    // Skip the newline that ends the header.
+    stream.get();
+    dataOffset = stream.tellg();
+  }
+
+  //! Get the number of rows of the matrix.
+  size_t NumRows() const { return numRows; }
+  //! Get the number of columns of the matrix.
+  size_t NumCols() const { return numCols; }
+
+  //! Start a new pass over the columns.
+  void Reset()
+  {
+    stream.clear();
+    stream.seekg(dataOffset);
+    position = 0;
+  }
+
+  /**
+   * Read the next block of columns.  Returns false when the pass is over.  A
+   * std::runtime_error is thrown if the file is truncated.
+   *
+   * @param block Matrix to store the block in.
+   */
+  bool NextBlock(arma::mat& block)
+  {
+    if (position >= numCols)
+      return false;
+
+    const size_t cols = std::min(blockSize, numCols - position);
+    block.set_size(numRows, cols);
+    stream.read(reinterpret_cast<char*>(block.memptr()),
+        sizeof(double) * numRows * cols);
+    if (!stream.good())
+    {
+      throw std::runtime_error("BinaryFileBlockSource: unexpected end of "
+          "file");
+    }
+
+    position += cols;
+    return true;
+  }
+
+ private:
+  //! The file being read.
+  std::ifstream stream;
+  //! Number of columns in each block.
+  size_t blockSize;
+  //! Number of rows of the matrix.
+  size_t numRows;
+  //! Number of columns of the matrix.
+  size_t numCols;
+  //! Position of the matrix elements in the file.
+  std::streampos dataOffset;
+  //! First column of the next block.
+  size_t position;
+};
+
+} // namespace svd
+} // namespace mlpack
+
+#endif
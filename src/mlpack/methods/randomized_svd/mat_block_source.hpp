@@ -0,0 +1,83 @@
+/**
+ * @file mat_block_source.hpp
+ *
+ * A column block source for the out-of-core randomized SVD that reads blocks
+ * from a matrix in memory.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_RANDOMIZED_SVD_MAT_BLOCK_SOURCE_HPP
+#define MLPACK_METHODS_RANDOMIZED_SVD_MAT_BLOCK_SOURCE_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace svd {
+
+/**
+ * This class serves consecutive blocks of columns of a matrix that is already
+ * in memory, so that the block-streaming RandomizedSVD::Apply() can be used
+ * (and tested) without a file.  See BinaryFileBlockSource for the block source
+ * API.
+ *
+ * @tparam MatType Type of the matrix (arma::mat or arma::sp_mat).
+ */
+template<typename MatType = arma::mat>
+class MatBlockSource
+{
+ public:
+  /**
+   * Create the block source.  The matrix is not copied, so it must stay alive
+   * while the source is used.
+   *
+   * @param data Matrix to serve the columns of.
+   * @param blockSize Number of columns in each block.
+   */
+  MatBlockSource(const MatType& data, const size_t blockSize = 1024) :
+      data(data),
+      blockSize(std::max(blockSize, (size_t) 1)),
+      position(0)
+  {
+    // Nothing to do.
+  }
+
+  //! Get the number of rows of the matrix.
+  size_t NumRows() const { return data.n_rows; }
+  //! Get the number of columns of the matrix.
+  size_t NumCols() const { return data.n_cols; }
+
+  //! Start a new pass over the columns.
+  void Reset() { position = 0; }
+
+  /**
+   * Get the next block of columns.  Returns false when the pass is over.
+   *
+   * @param block Matrix to store the block in.
+   */
+  bool NextBlock(arma::mat& block)
+  {
+    if (position >= data.n_cols)
+      return false;
+
+    const size_t end = std::min(position + blockSize, (size_t) data.n_cols);
+    block = arma::mat(data.cols(position, end - 1));
+    position = end;
+    return true;
+  }
+
+ private:
+  //! The matrix.
+  const MatType& data;
+  //! Number of columns in each block.
+  size_t blockSize;
+  //! First column of the next block.
+  size_t position;
+};
+
+} // namespace svd
+} // namespace mlpack
+
+#endif
@@ -15,6 +15,9 @@
 
 #include <mlpack/prereqs.hpp>
 
+#include "mat_block_source.hpp"
+#include "binary_file_block_source.hpp"
+
 namespace mlpack {
 namespace svd {
 
@@ -120,6 +123,35 @@ class RandomizedSVD
              arma::mat& v,
              const size_t rank);
 
+  /**
+   * Compute the randomized SVD of a matrix that is too large to hold in
+   * memory, reading it one block of columns at a time from the given block
+   * source (such as BinaryFileBlockSource).  As with the other overload, the
+   * rows are centered (the mean of the columns is subtracted).
+   *
+   * The data is read in MaxIterations() + 2 passes: the first pass
+   * accumulates the mean and A * Omega (where the random Omega is drawn
+   * block by block, and so never stored), each power iteration accumulates
+   * A * (A^T * Q) block by block, and the last pass accumulates the small
+   * matrix (Q^T A) (Q^T A)^T, whose eigendecomposition gives the singular
+   * values and the left singular vectors.  Only matrices with as many rows as
+   * the data and IteratedPower() columns are stored.
+   *
+   * The right singular vectors would have as many rows as the data has
+   * columns, so they are not computed; if needed, they can be recovered block
+   * by block as (A - mean)^T * u * diagmat(1 / s).
+   *
+   * @param source Block source to read the data from.
+   * @param u Matrix to store the left singular vectors in.
+   * @param s Vector to store the singular values in (in decreasing order).
+   * @param rank Rank of the approximation.
+   */
+  template<typename BlockSourceType>
+  void Apply(BlockSourceType& source,
+             arma::mat& u,
+             arma::vec& s,
+             const size_t rank);
+
   //! Get the size of the normalized power iterations.
   size_t IteratedPower() const { return iteratedPower; }
   //! Modify the size of the normalized power iterations.
@@ -149,4 +181,7 @@ class RandomizedSVD
 } // namespace svd
 } // namespace mlpack
 
+// Include implementation of templated functions.
+#include "randomized_svd_impl.hpp"
+
 #endif
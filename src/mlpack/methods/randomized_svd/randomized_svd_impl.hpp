@@ -0,0 +1,101 @@
+/**
+ * @file randomized_svd_impl.hpp
+ *
+ * Implementation of the block-streaming (out-of-core) randomized SVD.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_RANDOMIZED_SVD_RANDOMIZED_SVD_IMPL_HPP
+#define MLPACK_METHODS_RANDOMIZED_SVD_RANDOMIZED_SVD_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "randomized_svd.hpp"
+
+namespace mlpack {
+namespace svd {
+
+template<typename BlockSourceType>
+void RandomizedSVD::Apply(BlockSourceType& source,
+                          arma::mat& u,
+                          arma::vec& s,
+                          const size_t rank)
+{
+  if (iteratedPower == 0)
+    iteratedPower = rank + 2;
+
+  const size_t numCols = source.NumCols();
+  arma::mat block, q, r;
+
+  // First pass: compute the mean of the columns, and apply the centered data
+  // to a random matrix.  Since (A - mean * 1^T) * Omega =
+  // A * Omega - mean * (1^T * Omega), we only need the column sums of Omega.
+  arma::vec mean(source.NumRows(), arma::fill::zeros);
+  arma::mat y(source.NumRows(), iteratedPower, arma::fill::zeros);
+  arma::rowvec omegaSums(iteratedPower, arma::fill::zeros);
+
+  source.Reset();
+  while (source.NextBlock(block))
+  {
+    const arma::mat omega = arma::randn<arma::mat>(block.n_cols,
+        iteratedPower);
+    mean += arma::sum(block, 1);
+    y += block * omega;
+    omegaSums += arma::sum(omega, 0);
+  }
+  mean /= numCols;
+  y -= mean * omegaSums;
+
+  // Form a matrix Q whose columns constitute a well-conditioned basis for the
+  // columns of Y.
+  arma::qr_econ(q, r, y);
+
+  // Perform normalized power iterations; each is one pass over the data that
+  // accumulates (A - mean) (A - mean)^T Q.
+  for (size_t i = 0; i < maxIterations; ++i)
+  {
+    const arma::rowvec meanQ = mean.t() * q;
+    y.zeros(source.NumRows(), q.n_cols);
+    arma::rowvec projectionSums(q.n_cols, arma::fill::zeros);
+
+    source.Reset();
+    while (source.NextBlock(block))
+    {
+      arma::mat projection = block.t() * q;
+      projection.each_row() -= meanQ;
+      y += block * projection;
+      projectionSums += arma::sum(projection, 0);
+    }
+    y -= mean * projectionSums;
+
+    arma::qr_econ(q, r, y);
+  }
+
+  // Last pass: with B = Q^T (A - mean), the SVD of the projected data is
+  // given by the eigendecomposition of B B^T, which is small.
+  const arma::vec meanQ = q.t() * mean;
+  arma::mat bbt(q.n_cols, q.n_cols, arma::fill::zeros);
+
+  source.Reset();
+  while (source.NextBlock(block))
+  {
+    arma::mat b = q.t() * block;
+    b.each_col() -= meanQ;
+    bbt += b * b.t();
+  }
+
+  arma::vec eigval;
+  arma::mat eigvec;
+  arma::eig_sym(eigval, eigvec, bbt);
+
+  // eig_sym() sorts the eigenvalues in increasing order.
+  s = arma::sqrt(arma::clamp(arma::flipud(eigval), 0.0, DBL_MAX));
+  u = q * arma::fliplr(eigvec);
+}
+
+} // namespace svd
+} // namespace mlpack
+
+#endif
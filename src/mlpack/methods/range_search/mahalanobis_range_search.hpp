@@ -0,0 +1,148 @@
+/**
+ * @file mahalanobis_range_search.hpp
+ *
+ * Definition of the MahalanobisRangeSearch class, which performs range searches
+ * under a Mahalanobis distance with trees built in Euclidean space.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_RANGE_SEARCH_MAHALANOBIS_RANGE_SEARCH_HPP
+#define MLPACK_METHODS_RANGE_SEARCH_MAHALANOBIS_RANGE_SEARCH_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/metrics/mahalanobis_distance.hpp>
+#include "range_search.hpp"
+
+namespace mlpack {
+namespace range {
+
+/**
+ * Range search under a Mahalanobis distance, performed as a Euclidean range
+ * search on the points transformed by MahalanobisDistance::Transform().  See
+ * neighbor::MahalanobisSearch for the reasoning.  If the Mahalanobis distance
+ * does not take the root, the range is mapped to Euclidean distances before
+ * the search and the distances are squared afterwards.
+ *
+ * @tparam TakeRoot Whether the Mahalanobis distance takes the root.
+ * @tparam TreeType The tree type to use.
+ */
+template<bool TakeRoot = true,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType = tree::KDTree>
+class MahalanobisRangeSearch
+{
+ public:
+  //! The Euclidean range search used in the transformed space.
+  typedef RangeSearch<metric::EuclideanDistance, arma::mat, TreeType>
+      SearchType;
+
+  /**
+   * Transform the reference set with the given Mahalanobis distance and build
+   * the Euclidean range search on it.
+   *
+   * @param referenceSet Reference dataset.
+   * @param metric The Mahalanobis distance to search with.
+   * @param naive Whether the computation should be done in O(n^2) naive mode.
+   * @param singleMode Whether single-tree computation should be used.
+   */
+  MahalanobisRangeSearch(const arma::mat& referenceSet,
+                         const metric::MahalanobisDistance<TakeRoot>& metric,
+                         const bool naive = false,
+                         const bool singleMode = false) :
+      metric(metric),
+      search(Transform(metric, referenceSet), naive, singleMode)
+  { }
+
+  /**
+   * Search for all reference points in the given range for each point in the
+   * query set.
+   *
+   * @param querySet Set of query points.
+   * @param range The range of distances in which to search.
+   * @param neighbors Object which will hold the list of neighbors for each
+   *      point which fell into the given range, for each query point.
+   * @param distances Object which will hold the list of distances for each
+   *      point which fell into the given range, for each query point.
+   */
+  void Search(const arma::mat& querySet,
+              const math::Range& range,
+              std::vector<std::vector<size_t>>& neighbors,
+              std::vector<std::vector<double>>& distances)
+  {
+    search.Search(Transform(metric, querySet), EuclideanRange(range),
+        neighbors, distances);
+    MapDistances(distances);
+  }
+
+  /**
+   * Search for all points in the given range for each point in the reference
+   * set, excluding the point itself.
+   *
+   * @param range The range of distances in which to search.
+   * @param neighbors Object which will hold the list of neighbors for each
+   *      point which fell into the given range, for each point.
+   * @param distances Object which will hold the list of distances for each
+   *      point which fell into the given range, for each point.
+   */
+  void Search(const math::Range& range,
+              std::vector<std::vector<size_t>>& neighbors,
+              std::vector<std::vector<double>>& distances)
+  {
+    search.Search(EuclideanRange(range), neighbors, distances);
+    MapDistances(distances);
+  }
+
+  //! Get the Mahalanobis distance.
+  const metric::MahalanobisDistance<TakeRoot>& Metric() const { return metric; }
+
+  //! Get the Euclidean range search in the transformed space.
+  const SearchType& Searcher() const { return search; }
+  //! Modify the Euclidean range search in the transformed space.
+  SearchType& Searcher() { return search; }
+
+ private:
+  //! Transform the given points into the Euclidean space.
+  static arma::mat Transform(
+      const metric::MahalanobisDistance<TakeRoot>& metric,
+      const arma::mat& points)
+  {
+    arma::mat transformed;
+    metric.Transform(points, transformed);
+    return transformed;
+  }
+
+  //! Map a range of Mahalanobis distances to a range of Euclidean distances.
+  static math::Range EuclideanRange(const math::Range& range)
+  {
+    if (TakeRoot)
+      return range;
+
+    return math::Range(std::sqrt(std::max(range.Lo(), 0.0)),
+        std::sqrt(range.Hi()));
+  }
+
+  //! Map Euclidean distances back to Mahalanobis distances.
+  static void MapDistances(std::vector<std::vector<double>>& distances)
+  {
+    if (TakeRoot)
+      return;
+
+    for (std::vector<double>& list : distances)
+      for (double& distance : list)
+        distance *= distance;
+  }
+
+  //! The Mahalanobis distance.
+  metric::MahalanobisDistance<TakeRoot> metric;
+  //! The Euclidean range search in the transformed space.
+  SearchType search;
+};
+
+} // namespace range
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,187 @@
+/**
+ * @file range_count_rules.hpp
+ *
+ * Rules for range counting, which finds the number of reference points in a
+ * range around each query point without storing the points themselves.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_RANGE_SEARCH_RANGE_COUNT_RULES_HPP
+#define MLPACK_METHODS_RANGE_SEARCH_RANGE_COUNT_RULES_HPP
+
+#include <mlpack/core/tree/traversal_counters.hpp>
+#include <mlpack/core/tree/traversal_info.hpp>
+
+namespace mlpack {
+namespace range {
+
+/**
+ * The RangeCountRules class is a template helper class used by the RangeSearch
+ * class when only the number of points in range is needed.  It is the same as
+ * RangeSearchRules, except that when a reference node lies entirely inside the
+ * range, its number of descendants is added to the count of each query point
+ * without any distance being computed.
+ *
+ * Query points are not skipped as their own results; when the query set is the
+ * reference set, the caller must subtract the query point itself from the
+ * counts if the range contains 0.
+ *
+ * @tparam MetricType The metric to use for computation.
+ * @tparam TreeType The tree type to use; must adhere to the TreeType API.
+ */
+template<typename MetricType, typename TreeType>
+class RangeCountRules
+{
+ public:
+  /**
+   * Construct the RangeCountRules object.  This is usually done from within
+   * the RangeSearch class at search time.
+   *
+   * @param referenceSet Set of reference data.
+   * @param querySet Set of query data.
+   * @param range Range to search for.
+   * @param counts Vector to add the counts to; it must already be filled with
+   *     zeros.
+   * @param metric Instantiated metric.
+   */
+  RangeCountRules(const typename TreeType::Mat& referenceSet,
+                  const typename TreeType::Mat& querySet,
+                  const math::Range& range,
+                  arma::Col<size_t>& counts,
+                  MetricType& metric);
+
+  /**
+   * Construct a RangeCountRules object that shares the counts of the given
+   * rules object, but has its own base case cache, traversal info, and
+   * counters.  This is used by parallel traversals to give each thread its own
+   * rules object.  It is only safe as long as no two threads ever work on the
+   * same query point (or query node) at the same time.
+   *
+   * @param other Rules object whose counts will be shared.
+   */
+  RangeCountRules(RangeCountRules& other);
+
+  /**
+   * Compute the base case between the given query point and reference point.
+   *
+   * @param queryIndex Index of query point.
+   * @param referenceIndex Index of reference point.
+   */
+  double BaseCase(const size_t queryIndex, const size_t referenceIndex);
+
+  /**
+   * Compute the base cases between the given query point and each point of a
+   * contiguous block of reference points.  This is equivalent to calling
+   * BaseCase() for each of the reference points, but faster.
+   *
+   * @param queryIndex Index of query point.
+   * @param referenceBegin Index of the first reference point of the block.
+   * @param referenceCount Number of reference points in the block.
+   */
+  void BaseCaseBlock(const size_t queryIndex,
+                     const size_t referenceBegin,
+                     const size_t referenceCount);
+
+  /**
+   * Get the score for recursion order.  DBL_MAX indicates that the node should
+   * not be recursed into, either because it is out of range or because it was
+   * counted as a whole.
+   *
+   * @param queryIndex Index of query point.
+   * @param referenceNode Candidate node to be recursed into.
+   */
+  double Score(const size_t queryIndex, TreeType& referenceNode);
+
+  /**
+   * Re-evaluate the score for recursion order.  The bounds do not change
+   * during range counting, so this returns the old score.
+   *
+   * @param queryIndex Index of query point.
+   * @param referenceNode Candidate node to be recursed into.
+   * @param oldScore Old score produced by Score() (or Rescore()).
+   */
+  double Rescore(const size_t queryIndex,
+                 TreeType& referenceNode,
+                 const double oldScore) const;
+
+  /**
+   * Get the score for recursion order.  DBL_MAX indicates that the node
+   * combination should not be recursed into, either because it is out of range
+   * or because it was counted as a whole.
+   *
+   * @param queryNode Candidate query node to recurse into.
+   * @param referenceNode Candidate reference node to recurse into.
+   */
+  double Score(TreeType& queryNode, TreeType& referenceNode);
+
+  /**
+   * Re-evaluate the score for recursion order.  The bounds do not change
+   * during range counting, so this returns the old score.
+   *
+   * @param queryNode Candidate query node to recurse into.
+   * @param referenceNode Candidate reference node to recurse into.
+   * @param oldScore Old score produced by Score() (or Rescore()).
+   */
+  double Rescore(TreeType& queryNode,
+                 TreeType& referenceNode,
+                 const double oldScore) const;
+
+  typedef typename tree::TraversalInfo<TreeType> TraversalInfoType;
+
+  const TraversalInfoType& TraversalInfo() const { return traversalInfo; }
+  TraversalInfoType& TraversalInfo() { return traversalInfo; }
+
+  //! Get the number of base cases.
+  size_t BaseCases() const { return counters.BaseCases(); }
+  //! Get the number of scores (that is, calls to RangeDistance()).
+  size_t Scores() const { return counters.Scores(); }
+
+  //! Get the traversal counters.
+  const tree::TraversalCounters& Counters() const { return counters; }
+  //! Modify the traversal counters.
+  tree::TraversalCounters& Counters() { return counters; }
+
+ private:
+  //! The reference set.
+  const typename TreeType::Mat& referenceSet;
+
+  //! The query set.
+  const typename TreeType::Mat& querySet;
+
+  //! The range of distances for which we are searching.
+  const math::Range& range;
+
+  //! The number of points in range of each query point.
+  arma::Col<size_t>& counts;
+
+  //! The instantiated metric.
+  MetricType& metric;
+
+  //! The last query index.
+  size_t lastQueryIndex;
+  //! The last reference index.
+  size_t lastReferenceIndex;
+  //! The distances computed by the last call to BaseCaseBlock().
+  arma::vec blockDistances;
+
+  //! Add the number of points in the given node to the count of the given
+  //! query point.  If the base case with the first point of the node has
+  //! already been counted, it is not counted twice.
+  void AddCount(const size_t queryIndex, TreeType& referenceNode);
+
+  TraversalInfoType traversalInfo;
+
+  //! The counters of base cases, scores, prunes, and node visits.
+  tree::TraversalCounters counters;
+};
+
+} // namespace range
+} // namespace mlpack
+
+// Include implementation.
+#include "range_count_rules_impl.hpp"
+
+#endif
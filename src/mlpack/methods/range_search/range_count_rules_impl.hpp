@@ -0,0 +1,243 @@
+/**
+ * @file range_count_rules_impl.hpp
+ *
+ * Implementation of rules for range counting with generic trees.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_RANGE_SEARCH_RANGE_COUNT_RULES_IMPL_HPP
+#define MLPACK_METHODS_RANGE_SEARCH_RANGE_COUNT_RULES_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "range_count_rules.hpp"
+#include <mlpack/core/metrics/evaluate_block.hpp>
+
+namespace mlpack {
+namespace range {
+
+template<typename MetricType, typename TreeType>
+RangeCountRules<MetricType, TreeType>::RangeCountRules(
+    const typename TreeType::Mat& referenceSet,
+    const typename TreeType::Mat& querySet,
+    const math::Range& range,
+    arma::Col<size_t>& counts,
+    MetricType& metric) :
+    referenceSet(referenceSet),
+    querySet(querySet),
+    range(range),
+    counts(counts),
+    metric(metric),
+    lastQueryIndex(querySet.n_cols),
+    lastReferenceIndex(referenceSet.n_cols)
+{
+  // Nothing to do.
+}
+
+template<typename MetricType, typename TreeType>
+RangeCountRules<MetricType, TreeType>::RangeCountRules(
+    RangeCountRules& other) :
+    referenceSet(other.referenceSet),
+    querySet(other.querySet),
+    range(other.range),
+    counts(other.counts),
+    metric(other.metric),
+    lastQueryIndex(querySet.n_cols),
+    lastReferenceIndex(referenceSet.n_cols)
+{
+  // Nothing to do.
+}
+
+template<typename MetricType, typename TreeType>
+inline force_inline
+double RangeCountRules<MetricType, TreeType>::BaseCase(
+    const size_t queryIndex,
+    const size_t referenceIndex)
+{
+  // If we have just performed this base case, don't do it again.
+  if ((lastQueryIndex == queryIndex) && (lastReferenceIndex == referenceIndex))
+    return 0.0;
+
+  const double distance = metric.Evaluate(querySet.unsafe_col(queryIndex),
+      referenceSet.unsafe_col(referenceIndex));
+  counters.BaseCase();
+
+  lastQueryIndex = queryIndex;
+  lastReferenceIndex = referenceIndex;
+
+  if (range.Contains(distance))
+    ++counts[queryIndex];
+
+  return distance;
+}
+
+template<typename MetricType, typename TreeType>
+void RangeCountRules<MetricType, TreeType>::BaseCaseBlock(
+    const size_t queryIndex,
+    const size_t referenceBegin,
+    const size_t referenceCount)
+{
+  metric::EvaluateBlock(metric, querySet.unsafe_col(queryIndex), referenceSet,
+      referenceBegin, referenceCount, blockDistances);
+
+  for (size_t i = 0; i < referenceCount; ++i)
+  {
+    const size_t referenceIndex = referenceBegin + i;
+
+    // Skip the same base case that BaseCase() would skip.
+    if ((lastQueryIndex == queryIndex) &&
+        (lastReferenceIndex == referenceIndex))
+      continue;
+
+    counters.BaseCase();
+    lastQueryIndex = queryIndex;
+    lastReferenceIndex = referenceIndex;
+
+    if (range.Contains(blockDistances[i]))
+      ++counts[queryIndex];
+  }
+}
+
+template<typename MetricType, typename TreeType>
+double RangeCountRules<MetricType, TreeType>::Score(const size_t queryIndex,
+                                                    TreeType& referenceNode)
+{
+  math::Range distances;
+
+  if (tree::TreeTraits<TreeType>::FirstPointIsCentroid)
+  {
+    double baseCase;
+    if (tree::TreeTraits<TreeType>::HasSelfChildren &&
+        (referenceNode.Parent() != NULL) &&
+        (referenceNode.Point(0) == referenceNode.Parent()->Point(0)))
+    {
+      // The base case of a self-child was already calculated.
+      baseCase = referenceNode.Parent()->Stat().LastDistance();
+      lastQueryIndex = queryIndex;
+      lastReferenceIndex = referenceNode.Point(0);
+    }
+    else
+    {
+      baseCase = BaseCase(queryIndex, referenceNode.Point(0));
+    }
+
+    distances.Lo() = baseCase - referenceNode.FurthestDescendantDistance();
+    distances.Hi() = baseCase + referenceNode.FurthestDescendantDistance();
+
+    referenceNode.Stat().LastDistance() = baseCase;
+  }
+  else
+  {
+    distances = referenceNode.RangeDistance(querySet.unsafe_col(queryIndex));
+    counters.Score();
+  }
+
+  // If the ranges do not overlap, prune this node.
+  if (!distances.Contains(range))
+    return counters.ScoreResult(DBL_MAX);
+
+  // If the node is entirely in range, count all of its points at once.
+  if ((distances.Lo() >= range.Lo()) && (distances.Hi() <= range.Hi()))
+  {
+    AddCount(queryIndex, referenceNode);
+    return counters.ScoreResult(DBL_MAX);
+  }
+
+  return counters.ScoreResult(0.0);
+}
+
+template<typename MetricType, typename TreeType>
+double RangeCountRules<MetricType, TreeType>::Rescore(
+    const size_t /* queryIndex */,
+    TreeType& /* referenceNode */,
+    const double oldScore) const
+{
+  return oldScore;
+}
+
+template<typename MetricType, typename TreeType>
+double RangeCountRules<MetricType, TreeType>::Score(TreeType& queryNode,
+                                                    TreeType& referenceNode)
+{
+  math::Range distances;
+  if (tree::TreeTraits<TreeType>::FirstPointIsCentroid)
+  {
+    // It is possible that the base case has already been calculated.
+    double baseCase = 0.0;
+    if ((traversalInfo.LastQueryNode() != NULL) &&
+        (traversalInfo.LastReferenceNode() != NULL) &&
+        (traversalInfo.LastQueryNode()->Point(0) == queryNode.Point(0)) &&
+        (traversalInfo.LastReferenceNode()->Point(0) == referenceNode.Point(0)))
+    {
+      baseCase = traversalInfo.LastBaseCase();
+      lastQueryIndex = queryNode.Point(0);
+      lastReferenceIndex = referenceNode.Point(0);
+    }
+    else
+    {
+      baseCase = BaseCase(queryNode.Point(0), referenceNode.Point(0));
+    }
+
+    distances.Lo() = baseCase - queryNode.FurthestDescendantDistance()
+        - referenceNode.FurthestDescendantDistance();
+    distances.Hi() = baseCase + queryNode.FurthestDescendantDistance()
+        + referenceNode.FurthestDescendantDistance();
+
+    traversalInfo.LastBaseCase() = baseCase;
+  }
+  else
+  {
+    distances = referenceNode.RangeDistance(queryNode);
+    counters.Score();
+  }
+
+  // If the ranges do not overlap, prune this node combination.
+  if (!distances.Contains(range))
+    return counters.ScoreResult(DBL_MAX);
+
+  // If every pair is in range, count the reference node once for each query
+  // point.
+  if ((distances.Lo() >= range.Lo()) && (distances.Hi() <= range.Hi()))
+  {
+    for (size_t i = 0; i < queryNode.NumDescendants(); ++i)
+      AddCount(queryNode.Descendant(i), referenceNode);
+    return counters.ScoreResult(DBL_MAX);
+  }
+
+  traversalInfo.LastQueryNode() = &queryNode;
+  traversalInfo.LastReferenceNode() = &referenceNode;
+  return counters.ScoreResult(0.0);
+}
+
+template<typename MetricType, typename TreeType>
+double RangeCountRules<MetricType, TreeType>::Rescore(
+    TreeType& /* queryNode */,
+    TreeType& /* referenceNode */,
+    const double oldScore) const
+{
+  return oldScore;
+}
+
+template<typename MetricType, typename TreeType>
+void RangeCountRules<MetricType, TreeType>::AddCount(const size_t queryIndex,
+                                                     TreeType& referenceNode)
+{
+  // Some types of trees calculate the base case evaluation before Score() is
+  // called; that point has already been counted if it was in range.
+  size_t baseCaseMod = 0;
+  if (tree::TreeTraits<TreeType>::FirstPointIsCentroid &&
+      (queryIndex == lastQueryIndex) &&
+      (referenceNode.Point(0) == lastReferenceIndex))
+  {
+    baseCaseMod = 1;
+  }
+
+  counts[queryIndex] += referenceNode.NumDescendants() - baseCaseMod;
+}
+
+} // namespace range
+} // namespace mlpack
+
+#endif
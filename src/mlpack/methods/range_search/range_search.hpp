@@ -299,6 +299,37 @@ class RangeSearch
               std::vector<std::vector<size_t>>& neighbors,
               std::vector<std::vector<double>>& distances);
 
+  /**
+   * Count the reference points in the given range of each point in the query
+   * set, without storing the points or their distances.  When every point of
+   * a reference node is in range of a query point (or of every point of a
+   * query node), the number of points in the node is added to the counts at
+   * once, without any distance being computed.
+   *
+   * counts will be set to the length of the query set, and counts[i] will hold
+   * the number of reference points in range of query point i.
+   *
+   * @param querySet Set of query points to search with.
+   * @param range Range of distances in which to search.
+   * @param counts Vector which will hold the number of points in range of each
+   *      query point.
+   */
+  void Count(const MatType& querySet,
+             const math::Range& range,
+             arma::Col<size_t>& counts);
+
+  /**
+   * Count the points in the given range of each point in the reference set,
+   * without storing the points or their distances.  This means that the query
+   * set and the reference set are the same; as with the monochromatic
+   * Search(), a point is not counted in its own range.
+   *
+   * @param range Range of distances in which to search.
+   * @param counts Vector which will hold the number of points in range of each
+   *      reference point.
+   */
+  void Count(const math::Range& range, arma::Col<size_t>& counts);
+
   //! Get whether single-tree search is being used.
   bool SingleMode() const { return singleMode; }
   //! Modify whether single-tree search is being used.
@@ -309,6 +340,26 @@ class RangeSearch
   //! Modify whether naive search is being used.
   bool& Naive() { return naive; }
 
+  //! Get the maximum number of results returned by Search() for each query
+  //! point (0 means no limit).
+  size_t MaxResults() const { return maxResults; }
+  //! Modify the maximum number of results returned by Search() for each query
+  //! point.  If it is nonzero, Search() stops looking for results of a query
+  //! point once it has found this many, which bounds the memory used by the
+  //! results.  The results kept are the first ones found, in no particular
+  //! order; they are not the closest points.  This setting is not serialized.
+  size_t& MaxResults() { return maxResults; }
+
+  //! Get whether tree traversals are parallelized with OpenMP.
+  bool Parallel() const { return parallel; }
+  //! Modify whether tree traversals are parallelized with OpenMP.  In
+  //! dual-tree mode, subtrees of the query tree are split between threads; in
+  //! single-tree mode, query points are (except for trees with self-children,
+  //! such as cover trees, which are always searched serially in single-tree
+  //! mode).  Each thread appends to the results of its own query points only.
+  //! This setting is not serialized.
+  bool& Parallel() { return parallel; }
+
   //! Get the number of base cases during the last search.
   size_t BaseCases() const { return baseCases; }
   //! Get the number of scores during the last search.
@@ -342,6 +393,10 @@ class RangeSearch
   bool naive;
   //! If true, single-tree computation is used.
   bool singleMode;
+  //! The maximum number of results of each query point (0 means no limit).
+  size_t maxResults;
+  //! If true, tree traversals are parallelized with OpenMP.
+  bool parallel;
 
   //! Instantiated distance metric.
   MetricType metric;
@@ -351,6 +406,29 @@ class RangeSearch
   //! The total number of scores during the last search.
   size_t scores;
 
+  /**
+   * Perform a dual-tree traversal of the given query tree and the reference
+   * tree with the given rules.  If parallel search is enabled (and OpenMP is
+   * available), the query tree is split into disjoint subtrees near its root,
+   * and each subtree is traversed by one thread with its own copy of the rules.
+   *
+   * @param queryTree Tree built on the query points.
+   * @param rules Rules to use for the traversal.
+   */
+  template<typename RuleType>
+  void DualTreeTraversal(Tree& queryTree, RuleType& rules);
+
+  /**
+   * Run a single-tree traversal of the reference tree for each of the given
+   * number of query points with the given rules.  If parallel search is enabled
+   * (and OpenMP is available), the query points are split between threads.
+   *
+   * @param numQueries Number of query points.
+   * @param rules Rules to use for the traversal.
+   */
+  template<typename RuleType>
+  void SingleTreeTraversal(const size_t numQueries, RuleType& rules);
+
   //! For access to mappings when building models.
   friend class TrainVisitor;
 };
@@ -17,6 +17,8 @@
 
 // The rules for traversal.
 #include "range_search_rules.hpp"
+#include "range_count_rules.hpp"
+#include <mlpack/core/tree/split_frontier.hpp>
 
 namespace mlpack {
 namespace range {
@@ -59,6 +61,8 @@ RangeSearch<MetricType, MatType, TreeType>::RangeSearch(
     setOwner(false),
     naive(naive),
     singleMode(!naive && singleMode), // Naive overrides single mode.
+    maxResults(0),
+    parallel(false),
     metric(metric),
     baseCases(0),
     scores(0)
@@ -85,6 +89,8 @@ RangeSearch<MetricType, MatType, TreeType>::RangeSearch(
     setOwner(naive),
     naive(naive),
     singleMode(!naive && singleMode),
+    maxResults(0),
+    parallel(false),
     metric(metric),
     baseCases(0),
     scores(0)
@@ -107,6 +113,8 @@ RangeSearch<MetricType, MatType, TreeType>::RangeSearch(
     setOwner(false),
     naive(false),
     singleMode(singleMode),
+    maxResults(0),
+    parallel(false),
     metric(metric),
     baseCases(0),
     scores(0)
@@ -129,6 +137,8 @@ RangeSearch<MetricType, MatType, TreeType>::RangeSearch(
     setOwner(true),
     naive(naive),
     singleMode(singleMode),
+    maxResults(0),
+    parallel(false),
     metric(metric),
     baseCases(0),
     scores(0)
@@ -157,6 +167,8 @@ RangeSearch<MetricType, MatType, TreeType>::RangeSearch(
     setOwner(!other.referenceTree),
     naive(other.naive),
     singleMode(other.singleMode),
+    maxResults(other.maxResults),
+    parallel(other.parallel),
     metric(other.metric),
     baseCases(other.baseCases),
     scores(other.scores)
@@ -177,6 +189,8 @@ RangeSearch<MetricType, MatType, TreeType>::RangeSearch(RangeSearch&& other) :
     setOwner(other.setOwner),
     naive(other.naive),
     singleMode(other.singleMode),
+    maxResults(other.maxResults),
+    parallel(other.parallel),
     metric(std::move(other.metric)),
     baseCases(other.baseCases),
     scores(other.scores)
@@ -190,6 +204,8 @@ RangeSearch<MetricType, MatType, TreeType>::RangeSearch(RangeSearch&& other) :
   other.setOwner = true;
   other.naive = false;
   other.singleMode = false;
+  other.maxResults = 0;
+  other.parallel = false;
   other.baseCases = 0;
   other.scores = 0;
 }
@@ -217,6 +233,8 @@ RangeSearch<MetricType, MatType, TreeType>::operator=(const RangeSearch& other)
   setOwner = !other.referenceTree;
   naive = other.naive;
   singleMode = other.singleMode;
+  maxResults = other.maxResults;
+  parallel = other.parallel;
   metric = other.metric;
   baseCases = other.baseCases;
   scores = other.scores;
@@ -246,6 +264,8 @@ RangeSearch<MetricType, MatType, TreeType>::operator=(RangeSearch&& other)
   setOwner = other.setOwner;
   naive = other.naive;
   singleMode = other.singleMode;
+  maxResults = other.maxResults;
+  parallel = other.parallel;
   metric = std::move(other.metric);
   baseCases = other.baseCases;
   scores = other.scores;
@@ -259,6 +279,8 @@ RangeSearch<MetricType, MatType, TreeType>::operator=(RangeSearch&& other)
   other.setOwner = true;
   other.naive = false;
   other.singleMode = false;
+  other.maxResults = 0;
+  other.parallel = false;
   other.baseCases = 0;
   other.scores = 0;
 
@@ -445,7 +467,7 @@ void RangeSearch<MetricType, MatType, TreeType>::Search(
   if (naive)
   {
     RuleType rules(*referenceSet, querySet, range, *neighborPtr, *distancePtr,
-        metric);
+        metric, false, maxResults);
 
     // The naive brute-force solution.
     for (size_t i = 0; i < querySet.n_cols; ++i)
@@ -456,17 +478,13 @@ void RangeSearch<MetricType, MatType, TreeType>::Search(
   }
   else if (singleMode)
   {
-    // Create the traverser.
     RuleType rules(*referenceSet, querySet, range, *neighborPtr, *distancePtr,
-        metric);
-    typename Tree::template SingleTreeTraverser<RuleType> traverser(rules);
-
-    // Now have it traverse for each point.
-    for (size_t i = 0; i < querySet.n_cols; ++i)
-      traverser.Traverse(i, *referenceTree);
+        metric, false, maxResults);
+    SingleTreeTraversal(querySet.n_cols, rules);
 
     baseCases += rules.BaseCases();
     scores += rules.Scores();
+    rules.Counters().Report();
   }
   else // Dual-tree recursion.
   {
@@ -477,15 +495,14 @@ void RangeSearch<MetricType, MatType, TreeType>::Search(
     Timer::Stop("range_search/tree_building");
     Timer::Start("range_search/computing_neighbors");
 
-    // Create the traverser.
+    // Create the rules.
     RuleType rules(*referenceSet, queryTree->Dataset(), range, *neighborPtr,
-        *distancePtr, metric);
-    typename Tree::template DualTreeTraverser<RuleType> traverser(rules);
-
-    traverser.Traverse(*queryTree, *referenceTree);
+        *distancePtr, metric, false, maxResults);
+    DualTreeTraversal(*queryTree, rules);
 
     baseCases += rules.BaseCases();
     scores += rules.Scores();
+    rules.Counters().Report();
 
     // Clean up tree memory.
     delete queryTree;
@@ -600,17 +617,15 @@ void RangeSearch<MetricType, MatType, TreeType>::Search(
   // Create the helper object for the traversal.
   typedef RangeSearchRules<MetricType, Tree> RuleType;
   RuleType rules(*referenceSet, queryTree->Dataset(), range, *neighborPtr,
-      distances, metric);
+      distances, metric, false, maxResults);
 
-  // Create the traverser.
-  typename Tree::template DualTreeTraverser<RuleType> traverser(rules);
-
-  traverser.Traverse(*queryTree, *referenceTree);
+  DualTreeTraversal(*queryTree, rules);
 
   Timer::Stop("range_search/computing_neighbors");
 
   baseCases = rules.BaseCases();
   scores = rules.Scores();
+  rules.Counters().Report();
 
   // Do we need to map indices?
   if (treeOwner && tree::TreeTraits<Tree>::RearrangesDataset)
@@ -667,7 +682,8 @@ void RangeSearch<MetricType, MatType, TreeType>::Search(
   // Create the helper object for the traversal.
   typedef RangeSearchRules<MetricType, Tree> RuleType;
   RuleType rules(*referenceSet, *referenceSet, range, *neighborPtr,
-      *distancePtr, metric, true /* don't return the query in the results */);
+      *distancePtr, metric, true /* don't return the query in the results */,
+      maxResults);
 
   if (naive)
   {
@@ -681,25 +697,19 @@ void RangeSearch<MetricType, MatType, TreeType>::Search(
   }
   else if (singleMode)
   {
-    // Create the traverser.
-    typename Tree::template SingleTreeTraverser<RuleType> traverser(rules);
-
-    // Now have it traverse for each point.
-    for (size_t i = 0; i < referenceSet->n_cols; ++i)
-      traverser.Traverse(i, *referenceTree);
+    SingleTreeTraversal(referenceSet->n_cols, rules);
 
     baseCases = rules.BaseCases();
     scores = rules.Scores();
+    rules.Counters().Report();
   }
   else // Dual-tree recursion.
   {
-    // Create the traverser.
-    typename Tree::template DualTreeTraverser<RuleType> traverser(rules);
-
-    traverser.Traverse(*referenceTree, *referenceTree);
+    DualTreeTraversal(*referenceTree, rules);
 
     baseCases = rules.BaseCases();
     scores = rules.Scores();
+    rules.Counters().Report();
   }
 
   Timer::Stop("range_search/computing_neighbors");
@@ -732,6 +742,232 @@ void RangeSearch<MetricType, MatType, TreeType>::Search(
   }
 }
 
+template<typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void RangeSearch<MetricType, MatType, TreeType>::Count(
+    const MatType& querySet,
+    const math::Range& range,
+    arma::Col<size_t>& counts)
+{
+  if (querySet.n_rows != referenceSet->n_rows)
+  {
+    std::ostringstream oss;
+    oss << "RangeSearch::Count(): dimensionalities of query set ("
+        << querySet.n_rows << ") and reference set (" << referenceSet->n_rows
+        << ") do not match!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  counts.zeros(querySet.n_cols);
+
+  // If there are no points, there is no search to be done.
+  if (referenceSet->n_cols == 0)
+    return;
+
+  Timer::Start("range_search/computing_neighbors");
+
+  typedef RangeCountRules<MetricType, Tree> RuleType;
+
+  if (naive)
+  {
+    RuleType rules(*referenceSet, querySet, range, counts, metric);
+
+    for (size_t i = 0; i < querySet.n_cols; ++i)
+      for (size_t j = 0; j < referenceSet->n_cols; ++j)
+        rules.BaseCase(i, j);
+
+    baseCases = (querySet.n_cols * referenceSet->n_cols);
+    scores = 0;
+  }
+  else if (singleMode)
+  {
+    RuleType rules(*referenceSet, querySet, range, counts, metric);
+    SingleTreeTraversal(querySet.n_cols, rules);
+
+    baseCases = rules.BaseCases();
+    scores = rules.Scores();
+    rules.Counters().Report();
+  }
+  else // Dual-tree recursion.
+  {
+    // Build the query tree.
+    std::vector<size_t> oldFromNewQueries;
+    Timer::Stop("range_search/computing_neighbors");
+    Timer::Start("range_search/tree_building");
+    Tree* queryTree = BuildTree<Tree>(querySet, oldFromNewQueries);
+    Timer::Stop("range_search/tree_building");
+    Timer::Start("range_search/computing_neighbors");
+
+    // The counts are in the order of the query tree's dataset.
+    arma::Col<size_t> treeCounts(querySet.n_cols, arma::fill::zeros);
+    RuleType rules(*referenceSet, queryTree->Dataset(), range, treeCounts,
+        metric);
+    DualTreeTraversal(*queryTree, rules);
+
+    baseCases = rules.BaseCases();
+    scores = rules.Scores();
+    rules.Counters().Report();
+
+    // Map the counts back to the original query indices, if necessary.
+    if (tree::TreeTraits<Tree>::RearrangesDataset)
+    {
+      for (size_t i = 0; i < treeCounts.n_elem; ++i)
+        counts[oldFromNewQueries[i]] = treeCounts[i];
+    }
+    else
+    {
+      counts = std::move(treeCounts);
+    }
+
+    delete queryTree;
+  }
+
+  Timer::Stop("range_search/computing_neighbors");
+}
+
+template<typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void RangeSearch<MetricType, MatType, TreeType>::Count(
+    const math::Range& range,
+    arma::Col<size_t>& counts)
+{
+  counts.zeros(referenceSet->n_cols);
+
+  // If there are no points, there is no search to be done.
+  if (referenceSet->n_cols == 0)
+    return;
+
+  Timer::Start("range_search/computing_neighbors");
+
+  // The counts are in the order of the reference tree's dataset.
+  arma::Col<size_t> treeCounts(referenceSet->n_cols, arma::fill::zeros);
+  typedef RangeCountRules<MetricType, Tree> RuleType;
+  RuleType rules(*referenceSet, *referenceSet, range, treeCounts, metric);
+
+  if (naive)
+  {
+    for (size_t i = 0; i < referenceSet->n_cols; ++i)
+      for (size_t j = 0; j < referenceSet->n_cols; ++j)
+        rules.BaseCase(i, j);
+
+    baseCases = (referenceSet->n_cols * referenceSet->n_cols);
+    scores = 0;
+  }
+  else if (singleMode)
+  {
+    SingleTreeTraversal(referenceSet->n_cols, rules);
+
+    baseCases = rules.BaseCases();
+    scores = rules.Scores();
+    rules.Counters().Report();
+  }
+  else // Dual-tree recursion.
+  {
+    DualTreeTraversal(*referenceTree, rules);
+
+    baseCases = rules.BaseCases();
+    scores = rules.Scores();
+    rules.Counters().Report();
+  }
+
+  // The rules count every point in its own range, at distance 0, so that whole
+  // nodes can be counted without looking for the query point in them.
+  if (range.Contains(0.0))
+    treeCounts -= 1;
+
+  Timer::Stop("range_search/computing_neighbors");
+
+  // Map the counts back to the original indices, if necessary.
+  if (treeOwner && tree::TreeTraits<Tree>::RearrangesDataset)
+  {
+    for (size_t i = 0; i < treeCounts.n_elem; ++i)
+      counts[oldFromNewReferences[i]] = treeCounts[i];
+  }
+  else
+  {
+    counts = std::move(treeCounts);
+  }
+}
+
+template<typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+template<typename RuleType>
+void RangeSearch<MetricType, MatType, TreeType>::DualTreeTraversal(
+    Tree& queryTree,
+    RuleType& rules)
+{
+#ifdef HAS_OPENMP
+  const size_t numThreads = omp_get_max_threads();
+  if (parallel && numThreads > 1)
+  {
+    // Split the query tree near the root until there are enough subtrees to
+    // keep all threads busy; each thread shares the results, and no two
+    // subtrees in the frontier hold the same query point.
+    const std::vector<Tree*> frontier = tree::SplitFrontier(queryTree,
+        8 * numThreads);
+    typedef typename Tree::template DualTreeTraverser<RuleType> TraverserType;
+    tree::TraverseFrontier<TraverserType>(frontier, *referenceTree, rules);
+
+    return;
+  }
+#endif
+
+  typename Tree::template DualTreeTraverser<RuleType> traverser(rules);
+  traverser.Traverse(queryTree, *referenceTree);
+}
+
+template<typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+template<typename RuleType>
+void RangeSearch<MetricType, MatType, TreeType>::SingleTreeTraversal(
+    const size_t numQueries,
+    RuleType& rules)
+{
+#ifdef HAS_OPENMP
+  // Trees with self-children cache base cases in the statistics of reference
+  // nodes while scoring, so those reference trees can't be shared between
+  // threads.
+  if (parallel && omp_get_max_threads() > 1 &&
+      !tree::TreeTraits<Tree>::HasSelfChildren)
+  {
+    #pragma omp parallel
+    {
+      // Each thread has its own rules and traverser, and works on its own
+      // query points, so the shared results are never touched by two threads
+      // at once.
+      RuleType threadRules(rules);
+      typename Tree::template SingleTreeTraverser<RuleType>
+          traverser(threadRules);
+
+      #pragma omp for schedule(dynamic, 16)
+      for (omp_size_t i = 0; i < (omp_size_t) numQueries; ++i)
+        traverser.Traverse(i, *referenceTree);
+
+      #pragma omp critical
+      rules.Counters() += threadRules.Counters();
+    }
+
+    return;
+  }
+#endif
+
+  typename Tree::template SingleTreeTraverser<RuleType> traverser(rules);
+  for (size_t i = 0; i < numQueries; ++i)
+    traverser.Traverse(i, *referenceTree);
+}
+
 template<typename MetricType,
          typename MatType,
          template<typename TreeMetricType,
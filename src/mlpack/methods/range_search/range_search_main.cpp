@@ -16,6 +16,7 @@
 #include <mlpack/core/util/mlpack_main.hpp>
 #include <mlpack/core/metrics/lmetric.hpp>
 #include <mlpack/core/tree/cover_tree.hpp>
+#include <mlpack/core/data/extension.hpp>
 
 #include "range_search.hpp"
 #include "rs_model.hpp"
@@ -55,7 +56,11 @@ PROGRAM_INFO("Range Search",
     " resultant CSV-like files may not be loadable by many programs.  However, "
     "at this time a better way to store this non-square result is not known.  "
     "As a result, any output files will be written as CSVs in this manner, "
-    "regardless of the given extension.");
+    "unless their extension is '.bin'.  Those are written in binary: for each "
+    "query point, the number of results as a 64-bit unsigned integer, followed "
+    "by the results (64-bit unsigned integers for neighbors and doubles for "
+    "distances), in the byte order of the machine.  This is much faster to "
+    "write and read for large results.");
 
 // Define our input parameters that this program will take.
 PARAM_MATRIX_IN("reference", "Matrix containing the reference dataset.", "r");
@@ -90,6 +95,61 @@ PARAM_INT_IN("seed", "Random seed (if 0, std::time(NULL) is used).", "s", 0);
 PARAM_FLAG("naive", "If true, O(n^2) naive mode is used for computation.", "N");
 PARAM_FLAG("single_mode", "If true, single-tree search is used (as opposed to "
     "dual-tree search).", "S");
+PARAM_FLAG("parallel", "If set, the tree traversal is split between OpenMP "
+    "threads (the number of threads can be controlled with the OMP_NUM_THREADS "
+    "environment variable).", "P");
+
+// Save range search results, one line (or one block, for a .bin file) per query
+// point.
+template<typename T>
+void SaveResults(const string& filename,
+                 const vector<vector<T>>& results,
+                 const string& description)
+{
+  const bool binary = (data::Extension(filename) == "bin");
+  fstream stream(filename.c_str(), binary ? (fstream::out | fstream::binary) :
+      fstream::out);
+  if (!stream.is_open())
+  {
+    Log::Warn << "Cannot open file '" << filename << "' to save output "
+        << description << " to!" << endl;
+    return;
+  }
+
+  if (binary)
+  {
+    // The values are written as 64-bit integers or doubles.
+    typedef typename std::conditional<std::is_integral<T>::value, uint64_t,
+        double>::type OutputType;
+    for (size_t i = 0; i < results.size(); ++i)
+    {
+      const uint64_t count = results[i].size();
+      stream.write((const char*) &count, sizeof(uint64_t));
+      const vector<OutputType> values(results[i].begin(), results[i].end());
+      if (!values.empty())
+        stream.write((const char*) values.data(), count * sizeof(OutputType));
+    }
+  }
+  else
+  {
+    // Loop over each point.  We may have 0 results to store for a point, so we
+    // must account for that possibility.
+    for (size_t i = 0; i < results.size(); ++i)
+    {
+      for (size_t j = 0; j + 1 < results[i].size(); ++j)
+        stream << results[i][j] << ", ";
+
+      if (results[i].size() > 0)
+        stream << results[i][results[i].size() - 1];
+
+      stream << '\n';
+    }
+  }
+
+  if (!stream.good())
+    Log::Warn << "Error while saving output " << description << " to '"
+        << filename << "'!" << endl;
+}
 
 void mlpackMain()
 {
@@ -210,6 +270,8 @@ void mlpackMain()
   // Perform search, if desired.
   if (CLI::HasParam("min") || CLI::HasParam("max"))
   {
+    rs.Parallel() = CLI::HasParam("parallel");
+
     const double min = CLI::GetParam<double>("min");
     const double max = CLI::HasParam("max") ? CLI::GetParam<double>("max") :
         DBL_MAX;
@@ -244,60 +306,14 @@ void mlpackMain()
     // Save output, if desired.  We have to do this by hand.
     if (CLI::HasParam("distances_file"))
     {
-      const string distancesFile = CLI::GetParam<string>("distances_file");
-      fstream distancesStr(distancesFile.c_str(), fstream::out);
-      if (!distancesStr.is_open())
-      {
-        Log::Warn << "Cannot open file '" << distancesFile << "' to save output"
-            << " distances to!" << endl;
-      }
-      else
-      {
-        // Loop over each point.
-        for (size_t i = 0; i < distances.size(); ++i)
-        {
-          // Store the distances of each point.  We may have 0 points to store,
-          // so we must account for that possibility.
-          for (size_t j = 0; j + 1 < distances[i].size(); ++j)
-            distancesStr << distances[i][j] << ", ";
-
-          if (distances[i].size() > 0)
-            distancesStr << distances[i][distances[i].size() - 1];
-
-          distancesStr << endl;
-        }
-
-        distancesStr.close();
-      }
+      SaveResults(CLI::GetParam<string>("distances_file"), distances,
+          "distances");
     }
 
     if (CLI::HasParam("neighbors_file"))
     {
-      const string neighborsFile = CLI::GetParam<string>("neighbors_file");
-      fstream neighborsStr(neighborsFile.c_str(), fstream::out);
-      if (!neighborsStr.is_open())
-      {
-        Log::Warn << "Cannot open file '" << neighborsFile << "' to save output"
-            << " neighbor indices to!" << endl;
-      }
-      else
-      {
-        // Loop over each point.
-        for (size_t i = 0; i < neighbors.size(); ++i)
-        {
-          // Store the neighbors of each point.  We may have 0 points to store,
-          // so we must account for that possibility.
-          for (size_t j = 0; j + 1 < neighbors[i].size(); ++j)
-            neighborsStr << neighbors[i][j] << ", ";
-
-          if (neighbors[i].size() > 0)
-            neighborsStr << neighbors[i][neighbors[i].size() - 1];
-
-          neighborsStr << endl;
-        }
-
-        neighborsStr.close();
-      }
+      SaveResults(CLI::GetParam<string>("neighbors_file"), neighbors,
+          "neighbor indices");
     }
   }
 
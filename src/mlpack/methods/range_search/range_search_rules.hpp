@@ -12,6 +12,7 @@
 #ifndef MLPACK_METHODS_RANGE_SEARCH_RANGE_SEARCH_RULES_HPP
 #define MLPACK_METHODS_RANGE_SEARCH_RANGE_SEARCH_RULES_HPP
 
+#include <mlpack/core/tree/traversal_counters.hpp>
 #include <mlpack/core/tree/traversal_info.hpp>
 
 namespace mlpack {
@@ -40,14 +41,29 @@ class RangeSearchRules
    * @param metric Instantiated metric.
    * @param sameSet If true, the query and reference set are taken to be the
    *      same, and a query point will not return itself in the results.
+   * @param maxResults If nonzero, at most this many results are stored for
+   *      each query point, and query points (or query nodes) whose results are
+   *      full are pruned.
    */
-  RangeSearchRules(const arma::mat& referenceSet,
-                   const arma::mat& querySet,
+  RangeSearchRules(const typename TreeType::Mat& referenceSet,
+                   const typename TreeType::Mat& querySet,
                    const math::Range& range,
                    std::vector<std::vector<size_t> >& neighbors,
                    std::vector<std::vector<double> >& distances,
                    MetricType& metric,
-                   const bool sameSet = false);
+                   const bool sameSet = false,
+                   const size_t maxResults = 0);
+
+  /**
+   * Construct a RangeSearchRules object that shares the result lists of the
+   * given rules object, but has its own base case cache, traversal info, and
+   * counters.  This is used by parallel traversals to give each thread its own
+   * rules object.  It is only safe as long as no two threads ever work on the
+   * same query point (or query node) at the same time.
+   *
+   * @param other Rules object whose result lists will be shared.
+   */
+  RangeSearchRules(RangeSearchRules& other);
 
   /**
    * Compute the base case between the given query point and reference point.
@@ -57,6 +73,19 @@ class RangeSearchRules
    */
   double BaseCase(const size_t queryIndex, const size_t referenceIndex);
 
+  /**
+   * Compute the base cases between the given query point and each point of a
+   * contiguous block of reference points.  This is equivalent to calling
+   * BaseCase() for each of the reference points, but faster.
+   *
+   * @param queryIndex Index of query point.
+   * @param referenceBegin Index of the first reference point of the block.
+   * @param referenceCount Number of reference points in the block.
+   */
+  void BaseCaseBlock(const size_t queryIndex,
+                     const size_t referenceBegin,
+                     const size_t referenceCount);
+
   /**
    * Get the score for recursion order.  A low score indicates priority for
    * recursion, while DBL_MAX indicates that the node should not be recursed
@@ -113,16 +142,21 @@ class RangeSearchRules
   TraversalInfoType& TraversalInfo() { return traversalInfo; }
 
   //! Get the number of base cases.
-  size_t BaseCases() const { return baseCases; }
+  size_t BaseCases() const { return counters.BaseCases(); }
   //! Get the number of scores (that is, calls to RangeDistance()).
-  size_t Scores() const { return scores; }
+  size_t Scores() const { return counters.Scores(); }
+
+  //! Get the traversal counters.
+  const tree::TraversalCounters& Counters() const { return counters; }
+  //! Modify the traversal counters.
+  tree::TraversalCounters& Counters() { return counters; }
 
  private:
   //! The reference set.
-  const arma::mat& referenceSet;
+  const typename TreeType::Mat& referenceSet;
 
   //! The query set.
-  const arma::mat& querySet;
+  const typename TreeType::Mat& querySet;
 
   //! The range of distances for which we are searching.
   const math::Range& range;
@@ -139,10 +173,15 @@ class RangeSearchRules
   //! If true, the query and reference set are taken to be the same.
   bool sameSet;
 
+  //! The maximum number of results for each query point (0 means no limit).
+  size_t maxResults;
+
   //! The last query index.
   size_t lastQueryIndex;
   //! The last reference index.
   size_t lastReferenceIndex;
+  //! The distances computed by the last call to BaseCaseBlock().
+  arma::vec blockDistances;
 
   //! Add all the points in the given node to the results for the given query
   //! point.  If the base case has already been calculated, we make sure to not
@@ -150,12 +189,20 @@ class RangeSearchRules
   void AddResult(const size_t queryIndex,
                  TreeType& referenceNode);
 
+  //! Return true if the results of the given query point are full.
+  bool Full(const size_t queryIndex) const
+  {
+    return (maxResults != 0) && (neighbors[queryIndex].size() >= maxResults);
+  }
+
+  //! Return true if the results of every point in the given query node are
+  //! full.
+  bool Full(TreeType& queryNode) const;
+
   TraversalInfoType traversalInfo;
 
-  //! The number of base cases.
-  size_t baseCases;
-  //! THe number of scores.
-  size_t scores;
+  //! The counters of base cases, scores, prunes, and node visits.
+  tree::TraversalCounters counters;
 };
 
 } // namespace range
@@ -14,19 +14,21 @@
 
 // In case it hasn't been included yet.
 #include "range_search_rules.hpp"
+#include <mlpack/core/metrics/evaluate_block.hpp>
 
 namespace mlpack {
 namespace range {
 
 template<typename MetricType, typename TreeType>
 RangeSearchRules<MetricType, TreeType>::RangeSearchRules(
-    const arma::mat& referenceSet,
-    const arma::mat& querySet,
+    const typename TreeType::Mat& referenceSet,
+    const typename TreeType::Mat& querySet,
     const math::Range& range,
     std::vector<std::vector<size_t> >& neighbors,
     std::vector<std::vector<double> >& distances,
     MetricType& metric,
-    const bool sameSet) :
+    const bool sameSet,
+    const size_t maxResults) :
     referenceSet(referenceSet),
     querySet(querySet),
     range(range),
@@ -34,10 +36,26 @@ RangeSearchRules<MetricType, TreeType>::RangeSearchRules(
     distances(distances),
     metric(metric),
     sameSet(sameSet),
+    maxResults(maxResults),
     lastQueryIndex(querySet.n_cols),
-    lastReferenceIndex(referenceSet.n_cols),
-    baseCases(0),
-    scores(0)
+    lastReferenceIndex(referenceSet.n_cols)
+{
+  // Nothing to do.
+}
+
+template<typename MetricType, typename TreeType>
+RangeSearchRules<MetricType, TreeType>::RangeSearchRules(
+    RangeSearchRules& other) :
+    referenceSet(other.referenceSet),
+    querySet(other.querySet),
+    range(other.range),
+    neighbors(other.neighbors),
+    distances(other.distances),
+    metric(other.metric),
+    sameSet(other.sameSet),
+    maxResults(other.maxResults),
+    lastQueryIndex(querySet.n_cols),
+    lastReferenceIndex(referenceSet.n_cols)
 {
   // Nothing to do.
 }
@@ -60,13 +78,13 @@ double RangeSearchRules<MetricType, TreeType>::BaseCase(
 
   const double distance = metric.Evaluate(querySet.unsafe_col(queryIndex),
       referenceSet.unsafe_col(referenceIndex));
-  ++baseCases;
+  counters.BaseCase();
 
   // Update last indices, so we don't accidentally perform a base case twice.
   lastQueryIndex = queryIndex;
   lastReferenceIndex = referenceIndex;
 
-  if (range.Contains(distance))
+  if (range.Contains(distance) && !Full(queryIndex))
   {
     neighbors[queryIndex].push_back(referenceIndex);
     distances[queryIndex].push_back(distance);
@@ -75,11 +93,48 @@ double RangeSearchRules<MetricType, TreeType>::BaseCase(
   return distance;
 }
 
+template<typename MetricType, typename TreeType>
+void RangeSearchRules<MetricType, TreeType>::BaseCaseBlock(
+    const size_t queryIndex,
+    const size_t referenceBegin,
+    const size_t referenceCount)
+{
+  metric::EvaluateBlock(metric, querySet.unsafe_col(queryIndex), referenceSet,
+      referenceBegin, referenceCount, blockDistances);
+
+  for (size_t i = 0; i < referenceCount; ++i)
+  {
+    const size_t referenceIndex = referenceBegin + i;
+
+    // Skip the same base cases that BaseCase() would skip.
+    if (sameSet && (queryIndex == referenceIndex))
+      continue;
+    if ((lastQueryIndex == queryIndex) &&
+        (lastReferenceIndex == referenceIndex))
+      continue;
+
+    counters.BaseCase();
+    lastQueryIndex = queryIndex;
+    lastReferenceIndex = referenceIndex;
+
+    if (range.Contains(blockDistances[i]) && !Full(queryIndex))
+    {
+      neighbors[queryIndex].push_back(referenceIndex);
+      distances[queryIndex].push_back(blockDistances[i]);
+    }
+  }
+}
+
 //! Single-tree scoring function.
 template<typename MetricType, typename TreeType>
 double RangeSearchRules<MetricType, TreeType>::Score(const size_t queryIndex,
                                                      TreeType& referenceNode)
 {
+  // If the results of this query point are full, there is nothing to search
+  // for.
+  if (Full(queryIndex))
+    return counters.ScoreResult(DBL_MAX);
+
   // We must get the minimum and maximum distances and store them in this
   // object.
   math::Range distances;
@@ -115,24 +170,24 @@ double RangeSearchRules<MetricType, TreeType>::Score(const size_t queryIndex,
   else
   {
     distances = referenceNode.RangeDistance(querySet.unsafe_col(queryIndex));
-    ++scores;
+    counters.Score();
   }
 
   // If the ranges do not overlap, prune this node.
   if (!distances.Contains(range))
-    return DBL_MAX;
+    return counters.ScoreResult(DBL_MAX);
 
   // In this case, all of the points in the reference node will be part of the
   // results.
   if ((distances.Lo() >= range.Lo()) && (distances.Hi() <= range.Hi()))
   {
     AddResult(queryIndex, referenceNode);
-    return DBL_MAX; // We don't need to go any deeper.
+    return counters.ScoreResult(DBL_MAX); // We don't need to go any deeper.
   }
 
   // Otherwise the score doesn't matter.  Recursion order is irrelevant in
   // range search.
-  return 0.0;
+  return counters.ScoreResult(0.0);
 }
 
 //! Single-tree rescoring function.
@@ -151,6 +206,11 @@ template<typename MetricType, typename TreeType>
 double RangeSearchRules<MetricType, TreeType>::Score(TreeType& queryNode,
                                                      TreeType& referenceNode)
 {
+  // If the results of every query point in the node are full, there is nothing
+  // to search for.
+  if ((maxResults != 0) && Full(queryNode))
+    return counters.ScoreResult(DBL_MAX);
+
   math::Range distances;
   if (tree::TreeTraits<TreeType>::FirstPointIsCentroid)
   {
@@ -185,12 +245,12 @@ double RangeSearchRules<MetricType, TreeType>::Score(TreeType& queryNode,
   {
     // Just perform the calculation.
     distances = referenceNode.RangeDistance(queryNode);
-    ++scores;
+    counters.Score();
   }
 
   // If the ranges do not overlap, prune this node.
   if (!distances.Contains(range))
-    return DBL_MAX;
+    return counters.ScoreResult(DBL_MAX);
 
   // In this case, all of the points in the reference node will be part of all
   // the results for each point in the query node.
@@ -198,14 +258,14 @@ double RangeSearchRules<MetricType, TreeType>::Score(TreeType& queryNode,
   {
     for (size_t i = 0; i < queryNode.NumDescendants(); ++i)
       AddResult(queryNode.Descendant(i), referenceNode);
-    return DBL_MAX; // We don't need to go any deeper.
+    return counters.ScoreResult(DBL_MAX); // We don't need to go any deeper.
   }
 
   // Otherwise the score doesn't matter.  Recursion order is irrelevant in range
   // search.
   traversalInfo.LastQueryNode() = &queryNode;
   traversalInfo.LastReferenceNode() = &referenceNode;
-  return 0.0;
+  return counters.ScoreResult(0.0);
 }
 
 //! Dual-tree rescoring function.
@@ -240,13 +300,17 @@ void RangeSearchRules<MetricType, TreeType>::AddResult(const size_t queryIndex,
   // reserve() and not resize(), because we don't know if we will encounter the
   // case where the datasets and points are the same (and we skip in that case).
   const size_t oldSize = neighbors[queryIndex].size();
-  neighbors[queryIndex].reserve(oldSize + referenceNode.NumDescendants() -
-      baseCaseMod);
-  distances[queryIndex].reserve(oldSize + referenceNode.NumDescendants() -
-      baseCaseMod);
+  size_t newSize = oldSize + referenceNode.NumDescendants() - baseCaseMod;
+  if ((maxResults != 0) && (newSize > maxResults))
+    newSize = std::max(oldSize, maxResults);
+  neighbors[queryIndex].reserve(newSize);
+  distances[queryIndex].reserve(newSize);
 
   for (size_t i = baseCaseMod; i < referenceNode.NumDescendants(); ++i)
   {
+    if (Full(queryIndex))
+      break;
+
     if ((&referenceSet == &querySet) &&
         (queryIndex == referenceNode.Descendant(i)))
       continue;
@@ -259,6 +323,18 @@ void RangeSearchRules<MetricType, TreeType>::AddResult(const size_t queryIndex,
   }
 }
 
+//! Return true if the results of every point in the given query node are full.
+template<typename MetricType, typename TreeType>
+bool RangeSearchRules<MetricType, TreeType>::Full(TreeType& queryNode) const
+{
+  // This usually stops at the first descendant, unless the node can be pruned.
+  for (size_t i = 0; i < queryNode.NumDescendants(); ++i)
+    if (!Full(queryNode.Descendant(i)))
+      return false;
+
+  return true;
+}
+
 } // namespace range
 } // namespace mlpack
 
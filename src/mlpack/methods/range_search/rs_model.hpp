@@ -30,8 +30,9 @@ namespace range {
  */
 template<template<typename TreeMetricType,
                   typename TreeStatType,
-                  typename TreeMatType> class TreeType>
-using RSType = RangeSearch<metric::EuclideanDistance, arma::mat, TreeType>;
+                  typename TreeMatType> class TreeType,
+         typename MatType = arma::mat>
+using RSType = RangeSearch<metric::EuclideanDistance, MatType, TreeType>;
 
 /**
  * MonoSearchVisitor executes a monochromatic range search on the given
@@ -68,11 +69,12 @@ class MonoSearchVisitor : public  boost::static_visitor<void>
  * accept leafSize as a parameter. In these cases, before doing range search,
  * a query tree with proper leafSize is built from the querySet.
  */
+template<typename MatType = arma::mat>
 class BiSearchVisitor : public boost::static_visitor<void>
 {
  private:
   //! The query set for the bichromatic search.
-  const arma::mat& querySet;
+  const MatType& querySet;
   //! Range to search neighbours for.
   const math::Range& range;
   //! The result vector for neighbors.
@@ -91,7 +93,7 @@ class BiSearchVisitor : public boost::static_visitor<void>
   template<template<typename TreeMetricType,
                     typename TreeStatType,
                     typename TreeMatType> class TreeType>
-  using RSTypeT = RSType<TreeType>;
+  using RSTypeT = RSType<TreeType, MatType>;
 
   //! Default Bichromatic range search on the given RSType instance.
   template<template<typename TreeMetricType,
@@ -109,7 +111,7 @@ class BiSearchVisitor : public boost::static_visitor<void>
   void operator()(RSTypeT<tree::Octree>* rs) const;
 
   //! Construct the BiSearchVisitor.
-  BiSearchVisitor(const arma::mat& querySet,
+  BiSearchVisitor(const MatType& querySet,
                   const math::Range& range,
                   std::vector<std::vector<size_t>>& neighbors,
                   std::vector<std::vector<double>>& distances,
@@ -122,11 +124,12 @@ class BiSearchVisitor : public boost::static_visitor<void>
  * accept leafSize as a parameter. In these cases, a reference tree with proper
  * leafSize is built from the referenceSet.
  */
+template<typename MatType = arma::mat>
 class TrainVisitor : public boost::static_visitor<void>
 {
  private:
   //! The reference set to use for training.
-  arma::mat&& referenceSet;
+  MatType&& referenceSet;
   //! The leaf size, used only by BinarySpaceTree.
   size_t leafSize;
   //! Train on the given RsType considering the leafSize.
@@ -138,7 +141,7 @@ class TrainVisitor : public boost::static_visitor<void>
   template<template<typename TreeMetricType,
                     typename TreeStatType,
                     typename TreeMatType> class TreeType>
-  using RSTypeT = RSType<TreeType>;
+  using RSTypeT = RSType<TreeType, MatType>;
 
   //! Default Train on the given RSType instance.
   template<template<typename TreeMetricType,
@@ -156,19 +159,20 @@ class TrainVisitor : public boost::static_visitor<void>
   void operator()(RSTypeT<tree::Octree>* rs) const;
 
   //! Construct the TrainVisitor object with the given reference set, leafSize
-  TrainVisitor(arma::mat&& referenceSet,
+  TrainVisitor(MatType&& referenceSet,
                const size_t leafSize);
 };
 
 /**
  * ReferenceSetVisitor exposes the referenceSet of the given RSType.
  */
-class ReferenceSetVisitor : public boost::static_visitor<const arma::mat&>
+template<typename MatType = arma::mat>
+class ReferenceSetVisitor : public boost::static_visitor<const MatType&>
 {
  public:
   //! Return the reference set.
   template<typename RSType>
-  const arma::mat& operator()(RSType* rs) const;
+  const MatType& operator()(RSType* rs) const;
 };
 
 /**
@@ -209,7 +213,28 @@ class NaiveVisitor : public boost::static_visitor<bool&>
   bool& operator()(RSType* rs) const;
 };
 
-class RSModel
+/**
+ * ParallelVisitor exposes the Parallel() method of the given RSType.
+ */
+class ParallelVisitor : public boost::static_visitor<bool&>
+{
+ public:
+  //! Return whether or not the search is parallelized.
+  template<typename RSType>
+  bool& operator()(RSType* rs) const;
+};
+
+/**
+ * The RSModelType class provides an easy way to serialize a range search model,
+ * abstracts away the different types of trees, and also reflects the
+ * RangeSearch API.  It is templated on the type of the dataset, so that (for
+ * instance) single-precision datasets can be searched with
+ * RSModelType<arma::fmat>; the usual double-precision model is RSModel.
+ *
+ * @tparam MatType The type of data matrix.
+ */
+template<typename MatType>
+class RSModelType
 {
  public:
   enum TreeTypes
@@ -237,27 +262,27 @@ class RSModel
   //! If true, we randomly project the data into a new basis before search.
   bool randomBasis;
   //! Random projection matrix.
-  arma::mat q;
+  MatType q;
 
   /**
    * rSearch holds an instance of the RangeSearch class for the current
    * treeType. It is initialized every time BuildModel is executed.
    * We access to the contained value through the visitor classes defined above.
    */
-  boost::variant<RSType<tree::KDTree>*,
-                 RSType<tree::StandardCoverTree>*,
-                 RSType<tree::RTree>*,
-                 RSType<tree::RStarTree>*,
-                 RSType<tree::BallTree>*,
-                 RSType<tree::XTree>*,
-                 RSType<tree::HilbertRTree>*,
-                 RSType<tree::RPlusTree>*,
-                 RSType<tree::RPlusPlusTree>*,
-                 RSType<tree::VPTree>*,
-                 RSType<tree::RPTree>*,
-                 RSType<tree::MaxRPTree>*,
-                 RSType<tree::UBTree>*,
-                 RSType<tree::Octree>*> rSearch;
+  boost::variant<RSType<tree::KDTree, MatType>*,
+                 RSType<tree::StandardCoverTree, MatType>*,
+                 RSType<tree::RTree, MatType>*,
+                 RSType<tree::RStarTree, MatType>*,
+                 RSType<tree::BallTree, MatType>*,
+                 RSType<tree::XTree, MatType>*,
+                 RSType<tree::HilbertRTree, MatType>*,
+                 RSType<tree::RPlusTree, MatType>*,
+                 RSType<tree::RPlusPlusTree, MatType>*,
+                 RSType<tree::VPTree, MatType>*,
+                 RSType<tree::RPTree, MatType>*,
+                 RSType<tree::MaxRPTree, MatType>*,
+                 RSType<tree::UBTree, MatType>*,
+                 RSType<tree::Octree, MatType>*> rSearch;
 
  public:
   /**
@@ -267,48 +292,48 @@ class RSModel
    * @param treeType Type of tree to use.
    * @param randomBasis Whether or not to use a random basis.
    */
-  RSModel(const TreeTypes treeType = TreeTypes::KD_TREE,
-          const bool randomBasis = false);
+  RSModelType(const TreeTypes treeType = TreeTypes::KD_TREE,
+              const bool randomBasis = false);
 
   /**
    * Copy the given RSModel.
    *
    * @param other RSModel to copy.
    */
-  RSModel(const RSModel& other);
+  RSModelType(const RSModelType& other);
 
   /**
    * Take ownership of the given RSModel.
    *
    * @param other RSModel to take ownership of.
    */
-  RSModel(RSModel&& other);
+  RSModelType(RSModelType&& other);
 
   /**
    * Copy the given RSModel.
    *
    * @param other RSModel to copy.
    */
-  RSModel& operator=(const RSModel& other);
+  RSModelType& operator=(const RSModelType& other);
 
   /**
    * Take ownership of the given RSModel.
    *
    * @param other RSModel to take ownership of.
    */
-  RSModel& operator=(RSModel&& other);
+  RSModelType& operator=(RSModelType&& other);
 
   /**
    * Clean memory, if necessary.
    */
-  ~RSModel();
+  ~RSModelType();
 
   //! Serialize the range search model.
   template<typename Archive>
   void serialize(Archive& ar, const unsigned int /* version */);
 
   //! Expose the dataset.
-  const arma::mat& Dataset() const;
+  const MatType& Dataset() const;
 
   //! Get whether the model is in single-tree search mode.
   bool SingleMode() const;
@@ -320,6 +345,11 @@ class RSModel
   //! Modify whether the model is in naive search mode.
   bool& Naive();
 
+  //! Get whether tree traversals are parallelized with OpenMP.
+  bool Parallel() const;
+  //! Modify whether tree traversals are parallelized with OpenMP.
+  bool& Parallel();
+
   //! Get the leaf size (applicable to everything but the cover tree).
   size_t LeafSize() const { return leafSize; }
   //! Modify the leaf size (applicable to everything but the cover tree).
@@ -345,7 +375,7 @@ class RSModel
    * @param naive Whether naive search should be used.
    * @param singleMode Whether single-tree search should be used.
    */
-  void BuildModel(arma::mat&& referenceSet,
+  void BuildModel(MatType&& referenceSet,
                   const size_t leafSize,
                   const bool naive,
                   const bool singleMode);
@@ -360,7 +390,7 @@ class RSModel
    * @param neighbors Output: neighbors falling within the desired range.
    * @param distances Output: distances of neighbors.
    */
-  void Search(arma::mat&& querySet,
+  void Search(MatType&& querySet,
               const math::Range& range,
               std::vector<std::vector<size_t>>& neighbors,
               std::vector<std::vector<double>>& distances);
@@ -378,19 +408,22 @@ class RSModel
               std::vector<std::vector<size_t>>& neighbors,
               std::vector<std::vector<double>>& distances);
 
- private:
   /**
    * Return a string representing the name of the tree.  This is used for
    * logging output.
    */
   std::string TreeName() const;
 
+ private:
   /**
    * Clean up memory.
    */
   void CleanMemory();
 };
 
+//! The range search model for double-precision datasets.
+typedef RSModelType<arma::mat> RSModel;
+
 } // namespace range
 } // namespace mlpack
 
@@ -2,7 +2,7 @@
  * @file rs_model_impl.hpp
  * @author Ryan Curtin
  *
- * Implementation of serialize() and inline functions for RSModel.
+ * Implementation of RSModelType and its visitors.
  *
  * mlpack is free software; you may redistribute it and/or modify it under the
  * terms of the 3-clause BSD license.  You should have received a copy of the
@@ -25,7 +25,8 @@ namespace range {
  * Initialize the RSModel with the given tree type and whether or not a random
  * basis should be used.
  */
-inline RSModel::RSModel(TreeTypes treeType, bool randomBasis) :
+template<typename MatType>
+RSModelType<MatType>::RSModelType(TreeTypes treeType, bool randomBasis) :
     treeType(treeType),
     leafSize(0),
     randomBasis(randomBasis)
@@ -34,7 +35,8 @@ inline RSModel::RSModel(TreeTypes treeType, bool randomBasis) :
 }
 
 // Copy constructor.
-inline RSModel::RSModel(const RSModel& other) :
+template<typename MatType>
+RSModelType<MatType>::RSModelType(const RSModelType& other) :
     treeType(other.treeType),
     leafSize(other.leafSize),
     randomBasis(other.randomBasis),
@@ -45,7 +47,8 @@ inline RSModel::RSModel(const RSModel& other) :
 }
 
 // Move constructor.
-inline RSModel::RSModel(RSModel&& other) :
+template<typename MatType>
+RSModelType<MatType>::RSModelType(RSModelType&& other) :
     treeType(other.treeType),
     leafSize(other.leafSize),
     randomBasis(other.randomBasis),
@@ -60,7 +63,8 @@ inline RSModel::RSModel(RSModel&& other) :
 }
 
 // Copy operator.
-inline RSModel& RSModel::operator=(const RSModel& other)
+template<typename MatType>
+RSModelType<MatType>& RSModelType<MatType>::operator=(const RSModelType& other)
 {
   boost::apply_visitor(DeleteVisitor(), rSearch);
 
@@ -74,7 +78,8 @@ inline RSModel& RSModel::operator=(const RSModel& other)
 }
 
 // Move operator.
-inline RSModel& RSModel::operator=(RSModel&& other)
+template<typename MatType>
+RSModelType<MatType>& RSModelType<MatType>::operator=(RSModelType&& other)
 {
   boost::apply_visitor(DeleteVisitor(), rSearch);
 
@@ -94,21 +99,25 @@ inline RSModel& RSModel::operator=(RSModel&& other)
 }
 
 // Clean memory, if necessary.
-inline RSModel::~RSModel()
+template<typename MatType>
+RSModelType<MatType>::~RSModelType()
 {
   boost::apply_visitor(DeleteVisitor(), rSearch);
 }
 
-inline void RSModel::BuildModel(arma::mat&& referenceSet,
-                                const size_t leafSize,
-                                const bool naive,
-                                const bool singleMode)
+template<typename MatType>
+void RSModelType<MatType>::BuildModel(MatType&& referenceSet,
+                                      const size_t leafSize,
+                                      const bool naive,
+                                      const bool singleMode)
 {
   // Initialize random basis if necessary.
   if (randomBasis)
   {
     Log::Info << "Creating random basis..." << std::endl;
-    math::RandomBasis(q, referenceSet.n_rows);
+    arma::mat basis;
+    math::RandomBasis(basis, referenceSet.n_rows);
+    q = arma::conv_to<MatType>::from(basis);
   }
 
   this->leafSize = leafSize;
@@ -129,63 +138,63 @@ inline void RSModel::BuildModel(arma::mat&& referenceSet,
   switch (treeType)
   {
     case KD_TREE:
-      rSearch = new RSType<tree::KDTree> (naive, singleMode);
+      rSearch = new RSType<tree::KDTree, MatType>(naive, singleMode);
       break;
 
     case COVER_TREE:
-      rSearch = new RSType<tree::StandardCoverTree>(naive, singleMode);
+      rSearch = new RSType<tree::StandardCoverTree, MatType>(naive, singleMode);
       break;
 
     case R_TREE:
-      rSearch = new RSType<tree::RTree>(naive, singleMode);
+      rSearch = new RSType<tree::RTree, MatType>(naive, singleMode);
       break;
 
     case R_STAR_TREE:
-      rSearch = new RSType<tree::RStarTree>(naive, singleMode);
+      rSearch = new RSType<tree::RStarTree, MatType>(naive, singleMode);
       break;
 
     case BALL_TREE:
-      rSearch = new RSType<tree::BallTree>(naive, singleMode);
+      rSearch = new RSType<tree::BallTree, MatType>(naive, singleMode);
       break;
 
     case X_TREE:
-      rSearch = new RSType<tree::XTree>(naive, singleMode);
+      rSearch = new RSType<tree::XTree, MatType>(naive, singleMode);
       break;
 
     case HILBERT_R_TREE:
-      rSearch = new RSType<tree::HilbertRTree>(naive, singleMode);
+      rSearch = new RSType<tree::HilbertRTree, MatType>(naive, singleMode);
       break;
 
     case R_PLUS_TREE:
-      rSearch = new RSType<tree::RPlusTree>(naive, singleMode);
+      rSearch = new RSType<tree::RPlusTree, MatType>(naive, singleMode);
       break;
 
     case R_PLUS_PLUS_TREE:
-      rSearch = new RSType<tree::RPlusPlusTree>(naive, singleMode);
+      rSearch = new RSType<tree::RPlusPlusTree, MatType>(naive, singleMode);
       break;
 
     case VP_TREE:
-      rSearch = new RSType<tree::VPTree>(naive, singleMode);
+      rSearch = new RSType<tree::VPTree, MatType>(naive, singleMode);
       break;
 
     case RP_TREE:
-      rSearch = new RSType<tree::RPTree>(naive, singleMode);
+      rSearch = new RSType<tree::RPTree, MatType>(naive, singleMode);
       break;
 
     case MAX_RP_TREE:
-      rSearch = new RSType<tree::MaxRPTree>(naive, singleMode);
+      rSearch = new RSType<tree::MaxRPTree, MatType>(naive, singleMode);
       break;
 
     case UB_TREE:
-      rSearch = new RSType<tree::UBTree>(naive, singleMode);
+      rSearch = new RSType<tree::UBTree, MatType>(naive, singleMode);
       break;
 
     case OCTREE:
-      rSearch = new RSType<tree::Octree>(naive, singleMode);
+      rSearch = new RSType<tree::Octree, MatType>(naive, singleMode);
       break;
   }
 
-  TrainVisitor tn(std::move(referenceSet), leafSize);
+  TrainVisitor<MatType> tn(std::move(referenceSet), leafSize);
   boost::apply_visitor(tn, rSearch);
 
   if (!naive)
@@ -196,10 +205,12 @@ inline void RSModel::BuildModel(arma::mat&& referenceSet,
 }
 
 // Perform range search.
-inline void RSModel::Search(arma::mat&& querySet,
-                            const math::Range& range,
-                            std::vector<std::vector<size_t>>& neighbors,
-                            std::vector<std::vector<double>>& distances)
+template<typename MatType>
+void RSModelType<MatType>::Search(
+    MatType&& querySet,
+    const math::Range& range,
+    std::vector<std::vector<size_t>>& neighbors,
+    std::vector<std::vector<double>>& distances)
 {
   // We may need to map the query set randomly.
   if (randomBasis)
@@ -215,15 +226,17 @@ inline void RSModel::Search(arma::mat&& querySet,
     Log::Info << "brute-force (naive) search..." << std::endl;
 
 
-  BiSearchVisitor search(querySet, range, neighbors, distances,
+  BiSearchVisitor<MatType> search(querySet, range, neighbors, distances,
       leafSize);
   boost::apply_visitor(search, rSearch);
 }
 
 // Perform range search (monochromatic case).
-inline void RSModel::Search(const math::Range& range,
-                            std::vector<std::vector<size_t>>& neighbors,
-                            std::vector<std::vector<double>>& distances)
+template<typename MatType>
+void RSModelType<MatType>::Search(
+    const math::Range& range,
+    std::vector<std::vector<size_t>>& neighbors,
+    std::vector<std::vector<double>>& distances)
 {
   Log::Info << "Search for points in the range [" << range.Lo() << ", "
       << range.Hi() << "] with ";
@@ -239,7 +252,8 @@ inline void RSModel::Search(const math::Range& range,
 }
 
 // Get the name of the tree type.
-inline std::string RSModel::TreeName() const
+template<typename MatType>
+std::string RSModelType<MatType>::TreeName() const
 {
   switch (treeType)
   {
@@ -277,7 +291,8 @@ inline std::string RSModel::TreeName() const
 }
 
 // Clean memory.
-inline void RSModel::CleanMemory()
+template<typename MatType>
+void RSModelType<MatType>::CleanMemory()
 {
   boost::apply_visitor(DeleteVisitor(), rSearch);
 }
@@ -292,11 +307,13 @@ void MonoSearchVisitor::operator()(RSType* rs) const
 }
 
 //! Save parameters for bichromatic range search.
-BiSearchVisitor::BiSearchVisitor(const arma::mat& querySet,
-                                 const math::Range& range,
-                                 std::vector<std::vector<size_t>>& neighbors,
-                                 std::vector<std::vector<double>>& distances,
-                                 const size_t leafSize):
+template<typename MatType>
+BiSearchVisitor<MatType>::BiSearchVisitor(
+    const MatType& querySet,
+    const math::Range& range,
+    std::vector<std::vector<size_t>>& neighbors,
+    std::vector<std::vector<double>>& distances,
+    const size_t leafSize):
     querySet(querySet),
     range(range),
     neighbors(neighbors),
@@ -305,10 +322,11 @@ BiSearchVisitor::BiSearchVisitor(const arma::mat& querySet,
 {}
 
 //! Default Bichromatic range search on the given RSType instance.
+template<typename MatType>
 template<template<typename TreeMetricType,
                   typename TreeStatType,
                   typename TreeMatType> class TreeType>
-void BiSearchVisitor::operator()(RSTypeT<TreeType>* rs) const
+void BiSearchVisitor<MatType>::operator()(RSTypeT<TreeType>* rs) const
 {
   if (rs)
     return rs->Search(querySet, range, neighbors, distances);
@@ -316,7 +334,8 @@ void BiSearchVisitor::operator()(RSTypeT<TreeType>* rs) const
 }
 
 //! Bichromatic range search on the given RSType specialized for KDTrees.
-void BiSearchVisitor::operator()(RSTypeT<tree::KDTree>* rs) const
+template<typename MatType>
+void BiSearchVisitor<MatType>::operator()(RSTypeT<tree::KDTree>* rs) const
 {
   if (rs)
     return SearchLeaf(rs);
@@ -324,7 +343,8 @@ void BiSearchVisitor::operator()(RSTypeT<tree::KDTree>* rs) const
 }
 
 //! Bichromatic range search on the given RSType specialized for BallTrees.
-void BiSearchVisitor::operator()(RSTypeT<tree::BallTree>* rs) const
+template<typename MatType>
+void BiSearchVisitor<MatType>::operator()(RSTypeT<tree::BallTree>* rs) const
 {
   if (rs)
     return SearchLeaf(rs);
@@ -332,7 +352,8 @@ void BiSearchVisitor::operator()(RSTypeT<tree::BallTree>* rs) const
 }
 
 //! Bichromatic range search specialized for Ocrees.
-void BiSearchVisitor::operator()(RSTypeT<tree::Octree>* rs) const
+template<typename MatType>
+void BiSearchVisitor<MatType>::operator()(RSTypeT<tree::Octree>* rs) const
 {
   if (rs)
     return SearchLeaf(rs);
@@ -340,8 +361,9 @@ void BiSearchVisitor::operator()(RSTypeT<tree::Octree>* rs) const
 }
 
 //! Bichromatic range search on the given RSType considering the leafSize.
+template<typename MatType>
 template<typename RSType>
-void BiSearchVisitor::SearchLeaf(RSType* rs) const
+void BiSearchVisitor<MatType>::SearchLeaf(RSType* rs) const
 {
   if (!rs->Naive() && !rs->SingleMode())
   {
@@ -372,17 +394,19 @@ void BiSearchVisitor::SearchLeaf(RSType* rs) const
 }
 
 //! Save parameters for Train.
-TrainVisitor::TrainVisitor(arma::mat&& referenceSet,
-                           const size_t leafSize) :
+template<typename MatType>
+TrainVisitor<MatType>::TrainVisitor(MatType&& referenceSet,
+                                    const size_t leafSize) :
     referenceSet(std::move(referenceSet)),
     leafSize(leafSize)
 {}
 
 //! Default Train on the given RSType instance.
+template<typename MatType>
 template<template<typename TreeMetricType,
                   typename TreeStatType,
                   typename TreeMatType> class TreeType>
-void TrainVisitor::operator()(RSTypeT<TreeType>* rs) const
+void TrainVisitor<MatType>::operator()(RSTypeT<TreeType>* rs) const
 {
   if (rs)
     return rs->Train(std::move(referenceSet));
@@ -390,7 +414,8 @@ void TrainVisitor::operator()(RSTypeT<TreeType>* rs) const
 }
 
 //! Train on the given RSType specialized for KDTrees.
-void TrainVisitor::operator()(RSTypeT<tree::KDTree>* rs) const
+template<typename MatType>
+void TrainVisitor<MatType>::operator()(RSTypeT<tree::KDTree>* rs) const
 {
   if (rs)
     return TrainLeaf(rs);
@@ -398,7 +423,8 @@ void TrainVisitor::operator()(RSTypeT<tree::KDTree>* rs) const
 }
 
 //! Train on the given RSType specialized for BallTrees.
-void TrainVisitor::operator()(RSTypeT<tree::BallTree>* rs) const
+template<typename MatType>
+void TrainVisitor<MatType>::operator()(RSTypeT<tree::BallTree>* rs) const
 {
   if (rs)
     return TrainLeaf(rs);
@@ -406,7 +432,8 @@ void TrainVisitor::operator()(RSTypeT<tree::BallTree>* rs) const
 }
 
 //! Train specialized for Octrees.
-void TrainVisitor::operator()(RSTypeT<tree::Octree>* rs) const
+template<typename MatType>
+void TrainVisitor<MatType>::operator()(RSTypeT<tree::Octree>* rs) const
 {
   if (rs)
     return TrainLeaf(rs);
@@ -414,8 +441,9 @@ void TrainVisitor::operator()(RSTypeT<tree::Octree>* rs) const
 }
 
 //! Train on the given RSType considering the leafSize.
+template<typename MatType>
 template<typename RSType>
-void TrainVisitor::TrainLeaf(RSType* rs) const
+void TrainVisitor<MatType>::TrainLeaf(RSType* rs) const
 {
   if (rs->Naive())
     rs->Train(std::move(referenceSet));
@@ -434,8 +462,9 @@ void TrainVisitor::TrainLeaf(RSType* rs) const
 }
 
 //! Expose the referenceSet of the given RSType.
+template<typename MatType>
 template<typename RSType>
-const arma::mat& ReferenceSetVisitor::operator()(RSType* rs) const
+const MatType& ReferenceSetVisitor<MatType>::operator()(RSType* rs) const
 {
   if (rs)
     return rs->ReferenceSet();
@@ -468,9 +497,20 @@ bool& NaiveVisitor::operator()(RSType* rs) const
   throw std::runtime_error("no range search model initialized");
 }
 
+//! Exposes Parallel() function of given RSType
+template<typename RSType>
+bool& ParallelVisitor::operator()(RSType* rs) const
+{
+  if (rs)
+    return rs->Parallel();
+  throw std::runtime_error("no range search model initialized");
+}
+
 // Serialize the model.
+template<typename MatType>
 template<typename Archive>
-void RSModel::serialize(Archive& ar, const unsigned int /* version */)
+void RSModelType<MatType>::serialize(Archive& ar,
+                                     const unsigned int /* version */)
 {
   ar & BOOST_SERIALIZATION_NVP(treeType);
   ar & BOOST_SERIALIZATION_NVP(randomBasis);
@@ -484,31 +524,48 @@ void RSModel::serialize(Archive& ar, const unsigned int /* version */)
   ar & BOOST_SERIALIZATION_NVP(rSearch);
 }
 
-inline const arma::mat& RSModel::Dataset() const
+template<typename MatType>
+const MatType& RSModelType<MatType>::Dataset() const
 {
-  return boost::apply_visitor(ReferenceSetVisitor(), rSearch);
+  return boost::apply_visitor(ReferenceSetVisitor<MatType>(), rSearch);
 }
 
-inline bool RSModel::SingleMode() const
+template<typename MatType>
+bool RSModelType<MatType>::SingleMode() const
 {
   return boost::apply_visitor(SingleModeVisitor(), rSearch);
 }
 
-inline bool& RSModel::SingleMode()
+template<typename MatType>
+bool& RSModelType<MatType>::SingleMode()
 {
   return boost::apply_visitor(SingleModeVisitor(), rSearch);
 }
 
-inline bool RSModel::Naive() const
+template<typename MatType>
+bool RSModelType<MatType>::Naive() const
 {
   return boost::apply_visitor(NaiveVisitor(), rSearch);
 }
 
-inline bool& RSModel::Naive()
+template<typename MatType>
+bool& RSModelType<MatType>::Naive()
 {
   return boost::apply_visitor(NaiveVisitor(), rSearch);
 }
 
+template<typename MatType>
+bool RSModelType<MatType>::Parallel() const
+{
+  return boost::apply_visitor(ParallelVisitor(), rSearch);
+}
+
+template<typename MatType>
+bool& RSModelType<MatType>::Parallel()
+{
+  return boost::apply_visitor(ParallelVisitor(), rSearch);
+}
+
 } // namespace range
 } // namespace mlpack
 
@@ -95,6 +95,9 @@ PARAM_FLAG("first_leaf_exact", "The flag to trigger sampling only after "
            "exactly exploring the first leaf.", "X");
 PARAM_INT_IN("single_sample_limit", "The limit on the maximum number of "
     "samples (and hence the largest node you can approximate).", "z", 20);
+PARAM_FLAG("parallel", "If set, the tree traversal is split between OpenMP "
+    "threads (the number of threads can be controlled with the OMP_NUM_THREADS "
+    "environment variable).", "P");
 
 void mlpackMain()
 {
@@ -206,6 +209,7 @@ void mlpackMain()
     rann.SingleSampleLimit() = CLI::GetParam<double>("single_sample_limit");
   rann.SampleAtLeaves() = CLI::HasParam("sample_at_leaves");
   rann.FirstLeafExact() = CLI::HasParam("sample_at_leaves");
+  rann.Parallel() = CLI::HasParam("parallel");
 
   // Perform search, if desired.
   if (CLI::HasParam("k"))
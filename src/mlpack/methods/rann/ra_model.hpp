@@ -192,6 +192,17 @@ class SampleAtLeavesVisitor : public boost::static_visitor<bool&>
   bool& operator()(RAType *) const;
 };
 
+/**
+ * Exposes the Parallel() method of the given RAType.
+ */
+class ParallelVisitor : public boost::static_visitor<bool&>
+{
+ public:
+  //! Return whether or not the search is parallelized.
+  template<typename RAType>
+  bool& operator()(RAType* ra) const;
+};
+
 /**
  * Exposes the Alpha() method of the given RAType.
  */
@@ -392,6 +403,11 @@ class RAModel
   //! Modify the limit on the size of a node that can be approximation.
   size_t& SingleSampleLimit();
 
+  //! Get whether or not tree traversals are parallelized with OpenMP.
+  bool Parallel() const;
+  //! Modify whether or not tree traversals are parallelized with OpenMP.
+  bool& Parallel();
+
   //! Get the leaf size (only relevant when the kd-tree is used).
   size_t LeafSize() const;
   //! Modify the leaf size (only relevant when the kd-tree is used).
@@ -198,6 +198,15 @@ bool& SampleAtLeavesVisitor::operator()(RAType* ra) const
   throw std::runtime_error("no rank-approximate search model is initialized");
 }
 
+//! Exposes the Parallel() method of the given RAType.
+template<typename RAType>
+bool& ParallelVisitor::operator()(RAType* ra) const
+{
+  if (ra)
+    return ra->Parallel();
+  throw std::runtime_error("no rank-approximate search model is initialized");
+}
+
 //! Exposes the Alpha() method of the given RAType instance.
 template<typename RAType>
 double& AlphaVisitor::operator()(RAType* ra) const
@@ -440,6 +449,18 @@ size_t& RAModel<SortPolicy>::SingleSampleLimit()
   return boost::apply_visitor(SingleSampleLimitVisitor(), raSearch);
 }
 
+template<typename SortPolicy>
+bool RAModel<SortPolicy>::Parallel() const
+{
+  return boost::apply_visitor(ParallelVisitor(), raSearch);
+}
+
+template<typename SortPolicy>
+bool& RAModel<SortPolicy>::Parallel()
+{
+  return boost::apply_visitor(ParallelVisitor(), raSearch);
+}
+
 template<typename SortPolicy>
 size_t RAModel<SortPolicy>::LeafSize() const
 {
@@ -419,6 +419,11 @@ class RASearch
   //! Modify the limit on the size of a node that can be approximation.
   size_t& SingleSampleLimit() { return singleSampleLimit; }
 
+  //! Get whether or not tree traversals are parallelized with OpenMP.
+  bool Parallel() const { return parallel; }
+  //! Modify whether or not tree traversals are parallelized with OpenMP.
+  bool& Parallel() { return parallel; }
+
   //! Serialize the object.
   template<typename Archive>
   void serialize(Archive& ar, const unsigned int /* version */);
@@ -452,10 +457,44 @@ class RASearch
   //! The limit on the number of points in the largest node that can be
   //! approximated by sampling.
   size_t singleSampleLimit;
+  //! If true, tree traversals are split between OpenMP threads.
+  bool parallel;
 
   //! Instantiation of kernel.
   MetricType metric;
 
+  /**
+   * Perform a dual-tree traversal of the given query and reference trees with
+   * the given rules.  If parallel search is enabled (and OpenMP is available),
+   * the query tree is split into a number of disjoint subtrees near its root,
+   * and each subtree is traversed against the whole reference tree by one
+   * thread, with its own traverser and its own copy of the rules (sharing the
+   * candidate lists).  Each subtree is sampled with its own seed, so the
+   * results only depend on the random seed and the number of threads.
+   *
+   * @param queryTree Tree built on the query points.
+   * @param referenceTree Tree built on the reference points.
+   * @param rules Rules to use for the traversal.
+   */
+  template<typename RuleType>
+  void DualTreeTraversal(Tree& queryTree,
+                         Tree& referenceTree,
+                         RuleType& rules);
+
+  /**
+   * Perform a single-tree traversal of the reference tree for each of the
+   * given number of query points with the given rules.  If parallel search is
+   * enabled (and OpenMP is available), the query points are split between
+   * threads, each with its own traverser and its own copy of the rules.  Each
+   * query point is sampled with its own seed, so the results do not depend on
+   * the number of threads.
+   *
+   * @param numQueries Number of query points.
+   * @param rules Rules to use for the traversal.
+   */
+  template<typename RuleType>
+  void SingleTreeTraversal(const size_t numQueries, RuleType& rules);
+
   //! For access to mappings when building models.
   template<typename SortPol>
   friend class TrainVisitor;
@@ -14,6 +14,7 @@
 #define MLPACK_METHODS_RANN_RA_SEARCH_IMPL_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/core/tree/split_frontier.hpp>
 
 #include "ra_search_rules.hpp"
 
@@ -75,6 +76,7 @@ RASearch(const MatType& referenceSetIn,
     sampleAtLeaves(sampleAtLeaves),
     firstLeafExact(firstLeafExact),
     singleSampleLimit(singleSampleLimit),
+    parallel(false),
     metric(metric)
 {
   // Nothing to do.
@@ -110,6 +112,7 @@ RASearch(MatType&& referenceSetIn,
     sampleAtLeaves(sampleAtLeaves),
     firstLeafExact(firstLeafExact),
     singleSampleLimit(singleSampleLimit),
+    parallel(false),
     metric(metric)
 {
   // Nothing to do.
@@ -142,6 +145,7 @@ RASearch(Tree* referenceTree,
     sampleAtLeaves(sampleAtLeaves),
     firstLeafExact(firstLeafExact),
     singleSampleLimit(singleSampleLimit),
+    parallel(false),
     metric(metric)
 // Nothing else to initialize.
 {  }
@@ -173,6 +177,7 @@ RASearch(const bool naive,
     sampleAtLeaves(sampleAtLeaves),
     firstLeafExact(firstLeafExact),
     singleSampleLimit(singleSampleLimit),
+    parallel(false),
     metric(metric)
 {
   // Build the tree on the empty dataset, if necessary.
@@ -393,12 +398,8 @@ Search(const MatType& querySet,
     {
       Log::Info << "Performing single-tree traversal..." << std::endl;
 
-      // Create the traverser.
-      typename Tree::template SingleTreeTraverser<RuleType> traverser(rules);
-
-      // Now have it traverse for each point.
-      for (size_t i = 0; i < querySet.n_cols; ++i)
-        traverser.Traverse(i, *referenceTree);
+      // Traverse the reference tree for each point.
+      SingleTreeTraversal(querySet.n_cols, rules);
 
       Log::Info << "Single-tree traversal complete." << std::endl;
       Log::Info << "Average number of distance calculations per query point: "
@@ -422,12 +423,11 @@ Search(const MatType& querySet,
 
     RuleType rules(*referenceSet, queryTree->Dataset(), k, metric, tau, alpha,
         naive, sampleAtLeaves, firstLeafExact, singleSampleLimit, false);
-    typename Tree::template DualTreeTraverser<RuleType> traverser(rules);
 
     Log::Info << "Query statistic pre-search: "
         << queryTree->Stat().NumSamplesMade() << std::endl;
 
-    traverser.Traverse(*queryTree, *referenceTree);
+    DualTreeTraversal(*queryTree, *referenceTree, rules);
 
     Log::Info << "Dual-tree traversal complete." << std::endl;
     Log::Info << "Average number of distance calculations per query point: "
@@ -536,9 +536,7 @@ void RASearch<SortPolicy, MetricType, MatType, TreeType>::Search(
   RuleType rules(*referenceSet, queryTree->Dataset(), k, metric, tau, alpha,
       naive, sampleAtLeaves, firstLeafExact, singleSampleLimit, false);
 
-  // Create the traverser.
-  typename Tree::template DualTreeTraverser<RuleType> traverser(rules);
-  traverser.Traverse(*queryTree, *referenceTree);
+  DualTreeTraversal(*queryTree, *referenceTree, rules);
 
   rules.GetResults(*neighborPtr, distances);
 
@@ -609,19 +607,12 @@ void RASearch<SortPolicy, MetricType, MatType, TreeType>::Search(
   }
   else if (singleMode)
   {
-    // Create the traverser.
-    typename Tree::template SingleTreeTraverser<RuleType> traverser(rules);
-
-    // Now have it traverse for each point.
-    for (size_t i = 0; i < referenceSet->n_cols; ++i)
-      traverser.Traverse(i, *referenceTree);
+    // Traverse the reference tree for each point.
+    SingleTreeTraversal(referenceSet->n_cols, rules);
   }
   else
   {
-    // Create the traverser.
-    typename Tree::template DualTreeTraverser<RuleType> traverser(rules);
-
-    traverser.Traverse(*referenceTree, *referenceTree);
+    DualTreeTraversal(*referenceTree, *referenceTree, rules);
   }
 
   rules.GetResults(*neighborPtr, *distancePtr);
@@ -651,6 +642,117 @@ void RASearch<SortPolicy, MetricType, MatType, TreeType>::Search(
   }
 }
 
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+template<typename RuleType>
+void RASearch<SortPolicy, MetricType, MatType, TreeType>::DualTreeTraversal(
+    Tree& queryTree,
+    Tree& referenceTree,
+    RuleType& rules)
+{
+#ifdef HAS_OPENMP
+  const size_t numThreads = omp_get_max_threads();
+  if (parallel && numThreads > 1)
+  {
+    // Split the query tree near the root until there are enough subtrees to
+    // keep all threads busy.
+    const std::vector<Tree*> frontier = tree::SplitFrontier(queryTree,
+        8 * numThreads);
+
+    // Each subtree is sampled with its own seed, so the samples do not depend
+    // on which thread traverses it, or when.
+    const size_t seed = math::randGen();
+
+    #pragma omp parallel
+    {
+      // Each thread has its own rules, sharing the candidate lists and sample
+      // counts; no two subtrees in the frontier hold the same query point.
+      RuleType threadRules(rules);
+      const typename RuleType::TraversalInfoType initialInfo =
+          threadRules.TraversalInfo();
+      typename Tree::template DualTreeTraverser<RuleType>
+          traverser(threadRules);
+
+      #pragma omp for schedule(dynamic)
+      for (omp_size_t i = 0; i < (omp_size_t) frontier.size(); ++i)
+      {
+        // Nothing is known about the combination of this subtree and the
+        // reference root, so reset the traversal info.
+        threadRules.TraversalInfo() = initialInfo;
+        threadRules.Generator().seed((uint32_t) (seed + i));
+        traverser.Traverse(*frontier[i], referenceTree);
+      }
+
+      // The copy starts with no distance computations; add them to the
+      // shared count.
+      #pragma omp critical
+      rules.NumDistComputations() += threadRules.NumDistComputations();
+    }
+
+    return;
+  }
+#endif
+
+  typename Tree::template DualTreeTraverser<RuleType> traverser(rules);
+  traverser.Traverse(queryTree, referenceTree);
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+template<typename RuleType>
+void RASearch<SortPolicy, MetricType, MatType, TreeType>::SingleTreeTraversal(
+    const size_t numQueries,
+    RuleType& rules)
+{
+  // Each query point is sampled with its own seed, so the results are the same
+  // whether or not the search is parallel, and for any number of threads.
+  const size_t seed = math::randGen();
+
+#ifdef HAS_OPENMP
+  if (parallel && omp_get_max_threads() > 1)
+  {
+    #pragma omp parallel
+    {
+      // Each thread has its own rules and traverser, and works on its own
+      // query points, so the shared candidate lists and sample counts are
+      // never touched by two threads at once.
+      RuleType threadRules(rules);
+      typename Tree::template SingleTreeTraverser<RuleType>
+          traverser(threadRules);
+
+      #pragma omp for schedule(dynamic, 16)
+      for (omp_size_t i = 0; i < (omp_size_t) numQueries; ++i)
+      {
+        threadRules.Generator().seed((uint32_t) (seed + i));
+        traverser.Traverse(i, *referenceTree);
+      }
+
+      // The copy starts with no distance computations; add them to the
+      // shared count.
+      #pragma omp critical
+      rules.NumDistComputations() += threadRules.NumDistComputations();
+    }
+
+    return;
+  }
+#endif
+
+  typename Tree::template SingleTreeTraverser<RuleType> traverser(rules);
+  for (size_t i = 0; i < numQueries; ++i)
+  {
+    rules.Generator().seed((uint32_t) (seed + i));
+    traverser.Traverse(i, *referenceTree);
+  }
+}
+
 template<typename SortPolicy,
          typename MetricType,
          typename MatType,
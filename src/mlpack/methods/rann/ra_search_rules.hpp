@@ -15,8 +15,7 @@
 #define MLPACK_METHODS_RANN_RA_SEARCH_RULES_HPP
 
 #include <mlpack/core/tree/traversal_info.hpp>
-
-#include <queue>
+#include <mlpack/methods/neighbor_search/candidate_list.hpp>
 
 namespace mlpack {
 namespace neighbor {
@@ -66,6 +65,18 @@ class RASearchRules
                 const size_t singleSampleLimit = 20,
                 const bool sameSet = false);
 
+  /**
+   * Construct an RASearchRules object that shares the candidate lists and the
+   * per-query sample counts of the given rules object, but has its own
+   * traversal info, distance computation count, random number generator and
+   * sample buffer.  This is used by parallel traversals to give each thread its
+   * own rules object.  It is only safe as long as no two threads ever work on
+   * the same query point (or query node) at the same time.
+   *
+   * @param other Rules object whose candidate lists will be shared.
+   */
+  RASearchRules(RASearchRules& other);
+
   /**
    * Store the list of candidates for each query point in the given matrices.
    *
@@ -227,7 +238,10 @@ class RASearchRules
                  const double oldScore);
 
 
-  size_t NumDistComputations() { return numDistComputations; }
+  //! Get the number of distance computations performed.
+  size_t NumDistComputations() const { return numDistComputations; }
+  //! Modify the number of distance computations performed.
+  size_t& NumDistComputations() { return numDistComputations; }
   size_t NumEffectiveSamples()
   {
     if (numSamplesMade.n_elem == 0)
@@ -241,6 +255,11 @@ class RASearchRules
   const TraversalInfoType& TraversalInfo() const { return traversalInfo; }
   TraversalInfoType& TraversalInfo() { return traversalInfo; }
 
+  //! Modify the random number generator used for sampling.  Reseeding it
+  //! before traversing a fixed part of the work makes the sampling of that
+  //! part reproducible, whichever thread does it.
+  std::mt19937& Generator() { return generator; }
+
  private:
   //! The reference set.
   const arma::mat& referenceSet;
@@ -248,23 +267,12 @@ class RASearchRules
   //! The query set.
   const arma::mat& querySet;
 
-  //! Candidate represents a possible candidate neighbor (distance, index).
-  typedef std::pair<double, size_t> Candidate;
+  //! Storage for the candidate lists, if this object owns them.
+  CandidateList<SortPolicy> candidateStorage;
 
-  //! Compare two candidates based on the distance.
-  struct CandidateCmp {
-    bool operator()(const Candidate& c1, const Candidate& c2)
-    {
-      return !SortPolicy::IsBetter(c2.first, c1.first);
-    };
-  };
-
-  //! Use a priority queue to represent the list of candidate neighbors.
-  typedef std::priority_queue<Candidate, std::vector<Candidate>, CandidateCmp>
-      CandidateList;
-
-  //! Set of candidate neighbors for each point.
-  std::vector<CandidateList> candidates;
+  //! Set of candidate neighbors for each point.  This may refer to the
+  //! candidate lists of another RASearchRules object.
+  CandidateList<SortPolicy>& candidates;
 
   //! Number of neighbors to search for.
   const size_t k;
@@ -284,8 +292,13 @@ class RASearchRules
   //! The minimum number of samples required per query.
   size_t numSamplesReqd;
 
-  //! The number of samples made for every query.
-  arma::Col<size_t> numSamplesMade;
+  //! Storage for the number of samples made for every query, if this object
+  //! owns it.
+  arma::Col<size_t> numSamplesMadeStorage;
+
+  //! The number of samples made for every query.  This may refer to the counts
+  //! of another RASearchRules object.
+  arma::Col<size_t>& numSamplesMade;
 
   //! The sampling ratio.
   double samplingRatio;
@@ -298,6 +311,12 @@ class RASearchRules
 
   TraversalInfoType traversalInfo;
 
+  //! Random number generator used to draw samples.
+  std::mt19937 generator;
+
+  //! Buffer for the samples drawn from a node; reused to avoid allocations.
+  std::vector<size_t> samples;
+
   /**
    * Helper function to insert a point into the list of candidate points.
    *
@@ -33,12 +33,16 @@ RASearchRules(const arma::mat& referenceSet,
               const bool sameSet) :
     referenceSet(referenceSet),
     querySet(querySet),
+    candidateStorage(k, querySet.n_cols),
+    candidates(candidateStorage),
     k(k),
     metric(metric),
     sampleAtLeaves(sampleAtLeaves),
     firstLeafExact(firstLeafExact),
     singleSampleLimit(singleSampleLimit),
-    sameSet(sameSet)
+    numSamplesMade(numSamplesMadeStorage),
+    sameSet(sameSet),
+    generator(math::randGen())
 {
   // Validate tau to make sure that the rank approximation is greater than the
   // number of neighbors requested.
@@ -70,33 +74,40 @@ RASearchRules(const arma::mat& referenceSet,
   Log::Info << "Minimum samples required per query: " << numSamplesReqd <<
     ", sampling ratio: " << samplingRatio << std::endl;
 
-  // Let's build the list of candidate neighbors for each query point.
-  // It will be initialized with k candidates: (WorstDistance, size_t() - 1)
-  // The list of candidates will be updated when visiting new points with the
-  // BaseCase() method.
-  const Candidate def = std::make_pair(SortPolicy::WorstDistance(),
-      size_t() - 1);
-
-  std::vector<Candidate> vect(k, def);
-  CandidateList pqueue(CandidateCmp(), std::move(vect));
-
-  candidates.reserve(querySet.n_cols);
-  for (size_t i = 0; i < querySet.n_cols; i++)
-    candidates.push_back(pqueue);
-
   if (naive) // No tree traversal; just do naive sampling here.
   {
     // Sample enough points.
-    arma::uvec distinctSamples;
     for (size_t i = 0; i < querySet.n_cols; ++i)
     {
-      math::ObtainDistinctSamples(0, n, numSamplesReqd, distinctSamples);
-      for (size_t j = 0; j < distinctSamples.n_elem; j++)
-        BaseCase(i, (size_t) distinctSamples[j]);
+      math::ObtainDistinctSamples(0, n, numSamplesReqd, samples, generator);
+      for (size_t j = 0; j < samples.size(); j++)
+        BaseCase(i, (size_t) samples[j]);
     }
   }
 }
 
+template<typename SortPolicy, typename MetricType, typename TreeType>
+RASearchRules<SortPolicy, MetricType, TreeType>::RASearchRules(
+    RASearchRules& other) :
+    referenceSet(other.referenceSet),
+    querySet(other.querySet),
+    candidates(other.candidates),
+    k(other.k),
+    metric(other.metric),
+    sampleAtLeaves(other.sampleAtLeaves),
+    firstLeafExact(other.firstLeafExact),
+    singleSampleLimit(other.singleSampleLimit),
+    numSamplesReqd(other.numSamplesReqd),
+    numSamplesMade(other.numSamplesMade),
+    samplingRatio(other.samplingRatio),
+    numDistComputations(0),
+    sameSet(other.sameSet),
+    traversalInfo(other.traversalInfo),
+    generator(other.generator)
+{
+  // Nothing to do.
+}
+
 template<typename SortPolicy, typename MetricType, typename TreeType>
 void RASearchRules<SortPolicy, MetricType, TreeType>::GetResults(
     arma::Mat<size_t>& neighbors,
@@ -106,15 +117,7 @@ void RASearchRules<SortPolicy, MetricType, TreeType>::GetResults(
   distances.set_size(k, querySet.n_cols);
 
   for (size_t i = 0; i < querySet.n_cols; i++)
-  {
-    CandidateList& pqueue = candidates[i];
-    for (size_t j = 1; j <= k; j++)
-    {
-      neighbors(k - j, i) = pqueue.top().second;
-      distances(k - j, i) = pqueue.top().first;
-      pqueue.pop();
-    }
-  }
+    candidates.Get(i, neighbors.colptr(i), distances.colptr(i));
 };
 
 template<typename SortPolicy, typename MetricType, typename TreeType>
@@ -148,7 +151,7 @@ inline double RASearchRules<SortPolicy, MetricType, TreeType>::Score(
   const arma::vec queryPoint = querySet.unsafe_col(queryIndex);
   const double distance = SortPolicy::BestPointToNodeDistance(queryPoint,
       &referenceNode);
-  const double bestDistance = candidates[queryIndex].top().first;
+  const double bestDistance = candidates.Worst(queryIndex);
 
   return Score(queryIndex, referenceNode, distance, bestDistance);
 }
@@ -162,7 +165,7 @@ inline double RASearchRules<SortPolicy, MetricType, TreeType>::Score(
   const arma::vec queryPoint = querySet.unsafe_col(queryIndex);
   const double distance = SortPolicy::BestPointToNodeDistance(queryPoint,
       &referenceNode, baseCaseResult);
-  const double bestDistance = candidates[queryIndex].top().first;
+  const double bestDistance = candidates.Worst(queryIndex);
 
   return Score(queryIndex, referenceNode, distance, bestDistance);
 }
@@ -203,13 +206,12 @@ inline double RASearchRules<SortPolicy, MetricType, TreeType>::Score(
         {
           // Then samplesReqd <= singleSampleLimit.
           // Hence, approximate the node by sampling enough number of points.
-          arma::uvec distinctSamples;
           math::ObtainDistinctSamples(0, referenceNode.NumDescendants(),
-              samplesReqd, distinctSamples);
-          for (size_t i = 0; i < distinctSamples.n_elem; i++)
+              samplesReqd, samples, generator);
+          for (size_t i = 0; i < samples.size(); i++)
             // The counting of the samples are done in the 'BaseCase' function
             // so no book-keeping is required here.
-            BaseCase(queryIndex, referenceNode.Descendant(distinctSamples[i]));
+            BaseCase(queryIndex, referenceNode.Descendant(samples[i]));
 
           // Node approximated, so we can prune it.
           return DBL_MAX;
@@ -219,14 +221,13 @@ inline double RASearchRules<SortPolicy, MetricType, TreeType>::Score(
           if (sampleAtLeaves) // If allowed to sample at leaves.
           {
             // Approximate node by sampling enough number of points.
-            arma::uvec distinctSamples;
             math::ObtainDistinctSamples(0, referenceNode.NumDescendants(),
-                samplesReqd, distinctSamples);
-            for (size_t i = 0; i < distinctSamples.n_elem; i++)
+                samplesReqd, samples, generator);
+            for (size_t i = 0; i < samples.size(); i++)
               // The counting of the samples are done in the 'BaseCase' function
               // so no book-keeping is required here.
               BaseCase(queryIndex,
-                  referenceNode.Descendant(distinctSamples[i]));
+                  referenceNode.Descendant(samples[i]));
 
             // (Leaf) node approximated, so we can prune it.
             return DBL_MAX;
@@ -274,7 +275,7 @@ Rescore(const size_t queryIndex,
     return oldScore;
 
   // Just check the score again against the distances.
-  const double bestDistance = candidates[queryIndex].top().first;
+  const double bestDistance = candidates.Worst(queryIndex);
 
   // If this is better than the best distance we've seen so far,
   // maybe there will be something down this node.
@@ -307,13 +308,12 @@ Rescore(const size_t queryIndex,
       {
         // Then, samplesReqd <= singleSampleLimit.  Hence, approximate the node
         // by sampling enough number of points.
-        arma::uvec distinctSamples;
         math::ObtainDistinctSamples(0, referenceNode.NumDescendants(),
-            samplesReqd, distinctSamples);
-        for (size_t i = 0; i < distinctSamples.n_elem; i++)
+            samplesReqd, samples, generator);
+        for (size_t i = 0; i < samples.size(); i++)
           // The counting of the samples are done in the 'BaseCase' function so
           // no book-keeping is required here.
-          BaseCase(queryIndex, referenceNode.Descendant(distinctSamples[i]));
+          BaseCase(queryIndex, referenceNode.Descendant(samples[i]));
 
         // Node approximated, so we can prune it.
         return DBL_MAX;
@@ -323,13 +323,12 @@ Rescore(const size_t queryIndex,
         if (sampleAtLeaves)
         {
           // Approximate node by sampling enough points.
-          arma::uvec distinctSamples;
           math::ObtainDistinctSamples(0, referenceNode.NumDescendants(),
-              samplesReqd, distinctSamples);
-          for (size_t i = 0; i < distinctSamples.n_elem; i++)
+              samplesReqd, samples, generator);
+          for (size_t i = 0; i < samples.size(); i++)
             // The counting of the samples are done in the 'BaseCase' function
             // so no book-keeping is required here.
-            BaseCase(queryIndex, referenceNode.Descendant(distinctSamples[i]));
+            BaseCase(queryIndex, referenceNode.Descendant(samples[i]));
 
           // (Leaf) node approximated, so we can prune it.
           return DBL_MAX;
@@ -374,7 +373,7 @@ inline double RASearchRules<SortPolicy, MetricType, TreeType>::Score(
 
   for (size_t i = 0; i < queryNode.NumPoints(); i++)
   {
-    const double bound = candidates[queryNode.Point(i)].top().first
+    const double bound = candidates.Worst(queryNode.Point(i))
         + maxDescendantDistance;
     if (bound < pointBound)
       pointBound = bound;
@@ -413,7 +412,7 @@ inline double RASearchRules<SortPolicy, MetricType, TreeType>::Score(
 
   for (size_t i = 0; i < queryNode.NumPoints(); i++)
   {
-    const double bound = candidates[queryNode.Point(i)].top().first
+    const double bound = candidates.Worst(queryNode.Point(i))
         + maxDescendantDistance;
     if (bound < pointBound)
       pointBound = bound;
@@ -507,17 +506,16 @@ inline double RASearchRules<SortPolicy, MetricType, TreeType>::Score(
         {
           // Then samplesReqd <= singleSampleLimit.  Hence, approximate node by
           // sampling enough number of points for every query in the query node.
-          arma::uvec distinctSamples;
           for (size_t i = 0; i < queryNode.NumDescendants(); ++i)
           {
             const size_t queryIndex = queryNode.Descendant(i);
             math::ObtainDistinctSamples(0, referenceNode.NumDescendants(),
-                samplesReqd, distinctSamples);
-            for (size_t j = 0; j < distinctSamples.n_elem; j++)
+                samplesReqd, samples, generator);
+            for (size_t j = 0; j < samples.size(); j++)
               // The counting of the samples are done in the 'BaseCase' function
               // so no book-keeping is required here.
               BaseCase(queryIndex,
-                  referenceNode.Descendant(distinctSamples[j]));
+                  referenceNode.Descendant(samples[j]));
           }
 
           // Update the number of samples made for the queryNode and also update
@@ -537,17 +535,16 @@ inline double RASearchRules<SortPolicy, MetricType, TreeType>::Score(
           {
             // Approximate node by sampling enough number of points for every
             // query in the query node.
-            arma::uvec distinctSamples;
             for (size_t i = 0; i < queryNode.NumDescendants(); ++i)
             {
               const size_t queryIndex = queryNode.Descendant(i);
               math::ObtainDistinctSamples(0, referenceNode.NumDescendants(),
-                  samplesReqd, distinctSamples);
-              for (size_t j = 0; j < distinctSamples.n_elem; j++)
+                  samplesReqd, samples, generator);
+              for (size_t j = 0; j < samples.size(); j++)
                 // The counting of the samples are done in the 'BaseCase'
                 // function so no book-keeping is required here.
                 BaseCase(queryIndex,
-                    referenceNode.Descendant(distinctSamples[j]));
+                    referenceNode.Descendant(samples[j]));
             }
 
             // Update the number of samples made for the queryNode and also
@@ -627,7 +624,7 @@ Rescore(TreeType& queryNode,
 
   for (size_t i = 0; i < queryNode.NumPoints(); i++)
   {
-    const double bound = candidates[queryNode.Point(i)].top().first
+    const double bound = candidates.Worst(queryNode.Point(i))
         + maxDescendantDistance;
     if (bound < pointBound)
       pointBound = bound;
@@ -712,16 +709,15 @@ Rescore(TreeType& queryNode,
       {
         // then samplesReqd <= singleSampleLimit.  Hence, approximate the node
         // by sampling enough points for every query in the query node.
-        arma::uvec distinctSamples;
         for (size_t i = 0; i < queryNode.NumDescendants(); ++i)
         {
           const size_t queryIndex = queryNode.Descendant(i);
           math::ObtainDistinctSamples(0, referenceNode.NumDescendants(),
-              samplesReqd, distinctSamples);
-          for (size_t j = 0; j < distinctSamples.n_elem; j++)
+              samplesReqd, samples, generator);
+          for (size_t j = 0; j < samples.size(); j++)
             // The counting of the samples are done in the 'BaseCase'
             // function so no book-keeping is required here.
-            BaseCase(queryIndex, referenceNode.Descendant(distinctSamples[j]));
+            BaseCase(queryIndex, referenceNode.Descendant(samples[j]));
         }
 
         // Update the number of samples made for the query node and also update
@@ -741,17 +737,16 @@ Rescore(TreeType& queryNode,
         {
           // Approximate node by sampling enough points for every query in the
           // query node.
-          arma::uvec distinctSamples;
           for (size_t i = 0; i < queryNode.NumDescendants(); ++i)
           {
             const size_t queryIndex = queryNode.Descendant(i);
             math::ObtainDistinctSamples(0, referenceNode.NumDescendants(),
-                samplesReqd, distinctSamples);
-            for (size_t j = 0; j < distinctSamples.n_elem; j++)
+                samplesReqd, samples, generator);
+            for (size_t j = 0; j < samples.size(); j++)
               // The counting of the samples are done in BaseCase() so no
               // book-keeping is required here.
               BaseCase(queryIndex,
-                  referenceNode.Descendant(distinctSamples[j]));
+                  referenceNode.Descendant(samples[j]));
           }
 
           // Update the number of samples made for the query node and also
@@ -812,14 +807,7 @@ InsertNeighbor(
     const size_t neighbor,
     const double distance)
 {
-  CandidateList& pqueue = candidates[queryIndex];
-  Candidate c = std::make_pair(distance, neighbor);
-
-  if (CandidateCmp()(c, pqueue.top()))
-  {
-    pqueue.pop();
-    pqueue.push(c);
-  }
+  candidates.Insert(queryIndex, neighbor, distance);
 }
 
 } // namespace neighbor
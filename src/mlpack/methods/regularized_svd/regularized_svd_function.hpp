@@ -16,6 +16,7 @@
 #include <mlpack/prereqs.hpp>
 #include <mlpack/core/optimizers/sgd/sgd.hpp>
 #include <mlpack/core/optimizers/parallel_sgd/parallel_sgd.hpp>
+#include <mlpack/core/optimizers/parallel_sgd/decay_policies/constant_step.hpp>
 #include <mlpack/core/optimizers/parallel_sgd/decay_policies/exponential_backoff.hpp>
 
 namespace mlpack {
@@ -132,6 +133,42 @@ class RegularizedSVDFunction
   size_t numItems;
 };
 
+/**
+ * Optimize the given RegularizedSVDFunction with stratified parallel SGD
+ * (DSGD), as described in the following paper:
+ *
+ * @code
+ * @inproceedings{gemulla2011large,
+ *   title={Large-scale matrix factorization with distributed stochastic
+ *       gradient descent},
+ *   author={Gemulla, R. and Nijkamp, E. and Haas, P.J. and Sismanis, Y.},
+ *   booktitle={Proceedings of the 17th ACM SIGKDD International Conference on
+ *       Knowledge Discovery and Data Mining (KDD '11)},
+ *   pages={69--77},
+ *   year={2011}
+ * }
+ * @endcode
+ *
+ * The users and the items are split at random into p groups, where p is the
+ * number of threads, and so the ratings are split into p x p blocks.  Each
+ * iteration visits one stratum: p blocks that share no users and no items, one
+ * per thread.  The threads therefore never update the same parameters, and no
+ * atomic updates are needed.  The step size of each iteration is given by the
+ * decay policy of the optimizer, and its maximum number of iterations,
+ * tolerance, shuffle and evaluation interval settings are used; its thread
+ * share size and atomic update settings are not needed.
+ *
+ * @param optimizer Parallel SGD optimizer holding the parameters.
+ * @param function Function to optimize.
+ * @param parameters Starting point (will be modified).
+ * @return Objective value at the final point.
+ */
+template<typename DecayPolicyType>
+double StratifiedParallelSGD(
+    optimization::ParallelSGD<DecayPolicyType>& optimizer,
+    RegularizedSVDFunction<arma::mat>& function,
+    arma::mat& parameters);
+
 } // namespace svd
 } // namespace mlpack
 
@@ -139,10 +176,9 @@ namespace mlpack {
 namespace optimization {
 
   /**
-   * Template specialization for the SGD and parallel SGD optimizer. Used
-   * because the gradient affects only a small number of parameters per example,
-   * and thus the normal abstraction does not work as fast as we might like it
-   * to.
+   * Template specialization for the SGD optimizer. Used because the gradient
+   * affects only a small number of parameters per example, and thus the normal
+   * abstraction does not work as fast as we might like it to.
    */
   template <>
   template <>
@@ -150,6 +186,17 @@ namespace optimization {
       mlpack::svd::RegularizedSVDFunction<arma::mat>& function,
       arma::mat& parameters);
 
+  /**
+   * Template specializations for the parallel SGD optimizer, which use
+   * conflict-free stratified SGD (see svd::StratifiedParallelSGD()) instead of
+   * HOGWILD!.
+   */
+  template <>
+  template <>
+  inline double ParallelSGD<ConstantStep>::Optimize(
+      mlpack::svd::RegularizedSVDFunction<arma::mat>& function,
+      arma::mat& parameters);
+
   template <>
   template <>
   inline double ParallelSGD<ExponentialBackoff>::Optimize(
@@ -15,6 +15,10 @@
 #include "regularized_svd_function.hpp"
 #include <mlpack/core/math/make_alias.hpp>
 
+#ifdef HAS_OPENMP
+  #include <omp.h>
+#endif
+
 namespace mlpack {
 namespace svd {
 
@@ -173,6 +177,143 @@ void RegularizedSVDFunction<MatType>::Gradient(const arma::mat& parameters,
   }
 }
 
+template<typename DecayPolicyType>
+double StratifiedParallelSGD(
+    optimization::ParallelSGD<DecayPolicyType>& optimizer,
+    RegularizedSVDFunction<arma::mat>& function,
+    arma::mat& parameters)
+{
+  const size_t maxIterations = optimizer.MaxIterations();
+  const size_t evaluationInterval = optimizer.EvaluationInterval();
+
+  // Without any evaluation of the objective, the optimization would never
+  // terminate.
+  if (maxIterations == 0 && evaluationInterval == 0)
+  {
+    throw std::invalid_argument("ParallelSGD::Optimize(): the evaluation "
+        "interval must be positive when there is no limit on the number of "
+        "iterations!");
+  }
+
+  const arma::mat& data = function.Dataset();
+  const size_t numUsers = function.NumUsers();
+  const size_t numItems = function.NumItems();
+  const double lambda = function.Lambda();
+
+  // One group of users and items per thread.
+  size_t numGroups = 1;
+  #ifdef HAS_OPENMP
+    numGroups = omp_get_max_threads();
+  #endif
+  numGroups = std::max((size_t) 1, std::min(numGroups,
+      std::min(numUsers, numItems)));
+
+  // Assign the users and items to the groups at random, so that the blocks
+  // hold similar numbers of ratings.
+  arma::Col<size_t> userGroups(numUsers), itemGroups(numItems);
+  const arma::uvec userOrder = arma::randperm(numUsers);
+  for (size_t i = 0; i < numUsers; ++i)
+    userGroups[userOrder[i]] = (i * numGroups) / numUsers;
+  const arma::uvec itemOrder = arma::randperm(numItems);
+  for (size_t i = 0; i < numItems; ++i)
+    itemGroups[itemOrder[i]] = (i * numGroups) / numItems;
+
+  // Bucket the ratings into the blocks.
+  std::vector<std::vector<size_t>> blocks(numGroups * numGroups);
+  for (size_t j = 0; j < data.n_cols; ++j)
+  {
+    blocks[userGroups[(size_t) data(0, j)] * numGroups +
+        itemGroups[(size_t) data(1, j)]].push_back(j);
+  }
+
+  // The objective is evaluated in parallel.
+  auto objective = [&]()
+  {
+    double sum = 0.0;
+    #pragma omp parallel for reduction(+:sum)
+    for (omp_size_t j = 0; j < (omp_size_t) data.n_cols; ++j)
+      sum += function.Evaluate(parameters, j);
+    return sum;
+  };
+
+  double overallObjective = DBL_MAX;
+  double lastObjective;
+
+  for (size_t i = 1; i != maxIterations; ++i)
+  {
+    if (evaluationInterval > 0 && (i - 1) % evaluationInterval == 0)
+    {
+      // Calculate the overall objective.
+      lastObjective = overallObjective;
+      overallObjective = objective();
+
+      // Output current objective function.
+      Log::Info << "Parallel SGD: iteration " << i << ", objective "
+          << overallObjective << "." << std::endl;
+
+      if (std::isnan(overallObjective) || std::isinf(overallObjective))
+      {
+        Log::Warn << "Parallel SGD: converged to " << overallObjective
+            << "; terminating with failure. Try a smaller step size?"
+            << std::endl;
+        return overallObjective;
+      }
+
+      if (std::abs(lastObjective - overallObjective) < optimizer.Tolerance())
+      {
+        Log::Info << "SGD: minimized within tolerance "
+            << optimizer.Tolerance() << "; terminating optimization."
+            << std::endl;
+        return overallObjective;
+      }
+    }
+
+    const double stepSize = optimizer.DecayPolicy().StepSize(i);
+
+    // Thread g takes the block of user group g and item group (g + s) mod p,
+    // so no two threads share a user or an item.
+    const size_t stratum = (i - 1) % numGroups;
+    const size_t seed = mlpack::math::randGen();
+
+    #pragma omp parallel for
+    for (omp_size_t g = 0; g < (omp_size_t) numGroups; ++g)
+    {
+      std::vector<size_t>& block = blocks[g * numGroups +
+          (g + stratum) % numGroups];
+      if (optimizer.Shuffle())
+      {
+        std::mt19937 generator(seed + g);
+        std::shuffle(block.begin(), block.end(), generator);
+      }
+
+      for (size_t k = 0; k < block.size(); ++k)
+      {
+        const size_t user = data(0, block[k]);
+        const size_t item = data(1, block[k]) + numUsers;
+
+        // Prediction error for the example.
+        const double ratingError = data(2, block[k]) -
+            arma::dot(parameters.col(user), parameters.col(item));
+
+        // This is the gradient of Gradient(), restricted to the two columns it
+        // affects.
+        const arma::vec userUpdate = 2 * stepSize * (lambda *
+            parameters.col(user) - ratingError * parameters.col(item));
+        parameters.col(item) -= 2 * stepSize * (lambda * parameters.col(item) -
+            ratingError * parameters.col(user));
+        parameters.col(user) -= userUpdate;
+      }
+    }
+  }
+
+  // The last objective was computed before the last updates (if at all).
+  overallObjective = objective();
+
+  Log::Info << "\n Parallel SGD terminated with objective : "
+      << overallObjective << std::endl;
+  return overallObjective;
+}
+
 } // namespace svd
 } // namespace mlpack
 
@@ -240,107 +381,20 @@ double StandardSGD::Optimize(
 
 template <>
 template <>
-inline double ParallelSGD<ExponentialBackoff>::Optimize(
+inline double ParallelSGD<ConstantStep>::Optimize(
     mlpack::svd::RegularizedSVDFunction<arma::mat>& function,
-    arma::mat& iterate)
+    arma::mat& parameters)
 {
-  double overallObjective = DBL_MAX;
-  double lastObjective;
-
-  // The order in which the functions will be visited.
-  arma::Col<size_t> visitationOrder = arma::linspace<arma::Col<size_t>>(0,
-      (function.NumFunctions() - 1), function.NumFunctions());
-
-  const arma::mat data = function.Dataset();
-
-  // Iterate till the objective is within tolerance or the maximum number of
-  // allowed iterations is reached. If maxIterations is 0, this will iterate
-  // till convergence.
-  for (size_t i = 1; i != maxIterations; ++i)
-  {
-    // Calculate the overall objective.
-    lastObjective = overallObjective;
-    overallObjective = 0;
-
-    #pragma omp parallel for reduction(+:overallObjective)
-    for (omp_size_t j = 0; j < (omp_size_t) function.NumFunctions(); ++j)
-    {
-      overallObjective += function.Evaluate(iterate, j);
-    }
-
-    // Output current objective function.
-    Log::Info << "Parallel SGD: iteration " << i << ", objective "
-      << overallObjective << "." << std::endl;
-
-    if (std::isnan(overallObjective) || std::isinf(overallObjective))
-    {
-      Log::Warn << "Parallel SGD: converged to " << overallObjective
-        << "; terminating with failure. Try a smaller step size?"
-        << std::endl;
-      return overallObjective;
-    }
-
-    if (std::abs(lastObjective - overallObjective) < tolerance)
-    {
-      Log::Info << "SGD: minimized within tolerance " << tolerance << "; "
-        << "terminating optimization." << std::endl;
-      return overallObjective;
-    }
-
-    // Get the stepsize for this iteration
-    double stepSize = decayPolicy.StepSize(i);
-
-    if (shuffle) // Determine order of visitation.
-      std::shuffle(visitationOrder.begin(), visitationOrder.end(),
-          mlpack::math::randGen);
-
-    #pragma omp parallel
-    {
-      // Each processor gets a subset of the instances.
-      // Each subset is of size threadShareSize.
-      size_t threadId = 0;
-      #ifdef HAS_OPENMP
-        threadId = omp_get_thread_num();
-      #endif
-
-      for (size_t j = threadId * threadShareSize;
-          j < (threadId + 1) * threadShareSize && j < visitationOrder.n_elem;
-          ++j)
-      {
-        const size_t numUsers = function.NumUsers();
-
-        // Indices for accessing the the correct parameter columns.
-        const size_t user = data(0, visitationOrder[j]);
-        const size_t item = data(1, visitationOrder[j]) + numUsers;
-
-        // Prediction error for the example.
-        const double rating = data(2, visitationOrder[j]);
-        double ratingError = rating - arma::dot(iterate.col(user),
-            iterate.col(item));
-
-        double lambda = function.Lambda();
-
-        arma::mat userUpdate = stepSize * (lambda * iterate.col(user) -
-            ratingError * iterate.col(item));
-        arma::mat itemUpdate = stepSize * (lambda * iterate.col(item) -
-            ratingError * iterate.col(user));
-
-        // Gradient is non-zero only for the parameter columns corresponding to
-        // the example.
-        for (size_t i = 0; i < iterate.n_rows; ++i)
-        {
-          #pragma omp atomic
-          iterate(i, user) -= userUpdate(i);
-          #pragma omp atomic
-          iterate(i, item) -= itemUpdate(i);
-        }
-      }
-    }
-  }
-  Log::Info << "\n Parallel SGD terminated with objective : "
-    << overallObjective << std::endl;
+  return mlpack::svd::StratifiedParallelSGD(*this, function, parameters);
+}
 
-  return overallObjective;
+template <>
+template <>
+inline double ParallelSGD<ExponentialBackoff>::Optimize(
+    mlpack::svd::RegularizedSVDFunction<arma::mat>& function,
+    arma::mat& parameters)
+{
+  return mlpack::svd::StratifiedParallelSGD(*this, function, parameters);
 }
 
 } // namespace optimization
@@ -14,7 +14,7 @@
 #define MLPACK_METHODS_RL_ASYNC_LEARNING_IMPL_HPP
 
 #include <mlpack/prereqs.hpp>
-#include "queue"
+#include <atomic>
 
 namespace mlpack {
 namespace rl {
@@ -69,9 +69,9 @@ void AsyncLearning<
   if (learningNetwork.Parameters().is_empty())
     learningNetwork.ResetParameters();
   NetworkType targetNetwork = learningNetwork;
-  size_t totalSteps = 0;
+  std::atomic<size_t> totalSteps(0);
   PolicyType policy = this->policy;
-  bool stop = false;
+  std::atomic<bool> stop(false);
 
   // Set up worker pool, worker 0 will be deterministic for evaluation.
   std::vector<WorkerType> workers;
@@ -80,52 +80,28 @@ void AsyncLearning<
     workers.push_back(WorkerType(updater, environment, config, !i));
     workers.back().Initialize(learningNetwork);
   }
-  // Set up task queue corresponding to worker pool.
-  std::queue<size_t> tasks;
-  for (size_t i = 0; i <= config.NumWorkers(); ++i)
-    tasks.push(i);
 
   /**
    * Compute the number of threads for the for-loop. In general, we should use
    * OpenMP task rather than for-loop, here we do so to be compatible with some
    * compiler. We can switch to OpenMP task once MSVC supports OpenMP 3.0.
    */
-  size_t numThreads = 0;
-  #pragma omp parallel reduction(+:numThreads)
-  numThreads++;
+  const size_t numThreads = std::min(Parallel::Threads(), workers.size());
   Log::Debug << numThreads << " threads will be used in total." << std::endl;
 
-  #pragma omp parallel for shared(stop, workers, tasks, learningNetwork, \
-      targetNetwork, totalSteps, policy)
-  for (omp_size_t i = 0; i < numThreads; ++i)
+  /**
+   * Each thread owns a fixed set of workers (worker i belongs to thread
+   * i % numThreads) and steps them in turn, so a worker is never used by two
+   * threads and no lock is needed to schedule them.  The workers update the
+   * shared networks without locks.
+   */
+  #pragma omp parallel for num_threads(numThreads) shared(stop, workers, \
+      learningNetwork, targetNetwork, totalSteps, policy)
+  for (omp_size_t i = 0; i < (omp_size_t) numThreads; ++i)
   {
-    #pragma omp critical
-    {
-      #ifdef HAS_OPENMP
-        Log::Debug << "Thread " << omp_get_thread_num() <<
-            " started." << std::endl;
-      #endif
-    }
-    size_t task = std::numeric_limits<size_t>::max();
+    size_t task = i;
     while (!stop)
     {
-      // Assign task to current thread from queue.
-      #pragma omp critical
-      {
-        if (task != std::numeric_limits<size_t>::max())
-          tasks.push(task);
-
-        if (!tasks.empty())
-        {
-          task = tasks.front();
-          tasks.pop();
-        }
-      };
-
-      // This may happen when threads are more than workers.
-      if (task == std::numeric_limits<size_t>::max())
-        continue;
-
       // Get corresponding worker.
       WorkerType& worker = workers[task];
       double episodeReturn;
@@ -134,6 +110,11 @@ void AsyncLearning<
       {
         stop = measure(episodeReturn);
       }
+
+      // Move on to the next worker of this thread.
+      task += numThreads;
+      if (task >= workers.size())
+        task = i;
     }
   }
 
@@ -0,0 +1,179 @@
+/**
+ * @file vector_environment.hpp
+ *
+ * This file is an implementation of a wrapper that runs several copies of an
+ * environment in lockstep.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_RL_ENVIRONMENT_VECTOR_ENVIRONMENT_HPP
+#define MLPACK_METHODS_RL_ENVIRONMENT_VECTOR_ENVIRONMENT_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace rl {
+
+/**
+ * A vectorized environment: several copies of an environment, each with its
+ * own current state, that all take one step at a time together.  The current
+ * states can be encoded as the columns of one matrix, so that the action values
+ * of all the copies are computed with one forward pass of a network (see
+ * QLearning::Step(VectorEnvironment&)).
+ *
+ * When the episode of a copy ends (because its next state is terminal or
+ * because it reached the step limit), its return is saved in EpisodeReturns()
+ * and it starts a new episode from an initial state.
+ *
+ * @tparam EnvironmentType The type of the reinforcement learning task.
+ */
+template <typename EnvironmentType>
+class VectorEnvironment
+{
+ public:
+  //! Convenient typedef for state.
+  using StateType = typename EnvironmentType::State;
+
+  //! Convenient typedef for action.
+  using ActionType = typename EnvironmentType::Action;
+
+  /**
+   * Create the given number of copies of the environment, and start an episode
+   * in each of them.
+   *
+   * @param size Number of copies of the environment.
+   * @param environment The environment to copy.
+   * @param stepLimit Maximum number of steps of each episode (0 means no
+   *        limit).
+   */
+  VectorEnvironment(const size_t size,
+                    const EnvironmentType& environment = EnvironmentType(),
+                    const size_t stepLimit = 0) :
+      environments(size, environment),
+      states(size),
+      steps(size),
+      returns(size),
+      stepLimit(stepLimit)
+  {
+    Reset();
+  }
+
+  /**
+   * Start a new episode in every copy of the environment.
+   */
+  void Reset()
+  {
+    for (size_t i = 0; i < environments.size(); ++i)
+    {
+      states[i] = environments[i].InitialSample();
+      steps[i] = 0;
+      returns[i] = 0.0;
+    }
+  }
+
+  /**
+   * Encode the current states of all the copies as the columns of a matrix.
+   *
+   * @param encoded Matrix to store the encoded states in.
+   */
+  void Encode(arma::mat& encoded) const
+  {
+    if (states.empty())
+    {
+      encoded.reset();
+      return;
+    }
+
+    encoded.set_size(states[0].Encode().n_elem, states.size());
+    for (size_t i = 0; i < states.size(); ++i)
+      encoded.col(i) = states[i].Encode();
+  }
+
+  /**
+   * Take one step in every copy of the environment, with the given actions.
+   * Copies whose episode ended start a new one, so their current state is then
+   * an initial state, not nextStates[i].
+   *
+   * @param actions The action of each copy.
+   * @param rewards The reward of each copy will be stored here.
+   * @param nextStates The next state of each copy will be stored here.
+   * @param terminal Whether the next state of each copy is terminal will be
+   *        stored here.
+   */
+  void Step(const std::vector<ActionType>& actions,
+            arma::colvec& rewards,
+            std::vector<StateType>& nextStates,
+            std::vector<bool>& terminal)
+  {
+    rewards.set_size(environments.size());
+    nextStates.resize(environments.size());
+    terminal.resize(environments.size());
+    for (size_t i = 0; i < environments.size(); ++i)
+    {
+      rewards[i] = environments[i].Sample(states[i], actions[i],
+          nextStates[i]);
+      terminal[i] = environments[i].IsTerminal(nextStates[i]);
+      returns[i] += rewards[i];
+      ++steps[i];
+
+      if (terminal[i] || (stepLimit && steps[i] >= stepLimit))
+      {
+        episodeReturns.push_back(returns[i]);
+        states[i] = environments[i].InitialSample();
+        steps[i] = 0;
+        returns[i] = 0.0;
+      }
+      else
+      {
+        states[i] = nextStates[i];
+      }
+    }
+  }
+
+  //! Get the number of copies of the environment.
+  size_t Size() const { return environments.size(); }
+
+  //! Get the current state of each copy.
+  const std::vector<StateType>& States() const { return states; }
+
+  //! Get the copies of the environment.
+  const std::vector<EnvironmentType>& Environments() const
+  { return environments; }
+
+  //! Get the returns of the episodes that ended so far.
+  const std::vector<double>& EpisodeReturns() const { return episodeReturns; }
+  //! Modify the returns of the episodes that ended so far (to clear them).
+  std::vector<double>& EpisodeReturns() { return episodeReturns; }
+
+  //! Get the maximum number of steps of each episode (0 means no limit).
+  size_t StepLimit() const { return stepLimit; }
+  //! Modify the maximum number of steps of each episode.
+  size_t& StepLimit() { return stepLimit; }
+
+ private:
+  //! The copies of the environment.
+  std::vector<EnvironmentType> environments;
+
+  //! The current state of each copy.
+  std::vector<StateType> states;
+
+  //! The number of steps of the current episode of each copy.
+  std::vector<size_t> steps;
+
+  //! The return of the current episode of each copy.
+  std::vector<double> returns;
+
+  //! The returns of the episodes that ended.
+  std::vector<double> episodeReturns;
+
+  //! Maximum number of steps of each episode.
+  size_t stepLimit;
+};
+
+} // namespace rl
+} // namespace mlpack
+
+#endif
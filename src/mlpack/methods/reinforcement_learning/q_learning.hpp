@@ -14,8 +14,12 @@
 #define MLPACK_METHODS_RL_Q_LEARNING_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <atomic>
+#include <tuple>
 
 #include "replay/random_replay.hpp"
+#include "replay/prioritized_replay.hpp"
+#include "environment/vector_environment.hpp"
 #include "training_config.hpp"
 
 namespace mlpack {
@@ -45,7 +49,9 @@ namespace rl {
  * @tparam NetworkType The network to compute action value.
  * @tparam UpdaterType How to apply gradients when training.
  * @tparam PolicyType Behavior policy of the agent.
- * @tparam ReplayType Experience replay method.
+ * @tparam ReplayType Experience replay method (RandomReplay or
+ *     PrioritizedReplay); the importance-sampling weights it gives scale the
+ *     update of each sampled experience.
  */
 template <
   typename EnvironmentType,
@@ -89,12 +95,48 @@ class QLearning
    */
   double Step();
 
+  /**
+   * Execute a step in each of the given copies of the environment, in
+   * lockstep.  The actions of all the copies are selected with one forward
+   * pass of the learning network, all the transitions are stored for replay,
+   * and then one batch of experience is learnt from (once the exploration
+   * steps are over).  The environment of this object is not used.
+   *
+   * @param environments The copies of the environment.
+   * @return Sum of the rewards of the copies for the step.
+   */
+  double Step(VectorEnvironment<EnvironmentType>& environments);
+
   /**
    * Execute an episode.
    * @return Return of the episode.
    */
   double Episode();
 
+  /**
+   * Train the agent with several actors and one learner running in parallel.
+   * Each actor (there are config.NumActors()) steps its own copy of the
+   * environment with its own copy of the behavior policy and of the network,
+   * and stores its transitions for replay config.UpdateInterval() at a time.
+   * The learner learns from one batch of experience after the other, syncs
+   * the target network every config.TargetNetworkSyncInterval() updates, and
+   * sends its weights to the actors every config.ActorSyncInterval() updates,
+   * so the actors act with slightly stale weights.  The replay method is
+   * shared between the threads and guarded by a critical section.  The
+   * environment and the behavior policy of this object are only copied.
+   *
+   * @tparam Measure The type of the measurement. It should be a
+   *   callable object like
+   *   @code
+   *   bool foo(double reward);
+   *   @endcode
+   *   where reward is the return of an episode of any of the actors, and the
+   *   return value should indicate whether the training process is completed.
+   * @param measure The measurement instance.
+   */
+  template <typename Measure>
+  void Train(Measure& measure);
+
   /**
    * @return Total steps from beginning.
    */
@@ -113,6 +155,62 @@ class QLearning
    */
   arma::Col<size_t> BestAction(const arma::mat& actionValues);
 
+  /**
+   * Learn from one batch of experience sampled from the replay method.
+   */
+  void TrainAgent();
+
+  /**
+   * Learn from the batch of experience in the buffers of the last sample, and
+   * store the temporal difference errors of the batch in tdErrors.
+   */
+  void LearnFromSample();
+
+  /**
+   * An actor of Train(): its own copies of the network (with the weights the
+   * learner sent last), of the behavior policy and of the environment, its
+   * current episode, and the transitions it has not stored for replay yet.
+   */
+  struct Actor
+  {
+    Actor(const NetworkType& network,
+          const PolicyType& policy,
+          const EnvironmentType& environment) :
+        network(network),
+        policy(policy),
+        environment(environment),
+        state(this->environment.InitialSample()),
+        steps(0),
+        episodeReturn(0.0),
+        version(0)
+    { /* Nothing to do here. */ }
+
+    //! The copy of the network.
+    NetworkType network;
+
+    //! The copy of the behavior policy.
+    PolicyType policy;
+
+    //! The copy of the environment.
+    EnvironmentType environment;
+
+    //! The current state of the actor.
+    StateType state;
+
+    //! The number of steps of the current episode.
+    size_t steps;
+
+    //! The return of the current episode.
+    double episodeReturn;
+
+    //! How many times the learner had sent its weights when they were copied.
+    size_t version;
+
+    //! The transitions that are not stored for replay yet.
+    std::vector<std::tuple<StateType, ActionType, double, StateType, bool>>
+        transitions;
+  };
+
   //! Locally-stored hyper-parameters.
   TrainingConfig config;
 
@@ -142,6 +240,27 @@ class QLearning
 
   //! Locally-stored flag indicating training mode or test mode.
   bool deterministic;
+
+  //! Encoded states of the last sample (reused between steps).
+  arma::mat sampledStates;
+
+  //! Actions of the last sample.
+  arma::icolvec sampledActions;
+
+  //! Rewards of the last sample.
+  arma::colvec sampledRewards;
+
+  //! Encoded next states of the last sample.
+  arma::mat sampledNextStates;
+
+  //! Whether the next states of the last sample are terminal.
+  arma::icolvec isTerminal;
+
+  //! Importance-sampling weights of the last sample.
+  arma::colvec sampledWeights;
+
+  //! Temporal difference errors of the last sample.
+  arma::colvec tdErrors;
 };
 
 } // namespace rl
@@ -114,16 +114,111 @@ double QLearning<
     return reward;
 
   // Start experience replay.
+  TrainAgent();
 
-  // Sample from previous experience.
-  arma::mat sampledStates;
-  arma::icolvec sampledActions;
-  arma::colvec sampledRewards;
-  arma::mat sampledNextStates;
-  arma::icolvec isTerminal;
+  return reward;
+}
+
+template <
+  typename EnvironmentType,
+  typename NetworkType,
+  typename UpdaterType,
+  typename BehaviorPolicyType,
+  typename ReplayType
+>
+double QLearning<
+  EnvironmentType,
+  NetworkType,
+  UpdaterType,
+  BehaviorPolicyType,
+  ReplayType
+>::Step(VectorEnvironment<EnvironmentType>& environments)
+{
+  // Get the action values of all the current states with one forward pass.
+  const std::vector<StateType> states = environments.States();
+  arma::mat encodedStates;
+  environments.Encode(encodedStates);
+  arma::mat actionValues;
+  learningNetwork.Predict(encodedStates, actionValues);
+
+  // Select the action of each environment according to the behavior policy.
+  std::vector<ActionType> actions(environments.Size());
+  for (size_t i = 0; i < environments.Size(); ++i)
+    actions[i] = policy.Sample(actionValues.unsafe_col(i), deterministic);
+
+  // Advance all the environments, and store the transitions for replay.
+  arma::colvec rewards;
+  std::vector<StateType> nextStates;
+  std::vector<bool> terminal;
+  environments.Step(actions, rewards, nextStates, terminal);
+  for (size_t i = 0; i < environments.Size(); ++i)
+  {
+    replayMethod.Store(states[i], actions[i], rewards[i], nextStates[i],
+        terminal[i]);
+  }
+
+  if (deterministic)
+    return arma::accu(rewards);
+
+  // Update the target network if a synchronization point was passed, and
+  // anneal the policy once for each step past the exploration steps.
+  const size_t previousSteps = totalSteps;
+  totalSteps += environments.Size();
+  if (totalSteps / config.TargetNetworkSyncInterval() !=
+      previousSteps / config.TargetNetworkSyncInterval())
+    targetNetwork = learningNetwork;
+
+  for (size_t step = previousSteps + 1; step <= totalSteps; ++step)
+    if (step > config.ExplorationSteps())
+      policy.Anneal();
+
+  // Learn from one batch of experience per tick.
+  if (previousSteps >= config.ExplorationSteps())
+    TrainAgent();
+
+  return arma::accu(rewards);
+}
+
+template <
+  typename EnvironmentType,
+  typename NetworkType,
+  typename UpdaterType,
+  typename BehaviorPolicyType,
+  typename ReplayType
+>
+void QLearning<
+  EnvironmentType,
+  NetworkType,
+  UpdaterType,
+  BehaviorPolicyType,
+  ReplayType
+>::TrainAgent()
+{
+  // Sample from previous experience, into the buffers of the last sample.
   replayMethod.Sample(sampledStates, sampledActions, sampledRewards,
-      sampledNextStates, isTerminal);
+      sampledNextStates, isTerminal, sampledWeights);
 
+  LearnFromSample();
+
+  // Give the new errors to the replay method (for the priorities).
+  replayMethod.Update(tdErrors);
+}
+
+template <
+  typename EnvironmentType,
+  typename NetworkType,
+  typename UpdaterType,
+  typename BehaviorPolicyType,
+  typename ReplayType
+>
+void QLearning<
+  EnvironmentType,
+  NetworkType,
+  UpdaterType,
+  BehaviorPolicyType,
+  ReplayType
+>::LearnFromSample()
+{
   // Compute action value for next state with target network.
   arma::mat nextActionValues;
   targetNetwork.Predict(sampledNextStates, nextActionValues);
@@ -141,21 +236,24 @@ double QLearning<
     bestActions = BestAction(nextActionValues);
   }
 
-  // Compute the update target.
+  // Compute the update target.  The gradient of the squared error is scaled
+  // by the importance-sampling weight of each experience, so only that share
+  // of the temporal difference error goes into the target.
   arma::mat target;
   learningNetwork.Forward(sampledStates, target);
+  tdErrors.set_size(sampledNextStates.n_cols);
   for (size_t i = 0; i < sampledNextStates.n_cols; ++i)
   {
-    target(sampledActions[i], i) = sampledRewards[i] + config.Discount() *
+    const double targetActionValue = sampledRewards[i] + config.Discount() *
         (isTerminal[i] ? 0.0 : nextActionValues(bestActions[i], i));
+    tdErrors[i] = targetActionValue - target(sampledActions[i], i);
+    target(sampledActions[i], i) += sampledWeights[i] * tdErrors[i];
   }
 
   // Learn form experience.
   arma::mat gradients;
   learningNetwork.Backward(target, gradients);
   updater.Update(learningNetwork.Parameters(), config.StepSize(), gradients);
-
-  return reward;
 }
 
 template <
@@ -207,6 +305,162 @@ double QLearning<
   return totalReturn;
 }
 
+template <
+  typename EnvironmentType,
+  typename NetworkType,
+  typename UpdaterType,
+  typename BehaviorPolicyType,
+  typename ReplayType
+>
+template <typename Measure>
+void QLearning<
+  EnvironmentType,
+  NetworkType,
+  UpdaterType,
+  BehaviorPolicyType,
+  ReplayType
+>::Train(Measure& measure)
+{
+  // Set up the actors, each with its own copies.
+  const size_t numActors = std::max(config.NumActors(), (size_t) 1);
+  std::vector<Actor> actors;
+  for (size_t i = 0; i < numActors; ++i)
+    actors.push_back(Actor(learningNetwork, policy, environment));
+
+  // The weights the learner sent last, and how many times it sent them.
+  arma::mat sentParameters = learningNetwork.Parameters();
+  std::atomic<size_t> version(0);
+
+  std::atomic<size_t> steps(totalSteps);
+  std::atomic<bool> stop(false);
+  size_t updates = 0;
+  const size_t storeInterval = std::max(config.UpdateInterval(), (size_t) 1);
+
+  /**
+   * Role 0 is the learner and role i > 0 is actor i - 1.  As in
+   * AsyncLearning::Train(), each thread owns a fixed set of roles (role i
+   * belongs to thread i % numThreads) and steps them in turn, so with enough
+   * threads the learner and each actor run in their own thread, and with one
+   * thread they are interleaved.
+   */
+  const size_t numThreads = std::min(Parallel::Threads(), numActors + 1);
+  Log::Debug << numThreads << " threads will be used in total." << std::endl;
+
+  #pragma omp parallel for num_threads(numThreads) shared(actors, \
+      sentParameters, version, steps, stop, updates, measure)
+  for (omp_size_t i = 0; i < (omp_size_t) numThreads; ++i)
+  {
+    size_t role = i;
+    while (!stop)
+    {
+      if (role == 0)
+      {
+        // The learner waits for the exploration steps to be over.  The
+        // actors may overwrite some of the sampled experiences before their
+        // priorities are updated; that only makes the priorities a bit stale.
+        if (steps >= config.ExplorationSteps())
+        {
+          #pragma omp critical(QLearningReplay)
+          replayMethod.Sample(sampledStates, sampledActions, sampledRewards,
+              sampledNextStates, isTerminal, sampledWeights);
+
+          LearnFromSample();
+
+          #pragma omp critical(QLearningReplay)
+          replayMethod.Update(tdErrors);
+
+          ++updates;
+          if (updates % config.TargetNetworkSyncInterval() == 0)
+            targetNetwork.Parameters() = learningNetwork.Parameters();
+
+          if (updates % config.ActorSyncInterval() == 0)
+          {
+            #pragma omp critical(QLearningWeights)
+            {
+              sentParameters = learningNetwork.Parameters();
+              ++version;
+            }
+          }
+        }
+      }
+      else
+      {
+        Actor& actor = actors[role - 1];
+
+        // Take the weights the learner sent since the last step, if any.
+        if (actor.version != version)
+        {
+          #pragma omp critical(QLearningWeights)
+          {
+            actor.network.Parameters() = sentParameters;
+            actor.version = version;
+          }
+        }
+
+        arma::colvec actionValue;
+        actor.network.Predict(actor.state.Encode(), actionValue);
+        const ActionType action = actor.policy.Sample(actionValue);
+
+        StateType nextState;
+        const double reward = actor.environment.Sample(actor.state, action,
+            nextState);
+        const bool terminal = actor.environment.IsTerminal(nextState);
+        actor.transitions.push_back(std::make_tuple(actor.state, action,
+            reward, nextState, terminal));
+        actor.episodeReturn += reward;
+        ++actor.steps;
+
+        if (++steps > config.ExplorationSteps())
+          actor.policy.Anneal();
+
+        const bool episodeEnd = terminal ||
+            (config.StepLimit() && actor.steps >= config.StepLimit());
+
+        // Store the transitions in bunches, to take the lock less often.
+        if (episodeEnd || actor.transitions.size() >= storeInterval)
+        {
+          #pragma omp critical(QLearningReplay)
+          {
+            for (size_t j = 0; j < actor.transitions.size(); ++j)
+            {
+              replayMethod.Store(std::get<0>(actor.transitions[j]),
+                  std::get<1>(actor.transitions[j]),
+                  std::get<2>(actor.transitions[j]),
+                  std::get<3>(actor.transitions[j]),
+                  std::get<4>(actor.transitions[j]));
+            }
+          }
+          actor.transitions.clear();
+        }
+
+        if (episodeEnd)
+        {
+          #pragma omp critical(QLearningMeasure)
+          {
+            if (measure(actor.episodeReturn))
+              stop = true;
+          }
+
+          actor.state = actor.environment.InitialSample();
+          actor.steps = 0;
+          actor.episodeReturn = 0.0;
+        }
+        else
+        {
+          actor.state = nextState;
+        }
+      }
+
+      // Move on to the next role of this thread.
+      role += numThreads;
+      if (role > numActors)
+        role = i;
+    }
+  }
+
+  totalSteps = steps;
+}
+
 } // namespace rl
 } // namespace mlpack
 
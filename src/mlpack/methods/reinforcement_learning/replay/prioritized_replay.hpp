@@ -0,0 +1,278 @@
+/**
+ * @file prioritized_replay.hpp
+ *
+ * This file is an implementation of prioritized experience replay.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_RL_REPLAY_PRIORITIZED_REPLAY_HPP
+#define MLPACK_METHODS_RL_REPLAY_PRIORITIZED_REPLAY_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/math/random.hpp>
+#include "sum_tree.hpp"
+
+namespace mlpack {
+namespace rl {
+
+/**
+ * Implementation of prioritized experience replay.
+ *
+ * Like the RandomReplay, the memory is a First-In-First-Out buffer, but each
+ * experience is sampled with a probability proportional to its priority raised
+ * to the power alpha.  The priority of an experience is the absolute value of
+ * its last temporal difference error (given with Update()); new experiences
+ * get the largest priority seen so far, so that they are sampled at least
+ * once.  To correct the bias this introduces, each sampled experience comes
+ * with an importance-sampling weight (N P(i))^-beta, divided by the largest
+ * weight of the batch.  The priorities are held in a SumTree, so sampling and
+ * updating a priority take O(log n) time.
+ *
+ * For more information, see the following.
+ *
+ * @code
+ * @inproceedings{schaul2016prioritized,
+ *  title     = {Prioritized Experience Replay},
+ *  author    = {Schaul, Tom and Quan, John and Antonoglou, Ioannis and
+ *               Silver, David},
+ *  booktitle = {International Conference on Learning Representations},
+ *  year      = {2016}
+ * }
+ * @endcode
+ *
+ * @tparam EnvironmentType Desired task.
+ */
+template <typename EnvironmentType>
+class PrioritizedReplay
+{
+ public:
+  //! Convenient typedef for action.
+  using ActionType = typename EnvironmentType::Action;
+
+  //! Convenient typedef for state.
+  using StateType = typename EnvironmentType::State;
+
+  /**
+   * Construct an instance of prioritized experience replay class.
+   *
+   * @param batchSize Number of examples returned at each sample.
+   * @param capacity Total memory size in terms of number of examples.
+   * @param alpha How much the priorities are used (0 is uniform sampling).
+   * @param beta How much the importance-sampling weights correct the bias (1
+   *        is full correction).
+   * @param dimension The dimension of an encoded state.
+   */
+  PrioritizedReplay(const size_t batchSize,
+                    const size_t capacity,
+                    const double alpha = 0.6,
+                    const double beta = 0.4,
+                    const size_t dimension = StateType::dimension) :
+      batchSize(batchSize),
+      capacity(capacity),
+      alpha(alpha),
+      beta(beta),
+      position(0),
+      states(dimension, capacity),
+      actions(capacity),
+      rewards(capacity),
+      nextStates(dimension, capacity),
+      isTerminal(capacity),
+      full(false),
+      priorities(capacity),
+      maxPriority(1.0),
+      sampledIndices(batchSize)
+  { /* Nothing to do here. */ }
+
+  /**
+   * Store the given experience, with the largest priority seen so far.
+   *
+   * @param state Given state.
+   * @param action Given action.
+   * @param reward Given reward.
+   * @param nextState Given next state.
+   * @param isEnd Whether next state is terminal state.
+   */
+  void Store(const StateType& state,
+             ActionType action,
+             double reward,
+             const StateType& nextState,
+             bool isEnd)
+  {
+    states.col(position) = state.Encode();
+    actions(position) = action;
+    rewards(position) = reward;
+    nextStates.col(position) = nextState.Encode();
+    isTerminal(position) = isEnd;
+    priorities.Set(position, std::pow(maxPriority, alpha));
+    position++;
+    if (position == capacity)
+    {
+      full = true;
+      position = 0;
+    }
+  }
+
+  /**
+   * Sample some experiences in proportion to their priorities.  The batch is
+   * written into the given objects, so they are not reallocated if they are
+   * reused.
+   *
+   * @param sampledStates Sampled encoded states.
+   * @param sampledActions Sampled actions.
+   * @param sampledRewards Sampled rewards.
+   * @param sampledNextStates Sampled encoded next states.
+   * @param isTerminal Indicate whether corresponding next state is terminal
+   *        state.
+   */
+  void Sample(arma::mat& sampledStates,
+              arma::icolvec& sampledActions,
+              arma::colvec& sampledRewards,
+              arma::mat& sampledNextStates,
+              arma::icolvec& isTerminal)
+  {
+    // The sum of the priorities is split into one segment per sample, and
+    // each experience is taken at a random point of its segment.
+    const double segment = priorities.Sum() / batchSize;
+    for (size_t i = 0; i < batchSize; ++i)
+    {
+      sampledIndices[i] = priorities.Find((i + math::Random()) * segment);
+
+      // Rounding could make the tree point to an empty slot.
+      if (sampledIndices[i] >= Size())
+        sampledIndices[i] = Size() - 1;
+    }
+
+    sampledStates.set_size(states.n_rows, batchSize);
+    sampledActions.set_size(batchSize);
+    sampledRewards.set_size(batchSize);
+    sampledNextStates.set_size(nextStates.n_rows, batchSize);
+    isTerminal.set_size(batchSize);
+    for (size_t i = 0; i < batchSize; ++i)
+    {
+      sampledStates.col(i) = states.col(sampledIndices[i]);
+      sampledActions(i) = actions(sampledIndices[i]);
+      sampledRewards(i) = rewards(sampledIndices[i]);
+      sampledNextStates.col(i) = nextStates.col(sampledIndices[i]);
+      isTerminal(i) = this->isTerminal(sampledIndices[i]);
+    }
+  }
+
+  /**
+   * Sample some experiences in proportion to their priorities, with their
+   * importance-sampling weights.
+   *
+   * @param sampledStates Sampled encoded states.
+   * @param sampledActions Sampled actions.
+   * @param sampledRewards Sampled rewards.
+   * @param sampledNextStates Sampled encoded next states.
+   * @param isTerminal Indicate whether corresponding next state is terminal
+   *        state.
+   * @param weights Importance-sampling weights of the sampled experiences.
+   */
+  void Sample(arma::mat& sampledStates,
+              arma::icolvec& sampledActions,
+              arma::colvec& sampledRewards,
+              arma::mat& sampledNextStates,
+              arma::icolvec& isTerminal,
+              arma::colvec& weights)
+  {
+    Sample(sampledStates, sampledActions, sampledRewards, sampledNextStates,
+        isTerminal);
+
+    // The weights are (N P(i))^-beta, scaled so that the largest is 1.
+    weights.set_size(batchSize);
+    const double sum = priorities.Sum();
+    for (size_t i = 0; i < batchSize; ++i)
+    {
+      weights(i) = std::pow(Size() * priorities.Get(sampledIndices[i]) / sum,
+          -beta);
+    }
+    weights /= weights.max();
+  }
+
+  /**
+   * Set the priorities of the experiences of the last sample from their new
+   * temporal difference errors.
+   *
+   * @param errors Temporal difference error of each sampled experience.
+   */
+  void Update(const arma::colvec& errors)
+  {
+    for (size_t i = 0; i < batchSize; ++i)
+    {
+      // A small constant keeps every experience possible to sample.
+      const double priority = std::abs(errors(i)) + 1e-6;
+      maxPriority = std::max(maxPriority, priority);
+      priorities.Set(sampledIndices[i], std::pow(priority, alpha));
+    }
+  }
+
+  /**
+   * Get the number of transitions in the memory.
+   *
+   * @return Actual used memory size
+   */
+  const size_t& Size()
+  {
+    return full ? capacity : position;
+  }
+
+  //! Get the priority exponent.
+  double Alpha() const { return alpha; }
+
+  //! Get the importance-sampling exponent.
+  double Beta() const { return beta; }
+  //! Modify the importance-sampling exponent (it is usually annealed to 1).
+  double& Beta() { return beta; }
+
+ private:
+  //! Locally-stored number of examples of each sample.
+  size_t batchSize;
+
+  //! Locally-stored total memory limit.
+  size_t capacity;
+
+  //! Locally-stored priority exponent.
+  double alpha;
+
+  //! Locally-stored importance-sampling exponent.
+  double beta;
+
+  //! Indicate the position to store new transition.
+  size_t position;
+
+  //! Locally-stored encoded previous states.
+  arma::mat states;
+
+  //! Locally-stored previous actions.
+  arma::icolvec actions;
+
+  //! Locally-stored previous rewards.
+  arma::colvec rewards;
+
+  //! Locally-stored encoded previous next states.
+  arma::mat nextStates;
+
+  //! Locally-stored termination information of previous experience.
+  arma::icolvec isTerminal;
+
+  //! Locally-stored indicator that whether the memory is full or not
+  bool full;
+
+  //! The priority of each experience, raised to the power alpha.
+  SumTree priorities;
+
+  //! The largest priority seen so far.
+  double maxPriority;
+
+  //! The indices of the experiences of the last sample.
+  std::vector<size_t> sampledIndices;
+};
+
+} // namespace rl
+} // namespace mlpack
+
+#endif
@@ -13,6 +13,7 @@
 #define MLPACK_METHODS_RL_REPLAY_RANDOM_REPLAY_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/core/math/random.hpp>
 
 namespace mlpack {
 namespace rl {
@@ -67,7 +68,8 @@ class RandomReplay
       rewards(capacity),
       nextStates(dimension, capacity),
       isTerminal(capacity),
-      full(false)
+      full(false),
+      sampledIndices(batchSize)
   { /* Nothing to do here. */ }
 
   /**
@@ -99,7 +101,8 @@ class RandomReplay
   }
 
   /**
-   * Sample some experiences.
+   * Sample some experiences.  The batch is written into the given objects, so
+   * they are not reallocated if they are reused.
    *
    * @param sampledStates Sampled encoded states.
    * @param sampledActions Sampled actions.
@@ -115,16 +118,54 @@ class RandomReplay
               arma::icolvec& isTerminal)
   {
     size_t upperBound = full ? capacity : position;
-    arma::uvec sampledIndices = arma::randi<arma::uvec>(
-        batchSize, arma::distr_param(0, upperBound - 1));
-
-    sampledStates = states.cols(sampledIndices);
-    sampledActions = actions.elem(sampledIndices);
-    sampledRewards = rewards.elem(sampledIndices);
-    sampledNextStates = nextStates.cols(sampledIndices);
-    isTerminal = this->isTerminal.elem(sampledIndices);
+    for (size_t i = 0; i < batchSize; ++i)
+      sampledIndices[i] = math::RandInt(upperBound);
+
+    sampledStates.set_size(states.n_rows, batchSize);
+    sampledActions.set_size(batchSize);
+    sampledRewards.set_size(batchSize);
+    sampledNextStates.set_size(nextStates.n_rows, batchSize);
+    isTerminal.set_size(batchSize);
+    for (size_t i = 0; i < batchSize; ++i)
+    {
+      sampledStates.col(i) = states.col(sampledIndices[i]);
+      sampledActions(i) = actions(sampledIndices[i]);
+      sampledRewards(i) = rewards(sampledIndices[i]);
+      sampledNextStates.col(i) = nextStates.col(sampledIndices[i]);
+      isTerminal(i) = this->isTerminal(sampledIndices[i]);
+    }
+  }
+
+  /**
+   * Sample some experiences, with their importance-sampling weights, which are
+   * all 1 for uniform sampling.
+   *
+   * @param sampledStates Sampled encoded states.
+   * @param sampledActions Sampled actions.
+   * @param sampledRewards Sampled rewards.
+   * @param sampledNextStates Sampled encoded next states.
+   * @param isTerminal Indicate whether corresponding next state is terminal
+   *        state.
+   * @param weights Importance-sampling weights of the sampled experiences.
+   */
+  void Sample(arma::mat& sampledStates,
+              arma::icolvec& sampledActions,
+              arma::colvec& sampledRewards,
+              arma::mat& sampledNextStates,
+              arma::icolvec& isTerminal,
+              arma::colvec& weights)
+  {
+    Sample(sampledStates, sampledActions, sampledRewards, sampledNextStates,
+        isTerminal);
+    weights.ones(batchSize);
   }
 
+  /**
+   * Give the temporal difference errors of the experiences of the last sample.
+   * Uniform sampling does not use them.
+   */
+  void Update(const arma::colvec& /* errors */) { }
+
   /**
    * Get the number of transitions in the memory.
    *
@@ -162,6 +203,9 @@ class RandomReplay
 
   //! Locally-stored indicator that whether the memory is full or not
   bool full;
+
+  //! The indices of the experiences of the last sample.
+  std::vector<size_t> sampledIndices;
 };
 
 } // namespace rl
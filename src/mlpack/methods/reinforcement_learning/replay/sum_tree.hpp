@@ -0,0 +1,116 @@
+/**
+ * @file sum_tree.hpp
+ *
+ * This file is an implementation of a sum tree, which holds a nonnegative
+ * value for each index and can find the index at a given prefix sum.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_RL_REPLAY_SUM_TREE_HPP
+#define MLPACK_METHODS_RL_REPLAY_SUM_TREE_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace rl {
+
+/**
+ * A sum tree holds a nonnegative value for each of a fixed number of indices.
+ * It is a complete binary tree stored in an array, whose leaves are the values
+ * and whose other nodes are the sums of their children, so setting a value and
+ * finding the index at which the prefix sum of the values reaches a given
+ * amount both take O(log n) time.  This is what sampling in proportion to the
+ * values needs, as in prioritized experience replay.
+ */
+class SumTree
+{
+ public:
+  /**
+   * Create a sum tree for the given number of indices, all with value 0.
+   *
+   * @param size Number of indices.
+   */
+  SumTree(const size_t size = 0) :
+      size(size),
+      leaves(1)
+  {
+    while (leaves < size)
+      leaves *= 2;
+    tree.zeros(2 * leaves);
+  }
+
+  /**
+   * Set the value of the given index.
+   *
+   * @param index Index to set the value of.
+   * @param value New (nonnegative) value.
+   */
+  void Set(const size_t index, const double value)
+  {
+    size_t node = leaves + index;
+    const double change = value - tree[node];
+    while (node > 0)
+    {
+      tree[node] += change;
+      node /= 2;
+    }
+  }
+
+  //! Get the value of the given index.
+  double Get(const size_t index) const { return tree[leaves + index]; }
+
+  //! Get the sum of all the values.
+  double Sum() const { return tree[1]; }
+
+  /**
+   * Find the index at which the prefix sum of the values reaches the given
+   * amount: the smallest index i such that the sum of the values of indices 0
+   * to i is more than the amount.  If the amount is not less than the sum of
+   * all the values, the last index with a nonzero value is returned.
+   *
+   * @param amount Prefix sum to find, between 0 and Sum().
+   */
+  size_t Find(double amount) const
+  {
+    size_t node = 1;
+    while (node < leaves)
+    {
+      // Go to the right child if the left one does not hold enough, unless the
+      // right one is empty (which can only happen through rounding).
+      const size_t left = 2 * node;
+      if (amount < tree[left] || tree[left + 1] <= 0.0)
+      {
+        node = left;
+      }
+      else
+      {
+        amount -= tree[left];
+        node = left + 1;
+      }
+    }
+
+    return std::min(node - leaves, size - 1);
+  }
+
+  //! Get the number of indices.
+  size_t Size() const { return size; }
+
+ private:
+  //! The number of indices.
+  size_t size;
+
+  //! The number of leaves (the smallest power of 2 that is at least size).
+  size_t leaves;
+
+  //! The nodes of the tree; node 1 is the root, and the children of node i
+  //! are nodes 2i and 2i + 1.  Node 0 is unused.
+  arma::vec tree;
+};
+
+} // namespace rl
+} // namespace mlpack
+
+#endif
@@ -19,7 +19,12 @@ namespace rl {
 class TrainingConfig
 {
  public:
-  TrainingConfig() : stepLimit(0), gradientLimit(40), doubleQLearning(false)
+  TrainingConfig() :
+      stepLimit(0),
+      gradientLimit(40),
+      doubleQLearning(false),
+      numActors(1),
+      actorSyncInterval(100)
   { /* Nothing to do here. */ }
 
   TrainingConfig(
@@ -31,7 +36,9 @@ class TrainingConfig
       double stepSize,
       double discount,
       double gradientLimit,
-      bool doubleQLearning) :
+      bool doubleQLearning,
+      size_t numActors = 1,
+      size_t actorSyncInterval = 100) :
       numWorkers(numWorkers),
       updateInterval(updateInterval),
       targetNetworkSyncInterval(targetNetworkSyncInterval),
@@ -40,7 +47,9 @@ class TrainingConfig
       stepSize(stepSize),
       discount(discount),
       gradientLimit(gradientLimit),
-      doubleQLearning(doubleQLearning)
+      doubleQLearning(doubleQLearning),
+      numActors(numActors),
+      actorSyncInterval(actorSyncInterval)
   { /* Nothing to do here. */ }
 
   //! Get the amount of workers.
@@ -92,6 +101,16 @@ class TrainingConfig
   //! Modify the indicator of double q-learning.
   bool& DoubleQLearning() { return doubleQLearning; }
 
+  //! Get the number of actors.
+  size_t NumActors() const { return numActors; }
+  //! Modify the number of actors.
+  size_t& NumActors() { return numActors; }
+
+  //! Get the interval for sending the learnt weights to the actors.
+  size_t ActorSyncInterval() const { return actorSyncInterval; }
+  //! Modify the interval for sending the learnt weights to the actors.
+  size_t& ActorSyncInterval() { return actorSyncInterval; }
+
  private:
   /**
    * Locally-stored number of workers.
@@ -103,7 +122,8 @@ class TrainingConfig
    * Locally-stored update interval.
    * Update interval is similar to batch size,
    * however the update is done one by one.
-   * This is valid only for async RL agent.
+   * This is valid for async RL agent, and in QLearning::Train() it is the
+   * number of transitions an actor collects before storing them for replay.
    */
   size_t updateInterval;
 
@@ -149,6 +169,20 @@ class TrainingConfig
    * This is valid only for q-learning agent.
    */
   bool doubleQLearning;
+
+  /**
+   * Locally-stored number of actors, the threads that collect experience with
+   * their own copy of the network while one learner thread trains it.
+   * This is valid only for QLearning::Train().
+   */
+  size_t numActors;
+
+  /**
+   * Locally-stored number of learner updates between two copies of the learnt
+   * weights to the actors.
+   * This is valid only for QLearning::Train().
+   */
+  size_t actorSyncInterval;
 };
 
 } // namespace rl
@@ -13,6 +13,7 @@
 #ifndef MLPACK_METHODS_RL_WORKER_ONE_STEP_Q_LEARNING_WORKER_HPP
 #define MLPACK_METHODS_RL_WORKER_ONE_STEP_Q_LEARNING_WORKER_HPP
 
+#include <atomic>
 #include <mlpack/methods/reinforcement_learning/training_config.hpp>
 
 namespace mlpack {
@@ -70,13 +71,21 @@ class OneStepQLearningWorker
         learningNetwork.Parameters().n_cols);
     // Build local network.
     network = learningNetwork;
+    // Build local copy of the target network.
+    targetNetwork = learningNetwork;
   }
 
   /**
    * The agent will execute one step.
    *
+   * The parameters of the shared networks are read and written without locks
+   * (Hogwild-style): the worker computes its gradients with local copies of
+   * the networks, applies them directly to the parameters of the shared
+   * learning network, and then copies the shared parameters back into its
+   * local networks.
+   *
    * @param learningNetwork The shared learning network.
-   * @param targetNetwork The shared target network.
+   * @param sharedTargetNetwork The shared target network.
    * @param totalSteps The shared counter for total steps.
    * @param policy The shared behavior policy.
    * @param totalReward This will be the episode return if the episode ends
@@ -84,8 +93,8 @@ class OneStepQLearningWorker
    * @return Indicate whether current episode ends after this step.
    */
   bool Step(NetworkType& learningNetwork,
-            NetworkType& targetNetwork,
-            size_t& totalSteps,
+            NetworkType& sharedTargetNetwork,
+            std::atomic<size_t>& totalSteps,
             PolicyType& policy,
             double& totalReward)
   {
@@ -108,21 +117,23 @@ class OneStepQLearningWorker
         totalReward = episodeReturn;
         Reset();
         // Sync with latest learning network.
-        network = learningNetwork;
+        network.Parameters() = learningNetwork.Parameters();
         return true;
       }
       state = nextState;
       return false;
     }
 
-    #pragma omp atomic
-    totalSteps++;
+    const size_t currentSteps = ++totalSteps;
 
     pending[pendingIndex] = std::make_tuple(state, action, reward, nextState);
     pendingIndex++;
 
     if (terminal || pendingIndex >= config.UpdateInterval())
     {
+      // Sync the local target network with the shared target network.
+      targetNetwork.Parameters() = sharedTargetNetwork.Parameters();
+
       // Initialize the gradient storage.
       arma::mat totalGradients(learningNetwork.Parameters().n_rows,
           learningNetwork.Parameters().n_cols, arma::fill::zeros);
@@ -132,11 +143,7 @@ class OneStepQLearningWorker
 
         // Compute the target state-action value.
         arma::colvec actionValue;
-        #pragma omp critical
-        {
-          targetNetwork.Predict(
-              std::get<3>(transition).Encode(), actionValue);
-        };
+        targetNetwork.Predict(std::get<3>(transition).Encode(), actionValue);
         double targetActionValue = actionValue.max();
         if (terminal && i == pending.size() - 1)
           targetActionValue = 0;
@@ -165,18 +172,16 @@ class OneStepQLearningWorker
       updater.Update(learningNetwork.Parameters(),
           config.StepSize(), totalGradients);
 
-      // Sync the local network with the global network.
-      network = learningNetwork;
+      // Sync the local network with the global network.  Only the parameters
+      // are copied (in place), so the layers are not rebuilt.
+      network.Parameters() = learningNetwork.Parameters();
 
       pendingIndex = 0;
     }
 
     // Update global target network.
-    if (totalSteps % config.TargetNetworkSyncInterval() == 0)
-    {
-      #pragma omp critical
-      { targetNetwork = learningNetwork; }
-    }
+    if (currentSteps % config.TargetNetworkSyncInterval() == 0)
+      sharedTargetNetwork.Parameters() = learningNetwork.Parameters();
 
     policy.Anneal();
 
@@ -229,6 +234,9 @@ class OneStepQLearningWorker
   //! Local network of the worker.
   NetworkType network;
 
+  //! Local copy of the target network of the worker.
+  NetworkType targetNetwork;
+
   //! Current state of the agent.
   StateType state;
 };
@@ -32,6 +32,9 @@ namespace regression {
  *
  * http://ufldl.stanford.edu/wiki/index.php/Softmax_Regression
  *
+ * Training and classification accept sparse data (arma::sp_mat) as well as
+ * dense data; sparse data is never converted to a dense matrix.
+ *
  * An example on how to use the interface is shown below:
  *
  * @code
@@ -47,8 +50,8 @@ namespace regression {
  * const size_t numIterations = 100; // Maximum number of iterations.
  *
  * // Use an instantiated optimizer for the training.
- * SoftmaxRegressionFunction srf(train_data, labels, inputSize, numClasses);
- * L_BFGS<SoftmaxRegressionFunction> optimizer(srf, numBasis, numIterations);
+ * SoftmaxRegressionFunction<> srf(train_data, labels, inputSize, numClasses);
+ * L_BFGS<SoftmaxRegressionFunction<>> optimizer(srf, numBasis, numIterations);
  * SoftmaxRegression<L_BFGS> regressor2(optimizer);
  *
  * arma::mat test_data; // Test data matrix.
@@ -82,6 +85,8 @@ class SoftmaxRegression
    * function. By default, the model takes a small value.
    *
    * @tparam OptimizerType Desired optimizer type.
+   * @tparam MatType Type of data matrix (arma::mat or arma::sp_mat, for
+   *     instance).
    * @param data Input training features. Each column associate with one sample
    * @param labels Labels associated with the feature data.
    * @param inputSize Size of the input feature vector.
@@ -90,8 +95,9 @@ class SoftmaxRegression
    * @param lambda L2-regularization constant.
    * @param fitIntercept add intercept term or not.
    */
-  template<typename OptimizerType = mlpack::optimization::L_BFGS>
-  SoftmaxRegression(const arma::mat& data,
+  template<typename OptimizerType = mlpack::optimization::L_BFGS,
+           typename MatType = arma::mat>
+  SoftmaxRegression(const MatType& data,
                     const arma::Row<size_t>& labels,
                     const size_t numClasses,
                     const double lambda = 0.0001,
@@ -118,10 +124,13 @@ class SoftmaxRegression
    * point. It then chooses the class which has the highest probability among
    * all.
    *
+   * @tparam MatType Type of data matrix (arma::mat or arma::sp_mat, for
+   *     instance).
    * @param dataset Set of points to classify.
    * @param labels Predicted labels for each point.
    */
-  void Classify(const arma::mat& dataset, arma::Row<size_t>& labels) const;
+  template<typename MatType>
+  void Classify(const MatType& dataset, arma::Row<size_t>& labels) const;
 
   /**
    * Classify the given point. The predicted class label is returned.
@@ -141,21 +150,27 @@ class SoftmaxRegression
    * point. It then chooses the class which has the highest probability among
    * all.
    *
+   * @tparam MatType Type of data matrix (arma::mat or arma::sp_mat, for
+   *     instance).
    * @param dataset Matrix of data points to be classified.
    * @param labels Predicted labels for each point.
    * @param probabilities Class probabilities for each point.
    */
-  void Classify(const arma::mat& dataset,
+  template<typename MatType>
+  void Classify(const MatType& dataset,
                 arma::Row<size_t>& labels,
                 arma::mat& probabilites) const;
 
   /**
    * Classify the given points, returning class probabilities for each point.
    *
+   * @tparam MatType Type of data matrix (arma::mat or arma::sp_mat, for
+   *     instance).
    * @param dataset Matrix of data points to be classified.
    * @param probabilities Class probabilities for each point.
    */
-  void Classify(const arma::mat& dataset,
+  template<typename MatType>
+  void Classify(const MatType& dataset,
                 arma::mat& probabilities) const;
 
   /**
@@ -163,24 +178,30 @@ class SoftmaxRegression
    * labels associated with each data point. Predictions are made using the
    * provided data and are compared with the actual labels.
    *
+   * @tparam MatType Type of data matrix (arma::mat or arma::sp_mat, for
+   *     instance).
    * @param testData Matrix of data points using which predictions are made.
    * @param labels Vector of labels associated with the data.
    */
-  double ComputeAccuracy(const arma::mat& testData,
+  template<typename MatType>
+  double ComputeAccuracy(const MatType& testData,
                          const arma::Row<size_t>& labels) const;
 
   /**
    * Train the softmax regression with the given training data.
    *
    * @tparam OptimizerType Desired optimizer type.
+   * @tparam MatType Type of data matrix (arma::mat or arma::sp_mat, for
+   *     instance).  The data is never converted to a dense matrix.
    * @param data Input data with each column as one example.
    * @param labels Labels associated with the feature data.
    * @param numClasses Number of classes for classification.
    * @param optimizer Desired optimizer.
    * @return Objective value of the final point.
    */
-  template<typename OptimizerType = mlpack::optimization::L_BFGS>
-  double Train(const arma::mat& data,
+  template<typename OptimizerType = mlpack::optimization::L_BFGS,
+           typename MatType = arma::mat>
+  double Train(const MatType& data,
                const arma::Row<size_t>& labels,
                const size_t numClasses,
                OptimizerType optimizer = OptimizerType());
@@ -18,6 +18,14 @@
 namespace mlpack {
 namespace regression {
 
+/**
+ * The softmax regression objective function.  The data may be dense or sparse
+ * (specify arma::sp_mat as MatType); with sparse data, the products with the
+ * data only visit its nonzero elements, and the data is never densified.
+ *
+ * @tparam MatType Type of data matrix.
+ */
+template<typename MatType = arma::mat>
 class SoftmaxRegressionFunction
 {
  public:
@@ -32,7 +40,7 @@ class SoftmaxRegressionFunction
    * @param lambda L2-regularization constant.
    * @param fitIntercept Intercept term flag.
    */
-  SoftmaxRegressionFunction(const arma::mat& data,
+  SoftmaxRegressionFunction(const MatType& data,
                             const arma::Row<size_t>& labels,
                             const size_t numClasses,
                             const double lambda = 0.0001,
@@ -151,6 +159,53 @@ class SoftmaxRegressionFunction
                 arma::mat& gradient,
                 const size_t batchSize = 1);
 
+  /**
+   * Evaluate the gradient of the objective function given the current set of
+   * parameters, on a subset of the data, as a sparse matrix.  Only the
+   * features that are nonzero in some point of the batch have a nonzero
+   * gradient (unless lambda is not 0), so with sparse data, SGD with an update
+   * policy for sparse gradients (such as SparseAdaGradUpdate) only has to
+   * update those.
+   *
+   * @param parameters Current values of the model parameters.
+   * @param start First index of the data points to use.
+   * @param gradient Sparse matrix to store gradient into.
+   * @param batchSize Number of data points to evaluate gradient for.
+   */
+  void Gradient(const arma::mat& parameters,
+                const size_t start,
+                arma::sp_mat& gradient,
+                const size_t batchSize = 1) const;
+
+  /**
+   * Evaluate the objective function and its gradient given the current set of
+   * parameters.  This is faster than calling Evaluate() and Gradient() one
+   * after the other, since the probabilities are only computed once.
+   *
+   * @param parameters Current values of the model parameters.
+   * @param gradient Matrix where gradient values will be stored.
+   * @return The objective function with the given parameters.
+   */
+  double EvaluateWithGradient(const arma::mat& parameters,
+                              arma::mat& gradient) const;
+
+  /**
+   * Evaluate the objective function and its gradient given the current set of
+   * parameters, on a subset of the data.  This is faster than calling
+   * Evaluate() and Gradient() one after the other, since the probabilities are
+   * only computed once.
+   *
+   * @param parameters Current values of the model parameters.
+   * @param start First index of the data points to use.
+   * @param gradient Matrix to store gradient into.
+   * @param batchSize Number of data points to evaluate gradient for.
+   * @return The objective function of the given points.
+   */
+  double EvaluateWithGradient(const arma::mat& parameters,
+                              const size_t start,
+                              arma::mat& gradient,
+                              const size_t batchSize = 1) const;
+
   /**
    * Evaluates the gradient values of the objective function given the current
    * set of parameters for a single feature indexed by j.
@@ -170,6 +225,9 @@ class SoftmaxRegressionFunction
   //! Gets the number of classes.
   size_t NumClasses() const { return numClasses; }
 
+  //! Return the number of separable functions (the number of data points).
+  size_t NumFunctions() const { return data.n_cols; }
+
   //! Gets the features size of the training data.
   size_t NumFeatures() const
   {
@@ -185,8 +243,22 @@ class SoftmaxRegressionFunction
   bool FitIntercept() const { return fitIntercept; }
 
  private:
+  /**
+   * Evaluate the objective function on all the points, and its gradient if
+   * gradient is not NULL.  The points are handled in chunks, in parallel, so
+   * the probabilities of all the points are never held in memory at once.
+   *
+   * @param parameters Current values of the model parameters.
+   * @param gradient Matrix to store the gradient in, or NULL.
+   * @return Objective function value.
+   */
+  double EvaluateAll(const arma::mat& parameters, arma::mat* gradient) const;
+
+  //! The number of points handled at once by each thread in EvaluateAll().
+  static const size_t chunkSize = 1024;
+
   //! Training data matrix.  This is an alias until the data is shuffled.
-  arma::mat data;
+  MatType data;
   //! Label matrix for the provided data.
   arma::sp_mat groundTruth;
   //! Initial parameter point.
@@ -202,4 +274,7 @@ class SoftmaxRegressionFunction
 } // namespace regression
 } // namespace mlpack
 
+// Include implementation.
+#include "softmax_regression_function_impl.hpp"
+
 #endif
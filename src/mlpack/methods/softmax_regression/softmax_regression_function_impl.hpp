@@ -1,5 +1,5 @@
 /**
- * @file softmax_regression_function.cpp
+ * @file softmax_regression_function_impl.hpp
  * @author Siddharth Agrawal
  *
  * Implementation of function to be optimized for softmax regression.
@@ -9,19 +9,29 @@
  * 3-clause BSD license along with mlpack.  If not, see
  * http://www.opensource.org/licenses/BSD-3-Clause for more information.
  */
+#ifndef MLPACK_METHODS_SOFTMAX_REGRESSION_SOFTMAX_REGRESSION_FUNCTION_IMPL_HPP
+#define MLPACK_METHODS_SOFTMAX_REGRESSION_SOFTMAX_REGRESSION_FUNCTION_IMPL_HPP
+
+// In case it hasn't been included yet.
 #include "softmax_regression_function.hpp"
+
 #include <mlpack/core/math/make_alias.hpp>
+#include <mlpack/core/math/shuffle_data.hpp>
 
-using namespace mlpack;
-using namespace mlpack::regression;
+namespace mlpack {
+namespace regression {
 
-SoftmaxRegressionFunction::SoftmaxRegressionFunction(
-    const arma::mat& data,
+template<typename MatType>
+const size_t SoftmaxRegressionFunction<MatType>::chunkSize;
+
+template<typename MatType>
+SoftmaxRegressionFunction<MatType>::SoftmaxRegressionFunction(
+    const MatType& data,
     const arma::Row<size_t>& labels,
     const size_t numClasses,
     const double lambda,
     const bool fitIntercept) :
-    data(math::MakeAlias(const_cast<arma::mat&>(data), false)),
+    data(math::MakeAlias(const_cast<MatType&>(data), false)),
     numClasses(numClasses),
     lambda(lambda),
     fitIntercept(fitIntercept)
@@ -36,38 +46,24 @@ SoftmaxRegressionFunction::SoftmaxRegressionFunction(
 /**
  * Shuffle the data.
  */
-void SoftmaxRegressionFunction::Shuffle()
+template<typename MatType>
+void SoftmaxRegressionFunction<MatType>::Shuffle()
 {
-  // Determine new ordering.
-  arma::uvec ordering = arma::shuffle(arma::linspace<arma::uvec>(0,
-      data.n_cols - 1, data.n_cols));
+  // The label of each point is the row of the only nonzero element of its
+  // column of the ground truth matrix.
+  arma::Row<size_t> labels(groundTruth.n_cols);
+  for (size_t i = 0; i < groundTruth.n_cols; ++i)
+    labels[i] = groundTruth.row_indices[i];
+
+  MatType newData;
+  arma::Row<size_t> newLabels;
+  math::ShuffleData(data, labels, newData, newLabels);
 
-  // Re-sort data.
-  arma::mat newData = data.cols(ordering);
+  // If we are an alias, make sure we don't write to the original data.
   math::ClearAlias(data);
   data = std::move(newData);
 
-  // Assemble data for batch constructor.  We need reverse orderings though...
-  arma::uvec reverseOrdering(ordering.n_elem);
-  for (size_t i = 0; i < ordering.n_elem; ++i)
-    reverseOrdering[ordering[i]] = i;
-
-  arma::umat newLocations(2, groundTruth.n_nonzero);
-  arma::vec values(const_cast<double*>(groundTruth.values),
-      groundTruth.n_nonzero, false, true);
-  arma::sp_mat::const_iterator it = groundTruth.begin();
-  size_t loc = 0;
-  while (it != groundTruth.end())
-  {
-    newLocations(0, loc) = reverseOrdering(it.col());
-    newLocations(1, loc) = it.row();
-
-    ++it;
-    ++loc;
-  }
-
-  groundTruth = arma::sp_mat(newLocations, values, groundTruth.n_rows,
-      groundTruth.n_cols);
+  GetGroundTruthMatrix(newLabels, groundTruth);
 }
 
 /**
@@ -75,12 +71,14 @@ void SoftmaxRegressionFunction::Shuffle()
  * normal distribution. The weights cannot be initialized to zero, as that will
  * lead to each class output being the same.
  */
-const arma::mat SoftmaxRegressionFunction::InitializeWeights()
+template<typename MatType>
+const arma::mat SoftmaxRegressionFunction<MatType>::InitializeWeights()
 {
   return InitializeWeights(data.n_rows, numClasses, fitIntercept);
 }
 
-const arma::mat SoftmaxRegressionFunction::InitializeWeights(
+template<typename MatType>
+const arma::mat SoftmaxRegressionFunction<MatType>::InitializeWeights(
     const size_t featureSize,
     const size_t numClasses,
     const bool fitIntercept)
@@ -90,7 +88,8 @@ const arma::mat SoftmaxRegressionFunction::InitializeWeights(
     return parameters;
 }
 
-void SoftmaxRegressionFunction::InitializeWeights(
+template<typename MatType>
+void SoftmaxRegressionFunction<MatType>::InitializeWeights(
     arma::mat &weights,
     const size_t featureSize,
     const size_t numClasses,
@@ -111,7 +110,8 @@ void SoftmaxRegressionFunction::InitializeWeights(
  * labels. The output is in the form of a matrix, which leads to simpler
  * calculations in the Evaluate() and Gradient() methods.
  */
-void SoftmaxRegressionFunction::GetGroundTruthMatrix(
+template<typename MatType>
+void SoftmaxRegressionFunction<MatType>::GetGroundTruthMatrix(
     const arma::Row<size_t>& labels, arma::sp_mat& groundTruth)
 {
   // Calculate the ground truth matrix according to the labels passed. The
@@ -144,7 +144,8 @@ void SoftmaxRegressionFunction::GetGroundTruthMatrix(
  * Evaluate the probabilities matrix. If fitIntercept flag is true,
  * it should consider the parameters.cols(0) intercept term.
  */
-void SoftmaxRegressionFunction::GetProbabilitiesMatrix(
+template<typename MatType>
+void SoftmaxRegressionFunction<MatType>::GetProbabilitiesMatrix(
     const arma::mat& parameters,
     arma::mat& probabilities,
     const size_t start,
@@ -178,7 +179,9 @@ void SoftmaxRegressionFunction::GetProbabilitiesMatrix(
 /**
  * Evaluates the objective function given the parameters.
  */
-double SoftmaxRegressionFunction::Evaluate(const arma::mat& parameters) const
+template<typename MatType>
+double SoftmaxRegressionFunction<MatType>::Evaluate(
+    const arma::mat& parameters) const
 {
   // The objective function is the negative log likelihood of the model
   // calculated over all the training examples. Mathematically it is as follows:
@@ -189,36 +192,17 @@ double SoftmaxRegressionFunction::Evaluate(const arma::mat& parameters) const
   // 'm' is the number of training examples.
   // The cost also takes into account the regularization to control the
   // parameter weights.
-
-  // Calculate the class probabilities for each training example. The
-  // probabilities for each of the classes are given by:
-  // p_j = exp(theta_j' * x_i) / sum(exp(theta_k' * x_i))
-  // The sum is calculated over all the classes.
-  // x_i is the input vector for a particular training example.
-  // theta_j is the parameter vector associated with a particular class.
-  arma::mat probabilities;
-  GetProbabilitiesMatrix(parameters, probabilities, 0, data.n_cols);
-
-  // Calculate the log likelihood and regularization terms.
-  double logLikelihood, weightDecay, cost;
-
-  logLikelihood = arma::accu(groundTruth % arma::log(probabilities)) /
-                  data.n_cols;
-  weightDecay = 0.5 * lambda * arma::accu(parameters % parameters);
-
-  // The cost is the sum of the negative log likelihood and the regularization
-  // terms.
-  cost = -logLikelihood + weightDecay;
-
-  return cost;
+  return EvaluateAll(parameters, NULL);
 }
 
 /**
  * Evaluate the objective function for the given points given the parameters.
  */
-double SoftmaxRegressionFunction::Evaluate(const arma::mat& parameters,
-                                           const size_t start,
-                                           const size_t batchSize)
+template<typename MatType>
+double SoftmaxRegressionFunction<MatType>::Evaluate(
+    const arma::mat& parameters,
+    const size_t start,
+    const size_t batchSize)
 {
   arma::mat probabilities;
   GetProbabilitiesMatrix(parameters, probabilities, start, batchSize);
@@ -228,7 +212,7 @@ double SoftmaxRegressionFunction::Evaluate(const arma::mat& parameters,
 
   logLikelihood = arma::accu(groundTruth.cols(start, start + batchSize - 1) %
       arma::log(probabilities)) / batchSize;
-  weightDecay = 0.5 * lambda * arma::accu(parameters * parameters);
+  weightDecay = 0.5 * lambda * arma::accu(parameters % parameters);
 
   return -logLikelihood + weightDecay;
 }
@@ -236,53 +220,191 @@ double SoftmaxRegressionFunction::Evaluate(const arma::mat& parameters,
 /**
  * Calculates and stores the gradient values given a set of parameters.
  */
-void SoftmaxRegressionFunction::Gradient(const arma::mat& parameters,
-                                         arma::mat& gradient) const
+template<typename MatType>
+void SoftmaxRegressionFunction<MatType>::Gradient(
+    const arma::mat& parameters,
+    arma::mat& gradient) const
+{
+  EvaluateAll(parameters, &gradient);
+}
+
+template<typename MatType>
+void SoftmaxRegressionFunction<MatType>::Gradient(
+    const arma::mat& parameters,
+    const size_t start,
+    arma::mat& gradient,
+    const size_t batchSize)
 {
-  // Calculate the class probabilities for each training example. The
-  // probabilities for each of the classes are given by:
-  // p_j = exp(theta_j' * x_i) / sum(exp(theta_k' * x_i))
-  // The sum is calculated over all the classes.
-  // x_i is the input vector for a particular training example.
-  // theta_j is the parameter vector associated with a particular class.
   arma::mat probabilities;
-  GetProbabilitiesMatrix(parameters, probabilities, 0, data.n_cols);
+  GetProbabilitiesMatrix(parameters, probabilities, start, batchSize);
 
   // Calculate the parameter gradients.
   gradient.set_size(parameters.n_rows, parameters.n_cols);
   if (fitIntercept)
   {
-    // Treating the intercept term parameters.col(0) seperately to avoid
-    // the cost of building matrix [1; data].
-    arma::mat inner = probabilities - groundTruth;
+    arma::mat inner = probabilities - groundTruth.cols(start, start +
+        batchSize - 1);
     gradient.col(0) =
-      inner * arma::ones<arma::mat>(data.n_cols, 1) / data.n_cols +
-      lambda * parameters.col(0);
+        inner * arma::ones<arma::mat>(batchSize, 1) / batchSize +
+        lambda * parameters.col(0);
     gradient.cols(1, parameters.n_cols - 1) =
-      inner * data.t() / data.n_cols +
-      lambda * parameters.cols(1, parameters.n_cols - 1);
+        inner * data.cols(start, start + batchSize - 1).t() / batchSize +
+        lambda * parameters.cols(1, parameters.n_cols - 1);
   }
   else
   {
-    gradient = (probabilities - groundTruth) * data.t() / data.n_cols +
-               lambda * parameters;
+    gradient = (probabilities - groundTruth.cols(start, start + batchSize - 1))
+        * data.cols(start, start + batchSize - 1).t() / batchSize
+        + lambda * parameters;
   }
 }
 
-void SoftmaxRegressionFunction::Gradient(const arma::mat& parameters,
-                                         const size_t start,
-                                         arma::mat& gradient,
-                                         const size_t batchSize)
+/**
+ * Calculates the gradient values of the given points as a sparse matrix; only
+ * the features that appear in the batch get a nonzero gradient.
+ */
+template<typename MatType>
+void SoftmaxRegressionFunction<MatType>::Gradient(
+    const arma::mat& parameters,
+    const size_t start,
+    arma::sp_mat& gradient,
+    const size_t batchSize) const
+{
+  arma::mat probabilities;
+  GetProbabilitiesMatrix(parameters, probabilities, start, batchSize);
+
+  const arma::mat inner = probabilities - groundTruth.cols(start, start +
+      batchSize - 1);
+
+  // The product of two sparse matrices stays sparse.  (The matrix of the
+  // errors is dense, but it only has one row for each class.)
+  const arma::sp_mat features = arma::sp_mat(inner) *
+      arma::sp_mat(data.cols(start, start + batchSize - 1)).t() / batchSize;
+  if (fitIntercept)
+  {
+    gradient.zeros(parameters.n_rows, parameters.n_cols);
+    gradient.col(0) = arma::sum(inner, 1) / batchSize;
+    gradient.cols(1, parameters.n_cols - 1) = features;
+  }
+  else
+  {
+    gradient = features;
+  }
+
+  // Regularization term (which makes the gradient dense).
+  if (lambda != 0.0)
+    gradient += lambda * parameters;
+}
+
+/**
+ * Evaluates the objective function and calculates the gradient values given a
+ * set of parameters.
+ */
+template<typename MatType>
+double SoftmaxRegressionFunction<MatType>::EvaluateWithGradient(
+    const arma::mat& parameters,
+    arma::mat& gradient) const
+{
+  return EvaluateAll(parameters, &gradient);
+}
+
+/**
+ * Evaluates the objective function, and the gradient if requested, over all the
+ * points, a chunk of points at a time.
+ */
+template<typename MatType>
+double SoftmaxRegressionFunction<MatType>::EvaluateAll(
+    const arma::mat& parameters,
+    arma::mat* gradient) const
+{
+  // Calculate the class probabilities for each training example. The
+  // probabilities for each of the classes are given by:
+  // p_j = exp(theta_j' * x_i) / sum(exp(theta_k' * x_i))
+  // The sum is calculated over all the classes.
+  // x_i is the input vector for a particular training example.
+  // theta_j is the parameter vector associated with a particular class.
+  //
+  // Each thread handles chunks of points, and accumulates their log likelihood
+  // and their contributions to the gradient.
+  const size_t numChunks = (data.n_cols + chunkSize - 1) / chunkSize;
+  double logLikelihood = 0.0;
+  if (gradient)
+    gradient->zeros(parameters.n_rows, parameters.n_cols);
+
+  #pragma omp parallel reduction(+:logLikelihood)
+  {
+    arma::mat threadGradient, probabilities;
+    if (gradient)
+      threadGradient.zeros(parameters.n_rows, parameters.n_cols);
+
+    #pragma omp for schedule(dynamic)
+    for (omp_size_t c = 0; c < (omp_size_t) numChunks; ++c)
+    {
+      const size_t start = c * chunkSize;
+      const size_t count = std::min((size_t) data.n_cols - start, chunkSize);
+      GetProbabilitiesMatrix(parameters, probabilities, start, count);
+
+      // The label of each point is the row of the only nonzero element of its
+      // column of the ground truth matrix.  The probabilities become the
+      // errors (probabilities - groundTruth) used by the gradient.
+      for (size_t i = 0; i < count; ++i)
+      {
+        const size_t label = groundTruth.row_indices[start + i];
+        logLikelihood += std::log(probabilities(label, i));
+        probabilities(label, i) -= 1.0;
+      }
+
+      if (gradient)
+      {
+        if (fitIntercept)
+        {
+          // Treating the intercept term parameters.col(0) seperately to avoid
+          // the cost of building matrix [1; data].
+          threadGradient.col(0) += arma::sum(probabilities, 1);
+          threadGradient.cols(1, parameters.n_cols - 1) += probabilities *
+              data.cols(start, start + count - 1).t();
+        }
+        else
+        {
+          threadGradient += probabilities *
+              data.cols(start, start + count - 1).t();
+        }
+      }
+    }
+
+    if (gradient)
+    {
+      #pragma omp critical(SoftmaxRegressionGradient)
+      *gradient += threadGradient;
+    }
+  }
+
+  if (gradient)
+    *gradient = *gradient / data.n_cols + lambda * parameters;
+
+  // The cost is the sum of the negative log likelihood and the regularization
+  // terms.
+  const double weightDecay = 0.5 * lambda * arma::accu(parameters %
+      parameters);
+  return -logLikelihood / data.n_cols + weightDecay;
+}
+
+template<typename MatType>
+double SoftmaxRegressionFunction<MatType>::EvaluateWithGradient(
+    const arma::mat& parameters,
+    const size_t start,
+    arma::mat& gradient,
+    const size_t batchSize) const
 {
   arma::mat probabilities;
   GetProbabilitiesMatrix(parameters, probabilities, start, batchSize);
 
   // Calculate the parameter gradients.
+  arma::mat inner = probabilities - groundTruth.cols(start, start +
+      batchSize - 1);
   gradient.set_size(parameters.n_rows, parameters.n_cols);
   if (fitIntercept)
   {
-    arma::mat inner = probabilities - groundTruth.cols(start, start +
-        batchSize - 1);
     gradient.col(0) =
         inner * arma::ones<arma::mat>(batchSize, 1) / batchSize +
         lambda * parameters.col(0);
@@ -292,15 +414,24 @@ void SoftmaxRegressionFunction::Gradient(const arma::mat& parameters,
   }
   else
   {
-    gradient = (probabilities - groundTruth.cols(start, start + batchSize - 1))
-        * data.cols(start, start + batchSize - 1).t() / batchSize
-        + lambda * parameters;
+    gradient = inner * data.cols(start, start + batchSize - 1).t() /
+        batchSize + lambda * parameters;
   }
+
+  // Calculate the log likelihood and regularization terms.
+  const double logLikelihood = arma::accu(groundTruth.cols(start, start +
+      batchSize - 1) % arma::log(probabilities)) / batchSize;
+  const double weightDecay = 0.5 * lambda * arma::accu(parameters %
+      parameters);
+
+  return -logLikelihood + weightDecay;
 }
 
-void SoftmaxRegressionFunction::PartialGradient(const arma::mat& parameters,
-                                                const size_t j,
-                                                arma::sp_mat& gradient) const
+template<typename MatType>
+void SoftmaxRegressionFunction<MatType>::PartialGradient(
+    const arma::mat& parameters,
+    const size_t j,
+    arma::sp_mat& gradient) const
 {
   gradient.zeros(arma::size(parameters));
 
@@ -329,3 +460,8 @@ void SoftmaxRegressionFunction::PartialGradient(const arma::mat& parameters,
         parameters.col(j);
   }
 }
+
+} // namespace regression
+} // namespace mlpack
+
+#endif
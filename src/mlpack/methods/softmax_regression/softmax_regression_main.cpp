@@ -14,6 +14,7 @@
 
 #include <mlpack/methods/softmax_regression/softmax_regression.hpp>
 #include <mlpack/core/optimizers/lbfgs/lbfgs.hpp>
+#include <mlpack/core/data/load_libsvm.hpp>
 
 #include <memory>
 #include <set>
@@ -58,6 +59,15 @@ PROGRAM_INFO("Softmax Regression", "This program performs softmax regression, "
     "print the accuracy of the predictions on the given test set and its "
     "corresponding labels."
     "\n\n"
+    "Sparse datasets (such as bag-of-words or hashed features) can be given "
+    "in the libsvm (svmlight) format, with the " +
+    PRINT_PARAM_STRING("training_libsvm") + " parameter instead of " +
+    PRINT_PARAM_STRING("training") + " and " + PRINT_PARAM_STRING("labels") +
+    ", and with the " + PRINT_PARAM_STRING("test_libsvm") + " parameter "
+    "instead of " + PRINT_PARAM_STRING("test") + " and " +
+    PRINT_PARAM_STRING("test_labels") + ".  These datasets are loaded into "
+    "sparse matrices and are never converted to dense matrices."
+    "\n\n"
     "For example, to train a softmax regression model on the data " +
     PRINT_DATASET("dataset") + " with labels " + PRINT_DATASET("labels") +
     " with a maximum of 1000 iterations for training, saving the trained model "
@@ -91,6 +101,12 @@ PARAM_UROW_OUT("predictions", "Matrix to save predictions for test dataset "
     "into.", "p");
 PARAM_UROW_IN("test_labels", "Matrix containing test labels.", "L");
 
+// Sparse datasets.
+PARAM_STRING_IN("training_libsvm", "File containing the training set and its "
+    "labels in the libsvm format; it is loaded as a sparse matrix.", "", "");
+PARAM_STRING_IN("test_libsvm", "File containing the test set and its labels in "
+    "the libsvm format; it is loaded as a sparse matrix.", "", "");
+
 // Softmax configuration options.
 PARAM_INT_IN("max_iterations", "Maximum number of iterations before "
     "termination.", "n", 400);
@@ -111,6 +127,14 @@ size_t CalculateNumberOfClasses(const size_t numClasses,
 template<typename Model>
 void TestClassifyAcc(const size_t numClasses, const Model& model);
 
+// Classify the given test data, and test the accuracy of the predictions if
+// test labels are given.
+template<typename Model, typename MatType>
+void TestClassifyAcc(const size_t numClasses,
+                     const Model& model,
+                     const MatType& testData,
+                     const arma::Row<size_t>& testLabels);
+
 // Build the softmax model given the parameters.
 template<typename Model>
 unique_ptr<Model> TrainSoftmax(const size_t maxIterations);
@@ -120,17 +144,22 @@ void mlpackMain()
   const int maxIterations = CLI::GetParam<int>("max_iterations");
 
   // One of inputFile and modelFile must be specified.
-  RequireOnlyOnePassed({ "input_model", "training" }, true);
+  RequireOnlyOnePassed({ "input_model", "training", "training_libsvm" }, true);
   if (CLI::HasParam("training"))
   {
     RequireAtLeastOnePassed({ "labels" }, true, "if training data is specified,"
         " labels must also be specified");
   }
   ReportIgnoredParam({{ "training", false }}, "labels");
-  ReportIgnoredParam({{ "training", false }}, "max_iterations");
-  ReportIgnoredParam({{ "training", false }}, "number_of_classes");
-  ReportIgnoredParam({{ "training", false }}, "lambda");
-  ReportIgnoredParam({{ "training", false }}, "no_intercept");
+  ReportIgnoredParam({{ "input_model", true }}, "max_iterations");
+  ReportIgnoredParam({{ "input_model", true }}, "number_of_classes");
+  ReportIgnoredParam({{ "input_model", true }}, "lambda");
+  ReportIgnoredParam({{ "input_model", true }}, "no_intercept");
+  if (CLI::HasParam("test") && CLI::HasParam("test_libsvm"))
+  {
+    Log::Fatal << "Can only pass one of " << PRINT_PARAM_STRING("test")
+        << " or " << PRINT_PARAM_STRING("test_libsvm") << "!" << endl;
+  }
 
   RequireParamValue<int>("max_iterations", [](int x) { return x >= 0; }, true,
       "maximum number of iterations must be greater than or equal to 0");
@@ -170,6 +199,27 @@ void TestClassifyAcc(size_t numClasses, const Model& model)
 {
   using namespace mlpack;
 
+  // Sparse test data holds its own labels.
+  if (CLI::HasParam("test_libsvm"))
+  {
+    ReportIgnoredParam({{ "test_libsvm", true }}, "test_labels");
+
+    arma::sp_mat testData;
+    arma::Row<size_t> testLabels;
+    try
+    {
+      data::LoadLibSVM(CLI::GetParam<string>("test_libsvm"), testData,
+          testLabels, model.FeatureSize());
+    }
+    catch (std::runtime_error& e)
+    {
+      Log::Fatal << e.what() << endl;
+    }
+
+    TestClassifyAcc(numClasses, model, testData, testLabels);
+    return;
+  }
+
   // If there is no test set, there is nothing to test on.
   if (!CLI::HasParam("test"))
   {
@@ -181,19 +231,10 @@ void TestClassifyAcc(size_t numClasses, const Model& model)
 
   // Get the test dataset, and get predictions.
   arma::mat testData = std::move(CLI::GetParam<arma::mat>("test"));
-
-  arma::Row<size_t> predictLabels;
-  model.Classify(testData, predictLabels);
-
-  // Save predictions, if desired.
-  if (CLI::HasParam("predictions"))
-    CLI::GetParam<arma::Row<size_t>>("predictions") = std::move(predictLabels);
-
-  // Calculate accuracy, if desired.
+  arma::Row<size_t> testLabels;
   if (CLI::HasParam("test_labels"))
   {
-    arma::Row<size_t> testLabels =
-      std::move(CLI::GetParam<arma::Row<size_t>>("test_labels"));
+    testLabels = std::move(CLI::GetParam<arma::Row<size_t>>("test_labels"));
 
     if (testData.n_cols != testLabels.n_elem)
     {
@@ -202,7 +243,27 @@ void TestClassifyAcc(size_t numClasses, const Model& model)
           << PRINT_PARAM_STRING("test_labels") << " have " << testLabels.n_elem
           << " labels!" << endl;
     }
+  }
+
+  TestClassifyAcc(numClasses, model, testData, testLabels);
+}
+
+template<typename Model, typename MatType>
+void TestClassifyAcc(const size_t numClasses,
+                     const Model& model,
+                     const MatType& testData,
+                     const arma::Row<size_t>& testLabels)
+{
+  arma::Row<size_t> predictLabels;
+  model.Classify(testData, predictLabels);
+
+  // Save predictions, if desired.
+  if (CLI::HasParam("predictions"))
+    CLI::GetParam<arma::Row<size_t>>("predictions") = std::move(predictLabels);
 
+  // Calculate accuracy, if desired.
+  if (testLabels.n_elem > 0)
+  {
     vector<size_t> bingoLabels(numClasses, 0);
     vector<size_t> labelSize(numClasses, 0);
     for (arma::uword i = 0; i != predictLabels.n_elem; ++i)
@@ -234,15 +295,13 @@ unique_ptr<Model> TrainSoftmax(const size_t maxIterations)
 {
   using namespace mlpack;
 
-  using SRF = regression::SoftmaxRegressionFunction;
-
   unique_ptr<Model> sm;
   if (CLI::HasParam("input_model"))
   {
     sm.reset(new Model(0, 0, false));
     *sm = std::move(CLI::GetParam<Model>("input_model"));
   }
-  else
+  else if (CLI::HasParam("training"))
   {
     arma::mat trainData = std::move(CLI::GetParam<arma::mat>("training"));
     arma::Row<size_t> trainLabels =
@@ -262,6 +321,31 @@ unique_ptr<Model> TrainSoftmax(const size_t maxIterations)
     sm.reset(new Model(trainData, trainLabels, numClasses,
         CLI::GetParam<double>("lambda"), intercept, std::move(optimizer)));
   }
+  else
+  {
+    // The sparse training data is never densified.
+    arma::sp_mat trainData;
+    arma::Row<size_t> trainLabels;
+    try
+    {
+      data::LoadLibSVM(CLI::GetParam<string>("training_libsvm"), trainData,
+          trainLabels);
+    }
+    catch (std::runtime_error& e)
+    {
+      Log::Fatal << e.what() << endl;
+    }
+
+    const size_t numClasses = CalculateNumberOfClasses(
+        (size_t) CLI::GetParam<int>("number_of_classes"), trainLabels);
+
+    const bool intercept = CLI::HasParam("no_intercept") ? false : true;
+
+    const size_t numBasis = 5;
+    optimization::L_BFGS optimizer(numBasis, maxIterations);
+    sm.reset(new Model(trainData, trainLabels, numClasses,
+        CLI::GetParam<double>("lambda"), intercept, std::move(optimizer)));
+  }
 
   return sm;
 }
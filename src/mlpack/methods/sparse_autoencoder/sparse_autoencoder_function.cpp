@@ -11,6 +11,8 @@
  */
 #include "sparse_autoencoder_function.hpp"
 
+#include <mlpack/core/math/make_alias.hpp>
+
 using namespace mlpack;
 using namespace mlpack::nn;
 using namespace std;
@@ -21,7 +23,7 @@ SparseAutoencoderFunction::SparseAutoencoderFunction(const arma::mat& data,
                                                      const double lambda,
                                                      const double beta,
                                                      const double rho) :
-    data(data),
+    data(math::MakeAlias(const_cast<arma::mat&>(data), false)),
     visibleSize(visibleSize),
     hiddenSize(hiddenSize),
     lambda(lambda),
@@ -71,18 +73,29 @@ const arma::mat SparseAutoencoderFunction::InitializeWeights()
   return parameters;
 }
 
-/** Evaluates the objective function given the parameters.
+const size_t SparseAutoencoderFunction::chunkSize;
+
+/** Shuffles the data points.
   */
-double SparseAutoencoderFunction::Evaluate(const arma::mat& parameters) const
+void SparseAutoencoderFunction::Shuffle()
 {
-  // The objective function is the average squared reconstruction error of the
-  // network. w1 and b1 are the weights and biases associated with the hidden
-  // layer, whereas w2 and b2 are associated with the output layer.
-  // f(w1,w2,b1,b2) = sum((data - sigmoid(w2*sigmoid(w1data + b1) + b2))^2) / 2m
-  // 'm' is the number of training examples.
-  // The cost also takes into account the regularization and KL divergence terms
-  // to control the parameter weights and sparsity of the model respectively.
+  arma::mat newData = data.cols(arma::shuffle(arma::linspace<arma::uvec>(0,
+      data.n_cols - 1, data.n_cols)));
 
+  // If we are an alias, make sure we don't write to the original data.
+  math::ClearAlias(data);
+  data = std::move(newData);
+}
+
+/** Computes the activations of the hidden and output layers for a chunk of
+  * points.
+  */
+void SparseAutoencoderFunction::ForwardPass(const arma::mat& parameters,
+                                            const size_t begin,
+                                            const size_t count,
+                                            arma::mat& hiddenLayer,
+                                            arma::mat* outputLayer) const
+{
   // Compute the limits for the parameters w1, w2, b1 and b2.
   const size_t l1 = hiddenSize;
   const size_t l2 = visibleSize;
@@ -95,32 +108,112 @@ double SparseAutoencoderFunction::Evaluate(const arma::mat& parameters) const
   // w2 <- parameters.submat(l1, 0, l3-1, l2-1).t()
   // b1 <- parameters.submat(0, l2, l1-1, l2)
   // b2 <- parameters.submat(l3, 0, l3, l2-1).t()
+  arma::mat preactivation = parameters.submat(0, 0, l1 - 1, l2 - 1) *
+      data.cols(begin, begin + count - 1);
+  preactivation.each_col() += arma::vec(parameters.submat(0, l2, l1 - 1, l2));
+  Sigmoid(preactivation, hiddenLayer);
+
+  if (outputLayer)
+  {
+    preactivation = parameters.submat(l1, 0, l3 - 1, l2 - 1).t() *
+        hiddenLayer;
+    preactivation.each_col() +=
+        arma::vec(parameters.submat(l3, 0, l3, l2 - 1).t());
+    Sigmoid(preactivation, *outputLayer);
+  }
+}
 
-  arma::mat hiddenLayer, outputLayer;
+/** Computes the average activations of the hidden layer over a batch of
+  * points.
+  */
+arma::vec SparseAutoencoderFunction::AverageActivations(
+    const arma::mat& parameters,
+    const size_t begin,
+    const size_t batchSize) const
+{
+  const size_t numChunks = (batchSize + chunkSize - 1) / chunkSize;
+  arma::vec rhoCap(hiddenSize, arma::fill::zeros);
+
+  #pragma omp parallel
+  {
+    arma::vec threadSum(hiddenSize, arma::fill::zeros);
+    arma::mat hiddenLayer;
+
+    #pragma omp for schedule(dynamic)
+    for (omp_size_t c = 0; c < (omp_size_t) numChunks; ++c)
+    {
+      const size_t offset = c * chunkSize;
+      const size_t count = std::min(batchSize - offset, chunkSize);
+      ForwardPass(parameters, begin + offset, count, hiddenLayer, NULL);
+      threadSum += arma::sum(hiddenLayer, 1);
+    }
+
+    #pragma omp critical(SparseAutoencoderActivations)
+    rhoCap += threadSum;
+  }
+
+  return rhoCap / batchSize;
+}
 
-  // Compute activations of the hidden and output layers.
-  Sigmoid(parameters.submat(0, 0, l1 - 1, l2 - 1) * data +
-      arma::repmat(parameters.submat(0, l2, l1 - 1, l2), 1, data.n_cols),
-      hiddenLayer);
+/** Evaluates the objective function given the parameters.
+  */
+double SparseAutoencoderFunction::Evaluate(const arma::mat& parameters) const
+{
+  return Evaluate(parameters, 0, data.n_cols);
+}
 
-  Sigmoid(parameters.submat(l1, 0, l3 - 1, l2 - 1).t() * hiddenLayer +
-      arma::repmat(parameters.submat(l3, 0, l3, l2 - 1).t(), 1, data.n_cols),
-      outputLayer);
+/** Evaluates the objective function given the parameters, on a batch of
+  * points.
+  */
+double SparseAutoencoderFunction::Evaluate(const arma::mat& parameters,
+                                           const size_t begin,
+                                           const size_t batchSize) const
+{
+  // The objective function is the average squared reconstruction error of the
+  // network. w1 and b1 are the weights and biases associated with the hidden
+  // layer, whereas w2 and b2 are associated with the output layer.
+  // f(w1,w2,b1,b2) = sum((data - sigmoid(w2*sigmoid(w1data + b1) + b2))^2) / 2m
+  // 'm' is the number of training examples.
+  // The cost also takes into account the regularization and KL divergence terms
+  // to control the parameter weights and sparsity of the model respectively.
+  const size_t l2 = visibleSize;
+  const size_t l3 = 2 * hiddenSize;
 
-  arma::mat rhoCap, diff;
+  // Each thread handles chunks of points, and accumulates the squared
+  // reconstruction errors and the activations of the hidden layer.
+  const size_t numChunks = (batchSize + chunkSize - 1) / chunkSize;
+  arma::vec rhoCap(hiddenSize, arma::fill::zeros);
+  double squaredError = 0.0;
+
+  #pragma omp parallel reduction(+:squaredError)
+  {
+    arma::vec threadSum(hiddenSize, arma::fill::zeros);
+    arma::mat hiddenLayer, outputLayer;
+
+    #pragma omp for schedule(dynamic)
+    for (omp_size_t c = 0; c < (omp_size_t) numChunks; ++c)
+    {
+      const size_t offset = c * chunkSize;
+      const size_t count = std::min(batchSize - offset, chunkSize);
+      ForwardPass(parameters, begin + offset, count, hiddenLayer,
+          &outputLayer);
+
+      threadSum += arma::sum(hiddenLayer, 1);
+      // Difference between the reconstructed data and the original data.
+      squaredError += arma::accu(arma::square(outputLayer -
+          data.cols(begin + offset, begin + offset + count - 1)));
+    }
+
+    #pragma omp critical(SparseAutoencoderActivations)
+    rhoCap += threadSum;
+  }
 
   // Average activations of the hidden layer.
-  rhoCap = arma::sum(hiddenLayer, 1) / data.n_cols;
-  // Difference between the reconstructed data and the original data.
-  diff = outputLayer - data;
-
-  double wL2SquaredNorm;
+  rhoCap /= batchSize;
 
   // Calculate squared L2-norms of w1 and w2.
-  wL2SquaredNorm = arma::accu(parameters.submat(0, 0, l3 - 1, l2 - 1) %
-      parameters.submat(0, 0, l3 - 1, l2 - 1));
-
-  double sumOfSquaresError, weightDecay, klDivergence, cost;
+  const double wL2SquaredNorm = arma::accu(arma::square(
+      parameters.submat(0, 0, l3 - 1, l2 - 1)));
 
   // Calculate the reconstruction error, the regularization cost and the KL
   // divergence cost terms. 'sumOfSquaresError' is the average squared l2-norm
@@ -128,21 +221,30 @@ double SparseAutoencoderFunction::Evaluate(const arma::mat& parameters) const
   // of the weights w1 and w2. 'klDivergence' is the cost of the hidden layer
   // activations not being low. It is given by the following formula:
   // KL = sum_over_hSize(rho*log(rho/rhoCaq) + (1-rho)*log((1-rho)/(1-rhoCap)))
-  sumOfSquaresError = 0.5 * arma::accu(diff % diff) / data.n_cols;
-  weightDecay = 0.5 * lambda * wL2SquaredNorm;
-  klDivergence = beta * arma::accu(rho * arma::log(rho / rhoCap) + (1 - rho) *
-      arma::log((1 - rho) / (1 - rhoCap)));
+  const double sumOfSquaresError = 0.5 * squaredError / batchSize;
+  const double weightDecay = 0.5 * lambda * wL2SquaredNorm;
+  const double klDivergence = beta * arma::accu(rho * arma::log(rho / rhoCap) +
+      (1 - rho) * arma::log((1 - rho) / (1 - rhoCap)));
 
   // The cost is the sum of the terms calculated above.
-  cost = sumOfSquaresError + weightDecay + klDivergence;
-
-  return cost;
+  return sumOfSquaresError + weightDecay + klDivergence;
 }
 
 /** Calculates and stores the gradient values given a set of parameters.
   */
 void SparseAutoencoderFunction::Gradient(const arma::mat& parameters,
                                          arma::mat& gradient) const
+{
+  Gradient(parameters, 0, gradient, data.n_cols);
+}
+
+/** Calculates and stores the gradient values given a set of parameters, on a
+  * batch of points.
+  */
+void SparseAutoencoderFunction::Gradient(const arma::mat& parameters,
+                                         const size_t begin,
+                                         arma::mat& gradient,
+                                         const size_t batchSize) const
 {
   // Performs a feedforward pass of the neural network, and computes the
   // activations of the output layer as in the Evaluate() method. It uses the
@@ -155,56 +257,59 @@ void SparseAutoencoderFunction::Gradient(const arma::mat& parameters,
   const size_t l2 = visibleSize;
   const size_t l3 = 2 * hiddenSize;
 
-  // w1, w2, b1 and b2 are not extracted separately, 'parameters' is directly
-  // used in their place to avoid copying data. The following representations
-  // are used:
-  // w1 <- parameters.submat(0, 0, l1-1, l2-1)
-  // w2 <- parameters.submat(l1, 0, l3-1, l2-1).t()
-  // b1 <- parameters.submat(0, l2, l1-1, l2)
-  // b2 <- parameters.submat(l3, 0, l3, l2-1).t()
-
-  arma::mat hiddenLayer, outputLayer;
-
-  // Compute activations of the hidden and output layers.
-  Sigmoid(parameters.submat(0, 0, l1 - 1, l2 - 1) * data +
-      arma::repmat(parameters.submat(0, l2, l1 - 1, l2), 1, data.n_cols),
-      hiddenLayer);
-
-  Sigmoid(parameters.submat(l1, 0, l3 - 1, l2 - 1).t() * hiddenLayer +
-      arma::repmat(parameters.submat(l3, 0, l3, l2 - 1).t(), 1, data.n_cols),
-      outputLayer);
-
-  arma::mat rhoCap, diff;
-
-  // Average activations of the hidden layer.
-  rhoCap = arma::sum(hiddenLayer, 1) / data.n_cols;
-  // Difference between the reconstructed data and the original data.
-  diff = outputLayer - data;
-
-  arma::mat klDivGrad, delOut, delHid;
-
-  // The delta vector for the output layer is given by diff * f'(z), where z is
-  // the preactivation and f is the activation function. The derivative of the
-  // sigmoid function turns out to be f(z) * (1 - f(z)). For every other layer
-  // in the neural network which comes before the output layer, the delta values
-  // are given del_n = w_n' * del_(n+1) * f'(z_n). Since our cost function also
-  // includes the KL divergence term, we adjust for that in the formula below.
-  klDivGrad = beta * (-(rho / rhoCap) + (1 - rho) / (1 - rhoCap));
-  delOut = diff % outputLayer % (1 - outputLayer);
-  delHid = (parameters.submat(l1, 0, l3 - 1, l2 - 1) * delOut +
-      arma::repmat(klDivGrad, 1, data.n_cols)) % hiddenLayer %
-      (1 - hiddenLayer);
+  // The delta values of the hidden layer depend on the average activations of
+  // the hidden layer over all the points, so those are computed first.
+  const arma::vec rhoCap = AverageActivations(parameters, begin, batchSize);
+  const arma::vec klDivGrad = beta * (-(rho / rhoCap) + (1 - rho) /
+      (1 - rhoCap));
 
+  // Each thread then handles chunks of points, and accumulates their
+  // contributions to the gradient.
+  const size_t numChunks = (batchSize + chunkSize - 1) / chunkSize;
   gradient.zeros(2 * hiddenSize + 1, visibleSize + 1);
 
-  // Compute the gradient values using the activations and the delta values. The
-  // formula also accounts for the regularization terms in the objective.
-  // function.
-  gradient.submat(0, 0, l1 - 1, l2 - 1) = delHid * data.t() / data.n_cols +
-      lambda * parameters.submat(0, 0, l1 - 1, l2 - 1);
-  gradient.submat(l1, 0, l3 - 1, l2 - 1) =
-      (delOut * hiddenLayer.t() / data.n_cols +
-      lambda * parameters.submat(l1, 0, l3 - 1, l2 - 1).t()).t();
-  gradient.submat(0, l2, l1 - 1, l2) = arma::sum(delHid, 1) / data.n_cols;
-  gradient.submat(l3, 0, l3, l2 - 1) = (arma::sum(delOut, 1) / data.n_cols).t();
+  #pragma omp parallel
+  {
+    arma::mat threadGradient(2 * hiddenSize + 1, visibleSize + 1,
+        arma::fill::zeros);
+    arma::mat hiddenLayer, outputLayer, delOut, delHid;
+
+    #pragma omp for schedule(dynamic)
+    for (omp_size_t c = 0; c < (omp_size_t) numChunks; ++c)
+    {
+      const size_t offset = c * chunkSize;
+      const size_t count = std::min(batchSize - offset, chunkSize);
+      const size_t first = begin + offset;
+      ForwardPass(parameters, first, count, hiddenLayer, &outputLayer);
+
+      // The delta vector for the output layer is given by diff * f'(z), where
+      // z is the preactivation and f is the activation function. The
+      // derivative of the sigmoid function turns out to be f(z) * (1 - f(z)).
+      // For every other layer in the neural network which comes before the
+      // output layer, the delta values are given del_n = w_n' * del_(n+1) *
+      // f'(z_n). Since our cost function also includes the KL divergence term,
+      // we adjust for that in the formula below.
+      delOut = (outputLayer - data.cols(first, first + count - 1)) %
+          outputLayer % (1 - outputLayer);
+      delHid = parameters.submat(l1, 0, l3 - 1, l2 - 1) * delOut;
+      delHid.each_col() += klDivGrad;
+      delHid %= hiddenLayer % (1 - hiddenLayer);
+
+      threadGradient.submat(0, 0, l1 - 1, l2 - 1) += delHid *
+          data.cols(first, first + count - 1).t();
+      threadGradient.submat(l1, 0, l3 - 1, l2 - 1) += hiddenLayer *
+          delOut.t();
+      threadGradient.submat(0, l2, l1 - 1, l2) += arma::sum(delHid, 1);
+      threadGradient.submat(l3, 0, l3, l2 - 1) += arma::sum(delOut, 1).t();
+    }
+
+    #pragma omp critical(SparseAutoencoderGradient)
+    gradient += threadGradient;
+  }
+
+  // Average the contributions of the points, and add the regularization terms
+  // of the objective function.
+  gradient /= batchSize;
+  gradient.submat(0, 0, l3 - 1, l2 - 1) += lambda *
+      parameters.submat(0, 0, l3 - 1, l2 - 1);
 }
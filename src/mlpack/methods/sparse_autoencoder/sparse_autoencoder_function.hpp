@@ -55,10 +55,28 @@ class SparseAutoencoderFunction
    * using weights which are low in value and when the average activations of
    * neurons in the hidden layers agrees well with the sparsity parameter 'rho'.
    *
+   * The points are handled in chunks, in parallel, so the activations of all
+   * the points are never held in memory at once.
+   *
    * @param parameters Current values of the model parameters.
    */
   double Evaluate(const arma::mat& parameters) const;
 
+  /**
+   * Evaluates the objective function of the sparse autoencoder model on the
+   * batch of points [begin, begin + batchSize).  The average activations of the
+   * hidden layer used by the KL divergence term are taken over the batch, so
+   * this is an estimate of the objective over all the points; this lets SGD
+   * and the other batch optimizers train the model.
+   *
+   * @param parameters Current values of the model parameters.
+   * @param begin Index of the first point of the batch.
+   * @param batchSize Number of points in the batch.
+   */
+  double Evaluate(const arma::mat& parameters,
+                  const size_t begin,
+                  const size_t batchSize) const;
+
   /**
    * Evaluates the gradient values of the objective function given the current
    * set of parameters. The function performs a feedforward pass and computes
@@ -70,6 +88,29 @@ class SparseAutoencoderFunction
    */
   void Gradient(const arma::mat& parameters, arma::mat& gradient) const;
 
+  /**
+   * Evaluates the gradient of the objective function on the batch of points
+   * [begin, begin + batchSize), as in Evaluate(parameters, begin, batchSize).
+   *
+   * @param parameters Current values of the model parameters.
+   * @param begin Index of the first point of the batch.
+   * @param gradient Matrix where gradient values will be stored.
+   * @param batchSize Number of points in the batch.
+   */
+  void Gradient(const arma::mat& parameters,
+                const size_t begin,
+                arma::mat& gradient,
+                const size_t batchSize) const;
+
+  //! Return the number of points, for the batch optimizers.
+  size_t NumFunctions() const { return data.n_cols; }
+
+  /**
+   * Shuffle the points.  The data is copied the first time, so that the
+   * original matrix is not modified.
+   */
+  void Shuffle();
+
   /**
    * Returns the elementwise sigmoid of the passed matrix, where the sigmoid
    * function of a real number 'x' is [1 / (1 + exp(-x))].
@@ -145,8 +186,27 @@ class SparseAutoencoderFunction
   }
 
  private:
-  //! The matrix of data points.
-  const arma::mat& data;
+  /**
+   * Compute the activations of the hidden layer, and of the output layer if
+   * outputLayer is not NULL, for the count points starting at begin.
+   */
+  void ForwardPass(const arma::mat& parameters,
+                   const size_t begin,
+                   const size_t count,
+                   arma::mat& hiddenLayer,
+                   arma::mat* outputLayer) const;
+
+  //! Compute the average activations of the hidden layer over a batch.
+  arma::vec AverageActivations(const arma::mat& parameters,
+                               const size_t begin,
+                               const size_t batchSize) const;
+
+  //! The number of points handled at once by each thread.
+  static const size_t chunkSize = 1024;
+
+  //! The matrix of data points (an alias of the given matrix, unless the
+  //! points were shuffled).
+  arma::mat data;
   //! Initial parameter vector.
   arma::mat initialPoint;
   //! Size of the visible layer.
@@ -41,21 +41,31 @@ void SparseCoding::Encode(const arma::mat& data, arma::mat& codes)
   arma::mat matGram = trans(dictionary) * dictionary;
 
   codes.set_size(atoms, data.n_cols);
-  for (size_t i = 0; i < data.n_cols; ++i)
-  {
-    // Report progress.
-    if ((i % 100) == 0)
-      Log::Debug << "Optimization at point " << i << "." << std::endl;
 
+  // The points are encoded independently, so they are split between threads.
+  #pragma omp parallel
+  {
+    // Each thread reuses one LARS object and one response vector for all of
+    // its points; LARS refers to the shared Gram matrix instead of computing
+    // its own.
     bool useCholesky = true;
     regression::LARS lars(useCholesky, matGram, lambda1, lambda2);
+    arma::rowvec responses(data.n_rows);
 
-    // Create an alias of the code (using the same memory), and then LARS will
-    // place the result directly into that; then we will not need to have an
-    // extra copy.
-    arma::vec code = codes.unsafe_col(i);
-    arma::rowvec responses = data.unsafe_col(i).t();
-    lars.Train(dictionary, responses, code, false);
+    #pragma omp for schedule(dynamic, 16)
+    for (omp_size_t i = 0; i < (omp_size_t) data.n_cols; ++i)
+    {
+      // Report progress (only in debug builds).
+      if ((i % 100) == 0)
+        MLPACK_LOG_DEBUG << "Optimization at point " << i << "." << std::endl;
+
+      // Create an alias of the code (using the same memory), and then LARS
+      // will place the result directly into that; then we will not need to
+      // have an extra copy.
+      arma::vec code = codes.unsafe_col(i);
+      responses = data.col(i).t();
+      lars.Train(dictionary, responses, code, false);
+    }
   }
 }
 
@@ -194,10 +204,11 @@ double SparseCoding::OptimizeDictionary(const arma::mat& data,
     // Take step and print useful information.
     dualVars += searchDirection;
     normGradient = arma::norm(gradient, 2);
-    Log::Debug << "Newton Method iteration " << t << ":" << std::endl;
-    Log::Debug << "  Gradient norm: " << std::scientific << normGradient
+    MLPACK_LOG_DEBUG << "Newton Method iteration " << t << ":" << std::endl;
+    MLPACK_LOG_DEBUG << "  Gradient norm: " << std::scientific << normGradient
         << "." << std::endl;
-    Log::Debug << "  Improvement: " << std::scientific << improvement << ".\n";
+    MLPACK_LOG_DEBUG << "  Improvement: " << std::scientific << improvement
+        << ".\n";
 
     if (normGradient < newtonTolerance)
       converged = true;
@@ -62,7 +62,7 @@ void SparseCoding::Train(
 
   Log::Info << "  Sparsity level: " << 100.0 * ((double) (adjacencies.n_elem))
       / ((double) (atoms * data.n_cols)) << "%." << std::endl;
-  Log::Info << "  Objective value: " << Objective(data, codes) << "."
+  MLPACK_LOG_INFO << "  Objective value: " << Objective(data, codes) << "."
       << std::endl;
 
   for (size_t t = 1; t != maxIterations; ++t)
@@ -77,7 +77,7 @@ void SparseCoding::Train(
     // First step: optimize the dictionary.
     Log::Info << "Performing dictionary step... " << std::endl;
     OptimizeDictionary(data, codes, adjacencies);
-    Log::Info << "  Objective value: " << Objective(data, codes) << "."
+    MLPACK_LOG_INFO << "  Objective value: " << Objective(data, codes) << "."
         << std::endl;
 
     // Second step: perform the coding.
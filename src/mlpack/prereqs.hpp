@@ -61,11 +61,14 @@ using enable_if_t = typename enable_if<B, T>::type;
 #endif
 #endif
 
-// Increase the number of template arguments for the boost list class.
+// Increase the number of template arguments for the boost list class.  The
+// ANN LayerTypes variant has 41 types.  Boost only ships the list headers in
+// steps of ten (list40.hpp, list50.hpp), so 50 is the smallest limit that
+// holds it.
 #undef BOOST_MPL_CFG_NO_PREPROCESSED_HEADERS
 #undef BOOST_MPL_LIMIT_LIST_SIZE
 #define BOOST_MPL_CFG_NO_PREPROCESSED_HEADERS
-#define BOOST_MPL_LIMIT_LIST_SIZE 40
+#define BOOST_MPL_LIMIT_LIST_SIZE 50
 
 // We'll need the necessary boost::serialization features, as well as what we
 // use with mlpack.  In Boost 1.59 and newer, the BOOST_PFTO code is no longer
@@ -105,6 +108,9 @@ or upgrade Boost to 1.59 or newer.
 #include <mlpack/core/util/log.hpp>
 #include <mlpack/core/util/timers.hpp>
 
+// All code should use the thread budget.
+#include <mlpack/core/util/parallel.hpp>
+
 // On Visual Studio, disable C4519 (default arguments for function templates)
 // since it's by default an error, which doesn't even make any sense because
 // it's part of the C++11 standard.
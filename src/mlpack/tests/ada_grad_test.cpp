@@ -11,6 +11,7 @@
  */
 #include <mlpack/core.hpp>
 #include <mlpack/core/optimizers/ada_grad/ada_grad.hpp>
+#include <mlpack/core/optimizers/ada_grad/sparse_ada_grad_update.hpp>
 #include <mlpack/methods/logistic_regression/logistic_regression.hpp>
 #include <mlpack/core/optimizers/sgd/test_function.hpp>
 
@@ -100,4 +101,31 @@ BOOST_AUTO_TEST_CASE(AdaGradLogisticRegressionTest)
   const double testAcc = lr.ComputeAccuracy(testData, testResponses);
   BOOST_REQUIRE_CLOSE(testAcc, 100.0, 0.6); // 0.6% error tolerance.
 }
+
+/**
+ * Make sure that the sparse AdaGrad update takes the same steps as the dense
+ * AdaGrad update.
+ */
+BOOST_AUTO_TEST_CASE(SparseAdaGradUpdateTest)
+{
+  arma::mat denseIterate = arma::randn<arma::mat>(10, 5);
+  arma::mat sparseIterate(denseIterate);
+
+  AdaGradUpdate dense;
+  SparseAdaGradUpdate sparse;
+  dense.Initialize(10, 5);
+  sparse.Initialize(10, 5);
+
+  for (size_t i = 0; i < 30; ++i)
+  {
+    arma::sp_mat gradient;
+    gradient.sprandn(10, 5, 0.1);
+
+    dense.Update(denseIterate, 0.01, arma::mat(gradient));
+    sparse.Update(sparseIterate, 0.01, gradient);
+  }
+
+  CheckMatrices(sparseIterate, denseIterate, 1e-7);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
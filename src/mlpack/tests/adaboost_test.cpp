@@ -710,6 +710,55 @@ BOOST_AUTO_TEST_CASE(ClassifyTest_IRIS)
   BOOST_REQUIRE_LE(lError, 0.30);
 }
 
+/**
+ * Classify the given points by adding up the votes of each weak learner of the
+ * given AdaBoost model one at a time, and make sure that AdaBoost::Classify()
+ * gives the same predictions.
+ */
+template<typename WeakLearnerType>
+void CheckBatchClassify(AdaBoost<WeakLearnerType>& ab, const mat& points)
+{
+  mat votes(ab.NumClasses(), points.n_cols, fill::zeros);
+  for (size_t i = 0; i < ab.WeakLearners(); ++i)
+  {
+    Row<size_t> weakPredictions(points.n_cols);
+    ab.WeakLearner(i).Classify(points, weakPredictions);
+    for (size_t j = 0; j < points.n_cols; ++j)
+      votes(weakPredictions[j], j) += ab.Alpha(i);
+  }
+
+  Row<size_t> predictions;
+  ab.Classify(points, predictions);
+  BOOST_REQUIRE_EQUAL(predictions.n_elem, points.n_cols);
+  for (size_t j = 0; j < points.n_cols; ++j)
+  {
+    uword maxIndex;
+    votes.col(j).max(maxIndex);
+    BOOST_REQUIRE_EQUAL(predictions[j], (size_t) maxIndex);
+  }
+}
+
+/**
+ * Make sure that classifying many points (more than one batch) in parallel
+ * gives the same predictions as accumulating the votes of each weak learner.
+ */
+BOOST_AUTO_TEST_CASE(BatchClassifyTest)
+{
+  mat data = randu<mat>(3, 5000);
+  Row<size_t> labels(5000);
+  for (size_t i = 0; i < 5000; ++i)
+    labels[i] = (data(0, i) + data(1, i) > 1.0) ? 1 : ((data(2, i) > 0.7) ? 2 :
+        0);
+
+  Perceptron<> p(data, labels, 3, 100);
+  AdaBoost<> pBoost(data, labels, 3, p, 10, 1e-10);
+  CheckBatchClassify(pBoost, data);
+
+  DecisionStump<> ds(data, labels, 3, 10);
+  AdaBoost<DecisionStump<>> dsBoost(data, labels, 3, ds, 10, 1e-10);
+  CheckBatchClassify(dsBoost, data);
+}
+
 /**
  * Ensure that the Train() function works like it is supposed to, by building
  * AdaBoost on one dataset and then re-training on another dataset.
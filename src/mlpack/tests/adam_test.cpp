@@ -13,6 +13,7 @@
 #include <mlpack/core.hpp>
 
 #include <mlpack/core/optimizers/adam/adam.hpp>
+#include <mlpack/core/optimizers/adam/lazy_adam_update.hpp>
 #include <mlpack/core/optimizers/sgd/test_function.hpp>
 #include <mlpack/methods/logistic_regression/logistic_regression.hpp>
 
@@ -178,4 +179,42 @@ BOOST_AUTO_TEST_CASE(AdaMaxLogisticRegressionTest)
   BOOST_REQUIRE_CLOSE(testAcc, 100.0, 0.6); // 0.6% error tolerance.
 }
 
+/**
+ * Make sure that the lazy Adam update only moves the coordinates with a nonzero
+ * gradient, and that it takes the same steps as the Adam update when all of
+ * them have one.
+ */
+BOOST_AUTO_TEST_CASE(LazyAdamUpdateTest)
+{
+  arma::mat denseIterate = arma::randn<arma::mat>(10, 5);
+  arma::mat lazyIterate(denseIterate);
+
+  AdamUpdate dense;
+  LazyAdamUpdate lazy;
+  dense.Initialize(10, 5);
+  lazy.Initialize(10, 5);
+
+  // With a nonzero gradient everywhere, the steps are the same.
+  for (size_t i = 0; i < 10; ++i)
+  {
+    const arma::mat gradient = arma::randn<arma::mat>(10, 5) + 10.0;
+    dense.Update(denseIterate, 0.01, gradient);
+    lazy.Update(lazyIterate, 0.01, arma::sp_mat(gradient));
+  }
+  CheckMatrices(lazyIterate, denseIterate, 1e-7);
+
+  // Only the coordinates with a gradient move.
+  arma::sp_mat gradient(10, 5);
+  gradient(3, 2) = 1.0;
+  const arma::mat before(lazyIterate);
+  lazy.Update(lazyIterate, 0.01, gradient);
+  for (size_t i = 0; i < lazyIterate.n_elem; ++i)
+  {
+    if (i == 3 + 2 * 10)
+      BOOST_REQUIRE_LT(lazyIterate[i], before[i]);
+    else
+      BOOST_REQUIRE_EQUAL(lazyIterate[i], before[i]);
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END();
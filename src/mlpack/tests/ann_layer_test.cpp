@@ -488,6 +488,90 @@ BOOST_AUTO_TEST_CASE(GradientLinearLayerTest)
   BOOST_REQUIRE_LE(CheckGradient(function), 1e-4);
 }
 
+/**
+ * Sequential layer numerically gradient test.  The block has a first, a middle
+ * and a last module, so each of them must get the error of the module after
+ * it.
+ */
+BOOST_AUTO_TEST_CASE(GradientSequentialLayerTest)
+{
+  // Sequential function gradient instantiation.
+  struct GradientFunction
+  {
+    GradientFunction()
+    {
+      input = arma::randu(10, 1);
+      target = arma::mat("1");
+
+      model = new FFN<NegativeLogLikelihood<>, NguyenWidrowInitialization>(
+          input, target);
+      model->Add<IdentityLayer<> >();
+      Sequential<>* block = new Sequential<>();
+      block->Add<Linear<> >(10, 8);
+      block->Add<SigmoidLayer<> >();
+      block->Add<Linear<> >(8, 2);
+      model->Add(block);
+      model->Add<LogSoftMax<> >();
+    }
+
+    ~GradientFunction()
+    {
+      delete model;
+    }
+
+    double Gradient(arma::mat& gradient) const
+    {
+      arma::mat output;
+      double error = model->Evaluate(model->Parameters(), 0, 1);
+      model->Gradient(model->Parameters(), 0, gradient, 1);
+      return error;
+    }
+
+    arma::mat& Parameters() { return model->Parameters(); }
+
+    FFN<NegativeLogLikelihood<>, NguyenWidrowInitialization>* model;
+    arma::mat input, target;
+  } function;
+
+  BOOST_REQUIRE_LE(CheckGradient(function), 1e-4);
+}
+
+/**
+ * Make sure that the QuantizedLinear layer gives about the same results as the
+ * Linear layer it is made from.
+ */
+BOOST_AUTO_TEST_CASE(QuantizedLinearLayerTest)
+{
+  Linear<> module(50, 20);
+  module.Parameters().randn();
+  module.Reset();
+
+  QuantizedLinear<> quantized(module);
+  BOOST_REQUIRE_EQUAL(quantized.InputSize(), 50);
+  BOOST_REQUIRE_EQUAL(quantized.OutputSize(), 20);
+
+  arma::mat input = arma::randn(50, 30), output, quantizedOutput;
+  module.Forward(std::move(input), std::move(output));
+  quantized.Forward(std::move(input), std::move(quantizedOutput));
+  BOOST_REQUIRE_EQUAL(quantizedOutput.n_rows, 20);
+  BOOST_REQUIRE_EQUAL(quantizedOutput.n_cols, 30);
+  BOOST_REQUIRE_LE(arma::norm(output - quantizedOutput, "fro"),
+      0.02 * arma::norm(output, "fro"));
+
+  // The backward pass uses the dequantized weights.
+  arma::mat gy = arma::randn(20, 30), delta, quantizedDelta;
+  module.Backward(std::move(input), std::move(gy), std::move(delta));
+  quantized.Backward(std::move(input), std::move(gy),
+      std::move(quantizedDelta));
+  BOOST_REQUIRE_LE(arma::norm(delta - quantizedDelta, "fro"),
+      0.02 * arma::norm(delta, "fro"));
+
+  // A zero input must give the bias.
+  input.zeros();
+  quantized.Forward(std::move(input), std::move(quantizedOutput));
+  CheckMatrices(quantizedOutput.col(0), module.Parameters().rows(1000, 1019));
+}
+
 /**
  * Simple linear no bias module test.
  */
@@ -899,6 +983,59 @@ BOOST_AUTO_TEST_CASE(GradientFastLSTMLayerTest)
   BOOST_REQUIRE_LE(CheckGradient(function), 0.2);
 }
 
+/**
+ * Make sure that the sequence passes of the FastLSTM layer give the same
+ * results as one pass per time step.
+ */
+BOOST_AUTO_TEST_CASE(FastLSTMSequenceTest)
+{
+  const size_t steps = 6;
+  const size_t batchSize = 3;
+  arma::mat input = arma::randu(5, steps * batchSize);
+  arma::mat gy = arma::randu(4, steps * batchSize);
+
+  FastLSTM<> stepLayer(5, 4);
+  stepLayer.Parameters().randu();
+  stepLayer.Parameters() -= 0.5;
+  stepLayer.Reset();
+
+  FastLSTM<> sequenceLayer(5, 4);
+  sequenceLayer.Parameters() = stepLayer.Parameters();
+  sequenceLayer.Reset();
+
+  // One pass per time step, the way the RNN class calls the layer.
+  arma::mat stepOutput(4, steps * batchSize), stepG(5, steps * batchSize);
+  arma::mat stepGradient = arma::zeros(stepLayer.Parameters().n_elem, 1);
+  stepLayer.ResetCell(steps);
+  for (size_t i = 0; i < steps; ++i)
+  {
+    arma::mat output;
+    stepLayer.Forward(std::move(input.cols(i * batchSize,
+        (i + 1) * batchSize - 1)), std::move(output));
+    stepOutput.cols(i * batchSize, (i + 1) * batchSize - 1) = output;
+  }
+
+  for (size_t i = steps; i > 0; --i)
+  {
+    arma::mat error = gy.cols((i - 1) * batchSize, i * batchSize - 1);
+    arma::mat g, gradient(stepLayer.Parameters().n_elem, 1);
+    stepLayer.Backward(std::move(input), std::move(error), std::move(g));
+    stepLayer.Gradient(std::move(input.cols((i - 1) * batchSize,
+        i * batchSize - 1)), std::move(error), std::move(gradient));
+
+    stepG.cols((i - 1) * batchSize, i * batchSize - 1) = g;
+    stepGradient += gradient;
+  }
+
+  arma::mat sequenceOutput, sequenceG, sequenceGradient;
+  sequenceLayer.ForwardSequence(input, sequenceOutput, batchSize);
+  sequenceLayer.BackwardSequence(input, gy, sequenceG, sequenceGradient);
+
+  CheckMatrices(sequenceOutput, stepOutput);
+  CheckMatrices(sequenceG, stepG);
+  CheckMatrices(sequenceGradient, stepGradient);
+}
+
 /**
  * Check if the gradients computed by GRU cell are close enough to the
  * approximation of the gradients.
@@ -1081,6 +1218,69 @@ BOOST_AUTO_TEST_CASE(GradientConcatLayerTest)
   BOOST_REQUIRE_LE(CheckGradient(function), 1e-4);
 }
 
+/**
+ * Compare the MaxPooling and MeanPooling modules with a direct computation of
+ * the pooling over each window, on a batch of points with several maps each.
+ */
+BOOST_AUTO_TEST_CASE(PoolingLayersBatchTest)
+{
+  const size_t width = 7, height = 6, maps = 2, points = 3;
+  const size_t k = 3, stride = 2;
+  const size_t outWidth = (width - k) / stride + 1;
+  const size_t outHeight = (height - k) / stride + 1;
+
+  arma::mat input = arma::randu(width * height * maps, points);
+  arma::mat error = arma::randu(outWidth * outHeight * maps, points);
+
+  MaxPooling<> maxPooling(k, k, stride, stride);
+  maxPooling.InputWidth() = width;
+  maxPooling.InputHeight() = height;
+  MeanPooling<> meanPooling(k, k, stride, stride);
+  meanPooling.InputWidth() = width;
+  meanPooling.InputHeight() = height;
+
+  arma::mat maxOutput, meanOutput, maxDelta, meanDelta;
+  maxPooling.Forward(std::move(input), std::move(maxOutput));
+  meanPooling.Forward(std::move(input), std::move(meanOutput));
+  maxPooling.Backward(std::move(input), std::move(error), std::move(maxDelta));
+  meanPooling.Backward(std::move(input), std::move(error),
+      std::move(meanDelta));
+
+  const arma::cube inputCube(input.memptr(), width, height, maps * points);
+  const arma::cube errorCube(error.memptr(), outWidth, outHeight,
+      maps * points);
+  arma::cube maxCube(width, height, maps * points, arma::fill::zeros);
+  arma::cube meanCube(width, height, maps * points, arma::fill::zeros);
+  arma::cube expectedMax(outWidth, outHeight, maps * points);
+  arma::cube expectedMean(outWidth, outHeight, maps * points);
+  for (size_t s = 0; s < inputCube.n_slices; ++s)
+  {
+    for (size_t j = 0; j < outHeight; ++j)
+    {
+      for (size_t i = 0; i < outWidth; ++i)
+      {
+        const arma::mat window = inputCube.slice(s).submat(i * stride,
+            j * stride, i * stride + k - 1, j * stride + k - 1);
+        expectedMax(i, j, s) = window.max();
+        expectedMean(i, j, s) = arma::mean(arma::vectorise(window));
+
+        const arma::uword maxIndex = window.index_max();
+        maxCube(i * stride + maxIndex % k, j * stride + maxIndex / k, s) +=
+            errorCube(i, j, s);
+        meanCube.slice(s).submat(i * stride, j * stride, i * stride + k - 1,
+            j * stride + k - 1) += errorCube(i, j, s) / (k * k);
+      }
+    }
+  }
+
+  CheckMatrices(maxOutput, arma::reshape(arma::vectorise(expectedMax),
+      maxOutput.n_rows, points));
+  CheckMatrices(meanOutput, arma::reshape(arma::vectorise(expectedMean),
+      meanOutput.n_rows, points));
+  CheckMatrices(maxDelta, arma::vectorise(maxCube));
+  CheckMatrices(meanDelta, arma::vectorise(meanCube));
+}
+
 /**
  * Simple lookup module test.
  */
@@ -1122,6 +1322,73 @@ BOOST_AUTO_TEST_CASE(SimpleLookupLayerTest)
   BOOST_REQUIRE_CLOSE(arma::accu(gradient), arma::accu(error), 1e-3);
 }
 
+/**
+ * Make sure that the Lookup module sums the errors of repeated inputs, and
+ * that the columns of the last call are cleared when the gradient is reused.
+ */
+BOOST_AUTO_TEST_CASE(LookupLayerRepeatedInputTest)
+{
+  arma::mat output, delta, gradient;
+  Lookup<> module(10, 5);
+  module.Parameters().randu();
+  gradient.zeros(5, 10);
+
+  arma::mat input("2 7 2");
+  arma::mat error = arma::randu<arma::mat>(5, 3);
+  module.Gradient(std::move(input), std::move(error), std::move(gradient));
+
+  CheckMatrices(gradient.col(1), error.col(0) + error.col(2));
+  CheckMatrices(gradient.col(6), error.col(1));
+  BOOST_REQUIRE_CLOSE(arma::accu(gradient), arma::accu(error), 1e-3);
+  BOOST_REQUIRE_EQUAL(module.GradientColumns().n_elem, 2);
+
+  input = arma::mat("4");
+  error = arma::randu<arma::mat>(5, 1);
+  module.Gradient(std::move(input), std::move(error), std::move(gradient));
+
+  CheckMatrices(gradient.col(3), error.col(0));
+  BOOST_REQUIRE_CLOSE(arma::accu(gradient), arma::accu(error), 1e-3);
+  BOOST_REQUIRE_EQUAL(module.GradientColumns().n_elem, 1);
+}
+
+/**
+ * Make sure that the sparse gradient of a network with a Lookup layer is the
+ * same as the dense gradient, and only holds the looked up columns.
+ */
+BOOST_AUTO_TEST_CASE(LookupLayerSparseGradientTest)
+{
+  arma::mat input("3 8 3 1 8");
+  arma::mat target("1 2 2 1 2");
+
+  FFN<NegativeLogLikelihood<>, RandomInitialization> model(input, target);
+  model.Add<Lookup<> >(10, 4);
+  model.Add<Linear<> >(4, 2);
+  model.Add<LogSoftMax<> >();
+
+  arma::mat denseGradient;
+  model.Gradient(model.Parameters(), 0, denseGradient, 5);
+
+  // Call it twice, so that the clearing of the last columns is used.
+  arma::sp_mat sparseGradient;
+  model.Gradient(model.Parameters(), 0, sparseGradient, 2);
+  model.Gradient(model.Parameters(), 0, sparseGradient, 5);
+
+  CheckMatrices(denseGradient, arma::mat(sparseGradient));
+
+  // Three columns of the table are used, and all the parameters of the linear
+  // layer.
+  const size_t linearElements = 4 * 2 + 2;
+  BOOST_REQUIRE_LE(sparseGradient.n_nonzero, 3 * 4 + linearElements);
+  for (size_t c = 0; c < 10; ++c)
+  {
+    if (c != 0 && c != 2 && c != 7)
+    {
+      BOOST_REQUIRE_EQUAL(arma::accu(arma::abs(
+          arma::mat(sparseGradient.rows(4 * c, 4 * c + 3)))), 0.0);
+    }
+  }
+}
+
 /**
  * Simple LogSoftMax module test.
  */
@@ -1223,4 +1490,207 @@ BOOST_AUTO_TEST_CASE(SimpleMeanSquaredErrorLayerTest)
   BOOST_REQUIRE_EQUAL(output.n_elem, 1);
 }
 
+/**
+ * Test that the convolution layer gives the same results with
+ * Im2ColConvolution as with NaiveConvolution.
+ */
+BOOST_AUTO_TEST_CASE(Im2ColConvolutionLayerTest)
+{
+  typedef Convolution<Im2ColConvolution<ValidConvolution>,
+      Im2ColConvolution<FullConvolution>,
+      Im2ColConvolution<ValidConvolution> > Im2ColConvolutionLayer;
+
+  // Compare the forward pass on a batch of points with several input maps.
+  Convolution<> naive(2, 3, 3, 3, 1, 1, 1, 1, 7, 6);
+  Im2ColConvolutionLayer im2col(2, 3, 3, 3, 1, 1, 1, 1, 7, 6);
+  naive.Parameters().randu();
+  im2col.Parameters() = naive.Parameters();
+  naive.Reset();
+  im2col.Reset();
+
+  arma::mat input = arma::randu(7 * 6 * 2, 4);
+  arma::mat naiveOutput, im2colOutput;
+  naive.Forward(std::move(input), std::move(naiveOutput));
+  im2col.Forward(std::move(input), std::move(im2colOutput));
+  CheckMatrices(naiveOutput, im2colOutput);
+  BOOST_REQUIRE_EQUAL(im2col.OutputWidth(), naive.OutputWidth());
+  BOOST_REQUIRE_EQUAL(im2col.OutputHeight(), naive.OutputHeight());
+
+  // The backward pass and the gradient of NaiveConvolution only handle one
+  // point with one input map.
+  Convolution<> naiveSingle(1, 3, 3, 3, 1, 1, 1, 1, 7, 6);
+  Im2ColConvolutionLayer im2colSingle(1, 3, 3, 3, 1, 1, 1, 1, 7, 6);
+  naiveSingle.Parameters().randu();
+  im2colSingle.Parameters() = naiveSingle.Parameters();
+  naiveSingle.Reset();
+  im2colSingle.Reset();
+
+  input = arma::randu(7 * 6, 1);
+  naiveSingle.Forward(std::move(input), std::move(naiveOutput));
+  im2colSingle.Forward(std::move(input), std::move(im2colOutput));
+  CheckMatrices(naiveOutput, im2colOutput);
+
+  arma::mat error = arma::randu(naiveOutput.n_rows, 1);
+  arma::mat naiveDelta, im2colDelta;
+  naiveSingle.Backward(std::move(input), std::move(error),
+      std::move(naiveDelta));
+  im2colSingle.Backward(std::move(input), std::move(error),
+      std::move(im2colDelta));
+  CheckMatrices(naiveDelta, im2colDelta);
+
+  arma::mat naiveGradient(naiveSingle.Parameters().n_elem, 1);
+  arma::mat im2colGradient(im2colSingle.Parameters().n_elem, 1);
+  naiveSingle.Gradient(std::move(input), std::move(error),
+      std::move(naiveGradient));
+  im2colSingle.Gradient(std::move(input), std::move(error),
+      std::move(im2colGradient));
+  CheckMatrices(naiveGradient, im2colGradient);
+}
+
+/**
+ * Convolution module test with Im2ColConvolution, with several maps, padding
+ * and strides.
+ */
+BOOST_AUTO_TEST_CASE(GradientIm2ColConvolutionLayerTest)
+{
+  typedef Convolution<Im2ColConvolution<ValidConvolution>,
+      Im2ColConvolution<FullConvolution>,
+      Im2ColConvolution<ValidConvolution> > Im2ColConvolutionLayer;
+
+  // Convolution function gradient instantiation.
+  struct GradientFunction
+  {
+    GradientFunction()
+    {
+      input = arma::randu(5 * 5, 1);
+      target = arma::mat("1");
+
+      model = new FFN<NegativeLogLikelihood<>, NguyenWidrowInitialization>(
+          input, target);
+      model->Add<Im2ColConvolutionLayer>(1, 2, 3, 3, 1, 1, 1, 1, 5, 5);
+      model->Add<Im2ColConvolutionLayer>(2, 3, 3, 3, 2, 2, 0, 0, 5, 5);
+      model->Add<Linear<> >(3 * 2 * 2, 2);
+      model->Add<LogSoftMax<> >();
+    }
+
+    ~GradientFunction()
+    {
+      delete model;
+    }
+
+    double Gradient(arma::mat& gradient) const
+    {
+      arma::mat output;
+      double error = model->Evaluate(model->Parameters(), 0, 1);
+      model->Gradient(model->Parameters(), 0, gradient, 1);
+      return error;
+    }
+
+    arma::mat& Parameters() { return model->Parameters(); }
+
+    FFN<NegativeLogLikelihood<>, NguyenWidrowInitialization>* model;
+    arma::mat input, target;
+  } function;
+
+  BOOST_REQUIRE_LE(CheckGradient(function), 1e-4);
+}
+
+/**
+ * Make sure that a layer that already ran forward and backward passes on
+ * another input (of another size) gives the same results as a new layer on the
+ * given input and error, so the temporaries it keeps between passes don't leak
+ * into the next pass.
+ */
+template<typename LayerType>
+void CheckLayerReuse(LayerType& layer,
+                     LayerType& newLayer,
+                     arma::mat firstInput,
+                     arma::mat& input,
+                     arma::mat& error)
+{
+  arma::mat output, delta;
+  arma::mat firstError = arma::randu(error.n_rows, firstInput.n_cols);
+  layer.Forward(std::move(firstInput), std::move(output));
+  layer.Backward(std::move(firstInput), std::move(firstError),
+      std::move(delta));
+
+  layer.Forward(std::move(input), std::move(output));
+  layer.Backward(std::move(input), std::move(error), std::move(delta));
+
+  arma::mat newOutput, newDelta;
+  newLayer.Forward(std::move(input), std::move(newOutput));
+  newLayer.Backward(std::move(input), std::move(error), std::move(newDelta));
+
+  CheckMatrices(output, newOutput);
+  CheckMatrices(delta, newDelta);
+}
+
+/**
+ * Make sure that the given convolution layer gives the same results (including
+ * the gradient) when it reuses its temporaries from an earlier pass as when it
+ * is new.
+ */
+template<typename LayerType>
+void CheckConvolutionReuse(LayerType& layer,
+                           LayerType& newLayer,
+                           const arma::mat& firstInput,
+                           arma::mat input,
+                           const size_t outputSize)
+{
+  layer.Parameters().randu();
+  layer.Reset();
+  newLayer.Parameters() = layer.Parameters();
+  newLayer.Reset();
+
+  arma::mat error = arma::randu(outputSize, input.n_cols);
+  CheckLayerReuse(layer, newLayer, firstInput, input, error);
+
+  arma::mat gradient(layer.Parameters().n_elem, 1);
+  arma::mat newGradient(layer.Parameters().n_elem, 1);
+  layer.Gradient(std::move(input), std::move(error), std::move(gradient));
+  newLayer.Gradient(std::move(input), std::move(error),
+      std::move(newGradient));
+  CheckMatrices(gradient, newGradient);
+}
+
+/**
+ * Make sure that the Convolution, MaxPooling and MeanPooling layers give the
+ * same results when they reuse their temporaries from an earlier pass as when
+ * they are new.
+ */
+BOOST_AUTO_TEST_CASE(LayerTemporariesReuseTest)
+{
+  // The backward pass and the gradient of NaiveConvolution only handle one
+  // point with one input map.
+  Convolution<> naive(1, 2, 3, 3, 1, 1, 0, 0, 7, 6);
+  Convolution<> newNaive(1, 2, 3, 3, 1, 1, 0, 0, 7, 6);
+  CheckConvolutionReuse(naive, newNaive, arma::randu(7 * 6, 1),
+      arma::randu(7 * 6, 1), 5 * 4 * 2);
+
+  // Im2ColConvolution handles batches, so the first batch has another size.
+  // With padding, the backward pass uses the padded delta as well.
+  typedef Convolution<Im2ColConvolution<ValidConvolution>,
+      Im2ColConvolution<FullConvolution>,
+      Im2ColConvolution<ValidConvolution> > Im2ColConvolutionLayer;
+  Im2ColConvolutionLayer im2col(2, 3, 3, 3, 1, 1, 1, 1, 7, 6);
+  Im2ColConvolutionLayer newIm2col(2, 3, 3, 3, 1, 1, 1, 1, 7, 6);
+  CheckConvolutionReuse(im2col, newIm2col, arma::randu(7 * 6 * 2, 4),
+      arma::randu(7 * 6 * 2, 2), 7 * 6 * 3);
+
+  arma::mat input = arma::randu(7 * 6 * 2, 2);
+  arma::mat error = arma::randu(3 * 2 * 2, 2);
+
+  MaxPooling<> maxPooling(3, 3, 2, 2), newMaxPooling(3, 3, 2, 2);
+  maxPooling.InputWidth() = newMaxPooling.InputWidth() = 7;
+  maxPooling.InputHeight() = newMaxPooling.InputHeight() = 6;
+  CheckLayerReuse(maxPooling, newMaxPooling, arma::randu(7 * 6 * 2, 3),
+      input, error);
+
+  MeanPooling<> meanPooling(3, 3, 2, 2), newMeanPooling(3, 3, 2, 2);
+  meanPooling.InputWidth() = newMeanPooling.InputWidth() = 7;
+  meanPooling.InputHeight() = newMeanPooling.InputHeight() = 6;
+  CheckLayerReuse(meanPooling, newMeanPooling, arma::randu(7 * 6 * 2, 3),
+      input, error);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -217,4 +217,143 @@ BOOST_AUTO_TEST_CASE(NStepQLearningTest)
   Log::Debug << "Total test episodes: " << testEpisodes << std::endl;
 }
 
+/**
+ * Step a worker on its own, and make sure that the shared target network is
+ * given the parameters of the shared learning network exactly when the total
+ * number of steps reaches a multiple of the sync interval, and is left alone
+ * otherwise.
+ */
+template<typename WorkerType>
+void CheckWorkerTargetSync()
+{
+  FFN<MeanSquaredError<>, GaussianInitialization> learningNetwork(
+      MeanSquaredError<>(), GaussianInitialization(0, 0.001));
+  learningNetwork.Add<Linear<>>(4, 20);
+  learningNetwork.Add<ReLULayer<>>();
+  learningNetwork.Add<Linear<>>(20, 2);
+  learningNetwork.ResetParameters();
+  FFN<MeanSquaredError<>, GaussianInitialization> targetNetwork =
+      learningNetwork;
+  const arma::mat initialParameters = learningNetwork.Parameters();
+
+  GreedyPolicy<CartPole> policy(0.7, 5000, 0.1);
+
+  TrainingConfig config;
+  config.StepSize() = 0.01;
+  config.Discount() = 0.99;
+  config.NumWorkers() = 1;
+  config.UpdateInterval() = 6;
+  config.StepLimit() = 200;
+  config.TargetNetworkSyncInterval() = 10;
+
+  WorkerType worker(VanillaUpdate(), CartPole(), config, false);
+  worker.Initialize(learningNetwork);
+
+  std::atomic<size_t> totalSteps(0);
+  for (size_t i = 0; i < 500; ++i)
+  {
+    const arma::mat targetParameters = targetNetwork.Parameters();
+    double reward;
+    worker.Step(learningNetwork, targetNetwork, totalSteps, policy, reward);
+
+    if (totalSteps % config.TargetNetworkSyncInterval() == 0)
+    {
+      BOOST_REQUIRE(arma::all(arma::vectorise(
+          targetNetwork.Parameters() == learningNetwork.Parameters())));
+    }
+    else
+    {
+      BOOST_REQUIRE(arma::all(arma::vectorise(
+          targetNetwork.Parameters() == targetParameters)));
+    }
+  }
+
+  // The updates must have reached the shared learning network.
+  BOOST_REQUIRE_EQUAL(totalSteps.load(), 500);
+  BOOST_REQUIRE(arma::any(arma::vectorise(
+      learningNetwork.Parameters() != initialParameters)));
+}
+
+// Test the lock-free syncing of the shared networks by the workers.
+BOOST_AUTO_TEST_CASE(WorkerTargetNetworkSyncTest)
+{
+  typedef FFN<MeanSquaredError<>, GaussianInitialization> NetworkType;
+  typedef GreedyPolicy<CartPole> PolicyType;
+
+  CheckWorkerTargetSync<OneStepQLearningWorker<CartPole, NetworkType,
+      VanillaUpdate, PolicyType>>();
+  CheckWorkerTargetSync<OneStepSarsaWorker<CartPole, NetworkType,
+      VanillaUpdate, PolicyType>>();
+  CheckWorkerTargetSync<NStepQLearningWorker<CartPole, NetworkType,
+      VanillaUpdate, PolicyType>>();
+}
+
+// Test async one step q-learning in Cart Pole with several threads, which
+// share the networks without locks; it must learn as it does with one thread.
+BOOST_AUTO_TEST_CASE(OneStepQLearningParallelTest)
+{
+  #ifdef HAS_OPENMP
+    const int prevNumThreads = omp_get_max_threads();
+    omp_set_num_threads(4);
+  #endif
+
+  // Set up the network.
+  FFN<MeanSquaredError<>, GaussianInitialization> model(MeanSquaredError<>(),
+      GaussianInitialization(0, 0.001));
+  model.Add<Linear<>>(4, 20);
+  model.Add<ReLULayer<>>();
+  model.Add<Linear<>>(20, 20);
+  model.Add<ReLULayer<>>();
+  model.Add<Linear<>>(20, 2);
+
+  // Set up the policy.
+  using Policy = GreedyPolicy<CartPole>;
+  AggregatedPolicy<Policy> policy({Policy(0.7, 5000, 0.1),
+                                  Policy(0.7, 5000, 0.01),
+                                  Policy(0.7, 5000, 0.5)},
+                                  arma::colvec("0.4 0.3 0.3"));
+
+  TrainingConfig config;
+  config.StepSize() = 0.0001;
+  config.Discount() = 0.99;
+  config.NumWorkers() = 16;
+  config.UpdateInterval() = 6;
+  config.StepLimit() = 200;
+  config.TargetNetworkSyncInterval() = 200;
+
+  OneStepQLearning<CartPole, decltype(model), VanillaUpdate, decltype(policy)>
+      agent(std::move(config), std::move(model), std::move(policy));
+
+  arma::vec rewards(20, arma::fill::zeros);
+  size_t pos = 0;
+  size_t testEpisodes = 0;
+  bool tooManyEpisodes = false;
+  auto measure = [&](double reward)
+  {
+    // The measure is only called by the thread of the deterministic worker.
+    testEpisodes++;
+    if (testEpisodes > 10000)
+    {
+      tooManyEpisodes = true;
+      return true;
+    }
+    rewards[pos++] = reward;
+    pos %= rewards.n_elem;
+    // Maybe underestimated.
+    double avgReward = arma::mean(rewards);
+    Log::Debug << "Average return: " << avgReward
+        << " Episode return: " << reward << std::endl;
+    return avgReward > 60;
+  };
+
+  agent.Train(measure);
+  Log::Debug << "Total test episodes: " << testEpisodes << std::endl;
+
+  #ifdef HAS_OPENMP
+    omp_set_num_threads(prevNumThreads);
+  #endif
+
+  BOOST_REQUIRE(!tooManyEpisodes);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
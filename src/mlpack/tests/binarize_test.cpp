@@ -68,4 +68,24 @@ BOOST_AUTO_TEST_CASE(BinerizeAll)
   BOOST_REQUIRE_CLOSE(output(2, 2), 1.0, 1e-5); // 9
 }
 
+/**
+ * Make sure that binarizing in place gives the same result as binarizing into
+ * a separate matrix.
+ */
+BOOST_AUTO_TEST_CASE(BinarizeInPlace)
+{
+  mat input = randu<mat>(5, 200);
+
+  mat output;
+  Binarize<double>(input, output, 0.3);
+  mat inPlace = input;
+  Binarize<double>(inPlace, 0.3);
+  CheckMatrices(output, inPlace);
+
+  Binarize<double>(input, output, 0.6, 2);
+  inPlace = input;
+  Binarize<double>(inPlace, 0.6, 2);
+  CheckMatrices(output, inPlace);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -12,6 +12,7 @@
 
 #include <mlpack/core.hpp>
 #include <mlpack/methods/cf/cf.hpp>
+#include <mlpack/methods/cf/implicit_als.hpp>
 #include <iostream>
 
 #include <boost/test/unit_test.hpp>
@@ -98,6 +99,54 @@ BOOST_AUTO_TEST_CASE(CFGetRecommendationsQueriedUserTest)
   BOOST_REQUIRE_EQUAL(recommendations.n_cols, numUsers);
 }
 
+/**
+ * Make sure that the recommendations are the same with one thread as with all
+ * of them, and that no user is recommended an item they already rated.
+ */
+BOOST_AUTO_TEST_CASE(CFGetRecommendationsParallelTest)
+{
+  const size_t numRecs = 10;
+
+  // Load GroupLens data.
+  arma::mat dataset;
+  data::Load("GroupLensSmall.csv", dataset);
+
+  // Make data into sparse matrix.
+  arma::sp_mat cleanedData;
+  CF::CleanData(dataset, cleanedData);
+
+  CF c(cleanedData);
+
+  // Query every user three times, so that there are several blocks of users to
+  // process in parallel.
+  arma::Col<size_t> users(3 * cleanedData.n_cols);
+  for (size_t i = 0; i < users.n_elem; ++i)
+    users(i) = i % cleanedData.n_cols;
+
+  arma::Mat<size_t> serialRecommendations;
+  {
+    Parallel::Scope scope(1);
+    c.GetRecommendations(numRecs, serialRecommendations, users);
+  }
+
+  arma::Mat<size_t> recommendations;
+  c.GetRecommendations(numRecs, recommendations, users);
+
+  BOOST_REQUIRE_EQUAL(recommendations.n_rows, numRecs);
+  BOOST_REQUIRE_EQUAL(recommendations.n_cols, users.n_elem);
+  for (size_t i = 0; i < recommendations.n_cols; ++i)
+  {
+    for (size_t j = 0; j < numRecs; ++j)
+    {
+      BOOST_REQUIRE_EQUAL(recommendations(j, i), serialRecommendations(j, i));
+
+      // The item must be valid, and not rated by the user already.
+      BOOST_REQUIRE_LT(recommendations(j, i), cleanedData.n_rows);
+      BOOST_REQUIRE_EQUAL(cleanedData(recommendations(j, i), users(i)), 0.0);
+    }
+  }
+}
+
 /**
  * Make sure recommendations that are generated are reasonably accurate.
  */
@@ -542,7 +591,120 @@ BOOST_AUTO_TEST_CASE(SerializationTest)
     BOOST_REQUIRE_CLOSE(c.CleanedData().values[i],
         cText.CleanedData().values[i], 1e-5);
   }
+
+  // The loaded models should reuse the serialized similarity index, and give
+  // the same predictions.
+  arma::Mat<size_t> combinations(2, 20);
+  for (size_t i = 0; i < combinations.n_cols; ++i)
+  {
+    combinations(0, i) = (size_t) dataset(0, i);
+    combinations(1, i) = (size_t) dataset(1, i);
+  }
+
+  arma::vec predictions, xmlPredictions, binaryPredictions, textPredictions;
+  c.Predict(combinations, predictions);
+  cXml.Predict(combinations, xmlPredictions);
+  cBinary.Predict(combinations, binaryPredictions);
+  cText.Predict(combinations, textPredictions);
+  CheckMatrices(predictions, xmlPredictions, binaryPredictions,
+      textPredictions);
+
+  for (size_t i = 0; i < combinations.n_cols; ++i)
+  {
+    BOOST_REQUIRE_CLOSE(c.Predict(combinations(0, i), combinations(1, i)),
+        predictions[i], 1e-5);
+  }
 }
 
 
+/**
+ * Make sure that ImplicitALS scores the observed entries of a feedback matrix
+ * higher than the unobserved entries, and that it works as a CF factorizer.
+ */
+BOOST_AUTO_TEST_CASE(ImplicitALSTest)
+{
+  // Users 0-49 click on items 0-29, and users 50-99 click on items 30-59.
+  arma::sp_mat feedback(60, 100);
+  for (size_t u = 0; u < 100; ++u)
+  {
+    for (size_t i = 0; i < 30; ++i)
+    {
+      if (math::Random() < 0.3)
+        feedback((u < 50) ? i : (i + 30), u) = math::RandInt(1, 5);
+    }
+  }
+
+  arma::mat w, h;
+  ImplicitALS als(10, 10.0, 0.1);
+  als.Apply(feedback, 5, w, h);
+
+  const arma::mat scores = w * h;
+  double inBlock = 0.0, outOfBlock = 0.0;
+  for (size_t u = 0; u < 100; ++u)
+  {
+    inBlock += arma::accu(scores.col(u).subvec((u < 50) ? 0 : 30,
+        (u < 50) ? 29 : 59));
+    outOfBlock += arma::accu(scores.col(u).subvec((u < 50) ? 30 : 0,
+        (u < 50) ? 59 : 29));
+  }
+  BOOST_REQUIRE_GT(inBlock, 5 * outOfBlock);
+
+  // Recommendations from the CF model should stay inside each user's block.
+  CF c(feedback, als, 5, 5);
+  arma::Mat<size_t> recommendations;
+  c.GetRecommendations(3, recommendations);
+
+  BOOST_REQUIRE_EQUAL(recommendations.n_rows, 3);
+  BOOST_REQUIRE_EQUAL(recommendations.n_cols, 100);
+  size_t correct = 0;
+  for (size_t u = 0; u < 100; ++u)
+  {
+    for (size_t r = 0; r < 3; ++r)
+    {
+      if ((recommendations(r, u) < 30) == (u < 50))
+        ++correct;
+    }
+  }
+  BOOST_REQUIRE_GT(correct, 270);
+}
+
+/**
+ * Make sure that the max inner product recommendations are the unrated items
+ * with the largest predicted ratings.
+ */
+BOOST_AUTO_TEST_CASE(CFMaxInnerProductRecommendationsTest)
+{
+  arma::mat dataset;
+  data::Load("GroupLensSmall.csv", dataset);
+
+  CF c(dataset, amf::NMFALSFactorizer(), 5, 5);
+
+  arma::Col<size_t> users("0 3 17 45 101 199");
+  arma::Mat<size_t> recommendations;
+  c.GetMaxInnerProductRecommendations(5, recommendations, users);
+
+  BOOST_REQUIRE_EQUAL(recommendations.n_rows, 5);
+  BOOST_REQUIRE_EQUAL(recommendations.n_cols, users.n_elem);
+
+  // Compare with a brute-force search.
+  for (size_t i = 0; i < users.n_elem; ++i)
+  {
+    arma::vec ratings = c.W() * c.H().col(users[i]);
+    for (size_t j = 0; j < ratings.n_elem; ++j)
+    {
+      if (c.CleanedData()(j, users[i]) != 0.0)
+        ratings[j] = -DBL_MAX;
+    }
+
+    const arma::uvec best = arma::sort_index(ratings, "descend");
+    for (size_t r = 0; r < 5; ++r)
+      BOOST_REQUIRE_EQUAL(recommendations(r, i), best[r]);
+  }
+
+  // All users should get recommendations too.
+  c.GetMaxInnerProductRecommendations(5, recommendations);
+  BOOST_REQUIRE_EQUAL(recommendations.n_rows, 5);
+  BOOST_REQUIRE_EQUAL(recommendations.n_cols, 200);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -0,0 +1,201 @@
+/**
+ * @file checkpoint_test.cpp
+ *
+ * Tests for the checkpoints of the optimizers: an interrupted optimization that
+ * is resumed from its checkpoint must end where an uninterrupted one does.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/core/optimizers/adam/adam.hpp>
+#include <mlpack/core/optimizers/lbfgs/lbfgs.hpp>
+#include <mlpack/methods/logistic_regression/logistic_regression_function.hpp>
+
+#include <boost/test/unit_test.hpp>
+#include "test_tools.hpp"
+
+using namespace mlpack;
+using namespace mlpack::optimization;
+using namespace mlpack::regression;
+
+BOOST_AUTO_TEST_SUITE(CheckpointTest);
+
+/**
+ * A function that throws after the given number of gradient evaluations, to
+ * simulate an interrupted run.  It computes everything like the function it
+ * wraps, so that the steps are the same.
+ */
+class InterruptedFunction
+{
+ public:
+  InterruptedFunction(LogisticRegressionFunction<>& function,
+                      const size_t maxGradients) :
+      function(function),
+      maxGradients(maxGradients),
+      gradients(0)
+  { }
+
+  size_t NumFunctions() const { return function.NumFunctions(); }
+
+  void Shuffle() { function.Shuffle(); }
+
+  double Evaluate(const arma::mat& coordinates)
+  {
+    return function.Evaluate(coordinates);
+  }
+
+  double Evaluate(const arma::mat& coordinates,
+                  const size_t begin,
+                  const size_t batchSize)
+  {
+    return function.Evaluate(coordinates, begin, batchSize);
+  }
+
+  double EvaluateWithGradient(const arma::mat& coordinates,
+                              arma::mat& gradient)
+  {
+    Interrupt();
+    return function.EvaluateWithGradient(coordinates, gradient);
+  }
+
+  double EvaluateWithGradient(const arma::mat& coordinates,
+                              const size_t begin,
+                              arma::mat& gradient,
+                              const size_t batchSize)
+  {
+    Interrupt();
+    return function.EvaluateWithGradient(coordinates, begin, gradient,
+        batchSize);
+  }
+
+ private:
+  void Interrupt()
+  {
+    if (++gradients > maxGradients)
+      throw std::runtime_error("interrupted");
+  }
+
+  LogisticRegressionFunction<>& function;
+  size_t maxGradients;
+  size_t gradients;
+};
+
+/**
+ * Create a random logistic regression problem.
+ */
+void RandomProblem(arma::mat& data, arma::Row<size_t>& responses)
+{
+  data = arma::randn<arma::mat>(5, 200);
+  responses.set_size(200);
+  for (size_t i = 0; i < data.n_cols; ++i)
+    responses[i] = (arma::accu(data.col(i)) > 0) ? 1 : 0;
+}
+
+/**
+ * Make sure that Adam, interrupted in the middle of a pass, resumes from its
+ * last checkpoint (with the moment estimates) and ends at the same point as an
+ * uninterrupted run.
+ */
+BOOST_AUTO_TEST_CASE(AdamResumeTest)
+{
+  arma::mat data;
+  arma::Row<size_t> responses;
+  RandomProblem(data, responses);
+  LogisticRegressionFunction<> lrf(data, responses, 0.5);
+
+  const size_t maxIterations = 20 * data.n_cols;
+  Adam reference(0.01, 32, 0.9, 0.999, 1e-8, maxIterations, 0, false);
+  arma::mat referenceIterate = lrf.GetInitialPoint();
+  const double referenceObjective = reference.Optimize(lrf, referenceIterate);
+
+  // There are 7 batches in a pass; stop in the middle of the eighth pass.  The
+  // last checkpoint is then the one at the start of the seventh pass.
+  const std::string filename = "adam_checkpoint_test.bin";
+  {
+    Adam adam(0.01, 32, 0.9, 0.999, 1e-8, maxIterations, 0, false);
+    adam.Checkpoint() = OptimizerCheckpoint(filename, 2);
+
+    InterruptedFunction f(lrf, 7 * 7 + 3);
+    arma::mat iterate = lrf.GetInitialPoint();
+    BOOST_REQUIRE_THROW(adam.Optimize(f, iterate), std::runtime_error);
+  }
+
+  Adam adam(0.01, 32, 0.9, 0.999, 1e-8, maxIterations, 0, false);
+  adam.Checkpoint() = OptimizerCheckpoint(filename, 2);
+  arma::mat iterate = lrf.GetInitialPoint();
+  const double objective = adam.Optimize(lrf, iterate);
+
+  BOOST_REQUIRE_CLOSE(objective, referenceObjective, 1e-8);
+  CheckMatrices(iterate, referenceIterate, 1e-8);
+
+  // The checkpoint is removed at the end of the optimization.
+  BOOST_REQUIRE(!std::ifstream(filename).is_open());
+}
+
+/**
+ * Make sure that L-BFGS resumes from its last checkpoint (with the basis) and
+ * ends at the same point as an uninterrupted run.
+ */
+BOOST_AUTO_TEST_CASE(LBFGSResumeTest)
+{
+  arma::mat data;
+  arma::Row<size_t> responses;
+  RandomProblem(data, responses);
+  LogisticRegressionFunction<> lrf(data, responses, 0.5);
+
+  L_BFGS reference;
+  arma::mat referenceIterate = lrf.GetInitialPoint();
+  const double referenceObjective = reference.Optimize(lrf, referenceIterate);
+
+  const std::string filename = "lbfgs_checkpoint_test.bin";
+  {
+    L_BFGS lbfgs;
+    lbfgs.Checkpoint() = OptimizerCheckpoint(filename, 1);
+
+    InterruptedFunction f(lrf, 6);
+    arma::mat iterate = lrf.GetInitialPoint();
+    BOOST_REQUIRE_THROW(lbfgs.Optimize(f, iterate), std::runtime_error);
+  }
+
+  L_BFGS lbfgs;
+  lbfgs.Checkpoint() = OptimizerCheckpoint(filename, 1);
+  arma::mat iterate = lrf.GetInitialPoint();
+  const double objective = lbfgs.Optimize(lrf, iterate);
+
+  BOOST_REQUIRE_CLOSE(objective, referenceObjective, 1e-8);
+  CheckMatrices(iterate, referenceIterate, 1e-8);
+  BOOST_REQUIRE(!std::ifstream(filename).is_open());
+}
+
+/**
+ * Make sure that the checkpoint of one optimizer can't be loaded by another.
+ */
+BOOST_AUTO_TEST_CASE(CheckpointKindTest)
+{
+  arma::mat data;
+  arma::Row<size_t> responses;
+  RandomProblem(data, responses);
+  LogisticRegressionFunction<> lrf(data, responses, 0.5);
+
+  const std::string filename = "kind_checkpoint_test.bin";
+  {
+    Adam adam(0.01, 32, 0.9, 0.999, 1e-8, 20 * data.n_cols, 0, false);
+    adam.Checkpoint() = OptimizerCheckpoint(filename, 1);
+
+    InterruptedFunction f(lrf, 10);
+    arma::mat iterate = lrf.GetInitialPoint();
+    BOOST_REQUIRE_THROW(adam.Optimize(f, iterate), std::runtime_error);
+  }
+
+  L_BFGS lbfgs;
+  lbfgs.Checkpoint() = OptimizerCheckpoint(filename, 1);
+  arma::mat iterate = lrf.GetInitialPoint();
+  BOOST_REQUIRE_THROW(lbfgs.Optimize(lrf, iterate), std::runtime_error);
+
+  remove(filename.c_str());
+}
+
+BOOST_AUTO_TEST_SUITE_END();
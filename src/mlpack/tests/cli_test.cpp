@@ -25,6 +25,7 @@ using Option = mlpack::bindings::cli::CLIOption<T>;
 #include <mlpack/core/util/param.hpp>
 #include <mlpack/bindings/cli/parse_command_line.hpp>
 #include <mlpack/bindings/cli/end_program.hpp>
+#include <mlpack/bindings/cli/server.hpp>
 
 #include <boost/test/unit_test.hpp>
 #include "test_tools.hpp"
@@ -916,6 +917,52 @@ BOOST_AUTO_TEST_CASE(SerializationTest)
   remove("kernel.txt");
 }
 
+/**
+ * Make sure that a server request that passes another model file gets the new
+ * model, and that a request without a model file reuses the last one loaded.
+ */
+BOOST_AUTO_TEST_CASE(ServerInputModelTest)
+{
+  AddRequiredCLIOptions();
+
+  PARAM_MODEL_IN(GaussianKernel, "kernel", "Test kernel", "k");
+  PARAM_INT_IN("int", "Test int", "i", 0);
+
+  GaussianKernel gk1(0.5);
+  GaussianKernel gk2(2.0);
+  data::Save("kernel1.bin", "model", gk1);
+  data::Save("kernel2.bin", "model", gk2);
+
+  const char* argv[1];
+  argv[0] = "./test";
+
+  int argc = 1;
+
+  ParseCommandLine(argc, const_cast<char**>(argv));
+
+  // Each request records the bandwidth of the kernel it was given.
+  std::istringstream requests("--kernel_file kernel1.bin\n"
+                              "--kernel_file kernel2.bin\n"
+                              "-i 3\n"
+                              "--kernel_file kernel1.bin\n");
+  vector<double> bandwidths;
+  auto recordBandwidth = [&bandwidths]()
+  {
+    bandwidths.push_back(CLI::GetParam<GaussianKernel>("kernel").Bandwidth());
+  };
+
+  RunServer(recordBandwidth, requests);
+
+  BOOST_REQUIRE_EQUAL(bandwidths.size(), 4);
+  BOOST_REQUIRE_CLOSE(bandwidths[0], 0.5, 1e-5);
+  BOOST_REQUIRE_CLOSE(bandwidths[1], 2.0, 1e-5);
+  BOOST_REQUIRE_CLOSE(bandwidths[2], 2.0, 1e-5);
+  BOOST_REQUIRE_CLOSE(bandwidths[3], 0.5, 1e-5);
+
+  remove("kernel1.bin");
+  remove("kernel2.bin");
+}
+
 /**
  * Test that an exception is thrown when a required model is not specified.
  */
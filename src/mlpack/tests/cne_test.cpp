@@ -17,6 +17,7 @@
 #include <mlpack/methods/logistic_regression/logistic_regression.hpp>
 
 #include <mlpack/core/optimizers/cne/cne.hpp>
+#include <mlpack/core/optimizers/population_evaluator.hpp>
 
 #include <boost/test/unit_test.hpp>
 #include "test_tools.hpp"
@@ -196,4 +197,62 @@ BOOST_AUTO_TEST_CASE(VanillaNetworkWithCNETest)
   BOOST_REQUIRE_LE(classificationError, 0.1);
 }
 
+/**
+ * Make sure that the candidates of a network evaluated in parallel, on copies
+ * of the network, have the same objectives as when they are evaluated one
+ * after the other, and that the network itself is left untouched.
+ */
+BOOST_AUTO_TEST_CASE(CNEPopulationEvaluatorTest)
+{
+  BOOST_REQUIRE(!HasConstEvaluate<FFN<NegativeLogLikelihood<> > >::value);
+  BOOST_REQUIRE(HasConstEvaluate<LogisticRegressionFunction<> >::value);
+
+  arma::mat data = arma::randu<arma::mat>(10, 64);
+  arma::mat labels = arma::floor(3 * arma::randu<arma::mat>(1, 64)) + 1;
+
+  FFN<NegativeLogLikelihood<> > model(data, labels);
+  model.Add<Linear<> >(10, 20);
+  model.Add<SigmoidLayer<> >();
+  model.Add<Linear<> >(20, 3);
+  model.Add<LogSoftMax<> >();
+  model.ResetParameters();
+
+  arma::cube candidates(model.Parameters().n_rows, model.Parameters().n_cols,
+      16, arma::fill::randn);
+
+  // Evaluate the candidates on a copy, one after the other.
+  FFN<NegativeLogLikelihood<> > serialModel(model);
+  arma::vec objectives(candidates.n_slices);
+  for (size_t i = 0; i < candidates.n_slices; ++i)
+    objectives[i] = serialModel.Evaluate(candidates.slice(i));
+
+  const arma::mat parameters = model.Parameters();
+  PopulationEvaluator<FFN<NegativeLogLikelihood<> > > evaluator(model);
+  arma::vec parallelObjectives;
+  evaluator.Evaluate(candidates.n_slices, parallelObjectives,
+      [&](FFN<NegativeLogLikelihood<> >& network, const size_t i)
+      {
+        const arma::mat candidate(candidates.slice_memptr(i),
+            candidates.n_rows, candidates.n_cols, false, true);
+        return network.Evaluate(candidate);
+      });
+
+  BOOST_REQUIRE_EQUAL(parallelObjectives.n_elem, objectives.n_elem);
+  for (size_t i = 0; i < objectives.n_elem; ++i)
+    BOOST_REQUIRE_CLOSE(parallelObjectives[i], objectives[i], 1e-5);
+
+  // With several threads, the copies have their own parameters.
+  #ifdef HAS_OPENMP
+  if (omp_get_max_threads() > 1)
+    CheckMatrices(model.Parameters(), parameters);
+  #endif
+
+  // The last candidate is left in the parameters of the serial copy.
+  CheckMatrices(serialModel.Parameters(), candidates.slice(15));
+
+  // The layers of the copies have to use the parameters of the copies.
+  model.Parameters() = candidates.slice(0);
+  BOOST_REQUIRE_CLOSE(model.Evaluate(model.Parameters()), objectives[0], 1e-5);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -16,6 +16,7 @@
 #include <mlpack/methods/ann/convolution_rules/naive_convolution.hpp>
 #include <mlpack/methods/ann/convolution_rules/fft_convolution.hpp>
 #include <mlpack/methods/ann/convolution_rules/svd_convolution.hpp>
+#include <mlpack/methods/ann/convolution_rules/im2col_convolution.hpp>
 
 #include <boost/test/unit_test.hpp>
 #include "test_tools.hpp"
@@ -149,6 +150,10 @@ BOOST_AUTO_TEST_CASE(ValidConvolution2DTest)
   // speeded up the computation.
   Convolution2DMethodTest<SVDConvolution<ValidConvolution> >(input, filter,
       output);
+
+  // Perform the convolution through im2col and matrix multiplication.
+  Convolution2DMethodTest<Im2ColConvolution<ValidConvolution> >(input, filter,
+      output);
 }
 
 /**
@@ -186,6 +191,10 @@ BOOST_AUTO_TEST_CASE(FullConvolution2DTest)
   // speeded up the computation.
   Convolution2DMethodTest<SVDConvolution<FullConvolution> >(input, filter,
       output);
+
+  // Perform the convolution through im2col and matrix multiplication.
+  Convolution2DMethodTest<Im2ColConvolution<FullConvolution> >(input, filter,
+      output);
 }
 
 /**
@@ -231,6 +240,10 @@ BOOST_AUTO_TEST_CASE(ValidConvolution3DTest)
   // speeded up the computation.
   Convolution3DMethodTest<SVDConvolution<ValidConvolution> >(inputCube,
       filterCube, outputCube);
+
+  // Perform the convolution through im2col and matrix multiplication.
+  Convolution3DMethodTest<Im2ColConvolution<ValidConvolution> >(inputCube,
+      filterCube, outputCube);
 }
 
 /**
@@ -280,6 +293,10 @@ BOOST_AUTO_TEST_CASE(FullConvolution3DTest)
   // speeded up the computation.
   Convolution3DMethodTest<SVDConvolution<FullConvolution> >(inputCube,
       filterCube, outputCube);
+
+  // Perform the convolution through im2col and matrix multiplication.
+  Convolution3DMethodTest<Im2ColConvolution<FullConvolution> >(inputCube,
+      filterCube, outputCube);
 }
 
 /**
@@ -322,6 +339,10 @@ BOOST_AUTO_TEST_CASE(ValidConvolutionBatchTest)
   // speeded up the computation.
   ConvolutionMethodBatchTest<SVDConvolution<ValidConvolution> >(input,
       filterCube, outputCube);
+
+  // Perform the convolution through im2col and matrix multiplication.
+  ConvolutionMethodBatchTest<Im2ColConvolution<ValidConvolution> >(input,
+      filterCube, outputCube);
 }
 
 /**
@@ -368,6 +389,10 @@ BOOST_AUTO_TEST_CASE(FullConvolutionBatchTest)
   // speeded up the computation.
   ConvolutionMethodBatchTest<SVDConvolution<FullConvolution> >(input,
       filterCube, outputCube);
+
+  // Perform the convolution through im2col and matrix multiplication.
+  ConvolutionMethodBatchTest<Im2ColConvolution<FullConvolution> >(input,
+      filterCube, outputCube);
 }
 
 BOOST_AUTO_TEST_SUITE_END();
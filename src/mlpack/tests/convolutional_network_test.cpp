@@ -118,4 +118,32 @@ BOOST_AUTO_TEST_CASE(VanillaNetworkTest)
   BOOST_REQUIRE_LE(classificationError, 0.25);
 }
 
+/**
+ * Make sure that the convolution and pooling layers give the same results when
+ * a batch of points is predicted at once as when the points are predicted one
+ * at a time.
+ */
+BOOST_AUTO_TEST_CASE(BatchedPredictTest)
+{
+  FFN<NegativeLogLikelihood<>, RandomInitialization> model;
+
+  model.Add<Convolution<> >(1, 4, 3, 3, 1, 1, 1, 1, 10, 10);
+  model.Add<ReLULayer<> >();
+  model.Add<MaxPooling<> >(2, 2, 2, 2);
+  model.Add<Convolution<> >(4, 3, 2, 2);
+  model.Add<MeanPooling<> >(2, 2, 2, 2);
+  model.Add<Linear<> >(12, 2);
+  model.Add<LogSoftMax<> >();
+
+  arma::mat data = arma::randu<arma::mat>(100, 40);
+
+  arma::mat singlePredictions, predictions;
+  model.Predict(data, singlePredictions, 1);
+  model.Predict(data, predictions, 16);
+
+  BOOST_REQUIRE_EQUAL(predictions.n_rows, 2);
+  BOOST_REQUIRE_EQUAL(predictions.n_cols, 40);
+  CheckMatrices(singlePredictions, predictions);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
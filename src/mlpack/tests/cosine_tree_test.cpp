@@ -222,4 +222,29 @@ BOOST_AUTO_TEST_CASE(CosineTreeModifiedGramSchmidt)
   }
 }
 
+/**
+ * Checks that the matrix form of CosineTree::ModifiedGramSchmidt() gives a unit
+ * vector orthogonal to the basis, even when the centroid is almost in the span
+ * of the basis.
+ */
+BOOST_AUTO_TEST_CASE(CosineTreeModifiedGramSchmidtMatrixBasis)
+{
+  arma::mat data = arma::randu(100, 50);
+  CosineTree dummyTree(data, 1, 0.1);
+
+  // Make a random orthonormal basis of 20 vectors.
+  arma::mat basis, r;
+  arma::qr_econ(basis, r, arma::randu<arma::mat>(100, 20));
+
+  // The centroid is in the span of the basis, up to a small perturbation.
+  arma::vec centroid = basis * arma::randu<arma::vec>(20) +
+      1e-8 * arma::randu<arma::vec>(100);
+  arma::vec newBasisVector;
+  dummyTree.ModifiedGramSchmidt(basis, centroid, newBasisVector);
+
+  BOOST_REQUIRE_CLOSE(arma::norm(newBasisVector, 2), 1.0, 1e-5);
+  for (size_t i = 0; i < basis.n_cols; i++)
+    BOOST_REQUIRE_SMALL(arma::dot(basis.col(i), newBasisVector), 1e-5);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
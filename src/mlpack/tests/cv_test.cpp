@@ -15,6 +15,7 @@
 #include <mlpack/core/cv/metrics/accuracy.hpp>
 #include <mlpack/core/cv/metrics/f1.hpp>
 #include <mlpack/core/cv/metrics/mse.hpp>
+#include <mlpack/core/cv/metrics/multi_metric.hpp>
 #include <mlpack/core/cv/metrics/precision.hpp>
 #include <mlpack/core/cv/metrics/recall.hpp>
 #include <mlpack/core/cv/simple_cv.hpp>
@@ -122,6 +123,48 @@ BOOST_AUTO_TEST_CASE(MulticlassClassificationMetricsTest)
       macroaveragedF1, 1e-5);
 }
 
+/**
+ * Test that MultiMetric gives the same values as the metrics on their own.
+ */
+BOOST_AUTO_TEST_CASE(MultiMetricTest)
+{
+  // The same data as in MulticlassClassificationMetricsTest.
+  arma::mat data = arma::linspace<arma::rowvec>(1.0, 12.0, 12);
+  arma::Row<size_t> labels("0 1  0 1  2 2 1 2  3 3 3 3");
+  arma::Row<size_t> predictedLabels("0 0  1 1  2 2 2 2  3 3 3 3");
+  size_t numClasses = 4;
+
+  NaiveBayesClassifier<> nb(data, predictedLabels, numClasses);
+
+  typedef MultiMetric<Accuracy, Precision<Micro>, Precision<Macro>,
+      Recall<Macro>, F1<Macro>> Metrics;
+  arma::vec values = Metrics::EvaluateAll(nb, data, labels);
+
+  BOOST_REQUIRE_EQUAL(values.n_elem, 5);
+  BOOST_REQUIRE_CLOSE(values[0], Accuracy::Evaluate(nb, data, labels), 1e-5);
+  BOOST_REQUIRE_CLOSE(values[1], Precision<Micro>::Evaluate(nb, data, labels),
+      1e-5);
+  BOOST_REQUIRE_CLOSE(values[2], Precision<Macro>::Evaluate(nb, data, labels),
+      1e-5);
+  BOOST_REQUIRE_CLOSE(values[3], Recall<Macro>::Evaluate(nb, data, labels),
+      1e-5);
+  BOOST_REQUIRE_CLOSE(values[4], F1<Macro>::Evaluate(nb, data, labels), 1e-5);
+  BOOST_REQUIRE_CLOSE(Metrics::Evaluate(nb, data, labels), values[0], 1e-5);
+
+  // Binary metrics, with the positive class given.
+  arma::Row<size_t> binaryLabels("0 1 0 1 0 0 1 0 1 1 1 1");
+  arma::Row<size_t> binaryPredictions("0 0 1 1 0 0 0 0 1 1 1 1");
+  NaiveBayesClassifier<> binaryNB(data, binaryPredictions, 2);
+  arma::vec binaryValues = MultiMetric<Precision<Binary>, Recall<Binary>,
+      F1<Binary>>::EvaluateAll(binaryNB, data, binaryLabels);
+  BOOST_REQUIRE_CLOSE(binaryValues[0],
+      Precision<Binary>::Evaluate(binaryNB, data, binaryLabels), 1e-5);
+  BOOST_REQUIRE_CLOSE(binaryValues[1],
+      Recall<Binary>::Evaluate(binaryNB, data, binaryLabels), 1e-5);
+  BOOST_REQUIRE_CLOSE(binaryValues[2],
+      F1<Binary>::Evaluate(binaryNB, data, binaryLabels), 1e-5);
+}
+
 /**
  * Test the mean squared error.
  */
@@ -415,6 +458,52 @@ BOOST_AUTO_TEST_CASE(KFoldCVMSETest)
   cv.Model();
 }
 
+/**
+ * Test that k-fold cross-validation gives the same result when the folds are
+ * evaluated in parallel.
+ */
+BOOST_AUTO_TEST_CASE(KFoldCVParallelTest)
+{
+  arma::mat data = arma::randu<arma::mat>(3, 100);
+  arma::rowvec responses = arma::randu<arma::rowvec>(100);
+
+  KFoldCV<LinearRegression, MSE> cv(5, data, responses);
+  const double serialMSE = cv.Evaluate();
+
+  cv.Parallel() = true;
+  BOOST_REQUIRE_CLOSE(cv.Evaluate(), serialMSE, 1e-5);
+
+  // Bounding the number of folds trained at once doesn't change the result.
+  cv.NumThreads() = 2;
+  BOOST_REQUIRE_CLOSE(cv.Evaluate(), serialMSE, 1e-5);
+
+  // The model of the last fold should be accessible as well.
+  cv.Model();
+}
+
+/**
+ * Test that k-fold cross-validation stops after the first fold when the
+ * objective is already worse than the early stopping threshold.
+ */
+BOOST_AUTO_TEST_CASE(KFoldCVEarlyStopTest)
+{
+  arma::mat data("0 1 2 3 4 5 6 7");
+  arma::rowvec responses("0 3 2 5 4 7 6 9");
+
+  // The first fold is validated on the first two points.
+  LinearRegression lr(data.cols(2, 7), responses.cols(2, 7));
+  const double expectedMSE = MSE::Evaluate(lr, data.cols(0, 1),
+      responses.cols(0, 1));
+  BOOST_REQUIRE_GT(expectedMSE, 0.0);
+
+  KFoldCV<LinearRegression, MSE> cv(4, data, responses);
+  const double fullMSE = cv.Evaluate();
+
+  cv.EarlyStopThreshold() = 0.0;
+  BOOST_REQUIRE_CLOSE(cv.Evaluate(), expectedMSE, 1e-5);
+  BOOST_REQUIRE_GT(std::abs(fullMSE - expectedMSE), 1e-5);
+}
+
 /**
  * Test k-fold cross-validation with the Accuracy metric.
  */
@@ -440,6 +529,36 @@ BOOST_AUTO_TEST_CASE(KFoldCVAccuracyTest)
   cv.Model();
 }
 
+/**
+ * Test that k-fold cross-validation with a MultiMetric gives the values of
+ * every metric for each fold.
+ */
+BOOST_AUTO_TEST_CASE(KFoldCVMultiMetricTest)
+{
+  // The same data as in KFoldCVAccuracyTest.
+  arma::mat data("0 1 2 3 100 101 102 103 104 5");
+  arma::Row<size_t> labels("0 0 0 0 1 1 1 1 1 1");
+  size_t numClasses = 2;
+
+  KFoldCV<NaiveBayesClassifier<>, MultiMetric<Accuracy, Recall<Micro>>>
+      cv(10, data, labels, numClasses);
+
+  BOOST_REQUIRE_CLOSE(cv.Evaluate(), 0.9, 1e-5);
+  BOOST_REQUIRE_EQUAL(cv.FoldEvaluations().n_rows, 2);
+  BOOST_REQUIRE_EQUAL(cv.FoldEvaluations().n_cols, 10);
+  for (size_t i = 0; i < 10; ++i)
+  {
+    BOOST_REQUIRE_CLOSE(cv.FoldEvaluations()(0, i),
+        cv.FoldEvaluations()(1, i), 1e-5);
+  }
+
+  // A single metric gives one row.
+  KFoldCV<NaiveBayesClassifier<>, Accuracy> accuracyCV(10, data, labels,
+      numClasses);
+  accuracyCV.Evaluate();
+  BOOST_REQUIRE_EQUAL(accuracyCV.FoldEvaluations().n_rows, 1);
+}
+
 /**
  * Test k-fold cross-validation with weighted linear regression.
  */
@@ -0,0 +1,98 @@
+/**
+ * @file data_parallel_sgd_test.cpp
+ *
+ * Test file for synchronous data-parallel SGD.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/core/optimizers/data_parallel_sgd/data_parallel_sgd.hpp>
+#include <mlpack/core/optimizers/sgd/sgd.hpp>
+#include <mlpack/core/optimizers/sgd/update_policies/momentum_update.hpp>
+#include <mlpack/core/optimizers/sgd/test_function.hpp>
+#include <mlpack/methods/ann/ffn.hpp>
+#include <mlpack/methods/ann/init_rules/const_init.hpp>
+#include <mlpack/methods/ann/layer/layer.hpp>
+#include <mlpack/methods/logistic_regression/logistic_regression.hpp>
+
+#include <boost/test/unit_test.hpp>
+#include "test_tools.hpp"
+
+using namespace arma;
+using namespace mlpack;
+using namespace mlpack::ann;
+using namespace mlpack::optimization;
+using namespace mlpack::optimization::test;
+using namespace mlpack::regression;
+
+BOOST_AUTO_TEST_SUITE(DataParallelSGDTest);
+
+/**
+ * Make sure that data-parallel SGD finds the minimum of the SGD test function
+ * when each batch is split between the threads.
+ */
+BOOST_AUTO_TEST_CASE(SimpleDataParallelSGDTestFunction)
+{
+  SGDTestFunction f;
+  DataParallelSGD<> s(0.0003, 3, 5000000, 1e-9, true);
+
+  arma::mat coordinates = f.GetInitialPoint();
+  double result = s.Optimize(f, coordinates);
+
+  BOOST_REQUIRE_CLOSE(result, -1.0, 0.05);
+  BOOST_REQUIRE_SMALL(coordinates[0], 1e-3);
+  BOOST_REQUIRE_SMALL(coordinates[1], 1e-7);
+  BOOST_REQUIRE_SMALL(coordinates[2], 1e-7);
+}
+
+/**
+ * Make sure that the steps of data-parallel SGD are the steps of SGD with the
+ * same batch size, for a thread-safe function (LogisticRegressionFunction).
+ */
+BOOST_AUTO_TEST_CASE(DataParallelSGDLogisticRegressionTest)
+{
+  arma::mat data = arma::randn<arma::mat>(5, 2000);
+  arma::Row<size_t> responses(2000);
+  for (size_t i = 0; i < data.n_cols; ++i)
+    responses[i] = (arma::accu(data.col(i)) > 0) ? 1 : 0;
+
+  LogisticRegressionFunction<> lrf(data, responses, 0.5);
+
+  SGD<MomentumUpdate> sgd(0.01, 64, 5 * data.n_cols, 0, false);
+  DataParallelSGD<MomentumUpdate> dpsgd(0.01, 64, 5 * data.n_cols, 0, false);
+
+  arma::mat sgdCoordinates = lrf.GetInitialPoint();
+  arma::mat dpsgdCoordinates = lrf.GetInitialPoint();
+  const double sgdObjective = sgd.Optimize(lrf, sgdCoordinates);
+  const double dpsgdObjective = dpsgd.Optimize(lrf, dpsgdCoordinates);
+
+  BOOST_REQUIRE_CLOSE(dpsgdObjective, sgdObjective, 1e-5);
+  BOOST_REQUIRE_SMALL(arma::norm(dpsgdCoordinates - sgdCoordinates), 1e-8);
+}
+
+/**
+ * Make sure that a network, which is copied for each thread, takes the same
+ * steps with data-parallel SGD as with SGD.
+ */
+BOOST_AUTO_TEST_CASE(DataParallelSGDFFNTest)
+{
+  arma::mat data = arma::randu<arma::mat>(3, 512);
+  arma::mat responses = arma::sum(data) + 0.1 * arma::randn<arma::rowvec>(512);
+
+  FFN<MeanSquaredError<>, ConstInitialization> sgdModel(MeanSquaredError<>(),
+      ConstInitialization(0.1));
+  sgdModel.Add<Linear<>>(3, 1);
+  FFN<MeanSquaredError<>, ConstInitialization> dpsgdModel(sgdModel);
+
+  StandardSGD sgd(0.001, 32, 4 * data.n_cols, 0, false);
+  DataParallelSGD<> dpsgd(0.001, 32, 4 * data.n_cols, 0, false);
+  sgdModel.Train(data, responses, sgd);
+  dpsgdModel.Train(data, responses, dpsgd);
+
+  CheckMatrices(dpsgdModel.Parameters(), sgdModel.Parameters(), 1e-5);
+}
+
+BOOST_AUTO_TEST_SUITE_END();
@@ -271,4 +271,29 @@ BOOST_AUTO_TEST_CASE(GaussiansSingleModeTest)
   }
 }
 
+/**
+ * Make sure that searching the query points in blocks gives the same clusters
+ * as searching them all at once.
+ */
+BOOST_AUTO_TEST_CASE(BatchSizeTest)
+{
+  arma::mat points(2, 600);
+  points.cols(0, 199) = arma::randn<arma::mat>(2, 200);
+  points.cols(200, 399) = arma::randn<arma::mat>(2, 200) + 10.0;
+  points.cols(400, 599) = arma::randu<arma::mat>(2, 200) * 40.0 - 20.0;
+
+  DBSCAN<> d1(0.8, 5);
+  arma::Row<size_t> assignments1;
+  const size_t clusters1 = d1.Cluster(points, assignments1);
+
+  DBSCAN<> d2(0.8, 5);
+  d2.BatchSize() = 37;
+  arma::Row<size_t> assignments2;
+  const size_t clusters2 = d2.Cluster(points, assignments2);
+
+  BOOST_REQUIRE_EQUAL(clusters1, clusters2);
+  for (size_t i = 0; i < points.n_cols; ++i)
+    BOOST_REQUIRE_EQUAL(assignments1[i], assignments2[i]);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -11,8 +11,10 @@
  */
 #include <mlpack/core.hpp>
 #include <mlpack/methods/decision_tree/decision_tree.hpp>
+#include <mlpack/methods/decision_tree/flat_decision_forest.hpp>
 #include <mlpack/methods/decision_tree/information_gain.hpp>
 #include <mlpack/methods/decision_tree/gini_gain.hpp>
+#include <mlpack/methods/decision_tree/histogram_numeric_split.hpp>
 #include <mlpack/methods/decision_tree/random_dimension_select.hpp>
 #include <mlpack/methods/decision_tree/multiple_random_dimension_select.hpp>
 
@@ -21,6 +23,10 @@
 #include "serialization.hpp"
 #include "mock_categorical_data.hpp"
 
+#ifdef HAS_OPENMP
+  #include <omp.h>
+#endif
+
 using namespace mlpack;
 using namespace mlpack::tree;
 using namespace mlpack::distribution;
@@ -367,6 +373,74 @@ BOOST_AUTO_TEST_CASE(BestBinaryNumericSplitNoGainTest)
   BOOST_REQUIRE_EQUAL(classProbabilities.n_elem, 0);
 }
 
+/**
+ * Check that the HistogramNumericSplit finds the same split as the
+ * BestBinaryNumericSplit when there are few points.
+ */
+BOOST_AUTO_TEST_CASE(HistogramNumericSplitSimpleSplitTest)
+{
+  arma::vec values("0.0 0.1 0.2 0.3 0.4 0.5 0.6 0.7 0.8 0.9 1.0");
+  arma::Row<size_t> labels("0 0 0 0 0 1 1 1 1 1 1");
+  arma::rowvec weights(labels.n_elem);
+  weights.ones();
+
+  arma::vec classProbabilities;
+  HistogramNumericSplit<GiniGain>::template AuxiliarySplitInfo<double> aux;
+
+  // Call the method to do the splitting.
+  const double bestGain = GiniGain::Evaluate<false>(labels, 2, weights);
+  const double gain = HistogramNumericSplit<GiniGain>::SplitIfBetter<false>(
+      bestGain, values, labels, 2, weights, 3, classProbabilities, aux);
+  const double weightedGain =
+      HistogramNumericSplit<GiniGain>::SplitIfBetter<true>(bestGain, values,
+      labels, 2, weights, 3, classProbabilities, aux);
+
+  // The split is perfect, so we should be able to accomplish a gain of 0.
+  BOOST_REQUIRE_GT(gain, bestGain);
+  BOOST_REQUIRE_SMALL(gain, 1e-5);
+  BOOST_REQUIRE_SMALL(weightedGain, 1e-5);
+
+  BOOST_REQUIRE_EQUAL(classProbabilities.n_elem, 1);
+  BOOST_REQUIRE_GT(classProbabilities[0], 0.4);
+  BOOST_REQUIRE_LT(classProbabilities[0], 0.5);
+
+  // And it won't split if not enough points are given.
+  classProbabilities.clear();
+  const double noGain = HistogramNumericSplit<GiniGain>::SplitIfBetter<false>(
+      bestGain, values, labels, 2, weights, 8, classProbabilities, aux);
+  BOOST_REQUIRE_EQUAL(noGain, bestGain);
+  BOOST_REQUIRE_EQUAL(classProbabilities.n_elem, 0);
+}
+
+/**
+ * Check that the HistogramNumericSplit finds a split close to the best one when
+ * there are many more distinct values than bins.
+ */
+BOOST_AUTO_TEST_CASE(HistogramNumericSplitManyValuesTest)
+{
+  arma::vec values(20000);
+  arma::Row<size_t> labels(20000);
+  for (size_t i = 0; i < values.n_elem; ++i)
+  {
+    values[i] = math::Random();
+    labels[i] = (values[i] > 0.3) ? 1 : 0;
+  }
+  arma::rowvec weights;
+
+  arma::vec classProbabilities;
+  HistogramNumericSplit<InformationGain>::AuxiliarySplitInfo<double> aux;
+
+  const double bestGain = InformationGain::Evaluate<false>(labels, 2, weights);
+  const double gain =
+      HistogramNumericSplit<InformationGain>::SplitIfBetter<false>(bestGain,
+      values, labels, 2, weights, 10, classProbabilities, aux);
+
+  BOOST_REQUIRE_GT(gain, bestGain);
+  BOOST_REQUIRE_EQUAL(classProbabilities.n_elem, 1);
+  // About 1/256 of the points are in each bin.
+  BOOST_REQUIRE_SMALL(classProbabilities[0] - 0.3, 0.01);
+}
+
 /**
  * Check that the AllCategoricalSplit will split when the split is obviously
  * better.
@@ -661,6 +735,43 @@ BOOST_AUTO_TEST_CASE(SimpleGeneralizationTest)
   BOOST_REQUIRE_GT(wdcorrect, 0.75);
 }
 
+/**
+ * Make sure that a decision tree with the HistogramNumericSplit generalizes as
+ * well as one with the BestBinaryNumericSplit.
+ */
+BOOST_AUTO_TEST_CASE(HistogramGeneralizationTest)
+{
+  arma::mat inputData;
+  if (!data::Load("vc2.csv", inputData))
+    BOOST_FAIL("Cannot load test dataset vc2.csv!");
+
+  arma::Row<size_t> labels;
+  if (!data::Load("vc2_labels.txt", labels))
+    BOOST_FAIL("Cannot load labels for vc2_labels.txt");
+
+  DecisionTree<GiniGain, HistogramNumericSplit> d(inputData, labels, 3, 10);
+
+  arma::mat testData;
+  if (!data::Load("vc2_test.csv", testData))
+    BOOST_FAIL("Cannot load test dataset vc2_test.csv!");
+
+  arma::Mat<size_t> trueTestLabels;
+  if (!data::Load("vc2_test_labels.txt", trueTestLabels))
+    BOOST_FAIL("Cannot load labels for vc2_test_labels.txt");
+
+  arma::Row<size_t> predictions;
+  d.Classify(testData, predictions);
+  BOOST_REQUIRE_EQUAL(predictions.n_elem, testData.n_cols);
+
+  double correct = 0.0;
+  for (size_t i = 0; i < predictions.n_elem; ++i)
+    if (predictions[i] == trueTestLabels[i])
+      ++correct;
+  correct /= predictions.n_elem;
+
+  BOOST_REQUIRE_GT(correct, 0.75);
+}
+
 /**
  * Test that we can build a decision tree on a simple categorical dataset.
  */
@@ -1082,4 +1193,113 @@ BOOST_AUTO_TEST_CASE(ConstDataTest)
       constWeights);
 }
 
+/**
+ * Make sure that a tree trained in parallel is the same as one trained with one
+ * thread, on numeric and categorical data.
+ */
+BOOST_AUTO_TEST_CASE(ParallelTrainingTest)
+{
+  arma::mat data;
+  arma::Row<size_t> labels;
+  data::DatasetInfo datasetInfo;
+  MockCategoricalData(data, labels, datasetInfo);
+
+  DecisionTree<> tree(data, datasetInfo, labels, 5, 10);
+  DecisionTree<> numericTree(data, labels, 5, 10);
+
+#ifdef HAS_OPENMP
+  const int numThreads = omp_get_max_threads();
+  omp_set_num_threads(1);
+#endif
+
+  DecisionTree<> serialTree(data, datasetInfo, labels, 5, 10);
+  DecisionTree<> serialNumericTree(data, labels, 5, 10);
+
+#ifdef HAS_OPENMP
+  omp_set_num_threads(numThreads);
+#endif
+
+  arma::Row<size_t> predictions, serialPredictions;
+  arma::mat probabilities, serialProbabilities;
+  tree.Classify(data, predictions, probabilities);
+  serialTree.Classify(data, serialPredictions, serialProbabilities);
+  BOOST_REQUIRE_EQUAL(predictions.n_elem, serialPredictions.n_elem);
+  for (size_t i = 0; i < predictions.n_elem; ++i)
+    BOOST_REQUIRE_EQUAL(predictions[i], serialPredictions[i]);
+  CheckMatrices(probabilities, serialProbabilities);
+
+  numericTree.Classify(data, predictions, probabilities);
+  serialNumericTree.Classify(data, serialPredictions, serialProbabilities);
+  for (size_t i = 0; i < predictions.n_elem; ++i)
+    BOOST_REQUIRE_EQUAL(predictions[i], serialPredictions[i]);
+  CheckMatrices(probabilities, serialProbabilities);
+}
+
+/**
+ * A numeric split that has no SplitTraits specialization, so that
+ * FlatDecisionForest has to call CalculateDirection() on the original nodes.
+ */
+template<typename FitnessFunction>
+class PlainBinaryNumericSplit : public BestBinaryNumericSplit<FitnessFunction>
+{ };
+
+/**
+ * Make sure that the predictions of a flattened tree are the same as the ones
+ * of the tree.
+ */
+template<typename TreeType>
+void CheckFlatTree(const TreeType& tree, const arma::mat& data)
+{
+  FlatDecisionForest<TreeType> flatTree(tree);
+  BOOST_REQUIRE_EQUAL(flatTree.NumTrees(), 1);
+  BOOST_REQUIRE_EQUAL(flatTree.NumClasses(), tree.NumClasses());
+
+  arma::Row<size_t> predictions, flatPredictions;
+  arma::mat probabilities, flatProbabilities;
+  tree.Classify(data, predictions, probabilities);
+  flatTree.Classify(data, flatPredictions, flatProbabilities);
+
+  BOOST_REQUIRE_EQUAL(flatPredictions.n_elem, predictions.n_elem);
+  for (size_t i = 0; i < predictions.n_elem; ++i)
+  {
+    BOOST_REQUIRE_EQUAL(flatPredictions[i], predictions[i]);
+    BOOST_REQUIRE_EQUAL(flatTree.Classify(data.col(i)), predictions[i]);
+  }
+  CheckMatrices(flatProbabilities, probabilities);
+}
+
+/**
+ * Test that flattened trees give the same predictions as the trees, for each
+ * way a node can split.
+ */
+BOOST_AUTO_TEST_CASE(FlatDecisionTreeTest)
+{
+  arma::mat data;
+  arma::Row<size_t> labels;
+  data::DatasetInfo datasetInfo;
+  MockCategoricalData(data, labels, datasetInfo);
+
+  // Split with thresholds and categories.
+  DecisionTree<> tree(data, datasetInfo, labels, 5, 10);
+  CheckFlatTree(tree, data);
+
+  // Split with thresholds only.
+  DecisionTree<> numericTree(data, labels, 5, 10);
+  CheckFlatTree(numericTree, data);
+
+  // The histogram split is also a threshold.
+  DecisionTree<GiniGain, HistogramNumericSplit> histogramTree(data,
+      datasetInfo, labels, 5, 10);
+  CheckFlatTree(histogramTree, data);
+
+  // Call CalculateDirection() on the original nodes.
+  DecisionTree<GiniGain, PlainBinaryNumericSplit> plainTree(data, datasetInfo,
+      labels, 5, 10);
+  CheckFlatTree(plainTree, data);
+
+  // A tree that is only a leaf.
+  DecisionTree<> leaf(data, labels, 5, 10000);
+  CheckFlatTree(leaf, data);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
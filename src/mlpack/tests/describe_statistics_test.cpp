@@ -0,0 +1,146 @@
+/**
+ * @file describe_statistics_test.cpp
+ *
+ * Test the DescribeStatistics class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/core/data/describe_statistics.hpp>
+
+#include <boost/test/unit_test.hpp>
+#include "test_tools.hpp"
+
+using namespace mlpack;
+using namespace mlpack::data;
+
+BOOST_AUTO_TEST_SUITE(DescribeStatisticsTest);
+
+/**
+ * Compute the sum of the given powers of the deviations of each row from its
+ * mean, directly.
+ */
+arma::vec SumPowerDeviations(const arma::mat& data, const double power)
+{
+  const arma::vec means = arma::mean(data, 1);
+  arma::vec sums(data.n_rows);
+  for (size_t i = 0; i < data.n_rows; ++i)
+    sums[i] = arma::accu(arma::pow(data.row(i) - means[i], power));
+
+  return sums;
+}
+
+/**
+ * Make sure the one-pass statistics match the ones computed directly, for a
+ * sample and for a population.
+ */
+BOOST_AUTO_TEST_CASE(DescribeStatisticsMomentsTest)
+{
+  arma::mat data = arma::randn<arma::mat>(3, 1000);
+  data.row(1) = arma::exp(data.row(1));
+  data.row(2) += 1e6;
+
+  DescribeStatistics statistics;
+  statistics.Update(data);
+
+  BOOST_REQUIRE_EQUAL(statistics.Dimensionality(), 3);
+  BOOST_REQUIRE_EQUAL(statistics.Count(), 1000);
+
+  const double n = data.n_cols;
+  const arma::vec m2 = SumPowerDeviations(data, 2);
+  const arma::vec m3 = SumPowerDeviations(data, 3);
+  const arma::vec m4 = SumPowerDeviations(data, 4);
+  const arma::vec mean = arma::mean(data, 1);
+  const arma::vec min = arma::min(data, 1);
+  const arma::vec max = arma::max(data, 1);
+  const arma::vec sampleStd = arma::stddev(data, 0, 1);
+  const arma::vec populationStd = arma::stddev(data, 1, 1);
+
+  const arma::vec variance = statistics.Variance();
+  const arma::vec populationVariance = statistics.Variance(true);
+  const arma::vec skewness = statistics.Skewness();
+  const arma::vec populationSkewness = statistics.Skewness(true);
+  const arma::vec kurtosis = statistics.Kurtosis();
+  const arma::vec populationKurtosis = statistics.Kurtosis(true);
+  for (size_t i = 0; i < data.n_rows; ++i)
+  {
+    BOOST_REQUIRE_CLOSE(statistics.Mean()[i], mean[i], 1e-8);
+    BOOST_REQUIRE_EQUAL(statistics.Min()[i], min[i]);
+    BOOST_REQUIRE_EQUAL(statistics.Max()[i], max[i]);
+    BOOST_REQUIRE_CLOSE(variance[i], m2[i] / (n - 1), 1e-6);
+    BOOST_REQUIRE_CLOSE(populationVariance[i], m2[i] / n, 1e-6);
+
+    BOOST_REQUIRE_CLOSE(skewness[i], n * m3[i] / ((n - 1) * (n - 2) *
+        std::pow(sampleStd[i], 3)), 1e-4);
+    BOOST_REQUIRE_CLOSE(populationSkewness[i], m3[i] / (n *
+        std::pow(populationStd[i], 3)), 1e-4);
+
+    const double norm3 = (3 * (n - 1) * (n - 1)) / ((n - 2) * (n - 3));
+    const double normC = (n * (n + 1)) / ((n - 1) * (n - 2) * (n - 3));
+    BOOST_REQUIRE_CLOSE(kurtosis[i], normC * m4[i] /
+        std::pow(sampleStd[i], 4) - norm3, 1e-4);
+    BOOST_REQUIRE_CLOSE(populationKurtosis[i], n * m4[i] /
+        std::pow(m2[i], 2) - 3, 1e-4);
+  }
+}
+
+/**
+ * Make sure that statistics updated a chunk at a time, or merged from separate
+ * statistics, are the statistics of all the points.
+ */
+BOOST_AUTO_TEST_CASE(DescribeStatisticsChunksTest)
+{
+  arma::mat data = arma::randu<arma::mat>(4, 700);
+
+  DescribeStatistics all;
+  all.Update(data);
+
+  DescribeStatistics chunks;
+  DescribeStatistics first, second;
+  for (size_t i = 0; i < data.n_cols; i += 100)
+  {
+    const arma::mat chunk = data.cols(i, i + 99);
+    chunks.Update(chunk);
+    if (i < 300)
+      first.Update(chunk);
+    else
+      second.Update(chunk);
+  }
+  first.Merge(second);
+
+  BOOST_REQUIRE_EQUAL(chunks.Count(), 700);
+  BOOST_REQUIRE_EQUAL(first.Count(), 700);
+  const arma::vec variance = all.Variance();
+  const arma::vec skewness = all.Skewness();
+  const arma::vec kurtosis = all.Kurtosis();
+  for (const DescribeStatistics* statistics : { &chunks, &first })
+  {
+    const arma::vec otherVariance = statistics->Variance();
+    const arma::vec otherSkewness = statistics->Skewness();
+    const arma::vec otherKurtosis = statistics->Kurtosis();
+    for (size_t i = 0; i < data.n_rows; ++i)
+    {
+      BOOST_REQUIRE_CLOSE(statistics->Mean()[i], all.Mean()[i], 1e-8);
+      BOOST_REQUIRE_EQUAL(statistics->Min()[i], all.Min()[i]);
+      BOOST_REQUIRE_EQUAL(statistics->Max()[i], all.Max()[i]);
+      BOOST_REQUIRE_CLOSE(otherVariance[i], variance[i], 1e-8);
+      BOOST_REQUIRE_CLOSE(otherSkewness[i], skewness[i], 1e-6);
+      BOOST_REQUIRE_CLOSE(otherKurtosis[i], kurtosis[i], 1e-6);
+    }
+  }
+}
+
+/**
+ * Make sure points of the wrong dimensionality are rejected.
+ */
+BOOST_AUTO_TEST_CASE(DescribeStatisticsDimensionalityTest)
+{
+  DescribeStatistics statistics(3);
+  BOOST_REQUIRE_THROW(statistics.Update(arma::mat(4, 10)),
+      std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_SUITE_END();
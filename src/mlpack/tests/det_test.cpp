@@ -778,4 +778,48 @@ BOOST_AUTO_TEST_CASE(MoveOperatorTest)
   BOOST_REQUIRE_CLOSE(testDTree2.Right()->SplitValue(), 0.5, 1e-5);
 }
 
+/**
+ * Make sure that the trees of a dense matrix (whose values are sorted once
+ * before growing the tree) and of the same matrix as a sparse matrix (whose
+ * values are sorted in each node) are the same.  The dataset is large enough
+ * for the children to be grown in parallel.
+ */
+template<typename TreeTypeA, typename TreeTypeB>
+void CheckSameTrees(const TreeTypeA& a, const TreeTypeB& b)
+{
+  BOOST_REQUIRE_EQUAL(a.Start(), b.Start());
+  BOOST_REQUIRE_EQUAL(a.End(), b.End());
+  BOOST_REQUIRE_EQUAL(a.SubtreeLeaves(), b.SubtreeLeaves());
+  BOOST_REQUIRE_EQUAL(a.NumChildren(), b.NumChildren());
+  if (a.NumChildren() == 0)
+    return;
+
+  BOOST_REQUIRE_EQUAL(a.SplitDim(), b.SplitDim());
+  BOOST_REQUIRE_CLOSE(a.SplitValue(), b.SplitValue(), 1e-5);
+  CheckSameTrees(*a.Left(), *b.Left());
+  CheckSameTrees(*a.Right(), *b.Right());
+}
+
+BOOST_AUTO_TEST_CASE(DenseSparseGrowTest)
+{
+  arma::mat denseData = arma::randu<arma::mat>(4, 3000) + 1.0;
+  arma::sp_mat sparseData(denseData);
+
+  arma::Col<size_t> denseOldFromNew = arma::linspace<arma::Col<size_t>>(0,
+      2999, 3000);
+  arma::Col<size_t> sparseOldFromNew(denseOldFromNew);
+
+  DTree<arma::mat> denseTree(denseData);
+  DTree<arma::sp_mat> sparseTree(sparseData);
+  const double denseAlpha = denseTree.Grow(denseData, denseOldFromNew, false,
+      10, 5);
+  const double sparseAlpha = sparseTree.Grow(sparseData, sparseOldFromNew,
+      false, 10, 5);
+
+  BOOST_REQUIRE_CLOSE(denseAlpha, sparseAlpha, 1e-5);
+  CheckSameTrees(denseTree, sparseTree);
+  for (size_t i = 0; i < denseOldFromNew.n_elem; ++i)
+    BOOST_REQUIRE_EQUAL(denseOldFromNew[i], sparseOldFromNew[i]);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
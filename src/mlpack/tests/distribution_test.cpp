@@ -5,6 +5,7 @@
  *
  * Tests for the classes:
  *  * mlpack::distribution::DiscreteDistribution
+ *  * mlpack::distribution::SparseDiscreteDistribution
  *  * mlpack::distribution::GaussianDistribution
  *  * mlpack::distribution::GammaDistribution
  *
@@ -188,6 +189,77 @@ BOOST_AUTO_TEST_CASE(MultiDiscreteDistributionTrainProTest)
   BOOST_REQUIRE_CLOSE(d.Probability("2 1 0"), 0.015625, 1e-5);
 }
 
+/**
+ * Make sure the sparse discrete distribution estimates the probabilities of
+ * the observations it saw, and spreads the smoothing over all of them.
+ */
+BOOST_AUTO_TEST_CASE(SparseDiscreteDistributionTrainTest)
+{
+  SparseDiscreteDistribution d(1000000, 0.01);
+
+  // Before training, all the observations are equally likely.
+  BOOST_REQUIRE_CLOSE(d.Probability("12345"), 1e-6, 1e-5);
+
+  arma::mat obs("3 3 7 999999 3 7");
+  arma::vec prob("1 1 1 2 1 2");
+  d.Train(obs, prob);
+
+  BOOST_REQUIRE_EQUAL(d.Probabilities().n_nonzero, 3);
+  BOOST_REQUIRE_CLOSE(d.Probability("3"), 0.99 * 3.0 / 8.0 + 1e-8, 1e-5);
+  BOOST_REQUIRE_CLOSE(d.Probability("7"), 0.99 * 3.0 / 8.0 + 1e-8, 1e-5);
+  BOOST_REQUIRE_CLOSE(d.Probability("999999"), 0.99 * 2.0 / 8.0 + 1e-8,
+      1e-5);
+  BOOST_REQUIRE_CLOSE(d.Probability("4"), 1e-8, 1e-5);
+
+  // The batch log probabilities are the same.
+  arma::mat queries("3 4 7 999999 0");
+  arma::vec logProbs;
+  d.LogProbability(queries, logProbs);
+  BOOST_REQUIRE_EQUAL(logProbs.n_elem, 5);
+  for (size_t i = 0; i < queries.n_cols; ++i)
+  {
+    BOOST_REQUIRE_CLOSE(logProbs[i],
+        std::log(d.Probability(arma::vec(queries.col(i)))), 1e-5);
+  }
+
+  // Keeping only the two most likely observations renormalizes them.
+  d.MaxEntries() = 2;
+  d.Train(obs, prob);
+  BOOST_REQUIRE_EQUAL(d.Probabilities().n_nonzero, 2);
+  BOOST_REQUIRE_CLOSE(d.Probability("3"), 0.99 * 0.5 + 1e-8, 1e-5);
+  BOOST_REQUIRE_CLOSE(d.Probability("7"), 0.99 * 0.5 + 1e-8, 1e-5);
+  BOOST_REQUIRE_CLOSE(d.Probability("999999"), 1e-8, 1e-5);
+}
+
+/**
+ * Make sure random observations of the sparse discrete distribution follow
+ * its probabilities.
+ */
+BOOST_AUTO_TEST_CASE(SparseDiscreteDistributionRandomTest)
+{
+  SparseDiscreteDistribution d(100000, 0.0);
+  d.Train(arma::mat("10 10 10 500 99999"));
+
+  arma::vec counts(3, arma::fill::zeros);
+  for (size_t i = 0; i < 10000; ++i)
+  {
+    const size_t obs = (size_t) (d.Random()[0] + 0.5);
+    if (obs == 10)
+      ++counts[0];
+    else if (obs == 500)
+      ++counts[1];
+    else
+    {
+      BOOST_REQUIRE_EQUAL(obs, 99999);
+      ++counts[2];
+    }
+  }
+
+  BOOST_REQUIRE_CLOSE(counts[0] / 10000, 0.6, 5.0);
+  BOOST_REQUIRE_CLOSE(counts[1] / 10000, 0.2, 10.0);
+  BOOST_REQUIRE_CLOSE(counts[2] / 10000, 0.2, 10.0);
+}
+
 /*********************************/
 /** Gaussian Distribution Tests **/
 /*********************************/
@@ -393,6 +465,25 @@ BOOST_AUTO_TEST_CASE(GaussianMultipointMultivariateProbabilityTest)
   BOOST_REQUIRE_CLOSE(phis(5), -14.900192463287908, 1e-5);
 }
 
+/**
+ * Test the batch LogProbability() of a Gaussian with diagonal covariance
+ * against the single-point LogProbability().
+ */
+BOOST_AUTO_TEST_CASE(GaussianMultipointDiagonalProbabilityTest)
+{
+  GaussianDistribution g(arma::vec("5 6 3 3 2"),
+      arma::diagmat(arma::vec("6 7 4 7 6")));
+
+  arma::mat points = arma::randu<arma::mat>(5, 20) * 10.0;
+
+  arma::vec phis;
+  g.LogProbability(points, phis);
+
+  BOOST_REQUIRE_EQUAL(phis.n_elem, 20);
+  for (size_t i = 0; i < points.n_cols; ++i)
+    BOOST_REQUIRE_CLOSE(phis(i), g.LogProbability(points.col(i)), 1e-5);
+}
+
 /**
  * Make sure random observations follow the probability distribution correctly.
  */
@@ -423,6 +514,37 @@ BOOST_AUTO_TEST_CASE(GaussianDistributionRandomTest)
   BOOST_REQUIRE_CLOSE(obsCov(1, 1), cov(1, 1), 10.0);
 }
 
+/**
+ * Make sure random observations generated all at once follow the probability
+ * distribution correctly.
+ */
+BOOST_AUTO_TEST_CASE(GaussianDistributionBatchRandomTest)
+{
+  arma::vec mean("1.0 2.25");
+  arma::mat cov("0.85 0.60;"
+                "0.60 1.45");
+
+  GaussianDistribution d(mean, cov);
+
+  arma::mat obs;
+  d.Random(5000, obs);
+  BOOST_REQUIRE_EQUAL(obs.n_rows, 2);
+  BOOST_REQUIRE_EQUAL(obs.n_cols, 5000);
+
+  // Now make sure that reflects the actual distribution.
+  arma::vec obsMean = arma::mean(obs, 1);
+  arma::mat obsCov = ccov(obs);
+
+  // 10% tolerance because this can be noisy.
+  BOOST_REQUIRE_CLOSE(obsMean[0], mean[0], 10.0);
+  BOOST_REQUIRE_CLOSE(obsMean[1], mean[1], 10.0);
+
+  BOOST_REQUIRE_CLOSE(obsCov(0, 0), cov(0, 0), 10.0);
+  BOOST_REQUIRE_CLOSE(obsCov(0, 1), cov(0, 1), 10.0);
+  BOOST_REQUIRE_CLOSE(obsCov(1, 0), cov(1, 0), 10.0);
+  BOOST_REQUIRE_CLOSE(obsCov(1, 1), cov(1, 1), 10.0);
+}
+
 /**
  * Make sure that we can properly estimate from given observations.
  */
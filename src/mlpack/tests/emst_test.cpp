@@ -10,6 +10,8 @@
  */
 #include <mlpack/core.hpp>
 #include <mlpack/methods/emst/dtb.hpp>
+#include <mlpack/methods/emst/union_find.hpp>
+#include <mlpack/methods/emst/single_linkage.hpp>
 #include <boost/test/unit_test.hpp>
 #include "test_tools.hpp"
 
@@ -278,4 +280,141 @@ BOOST_AUTO_TEST_CASE(BallTreeTest)
   }
 }
 
+/**
+ * Make sure that a dataset with many equal distances (a grid) gives a spanning
+ * tree of the right length, since the components of one round may then be
+ * joined in any order.
+ */
+BOOST_AUTO_TEST_CASE(GridTiesTest)
+{
+  arma::mat inputData(2, 400);
+  for (size_t i = 0; i < 20; ++i)
+  {
+    for (size_t j = 0; j < 20; ++j)
+    {
+      inputData(0, 20 * i + j) = i;
+      inputData(1, 20 * i + j) = j;
+    }
+  }
+
+  DualTreeBoruvka<> dtb(inputData);
+  DualTreeBoruvka<> naive(inputData, true);
+
+  arma::mat dualResults;
+  arma::mat naiveResults;
+  dtb.ComputeMST(dualResults);
+  naive.ComputeMST(naiveResults);
+
+  BOOST_REQUIRE_EQUAL(dualResults.n_cols, 399);
+  BOOST_REQUIRE_EQUAL(naiveResults.n_cols, 399);
+  BOOST_REQUIRE_CLOSE(arma::accu(dualResults.row(2)), 399.0, 1e-5);
+  BOOST_REQUIRE_CLOSE(arma::accu(naiveResults.row(2)), 399.0, 1e-5);
+
+  // The edges must connect all the points.
+  UnionFind uf(400);
+  for (size_t i = 0; i < dualResults.n_cols; ++i)
+    uf.Union((size_t) dualResults(0, i), (size_t) dualResults(1, i));
+  for (size_t i = 1; i < 400; ++i)
+    BOOST_REQUIRE_EQUAL(uf.Find(i), uf.Find(0));
+}
+
+/**
+ * Check the single-linkage dendrogram of a small hand-made spanning tree, of
+ * the points 0, 1, 3, 10, 11, and 13 on a line.  The edges are given out of
+ * order.
+ */
+BOOST_AUTO_TEST_CASE(SingleLinkageDendrogramTest)
+{
+  arma::mat mst("2 0 4 1 3;"
+                "3 1 5 2 4;"
+                "7 1 2 2 1");
+
+  arma::mat dendrogram;
+  SingleLinkage::Dendrogram(mst, dendrogram);
+
+  arma::mat expected("0 3 5 2 8;"
+                     "1 4 7 6 9;"
+                     "1 1 2 2 7;"
+                     "2 2 3 3 6");
+
+  BOOST_REQUIRE_EQUAL(dendrogram.n_rows, 4);
+  BOOST_REQUIRE_EQUAL(dendrogram.n_cols, 5);
+  for (size_t i = 0; i < dendrogram.n_elem; ++i)
+    BOOST_REQUIRE_CLOSE(dendrogram[i], expected[i], 1e-5);
+}
+
+/**
+ * Check the condensed tree of the same spanning tree for two minimum cluster
+ * sizes.
+ */
+BOOST_AUTO_TEST_CASE(SingleLinkageCondensedTreeTest)
+{
+  arma::mat mst("2 0 4 1 3;"
+                "3 1 5 2 4;"
+                "7 1 2 2 1");
+
+  arma::mat dendrogram;
+  SingleLinkage::Dendrogram(mst, dendrogram);
+
+  // With a minimum size of 3, the root (6) splits into two clusters, and then
+  // the points of each fall out at distance 2.
+  arma::mat condensedTree;
+  SingleLinkage::CondensedTree(dendrogram, 3, condensedTree);
+  BOOST_REQUIRE_EQUAL(condensedTree.n_rows, 4);
+  BOOST_REQUIRE_EQUAL(condensedTree.n_cols, 8);
+
+  arma::vec parents(6), lambdas(6);
+  for (size_t i = 0; i < condensedTree.n_cols; ++i)
+  {
+    if (condensedTree(1, i) < 6)
+    {
+      const size_t point = (size_t) condensedTree(1, i);
+      parents[point] = condensedTree(0, i);
+      lambdas[point] = condensedTree(2, i);
+      BOOST_REQUIRE_EQUAL(condensedTree(3, i), 1);
+    }
+    else
+    {
+      BOOST_REQUIRE_EQUAL(condensedTree(0, i), 6);
+      BOOST_REQUIRE_CLOSE(condensedTree(2, i), 1.0 / 7.0, 1e-5);
+      BOOST_REQUIRE_EQUAL(condensedTree(3, i), 3);
+    }
+  }
+
+  for (size_t i = 0; i < 6; ++i)
+    BOOST_REQUIRE_CLOSE(lambdas[i], 0.5, 1e-5);
+  BOOST_REQUIRE_EQUAL(parents[0], parents[1]);
+  BOOST_REQUIRE_EQUAL(parents[0], parents[2]);
+  BOOST_REQUIRE_EQUAL(parents[3], parents[4]);
+  BOOST_REQUIRE_EQUAL(parents[3], parents[5]);
+  BOOST_REQUIRE_NE(parents[0], parents[3]);
+
+  // With a minimum size of 2, the points 2 and 5 fall out first, and the pairs
+  // (0, 1) and (3, 4) go on until distance 1.
+  SingleLinkage::CondensedTree(dendrogram, 2, condensedTree);
+  BOOST_REQUIRE_EQUAL(condensedTree.n_cols, 8);
+  for (size_t i = 0; i < condensedTree.n_cols; ++i)
+  {
+    if (condensedTree(1, i) < 6)
+    {
+      const size_t point = (size_t) condensedTree(1, i);
+      parents[point] = condensedTree(0, i);
+      lambdas[point] = condensedTree(2, i);
+    }
+  }
+
+  BOOST_REQUIRE_CLOSE(lambdas[0], 1.0, 1e-5);
+  BOOST_REQUIRE_CLOSE(lambdas[1], 1.0, 1e-5);
+  BOOST_REQUIRE_CLOSE(lambdas[2], 0.5, 1e-5);
+  BOOST_REQUIRE_CLOSE(lambdas[3], 1.0, 1e-5);
+  BOOST_REQUIRE_CLOSE(lambdas[4], 1.0, 1e-5);
+  BOOST_REQUIRE_CLOSE(lambdas[5], 0.5, 1e-5);
+  BOOST_REQUIRE_EQUAL(parents[0], parents[2]);
+  BOOST_REQUIRE_EQUAL(parents[3], parents[5]);
+
+  // A minimum size of 1 doesn't make sense.
+  BOOST_REQUIRE_THROW(SingleLinkage::CondensedTree(dendrogram, 1,
+      condensedTree), std::invalid_argument);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
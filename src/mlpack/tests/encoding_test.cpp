@@ -0,0 +1,156 @@
+/**
+ * @file encoding_test.cpp
+ *
+ * Test OneHotEncoding() and the FeatureHasher class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/core/data/one_hot_encoding.hpp>
+#include <mlpack/core/data/feature_hasher.hpp>
+
+#include <boost/test/unit_test.hpp>
+#include "test_tools.hpp"
+
+using namespace mlpack;
+using namespace mlpack::data;
+
+BOOST_AUTO_TEST_SUITE(EncodingTest);
+
+/**
+ * Create a dataset with a numeric dimension between two categorical ones, the
+ * first with categories "a", "b" and "c" and the second with "x" and "y".
+ */
+void CreateCategoricalData(arma::mat& data, DatasetInfo& info)
+{
+  const char* first[] = { "a", "b", "c", "a", "c", "b", "a" };
+  const char* second[] = { "x", "x", "y", "y", "x", "y", "x" };
+  const double numeric[] = { 1.5, 0.0, -2.0, 3.0, 0.0, 4.0, 5.0 };
+
+  info = DatasetInfo(3);
+  data.set_size(3, 7);
+  for (size_t i = 0; i < data.n_cols; ++i)
+  {
+    data(0, i) = info.MapString<double>(first[i], 0);
+    data(1, i) = numeric[i];
+    data(2, i) = info.MapString<double>(second[i], 2);
+  }
+}
+
+/**
+ * Make sure the one-hot encoding of a dataset is the dense encoding computed
+ * directly.
+ */
+BOOST_AUTO_TEST_CASE(OneHotEncodingTest)
+{
+  arma::mat data;
+  DatasetInfo info;
+  CreateCategoricalData(data, info);
+
+  arma::sp_mat output;
+  OneHotEncoding(data, info, output);
+
+  BOOST_REQUIRE_EQUAL(output.n_rows, 6);
+  BOOST_REQUIRE_EQUAL(output.n_cols, 7);
+
+  arma::mat expected(6, 7, arma::fill::zeros);
+  for (size_t i = 0; i < data.n_cols; ++i)
+  {
+    expected((size_t) data(0, i), i) = 1.0;
+    expected(3, i) = data(1, i);
+    expected(4 + (size_t) data(2, i), i) = 1.0;
+  }
+
+  // The zero numeric values are not stored.
+  BOOST_REQUIRE_EQUAL(output.n_nonzero, 7 * 3 - 2);
+  const arma::mat dense(output);
+  for (size_t i = 0; i < expected.n_elem; ++i)
+    BOOST_REQUIRE_EQUAL(dense[i], expected[i]);
+}
+
+/**
+ * Make sure that an unmapped categorical value is rejected.
+ */
+BOOST_AUTO_TEST_CASE(OneHotEncodingInvalidTest)
+{
+  arma::mat data;
+  DatasetInfo info;
+  CreateCategoricalData(data, info);
+  data(0, 3) = 3.0;
+
+  arma::sp_mat output;
+  BOOST_REQUIRE_THROW(OneHotEncoding(data, info, output),
+      std::invalid_argument);
+}
+
+/**
+ * Make sure the hashed encoding sums the signed values hashed to each output
+ * dimension.
+ */
+BOOST_AUTO_TEST_CASE(FeatureHasherTest)
+{
+  arma::mat data;
+  DatasetInfo info;
+  CreateCategoricalData(data, info);
+
+  // With few features, there are collisions.
+  for (const size_t numFeatures : { 3, 1000 })
+  {
+    FeatureHasher hasher(numFeatures);
+    arma::sp_mat output;
+    hasher.Transform(data, info, output);
+
+    BOOST_REQUIRE_EQUAL(output.n_rows, numFeatures);
+    BOOST_REQUIRE_EQUAL(output.n_cols, 7);
+
+    arma::mat expected(numFeatures, 7, arma::fill::zeros);
+    for (size_t i = 0; i < data.n_cols; ++i)
+    {
+      double sign;
+      size_t row = hasher.Hash(0, info.UnmapString(data(0, i), 0), sign);
+      expected(row, i) += sign;
+      row = hasher.Hash(1, "", sign);
+      expected(row, i) += sign * data(1, i);
+      row = hasher.Hash(2, info.UnmapString(data(2, i), 2), sign);
+      expected(row, i) += sign;
+    }
+
+    const arma::mat dense(output);
+    for (size_t i = 0; i < expected.n_elem; ++i)
+      BOOST_REQUIRE_SMALL(dense[i] - expected[i], 1e-12);
+    BOOST_REQUIRE_EQUAL(output.n_nonzero, arma::accu(expected != 0.0));
+  }
+}
+
+/**
+ * Make sure that a category is hashed the same way whatever its mapped value,
+ * and that the signs can be disabled.
+ */
+BOOST_AUTO_TEST_CASE(FeatureHasherConsistencyTest)
+{
+  DatasetInfo first(1), second(1);
+  arma::mat firstData(1, 2), secondData(1, 2);
+  firstData(0, 0) = first.MapString<double>("red", 0);
+  firstData(0, 1) = first.MapString<double>("blue", 0);
+  secondData(0, 0) = second.MapString<double>("blue", 0);
+  secondData(0, 1) = second.MapString<double>("red", 0);
+
+  FeatureHasher hasher(100, false);
+  arma::sp_mat firstOutput, secondOutput;
+  hasher.Transform(firstData, first, firstOutput);
+  hasher.Transform(secondData, second, secondOutput);
+
+  const arma::mat firstDense(firstOutput);
+  const arma::mat secondDense(secondOutput);
+  for (size_t r = 0; r < 100; ++r)
+  {
+    BOOST_REQUIRE_EQUAL(firstDense(r, 0), secondDense(r, 1));
+    BOOST_REQUIRE_EQUAL(firstDense(r, 1), secondDense(r, 0));
+  }
+  BOOST_REQUIRE_EQUAL(arma::accu(firstDense), 2.0);
+}
+
+BOOST_AUTO_TEST_SUITE_END();
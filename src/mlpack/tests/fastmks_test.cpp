@@ -1082,4 +1082,103 @@ BOOST_AUTO_TEST_CASE(CopyAssignmentTest)
   }
 }
 
+/**
+ * Make sure parallel dual-tree search gives the same results as serial
+ * dual-tree search, also when the trees are reused for a second search.
+ */
+BOOST_AUTO_TEST_CASE(ParallelDualTreeVsSerial)
+{
+  arma::mat data;
+  data.randu(8, 3000);
+  arma::mat queries;
+  queries.randu(8, 1000);
+  PolynomialKernel pk(3.0, 1.5);
+
+  FastMKS<PolynomialKernel> serial(data, pk);
+  FastMKS<PolynomialKernel> parallel(data, pk);
+  parallel.Parallel() = true;
+
+  for (size_t trial = 0; trial < 2; ++trial)
+  {
+    arma::Mat<size_t> serialIndices, parallelIndices;
+    arma::mat serialKernels, parallelKernels;
+    if (trial == 0)
+    {
+      serial.Search(5, serialIndices, serialKernels);
+      parallel.Search(5, parallelIndices, parallelKernels);
+    }
+    else
+    {
+      serial.Search(queries, 5, serialIndices, serialKernels);
+      parallel.Search(queries, 5, parallelIndices, parallelKernels);
+    }
+
+    BOOST_REQUIRE_EQUAL(parallelIndices.n_cols, serialIndices.n_cols);
+    for (size_t i = 0; i < serialIndices.n_elem; ++i)
+    {
+      BOOST_REQUIRE_EQUAL(parallelIndices[i], serialIndices[i]);
+      BOOST_REQUIRE_CLOSE(parallelKernels[i], serialKernels[i], 1e-5);
+    }
+  }
+}
+
+/**
+ * Check the blocked naive search against kernels evaluated one pair at a time.
+ */
+template<typename KernelType>
+void CheckBlockedNaive(KernelType& kernel, const bool parallel)
+{
+  // Use more points than fit in one block.
+  arma::mat data;
+  data.randn(6, 1500);
+  arma::mat queries;
+  queries.randn(6, 150);
+
+  FastMKS<KernelType> naive(data, kernel, false, true);
+  naive.Parallel() = parallel;
+
+  arma::Mat<size_t> indices;
+  arma::mat kernels;
+  naive.Search(queries, 3, indices, kernels);
+
+  for (size_t q = 0; q < queries.n_cols; ++q)
+  {
+    arma::vec products(data.n_cols);
+    for (size_t r = 0; r < data.n_cols; ++r)
+      products[r] = kernel.Evaluate(queries.col(q), data.col(r));
+    const arma::uvec order = arma::sort_index(products, "descend");
+
+    for (size_t j = 0; j < 3; ++j)
+    {
+      BOOST_REQUIRE_EQUAL(indices(j, q), order[j]);
+      BOOST_REQUIRE_CLOSE(kernels(j, q), products[order[j]], 1e-5);
+    }
+  }
+
+  // In monochromatic search, points are not their own candidates.
+  naive.Search(3, indices, kernels);
+  for (size_t q = 0; q < data.n_cols; ++q)
+    for (size_t j = 0; j < 3; ++j)
+      BOOST_REQUIRE_NE(indices(j, q), q);
+}
+
+BOOST_AUTO_TEST_CASE(BlockedNaiveTest)
+{
+  LinearKernel lk;
+  CheckBlockedNaive(lk, false);
+  CheckBlockedNaive(lk, true);
+
+  PolynomialKernel pk(3.0, 1.0);
+  CheckBlockedNaive(pk, false);
+  CheckBlockedNaive(pk, true);
+
+  CosineDistance cd;
+  CheckBlockedNaive(cd, false);
+  CheckBlockedNaive(cd, true);
+
+  // Kernels without a blocked evaluation are evaluated pairwise.
+  GaussianKernel gk(1.5);
+  CheckBlockedNaive(gk, true);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
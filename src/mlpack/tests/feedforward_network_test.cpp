@@ -12,10 +12,12 @@
  */
 #include <mlpack/core.hpp>
 
+#include <mlpack/core/optimizers/adam/adam.hpp>
 #include <mlpack/core/optimizers/rmsprop/rmsprop.hpp>
 #include <mlpack/core/optimizers/sgd/update_policies/vanilla_update.hpp>
 #include <mlpack/methods/ann/layer/layer.hpp>
 #include <mlpack/methods/ann/ffn.hpp>
+#include <mlpack/methods/ann/static_ffn.hpp>
 
 #include <boost/test/unit_test.hpp>
 #include "test_tools.hpp"
@@ -501,6 +503,77 @@ BOOST_AUTO_TEST_CASE(FFNMiscTest)
   movedModel = std::move(copiedModel);
 }
 
+/**
+ * Make sure that predicting batches of points gives the same results as
+ * predicting the points one at a time.
+ */
+BOOST_AUTO_TEST_CASE(BatchedPredictTest)
+{
+  FFN<NegativeLogLikelihood<>> model;
+  model.Add<Linear<>>(10, 20);
+  model.Add<SigmoidLayer<>>();
+  model.Add<Dropout<>>();
+  model.Add<Linear<>>(20, 3);
+  model.Add<LogSoftMax<>>();
+
+  arma::mat data = arma::randu<arma::mat>(10, 301);
+
+  arma::mat singlePredictions, predictions, smallBatchPredictions;
+  model.Predict(data, singlePredictions, 1);
+  model.Predict(data, predictions);
+  model.Predict(data, smallBatchPredictions, 7);
+
+  BOOST_REQUIRE_EQUAL(singlePredictions.n_rows, 3);
+  BOOST_REQUIRE_EQUAL(singlePredictions.n_cols, 301);
+  CheckMatrices(singlePredictions, predictions);
+  CheckMatrices(singlePredictions, smallBatchPredictions);
+}
+
+/**
+ * Make sure that the const Predict() gives the same results as Predict(), also
+ * when several threads predict with the same network at the same time.
+ */
+BOOST_AUTO_TEST_CASE(ConstPredictTest)
+{
+  FFN<NegativeLogLikelihood<>> model;
+  model.Add<Linear<>>(10, 20);
+  model.Add<SigmoidLayer<>>();
+  model.Add<Dropout<>>();
+  model.Add<Linear<>>(20, 3);
+  model.Add<LogSoftMax<>>();
+  model.ResetParameters();
+
+  arma::mat data = arma::randu<arma::mat>(10, 301);
+  arma::mat predictions;
+  model.Predict(data, predictions);
+
+  const FFN<NegativeLogLikelihood<>>& constModel = model;
+  const size_t numThreads = 4;
+  std::vector<arma::mat> threadPredictions(numThreads);
+
+  #pragma omp parallel for num_threads(numThreads)
+  for (omp_size_t t = 0; t < (omp_size_t) numThreads; ++t)
+  {
+    FFN<NegativeLogLikelihood<>>::Workspace workspace;
+    constModel.Predict(data, threadPredictions[t], workspace, 7 + t);
+
+    // The workspace is reused by the next call.
+    constModel.Predict(data, threadPredictions[t], workspace);
+  }
+
+  for (size_t t = 0; t < numThreads; ++t)
+    CheckMatrices(predictions, threadPredictions[t]);
+
+  // The workspace has to follow a change of the parameters.
+  FFN<NegativeLogLikelihood<>>::Workspace workspace;
+  arma::mat constPredictions;
+  constModel.Predict(data, constPredictions, workspace);
+  model.Parameters() = arma::randu<arma::mat>(model.Parameters().n_rows, 1);
+  model.Predict(data, predictions);
+  constModel.Predict(data, constPredictions, workspace);
+  CheckMatrices(predictions, constPredictions);
+}
+
 /**
  * Test that serialization works ok.
  */
@@ -567,4 +640,488 @@ BOOST_AUTO_TEST_CASE(SerializationTest)
       binaryPredictions);
 }
 
+//! The layers used by the StaticFFN tests.
+typedef LayerSequence<Linear<>, SigmoidLayer<>, Linear<>, LogSoftMax<> >
+    StaticFFNLayers;
+
+/**
+ * Make sure that a StaticFFN gives the same results as an FFN with the same
+ * layers and parameters.
+ */
+BOOST_AUTO_TEST_CASE(StaticFFNTest)
+{
+  FFN<NegativeLogLikelihood<> > model;
+  model.Add<Linear<> >(10, 20);
+  model.Add<SigmoidLayer<> >();
+  model.Add<Linear<> >(20, 3);
+  model.Add<LogSoftMax<> >();
+  model.ResetParameters();
+
+  StaticFFN<StaticFFNLayers> staticModel(Linear<>(10, 20), SigmoidLayer<>(),
+      Linear<>(20, 3), LogSoftMax<>());
+  staticModel.ResetParameters();
+  BOOST_REQUIRE_EQUAL(staticModel.Parameters().n_elem,
+      model.Parameters().n_elem);
+  staticModel.Parameters() = model.Parameters();
+
+  arma::mat data = arma::randu<arma::mat>(10, 50);
+  arma::mat labels = arma::floor(3 * arma::randu<arma::mat>(1, 50)) + 1;
+
+  arma::mat predictions, staticPredictions;
+  model.Predict(data, predictions);
+  staticModel.Predict(data, staticPredictions);
+  CheckMatrices(predictions, staticPredictions);
+
+  arma::mat results, staticResults, gradients, staticGradients;
+  model.Forward(data, results);
+  staticModel.Forward(data, staticResults);
+  CheckMatrices(results, staticResults);
+
+  const double error = model.Backward(labels, gradients);
+  const double staticError = staticModel.Backward(labels, staticGradients);
+  BOOST_REQUIRE_CLOSE(error, staticError, 1e-5);
+  CheckMatrices(gradients, staticGradients);
+}
+
+/**
+ * Make sure that the gradient of a batch is the same when it is split between
+ * threads, and that training with the parallel gradient gives the same model.
+ */
+BOOST_AUTO_TEST_CASE(ParallelGradientTest)
+{
+  arma::mat data = arma::randu<arma::mat>(10, 64);
+  arma::mat labels = arma::floor(3 * arma::randu<arma::mat>(1, 64)) + 1;
+
+  FFN<NegativeLogLikelihood<> > model(data, labels);
+  model.Add<Linear<> >(10, 20);
+  model.Add<SigmoidLayer<> >();
+  model.Add<Linear<> >(20, 3);
+  model.Add<LogSoftMax<> >();
+  model.ResetParameters();
+
+  FFN<NegativeLogLikelihood<> > parallelModel(data, labels);
+  parallelModel.Add<Linear<> >(10, 20);
+  parallelModel.Add<SigmoidLayer<> >();
+  parallelModel.Add<Linear<> >(20, 3);
+  parallelModel.Add<LogSoftMax<> >();
+  parallelModel.ResetParameters();
+  parallelModel.Parameters() = model.Parameters();
+  parallelModel.Parallel() = true;
+
+  // The first pass is always done by a single thread.
+  arma::mat gradient, parallelGradient;
+  model.Gradient(model.Parameters(), 0, gradient, 64);
+  parallelModel.Gradient(parallelModel.Parameters(), 0, parallelGradient, 64);
+  CheckMatrices(gradient, parallelGradient);
+
+  parallelModel.Gradient(parallelModel.Parameters(), 0, parallelGradient, 64);
+  CheckMatrices(gradient, parallelGradient);
+
+  // The replicas have to see each update of the parameters.
+  Adam opt(0.01, 16, 0.9, 0.999, 1e-8, 5 * data.n_cols, -1, false);
+  model.Train(data, labels, opt);
+  parallelModel.Train(data, labels, opt);
+  CheckMatrices(model.Parameters(), parallelModel.Parameters());
+}
+
+/**
+ * Make sure that EvaluateWithGradient() gives the same results as Evaluate()
+ * and Gradient().
+ */
+BOOST_AUTO_TEST_CASE(FFNEvaluateWithGradientTest)
+{
+  BOOST_REQUIRE(HasSeparableEvaluateWithGradient<
+      FFN<NegativeLogLikelihood<> > >::value);
+
+  arma::mat data = arma::randu<arma::mat>(10, 64);
+  arma::mat labels = arma::floor(3 * arma::randu<arma::mat>(1, 64)) + 1;
+
+  FFN<NegativeLogLikelihood<> > model(data, labels);
+  model.Add<Linear<> >(10, 20);
+  model.Add<SigmoidLayer<> >();
+  model.Add<Linear<> >(20, 3);
+  model.Add<LogSoftMax<> >();
+  model.ResetParameters();
+
+  arma::mat gradient, fusedGradient;
+  for (size_t begin = 0; begin < data.n_cols; begin += 16)
+  {
+    const double objective = model.Evaluate(model.Parameters(), begin, 16);
+    model.Gradient(model.Parameters(), begin, gradient, 16);
+    const double fusedObjective = model.EvaluateWithGradient(
+        model.Parameters(), begin, fusedGradient, 16);
+
+    BOOST_REQUIRE_CLOSE(objective, fusedObjective, 1e-5);
+    CheckMatrices(gradient, fusedGradient);
+  }
+}
+
+/**
+ * Make sure that the shuffled batches visit each point once, and that
+ * prefetching the batches in the background gives the same training results.
+ */
+BOOST_AUTO_TEST_CASE(PrefetchTest)
+{
+  arma::mat data = arma::randu<arma::mat>(10, 70);
+  arma::mat labels = arma::floor(3 * arma::randu<arma::mat>(1, 70)) + 1;
+
+  FFN<NegativeLogLikelihood<> > model(data, labels);
+  model.Add<Linear<> >(10, 20);
+  model.Add<SigmoidLayer<> >();
+  model.Add<Linear<> >(20, 3);
+  model.Add<LogSoftMax<> >();
+  model.ResetParameters();
+
+  FFN<NegativeLogLikelihood<> > prefetchModel(data, labels);
+  prefetchModel.Add<Linear<> >(10, 20);
+  prefetchModel.Add<SigmoidLayer<> >();
+  prefetchModel.Add<Linear<> >(20, 3);
+  prefetchModel.Add<LogSoftMax<> >();
+  prefetchModel.ResetParameters();
+  prefetchModel.Parameters() = model.Parameters();
+  prefetchModel.Prefetch() = true;
+
+  // The objective of the whole dataset doesn't depend on the order of the
+  // batches (the last batch is smaller than the others).
+  double objective = 0, shuffledObjective = 0;
+  for (size_t i = 0; i < data.n_cols; i += 16)
+  {
+    const size_t batchSize = std::min((size_t) 16, (size_t) data.n_cols - i);
+    objective += model.Evaluate(model.Parameters(), i, batchSize);
+  }
+
+  prefetchModel.Shuffle();
+  for (size_t i = 0; i < data.n_cols; i += 16)
+  {
+    const size_t batchSize = std::min((size_t) 16, (size_t) data.n_cols - i);
+    shuffledObjective += prefetchModel.Evaluate(prefetchModel.Parameters(), i,
+        batchSize);
+  }
+  BOOST_REQUIRE_CLOSE(objective, shuffledObjective, 1e-5);
+
+  // With the same seed, both networks visit the points in the same order.
+  Adam opt(0.01, 16, 0.9, 0.999, 1e-8, 5 * data.n_cols, -1, true);
+  math::RandomSeed(42);
+  model.Train(data, labels, opt);
+  math::RandomSeed(42);
+  prefetchModel.Train(data, labels, opt);
+  CheckMatrices(model.Parameters(), prefetchModel.Parameters());
+}
+
+/**
+ * Make sure that a quantized network gives about the same predictions as the
+ * original network, keeps the weights of the other layers, and can be
+ * serialized.
+ */
+BOOST_AUTO_TEST_CASE(QuantizeTest)
+{
+  FFN<NegativeLogLikelihood<> > model;
+  model.Add<Linear<> >(10, 20);
+  model.Add<PReLU<> >();
+  model.Add<LinearNoBias<> >(20, 3);
+  model.Add<LogSoftMax<> >();
+  model.ResetParameters();
+
+  arma::mat data = arma::randu<arma::mat>(10, 100);
+  arma::mat predictions;
+  model.Predict(data, predictions);
+
+  // Only the weight of the PReLU layer (after the 220 weights of the first
+  // layer) is left in the parameters.
+  const double alpha = model.Parameters()(220);
+  model.Quantize();
+  BOOST_REQUIRE_EQUAL(model.Parameters().n_elem, 1);
+  BOOST_REQUIRE_EQUAL(model.Parameters()(0), alpha);
+
+  arma::mat quantizedPredictions;
+  model.Predict(data, quantizedPredictions);
+  BOOST_REQUIRE_LE(arma::norm(predictions - quantizedPredictions, "fro"),
+      0.02 * arma::norm(predictions, "fro"));
+
+  FFN<NegativeLogLikelihood<> > xmlModel, textModel, binaryModel;
+  xmlModel.Add<Linear<> >(10, 10); // Layer that will get removed.
+  SerializeObjectAll(model, xmlModel, textModel, binaryModel);
+
+  arma::mat xmlPredictions, textPredictions, binaryPredictions;
+  xmlModel.Predict(data, xmlPredictions);
+  textModel.Predict(data, textPredictions);
+  binaryModel.Predict(data, binaryPredictions);
+
+  CheckMatrices(quantizedPredictions, xmlPredictions, textPredictions,
+      binaryPredictions);
+}
+
+/**
+ * Make sure that a fused network, with a Sequential block, gives the same
+ * predictions, objective and gradient as the original network, and that its
+ * parameters are not changed.
+ */
+BOOST_AUTO_TEST_CASE(FuseTest)
+{
+  arma::mat data = arma::randu<arma::mat>(10, 50);
+  arma::mat labels = arma::randi<arma::mat>(1, 50, arma::distr_param(1, 3));
+
+  FFN<NegativeLogLikelihood<> > model(data, labels);
+  model.Add<Linear<> >(10, 20);
+  model.Add<SigmoidLayer<> >();
+  Sequential<>* block = new Sequential<>();
+  block->Add<Linear<> >(20, 15);
+  block->Add<ReLULayer<> >();
+  block->Add<Linear<> >(15, 10);
+  block->Add<SigmoidLayer<> >();
+  model.Add(block);
+  model.Add<Linear<> >(10, 3);
+  model.Add<LogSoftMax<> >();
+  model.ResetParameters();
+
+  arma::mat predictions, gradient;
+  model.Predict(data, predictions);
+  const double objective = model.EvaluateWithGradient(model.Parameters(), 0,
+      gradient, 50);
+
+  const arma::mat parameters = model.Parameters();
+  model.Fuse();
+  CheckMatrices(parameters, model.Parameters());
+  BOOST_REQUIRE_EQUAL(block->Model().size(), 2);
+  BOOST_REQUIRE(boost::get<FusedLinear<RectifierFunction>*>(
+      &block->Model()[0]));
+  BOOST_REQUIRE(boost::get<FusedLinear<LogisticFunction>*>(
+      &block->Model()[1]));
+
+  arma::mat fusedPredictions, fusedGradient;
+  model.Predict(data, fusedPredictions);
+  const double fusedObjective = model.EvaluateWithGradient(
+      model.Parameters(), 0, fusedGradient, 50);
+
+  CheckMatrices(predictions, fusedPredictions);
+  BOOST_REQUIRE_CLOSE(objective, fusedObjective, 1e-5);
+  CheckMatrices(gradient, fusedGradient);
+}
+
+/**
+ * Make sure that a network trained on sparse predictors gives the same
+ * parameters and predictions as the same network trained on the dense
+ * predictors, and that the sparse gradient of the first layer only holds the
+ * columns of the inputs of the batch.
+ */
+BOOST_AUTO_TEST_CASE(SparseInputTest)
+{
+  arma::sp_mat sparseData;
+  sparseData.sprandu(1000, 200, 0.01);
+  const arma::mat data(sparseData);
+  arma::mat labels = arma::randi<arma::mat>(1, 200, arma::distr_param(1, 3));
+
+  FFN<NegativeLogLikelihood<> > model;
+  model.Add<Linear<> >(1000, 10);
+  model.Add<SigmoidLayer<> >();
+  model.Add<Linear<> >(10, 3);
+  model.Add<LogSoftMax<> >();
+  model.ResetParameters();
+
+  // The first pass makes the network keep its parameters when it is trained.
+  arma::mat predictions, densePredictions;
+  model.Predict(sparseData, predictions);
+  FFN<NegativeLogLikelihood<> > denseModel(model);
+  denseModel.Predict(data, densePredictions);
+  CheckMatrices(predictions, densePredictions);
+
+  Adam opt(0.01, 16, 0.9, 0.999, 1e-8, 2 * data.n_cols, -1, false);
+  model.Train(sparseData, labels, opt);
+  denseModel.Train(data, labels, opt);
+  CheckMatrices(model.Parameters(), denseModel.Parameters());
+
+  model.Predict(sparseData, predictions);
+  denseModel.Predict(data, densePredictions);
+  CheckMatrices(predictions, densePredictions);
+
+  arma::mat denseGradient;
+  arma::sp_mat sparseGradient;
+  denseModel.Gradient(denseModel.Parameters(), 0, denseGradient, 10);
+  model.Gradient(model.Parameters(), 0, sparseGradient, 10);
+  CheckMatrices(denseGradient, arma::mat(sparseGradient));
+
+  arma::sp_mat batch = sparseData.cols(0, 9);
+  size_t inputs = 0;
+  for (size_t r = 0; r < batch.n_rows; ++r)
+    inputs += (arma::accu(arma::abs(batch.row(r))) > 0);
+  BOOST_REQUIRE_LE(sparseGradient.n_nonzero, 10 * inputs + 10 + 33);
+
+  // The first layer has to be a Linear layer.
+  FFN<NegativeLogLikelihood<> > otherModel;
+  otherModel.Add<SigmoidLayer<> >();
+  otherModel.Add<LogSoftMax<> >();
+  BOOST_REQUIRE_THROW(otherModel.Train(sparseData, labels, opt),
+      std::invalid_argument);
+}
+
+/**
+ * Train a StaticFFN, then make sure that copies, moves and serialized models
+ * give the same predictions.
+ */
+BOOST_AUTO_TEST_CASE(StaticFFNTrainTest)
+{
+  arma::mat dataset;
+  dataset.load("mnist_first250_training_4s_and_9s.arm");
+
+  // Normalize each point since these are images.
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+    dataset.col(i) /= norm(dataset.col(i), 2);
+
+  arma::mat labels = arma::zeros(1, dataset.n_cols);
+  labels.submat(0, labels.n_cols / 2, 0, labels.n_cols - 1).fill(1);
+  labels += 1;
+
+  StaticFFN<StaticFFNLayers> model(Linear<>(dataset.n_rows, 10),
+      SigmoidLayer<>(), Linear<>(10, 2), LogSoftMax<>());
+
+  RMSProp opt(0.01, 32, 0.88, 1e-8, 10 * dataset.n_cols, -1);
+  model.Train(dataset, labels, opt);
+
+  arma::mat predictions;
+  model.Predict(dataset, predictions);
+
+  size_t correct = 0;
+  for (size_t i = 0; i < predictions.n_cols; ++i)
+  {
+    const size_t label = arma::as_scalar(arma::find(
+        arma::max(predictions.col(i)) == predictions.col(i), 1)) + 1;
+    if (label == size_t(labels(i)))
+      ++correct;
+  }
+  BOOST_REQUIRE_GE(double(correct) / predictions.n_cols, 0.8);
+
+  // The copies must use their own weights.
+  StaticFFN<StaticFFNLayers> copiedModel(model);
+  model.Parameters().zeros();
+  arma::mat copiedPredictions;
+  copiedModel.Predict(dataset, copiedPredictions);
+  CheckMatrices(predictions, copiedPredictions);
+
+  StaticFFN<StaticFFNLayers> movedModel(std::move(copiedModel));
+  arma::mat movedPredictions;
+  movedModel.Predict(dataset, movedPredictions);
+  CheckMatrices(predictions, movedPredictions);
+
+  StaticFFN<StaticFFNLayers> xmlModel(Linear<>(dataset.n_rows, 10),
+      SigmoidLayer<>(), Linear<>(10, 2), LogSoftMax<>());
+  StaticFFN<StaticFFNLayers> textModel(xmlModel), binaryModel(xmlModel);
+  SerializeObjectAll(movedModel, xmlModel, textModel, binaryModel);
+
+  arma::mat xmlPredictions, textPredictions, binaryPredictions;
+  xmlModel.Predict(dataset, xmlPredictions);
+  textModel.Predict(dataset, textPredictions);
+  binaryModel.Predict(dataset, binaryPredictions);
+
+  CheckMatrices(predictions, xmlPredictions, textPredictions,
+      binaryPredictions);
+}
+
+//! The single-precision layers used by the StaticFFN tests.
+typedef LayerSequence<Linear<arma::fmat, arma::fmat>,
+    SigmoidLayer<arma::fmat, arma::fmat>, Linear<arma::fmat, arma::fmat>,
+    LogSoftMax<arma::fmat, arma::fmat> > StaticFFNFloatLayers;
+
+//! A StaticFFN whose layers work in single precision.
+typedef StaticFFN<StaticFFNFloatLayers,
+    NegativeLogLikelihood<arma::fmat, arma::fmat>, RandomInitialization,
+    arma::fmat> StaticFFNFloat;
+
+/**
+ * Make sure that a StaticFFN with single-precision layers gives about the same
+ * results as with double-precision layers, and that it can be trained and
+ * serialized.
+ */
+BOOST_AUTO_TEST_CASE(StaticFFNFloatTest)
+{
+  StaticFFN<StaticFFNLayers> model(Linear<>(10, 20), SigmoidLayer<>(),
+      Linear<>(20, 3), LogSoftMax<>());
+  model.ResetParameters();
+
+  StaticFFNFloat floatModel(Linear<arma::fmat, arma::fmat>(10, 20),
+      SigmoidLayer<arma::fmat, arma::fmat>(),
+      Linear<arma::fmat, arma::fmat>(20, 3),
+      LogSoftMax<arma::fmat, arma::fmat>());
+  floatModel.ResetParameters();
+  BOOST_REQUIRE_EQUAL(floatModel.Parameters().n_elem,
+      model.Parameters().n_elem);
+  floatModel.Parameters() = model.Parameters();
+
+  arma::mat data = arma::randu<arma::mat>(10, 50);
+  arma::mat labels = arma::floor(3 * arma::randu<arma::mat>(1, 50)) + 1;
+  arma::fmat floatData = arma::conv_to<arma::fmat>::from(data);
+  arma::fmat floatLabels = arma::conv_to<arma::fmat>::from(labels);
+
+  arma::mat predictions;
+  arma::fmat floatPredictions;
+  model.Predict(data, predictions);
+  floatModel.Predict(floatData, floatPredictions);
+  CheckMatrices(predictions, arma::conv_to<arma::mat>::from(floatPredictions),
+      0.1);
+
+  // The gradient is given in double precision.
+  arma::mat results, gradients, floatGradients;
+  arma::fmat floatResults;
+  model.Forward(data, results);
+  floatModel.Forward(floatData, floatResults);
+  const double error = model.Backward(labels, gradients);
+  const double floatError = floatModel.Backward(floatLabels, floatGradients);
+  BOOST_REQUIRE_CLOSE(error, floatError, 0.1);
+  BOOST_REQUIRE_EQUAL(floatGradients.n_elem, gradients.n_elem);
+  BOOST_REQUIRE_LE(arma::norm(gradients - floatGradients, 2),
+      1e-3 * arma::norm(gradients, 2));
+
+  // Train on real data.
+  arma::fmat dataset;
+  dataset.load("mnist_first250_training_4s_and_9s.arm");
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+    dataset.col(i) /= norm(dataset.col(i), 2);
+
+  arma::fmat datasetLabels = arma::zeros<arma::fmat>(1, dataset.n_cols);
+  datasetLabels.submat(0, datasetLabels.n_cols / 2, 0,
+      datasetLabels.n_cols - 1).fill(1);
+  datasetLabels += 1;
+
+  StaticFFNFloat trainModel(Linear<arma::fmat, arma::fmat>(dataset.n_rows, 10),
+      SigmoidLayer<arma::fmat, arma::fmat>(),
+      Linear<arma::fmat, arma::fmat>(10, 2),
+      LogSoftMax<arma::fmat, arma::fmat>());
+
+  RMSProp opt(0.01, 32, 0.88, 1e-8, 10 * dataset.n_cols, -1);
+  trainModel.Train(dataset, datasetLabels, opt);
+
+  arma::fmat trainPredictions;
+  trainModel.Predict(dataset, trainPredictions);
+
+  size_t correct = 0;
+  for (size_t i = 0; i < trainPredictions.n_cols; ++i)
+  {
+    const size_t label = arma::as_scalar(arma::find(
+        arma::max(trainPredictions.col(i)) == trainPredictions.col(i), 1)) + 1;
+    if (label == size_t(datasetLabels(i)))
+      ++correct;
+  }
+  BOOST_REQUIRE_GE(double(correct) / trainPredictions.n_cols, 0.8);
+
+  StaticFFNFloat xmlModel(Linear<arma::fmat, arma::fmat>(dataset.n_rows, 10),
+      SigmoidLayer<arma::fmat, arma::fmat>(),
+      Linear<arma::fmat, arma::fmat>(10, 2),
+      LogSoftMax<arma::fmat, arma::fmat>());
+  StaticFFNFloat textModel(xmlModel), binaryModel(xmlModel);
+  SerializeObjectAll(trainModel, xmlModel, textModel, binaryModel);
+
+  arma::fmat xmlPredictions, textPredictions, binaryPredictions;
+  xmlModel.Predict(dataset, xmlPredictions);
+  textModel.Predict(dataset, textPredictions);
+  binaryModel.Predict(dataset, binaryPredictions);
+
+  const arma::mat doublePredictions =
+      arma::conv_to<arma::mat>::from(trainPredictions);
+  CheckMatrices(doublePredictions,
+      arma::conv_to<arma::mat>::from(xmlPredictions));
+  CheckMatrices(doublePredictions,
+      arma::conv_to<arma::mat>::from(textPredictions));
+  CheckMatrices(doublePredictions,
+      arma::conv_to<arma::mat>::from(binaryPredictions));
+}
+
 BOOST_AUTO_TEST_SUITE_END();
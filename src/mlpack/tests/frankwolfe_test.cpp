@@ -12,6 +12,7 @@
 #include <mlpack/core.hpp>
 #include <mlpack/core/optimizers/fw/frank_wolfe.hpp>
 #include <mlpack/core/optimizers/fw/constr_lpball.hpp>
+#include <mlpack/core/optimizers/fw/atoms.hpp>
 #include <mlpack/core/optimizers/fw/update_span.hpp>
 #include <mlpack/core/optimizers/fw/update_full_correction.hpp>
 #include <mlpack/core/optimizers/fw/update_classic.hpp>
@@ -147,6 +148,46 @@ BOOST_AUTO_TEST_CASE(AtomNormConstraint)
  * A very simple test of classic Frank-Wolfe algorithm.
  * The constrained domain used is unit lp ball.
  */
+/**
+ * Make sure that the least-squares coefficients given by the factorization
+ * that Atoms keeps are the ones of a direct solve, also when an atom is in the
+ * span of the previous ones and after atoms are pruned.
+ */
+BOOST_AUTO_TEST_CASE(AtomsFactorizationTest)
+{
+  mat A = randn(20, 8);
+  vec b = randn(20);
+  FuncSq f(A, b);
+
+  Atoms atoms;
+  for (size_t i = 0; i < 5; ++i)
+  {
+    vec v = randn(8);
+    atoms.AddAtom(v, f);
+  }
+
+  // An atom in the span of the first two.
+  vec dependent = atoms.CurrentAtoms().col(0) - 2 * atoms.CurrentAtoms().col(1);
+  atoms.AddAtom(dependent, f);
+  BOOST_REQUIRE_EQUAL(atoms.CurrentAtoms().n_cols, 6);
+
+  atoms.SolveInSpan();
+  vec x;
+  atoms.RecoverVector(x);
+
+  vec expected = solve(A * atoms.CurrentAtoms().cols(0, 4), b);
+  vec expectedX = atoms.CurrentAtoms().cols(0, 4) * expected;
+  for (size_t i = 0; i < x.n_elem; ++i)
+    BOOST_REQUIRE_SMALL(x[i] - expectedX[i], 1e-8);
+
+  // Pruning with a large threshold removes atoms until one is left; the
+  // remaining coefficients must still solve the least-squares problem.
+  atoms.PruneSupport(1e10, f);
+  BOOST_REQUIRE_EQUAL(atoms.CurrentAtoms().n_cols, 1);
+  vec prunedExpected = solve(A * atoms.CurrentAtoms(), b);
+  BOOST_REQUIRE_SMALL(atoms.CurrentCoeffs()[0] - prunedExpected[0], 1e-8);
+}
+
 BOOST_AUTO_TEST_CASE(ClassicFW)
 {
   TestFuncFW f;
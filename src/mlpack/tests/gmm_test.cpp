@@ -46,6 +46,40 @@ BOOST_AUTO_TEST_CASE(GMMProbabilityTest)
   BOOST_REQUIRE_CLOSE(gmm.Probability("1.4 0"), 0.024676682176, 1e-5);
 }
 
+/**
+ * Test GMM::Probability() and GMM::LogProbability() for many observations at
+ * once against the single-observation Probability().
+ */
+BOOST_AUTO_TEST_CASE(GMMBatchProbabilityTest)
+{
+  // Create a GMM (same as the last test).
+  GMM gmm(2, 2);
+  gmm.Component(0) = distribution::GaussianDistribution("0 0", "1 0; 0 1");
+  gmm.Component(1) = distribution::GaussianDistribution("3 3", "2 1; 1 2");
+  gmm.Weights() = "0.3 0.7";
+
+  arma::mat observations("0 1 2 3 -1 1.4 40;"
+                         "0 1 2 3 5.3 0 -40");
+
+  arma::vec probabilities, logProbabilities;
+  gmm.Probability(observations, probabilities);
+  gmm.LogProbability(observations, logProbabilities);
+
+  BOOST_REQUIRE_EQUAL(probabilities.n_elem, 7);
+  BOOST_REQUIRE_EQUAL(logProbabilities.n_elem, 7);
+  for (size_t i = 0; i < 6; ++i)
+  {
+    const double p = gmm.Probability(observations.col(i));
+    BOOST_REQUIRE_CLOSE(probabilities[i], p, 1e-5);
+    BOOST_REQUIRE_CLOSE(logProbabilities[i], std::log(p), 1e-5);
+  }
+
+  // The last observation is so far away that its probability underflows, but
+  // its log-probability does not.
+  BOOST_REQUIRE_SMALL(probabilities[6], 1e-300);
+  BOOST_REQUIRE(std::isfinite(logProbabilities[6]));
+}
+
 /**
  * Test GMM::Probability() for a single observation being from a particular
  * component.
@@ -595,6 +629,86 @@ BOOST_AUTO_TEST_CASE(EigenvalueRatioConstraintTest)
   }
 }
 
+/**
+ * Start EM from a model where the probabilities of half the points underflow
+ * for every Gaussian.  The E-step works in the log domain, so those points
+ * are still assigned to the closest Gaussian, and both clusters are found.
+ */
+BOOST_AUTO_TEST_CASE(EMFitFarPointsTest)
+{
+  arma::mat data(2, 1000);
+  data.cols(0, 499) = arma::randn<arma::mat>(2, 500);
+  data.cols(500, 999) = arma::randn<arma::mat>(2, 500) + 1000.0;
+
+  std::vector<distribution::GaussianDistribution> dists(2,
+      distribution::GaussianDistribution(2));
+  dists[0].Mean() = arma::vec("0.0 0.0");
+  dists[1].Mean() = arma::vec("1.0 1.0");
+  arma::vec weights("0.5 0.5");
+
+  EMFit<> fitter(100, 1e-10);
+  fitter.Estimate(data, dists, weights, true);
+
+  arma::vec trueMean0 = arma::mean(data.cols(0, 499), 1);
+  arma::vec trueMean1 = arma::mean(data.cols(500, 999), 1);
+  CheckMatrices(dists[0].Mean(), trueMean0, 1e-3);
+  CheckMatrices(dists[1].Mean(), trueMean1, 1e-3);
+  BOOST_REQUIRE_CLOSE(weights[0], 0.5, 1e-5);
+  BOOST_REQUIRE_CLOSE(weights[1], 0.5, 1e-5);
+}
+
+/**
+ * Train a GMM online on a stream of batches, after training it on a first
+ * batch, and make sure it gets close to the true model.
+ */
+BOOST_AUTO_TEST_CASE(GMMUpdateTest)
+{
+  GMM trueGMM(2, 2);
+  trueGMM.Component(0) = distribution::GaussianDistribution("0 0",
+      "1.0 0.3; 0.3 1.0");
+  trueGMM.Component(1) = distribution::GaussianDistribution("6 4",
+      "2.0 0.0; 0.0 0.5");
+  trueGMM.Weights() = arma::vec("0.3 0.7");
+
+  arma::mat firstBatch(2, 200);
+  for (size_t i = 0; i < firstBatch.n_cols; ++i)
+    firstBatch.col(i) = trueGMM.Random();
+
+  GMM gmm(2, 2);
+  gmm.Train(firstBatch, 3);
+
+  for (size_t batch = 0; batch < 200; ++batch)
+  {
+    arma::mat observations(2, 500);
+    for (size_t i = 0; i < observations.n_cols; ++i)
+      observations.col(i) = trueGMM.Random();
+
+    gmm.Update(observations);
+  }
+
+  BOOST_REQUIRE_EQUAL(gmm.Updates(), 200);
+
+  // The components may be in either order.
+  const size_t first = (gmm.Weights()[0] < gmm.Weights()[1]) ? 0 : 1;
+  const size_t second = 1 - first;
+  BOOST_REQUIRE_SMALL(gmm.Weights()[first] - 0.3, 0.02);
+  for (size_t d = 0; d < 2; ++d)
+  {
+    BOOST_REQUIRE_SMALL(gmm.Component(first).Mean()[d] -
+        trueGMM.Component(0).Mean()[d], 0.1);
+    BOOST_REQUIRE_SMALL(gmm.Component(second).Mean()[d] -
+        trueGMM.Component(1).Mean()[d], 0.1);
+  }
+
+  for (size_t i = 0; i < 4; ++i)
+  {
+    BOOST_REQUIRE_SMALL(gmm.Component(first).Covariance()[i] -
+        trueGMM.Component(0).Covariance()[i], 0.15);
+    BOOST_REQUIRE_SMALL(gmm.Component(second).Covariance()[i] -
+        trueGMM.Component(1).Covariance()[i], 0.15);
+  }
+}
+
 BOOST_AUTO_TEST_CASE(UseExistingModelTest)
 {
   // If we run a GMM and it converges, then if we run it again using the
@@ -857,4 +971,86 @@ BOOST_AUTO_TEST_CASE(DiagonalGMMTrainTest)
   }
 }
 
+/**
+ * Make sure observations generated all at once come from the right components
+ * in the right proportions.
+ */
+BOOST_AUTO_TEST_CASE(GMMBatchRandomTest)
+{
+  // Two components far from each other.
+  GMM gmm(2, 2);
+  gmm.Weights() = arma::vec("0.30 0.70");
+  gmm.Component(0) = distribution::GaussianDistribution("-10.0 -10.0",
+      "1.00 0.30; 0.30 0.80");
+  gmm.Component(1) = distribution::GaussianDistribution("10.0 10.0",
+      "0.90 0.20; 0.20 1.10");
+
+  arma::mat observations;
+  gmm.Random(5000, observations);
+  BOOST_REQUIRE_EQUAL(observations.n_rows, 2);
+  BOOST_REQUIRE_EQUAL(observations.n_cols, 5000);
+
+  // Split the observations by component.
+  const arma::uvec first = arma::find(observations.row(0) < 0.0);
+  const arma::uvec second = arma::find(observations.row(0) >= 0.0);
+  BOOST_REQUIRE_CLOSE((double) first.n_elem / 5000, 0.30, 7.0);
+  BOOST_REQUIRE_CLOSE((double) second.n_elem / 5000, 0.70, 7.0);
+
+  const arma::mat firstObs = observations.cols(first);
+  const arma::mat secondObs = observations.cols(second);
+  const arma::vec firstMean = arma::mean(firstObs, 1);
+  const arma::vec secondMean = arma::mean(secondObs, 1);
+  BOOST_REQUIRE_CLOSE(firstMean[0], -10.0, 2.0);
+  BOOST_REQUIRE_CLOSE(firstMean[1], -10.0, 2.0);
+  BOOST_REQUIRE_CLOSE(secondMean[0], 10.0, 2.0);
+  BOOST_REQUIRE_CLOSE(secondMean[1], 10.0, 2.0);
+
+  const arma::mat firstCov = ccov(firstObs);
+  BOOST_REQUIRE_CLOSE(firstCov(0, 0), 1.00, 15.0);
+  BOOST_REQUIRE_CLOSE(firstCov(1, 1), 0.80, 15.0);
+}
+
+/**
+ * Make sure that the trials, which run in parallel with their own random
+ * streams, give the same model whatever the number of threads.
+ */
+BOOST_AUTO_TEST_CASE(GMMParallelTrialsTest)
+{
+  GMM g(3, 2);
+  g.Weights() = arma::vec("0.3 0.3 0.4");
+  g.Component(0) = distribution::GaussianDistribution("0.0 0.0",
+      "1.0 0.0; 0.0 1.0");
+  g.Component(1) = distribution::GaussianDistribution("4.0 1.0",
+      "1.0 0.3; 0.3 1.0");
+  g.Component(2) = distribution::GaussianDistribution("1.0 5.0",
+      "0.8 0.0; 0.0 1.2");
+  arma::mat observations;
+  g.Random(1500, observations);
+
+  GMM parallel(3, 2), sequential(3, 2);
+  math::RandomSeed(42);
+  const double parallelLikelihood = parallel.Train(observations, 6);
+
+#ifdef HAS_OPENMP
+  const size_t prevNumThreads = omp_get_max_threads();
+  omp_set_num_threads(1);
+#endif
+  math::RandomSeed(42);
+  const double sequentialLikelihood = sequential.Train(observations, 6);
+#ifdef HAS_OPENMP
+  omp_set_num_threads(prevNumThreads);
+#endif
+
+  BOOST_REQUIRE_CLOSE(parallelLikelihood, sequentialLikelihood, 1e-8);
+  for (size_t i = 0; i < 3; ++i)
+  {
+    BOOST_REQUIRE_CLOSE(parallel.Weights()[i], sequential.Weights()[i], 1e-8);
+    for (size_t d = 0; d < 2; ++d)
+    {
+      BOOST_REQUIRE_CLOSE(parallel.Component(i).Mean()[d],
+          sequential.Component(i).Mean()[d], 1e-8);
+    }
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END();
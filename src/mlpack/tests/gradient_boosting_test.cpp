@@ -0,0 +1,253 @@
+/**
+ * @file gradient_boosting_test.cpp
+ *
+ * Tests for the GradientBoosting class and the GradientBoostingTree class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/methods/gradient_boosting/gradient_boosting.hpp>
+#include <mlpack/methods/decision_tree/decision_tree.hpp>
+
+#include <boost/test/unit_test.hpp>
+#include "test_tools.hpp"
+#include "serialization.hpp"
+
+using namespace mlpack;
+using namespace mlpack::tree;
+
+BOOST_AUTO_TEST_SUITE(GradientBoostingTest);
+
+/**
+ * Make a noisy regression dataset, y = sin(x_1) + x_2^2 / 4.
+ */
+void RegressionData(const size_t n,
+                    arma::mat& data,
+                    arma::rowvec& responses,
+                    const double noise = 0.1)
+{
+  data = 4 * arma::randu<arma::mat>(3, n) - 2;
+  responses = arma::sin(data.row(0)) + arma::square(data.row(1)) / 4 +
+      noise * arma::randn<arma::rowvec>(n);
+}
+
+/**
+ * A tree trained on a step function should split at the step, and with no
+ * regularization its leaves should hold the mean gradient.
+ */
+BOOST_AUTO_TEST_CASE(TreeStepTest)
+{
+  arma::Mat<unsigned char> bins(100, 1);
+  std::vector<arma::vec> binThresholds(1);
+  binThresholds[0] = arma::linspace<arma::vec>(0.5, 8.5, 9);
+  arma::rowvec gradients(100), hessians(100, arma::fill::ones);
+  for (size_t i = 0; i < 100; ++i)
+  {
+    bins(i, 0) = (unsigned char) (i / 10);
+    gradients[i] = (i < 30) ? -1.0 : 2.0;
+  }
+
+  const arma::uvec points = arma::linspace<arma::uvec>(0, 99, 100);
+  const arma::uvec dimensions(1, arma::fill::zeros);
+
+  GradientBoostingTree tree;
+  tree.Train(bins, binThresholds, gradients, hessians, points, dimensions, 1, 5,
+      0.0, 1.0);
+
+  BOOST_REQUIRE_EQUAL(tree.NumNodes(), 3);
+  for (size_t i = 0; i < 100; ++i)
+  {
+    BOOST_REQUIRE_CLOSE(tree.Predict(bins, i), -gradients[i], 1e-5);
+
+    // The step is between bins 2 and 3, so at the value 2.5.
+    arma::vec point(1);
+    point[0] = (double) (i / 10);
+    BOOST_REQUIRE_CLOSE(tree.Predict(point), -gradients[i], 1e-5);
+  }
+}
+
+/**
+ * Make sure that the squared error of a regression model is much smaller than
+ * the variance of the responses.
+ */
+BOOST_AUTO_TEST_CASE(RegressionTest)
+{
+  arma::mat data, testData;
+  arma::rowvec responses, testResponses;
+  RegressionData(2000, data, responses);
+  RegressionData(1000, testData, testResponses);
+
+  GradientBoosting gbm(200, 0.1, 4, 10);
+  gbm.Train(data, responses);
+  BOOST_REQUIRE_EQUAL(gbm.NumClasses(), 0);
+  BOOST_REQUIRE_EQUAL(gbm.NumTrees(), 200);
+
+  arma::rowvec predictions;
+  gbm.Predict(testData, predictions);
+  BOOST_REQUIRE_EQUAL(predictions.n_elem, testData.n_cols);
+
+  const double mse = arma::mean(arma::square(predictions - testResponses));
+  const double variance = arma::var(testResponses);
+  BOOST_REQUIRE_LT(mse, 0.15 * variance);
+
+  // A regression model can't classify.
+  arma::Row<size_t> labels;
+  BOOST_REQUIRE_THROW(gbm.Classify(testData, labels), std::invalid_argument);
+}
+
+/**
+ * Make sure that a classifier does at least as well as a decision tree on the
+ * vc2 dataset, and that its probabilities sum to one.
+ */
+BOOST_AUTO_TEST_CASE(ClassificationTest)
+{
+  arma::mat dataset, testDataset;
+  data::Load("vc2.csv", dataset);
+  data::Load("vc2_test.csv", testDataset);
+  arma::Row<size_t> labels, testLabels;
+  data::Load("vc2_labels.txt", labels);
+  data::Load("vc2_test_labels.txt", testLabels);
+
+  GradientBoosting gbm(50, 0.1, 4, 5);
+  gbm.Train(dataset, labels, 3);
+  BOOST_REQUIRE_EQUAL(gbm.NumClasses(), 3);
+  BOOST_REQUIRE_EQUAL(gbm.NumTrees(), 150);
+
+  DecisionTree<> dt(dataset, labels, 3, 5);
+
+  arma::Row<size_t> predictions, dtPredictions;
+  arma::mat probabilities;
+  gbm.Classify(testDataset, predictions, probabilities);
+  dt.Classify(testDataset, dtPredictions);
+
+  BOOST_REQUIRE_EQUAL(probabilities.n_rows, 3);
+  BOOST_REQUIRE_EQUAL(probabilities.n_cols, testDataset.n_cols);
+  for (size_t i = 0; i < probabilities.n_cols; ++i)
+    BOOST_REQUIRE_CLOSE(arma::accu(probabilities.col(i)), 1.0, 1e-5);
+
+  const size_t correct = arma::accu(predictions == testLabels);
+  const size_t dtCorrect = arma::accu(dtPredictions == testLabels);
+  BOOST_REQUIRE_GE(correct, dtCorrect);
+  BOOST_REQUIRE_GE(correct, size_t(0.7 * testDataset.n_cols));
+
+  // A classifier can't predict responses.
+  arma::rowvec responses;
+  BOOST_REQUIRE_THROW(gbm.Predict(testDataset, responses),
+      std::invalid_argument);
+}
+
+/**
+ * Make sure that row and column subsampling still give a good model.
+ */
+BOOST_AUTO_TEST_CASE(SubsampleTest)
+{
+  arma::mat data, testData;
+  arma::rowvec responses, testResponses;
+  RegressionData(2000, data, responses);
+  RegressionData(1000, testData, testResponses);
+
+  GradientBoosting gbm(200, 0.1, 4, 10, 1.0, 0.5, 0.7);
+  gbm.Train(data, responses);
+
+  arma::rowvec predictions;
+  gbm.Predict(testData, predictions);
+
+  const double mse = arma::mean(arma::square(predictions - testResponses));
+  BOOST_REQUIRE_LT(mse, 0.25 * arma::var(testResponses));
+}
+
+/**
+ * Make sure that training stops early when the validation loss stops improving.
+ */
+BOOST_AUTO_TEST_CASE(EarlyStoppingTest)
+{
+  // Pure noise: the model can only overfit.
+  arma::mat data = arma::randu<arma::mat>(3, 500);
+  arma::rowvec responses = arma::randn<arma::rowvec>(500);
+  arma::mat validationData = arma::randu<arma::mat>(3, 500);
+  arma::rowvec validationResponses = arma::randn<arma::rowvec>(500);
+
+  GradientBoosting gbm(1000, 0.3, 6, 1);
+  gbm.EarlyStoppingRounds() = 5;
+  gbm.Train(data, responses, validationData, validationResponses);
+  BOOST_REQUIRE_LT(gbm.NumTrees(), 1000);
+
+  // Without early stopping, all rounds are kept.
+  gbm.EarlyStoppingRounds() = 0;
+  gbm.NumRounds() = 20;
+  gbm.Train(data, responses, validationData, validationResponses);
+  BOOST_REQUIRE_EQUAL(gbm.NumTrees(), 20);
+}
+
+/**
+ * Make sure that invalid parameters and data are rejected.
+ */
+BOOST_AUTO_TEST_CASE(InvalidParametersTest)
+{
+  arma::mat data;
+  arma::rowvec responses;
+  RegressionData(200, data, responses);
+
+  GradientBoosting gbm(10);
+  gbm.MaxBins() = 1000;
+  BOOST_REQUIRE_THROW(gbm.Train(data, responses), std::invalid_argument);
+  gbm.MaxBins() = 256;
+  gbm.RowSubsample() = 0.0;
+  BOOST_REQUIRE_THROW(gbm.Train(data, responses), std::invalid_argument);
+  gbm.RowSubsample() = 1.0;
+
+  const arma::rowvec shortResponses = responses.head(100);
+  BOOST_REQUIRE_THROW(gbm.Train(data, shortResponses), std::invalid_argument);
+
+  arma::Row<size_t> labels(200, arma::fill::zeros);
+  labels[3] = 2;
+  BOOST_REQUIRE_THROW(gbm.Train(data, labels, 2), std::invalid_argument);
+
+  // An untrained model can't predict.
+  GradientBoosting untrained;
+  arma::rowvec predictions;
+  BOOST_REQUIRE_THROW(untrained.Predict(data, predictions),
+      std::invalid_argument);
+}
+
+/**
+ * Make sure that a serialized model gives the same predictions.
+ */
+BOOST_AUTO_TEST_CASE(SerializationTest)
+{
+  arma::mat dataset;
+  data::Load("vc2.csv", dataset);
+  arma::Row<size_t> labels;
+  data::Load("vc2_labels.txt", labels);
+
+  GradientBoosting gbm(20, 0.1, 4, 5);
+  gbm.Train(dataset, labels, 3);
+
+  arma::Row<size_t> beforePredictions;
+  arma::mat beforeProbabilities;
+  gbm.Classify(dataset, beforePredictions, beforeProbabilities);
+
+  GradientBoosting xmlModel, textModel, binaryModel;
+  arma::rowvec responses = arma::randu<arma::rowvec>(dataset.n_cols);
+  binaryModel.Train(dataset, responses);
+  SerializeObjectAll(gbm, xmlModel, textModel, binaryModel);
+
+  BOOST_REQUIRE_EQUAL(xmlModel.NumTrees(), gbm.NumTrees());
+  BOOST_REQUIRE_EQUAL(binaryModel.NumClasses(), 3);
+
+  arma::Row<size_t> xmlPredictions, textPredictions, binaryPredictions;
+  arma::mat xmlProbabilities, textProbabilities, binaryProbabilities;
+  xmlModel.Classify(dataset, xmlPredictions, xmlProbabilities);
+  textModel.Classify(dataset, textPredictions, textProbabilities);
+  binaryModel.Classify(dataset, binaryPredictions, binaryProbabilities);
+
+  CheckMatrices(beforePredictions, xmlPredictions, textPredictions,
+      binaryPredictions);
+  CheckMatrices(beforeProbabilities, xmlProbabilities, textProbabilities,
+      binaryProbabilities);
+}
+
+BOOST_AUTO_TEST_SUITE_END();
@@ -1173,5 +1173,177 @@ BOOST_AUTO_TEST_CASE(DiscreteHMMLoadSaveTest)
           hmm2.Emission()[j].Probabilities()[i], 1e-3);
 }
 
-BOOST_AUTO_TEST_SUITE_END();
+/**
+ * Train a Gaussian HMM online, with one batch of sequences at a time, starting
+ * from a model with uniform transitions and shifted emissions, and make sure
+ * the model gets close to the true one.
+ */
+BOOST_AUTO_TEST_CASE(GaussianHMMUpdateTest)
+{
+  std::vector<GaussianDistribution> emission;
+  emission.push_back(GaussianDistribution("0.0 0.0", "1.0 0.0; 0.0 1.0"));
+  emission.push_back(GaussianDistribution("8.0 0.0", "1.0 0.0; 0.0 1.0"));
+  emission.push_back(GaussianDistribution("0.0 8.0", "1.0 0.0; 0.0 1.0"));
+  arma::mat transition("0.6 0.2 0.3;"
+                       "0.3 0.7 0.1;"
+                       "0.1 0.1 0.6");
+  arma::vec initial("0.4 0.3 0.3");
+  HMM<GaussianDistribution> hmm(initial, transition, emission);
+
+  // Start from a model with uniform transitions and shifted means.
+  std::vector<GaussianDistribution> guessEmission(emission);
+  for (size_t i = 0; i < 3; ++i)
+    guessEmission[i].Mean() += 1.0;
+  HMM<GaussianDistribution> onlineHMM(arma::vec(3).fill(1.0 / 3.0),
+      arma::mat(3, 3).fill(1.0 / 3.0), guessEmission);
+
+  for (size_t batch = 0; batch < 100; ++batch)
+  {
+    std::vector<arma::mat> sequences(10);
+    arma::Row<size_t> states;
+    for (size_t i = 0; i < sequences.size(); ++i)
+      hmm.Generate(100, sequences[i], states, math::RandInt(3));
+
+    onlineHMM.Update(sequences);
+  }
+
+  BOOST_REQUIRE_EQUAL(onlineHMM.Updates(), 100);
+  for (size_t i = 0; i < 3; ++i)
+  {
+    for (size_t j = 0; j < 3; ++j)
+      BOOST_REQUIRE_SMALL(onlineHMM.Transition()(i, j) - transition(i, j),
+          0.05);
+
+    for (size_t d = 0; d < 2; ++d)
+      BOOST_REQUIRE_SMALL(onlineHMM.Emission()[i].Mean()[d] -
+          emission[i].Mean()[d], 0.15);
+  }
+}
+
+/**
+ * Make sure that observations that are very unlikely under every state do not
+ * make the log-likelihood underflow.  When all the states have the same
+ * emission distribution, the log-likelihood of a sequence is the sum of the
+ * log-probabilities of the observations, whatever the transitions are.
+ */
+BOOST_AUTO_TEST_CASE(UnlikelyEmissionLogLikelihoodTest)
+{
+  GaussianDistribution g(arma::vec("0.0"), arma::mat("1.0"));
+  std::vector<GaussianDistribution> emission(2, g);
+  HMM<GaussianDistribution> hmm(arma::vec("0.3 0.7"),
+      arma::mat("0.9 0.4; 0.1 0.6"), emission);
+
+  // The probability of each of these observations underflows.
+  arma::mat sequence = 40.0 + arma::randu<arma::mat>(1, 50);
+
+  double logProb = 0.0;
+  for (size_t t = 0; t < sequence.n_cols; ++t)
+    logProb += g.LogProbability(sequence.col(t));
+
+  BOOST_REQUIRE_CLOSE(hmm.LogLikelihood(sequence), logProb, 1e-5);
+
+  arma::mat stateProb;
+  BOOST_REQUIRE_CLOSE(hmm.Estimate(sequence, stateProb), logProb, 1e-5);
+  for (size_t t = 0; t < sequence.n_cols; ++t)
+  {
+    BOOST_REQUIRE_CLOSE(arma::accu(stateProb.col(t)), 1.0, 1e-5);
+  }
+
+  // Training on the sequence should not give any NaNs.
+  hmm.Train(std::vector<arma::mat>(1, sequence));
+  BOOST_REQUIRE(hmm.Transition().is_finite());
+  BOOST_REQUIRE(hmm.Initial().is_finite());
+}
 
+/**
+ * Make sure that predicting and computing the log-likelihood of many sequences
+ * at once gives the same results as doing it for one sequence at a time.
+ */
+BOOST_AUTO_TEST_CASE(BatchPredictLogLikelihoodTest)
+{
+  std::vector<GaussianDistribution> emission(3);
+  emission[0] = GaussianDistribution(arma::vec("0.0 0.0"), arma::eye(2, 2));
+  emission[1] = GaussianDistribution(arma::vec("2.0 2.0"), arma::eye(2, 2));
+  emission[2] = GaussianDistribution(arma::vec("-2.0 2.0"), arma::eye(2, 2));
+  HMM<GaussianDistribution> hmm(arma::vec("0.5 0.3 0.2"),
+      arma::mat("0.8 0.1 0.3; 0.1 0.8 0.1; 0.1 0.1 0.6"), emission);
+
+  std::vector<arma::mat> sequences(50);
+  arma::Row<size_t> states;
+  for (size_t i = 0; i < sequences.size(); ++i)
+  {
+    // Leave one sequence empty.
+    if (i != 10)
+      hmm.Generate(math::RandInt(1, 30), sequences[i], states);
+  }
+
+  std::vector<arma::Row<size_t>> predictions;
+  hmm.Predict(sequences, predictions);
+  arma::vec logLikelihoods;
+  hmm.LogLikelihood(sequences, logLikelihoods);
+
+  BOOST_REQUIRE_EQUAL(predictions.size(), sequences.size());
+  BOOST_REQUIRE_EQUAL(logLikelihoods.n_elem, sequences.size());
+  BOOST_REQUIRE_EQUAL(predictions[10].n_elem, 0);
+  BOOST_REQUIRE_SMALL(logLikelihoods[10], 1e-10);
+  for (size_t i = 0; i < sequences.size(); ++i)
+  {
+    if (i == 10)
+      continue;
+
+    arma::Row<size_t> prediction;
+    hmm.Predict(sequences[i], prediction);
+    BOOST_REQUIRE_EQUAL(predictions[i].n_elem, prediction.n_elem);
+    for (size_t t = 0; t < prediction.n_elem; ++t)
+      BOOST_REQUIRE_EQUAL(predictions[i][t], prediction[t]);
+
+    BOOST_REQUIRE_CLOSE(logLikelihoods[i], hmm.LogLikelihood(sequences[i]),
+        1e-5);
+  }
+}
+
+/**
+ * Make sure that an HMM with sparse discrete emissions (and no smoothing)
+ * learns the same model as one with dense discrete emissions.
+ */
+BOOST_AUTO_TEST_CASE(SparseDiscreteHMMTrainTest)
+{
+  // Generate sequences from a dense discrete HMM.
+  std::vector<DiscreteDistribution> emission(2);
+  emission[0].Probabilities() = arma::vec("0.5 0.3 0.1 0.1 0.0");
+  emission[1].Probabilities() = arma::vec("0.0 0.1 0.1 0.2 0.6");
+  HMM<DiscreteDistribution> hmm(arma::vec("0.7 0.3"),
+      arma::mat("0.8 0.3; 0.2 0.7"), emission);
+
+  std::vector<arma::mat> observations(10);
+  std::vector<arma::Row<size_t>> states(10);
+  for (size_t i = 0; i < 10; ++i)
+    hmm.Generate(100, observations[i], states[i]);
+
+  HMM<DiscreteDistribution> denseHMM(2, DiscreteDistribution(5));
+  denseHMM.Train(observations, states);
+  HMM<SparseDiscreteDistribution> sparseHMM(2,
+      SparseDiscreteDistribution(5, 0.0));
+  sparseHMM.Train(observations, states);
+
+  for (size_t i = 0; i < 2; ++i)
+  {
+    for (size_t obs = 0; obs < 5; ++obs)
+    {
+      arma::vec observation(1);
+      observation[0] = obs;
+      BOOST_REQUIRE_CLOSE(
+          denseHMM.Emission()[i].Probability(observation) + 1e-10,
+          sparseHMM.Emission()[i].Probability(observation) + 1e-10, 1e-5);
+    }
+  }
+
+  // The log-likelihoods of the sequences are the same too.
+  for (size_t i = 0; i < 10; ++i)
+  {
+    BOOST_REQUIRE_CLOSE(denseHMM.LogLikelihood(observations[i]),
+        sparseHMM.LogLikelihood(observations[i]), 1e-5);
+  }
+}
+
+BOOST_AUTO_TEST_SUITE_END();
@@ -0,0 +1,155 @@
+/**
+ * @file hnsw_test.cpp
+ *
+ * Unit tests for the 'HNSWSearch' class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/core/metrics/lmetric.hpp>
+#include <boost/test/unit_test.hpp>
+#include "test_tools.hpp"
+
+#include <mlpack/methods/hnsw/hnsw_search.hpp>
+#include <mlpack/methods/lsh/lsh_search.hpp>
+#include <mlpack/methods/neighbor_search/neighbor_search.hpp>
+
+using namespace std;
+using namespace mlpack;
+using namespace mlpack::neighbor;
+
+BOOST_AUTO_TEST_SUITE(HNSWTest);
+
+/**
+ * Make sure that the graph has the expected structure: the entry point is in
+ * the highest layer, and no point has more bottom layer links than allowed or
+ * links to itself.
+ */
+BOOST_AUTO_TEST_CASE(GraphStructureTest)
+{
+  arma::mat rdata = arma::randu<arma::mat>(5, 1000);
+
+  HNSWSearch<> hnsw(rdata, 8, 50);
+
+  BOOST_REQUIRE_EQUAL(hnsw.NumLayers(), arma::max(hnsw.Layers()) + 1);
+  BOOST_REQUIRE_EQUAL(hnsw.Layers()[hnsw.EntryPoint()] + 1, hnsw.NumLayers());
+  BOOST_REQUIRE_EQUAL(hnsw.BaseLinks().n_rows, 16);
+
+  for (size_t i = 0; i < rdata.n_cols; ++i)
+  {
+    BOOST_REQUIRE_GT(hnsw.BaseDegrees()[i], 0);
+    BOOST_REQUIRE_LE(hnsw.BaseDegrees()[i], 16);
+    for (size_t j = 0; j < hnsw.BaseDegrees()[i]; ++j)
+    {
+      BOOST_REQUIRE_NE(hnsw.BaseLinks()(j, i), i);
+      BOOST_REQUIRE_LT(hnsw.BaseLinks()(j, i), rdata.n_cols);
+    }
+  }
+}
+
+/**
+ * Make sure that the recall is high compared to exact search, and that it does
+ * not decrease when more candidates are kept.
+ */
+BOOST_AUTO_TEST_CASE(RecallTest)
+{
+  arma::mat rdata = arma::randn<arma::mat>(20, 2000);
+  arma::mat qdata = arma::randn<arma::mat>(20, 200);
+  const size_t k = 10;
+
+  KNN knn(rdata);
+  arma::Mat<size_t> trueNeighbors;
+  arma::mat trueDistances;
+  knn.Search(qdata, k, trueNeighbors, trueDistances);
+
+  HNSWSearch<> hnsw(rdata);
+
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  hnsw.Search(qdata, k, neighbors, distances, 20);
+  const double lowRecall = LSHSearch<>::ComputeRecall(neighbors,
+      trueNeighbors);
+  const size_t lowEvaluations = hnsw.DistanceEvaluations();
+
+  hnsw.Search(qdata, k, neighbors, distances, 200);
+  const double highRecall = LSHSearch<>::ComputeRecall(neighbors,
+      trueNeighbors);
+
+  BOOST_REQUIRE_GE(highRecall, 0.95);
+  BOOST_REQUIRE_GE(highRecall, lowRecall);
+  BOOST_REQUIRE_GT(hnsw.DistanceEvaluations(), lowEvaluations);
+
+  // The search should be much cheaper than a linear scan.
+  BOOST_REQUIRE_LT(hnsw.DistanceEvaluations(), rdata.n_cols * qdata.n_cols);
+
+  // Distances are sorted and correct.
+  for (size_t i = 0; i < qdata.n_cols; ++i)
+  {
+    for (size_t j = 0; j < k; ++j)
+    {
+      BOOST_REQUIRE_CLOSE(distances(j, i), metric::EuclideanDistance::Evaluate(
+          qdata.col(i), rdata.col(neighbors(j, i))), 1e-5);
+      if (j > 0)
+        BOOST_REQUIRE_LE(distances(j - 1, i), distances(j, i));
+    }
+  }
+}
+
+/**
+ * Searching without a query set should not return a point as its own neighbor,
+ * and should find its nearest neighbors.
+ */
+BOOST_AUTO_TEST_CASE(MonochromaticSearchTest)
+{
+  arma::mat rdata = arma::randu<arma::mat>(3, 500);
+
+  KNN knn(rdata);
+  arma::Mat<size_t> trueNeighbors;
+  arma::mat trueDistances;
+  knn.Search(5, trueNeighbors, trueDistances);
+
+  HNSWSearch<> hnsw(rdata, 8, 100);
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  hnsw.Search(5, neighbors, distances, 100);
+
+  for (size_t i = 0; i < rdata.n_cols; ++i)
+    for (size_t j = 0; j < 5; ++j)
+      BOOST_REQUIRE_NE(neighbors(j, i), i);
+
+  BOOST_REQUIRE_GE(LSHSearch<>::ComputeRecall(neighbors, trueNeighbors), 0.95);
+}
+
+/**
+ * Make sure invalid arguments are rejected.
+ */
+BOOST_AUTO_TEST_CASE(InvalidArgumentsTest)
+{
+  arma::mat rdata = arma::randu<arma::mat>(3, 10);
+
+  BOOST_REQUIRE_THROW(HNSWSearch<>(rdata, 1), std::invalid_argument);
+
+  HNSWSearch<> hnsw(rdata);
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+
+  arma::mat qdata = arma::randu<arma::mat>(4, 5);
+  BOOST_REQUIRE_THROW(hnsw.Search(qdata, 1, neighbors, distances),
+      std::invalid_argument);
+
+  qdata = arma::randu<arma::mat>(3, 5);
+  BOOST_REQUIRE_THROW(hnsw.Search(qdata, 11, neighbors, distances),
+      std::invalid_argument);
+  BOOST_REQUIRE_THROW(hnsw.Search(10, neighbors, distances),
+      std::invalid_argument);
+
+  // Every other point can be requested.
+  hnsw.Search(9, neighbors, distances);
+  BOOST_REQUIRE_EQUAL(neighbors.n_rows, 9);
+  BOOST_REQUIRE_EQUAL(neighbors.n_cols, 10);
+}
+
+BOOST_AUTO_TEST_SUITE_END();
@@ -970,6 +970,113 @@ BOOST_AUTO_TEST_CASE(MajorityProbabilityTest)
   BOOST_REQUIRE_CLOSE(probability, 0.625, 1e-5);
 }
 
+/**
+ * Make sure that mini-batch training with a batch size of one is the same as
+ * streaming training, and that larger mini-batches still give a good tree.
+ */
+BOOST_AUTO_TEST_CASE(MiniBatchTrainingTest)
+{
+  // Generate data with two numeric dimensions and one categorical dimension
+  // that holds the label (with some noise).
+  arma::mat dataset(3, 9000);
+  arma::Row<size_t> labels(9000);
+  data::DatasetInfo info(3);
+  info.MapString<size_t>("cat0", 2);
+  info.MapString<size_t>("cat1", 2);
+  info.MapString<size_t>("cat2", 2);
+  for (size_t i = 0; i < 9000; ++i)
+  {
+    labels[i] = i % 3;
+    dataset(0, i) = mlpack::math::Random();
+    dataset(1, i) = mlpack::math::Random() + labels[i];
+    dataset(2, i) = (mlpack::math::Random() < 0.7) ? labels[i] :
+        mlpack::math::RandInt(3);
+  }
+
+  HoeffdingTree<> streamTree(info, 3);
+  for (size_t i = 0; i < 9000; ++i)
+    streamTree.Train(dataset.col(i), labels[i]);
+
+  HoeffdingTree<> onePointTree(info, 3);
+  onePointTree.MiniBatchTrain(dataset, labels, 1);
+
+  HoeffdingTree<> miniBatchTree(info, 3);
+  miniBatchTree.MiniBatchTrain(dataset, labels, 1000);
+
+  BOOST_REQUIRE_GT(streamTree.NumChildren(), 0);
+  BOOST_REQUIRE_EQUAL(onePointTree.NumDescendants(),
+      streamTree.NumDescendants());
+  BOOST_REQUIRE_EQUAL(onePointTree.SplitDimension(),
+      streamTree.SplitDimension());
+  BOOST_REQUIRE_GT(miniBatchTree.NumChildren(), 0);
+
+  arma::Row<size_t> streamPredictions, onePointPredictions,
+      miniBatchPredictions;
+  streamTree.Classify(dataset, streamPredictions);
+  onePointTree.Classify(dataset, onePointPredictions);
+  miniBatchTree.Classify(dataset, miniBatchPredictions);
+
+  for (size_t i = 0; i < 9000; ++i)
+    BOOST_REQUIRE_EQUAL(onePointPredictions[i], streamPredictions[i]);
+
+  const size_t miniBatchCorrect = arma::accu(miniBatchPredictions == labels);
+  BOOST_REQUIRE_GT(miniBatchCorrect, 6000);
+}
+
+/**
+ * Make sure that the compact copy built by Flatten() gives the same predictions
+ * as the tree, and that training the tree drops it.
+ */
+BOOST_AUTO_TEST_CASE(FlattenTest)
+{
+  // Generate data with two numeric dimensions and one categorical dimension,
+  // all related to the label.
+  arma::mat dataset(3, 9000);
+  arma::Row<size_t> labels(9000);
+  data::DatasetInfo info(3);
+  info.MapString<size_t>("cat0", 2);
+  info.MapString<size_t>("cat1", 2);
+  info.MapString<size_t>("cat2", 2);
+  for (size_t i = 0; i < 9000; ++i)
+  {
+    labels[i] = i % 3;
+    dataset(0, i) = mlpack::math::Random() + 0.5 * labels[i];
+    dataset(1, i) = mlpack::math::Random() + labels[i];
+    dataset(2, i) = (mlpack::math::Random() < 0.7) ? labels[i] :
+        mlpack::math::RandInt(3);
+  }
+
+  HoeffdingTree<> tree(dataset, info, labels, 3);
+  BOOST_REQUIRE_GT(tree.NumChildren(), 0);
+  BOOST_REQUIRE(!tree.Flattened());
+
+  arma::Row<size_t> predictions;
+  arma::rowvec probabilities;
+  tree.Classify(dataset, predictions, probabilities);
+
+  tree.Flatten();
+  BOOST_REQUIRE(tree.Flattened());
+
+  arma::Row<size_t> flatPredictions;
+  arma::rowvec flatProbabilities;
+  tree.Classify(dataset, flatPredictions, flatProbabilities);
+
+  for (size_t i = 0; i < 9000; ++i)
+  {
+    BOOST_REQUIRE_EQUAL(flatPredictions[i], predictions[i]);
+    BOOST_REQUIRE_EQUAL(flatProbabilities[i], probabilities[i]);
+    BOOST_REQUIRE_EQUAL(tree.Classify(dataset.col(i)), predictions[i]);
+  }
+
+  // A copy keeps the compact copy.
+  HoeffdingTree<> copy(tree);
+  BOOST_REQUIRE(copy.Flattened());
+
+  // Training drops it.
+  tree.Train(dataset.col(0), labels[0]);
+  BOOST_REQUIRE(!tree.Flattened());
+}
+
 /**
  * Make sure that batch training mode outperforms non-batch mode.
  */
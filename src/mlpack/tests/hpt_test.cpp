@@ -15,7 +15,9 @@
 #include <mlpack/core/hpt/cv_function.hpp>
 #include <mlpack/core/hpt/fixed.hpp>
 #include <mlpack/core/hpt/hpt.hpp>
+#include <mlpack/core/optimizers/bayesian_optimization/bayesian_optimization.hpp>
 #include <mlpack/core/optimizers/grid_search/grid_search.hpp>
+#include <mlpack/core/optimizers/random_search/random_search.hpp>
 #include <mlpack/core/optimizers/gradient_descent/gradient_descent.cpp>
 #include <mlpack/methods/lars/lars.hpp>
 #include <mlpack/methods/logistic_regression/logistic_regression.hpp>
@@ -80,10 +82,11 @@ class QuadraticFunction
                     double xMin = 0.0,
                     double yMin = 0.0,
                     double zMin = 0.0) :
-      a(a), b(b), c(c), d(d), xMin(xMin), yMin(yMin), zMin(zMin) {}
+      a(a), b(b), c(c), d(d), xMin(xMin), yMin(yMin), zMin(zMin), calls(0) {}
 
   double Evaluate(double x, double y, double z)
   {
+    ++calls;
     return a * pow(x - xMin, 2)  + b * pow(y - yMin, 2) + c * pow(z - zMin, 2)
         + d;
   }
@@ -95,8 +98,12 @@ class QuadraticFunction
     return MLAlgorithm();
   }
 
+  // The number of times Evaluate() has been called.
+  size_t Calls() const { return calls; }
+
  private:
   double a, b, c, d, xMin, yMin, zMin;
+  size_t calls;
 };
 
 /**
@@ -134,6 +141,29 @@ BOOST_AUTO_TEST_CASE(CVFunctionGradientTest)
   BOOST_REQUIRE_CLOSE(gradient(2), aproximateZPartialDerivative, 1e-5);
 }
 
+/**
+ * Test CVFunction does not run cross-validation again for parameters it has
+ * already evaluated, including the ones the gradient is computed at.
+ */
+BOOST_AUTO_TEST_CASE(CVFunctionCacheTest)
+{
+  QuadraticFunction<LARS> lf(1.0, -1.5, 2.5, 3.0);
+  CVFunction<decltype(lf), LARS, 3> cvFun(lf, 0.01, 0.001);
+
+  const arma::vec parameters("0.0 -1.0 2.0");
+  const double objective = cvFun.Evaluate(parameters);
+  BOOST_REQUIRE_EQUAL(lf.Calls(), 1);
+
+  arma::mat gradient;
+  cvFun.Gradient(parameters, gradient);
+  BOOST_REQUIRE_EQUAL(lf.Calls(), 4);
+  BOOST_REQUIRE_EQUAL(cvFun.NumEvaluations(), 4);
+
+  BOOST_REQUIRE_EQUAL(cvFun.Evaluate(parameters), objective);
+  cvFun.Gradient(parameters, gradient);
+  BOOST_REQUIRE_EQUAL(lf.Calls(), 4);
+}
+
 
 void InitProneToOverfittingData(arma::mat& xs,
                                 arma::rowvec& ys,
@@ -228,6 +258,135 @@ BOOST_AUTO_TEST_CASE(GridSearchTest)
   BOOST_REQUIRE_CLOSE(expectedLambda2, actualParameters(1, 0), 1e-5);
 }
 
+/**
+ * A function with a const Evaluate(), which GridSearch can evaluate with
+ * several threads.  Its minimum is reached at two points of the grid.
+ */
+class ConstQuadraticFunction
+{
+ public:
+  double Evaluate(const arma::mat& x) const
+  {
+    return std::pow(std::abs(x(0)) - 1.0, 2) + std::pow(x(1) - 2.0, 2);
+  }
+};
+
+/**
+ * Test that grid-search optimization of a thread-safe function finds the first
+ * of the best points of the grid.
+ */
+BOOST_AUTO_TEST_CASE(GridSearchConstFunctionTest)
+{
+  IncrementPolicy policy(true);
+  DatasetMapper<IncrementPolicy, double> datasetInfo(policy, 2);
+  for (double x : {-2.0, -1.0, 0.0, 1.0, 2.0})
+    datasetInfo.MapString<size_t>(x, 0);
+  for (double y : {0.0, 1.0, 2.0, 3.0})
+    datasetInfo.MapString<size_t>(y, 1);
+
+  ConstQuadraticFunction function;
+  GridSearch optimizer;
+  arma::mat parameters;
+  double objective = optimizer.Optimize(function, parameters, datasetInfo);
+
+  BOOST_REQUIRE_SMALL(objective, 1e-10);
+  BOOST_REQUIRE_CLOSE(parameters(0, 0), -1.0, 1e-5);
+  BOOST_REQUIRE_CLOSE(parameters(1, 0), 2.0, 1e-5);
+}
+
+/**
+ * Test that random-search optimization evaluates the whole grid when it has
+ * fewer points than asked for, and that otherwise it returns one of the points
+ * of the grid with its objective.
+ */
+BOOST_AUTO_TEST_CASE(RandomSearchTest)
+{
+  IncrementPolicy policy(true);
+  DatasetMapper<IncrementPolicy, double> datasetInfo(policy, 2);
+  for (double x : {-2.0, -1.0, 0.0, 1.0, 2.0})
+    datasetInfo.MapString<size_t>(x, 0);
+  for (double y : {0.0, 1.0, 2.0, 3.0})
+    datasetInfo.MapString<size_t>(y, 1);
+
+  ConstQuadraticFunction function;
+  RandomSearch optimizer(100);
+  arma::mat parameters;
+  double objective = optimizer.Optimize(function, parameters, datasetInfo);
+
+  BOOST_REQUIRE_SMALL(objective, 1e-10);
+  BOOST_REQUIRE_CLOSE(std::abs(parameters(0, 0)), 1.0, 1e-5);
+  BOOST_REQUIRE_CLOSE(parameters(1, 0), 2.0, 1e-5);
+
+  optimizer.NumPoints() = 5;
+  objective = optimizer.Optimize(function, parameters, datasetInfo);
+
+  BOOST_REQUIRE_CLOSE(objective, function.Evaluate(parameters), 1e-5);
+  BOOST_REQUIRE_EQUAL(std::round(parameters(0, 0)), parameters(0, 0));
+  BOOST_REQUIRE_EQUAL(std::round(parameters(1, 0)), parameters(1, 0));
+}
+
+/**
+ * Test that Bayesian optimization finds a point close to the minimum of a
+ * smooth function on a fine grid with a small fraction of the evaluations,
+ * choosing several points at once.
+ */
+BOOST_AUTO_TEST_CASE(BayesianOptimizationTest)
+{
+  IncrementPolicy policy(true);
+  DatasetMapper<IncrementPolicy, double> datasetInfo(policy, 2);
+  for (size_t i = 0; i <= 40; ++i)
+  {
+    datasetInfo.MapString<size_t>(0.1 * i, 0);
+    datasetInfo.MapString<size_t>(0.1 * i, 1);
+  }
+
+  ConstQuadraticFunction function;
+  BayesianOptimization optimizer(60, 10, 4);
+  arma::mat parameters;
+  double objective = optimizer.Optimize(function, parameters, datasetInfo);
+
+  BOOST_REQUIRE_LT(objective, 0.1);
+  BOOST_REQUIRE_CLOSE(objective, function.Evaluate(parameters), 1e-5);
+}
+
+/**
+ * Test HyperParameterTuner with random search and Bayesian optimization
+ * evaluating the whole grid.
+ */
+BOOST_AUTO_TEST_CASE(HPTRandomSearchBayesianOptimizationTest)
+{
+  arma::mat xs;
+  arma::rowvec ys;
+  double validationSize;
+  InitProneToOverfittingData(xs, ys, validationSize);
+
+  bool transposeData = true;
+  bool useCholesky = false;
+  arma::vec lambda1Set("0 0.001 0.01 0.1 1.0 10.0 100.0");
+  arma::vec lambda2Set("0.0 0.05 0.5 5.0");
+
+  double expectedLambda1, expectedLambda2, expectedObjective;
+  FindLARSBestLambdas(xs, ys, validationSize, transposeData, useCholesky,
+      lambda1Set, lambda2Set, expectedLambda1, expectedLambda2,
+      expectedObjective);
+
+  HyperParameterTuner<LARS, MSE, SimpleCV, RandomSearch>
+      randomHpt(validationSize, xs, ys);
+  randomHpt.Optimizer().NumPoints() = 28;
+  randomHpt.Optimize(Fixed(transposeData), Fixed(useCholesky), lambda1Set,
+      lambda2Set);
+
+  BOOST_REQUIRE_CLOSE(expectedObjective, randomHpt.BestObjective(), 1e-5);
+
+  HyperParameterTuner<LARS, MSE, SimpleCV, BayesianOptimization>
+      bayesianHpt(validationSize, xs, ys);
+  bayesianHpt.Optimizer().MaxEvaluations() = 28;
+  bayesianHpt.Optimize(Fixed(transposeData), Fixed(useCholesky), lambda1Set,
+      lambda2Set);
+
+  BOOST_REQUIRE_CLOSE(expectedObjective, bayesianHpt.BestObjective(), 1e-5);
+}
+
 /**
  * Test HyperParameterTuner.
  */
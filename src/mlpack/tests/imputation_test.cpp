@@ -266,6 +266,61 @@ BOOST_AUTO_TEST_CASE(ListwiseDeletionTest)
   BOOST_REQUIRE_CLOSE(rowWiseInput(1, 3), 8.0, 1e-5);
 }
 
+/**
+ * Impute several dimensions of the given matrix at once with the given
+ * strategy, and make sure the result is the same as imputing them one after
+ * the other.
+ */
+template<typename StrategyType>
+void CheckImputeDimensions(StrategyType strategy,
+                           const arma::mat& input,
+                           const bool columnMajor)
+{
+  const std::vector<size_t> dimensions = { 0, 2, 3 };
+  const std::vector<double> mappedValues = { 0.0, 0.0, 0.0 };
+
+  arma::mat expected(input);
+  for (size_t j = 0; j < dimensions.size(); ++j)
+    strategy.Impute(expected, mappedValues[j], dimensions[j], columnMajor);
+
+  arma::mat actual(input);
+  strategy.Impute(actual, mappedValues, dimensions, columnMajor);
+
+  BOOST_REQUIRE_EQUAL(actual.n_rows, expected.n_rows);
+  BOOST_REQUIRE_EQUAL(actual.n_cols, expected.n_cols);
+  for (size_t i = 0; i < expected.n_elem; ++i)
+  {
+    // The dimensions that are not imputed keep their NaNs.
+    if (std::isnan(expected[i]))
+      BOOST_REQUIRE(std::isnan(actual[i]));
+    else
+      BOOST_REQUIRE_CLOSE(actual[i], expected[i], 1e-8);
+  }
+}
+
+/**
+ * Make sure every strategy imputes several dimensions at once in the same way
+ * as one dimension at a time, for column wise and row wise data.
+ */
+BOOST_AUTO_TEST_CASE(ImputeDimensionsTest)
+{
+  // Set some values to the mapped value and some to NaN.
+  arma::mat input = arma::randu<arma::mat>(5, 200) + 0.5;
+  input.elem(arma::find(arma::randu<arma::mat>(5, 200) < 0.05)).zeros();
+  input.elem(arma::find(arma::randu<arma::mat>(5, 200) < 0.02)).fill(
+      arma::datum::nan);
+  const arma::mat rowWiseInput = input.t();
+
+  CheckImputeDimensions(CustomImputation<double>(-1.0), input, true);
+  CheckImputeDimensions(CustomImputation<double>(-1.0), rowWiseInput, false);
+  CheckImputeDimensions(MeanImputation<double>(), input, true);
+  CheckImputeDimensions(MeanImputation<double>(), rowWiseInput, false);
+  CheckImputeDimensions(MedianImputation<double>(), input, true);
+  CheckImputeDimensions(MedianImputation<double>(), rowWiseInput, false);
+  CheckImputeDimensions(ListwiseDeletion<double>(), input, true);
+  CheckImputeDimensions(ListwiseDeletion<double>(), rowWiseInput, false);
+}
+
 /**
  * Make sure we can map non-strings.
  */
@@ -314,4 +369,69 @@ BOOST_AUTO_TEST_CASE(DatasetMapperPointerMapping)
   BOOST_REQUIRE_EQUAL(dm.UnmapString(2, 0), &c);
 }
 
+/**
+ * Map many repeated strings in several dimensions, and make sure that each
+ * string is mapped to the number of distinct strings seen before it in its
+ * dimension, and that every mapping can be unmapped.
+ */
+BOOST_AUTO_TEST_CASE(DatasetMapperRepeatedStringMapping)
+{
+  const size_t dimensions = 3;
+  IncrementPolicy incr(true);
+  DatasetMapper<IncrementPolicy> dm(incr, dimensions);
+
+  std::vector<std::map<std::string, size_t>> expected(dimensions);
+  for (size_t i = 0; i < 1000; ++i)
+  {
+    const size_t dimension = math::RandInt(dimensions);
+    const std::string input = "s" + std::to_string(math::RandInt(50));
+
+    // New inputs get the next mapping of the dimension.
+    if (expected[dimension].count(input) == 0)
+    {
+      const size_t next = expected[dimension].size();
+      expected[dimension][input] = next;
+    }
+
+    BOOST_REQUIRE_EQUAL(dm.MapString<size_t>(input, dimension),
+        expected[dimension][input]);
+  }
+
+  for (size_t d = 0; d < dimensions; ++d)
+  {
+    BOOST_REQUIRE_EQUAL(dm.NumMappings(d), expected[d].size());
+    BOOST_REQUIRE(dm.Type(d) == data::Datatype::categorical);
+    for (std::map<std::string, size_t>::const_iterator it =
+        expected[d].begin(); it != expected[d].end(); ++it)
+    {
+      BOOST_REQUIRE_EQUAL(dm.UnmapValue(it->first, d), it->second);
+      BOOST_REQUIRE_EQUAL(dm.UnmapString(it->second, d), it->first);
+    }
+
+    BOOST_REQUIRE_THROW(dm.UnmapValue("unknown", d), std::invalid_argument);
+    BOOST_REQUIRE_THROW(dm.UnmapString(expected[d].size(), d),
+        std::invalid_argument);
+  }
+
+  // A dimension without mappings must not get any by a failed lookup.
+  DatasetMapper<IncrementPolicy> empty(incr, 1);
+  BOOST_REQUIRE_THROW(empty.UnmapValue("s0", 0), std::invalid_argument);
+  BOOST_REQUIRE_EQUAL(empty.NumMappings(0), 0);
+  BOOST_REQUIRE(empty.Type(0) == data::Datatype::numeric);
+
+  // With MissingPolicy, every missing string maps to NaN, is recorded once, and
+  // numbers are not mapped.
+  MissingPolicy miss({"a", "b"});
+  DatasetMapper<MissingPolicy> missing(miss, 1);
+  BOOST_REQUIRE(std::isnan(missing.MapString<double>("a", 0)));
+  BOOST_REQUIRE(std::isnan(missing.MapString<double>("b", 0)));
+  BOOST_REQUIRE(std::isnan(missing.MapString<double>("a", 0)));
+  BOOST_REQUIRE_EQUAL(missing.MapString<double>("1.5", 0), 1.5);
+  BOOST_REQUIRE_EQUAL(missing.NumMappings(0), 2);
+  const double nan = std::numeric_limits<double>::quiet_NaN();
+  BOOST_REQUIRE_EQUAL(missing.NumUnmappings(nan, 0), 2);
+  BOOST_REQUIRE_EQUAL(missing.UnmapString(nan, 0, 0), "a");
+  BOOST_REQUIRE_EQUAL(missing.UnmapString(nan, 0, 1), "b");
+}
+
 BOOST_AUTO_TEST_SUITE_END();
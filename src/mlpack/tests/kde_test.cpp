@@ -0,0 +1,315 @@
+/**
+ * @file kde_test.cpp
+ *
+ * Tests for the KDE class and the KDEModel class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/methods/kde/kde.hpp>
+#include <mlpack/methods/kde/kde_model.hpp>
+#include <boost/test/unit_test.hpp>
+#include "test_tools.hpp"
+#include "serialization.hpp"
+
+using namespace mlpack;
+using namespace mlpack::kde;
+using namespace mlpack::kernel;
+using namespace mlpack::metric;
+using namespace mlpack::tree;
+
+BOOST_AUTO_TEST_SUITE(KDETest);
+
+/**
+ * Compute the density estimates by hand.
+ */
+template<typename KernelType>
+arma::vec BruteForceKDE(const arma::mat& referenceSet,
+                        const arma::mat& querySet,
+                        KernelType& kernel)
+{
+  arma::vec estimations(querySet.n_cols, arma::fill::zeros);
+  for (size_t i = 0; i < querySet.n_cols; ++i)
+    for (size_t j = 0; j < referenceSet.n_cols; ++j)
+      estimations[i] += kernel.Evaluate(EuclideanDistance::Evaluate(
+          querySet.col(i), referenceSet.col(j)));
+
+  estimations /= referenceSet.n_cols;
+  return estimations;
+}
+
+/**
+ * Make sure that naive KDE with the Gaussian kernel gives the normalized
+ * average of the kernel values.
+ */
+BOOST_AUTO_TEST_CASE(NaiveGaussianTest)
+{
+  arma::mat referenceSet = arma::randu<arma::mat>(3, 200);
+  arma::mat querySet = arma::randu<arma::mat>(3, 50);
+  GaussianKernel kernel(0.3);
+
+  arma::vec expected = BruteForceKDE(referenceSet, querySet, kernel);
+  expected /= kernel.Normalizer(3);
+
+  KDE<> kde(0.0, 0.0, kernel, EuclideanDistance(), true);
+  kde.Train(referenceSet);
+  arma::vec estimations;
+  kde.Evaluate(querySet, estimations);
+
+  BOOST_REQUIRE_EQUAL(estimations.n_elem, querySet.n_cols);
+  for (size_t i = 0; i < estimations.n_elem; ++i)
+    BOOST_REQUIRE_CLOSE(estimations[i], expected[i], 1e-8);
+}
+
+/**
+ * With no error tolerance, tree-based KDE must give the naive results, in
+ * both single-tree and dual-tree mode, and for bichromatic and monochromatic
+ * evaluation.
+ */
+template<typename KernelType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void CheckExact(const KernelType& kernel)
+{
+  arma::mat referenceSet = arma::randu<arma::mat>(3, 500);
+  arma::mat querySet = arma::randu<arma::mat>(3, 200);
+
+  KDE<KernelType, EuclideanDistance, arma::mat, TreeType> naive(0.0, 0.0,
+      kernel, EuclideanDistance(), true);
+  naive.Train(referenceSet);
+  arma::vec naiveEstimations, naiveMonoEstimations;
+  naive.Evaluate(querySet, naiveEstimations);
+  naive.Evaluate(naiveMonoEstimations);
+
+  for (size_t mode = 0; mode < 2; ++mode)
+  {
+    KDE<KernelType, EuclideanDistance, arma::mat, TreeType> kde(0.0, 0.0,
+        kernel, EuclideanDistance(), false, mode == 1);
+    kde.Train(referenceSet);
+
+    arma::vec estimations, monoEstimations;
+    kde.Evaluate(querySet, estimations);
+    kde.Evaluate(monoEstimations);
+
+    BOOST_REQUIRE_EQUAL(estimations.n_elem, naiveEstimations.n_elem);
+    for (size_t i = 0; i < estimations.n_elem; ++i)
+    {
+      if (std::abs(naiveEstimations[i]) < 1e-10)
+        BOOST_REQUIRE_SMALL(estimations[i], 1e-10);
+      else
+        BOOST_REQUIRE_CLOSE(estimations[i], naiveEstimations[i], 1e-5);
+    }
+
+    BOOST_REQUIRE_EQUAL(monoEstimations.n_elem, naiveMonoEstimations.n_elem);
+    for (size_t i = 0; i < monoEstimations.n_elem; ++i)
+    {
+      if (std::abs(naiveMonoEstimations[i]) < 1e-10)
+        BOOST_REQUIRE_SMALL(monoEstimations[i], 1e-10);
+      else
+        BOOST_REQUIRE_CLOSE(monoEstimations[i], naiveMonoEstimations[i], 1e-5);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(ExactKDTreeTest)
+{
+  CheckExact<GaussianKernel, KDTree>(GaussianKernel(0.2));
+  CheckExact<EpanechnikovKernel, KDTree>(EpanechnikovKernel(0.3));
+}
+
+BOOST_AUTO_TEST_CASE(ExactBallTreeTest)
+{
+  CheckExact<GaussianKernel, BallTree>(GaussianKernel(0.2));
+  CheckExact<TriangularKernel, BallTree>(TriangularKernel(0.3));
+}
+
+BOOST_AUTO_TEST_CASE(ExactCoverTreeTest)
+{
+  CheckExact<GaussianKernel, StandardCoverTree>(GaussianKernel(0.2));
+  CheckExact<SphericalKernel, StandardCoverTree>(SphericalKernel(0.3));
+}
+
+BOOST_AUTO_TEST_CASE(ExactOctreeTest)
+{
+  CheckExact<GaussianKernel, Octree>(GaussianKernel(0.2));
+  CheckExact<LaplacianKernel, Octree>(LaplacianKernel(0.3));
+}
+
+/**
+ * Make sure that every estimate is within the error tolerances of the true
+ * estimate, in single-tree and dual-tree mode.
+ */
+BOOST_AUTO_TEST_CASE(ErrorToleranceTest)
+{
+  arma::mat referenceSet = arma::randu<arma::mat>(2, 2000);
+  arma::mat querySet = arma::randu<arma::mat>(2, 500);
+  GaussianKernel kernel(0.1);
+  const double relError = 0.05;
+  const double absError = 1e-3;
+
+  // The tolerances apply before normalization, to the sums of kernel values
+  // divided by the number of reference points.
+  const arma::vec expected = BruteForceKDE(referenceSet, querySet, kernel);
+
+  for (size_t mode = 0; mode < 2; ++mode)
+  {
+    KDE<> kde(relError, absError, kernel, EuclideanDistance(), false,
+        mode == 1);
+    kde.Train(referenceSet);
+
+    arma::vec estimations;
+    kde.Evaluate(querySet, estimations);
+    estimations *= kernel.Normalizer(2);
+
+    for (size_t i = 0; i < estimations.n_elem; ++i)
+    {
+      BOOST_REQUIRE_LE(std::abs(estimations[i] - expected[i]),
+          absError + relError * expected[i] + 1e-10);
+    }
+
+    // The tolerances should have allowed some pruning.
+    BOOST_REQUIRE_LT(kde.BaseCases(), referenceSet.n_cols * querySet.n_cols);
+  }
+}
+
+/**
+ * Make sure that parallel evaluation gives the same results as serial
+ * evaluation.
+ */
+BOOST_AUTO_TEST_CASE(ParallelTest)
+{
+  arma::mat referenceSet = arma::randu<arma::mat>(3, 2000);
+  arma::mat querySet = arma::randu<arma::mat>(3, 1000);
+
+  for (size_t mode = 0; mode < 3; ++mode)
+  {
+    KDE<> kde(0.05, 0.0, GaussianKernel(0.2), EuclideanDistance(), mode == 2,
+        mode == 1);
+    kde.Train(referenceSet);
+
+    arma::vec serialEstimations, serialMonoEstimations;
+    kde.Evaluate(querySet, serialEstimations);
+    kde.Evaluate(serialMonoEstimations);
+
+    kde.Parallel() = true;
+    arma::vec estimations, monoEstimations;
+    kde.Evaluate(querySet, estimations);
+    kde.Evaluate(monoEstimations);
+
+    for (size_t i = 0; i < estimations.n_elem; ++i)
+      BOOST_REQUIRE_CLOSE(estimations[i], serialEstimations[i], 1e-8);
+    for (size_t i = 0; i < monoEstimations.n_elem; ++i)
+      BOOST_REQUIRE_CLOSE(monoEstimations[i], serialMonoEstimations[i], 1e-8);
+  }
+}
+
+/**
+ * Monte Carlo estimates should be within the relative error tolerance for
+ * most query points, and parallel evaluation with the same seed should give
+ * the same results.
+ */
+BOOST_AUTO_TEST_CASE(MonteCarloTest)
+{
+  arma::mat referenceSet = arma::randu<arma::mat>(2, 5000);
+  arma::mat querySet = arma::randu<arma::mat>(2, 200);
+  GaussianKernel kernel(0.5);
+  const double relError = 0.05;
+
+  arma::vec expected = BruteForceKDE(referenceSet, querySet, kernel);
+  expected /= kernel.Normalizer(2);
+
+  KDE<> kde(relError, 0.0, kernel, EuclideanDistance(), false, true);
+  kde.MonteCarlo() = true;
+  kde.MCProbability(0.95);
+  kde.Train(referenceSet);
+
+  math::RandomSeed(1);
+  arma::vec estimations;
+  kde.Evaluate(querySet, estimations);
+
+  size_t withinTolerance = 0;
+  for (size_t i = 0; i < estimations.n_elem; ++i)
+    if (std::abs(estimations[i] - expected[i]) <= relError * expected[i])
+      ++withinTolerance;
+  BOOST_REQUIRE_GE(withinTolerance, 0.9 * estimations.n_elem);
+
+  math::RandomSeed(1);
+  kde.Parallel() = true;
+  arma::vec parallelEstimations;
+  kde.Evaluate(querySet, parallelEstimations);
+
+  for (size_t i = 0; i < estimations.n_elem; ++i)
+    BOOST_REQUIRE_CLOSE(parallelEstimations[i], estimations[i], 1e-8);
+}
+
+/**
+ * Invalid error tolerances should throw.
+ */
+BOOST_AUTO_TEST_CASE(InvalidErrorTest)
+{
+  BOOST_REQUIRE_THROW(KDE<>(-0.1, 0.0), std::invalid_argument);
+  BOOST_REQUIRE_THROW(KDE<>(1.1, 0.0), std::invalid_argument);
+  BOOST_REQUIRE_THROW(KDE<>(0.05, -1.0), std::invalid_argument);
+
+  KDE<> kde;
+  BOOST_REQUIRE_THROW(kde.RelativeError(2.0), std::invalid_argument);
+  BOOST_REQUIRE_THROW(kde.AbsoluteError(-0.5), std::invalid_argument);
+  BOOST_REQUIRE_THROW(kde.MCProbability(1.0), std::invalid_argument);
+}
+
+/**
+ * Make sure that KDEModel gives the same results as KDE for every kernel and
+ * tree type, and that it still does after serialization and copying.
+ */
+BOOST_AUTO_TEST_CASE(KDEModelTest)
+{
+  arma::mat referenceSet = arma::randu<arma::mat>(3, 300);
+  arma::mat querySet = arma::randu<arma::mat>(3, 100);
+
+  KDE<> kde(0.0, 0.0, GaussianKernel(0.2));
+  kde.Train(referenceSet);
+  arma::vec expected;
+  kde.Evaluate(querySet, expected);
+
+  for (size_t k = 0; k < 5; ++k)
+  {
+    for (size_t t = 0; t < 4; ++t)
+    {
+      KDEModel model(0.2, 0.0, 0.0, (KDEModel::KernelTypes) k,
+          (KDEModel::TreeTypes) t);
+      model.BuildModel(arma::mat(referenceSet));
+
+      arma::vec estimations;
+      model.Evaluate(arma::mat(querySet), estimations);
+      BOOST_REQUIRE_EQUAL(estimations.n_elem, querySet.n_cols);
+
+      if (k == KDEModel::GAUSSIAN_KERNEL)
+      {
+        for (size_t i = 0; i < estimations.n_elem; ++i)
+          BOOST_REQUIRE_CLOSE(estimations[i], expected[i], 1e-5);
+      }
+
+      KDEModel xmlModel, textModel, binaryModel;
+      SerializeObjectAll(model, xmlModel, textModel, binaryModel);
+      KDEModel copy(model);
+
+      arma::vec xmlEstimations, textEstimations, binaryEstimations,
+          copyEstimations;
+      xmlModel.Evaluate(arma::mat(querySet), xmlEstimations);
+      textModel.Evaluate(arma::mat(querySet), textEstimations);
+      binaryModel.Evaluate(arma::mat(querySet), binaryEstimations);
+      copy.Evaluate(arma::mat(querySet), copyEstimations);
+
+      CheckMatrices(estimations, xmlEstimations);
+      CheckMatrices(estimations, textEstimations);
+      CheckMatrices(estimations, binaryEstimations);
+      CheckMatrices(estimations, copyEstimations);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_SUITE_END();
@@ -150,4 +150,147 @@ BOOST_AUTO_TEST_CASE(CircleTransformationTestNystroem)
   BOOST_REQUIRE_EQUAL(ranges[1].Contains(ranges[2]), false);
 }
 
+/**
+ * If KernelPCA is working right, then it should turn a circle dataset into a
+ * linearly separable dataset in one dimension (which is easy to check).
+ */
+BOOST_AUTO_TEST_CASE(CircleTransformationTestRandomized)
+{
+  // The dataset, which will have three concentric rings in three dimensions.
+  arma::mat dataset;
+
+  // Now, there are 750 points centered at the origin with unit variance.
+  dataset.randn(3, 750);
+  dataset *= 0.05;
+
+  // Take the second 250 points and spread them away from the origin.
+  for (size_t i = 250; i < 500; ++i)
+  {
+    // Push the point away from the origin by 2.
+    const double pointNorm = norm(dataset.col(i), 2);
+
+    dataset(0, i) += 2.0 * (dataset(0, i) / pointNorm);
+    dataset(1, i) += 2.0 * (dataset(1, i) / pointNorm);
+    dataset(2, i) += 2.0 * (dataset(2, i) / pointNorm);
+  }
+
+  // Take the third 500 points and spread them away from the origin.
+  for (size_t i = 500; i < 750; ++i)
+  {
+    // Push the point away from the origin by 5.
+    const double pointNorm = norm(dataset.col(i), 2);
+
+    dataset(0, i) += 5.0 * (dataset(0, i) / pointNorm);
+    dataset(1, i) += 5.0 * (dataset(1, i) / pointNorm);
+    dataset(2, i) += 5.0 * (dataset(2, i) / pointNorm);
+  }
+
+  // Now we have a dataset; we will use the GaussianKernel to perform KernelPCA
+  // using the randomized method to take it down to one dimension.
+  KernelPCA<GaussianKernel, RandomizedKernelRule<GaussianKernel> > p;
+  p.Apply(dataset, 1);
+
+  // Get the ranges of each "class".  These are all initialized as empty ranges
+  // containing no points.
+  Range ranges[3];
+  ranges[0] = Range();
+  ranges[1] = Range();
+  ranges[2] = Range();
+
+  // Expand the ranges to hold all of the points in the class.
+  for (size_t i = 0; i < 250; ++i)
+    ranges[0] |= dataset(0, i);
+  for (size_t i = 250; i < 500; ++i)
+    ranges[1] |= dataset(0, i);
+  for (size_t i = 500; i < 750; ++i)
+    ranges[2] |= dataset(0, i);
+
+  // None of these ranges should overlap -- the classes should be linearly
+  // separable.
+  BOOST_REQUIRE_EQUAL(ranges[0].Contains(ranges[1]), false);
+  BOOST_REQUIRE_EQUAL(ranges[0].Contains(ranges[2]), false);
+  BOOST_REQUIRE_EQUAL(ranges[1].Contains(ranges[2]), false);
+}
+
+/**
+ * The randomized method should find the same top eigenvalues as the naive
+ * method.
+ */
+BOOST_AUTO_TEST_CASE(RandomizedEigenvaluesTest)
+{
+  arma::mat dataset(4, 400, arma::fill::randu);
+
+  arma::mat naiveTransformed, naiveEigvec, transformed, eigvec;
+  arma::vec naiveEigval, eigval;
+  KernelPCA<GaussianKernel> naive(GaussianKernel(0.5));
+  naive.Apply(dataset, naiveTransformed, naiveEigval, naiveEigvec, 3);
+
+  KernelPCA<GaussianKernel, RandomizedKernelRule<GaussianKernel> > randomized(
+      GaussianKernel(0.5));
+  randomized.Apply(dataset, transformed, eigval, eigvec, 3);
+
+  BOOST_REQUIRE_EQUAL(eigval.n_elem, 3);
+  BOOST_REQUIRE_EQUAL(eigvec.n_rows, dataset.n_cols);
+  BOOST_REQUIRE_EQUAL(eigvec.n_cols, 3);
+  BOOST_REQUIRE_EQUAL(transformed.n_rows, 3);
+  BOOST_REQUIRE_EQUAL(transformed.n_cols, dataset.n_cols);
+  for (size_t i = 0; i < 3; ++i)
+  {
+    BOOST_REQUIRE_CLOSE(eigval[i], naiveEigval[i], 1.0);
+
+    // The eigenvectors may have opposite signs.
+    const double similarity = arma::dot(eigvec.col(i), naiveEigvec.col(i));
+    BOOST_REQUIRE_CLOSE(std::abs(similarity), 1.0, 1.0);
+  }
+}
+
+/**
+ * Projecting the reference points with Transform() should give the same
+ * result as Apply().
+ */
+BOOST_AUTO_TEST_CASE(TransformReferencePointsTest)
+{
+  arma::mat dataset(3, 200, arma::fill::randu);
+
+  for (size_t center = 0; center < 2; ++center)
+  {
+    KernelPCA<GaussianKernel> p(GaussianKernel(0.8), (center == 1));
+    arma::mat transformed, eigvec;
+    arma::vec eigval;
+    p.Apply(dataset, transformed, eigval, eigvec, 2);
+
+    arma::mat projected;
+    p.Transform(dataset, projected);
+
+    BOOST_REQUIRE_EQUAL(projected.n_rows, 2);
+    BOOST_REQUIRE_EQUAL(projected.n_cols, dataset.n_cols);
+    for (size_t i = 0; i < projected.n_elem; ++i)
+    {
+      const double expected = transformed(i % 2, i / 2);
+      if (std::abs(expected) < 1e-5)
+        BOOST_REQUIRE_SMALL(projected[i], 1e-5);
+      else
+        BOOST_REQUIRE_CLOSE(projected[i], expected, 1e-3);
+    }
+  }
+}
+
+/**
+ * Transform() can't be used before Apply(), or with the Nystroem method.
+ */
+BOOST_AUTO_TEST_CASE(TransformWithoutComponentsTest)
+{
+  arma::mat dataset(3, 100, arma::fill::randu);
+  arma::mat projected;
+
+  KernelPCA<GaussianKernel> p;
+  BOOST_REQUIRE_THROW(p.Transform(dataset, projected), std::logic_error);
+
+  KernelPCA<GaussianKernel, NystroemKernelRule<GaussianKernel> > nystroem;
+  arma::mat transformed = dataset;
+  nystroem.Apply(transformed, 2);
+  BOOST_REQUIRE_THROW(nystroem.Transform(dataset, projected),
+      std::logic_error);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -10,13 +10,16 @@
  * 3-clause BSD license along with mlpack.  If not, see
  * http://www.opensource.org/licenses/BSD-3-Clause for more information.
  */
+#include <mlpack/core/kernels/cached_kernel.hpp>
 #include <mlpack/core/kernels/cosine_distance.hpp>
 #include <mlpack/core/kernels/epanechnikov_kernel.hpp>
 #include <mlpack/core/kernels/gaussian_kernel.hpp>
 #include <mlpack/core/kernels/hyperbolic_tangent_kernel.hpp>
+#include <mlpack/core/kernels/kernel_matrix.hpp>
 #include <mlpack/core/kernels/laplacian_kernel.hpp>
 #include <mlpack/core/kernels/linear_kernel.hpp>
 #include <mlpack/core/kernels/polynomial_kernel.hpp>
+#include <mlpack/core/kernels/precomputed_kernel.hpp>
 #include <mlpack/core/kernels/spherical_kernel.hpp>
 #include <mlpack/core/kernels/pspectrum_string_kernel.hpp>
 #include <mlpack/core/metrics/lmetric.hpp>
@@ -608,4 +611,183 @@ BOOST_AUTO_TEST_CASE(PSpectrumStringEvaluateTest)
   BOOST_REQUIRE_CLOSE(p.Evaluate(b, a), 11.0, 1e-5);
 }
 
+/**
+ * Make sure that KernelMatrix() gives the same results as evaluating the
+ * kernel on every pair of points, for the two-set and the symmetric version.
+ */
+template<typename KernelType>
+void CheckKernelMatrix(KernelType& kernel)
+{
+  // Enough points that more than one tile is used.
+  arma::mat a(5, 150, arma::fill::randu);
+  arma::mat b(5, 90, arma::fill::randu);
+
+  arma::mat kernelMatrix;
+  KernelMatrix(kernel, a, b, kernelMatrix);
+  BOOST_REQUIRE_EQUAL(kernelMatrix.n_rows, a.n_cols);
+  BOOST_REQUIRE_EQUAL(kernelMatrix.n_cols, b.n_cols);
+  for (size_t i = 0; i < a.n_cols; ++i)
+  {
+    for (size_t j = 0; j < b.n_cols; ++j)
+    {
+      const double value = kernel.Evaluate(a.col(i), b.col(j));
+      if (std::abs(value) < 1e-8)
+        BOOST_REQUIRE_SMALL(kernelMatrix(i, j), 1e-8);
+      else
+        BOOST_REQUIRE_CLOSE(kernelMatrix(i, j), value, 1e-5);
+    }
+  }
+
+  KernelMatrix(kernel, a, kernelMatrix);
+  BOOST_REQUIRE_EQUAL(kernelMatrix.n_rows, a.n_cols);
+  BOOST_REQUIRE_EQUAL(kernelMatrix.n_cols, a.n_cols);
+  for (size_t i = 0; i < a.n_cols; ++i)
+  {
+    for (size_t j = 0; j < a.n_cols; ++j)
+    {
+      const double value = kernel.Evaluate(a.col(i), a.col(j));
+      if (std::abs(value) < 1e-8)
+        BOOST_REQUIRE_SMALL(kernelMatrix(i, j), 1e-8);
+      else
+        BOOST_REQUIRE_CLOSE(kernelMatrix(i, j), value, 1e-5);
+    }
+  }
+}
+
+/**
+ * Test KernelMatrix() for kernels with a matrix multiplication overload, for
+ * kernels of the squared distance, and for the generic tiled version.
+ */
+BOOST_AUTO_TEST_CASE(KernelMatrixTest)
+{
+  LinearKernel linear;
+  CheckKernelMatrix(linear);
+
+  PolynomialKernel polynomial(3.0, 1.5);
+  CheckKernelMatrix(polynomial);
+
+  CosineDistance cosine;
+  CheckKernelMatrix(cosine);
+
+  GaussianKernel gaussian(0.7);
+  CheckKernelMatrix(gaussian);
+
+  EpanechnikovKernel epanechnikov(1.2);
+  CheckKernelMatrix(epanechnikov);
+
+  LaplacianKernel laplacian(0.5);
+  CheckKernelMatrix(laplacian);
+
+  HyperbolicTangentKernel tangent(0.3, 0.1);
+  CheckKernelMatrix(tangent);
+}
+
+/**
+ * Make sure that the p-spectrum string kernel matrix from the encoded substring
+ * counts matches the kernel evaluated pair by pair.
+ */
+BOOST_AUTO_TEST_CASE(PSpectrumStringKernelMatrixTest)
+{
+  std::vector<std::vector<std::string> > datasets;
+  datasets.push_back(std::vector<std::string>());
+  datasets[0].push_back("hello");
+  datasets[0].push_back("jello");
+  datasets[0].push_back("mellow");
+  datasets.push_back(std::vector<std::string>());
+  datasets[1].push_back("mellow jello");
+  datasets[1].push_back("yellow bellow");
+  datasets[1].push_back("xyz");
+
+  PSpectrumStringKernel p(datasets, 3);
+
+  arma::mat a("0 0 0; 0 1 2");
+  arma::mat b("1 1 1 0; 0 1 2 1");
+
+  arma::mat kernelMatrix;
+  KernelMatrix(p, a, b, kernelMatrix);
+  BOOST_REQUIRE_EQUAL(kernelMatrix.n_rows, 3);
+  BOOST_REQUIRE_EQUAL(kernelMatrix.n_cols, 4);
+  for (size_t i = 0; i < a.n_cols; ++i)
+    for (size_t j = 0; j < b.n_cols; ++j)
+      BOOST_REQUIRE_CLOSE(kernelMatrix(i, j) + 1.0,
+          p.Evaluate(a.col(i), b.col(j)) + 1.0, 1e-5);
+
+  KernelMatrix(p, b, kernelMatrix);
+  BOOST_REQUIRE_EQUAL(kernelMatrix.n_rows, 4);
+  BOOST_REQUIRE_EQUAL(kernelMatrix.n_cols, 4);
+  for (size_t i = 0; i < b.n_cols; ++i)
+    for (size_t j = 0; j < b.n_cols; ++j)
+      BOOST_REQUIRE_CLOSE(kernelMatrix(i, j) + 1.0,
+          p.Evaluate(b.col(i), b.col(j)) + 1.0, 1e-5);
+}
+
+/**
+ * Make sure that the precomputed kernel returns the values of its kernel
+ * matrix, for single evaluations and for kernel matrices.
+ */
+BOOST_AUTO_TEST_CASE(PrecomputedKernelTest)
+{
+  arma::mat data = arma::randu<arma::mat>(3, 40);
+  GaussianKernel gaussian(0.8);
+  arma::mat gaussianMatrix;
+  KernelMatrix(gaussian, data, gaussianMatrix);
+
+  PrecomputedKernel precomputed(gaussianMatrix);
+  arma::mat indices(1, 40);
+  for (size_t i = 0; i < 40; ++i)
+    indices[i] = i;
+
+  for (size_t i = 0; i < 40; ++i)
+    for (size_t j = 0; j < 40; ++j)
+      BOOST_REQUIRE_EQUAL(precomputed.Evaluate(indices.col(i),
+          indices.col(j)), gaussianMatrix(i, j));
+
+  arma::mat kernelMatrix;
+  KernelMatrix(precomputed, indices.cols(5, 9), indices.cols(20, 29),
+      kernelMatrix);
+  BOOST_REQUIRE_EQUAL(kernelMatrix.n_rows, 5);
+  BOOST_REQUIRE_EQUAL(kernelMatrix.n_cols, 10);
+  for (size_t i = 0; i < 5; ++i)
+    for (size_t j = 0; j < 10; ++j)
+      BOOST_REQUIRE_EQUAL(kernelMatrix(i, j), gaussianMatrix(i + 5, j + 20));
+}
+
+/**
+ * Make sure that the cached kernel gives the values of the wrapped kernel, and
+ * that repeated evaluations are found in the cache.
+ */
+BOOST_AUTO_TEST_CASE(CachedKernelTest)
+{
+  arma::mat data = arma::randu<arma::mat>(3, 40);
+  HyperbolicTangentKernel tangent(0.3, 0.1);
+  CachedKernel<HyperbolicTangentKernel> cached(data, 5, tangent);
+
+  arma::mat indices(1, 40);
+  for (size_t i = 0; i < 40; ++i)
+    indices[i] = i;
+
+  // Evaluate every pair twice; the second time, the row of point i is always
+  // in the cache.
+  for (size_t i = 0; i < 40; ++i)
+  {
+    for (size_t j = 0; j < 40; ++j)
+    {
+      const double value = tangent.Evaluate(data.col(i), data.col(j));
+      BOOST_REQUIRE_CLOSE(cached.Evaluate(indices.col(i), indices.col(j)),
+          value, 1e-10);
+      BOOST_REQUIRE_CLOSE(cached.Evaluate(indices.col(i), indices.col(j)),
+          value, 1e-10);
+    }
+  }
+
+  BOOST_REQUIRE_LE(cached.Misses(), 40);
+  BOOST_REQUIRE_GE(cached.Hits(), 40 * 40);
+
+  // KernelMatrix() computes the values directly.
+  arma::mat kernelMatrix, tangentMatrix;
+  KernelMatrix(cached, indices, kernelMatrix);
+  KernelMatrix(tangent, data, tangentMatrix);
+  CheckMatrices(kernelMatrix, tangentMatrix);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -16,6 +16,9 @@
 #include <mlpack/methods/kmeans/hamerly_kmeans.hpp>
 #include <mlpack/methods/kmeans/pelleg_moore_kmeans.hpp>
 #include <mlpack/methods/kmeans/dual_tree_kmeans.hpp>
+#include <mlpack/methods/kmeans/mini_batch_kmeans.hpp>
+#include <mlpack/methods/kmeans/kmeans_plus_plus_initialization.hpp>
+#include <mlpack/methods/kmeans/kmeans_parallel_initialization.hpp>
 #include <mlpack/methods/kmeans/sample_initialization.hpp>
 #include <mlpack/methods/kmeans/random_partition.hpp>
 
@@ -568,6 +571,53 @@ BOOST_AUTO_TEST_CASE(HamerlyTest)
   }
 }
 
+/**
+ * Cluster the given dataset with the given k-means step type, starting from the
+ * given centroids, once with one thread and once with all of them, and make
+ * sure that the results are the same.
+ */
+template<template<class, class> class LloydStepType>
+void CheckParallelKMeans(const arma::mat& dataset, const arma::mat& centroids)
+{
+  KMeans<EuclideanDistance, RandomPartition, MaxVarianceNewCluster,
+      LloydStepType> km;
+
+  arma::Row<size_t> sequentialAssignments;
+  arma::mat sequentialCentroids(centroids);
+  {
+    Parallel::Scope scope(1);
+    km.Cluster(dataset, centroids.n_cols, sequentialAssignments,
+        sequentialCentroids, false, true);
+  }
+
+  arma::Row<size_t> parallelAssignments;
+  arma::mat parallelCentroids(centroids);
+  km.Cluster(dataset, centroids.n_cols, parallelAssignments, parallelCentroids,
+      false, true);
+
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+    BOOST_REQUIRE_EQUAL(sequentialAssignments[i], parallelAssignments[i]);
+
+  for (size_t i = 0; i < centroids.n_elem; ++i)
+    BOOST_REQUIRE_CLOSE(sequentialCentroids[i], parallelCentroids[i], 1e-5);
+}
+
+/**
+ * Make sure that the parallel iterations of Elkan's and Hamerly's algorithms
+ * give the same clusters as the sequential ones.
+ */
+BOOST_AUTO_TEST_CASE(ElkanHamerlyParallelTest)
+{
+  arma::mat dataset(10, 2000);
+  dataset.randu();
+
+  arma::mat centroids(10, 20);
+  centroids.randu();
+
+  CheckParallelKMeans<ElkanKMeans>(dataset, centroids);
+  CheckParallelKMeans<HamerlyKMeans>(dataset, centroids);
+}
+
 BOOST_AUTO_TEST_CASE(PellegMooreTest)
 {
   const size_t trials = 5;
@@ -666,6 +716,183 @@ BOOST_AUTO_TEST_CASE(DTNNCoverTreeTest)
   }
 }
 
+/**
+ * Create a dataset of well-separated Gaussian blobs, for the seeding tests.
+ */
+void CreateBlobs(const size_t blobs, arma::mat& means, arma::mat& dataset)
+{
+  means = 100.0 * arma::randu<arma::mat>(3, blobs);
+  // Make sure the blobs are far apart.
+  for (size_t i = 0; i < blobs; ++i)
+    means(0, i) += 200.0 * i;
+
+  dataset.set_size(3, 200 * blobs);
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+    dataset.col(i) = means.col(i % blobs) + arma::randn<arma::vec>(3);
+}
+
+/**
+ * Check that there is exactly one centroid in each blob.
+ */
+void CheckOneCentroidPerBlob(const arma::mat& means, const arma::mat& centroids)
+{
+  BOOST_REQUIRE_EQUAL(centroids.n_cols, means.n_cols);
+  arma::Col<size_t> found(means.n_cols, arma::fill::zeros);
+  for (size_t c = 0; c < centroids.n_cols; ++c)
+  {
+    for (size_t i = 0; i < means.n_cols; ++i)
+      if (arma::norm(centroids.col(c) - means.col(i)) < 10.0)
+        ++found[i];
+  }
+
+  for (size_t i = 0; i < means.n_cols; ++i)
+    BOOST_REQUIRE_EQUAL(found[i], 1);
+}
+
+/**
+ * Make sure that the distances computed for the seeding policies are the
+ * squared Euclidean distances to the nearest center.
+ */
+BOOST_AUTO_TEST_CASE(SeedingDistancesTest)
+{
+  arma::mat dataset(7, 200, arma::fill::randu);
+  arma::mat centers(7, 10, arma::fill::randu);
+
+  arma::vec norms;
+  KMeansPlusPlusInitialization::SquaredNorms(dataset, norms);
+  arma::vec distances(dataset.n_cols);
+  distances.fill(DBL_MAX);
+  arma::Col<size_t> nearest(dataset.n_cols);
+  KMeansPlusPlusInitialization::UpdateDistances(dataset, norms, centers, 0, 4,
+      distances, nearest);
+  KMeansPlusPlusInitialization::UpdateDistances(dataset, norms, centers, 4, 10,
+      distances, nearest);
+
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+  {
+    double minDistance = DBL_MAX;
+    size_t minCenter = 0;
+    for (size_t c = 0; c < centers.n_cols; ++c)
+    {
+      const double distance = arma::accu(arma::square(dataset.col(i) -
+          centers.col(c)));
+      if (distance < minDistance)
+      {
+        minDistance = distance;
+        minCenter = c;
+      }
+    }
+
+    BOOST_REQUIRE_CLOSE(distances[i], minDistance, 1e-5);
+    BOOST_REQUIRE_EQUAL(nearest[i], minCenter);
+  }
+}
+
+/**
+ * k-means++ should put one initial centroid in each of a set of well-separated
+ * blobs.
+ */
+BOOST_AUTO_TEST_CASE(KMeansPlusPlusTest)
+{
+  arma::mat means, dataset;
+  CreateBlobs(8, means, dataset);
+
+  arma::mat centroids;
+  KMeansPlusPlusInitialization::Cluster(dataset, 8, centroids);
+  CheckOneCentroidPerBlob(means, centroids);
+
+  // And k-means with it should find the blobs.
+  KMeans<metric::EuclideanDistance, KMeansPlusPlusInitialization> km;
+  km.Cluster(dataset, 8, centroids);
+  CheckOneCentroidPerBlob(means, centroids);
+}
+
+/**
+ * k-means|| should put one initial centroid in each of a set of well-separated
+ * blobs too.
+ */
+BOOST_AUTO_TEST_CASE(KMeansParallelTest)
+{
+  arma::mat means, dataset;
+  CreateBlobs(8, means, dataset);
+
+  arma::mat centroids;
+  KMeansParallelInitialization kmp(3);
+  kmp.Cluster(dataset, 8, centroids);
+  CheckOneCentroidPerBlob(means, centroids);
+
+  KMeans<metric::EuclideanDistance, KMeansParallelInitialization> km;
+  km.Cluster(dataset, 8, centroids);
+  CheckOneCentroidPerBlob(means, centroids);
+}
+
+/**
+ * When the batch holds the whole dataset, the first iteration of mini-batch
+ * k-means is a Lloyd iteration: each centroid becomes the mean of its points.
+ */
+BOOST_AUTO_TEST_CASE(MiniBatchFullBatchTest)
+{
+  arma::mat dataset(5, 300, arma::fill::randu);
+  arma::mat centroids(5, 6, arma::fill::randu);
+
+  metric::EuclideanDistance metric;
+  NaiveKMeans<metric::EuclideanDistance, arma::mat> naive(dataset, metric);
+  MiniBatchKMeans<metric::EuclideanDistance, arma::mat> miniBatch(dataset,
+      metric, 0);
+
+  arma::mat naiveCentroids, miniBatchCentroids;
+  arma::Col<size_t> naiveCounts, miniBatchCounts;
+  naive.Iterate(centroids, naiveCentroids, naiveCounts);
+  miniBatch.Iterate(centroids, miniBatchCentroids, miniBatchCounts);
+
+  for (size_t i = 0; i < centroids.n_cols; ++i)
+  {
+    BOOST_REQUIRE_EQUAL(naiveCounts[i], miniBatchCounts[i]);
+    if (naiveCounts[i] == 0)
+      continue;
+
+    for (size_t d = 0; d < centroids.n_rows; ++d)
+      BOOST_REQUIRE_CLOSE(naiveCentroids(d, i), miniBatchCentroids(d, i),
+          1e-5);
+  }
+}
+
+/**
+ * Make sure mini-batch k-means finds well-separated clusters from small
+ * batches.
+ */
+BOOST_AUTO_TEST_CASE(MiniBatchKMeansTest)
+{
+  const size_t k = 3;
+  arma::mat means("0.0 10.0 0.0; 0.0 0.0 10.0");
+
+  arma::mat dataset(2, 30000);
+  arma::Row<size_t> labels(dataset.n_cols);
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+  {
+    labels[i] = i % k;
+    dataset.col(i) = means.col(labels[i]) + arma::randn<arma::vec>(2);
+  }
+
+  // Start from one point of each cluster.
+  arma::mat centroids = dataset.cols(0, k - 1);
+
+  KMeans<metric::EuclideanDistance, SampleInitialization,
+      MaxVarianceNewCluster, MiniBatchKMeans> km(300);
+  arma::Row<size_t> assignments;
+  km.Cluster(dataset, k, assignments, centroids, false, true);
+
+  // Each centroid should be close to the mean of its cluster.
+  for (size_t i = 0; i < k; ++i)
+  {
+    BOOST_REQUIRE_SMALL(arma::norm(centroids.col(i) - means.col(i)), 0.2);
+  }
+
+  // Almost all points should be in the right cluster.
+  const size_t correct = arma::accu(assignments == labels);
+  BOOST_REQUIRE_GT(correct, (size_t) (0.99 * dataset.n_cols));
+}
+
 /**
  * Make sure that the sample initialization strategy successfully samples points
  * from the dataset.
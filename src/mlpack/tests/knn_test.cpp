@@ -12,10 +12,12 @@
 #include <mlpack/methods/neighbor_search/neighbor_search.hpp>
 #include <mlpack/methods/neighbor_search/unmap.hpp>
 #include <mlpack/methods/neighbor_search/ns_model.hpp>
+#include <mlpack/methods/neighbor_search/mahalanobis_search.hpp>
 #include <mlpack/core/tree/cover_tree.hpp>
 #include <mlpack/core/tree/example_tree.hpp>
 #include <boost/test/unit_test.hpp>
 #include "test_tools.hpp"
+#include "serialization.hpp"
 
 using namespace mlpack;
 using namespace mlpack::neighbor;
@@ -164,6 +166,18 @@ BOOST_AUTO_TEST_CASE(SingleTreeUnmapTest)
     BOOST_REQUIRE_EQUAL(neighborsOut[i], correctNeighbors[i]);
     BOOST_REQUIRE_CLOSE(distancesOut[i], sqrt(correctDistances[i]), 1e-5);
   }
+
+  // The same results are obtained in place with 32-bit indices.
+  const std::vector<arma::u32> compressedMap(refMap.begin(), refMap.end());
+  arma::Mat<arma::u32> compressedNeighbors =
+      arma::conv_to<arma::Mat<arma::u32>>::from(neighbors);
+  UnmapInPlace(compressedNeighbors, distances, compressedMap, true);
+
+  for (size_t i = 0; i < correctNeighbors.n_elem; ++i)
+  {
+    BOOST_REQUIRE_EQUAL(compressedNeighbors[i], correctNeighbors[i]);
+    BOOST_REQUIRE_CLOSE(distances[i], sqrt(correctDistances[i]), 1e-5);
+  }
 }
 
 /**
@@ -283,6 +297,48 @@ BOOST_AUTO_TEST_CASE(NaiveTrainTreeTest)
   BOOST_REQUIRE_THROW(empty.Train(std::move(tree)), std::invalid_argument);
 }
 
+/**
+ * Make sure that a tree shared by several NeighborSearch objects (which don't
+ * own it) gives the same results as a tree owned by one, whatever the order
+ * the searches are run in.
+ */
+BOOST_AUTO_TEST_CASE(SharedTreeTest)
+{
+  arma::mat dataset = arma::randu<arma::mat>(5, 200);
+  arma::mat querySet = arma::randu<arma::mat>(5, 50);
+
+  KNN::Tree tree(dataset);
+  KNN owner(KNN::Tree(tree), DUAL_TREE_MODE);
+
+  KNN dualTree(&tree, DUAL_TREE_MODE);
+  KNN singleTree(SINGLE_TREE_MODE);
+  singleTree.Train(&tree);
+
+  arma::Mat<size_t> neighbors, ownerNeighbors;
+  arma::mat distances, ownerDistances;
+  owner.Search(5, ownerNeighbors, ownerDistances);
+
+  // Run the monochromatic dual-tree search twice, with the other object
+  // searching in between.
+  for (size_t trial = 0; trial < 2; ++trial)
+  {
+    dualTree.Search(5, neighbors, distances);
+    CheckMatrices(neighbors, ownerNeighbors);
+    CheckMatrices(distances, ownerDistances);
+
+    singleTree.Search(5, neighbors, distances);
+    CheckMatrices(neighbors, ownerNeighbors);
+    CheckMatrices(distances, ownerDistances);
+  }
+
+  owner.Search(querySet, 5, ownerNeighbors, ownerDistances);
+  dualTree.Search(querySet, 5, neighbors, distances);
+  CheckMatrices(neighbors, ownerNeighbors);
+  CheckMatrices(distances, ownerDistances);
+
+  BOOST_REQUIRE_THROW(KNN(&tree, NAIVE_MODE), std::invalid_argument);
+}
+
 /**
  * Test that the rvalue reference move constructor works.
  */
@@ -719,6 +775,59 @@ BOOST_AUTO_TEST_CASE(DualTreeVsNaive2)
   }
 }
 
+/**
+ * Test the parallel dual-tree nearest-neighbors method against the naive
+ * method, in both the monochromatic and bichromatic settings.  When OpenMP is
+ * not available this is just the serial traversal.
+ */
+BOOST_AUTO_TEST_CASE(ParallelDualTreeVsNaive)
+{
+  arma::mat dataset;
+  if (!data::Load("test_data_3_1000.csv", dataset))
+    BOOST_FAIL("Cannot load test dataset test_data_3_1000.csv!");
+
+  arma::mat querySet = arma::randu<arma::mat>(3, 500);
+
+  KNN knn(dataset);
+  knn.Parallel() = true;
+
+  KNN naive(dataset, NAIVE_MODE);
+
+  arma::Mat<size_t> neighborsTree, neighborsNaive;
+  arma::mat distancesTree, distancesNaive;
+
+  knn.Search(15, neighborsTree, distancesTree);
+  naive.Search(15, neighborsNaive, distancesNaive);
+
+  for (size_t i = 0; i < neighborsTree.n_elem; ++i)
+  {
+    BOOST_REQUIRE_EQUAL(neighborsTree[i], neighborsNaive[i]);
+    BOOST_REQUIRE_CLOSE(distancesTree[i], distancesNaive[i], 1e-5);
+  }
+
+  knn.Search(querySet, 10, neighborsTree, distancesTree);
+  naive.Search(querySet, 10, neighborsNaive, distancesNaive);
+
+  for (size_t i = 0; i < neighborsTree.n_elem; ++i)
+  {
+    BOOST_REQUIRE_EQUAL(neighborsTree[i], neighborsNaive[i]);
+    BOOST_REQUIRE_CLOSE(distancesTree[i], distancesNaive[i], 1e-5);
+  }
+
+  // Now try with a cover tree, whose traversal is quite different.
+  NeighborSearch<NearestNeighborSort, EuclideanDistance, arma::mat,
+      StandardCoverTree> coverTreeSearch(dataset);
+  coverTreeSearch.Parallel() = true;
+
+  coverTreeSearch.Search(querySet, 10, neighborsTree, distancesTree);
+
+  for (size_t i = 0; i < neighborsTree.n_elem; ++i)
+  {
+    BOOST_REQUIRE_EQUAL(neighborsTree[i], neighborsNaive[i]);
+    BOOST_REQUIRE_CLOSE(distancesTree[i], distancesNaive[i], 1e-5);
+  }
+}
+
 /**
  * Test the single-tree nearest-neighbors method with the naive method.  This
  * uses only a reference dataset.
@@ -754,6 +863,129 @@ BOOST_AUTO_TEST_CASE(SingleTreeVsNaive)
   }
 }
 
+/**
+ * Test the parallel single-tree nearest-neighbors method against the naive
+ * method, in both the monochromatic and bichromatic settings.
+ */
+BOOST_AUTO_TEST_CASE(ParallelSingleTreeVsNaive)
+{
+  arma::mat dataset;
+  if (!data::Load("test_data_3_1000.csv", dataset))
+    BOOST_FAIL("Cannot load test dataset test_data_3_1000.csv!");
+
+  arma::mat querySet = arma::randu<arma::mat>(3, 500);
+
+  KNN knn(dataset, SINGLE_TREE_MODE);
+  knn.Parallel() = true;
+
+  KNN naive(dataset, NAIVE_MODE);
+
+  arma::Mat<size_t> neighborsTree, neighborsNaive;
+  arma::mat distancesTree, distancesNaive;
+
+  knn.Search(15, neighborsTree, distancesTree);
+  naive.Search(15, neighborsNaive, distancesNaive);
+
+  for (size_t i = 0; i < neighborsTree.n_elem; ++i)
+  {
+    BOOST_REQUIRE_EQUAL(neighborsTree[i], neighborsNaive[i]);
+    BOOST_REQUIRE_CLOSE(distancesTree[i], distancesNaive[i], 1e-5);
+  }
+
+  knn.Search(querySet, 10, neighborsTree, distancesTree);
+  naive.Search(querySet, 10, neighborsNaive, distancesNaive);
+
+  for (size_t i = 0; i < neighborsTree.n_elem; ++i)
+  {
+    BOOST_REQUIRE_EQUAL(neighborsTree[i], neighborsNaive[i]);
+    BOOST_REQUIRE_CLOSE(distancesTree[i], distancesNaive[i], 1e-5);
+  }
+}
+
+/**
+ * Test the best-first single-tree nearest-neighbors method against the naive
+ * method, with a kd-tree and a cover tree, in both the monochromatic and
+ * bichromatic settings.
+ */
+BOOST_AUTO_TEST_CASE(BestFirstVsNaive)
+{
+  arma::mat dataset;
+  if (!data::Load("test_data_3_1000.csv", dataset))
+    BOOST_FAIL("Cannot load test dataset test_data_3_1000.csv!");
+
+  arma::mat querySet = arma::randu<arma::mat>(3, 200);
+
+  KNN knn(dataset, BEST_FIRST_SINGLE_TREE_MODE);
+  NeighborSearch<NearestNeighborSort, LMetric<2>, arma::mat, StandardCoverTree>
+      coverTreeSearch(dataset, BEST_FIRST_SINGLE_TREE_MODE);
+  KNN naive(dataset, NAIVE_MODE);
+
+  arma::Mat<size_t> neighborsNaive, neighborsTree, neighborsCover;
+  arma::mat distancesNaive, distancesTree, distancesCover;
+
+  naive.Search(10, neighborsNaive, distancesNaive);
+  knn.Search(10, neighborsTree, distancesTree);
+  coverTreeSearch.Search(10, neighborsCover, distancesCover);
+
+  for (size_t i = 0; i < neighborsNaive.n_elem; ++i)
+  {
+    BOOST_REQUIRE_EQUAL(neighborsTree[i], neighborsNaive[i]);
+    BOOST_REQUIRE_CLOSE(distancesTree[i], distancesNaive[i], 1e-5);
+    BOOST_REQUIRE_EQUAL(neighborsCover[i], neighborsNaive[i]);
+    BOOST_REQUIRE_CLOSE(distancesCover[i], distancesNaive[i], 1e-5);
+  }
+
+  naive.Search(querySet, 10, neighborsNaive, distancesNaive);
+  knn.Search(querySet, 10, neighborsTree, distancesTree);
+  coverTreeSearch.Search(querySet, 10, neighborsCover, distancesCover);
+
+  for (size_t i = 0; i < neighborsNaive.n_elem; ++i)
+  {
+    BOOST_REQUIRE_EQUAL(neighborsTree[i], neighborsNaive[i]);
+    BOOST_REQUIRE_CLOSE(distancesTree[i], distancesNaive[i], 1e-5);
+    BOOST_REQUIRE_EQUAL(neighborsCover[i], neighborsNaive[i]);
+    BOOST_REQUIRE_CLOSE(distancesCover[i], distancesNaive[i], 1e-5);
+  }
+}
+
+/**
+ * Make sure that the best-first search with a maximum number of visits
+ * evaluates fewer base cases, and returns neighbors that are no closer than
+ * the true ones.
+ */
+BOOST_AUTO_TEST_CASE(BestFirstMaxVisitsTest)
+{
+  arma::mat dataset;
+  if (!data::Load("test_data_3_1000.csv", dataset))
+    BOOST_FAIL("Cannot load test dataset test_data_3_1000.csv!");
+
+  KNN knn(dataset, BEST_FIRST_SINGLE_TREE_MODE);
+  KNN naive(dataset, NAIVE_MODE);
+
+  arma::Mat<size_t> neighborsNaive, neighborsTree;
+  arma::mat distancesNaive, distancesTree;
+  naive.Search(5, neighborsNaive, distancesNaive);
+  knn.Search(5, neighborsTree, distancesTree);
+  const size_t exactBaseCases = knn.BaseCases();
+
+  // The budget is enough to reach a leaf from the root.
+  knn.MaxVisits() = 30;
+  knn.Search(5, neighborsTree, distancesTree);
+  BOOST_REQUIRE_LE(knn.BaseCases(), exactBaseCases);
+
+  // Each point still has candidates from the first leaves it visited.
+  for (size_t i = 0; i < distancesTree.n_elem; ++i)
+  {
+    BOOST_REQUIRE_LT(neighborsTree[i], dataset.n_cols);
+    BOOST_REQUIRE_GE(distancesTree[i], distancesNaive[i] - 1e-10);
+  }
+
+  // Spill trees can't be searched best-first.
+  SpillKNN spill(dataset, BEST_FIRST_SINGLE_TREE_MODE);
+  BOOST_REQUIRE_THROW(spill.Search(5, neighborsTree, distancesTree),
+      std::invalid_argument);
+}
+
 /**
  * Test the cover tree single-tree nearest-neighbors method against the naive
  * method.  This uses only a random reference dataset.
@@ -820,6 +1052,88 @@ BOOST_AUTO_TEST_CASE(DualCoverTreeTest)
   }
 }
 
+/**
+ * Make sure the dual-tree cover tree search, which reuses the base cases of the
+ * self-children, gives the naive results on high-dimensional data with
+ * duplicated points, in both the monochromatic and bichromatic settings.
+ */
+BOOST_AUTO_TEST_CASE(DualCoverTreeSelfChildTest)
+{
+  arma::mat dataset = arma::randu<arma::mat>(30, 400);
+  dataset = arma::join_rows(dataset, dataset.cols(0, 99));
+  const arma::mat querySet = arma::randu<arma::mat>(30, 150);
+
+  KNN naive(dataset, NAIVE_MODE);
+  NeighborSearch<NearestNeighborSort, EuclideanDistance, arma::mat,
+      StandardCoverTree> coverTreeSearch(dataset);
+
+  arma::Mat<size_t> naiveNeighbors, coverNeighbors;
+  arma::mat naiveDistances, coverDistances;
+  naive.Search(5, naiveNeighbors, naiveDistances);
+  coverTreeSearch.Search(5, coverNeighbors, coverDistances);
+  for (size_t i = 0; i < coverDistances.n_elem; ++i)
+    BOOST_REQUIRE_CLOSE(coverDistances(i), naiveDistances(i), 1e-5);
+
+  naive.Search(querySet, 5, naiveNeighbors, naiveDistances);
+  coverTreeSearch.Search(querySet, 5, coverNeighbors, coverDistances);
+  for (size_t i = 0; i < coverNeighbors.n_elem; ++i)
+  {
+    BOOST_REQUIRE_EQUAL(coverNeighbors(i), naiveNeighbors(i));
+    BOOST_REQUIRE_CLOSE(coverDistances(i), naiveDistances(i), 1e-5);
+  }
+}
+
+/**
+ * Make sure the tiled naive search, which filters points with distances
+ * computed by a matrix multiplication, gives the exact results of the trees
+ * on high-dimensional data, for both nearest and furthest neighbors, serially
+ * and in parallel.
+ */
+BOOST_AUTO_TEST_CASE(NaiveTileSearchTest)
+{
+  // The numbers of points are not multiples of the tile size.
+  const arma::mat dataset = arma::randu<arma::mat>(64, 700);
+  const arma::mat querySet = arma::randu<arma::mat>(64, 300);
+
+  KNN knn(dataset, SINGLE_TREE_MODE);
+  KNN naive(dataset, NAIVE_MODE);
+  KFN kfn(dataset, SINGLE_TREE_MODE);
+  KFN naiveKFN(dataset, NAIVE_MODE);
+
+  // In the monochromatic search, the duplicated points are at distance zero.
+  const arma::mat duplicated = arma::join_rows(dataset, dataset.cols(0, 49));
+  KNN duplicatedKNN(duplicated, SINGLE_TREE_MODE);
+  KNN duplicatedNaive(duplicated, NAIVE_MODE);
+
+  arma::Mat<size_t> treeNeighbors, naiveNeighbors;
+  arma::mat treeDistances, naiveDistances;
+  for (const bool parallel : { false, true })
+  {
+    naive.Parallel() = parallel;
+    naiveKFN.Parallel() = parallel;
+    duplicatedNaive.Parallel() = parallel;
+
+    knn.Search(querySet, 10, treeNeighbors, treeDistances);
+    naive.Search(querySet, 10, naiveNeighbors, naiveDistances);
+    CheckMatrices(naiveNeighbors, treeNeighbors);
+    CheckMatrices(naiveDistances, treeDistances);
+
+    kfn.Search(querySet, 10, treeNeighbors, treeDistances);
+    naiveKFN.Search(querySet, 10, naiveNeighbors, naiveDistances);
+    CheckMatrices(naiveNeighbors, treeNeighbors);
+    CheckMatrices(naiveDistances, treeDistances);
+
+    duplicatedKNN.Search(3, treeNeighbors, treeDistances);
+    duplicatedNaive.Search(3, naiveNeighbors, naiveDistances);
+    CheckMatrices(naiveDistances, treeDistances);
+    for (size_t i = 0; i < 50; ++i)
+    {
+      BOOST_REQUIRE_EQUAL(naiveDistances(0, i), 0.0);
+      BOOST_REQUIRE_EQUAL(naiveNeighbors(0, i), 700 + i);
+    }
+  }
+}
+
 /**
  * Test the ball tree single-tree nearest-neighbors method against the naive
  * method.  This uses only a random reference dataset.
@@ -859,6 +1173,83 @@ BOOST_AUTO_TEST_CASE(SingleBallTreeTest)
   }
 }
 
+/**
+ * Traversers that only derive from the kd-tree traversers, so that a
+ * NeighborSearch using them is compiled in this file, instead of being taken
+ * from the instantiations of KNN and KFN in the mlpack library.
+ */
+template<typename SortPolicy>
+struct LocalTraversers
+{
+  typedef KDTree<EuclideanDistance, NeighborSearchStat<SortPolicy>, arma::mat>
+      TreeType;
+
+  template<typename RuleType>
+  class Dual : public TreeType::template DualTreeTraverser<RuleType>
+  {
+   public:
+    Dual(RuleType& rule) :
+        TreeType::template DualTreeTraverser<RuleType>(rule) { }
+  };
+
+  template<typename RuleType>
+  class Single : public TreeType::template SingleTreeTraverser<RuleType>
+  {
+   public:
+    Single(RuleType& rule) :
+        TreeType::template SingleTreeTraverser<RuleType>(rule) { }
+  };
+};
+
+/**
+ * Make sure that the given instantiated NeighborSearch type gives the same
+ * results in every mode as the same search compiled in this file.
+ */
+template<typename SortPolicy>
+void CheckInstantiatedSearch()
+{
+  typedef NeighborSearch<SortPolicy, EuclideanDistance> InstantiatedType;
+  typedef NeighborSearch<SortPolicy, EuclideanDistance, arma::mat, KDTree,
+      LocalTraversers<SortPolicy>::template Dual,
+      LocalTraversers<SortPolicy>::template Single> LocalType;
+
+  arma::mat dataset;
+  data::Load("test_data_3_1000.csv", dataset);
+  arma::mat querySet = arma::randu<arma::mat>(3, 200);
+
+  const NeighborSearchMode modes[] = { NAIVE_MODE, SINGLE_TREE_MODE,
+      DUAL_TREE_MODE, GREEDY_SINGLE_TREE_MODE };
+  for (size_t m = 0; m < 4; ++m)
+  {
+    InstantiatedType instantiated(dataset, modes[m]);
+    LocalType local(dataset, modes[m]);
+
+    arma::Mat<size_t> neighbors, localNeighbors;
+    arma::mat distances, localDistances;
+
+    // Check both a monochromatic and a bichromatic search.
+    instantiated.Search(5, neighbors, distances);
+    local.Search(5, localNeighbors, localDistances);
+    CheckMatrices(neighbors, localNeighbors);
+    CheckMatrices(distances, localDistances);
+
+    instantiated.Search(querySet, 5, neighbors, distances);
+    local.Search(querySet, 5, localNeighbors, localDistances);
+    CheckMatrices(neighbors, localNeighbors);
+    CheckMatrices(distances, localDistances);
+  }
+}
+
+/**
+ * KNN and KFN are instantiated in the mlpack library; make sure that they give
+ * the same results as when NeighborSearch is compiled where it is used.
+ */
+BOOST_AUTO_TEST_CASE(InstantiatedKNNKFNTest)
+{
+  CheckInstantiatedSearch<NearestNeighborSort>();
+  CheckInstantiatedSearch<FurthestNeighborSort>();
+}
+
 /**
  * Test the ball tree dual-tree nearest neighbors method against the naive
  * method.
@@ -1225,6 +1616,240 @@ BOOST_AUTO_TEST_CASE(KNNModelMonochromaticTest)
   }
 }
 
+/**
+ * Ensure that an NSModel holding single-precision data gives the same results
+ * as a double-precision search, for every tree type and search mode.
+ */
+BOOST_AUTO_TEST_CASE(KNNFloatModelTest)
+{
+  typedef NSModel<NearestNeighborSort, arma::fmat> KNNFloatModel;
+
+  arma::fmat queryData = arma::randu<arma::fmat>(10, 50);
+  arma::fmat referenceData = arma::randu<arma::fmat>(10, 200);
+
+  // Get a baseline in double precision.
+  KNN knn(arma::conv_to<arma::mat>::from(referenceData));
+  arma::Mat<size_t> baselineNeighbors;
+  arma::mat baselineDistances;
+  knn.Search(arma::conv_to<arma::mat>::from(queryData), 3, baselineNeighbors,
+      baselineDistances);
+
+  const KNNFloatModel::TreeTypes treeTypes[] = {
+      KNNFloatModel::TreeTypes::KD_TREE,
+      KNNFloatModel::TreeTypes::COVER_TREE,
+      KNNFloatModel::TreeTypes::R_TREE,
+      KNNFloatModel::TreeTypes::R_STAR_TREE,
+      KNNFloatModel::TreeTypes::X_TREE,
+      KNNFloatModel::TreeTypes::BALL_TREE,
+      KNNFloatModel::TreeTypes::HILBERT_R_TREE,
+      KNNFloatModel::TreeTypes::R_PLUS_TREE,
+      KNNFloatModel::TreeTypes::R_PLUS_PLUS_TREE,
+      KNNFloatModel::TreeTypes::VP_TREE,
+      KNNFloatModel::TreeTypes::RP_TREE,
+      KNNFloatModel::TreeTypes::MAX_RP_TREE,
+      KNNFloatModel::TreeTypes::UB_TREE,
+      KNNFloatModel::TreeTypes::OCTREE };
+
+  for (size_t j = 0; j < 3; ++j)
+  {
+    for (size_t i = 0; i < 14; ++i)
+    {
+      KNNFloatModel model(treeTypes[i], false);
+
+      arma::fmat referenceCopy(referenceData);
+      arma::fmat queryCopy(queryData);
+      if (j == 0)
+        model.BuildModel(std::move(referenceCopy), 20, DUAL_TREE_MODE);
+      if (j == 1)
+        model.BuildModel(std::move(referenceCopy), 20, SINGLE_TREE_MODE);
+      if (j == 2)
+        model.BuildModel(std::move(referenceCopy), 20, NAIVE_MODE);
+
+      arma::Mat<size_t> neighbors;
+      arma::mat distances;
+
+      model.Search(std::move(queryCopy), 3, neighbors, distances);
+
+      BOOST_REQUIRE_EQUAL(neighbors.n_rows, baselineNeighbors.n_rows);
+      BOOST_REQUIRE_EQUAL(neighbors.n_cols, baselineNeighbors.n_cols);
+      BOOST_REQUIRE_EQUAL(distances.n_rows, baselineDistances.n_rows);
+      BOOST_REQUIRE_EQUAL(distances.n_cols, baselineDistances.n_cols);
+
+      // Only compare distances: with single precision, two neighbors at almost
+      // the same distance could be swapped.
+      for (size_t k = 0; k < distances.n_elem; ++k)
+        BOOST_REQUIRE_CLOSE(distances[k], baselineDistances[k], 1e-3);
+    }
+  }
+}
+
+/**
+ * Make sure we can serialize a single-precision NSModel.
+ */
+BOOST_AUTO_TEST_CASE(KNNFloatModelSerializationTest)
+{
+  typedef NSModel<NearestNeighborSort, arma::fmat> KNNFloatModel;
+
+  arma::fmat referenceData = arma::randu<arma::fmat>(5, 300);
+  arma::fmat queryData = arma::randu<arma::fmat>(5, 50);
+
+  KNNFloatModel model(KNNFloatModel::TreeTypes::KD_TREE);
+  model.BuildModel(arma::fmat(referenceData), 20, DUAL_TREE_MODE);
+
+  KNNFloatModel xmlModel(KNNFloatModel::TreeTypes::COVER_TREE), textModel,
+      binaryModel(KNNFloatModel::TreeTypes::BALL_TREE);
+  SerializeObjectAll(model, xmlModel, textModel, binaryModel);
+
+  arma::Mat<size_t> neighbors, xmlNeighbors, textNeighbors, binaryNeighbors;
+  arma::mat distances, xmlDistances, textDistances, binaryDistances;
+  model.Search(arma::fmat(queryData), 4, neighbors, distances);
+  xmlModel.Search(arma::fmat(queryData), 4, xmlNeighbors, xmlDistances);
+  textModel.Search(arma::fmat(queryData), 4, textNeighbors, textDistances);
+  binaryModel.Search(arma::fmat(queryData), 4, binaryNeighbors,
+      binaryDistances);
+
+  BOOST_REQUIRE_EQUAL(xmlModel.TreeType(), KNNFloatModel::TreeTypes::KD_TREE);
+  CheckMatrices(neighbors, xmlNeighbors, textNeighbors, binaryNeighbors);
+  CheckMatrices(distances, xmlDistances, textDistances, binaryDistances);
+}
+
+/**
+ * Insert points into and delete points from the reference tree, and make sure
+ * that the results are the same as the naive search on the remaining points.
+ */
+BOOST_AUTO_TEST_CASE(KNNInsertDeletePointsTest)
+{
+  arma::mat referenceData = arma::randu<arma::mat>(4, 600);
+  arma::mat newPoints = arma::randu<arma::mat>(4, 200);
+  newPoints.cols(0, 49) *= 2.0;
+  arma::mat queryData = arma::randu<arma::mat>(4, 100);
+
+  KNN knn(referenceData);
+  knn.InsertPoints(newPoints, 20);
+
+  // Delete every fourth point.
+  arma::mat allPoints = arma::join_rows(referenceData, newPoints);
+  std::vector<size_t> deleted, live;
+  for (size_t i = 0; i < allPoints.n_cols; ++i)
+  {
+    if (i % 4 == 0)
+      deleted.push_back(i);
+    else
+      live.push_back(i);
+  }
+
+  knn.DeletePoints(deleted, 20);
+  BOOST_REQUIRE_THROW(knn.DeletePoints(std::vector<size_t>(1, 0), 20),
+      std::invalid_argument);
+
+  arma::mat liveData(4, live.size());
+  for (size_t i = 0; i < live.size(); ++i)
+    liveData.col(i) = allPoints.col(live[i]);
+
+  KNN naive(liveData, NAIVE_MODE);
+  arma::Mat<size_t> baselineNeighbors, monoBaselineNeighbors;
+  arma::mat baselineDistances, monoBaselineDistances;
+  naive.Search(queryData, 5, baselineNeighbors, baselineDistances);
+  naive.Search(5, monoBaselineNeighbors, monoBaselineDistances);
+
+  for (size_t mode = 0; mode < 2; ++mode)
+  {
+    knn.SearchMode() = (mode == 0) ? DUAL_TREE_MODE : SINGLE_TREE_MODE;
+
+    arma::Mat<size_t> neighbors;
+    arma::mat distances;
+    knn.Search(queryData, 5, neighbors, distances);
+
+    BOOST_REQUIRE_EQUAL(neighbors.n_cols, queryData.n_cols);
+    for (size_t i = 0; i < neighbors.n_elem; ++i)
+    {
+      BOOST_REQUIRE_EQUAL(neighbors[i], live[baselineNeighbors[i]]);
+      BOOST_REQUIRE_CLOSE(distances[i], baselineDistances[i], 1e-5);
+    }
+
+    // Only the columns of points that were not deleted are meaningful.
+    knn.Search(5, neighbors, distances);
+    BOOST_REQUIRE_EQUAL(neighbors.n_cols, allPoints.n_cols);
+    for (size_t i = 0; i < live.size(); ++i)
+    {
+      for (size_t j = 0; j < 5; ++j)
+      {
+        BOOST_REQUIRE_EQUAL(neighbors(j, live[i]),
+            live[monoBaselineNeighbors(j, i)]);
+        BOOST_REQUIRE_CLOSE(distances(j, live[i]),
+            monoBaselineDistances(j, i), 1e-5);
+      }
+    }
+  }
+
+  // Only trees can be modified.
+  KNN naive2(referenceData, NAIVE_MODE);
+  BOOST_REQUIRE_THROW(naive2.InsertPoints(newPoints), std::invalid_argument);
+}
+
+/**
+ * Make sure that NSModel only allows insertion and deletion for kd-trees and
+ * ball trees, and that the results are correct.
+ */
+BOOST_AUTO_TEST_CASE(KNNModelInsertDeletePointsTest)
+{
+  typedef NSModel<NearestNeighborSort> KNNModel;
+
+  arma::mat referenceData = arma::randu<arma::mat>(5, 300);
+  arma::mat newPoints = arma::randu<arma::mat>(5, 100);
+  arma::mat queryData = arma::randu<arma::mat>(5, 50);
+
+  std::vector<size_t> deleted;
+  for (size_t i = 0; i < 400; i += 2)
+    deleted.push_back(i);
+
+  // Baseline: only the odd points are left.
+  arma::mat allPoints = arma::join_rows(referenceData, newPoints);
+  arma::mat liveData(5, 200);
+  for (size_t i = 0; i < 200; ++i)
+    liveData.col(i) = allPoints.col(2 * i + 1);
+
+  KNN naive(liveData, NAIVE_MODE);
+  arma::Mat<size_t> baselineNeighbors;
+  arma::mat baselineDistances;
+  naive.Search(queryData, 3, baselineNeighbors, baselineDistances);
+
+  KNNModel models[3];
+  models[0] = KNNModel(KNNModel::TreeTypes::KD_TREE, false);
+  models[1] = KNNModel(KNNModel::TreeTypes::BALL_TREE, false);
+  models[2] = KNNModel(KNNModel::TreeTypes::COVER_TREE, false);
+
+  for (size_t m = 0; m < 3; ++m)
+  {
+    arma::mat referenceCopy(referenceData);
+    arma::mat newCopy(newPoints);
+    models[m].BuildModel(std::move(referenceCopy), 10, DUAL_TREE_MODE);
+
+    if (m == 2)
+    {
+      BOOST_REQUIRE_THROW(models[m].InsertPoints(std::move(newCopy)),
+          std::invalid_argument);
+      BOOST_REQUIRE_THROW(models[m].DeletePoints(deleted),
+          std::invalid_argument);
+      continue;
+    }
+
+    models[m].InsertPoints(std::move(newCopy));
+    models[m].DeletePoints(deleted);
+
+    arma::Mat<size_t> neighbors;
+    arma::mat distances;
+    arma::mat queryCopy(queryData);
+    models[m].Search(std::move(queryCopy), 3, neighbors, distances);
+
+    for (size_t i = 0; i < neighbors.n_elem; ++i)
+    {
+      BOOST_REQUIRE_EQUAL(neighbors[i], 2 * baselineNeighbors[i] + 1);
+      BOOST_REQUIRE_CLOSE(distances[i], baselineDistances[i], 1e-5);
+    }
+  }
+}
+
 /**
  * If we search twice with the same reference tree, the bounds need to be reset
  * before the second search.  This test ensures that that happens, by making
@@ -1247,6 +1872,72 @@ BOOST_AUTO_TEST_CASE(DoubleReferenceSearchTest)
   BOOST_REQUIRE_EQUAL(knn.Scores(), scores);
 }
 
+/**
+ * Make sure that TraversalCounters counts prunes and visits correctly (when
+ * they are counted at all), and that counters can be added together.
+ */
+BOOST_AUTO_TEST_CASE(TraversalCountersTest)
+{
+  TraversalCounters counters;
+  counters.BaseCase();
+  counters.BaseCase();
+  counters.Score();
+
+  BOOST_REQUIRE_EQUAL(counters.ScoreResult(DBL_MAX), DBL_MAX);
+  BOOST_REQUIRE_EQUAL(counters.ScoreResult(1.5), 1.5);
+  BOOST_REQUIRE_EQUAL(counters.ScoreResult(0.0), 0.0);
+  // Already pruned, so this is not a new prune.
+  BOOST_REQUIRE_EQUAL(counters.RescoreResult(DBL_MAX, DBL_MAX), DBL_MAX);
+  BOOST_REQUIRE_EQUAL(counters.RescoreResult(1.5, DBL_MAX), DBL_MAX);
+  BOOST_REQUIRE_EQUAL(counters.RescoreResult(0.0, 0.0), 0.0);
+
+  BOOST_REQUIRE_EQUAL(counters.BaseCases(), 2);
+  BOOST_REQUIRE_EQUAL(counters.Scores(), 1);
+#ifdef MLPACK_TRAVERSAL_COUNTERS
+  BOOST_REQUIRE_EQUAL(counters.Prunes(), 2);
+  BOOST_REQUIRE_EQUAL(counters.Visits(), 2);
+#else
+  BOOST_REQUIRE_EQUAL(counters.Prunes(), 0);
+  BOOST_REQUIRE_EQUAL(counters.Visits(), 0);
+#endif
+
+  TraversalCounters total;
+  total += counters;
+  total += counters;
+  BOOST_REQUIRE_EQUAL(total.BaseCases(), 4);
+  BOOST_REQUIRE_EQUAL(total.Scores(), 2);
+  BOOST_REQUIRE_EQUAL(total.Prunes(), 2 * counters.Prunes());
+  BOOST_REQUIRE_EQUAL(total.Visits(), 2 * counters.Visits());
+}
+
+/**
+ * The counters of NeighborSearchRules should agree with the base cases and
+ * scores, and every scored combination must have been pruned or visited.
+ */
+BOOST_AUTO_TEST_CASE(NeighborSearchRulesCountersTest)
+{
+  arma::mat dataset = arma::randu<arma::mat>(3, 1000);
+  KNN::Tree tree(dataset);
+
+  typedef NeighborSearchRules<NearestNeighborSort, EuclideanDistance,
+      KNN::Tree> RuleType;
+  EuclideanDistance metric;
+  RuleType rules(tree.Dataset(), tree.Dataset(), 3, metric, 0.0, true);
+  KNN::Tree::DualTreeTraverser<RuleType> traverser(rules);
+  traverser.Traverse(tree, tree);
+
+  BOOST_REQUIRE_EQUAL(rules.Counters().BaseCases(), rules.BaseCases());
+  BOOST_REQUIRE_EQUAL(rules.Counters().Scores(), rules.Scores());
+  BOOST_REQUIRE_GT(rules.BaseCases(), 0);
+  BOOST_REQUIRE_GT(rules.Scores(), 0);
+#ifdef MLPACK_TRAVERSAL_COUNTERS
+  BOOST_REQUIRE_GT(rules.Counters().Prunes(), 0);
+  BOOST_REQUIRE_LE(rules.Counters().Visits(), rules.Scores());
+  BOOST_REQUIRE_GE(rules.Counters().Prunes() + rules.Counters().Visits(),
+      rules.Scores());
+#endif
+}
+
 /**
  * Make sure that the neighborPtr matrix isn't accidentally deleted.
  * See issue #478.
@@ -1434,4 +2125,268 @@ BOOST_AUTO_TEST_CASE(MoveOperatorNaiveTest)
   CheckMatrices(distances, distances2);
 }
 
+/**
+ * Make sure the candidate lists keep the k best candidates in order, both for
+ * the small values of k where they are sorted arrays and for the large values
+ * of k where they are heaps.
+ */
+BOOST_AUTO_TEST_CASE(CandidateListTest)
+{
+  const arma::vec distances = arma::randu<arma::vec>(300);
+  for (const size_t k : { 1, 2, 7, 10, 20, 33, 100 })
+  {
+    CandidateList<NearestNeighborSort> nearest(k, 3);
+    CandidateList<FurthestNeighborSort> furthest(k, 3);
+    for (size_t i = 0; i < distances.n_elem; ++i)
+    {
+      nearest.Insert(i % 3, i, distances[i]);
+      furthest.Insert(i % 3, i, distances[i]);
+    }
+
+    for (size_t q = 0; q < 3; ++q)
+    {
+      arma::vec queryDistances(100);
+      for (size_t j = 0; j < 100; ++j)
+        queryDistances[j] = distances[q + 3 * j];
+      const arma::uvec order = arma::sort_index(queryDistances);
+
+      BOOST_REQUIRE_EQUAL(nearest.Worst(q), queryDistances[order[k - 1]]);
+      BOOST_REQUIRE_EQUAL(furthest.Worst(q),
+          queryDistances[order[order.n_elem - k]]);
+
+      arma::Col<size_t> neighbors(k);
+      arma::vec neighborDistances(k);
+      nearest.Get(q, neighbors.memptr(), neighborDistances.memptr());
+      for (size_t j = 0; j < k; ++j)
+      {
+        BOOST_REQUIRE_EQUAL(neighbors[j], q + 3 * order[j]);
+        BOOST_REQUIRE_EQUAL(neighborDistances[j], queryDistances[order[j]]);
+      }
+
+      furthest.Get(q, neighbors.memptr(), neighborDistances.memptr());
+      for (size_t j = 0; j < k; ++j)
+      {
+        BOOST_REQUIRE_EQUAL(neighbors[j],
+            q + 3 * order[order.n_elem - 1 - j]);
+      }
+    }
+  }
+}
+
+/**
+ * Make sure that the search in the space transformed by the Mahalanobis
+ * distance finds the same neighbors as a brute-force search with the distance,
+ * with and without the root.
+ */
+BOOST_AUTO_TEST_CASE(MahalanobisSearchTest)
+{
+  arma::mat dataset = arma::randu<arma::mat>(4, 300);
+  arma::mat querySet = arma::randu<arma::mat>(4, 50);
+  const arma::mat a = arma::randu<arma::mat>(4, 4);
+  const arma::mat covariance = a * a.t() + arma::eye<arma::mat>(4, 4);
+
+  MahalanobisDistance<true> rooted(covariance);
+  MahalanobisDistance<false> squared(covariance);
+
+  MahalanobisSearch<NearestNeighborSort, true> rootedSearch(dataset, rooted);
+  MahalanobisSearch<NearestNeighborSort, false> squaredSearch(dataset, squared,
+      SINGLE_TREE_MODE);
+
+  arma::Mat<size_t> rootedNeighbors, squaredNeighbors;
+  arma::mat rootedDistances, squaredDistances;
+  rootedSearch.Search(querySet, 5, rootedNeighbors, rootedDistances);
+  squaredSearch.Search(querySet, 5, squaredNeighbors, squaredDistances);
+
+  for (size_t i = 0; i < querySet.n_cols; ++i)
+  {
+    arma::vec distances(dataset.n_cols);
+    for (size_t j = 0; j < dataset.n_cols; ++j)
+      distances[j] = rooted.Evaluate(querySet.col(i), dataset.col(j));
+    const arma::uvec order = arma::sort_index(distances);
+
+    for (size_t j = 0; j < 5; ++j)
+    {
+      BOOST_REQUIRE_EQUAL(rootedNeighbors(j, i), order[j]);
+      BOOST_REQUIRE_EQUAL(squaredNeighbors(j, i), order[j]);
+      BOOST_REQUIRE_CLOSE(rootedDistances(j, i), distances[order[j]], 1e-5);
+      BOOST_REQUIRE_CLOSE(squaredDistances(j, i), squared.Evaluate(
+          querySet.col(i), dataset.col(order[j])), 1e-5);
+    }
+  }
+}
+
+/**
+ * Make sure that NSModel::Tune() picks one of the candidates, that the tuned
+ * model gives the exact neighbors, and that the choice is serialized.
+ */
+BOOST_AUTO_TEST_CASE(KNNModelTuneTest)
+{
+  typedef NSModel<NearestNeighborSort> KNNModel;
+
+  arma::mat dataset = arma::randu<arma::mat>(3, 1000);
+  arma::mat querySet = arma::randu<arma::mat>(3, 100);
+
+  KNNModel model;
+  BOOST_REQUIRE_EQUAL(model.Tuned(), false);
+
+  const std::vector<KNNModel::TreeTypes> candidates = { KNNModel::BALL_TREE,
+      KNNModel::COVER_TREE, KNNModel::OCTREE };
+  model.Tune(dataset, 3, DUAL_TREE_MODE, 0, candidates, { 10, 30 }, 500, 100);
+  BOOST_REQUIRE_EQUAL(model.Tuned(), true);
+  BOOST_REQUIRE(std::find(candidates.begin(), candidates.end(),
+      model.TreeType()) != candidates.end());
+  if (model.TreeType() != KNNModel::COVER_TREE)
+    BOOST_REQUIRE(model.LeafSize() == 10 || model.LeafSize() == 30);
+
+  model.BuildModel(arma::mat(dataset), model.LeafSize(), DUAL_TREE_MODE);
+  arma::Mat<size_t> neighbors, naiveNeighbors;
+  arma::mat distances, naiveDistances;
+  model.Search(arma::mat(querySet), 3, neighbors, distances);
+
+  KNN naive(dataset, NAIVE_MODE);
+  naive.Search(querySet, 3, naiveNeighbors, naiveDistances);
+  CheckMatrices(neighbors, naiveNeighbors);
+  CheckMatrices(distances, naiveDistances);
+
+  KNNModel xmlModel, textModel, binaryModel;
+  SerializeObjectAll(model, xmlModel, textModel, binaryModel);
+  BOOST_REQUIRE_EQUAL(xmlModel.Tuned(), true);
+  BOOST_REQUIRE_EQUAL(textModel.Tuned(), true);
+  BOOST_REQUIRE_EQUAL(binaryModel.Tuned(), true);
+  BOOST_REQUIRE_EQUAL(xmlModel.TreeType(), model.TreeType());
+  BOOST_REQUIRE_EQUAL(xmlModel.LeafSize(), model.LeafSize());
+}
+
+/**
+ * Make sure that repeated queries are answered from the cache of NSModel, with
+ * the same results, and that the cache is cleared when the reference set
+ * changes.
+ */
+BOOST_AUTO_TEST_CASE(KNNModelCacheTest)
+{
+  typedef NSModel<NearestNeighborSort> KNNModel;
+
+  arma::mat dataset = arma::randu<arma::mat>(3, 500);
+  arma::mat querySet = arma::randu<arma::mat>(3, 40);
+
+  KNNModel model;
+  model.BuildModel(arma::mat(dataset), 20, DUAL_TREE_MODE);
+  model.Cache().MemoryBudget(1024 * 1024);
+
+  arma::Mat<size_t> neighbors, cachedNeighbors;
+  arma::mat distances, cachedDistances;
+  model.Search(arma::mat(querySet), 5, neighbors, distances);
+  BOOST_REQUIRE_EQUAL(model.Cache().Hits(), 0);
+  BOOST_REQUIRE_EQUAL(model.Cache().Misses(), 40);
+  BOOST_REQUIRE_EQUAL(model.Cache().Size(), 40);
+
+  // Half of the queries are repeated, with fewer neighbors.
+  arma::mat mixedSet = arma::join_rows(querySet.cols(0, 19),
+      arma::randu<arma::mat>(3, 20));
+  model.Search(arma::mat(mixedSet), 3, cachedNeighbors, cachedDistances);
+  BOOST_REQUIRE_EQUAL(model.Cache().Hits(), 20);
+  BOOST_REQUIRE_EQUAL(model.Cache().Misses(), 60);
+
+  KNN naive(dataset, NAIVE_MODE);
+  arma::Mat<size_t> naiveNeighbors;
+  arma::mat naiveDistances;
+  naive.Search(mixedSet, 3, naiveNeighbors, naiveDistances);
+  CheckMatrices(cachedNeighbors, naiveNeighbors);
+  CheckMatrices(cachedDistances, naiveDistances);
+
+  // A small budget keeps only the most recently used entries.
+  model.Cache().MemoryBudget(model.Cache().MemoryUsage() / 2);
+  BOOST_REQUIRE_LT(model.Cache().Size(), 60);
+  BOOST_REQUIRE_LE(model.Cache().MemoryUsage(), model.Cache().MemoryBudget());
+
+  // The results belong to the reference set.
+  model.BuildModel(arma::mat(dataset), 20, DUAL_TREE_MODE);
+  BOOST_REQUIRE_EQUAL(model.Cache().Size(), 0);
+}
+
+/**
+ * Check a CandidateList with the given k and sort policy against a sorted
+ * reference list: the k best of many candidates are kept in order, a candidate
+ * that ties with the worst one is not inserted, and a candidate that ties with
+ * another one goes in just before it.  The distances of the candidates are in
+ * [1, 2], and the worse distance is worse than all of them.
+ */
+template<typename SortPolicy>
+void CheckCandidateList(const size_t k, const double worseDistance)
+{
+  typedef std::pair<double, size_t> Candidate;
+
+  // The second query point gets no candidates.
+  CandidateList<SortPolicy> list(k, 2, 12345);
+
+  std::vector<Candidate> reference;
+  for (size_t i = 0; i < 3 * k + 5; ++i)
+  {
+    const double distance = 1.0 + math::Random();
+    list.Insert(0, i, distance);
+    reference.push_back(Candidate(distance, i));
+  }
+
+  // A candidate that is worse than all the others is not inserted.
+  list.Insert(0, reference.size(), worseDistance);
+
+  std::stable_sort(reference.begin(), reference.end(),
+      [](const Candidate& a, const Candidate& b)
+      {
+        return SortPolicy::IsBetter(a.first, b.first) &&
+            a.first != b.first;
+      });
+  reference.resize(k);
+  BOOST_REQUIRE_EQUAL(list.Worst(0), reference[k - 1].first);
+
+  // A candidate that ties with the worst one is not inserted either.
+  list.Insert(0, 1000, reference[k - 1].first);
+  BOOST_REQUIRE_EQUAL(list.Worst(0), reference[k - 1].first);
+
+  // A candidate that ties with the best one replaces the worst one, and (when
+  // the list is sorted) goes before the best one.
+  if (k > 1)
+  {
+    list.Insert(0, 1001, reference[0].first);
+    reference.insert(reference.begin(), Candidate(reference[0].first, 1001));
+    reference.resize(k);
+    BOOST_REQUIRE_EQUAL(list.Worst(0), reference[k - 1].first);
+  }
+
+  arma::Col<size_t> neighbors(k);
+  arma::vec distances(k);
+  list.Get(0, neighbors.memptr(), distances.memptr());
+  for (size_t j = 0; j < k; ++j)
+  {
+    BOOST_REQUIRE_EQUAL(distances[j], reference[j].first);
+    // The heap doesn't keep the order of candidates with the same distance.
+    if (k <= CandidateList<SortPolicy>::SortedLimit || j > 1)
+      BOOST_REQUIRE_EQUAL(neighbors[j], reference[j].second);
+  }
+
+  // The candidates of the second query point are untouched.
+  BOOST_REQUIRE_EQUAL(list.Worst(1), SortPolicy::WorstDistance());
+  list.Get(1, neighbors.memptr(), distances.memptr());
+  for (size_t j = 0; j < k; ++j)
+  {
+    BOOST_REQUIRE_EQUAL(neighbors[j], 12345);
+    BOOST_REQUIRE_EQUAL(distances[j], SortPolicy::WorstDistance());
+  }
+}
+
+/**
+ * Check the candidate lists for the values of k at the boundaries of each way
+ * they are stored: k = 1 and k = 10 are the smallest and largest sorted lists
+ * with k known at compile time, k = 11 and k = 32 are the smallest and largest
+ * sorted lists with k known at runtime, and k = 33 is the smallest heap.
+ */
+BOOST_AUTO_TEST_CASE(CandidateListBoundaryTest)
+{
+  for (const size_t k : { 1, 10, 11, 32, 33 })
+  {
+    CheckCandidateList<NearestNeighborSort>(k, 3.0);
+    CheckCandidateList<FurthestNeighborSort>(k, 0.0);
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -212,6 +212,82 @@ BOOST_AUTO_TEST_CASE(DualTreeSearch)
   BOOST_REQUIRE_LT(numQueriesFail, maxNumQueriesFail);
 }
 
+// Make sure the parallel dual-tree traversal still gives the rank-approximation
+// guarantee.
+BOOST_AUTO_TEST_CASE(ParallelDualTreeSearch)
+{
+  arma::mat refData;
+  arma::mat queryData;
+
+  data::Load("rann_test_r_3_900.csv", refData, true);
+  data::Load("rann_test_q_3_100.csv", queryData, true);
+
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+
+  RASearch<> tsdRann(refData, false, false, 1.0, 0.95, false, false, 5);
+  tsdRann.Parallel() = true;
+
+  arma::Mat<size_t> qrRanks;
+  data::Load("rann_test_qr_ranks.csv", qrRanks, true, false); // No transpose.
+
+  size_t numRounds = 1000;
+  arma::Col<size_t> numSuccessRounds(queryData.n_cols);
+  numSuccessRounds.fill(0);
+
+  // 1% of 900 is 9, so the rank is expected to be less than 10.
+  size_t expectedRankErrorUB = 10;
+
+  for (size_t rounds = 0; rounds < numRounds; rounds++)
+  {
+    tsdRann.Search(queryData, 1, neighbors, distances);
+
+    for (size_t i = 0; i < queryData.n_cols; i++)
+      if (qrRanks(i, neighbors(0, i)) < expectedRankErrorUB)
+        numSuccessRounds[i]++;
+
+    neighbors.reset();
+    distances.reset();
+  }
+
+  size_t threshold = floor(numRounds *
+      (0.95 - (1.96 * sqrt(0.95 * 0.05 / numRounds))));
+  size_t numQueriesFail = 0;
+  for (size_t i = 0; i < queryData.n_cols; i++)
+    if (numSuccessRounds[i] < threshold)
+      numQueriesFail++;
+
+  // At most 5% of the queries should fall out of this threshold.
+  BOOST_REQUIRE_LT(numQueriesFail, 6);
+}
+
+// Make sure the parallel single-tree traversal gives the same results as the
+// serial one with the same random seed, since each query point is sampled with
+// its own seed.
+BOOST_AUTO_TEST_CASE(ParallelSingleTreeSearch)
+{
+  arma::mat refData;
+  arma::mat queryData;
+
+  data::Load("rann_test_r_3_900.csv", refData, true);
+  data::Load("rann_test_q_3_100.csv", queryData, true);
+
+  RASearch<> tssRann(refData, false, true, 1.0, 0.95, false, false);
+
+  arma::Mat<size_t> neighbors, parallelNeighbors;
+  arma::mat distances, parallelDistances;
+
+  math::RandomSeed(7);
+  tssRann.Search(queryData, 3, neighbors, distances);
+
+  tssRann.Parallel() = true;
+  math::RandomSeed(7);
+  tssRann.Search(queryData, 3, parallelNeighbors, parallelDistances);
+
+  CheckMatrices(neighbors, parallelNeighbors);
+  CheckMatrices(distances, parallelDistances);
+}
+
 // Test rank-approximate search with just a single dataset.  These tests just
 // ensure that the method runs okay.
 BOOST_AUTO_TEST_CASE(SingleDatasetNaiveSearch)
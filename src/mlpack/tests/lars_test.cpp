@@ -352,4 +352,91 @@ BOOST_AUTO_TEST_CASE(TrainingConstructorWithNonDefaultsTest)
     BOOST_REQUIRE_CLOSE(beta[i], lars2.Beta()[i], 1e-5);
 }
 
+/**
+ * Make sure that training on sparse data gives the same solution as training
+ * on the same dense data.
+ */
+BOOST_AUTO_TEST_CASE(SparseTrainTest)
+{
+  arma::mat X;
+  arma::rowvec y;
+  GenerateProblem(X, y, 1000, 50);
+  X.elem(arma::find(arma::abs(X) < 0.5)).zeros();
+  arma::sp_mat sparseX(X);
+
+  LARS denseLars(false, 0.1, 0.05);
+  arma::vec denseBeta;
+  denseLars.Train(X, y, denseBeta);
+
+  LARS sparseLars(false, 0.1, 0.05);
+  arma::vec sparseBeta;
+  sparseLars.Train(sparseX, y, sparseBeta);
+
+  BOOST_REQUIRE_EQUAL(sparseBeta.n_elem, denseBeta.n_elem);
+  for (size_t i = 0; i < denseBeta.n_elem; ++i)
+    BOOST_REQUIRE_SMALL(sparseBeta[i] - denseBeta[i], 1e-8);
+}
+
+/**
+ * Make sure that retraining on new data of the same dimensionality doesn't
+ * reuse the Gram matrix of the old data.
+ */
+BOOST_AUTO_TEST_CASE(RetrainSameDimensionalityTest)
+{
+  arma::mat origX, newX;
+  arma::rowvec origY, newY;
+  GenerateProblem(origX, origY, 1000, 50);
+  GenerateProblem(newX, newY, 750, 50);
+
+  LARS lars(false, 0.1, 0.1);
+  arma::vec betaOpt;
+  lars.Train(origX, origY, betaOpt);
+  lars.Train(newX, newY, betaOpt);
+
+  arma::vec errCorr = (arma::trans(newX) * arma::trans(newX) +
+      0.1 * arma::eye(50, 50)) * betaOpt - arma::trans(newY * newX.t());
+
+  LARSVerifyCorrectness(betaOpt, errCorr, 0.1);
+}
+
+/**
+ * Make sure that the solutions of a lambda path match the solutions of
+ * training separately for each lambda.
+ */
+BOOST_AUTO_TEST_CASE(TrainPathTest)
+{
+  arma::mat X;
+  arma::rowvec y;
+  GenerateProblem(X, y, 1000, 20);
+
+  arma::vec sortedAbsCorr = arma::sort(arma::abs(X * y.t()));
+  arma::vec lambdas(3);
+  lambdas[0] = sortedAbsCorr(15);
+  lambdas[1] = sortedAbsCorr(10);
+  lambdas[2] = sortedAbsCorr(5);
+
+  LARS pathLars(true);
+  arma::mat betas;
+  pathLars.TrainPath(X, y, lambdas, betas);
+
+  BOOST_REQUIRE_EQUAL(betas.n_rows, 20);
+  BOOST_REQUIRE_EQUAL(betas.n_cols, 3);
+
+  for (size_t i = 0; i < lambdas.n_elem; ++i)
+  {
+    LARS lars(true, lambdas[i]);
+    arma::vec betaOpt;
+    lars.Train(X, y, betaOpt);
+
+    for (size_t j = 0; j < betaOpt.n_elem; ++j)
+      BOOST_REQUIRE_SMALL(betas(j, i) - betaOpt[j], 1e-6);
+  }
+
+  // The solution at the smallest lambda is the end of the path.
+  arma::vec beta;
+  pathLars.PathSolution(lambdas[2], beta);
+  for (size_t j = 0; j < beta.n_elem; ++j)
+    BOOST_REQUIRE_SMALL(beta[j] - pathLars.Beta()[j], 1e-10);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
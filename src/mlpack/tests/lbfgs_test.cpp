@@ -117,4 +117,25 @@ BOOST_AUTO_TEST_CASE(RosenbrockWoodFunctionTest)
   }
 }
 
+/**
+ * Make sure that the parallel line search takes the same steps as the serial
+ * line search.
+ */
+BOOST_AUTO_TEST_CASE(ParallelLineSearchTest)
+{
+  GeneralizedRosenbrockFunction f(64);
+  L_BFGS lbfgs(20);
+  L_BFGS parallelLBFGS(20);
+  parallelLBFGS.ParallelLineSearch() = true;
+
+  arma::mat coords = f.GetInitialPoint();
+  arma::mat parallelCoords = f.GetInitialPoint();
+  lbfgs.Optimize(f, coords);
+  parallelLBFGS.Optimize(f, parallelCoords);
+
+  BOOST_REQUIRE_SMALL(f.Evaluate(parallelCoords), 1e-5);
+  for (size_t j = 0; j < coords.n_elem; ++j)
+    BOOST_REQUIRE_CLOSE(parallelCoords[j], coords[j], 1e-10);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
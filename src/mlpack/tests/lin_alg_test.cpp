@@ -78,6 +78,63 @@ BOOST_AUTO_TEST_CASE(TestCenterB)
       BOOST_REQUIRE_CLOSE(tmp_out(row, col), (double) (col - 2.5) * row, 1e-5);
 }
 
+/**
+ * Make sure that centering in place, or into the same matrix, gives the same
+ * result as centering into another matrix.
+ */
+BOOST_AUTO_TEST_CASE(TestCenterInPlace)
+{
+  mat tmp = randu<mat>(7, 300);
+
+  mat centered;
+  Center(tmp, centered);
+
+  mat inPlace = tmp;
+  CenterInPlace(inPlace);
+  CheckMatrices(centered, inPlace);
+
+  mat aliased = tmp;
+  Center(aliased, aliased);
+  CheckMatrices(centered, aliased);
+
+  for (size_t row = 0; row < tmp.n_rows; ++row)
+    BOOST_REQUIRE_SMALL(accu(inPlace.row(row)), 1e-10);
+}
+
+/**
+ * After whitening using the singular value decomposition, the covariance of
+ * the matrix should be the identity, and the whitening matrix should be the
+ * same as with the eigendecomposition, up to a rotation.
+ */
+BOOST_AUTO_TEST_CASE(TestWhitenUsingSVD)
+{
+  mat tmp = randu<mat>(4, 500);
+  tmp.row(1) += 3.0 * tmp.row(0);
+  tmp.row(3) *= 10.0;
+
+  mat centered, whitened, whiteningMatrix;
+  Center(tmp, centered);
+  WhitenUsingSVD(centered, whitened, whiteningMatrix);
+
+  const mat newcov = ccov(whitened);
+  for (size_t row = 0; row < newcov.n_rows; ++row)
+  {
+    for (size_t col = 0; col < newcov.n_cols; ++col)
+    {
+      if (row == col)
+        BOOST_REQUIRE_CLOSE(newcov(row, col), 1.0, 1e-8);
+      else
+        BOOST_REQUIRE_SMALL(newcov(row, col), 1e-8);
+    }
+  }
+
+  // W^T W is the inverse of the covariance for both whitening matrices.
+  mat eigWhitened, eigWhiteningMatrix;
+  WhitenUsingEig(centered, eigWhitened, eigWhiteningMatrix);
+  CheckMatrices(whiteningMatrix.t() * whiteningMatrix,
+      eigWhiteningMatrix.t() * eigWhiteningMatrix, 1e-6);
+}
+
 BOOST_AUTO_TEST_CASE(TestWhitenUsingEig)
 {
   // After whitening using eigendecomposition, the covariance of
@@ -289,4 +346,49 @@ BOOST_AUTO_TEST_CASE(TestSymKronId)
   }
 }
 
+/**
+ * Make sure the weighted covariance matches the direct computation, with both
+ * the two-pass and the one-pass algorithm, over several blocks of points.
+ */
+BOOST_AUTO_TEST_CASE(TestWeightedCovariance)
+{
+  mat x = randu<mat>(4, 1000);
+  x.row(2) += 10.0;
+  const vec weights = randu<vec>(1000);
+
+  const double sumWeights = accu(weights);
+  const vec expectedMean = (x * weights) / sumWeights;
+  mat expectedCovariance(4, 4, fill::zeros);
+  for (size_t i = 0; i < x.n_cols; ++i)
+  {
+    expectedCovariance += weights[i] * (x.col(i) - expectedMean) *
+        trans(x.col(i) - expectedMean);
+  }
+  expectedCovariance /= sumWeights;
+
+  for (const bool onePass : { false, true })
+  {
+    vec mean;
+    mat covariance;
+    BOOST_REQUIRE_CLOSE(WeightedCovariance(x, weights, mean, covariance,
+        onePass), sumWeights, 1e-8);
+
+    for (size_t i = 0; i < mean.n_elem; ++i)
+      BOOST_REQUIRE_CLOSE(mean[i], expectedMean[i], 1e-8);
+    for (size_t i = 0; i < covariance.n_elem; ++i)
+      BOOST_REQUIRE_SMALL(covariance[i] - expectedCovariance[i], 1e-8);
+  }
+
+  // Unit weights give the biased covariance of the data.
+  vec mean;
+  mat covariance;
+  WeightedCovariance(x, ones<vec>(1000), mean, covariance);
+  const mat biasedCovariance = ccov(x, 1);
+  for (size_t i = 0; i < covariance.n_elem; ++i)
+    BOOST_REQUIRE_SMALL(covariance[i] - biasedCovariance[i], 1e-8);
+
+  BOOST_REQUIRE_THROW(WeightedCovariance(x, ones<vec>(10), mean, covariance),
+      std::invalid_argument);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
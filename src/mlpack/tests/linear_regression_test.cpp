@@ -199,4 +199,35 @@ BOOST_AUTO_TEST_CASE(LinearRegressionTrainTest)
     BOOST_REQUIRE_CLOSE(lr.Parameters()[i], lrTrain.Parameters()[i], 1e-5);
 }
 
+/**
+ * Make sure that a model trained on chunks of the data with Update() and
+ * Solve() is the same as a model trained on all of the data at once.
+ */
+BOOST_AUTO_TEST_CASE(LinearRegressionUpdateTest)
+{
+  arma::mat dataset = arma::randu<arma::mat>(5, 3000);
+  arma::rowvec responses = arma::randu<arma::rowvec>(3000);
+  arma::rowvec weights = arma::randu<arma::rowvec>(3000);
+
+  LinearRegression lr(dataset, responses, weights, 0.3);
+
+  LinearRegression lrUpdate;
+  lrUpdate.Lambda() = 0.3;
+  lrUpdate.Update(dataset.cols(0, 1499), responses.subvec(0, 1499),
+      weights.subvec(0, 1499));
+  lrUpdate.Update(dataset.cols(1500, 2999), responses.subvec(1500, 2999),
+      weights.subvec(1500, 2999));
+  lrUpdate.Solve();
+
+  BOOST_REQUIRE_EQUAL(lr.Parameters().n_elem, lrUpdate.Parameters().n_elem);
+  for (size_t i = 0; i < lr.Parameters().n_elem; ++i)
+    BOOST_REQUIRE_CLOSE(lr.Parameters()[i], lrUpdate.Parameters()[i], 1e-5);
+
+  // Data of a different dimensionality can't be added to the model.
+  arma::mat otherDataset = arma::randu<arma::mat>(4, 100);
+  arma::rowvec otherResponses = arma::randu<arma::rowvec>(100);
+  BOOST_REQUIRE_THROW(lrUpdate.Update(otherDataset, otherResponses),
+      std::invalid_argument);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
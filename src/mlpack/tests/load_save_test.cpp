@@ -13,7 +13,9 @@
 
 #include <mlpack/core.hpp>
 #include <mlpack/core/data/load_arff.hpp>
+#include <mlpack/core/data/mapped_matrix.hpp>
 #include <mlpack/core/data/map_policies/missing_policy.hpp>
+#include <mlpack/core/data/streaming_dataset.hpp>
 
 #include <boost/test/unit_test.hpp>
 #include "test_tools.hpp"
@@ -1819,6 +1821,259 @@ BOOST_AUTO_TEST_CASE(CaseTest)
   BOOST_CHECK_EQUAL(dataset.n_cols, 3);
 }
 
+/**
+ * Load an ARFF file with sparse rows (and a dense row) into a sparse matrix.
+ */
+BOOST_AUTO_TEST_CASE(SparseARFFTest)
+{
+  fstream f;
+  f.open("test.arff", fstream::out);
+  f << "@relation test" << endl;
+  f << "@attribute one numeric" << endl;
+  f << "@attribute two string" << endl;
+  f << "@attribute three numeric" << endl;
+  f << "@attribute four numeric" << endl;
+  f << "@data" << endl;
+  f << "{0 1.5, 3 2}" << endl;
+  f << "% comment" << endl;
+  f << "{}" << endl;
+  f << endl;
+  f << "{ 3 -4, 1 \"hello world\" } % comment" << endl;
+  f << "0, goodbye, 7, 0" << endl;
+  f << "{1 goodbye, 2 0}" << endl;
+  f.close();
+
+  arma::sp_mat dataset;
+  DatasetInfo info;
+  data::LoadARFF("test.arff", dataset, info);
+
+  BOOST_REQUIRE_EQUAL(info.Dimensionality(), 4);
+  BOOST_REQUIRE(info.Type(0) == Datatype::numeric);
+  BOOST_REQUIRE(info.Type(1) == Datatype::categorical);
+  BOOST_REQUIRE_EQUAL(info.NumMappings(1), 2);
+
+  BOOST_REQUIRE_EQUAL(dataset.n_rows, 4);
+  BOOST_REQUIRE_EQUAL(dataset.n_cols, 5);
+
+  // "hello world" is mapped to 0, so it isn't stored.
+  BOOST_REQUIRE_EQUAL(dataset.n_nonzero, 6);
+  BOOST_REQUIRE_CLOSE((double) dataset(0, 0), 1.5, 1e-5);
+  BOOST_REQUIRE_CLOSE((double) dataset(3, 0), 2.0, 1e-5);
+  BOOST_REQUIRE_EQUAL(arma::accu(arma::abs(arma::mat(dataset.col(1)))), 0.0);
+  BOOST_REQUIRE_CLOSE((double) dataset(3, 2), -4.0, 1e-5);
+  BOOST_REQUIRE_EQUAL((double) dataset(1, 2), 0.0);
+  BOOST_REQUIRE_CLOSE((double) dataset(1, 3), 1.0, 1e-5);
+  BOOST_REQUIRE_CLOSE((double) dataset(2, 3), 7.0, 1e-5);
+  BOOST_REQUIRE_CLOSE((double) dataset(1, 4), 1.0, 1e-5);
+  BOOST_REQUIRE_EQUAL((double) dataset(2, 4), 0.0);
+
+  // Loading the same file into a dense matrix must give the same values.
+  arma::mat denseDataset;
+  DatasetInfo denseInfo;
+  data::LoadARFF("test.arff", denseDataset, denseInfo);
+
+  BOOST_REQUIRE_EQUAL(denseDataset.n_rows, 4);
+  BOOST_REQUIRE_EQUAL(denseDataset.n_cols, 5);
+  for (size_t i = 0; i < denseDataset.n_elem; ++i)
+    BOOST_REQUIRE_EQUAL(denseDataset[i], (double) dataset(i % 4, i / 4));
+
+  remove("test.arff");
+}
+
+/**
+ * Make sure malformed sparse ARFF rows are rejected.
+ */
+BOOST_AUTO_TEST_CASE(BadSparseARFFTest)
+{
+  const char* badRows[] = { "{0 1, 2 3}", "{0 1, 0 3}", "{0 1, 1}",
+      "{0 1, 1 2", "{-1 2}", "{0 ?}" };
+
+  for (size_t i = 0; i < 6; ++i)
+  {
+    fstream f;
+    f.open("test.arff", fstream::out);
+    f << "@relation test" << endl;
+    f << "@attribute one numeric" << endl;
+    f << "@attribute two numeric" << endl;
+    f << "@data" << endl;
+    f << "{1 4}" << endl;
+    f << badRows[i] << endl;
+    f.close();
+
+    arma::sp_mat dataset;
+    DatasetInfo info;
+    BOOST_REQUIRE_THROW(data::LoadARFF("test.arff", dataset, info),
+        std::runtime_error);
+  }
+
+  remove("test.arff");
+}
+
+/**
+ * Load a larger sparse ARFF file, which is parsed in many chunks, and check it
+ * against the matrix it was written from.
+ */
+BOOST_AUTO_TEST_CASE(LargeSparseARFFTest)
+{
+  arma::sp_mat original;
+  original.sprandu(1000, 5000, 0.01);
+
+  fstream f;
+  f.open("test.arff", fstream::out);
+  f << "@relation test" << endl;
+  for (size_t i = 0; i < original.n_rows; ++i)
+    f << "@attribute a" << i << " numeric" << endl;
+  f << "@data" << endl;
+  f << std::setprecision(17);
+  for (size_t i = 0; i < original.n_cols; ++i)
+  {
+    f << "{";
+    bool first = true;
+    for (arma::sp_mat::const_iterator it = original.begin_col(i);
+         it != original.end_col(i); ++it)
+    {
+      f << (first ? "" : ", ") << it.row() << " " << (*it);
+      first = false;
+    }
+    f << "}" << endl;
+  }
+  f.close();
+
+  arma::sp_mat dataset;
+  data::LoadARFF("test.arff", dataset);
+
+  BOOST_REQUIRE_EQUAL(dataset.n_rows, original.n_rows);
+  BOOST_REQUIRE_EQUAL(dataset.n_cols, original.n_cols);
+  BOOST_REQUIRE_EQUAL(dataset.n_nonzero, original.n_nonzero);
+  for (arma::sp_mat::const_iterator it = original.begin();
+       it != original.end(); ++it)
+    BOOST_REQUIRE_CLOSE((double) dataset(it.row(), it.col()), *it, 1e-10);
+
+  remove("test.arff");
+}
+
+/**
+ * Load a simple libsvm file.
+ */
+BOOST_AUTO_TEST_CASE(LibSVMLoadTest)
+{
+  fstream f;
+  f.open("test.svm", fstream::out);
+  f << "# A comment." << endl;
+  f << "1 1:0.5 3:-2 # comment" << endl;
+  f << endl;
+  f << "0 qid:3 2:4e2\t4:1" << endl;
+  f << "  1  " << endl;
+  f << "2 1:0 4:7" << endl;
+  f.close();
+
+  arma::sp_mat dataset;
+  arma::Row<size_t> labels;
+  data::LoadLibSVM("test.svm", dataset, labels);
+
+  BOOST_REQUIRE_EQUAL(dataset.n_rows, 4);
+  BOOST_REQUIRE_EQUAL(dataset.n_cols, 4);
+  BOOST_REQUIRE_EQUAL(labels.n_elem, 4);
+  BOOST_REQUIRE_EQUAL(labels[0], 1);
+  BOOST_REQUIRE_EQUAL(labels[1], 0);
+  BOOST_REQUIRE_EQUAL(labels[2], 1);
+  BOOST_REQUIRE_EQUAL(labels[3], 2);
+
+  // The explicit zero isn't stored.
+  BOOST_REQUIRE_EQUAL(dataset.n_nonzero, 5);
+  BOOST_REQUIRE_CLOSE((double) dataset(0, 0), 0.5, 1e-5);
+  BOOST_REQUIRE_CLOSE((double) dataset(2, 0), -2.0, 1e-5);
+  BOOST_REQUIRE_CLOSE((double) dataset(1, 1), 400.0, 1e-5);
+  BOOST_REQUIRE_CLOSE((double) dataset(3, 1), 1.0, 1e-5);
+  BOOST_REQUIRE_CLOSE((double) dataset(3, 3), 7.0, 1e-5);
+  BOOST_REQUIRE_EQUAL((double) dataset(0, 3), 0.0);
+
+  // The matrix must be usable as any other.
+  arma::mat sums(arma::sum(dataset, 1));
+  BOOST_REQUIRE_CLOSE(sums[3], 8.0, 1e-5);
+
+  // A larger dimensionality can be given, but not a smaller one.
+  data::LoadLibSVM("test.svm", dataset, labels, 10);
+  BOOST_REQUIRE_EQUAL(dataset.n_rows, 10);
+  BOOST_REQUIRE_EQUAL(dataset.n_nonzero, 5);
+  BOOST_REQUIRE_THROW(data::LoadLibSVM("test.svm", dataset, labels, 3),
+      std::runtime_error);
+
+  remove("test.svm");
+}
+
+/**
+ * Make sure that malformed libsvm files and labels which don't fit in the
+ * label type are rejected.
+ */
+BOOST_AUTO_TEST_CASE(BadLibSVMTest)
+{
+  const char* badLines[] = { "1 2:1 1:3", "1 0:1", "1 1:", "1 1:x", "a 1:1",
+      "1,2 1:1", "1 1 2", "1 -1:2", "-1 1:1" };
+
+  for (size_t i = 0; i < 9; ++i)
+  {
+    fstream f;
+    f.open("test.svm", fstream::out);
+    f << "1 1:1" << endl;
+    f << badLines[i] << endl;
+    f.close();
+
+    arma::sp_mat dataset;
+    arma::Row<size_t> labels;
+    BOOST_REQUIRE_THROW(data::LoadLibSVM("test.svm", dataset, labels),
+        std::runtime_error);
+  }
+
+  // Negative labels are fine with a signed or floating-point label type.
+  arma::sp_mat dataset;
+  arma::Row<double> labels;
+  data::LoadLibSVM("test.svm", dataset, labels);
+  BOOST_REQUIRE_EQUAL(labels[1], -1.0);
+
+  remove("test.svm");
+}
+
+/**
+ * Load a larger libsvm file, which is parsed in many chunks, and check it
+ * against the matrix it was written from.
+ */
+BOOST_AUTO_TEST_CASE(LargeLibSVMTest)
+{
+  arma::sp_mat original;
+  original.sprandu(2000, 10000, 0.005);
+  arma::Row<size_t> originalLabels =
+      arma::randi<arma::Row<size_t>>(10000, arma::distr_param(0, 4));
+
+  fstream f;
+  f.open("test.svm", fstream::out);
+  f << std::setprecision(17);
+  for (size_t i = 0; i < original.n_cols; ++i)
+  {
+    f << originalLabels[i];
+    for (arma::sp_mat::const_iterator it = original.begin_col(i);
+         it != original.end_col(i); ++it)
+      f << " " << (it.row() + 1) << ":" << (*it);
+    f << endl;
+  }
+  f.close();
+
+  arma::sp_mat dataset;
+  arma::Row<size_t> labels;
+  data::LoadLibSVM("test.svm", dataset, labels, original.n_rows);
+
+  BOOST_REQUIRE_EQUAL(dataset.n_rows, original.n_rows);
+  BOOST_REQUIRE_EQUAL(dataset.n_cols, original.n_cols);
+  BOOST_REQUIRE_EQUAL(dataset.n_nonzero, original.n_nonzero);
+  for (arma::sp_mat::const_iterator it = original.begin();
+       it != original.end(); ++it)
+    BOOST_REQUIRE_CLOSE((double) dataset(it.row(), it.col()), *it, 1e-10);
+  for (size_t i = 0; i < labels.n_elem; ++i)
+    BOOST_REQUIRE_EQUAL(labels[i], originalLabels[i]);
+
+  remove("test.svm");
+}
+
 /**
  * Test that a CSV with the wrong number of columns fails.
  */
@@ -1971,6 +2226,225 @@ BOOST_AUTO_TEST_CASE(LoadCSVNoTransposeTXTTest)
   remove("test.txt");
 }
 
+/**
+ * Make sure that a large categorical CSV, which is split between many threads
+ * while loading, is mapped in file order, and that the result does not depend
+ * on the number of threads.
+ */
+BOOST_AUTO_TEST_CASE(LargeCategoricalCSVLoadTest)
+{
+  const size_t numLines = 20000;
+
+  // The first dimension is numeric, the second is categorical, and the third
+  // only becomes categorical near the end of the file.
+  fstream f;
+  f.open("test.csv", fstream::out);
+  for (size_t i = 0; i < numLines; ++i)
+  {
+    f << i << ", c" << (i * 7919) % 13 << ", ";
+    if (i == 15000)
+      f << "x" << endl;
+    else
+      f << (i % 5) << endl;
+  }
+  f.close();
+
+  arma::mat dataset;
+  DatasetInfo info;
+  BOOST_REQUIRE(data::Load("test.csv", dataset, info, true));
+
+  BOOST_REQUIRE_EQUAL(dataset.n_rows, 3);
+  BOOST_REQUIRE_EQUAL(dataset.n_cols, numLines);
+  BOOST_REQUIRE(info.Type(0) == Datatype::numeric);
+  BOOST_REQUIRE(info.Type(1) == Datatype::categorical);
+  BOOST_REQUIRE(info.Type(2) == Datatype::categorical);
+  BOOST_REQUIRE_EQUAL(info.NumMappings(1), 13);
+  BOOST_REQUIRE_EQUAL(info.NumMappings(2), 6);
+
+  // Strings are mapped in the order they first appear in the file.
+  std::map<size_t, size_t> categories;
+  for (size_t i = 0; i < numLines; ++i)
+  {
+    const size_t category = (i * 7919) % 13;
+    if (categories.count(category) == 0)
+    {
+      const size_t mapping = categories.size();
+      categories[category] = mapping;
+    }
+
+    BOOST_REQUIRE_EQUAL(dataset(0, i), (double) i);
+    BOOST_REQUIRE_EQUAL(dataset(1, i), (double) categories[category]);
+    if (i == 15000)
+      BOOST_REQUIRE_EQUAL(dataset(2, i), 5.0);
+    else
+      BOOST_REQUIRE_EQUAL(dataset(2, i), (double) (i % 5));
+  }
+
+  // Now load non-transposed, where each line is a dimension.
+  arma::mat ntDataset;
+  DatasetInfo ntInfo;
+  BOOST_REQUIRE(data::Load("test.csv", ntDataset, ntInfo, true, false));
+
+  BOOST_REQUIRE_EQUAL(ntDataset.n_rows, numLines);
+  BOOST_REQUIRE_EQUAL(ntDataset.n_cols, 3);
+  BOOST_REQUIRE_EQUAL(ntInfo.Dimensionality(), numLines);
+  for (size_t i = 0; i < numLines; ++i)
+  {
+    BOOST_REQUIRE(ntInfo.Type(i) == Datatype::categorical);
+    // For the first five lines, the first and last fields are the same.
+    BOOST_REQUIRE_EQUAL(ntInfo.NumMappings(i), (i < 5) ? 2 : 3);
+    BOOST_REQUIRE_EQUAL(ntDataset(i, 0), 0.0);
+    BOOST_REQUIRE_EQUAL(ntDataset(i, 1), 1.0);
+  }
+
+#ifdef HAS_OPENMP
+  // Loading with one thread should give exactly the same results.
+  const int numThreads = omp_get_max_threads();
+  omp_set_num_threads(1);
+
+  arma::mat serialDataset, ntSerialDataset;
+  DatasetInfo serialInfo, ntSerialInfo;
+  const bool loaded = data::Load("test.csv", serialDataset, serialInfo, false);
+  const bool ntLoaded = data::Load("test.csv", ntSerialDataset, ntSerialInfo,
+      false, false);
+  omp_set_num_threads(numThreads);
+
+  BOOST_REQUIRE(loaded);
+  BOOST_REQUIRE(ntLoaded);
+  CheckMatrices(dataset, serialDataset);
+  CheckMatrices(ntDataset, ntSerialDataset);
+  for (size_t d = 0; d < 3; ++d)
+  {
+    BOOST_REQUIRE(info.Type(d) == serialInfo.Type(d));
+    BOOST_REQUIRE_EQUAL(info.NumMappings(d), serialInfo.NumMappings(d));
+  }
+#endif
+
+  remove("test.csv");
+}
+
+/**
+ * Read all the chunks of a StreamingDataset, check their sizes, and put them
+ * back together.
+ */
+template<typename eT>
+arma::Mat<eT> ReadAllChunks(StreamingDataset<eT>& dataset)
+{
+  arma::Mat<eT> all, chunk;
+  while (dataset.Next(chunk))
+  {
+    BOOST_REQUIRE_EQUAL(chunk.n_rows, dataset.Dimensionality());
+    BOOST_REQUIRE_LE(chunk.n_cols, dataset.ChunkSize());
+    BOOST_REQUIRE_GT(chunk.n_cols, 0);
+    all = arma::join_rows(all, chunk);
+  }
+
+  BOOST_REQUIRE_EQUAL(chunk.n_cols, 0);
+  return all;
+}
+
+/**
+ * Make sure a CSV can be streamed in chunks, with and without prefetching, and
+ * that it gives the same points as data::Load().
+ */
+BOOST_AUTO_TEST_CASE(StreamingDatasetCSVTest)
+{
+  arma::mat data = arma::randu<arma::mat>(3, 25);
+  data::Save("test.csv", data);
+
+  arma::mat loaded;
+  BOOST_REQUIRE(data::Load("test.csv", loaded));
+
+  for (size_t p = 0; p < 2; ++p)
+  {
+    StreamingDataset<> dataset("test.csv", 10, (p == 0));
+    BOOST_REQUIRE_EQUAL(dataset.Dimensionality(), 3);
+    BOOST_REQUIRE_EQUAL(dataset.NumPoints(), 25);
+
+    CheckMatrices(ReadAllChunks(dataset), loaded);
+
+    // Another pass should give the same points.
+    dataset.Reset();
+    CheckMatrices(ReadAllChunks(dataset), loaded);
+
+    // Reset in the middle of a pass.
+    arma::mat chunk;
+    BOOST_REQUIRE(dataset.Next(chunk));
+    dataset.Reset();
+    CheckMatrices(ReadAllChunks(dataset), loaded);
+  }
+
+  remove("test.csv");
+}
+
+/**
+ * Make sure an Armadillo binary file can be streamed, and that labels are split
+ * off correctly.
+ */
+BOOST_AUTO_TEST_CASE(StreamingDatasetBinaryTest)
+{
+  arma::mat data = arma::randu<arma::mat>(4, 1003);
+  data.row(3) = arma::floor(3 * data.row(3));
+  data::Save("test.bin", data, true, false);
+
+  StreamingDataset<> dataset("test.bin", 100);
+  BOOST_REQUIRE_EQUAL(dataset.Dimensionality(), 4);
+  BOOST_REQUIRE_EQUAL(dataset.NumPoints(), 1003);
+
+  CheckMatrices(ReadAllChunks(dataset), data);
+
+  dataset.Reset();
+  arma::mat points;
+  arma::Row<size_t> labels;
+  size_t numPoints = 0;
+  while (dataset.Next(points, labels))
+  {
+    BOOST_REQUIRE_EQUAL(points.n_rows, 3);
+    BOOST_REQUIRE_EQUAL(labels.n_elem, points.n_cols);
+    for (size_t i = 0; i < points.n_cols; ++i)
+    {
+      for (size_t d = 0; d < 3; ++d)
+        BOOST_REQUIRE_EQUAL(points(d, i), data(d, numPoints + i));
+      BOOST_REQUIRE_EQUAL(labels[i], (size_t) data(3, numPoints + i));
+    }
+    numPoints += points.n_cols;
+  }
+  BOOST_REQUIRE_EQUAL(numPoints, 1003);
+
+  // The element type has to match the file.
+  BOOST_REQUIRE_THROW(StreamingDataset<float>("test.bin"), std::runtime_error);
+
+  remove("test.bin");
+}
+
+/**
+ * Make sure a malformed or non-numeric CSV can't be streamed.
+ */
+BOOST_AUTO_TEST_CASE(StreamingDatasetMalformedTest)
+{
+  fstream f;
+  f.open("test.csv", fstream::out);
+  f << "1, 2, 3" << endl;
+  f << "4, 5" << endl;
+  f.close();
+
+  StreamingDataset<> dataset("test.csv");
+  arma::mat chunk;
+  BOOST_REQUIRE_THROW(dataset.Next(chunk), std::runtime_error);
+
+  f.open("test.csv", fstream::out);
+  f << "1, 2, 3" << endl;
+  f << "4, hello, 6" << endl;
+  f.close();
+
+  StreamingDataset<> stringDataset("test.csv", 10, false);
+  BOOST_REQUIRE_THROW(stringDataset.Next(chunk), std::runtime_error);
+
+  BOOST_REQUIRE_THROW(StreamingDataset<>("test.arff"), std::runtime_error);
+
+  remove("test.csv");
+}
+
 /**
  * Make sure DatasetMapper properly unmaps from non-unique strings.
  */
@@ -1994,4 +2468,90 @@ BOOST_AUTO_TEST_CASE(DatasetMapperNonUniqueTest)
   BOOST_REQUIRE_EQUAL(dm.UnmapString(nan, 0, 2), "cheese");
 }
 
+/**
+ * Make sure a matrix saved with SaveMapped() can be mapped back correctly.
+ */
+BOOST_AUTO_TEST_CASE(MappedMatrixTest)
+{
+  arma::mat dataset = arma::randu<arma::mat>(7, 123);
+  BOOST_REQUIRE(data::SaveMapped("test_mapped.mbin", dataset) == true);
+
+  {
+    MappedMatrix<double> mapped("test_mapped.mbin");
+
+    BOOST_REQUIRE_EQUAL(mapped.Matrix().n_rows, 7);
+    BOOST_REQUIRE_EQUAL(mapped.Matrix().n_cols, 123);
+    for (size_t i = 0; i < dataset.n_elem; ++i)
+      BOOST_REQUIRE_EQUAL(mapped.Matrix()[i], dataset[i]);
+  }
+
+  // A copy-on-write mapping can be modified without changing the file.
+  {
+    MappedMatrix<double> mapped("test_mapped.mbin", true);
+    mapped.Matrix().zeros();
+    BOOST_REQUIRE_EQUAL(arma::accu(mapped.Matrix()), 0.0);
+  }
+
+  {
+    MappedMatrix<double> mapped("test_mapped.mbin");
+    for (size_t i = 0; i < dataset.n_elem; ++i)
+      BOOST_REQUIRE_EQUAL(mapped.Matrix()[i], dataset[i]);
+  }
+
+  // Mapping with the wrong element type should fail.
+  Log::Fatal.ignoreInput = true;
+  BOOST_REQUIRE_THROW(MappedMatrix<float>("test_mapped.mbin"),
+      std::runtime_error);
+  BOOST_REQUIRE_THROW(MappedMatrix<double>("nonexistent_______.mbin"),
+      std::runtime_error);
+  Log::Fatal.ignoreInput = false;
+
+  remove("test_mapped.mbin");
+}
+
+/**
+ * Make sure that text saved by the parallel writer loads back exactly, in both
+ * orientations and for integer matrices, even when it spans many chunks.
+ */
+BOOST_AUTO_TEST_CASE(SaveTextRoundTripTest)
+{
+  arma::mat test(7, 20000, arma::fill::randn);
+  test.col(0).fill(0.1);
+  test(1, 1) = -1e-300;
+  test(2, 2) = 1e300;
+
+  for (const std::string filename : { "test_file.csv", "test_file.txt" })
+  {
+    BOOST_REQUIRE(data::Save(filename, test));
+    arma::mat loaded;
+    BOOST_REQUIRE(data::Load(filename, loaded));
+    BOOST_REQUIRE_EQUAL(loaded.n_rows, test.n_rows);
+    BOOST_REQUIRE_EQUAL(loaded.n_cols, test.n_cols);
+    BOOST_REQUIRE_EQUAL(arma::accu(loaded != test), 0);
+
+    BOOST_REQUIRE(data::Save(filename, test, false, false));
+    BOOST_REQUIRE(data::Load(filename, loaded, false, false));
+    BOOST_REQUIRE_EQUAL(arma::accu(loaded != test), 0);
+    remove(filename.c_str());
+  }
+
+  arma::Mat<size_t> indices = arma::randi<arma::Mat<size_t>>(3, 5000,
+      arma::distr_param(0, 1000000));
+  indices(0, 0) = 0;
+  BOOST_REQUIRE(data::Save("test_file.csv", indices));
+  arma::Mat<size_t> loadedIndices;
+  BOOST_REQUIRE(data::Load("test_file.csv", loadedIndices));
+  BOOST_REQUIRE_EQUAL(arma::accu(loadedIndices != indices), 0);
+  remove("test_file.csv");
+
+  // Check the formatting of a few values directly.
+  char buffer[32];
+  BOOST_REQUIRE_EQUAL(std::string(buffer, data::FormatValue(buffer, 0.1)),
+      "0.1");
+  BOOST_REQUIRE_EQUAL(std::string(buffer, data::FormatValue(buffer, -42)),
+      "-42");
+  BOOST_REQUIRE_EQUAL(std::string(buffer, data::FormatValue(buffer,
+      (size_t) 1234567)), "1234567");
+}
+
 BOOST_AUTO_TEST_SUITE_END();
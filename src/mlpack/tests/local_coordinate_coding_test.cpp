@@ -86,6 +86,67 @@ BOOST_AUTO_TEST_CASE(LocalCoordinateCodingTestCodingStep)
   }
 }
 
+/**
+ * Make sure that the codes are the same with one thread as with all of them,
+ * and the same as weighting the dictionary with diagmat() and running a new
+ * LARS object for each point.
+ */
+BOOST_AUTO_TEST_CASE(LocalCoordinateCodingTestCodingStepParallel)
+{
+  double lambda1 = 0.1;
+  uword nAtoms = 10;
+
+  mat X;
+  X.load("mnist_first250_training_4s_and_9s.arm");
+  uword nPoints = X.n_cols;
+
+  // normalize each point since these are images
+  for (uword i = 0; i < nPoints; i++)
+  {
+    X.col(i) /= norm(X.col(i), 2);
+  }
+
+  LocalCoordinateCoding lcc(X, nAtoms, lambda1, 10);
+
+  mat serialZ;
+  {
+    Parallel::Scope scope(1);
+    lcc.Encode(X, serialZ);
+  }
+
+  mat Z;
+  lcc.Encode(X, Z);
+
+  const mat& D = lcc.Dictionary();
+  mat dictGram = trans(D) * D;
+  for (uword i = 0; i < nPoints; i++)
+  {
+    vec invW(nAtoms);
+    for (uword j = 0; j < nAtoms; j++)
+    {
+      invW[j] = 1.0 / (accu(square(D.col(j))) + accu(square(X.col(i))) -
+          2 * dot(D.col(j), X.col(i)));
+    }
+
+    mat dictPrime = D * diagmat(invW);
+    mat dictGramTD = diagmat(invW) * dictGram * diagmat(invW);
+    LARS lars(false, dictGramTD, 0.5 * lambda1);
+    vec code;
+    rowvec responses = trans(X.col(i));
+    lars.Train(dictPrime, responses, code, false);
+    code %= invW;
+
+    for (uword j = 0; j < nAtoms; j++)
+    {
+      BOOST_REQUIRE_EQUAL(Z(j, i), serialZ(j, i));
+      if (std::abs(code[j]) < 1e-8)
+        BOOST_REQUIRE_SMALL(Z(j, i), 1e-8);
+      else
+        BOOST_REQUIRE_CLOSE(Z(j, i), code[j], 1e-5);
+    }
+  }
+}
+
 BOOST_AUTO_TEST_CASE(LocalCoordinateCodingTestDictionaryStep)
 {
   const double tol = 0.1;
@@ -13,6 +13,8 @@
 #include <mlpack/core.hpp>
 #include <mlpack/methods/logistic_regression/logistic_regression.hpp>
 #include <mlpack/core/optimizers/sgd/sgd.hpp>
+#include <mlpack/core/optimizers/ada_grad/sparse_ada_grad_update.hpp>
+#include <mlpack/core/optimizers/ada_grad/ada_grad_update.hpp>
 
 #include <boost/test/unit_test.hpp>
 #include "test_tools.hpp"
@@ -483,6 +485,48 @@ BOOST_AUTO_TEST_CASE(LogisticRegressionFunctionRegularizationSeparableGradient)
   }
 }
 
+/**
+ * Make sure that EvaluateWithGradient() gives the same results as Evaluate()
+ * and Gradient(), and that the optimizers can detect it.
+ */
+BOOST_AUTO_TEST_CASE(LogisticRegressionFunctionEvaluateWithGradient)
+{
+  BOOST_REQUIRE(HasEvaluateWithGradient<LogisticRegressionFunction<> >::value);
+  BOOST_REQUIRE(HasSeparableEvaluateWithGradient<
+      LogisticRegressionFunction<> >::value);
+
+  const size_t points = 500;
+  const size_t dimension = 10;
+
+  arma::mat data;
+  data.randu(dimension, points);
+  arma::Row<size_t> responses(points);
+  for (size_t i = 0; i < points; ++i)
+    responses[i] = math::RandInt(0, 2);
+
+  LogisticRegressionFunction<> lrf(data, responses, 0.5);
+
+  arma::mat parameters(1, dimension + 1);
+  parameters.randu();
+
+  arma::mat gradient, fusedGradient;
+  lrf.Gradient(parameters, gradient);
+  const double objective = lrf.EvaluateWithGradient(parameters,
+      fusedGradient);
+  BOOST_REQUIRE_CLOSE(objective, lrf.Evaluate(parameters), 1e-5);
+  CheckMatrices(gradient, fusedGradient);
+
+  for (size_t begin = 0; begin < points; begin += 100)
+  {
+    lrf.Gradient(parameters, begin, gradient, 100);
+    const double batchObjective = lrf.EvaluateWithGradient(parameters, begin,
+        fusedGradient, 100);
+    BOOST_REQUIRE_CLOSE(batchObjective, lrf.Evaluate(parameters, begin, 100),
+        1e-5);
+    CheckMatrices(gradient, fusedGradient);
+  }
+}
+
 // Test training of logistic regression on a simple dataset.
 BOOST_AUTO_TEST_CASE(LogisticRegressionLBFGSSimpleTest)
 {
@@ -813,6 +857,95 @@ BOOST_AUTO_TEST_CASE(LogisticRegressionSparseSGDTest)
     BOOST_REQUIRE_CLOSE(lr.Parameters()[i], lrSparse.Parameters()[i], 1e-5);
 }
 
+/**
+ * Make sure that the sparse gradient of a batch is the dense gradient, with and
+ * without regularization.
+ */
+BOOST_AUTO_TEST_CASE(LogisticRegressionFunctionSparseGradient)
+{
+  arma::sp_mat data;
+  data.sprandu(20, 200, 0.1);
+  arma::Row<size_t> responses(200);
+  for (size_t i = 0; i < 200; ++i)
+    responses[i] = math::RandInt(0, 2);
+
+  const arma::mat parameters = arma::randn<arma::mat>(1, 21);
+  for (double lambda = 0.0; lambda <= 0.5; lambda += 0.5)
+  {
+    LogisticRegressionFunction<arma::sp_mat> lrf(data, responses, lambda);
+    for (size_t begin = 0; begin < 200; begin += 50)
+    {
+      arma::mat denseGradient;
+      arma::sp_mat sparseGradient;
+      lrf.Gradient(parameters, begin, denseGradient, 50);
+      lrf.Gradient(parameters, begin, sparseGradient, 50);
+
+      CheckMatrices(arma::mat(sparseGradient), denseGradient, 1e-7);
+    }
+  }
+}
+
+/**
+ * Make sure that with an update policy for sparse gradients, SGD on sparse
+ * data takes the same steps as with the dense update policy.
+ */
+BOOST_AUTO_TEST_CASE(LogisticRegressionSparseGradientSGDTest)
+{
+  arma::sp_mat dataset;
+  dataset.sprandu(30, 800, 0.05);
+  arma::Row<size_t> labels(800);
+  for (size_t i = 0; i < 800; ++i)
+    labels[i] = math::RandInt(0, 2);
+
+  LogisticRegression<arma::sp_mat> lr(30, 0.0);
+  SGD<AdaGradUpdate> sgd(0.01, 32, 8000, 1e-5, false);
+  lr.Train(dataset, labels, sgd);
+
+  LogisticRegression<arma::sp_mat> lrSparse(30, 0.0);
+  SGD<SparseAdaGradUpdate> sgdSparse(0.01, 32, 8000, 1e-5, false);
+  lrSparse.Train(dataset, labels, sgdSparse);
+
+  BOOST_REQUIRE_EQUAL(lr.Parameters().n_elem, lrSparse.Parameters().n_elem);
+  for (size_t i = 0; i < lr.Parameters().n_elem; ++i)
+    BOOST_REQUIRE_CLOSE(lr.Parameters()[i], lrSparse.Parameters()[i], 1e-5);
+}
+
+/**
+ * Make sure that training on a streamed dataset gives the same model as
+ * training on the same dataset in memory.  The chunk size is not a multiple of
+ * the batch size, so some batches span two chunks.
+ */
+BOOST_AUTO_TEST_CASE(LogisticRegressionStreamingSGDTest)
+{
+  arma::mat dataset = arma::randu<arma::mat>(10, 800);
+  arma::Row<size_t> labels(800);
+  for (size_t i = 0; i < 800; ++i)
+    labels[i] = math::RandInt(0, 2);
+
+  LogisticRegression<> lr(10, 0.3);
+  SGD<> sgd(0.01, 32, 8000);
+  sgd.Shuffle() = false;
+  lr.Train(dataset, labels, sgd);
+
+  // Store the labels as the last dimension, one point per column.
+  arma::mat labeledDataset = arma::join_cols(dataset,
+      arma::conv_to<arma::rowvec>::from(labels));
+  data::Save("test.bin", labeledDataset, true, false);
+
+  data::StreamingDataset<> streamingDataset("test.bin", 100);
+  LogisticRegression<> streamingLr(10, 0.3);
+  SGD<> streamingSgd(0.01, 32, 8000);
+  streamingSgd.Shuffle() = false;
+  streamingLr.Train(streamingDataset, streamingSgd);
+
+  BOOST_REQUIRE_EQUAL(lr.Parameters().n_elem,
+      streamingLr.Parameters().n_elem);
+  for (size_t i = 0; i < lr.Parameters().n_elem; ++i)
+    BOOST_REQUIRE_CLOSE(lr.Parameters()[i], streamingLr.Parameters()[i], 1e-5);
+
+  remove("test.bin");
+}
+
 /**
  * Test multi-point classification (Classify()).
  */
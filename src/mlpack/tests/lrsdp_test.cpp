@@ -276,6 +276,82 @@ BOOST_AUTO_TEST_CASE(GaussianMatrixSensingSDP)
   BOOST_REQUIRE_SMALL(err, 0.05);
 }
 
+/**
+ * Make sure that the constraints and the gradient of the augmented Lagrangian
+ * are the same as when they are computed directly from R R^T, with both sparse
+ * and dense constraints.
+ */
+BOOST_AUTO_TEST_CASE(LRSDPConstraintsTest)
+{
+  const size_t n = 20;
+  const size_t numSparse = 15;
+  const size_t numDense = 3;
+
+  arma::mat coordinates(n, 4, arma::fill::randu);
+  LRSDPFunction<SDP<arma::mat>> function(numSparse, numDense, coordinates);
+
+  function.SDP().C().randu(n, n);
+  function.SDP().C() += function.SDP().C().t();
+  function.SDP().SparseB().randu(numSparse);
+  function.SDP().DenseB().randu(numDense);
+  for (size_t i = 0; i < numSparse; ++i)
+  {
+    arma::sp_mat a;
+    a.sprandu(n, n, 0.05);
+    function.SDP().SparseA()[i] = a + a.t();
+  }
+  for (size_t i = 0; i < numDense; ++i)
+  {
+    function.SDP().DenseA()[i].randu(n, n);
+    function.SDP().DenseA()[i] += function.SDP().DenseA()[i].t();
+  }
+
+  const arma::mat rrt = coordinates * trans(coordinates);
+
+  arma::vec constraints;
+  function.EvaluateConstraints(coordinates, constraints);
+  BOOST_REQUIRE_EQUAL(constraints.n_elem, numSparse + numDense);
+  for (size_t i = 0; i < numSparse + numDense; ++i)
+  {
+    const double constraint = (i < numSparse) ?
+        accu(function.SDP().SparseA()[i] % rrt) - function.SDP().SparseB()[i] :
+        accu(function.SDP().DenseA()[i - numSparse] % rrt) -
+        function.SDP().DenseB()[i - numSparse];
+
+    BOOST_REQUIRE_SMALL(constraints[i] - constraint, 1e-10);
+    BOOST_REQUIRE_SMALL(function.EvaluateConstraint(i, coordinates) -
+        constraint, 1e-10);
+  }
+
+  // Now the augmented Lagrangian and its gradient.
+  AugLagrangianFunction<LRSDPFunction<SDP<arma::mat>>> augLag(function);
+  augLag.Lambda().randu(numSparse + numDense);
+  augLag.Sigma() = 3.0;
+
+  arma::mat s = function.SDP().C();
+  double objective = accu(function.SDP().C() % rrt);
+  for (size_t i = 0; i < numSparse + numDense; ++i)
+  {
+    const double y = augLag.Lambda()[i] - augLag.Sigma() * constraints[i];
+    objective -= augLag.Lambda()[i] * constraints[i];
+    objective += (augLag.Sigma() / 2.) * constraints[i] * constraints[i];
+    if (i < numSparse)
+      s -= y * function.SDP().SparseA()[i];
+    else
+      s -= y * function.SDP().DenseA()[i - numSparse];
+  }
+  const arma::mat gradient = 2 * s * coordinates;
+
+  BOOST_REQUIRE_CLOSE(augLag.Evaluate(coordinates), objective, 1e-8);
+
+  arma::mat augLagGradient;
+  augLag.Gradient(coordinates, augLagGradient);
+  BOOST_REQUIRE_EQUAL(augLagGradient.n_rows, gradient.n_rows);
+  BOOST_REQUIRE_EQUAL(augLagGradient.n_cols, gradient.n_cols);
+  for (size_t i = 0; i < gradient.n_elem; ++i)
+    BOOST_REQUIRE_SMALL(augLagGradient[i] - gradient[i], 1e-8);
+}
+
 /**
  * keller4.co test case for Lovasz-Theta LRSDP.
  * This is commented out because it takes a long time to run.
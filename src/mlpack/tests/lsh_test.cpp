@@ -912,4 +912,82 @@ BOOST_AUTO_TEST_CASE(MoveOperatorTest)
   CheckMatrices(distances, distances2);
 }
 
+/**
+ * Test: inserting points into a trained model should give the same results as
+ * training on all of the points with the same projections, offsets and second
+ * hash weights.
+ */
+BOOST_AUTO_TEST_CASE(InsertTest)
+{
+  arma::mat dataset = arma::randu<arma::mat>(10, 1000);
+  arma::mat queries = arma::randu<arma::mat>(10, 100);
+  const arma::cube projections = arma::randn<arma::cube>(10, 5, 8);
+
+  // The offsets and the second hash weights are the only random parts of
+  // Train() when the hash width and the projections are given.  Buckets are
+  // unlimited so no points are dropped.
+  math::RandomSeed(42);
+  LSHSearch<> lsh(dataset, projections, 1.0, 99901, 0);
+
+  math::RandomSeed(42);
+  LSHSearch<> insertedLsh(dataset.cols(0, 599), projections, 1.0, 99901, 0);
+  insertedLsh.Insert(dataset.cols(600, 899));
+  insertedLsh.Insert(dataset.cols(900, 999));
+
+  BOOST_REQUIRE_EQUAL(insertedLsh.ReferenceSet().n_cols, 1000);
+  BOOST_REQUIRE_EQUAL(insertedLsh.BucketContents().n_elem,
+      lsh.BucketContents().n_elem);
+  BOOST_REQUIRE_EQUAL(insertedLsh.BucketOffsets().n_elem,
+      lsh.BucketOffsets().n_elem);
+
+  arma::Mat<size_t> neighbors, insertedNeighbors;
+  arma::mat distances, insertedDistances;
+
+  lsh.Search(queries, 5, neighbors, distances, 0, 2);
+  insertedLsh.Search(queries, 5, insertedNeighbors, insertedDistances, 0, 2);
+
+  CheckMatrices(neighbors, insertedNeighbors);
+  CheckMatrices(distances, insertedDistances);
+
+  // Inserting never grows a bucket past the bucket size.
+  LSHSearch<> smallLsh(dataset.cols(0, 499), 5, 4, 10.0, 99901, 3);
+  smallLsh.Insert(dataset.cols(500, 999));
+  for (size_t i = 0; i + 1 < smallLsh.BucketOffsets().n_elem; ++i)
+  {
+    BOOST_REQUIRE_LE(smallLsh.BucketOffsets()[i + 1] -
+        smallLsh.BucketOffsets()[i], 3);
+  }
+
+  // Points of the wrong dimensionality can't be inserted.
+  BOOST_REQUIRE_THROW(smallLsh.Insert(arma::randu<arma::mat>(9, 10)),
+      std::invalid_argument);
+}
+
+/**
+ * Test: queries are hashed in blocks, so searching a query set at once should
+ * give the same results as searching each query alone.
+ */
+BOOST_AUTO_TEST_CASE(BlockedQueryHashingTest)
+{
+  arma::mat dataset = arma::randu<arma::mat>(10, 1000);
+  arma::mat queries = arma::randu<arma::mat>(10, 150);
+
+  LSHSearch<> lsh(dataset, 5, 8);
+
+  arma::Mat<size_t> neighbors, singleNeighbors;
+  arma::mat distances, singleDistances;
+
+  // Search only some of the tables, with multiprobe.
+  lsh.Search(queries, 3, neighbors, distances, 6, 3);
+
+  for (size_t i = 0; i < queries.n_cols; ++i)
+  {
+    lsh.Search(arma::mat(queries.col(i)), 3, singleNeighbors, singleDistances,
+        6, 3);
+
+    CheckMatrices(arma::Mat<size_t>(neighbors.col(i)), singleNeighbors);
+    CheckMatrices(arma::mat(distances.col(i)), singleDistances);
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END();
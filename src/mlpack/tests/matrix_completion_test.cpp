@@ -64,4 +64,56 @@ BOOST_AUTO_TEST_CASE(UniformMatrixCompletionSDP)
   }
 }
 
+/**
+ * Complete a random low-rank matrix with alternating least squares, and make
+ * sure that the factors give the same matrix as Recover().
+ */
+BOOST_AUTO_TEST_CASE(MatrixCompletionALSTest)
+{
+  // The entries are positive, so that no known entry is zero.
+  const arma::mat x = arma::randu<arma::mat>(60, 3) *
+      arma::randu<arma::mat>(3, 50) + 0.1;
+
+  // Keep about 60% of the entries.
+  std::vector<size_t> rows, cols;
+  for (size_t j = 0; j < x.n_cols; ++j)
+  {
+    for (size_t i = 0; i < x.n_rows; ++i)
+    {
+      if (math::Random() < 0.6)
+      {
+        rows.push_back(i);
+        cols.push_back(j);
+      }
+    }
+  }
+
+  arma::umat indices(2, rows.size());
+  arma::vec values(rows.size());
+  for (size_t i = 0; i < rows.size(); ++i)
+  {
+    indices(0, i) = rows[i];
+    indices(1, i) = cols[i];
+    values[i] = x(rows[i], cols[i]);
+  }
+
+  MatrixCompletion mc(x.n_rows, x.n_cols, indices, values, 4,
+      MatrixCompletion::ALTERNATING_LEAST_SQUARES);
+  BOOST_REQUIRE_EQUAL(mc.Sdp().SDP().NumConstraints(), 0);
+
+  arma::mat recovered;
+  mc.Recover(recovered);
+  BOOST_REQUIRE_SMALL(arma::norm(x - recovered, "fro") / arma::norm(x, "fro"),
+      1e-2);
+
+  arma::mat w, h;
+  mc.Recover(w, h);
+  BOOST_REQUIRE_EQUAL(w.n_rows, x.n_rows);
+  BOOST_REQUIRE_EQUAL(w.n_cols, 4);
+  BOOST_REQUIRE_EQUAL(h.n_rows, 4);
+  BOOST_REQUIRE_EQUAL(h.n_cols, x.n_cols);
+  BOOST_REQUIRE_SMALL(arma::norm(x - w * h, "fro") / arma::norm(x, "fro"),
+      1e-2);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
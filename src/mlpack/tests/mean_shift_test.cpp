@@ -90,6 +90,32 @@ BOOST_AUTO_TEST_CASE(MeanShiftSimpleTest)
     BOOST_REQUIRE_EQUAL(assignments(i), thirdClass);
 }
 
+/**
+ * Use every point as a seed, so that many seeds converge to each mode and the
+ * duplicate centroids have to be merged.
+ */
+BOOST_AUTO_TEST_CASE(MeanShiftNoSeedsTest)
+{
+  MeanShift<> meanShift(2.0);
+
+  arma::Col<size_t> assignments;
+  arma::mat centroids;
+  meanShift.Cluster((arma::mat) trans(meanShiftData), assignments, centroids,
+      false);
+
+  BOOST_REQUIRE_EQUAL(centroids.n_cols, 3);
+  for (size_t i = 1; i < 13; i++)
+    BOOST_REQUIRE_EQUAL(assignments(i), assignments(0));
+  for (size_t i = 14; i < 20; i++)
+    BOOST_REQUIRE_EQUAL(assignments(i), assignments(13));
+  for (size_t i = 21; i < 30; i++)
+    BOOST_REQUIRE_EQUAL(assignments(i), assignments(20));
+
+  BOOST_REQUIRE_NE(assignments(0), assignments(13));
+  BOOST_REQUIRE_NE(assignments(13), assignments(20));
+  BOOST_REQUIRE_NE(assignments(0), assignments(20));
+}
+
 // Generate samples from four Gaussians, and make sure mean shift nearly
 // recovers those four centers.
 BOOST_AUTO_TEST_CASE(GaussianClustering)
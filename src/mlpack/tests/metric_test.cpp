@@ -10,6 +10,7 @@
  */
 #include <mlpack/core.hpp>
 #include <mlpack/core/metrics/lmetric.hpp>
+#include <mlpack/core/metrics/evaluate_block.hpp>
 #include <boost/test/unit_test.hpp>
 #include "test_tools.hpp"
 
@@ -87,4 +88,52 @@ BOOST_AUTO_TEST_CASE(LINFMetricTest)
                       lMetric.Evaluate(a2, b2), 1e-5);
 }
 
+//! Make sure the block evaluation gives the same results as Evaluate().
+template<typename MetricType, typename eT = double>
+void CheckBlockEvaluate(const double tolerance = 1e-5)
+{
+  arma::Mat<eT> points(7, 23);
+  points.randn();
+  arma::Col<eT> point(7);
+  point.randn();
+
+  MetricType metric;
+
+  // Use blocks of all sizes, so that all the code paths are taken.
+  arma::vec distances;
+  for (size_t begin = 0; begin < 5; ++begin)
+  {
+    for (size_t count = 0; begin + count <= points.n_cols; ++count)
+    {
+      EvaluateBlock(metric, point, points, begin, count, distances);
+
+      BOOST_REQUIRE_EQUAL(distances.n_elem, count);
+      for (size_t i = 0; i < count; ++i)
+      {
+        BOOST_REQUIRE_CLOSE(distances[i],
+            (double) metric.Evaluate(point, points.col(begin + i)), tolerance);
+      }
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(BlockEvaluateTest)
+{
+  CheckBlockEvaluate<ManhattanDistance>();
+  CheckBlockEvaluate<SquaredEuclideanDistance>();
+  CheckBlockEvaluate<EuclideanDistance>();
+  CheckBlockEvaluate<LMetric<3, true>>();
+  CheckBlockEvaluate<LMetric<3, false>>();
+  CheckBlockEvaluate<ChebyshevDistance>();
+}
+
+//! The L1 and L2 kernels for float points must give the right results too.
+BOOST_AUTO_TEST_CASE(BlockEvaluateFloatTest)
+{
+  CheckBlockEvaluate<ManhattanDistance, float>(1e-3);
+  CheckBlockEvaluate<SquaredEuclideanDistance, float>(1e-3);
+  CheckBlockEvaluate<EuclideanDistance, float>(1e-3);
+  CheckBlockEvaluate<ChebyshevDistance, float>(1e-3);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
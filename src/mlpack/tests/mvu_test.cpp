@@ -0,0 +1,125 @@
+/**
+ * @file mvu_test.cpp
+ *
+ * Tests for Maximum Variance Unfolding and its objective function.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/methods/mvu/mvu.hpp>
+#include <mlpack/methods/mvu/mvu_function.hpp>
+
+#include <set>
+
+#include <boost/test/unit_test.hpp>
+#include "test_tools.hpp"
+
+using namespace mlpack;
+using namespace mlpack::mvu;
+using namespace mlpack::optimization;
+
+BOOST_AUTO_TEST_SUITE(MVUTest);
+
+/**
+ * Make sure that each neighbor pair gives exactly one constraint, and that the
+ * constraints are evaluated the same way one at a time and all at once.
+ */
+BOOST_AUTO_TEST_CASE(MVUFunctionConstraintsTest)
+{
+  arma::mat data = arma::randu<arma::mat>(3, 200);
+  MVUFunction f(data, 2, 5);
+
+  std::set<std::pair<size_t, size_t>> pairs;
+  for (size_t c = 0; c < f.NumConstraints(); ++c)
+  {
+    const size_t i = std::min(f.First()[c], f.Second()[c]);
+    const size_t j = std::max(f.First()[c], f.Second()[c]);
+    BOOST_REQUIRE(pairs.insert(std::make_pair(i, j)).second);
+    BOOST_REQUIRE_CLOSE(f.SquaredDistances()[c],
+        arma::accu(arma::square(data.col(i) - data.col(j))), 1e-5);
+  }
+  BOOST_REQUIRE_GE(f.NumConstraints(), 200 * 5 / 2);
+  BOOST_REQUIRE_LE(f.NumConstraints(), 200 * 5);
+
+  const arma::mat coordinates = arma::randu<arma::mat>(2, 200);
+  arma::vec constraints;
+  f.EvaluateConstraints(coordinates, constraints);
+  for (size_t c = 0; c < f.NumConstraints(); ++c)
+  {
+    BOOST_REQUIRE_CLOSE(constraints[c], f.EvaluateConstraint(c, coordinates),
+        1e-5);
+  }
+}
+
+/**
+ * Check the gradient of the augmented Lagrangian numerically.
+ */
+BOOST_AUTO_TEST_CASE(MVUAugLagrangianGradientTest)
+{
+  arma::mat data = arma::randu<arma::mat>(3, 50);
+  MVUFunction f(data, 2, 4);
+
+  const arma::vec lambda = arma::randu<arma::vec>(f.NumConstraints());
+  AugLagrangianFunction<MVUFunction> augFunction(f, lambda, 3.0);
+
+  arma::mat coordinates = arma::randu<arma::mat>(2, 50);
+  arma::mat gradient;
+  augFunction.Gradient(coordinates, gradient);
+
+  const double epsilon = 1e-6;
+  for (size_t i = 0; i < coordinates.n_elem; ++i)
+  {
+    const double original = coordinates[i];
+    coordinates[i] = original + epsilon;
+    const double plus = augFunction.Evaluate(coordinates);
+    coordinates[i] = original - epsilon;
+    const double minus = augFunction.Evaluate(coordinates);
+    coordinates[i] = original;
+
+    const double numGradient = (plus - minus) / (2 * epsilon);
+    if (std::abs(gradient[i]) < 1e-5)
+      BOOST_REQUIRE_SMALL(numGradient, 1e-4);
+    else
+      BOOST_REQUIRE_CLOSE(numGradient, gradient[i], 1e-2);
+  }
+}
+
+/**
+ * Unfold an arc of a circle into a line, and make sure that the distances to
+ * the neighbors are kept and that the result is centered.
+ */
+BOOST_AUTO_TEST_CASE(MVUUnfoldArcTest)
+{
+  const size_t n = 100;
+  arma::mat data(2, n);
+  for (size_t i = 0; i < n; ++i)
+  {
+    const double angle = M_PI * i / (n - 1);
+    data(0, i) = std::cos(angle);
+    data(1, i) = std::sin(angle);
+  }
+
+  MVU mvu(data);
+  arma::mat output;
+  mvu.Unfold(1, 2, output);
+
+  BOOST_REQUIRE_EQUAL(output.n_rows, 1);
+  BOOST_REQUIRE_EQUAL(output.n_cols, n);
+  BOOST_REQUIRE_SMALL(arma::mean(output.row(0)), 1e-5);
+
+  // Consecutive points of the arc are neighbors, so their distance is kept.
+  for (size_t i = 1; i < n; ++i)
+  {
+    const double distance = arma::norm(data.col(i) - data.col(i - 1));
+    BOOST_REQUIRE_CLOSE(std::abs(output(0, i) - output(0, i - 1)), distance,
+        5.0);
+  }
+
+  // The unfolded arc is longer than its diameter.
+  BOOST_REQUIRE_GT(output.max() - output.min(), 2.5);
+}
+
+BOOST_AUTO_TEST_SUITE_END();
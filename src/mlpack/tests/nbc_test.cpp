@@ -10,6 +10,7 @@
  */
 #include <mlpack/core.hpp>
 #include <mlpack/methods/naive_bayes/naive_bayes_classifier.hpp>
+#include <mlpack/methods/naive_bayes/multinomial_naive_bayes_classifier.hpp>
 
 #include <boost/test/unit_test.hpp>
 #include "test_tools.hpp"
@@ -314,4 +315,136 @@ BOOST_AUTO_TEST_CASE(SeparateTrainIndividualIncrementalTest)
   }
 }
 
+/**
+ * Ensure that training on a sparse matrix gives the same model as training on
+ * the same data in a dense matrix.
+ */
+BOOST_AUTO_TEST_CASE(SparseTrainTest)
+{
+  const char* trainFilename = "trainSet.csv";
+  size_t classes = 2;
+
+  arma::mat trainData;
+  data::Load(trainFilename, trainData, true);
+
+  // Get the labels out.
+  arma::Row<size_t> labels(trainData.n_cols);
+  for (size_t i = 0; i < trainData.n_cols; ++i)
+    labels[i] = trainData(trainData.n_rows - 1, i);
+  trainData.shed_row(trainData.n_rows - 1);
+
+  // Zero out some of the data so that the sparse matrix is actually sparse.
+  trainData.elem(arma::find(arma::abs(trainData) < 0.5)).zeros();
+  arma::sp_mat sparseTrainData(trainData);
+
+  NaiveBayesClassifier<> nbc(trainData.n_rows, classes);
+  nbc.Train(trainData, labels, classes);
+  NaiveBayesClassifier<> nbcSparse(trainData.n_rows, classes);
+  nbcSparse.Train(sparseTrainData, labels, classes);
+
+  for (size_t i = 0; i < nbc.Means().n_elem; ++i)
+  {
+    if (std::abs(nbc.Means()[i]) < 1e-5)
+      BOOST_REQUIRE_SMALL(nbcSparse.Means()[i], 1e-5);
+    else
+      BOOST_REQUIRE_CLOSE(nbc.Means()[i], nbcSparse.Means()[i], 1e-5);
+  }
+
+  for (size_t i = 0; i < nbc.Variances().n_elem; ++i)
+  {
+    if (std::abs(nbc.Variances()[i]) < 1e-5)
+      BOOST_REQUIRE_SMALL(nbcSparse.Variances()[i], 1e-5);
+    else
+      BOOST_REQUIRE_CLOSE(nbc.Variances()[i], nbcSparse.Variances()[i], 1e-5);
+  }
+
+  for (size_t i = 0; i < nbc.Probabilities().n_elem; ++i)
+    BOOST_REQUIRE_CLOSE(nbc.Probabilities()[i], nbcSparse.Probabilities()[i],
+        1e-5);
+}
+
+/**
+ * Make sure the multinomial classifier learns the smoothed feature
+ * distributions of each class, and classifies points that are made of the
+ * words of one class correctly.
+ */
+BOOST_AUTO_TEST_CASE(MultinomialNaiveBayesSimpleTest)
+{
+  // Class 0 uses words 0 and 1; class 1 uses words 2 and 3.
+  arma::mat data("3 0 1 0;"
+                 "1 2 0 0;"
+                 "0 0 2 1;"
+                 "0 0 1 3");
+  arma::Row<size_t> labels("0 0 1 1");
+
+  MultinomialNaiveBayesClassifier<> mnb(data, labels, 2, 1.0);
+
+  // The smoothed counts of class 0 are (4, 4, 1, 1), out of 10.
+  BOOST_REQUIRE_CLOSE(std::exp(mnb.LogTheta()(0, 0)), 0.4, 1e-5);
+  BOOST_REQUIRE_CLOSE(std::exp(mnb.LogTheta()(1, 0)), 0.4, 1e-5);
+  BOOST_REQUIRE_CLOSE(std::exp(mnb.LogTheta()(2, 0)), 0.1, 1e-5);
+  BOOST_REQUIRE_CLOSE(std::exp(mnb.LogTheta()(3, 0)), 0.1, 1e-5);
+  BOOST_REQUIRE_CLOSE(std::exp(mnb.LogPriors()[0]), 0.5, 1e-5);
+
+  arma::mat testData("2 0;"
+                     "2 0;"
+                     "0 1;"
+                     "0 4");
+  arma::Row<size_t> predictions;
+  arma::mat probabilities;
+  mnb.Classify(testData, predictions, probabilities);
+
+  BOOST_REQUIRE_EQUAL(predictions[0], 0);
+  BOOST_REQUIRE_EQUAL(predictions[1], 1);
+  for (size_t i = 0; i < probabilities.n_cols; ++i)
+    BOOST_REQUIRE_CLOSE(arma::accu(probabilities.col(i)), 1.0, 1e-5);
+
+  BOOST_REQUIRE_EQUAL(mnb.Classify(testData.col(1)), 1);
+}
+
+/**
+ * Ensure that the multinomial classifier gives the same model and the same
+ * predictions for sparse data as for the same data in a dense matrix, also
+ * when the points span several batches.
+ */
+BOOST_AUTO_TEST_CASE(MultinomialNaiveBayesSparseTest)
+{
+  arma::sp_mat sparseData;
+  sparseData.sprandu(100, 3000, 0.05);
+  sparseData = arma::ceil(10 * sparseData);
+  arma::mat data(sparseData);
+
+  arma::Row<size_t> labels(data.n_cols);
+  for (size_t i = 0; i < data.n_cols; ++i)
+    labels[i] = math::RandInt(0, 4);
+
+  MultinomialNaiveBayesClassifier<> mnb(data, labels, 4);
+  MultinomialNaiveBayesClassifier<> mnbSparse(sparseData, labels, 4);
+
+  for (size_t i = 0; i < mnb.LogTheta().n_elem; ++i)
+    BOOST_REQUIRE_CLOSE(mnb.LogTheta()[i], mnbSparse.LogTheta()[i], 1e-5);
+  for (size_t i = 0; i < mnb.LogPriors().n_elem; ++i)
+    BOOST_REQUIRE_CLOSE(mnb.LogPriors()[i], mnbSparse.LogPriors()[i], 1e-5);
+
+  arma::Row<size_t> predictions, sparsePredictions;
+  arma::mat probabilities, sparseProbabilities;
+  mnb.Classify(data, predictions, probabilities);
+  mnbSparse.Classify(sparseData, sparsePredictions, sparseProbabilities);
+
+  for (size_t i = 0; i < predictions.n_elem; ++i)
+  {
+    BOOST_REQUIRE_EQUAL(predictions[i], sparsePredictions[i]);
+    BOOST_REQUIRE_EQUAL(predictions[i],
+        mnbSparse.Classify(sparseData.col(i)));
+  }
+
+  for (size_t i = 0; i < probabilities.n_elem; ++i)
+  {
+    if (std::abs(probabilities[i]) < 1e-5)
+      BOOST_REQUIRE_SMALL(sparseProbabilities[i], 1e-5);
+    else
+      BOOST_REQUIRE_CLOSE(probabilities[i], sparseProbabilities[i], 1e-5);
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END();
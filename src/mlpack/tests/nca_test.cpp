@@ -322,4 +322,72 @@ BOOST_AUTO_TEST_CASE(NCALBFGSSimpleDataset)
   BOOST_REQUIRE_LT(arma::norm(finalGradient, 2), 1e-6);
 }
 
+/**
+ * When the number of neighbors covers every other point, the approximate
+ * objective function and gradients should be the same as the exact ones.
+ */
+BOOST_AUTO_TEST_CASE(SoftmaxNeighborsAllPoints)
+{
+  arma::mat data;
+  data.randu(3, 40);
+  arma::Row<size_t> labels(40);
+  for (size_t i = 0; i < labels.n_elem; ++i)
+    labels[i] = i % 3;
+
+  arma::mat coordinates = arma::eye<arma::mat>(3, 3) +
+      0.1 * arma::randu<arma::mat>(3, 3);
+
+  SoftmaxErrorFunction<SquaredEuclideanDistance> exact(data, labels);
+  SoftmaxErrorFunction<SquaredEuclideanDistance> approx(data, labels,
+      SquaredEuclideanDistance(), 38);
+
+  BOOST_REQUIRE_CLOSE(approx.Evaluate(coordinates),
+      exact.Evaluate(coordinates), 1e-5);
+
+  arma::mat exactGradient, approxGradient;
+  exact.Gradient(coordinates, exactGradient);
+  approx.Gradient(coordinates, approxGradient);
+  BOOST_REQUIRE_EQUAL(approxGradient.n_rows, exactGradient.n_rows);
+  BOOST_REQUIRE_EQUAL(approxGradient.n_cols, exactGradient.n_cols);
+  for (size_t i = 0; i < exactGradient.n_elem; ++i)
+    BOOST_REQUIRE_CLOSE(approxGradient[i], exactGradient[i], 1e-5);
+
+  // Check the separable versions too.
+  BOOST_REQUIRE_CLOSE(approx.Evaluate(coordinates, 5, 10),
+      exact.Evaluate(coordinates, 5, 10), 1e-5);
+
+  exact.Gradient(coordinates, 5, exactGradient, 10);
+  approx.Gradient(coordinates, 5, approxGradient, 10);
+  for (size_t i = 0; i < exactGradient.n_elem; ++i)
+    BOOST_REQUIRE_CLOSE(approxGradient[i], exactGradient[i], 1e-5);
+}
+
+/**
+ * With few neighbors, NCA with L-BFGS should still learn a distance that is
+ * better than the identity.
+ */
+BOOST_AUTO_TEST_CASE(NCALBFGSNeighbors)
+{
+  // Two classes that overlap in the first dimension, but not in the second.
+  arma::mat data = arma::randu<arma::mat>(2, 200);
+  arma::Row<size_t> labels(200);
+  for (size_t i = 0; i < 200; ++i)
+  {
+    labels[i] = (i < 100) ? 0 : 1;
+    data(1, i) = 0.2 * data(1, i) + ((i < 100) ? 0.0 : 0.25);
+    data(0, i) *= 5.0;
+  }
+
+  NCA<SquaredEuclideanDistance, L_BFGS> nca(data, labels);
+  nca.Neighbors() = 10;
+  nca.Optimizer().MaxIterations() = 100;
+
+  arma::mat outputMatrix;
+  nca.LearnDistance(outputMatrix);
+
+  SoftmaxErrorFunction<SquaredEuclideanDistance> sef(data, labels);
+  BOOST_REQUIRE_LT(sef.Evaluate(outputMatrix),
+      sef.Evaluate(arma::eye<arma::mat>(2, 2)));
+}
+
 BOOST_AUTO_TEST_SUITE_END();
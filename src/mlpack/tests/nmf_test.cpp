@@ -222,4 +222,40 @@ BOOST_AUTO_TEST_CASE(SparseNMFALSTest)
       1e-5);
 }
 
+/**
+ * Check that the multiplicative divergence update rules give the same
+ * factorization for sparse and dense matrices; the sparse rules only evaluate
+ * W * H at the nonzero entries of V.
+ */
+BOOST_AUTO_TEST_CASE(SparseNMFDivTest)
+{
+  mat w, h, dw, dh;
+  sp_mat v;
+  v.sprandu(30, 25, 0.3);
+  // Ensure there is at least one nonzero element in every row and column.
+  for (size_t i = 0; i < 25; ++i)
+    v(i, i) += 1e-5;
+  mat dv(v); // Make a dense copy.
+  const size_t r = 5;
+
+  // Get an initialization.
+  arma::mat iw, ih;
+  RandomAcolInitialization<>::Initialize(v, r, iw, ih);
+  GivenInitialization g(std::move(iw), std::move(ih));
+
+  SimpleResidueTermination srt(1e-10, 200);
+  AMF<SimpleResidueTermination, GivenInitialization,
+      NMFMultiplicativeDivergenceUpdate> nmf(srt, g);
+  nmf.Apply(v, r, w, h);
+  nmf.Apply(dv, r, dw, dh);
+
+  // Reconstruct matrices.
+  const mat vp = w * h;
+  const mat dvp = dw * dh;
+
+  BOOST_REQUIRE(vp.is_finite());
+  BOOST_REQUIRE_SMALL(arma::norm(vp - dvp, "fro") / arma::norm(dvp, "fro"),
+      1e-5);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -202,4 +202,51 @@ BOOST_AUTO_TEST_CASE(GermanTest)
   }
 }
 
+/**
+ * Mapping the points of the dataset with the cached factorization should give
+ * the same feature vectors as Apply(), and with a full-rank approximation the
+ * feature vectors of new points should reproduce the kernel values between
+ * the new points and the dataset.
+ */
+BOOST_AUTO_TEST_CASE(OutOfSampleTest)
+{
+  arma::mat data;
+  data.randu(5, 50);
+  arma::mat newPoints;
+  newPoints.randu(5, 20);
+
+  GaussianKernel gk;
+  NystroemMethod<GaussianKernel, OrderedSelection> nm(data, gk, 50);
+
+  arma::mat newG;
+  BOOST_REQUIRE_THROW(nm.Apply(newPoints, newG), std::logic_error);
+
+  arma::mat g;
+  nm.Apply(g);
+
+  arma::mat mapped;
+  nm.Apply(data, mapped);
+  BOOST_REQUIRE_EQUAL(mapped.n_rows, g.n_rows);
+  BOOST_REQUIRE_EQUAL(mapped.n_cols, g.n_cols);
+  for (size_t i = 0; i < g.n_elem; ++i)
+  {
+    if (std::abs(g[i]) < 1e-5)
+      BOOST_REQUIRE_SMALL(mapped[i], 1e-5);
+    else
+      BOOST_REQUIRE_CLOSE(mapped[i], g[i], 1e-5);
+  }
+
+  nm.Apply(newPoints, newG);
+  BOOST_REQUIRE_EQUAL(newG.n_rows, newPoints.n_cols);
+  const arma::mat approximation = newG * g.t();
+  for (size_t i = 0; i < newPoints.n_cols; ++i)
+  {
+    for (size_t j = 0; j < data.n_cols; ++j)
+    {
+      const double value = gk.Evaluate(newPoints.col(i), data.col(j));
+      BOOST_REQUIRE_CLOSE(approximation(i, j), value, 1e-3);
+    }
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -179,6 +179,27 @@ BOOST_AUTO_TEST_CASE(OverlapTest)
   CheckOverlap(t2);
 }
 
+/**
+ * Make sure that a tree large enough for its children to be built in parallel
+ * has correct mappings and no overlapping children.
+ */
+BOOST_AUTO_TEST_CASE(ParallelConstructionTest)
+{
+  arma::mat dataset(3, 30000, arma::fill::randu);
+  std::vector<size_t> oldFromNew;
+
+  Octree<> t(dataset, oldFromNew, 10);
+
+  BOOST_REQUIRE_EQUAL(t.NumDescendants(), 30000);
+  for (size_t i = 0; i < oldFromNew.size(); ++i)
+  {
+    BOOST_REQUIRE_SMALL(arma::norm(dataset.col(oldFromNew[i]) -
+        t.Dataset().col(i)), 1e-10);
+  }
+
+  CheckOverlap(t);
+}
+
 /**
  * Make sure no points are further than the furthest point distance, and that no
  * descendants are further than the furthest descendant distance.
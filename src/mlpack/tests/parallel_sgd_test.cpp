@@ -14,6 +14,7 @@
 #include <mlpack/core/optimizers/parallel_sgd/decay_policies/exponential_backoff.hpp>
 #include <mlpack/core/optimizers/parallel_sgd/sparse_test_function.hpp>
 #include <mlpack/core/optimizers/lbfgs/test_functions.hpp>
+#include <mlpack/methods/logistic_regression/logistic_regression.hpp>
 // We need some thorough testing
 #define private public
 #include <mlpack/core/optimizers/parallel_sgd/parallel_sgd.hpp>
@@ -27,6 +28,8 @@ using namespace arma;
 using namespace mlpack;
 using namespace mlpack::optimization;
 using namespace mlpack::optimization::test;
+using namespace mlpack::distribution;
+using namespace mlpack::regression;
 
 BOOST_AUTO_TEST_SUITE(ParallelSGDTest);
 
@@ -102,6 +105,96 @@ BOOST_AUTO_TEST_CASE(GeneralizedRosenbrockTest)
   }
 }
 
+/**
+ * Without atomic updates, and with the objective only evaluated every few
+ * iterations, parallel SGD should still converge on the sparse test function,
+ * since the updates of the threads are disjoint.
+ */
+BOOST_AUTO_TEST_CASE(HogwildParallelSGDTest)
+{
+  SparseTestFunction f;
+
+  ConstantStep decayPolicy(0.4);
+
+  size_t threadsAvailable = omp_get_max_threads();
+
+  for (size_t i = threadsAvailable; i > 0; --i)
+  {
+    omp_set_num_threads(i);
+
+    size_t batchSize = std::ceil((float) f.NumFunctions() / i);
+
+    ParallelSGD<ConstantStep> s(10000, batchSize, 1e-5, true, decayPolicy, 32,
+        5, false);
+
+    arma::mat coordinates = f.GetInitialPoint();
+    double result = s.Optimize(f, coordinates);
+
+    BOOST_REQUIRE_CLOSE(result, 123.75, 0.01);
+
+    BOOST_REQUIRE_CLOSE(coordinates[0], 2, 0.02);
+    BOOST_REQUIRE_CLOSE(coordinates[1], 1, 0.02);
+    BOOST_REQUIRE_CLOSE(coordinates[2], 1.5, 0.02);
+    BOOST_REQUIRE_CLOSE(coordinates[3], 4, 0.02);
+  }
+}
+
+/**
+ * Parallel SGD should train logistic regression, a dense objective, with
+ * mini-batches, with and without atomic updates.
+ */
+BOOST_AUTO_TEST_CASE(LogisticRegressionParallelSGDTest)
+{
+  // Generate a two-Gaussian dataset.
+  GaussianDistribution g1(arma::vec("1.0 1.0 1.0"), arma::eye<arma::mat>(3, 3));
+  GaussianDistribution g2(arma::vec("9.0 9.0 9.0"), arma::eye<arma::mat>(3, 3));
+
+  arma::mat data(3, 1000);
+  arma::Row<size_t> responses(1000);
+  for (size_t i = 0; i < 500; ++i)
+  {
+    data.col(i) = g1.Random();
+    responses[i] = 0;
+  }
+  for (size_t i = 500; i < 1000; ++i)
+  {
+    data.col(i) = g2.Random();
+    responses[i] = 1;
+  }
+
+  omp_set_num_threads(omp_get_max_threads());
+  const size_t threadShareSize = std::ceil((float) data.n_cols /
+      omp_get_max_threads());
+
+  for (size_t atomic = 0; atomic < 2; ++atomic)
+  {
+    ConstantStep decayPolicy(0.01);
+    ParallelSGD<ConstantStep> s(100, threadShareSize, 1e-5, true, decayPolicy,
+        32, 10, atomic == 1);
+
+    LogisticRegression<> lr(data.n_rows, 0.5);
+    lr.Train(data, responses, s);
+
+    // Ensure that the error is close to zero.
+    const double acc = lr.ComputeAccuracy(data, responses);
+    BOOST_REQUIRE_CLOSE(acc, 100.0, 0.3); // 0.3% error tolerance.
+  }
+}
+
+/**
+ * Make sure that an optimization that could never terminate is rejected.
+ */
+BOOST_AUTO_TEST_CASE(ParallelSGDNoEvaluationTest)
+{
+  SparseTestFunction f;
+
+  ParallelSGD<ConstantStep> s(0, f.NumFunctions(), 1e-5, true, ConstantStep(),
+      32, 0);
+
+  arma::mat coordinates = f.GetInitialPoint();
+  BOOST_REQUIRE_THROW(s.Optimize(f, coordinates), std::invalid_argument);
+}
+
 #endif
 
 /**
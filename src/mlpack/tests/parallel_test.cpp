@@ -0,0 +1,97 @@
+/**
+ * @file parallel_test.cpp
+ *
+ * Tests for the thread budget of mlpack.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/core/data/first_touch.hpp>
+
+#include <boost/test/unit_test.hpp>
+#include "test_tools.hpp"
+
+using namespace mlpack;
+
+BOOST_AUTO_TEST_SUITE(ParallelTest);
+
+/**
+ * Make sure that the budget is set and restored, and that a Scope can only
+ * lower it.
+ */
+BOOST_AUTO_TEST_CASE(ParallelScopeTest)
+{
+  Parallel::SetMaxThreads(4);
+#ifdef HAS_OPENMP
+  BOOST_REQUIRE_EQUAL(Parallel::MaxThreads(), 4);
+  BOOST_REQUIRE_EQUAL(Parallel::Threads(), 4);
+#else
+  BOOST_REQUIRE_EQUAL(Parallel::Threads(), 1);
+#endif
+
+  {
+    Parallel::Scope scope(2);
+    BOOST_REQUIRE_LE(Parallel::Threads(), 2);
+
+    // The inner scope can't raise the budget.
+    Parallel::Scope inner(8);
+    BOOST_REQUIRE_LE(Parallel::Threads(), 2);
+  }
+
+#ifdef HAS_OPENMP
+  BOOST_REQUIRE_EQUAL(Parallel::MaxThreads(), 4);
+#endif
+
+  // Restore the default.
+  Parallel::SetMaxThreads(0);
+  BOOST_REQUIRE_GE(Parallel::MaxThreads(), 1);
+}
+
+/**
+ * Make sure that a parallel region that can't be nested gets one thread.
+ */
+BOOST_AUTO_TEST_CASE(ParallelNestedTest)
+{
+  size_t nestedThreads = 0;
+  #pragma omp parallel num_threads(2)
+  {
+    const size_t threads = Parallel::Threads();
+    #pragma omp critical
+    nestedThreads = std::max(nestedThreads, threads);
+  }
+
+#if defined(HAS_OPENMP) && (_OPENMP >= 200805)
+  if (omp_get_max_active_levels() <= 1)
+    BOOST_REQUIRE_EQUAL(nestedThreads, 1);
+#else
+  BOOST_REQUIRE_EQUAL(nestedThreads, 1);
+#endif
+}
+
+/**
+ * Make sure that FirstTouch() copies the matrix exactly, for any block size.
+ */
+BOOST_AUTO_TEST_CASE(FirstTouchTest)
+{
+  arma::mat source(5, 1003, arma::fill::randu);
+
+  for (const size_t blockSize : { 1, 7, 256, 2000 })
+  {
+    arma::mat placed;
+    data::FirstTouch(source, placed, blockSize);
+    BOOST_REQUIRE_EQUAL(placed.n_rows, source.n_rows);
+    BOOST_REQUIRE_EQUAL(placed.n_cols, source.n_cols);
+    BOOST_REQUIRE_EQUAL(arma::accu(placed != source), 0);
+  }
+
+  arma::mat matrix(source);
+  data::FirstTouch(matrix);
+  BOOST_REQUIRE_EQUAL(arma::accu(matrix != source), 0);
+
+  BOOST_REQUIRE_THROW(data::FirstTouch(matrix, 0), std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_SUITE_END();
@@ -13,12 +13,14 @@
 #include <mlpack/core.hpp>
 #include <mlpack/methods/pca/pca.hpp>
 #include <mlpack/methods/pca/decomposition_policies/exact_svd_method.hpp>
+#include <mlpack/methods/pca/decomposition_policies/incremental_svd_method.hpp>
 #include <mlpack/methods/pca/decomposition_policies/quic_svd_method.hpp>
 #include <mlpack/methods/pca/decomposition_policies/randomized_svd_method.hpp>
 #include <mlpack/methods/pca/decomposition_policies/randomized_block_krylov_method.hpp>
 
 #include <boost/test/unit_test.hpp>
 #include "test_tools.hpp"
+#include "serialization.hpp"
 
 BOOST_AUTO_TEST_SUITE(PCATest);
 
@@ -266,6 +268,91 @@ BOOST_AUTO_TEST_CASE(ExactPCAVarianceRetainedTest)
   PCAVarianceRetained<ExactSVDPolicy>();
 }
 
+/**
+ * Compare the output of our incremental PCA implementation with Armadillo's,
+ * when the data is fed in several batches.
+ */
+BOOST_AUTO_TEST_CASE(ArmaComparisonIncrementalPCATest)
+{
+  IncrementalSVDPolicy decomposition(0, 128);
+  ArmaComparisonPCA<IncrementalSVDPolicy>(false, decomposition);
+}
+
+/**
+ * Test that dimensionality reduction with incremental PCA works the same way
+ * MATLAB does, when the data is fed in several batches.
+ */
+BOOST_AUTO_TEST_CASE(IncrementalPCADimensionalityReductionTest)
+{
+  IncrementalSVDPolicy decomposition(0, 2);
+  PCADimensionalityReduction<IncrementalSVDPolicy>(false, decomposition);
+}
+
+/**
+ * Make sure that updating the incremental decomposition batch by batch gives
+ * the same mean and leading components as exact PCA on all the points, and
+ * that its state can be saved and restored between updates.
+ */
+BOOST_AUTO_TEST_CASE(IncrementalPCAUpdateTest)
+{
+  // Data of rank 4 (after centering) in 10 dimensions, so keeping 4
+  // components is exact.
+  arma::mat data = arma::randn<arma::mat>(10, 4) *
+      arma::diagmat(arma::vec("8 4 2 1")) * arma::randn<arma::mat>(4, 600);
+  data.each_col() += arma::randu<arma::vec>(10);
+
+  IncrementalSVDPolicy ipca(4);
+  ipca.Update(data.cols(0, 249));
+
+  // Save and restore the model before the remaining updates.
+  IncrementalSVDPolicy xmlIpca, textIpca, binaryIpca;
+  SerializeObjectAll(ipca, xmlIpca, textIpca, binaryIpca);
+  BOOST_REQUIRE_EQUAL(binaryIpca.NumPoints(), 250);
+
+  ipca.Update(data.cols(250, 299));
+  ipca.Update(data.cols(300, 599));
+  binaryIpca.Update(data.cols(250, 299));
+  binaryIpca.Update(data.cols(300, 599));
+  BOOST_REQUIRE_EQUAL(ipca.NumPoints(), 600);
+  BOOST_REQUIRE_EQUAL(ipca.Components().n_cols, 4);
+
+  arma::vec eigVal, exactEigVal, binaryEigVal;
+  arma::mat eigvec, exactEigvec, binaryEigvec, transformed;
+  ipca.EigenDecomposition(eigVal, eigvec);
+  binaryIpca.EigenDecomposition(binaryEigVal, binaryEigvec);
+
+  PCA p;
+  p.Apply(data, transformed, exactEigVal, exactEigvec);
+
+  for (size_t i = 0; i < 10; ++i)
+    BOOST_REQUIRE_CLOSE(ipca.Mean()[i], arma::mean(data.row(i)), 1e-5);
+
+  for (size_t i = 0; i < 4; ++i)
+  {
+    BOOST_REQUIRE_CLOSE(eigVal[i], exactEigVal[i], 1e-5);
+    BOOST_REQUIRE_CLOSE(binaryEigVal[i], exactEigVal[i], 1e-5);
+    BOOST_REQUIRE_CLOSE(std::abs(arma::dot(eigvec.col(i),
+        exactEigvec.col(i))), 1.0, 1e-5);
+  }
+
+  // The projection of the points should match too, up to the sign.
+  arma::mat incrementalTransformed;
+  ipca.Transform(data, incrementalTransformed);
+  for (size_t i = 0; i < 4; ++i)
+  {
+    const double sign = arma::dot(eigvec.col(i), exactEigvec.col(i)) > 0 ?
+        1.0 : -1.0;
+    for (size_t j = 0; j < data.n_cols; ++j)
+    {
+      if (std::abs(transformed(i, j)) < 1e-5)
+        BOOST_REQUIRE_SMALL(incrementalTransformed(i, j), 1e-5);
+      else
+        BOOST_REQUIRE_CLOSE(sign * incrementalTransformed(i, j),
+            transformed(i, j), 1e-3);
+    }
+  }
+}
+
 /**
  * Test that scaling PCA works.
  */
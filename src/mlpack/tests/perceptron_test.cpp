@@ -255,4 +255,30 @@ BOOST_AUTO_TEST_CASE(SecondaryConstructor)
   Perceptron<> p2(p1);
 }
 
+/**
+ * Make sure that parallel training converges on linearly separable data with
+ * 3 classes, and classifies every training point correctly.
+ */
+BOOST_AUTO_TEST_CASE(ParallelTrainTest)
+{
+  mat trainData(2, 3000);
+  Row<size_t> labels(3000);
+  for (size_t i = 0; i < 3000; ++i)
+  {
+    labels[i] = i % 3;
+    trainData.col(i) = 0.5 * randn<vec>(2);
+    if (labels[i] > 0)
+      trainData(labels[i] - 1, i) += 10.0;
+  }
+
+  Perceptron<> p(3, 2, 1000);
+  p.ParallelTrain(trainData, labels, 3);
+
+  Row<size_t> predictedLabels;
+  p.Classify(trainData, predictedLabels);
+
+  for (size_t i = 0; i < predictedLabels.n_elem; i++)
+    BOOST_REQUIRE_EQUAL(predictedLabels[i], labels[i]);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -239,4 +239,77 @@ BOOST_AUTO_TEST_CASE(TestArmaCustomPrecision)
       BASH_GREEN "[INFO ] " BASH_CLEAR "   4.0000   4.5000   5.0000\n");
 }
 
+/**
+ * Make sure that an ignored stream prints nothing, and prints as a new stream
+ * would once it is no longer ignored; that an ignored fatal stream still
+ * throws; and that MLPACK_LOG_INFO and MLPACK_LOG_DEBUG only evaluate their
+ * arguments when they print them, and then print the same as Log::Info and
+ * Log::Debug.
+ */
+BOOST_AUTO_TEST_CASE(TestIgnoredPrefixedOutStream)
+{
+  arma::vec test("1.0 1.5 2.0");
+
+  std::stringstream ss;
+  PrefixedOutStream pss(ss, BASH_GREEN "[INFO ] " BASH_CLEAR, true);
+  pss << "Not shown: " << 3.141592654 << " " << 5 << std::endl;
+  pss << test;
+  pss << "Not shown either." << std::endl;
+  BOOST_REQUIRE_EQUAL(ss.str(), "");
+
+  pss.ignoreInput = false;
+  pss << "Now shown." << std::endl;
+  BOOST_REQUIRE_EQUAL(ss.str(),
+      BASH_GREEN "[INFO ] " BASH_CLEAR "Now shown.\n");
+
+  std::stringstream fatalStream;
+  PrefixedOutStream fatal(fatalStream, BASH_RED "[FATAL] " BASH_CLEAR, true,
+      true);
+  BOOST_REQUIRE_THROW(fatal << "Error." << std::endl, std::runtime_error);
+  BOOST_REQUIRE_EQUAL(fatalStream.str(), "");
+
+  // Send std::cout, the destination of Log::Info and Log::Debug, to a string.
+  size_t calls = 0;
+  auto value = [&calls]() { return ++calls; };
+  std::stringstream coutStream;
+  std::streambuf* coutBuffer = std::cout.rdbuf(coutStream.rdbuf());
+  const bool infoIgnored = Log::Info.ignoreInput;
+
+  Log::Info.ignoreInput = true;
+  MLPACK_LOG_INFO << "Value: " << value() << "." << std::endl;
+  const size_t ignoredCalls = calls;
+  const std::string ignoredOutput = coutStream.str();
+
+  Log::Info.ignoreInput = false;
+  Log::Info << "Value: " << 1 << "." << std::endl;
+  const std::string infoOutput = coutStream.str();
+  coutStream.str("");
+  MLPACK_LOG_INFO << "Value: " << value() << "." << std::endl;
+  const size_t shownCalls = calls;
+  const std::string macroOutput = coutStream.str();
+
+  coutStream.str("");
+  calls = 0;
+  Log::Debug << "Value: " << 1 << "." << std::endl;
+  const std::string debugOutput = coutStream.str();
+  coutStream.str("");
+  MLPACK_LOG_DEBUG << "Value: " << value() << "." << std::endl;
+  const size_t debugCalls = calls;
+  const std::string debugMacroOutput = coutStream.str();
+
+  std::cout.rdbuf(coutBuffer);
+  Log::Info.ignoreInput = infoIgnored;
+
+  BOOST_REQUIRE_EQUAL(ignoredCalls, 0);
+  BOOST_REQUIRE_EQUAL(ignoredOutput, "");
+  BOOST_REQUIRE_EQUAL(shownCalls, 1);
+  BOOST_REQUIRE_EQUAL(macroOutput, infoOutput);
+  BOOST_REQUIRE_EQUAL(debugMacroOutput, debugOutput);
+  #ifdef DEBUG
+    BOOST_REQUIRE_EQUAL(debugCalls, 1);
+  #else
+    BOOST_REQUIRE_EQUAL(debugCalls, 0);
+  #endif
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -0,0 +1,199 @@
+/**
+ * @file product_quantization_test.cpp
+ *
+ * Unit tests for the ProductQuantizer and PQSearch classes.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <boost/test/unit_test.hpp>
+#include "test_tools.hpp"
+
+#include <mlpack/methods/product_quantization/pq_search.hpp>
+#include <mlpack/methods/neighbor_search/neighbor_search.hpp>
+
+using namespace mlpack;
+using namespace mlpack::neighbor;
+
+BOOST_AUTO_TEST_SUITE(ProductQuantizationTest);
+
+/**
+ * Make sure that decoding and encoding again gives the same codes, and that
+ * the reconstruction is much better than the mean of the data.
+ */
+BOOST_AUTO_TEST_CASE(EncodeDecodeTest)
+{
+  arma::mat data = arma::randu<arma::mat>(12, 1000);
+
+  ProductQuantizer pq(4, 32);
+  pq.Train(data);
+
+  BOOST_REQUIRE_EQUAL(pq.Dimensionality(), 12);
+  BOOST_REQUIRE_EQUAL(pq.Codebook(0).n_rows, 3);
+  BOOST_REQUIRE_EQUAL(pq.Codebook(0).n_cols, 32);
+
+  arma::Mat<arma::u8> codes;
+  pq.Encode(data, codes);
+  BOOST_REQUIRE_EQUAL(codes.n_rows, 4);
+  BOOST_REQUIRE_EQUAL(codes.n_cols, 1000);
+
+  arma::mat reconstruction;
+  pq.Decode(codes, reconstruction);
+
+  arma::Mat<arma::u8> newCodes;
+  pq.Encode(reconstruction, newCodes);
+  BOOST_REQUIRE(arma::all(arma::vectorise(newCodes == codes)));
+
+  arma::mat centered = data.each_col() - arma::mean(data, 1);
+  BOOST_REQUIRE_LT(arma::accu(arma::square(data - reconstruction)),
+      0.5 * arma::accu(arma::square(centered)));
+}
+
+/**
+ * The asymmetric distance should be the squared distance between the query and
+ * the reconstructed point.
+ */
+BOOST_AUTO_TEST_CASE(DistanceTableTest)
+{
+  arma::mat data = arma::randu<arma::mat>(10, 500);
+  arma::mat queries = arma::randu<arma::mat>(10, 20);
+
+  ProductQuantizer pq(5, 16);
+  pq.Train(data);
+
+  arma::Mat<arma::u8> codes;
+  pq.Encode(data, codes);
+  arma::mat reconstruction;
+  pq.Decode(codes, reconstruction);
+
+  arma::mat table;
+  for (size_t i = 0; i < queries.n_cols; ++i)
+  {
+    pq.DistanceTable(queries.col(i), table);
+    BOOST_REQUIRE_EQUAL(table.n_rows, 16);
+    BOOST_REQUIRE_EQUAL(table.n_cols, 5);
+
+    for (size_t j = 0; j < data.n_cols; j += 50)
+    {
+      BOOST_REQUIRE_CLOSE(ProductQuantizer::Distance(table, codes.colptr(j)),
+          arma::accu(arma::square(queries.col(i) - reconstruction.col(j))),
+          1e-5);
+    }
+  }
+}
+
+/**
+ * Scanning all codes should usually find the true nearest neighbor among the
+ * returned neighbors.
+ */
+BOOST_AUTO_TEST_CASE(SearchTest)
+{
+  arma::mat data = arma::randu<arma::mat>(16, 2000);
+  arma::mat queries = arma::randu<arma::mat>(16, 100);
+
+  KNN knn(data);
+  arma::Mat<size_t> trueNeighbors;
+  arma::mat trueDistances;
+  knn.Search(queries, 1, trueNeighbors, trueDistances);
+
+  PQSearch pq(data, ProductQuantizer(8, 64));
+  BOOST_REQUIRE_EQUAL(pq.Codes().n_rows, 8);
+  BOOST_REQUIRE_EQUAL(pq.Codes().n_cols, 2000);
+
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  pq.Search(queries, 10, neighbors, distances);
+
+  size_t found = 0;
+  for (size_t i = 0; i < queries.n_cols; ++i)
+  {
+    for (size_t j = 0; j < 10; ++j)
+    {
+      if (j > 0)
+        BOOST_REQUIRE_LE(distances(j - 1, i), distances(j, i));
+      if (neighbors(j, i) == trueNeighbors(0, i))
+        ++found;
+    }
+  }
+
+  BOOST_REQUIRE_GE(found, 60);
+}
+
+/**
+ * Re-ranking should only return valid candidates, sorted by distance, with the
+ * same distances as a full scan.
+ */
+BOOST_AUTO_TEST_CASE(RerankTest)
+{
+  arma::mat data = arma::randu<arma::mat>(8, 1000);
+  arma::mat queries = arma::randu<arma::mat>(8, 50);
+
+  KNN knn(data);
+  arma::Mat<size_t> candidates;
+  arma::mat candidateDistances;
+  knn.Search(queries, 20, candidates, candidateDistances);
+
+  // Invalid candidates are skipped.
+  candidates.row(19).fill(data.n_cols);
+
+  PQSearch pq(data, ProductQuantizer(4, 32));
+
+  arma::Mat<size_t> neighbors, allNeighbors;
+  arma::mat distances, allDistances;
+  pq.Search(queries, candidates, 5, neighbors, distances);
+  pq.Search(queries, 1000, allNeighbors, allDistances);
+
+  for (size_t i = 0; i < queries.n_cols; ++i)
+  {
+    for (size_t j = 0; j < 5; ++j)
+    {
+      BOOST_REQUIRE(arma::any(candidates.submat(0, i, 18, i) ==
+          neighbors(j, i)));
+      if (j > 0)
+        BOOST_REQUIRE_LE(distances(j - 1, i), distances(j, i));
+
+      const arma::uvec position = arma::find(allNeighbors.col(i) ==
+          neighbors(j, i));
+      BOOST_REQUIRE_EQUAL(position.n_elem, 1);
+      BOOST_REQUIRE_CLOSE(distances(j, i), allDistances(position[0], i),
+          1e-5);
+    }
+  }
+
+  // With fewer valid candidates than k, the rest are placeholders.
+  pq.Search(queries, candidates, 20, neighbors, distances);
+  for (size_t i = 0; i < queries.n_cols; ++i)
+  {
+    BOOST_REQUIRE_EQUAL(neighbors(19, i), data.n_cols);
+    BOOST_REQUIRE_EQUAL(distances(19, i), DBL_MAX);
+  }
+}
+
+/**
+ * Make sure invalid parameters are rejected.
+ */
+BOOST_AUTO_TEST_CASE(InvalidArgumentsTest)
+{
+  arma::mat data = arma::randu<arma::mat>(4, 100);
+
+  ProductQuantizer tooManyCentroids(2, 300);
+  BOOST_REQUIRE_THROW(tooManyCentroids.Train(data), std::invalid_argument);
+
+  ProductQuantizer tooManySubspaces(5, 16);
+  BOOST_REQUIRE_THROW(tooManySubspaces.Train(data), std::invalid_argument);
+
+  ProductQuantizer tooFewPoints(2, 256);
+  BOOST_REQUIRE_THROW(tooFewPoints.Train(data), std::invalid_argument);
+
+  PQSearch pq(data, ProductQuantizer(2, 16));
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  arma::mat queries = arma::randu<arma::mat>(3, 10);
+  BOOST_REQUIRE_THROW(pq.Search(queries, 1, neighbors, distances),
+      std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_SUITE_END();
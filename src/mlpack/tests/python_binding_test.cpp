@@ -11,6 +11,7 @@
  */
 #include <mlpack/core.hpp>
 #include <mlpack/bindings/python/py_option.hpp>
+#include <thread>
 
 #include <boost/test/unit_test.hpp>
 #include "test_tools.hpp"
@@ -71,6 +72,61 @@ BOOST_AUTO_TEST_CASE(PyOptionTest)
   CLI::ClearSettings();
 }
 
+/**
+ * Make sure that each thread with a CLI::Context has its own parameters, and
+ * that the singleton is restored once the Contexts are destroyed.
+ */
+BOOST_AUTO_TEST_CASE(ContextTest)
+{
+  CLI::ClearSettings();
+  programName = "context";
+  PyOption<double> po(0.0, "value", "value2", "v", "double", false, true,
+      false);
+
+  BOOST_REQUIRE_THROW(CLI::Context("unknown"), std::invalid_argument);
+
+  std::vector<char> correct(8, 0);
+  std::vector<std::thread> threads;
+  for (size_t t = 0; t < correct.size(); ++t)
+  {
+    threads.push_back(std::thread([t, &correct]()
+    {
+      // Boost.Test assertions are not thread-safe, so the results are only
+      // checked once the threads are done.
+      CLI::Context context(programName);
+      bool same = (CLI::GetParam<double>("value") == 0.0);
+      CLI::GetParam<double>("value") = double(t);
+      CLI::SetPassed("value");
+
+      for (size_t i = 0; i < 1000; ++i)
+      {
+        std::this_thread::yield();
+        same &= (CLI::GetParam<double>("value") == double(t));
+        same &= CLI::HasParam("value");
+      }
+
+      // A nested Context starts from the stored settings again.
+      {
+        CLI::Context nested(programName);
+        same &= (CLI::GetParam<double>("value") == 0.0);
+        same &= !CLI::HasParam("value");
+      }
+      same &= (CLI::GetParam<double>("value") == double(t));
+      correct[t] = same;
+    }));
+  }
+
+  for (size_t t = 0; t < threads.size(); ++t)
+    threads[t].join();
+  for (size_t t = 0; t < correct.size(); ++t)
+    BOOST_REQUIRE_EQUAL(correct[t], 1);
+
+  // The singleton does not hold the parameter, since it was stored.
+  BOOST_REQUIRE_EQUAL(CLI::Parameters().count("value"), 0);
+
+  CLI::ClearSettings();
+}
+
 /**
  * Make sure GetParam() works.
  */
@@ -170,4 +170,190 @@ BOOST_AUTO_TEST_CASE(CartPoleWithDoubleDQN)
   BOOST_REQUIRE(converged);
 }
 
+//! Test DQN with prioritized experience replay in Cart Pole task.
+BOOST_AUTO_TEST_CASE(CartPoleWithPrioritizedReplay)
+{
+  // It isn't guaranteed that the network will converge in the specified number
+  // of iterations using random weights. If this works 1 of 4 times, I'm fine
+  // with that.
+  size_t episodes = 0;
+  bool converged = false;
+  for (size_t trial = 0; trial < 4; ++trial)
+  {
+    // Set up the network.
+    FFN<MeanSquaredError<>, GaussianInitialization> model(MeanSquaredError<>(),
+        GaussianInitialization(0, 0.001));
+    model.Add<Linear<>>(4, 20);
+    model.Add<ReLULayer<>>();
+    model.Add<Linear<>>(20, 20);
+    model.Add<ReLULayer<>>();
+    model.Add<Linear<>>(20, 2);
+
+    // Set up the policy and replay method.
+    GreedyPolicy<CartPole> policy(1.0, 1000, 0.1);
+    PrioritizedReplay<CartPole> replayMethod(10, 10000);
+
+    TrainingConfig config;
+    config.StepSize() = 0.01;
+    config.Discount() = 0.9;
+    config.TargetNetworkSyncInterval() = 100;
+    config.ExplorationSteps() = 100;
+    config.DoubleQLearning() = false;
+    config.StepLimit() = 200;
+
+    // Set up the DQN agent.
+    QLearning<CartPole, decltype(model), AdamUpdate, decltype(policy),
+        PrioritizedReplay<CartPole>> agent(std::move(config),
+        std::move(model), std::move(policy), std::move(replayMethod));
+
+    arma::running_stat<double> averageReturn;
+
+    for (episodes = 0; episodes <= 1000; ++episodes)
+    {
+      double episodeReturn = agent.Episode();
+      averageReturn(episodeReturn);
+
+      Log::Debug << "Average return: " << averageReturn.mean()
+          << " Episode return: " << episodeReturn << std::endl;
+      if (averageReturn.mean() > 35)
+        break;
+    }
+
+    if (episodes < 1000)
+    {
+      converged = true;
+      break;
+    }
+  }
+
+  BOOST_REQUIRE(converged);
+}
+
+//! Test DQN in Cart Pole task, with several copies of the task in lockstep.
+BOOST_AUTO_TEST_CASE(CartPoleWithVectorEnvironment)
+{
+  // It isn't guaranteed that the network will converge in the specified number
+  // of iterations using random weights. If this works 1 of 4 times, I'm fine
+  // with that.
+  bool converged = false;
+  for (size_t trial = 0; trial < 4; ++trial)
+  {
+    // Set up the network.
+    FFN<MeanSquaredError<>, GaussianInitialization> model(MeanSquaredError<>(),
+        GaussianInitialization(0, 0.001));
+    model.Add<Linear<>>(4, 20);
+    model.Add<ReLULayer<>>();
+    model.Add<Linear<>>(20, 20);
+    model.Add<ReLULayer<>>();
+    model.Add<Linear<>>(20, 2);
+
+    // Set up the policy and replay method.
+    GreedyPolicy<CartPole> policy(1.0, 1000, 0.1);
+    RandomReplay<CartPole> replayMethod(10, 10000);
+
+    TrainingConfig config;
+    config.StepSize() = 0.01;
+    config.Discount() = 0.9;
+    config.TargetNetworkSyncInterval() = 100;
+    config.ExplorationSteps() = 100;
+    config.DoubleQLearning() = false;
+
+    // Set up the DQN agent, with four copies of the task.
+    QLearning<CartPole, decltype(model), AdamUpdate, decltype(policy)>
+        agent(std::move(config), std::move(model), std::move(policy),
+            std::move(replayMethod));
+    VectorEnvironment<CartPole> environments(4, CartPole(), 200);
+
+    // Stop once the average return of the last 20 episodes reaches 35.
+    for (size_t tick = 0; tick < 50000; ++tick)
+    {
+      agent.Step(environments);
+
+      const std::vector<double>& returns = environments.EpisodeReturns();
+      if (returns.size() >= 20)
+      {
+        double average = 0.0;
+        for (size_t i = returns.size() - 20; i < returns.size(); ++i)
+          average += returns[i] / 20;
+        if (average > 35)
+        {
+          converged = true;
+          break;
+        }
+      }
+    }
+
+    if (converged)
+      break;
+  }
+
+  BOOST_REQUIRE(converged);
+}
+
+//! Test DQN with several actors and one learner in CartPole task.
+BOOST_AUTO_TEST_CASE(CartPoleWithActors)
+{
+  // It isn't guaranteed that the network will converge in the specified number
+  // of episodes using random weights. If this works 1 of 4 times, I'm fine
+  // with that.
+  bool converged = false;
+  for (size_t trial = 0; trial < 4; ++trial)
+  {
+    // Set up the network.
+    FFN<MeanSquaredError<>, GaussianInitialization> model(MeanSquaredError<>(),
+        GaussianInitialization(0, 0.001));
+    model.Add<Linear<>>(4, 20);
+    model.Add<ReLULayer<>>();
+    model.Add<Linear<>>(20, 20);
+    model.Add<ReLULayer<>>();
+    model.Add<Linear<>>(20, 2);
+
+    // Set up the policy and replay method.
+    GreedyPolicy<CartPole> policy(1.0, 1000, 0.1);
+    RandomReplay<CartPole> replayMethod(10, 10000);
+
+    TrainingConfig config;
+    config.StepSize() = 0.01;
+    config.Discount() = 0.9;
+    config.TargetNetworkSyncInterval() = 100;
+    config.ExplorationSteps() = 100;
+    config.DoubleQLearning() = false;
+    config.StepLimit() = 200;
+    config.UpdateInterval() = 10;
+    config.NumActors() = 3;
+    config.ActorSyncInterval() = 10;
+
+    // Set up the DQN agent.
+    QLearning<CartPole, decltype(model), AdamUpdate, decltype(policy)>
+        agent(std::move(config), std::move(model), std::move(policy),
+            std::move(replayMethod));
+
+    // Stop once the average return of the last 20 episodes reaches 35, or
+    // after 5000 episodes.
+    std::vector<double> returns;
+    bool trialConverged = false;
+    auto measure = [&returns, &trialConverged](double episodeReturn)
+    {
+      returns.push_back(episodeReturn);
+      if (returns.size() < 20)
+        return false;
+
+      double average = 0.0;
+      for (size_t i = returns.size() - 20; i < returns.size(); ++i)
+        average += returns[i] / 20;
+      trialConverged = (average > 35);
+      return trialConverged || returns.size() >= 5000;
+    };
+
+    agent.Train(measure);
+    BOOST_REQUIRE_GT(agent.TotalSteps(), 0);
+
+    converged = trialConverged;
+    if (converged)
+      break;
+  }
+
+  BOOST_REQUIRE(converged);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
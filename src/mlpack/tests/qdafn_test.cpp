@@ -208,4 +208,34 @@ BOOST_AUTO_TEST_CASE(SparseTest)
   BOOST_REQUIRE_EQUAL(distances.n_cols, 1000);
 }
 
+/**
+ * Make sure that searching a set of query points at once (in parallel, with
+ * batched projections) gives the same results as searching them one by one.
+ */
+BOOST_AUTO_TEST_CASE(QDAFNBatchSearchTest)
+{
+  arma::mat refSet = arma::randu<arma::mat>(10, 500);
+  arma::mat querySet = arma::randu<arma::mat>(10, 100);
+
+  QDAFN<> qdafn(refSet, 10, 30);
+
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  qdafn.Search(querySet, 5, neighbors, distances);
+
+  for (size_t q = 0; q < querySet.n_cols; ++q)
+  {
+    arma::Mat<size_t> singleNeighbors;
+    arma::mat singleDistances;
+    qdafn.Search(arma::mat(querySet.col(q)), 5, singleNeighbors,
+        singleDistances);
+
+    for (size_t j = 0; j < 5; ++j)
+    {
+      BOOST_REQUIRE_EQUAL(neighbors(j, q), singleNeighbors[j]);
+      BOOST_REQUIRE_CLOSE(distances(j, q), singleDistances[j], 1e-5);
+    }
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END();
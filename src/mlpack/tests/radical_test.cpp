@@ -57,4 +57,26 @@ BOOST_AUTO_TEST_CASE(Radical_Test_Radical3D)
   BOOST_REQUIRE_CLOSE(valBest, valEst, 0.25);
 }
 
+/**
+ * Make sure that the unmixing matrix maps the data to the independent
+ * components.
+ */
+BOOST_AUTO_TEST_CASE(RadicalUnmixingMatrixTest)
+{
+  mat matX;
+  data::Load("data_3d_mixed.txt", matX);
+
+  Radical rad(0.175, 5, 100, matX.n_rows - 1);
+
+  mat matY;
+  mat matW;
+  rad.DoRadical(matX, matY, matW);
+
+  const mat matWX = matW * matX;
+  BOOST_REQUIRE_EQUAL(matWX.n_rows, matY.n_rows);
+  BOOST_REQUIRE_EQUAL(matWX.n_cols, matY.n_cols);
+  for (size_t i = 0; i < matY.n_elem; ++i)
+    BOOST_REQUIRE_SMALL(matWX[i] - matY[i], 1e-8);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -311,8 +311,10 @@ BOOST_AUTO_TEST_CASE(LeafSize1Test)
   arma::Row<size_t> labels;
   data::Load("vc2_labels.txt", labels);
 
-  // Build a random forest with a leaf size of 1.
-  RandomForest<> rf(dataset, labels, 3, 10 /* 10 trees */, 1);
+  // Build a random forest with a leaf size of 1.  Each tree only memorizes its
+  // bootstrap sample, so use enough trees that every point is in the bag for
+  // most of them.
+  RandomForest<> rf(dataset, labels, 3, 40 /* 40 trees */, 1);
 
   // Predict on the training set.
   arma::Row<size_t> predictions;
@@ -354,11 +356,14 @@ BOOST_AUTO_TEST_CASE(LeafSizeDatasetTest)
   BOOST_REQUIRE_EQUAL(probabilities.n_rows, 3);
   BOOST_REQUIRE_EQUAL(probabilities.n_cols, dataset.n_cols);
   BOOST_REQUIRE_EQUAL(predictions.n_elem, dataset.n_cols);
+  // Each tree holds the class proportions of its bootstrap sample, so the
+  // probabilities are only close to the proportions of the dataset.
   for (size_t i = 0; i < predictions.n_cols; ++i)
   {
     BOOST_REQUIRE_EQUAL(predictions[i], majorityClass);
     for (size_t j = 0; j < probabilities.n_rows; ++j)
-      BOOST_REQUIRE_CLOSE(probabilities(j, i), majorityProbs[j], 1e-5);
+      BOOST_REQUIRE_SMALL(probabilities(j, i) - majorityProbs[j], 0.05);
+    BOOST_REQUIRE_CLOSE(arma::accu(probabilities.col(i)), 1.0, 1e-5);
   }
 }
 
@@ -393,6 +398,88 @@ BOOST_AUTO_TEST_CASE(SerializationTest)
       binaryPredictions);
   CheckMatrices(beforeProbabilities, xmlProbabilities, textProbabilities,
       binaryProbabilities);
+
+  BOOST_REQUIRE_EQUAL(xmlForest.OOBError(), rf.OOBError());
+  BOOST_REQUIRE_EQUAL(textForest.OOBError(), rf.OOBError());
+  BOOST_REQUIRE_EQUAL(binaryForest.OOBError(), rf.OOBError());
+}
+
+/**
+ * Make sure bootstrap counts sum to the number of points, and that about a
+ * third of the points are out of the bag.
+ */
+BOOST_AUTO_TEST_CASE(BootstrapCountsTest)
+{
+  for (size_t trial = 0; trial < 5; ++trial)
+  {
+    arma::Col<size_t> counts;
+    BootstrapCounts(1000, counts);
+
+    BOOST_REQUIRE_EQUAL(counts.n_elem, 1000);
+    BOOST_REQUIRE_EQUAL(arma::accu(counts), 1000);
+
+    const size_t outOfBag = arma::accu(counts == 0);
+    BOOST_REQUIRE_GT(outOfBag, 300);
+    BOOST_REQUIRE_LT(outOfBag, 440);
+  }
+}
+
+/**
+ * Make sure that the out-of-bag error is close to the error on a held-out test
+ * set.
+ */
+BOOST_AUTO_TEST_CASE(OOBErrorTest)
+{
+  arma::mat dataset, testDataset;
+  data::Load("vc2.csv", dataset);
+  data::Load("vc2_test.csv", testDataset);
+  arma::Row<size_t> labels, testLabels;
+  data::Load("vc2_labels.txt", labels);
+  data::Load("vc2_test_labels.txt", testLabels);
+
+  // An untrained forest has no out-of-bag error.
+  RandomForest<> empty;
+  BOOST_REQUIRE(std::isnan(empty.OOBError()));
+
+  RandomForest<> rf(dataset, labels, 3, 50 /* 50 trees */, 5);
+
+  arma::Row<size_t> predictions;
+  rf.Classify(testDataset, predictions);
+  const double testError = 1.0 - (double) arma::accu(predictions == testLabels)
+      / testLabels.n_elem;
+
+  BOOST_REQUIRE_GE(rf.OOBError(), 0.0);
+  BOOST_REQUIRE_LE(rf.OOBError(), 1.0);
+  BOOST_REQUIRE_SMALL(rf.OOBError() - testError, 0.15);
+}
+
+/**
+ * Make sure that a flattened forest gives the same predictions as the forest.
+ */
+BOOST_AUTO_TEST_CASE(FlattenTest)
+{
+  arma::mat data;
+  arma::Row<size_t> labels;
+  data::DatasetInfo datasetInfo;
+  MockCategoricalData(data, labels, datasetInfo);
+
+  RandomForest<> rf(data, datasetInfo, labels, 5, 10 /* 10 trees */, 5);
+  FlatDecisionForest<RandomForest<>::DecisionTreeType> flat = rf.Flatten();
+  BOOST_REQUIRE_EQUAL(flat.NumTrees(), 10);
+
+  arma::Row<size_t> predictions, flatPredictions;
+  arma::mat probabilities, flatProbabilities;
+  rf.Classify(data, predictions, probabilities);
+  flat.Classify(data, flatPredictions, flatProbabilities);
+
+  BOOST_REQUIRE_EQUAL(flatPredictions.n_elem, predictions.n_elem);
+  for (size_t i = 0; i < predictions.n_elem; ++i)
+    BOOST_REQUIRE_EQUAL(flatPredictions[i], predictions[i]);
+  CheckMatrices(flatProbabilities, probabilities);
+
+  // An untrained forest can't be flattened.
+  RandomForest<> empty;
+  BOOST_REQUIRE_THROW(empty.Flatten(), std::invalid_argument);
 }
 
 BOOST_AUTO_TEST_SUITE_END();
@@ -97,4 +97,105 @@ BOOST_AUTO_TEST_CASE(WeightedRandomTest)
   }
 }
 
+// Make sure the streams of Philox are reproducible and distinct, and that
+// Discard() skips the right number of outputs.
+BOOST_AUTO_TEST_CASE(PhiloxStreamTest)
+{
+  Philox a(42, 3), b(42, 3), c(42, 4), d(43, 3);
+  size_t sameAsC = 0, sameAsD = 0;
+  for (size_t i = 0; i < 100; ++i)
+  {
+    const uint32_t value = a();
+    BOOST_REQUIRE_EQUAL(value, b());
+    if (value == c())
+      ++sameAsC;
+    if (value == d())
+      ++sameAsD;
+  }
+  BOOST_REQUIRE_LT(sameAsC, 2);
+  BOOST_REQUIRE_LT(sameAsD, 2);
+
+  for (size_t skip = 0; skip < 10; ++skip)
+  {
+    Philox skipped(7, 1), stepped(7, 1);
+    skipped();
+    stepped();
+    skipped.Discard(skip);
+    for (size_t i = 0; i < skip; ++i)
+      stepped();
+    for (size_t i = 0; i < 10; ++i)
+      BOOST_REQUIRE_EQUAL(skipped(), stepped());
+  }
+}
+
+// Make sure that setting the seed makes Random(), RandInt() and RandNormal()
+// reproducible.
+BOOST_AUTO_TEST_CASE(RandomSeedReproducibleTest)
+{
+  RandomSeed(1234);
+  arma::vec first(30);
+  for (size_t i = 0; i < 10; ++i)
+  {
+    first[3 * i] = Random();
+    first[3 * i + 1] = RandInt(1000);
+    first[3 * i + 2] = RandNormal();
+  }
+
+  RandomSeed(1234);
+  for (size_t i = 0; i < 10; ++i)
+  {
+    BOOST_REQUIRE_EQUAL(first[3 * i], Random());
+    BOOST_REQUIRE_EQUAL(first[3 * i + 1], RandInt(1000));
+    BOOST_REQUIRE_EQUAL(first[3 * i + 2], RandNormal());
+  }
+}
+
+// Make sure that work items with their own stream give the same results in
+// parallel as serially.
+BOOST_AUTO_TEST_CASE(RandomStreamParallelTest)
+{
+  RandomSeed(99);
+  arma::mat serial(10, 50), parallel(10, 50);
+  for (size_t j = 0; j < 50; ++j)
+  {
+    Philox generator = RandomStream(j);
+    for (size_t i = 0; i < 10; ++i)
+      serial(i, j) = Random(generator);
+  }
+
+  #pragma omp parallel for
+  for (omp_size_t j = 0; j < 50; ++j)
+  {
+    Philox generator = RandomStream(j);
+    for (size_t i = 0; i < 10; ++i)
+      parallel(i, j) = Random(generator);
+  }
+
+  for (size_t i = 0; i < serial.n_elem; ++i)
+  {
+    BOOST_REQUIRE_EQUAL(serial[i], parallel[i]);
+    BOOST_REQUIRE_GE(serial[i], 0.0);
+    BOOST_REQUIRE_LT(serial[i], 1.0);
+  }
+}
+
+// Make sure that the random functions draw from the stream of a
+// RandomStreamScope while it exists, and from the thread's stream afterwards.
+BOOST_AUTO_TEST_CASE(RandomStreamScopeTest)
+{
+  RandomSeed(7);
+  const double first = Random();
+  const double second = Random();
+
+  RandomSeed(7);
+  BOOST_REQUIRE_EQUAL(Random(), first);
+  {
+    RandomStreamScope scope(3);
+    Philox generator = RandomStream(3);
+    for (size_t i = 0; i < 10; ++i)
+      BOOST_REQUIRE_EQUAL(Random(), Random(generator));
+  }
+  BOOST_REQUIRE_EQUAL(Random(), second);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -64,4 +64,78 @@ BOOST_AUTO_TEST_CASE(RandomizedSVDReconstructionError)
   BOOST_REQUIRE_SMALL(error, 1e-5);
 }
 
+/**
+ * Check the block-streaming randomized SVD against the SVD of the centered
+ * data, with the given block source.
+ */
+template<typename BlockSourceType>
+void CheckStreamingSVD(const arma::mat& data, BlockSourceType& source)
+{
+  arma::mat centeredData;
+  math::Center(data, centeredData);
+
+  arma::mat U1, V1, U2;
+  arma::vec s1, s2;
+  arma::svd_econ(U1, s1, V1, centeredData);
+
+  svd::RandomizedSVD rSVD(0, 3);
+  rSVD.Apply(source, U2, s2, 5);
+
+  BOOST_REQUIRE_GE(s2.n_elem, 5);
+  BOOST_REQUIRE_EQUAL(U2.n_rows, data.n_rows);
+  BOOST_REQUIRE_EQUAL(U2.n_cols, s2.n_elem);
+
+  // The leading singular values should match.
+  const double error = arma::norm(s2.subvec(0, 4) - s1.subvec(0, 4)) /
+      arma::norm(s1.subvec(0, 4));
+  BOOST_REQUIRE_SMALL(error, 1e-5);
+
+  // The leading singular vectors should match up to their sign.
+  for (size_t i = 0; i < 5; ++i)
+    BOOST_REQUIRE_CLOSE(std::abs(arma::dot(U1.col(i), U2.col(i))), 1.0, 1e-3);
+}
+
+/**
+ * Make low-rank data with a nonzero mean, so that centering matters.
+ */
+arma::mat LowRankStreamingData()
+{
+  arma::mat data = arma::randn<arma::mat>(40, 5) *
+      arma::diagmat(arma::vec("10 5 3 2 1")) * arma::randn<arma::mat>(5, 700);
+  data.each_col() += 3.0 * arma::randu<arma::vec>(40);
+  return data;
+}
+
+/**
+ * The block-streaming randomized SVD should recover the singular values and
+ * vectors of low-rank data held in memory.
+ */
+BOOST_AUTO_TEST_CASE(RandomizedSVDStreamingMatTest)
+{
+  const arma::mat data = LowRankStreamingData();
+
+  // The block size does not divide the number of points.
+  svd::MatBlockSource<> source(data, 64);
+  CheckStreamingSVD(data, source);
+}
+
+/**
+ * The block-streaming randomized SVD should give the same results when the
+ * data is read from a binary file.
+ */
+BOOST_AUTO_TEST_CASE(RandomizedSVDStreamingFileTest)
+{
+  const arma::mat data = LowRankStreamingData();
+  data.save("randomized_svd_streaming_test.bin", arma::arma_binary);
+
+  {
+    svd::BinaryFileBlockSource source("randomized_svd_streaming_test.bin", 100);
+    BOOST_REQUIRE_EQUAL(source.NumRows(), data.n_rows);
+    BOOST_REQUIRE_EQUAL(source.NumCols(), data.n_cols);
+    CheckStreamingSVD(data, source);
+  }
+
+  remove("randomized_svd_streaming_test.bin");
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -13,6 +13,7 @@
 #include <mlpack/methods/range_search/range_search.hpp>
 #include <mlpack/core/tree/cover_tree.hpp>
 #include <mlpack/methods/range_search/rs_model.hpp>
+#include <mlpack/methods/range_search/mahalanobis_range_search.hpp>
 #include <boost/test/unit_test.hpp>
 #include "test_tools.hpp"
 
@@ -1334,6 +1335,102 @@ BOOST_AUTO_TEST_CASE(RSModelTest)
   }
 }
 
+/**
+ * Make sure that RSModel::TreeName() names each tree type the way that the
+ * range search benchmarks and the logging output expect.
+ */
+BOOST_AUTO_TEST_CASE(RSModelTreeNameTest)
+{
+  const RSModel::TreeTypes types[] = { RSModel::KD_TREE, RSModel::COVER_TREE,
+      RSModel::R_TREE, RSModel::R_STAR_TREE, RSModel::BALL_TREE,
+      RSModel::X_TREE, RSModel::HILBERT_R_TREE, RSModel::R_PLUS_TREE,
+      RSModel::R_PLUS_PLUS_TREE, RSModel::VP_TREE, RSModel::RP_TREE,
+      RSModel::MAX_RP_TREE, RSModel::UB_TREE, RSModel::OCTREE };
+  const char* names[] = { "kd-tree", "cover tree", "R tree", "R* tree",
+      "ball tree", "X tree", "Hilbert R tree", "R+ tree", "R++ tree",
+      "vantage point tree", "random projection tree (mean split)",
+      "random projection tree (max split)", "UB tree", "octree" };
+
+  for (size_t i = 0; i < 14; ++i)
+  {
+    RSModel model(types[i]);
+    BOOST_REQUIRE_EQUAL(model.TreeName(), names[i]);
+  }
+}
+
+/**
+ * Ensure that a range search model holding single-precision data gives the
+ * same results as single-precision brute-force search.
+ */
+BOOST_AUTO_TEST_CASE(RSFloatModelTest)
+{
+  typedef RSModelType<arma::fmat> RSFloatModel;
+
+  arma::fmat queryData = arma::randu<arma::fmat>(10, 50);
+  arma::fmat referenceData = arma::randu<arma::fmat>(10, 200);
+
+  // Get a baseline.
+  RangeSearch<EuclideanDistance, arma::fmat> rs(referenceData, true);
+  vector<vector<size_t>> baselineNeighbors;
+  vector<vector<double>> baselineDistances;
+  rs.Search(queryData, math::Range(0.25, 0.75), baselineNeighbors,
+      baselineDistances);
+
+  vector<vector<pair<double, size_t>>> baselineSorted;
+  SortResults(baselineNeighbors, baselineDistances, baselineSorted);
+
+  const RSFloatModel::TreeTypes treeTypes[] = {
+      RSFloatModel::TreeTypes::KD_TREE,
+      RSFloatModel::TreeTypes::COVER_TREE,
+      RSFloatModel::TreeTypes::R_TREE,
+      RSFloatModel::TreeTypes::R_STAR_TREE,
+      RSFloatModel::TreeTypes::X_TREE,
+      RSFloatModel::TreeTypes::BALL_TREE,
+      RSFloatModel::TreeTypes::HILBERT_R_TREE,
+      RSFloatModel::TreeTypes::R_PLUS_TREE,
+      RSFloatModel::TreeTypes::R_PLUS_PLUS_TREE,
+      RSFloatModel::TreeTypes::VP_TREE,
+      RSFloatModel::TreeTypes::RP_TREE,
+      RSFloatModel::TreeTypes::MAX_RP_TREE,
+      RSFloatModel::TreeTypes::UB_TREE,
+      RSFloatModel::TreeTypes::OCTREE };
+
+  for (size_t j = 0; j < 2; ++j)
+  {
+    for (size_t i = 0; i < 14; ++i)
+    {
+      RSFloatModel model(treeTypes[i], false);
+
+      arma::fmat referenceCopy(referenceData);
+      arma::fmat queryCopy(queryData);
+      model.BuildModel(std::move(referenceCopy), 5, false, (j == 1));
+
+      vector<vector<size_t>> neighbors;
+      vector<vector<double>> distances;
+
+      model.Search(std::move(queryCopy), math::Range(0.25, 0.75), neighbors,
+          distances);
+
+      BOOST_REQUIRE_EQUAL(neighbors.size(), baselineNeighbors.size());
+      BOOST_REQUIRE_EQUAL(distances.size(), baselineDistances.size());
+
+      vector<vector<pair<double, size_t>>> sorted;
+      SortResults(neighbors, distances, sorted);
+
+      for (size_t k = 0; k < sorted.size(); ++k)
+      {
+        BOOST_REQUIRE_EQUAL(sorted[k].size(), baselineSorted[k].size());
+        for (size_t l = 0; l < sorted[k].size(); ++l)
+        {
+          BOOST_REQUIRE_EQUAL(sorted[k][l].second, baselineSorted[k][l].second);
+          BOOST_REQUIRE_CLOSE(sorted[k][l].first, baselineSorted[k][l].first,
+              1e-3);
+        }
+      }
+    }
+  }
+}
+
 BOOST_AUTO_TEST_CASE(RSModelMonochromaticTest)
 {
   // Ensure that we can build an RSModel and get correct results.
@@ -1696,4 +1793,252 @@ BOOST_AUTO_TEST_CASE(MoveOperatorNaiveTest)
   }
 }
 
+/**
+ * Make sure Count() gives the sizes of the results of Search(), for the given
+ * tree type, in naive, single-tree and dual-tree mode.
+ */
+template<template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void CheckCount(const arma::mat& referenceData,
+                const arma::mat& queryData,
+                const Range& range)
+{
+  for (size_t mode = 0; mode < 3; ++mode)
+  {
+    RangeSearch<EuclideanDistance, arma::mat, TreeType> rs(referenceData,
+        mode == 0, mode == 1);
+
+    vector<vector<size_t>> neighbors;
+    vector<vector<double>> distances;
+    arma::Col<size_t> counts;
+
+    rs.Search(queryData, range, neighbors, distances);
+    rs.Count(queryData, range, counts);
+
+    BOOST_REQUIRE_EQUAL(counts.n_elem, queryData.n_cols);
+    for (size_t i = 0; i < neighbors.size(); ++i)
+      BOOST_REQUIRE_EQUAL(counts[i], neighbors[i].size());
+
+    rs.Search(range, neighbors, distances);
+    rs.Count(range, counts);
+
+    BOOST_REQUIRE_EQUAL(counts.n_elem, referenceData.n_cols);
+    for (size_t i = 0; i < neighbors.size(); ++i)
+      BOOST_REQUIRE_EQUAL(counts[i], neighbors[i].size());
+  }
+}
+
+BOOST_AUTO_TEST_CASE(CountTest)
+{
+  arma::mat referenceData(5, 1200, arma::fill::randu);
+  arma::mat queryData(5, 300, arma::fill::randu);
+
+  // Ranges with and without 0, to check that points are not counted in their
+  // own range in the monochromatic case.
+  const Range ranges[] = { Range(0.0, 0.4), Range(0.2, 0.6),
+      Range(0.5, DBL_MAX) };
+  for (size_t r = 0; r < 3; ++r)
+  {
+    CheckCount<KDTree>(referenceData, queryData, ranges[r]);
+    CheckCount<StandardCoverTree>(referenceData, queryData, ranges[r]);
+    CheckCount<BallTree>(referenceData, queryData, ranges[r]);
+  }
+}
+
+/**
+ * Make sure MaxResults() caps the results, and that the results which are kept
+ * are correct.
+ */
+BOOST_AUTO_TEST_CASE(MaxResultsTest)
+{
+  arma::mat referenceData(3, 1000, arma::fill::randu);
+  arma::mat queryData(3, 200, arma::fill::randu);
+  const Range range(0.0, 0.5);
+
+  for (size_t mode = 0; mode < 3; ++mode)
+  {
+    RangeSearch<> rs(referenceData, mode == 0, mode == 1);
+
+    for (size_t mono = 0; mono < 2; ++mono)
+    {
+      vector<vector<size_t>> neighbors, cappedNeighbors;
+      vector<vector<double>> distances, cappedDistances;
+
+      rs.MaxResults() = 0;
+      if (mono == 0)
+        rs.Search(queryData, range, neighbors, distances);
+      else
+        rs.Search(range, neighbors, distances);
+
+      rs.MaxResults() = 7;
+      if (mono == 0)
+        rs.Search(queryData, range, cappedNeighbors, cappedDistances);
+      else
+        rs.Search(range, cappedNeighbors, cappedDistances);
+
+      BOOST_REQUIRE_EQUAL(cappedNeighbors.size(), neighbors.size());
+      for (size_t i = 0; i < neighbors.size(); ++i)
+      {
+        BOOST_REQUIRE_EQUAL(cappedNeighbors[i].size(),
+            std::min(neighbors[i].size(), (size_t) 7));
+        BOOST_REQUIRE_EQUAL(cappedDistances[i].size(),
+            cappedNeighbors[i].size());
+
+        // Every kept result must be one of the full results.
+        for (size_t j = 0; j < cappedNeighbors[i].size(); ++j)
+        {
+          const size_t k = std::find(neighbors[i].begin(), neighbors[i].end(),
+              cappedNeighbors[i][j]) - neighbors[i].begin();
+          BOOST_REQUIRE_LT(k, neighbors[i].size());
+          BOOST_REQUIRE_CLOSE(cappedDistances[i][j], distances[i][k], 1e-5);
+        }
+      }
+    }
+  }
+}
+
+/**
+ * Make sure parallel single-tree and dual-tree search give the same results as
+ * serial search, for every tree type of RSModel.
+ */
+BOOST_AUTO_TEST_CASE(RSModelParallelTest)
+{
+  arma::mat queryData = arma::randu<arma::mat>(3, 500);
+  arma::mat referenceData = arma::randu<arma::mat>(3, 2000);
+  const math::Range range(0.05, 0.15);
+
+  // Get baselines.
+  RangeSearch<> rs(referenceData);
+  vector<vector<size_t>> baselineNeighbors, monoBaselineNeighbors;
+  vector<vector<double>> baselineDistances, monoBaselineDistances;
+  rs.Search(queryData, range, baselineNeighbors, baselineDistances);
+  rs.Search(range, monoBaselineNeighbors, monoBaselineDistances);
+
+  vector<vector<pair<double, size_t>>> baselineSorted, monoBaselineSorted;
+  SortResults(baselineNeighbors, baselineDistances, baselineSorted);
+  SortResults(monoBaselineNeighbors, monoBaselineDistances, monoBaselineSorted);
+
+  const RSModel::TreeTypes treeTypes[] = { RSModel::TreeTypes::KD_TREE,
+      RSModel::TreeTypes::COVER_TREE, RSModel::TreeTypes::R_TREE,
+      RSModel::TreeTypes::R_STAR_TREE, RSModel::TreeTypes::X_TREE,
+      RSModel::TreeTypes::BALL_TREE, RSModel::TreeTypes::HILBERT_R_TREE,
+      RSModel::TreeTypes::R_PLUS_TREE, RSModel::TreeTypes::R_PLUS_PLUS_TREE,
+      RSModel::TreeTypes::VP_TREE, RSModel::TreeTypes::RP_TREE,
+      RSModel::TreeTypes::MAX_RP_TREE, RSModel::TreeTypes::UB_TREE,
+      RSModel::TreeTypes::OCTREE };
+
+  for (size_t i = 0; i < 14; ++i)
+  {
+    for (size_t singleMode = 0; singleMode < 2; ++singleMode)
+    {
+      RSModel model(treeTypes[i], false);
+      arma::mat referenceCopy(referenceData);
+      model.BuildModel(std::move(referenceCopy), 5, false, singleMode == 1);
+      model.Parallel() = true;
+
+      for (size_t mono = 0; mono < 2; ++mono)
+      {
+        vector<vector<size_t>> neighbors;
+        vector<vector<double>> distances;
+        if (mono == 0)
+        {
+          arma::mat queryCopy(queryData);
+          model.Search(std::move(queryCopy), range, neighbors, distances);
+        }
+        else
+        {
+          model.Search(range, neighbors, distances);
+        }
+
+        vector<vector<pair<double, size_t>>> sorted;
+        SortResults(neighbors, distances, sorted);
+        const vector<vector<pair<double, size_t>>>& expected =
+            (mono == 0) ? baselineSorted : monoBaselineSorted;
+
+        BOOST_REQUIRE_EQUAL(sorted.size(), expected.size());
+        for (size_t k = 0; k < sorted.size(); ++k)
+        {
+          BOOST_REQUIRE_EQUAL(sorted[k].size(), expected[k].size());
+          for (size_t l = 0; l < sorted[k].size(); ++l)
+          {
+            BOOST_REQUIRE_EQUAL(sorted[k][l].second, expected[k][l].second);
+            BOOST_REQUIRE_CLOSE(sorted[k][l].first, expected[k][l].first,
+                1e-5);
+          }
+        }
+      }
+    }
+  }
+}
+
+/**
+ * Make sure parallel Count() gives the same counts as serial Count().
+ */
+BOOST_AUTO_TEST_CASE(ParallelCountTest)
+{
+  arma::mat referenceData(4, 3000, arma::fill::randu);
+  arma::mat queryData(4, 800, arma::fill::randu);
+  const math::Range range(0.1, 0.3);
+
+  for (size_t singleMode = 0; singleMode < 2; ++singleMode)
+  {
+    RangeSearch<> rs(referenceData, false, singleMode == 1);
+
+    arma::Col<size_t> counts, parallelCounts;
+    rs.Count(queryData, range, counts);
+    rs.Parallel() = true;
+    rs.Count(queryData, range, parallelCounts);
+    CheckMatrices(counts, parallelCounts);
+
+    rs.Parallel() = false;
+    rs.Count(range, counts);
+    rs.Parallel() = true;
+    rs.Count(range, parallelCounts);
+    CheckMatrices(counts, parallelCounts);
+  }
+}
+
+/**
+ * Make sure that the range search in the space transformed by a Mahalanobis
+ * distance that does not take the root finds the same points as a brute-force
+ * search with the distance.
+ */
+BOOST_AUTO_TEST_CASE(MahalanobisRangeSearchTest)
+{
+  arma::mat dataset = arma::randu<arma::mat>(3, 300);
+  const arma::mat a = arma::randu<arma::mat>(3, 3);
+  metric::MahalanobisDistance<false> metric(a * a.t() +
+      arma::eye<arma::mat>(3, 3));
+
+  MahalanobisRangeSearch<false> search(dataset, metric);
+  std::vector<std::vector<size_t>> neighbors;
+  std::vector<std::vector<double>> distances;
+  const Range range(0.05, 0.2);
+  search.Search(range, neighbors, distances);
+
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+  {
+    std::vector<size_t> expected;
+    for (size_t j = 0; j < dataset.n_cols; ++j)
+    {
+      if (j != i && range.Contains(metric.Evaluate(dataset.col(i),
+          dataset.col(j))))
+        expected.push_back(j);
+    }
+
+    std::vector<size_t> found = neighbors[i];
+    std::sort(found.begin(), found.end());
+    BOOST_REQUIRE_EQUAL(found.size(), expected.size());
+    for (size_t j = 0; j < found.size(); ++j)
+      BOOST_REQUIRE_EQUAL(found[j], expected[j]);
+
+    for (size_t j = 0; j < neighbors[i].size(); ++j)
+    {
+      BOOST_REQUIRE_CLOSE(distances[i][j], metric.Evaluate(dataset.col(i),
+          dataset.col(neighbors[i][j])), 1e-5);
+    }
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -1372,6 +1372,108 @@ BOOST_AUTO_TEST_CASE(RStarTreeSplitTest)
       0.9, 1e-15);
 }
 
+/**
+ * Collect the indices of all points held in the leaves of the given tree.
+ */
+template<typename TreeType>
+void GetAllPointIndices(const TreeType& tree, std::vector<size_t>& indices)
+{
+  for (size_t i = 0; i < tree.NumChildren(); i++)
+    GetAllPointIndices(tree.Child(i), indices);
+
+  for (size_t i = 0; i < tree.NumPoints(); i++)
+    indices.push_back(tree.Point(i));
+}
+
+/**
+ * Bulk-load a tree on the given dataset, check its structure, and make sure
+ * that nearest neighbor search with it gives the same results as the naive
+ * search.
+ */
+template<template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void CheckBulkLoadedTree(const arma::mat& dataset,
+                         const BulkLoadType bulkLoad)
+{
+  typedef TreeType<EuclideanDistance, NeighborSearchStat<NearestNeighborSort>,
+      arma::mat> Tree;
+  Tree tree(dataset, bulkLoad, 20, 6, 5, 2);
+
+  BOOST_REQUIRE_EQUAL(tree.NumDescendants(), dataset.n_cols);
+
+  // Each point must be in the tree exactly once.
+  std::vector<size_t> indices;
+  GetAllPointIndices(tree, indices);
+  BOOST_REQUIRE_EQUAL(indices.size(), dataset.n_cols);
+  std::sort(indices.begin(), indices.end());
+  for (size_t i = 0; i < indices.size(); i++)
+    BOOST_REQUIRE_EQUAL(indices[i], i);
+
+  CheckContainment(tree);
+  CheckExactContainment(tree);
+  CheckHierarchy(tree);
+  CheckFills(tree);
+  CheckNumDescendants(tree);
+  BOOST_REQUIRE_EQUAL(GetMinLevel(tree), GetMaxLevel(tree));
+
+  arma::Mat<size_t> neighbors1, neighbors2;
+  arma::mat distances1, distances2;
+
+  NeighborSearch<NearestNeighborSort, EuclideanDistance, arma::mat, TreeType>
+      knn1(std::move(tree));
+  knn1.Search(5, neighbors1, distances1);
+
+  KNN knn2(dataset, NAIVE_MODE);
+  knn2.Search(5, neighbors2, distances2);
+
+  for (size_t i = 0; i < neighbors1.size(); i++)
+  {
+    BOOST_REQUIRE_EQUAL(neighbors1[i], neighbors2[i]);
+    BOOST_REQUIRE_EQUAL(distances1[i], distances2[i]);
+  }
+}
+
+// Make sure that STR bulk-loading gives valid R trees, R* trees and X trees.
+BOOST_AUTO_TEST_CASE(STRBulkLoadTest)
+{
+  // The number of points is chosen so that the leaves aren't all full.
+  arma::mat dataset;
+  dataset.randu(8, 1003);
+
+  CheckBulkLoadedTree<RTree>(dataset, STR_BULK_LOAD);
+  CheckBulkLoadedTree<RStarTree>(dataset, STR_BULK_LOAD);
+  CheckBulkLoadedTree<XTree>(dataset, STR_BULK_LOAD);
+}
+
+// Make sure that Hilbert bulk-loading gives valid Hilbert R trees.
+BOOST_AUTO_TEST_CASE(HilbertBulkLoadTest)
+{
+  arma::mat dataset;
+  dataset.randu(8, 1003);
+
+  CheckBulkLoadedTree<HilbertRTree>(dataset, HILBERT_BULK_LOAD);
+
+  typedef HilbertRTree<EuclideanDistance,
+      NeighborSearchStat<NearestNeighborSort>, arma::mat> TreeType;
+  TreeType hilbertRTree(dataset, HILBERT_BULK_LOAD, 20, 6, 5, 2);
+
+  CheckHilbertOrdering(hilbertRTree);
+  CheckDiscreteHilbertValueSync(hilbertRTree);
+
+  // The tree must stay valid when more points are inserted.
+  hilbertRTree.Dataset().reshape(8, 1103);
+  hilbertRTree.Dataset().cols(1003, 1102).randu();
+  for (size_t i = 1003; i < 1103; i++)
+    hilbertRTree.InsertPoint(i);
+
+  BOOST_REQUIRE_EQUAL(hilbertRTree.NumDescendants(), 1103);
+  CheckContainment(hilbertRTree);
+  CheckNumDescendants(hilbertRTree);
+  CheckHilbertOrdering(hilbertRTree);
+  CheckDiscreteHilbertValueSync(hilbertRTree);
+}
+
 BOOST_AUTO_TEST_CASE(RectangleTreeMoveDatasetTest)
 {
   arma::mat dataset = arma::randu<arma::mat>(3, 1000);
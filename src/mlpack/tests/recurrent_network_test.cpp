@@ -808,4 +808,158 @@ BOOST_AUTO_TEST_CASE(SerializationTest)
   CheckMatrices(prediction, xmlPrediction, textPrediction, binaryPrediction);
 }
 
+/**
+ * Make sure that a network trained with truncated BPTT on windows of the
+ * sequences gives the same objective and predictions as a network that sees
+ * the whole sequences at once, since the recurrent layer carries its state
+ * from one window to the next.
+ */
+template<typename RecurrentLayerType>
+void TruncatedBPTTTest()
+{
+  const size_t inputSize = 3, outputSize = 2, steps = 12;
+  arma::mat input = arma::randu(inputSize * steps, 10);
+  arma::mat labels = arma::randu(outputSize * steps, 10);
+
+  RNN<MeanSquaredError<> > model(input, labels, steps);
+  model.Add<Linear<> >(inputSize, 5);
+  model.Add<RecurrentLayerType>(5, 5);
+  model.Add<Linear<> >(5, outputSize);
+  model.ResetParameters();
+
+  // Windows of 4 steps.
+  RNN<MeanSquaredError<> > truncatedModel(input, labels, 4);
+  truncatedModel.Add<Linear<> >(inputSize, 5);
+  truncatedModel.Add<RecurrentLayerType>(5, 5);
+  truncatedModel.Add<Linear<> >(5, outputSize);
+  truncatedModel.SequenceLength() = steps;
+  truncatedModel.ResetParameters();
+  truncatedModel.Parameters() = model.Parameters();
+
+  for (size_t i = 0; i < input.n_cols; ++i)
+  {
+    BOOST_REQUIRE_CLOSE(model.Evaluate(model.Parameters(), i, 1),
+        truncatedModel.Evaluate(truncatedModel.Parameters(), i, 1), 1e-5);
+  }
+
+  arma::mat predictions, truncatedPredictions;
+  model.Predict(input, predictions);
+  truncatedModel.Predict(input, truncatedPredictions);
+  BOOST_REQUIRE_EQUAL(truncatedPredictions.n_rows, outputSize * steps);
+  CheckMatrices(predictions, truncatedPredictions);
+
+  // The error is not backpropagated from one window to the previous one, so
+  // the gradient differs from the one of the whole sequences, but training
+  // must still reduce the objective.  The first epoch also initializes the
+  // parameters.
+  StandardSGD opt(0.05, 1, input.n_cols, -100);
+  truncatedModel.Train(input, labels, opt);
+
+  double objective = 0;
+  for (size_t i = 0; i < input.n_cols; ++i)
+    objective += truncatedModel.Evaluate(truncatedModel.Parameters(), i, 1);
+
+  opt.MaxIterations() = 20 * input.n_cols;
+  truncatedModel.Train(input, labels, opt);
+
+  double trainedObjective = 0;
+  for (size_t i = 0; i < input.n_cols; ++i)
+  {
+    trainedObjective += truncatedModel.Evaluate(truncatedModel.Parameters(), i,
+        1);
+  }
+  BOOST_REQUIRE_LT(trainedObjective, objective);
+}
+
+/**
+ * Train the LSTM layer with truncated BPTT.
+ */
+BOOST_AUTO_TEST_CASE(LSTMTruncatedBPTTTest)
+{
+  TruncatedBPTTTest<LSTM<> >();
+}
+
+/**
+ * Train the FastLSTM layer with truncated BPTT.
+ */
+BOOST_AUTO_TEST_CASE(FastLSTMTruncatedBPTTTest)
+{
+  TruncatedBPTTTest<FastLSTM<> >();
+}
+
+/**
+ * Make sure that advancing the network one step at a time with Step() gives
+ * the same outputs as Predict() on the whole sequences, also when the state is
+ * taken out and put back in between.
+ */
+template<typename RecurrentLayerType>
+void StepTest(const size_t stateSize)
+{
+  const size_t inputSize = 3, outputSize = 2, steps = 12;
+  arma::mat input = arma::randu(inputSize * steps, 2);
+  arma::mat labels = arma::randu(outputSize * steps, 2);
+
+  // Windows of 4 steps, so that the state is carried from one window to the
+  // next.
+  RNN<MeanSquaredError<> > model(input, labels, 4);
+  model.Add<Linear<> >(inputSize, 5);
+  model.Add<RecurrentLayerType>(5, 5);
+  model.Add<Linear<> >(5, outputSize);
+  model.SequenceLength() = steps;
+  model.ResetParameters();
+
+  // This sets the size of the output.
+  model.Evaluate(model.Parameters(), 0, 1);
+
+  arma::mat predictions;
+  model.Predict(input, predictions);
+
+  // Both sequences are advanced at once.
+  model.ResetState();
+  arma::mat output, state;
+  for (size_t s = 0; s < steps; ++s)
+  {
+    if (s % 3 == 1)
+    {
+      model.State(state);
+      BOOST_REQUIRE_EQUAL(state.n_rows, stateSize);
+      BOOST_REQUIRE_EQUAL(state.n_cols, 2);
+
+      model.ResetState();
+      model.SetState(state);
+    }
+
+    model.Step(input.rows(s * inputSize, (s + 1) * inputSize - 1), output);
+    CheckMatrices(output, predictions.rows(s * outputSize,
+        (s + 1) * outputSize - 1));
+  }
+
+  BOOST_REQUIRE_THROW(model.SetState(arma::mat(stateSize + 1, 2)),
+      std::invalid_argument);
+}
+
+/**
+ * Advance a network with an LSTM layer one step at a time.
+ */
+BOOST_AUTO_TEST_CASE(LSTMStepTest)
+{
+  StepTest<LSTM<> >(10);
+}
+
+/**
+ * Advance a network with a FastLSTM layer one step at a time.
+ */
+BOOST_AUTO_TEST_CASE(FastLSTMStepTest)
+{
+  StepTest<FastLSTM<> >(10);
+}
+
+/**
+ * Advance a network with a GRU layer one step at a time.
+ */
+BOOST_AUTO_TEST_CASE(GRUStepTest)
+{
+  StepTest<GRU<> >(5);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
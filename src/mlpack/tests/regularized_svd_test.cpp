@@ -251,6 +251,96 @@ BOOST_AUTO_TEST_CASE(RegularizedSVDFunctionOptimize)
   BOOST_REQUIRE_SMALL(relativeError, 1e-2);
 }
 
+/**
+ * With one thread, stratified parallel SGD has a single block holding every
+ * rating, so without shuffling each iteration must be a pass of plain SGD over
+ * the ratings in order.  With all the threads, it must still converge.
+ */
+BOOST_AUTO_TEST_CASE(RegularizedSVDFunctionStratifiedParallelSGD)
+{
+  // Define useful constants.
+  const size_t numUsers = 50;
+  const size_t numItems = 50;
+  const size_t numRatings = 100;
+  const size_t iterations = 10;
+  const size_t rank = 10;
+  const double alpha = 0.01;
+  const double lambda = 0.01;
+
+  // Initiate random parameters.
+  arma::mat parameters = arma::randu(rank, numUsers + numItems);
+
+  // Make a random rating dataset.
+  arma::mat data = arma::randu(3, numRatings);
+  data.row(0) = floor(data.row(0) * numUsers);
+  data.row(1) = floor(data.row(1) * numItems);
+
+  // Manually set last row to maximum user and maximum item.
+  data(0, numRatings - 1) = numUsers - 1;
+  data(1, numRatings - 1) = numItems - 1;
+
+  // Make rating entries based on the parameters.
+  for (size_t i = 0; i < numRatings; i++)
+  {
+    data(2, i) = arma::dot(parameters.col(data(0, i)),
+                           parameters.col(numUsers + data(1, i)));
+  }
+
+  RegularizedSVDFunction<arma::mat> rSVDFunc(data, rank, lambda);
+  const arma::mat startParameters = arma::randu(rank, numUsers + numItems);
+
+  // The tolerance is never reached, so all iterations are run.
+  arma::mat serialParameters(startParameters);
+  {
+    Parallel::Scope scope(1);
+    ParallelSGD<ConstantStep> optimizer(iterations, numRatings, -1.0, false,
+        ConstantStep(alpha));
+    optimizer.Optimize(rSVDFunc, serialParameters);
+  }
+
+  // Plain SGD with the gradient of each rating; the loop of the optimizer runs
+  // iterations - 1 passes.
+  arma::mat sgdParameters(startParameters);
+  arma::mat gradient;
+  for (size_t i = 1; i < iterations; ++i)
+  {
+    for (size_t j = 0; j < numRatings; ++j)
+    {
+      rSVDFunc.Gradient(sgdParameters, j, gradient);
+      sgdParameters -= alpha * gradient;
+    }
+  }
+
+  for (size_t i = 0; i < sgdParameters.n_elem; ++i)
+  {
+    if (std::abs(sgdParameters[i]) < 1e-8)
+      BOOST_REQUIRE_SMALL(serialParameters[i], 1e-8);
+    else
+      BOOST_REQUIRE_CLOSE(serialParameters[i], sgdParameters[i], 1e-5);
+  }
+
+  // Now optimize until convergence with all the threads.
+  ParallelSGD<ConstantStep> optimizer(0, numRatings, 1e-5, true,
+      ConstantStep(alpha));
+  arma::mat optParameters(startParameters);
+  optimizer.Optimize(rSVDFunc, optParameters);
+
+  // Get predicted ratings from optimized parameters.
+  arma::mat predictedData(1, numRatings);
+  for (size_t i = 0; i < numRatings; i++)
+  {
+    predictedData(0, i) = arma::dot(optParameters.col(data(0, i)),
+                                    optParameters.col(numUsers + data(1, i)));
+  }
+
+  // Calculate relative error.
+  const double relativeError = arma::norm(data.row(2) - predictedData, "frob") /
+                               arma::norm(data, "frob");
+
+  // Relative error should be small.
+  BOOST_REQUIRE_SMALL(relativeError, 1e-2);
+}
+
 // The test is only compiled if the user has specified OpenMP to be
 // used.
 #ifdef HAS_OPENMP
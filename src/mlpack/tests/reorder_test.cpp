@@ -0,0 +1,76 @@
+/**
+ * @file reorder_test.cpp
+ *
+ * Tests for the reordering of datasets along space-filling curves.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/core/data/reorder.hpp>
+
+#include <boost/test/unit_test.hpp>
+#include "test_tools.hpp"
+
+using namespace mlpack;
+using namespace mlpack::data;
+
+BOOST_AUTO_TEST_SUITE(ReorderTest);
+
+/**
+ * Make sure that the reordering is a permutation of the points, that it sorts
+ * the points along the curve, and that RestoreOrder() undoes it.
+ */
+BOOST_AUTO_TEST_CASE(ReorderRestoreTest)
+{
+  arma::mat dataset(3, 500, arma::fill::randn);
+
+  for (const ReorderCurve curve : { MORTON_CURVE, HILBERT_CURVE })
+  {
+    arma::mat reordered(dataset);
+    std::vector<size_t> oldFromNew;
+    Reorder(reordered, oldFromNew, curve);
+
+    BOOST_REQUIRE_EQUAL(oldFromNew.size(), dataset.n_cols);
+    for (size_t i = 0; i < oldFromNew.size(); ++i)
+      BOOST_REQUIRE_EQUAL(arma::accu(reordered.col(i) !=
+          dataset.col(oldFromNew[i])), 0);
+
+    // The points must be sorted along the curve.
+    for (size_t i = 1; i < reordered.n_cols; ++i)
+    {
+      if (curve == HILBERT_CURVE)
+      {
+        BOOST_REQUIRE_LE(tree::DiscreteHilbertValue<double>::ComparePoints(
+            reordered.col(i - 1), reordered.col(i)), 0);
+      }
+      else
+      {
+        arma::Col<uint64_t> a(3, arma::fill::zeros), b(3, arma::fill::zeros);
+        bound::addr::PointToAddress(a, reordered.col(i - 1));
+        bound::addr::PointToAddress(b, reordered.col(i));
+        BOOST_REQUIRE_LE(bound::addr::CompareAddresses(a, b), 0);
+      }
+    }
+
+    RestoreOrder(reordered, oldFromNew);
+    BOOST_REQUIRE_EQUAL(arma::accu(reordered != dataset), 0);
+
+    // Results with one column per point are restored too.
+    arma::Row<size_t> labels(oldFromNew.size());
+    for (size_t i = 0; i < labels.n_elem; ++i)
+      labels[i] = oldFromNew[i];
+    RestoreOrder(labels, oldFromNew);
+    for (size_t i = 0; i < labels.n_elem; ++i)
+      BOOST_REQUIRE_EQUAL(labels[i], i);
+  }
+
+  arma::mat wrongSize(3, 10);
+  std::vector<size_t> oldFromNew(5);
+  BOOST_REQUIRE_THROW(RestoreOrder(wrongSize, oldFromNew),
+      std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_SUITE_END();
@@ -14,7 +14,9 @@
 
 #include <mlpack/methods/reinforcement_learning/environment/mountain_car.hpp>
 #include <mlpack/methods/reinforcement_learning/environment/cart_pole.hpp>
+#include <mlpack/methods/reinforcement_learning/environment/vector_environment.hpp>
 #include <mlpack/methods/reinforcement_learning/replay/random_replay.hpp>
+#include <mlpack/methods/reinforcement_learning/replay/prioritized_replay.hpp>
 #include <mlpack/methods/reinforcement_learning/policy/greedy_policy.hpp>
 
 #include <boost/test/unit_test.hpp>
@@ -59,6 +61,47 @@ BOOST_AUTO_TEST_CASE(SimpleCartPoleTest)
   BOOST_REQUIRE_EQUAL(2, CartPole::Action::size);
 }
 
+/**
+ * Step several copies of the Cart Pole task in lockstep and check that they
+ * follow the same dynamics as a single copy.
+ */
+BOOST_AUTO_TEST_CASE(VectorEnvironmentTest)
+{
+  CartPole task;
+  VectorEnvironment<CartPole> env(3, task, 5);
+  BOOST_REQUIRE_EQUAL(env.Size(), 3);
+
+  arma::mat encoded;
+  env.Encode(encoded);
+  BOOST_REQUIRE_EQUAL(encoded.n_rows, 4);
+  BOOST_REQUIRE_EQUAL(encoded.n_cols, 3);
+
+  std::vector<CartPole::Action> actions(3, CartPole::Action::forward);
+  arma::colvec rewards;
+  std::vector<CartPole::State> nextStates;
+  std::vector<bool> terminal;
+  for (size_t step = 0; step < 5; ++step)
+  {
+    const std::vector<CartPole::State> states = env.States();
+    env.Step(actions, rewards, nextStates, terminal);
+
+    BOOST_REQUIRE_EQUAL(rewards.n_elem, 3);
+    for (size_t i = 0; i < 3; ++i)
+    {
+      CartPole::State nextState;
+      BOOST_REQUIRE_CLOSE(rewards[i], task.Sample(states[i], actions[i],
+          nextState), 1e-5);
+      CheckMatrices(nextState.Encode(), nextStates[i].Encode());
+      BOOST_REQUIRE_EQUAL(terminal[i], task.IsTerminal(nextState));
+    }
+  }
+
+  // The step limit ends every episode after 5 steps.
+  BOOST_REQUIRE_EQUAL(env.EpisodeReturns().size(), 3);
+  for (size_t i = 0; i < 3; ++i)
+    BOOST_REQUIRE_CLOSE(env.EpisodeReturns()[i], 5.0, 1e-5);
+}
+
 /**
  * Construct a random replay instance and check if it works as
  * it should be.
@@ -107,6 +150,89 @@ BOOST_AUTO_TEST_CASE(RandomReplayTest)
   }
 }
 
+/**
+ * Check that a sum tree keeps the sums of its values and finds the index at a
+ * given prefix sum.
+ */
+BOOST_AUTO_TEST_CASE(SumTreeTest)
+{
+  SumTree tree(5);
+  tree.Set(0, 1.0);
+  tree.Set(1, 2.0);
+  tree.Set(2, 0.0);
+  tree.Set(3, 3.0);
+  tree.Set(4, 4.0);
+  BOOST_REQUIRE_CLOSE(tree.Sum(), 10.0, 1e-5);
+
+  BOOST_REQUIRE_EQUAL(tree.Find(0.0), 0);
+  BOOST_REQUIRE_EQUAL(tree.Find(0.5), 0);
+  BOOST_REQUIRE_EQUAL(tree.Find(1.5), 1);
+  BOOST_REQUIRE_EQUAL(tree.Find(3.0), 3);
+  BOOST_REQUIRE_EQUAL(tree.Find(5.9), 3);
+  BOOST_REQUIRE_EQUAL(tree.Find(6.0), 4);
+  BOOST_REQUIRE_EQUAL(tree.Find(10.0), 4);
+
+  tree.Set(4, 0.0);
+  BOOST_REQUIRE_CLOSE(tree.Sum(), 6.0, 1e-5);
+  BOOST_REQUIRE_CLOSE(tree.Get(3), 3.0, 1e-5);
+  BOOST_REQUIRE_EQUAL(tree.Find(6.0), 3);
+}
+
+/**
+ * Construct a prioritized replay instance and check that experiences are
+ * sampled in proportion to their priorities.
+ */
+BOOST_AUTO_TEST_CASE(PrioritizedReplayTest)
+{
+  PrioritizedReplay<MountainCar> replay(2, 3, 1.0, 1.0);
+  MountainCar env;
+  MountainCar::State state = env.InitialSample();
+  MountainCar::Action action = MountainCar::Action::forward;
+  MountainCar::State nextState;
+  double reward = env.Sample(state, action, nextState);
+  replay.Store(state, action, reward, nextState, false);
+  replay.Store(nextState, action, reward, state, true);
+  BOOST_REQUIRE_EQUAL(2, replay.Size());
+
+  arma::mat sampledState;
+  arma::icolvec sampledAction;
+  arma::colvec sampledReward;
+  arma::mat sampledNextState;
+  arma::icolvec sampledTerminal;
+  arma::colvec weights;
+
+  // Both experiences have the same priority, so with stratified sampling each
+  // is sampled once, with weight 1.
+  replay.Sample(sampledState, sampledAction, sampledReward, sampledNextState,
+      sampledTerminal, weights);
+  BOOST_REQUIRE_EQUAL(sampledState.n_cols, 2);
+  BOOST_REQUIRE_EQUAL(weights.n_elem, 2);
+  BOOST_REQUIRE_EQUAL(sampledTerminal[0], 0);
+  BOOST_REQUIRE_EQUAL(sampledTerminal[1], 1);
+  BOOST_REQUIRE_CLOSE(weights[0], 1.0, 1e-5);
+  BOOST_REQUIRE_CLOSE(weights[1], 1.0, 1e-5);
+
+  // Make the terminal experience much more likely; now it should be sampled
+  // most of the time, with a smaller weight.
+  replay.Update(arma::colvec("0.001 100.0"));
+  size_t terminalSamples = 0;
+  for (size_t i = 0; i < 100; ++i)
+  {
+    replay.Sample(sampledState, sampledAction, sampledReward,
+        sampledNextState, sampledTerminal, weights);
+    for (size_t j = 0; j < 2; ++j)
+    {
+      if (sampledTerminal[j])
+      {
+        ++terminalSamples;
+        BOOST_REQUIRE_LE(weights[j], 1.0);
+      }
+    }
+  }
+
+  BOOST_REQUIRE_GT(terminalSamples, 190);
+}
+
 /**
  * Construct a greedy policy instance and check if it works as
  * it should be.
@@ -12,6 +12,7 @@
 #include <mlpack/core.hpp>
 
 #include <mlpack/core/optimizers/rmsprop/rmsprop.hpp>
+#include <mlpack/core/optimizers/rmsprop/sparse_rmsprop_update.hpp>
 #include <mlpack/core/optimizers/sgd/test_function.hpp>
 
 #include <mlpack/methods/logistic_regression/logistic_regression.hpp>
@@ -103,4 +104,34 @@ BOOST_AUTO_TEST_CASE(LogisticRegressionTest)
   BOOST_REQUIRE_CLOSE(testAcc, 100.0, 0.6); // 0.6% error tolerance.
 }
 
+/**
+ * Make sure that the sparse RMSProp update takes the same steps as the dense
+ * RMSProp update, when sparse and dense gradients are mixed.
+ */
+BOOST_AUTO_TEST_CASE(SparseRMSPropUpdateTest)
+{
+  arma::mat denseIterate = arma::randn<arma::mat>(10, 5);
+  arma::mat sparseIterate(denseIterate);
+
+  RMSPropUpdate dense(1e-8, 0.9);
+  SparseRMSPropUpdate sparse(1e-8, 0.9);
+  dense.Initialize(10, 5);
+  sparse.Initialize(10, 5);
+
+  for (size_t i = 0; i < 30; ++i)
+  {
+    arma::sp_mat gradient;
+    gradient.sprandn(10, 5, 0.1);
+
+    dense.Update(denseIterate, 0.01, arma::mat(gradient));
+    // Every fifth step is dense.
+    if (i % 5 == 4)
+      sparse.Update(sparseIterate, 0.01, arma::mat(gradient));
+    else
+      sparse.Update(sparseIterate, 0.01, gradient);
+  }
+
+  CheckMatrices(sparseIterate, denseIterate, 1e-7);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
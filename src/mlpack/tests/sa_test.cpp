@@ -133,4 +133,37 @@ BOOST_AUTO_TEST_CASE(RastrigrinFunctionTest)
   BOOST_REQUIRE_GE(successes, 1);
 }
 
+/**
+ * Make sure that parallel tempering with several chains escapes from the local
+ * minima of the Rastrigrin function, and returns the best point it saw.
+ */
+BOOST_AUTO_TEST_CASE(ParallelTemperingRastrigrinTest)
+{
+  size_t successes = 0;
+
+  for (size_t trial = 0; trial < 4; ++trial)
+  {
+    RastrigrinFunction f;
+    ExponentialSchedule schedule;
+    SA<> sa(schedule, 2000000, 100, 50, 1000, 1e-12, 2, 2.0, 0.5, 0.1, 4, 500,
+        3.0);
+    arma::mat coordinates = f.GetInitialPoint();
+
+    const double result = sa.Optimize(f, coordinates);
+
+    // The returned value is the value of the returned point.
+    BOOST_REQUIRE_CLOSE(f.Evaluate(coordinates) + 1.0, result + 1.0, 1e-5);
+
+    if ((std::abs(result) < 1e-3) &&
+        (std::abs(coordinates[0]) < 1e-3) &&
+        (std::abs(coordinates[1]) < 1e-3))
+    {
+      ++successes;
+      break; // No need to continue.
+    }
+  }
+
+  BOOST_REQUIRE_GE(successes, 1);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -0,0 +1,193 @@
+/**
+ * @file scaler_test.cpp
+ *
+ * Test the StandardScaler and MinMaxScaler classes.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/core/data/scaler_methods/standard_scaler.hpp>
+#include <mlpack/core/data/scaler_methods/min_max_scaler.hpp>
+
+#include <boost/test/unit_test.hpp>
+#include "test_tools.hpp"
+#include "serialization.hpp"
+
+using namespace mlpack;
+using namespace mlpack::data;
+
+BOOST_AUTO_TEST_SUITE(ScalerTest);
+
+/**
+ * Make sure the StandardScaler fitted a chunk at a time standardizes the
+ * points, and that the transformation can be undone.
+ */
+BOOST_AUTO_TEST_CASE(StandardScalerTest)
+{
+  arma::mat data = arma::randn<arma::mat>(4, 1000);
+  data.row(1) = 5.0 * data.row(1) + 100.0;
+  data.row(3).fill(2.0);
+
+  StandardScaler scaler;
+  for (size_t i = 0; i < data.n_cols; i += 300)
+  {
+    scaler.Update(arma::mat(data.cols(i, std::min(i + 299,
+        (size_t) data.n_cols - 1))));
+  }
+
+  BOOST_REQUIRE_EQUAL(scaler.Count(), 1000);
+  const arma::vec mean = arma::mean(data, 1);
+  const arma::vec stddev = arma::stddev(data, 1, 1);
+  for (size_t d = 0; d < data.n_rows; ++d)
+  {
+    BOOST_REQUIRE_SMALL(scaler.Mean()[d] - mean[d], 1e-8);
+    BOOST_REQUIRE_SMALL(scaler.StandardDeviation()[d] - stddev[d], 1e-8);
+  }
+
+  arma::mat transformed = data;
+  scaler.Transform(transformed);
+  for (size_t d = 0; d < 3; ++d)
+  {
+    BOOST_REQUIRE_SMALL(arma::mean(transformed.row(d)), 1e-8);
+    BOOST_REQUIRE_CLOSE(arma::stddev(transformed.row(d), 1), 1.0, 1e-6);
+  }
+
+  // The constant dimension is only centered.
+  BOOST_REQUIRE_SMALL(arma::abs(transformed.row(3)).max(), 1e-12);
+
+  scaler.InverseTransform(transformed);
+  CheckMatrices(data, transformed);
+}
+
+/**
+ * Make sure a sparse matrix is only scaled by a StandardScaler that does not
+ * center, and that it is scaled like the dense matrix.
+ */
+BOOST_AUTO_TEST_CASE(StandardScalerSparseTest)
+{
+  arma::sp_mat data = arma::sprandu<arma::sp_mat>(20, 300, 0.1);
+  const arma::mat dense(data);
+
+  StandardScaler centering;
+  centering.Fit(data);
+  arma::sp_mat transformed = data;
+  BOOST_REQUIRE_THROW(centering.Transform(transformed), std::invalid_argument);
+
+  StandardScaler scaler(false);
+  scaler.Fit(data);
+  StandardScaler denseScaler(false);
+  denseScaler.Fit(dense);
+  for (size_t d = 0; d < data.n_rows; ++d)
+  {
+    BOOST_REQUIRE_SMALL(scaler.Mean()[d] - denseScaler.Mean()[d], 1e-10);
+    BOOST_REQUIRE_SMALL(scaler.StandardDeviation()[d] -
+        denseScaler.StandardDeviation()[d], 1e-10);
+  }
+
+  scaler.Transform(transformed);
+  arma::mat expected = dense;
+  denseScaler.Transform(expected);
+  BOOST_REQUIRE_EQUAL(transformed.n_nonzero, data.n_nonzero);
+  CheckMatrices(expected, arma::mat(transformed));
+
+  scaler.InverseTransform(transformed);
+  CheckMatrices(dense, arma::mat(transformed));
+}
+
+/**
+ * Make sure the MinMaxScaler fitted a chunk at a time maps each dimension to
+ * the given range, and that the transformation can be undone.
+ */
+BOOST_AUTO_TEST_CASE(MinMaxScalerTest)
+{
+  arma::mat data = arma::randn<arma::mat>(3, 500);
+  data.row(2).fill(-4.0);
+
+  MinMaxScaler scaler(-1.0, 2.0);
+  scaler.Update(arma::mat(data.cols(0, 199)));
+  scaler.Update(arma::mat(data.cols(200, 499)));
+
+  arma::mat transformed = data;
+  scaler.Transform(transformed);
+  for (size_t d = 0; d < 2; ++d)
+  {
+    BOOST_REQUIRE_CLOSE(transformed.row(d).min(), -1.0, 1e-8);
+    BOOST_REQUIRE_CLOSE(transformed.row(d).max(), 2.0, 1e-8);
+  }
+  for (size_t i = 0; i < data.n_cols; ++i)
+    BOOST_REQUIRE_CLOSE(transformed(2, i), -1.0, 1e-8);
+
+  scaler.InverseTransform(transformed);
+  CheckMatrices(data, transformed);
+
+  // Zero is not mapped to zero, so a sparse matrix can't be transformed.
+  arma::sp_mat sparse(data);
+  BOOST_REQUIRE_THROW(scaler.Transform(sparse), std::invalid_argument);
+}
+
+/**
+ * Make sure nonnegative sparse data is scaled to [0, 1] and stays sparse.
+ */
+BOOST_AUTO_TEST_CASE(MinMaxScalerSparseTest)
+{
+  arma::sp_mat data = 10.0 * arma::sprandu<arma::sp_mat>(10, 400, 0.05);
+
+  MinMaxScaler scaler;
+  scaler.Fit(data);
+
+  arma::sp_mat transformed = data;
+  scaler.Transform(transformed);
+  BOOST_REQUIRE_EQUAL(transformed.n_nonzero, data.n_nonzero);
+
+  arma::mat expected(data);
+  scaler.Transform(expected);
+  CheckMatrices(expected, arma::mat(transformed));
+
+  scaler.InverseTransform(transformed);
+  CheckMatrices(arma::mat(data), arma::mat(transformed));
+}
+
+/**
+ * Make sure that the fitted statistics are serialized, so that they transform
+ * new points the same way.
+ */
+BOOST_AUTO_TEST_CASE(ScalerSerializationTest)
+{
+  arma::mat data = arma::randu<arma::mat>(5, 100);
+  arma::mat test = arma::randu<arma::mat>(5, 20);
+
+  StandardScaler standard;
+  standard.Fit(data);
+  MinMaxScaler minMax(-1.0, 1.0);
+  minMax.Fit(data);
+
+  arma::mat expectedStandard = test;
+  standard.Transform(expectedStandard);
+  arma::mat expectedMinMax = test;
+  minMax.Transform(expectedMinMax);
+
+  StandardScaler xmlStandard, textStandard, binaryStandard;
+  SerializeObjectAll(standard, xmlStandard, textStandard, binaryStandard);
+  MinMaxScaler xmlMinMax, textMinMax, binaryMinMax;
+  SerializeObjectAll(minMax, xmlMinMax, textMinMax, binaryMinMax);
+
+  for (const StandardScaler* s : { &xmlStandard, &textStandard,
+      &binaryStandard })
+  {
+    arma::mat transformed = test;
+    s->Transform(transformed);
+    CheckMatrices(expectedStandard, transformed);
+  }
+
+  for (const MinMaxScaler* s : { &xmlMinMax, &textMinMax, &binaryMinMax })
+  {
+    arma::mat transformed = test;
+    s->Transform(transformed);
+    CheckMatrices(expectedMinMax, transformed);
+  }
+}
+
+BOOST_AUTO_TEST_SUITE_END();
@@ -13,6 +13,7 @@
 #include <mlpack/core/optimizers/scd/scd.hpp>
 #include <mlpack/core/optimizers/scd/descent_policies/greedy_descent.hpp>
 #include <mlpack/core/optimizers/scd/descent_policies/cyclic_descent.hpp>
+#include <mlpack/core/optimizers/scd/descent_policies/shotgun_descent.hpp>
 #include <mlpack/core/optimizers/parallel_sgd/sparse_test_function.hpp>
 #include <mlpack/methods/logistic_regression/logistic_regression_function.hpp>
 #include <mlpack/methods/softmax_regression/softmax_regression_function.hpp>
@@ -147,6 +148,71 @@ BOOST_AUTO_TEST_CASE(RandomDescentTest)
   }
 }
 
+/**
+ * Test that the shotgun descent policy picks distinct features.
+ */
+BOOST_AUTO_TEST_CASE(ShotgunDescentTest)
+{
+  const size_t features = 10;
+  struct DummyFunction
+  {
+    static size_t NumFeatures()
+    {
+      return features;
+    }
+  };
+
+  DummyFunction dummy;
+
+  ShotgunDescent descentPolicy(4);
+
+  for (size_t i = 0; i < 100; ++i)
+  {
+    arma::uvec picked;
+    descentPolicy.DescentFeatures(i, arma::mat(), dummy, picked);
+
+    BOOST_REQUIRE_EQUAL(picked.n_elem, 4);
+    BOOST_REQUIRE_LT(picked.max(), features);
+    BOOST_REQUIRE_EQUAL(arma::uvec(arma::unique(picked)).n_elem, 4);
+  }
+}
+
+/**
+ * Make sure that SCD with the shotgun descent policy, which updates several
+ * coordinates at once, optimizes the sparse test function.
+ */
+BOOST_AUTO_TEST_CASE(ShotgunDisjointFeatureTest)
+{
+  SparseTestFunction f;
+  SCD<ShotgunDescent> s(0.4, 100000, 1e-5, 1e3, ShotgunDescent(2));
+
+  arma::mat iterate = f.GetInitialPoint();
+
+  double result = s.Optimize(f, iterate);
+
+  BOOST_REQUIRE_CLOSE(result, 123.75, 0.01);
+  BOOST_REQUIRE_CLOSE(iterate[0], 2, 0.02);
+  BOOST_REQUIRE_CLOSE(iterate[1], 1, 0.02);
+  BOOST_REQUIRE_CLOSE(iterate[2], 1.5, 0.02);
+  BOOST_REQUIRE_CLOSE(iterate[3], 4, 0.02);
+}
+
+/**
+ * Test the estimate of the number of coordinates that can be updated at once:
+ * all of them for uncorrelated features, and one for identical features.
+ */
+BOOST_AUTO_TEST_CASE(ShotgunMaxParallelUpdatesTest)
+{
+  arma::mat orthogonal = arma::eye<arma::mat>(8, 8);
+  BOOST_REQUIRE_EQUAL(ShotgunDescent::MaxParallelUpdates(orthogonal), 8);
+
+  arma::mat identical = arma::repmat(arma::randu<arma::rowvec>(50), 8, 1);
+  BOOST_REQUIRE_EQUAL(ShotgunDescent::MaxParallelUpdates(identical), 1);
+
+  arma::sp_mat sparseOrthogonal(orthogonal);
+  BOOST_REQUIRE_EQUAL(ShotgunDescent::MaxParallelUpdates(sparseOrthogonal), 8);
+}
+
 /**
  * Test that LogisticRegressionFunction::PartialGradient() works as expected.
  */
@@ -193,7 +259,7 @@ BOOST_AUTO_TEST_CASE(SoftmaxRegressionFunctionPartialGradientTest)
 
   // 2 objects for 2 terms in the cost function. Each term contributes towards
   // the gradient and thus need to be checked independently.
-  SoftmaxRegressionFunction srf(data, labels, numClasses, 0);
+  SoftmaxRegressionFunction<> srf(data, labels, numClasses, 0);
 
   // Create a random set of parameters.
   arma::mat parameters;
@@ -32,6 +32,8 @@
 #include <mlpack/methods/naive_bayes/naive_bayes_classifier.hpp>
 #include <mlpack/methods/rann/ra_search.hpp>
 #include <mlpack/methods/lsh/lsh_search.hpp>
+#include <mlpack/methods/hnsw/hnsw_search.hpp>
+#include <mlpack/methods/product_quantization/pq_search.hpp>
 #include <mlpack/methods/decision_stump/decision_stump.hpp>
 #include <mlpack/methods/lars/lars.hpp>
 
@@ -833,6 +835,53 @@ BOOST_AUTO_TEST_CASE(KNNTest)
   CheckMatrices(neighbors, xmlNeighbors, textNeighbors, binaryNeighbors);
 }
 
+/**
+ * Make sure a KNN model can be saved to and loaded from a flat model file, and
+ * that the large matrices of the loaded model point into the file mapping.
+ */
+BOOST_AUTO_TEST_CASE(KNNFlatFormatTest)
+{
+  using neighbor::KNN;
+  arma::mat dataset = arma::randu<arma::mat>(5, 2000);
+
+  KNN knn(dataset, DUAL_TREE_MODE);
+  BOOST_REQUIRE(data::Save("test_knn.flat", "knn", knn));
+
+  KNN knnFlat;
+  BOOST_REQUIRE(data::Load("test_knn.flat", "knn", knnFlat));
+
+  // The reference set wasn't copied out of the mapping.
+  BOOST_REQUIRE_EQUAL(knnFlat.ReferenceSet().mem_state, 1);
+  CheckMatrices(knn.ReferenceSet(), knnFlat.ReferenceSet());
+
+  arma::mat querySet = arma::randu<arma::mat>(5, 1000);
+  arma::mat distances, flatDistances;
+  arma::Mat<size_t> neighbors, flatNeighbors;
+
+  knn.Search(querySet, 5, neighbors, distances);
+  knnFlat.Search(querySet, 5, flatNeighbors, flatDistances);
+
+  CheckMatrices(distances, flatDistances);
+  CheckMatrices(neighbors, flatNeighbors);
+
+  // Small matrices are kept in the archive; this should still work.
+  arma::mat small = arma::randu<arma::mat>(3, 3);
+  arma::mat smallFlat;
+  BOOST_REQUIRE(data::Save("test_small.flat", "small", small));
+  BOOST_REQUIRE(data::Load("test_small.flat", "small", smallFlat));
+  BOOST_REQUIRE_EQUAL(smallFlat.mem_state, 0);
+  CheckMatrices(small, smallFlat);
+
+  // A file that is not a flat model file can't be loaded.
+  BOOST_REQUIRE(data::Save("test_knn.bin", "knn", knn));
+  BOOST_REQUIRE(!data::Load("test_knn.bin", "knn", knnFlat, false,
+      data::format::flat));
+
+  remove("test_knn.flat");
+  remove("test_small.flat");
+  remove("test_knn.bin");
+}
+
 BOOST_AUTO_TEST_CASE(SoftmaxRegressionTest)
 {
   using regression::SoftmaxRegression;
@@ -1232,16 +1281,100 @@ BOOST_AUTO_TEST_CASE(LSHTest)
   BOOST_REQUIRE_EQUAL(lsh.BucketSize(), textLsh.BucketSize());
   BOOST_REQUIRE_EQUAL(lsh.BucketSize(), binaryLsh.BucketSize());
 
-  BOOST_REQUIRE_EQUAL(lsh.SecondHashTable().size(),
-      xmlLsh.SecondHashTable().size());
-  BOOST_REQUIRE_EQUAL(lsh.SecondHashTable().size(),
-      textLsh.SecondHashTable().size());
-  BOOST_REQUIRE_EQUAL(lsh.SecondHashTable().size(),
-      binaryLsh.SecondHashTable().size());
+  CheckMatrices(lsh.BucketOffsets(), xmlLsh.BucketOffsets(),
+      textLsh.BucketOffsets(), binaryLsh.BucketOffsets());
+  CheckMatrices(arma::conv_to<arma::Mat<size_t>>::from(lsh.BucketContents()),
+      arma::conv_to<arma::Mat<size_t>>::from(xmlLsh.BucketContents()),
+      arma::conv_to<arma::Mat<size_t>>::from(textLsh.BucketContents()),
+      arma::conv_to<arma::Mat<size_t>>::from(binaryLsh.BucketContents()));
+}
+
+/**
+ * Test that an HNSW model can be serialized and deserialized, and that the
+ * deserialized models give the same results.
+ */
+BOOST_AUTO_TEST_CASE(HNSWTest)
+{
+  arma::mat referenceData = arma::randu<arma::mat>(10, 200);
+  arma::mat queryData = arma::randu<arma::mat>(10, 20);
+
+  HNSWSearch<> hnsw(referenceData, 6, 40);
+
+  HNSWSearch<> xmlHnsw;
+  arma::mat textData = arma::randu<arma::mat>(5, 50);
+  HNSWSearch<> textHnsw(textData, 4, 10);
+  HNSWSearch<> binaryHnsw(referenceData, 12, 20);
+
+  SerializeObjectAll(hnsw, xmlHnsw, textHnsw, binaryHnsw);
 
-  for (size_t i = 0; i < lsh.SecondHashTable().size(); ++i)
-  CheckMatrices(lsh.SecondHashTable()[i], xmlLsh.SecondHashTable()[i],
-      textLsh.SecondHashTable()[i], binaryLsh.SecondHashTable()[i]);
+  BOOST_REQUIRE_EQUAL(hnsw.M(), xmlHnsw.M());
+  BOOST_REQUIRE_EQUAL(hnsw.M(), textHnsw.M());
+  BOOST_REQUIRE_EQUAL(hnsw.M(), binaryHnsw.M());
+  BOOST_REQUIRE_EQUAL(hnsw.EntryPoint(), xmlHnsw.EntryPoint());
+  BOOST_REQUIRE_EQUAL(hnsw.EntryPoint(), textHnsw.EntryPoint());
+  BOOST_REQUIRE_EQUAL(hnsw.EntryPoint(), binaryHnsw.EntryPoint());
+
+  CheckMatrices(hnsw.ReferenceSet(), xmlHnsw.ReferenceSet(),
+      textHnsw.ReferenceSet(), binaryHnsw.ReferenceSet());
+  CheckMatrices(hnsw.Layers(), xmlHnsw.Layers(), textHnsw.Layers(),
+      binaryHnsw.Layers());
+  CheckMatrices(hnsw.BaseDegrees(), xmlHnsw.BaseDegrees(),
+      textHnsw.BaseDegrees(), binaryHnsw.BaseDegrees());
+
+  arma::Mat<size_t> neighbors, xmlNeighbors, textNeighbors, binaryNeighbors;
+  arma::mat distances, xmlDistances, textDistances, binaryDistances;
+  hnsw.Search(queryData, 3, neighbors, distances);
+  xmlHnsw.Search(queryData, 3, xmlNeighbors, xmlDistances);
+  textHnsw.Search(queryData, 3, textNeighbors, textDistances);
+  binaryHnsw.Search(queryData, 3, binaryNeighbors, binaryDistances);
+
+  CheckMatrices(neighbors, xmlNeighbors, textNeighbors, binaryNeighbors);
+  CheckMatrices(distances, xmlDistances, textDistances, binaryDistances);
+}
+
+/**
+ * Test that a PQSearch model can be serialized and deserialized, and that the
+ * deserialized models give the same results.
+ */
+BOOST_AUTO_TEST_CASE(PQSearchTest)
+{
+  arma::mat referenceData = arma::randu<arma::mat>(8, 200);
+  arma::mat queryData = arma::randu<arma::mat>(8, 20);
+
+  PQSearch pq(referenceData, ProductQuantizer(4, 16));
+
+  PQSearch xmlPq;
+  arma::mat textData = arma::randu<arma::mat>(4, 50);
+  PQSearch textPq(textData, ProductQuantizer(2, 8));
+  PQSearch binaryPq(referenceData, ProductQuantizer(2, 32));
+
+  SerializeObjectAll(pq, xmlPq, textPq, binaryPq);
+
+  BOOST_REQUIRE_EQUAL(pq.Quantizer().NumSubspaces(),
+      xmlPq.Quantizer().NumSubspaces());
+  BOOST_REQUIRE_EQUAL(pq.Quantizer().NumSubspaces(),
+      textPq.Quantizer().NumSubspaces());
+  BOOST_REQUIRE_EQUAL(pq.Quantizer().NumSubspaces(),
+      binaryPq.Quantizer().NumSubspaces());
+  for (size_t s = 0; s < pq.Quantizer().NumSubspaces(); ++s)
+  {
+    CheckMatrices(pq.Quantizer().Codebook(s), xmlPq.Quantizer().Codebook(s),
+        textPq.Quantizer().Codebook(s), binaryPq.Quantizer().Codebook(s));
+  }
+  CheckMatrices(arma::conv_to<arma::Mat<size_t>>::from(pq.Codes()),
+      arma::conv_to<arma::Mat<size_t>>::from(xmlPq.Codes()),
+      arma::conv_to<arma::Mat<size_t>>::from(textPq.Codes()),
+      arma::conv_to<arma::Mat<size_t>>::from(binaryPq.Codes()));
+
+  arma::Mat<size_t> neighbors, xmlNeighbors, textNeighbors, binaryNeighbors;
+  arma::mat distances, xmlDistances, textDistances, binaryDistances;
+  pq.Search(queryData, 3, neighbors, distances);
+  xmlPq.Search(queryData, 3, xmlNeighbors, xmlDistances);
+  textPq.Search(queryData, 3, textNeighbors, textDistances);
+  binaryPq.Search(queryData, 3, binaryNeighbors, binaryDistances);
+
+  CheckMatrices(neighbors, xmlNeighbors, textNeighbors, binaryNeighbors);
+  CheckMatrices(distances, xmlDistances, textDistances, binaryDistances);
 }
 
 // Make sure serialization works for the decision stump.
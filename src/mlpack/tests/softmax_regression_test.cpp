@@ -39,7 +39,7 @@ BOOST_AUTO_TEST_CASE(SoftmaxRegressionFunctionEvaluate)
     labels(i) = math::RandInt(0, numClasses);
 
   // Create a SoftmaxRegressionFunction. Regularization term ignored.
-  SoftmaxRegressionFunction srf(data, labels, numClasses, 0);
+  SoftmaxRegressionFunction<> srf(data, labels, numClasses, 0);
 
   // Run a number of trials.
   for (size_t i = 0; i < trials; i++)
@@ -84,9 +84,9 @@ BOOST_AUTO_TEST_CASE(SoftmaxRegressionFunctionRegularizationEvaluate)
     labels(i) = math::RandInt(0, numClasses);
 
   // 3 objects for comparing regularization costs.
-  SoftmaxRegressionFunction srfNoReg(data, labels, numClasses, 0);
-  SoftmaxRegressionFunction srfSmallReg(data, labels, numClasses, 1);
-  SoftmaxRegressionFunction srfBigReg(data, labels, numClasses, 20);
+  SoftmaxRegressionFunction<> srfNoReg(data, labels, numClasses, 0);
+  SoftmaxRegressionFunction<> srfSmallReg(data, labels, numClasses, 1);
+  SoftmaxRegressionFunction<> srfBigReg(data, labels, numClasses, 20);
 
   // Run a number of trials.
   for (size_t i = 0; i < trials; i++)
@@ -126,8 +126,8 @@ BOOST_AUTO_TEST_CASE(SoftmaxRegressionFunctionGradient)
 
   // 2 objects for 2 terms in the cost function. Each term contributes towards
   // the gradient and thus need to be checked independently.
-  SoftmaxRegressionFunction srf1(data, labels, numClasses, 0);
-  SoftmaxRegressionFunction srf2(data, labels, numClasses, 20);
+  SoftmaxRegressionFunction<> srf1(data, labels, numClasses, 0);
+  SoftmaxRegressionFunction<> srf2(data, labels, numClasses, 20);
 
   // Create a random set of parameters.
   arma::mat parameters;
@@ -172,6 +172,84 @@ BOOST_AUTO_TEST_CASE(SoftmaxRegressionFunctionGradient)
   }
 }
 
+/**
+ * Make sure that EvaluateWithGradient() gives the same results as Evaluate()
+ * and Gradient(), with and without the intercept.
+ */
+BOOST_AUTO_TEST_CASE(SoftmaxRegressionFunctionEvaluateWithGradient)
+{
+  const size_t points = 500;
+  const size_t inputSize = 10;
+  const size_t numClasses = 5;
+
+  arma::mat data;
+  data.randu(inputSize, points);
+  arma::Row<size_t> labels(points);
+  for (size_t i = 0; i < points; i++)
+    labels(i) = math::RandInt(0, numClasses);
+
+  for (size_t intercept = 0; intercept < 2; ++intercept)
+  {
+    SoftmaxRegressionFunction<> srf(data, labels, numClasses, 0.1, intercept);
+
+    arma::mat parameters;
+    parameters.randu(numClasses, inputSize + intercept);
+
+    arma::mat gradient, fusedGradient;
+    srf.Gradient(parameters, gradient);
+    const double objective = srf.EvaluateWithGradient(parameters,
+        fusedGradient);
+    BOOST_REQUIRE_CLOSE(objective, srf.Evaluate(parameters), 1e-5);
+    CheckMatrices(gradient, fusedGradient);
+
+    for (size_t begin = 0; begin < points; begin += 100)
+    {
+      srf.Gradient(parameters, begin, gradient, 100);
+      const double batchObjective = srf.EvaluateWithGradient(parameters,
+          begin, fusedGradient, 100);
+      BOOST_REQUIRE_CLOSE(batchObjective, srf.Evaluate(parameters, begin, 100),
+          1e-5);
+      CheckMatrices(gradient, fusedGradient);
+    }
+  }
+}
+
+/**
+ * The full-batch objective and gradient are computed a chunk of points at a
+ * time; make sure they match the batch computation over all the points.
+ */
+BOOST_AUTO_TEST_CASE(SoftmaxRegressionFunctionChunksTest)
+{
+  const size_t points = 2500;
+  const size_t inputSize = 10;
+  const size_t numClasses = 5;
+
+  arma::mat data;
+  data.randu(inputSize, points);
+  arma::Row<size_t> labels(points);
+  for (size_t i = 0; i < points; i++)
+    labels(i) = math::RandInt(0, numClasses);
+
+  for (size_t intercept = 0; intercept < 2; ++intercept)
+  {
+    SoftmaxRegressionFunction<> srf(data, labels, numClasses, 0.1, intercept);
+
+    arma::mat parameters;
+    parameters.randu(numClasses, inputSize + intercept);
+
+    arma::mat gradient, batchGradient;
+    srf.Gradient(parameters, gradient);
+    srf.Gradient(parameters, 0, batchGradient, points);
+    CheckMatrices(gradient, batchGradient);
+
+    BOOST_REQUIRE_CLOSE(srf.Evaluate(parameters),
+        srf.Evaluate(parameters, 0, points), 1e-5);
+    BOOST_REQUIRE_CLOSE(srf.EvaluateWithGradient(parameters, gradient),
+        srf.Evaluate(parameters, 0, points), 1e-5);
+    CheckMatrices(gradient, batchGradient);
+  }
+}
+
 BOOST_AUTO_TEST_CASE(SoftmaxRegressionTwoClasses)
 {
   const size_t points = 1000;
@@ -669,4 +747,82 @@ BOOST_AUTO_TEST_CASE(SoftmaxRegressionComputeProbabilitiesAndLabelsTest)
   }
 }
 
+/**
+ * Make sure that the objective function gives the same results for sparse data
+ * as for the same data in a dense matrix, and that its sparse gradient is the
+ * same as its dense gradient.
+ */
+BOOST_AUTO_TEST_CASE(SoftmaxRegressionFunctionSparseTest)
+{
+  arma::sp_mat sparseData;
+  sparseData.sprandu(20, 200, 0.1);
+  const arma::mat data(sparseData);
+  arma::Row<size_t> labels(200);
+  for (size_t i = 0; i < 200; ++i)
+    labels[i] = math::RandInt(0, 3);
+
+  for (size_t intercept = 0; intercept < 2; ++intercept)
+  {
+    SoftmaxRegressionFunction<> srf(data, labels, 3, 0.1, intercept);
+    SoftmaxRegressionFunction<arma::sp_mat> srfSparse(sparseData, labels, 3,
+        0.1, intercept);
+
+    const arma::mat parameters = arma::randn<arma::mat>(3, 20 + intercept);
+    BOOST_REQUIRE_CLOSE(srf.Evaluate(parameters),
+        srfSparse.Evaluate(parameters), 1e-5);
+
+    arma::mat gradient, sparseDataGradient;
+    srf.Gradient(parameters, gradient);
+    srfSparse.Gradient(parameters, sparseDataGradient);
+    CheckMatrices(gradient, sparseDataGradient, 1e-5);
+
+    for (size_t begin = 0; begin < 200; begin += 50)
+    {
+      arma::mat batchGradient;
+      arma::sp_mat sparseGradient;
+      srfSparse.Gradient(parameters, begin, batchGradient, 50);
+      srfSparse.Gradient(parameters, begin, sparseGradient, 50);
+      CheckMatrices(arma::mat(sparseGradient), batchGradient, 1e-5);
+    }
+  }
+}
+
+/**
+ * Make sure that training and classification on sparse data give the same
+ * results as on the same data in a dense matrix.
+ */
+BOOST_AUTO_TEST_CASE(SoftmaxRegressionSparseTrainTest)
+{
+  arma::sp_mat sparseData;
+  sparseData.sprandu(10, 500, 0.2);
+  const arma::mat data(sparseData);
+  arma::Row<size_t> labels(500);
+  for (size_t i = 0; i < 500; ++i)
+    labels[i] = (data(0, i) > 0.0) ? 1 : ((data(1, i) > 0.0) ? 2 : 0);
+
+  SoftmaxRegression sr(data.n_rows, 3, true);
+  SoftmaxRegression srSparse(data.n_rows, 3, true);
+  srSparse.Parameters() = sr.Parameters();
+
+  sr.Train(data, labels, 3);
+  srSparse.Train(sparseData, labels, 3);
+
+  for (size_t i = 0; i < sr.Parameters().n_elem; ++i)
+  {
+    if (std::abs(sr.Parameters()[i]) < 1e-4)
+      BOOST_REQUIRE_SMALL(srSparse.Parameters()[i], 1e-4);
+    else
+      BOOST_REQUIRE_CLOSE(sr.Parameters()[i], srSparse.Parameters()[i], 1e-4);
+  }
+
+  arma::Row<size_t> predictions, sparsePredictions;
+  sr.Classify(data, predictions);
+  srSparse.Classify(sparseData, sparsePredictions);
+  for (size_t i = 0; i < predictions.n_elem; ++i)
+    BOOST_REQUIRE_EQUAL(predictions[i], sparsePredictions[i]);
+
+  BOOST_REQUIRE_CLOSE(sr.ComputeAccuracy(data, labels),
+      srSparse.ComputeAccuracy(sparseData, labels), 1e-5);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -268,4 +268,74 @@ BOOST_AUTO_TEST_CASE(SparseAutoencoderFunctionGradient)
   }
 }
 
+/**
+ * The objective and gradient are computed a chunk of points at a time; make
+ * sure they are right when there are several chunks, and that the batch
+ * versions only use the points of the batch.
+ */
+BOOST_AUTO_TEST_CASE(SparseAutoencoderFunctionBatchTest)
+{
+  const size_t points = 2500;
+  const size_t vSize = 8;
+  const size_t hSize = 4;
+  const size_t l1 = hSize;
+  const size_t l2 = vSize;
+  const size_t l3 = 2 * hSize;
+
+  arma::mat data;
+  data.randu(vSize, points);
+
+  SparseAutoencoderFunction saf(data, vSize, hSize, 0.1, 2, 0.1);
+
+  arma::mat parameters;
+  parameters.randu(l3 + 1, l2 + 1);
+
+  // Compute the objective directly.
+  arma::mat hidden = parameters.submat(0, 0, l1 - 1, l2 - 1) * data;
+  hidden.each_col() += arma::vec(parameters.submat(0, l2, l1 - 1, l2));
+  hidden = 1.0 / (1 + arma::exp(-hidden));
+  arma::mat output = parameters.submat(l1, 0, l3 - 1, l2 - 1).t() * hidden;
+  output.each_col() += arma::vec(parameters.submat(l3, 0, l3, l2 - 1).t());
+  output = 1.0 / (1 + arma::exp(-output));
+  const arma::vec rhoCap = arma::sum(hidden, 1) / points;
+  const double cost = 0.5 * arma::accu(arma::square(output - data)) / points +
+      0.05 * arma::accu(arma::square(parameters.submat(0, 0, l3 - 1,
+      l2 - 1))) + 2 * arma::accu(0.1 * arma::log(0.1 / rhoCap) + 0.9 *
+      arma::log(0.9 / (1 - rhoCap)));
+  BOOST_REQUIRE_CLOSE(saf.Evaluate(parameters), cost, 1e-5);
+
+  // Check the gradient numerically.
+  arma::mat gradient;
+  saf.Gradient(parameters, gradient);
+  const double epsilon = 0.0001;
+  for (size_t i = 0; i <= l3; i++)
+  {
+    for (size_t j = 0; j <= l2; j++)
+    {
+      parameters(i, j) += epsilon;
+      const double costPlus = saf.Evaluate(parameters);
+      parameters(i, j) -= 2 * epsilon;
+      const double costMinus = saf.Evaluate(parameters);
+      parameters(i, j) += epsilon;
+
+      const double numGradient = (costPlus - costMinus) / (2 * epsilon);
+      if (std::abs(gradient(i, j)) < 1e-5)
+        BOOST_REQUIRE_SMALL(numGradient, 1e-5);
+      else
+        BOOST_REQUIRE_CLOSE(numGradient, gradient(i, j), 1e-2);
+    }
+  }
+
+  // A batch gives the same results as the function of only its points.
+  arma::mat batch = data.cols(700, 1899);
+  SparseAutoencoderFunction batchSaf(batch, vSize, hSize, 0.1, 2, 0.1);
+  BOOST_REQUIRE_CLOSE(saf.Evaluate(parameters, 700, 1200),
+      batchSaf.Evaluate(parameters), 1e-5);
+
+  arma::mat batchGradient;
+  saf.Gradient(parameters, 700, gradient, 1200);
+  batchSaf.Gradient(parameters, batchGradient);
+  CheckMatrices(gradient, batchGradient);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
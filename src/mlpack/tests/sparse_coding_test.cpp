@@ -110,6 +110,56 @@ BOOST_AUTO_TEST_CASE(SparseCodingTestCodingStepElasticNet)
   }
 }
 
+/**
+ * Make sure that the codes are the same with one thread as with all of them,
+ * and the same as running a new LARS object for each point.
+ */
+BOOST_AUTO_TEST_CASE(SparseCodingTestCodingStepParallel)
+{
+  double lambda1 = 0.1;
+  double lambda2 = 0.2;
+  uword nAtoms = 25;
+
+  mat X;
+  X.load("mnist_first250_training_4s_and_9s.arm");
+  uword nPoints = X.n_cols;
+
+  // Normalize each point since these are images.
+  for (uword i = 0; i < nPoints; ++i)
+    X.col(i) /= norm(X.col(i), 2);
+
+  SparseCoding sc(nAtoms, lambda1, lambda2);
+  DataDependentRandomInitializer::Initialize(X, 25, sc.Dictionary());
+
+  mat serialZ;
+  {
+    Parallel::Scope scope(1);
+    sc.Encode(X, serialZ);
+  }
+
+  mat Z;
+  sc.Encode(X, Z);
+
+  const mat& D = sc.Dictionary();
+  mat matGram = trans(D) * D;
+  for (uword i = 0; i < nPoints; ++i)
+  {
+    LARS lars(true, matGram, lambda1, lambda2);
+    vec code;
+    rowvec responses = trans(X.col(i));
+    lars.Train(D, responses, code, false);
+
+    for (uword j = 0; j < nAtoms; ++j)
+    {
+      BOOST_REQUIRE_EQUAL(Z(j, i), serialZ(j, i));
+      if (std::abs(code[j]) < 1e-8)
+        BOOST_REQUIRE_SMALL(Z(j, i), 1e-8);
+      else
+        BOOST_REQUIRE_CLOSE(Z(j, i), code[j], 1e-5);
+    }
+  }
+}
+
 BOOST_AUTO_TEST_CASE(SparseCodingTestDictionaryStep)
 {
   const double tol = 1e-6;
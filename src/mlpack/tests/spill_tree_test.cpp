@@ -308,4 +308,29 @@ BOOST_AUTO_TEST_CASE(SpillTreeMoveDatasetTest)
   BOOST_REQUIRE_EQUAL(tree.Dataset().n_cols, 1000);
 }
 
+/**
+ * Make sure that a tree whose children are built in parallel is the same as a
+ * tree built serially, and that its copy (whose leaves own their points
+ * instead of sharing the arena of the root) is the same too.
+ */
+BOOST_AUTO_TEST_CASE(SpillTreeParallelConstructionTest)
+{
+  arma::mat dataset = arma::randu<arma::mat>(3, 2000);
+  typedef SPTree<EuclideanDistance, EmptyStatistic, arma::mat> TreeType;
+
+  TreeType serialTree(dataset, 0.1, 20, 0.7, 100000);
+  TreeType parallelTree(dataset, 0.1, 20, 0.7, 50);
+  TreeType copiedTree(parallelTree);
+
+  BOOST_REQUIRE_EQUAL(parallelTree.NumDescendants(),
+      serialTree.NumDescendants());
+  BOOST_REQUIRE_EQUAL(copiedTree.NumDescendants(),
+      serialTree.NumDescendants());
+  for (size_t i = 0; i < serialTree.NumDescendants(); ++i)
+  {
+    BOOST_REQUIRE_EQUAL(parallelTree.Descendant(i), serialTree.Descendant(i));
+    BOOST_REQUIRE_EQUAL(copiedTree.Descendant(i), serialTree.Descendant(i));
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END();
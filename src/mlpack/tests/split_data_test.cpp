@@ -170,4 +170,113 @@ BOOST_AUTO_TEST_CASE(SplitLabeledDataLargerTest)
   CheckDuplication(std::get<2>(value), std::get<3>(value));
 }
 
+/**
+ * Make sure that SplitIndices() gives the same points as Split() for the same
+ * random seed, and that each point is used once.
+ */
+BOOST_AUTO_TEST_CASE(SplitIndicesTest)
+{
+  mat input(3, 101);
+  input.randu();
+
+  math::RandomSeed(7);
+  arma::uvec trainIndices, testIndices;
+  SplitIndices(input.n_cols, trainIndices, testIndices, 0.25);
+  BOOST_REQUIRE_EQUAL(trainIndices.n_elem, 101 - size_t(0.25 * 101));
+  BOOST_REQUIRE_EQUAL(testIndices.n_elem, size_t(0.25 * 101));
+
+  math::RandomSeed(7);
+  mat trainData, testData;
+  Split(input, trainData, testData, 0.25);
+
+  CheckMatEqual(trainData, input.cols(trainIndices));
+  CheckMatEqual(testData, input.cols(testIndices));
+  CheckDuplication(arma::conv_to<Row<size_t>>::from(trainIndices),
+      arma::conv_to<Row<size_t>>::from(testIndices));
+}
+
+/**
+ * Make sure that a stratified split puts the same proportion of the points of
+ * each label in the test set, and keeps the labels with their points.
+ */
+BOOST_AUTO_TEST_CASE(StratifiedSplitTest)
+{
+  // 300 points of label 0, 60 of label 1 and 20 of label 2; the first
+  // dimension of each point is its index.
+  mat input(2, 380);
+  input.randu();
+  input.row(0) = arma::linspace<rowvec>(0, input.n_cols - 1, input.n_cols);
+  Row<size_t> labels(380);
+  labels.cols(0, 299).fill(0);
+  labels.cols(300, 359).fill(1);
+  labels.cols(360, 379).fill(2);
+
+  const auto value = StratifiedSplit(input, labels, 0.25);
+  const Row<size_t>& trainLabels = std::get<2>(value);
+  const Row<size_t>& testLabels = std::get<3>(value);
+  BOOST_REQUIRE_EQUAL(std::get<0>(value).n_cols, 285);
+  BOOST_REQUIRE_EQUAL(std::get<1>(value).n_cols, 95);
+
+  const size_t testCounts[3] = { 75, 15, 5 };
+  for (size_t label = 0; label < 3; ++label)
+  {
+    BOOST_REQUIRE_EQUAL(arma::accu(testLabels == label), testCounts[label]);
+    BOOST_REQUIRE_EQUAL(arma::accu(trainLabels == label),
+        arma::accu(labels == label) - testCounts[label]);
+  }
+
+  // Each point must be used once, with its label.
+  const Row<size_t> trainIndices =
+      arma::conv_to<Row<size_t>>::from(std::get<0>(value).row(0));
+  const Row<size_t> testIndices =
+      arma::conv_to<Row<size_t>>::from(std::get<1>(value).row(0));
+  CheckDuplication(trainIndices, testIndices);
+  CompareData(input, std::get<0>(value), trainIndices);
+  CompareData(input, std::get<1>(value), testIndices);
+  for (size_t i = 0; i < trainIndices.n_elem; ++i)
+    BOOST_REQUIRE_EQUAL(trainLabels[i], labels[trainIndices[i]]);
+  for (size_t i = 0; i < testIndices.n_elem; ++i)
+    BOOST_REQUIRE_EQUAL(testLabels[i], labels[testIndices[i]]);
+}
+
+/**
+ * Make sure that splitting a file a chunk at a time writes each point once,
+ * with the right number of test points, in the order of the input file.
+ */
+BOOST_AUTO_TEST_CASE(StreamingSplitTest)
+{
+  // The first dimension of each point is its index.
+  mat input(3, 1003);
+  input.randu();
+  input.row(0) = arma::linspace<rowvec>(0, input.n_cols - 1, input.n_cols);
+  data::Save("split_input.csv", input, true);
+
+  StreamingDataset<double> dataset("split_input.csv", 100);
+  Split(dataset, "split_train.csv", "split_test.txt", 0.3);
+
+  mat trainData, testData;
+  data::Load("split_train.csv", trainData, true);
+  data::Load("split_test.txt", testData, true);
+  remove("split_input.csv");
+  remove("split_train.csv");
+  remove("split_test.txt");
+
+  BOOST_REQUIRE_EQUAL(trainData.n_cols, 1003 - size_t(0.3 * 1003));
+  BOOST_REQUIRE_EQUAL(testData.n_cols, size_t(0.3 * 1003));
+  BOOST_REQUIRE_EQUAL(trainData.n_rows, 3);
+  BOOST_REQUIRE_EQUAL(testData.n_rows, 3);
+
+  const Row<size_t> trainIndices =
+      arma::conv_to<Row<size_t>>::from(trainData.row(0));
+  const Row<size_t> testIndices =
+      arma::conv_to<Row<size_t>>::from(testData.row(0));
+  CheckDuplication(trainIndices, testIndices);
+  CompareData(input, trainData, trainIndices);
+  CompareData(input, testData, testIndices);
+
+  // The points keep their order.
+  BOOST_REQUIRE(std::is_sorted(trainIndices.begin(), trainIndices.end()));
+  BOOST_REQUIRE(std::is_sorted(testIndices.begin(), testIndices.end()));
+}
+
 BOOST_AUTO_TEST_SUITE_END();
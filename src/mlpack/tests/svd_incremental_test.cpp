@@ -2,8 +2,9 @@
  * @file svd_incremental_test.cpp
  * @author Sumedh Ghaisas
  *
- * Tests for SVDIncompleteIncrementalLearning and
- * SVDCompleteIncrementalLearning.
+ * Tests for SVDIncompleteIncrementalLearning,
+ * SVDCompleteIncrementalLearning, SVDParallelIncrementalLearning and
+ * ParallelALSUpdate.
  *
  * mlpack is free software; you may redistribute it and/or modify it under the
  * terms of the 3-clause BSD license.  You should have received a copy of the
@@ -14,11 +15,14 @@
 #include <mlpack/methods/amf/amf.hpp>
 #include <mlpack/methods/amf/update_rules/svd_incomplete_incremental_learning.hpp>
 #include <mlpack/methods/amf/update_rules/svd_complete_incremental_learning.hpp>
+#include <mlpack/methods/amf/update_rules/svd_parallel_incremental_learning.hpp>
+#include <mlpack/methods/amf/update_rules/parallel_als.hpp>
 #include <mlpack/methods/amf/init_rules/random_init.hpp>
 #include <mlpack/methods/amf/termination_policies/incomplete_incremental_termination.hpp>
 #include <mlpack/methods/amf/termination_policies/complete_incremental_termination.hpp>
 #include <mlpack/methods/amf/termination_policies/simple_tolerance_termination.hpp>
 #include <mlpack/methods/amf/termination_policies/validation_RMSE_termination.hpp>
+#include <mlpack/methods/amf/termination_policies/max_iteration_termination.hpp>
 
 #include <boost/test/unit_test.hpp>
 #include "test_tools.hpp"
@@ -146,4 +150,69 @@ BOOST_AUTO_TEST_CASE(SVDIncompleteIncrementalRegularizationTest)
   BOOST_REQUIRE_LT(regularizedRMSE, regularRMSE + 0.075);
 }
 
+//! Compute the RMSE of W * H on the nonzero entries of V.
+double ObservedRMSE(const sp_mat& v, const mat& w, const mat& h)
+{
+  double sum = 0.0;
+  for (sp_mat::const_iterator it = v.begin(); it != v.end(); ++it)
+  {
+    const double error = (*it) - dot(w.row(it.row()), h.col(it.col()));
+    sum += error * error;
+  }
+
+  return std::sqrt(sum / v.n_nonzero);
+}
+
+//! Build a sparse matrix holding about half of the entries of a random rank-3
+//! matrix.
+sp_mat LowRankSparseData()
+{
+  const mat full = randu<mat>(50, 3) * randu<mat>(3, 60) + 0.1;
+  const mat mask = randu<mat>(50, 60);
+
+  mat observed = full;
+  observed.elem(find(mask > 0.5)).zeros();
+  return sp_mat(observed);
+}
+
+/**
+ * Make sure that the parallel incremental learning fits the observed entries
+ * of a low-rank matrix.
+ */
+BOOST_AUTO_TEST_CASE(SVDParallelIncrementalConvergenceTest)
+{
+  const sp_mat data = LowRankSparseData();
+
+  AMF<MaxIterationTermination, RandomInitialization,
+      SVDParallelIncrementalLearning> amf(MaxIterationTermination(500),
+      RandomInitialization(), SVDParallelIncrementalLearning(0.01));
+
+  mat w, h;
+  amf.Apply(data, 3, w, h);
+
+  BOOST_REQUIRE_LT(ObservedRMSE(data, w, h), 0.1);
+}
+
+/**
+ * Make sure that parallel ALS fits the observed entries of a low-rank matrix,
+ * with both sparse and dense input.
+ */
+BOOST_AUTO_TEST_CASE(ParallelALSConvergenceTest)
+{
+  const sp_mat data = LowRankSparseData();
+  const mat denseData(data);
+
+  AMF<MaxIterationTermination, RandomInitialization, ParallelALSUpdate>
+      amf(MaxIterationTermination(50), RandomInitialization(),
+      ParallelALSUpdate(1e-5));
+
+  mat w, h;
+  amf.Apply(data, 3, w, h);
+  BOOST_REQUIRE_LT(ObservedRMSE(data, w, h), 0.01);
+
+  mat denseW, denseH;
+  amf.Apply(denseData, 3, denseW, denseH);
+  BOOST_REQUIRE_LT(ObservedRMSE(data, denseW, denseH), 0.01);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
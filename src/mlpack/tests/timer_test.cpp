@@ -147,4 +147,67 @@ BOOST_AUTO_TEST_CASE(DisabledTimingTest)
   BOOST_REQUIRE(Timer::Get("test_timer") == std::chrono::microseconds(0));
 }
 
+/**
+ * Make sure that the resource usage of a timer is recorded.
+ */
+BOOST_AUTO_TEST_CASE(TimerUsageTest)
+{
+  Timer::EnableTiming();
+
+  for (size_t run = 0; run < 2; ++run)
+  {
+    Timer::Start("usage_timer");
+
+    // Keep the CPU busy for a while.
+    const std::chrono::steady_clock::time_point start =
+        std::chrono::steady_clock::now();
+    volatile double sum = 0.0;
+    while (std::chrono::steady_clock::now() - start <
+        std::chrono::milliseconds(30))
+      sum = sum + 1.0;
+
+    Timer::RecordAllocation(100);
+    Timer::Stop("usage_timer");
+  }
+
+  const TimerUsage usage = Timer::GetUsage("usage_timer");
+  BOOST_REQUIRE_EQUAL(usage.runs, 2);
+  BOOST_REQUIRE_GT(usage.cpuTime.count(), 0);
+  BOOST_REQUIRE_GE(usage.allocations, 2);
+  BOOST_REQUIRE_GE(usage.allocatedBytes, 200);
+#ifndef _WIN32
+  BOOST_REQUIRE_GT(usage.peakMemory, 0);
+#endif
+
+  Timer::DisableTiming();
+}
+
+/**
+ * Make sure the JSON report holds the timers, with their names escaped.
+ */
+BOOST_AUTO_TEST_CASE(TimerJSONTest)
+{
+  Timer::EnableTiming();
+  Timer::Start("json \"timer\"");
+  Timer::Stop("json \"timer\"");
+  Timer::Start("json_running_timer");
+
+  std::ostringstream report;
+  CLI::GetSingleton().timer.WriteJSON(report);
+  const std::string json = report.str();
+
+  BOOST_REQUIRE_NE(json.find("\"json \\\"timer\\\"\": {"),
+      std::string::npos);
+  BOOST_REQUIRE_NE(json.find("\"json_running_timer\": {"), std::string::npos);
+  BOOST_REQUIRE_NE(json.find("\"wall_time\": "), std::string::npos);
+  BOOST_REQUIRE_NE(json.find("\"cpu_time\": "), std::string::npos);
+  BOOST_REQUIRE_NE(json.find("\"peak_memory\": "), std::string::npos);
+  BOOST_REQUIRE_NE(json.find("\"allocations\": "), std::string::npos);
+  BOOST_REQUIRE_NE(json.find("\"runs\": 1"), std::string::npos);
+  BOOST_REQUIRE_EQUAL(json[0], '{');
+
+  Timer::Stop("json_running_timer");
+  Timer::DisableTiming();
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -14,8 +14,12 @@
 #include <mlpack/core/metrics/lmetric.hpp>
 #include <mlpack/core/tree/cover_tree/cover_tree.hpp>
 #include <mlpack/core/tree/rectangle_tree.hpp>
+#include <mlpack/core/tree/octree.hpp>
+#include <mlpack/core/tree/split_frontier.hpp>
 
+#include <functional>
 #include <queue>
+#include <sstream>
 #include <stack>
 
 #include <boost/test/unit_test.hpp>
@@ -1041,6 +1045,80 @@ BOOST_AUTO_TEST_CASE(HRectBoundDiameter)
   BOOST_REQUIRE_SMALL(d.Diameter(), 1e-5);
 }
 
+/**
+ * Compare the distances of random bounds and points with a direct computation
+ * of the gaps and extents along each dimension, for the given metric.
+ */
+template<typename MetricType>
+void CheckHRectBoundDistances()
+{
+  const size_t dim = 7;
+  for (size_t trial = 0; trial < 50; ++trial)
+  {
+    const arma::mat a = arma::randn<arma::mat>(dim, 5);
+    const arma::mat b = arma::randn<arma::mat>(dim, 5);
+    const arma::vec point = 2 * arma::randn<arma::vec>(dim);
+
+    HRectBound<MetricType> first(dim), second(dim);
+    first |= a;
+    second |= b;
+
+    const arma::vec aMin = arma::min(a, 1), aMax = arma::max(a, 1);
+    const arma::vec bMin = arma::min(b, 1), bMax = arma::max(b, 1);
+    arma::vec gap(dim), extent(dim), pointGap(dim), pointExtent(dim);
+    for (size_t d = 0; d < dim; ++d)
+    {
+      if (bMin[d] > aMax[d])
+        gap[d] = bMin[d] - aMax[d];
+      else if (aMin[d] > bMax[d])
+        gap[d] = aMin[d] - bMax[d];
+      else
+        gap[d] = 0.0;
+      extent[d] = std::max(bMax[d] - aMin[d], aMax[d] - bMin[d]);
+
+      if (point[d] < aMin[d])
+        pointGap[d] = aMin[d] - point[d];
+      else if (point[d] > aMax[d])
+        pointGap[d] = point[d] - aMax[d];
+      else
+        pointGap[d] = 0.0;
+      pointExtent[d] = std::max(point[d] - aMin[d], aMax[d] - point[d]);
+    }
+
+    const arma::vec zero(dim, arma::fill::zeros);
+    MetricType metric;
+    BOOST_REQUIRE_CLOSE(first.MinDistance(second) + 1.0,
+        metric.Evaluate(gap, zero) + 1.0, 1e-5);
+    BOOST_REQUIRE_CLOSE(first.MaxDistance(second),
+        metric.Evaluate(extent, zero), 1e-5);
+    BOOST_REQUIRE_CLOSE(first.RangeDistance(second).Lo() + 1.0,
+        metric.Evaluate(gap, zero) + 1.0, 1e-5);
+    BOOST_REQUIRE_CLOSE(first.RangeDistance(second).Hi(),
+        metric.Evaluate(extent, zero), 1e-5);
+
+    BOOST_REQUIRE_CLOSE(first.MinDistance(point) + 1.0,
+        metric.Evaluate(pointGap, zero) + 1.0, 1e-5);
+    BOOST_REQUIRE_CLOSE(first.MaxDistance(point),
+        metric.Evaluate(pointExtent, zero), 1e-5);
+    BOOST_REQUIRE_CLOSE(first.RangeDistance(point).Lo() + 1.0,
+        metric.Evaluate(pointGap, zero) + 1.0, 1e-5);
+    BOOST_REQUIRE_CLOSE(first.RangeDistance(point).Hi(),
+        metric.Evaluate(pointExtent, zero), 1e-5);
+  }
+}
+
+/**
+ * Make sure the branch-free HRectBound distances are right for the L1 and L2
+ * metrics, with and without the root, and for a generic power.
+ */
+BOOST_AUTO_TEST_CASE(HRectBoundRandomDistances)
+{
+  CheckHRectBoundDistances<LMetric<1, true>>();
+  CheckHRectBoundDistances<LMetric<2, true>>();
+  CheckHRectBoundDistances<LMetric<2, false>>();
+  CheckHRectBoundDistances<LMetric<3, true>>();
+}
+
 /**
  * It seems as though Bill has stumbled across a bug where
  * BinarySpaceTree<>::count() returns something different than
@@ -1926,6 +2004,59 @@ BOOST_AUTO_TEST_CASE(CoverTreeConstructionTest)
   // implementation.
 }
 
+#ifdef HAS_OPENMP
+/**
+ * Make sure that two cover trees are identical.
+ */
+template<typename TreeType>
+void CheckSameCoverTree(const TreeType& a, const TreeType& b)
+{
+  BOOST_REQUIRE_EQUAL(a.Point(), b.Point());
+  BOOST_REQUIRE_EQUAL(a.Scale(), b.Scale());
+  BOOST_REQUIRE_EQUAL(a.NumDescendants(), b.NumDescendants());
+  BOOST_REQUIRE_EQUAL(a.ParentDistance(), b.ParentDistance());
+  BOOST_REQUIRE_EQUAL(a.FurthestDescendantDistance(),
+                      b.FurthestDescendantDistance());
+  BOOST_REQUIRE_EQUAL(a.NumChildren(), b.NumChildren());
+
+  for (size_t i = 0; i < a.NumChildren(); ++i)
+    CheckSameCoverTree(a.Child(i), b.Child(i));
+}
+
+/**
+ * Building a cover tree with several threads must give the same tree as
+ * building it with one thread.  The build times are reported with Log::Info.
+ */
+BOOST_AUTO_TEST_CASE(ParallelCoverTreeConstructionTest)
+{
+  arma::mat dataset;
+  dataset.randu(50, 5000);
+
+  typedef StandardCoverTree<EuclideanDistance, EmptyStatistic, arma::mat>
+      TreeType;
+
+  arma::wall_clock timer;
+  timer.tic();
+  TreeType parallelTree(dataset);
+  const double parallelTime = timer.toc();
+
+  const size_t prevNumThreads = omp_get_max_threads();
+  omp_set_num_threads(1);
+  timer.tic();
+  TreeType sequentialTree(dataset);
+  const double sequentialTime = timer.toc();
+  omp_set_num_threads(prevNumThreads);
+
+  Log::Info << "Cover tree construction: " << sequentialTime << "s with 1 "
+      << "thread, " << parallelTime << "s with " << prevNumThreads
+      << " threads." << std::endl;
+
+  CheckSameCoverTree(parallelTree, sequentialTree);
+  BOOST_REQUIRE_EQUAL(parallelTree.DistanceComps(),
+                      sequentialTree.DistanceComps());
+}
+#endif
+
 /**
  * Create a cover tree on sparse data and make sure it's accurate.
  */
@@ -2136,6 +2267,90 @@ BOOST_AUTO_TEST_CASE(BinarySpaceTreeCopyConstructor)
   BOOST_REQUIRE_EQUAL(b.Right()->Right(), c.Right()->Right());
 }
 
+//! Record the begin, count, and bound of every node in depth-first order, and
+//! check that the parent pointers are consistent.
+template<typename TreeType>
+void RecordTree(const TreeType& node,
+                std::vector<size_t>& begins,
+                std::vector<size_t>& counts,
+                std::vector<double>& bounds)
+{
+  begins.push_back(node.Begin());
+  counts.push_back(node.Count());
+  for (size_t d = 0; d < node.Bound().Dim(); ++d)
+  {
+    bounds.push_back(node.Bound()[d].Lo());
+    bounds.push_back(node.Bound()[d].Hi());
+  }
+
+  for (size_t i = 0; i < node.NumChildren(); ++i)
+  {
+    BOOST_REQUIRE_EQUAL(node.Child(i).Parent(), &node);
+    RecordTree(node.Child(i), begins, counts, bounds);
+  }
+}
+
+/**
+ * Make sure that packing the nodes of a binary space tree, in either order,
+ * doesn't change the tree.
+ */
+BOOST_AUTO_TEST_CASE(BinarySpaceTreePackNodesTest)
+{
+  arma::mat dataset(4, 1000);
+  dataset.randu();
+
+  typedef KDTree<EuclideanDistance, EmptyStatistic, arma::mat> TreeType;
+  TreeType tree(dataset, 5);
+
+  std::vector<size_t> begins, counts;
+  std::vector<double> bounds;
+  RecordTree(tree, begins, counts, bounds);
+  BOOST_REQUIRE_EQUAL(tree.IsPacked(), false);
+
+  // Pack in van Emde Boas order, then repack in breadth-first order.
+  for (size_t trial = 0; trial < 2; ++trial)
+  {
+    tree.PackNodes(trial == 0);
+    BOOST_REQUIRE_EQUAL(tree.IsPacked(), true);
+
+    std::vector<size_t> packedBegins, packedCounts;
+    std::vector<double> packedBounds;
+    RecordTree(tree, packedBegins, packedCounts, packedBounds);
+
+    BOOST_REQUIRE_EQUAL(packedBegins.size(), begins.size());
+    for (size_t i = 0; i < begins.size(); ++i)
+    {
+      BOOST_REQUIRE_EQUAL(packedBegins[i], begins[i]);
+      BOOST_REQUIRE_EQUAL(packedCounts[i], counts[i]);
+    }
+
+    BOOST_REQUIRE_EQUAL(packedBounds.size(), bounds.size());
+    for (size_t i = 0; i < bounds.size(); ++i)
+      BOOST_REQUIRE_EQUAL(packedBounds[i], bounds[i]);
+  }
+
+  // In breadth-first order, the two children of the root are adjacent.
+  BOOST_REQUIRE_EQUAL(tree.Right(), tree.Left() + 1);
+
+  // A copy of a packed tree is an ordinary tree.
+  TreeType copy(tree);
+  BOOST_REQUIRE_EQUAL(copy.IsPacked(), false);
+
+  std::vector<size_t> copyBegins, copyCounts;
+  std::vector<double> copyBounds;
+  RecordTree(copy, copyBegins, copyCounts, copyBounds);
+  BOOST_REQUIRE_EQUAL(copyBegins.size(), begins.size());
+
+  // Packing a non-root node is not allowed.
+  BOOST_REQUIRE_THROW(tree.Left()->PackNodes(), std::invalid_argument);
+
+  // Moving the tree moves the packed nodes too.
+  TreeType moved(std::move(tree));
+  BOOST_REQUIRE_EQUAL(moved.IsPacked(), true);
+  BOOST_REQUIRE_EQUAL(tree.IsPacked(), false);
+  BOOST_REQUIRE_EQUAL(moved.Left()->Parent(), &moved);
+}
+
 //! Count the number of leaves under this node.
 template<typename TreeType>
 size_t NumLeaves(TreeType* node)
@@ -2236,6 +2451,153 @@ void CheckDescendants(TreeType* node)
     CheckDescendants(&node->Child(i));
 }
 
+/**
+ * Check that every node of a modified tree contains its points, that the
+ * children of each node split its points, and that no leaf is too big.
+ */
+template<typename TreeType>
+void CheckModifiedTree(TreeType& node, const size_t maxLeafSize)
+{
+  for (size_t i = node.Begin(); i < node.Begin() + node.Count(); ++i)
+    BOOST_REQUIRE_EQUAL(node.Bound().Contains(node.Dataset().col(i)), true);
+
+  if (node.IsLeaf())
+  {
+    BOOST_REQUIRE_LE(node.Count(), maxLeafSize);
+    return;
+  }
+
+  BOOST_REQUIRE_EQUAL(node.Left()->Parent(), &node);
+  BOOST_REQUIRE_EQUAL(node.Right()->Parent(), &node);
+  BOOST_REQUIRE_EQUAL(node.Left()->Begin(), node.Begin());
+  BOOST_REQUIRE_EQUAL(node.Right()->Begin(),
+      node.Begin() + node.Left()->Count());
+  BOOST_REQUIRE_EQUAL(node.Left()->Count() + node.Right()->Count(),
+      node.Count());
+
+  CheckModifiedTree(*node.Left(), maxLeafSize);
+  CheckModifiedTree(*node.Right(), maxLeafSize);
+}
+
+/**
+ * Insert points into and delete points from a kd-tree, and make sure that the
+ * tree and the mapping are still valid.
+ */
+BOOST_AUTO_TEST_CASE(BinarySpaceTreeInsertDeleteTest)
+{
+  arma::mat dataset(4, 500);
+  dataset.randu();
+  // Half of the new points lie outside of the original bounds.
+  arma::mat newPoints(4, 200);
+  newPoints.randu();
+  newPoints.cols(0, 99) *= 3.0;
+
+  typedef KDTree<EuclideanDistance, EmptyStatistic, arma::mat> TreeType;
+  std::vector<size_t> oldFromNew;
+  TreeType tree(dataset, oldFromNew, 10);
+
+  tree.InsertPoints(newPoints, oldFromNew, 10);
+  BOOST_REQUIRE_EQUAL(tree.NumDescendants(), 700);
+  BOOST_REQUIRE_EQUAL(tree.Dataset().n_cols, 700);
+  BOOST_REQUIRE_EQUAL(oldFromNew.size(), 700);
+  CheckModifiedTree(tree, 10);
+
+  // Delete every third point (by original index).
+  std::vector<size_t> newFromOld(oldFromNew.size());
+  for (size_t i = 0; i < oldFromNew.size(); ++i)
+    newFromOld[oldFromNew[i]] = i;
+
+  std::vector<bool> deleted(700, false);
+  std::vector<size_t> points;
+  for (size_t i = 0; i < 700; i += 3)
+  {
+    deleted[i] = true;
+    points.push_back(newFromOld[i]);
+  }
+
+  tree.DeletePoints(points, oldFromNew, 10);
+  BOOST_REQUIRE_EQUAL(tree.NumDescendants(), 700 - points.size());
+  BOOST_REQUIRE_EQUAL(tree.Dataset().n_cols, 700);
+  CheckModifiedTree(tree, 10);
+
+  // Deleted points can't be deleted again.
+  BOOST_REQUIRE_THROW(tree.DeletePoints(std::vector<size_t>(1,
+      tree.NumDescendants()), oldFromNew, 10), std::invalid_argument);
+
+  // Check the mapping: each point must be in the right place, and exactly the
+  // points that were not deleted must be held by the root.
+  arma::mat allPoints = arma::join_rows(dataset, newPoints);
+  std::vector<bool> found(700, false);
+  for (size_t i = 0; i < 700; ++i)
+  {
+    for (size_t d = 0; d < 4; ++d)
+      BOOST_REQUIRE_CLOSE(tree.Dataset()(d, i), allPoints(d, oldFromNew[i]),
+          1e-5);
+
+    BOOST_REQUIRE_EQUAL(found[oldFromNew[i]], false);
+    found[oldFromNew[i]] = true;
+    BOOST_REQUIRE_EQUAL(deleted[oldFromNew[i]], (i >= tree.NumDescendants()));
+  }
+}
+
+/**
+ * Make sure that two binary space trees have the same structure.
+ */
+template<typename TreeType>
+void CheckSameBinarySpaceTree(const TreeType& a, const TreeType& b)
+{
+  BOOST_REQUIRE_EQUAL(a.Begin(), b.Begin());
+  BOOST_REQUIRE_EQUAL(a.Count(), b.Count());
+  BOOST_REQUIRE_EQUAL(a.IsLeaf(), b.IsLeaf());
+  BOOST_REQUIRE_EQUAL(a.ParentDistance(), b.ParentDistance());
+  BOOST_REQUIRE_EQUAL(a.FurthestDescendantDistance(),
+                      b.FurthestDescendantDistance());
+
+  if (!a.IsLeaf())
+  {
+    CheckSameBinarySpaceTree(*a.Left(), *b.Left());
+    CheckSameBinarySpaceTree(*a.Right(), *b.Right());
+  }
+}
+
+/**
+ * Build a tree with children built in parallel (from a small cutoff) and
+ * without, and make sure the trees and the mappings are the same.
+ */
+template<typename TreeType>
+void CheckParallelConstruction(const arma::mat& dataset)
+{
+  std::vector<size_t> parallelOldFromNew, sequentialOldFromNew;
+  TreeType parallelTree(dataset, parallelOldFromNew, 20, 100);
+  TreeType sequentialTree(dataset, sequentialOldFromNew, 20,
+      std::numeric_limits<size_t>::max());
+
+  CheckSameBinarySpaceTree(parallelTree, sequentialTree);
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+    BOOST_REQUIRE_EQUAL(parallelOldFromNew[i], sequentialOldFromNew[i]);
+
+  // The tree built without the mapping must be the same too.
+  TreeType otherTree(dataset, 20, 100);
+  CheckSameBinarySpaceTree(otherTree, sequentialTree);
+}
+
+/**
+ * Building the children of the nodes in parallel must not change kd-trees or
+ * ball trees.
+ */
+BOOST_AUTO_TEST_CASE(ParallelBinarySpaceTreeConstructionTest)
+{
+  arma::mat dataset(5, 20000);
+  dataset.randu();
+
+  CheckParallelConstruction<KDTree<EuclideanDistance, EmptyStatistic,
+      arma::mat>>(dataset);
+  CheckParallelConstruction<MeanSplitKDTree<EuclideanDistance, EmptyStatistic,
+      arma::mat>>(dataset);
+  CheckParallelConstruction<BallTree<EuclideanDistance, EmptyStatistic,
+      arma::mat>>(dataset);
+}
+
 /**
  * Make sure Descendant() and NumDescendants() works properly for the cover
  * tree.
@@ -2252,4 +2614,760 @@ BOOST_AUTO_TEST_CASE(CoverTreeDescendantTest)
   CheckDescendants(&tree);
 }
 
+/**
+ * Make sure SplitFrontier() splits the tree into at least the requested number
+ * of subtrees, and that together they hold every point exactly once.
+ */
+BOOST_AUTO_TEST_CASE(SplitFrontierTest)
+{
+  arma::mat dataset;
+  dataset.randu(3, 1000);
+
+  typedef KDTree<EuclideanDistance, EmptyStatistic, arma::mat> TreeType;
+  TreeType tree(dataset, 10);
+
+  size_t splits = 0;
+  const std::vector<TreeType*> frontier = SplitFrontier(tree, 20,
+      [&splits](TreeType& node)
+      {
+        BOOST_REQUIRE_GT(node.NumChildren(), 0);
+        ++splits;
+      });
+
+  BOOST_REQUIRE_GE(frontier.size(), 20);
+  // Each split of a binary tree adds one subtree to the frontier.
+  BOOST_REQUIRE_EQUAL(frontier.size(), splits + 1);
+
+  arma::Col<size_t> counts(dataset.n_cols, arma::fill::zeros);
+  for (size_t i = 0; i < frontier.size(); ++i)
+    for (size_t j = 0; j < frontier[i]->NumDescendants(); ++j)
+      ++counts[frontier[i]->Descendant(j)];
+
+  for (size_t i = 0; i < counts.n_elem; ++i)
+    BOOST_REQUIRE_EQUAL(counts[i], 1);
+
+  // A tree with a single leaf can't be split.
+  TreeType leaf(dataset, dataset.n_cols);
+  BOOST_REQUIRE_EQUAL(SplitFrontier(leaf, 20).size(), 1);
+}
+
+/**
+ * Rules that record each call to Score(), Rescore() and BaseCase(), along with
+ * the traversal info at the time of the call.  The scores are pseudorandom
+ * functions of the nodes, so some combinations are pruned by Score() and some
+ * more by Rescore(), and many scores are tied.
+ */
+template<typename TreeType>
+class RecordingRules
+{
+ public:
+  typedef size_t TraversalInfoType;
+
+  RecordingRules() : traversalInfo(0) { }
+
+  double BaseCase(const size_t queryIndex, const size_t referenceIndex)
+  {
+    Record("BaseCase", queryIndex, referenceIndex, 0.0);
+    return 0.0;
+  }
+
+  double Score(const size_t queryIndex, const TreeType& referenceNode)
+  {
+    return RecordScore("Score", queryIndex, Id(referenceNode));
+  }
+
+  double Score(const TreeType& queryNode, const TreeType& referenceNode)
+  {
+    return RecordScore("ScoreNodes", Id(queryNode), Id(referenceNode));
+  }
+
+  double Rescore(const size_t queryIndex,
+                 const TreeType& referenceNode,
+                 const double oldScore)
+  {
+    return RecordRescore("Rescore", queryIndex, Id(referenceNode), oldScore);
+  }
+
+  double Rescore(const TreeType& queryNode,
+                 const TreeType& referenceNode,
+                 const double oldScore)
+  {
+    return RecordRescore("RescoreNodes", Id(queryNode), Id(referenceNode),
+        oldScore);
+  }
+
+  TraversalInfoType& TraversalInfo() { return traversalInfo; }
+
+  //! The recorded calls.
+  std::vector<std::string> calls;
+
+ private:
+  //! Identify a node by its points.
+  static size_t Id(const TreeType& node)
+  {
+    return node.Descendant(0) * 1000 + node.NumDescendants();
+  }
+
+  //! Hash two numbers.
+  static size_t Hash(const size_t a, const size_t b)
+  {
+    size_t h = a * 2654435761u + b * 40503u + 1;
+    h ^= (h >> 13);
+    h *= 2246822519u;
+    h ^= (h >> 16);
+    return h;
+  }
+
+  //! Score the combination of a and b, and record the call.
+  double RecordScore(const char* name, const size_t a, const size_t b)
+  {
+    const size_t h = Hash(a, b);
+    const double score = (h % 8 == 0) ? DBL_MAX : double(h % 4);
+    Record(name, a, b, score);
+    traversalInfo = h;
+    return score;
+  }
+
+  //! Rescore the combination of a and b, and record the call.
+  double RecordRescore(const char* name,
+                       const size_t a,
+                       const size_t b,
+                       const double oldScore)
+  {
+    const double score = (Hash(b, a) % 5 == 0) ? DBL_MAX : oldScore;
+    Record(name, a, b, score);
+    return score;
+  }
+
+  //! Record a call.
+  void Record(const char* name,
+              const size_t a,
+              const size_t b,
+              const double result)
+  {
+    std::ostringstream oss;
+    oss << name << "(" << a << ", " << b << ") = " << result << " with info "
+        << traversalInfo;
+    calls.push_back(oss.str());
+  }
+
+  //! The traversal info, which is the hash of the last scored combination.
+  TraversalInfoType traversalInfo;
+};
+
+/**
+ * The recursive BinarySpaceTree single-tree traverser that the iterative one
+ * replaced, to check that the rules see the same calls.
+ */
+template<typename TreeType, typename RuleType>
+class RecursiveBinarySpaceTreeSingleTraverser
+{
+ public:
+  RecursiveBinarySpaceTreeSingleTraverser(RuleType& rule) : rule(rule) { }
+
+  void Traverse(const size_t queryIndex, TreeType& referenceNode)
+  {
+    if (referenceNode.IsLeaf())
+    {
+      const size_t refEnd = referenceNode.Begin() + referenceNode.Count();
+      for (size_t i = referenceNode.Begin(); i < refEnd; ++i)
+        rule.BaseCase(queryIndex, i);
+      return;
+    }
+
+    double leftScore = rule.Score(queryIndex, *referenceNode.Left());
+    double rightScore = rule.Score(queryIndex, *referenceNode.Right());
+
+    if (leftScore < rightScore ||
+        (leftScore == rightScore && leftScore != DBL_MAX))
+    {
+      Traverse(queryIndex, *referenceNode.Left());
+      rightScore = rule.Rescore(queryIndex, *referenceNode.Right(), rightScore);
+      if (rightScore != DBL_MAX)
+        Traverse(queryIndex, *referenceNode.Right());
+    }
+    else if (rightScore < leftScore)
+    {
+      Traverse(queryIndex, *referenceNode.Right());
+      leftScore = rule.Rescore(queryIndex, *referenceNode.Left(), leftScore);
+      if (leftScore != DBL_MAX)
+        Traverse(queryIndex, *referenceNode.Left());
+    }
+  }
+
+ private:
+  RuleType& rule;
+};
+
+/**
+ * The recursive BinarySpaceTree dual-tree traverser that the iterative one
+ * replaced, to check that the rules see the same calls with the same traversal
+ * info.
+ */
+template<typename TreeType, typename RuleType>
+class RecursiveBinarySpaceTreeDualTraverser
+{
+ public:
+  typedef typename RuleType::TraversalInfoType TraversalInfoType;
+
+  RecursiveBinarySpaceTreeDualTraverser(RuleType& rule) : rule(rule) { }
+
+  void Traverse(TreeType& queryNode, TreeType& referenceNode)
+  {
+    traversalInfo = rule.TraversalInfo();
+
+    if (queryNode.IsLeaf() && referenceNode.IsLeaf())
+    {
+      const size_t queryEnd = queryNode.Begin() + queryNode.Count();
+      const size_t refEnd = referenceNode.Begin() + referenceNode.Count();
+      for (size_t query = queryNode.Begin(); query < queryEnd; ++query)
+      {
+        rule.TraversalInfo() = traversalInfo;
+        if (rule.Score(query, referenceNode) == DBL_MAX)
+          continue;
+
+        for (size_t ref = referenceNode.Begin(); ref < refEnd; ++ref)
+          rule.BaseCase(query, ref);
+      }
+    }
+    else if ((!queryNode.IsLeaf() && referenceNode.IsLeaf()) ||
+             (queryNode.NumDescendants() > 3 * referenceNode.NumDescendants() &&
+              !queryNode.IsLeaf() && !referenceNode.IsLeaf()))
+    {
+      if (rule.Score(*queryNode.Left(), referenceNode) != DBL_MAX)
+        Traverse(*queryNode.Left(), referenceNode);
+
+      rule.TraversalInfo() = traversalInfo;
+      if (rule.Score(*queryNode.Right(), referenceNode) != DBL_MAX)
+        Traverse(*queryNode.Right(), referenceNode);
+    }
+    else if (queryNode.IsLeaf())
+    {
+      // The traversal info of the right child is kept in the member.
+      TraverseReferenceChildren(queryNode, referenceNode, traversalInfo);
+    }
+    else
+    {
+      TraversalInfoType rightInfo;
+      TraverseReferenceChildren(*queryNode.Left(), referenceNode, rightInfo);
+      rule.TraversalInfo() = traversalInfo;
+      TraverseReferenceChildren(*queryNode.Right(), referenceNode, rightInfo);
+    }
+  }
+
+ private:
+  void TraverseReferenceChildren(TreeType& queryNode,
+                                 TreeType& referenceNode,
+                                 TraversalInfoType& rightInfo)
+  {
+    double leftScore = rule.Score(queryNode, *referenceNode.Left());
+    const TraversalInfoType leftInfo = rule.TraversalInfo();
+    rule.TraversalInfo() = traversalInfo;
+    double rightScore = rule.Score(queryNode, *referenceNode.Right());
+
+    if (leftScore < rightScore ||
+        (leftScore == rightScore && leftScore != DBL_MAX))
+    {
+      rightInfo = rule.TraversalInfo();
+      rule.TraversalInfo() = leftInfo;
+      Traverse(queryNode, *referenceNode.Left());
+
+      rightScore = rule.Rescore(queryNode, *referenceNode.Right(), rightScore);
+      if (rightScore != DBL_MAX)
+      {
+        rule.TraversalInfo() = rightInfo;
+        Traverse(queryNode, *referenceNode.Right());
+      }
+    }
+    else if (rightScore < leftScore)
+    {
+      Traverse(queryNode, *referenceNode.Right());
+
+      leftScore = rule.Rescore(queryNode, *referenceNode.Left(), leftScore);
+      if (leftScore != DBL_MAX)
+      {
+        rule.TraversalInfo() = leftInfo;
+        Traverse(queryNode, *referenceNode.Left());
+      }
+    }
+  }
+
+  RuleType& rule;
+  TraversalInfoType traversalInfo;
+};
+
+/**
+ * The recursive Octree single-tree traverser that the iterative one replaced.
+ */
+template<typename TreeType, typename RuleType>
+class RecursiveOctreeSingleTraverser
+{
+ public:
+  RecursiveOctreeSingleTraverser(RuleType& rule) : rule(rule) { }
+
+  void Traverse(const size_t queryIndex, TreeType& referenceNode)
+  {
+    if (referenceNode.NumChildren() == 0)
+    {
+      const size_t refBegin = referenceNode.Point(0);
+      const size_t refEnd = refBegin + referenceNode.NumPoints();
+      for (size_t r = refBegin; r < refEnd; ++r)
+        rule.BaseCase(queryIndex, r);
+      return;
+    }
+
+    arma::vec scores(referenceNode.NumChildren());
+    for (size_t i = 0; i < scores.n_elem; ++i)
+      scores[i] = rule.Score(queryIndex, referenceNode.Child(i));
+
+    arma::uvec sortedIndices = arma::sort_index(scores);
+    for (size_t i = 0; i < sortedIndices.n_elem; ++i)
+    {
+      if (scores[sortedIndices[i]] == DBL_MAX)
+        break;
+
+      Traverse(queryIndex, referenceNode.Child(sortedIndices[i]));
+    }
+  }
+
+ private:
+  RuleType& rule;
+};
+
+/**
+ * The recursive RectangleTree single-tree traverser that the iterative one
+ * replaced.
+ */
+template<typename TreeType, typename RuleType>
+class RecursiveRectangleTreeSingleTraverser
+{
+ public:
+  RecursiveRectangleTreeSingleTraverser(RuleType& rule) : rule(rule) { }
+
+  void Traverse(const size_t queryIndex, const TreeType& referenceNode)
+  {
+    if (referenceNode.IsLeaf())
+    {
+      for (size_t i = 0; i < referenceNode.Count(); i++)
+        rule.BaseCase(queryIndex, referenceNode.Point(i));
+      return;
+    }
+
+    std::vector<NodeAndScore> nodesAndScores(referenceNode.NumChildren());
+    for (size_t i = 0; i < referenceNode.NumChildren(); i++)
+    {
+      nodesAndScores[i].node = &referenceNode.Child(i);
+      nodesAndScores[i].score = rule.Score(queryIndex, *nodesAndScores[i].node);
+    }
+
+    std::sort(nodesAndScores.begin(), nodesAndScores.end(), NodeComparator);
+
+    for (size_t i = 0; i < nodesAndScores.size(); i++)
+    {
+      if (rule.Rescore(queryIndex, *nodesAndScores[i].node,
+          nodesAndScores[i].score) == DBL_MAX)
+        return;
+
+      Traverse(queryIndex, *nodesAndScores[i].node);
+    }
+  }
+
+ private:
+  struct NodeAndScore
+  {
+    const TreeType* node;
+    double score;
+  };
+
+  static bool NodeComparator(const NodeAndScore& obj1, const NodeAndScore& obj2)
+  {
+    return obj1.score < obj2.score;
+  }
+
+  RuleType& rule;
+};
+
+/**
+ * Check that the given single-tree traverser makes the same calls to the rules
+ * as the given recursive reference traverser, for many query points.
+ */
+template<typename TreeType, typename TraverserType, typename ReferenceType>
+void CheckSingleTreeCalls(TreeType& tree)
+{
+  for (size_t queryIndex = 0; queryIndex < 50; ++queryIndex)
+  {
+    RecordingRules<TreeType> rules;
+    TraverserType traverser(rules);
+    traverser.Traverse(queryIndex, tree);
+
+    RecordingRules<TreeType> referenceRules;
+    ReferenceType referenceTraverser(referenceRules);
+    referenceTraverser.Traverse(queryIndex, tree);
+
+    BOOST_REQUIRE_GT(rules.calls.size(), 0);
+    BOOST_REQUIRE_EQUAL(rules.calls.size(), referenceRules.calls.size());
+    for (size_t i = 0; i < rules.calls.size(); ++i)
+      BOOST_REQUIRE_EQUAL(rules.calls[i], referenceRules.calls[i]);
+  }
+}
+
+/**
+ * Make sure that the iterative single-tree traversers make the same calls to
+ * the rules, in the same order, as the recursive ones they replaced.
+ */
+BOOST_AUTO_TEST_CASE(SingleTreeTraverserCallOrderTest)
+{
+  arma::mat dataset;
+  dataset.randu(3, 500);
+
+  typedef KDTree<EuclideanDistance, EmptyStatistic, arma::mat> KDTreeType;
+  typedef RecordingRules<KDTreeType> KDTreeRules;
+  KDTreeType kdTree(dataset, 3);
+  CheckSingleTreeCalls<KDTreeType,
+      KDTreeType::SingleTreeTraverser<KDTreeRules>,
+      RecursiveBinarySpaceTreeSingleTraverser<KDTreeType, KDTreeRules>>(
+      kdTree);
+
+  typedef Octree<EuclideanDistance, EmptyStatistic, arma::mat> OctreeType;
+  typedef RecordingRules<OctreeType> OctreeRules;
+  OctreeType octree(dataset, 3);
+  CheckSingleTreeCalls<OctreeType,
+      OctreeType::SingleTreeTraverser<OctreeRules>,
+      RecursiveOctreeSingleTraverser<OctreeType, OctreeRules>>(octree);
+
+  typedef RTree<EuclideanDistance, EmptyStatistic, arma::mat> RTreeType;
+  typedef RecordingRules<RTreeType> RTreeRules;
+  RTreeType rTree(dataset, 5, 2, 5, 2);
+  CheckSingleTreeCalls<RTreeType,
+      RTreeType::SingleTreeTraverser<RTreeRules>,
+      RecursiveRectangleTreeSingleTraverser<RTreeType, RTreeRules>>(rTree);
+}
+
+/**
+ * Make sure that the iterative BinarySpaceTree dual-tree traverser makes the
+ * same calls to the rules, in the same order and with the same traversal info,
+ * as the recursive one it replaced.
+ */
+BOOST_AUTO_TEST_CASE(DualTreeTraverserCallOrderTest)
+{
+  arma::mat querySet, referenceSet;
+  querySet.randu(3, 200);
+  referenceSet.randu(3, 500);
+
+  typedef KDTree<EuclideanDistance, EmptyStatistic, arma::mat> TreeType;
+  typedef RecordingRules<TreeType> RuleType;
+  TreeType queryTree(querySet, 3);
+  TreeType referenceTree(referenceSet, 3);
+
+  // Check both a query tree that is smaller than the reference tree, and the
+  // same tree as query and reference.
+  TreeType* queryTrees[] = { &queryTree, &referenceTree };
+  for (size_t t = 0; t < 2; ++t)
+  {
+    RuleType rules;
+    TreeType::DualTreeTraverser<RuleType> traverser(rules);
+    traverser.Traverse(*queryTrees[t], referenceTree);
+
+    RuleType referenceRules;
+    RecursiveBinarySpaceTreeDualTraverser<TreeType, RuleType>
+        referenceTraverser(referenceRules);
+    referenceTraverser.Traverse(*queryTrees[t], referenceTree);
+
+    BOOST_REQUIRE_GT(rules.calls.size(), 0);
+    BOOST_REQUIRE_EQUAL(rules.calls.size(), referenceRules.calls.size());
+    for (size_t i = 0; i < rules.calls.size(); ++i)
+      BOOST_REQUIRE_EQUAL(rules.calls[i], referenceRules.calls[i]);
+  }
+}
+
+/**
+ * The BinarySpaceTree breadth-first dual-tree traverser before it reused its
+ * buffers: it recursed into each query child with new priority queues.
+ */
+template<typename TreeType, typename RuleType>
+class RecursiveBreadthFirstDualTraverser
+{
+ public:
+  typedef QueueFrame<TreeType, typename RuleType::TraversalInfoType>
+      QueueFrameType;
+
+  RecursiveBreadthFirstDualTraverser(RuleType& rule) : rule(rule) { }
+
+  void Traverse(TreeType& queryRoot, TreeType& referenceRoot)
+  {
+    if (rule.Score(queryRoot, referenceRoot) == DBL_MAX)
+      return;
+
+    std::priority_queue<QueueFrameType> queue;
+    QueueFrameType rootFrame = { &queryRoot, &referenceRoot, 0, 0.0,
+        rule.TraversalInfo() };
+    queue.push(rootFrame);
+
+    Traverse(queryRoot, queue);
+  }
+
+ private:
+  void Traverse(TreeType& queryRoot,
+                std::priority_queue<QueueFrameType>& referenceQueue)
+  {
+    std::priority_queue<QueueFrameType> leftChildQueue;
+    std::priority_queue<QueueFrameType> rightChildQueue;
+
+    while (!referenceQueue.empty())
+    {
+      QueueFrameType frame = referenceQueue.top();
+      referenceQueue.pop();
+
+      TreeType& queryNode = *frame.queryNode;
+      TreeType& referenceNode = *frame.referenceNode;
+      const typename RuleType::TraversalInfoType ti = frame.traversalInfo;
+      rule.TraversalInfo() = ti;
+      const size_t depth = frame.queryDepth;
+
+      const double score = rule.Score(queryNode, referenceNode);
+      if (score == DBL_MAX)
+        continue;
+
+      if (queryNode.IsLeaf() && referenceNode.IsLeaf())
+      {
+        const size_t queryEnd = queryNode.Begin() + queryNode.Count();
+        const size_t refEnd = referenceNode.Begin() + referenceNode.Count();
+        for (size_t query = queryNode.Begin(); query < queryEnd; ++query)
+          for (size_t ref = referenceNode.Begin(); ref < refEnd; ++ref)
+            rule.BaseCase(query, ref);
+      }
+      else if (!queryNode.IsLeaf() && referenceNode.IsLeaf())
+      {
+        QueueFrameType fl = { queryNode.Left(), &referenceNode, depth + 1,
+            score, rule.TraversalInfo() };
+        leftChildQueue.push(fl);
+        QueueFrameType fr = { queryNode.Right(), &referenceNode, depth + 1,
+            score, ti };
+        rightChildQueue.push(fr);
+      }
+      else if (queryNode.IsLeaf() && !referenceNode.IsLeaf())
+      {
+        QueueFrameType fl = { &queryNode, referenceNode.Left(), depth, score,
+            rule.TraversalInfo() };
+        referenceQueue.push(fl);
+        QueueFrameType fr = { &queryNode, referenceNode.Right(), depth, score,
+            ti };
+        referenceQueue.push(fr);
+      }
+      else
+      {
+        QueueFrameType fll = { queryNode.Left(), referenceNode.Left(),
+            depth + 1, score, rule.TraversalInfo() };
+        leftChildQueue.push(fll);
+        QueueFrameType flr = { queryNode.Left(), referenceNode.Right(),
+            depth + 1, score, rule.TraversalInfo() };
+        leftChildQueue.push(flr);
+        QueueFrameType frl = { queryNode.Right(), referenceNode.Left(),
+            depth + 1, score, rule.TraversalInfo() };
+        rightChildQueue.push(frl);
+        QueueFrameType frr = { queryNode.Right(), referenceNode.Right(),
+            depth + 1, score, rule.TraversalInfo() };
+        rightChildQueue.push(frr);
+      }
+    }
+
+    if (!leftChildQueue.empty())
+      Traverse(*queryRoot.Left(), leftChildQueue);
+    if (!rightChildQueue.empty())
+      Traverse(*queryRoot.Right(), rightChildQueue);
+  }
+
+  RuleType& rule;
+};
+
+/**
+ * Make sure that the BinarySpaceTree breadth-first dual-tree traverser, which
+ * reuses its buffers, makes the same calls to the rules in the same order and
+ * with the same traversal info as it did with new priority queues for each
+ * query node.  The same traverser is used twice, so the second traversal runs
+ * with buffers left over from the first.
+ */
+BOOST_AUTO_TEST_CASE(BreadthFirstDualTreeTraverserCallOrderTest)
+{
+  arma::mat querySet, referenceSet;
+  querySet.randu(3, 200);
+  referenceSet.randu(3, 500);
+
+  typedef KDTree<EuclideanDistance, EmptyStatistic, arma::mat> TreeType;
+  typedef RecordingRules<TreeType> RuleType;
+  TreeType queryTree(querySet, 3);
+  TreeType referenceTree(referenceSet, 3);
+
+  RuleType rules;
+  TreeType::BreadthFirstDualTreeTraverser<RuleType> traverser(rules);
+
+  TreeType* queryTrees[] = { &queryTree, &referenceTree };
+  for (size_t t = 0; t < 2; ++t)
+  {
+    rules.calls.clear();
+    rules.TraversalInfo() = 0;
+    traverser.Traverse(*queryTrees[t], referenceTree);
+
+    RuleType referenceRules;
+    RecursiveBreadthFirstDualTraverser<TreeType, RuleType>
+        referenceTraverser(referenceRules);
+    referenceTraverser.Traverse(*queryTrees[t], referenceTree);
+
+    BOOST_REQUIRE_GT(rules.calls.size(), 0);
+    BOOST_REQUIRE_EQUAL(rules.calls.size(), referenceRules.calls.size());
+    for (size_t i = 0; i < rules.calls.size(); ++i)
+      BOOST_REQUIRE_EQUAL(rules.calls[i], referenceRules.calls[i]);
+  }
+}
+
+/**
+ * Rules that never prune, and that start another traversal from the first few
+ * base cases of the outer traversal.  They count the base cases of the outer
+ * traversal and of the nested ones separately.
+ */
+class NestingRules
+{
+ public:
+  typedef size_t TraversalInfoType;
+
+  NestingRules(const size_t numQueries, const size_t numReferences) :
+      outerCounts(numQueries, numReferences, arma::fill::zeros),
+      nestedCounts(numQueries, numReferences, arma::fill::zeros),
+      numNested(0),
+      nested(false),
+      traversalInfo(0)
+  { }
+
+  double BaseCase(const size_t queryIndex, const size_t referenceIndex)
+  {
+    if (nested)
+    {
+      ++nestedCounts(queryIndex, referenceIndex);
+    }
+    else
+    {
+      ++outerCounts(queryIndex, referenceIndex);
+      if (numNested < 3)
+      {
+        ++numNested;
+        nested = true;
+        startNested();
+        nested = false;
+      }
+    }
+
+    return 0.0;
+  }
+
+  template<typename TreeType>
+  double Score(const size_t /* queryIndex */, const TreeType& /* node */)
+  {
+    return 0.0;
+  }
+
+  template<typename TreeType>
+  double Score(const TreeType& /* queryNode */,
+               const TreeType& /* referenceNode */)
+  {
+    return 0.0;
+  }
+
+  template<typename TreeType>
+  double Rescore(const size_t /* queryIndex */,
+                 const TreeType& /* node */,
+                 const double oldScore)
+  {
+    return oldScore;
+  }
+
+  template<typename TreeType>
+  double Rescore(const TreeType& /* queryNode */,
+                 const TreeType& /* referenceNode */,
+                 const double oldScore)
+  {
+    return oldScore;
+  }
+
+  TraversalInfoType& TraversalInfo() { return traversalInfo; }
+
+  //! The number of base cases of the outer traversal.
+  arma::Mat<size_t> outerCounts;
+  //! The number of base cases of the nested traversals.
+  arma::Mat<size_t> nestedCounts;
+  //! The number of nested traversals started so far.
+  size_t numNested;
+  //! Start a nested traversal.
+  std::function<void()> startNested;
+
+ private:
+  //! Whether a nested traversal is running.
+  bool nested;
+
+  TraversalInfoType traversalInfo;
+};
+
+/**
+ * Check that a nested traversal started from a base case with the same
+ * single-tree traverser doesn't disturb the outer traversal.
+ */
+template<typename TreeType>
+void CheckNestedSingleTreeTraversal(TreeType& tree, const size_t numPoints)
+{
+  NestingRules rules(2, numPoints);
+  typename TreeType::template SingleTreeTraverser<NestingRules>
+      traverser(rules);
+  rules.startNested = [&]() { traverser.Traverse(1, tree); };
+
+  traverser.Traverse(0, tree);
+
+  BOOST_REQUIRE_EQUAL(rules.numNested, 3);
+  for (size_t i = 0; i < numPoints; ++i)
+  {
+    BOOST_REQUIRE_EQUAL(rules.outerCounts(0, i), 1);
+    BOOST_REQUIRE_EQUAL(rules.nestedCounts(1, i), 3);
+  }
+}
+
+/**
+ * Make sure that a rule can start a traversal from inside BaseCase(), with the
+ * same traverser, since the traversers keep their stacks as members.
+ */
+BOOST_AUTO_TEST_CASE(NestedTraversalTest)
+{
+  arma::mat dataset;
+  dataset.randu(3, 300);
+
+  KDTree<EuclideanDistance, EmptyStatistic, arma::mat> kdTree(dataset, 3);
+  CheckNestedSingleTreeTraversal(kdTree, dataset.n_cols);
+
+  Octree<EuclideanDistance, EmptyStatistic, arma::mat> octree(dataset, 3);
+  CheckNestedSingleTreeTraversal(octree, dataset.n_cols);
+
+  RTree<EuclideanDistance, EmptyStatistic, arma::mat> rTree(dataset, 5, 2, 5,
+      2);
+  CheckNestedSingleTreeTraversal(rTree, dataset.n_cols);
+
+  // Now the dual-tree traverser.
+  typedef KDTree<EuclideanDistance, EmptyStatistic, arma::mat> TreeType;
+  arma::mat querySet;
+  querySet.randu(3, 100);
+  TreeType queryTree(querySet, 3);
+
+  NestingRules rules(querySet.n_cols, dataset.n_cols);
+  TreeType::DualTreeTraverser<NestingRules> traverser(rules);
+  rules.startNested = [&]() { traverser.Traverse(queryTree, kdTree); };
+
+  traverser.Traverse(queryTree, kdTree);
+
+  BOOST_REQUIRE_EQUAL(rules.numNested, 3);
+  for (size_t i = 0; i < querySet.n_cols; ++i)
+  {
+    for (size_t j = 0; j < dataset.n_cols; ++j)
+    {
+      BOOST_REQUIRE_EQUAL(rules.outerCounts(i, j), 1);
+      BOOST_REQUIRE_EQUAL(rules.nestedCounts(i, j), 3);
+    }
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END();
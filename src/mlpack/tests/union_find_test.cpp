@@ -10,6 +10,7 @@
  * http://www.opensource.org/licenses/BSD-3-Clause for more information.
  */
 #include <mlpack/methods/emst/union_find.hpp>
+#include <mlpack/methods/emst/concurrent_union_find.hpp>
 
 #include <mlpack/core.hpp>
 #include <boost/test/unit_test.hpp>
@@ -51,4 +52,38 @@ BOOST_AUTO_TEST_CASE(TestUnion)
   BOOST_REQUIRE(testUnionFind.Find(6) == testUnionFind.Find(3));
 }
 
+/**
+ * Check that the components found by ConcurrentUnionFind are the ones found by
+ * emst::UnionFind for the same unions, and that each component is labeled with
+ * its smallest element.
+ */
+BOOST_AUTO_TEST_CASE(ConcurrentUnionFindTest)
+{
+  const size_t n = 2000;
+  ConcurrentUnionFind cuf(n);
+  UnionFind uf(n);
+
+  arma::Mat<size_t> pairs(2, 1500);
+  for (size_t i = 0; i < pairs.n_cols; ++i)
+  {
+    pairs(0, i) = math::RandInt(n);
+    pairs(1, i) = math::RandInt(n);
+    uf.Union(pairs(0, i), pairs(1, i));
+  }
+
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) pairs.n_cols; ++i)
+    cuf.Union(pairs(0, i), pairs(1, i));
+
+  // Unions of elements in the same component don't merge anything.
+  BOOST_REQUIRE(!cuf.Union(pairs(0, 0), pairs(1, 0)));
+
+  for (size_t i = 0; i < n; ++i)
+  {
+    BOOST_REQUIRE_LE(cuf.Find(i), i);
+    for (size_t j = i + 1; j < std::min(n, i + 50); ++j)
+      BOOST_REQUIRE_EQUAL(cuf.Find(i) == cuf.Find(j), uf.Find(i) == uf.Find(j));
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END();